@@ -205,14 +205,16 @@ GrB_Info GxB_MatrixTupleIter_iterate_row
 				rowIdx, iter->nrows) ;
 	}
 
-	if(iter->nvals == 0) {
+	// deplete iterator, should caller ignore returned error
+	_EmptyIterator(iter) ;
+
+	// iter->nvals is bounded by the previously iterated row
+	// inspect the matrix itself
+	if(GB_nnz(iter->A) == 0) {
 		// empty matrix
 		return (GrB_SUCCESS) ;
 	}
 
-	// deplete iterator, should caller ignore returned error
-	_EmptyIterator(iter) ;
-
 	GrB_Index _rowIdx = rowIdx ;
 	GrB_Matrix A = iter->A ;
 
@@ -246,14 +248,16 @@ GrB_Info GxB_MatrixTupleIter_jump_to_row
 				rowIdx, iter->nrows) ;
 	}
 
-	if(iter->nvals == 0) {
+	// deplete iterator, should caller ignore returned error
+	_EmptyIterator(iter) ;
+
+	// iter->nvals is bounded by the previously iterated row
+	// inspect the matrix itself
+	if(GB_nnz(iter->A) == 0) {
 		// empty matrix
 		return (GrB_SUCCESS) ;
 	}
 
-	// deplete iterator, should caller ignore returned error
-	_EmptyIterator(iter) ;
-
 	// this call needed because we deplete the iterator
 	GrB_Matrix A = iter->A ;
 	GrB_Index _rowIdx = rowIdx ; // row position in A->p
@@ -0,0 +1,200 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "algo_matrix.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/rg_matrix/rg_matrix_iter.h"
+
+// collects the weights of edges of type 'r' as (src, dest, weight) tuples
+static void _CollectWeights
+(
+	Graph *g,
+	int r,
+	Attribute_ID weight,
+	GrB_Index **I,
+	GrB_Index **J,
+	double **X
+) {
+	EdgeID     id;
+	GrB_Index  src;
+	GrB_Index  dest;
+	bool       depleted = false;
+
+	RG_Matrix M = Graph_GetRelationMatrix(g, r, false);
+	RG_MatrixTupleIter *it = NULL;
+	RG_MatrixTupleIter_new(&it, M);
+
+	while(true) {
+		RG_MatrixTupleIter_next(it, &src, &dest, &id, &depleted);
+		if(depleted) break;
+
+		// multiple edges may connect src to dest
+		uint64_t edge_count = 1;
+		const EdgeID *ids = &id;
+		if(!SINGLE_EDGE(id)) ids = RG_Matrix_multiEdgeIDs(M, id, &edge_count);
+
+		for(uint64_t i = 0; i < edge_count; i++) {
+			Edge e;
+			Graph_GetEdge(g, ids[i], &e);
+
+			double w;
+			SIValue *v = GraphEntity_GetProperty((GraphEntity *)&e, weight);
+			if(v == PROPERTY_NOTFOUND || !(SI_TYPE(*v) & SI_NUMERIC)) continue;
+			SIValue_ToDouble(v, &w);
+			if(!(w > 0)) continue;
+
+			array_append(*I, src);
+			array_append(*J, dest);
+			array_append(*X, w);
+		}
+	}
+
+	RG_MatrixTupleIter_free(&it);
+}
+
+// returns the IDs of the nodes the sub-graph consists of, in ascending order
+// returns NULL if the sub-graph consists of all node IDs
+static GrB_Index *_Mapping
+(
+	Graph *g,
+	int label,
+	GrB_Index *n
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index *mapping = NULL;
+
+	if(label != GRAPH_NO_LABEL) {
+		GrB_Matrix L;
+		RG_Matrix_export(&L, Graph_GetLabelMatrix(g, label));
+
+		// extract row indices from 'L', corresponding to node IDs
+		info = GrB_Matrix_nvals(n, L);
+		ASSERT(info == GrB_SUCCESS);
+		mapping = rm_malloc(sizeof(GrB_Index) * (*n));
+		info = GrB_Matrix_extractTuples_BOOL(mapping, GrB_NULL, GrB_NULL, n, L);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_free(&L);
+	} else if(Graph_DeletedNodeCount(g) > 0) {
+		// skip deleted node IDs
+		*n = Graph_NodeCount(g);
+		mapping = rm_malloc(sizeof(GrB_Index) * (*n));
+
+		NodeID id;
+		GrB_Index i = 0;
+		DataBlockIterator *iter = Graph_ScanNodes(g);
+		while(DataBlockIterator_Next(iter, &id) != NULL) mapping[i++] = id;
+		DataBlockIterator_Free(iter);
+		ASSERT(i == *n);
+	} else {
+		*n = Graph_UncompactedNodeCount(g);
+	}
+
+	return mapping;
+}
+
+GrB_Info AlgoMatrix_Build
+(
+	GrB_Matrix *A,
+	GrB_Index **mapping,
+	GrB_Index *n,
+	Graph *g,
+	int label,
+	int relation,
+	Attribute_ID weight,
+	bool symmetric
+) {
+	ASSERT(g       != NULL);
+	ASSERT(A       != NULL);
+	ASSERT(n       != NULL);
+	ASSERT(mapping != NULL);
+
+	GrB_Info info;
+	GrB_Matrix M = NULL;
+	GrB_Index N = Graph_UncompactedNodeCount(g);
+
+	*A       = NULL;
+	*mapping = NULL;
+
+	info = GrB_Matrix_new(&M, GrB_FP64, N, N);
+	if(info != GrB_SUCCESS) return info;
+
+	if(weight == ATTRIBUTE_NOTFOUND) {
+		// a single unit of weight per connected pair
+		GrB_Matrix R;
+		RG_Matrix m = (relation == GRAPH_NO_RELATION) ?
+			Graph_GetAdjacencyMatrix(g, false) :
+			Graph_GetRelationMatrix(g, relation, false);
+		RG_Matrix_export(&R, m);
+
+		// resize to remove unused rows
+		info = GxB_Matrix_resize(R, N, N);
+		if(info == GrB_SUCCESS) {
+			info = GrB_Matrix_apply(M, GrB_NULL, GrB_NULL, GxB_ONE_FP64, R,
+					GrB_NULL);
+		}
+		GrB_free(&R);
+	} else {
+		int first = relation;
+		int last  = relation;
+		if(relation == GRAPH_NO_RELATION) {
+			first = 0;
+			last  = Graph_RelationTypeCount(g) - 1;
+		}
+
+		GrB_Index *I = array_new(GrB_Index, 0);
+		GrB_Index *J = array_new(GrB_Index, 0);
+		double    *X = array_new(double, 0);
+
+		for(int r = first; r <= last; r++) {
+			_CollectWeights(g, r, weight, &I, &J, &X);
+		}
+
+		// parallel edges sum up
+		info = GrB_Matrix_build_FP64(M, I, J, X, array_len(X), GrB_PLUS_FP64);
+
+		array_free(I);
+		array_free(J);
+		array_free(X);
+	}
+
+	if(info != GrB_SUCCESS) goto cleanup;
+
+	// discard rows and columns of nodes outside of the sub-graph
+	*mapping = _Mapping(g, label, n);
+	if(*mapping != NULL) {
+		GrB_Matrix reduced;
+		info = GrB_Matrix_new(&reduced, GrB_FP64, *n, *n);
+		if(info != GrB_SUCCESS) goto cleanup;
+
+		info = GrB_Matrix_extract(reduced, GrB_NULL, GrB_NULL, M, *mapping, *n,
+				*mapping, *n, GrB_NULL);
+		GrB_free(&M);
+		M = reduced;
+		if(info != GrB_SUCCESS) goto cleanup;
+	}
+
+	if(symmetric) {
+		info = GrB_Matrix_eWiseAdd_BinaryOp(M, GrB_NULL, GrB_NULL,
+				GrB_MAX_FP64, M, M, GrB_DESC_T1);
+		if(info != GrB_SUCCESS) goto cleanup;
+	}
+
+	*A = M;
+	return GrB_SUCCESS;
+
+cleanup:
+	GrB_free(&M);
+	if(*mapping != NULL) {
+		rm_free(*mapping);
+		*mapping = NULL;
+	}
+	return info;
+}
@@ -0,0 +1,33 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/graph.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// builds the FP64 adjacency matrix 'A' of the sub-graph induced by nodes
+// labeled 'label' connected by edges of type 'relation'
+// GRAPH_NO_LABEL and GRAPH_NO_RELATION stand for any label / relation
+//
+// A(i,j) is the sum of 'weight' over the edges connecting i to j,
+// edges lacking a positive numeric 'weight' are ignored
+// if 'weight' is ATTRIBUTE_NOTFOUND, A(i,j) is 1 for any connected pair
+//
+// rows are compacted to the sub-graph's nodes, 'mapping' maps row i
+// to its node ID and is set to NULL when rows are node IDs
+// the caller is responsible for freeing both 'A' and 'mapping'
+GrB_Info AlgoMatrix_Build
+(
+	GrB_Matrix *A,          // [output] adjacency matrix
+	GrB_Index **mapping,    // [output] row to node ID mapping
+	GrB_Index *n,           // [output] number of rows
+	Graph *g,               // graph
+	int label,              // node label
+	int relation,           // edge relationship type
+	Attribute_ID weight,    // edge weight attribute
+	bool symmetric          // make A symmetric by adding A'
+);
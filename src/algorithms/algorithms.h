@@ -12,4 +12,6 @@
 #include "./detect_cycle.h"
 #include "./longest_path.h"
 #include "./all_neighbors.h"
+#include "./bidirectional_bfs.h"
+#include "./all_shortest_paths.h"
 
@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../query_ctx.h"
 
 // Make sure context levels array have atleast 'level' entries,
 // Append given 'node' to given 'level' array.
@@ -44,7 +45,16 @@ static void _addNeighbors(AllPathsCtx *ctx, LevelConnection *frontier, uint32_t
 	//--------------------------------------------------------------------------
 	// apply filter to edge
 	//--------------------------------------------------------------------------
-	if(ctx->ft) {
+	if(ctx->edge_filter) {
+		for(uint32_t i = 0; i < neighborsCount; i++) {
+			// drop edge if it doesn't passes filter
+			if(!EdgeFilter_Pass(ctx->edge_filter, ctx->r, ctx->neighbors + i)) {
+				array_del_fast(ctx->neighbors, i);
+				i--;
+				neighborsCount--;
+			}
+		}
+	} else if(ctx->ft) {
 		for(uint32_t i = 0; i < neighborsCount; i++) {
 			Edge e = ctx->neighbors[i];
 
@@ -93,6 +103,7 @@ AllPathsCtx *AllPathsCtx_New(Node *src, Node *dst, Graph *g, int *relationIDs, i
 	ctx->ft        =  ft;
 	ctx->dir       =  dir;
 	ctx->edge_idx  =  edge_idx;
+	ctx->edge_filter = NULL;
 
 	// Cypher variable path "[:*min..max]"" specifies edge count
 	// While the path constructed here contains only nodes.
@@ -114,11 +125,24 @@ AllPathsCtx *AllPathsCtx_New(Node *src, Node *dst, Graph *g, int *relationIDs, i
 	return ctx;
 }
 
+void AllPathsCtx_SetEdgeFilter(AllPathsCtx *ctx, EdgeFilter *f) {
+	ASSERT(ctx != NULL);
+	ASSERT(f != NULL);
+	ASSERT(ctx->edge_idx < Record_length(ctx->r));
+
+	ctx->edge_filter = f;
+}
+
 Path *AllPathsCtx_NextPath(AllPathsCtx *ctx) {
 	if(!ctx) return NULL;
 
+	uint64_t steps = 0;
+
 	// As long as path is not empty OR there are neighbors to traverse.
 	while(Path_NodeCount(ctx->path) || _AllPathsCtx_LevelNotEmpty(ctx, 0)) {
+		// expansion may take long without producing a path
+		if((++steps & QUERY_CANCEL_CHECK_MASK) == 0) QueryCtx_CheckCancelled();
+
 		uint32_t depth = Path_NodeCount(ctx->path);
 
 		// Can we advance?
@@ -21,6 +21,7 @@
 #include "../graph/graph.h"
 #include "../graph/entities/node.h"
 #include "../filter_tree/filter_tree.h"
+#include "edge_filter.h"
 
 typedef struct {
 	Node node;
@@ -41,6 +42,7 @@ typedef struct {
 	Record r;                   // Record the traversal is being performed upon, only used for edge filtering.
 	FT_FilterNode *ft;          // FilterTree of predicates to be applied to traversed edges.
 	uint edge_idx;              // Record index of the edge alias, only used for edge filtering.
+	EdgeFilter *edge_filter;    // [optional] Filter applied to traversed edges instead of 'ft'.
 } AllPathsCtx;
 
 // Create a new All paths context object.
@@ -58,6 +60,10 @@ AllPathsCtx *AllPathsCtx_New(
 	uint edge_idx        // Record index of the edge alias.
 );
 
+// Filter traversed edges using 'f' rather than by applying the filter tree
+// 'f' isn't owned by the context and must outlive it.
+void AllPathsCtx_SetEdgeFilter(AllPathsCtx *ctx, EdgeFilter *f);
+
 // Tries to produce a new path from given context
 // If no additional path can be computed return NULL.
 Path *AllPathsCtx_NextPath(AllPathsCtx *ctx);
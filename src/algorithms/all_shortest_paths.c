@@ -0,0 +1,235 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "all_shortest_paths.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+static void _FreeLevels
+(
+	GrB_Vector *levels
+) {
+	uint n = array_len(levels);
+	for(uint i = 0; i < n; i++) GrB_Vector_free(levels + i);
+	array_free(levels);
+}
+
+// expands levels from 'src' until 'dest' is discovered
+// levels[k] holds the nodes at distance k from 'src'
+// valued by the number of shortest paths leading to them
+// returns the number of shortest paths to 'dest', 0 if it wasn't discovered
+static uint64_t _BFS
+(
+	GrB_Matrix A,       // traversed matrix
+	NodeID src,         // paths source
+	NodeID dest,        // paths destination
+	uint max_len,       // maximum number of hops
+	GrB_Vector **levels // [output] discovered levels
+) {
+	GrB_Index n;
+	GrB_Index nvals;
+	GrB_Vector frontier;
+	GrB_Vector visited;
+	uint64_t count = 0;
+	GrB_Info info;
+	UNUSED(info);
+
+	*levels = array_new(GrB_Vector, 1);
+
+	info = GrB_Matrix_nrows(&n, A);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(src == dest) return 1;
+
+	// nodes created after the matrix was exported have no edges
+	if(src >= n || dest >= n) return 0;
+
+	info = GrB_Vector_new(&frontier, GrB_UINT64, n);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_setElement_UINT64(frontier, 1, src);
+	ASSERT(info == GrB_SUCCESS);
+	array_append(*levels, frontier);
+
+	info = GrB_Vector_new(&visited, GrB_BOOL, n);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_setElement_BOOL(visited, true, src);
+	ASSERT(info == GrB_SUCCESS);
+
+	for(uint depth = 1; depth <= max_len; depth++) {
+		// next<!visited> = frontier * A
+		// each node sums the path counts of its parents
+		GrB_Vector next;
+		info = GrB_Vector_new(&next, GrB_UINT64, n);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_vxm(next, visited, NULL, GxB_PLUS_FIRST_UINT64, frontier,
+				A, GrB_DESC_RSC);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = GrB_Vector_nvals(&nvals, next);
+		ASSERT(info == GrB_SUCCESS);
+		if(nvals == 0) {
+			GrB_Vector_free(&next);
+			break;
+		}
+
+		array_append(*levels, next);
+		frontier = next;
+
+		if(GrB_Vector_extractElement_UINT64(&count, next, dest) ==
+				GrB_SUCCESS) {
+			break;
+		}
+
+		// visited<next> = true
+		info = GrB_Vector_assign_BOOL(visited, next, NULL, true, GrB_ALL, 0,
+				GrB_DESC_S);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	GrB_Vector_free(&visited);
+
+	return count;
+}
+
+// reduces each level to the nodes on a shortest path to 'dest'
+// a node of level k is kept if it connects to a kept node of level k + 1
+static void _Prune
+(
+	GrB_Matrix A,       // traversed matrix
+	GrB_Vector *levels, // levels discovered by _BFS
+	NodeID dest         // paths destination
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	uint last = array_len(levels) - 1;
+
+	// dest is the only node kept at the deepest level
+	info = GrB_Vector_clear(levels[last]);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_setElement_UINT64(levels[last], 1, dest);
+	ASSERT(info == GrB_SUCCESS);
+
+	for(uint k = last - 1; k > 0; k--) {
+		// levels[k]<levels[k]> = A * levels[k + 1]
+		info = GrB_mxv(levels[k], levels[k], NULL, GxB_ANY_PAIR_UINT64, A,
+				levels[k + 1], GrB_DESC_RS);
+		ASSERT(info == GrB_SUCCESS);
+	}
+}
+
+// extends 'path' by each kept successor of its last node, depth first
+static void _Enumerate
+(
+	GrB_Matrix A,       // traversed matrix
+	GrB_Vector *levels, // pruned levels
+	GrB_Vector w,       // workspace
+	NodeID *path,       // path so far
+	NodeID ***paths     // [output] complete paths
+) {
+	uint depth = array_len(path) - 1;
+	if(depth == array_len(levels) - 1) {
+		NodeID *p;
+		array_clone(p, path);
+		array_append(*paths, p);
+		return;
+	}
+
+	GrB_Index n;
+	GrB_Index nvals;
+	GrB_Info info;
+	UNUSED(info);
+
+	info = GrB_Vector_size(&n, w);
+	ASSERT(info == GrB_SUCCESS);
+
+	// w<levels[depth + 1]> = A(path[depth], :)
+	info = GrB_Col_extract(w, levels[depth + 1], NULL, A, GrB_ALL, n,
+			path[depth], GrB_DESC_RST0);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Vector_nvals(&nvals, w);
+	ASSERT(info == GrB_SUCCESS);
+
+	// 'w' is reused by deeper levels, copy out the successors
+	GrB_Index *next = rm_malloc(sizeof(GrB_Index) * nvals);
+	info = GrB_Vector_extractTuples_BOOL(next, NULL, &nvals, w);
+	ASSERT(info == GrB_SUCCESS);
+
+	for(GrB_Index i = 0; i < nvals; i++) {
+		array_append(path, next[i]);
+		_Enumerate(A, levels, w, path, paths);
+		array_pop(path);
+	}
+
+	rm_free(next);
+}
+
+uint64_t AllShortestPaths_Count
+(
+	GrB_Matrix A,  // traversed matrix
+	NodeID src,    // paths source
+	NodeID dest,   // paths destination
+	uint max_len   // maximum number of hops
+) {
+	ASSERT(A != NULL);
+
+	GrB_Vector *levels;
+	uint64_t count = _BFS(A, src, dest, max_len, &levels);
+	_FreeLevels(levels);
+
+	return count;
+}
+
+NodeID **AllShortestPaths
+(
+	GrB_Matrix A,  // traversed matrix
+	NodeID src,    // paths source
+	NodeID dest,   // paths destination
+	uint max_len   // maximum number of hops
+) {
+	ASSERT(A != NULL);
+
+	GrB_Vector *levels;
+	uint64_t count = _BFS(A, src, dest, max_len, &levels);
+	if(count == 0) {
+		_FreeLevels(levels);
+		return NULL;
+	}
+
+	// a path visits a single node of each level, reserve room for all of them
+	// such that extending the path never moves it
+	NodeID **paths = array_new(NodeID *, 1);
+	NodeID *path = array_new(NodeID, array_len(levels) + 1);
+	array_append(path, src);
+
+	if(src == dest) {
+		array_append(paths, path);
+		_FreeLevels(levels);
+		return paths;
+	}
+
+	GrB_Index n;
+	GrB_Vector w;
+	GrB_Info info;
+	UNUSED(info);
+
+	info = GrB_Matrix_nrows(&n, A);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_new(&w, GrB_BOOL, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	_Prune(A, levels, dest);
+	_Enumerate(A, levels, w, path, &paths);
+	ASSERT(array_len(paths) == count);
+
+	GrB_Vector_free(&w);
+	array_free(path);
+	_FreeLevels(levels);
+
+	return paths;
+}
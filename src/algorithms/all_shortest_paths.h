@@ -0,0 +1,49 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+#include "../graph/entities/node.h"
+
+// all shortest paths between a source and a destination node
+//
+// a level synchronous BFS is performed from 'src', each level is computed
+// by a single vector matrix multiplication of the previous level against 'A'
+// using the PLUS_FIRST semiring, masked by the nodes discovered so far
+// as such each node of level k holds the number of shortest paths
+// leading to it from 'src', and the destination's value is the number
+// of shortest paths, obtained without enumerating any of them
+//
+// paths are enumerated only after the levels are pruned to the nodes
+// from which the destination is reachable at the remaining depth
+// such that the enumeration never follows a dead end
+//
+// an edge i->j is a nonzero A(i,j)
+// parallel edges connecting the same two nodes are a single connection
+
+// returns the number of shortest paths from 'src' to 'dest'
+// or 0 if 'dest' isn't reachable within 'max_len' hops
+uint64_t AllShortestPaths_Count
+(
+	GrB_Matrix A,  // traversed matrix
+	NodeID src,    // paths source
+	NodeID dest,   // paths destination
+	uint max_len   // maximum number of hops
+);
+
+// returns an array of all shortest paths from 'src' to 'dest'
+// each path is an array of node IDs starting at 'src' and ending at 'dest'
+// returns NULL if 'dest' isn't reachable within 'max_len' hops
+// the returned arrays are owned by the caller and should be freed
+// using array_free
+NodeID **AllShortestPaths
+(
+	GrB_Matrix A,  // traversed matrix
+	NodeID src,    // paths source
+	NodeID dest,   // paths destination
+	uint max_len   // maximum number of hops
+);
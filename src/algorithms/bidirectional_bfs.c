@@ -0,0 +1,191 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "bidirectional_bfs.h"
+#include "../util/arr.h"
+#include "../../deps/rax/rax.h"
+#include "../graph/rg_matrix/rg_matrix_iter.h"
+
+// a single side of the search
+typedef struct {
+	const RG_Matrix *M;  // matrices traversed by this side
+	rax *parents;        // visited nodes, maps each node to its parent
+	NodeID *frontier;    // nodes discovered at the deepest level
+	NodeID *next;        // nodes discovered at the level being expanded
+	uint depth;          // number of levels expanded
+} _BFSSide;
+
+static void _BFSSide_Init
+(
+	_BFSSide *side,
+	const RG_Matrix *M,
+	NodeID root
+) {
+	side->M        = M;
+	side->depth    = 0;
+	side->parents  = raxNew();
+	side->frontier = array_new(NodeID, 1);
+	side->next     = array_new(NodeID, 1);
+
+	// the root is its own parent
+	raxInsert(side->parents, (unsigned char *)&root, sizeof(root),
+			(void *)root, NULL);
+	array_append(side->frontier, root);
+}
+
+static inline NodeID _BFSSide_Parent
+(
+	const _BFSSide *side,
+	NodeID id
+) {
+	void *parent = raxFind(side->parents, (unsigned char *)&id, sizeof(id));
+	ASSERT(parent != raxNotFound);
+	return (NodeID)parent;
+}
+
+static void _BFSSide_Free
+(
+	_BFSSide *side
+) {
+	raxFree(side->parents);
+	array_free(side->frontier);
+	array_free(side->next);
+}
+
+// expands 'side' by a single level
+// returns true and sets 'meet' if a node visited by 'other' was discovered
+static bool _BFSSide_Expand
+(
+	_BFSSide *side,
+	const _BFSSide *other,
+	uint n,
+	NodeID *meet
+) {
+	bool                depleted;
+	GrB_Index           dest_id;
+	RG_MatrixTupleIter  it;
+
+	array_clear(side->next);
+	side->depth++;
+
+	uint frontier_len = array_len(side->frontier);
+	for(uint i = 0; i < n; i++) {
+		RG_MatrixTupleIter_reuse(&it, side->M[i]);
+
+		for(uint j = 0; j < frontier_len; j++) {
+			NodeID src_id = side->frontier[j];
+			RG_MatrixTupleIter_iterate_row(&it, src_id);
+
+			while(true) {
+				RG_MatrixTupleIter_next(&it, NULL, &dest_id, NULL, &depleted);
+				if(depleted) break;
+
+				NodeID id = dest_id;
+				// skip visited nodes
+				if(!raxTryInsert(side->parents, (unsigned char *)&id,
+							sizeof(id), (void *)src_id, NULL)) {
+					continue;
+				}
+
+				// all nodes discovered at this level are at the same distance
+				// from the root, the first to meet the other side
+				// closes a shortest path
+				if(raxFind(other->parents, (unsigned char *)&id, sizeof(id)) !=
+						raxNotFound) {
+					*meet = id;
+					return true;
+				}
+
+				array_append(side->next, id);
+			}
+		}
+	}
+
+	// advance frontier
+	NodeID *frontier = side->frontier;
+	side->frontier = side->next;
+	side->next = frontier;
+
+	return false;
+}
+
+NodeID *BidirectionalBFS
+(
+	const RG_Matrix *M,   // matrices traversed from 'src'
+	const RG_Matrix *MT,  // matrices traversed from 'dest'
+	uint n,               // number of matrices in 'M' and 'MT'
+	NodeID src,           // path source
+	NodeID dest,          // path destination
+	uint max_len          // maximum number of hops
+) {
+	ASSERT(n == 0 || (M != NULL && MT != NULL));
+
+	NodeID *path = NULL;
+
+	if(src == dest) {
+		path = array_new(NodeID, 1);
+		array_append(path, src);
+		return path;
+	}
+
+	_BFSSide fwd;
+	_BFSSide bwd;
+	_BFSSide_Init(&fwd, M, src);
+	_BFSSide_Init(&bwd, MT, dest);
+
+	NodeID meet;
+	bool found = false;
+
+	while(fwd.depth + bwd.depth < max_len) {
+		uint fwd_len = array_len(fwd.frontier);
+		uint bwd_len = array_len(bwd.frontier);
+
+		// either side is exhausted, the two can't meet
+		if(fwd_len == 0 || bwd_len == 0) break;
+
+		// expand the smaller frontier
+		if(fwd_len <= bwd_len) {
+			found = _BFSSide_Expand(&fwd, &bwd, n, &meet);
+		} else {
+			found = _BFSSide_Expand(&bwd, &fwd, n, &meet);
+		}
+
+		if(found) break;
+	}
+
+	if(found) {
+		path = array_new(NodeID, fwd.depth + bwd.depth + 1);
+
+		// backtrack from the meeting point to the source
+		NodeID id = meet;
+		array_append(path, id);
+		while(id != src) {
+			id = _BFSSide_Parent(&fwd, id);
+			array_append(path, id);
+		}
+
+		// reverse, such that the path starts at the source
+		uint len = array_len(path);
+		for(uint i = 0; i < len / 2; i++) {
+			NodeID tmp = path[i];
+			path[i] = path[len - 1 - i];
+			path[len - 1 - i] = tmp;
+		}
+
+		// follow the meeting point's parents to the destination
+		id = meet;
+		while(id != dest) {
+			id = _BFSSide_Parent(&bwd, id);
+			array_append(path, id);
+		}
+	}
+
+	_BFSSide_Free(&fwd);
+	_BFSSide_Free(&bwd);
+
+	return path;
+}
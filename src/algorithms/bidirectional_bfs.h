@@ -0,0 +1,35 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/rg_matrix/rg_matrix.h"
+#include "../graph/entities/node.h"
+
+// finds a shortest path from 'src' to 'dest'
+// two BFS frontiers are expanded level by level, one from 'src' over 'M'
+// and one from 'dest' over the transposes 'MT', at each step the smaller
+// frontier is expanded, the search stops as soon as the frontiers meet
+// this visits far fewer nodes than a single BFS rooted at 'src'
+// as each side only needs to reach half the path's depth
+//
+// an edge src->dest is a nonzero in any of the 'n' matrices in 'M'
+// MT[i] must be the transpose of M[i]
+// for an undirected search pass both M[i] and MT[i] on both sides
+//
+// returns an array of node IDs along the path, starting at 'src' and ending
+// at 'dest', or NULL if 'dest' isn't reachable within 'max_len' hops
+// the returned array is owned by the caller and should be freed
+// using array_free
+NodeID *BidirectionalBFS
+(
+	const RG_Matrix *M,   // matrices traversed from 'src'
+	const RG_Matrix *MT,  // matrices traversed from 'dest'
+	uint n,               // number of matrices in 'M' and 'MT'
+	NodeID src,           // path source
+	NodeID dest,          // path destination
+	uint max_len          // maximum number of hops
+);
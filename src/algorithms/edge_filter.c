@@ -0,0 +1,172 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "edge_filter.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../graph/rg_matrix/rg_matrix_iter.h"
+
+// make sure bitmaps cover edge 'id'
+static void _EdgeFilter_Grow
+(
+	EdgeFilter *f,
+	EntityID id
+) {
+	uint64_t words = (id / 64) + 1;
+	if(words <= f->words) return;
+
+	// grow geometrically to amortize reallocations
+	if(words < f->words * 2) words = f->words * 2;
+
+	f->evaluated = rm_realloc(f->evaluated, sizeof(uint64_t) * words);
+	f->passed    = rm_realloc(f->passed, sizeof(uint64_t) * words);
+
+	size_t added = sizeof(uint64_t) * (words - f->words);
+	memset(f->evaluated + f->words, 0, added);
+	memset(f->passed + f->words, 0, added);
+
+	f->words = words;
+}
+
+EdgeFilter *EdgeFilter_New
+(
+	FT_FilterNode *ft,
+	uint edge_idx,
+	bool memoize
+) {
+	ASSERT(ft != NULL);
+
+	EdgeFilter *f = rm_malloc(sizeof(EdgeFilter));
+
+	f->ft        = ft;
+	f->edge_idx  = edge_idx;
+	f->memoize   = memoize;
+	f->evaluated = NULL;
+	f->passed    = NULL;
+	f->words     = 0;
+
+	return f;
+}
+
+bool EdgeFilter_Pass
+(
+	EdgeFilter *f,
+	Record r,
+	Edge *e
+) {
+	ASSERT(f != NULL);
+	ASSERT(e != NULL);
+
+	EntityID id = ENTITY_GET_ID(e);
+	uint64_t word = id / 64;
+	uint64_t bit = 1ULL << (id % 64);
+
+	if(f->memoize && word < f->words && (f->evaluated[word] & bit)) {
+		return (f->passed[word] & bit) != 0;
+	}
+
+	// update the record with the current edge
+	Record_AddEdge(r, f->edge_idx, *e);
+	bool pass = FilterTree_applyFilters(f->ft, r) == FILTER_PASS;
+
+	if(f->memoize) {
+		_EdgeFilter_Grow(f, id);
+		f->evaluated[word] |= bit;
+		if(pass) f->passed[word] |= bit;
+	}
+
+	return pass;
+}
+
+GrB_Matrix EdgeFilter_Matrix
+(
+	EdgeFilter *f,
+	Record r,
+	const Graph *g,
+	int R,
+	bool transpose
+) {
+	ASSERT(f != NULL);
+	ASSERT(g != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index n = Graph_RequiredMatrixDim(g);
+	GrB_Index *rows = array_new(GrB_Index, 0);
+	GrB_Index *cols = array_new(GrB_Index, 0);
+
+	RG_Matrix M = Graph_GetRelationMatrix(g, R, false);
+	RG_MatrixTupleIter it;
+	info = RG_MatrixTupleIter_reuse(&it, M);
+	ASSERT(info == GrB_SUCCESS);
+
+	Edge e = GE_NEW_EDGE();
+	e.relationID = R;
+
+	bool depleted = false;
+	GrB_Index src;
+	GrB_Index dest;
+	uint64_t v;
+
+	while(true) {
+		RG_MatrixTupleIter_next(&it, &src, &dest, &v, &depleted);
+		if(depleted) break;
+
+		e.srcNodeID  = src;
+		e.destNodeID = dest;
+
+		// keep entry if any of the edges connecting src to dest passes
+		bool pass = false;
+		if(SINGLE_EDGE(v)) {
+			Graph_GetEdge(g, v, &e);
+			pass = EdgeFilter_Pass(f, r, &e);
+		} else {
+			uint64_t count;
+			const EdgeID *ids = RG_Matrix_multiEdgeIDs(M, v, &count);
+			for(uint64_t i = 0; i < count && !pass; i++) {
+				Graph_GetEdge(g, ids[i], &e);
+				pass = EdgeFilter_Pass(f, r, &e);
+			}
+		}
+
+		if(pass) {
+			array_append(rows, transpose ? dest : src);
+			array_append(cols, transpose ? src : dest);
+		}
+	}
+
+	GrB_Matrix A;
+	info = GrB_Matrix_new(&A, GrB_BOOL, n, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_Index nvals = array_len(rows);
+	if(nvals > 0) {
+		bool *vals = rm_malloc(sizeof(bool) * nvals);
+		for(GrB_Index i = 0; i < nvals; i++) vals[i] = true;
+		info = GrB_Matrix_build_BOOL(A, rows, cols, vals, nvals, GrB_LOR);
+		ASSERT(info == GrB_SUCCESS);
+		rm_free(vals);
+	}
+
+	array_free(rows);
+	array_free(cols);
+
+	return A;
+}
+
+void EdgeFilter_Free
+(
+	EdgeFilter *f
+) {
+	if(f == NULL) return;
+
+	if(f->evaluated) rm_free(f->evaluated);
+	if(f->passed) rm_free(f->passed);
+	rm_free(f);
+}
+
@@ -0,0 +1,62 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/graph.h"
+#include "../graph/entities/edge.h"
+#include "../filter_tree/filter_tree.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// EdgeFilter applies a filter tree to traversed edges
+//
+// when the filter depends on nothing but the edge, e.g. [:TX*1..5 {flagged: false}]
+// its outcome is memoized per edge ID, such that each edge is evaluated at
+// most once throughout the query no matter how many paths it is on
+typedef struct {
+	FT_FilterNode *ft;    // filter tree applied to edges
+	uint edge_idx;        // record index of the edge alias
+	bool memoize;         // filter outcome depends on edge alone
+	uint64_t *evaluated;  // bitmap of evaluated edges
+	uint64_t *passed;     // bitmap of edges passing the filter
+	uint64_t words;       // number of words in each bitmap
+} EdgeFilter;
+
+// create a new edge filter
+EdgeFilter *EdgeFilter_New
+(
+	FT_FilterNode *ft,  // filter tree applied to edges, not owned
+	uint edge_idx,      // record index of the edge alias
+	bool memoize        // filter outcome depends on edge alone
+);
+
+// returns true if 'e' passes filter
+// 'r' is updated with 'e' at 'edge_idx'
+bool EdgeFilter_Pass
+(
+	EdgeFilter *f,  // edge filter
+	Record r,       // record to evaluate the filter against
+	Edge *e         // edge to filter
+);
+
+// build a boolean matrix holding an entry for each pair of nodes connected
+// by at least one edge of relationship 'R' passing the filter
+// the matrix is transposed if 'transpose' is set
+GrB_Matrix EdgeFilter_Matrix
+(
+	EdgeFilter *f,  // edge filter
+	Record r,       // record to evaluate the filter against
+	const Graph *g, // graph
+	int R,          // relationship ID
+	bool transpose  // transpose resulting matrix
+);
+
+// free edge filter
+void EdgeFilter_Free
+(
+	EdgeFilter *f
+);
+
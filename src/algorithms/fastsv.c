@@ -0,0 +1,102 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "fastsv.h"
+#include "../util/rmalloc.h"
+
+GrB_Info FastSV
+(
+	GrB_Index **components,
+	GrB_Matrix A
+) {
+	ASSERT(A          != NULL);
+	ASSERT(components != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index n;
+	*components = NULL;
+
+	info = GrB_Matrix_nrows(&n, A);
+	ASSERT(info == GrB_SUCCESS);
+	if(n == 0) return GrB_SUCCESS;
+
+	GrB_Vector f      = NULL;  // parent of each node
+	GrB_Vector gp     = NULL;  // grandparent of each node
+	GrB_Vector gp_new = NULL;  // grandparent after current iteration
+	GrB_Vector mngp   = NULL;  // minimum grandparent among neighbors
+	GrB_Vector mod    = NULL;  // grandparent changed
+
+	GrB_Index *V = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+
+	// each node starts as its own parent
+	for(GrB_Index i = 0; i < n; i++) I[i] = i;
+
+	GrB_Vector_new(&f, GrB_UINT64, n);
+	GrB_Vector_new(&mod, GrB_BOOL, n);
+	GrB_Vector_new(&gp_new, GrB_UINT64, n);
+
+	info = GrB_Vector_build_UINT64(f, I, I, n, GrB_PLUS_UINT64);
+	ASSERT(info == GrB_SUCCESS);
+	GrB_Vector_dup(&gp, f);
+	GrB_Vector_dup(&mngp, f);
+
+	bool changed = true;
+	while(changed) {
+		// mngp = min(mngp, A min.second gp)
+		info = GrB_mxv(mngp, GrB_NULL, GrB_MIN_UINT64,
+				GrB_MIN_SECOND_SEMIRING_UINT64, A, gp, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// stochastic hooking: f[f[u]] = min(f[f[u]], mngp[u])
+		info = GrB_Vector_extractTuples_UINT64(GrB_NULL, V, &n, f);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_assign(f, GrB_NULL, GrB_MIN_UINT64, mngp, V, n,
+				GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// aggressive hooking and shortcutting: f = min(f, mngp, gp)
+		info = GrB_Vector_eWiseAdd_BinaryOp(f, GrB_NULL, GrB_MIN_UINT64,
+				GrB_MIN_UINT64, mngp, gp, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// gp_new = f[f]
+		info = GrB_Vector_extractTuples_UINT64(GrB_NULL, V, &n, f);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_extract(gp_new, GrB_NULL, GrB_NULL, f, V, n,
+				GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// done once grandparents are stable
+		info = GrB_Vector_eWiseMult_BinaryOp(mod, GrB_NULL, GrB_NULL,
+				GrB_NE_UINT64, gp_new, gp, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_reduce_BOOL(&changed, GrB_NULL, GrB_LOR_MONOID_BOOL,
+				mod, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_Vector swap = gp;
+		gp = gp_new;
+		gp_new = swap;
+	}
+
+	// f is dense, its entries are the components
+	info = GrB_Vector_extractTuples_UINT64(I, V, &n, f);
+	ASSERT(info == GrB_SUCCESS);
+
+	rm_free(I);
+	GrB_free(&f);
+	GrB_free(&gp);
+	GrB_free(&gp_new);
+	GrB_free(&mngp);
+	GrB_free(&mod);
+
+	*components = V;
+	return GrB_SUCCESS;
+}
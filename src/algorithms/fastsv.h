@@ -0,0 +1,19 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// computes the connected components of undirected graph 'A'
+// using the FastSV algorithm (Zhang, Azad and Buluc, 2020)
+// 'components' is a dense array of n entries, components[i] is the
+// smallest row index of the component row i belongs to
+GrB_Info FastSV
+(
+	GrB_Index **components,  // [output] component of each node
+	GrB_Matrix A             // symmetric input graph, not modified
+);
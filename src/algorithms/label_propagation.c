@@ -0,0 +1,147 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "label_propagation.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../configuration/config.h"
+
+#include <omp.h>
+
+#define LABEL_ISLT(a,b) (*(a) < *(b))
+
+// returns the most frequent label among 'neighbors'
+// ties are broken by the smallest label
+static GrB_Index _MostFrequentLabel
+(
+	GrB_Index *neighbors,  // neighbors labels, reordered
+	GrB_Index count        // number of neighbors
+) {
+	QSORT(GrB_Index, neighbors, count, LABEL_ISLT);
+
+	GrB_Index best       = neighbors[0];
+	GrB_Index best_count = 0;
+
+	GrB_Index run = 0;
+	for(GrB_Index k = 0; k < count; k++) {
+		run++;
+		// end of run
+		if(k + 1 == count || neighbors[k + 1] != neighbors[k]) {
+			if(run > best_count) {
+				best       = neighbors[k];
+				best_count = run;
+			}
+			run = 0;
+		}
+	}
+
+	return best;
+}
+
+GrB_Info LabelPropagation
+(
+	GrB_Index **labels,
+	GrB_Matrix A,
+	int itermax,
+	int *iters
+) {
+	ASSERT(A      != NULL);
+	ASSERT(iters  != NULL);
+	ASSERT(labels != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index n;
+	GrB_Index nvals;
+	*labels = NULL;
+	*iters  = 0;
+
+	info = GrB_Matrix_nrows(&n, A);
+	ASSERT(info == GrB_SUCCESS);
+	if(n == 0) return GrB_SUCCESS;
+
+	info = GrB_Matrix_nvals(&nvals, A);
+	ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// build CSR adjacency
+	//--------------------------------------------------------------------------
+
+	GrB_Index *I  = rm_malloc(sizeof(GrB_Index) * nvals);
+	GrB_Index *J  = rm_malloc(sizeof(GrB_Index) * nvals);
+	GrB_Index *Ap = rm_calloc(n + 1, sizeof(GrB_Index));
+	GrB_Index *Aj = rm_malloc(sizeof(GrB_Index) * nvals);
+
+	info = GrB_Matrix_extractTuples_FP64(I, J, GrB_NULL, &nvals, A);
+	ASSERT(info == GrB_SUCCESS);
+
+	for(GrB_Index k = 0; k < nvals; k++) Ap[I[k] + 1]++;
+	GrB_Index max_degree = 0;
+	for(GrB_Index i = 0; i < n; i++) {
+		if(Ap[i + 1] > max_degree) max_degree = Ap[i + 1];
+		Ap[i + 1] += Ap[i];
+	}
+
+	// scatter columns into their rows
+	GrB_Index *pos = rm_malloc(sizeof(GrB_Index) * n);
+	memcpy(pos, Ap, sizeof(GrB_Index) * n);
+	for(GrB_Index k = 0; k < nvals; k++) Aj[pos[I[k]]++] = J[k];
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(pos);
+
+	//--------------------------------------------------------------------------
+	// propagate labels
+	//--------------------------------------------------------------------------
+
+	GrB_Index *L    = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *next = rm_malloc(sizeof(GrB_Index) * n);
+	for(GrB_Index i = 0; i < n; i++) L[i] = i;
+
+	uint nthreads;
+	Config_Option_get(Config_OPENMP_NTHREAD, &nthreads);
+
+	bool changed = true;
+	while(changed && *iters < itermax) {
+		(*iters)++;
+		changed = false;
+
+		#pragma omp parallel num_threads(nthreads) reduction(||:changed)
+		{
+			GrB_Index *neighbors = rm_malloc(sizeof(GrB_Index) * (max_degree + 1));
+
+			#pragma omp for schedule(dynamic, 1024)
+			for(GrB_Index i = 0; i < n; i++) {
+				// a node votes for its own label as well, preventing
+				// labels from oscillating between bipartite neighbors
+				GrB_Index degree = Ap[i + 1] - Ap[i];
+				neighbors[0] = L[i];
+				for(GrB_Index k = 0; k < degree; k++) {
+					neighbors[k + 1] = L[Aj[Ap[i] + k]];
+				}
+
+				next[i] = _MostFrequentLabel(neighbors, degree + 1);
+				changed = changed || (next[i] != L[i]);
+			}
+
+			rm_free(neighbors);
+		}
+
+		GrB_Index *swap = L;
+		L = next;
+		next = swap;
+	}
+
+	rm_free(Ap);
+	rm_free(Aj);
+	rm_free(next);
+
+	*labels = L;
+	return GrB_SUCCESS;
+}
@@ -0,0 +1,23 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// detects communities of undirected graph 'A' by synchronous label
+// propagation, each node starts with its own label and repeatedly adopts
+// the most frequent label among itself and its neighbors, ties broken by
+// the smallest label, until labels are stable or 'itermax' iterations
+// were performed
+// 'labels' is a dense array of n entries, labels are row indices
+GrB_Info LabelPropagation
+(
+	GrB_Index **labels,  // [output] community of each node
+	GrB_Matrix A,        // symmetric input graph, not modified
+	int itermax,         // max number of iterations
+	int *iters           // [output] number of iterations taken
+);
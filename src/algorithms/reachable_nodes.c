@@ -0,0 +1,221 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "reachable_nodes.h"
+#include "../util/rmalloc.h"
+
+#include <math.h>
+
+// set the nodes to return to the entries of the current frontier
+static void _ReachableNodesCtx_CollectFrontier
+(
+	ReachableNodesCtx *ctx
+) {
+	GrB_Index nvals;
+	GrB_Info info = GrB_Vector_nvals(&nvals, ctx->frontier);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(nvals > ctx->node_cap) {
+		ctx->node_cap = nvals;
+		ctx->nodes = rm_realloc(ctx->nodes, sizeof(GrB_Index) * nvals);
+	}
+
+	info = GrB_Vector_extractTuples_BOOL(ctx->nodes, NULL, &nvals,
+			ctx->frontier);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	ctx->pos = 0;
+	ctx->node_count = nvals;
+}
+
+// returns true if the next level is cheaper to compute by pulling
+// pushing scans the out-going edges of each of the 'nq' frontier nodes
+// pulling scans the in-coming edges of each unvisited node, until one
+// originating at the frontier is found, see LAGraph_bfs_pushpull
+static bool _ReachableNodesCtx_Pull
+(
+	const ReachableNodesCtx *ctx,
+	GrB_Index nq
+) {
+	if(ctx->AT == NULL || nq == 0) return false;
+
+	double push_work = ctx->degree * nq;
+	double expected  = (double)ctx->n / (double)(ctx->visited_count + 1);
+	double per_dot   = (ctx->degree < expected) ? ctx->degree : expected;
+	double search    = 3 * (1 + log2((double)nq));
+	double pull_work = (ctx->n - ctx->visited_count) * per_dot * search;
+
+	return pull_work < push_work;
+}
+
+// advance frontier by a single level
+// returns false if no new nodes were discovered
+static bool _ReachableNodesCtx_Expand
+(
+	ReachableNodesCtx *ctx
+) {
+	GrB_Index nvals;
+	GrB_Info info;
+	UNUSED(info);
+
+	info = GrB_Vector_nvals(&nvals, ctx->frontier);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(_ReachableNodesCtx_Pull(ctx, nvals)) {
+		// frontier<!visited> = AT * frontier
+		info = GrB_mxv(ctx->frontier, ctx->visited, NULL, GxB_ANY_PAIR_BOOL,
+				ctx->AT, ctx->frontier, GrB_DESC_RSC);
+	} else {
+		// frontier<!visited> = frontier * A
+		info = GrB_vxm(ctx->frontier, ctx->visited, NULL, GxB_ANY_PAIR_BOOL,
+				ctx->frontier, ctx->A, GrB_DESC_RSC);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Vector_nvals(&nvals, ctx->frontier);
+	ASSERT(info == GrB_SUCCESS);
+	if(nvals == 0) return false;
+
+	// visited<frontier> = true
+	info = GrB_Vector_assign_BOOL(ctx->visited, ctx->frontier, NULL, true,
+			GrB_ALL, 0, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+
+	ctx->visited_count += nvals;
+	ctx->level++;
+	return true;
+}
+
+ReachableNodesCtx *ReachableNodesCtx_New
+(
+	GrB_Matrix A,   // matrix describing connections
+	GrB_Matrix AT,  // transpose of 'A', NULL for push-only traversal
+	uint minLen,    // minimum traversal depth, either 0 or 1
+	uint maxLen     // maximum traversal depth
+) {
+	ASSERT(A != NULL);
+	ASSERT(minLen <= 1);
+
+	GrB_Index n;
+	GrB_Index nvals;
+	GrB_Info info;
+	UNUSED(info);
+
+	ReachableNodesCtx *ctx = rm_calloc(1, sizeof(ReachableNodesCtx));
+
+	ctx->A      = A;
+	ctx->AT     = AT;
+	ctx->minLen = minLen;
+	ctx->maxLen = maxLen;
+
+	info = GrB_Matrix_nrows(&n, ctx->A);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_nvals(&nvals, ctx->A);
+	ASSERT(info == GrB_SUCCESS);
+
+	ctx->n      = n;
+	ctx->degree = (n > 0) ? (double)nvals / (double)n : 0;
+
+	info = GrB_Vector_new(&ctx->frontier, GrB_BOOL, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Vector_new(&ctx->visited, GrB_BOOL, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	return ctx;
+}
+
+void ReachableNodesCtx_Reset
+(
+	ReachableNodesCtx *ctx,  // reachable nodes context to reset
+	EntityID src             // source node from which to traverse
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(src != INVALID_ENTITY_ID);
+
+	GrB_Index n;
+	GrB_Info info;
+	UNUSED(info);
+
+	ctx->pos           = 0;
+	ctx->level         = 0;
+	ctx->node_count    = 0;
+	ctx->visited_count = 0;
+
+	info = GrB_Vector_clear(ctx->frontier);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_clear(ctx->visited);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Vector_size(&n, ctx->frontier);
+	ASSERT(info == GrB_SUCCESS);
+
+	// source created after the matrix was exported has no outgoing edges
+	if(src >= n) {
+		ctx->level = ctx->maxLen;
+		if(ctx->minLen == 0) {
+			if(ctx->node_cap == 0) {
+				ctx->node_cap = 1;
+				ctx->nodes = rm_malloc(sizeof(GrB_Index));
+			}
+			ctx->nodes[0] = src;
+			ctx->node_count = 1;
+		}
+		return;
+	}
+
+	info = GrB_Vector_setElement_BOOL(ctx->frontier, true, src);
+	ASSERT(info == GrB_SUCCESS);
+
+	// with a minimum depth of 0 'src' is returned at level 0 and never again
+	// otherwise 'src' is returned only once it is rediscovered
+	if(ctx->minLen == 0) {
+		info = GrB_Vector_setElement_BOOL(ctx->visited, true, src);
+		ASSERT(info == GrB_SUCCESS);
+		ctx->visited_count = 1;
+		_ReachableNodesCtx_CollectFrontier(ctx);
+	}
+}
+
+EntityID ReachableNodesCtx_NextNode
+(
+	ReachableNodesCtx *ctx
+) {
+	ASSERT(ctx != NULL);
+
+	while(ctx->pos == ctx->node_count) {
+		if(ctx->level >= ctx->maxLen) return INVALID_ENTITY_ID;
+
+		if(!_ReachableNodesCtx_Expand(ctx)) {
+			// no new nodes, traversal is done
+			ctx->level = ctx->maxLen;
+			return INVALID_ENTITY_ID;
+		}
+
+		_ReachableNodesCtx_CollectFrontier(ctx);
+	}
+
+	return ctx->nodes[ctx->pos++];
+}
+
+void ReachableNodesCtx_Free
+(
+	ReachableNodesCtx *ctx
+) {
+	if(!ctx) return;
+
+	GrB_Matrix_free(&ctx->A);
+	if(ctx->AT) GrB_Matrix_free(&ctx->AT);
+	GrB_Vector_free(&ctx->frontier);
+	GrB_Vector_free(&ctx->visited);
+	if(ctx->nodes) rm_free(ctx->nodes);
+
+	rm_free(ctx);
+}
+
@@ -0,0 +1,76 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+#include "../graph/entities/node.h"
+
+// performs a level synchronous BFS from 'src'
+// each level is computed by a single vector matrix multiplication of the
+// previous level against the adjacency matrix, masked by the nodes
+// discovered so far
+//
+// unlike AllNeighborsCtx each reachable destination node is returned once
+// regardless of the number of paths leading to it, the work performed is
+// bounded by the number of levels times the number of edges
+//
+// a node is returned if its distance from 'src' is within
+// [minLen, maxLen], as such 'minLen' must not exceed 1, with a minimum of
+// 1 'src' itself is returned if it is on a cycle of at most 'maxLen' hops
+//
+// when the transpose of the adjacency matrix is provided, each level is
+// computed either by pushing the frontier along its out-going edges
+// or by having every unvisited node pull from its in-coming edges,
+// whichever is estimated to be cheaper, as in LAGraph_bfs_pushpull
+// pulling pays off once the frontier covers a large part of the graph
+
+typedef struct {
+	GrB_Matrix A;             // adjacency matrix
+	GrB_Matrix AT;            // transposed adjacency matrix, optional
+	double degree;            // average out-degree
+	GrB_Index n;              // number of nodes
+	GrB_Vector frontier;      // nodes discovered at the current level
+	GrB_Vector visited;       // nodes discovered so far
+	GrB_Index visited_count;  // number of nodes discovered so far
+	GrB_Index *nodes;         // nodes of the current level to return
+	GrB_Index node_count;     // number of nodes in 'nodes'
+	GrB_Index node_cap;       // capacity of 'nodes'
+	GrB_Index pos;            // position of next node to return
+	uint minLen;              // minimum required depth
+	uint maxLen;              // maximum allowed depth
+	uint level;               // current depth
+} ReachableNodesCtx;
+
+// create a new context traversing 'A'
+// the context takes ownership of 'A' and 'AT'
+ReachableNodesCtx *ReachableNodesCtx_New
+(
+	GrB_Matrix A,   // matrix describing connections
+	GrB_Matrix AT,  // transpose of 'A', NULL for push-only traversal
+	uint minLen,    // minimum traversal depth, either 0 or 1
+	uint maxLen     // maximum traversal depth
+);
+
+// restart traversal from 'src'
+void ReachableNodesCtx_Reset
+(
+	ReachableNodesCtx *ctx,  // reachable nodes context to reset
+	EntityID src             // source node from which to traverse
+);
+
+// produce next reachable destination node
+// returns INVALID_ENTITY_ID once depleted
+EntityID ReachableNodesCtx_NextNode
+(
+	ReachableNodesCtx *ctx
+);
+
+void ReachableNodesCtx_Free
+(
+	ReachableNodesCtx *ctx
+);
+
@@ -0,0 +1,68 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "triangle_count.h"
+#include "../util/rmalloc.h"
+
+GrB_Info TriangleCount
+(
+	uint64_t **triangles,
+	GrB_Matrix A
+) {
+	ASSERT(A         != NULL);
+	ASSERT(triangles != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index n;
+	*triangles = NULL;
+
+	info = GrB_Matrix_nrows(&n, A);
+	ASSERT(info == GrB_SUCCESS);
+	if(n == 0) return GrB_SUCCESS;
+
+	GrB_Matrix S = NULL;  // A without self loops
+	GrB_Matrix C = NULL;  // C(i,j) number of paths of length 2 from i to j
+	GrB_Vector t = NULL;  // twice the number of triangles per node
+
+	GrB_Matrix_new(&S, GrB_BOOL, n, n);
+	GrB_Matrix_new(&C, GrB_UINT64, n, n);
+	GrB_Vector_new(&t, GrB_UINT64, n);
+
+	info = GxB_Matrix_select(S, GrB_NULL, GrB_NULL, GxB_OFFDIAG, A, GrB_NULL,
+			GrB_NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	// C<S> = S * S, each connected pair (i,j) holds
+	// the number of triangles the edge i-j participates in
+	info = GrB_mxm(C, S, GrB_NULL, GxB_PLUS_PAIR_UINT64, S, S, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+
+	// t = sum(C, 2), each triangle is counted once per adjacent edge
+	info = GrB_Matrix_reduce_Monoid(t, GrB_NULL, GrB_NULL,
+			GrB_PLUS_MONOID_UINT64, C, GrB_NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_Index nvals = n;
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t *X = rm_malloc(sizeof(uint64_t) * n);
+	uint64_t *T = rm_calloc(n, sizeof(uint64_t));
+
+	info = GrB_Vector_extractTuples_UINT64(I, X, &nvals, t);
+	ASSERT(info == GrB_SUCCESS);
+	for(GrB_Index k = 0; k < nvals; k++) T[I[k]] = X[k] / 2;
+
+	rm_free(I);
+	rm_free(X);
+	GrB_free(&S);
+	GrB_free(&C);
+	GrB_free(&t);
+
+	*triangles = T;
+	return GrB_SUCCESS;
+}
@@ -0,0 +1,18 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// counts the triangles each node of undirected graph 'A' participates in
+// self loops are ignored
+// 'triangles' is a dense array of n entries
+GrB_Info TriangleCount
+(
+	uint64_t **triangles,  // [output] number of triangles per node
+	GrB_Matrix A           // symmetric input graph, not modified
+);
@@ -0,0 +1,153 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "weighted_pagerank.h"
+#include "../util/rmalloc.h"
+
+GrB_Info WeightedPagerank
+(
+	double **ranks,
+	GrB_Matrix A,
+	GrB_Vector p,
+	double damping,
+	int itermax,
+	double tol,
+	int *iters
+) {
+	ASSERT(A     != NULL);
+	ASSERT(ranks != NULL);
+	ASSERT(iters != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index n;
+	*ranks = NULL;
+	*iters = 0;
+
+	info = GrB_Matrix_nrows(&n, A);
+	ASSERT(info == GrB_SUCCESS);
+	if(n == 0) return GrB_SUCCESS;
+
+	GrB_Vector w   = NULL;  // out-going weight of each node
+	GrB_Vector j   = NULL;  // jump distribution
+	GrB_Vector r   = NULL;  // current ranks
+	GrB_Vector t   = NULL;  // next ranks
+	GrB_Vector s   = NULL;  // rank passed per unit of out-going weight
+	GrB_Vector tmp = NULL;
+
+	GrB_Vector_new(&w, GrB_FP64, n);
+	GrB_Vector_new(&j, GrB_FP64, n);
+	GrB_Vector_new(&t, GrB_FP64, n);
+	GrB_Vector_new(&s, GrB_FP64, n);
+	GrB_Vector_new(&tmp, GrB_FP64, n);
+
+	// w = sum(A, 2)
+	info = GrB_Matrix_reduce_Monoid(w, GrB_NULL, GrB_NULL,
+			GrB_PLUS_MONOID_FP64, A, GrB_NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(p == NULL) {
+		info = GrB_Vector_assign_FP64(j, GrB_NULL, GrB_NULL, 1.0 / n, GrB_ALL,
+				n, GrB_NULL);
+	} else {
+		// normalize p
+		double psum;
+		info = GrB_Vector_reduce_FP64(&psum, GrB_NULL, GrB_PLUS_MONOID_FP64, p,
+				GrB_NULL);
+		ASSERT(info == GrB_SUCCESS && psum > 0);
+		info = GrB_Vector_apply_BinaryOp2nd_FP64(j, GrB_NULL, GrB_NULL,
+				GrB_DIV_FP64, p, psum, GrB_NULL);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	// start at the jump distribution
+	info = GrB_Vector_dup(&r, j);
+	ASSERT(info == GrB_SUCCESS);
+
+	while(*iters < itermax) {
+		(*iters)++;
+
+		double total;    // sum(r)
+		double linked;   // rank held by nodes with out-going edges
+		double delta;    // L1 norm of r - t
+
+		info = GrB_Vector_reduce_FP64(&total, GrB_NULL, GrB_PLUS_MONOID_FP64,
+				r, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// s = r ./ w
+		info = GrB_Vector_eWiseMult_BinaryOp(s, GrB_NULL, GrB_NULL,
+				GrB_DIV_FP64, r, w, GrB_DESC_R);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = GrB_Vector_eWiseMult_BinaryOp(tmp, GrB_NULL, GrB_NULL,
+				GrB_FIRST_FP64, r, w, GrB_DESC_R);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_reduce_FP64(&linked, GrB_NULL, GrB_PLUS_MONOID_FP64,
+				tmp, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// t = damping * (s * A)
+		info = GrB_vxm(t, GrB_NULL, GrB_NULL, GrB_PLUS_TIMES_SEMIRING_FP64, s,
+				A, GrB_DESC_R);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_apply_BinaryOp2nd_FP64(t, GrB_NULL, GrB_NULL,
+				GrB_TIMES_FP64, t, damping, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// jumps and the rank of nodes without out-going edges
+		// are distributed according to j
+		double jump = (1 - damping) * total + damping * (total - linked);
+		info = GrB_Vector_apply_BinaryOp2nd_FP64(tmp, GrB_NULL, GrB_NULL,
+				GrB_TIMES_FP64, j, jump, GrB_DESC_R);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_eWiseAdd_BinaryOp(t, GrB_NULL, GrB_NULL,
+				GrB_PLUS_FP64, t, tmp, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		// delta = sum(abs(t - r))
+		info = GrB_Vector_eWiseAdd_BinaryOp(tmp, GrB_NULL, GrB_NULL,
+				GrB_MINUS_FP64, t, r, GrB_DESC_R);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_apply(tmp, GrB_NULL, GrB_NULL, GrB_ABS_FP64, tmp,
+				GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_reduce_FP64(&delta, GrB_NULL, GrB_PLUS_MONOID_FP64,
+				tmp, GrB_NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_Vector swap = r;
+		r = t;
+		t = swap;
+
+		if(delta < tol) break;
+	}
+
+	// scatter r into a dense array, nodes never reached rank 0
+	GrB_Index nvals = n;
+	GrB_Index *I = rm_malloc(sizeof(GrB_Index) * n);
+	double *X = rm_malloc(sizeof(double) * n);
+	double *R = rm_calloc(n, sizeof(double));
+
+	info = GrB_Vector_extractTuples_FP64(I, X, &nvals, r);
+	ASSERT(info == GrB_SUCCESS);
+	for(GrB_Index k = 0; k < nvals; k++) R[I[k]] = X[k];
+
+	rm_free(I);
+	rm_free(X);
+
+	GrB_free(&w);
+	GrB_free(&j);
+	GrB_free(&r);
+	GrB_free(&t);
+	GrB_free(&s);
+	GrB_free(&tmp);
+
+	*ranks = R;
+	return GrB_SUCCESS;
+}
@@ -0,0 +1,30 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// computes the pagerank of each node of weighted graph 'A'
+// a node distributes its rank among its out-going edges
+// proportionally to their weight, A(i,j)
+//
+// when 'p' is specified, random jumps land on node i with probability p(i),
+// yielding the personalized pagerank with respect to 'p', otherwise jumps
+// are uniform, rank of nodes without out-going edges is distributed likewise
+//
+// iterations stop once the L1 norm of the rank change drops below 'tol'
+// 'ranks' is a dense array of n entries summing up to 1
+GrB_Info WeightedPagerank
+(
+	double **ranks,    // [output] rank of each node
+	GrB_Matrix A,      // FP64 weighted input graph, not modified
+	GrB_Vector p,      // FP64 jump distribution, optional
+	double damping,    // probability of following an edge
+	int itermax,       // max number of iterations
+	double tol,        // convergence tolerance
+	int *iters         // [output] number of iterations taken
+);
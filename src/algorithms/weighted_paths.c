@@ -0,0 +1,483 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rax.h"
+#include "weighted_paths.h"
+#include "../util/arr.h"
+#include "../util/heap.h"
+#include "../util/rmalloc.h"
+
+#include <math.h>
+
+// a search state, 'node' reached by 'len' edges weighing 'weight'
+typedef struct {
+	NodeID node;      // reached node
+	uint len;         // number of edges leading to node
+	double weight;    // weight of edges leading to node
+	int64_t parent;   // previous state index, -1 for the source
+	Edge edge;        // edge connecting parent to node
+} SearchState;
+
+// single search, from a source to a destination or to all reachable nodes
+typedef struct {
+	const WeightedPathCtx *ctx;  // traversal constraints
+	SearchState *states;         // discovered states
+	heap_t *pending;             // pending state indices, lightest first
+	rax *settled;                // node ID -> 1 + length it was settled with
+	int64_t *order;              // first settled state per node, if collected
+} Search;
+
+// a search is bounded by length if max_len is set, in which case a node
+// might be settled multiple times, each time reached by fewer edges
+#define BOUNDED(ctx) ((ctx)->max_len != UINT_MAX)
+
+// heap items are state indices offset by 1, as NULL marks an empty heap
+#define STATE_ITEM(idx) ((void *)(intptr_t)((idx) + 1))
+#define ITEM_STATE(item) ((int64_t)(intptr_t)(item) - 1)
+
+static int _StateCmp
+(
+	const void *a,
+	const void *b,
+	const void *udata
+) {
+	const SearchState *states = *(SearchState **)udata;
+	const SearchState *sa = states + ITEM_STATE(a);
+	const SearchState *sb = states + ITEM_STATE(b);
+
+	// heap is a max-heap, lighter states have higher priority
+	if(sa->weight < sb->weight) return 1;
+	if(sa->weight > sb->weight) return -1;
+	if(sa->len < sb->len) return 1;
+	if(sa->len > sb->len) return -1;
+	return 0;
+}
+
+static inline bool _RaxContains
+(
+	rax *r,
+	EntityID id
+) {
+	return r != NULL &&
+		raxFind(r, (unsigned char *)&id, sizeof(id)) != raxNotFound;
+}
+
+// returns false if edge can't be traversed
+static bool _EdgeWeight
+(
+	const WeightedPathCtx *ctx,
+	Edge *e,
+	double *w
+) {
+	if(ctx->weight == ATTRIBUTE_NOTFOUND) {
+		*w = 1;
+		return true;
+	}
+
+	SIValue *v = GraphEntity_GetProperty((GraphEntity *)e, ctx->weight);
+	if(v == PROPERTY_NOTFOUND || !(SI_TYPE(*v) & SI_NUMERIC)) return false;
+
+	SIValue_ToDouble(v, w);
+	return *w >= 0;
+}
+
+static void _Push
+(
+	Search *s,
+	SearchState state
+) {
+	int64_t idx = array_len(s->states);
+	array_append(s->states, state);
+	Heap_offer(&s->pending, STATE_ITEM(idx));
+}
+
+// expands state 'idx', pushing states reachable over a single edge
+static void _Expand
+(
+	Search *s,
+	int64_t idx,
+	rax *banned_nodes,
+	rax *banned_edges,
+	uint max_len,
+	double max_weight
+) {
+	const WeightedPathCtx *ctx = s->ctx;
+	SearchState state = s->states[idx];
+	if(state.len >= max_len) return;
+
+	Node n;
+	Graph_GetNode(ctx->g, state.node, &n);
+
+	Edge *edges = array_new(Edge, 0);
+	if(ctx->relations == NULL) {
+		Graph_GetNodeEdges(ctx->g, &n, ctx->dir, GRAPH_NO_RELATION, &edges);
+	} else {
+		uint relation_count = array_len(ctx->relations);
+		for(uint i = 0; i < relation_count; i++) {
+			Graph_GetNodeEdges(ctx->g, &n, ctx->dir, ctx->relations[i], &edges);
+		}
+	}
+
+	uint edge_count = array_len(edges);
+	for(uint i = 0; i < edge_count; i++) {
+		Edge *e = edges + i;
+		if(_RaxContains(banned_edges, ENTITY_GET_ID(e))) continue;
+
+		NodeID next = (e->srcNodeID == state.node) ?
+			e->destNodeID : e->srcNodeID;
+		if(_RaxContains(banned_nodes, next)) continue;
+
+		double w;
+		if(!_EdgeWeight(ctx, e, &w)) continue;
+		if(state.weight + w > max_weight) continue;
+
+		// skip nodes already settled by as few edges
+		uint len = state.len + 1;
+		void *settled = raxFind(s->settled, (unsigned char *)&next,
+				sizeof(next));
+		if(settled != raxNotFound &&
+		   (!BOUNDED(ctx) || (uintptr_t)settled - 1 <= len)) {
+			continue;
+		}
+
+		SearchState succ = {
+			.node   = next,
+			.len    = len,
+			.weight = state.weight + w,
+			.parent = idx,
+			.edge   = *e,
+		};
+		_Push(s, succ);
+	}
+
+	array_free(edges);
+}
+
+// searches for the lightest path from 'src' to 'dest'
+// if 'dest' is INVALID_ENTITY_ID all reachable nodes are settled
+// returns the state reaching 'dest', -1 if unreachable
+static int64_t _Search
+(
+	Search *s,
+	NodeID src,
+	NodeID dest,
+	rax *banned_nodes,
+	rax *banned_edges,
+	uint max_len,
+	double max_weight
+) {
+	SearchState first = {
+		.node   = src,
+		.len    = 0,
+		.weight = 0,
+		.parent = -1,
+		.edge   = GE_NEW_EDGE(),
+	};
+	_Push(s, first);
+
+	void *item;
+	while((item = Heap_poll(s->pending)) != NULL) {
+		int64_t idx = ITEM_STATE(item);
+		SearchState *state = s->states + idx;
+		NodeID id = state->node;
+
+		// states are settled in ascending weight order, a state is dominated
+		// by an earlier one of the same node reached by as few edges
+		uintptr_t len = BOUNDED(s->ctx) ? state->len : 0;
+		void *settled = raxFind(s->settled, (unsigned char *)&id, sizeof(id));
+		if(settled != raxNotFound && (uintptr_t)settled - 1 <= len) continue;
+
+		raxInsert(s->settled, (unsigned char *)&id, sizeof(id),
+				(void *)(len + 1), NULL);
+		if(settled == raxNotFound && s->order != NULL) {
+			array_append(s->order, idx);
+		}
+
+		if(id == dest) return idx;
+
+		_Expand(s, idx, banned_nodes, banned_edges, max_len, max_weight);
+	}
+
+	return -1;
+}
+
+static void _Search_Init
+(
+	Search *s,
+	const WeightedPathCtx *ctx,
+	bool collect
+) {
+	s->ctx     = ctx;
+	s->states  = array_new(SearchState, 32);
+	s->pending = Heap_new(_StateCmp, &s->states);
+	s->settled = raxNew();
+	s->order   = collect ? array_new(int64_t, 32) : NULL;
+}
+
+static void _Search_Free
+(
+	Search *s
+) {
+	array_free(s->states);
+	Heap_free(s->pending);
+	raxFree(s->settled);
+	if(s->order != NULL) array_free(s->order);
+}
+
+// builds the path leading to state 'idx'
+static WeightedPath _BuildPath
+(
+	const Search *s,
+	int64_t idx
+) {
+	const SearchState *state = s->states + idx;
+	WeightedPath p = {
+		.nodes  = array_new(NodeID, state->len + 1),
+		.edges  = array_new(Edge, state->len),
+		.weight = state->weight,
+	};
+
+	while(true) {
+		array_append(p.nodes, state->node);
+		if(state->parent == -1) break;
+		array_append(p.edges, state->edge);
+		state = s->states + state->parent;
+	}
+
+	// reverse
+	uint node_count = array_len(p.nodes);
+	for(uint i = 0; i < node_count / 2; i++) {
+		NodeID tmp = p.nodes[i];
+		p.nodes[i] = p.nodes[node_count - 1 - i];
+		p.nodes[node_count - 1 - i] = tmp;
+	}
+
+	uint edge_count = array_len(p.edges);
+	for(uint i = 0; i < edge_count / 2; i++) {
+		Edge tmp = p.edges[i];
+		p.edges[i] = p.edges[edge_count - 1 - i];
+		p.edges[edge_count - 1 - i] = tmp;
+	}
+
+	return p;
+}
+
+static void _WeightedPath_Free
+(
+	WeightedPath *p
+) {
+	array_free(p->nodes);
+	array_free(p->edges);
+}
+
+WeightedPath *WeightedPaths_SingleSource
+(
+	const WeightedPathCtx *ctx,
+	NodeID src
+) {
+	ASSERT(ctx != NULL);
+
+	Search s;
+	_Search_Init(&s, ctx, true);
+	_Search(&s, src, INVALID_ENTITY_ID, NULL, NULL, ctx->max_len,
+			ctx->max_weight);
+
+	// skip the trivial path to src, settled first
+	uint count = array_len(s.order);
+	WeightedPath *paths = array_new(WeightedPath, count);
+	for(uint i = 1; i < count; i++) {
+		array_append(paths, _BuildPath(&s, s.order[i]));
+	}
+
+	_Search_Free(&s);
+	return paths;
+}
+
+// returns true if the first 'len' edges of 'a' and 'b' are the same
+static bool _SamePrefix
+(
+	const WeightedPath *a,
+	const WeightedPath *b,
+	uint len
+) {
+	if(array_len(a->edges) < len || array_len(b->edges) < len) return false;
+	for(uint i = 0; i < len; i++) {
+		if(ENTITY_GET_ID(a->edges + i) != ENTITY_GET_ID(b->edges + i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool _SamePath
+(
+	const WeightedPath *a,
+	const WeightedPath *b
+) {
+	uint len = array_len(a->edges);
+	return array_len(b->edges) == len && _SamePrefix(a, b, len);
+}
+
+static bool _ContainsPath
+(
+	WeightedPath *paths,
+	const WeightedPath *p
+) {
+	uint count = array_len(paths);
+	for(uint i = 0; i < count; i++) {
+		if(_SamePath(paths + i, p)) return true;
+	}
+	return false;
+}
+
+// lightest path from src to dest avoiding banned nodes and edges
+// returns false if there's no such path
+static bool _ShortestPath
+(
+	const WeightedPathCtx *ctx,
+	NodeID src,
+	NodeID dest,
+	rax *banned_nodes,
+	rax *banned_edges,
+	uint max_len,
+	double max_weight,
+	WeightedPath *p
+) {
+	Search s;
+	_Search_Init(&s, ctx, false);
+
+	int64_t idx = _Search(&s, src, dest, banned_nodes, banned_edges, max_len,
+			max_weight);
+	if(idx != -1) *p = _BuildPath(&s, idx);
+
+	_Search_Free(&s);
+	return idx != -1;
+}
+
+WeightedPath *WeightedPaths_KShortest
+(
+	const WeightedPathCtx *ctx,
+	NodeID src,
+	NodeID dest,
+	uint k
+) {
+	ASSERT(ctx != NULL);
+
+	WeightedPath *A = array_new(WeightedPath, k);  // lightest paths
+	WeightedPath *B = array_new(WeightedPath, 0);  // candidates
+
+	WeightedPath first;
+	if(k == 0 || src == dest || !_ShortestPath(ctx, src, dest, NULL, NULL,
+				ctx->max_len, ctx->max_weight, &first)) {
+		array_free(B);
+		return A;
+	}
+	array_append(A, first);
+
+	while(array_len(A) < k) {
+		WeightedPath *prev = A + array_len(A) - 1;
+		uint prev_len = array_len(prev->edges);
+		double root_weight = 0;
+
+		// deviate from prev at each of its nodes
+		for(uint i = 0; i < prev_len; i++) {
+			NodeID spur = prev->nodes[i];
+			rax *banned_nodes = raxNew();
+			rax *banned_edges = raxNew();
+
+			// edges leaving the root by an already found path
+			uint found = array_len(A);
+			for(uint j = 0; j < found; j++) {
+				if(array_len(A[j].edges) > i && _SamePrefix(A + j, prev, i)) {
+					EdgeID id = ENTITY_GET_ID(A[j].edges + i);
+					raxInsert(banned_edges, (unsigned char *)&id, sizeof(id),
+							NULL, NULL);
+				}
+			}
+
+			// paths are loopless, root nodes can't be revisited
+			for(uint j = 0; j < i; j++) {
+				NodeID id = prev->nodes[j];
+				raxInsert(banned_nodes, (unsigned char *)&id, sizeof(id), NULL,
+						NULL);
+			}
+
+			WeightedPath spur_path;
+			if(_ShortestPath(ctx, spur, dest, banned_nodes, banned_edges,
+						ctx->max_len - i, ctx->max_weight - root_weight,
+						&spur_path)) {
+				// candidate = root + spur path
+				WeightedPath candidate = {
+					.nodes  = array_new(NodeID, i + array_len(spur_path.nodes)),
+					.edges  = array_new(Edge, i + array_len(spur_path.edges)),
+					.weight = root_weight + spur_path.weight,
+				};
+				for(uint j = 0; j < i; j++) {
+					array_append(candidate.nodes, prev->nodes[j]);
+					array_append(candidate.edges, prev->edges[j]);
+				}
+				uint spur_nodes = array_len(spur_path.nodes);
+				for(uint j = 0; j < spur_nodes; j++) {
+					array_append(candidate.nodes, spur_path.nodes[j]);
+				}
+				uint spur_edges = array_len(spur_path.edges);
+				for(uint j = 0; j < spur_edges; j++) {
+					array_append(candidate.edges, spur_path.edges[j]);
+				}
+				_WeightedPath_Free(&spur_path);
+
+				if(_ContainsPath(B, &candidate) || _ContainsPath(A, &candidate)) {
+					_WeightedPath_Free(&candidate);
+				} else {
+					array_append(B, candidate);
+				}
+			}
+
+			raxFree(banned_nodes);
+			raxFree(banned_edges);
+
+			double w;
+			bool traversable = _EdgeWeight(ctx, prev->edges + i, &w);
+			ASSERT(traversable);
+			UNUSED(traversable);
+			root_weight += w;
+		}
+
+		uint candidate_count = array_len(B);
+		if(candidate_count == 0) break;
+
+		// promote the lightest candidate, preferring shorter paths
+		uint best = 0;
+		for(uint i = 1; i < candidate_count; i++) {
+			double w = B[i].weight;
+			if(w < B[best].weight || (w == B[best].weight &&
+				array_len(B[i].edges) < array_len(B[best].edges))) {
+				best = i;
+			}
+		}
+
+		array_append(A, B[best]);
+		array_del_fast(B, best);
+	}
+
+	uint candidate_count = array_len(B);
+	for(uint i = 0; i < candidate_count; i++) _WeightedPath_Free(B + i);
+	array_free(B);
+
+	return A;
+}
+
+void WeightedPaths_Free
+(
+	WeightedPath *paths
+) {
+	if(paths == NULL) return;
+
+	uint count = array_len(paths);
+	for(uint i = 0; i < count; i++) _WeightedPath_Free(paths + i);
+	array_free(paths);
+}
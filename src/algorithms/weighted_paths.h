@@ -0,0 +1,56 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../graph/graph.h"
+
+// a path and its weight, the sum of its edges weight
+typedef struct {
+	NodeID *nodes;    // path nodes, array
+	Edge *edges;      // path edges, array, edges[i] connects nodes[i, i+1]
+	double weight;    // path weight
+} WeightedPath;
+
+// traversal constraints
+typedef struct {
+	Graph *g;              // graph to traverse
+	int *relations;        // relationship types to traverse, NULL for any
+	GRAPH_EDGE_DIR dir;    // traversal direction
+	Attribute_ID weight;   // edge weight attribute, ATTRIBUTE_NOTFOUND for 1
+	uint max_len;          // max number of edges per path
+	double max_weight;     // max path weight
+} WeightedPathCtx;
+
+// edges lacking a non-negative numeric weight are not traversed
+// paths are searched for in ascending weight order by a label-setting
+// search over (node, length) states, such that the lightest path within
+// 'max_len' edges is found even if a lighter but longer path exists
+
+// computes the lightest path from 'src' to every node reachable within
+// the ctx bounds, returns an array of paths in ascending weight order
+// the trivial path to 'src' is excluded
+WeightedPath *WeightedPaths_SingleSource
+(
+	const WeightedPathCtx *ctx,  // traversal constraints
+	NodeID src                   // source node
+);
+
+// computes up to 'k' lightest loopless paths from 'src' to 'dest'
+// using Yen's algorithm, returns an array of paths in ascending weight order
+WeightedPath *WeightedPaths_KShortest
+(
+	const WeightedPathCtx *ctx,  // traversal constraints
+	NodeID src,                  // source node
+	NodeID dest,                 // destination node
+	uint k                       // max number of paths
+);
+
+// free an array of paths
+void WeightedPaths_Free
+(
+	WeightedPath *paths
+);
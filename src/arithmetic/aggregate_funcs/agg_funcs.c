@@ -5,12 +5,16 @@
 */
 
 #include "agg_funcs.h"
+#include "agg_kernels.h"
+#include "../../RG.h"
 #include "../../value.h"
 #include "../../errors.h"
 #include "../../util/arr.h"
+#include "../../util/hll.h"
 #include "../../query_ctx.h"
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../util/tdigest.h"
 #include "../../datatypes/array.h"
 #include <math.h>
 #include <float.h>
@@ -43,6 +47,21 @@ static inline void Aggregate_SetResult(AggregateCtx *ctx, SIValue result) {
 	ctx->result = result;
 }
 
+// Compensated sum of a batch of numeric values.
+static inline double _BatchSum(SIType t, const void *values, uint count) {
+	if(t == T_INT64) return AggKernel_SumInts(values, count);
+	return AggKernel_SumDoubles(values, count);
+}
+
+// Append a batch of numeric values to an array of doubles.
+static double *_BatchAppend(double *arr, SIType t, const void *values, uint count) {
+	uint len = array_len(arr);
+	arr = array_grow(arr, count);
+	if(t == T_INT64) AggKernel_IntsToDoubles(values, count, arr + len);
+	else memcpy(arr + len, values, count * sizeof(double));
+	return arr;
+}
+
 //------------------------------------------------------------------------------
 // Sum
 //------------------------------------------------------------------------------
@@ -61,6 +80,24 @@ AggregateResult AGG_SUM(SIValue *argv, int argc) {
 	return AGGREGATE_OK;
 }
 
+typedef struct {
+	double compensation;  // low-order bits lost by the running total
+} _agg_SumCtx;
+
+void AGG_SUM_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	AggregateCtx *ctx = ctx_ptr;
+	ASSERT(SI_TYPE(ctx->result) == T_DOUBLE);
+
+	if(ctx->private_ctx == NULL) ctx->private_ctx = rm_calloc(1, sizeof(_agg_SumCtx));
+	_agg_SumCtx *sum_ctx = ctx->private_ctx;
+
+	// add batch sum to the total, carrying the compensation across batches
+	double y = _BatchSum(t, values, count) - sum_ctx->compensation;
+	double total = ctx->result.doubleval + y;
+	sum_ctx->compensation = (total - ctx->result.doubleval) - y;
+	ctx->result.doubleval = total;
+}
+
 //------------------------------------------------------------------------------
 // Avg
 //------------------------------------------------------------------------------
@@ -71,17 +108,7 @@ typedef struct {
 	bool overflow;
 } _agg_AvgCtx;
 
-AggregateResult AGG_AVG(SIValue *argv, int argc) {
-	AggregateCtx *ctx = argv[1].ptrval;
-	// on the first invocation, initialize the context
-	if(ctx->private_ctx == NULL) ctx->private_ctx = rm_calloc(1, sizeof(_agg_AvgCtx));
-
-	SIValue si_val = argv[0];
-	if(SI_TYPE(si_val) == T_NULL) return AGGREGATE_OK;
-	long double v = SI_GET_NUMERIC(si_val);
-
-	_agg_AvgCtx *avg_ctx = ctx->private_ctx;
-
+static void _AvgStep(_agg_AvgCtx *avg_ctx, long double v) {
 	avg_ctx->count ++; // increment the count
 
 	// if we've already overflowed or adding the current value
@@ -101,10 +128,46 @@ AggregateResult AGG_AVG(SIValue *argv, int argc) {
 	} else { // no overflow
 		avg_ctx->total += v;
 	}
+}
+
+AggregateResult AGG_AVG(SIValue *argv, int argc) {
+	AggregateCtx *ctx = argv[1].ptrval;
+	// on the first invocation, initialize the context
+	if(ctx->private_ctx == NULL) ctx->private_ctx = rm_calloc(1, sizeof(_agg_AvgCtx));
+
+	SIValue si_val = argv[0];
+	if(SI_TYPE(si_val) == T_NULL) return AGGREGATE_OK;
+	long double v = SI_GET_NUMERIC(si_val);
+
+	_agg_AvgCtx *avg_ctx = ctx->private_ctx;
+	_AvgStep(avg_ctx, v);
 
 	return AGGREGATE_OK;
 }
 
+void AGG_AVG_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	AggregateCtx *ctx = ctx_ptr;
+	_agg_AvgCtx *avg_ctx = ctx->private_ctx;
+	ASSERT(avg_ctx != NULL);
+
+	if(!avg_ctx->overflow) {
+		double sum = _BatchSum(t, values, count);
+		double total = avg_ctx->total + sum;
+		if(isfinite(sum) && isfinite(total)) {
+			avg_ctx->total = total;
+			avg_ctx->count += count;
+			return;
+		}
+	}
+
+	// total overflows, fall back to the incremental algorithm
+	for(uint i = 0; i < count; i++) {
+		long double v = (t == T_INT64) ? ((const int64_t *)values)[i]
+			: ((const double *)values)[i];
+		_AvgStep(avg_ctx, v);
+	}
+}
+
 void AvgFinalize(void *ctx_ptr) {
 	AggregateCtx *ctx = ctx_ptr;
 	_agg_AvgCtx *avg_ctx = ctx->private_ctx;
@@ -124,40 +187,60 @@ void AvgFinalize(void *ctx_ptr) {
 // Max
 //------------------------------------------------------------------------------
 
-AggregateResult AGG_MAX(SIValue *argv, int argc) {
-	SIValue v = argv[0];
-	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
-	AggregateCtx *ctx = argv[1].ptrval;
-
+static inline void _MaxUpdate(AggregateCtx *ctx, SIValue v) {
 	// Update the result if the current element is greater.
 	int compared_null;
 	if((SIValue_Compare(ctx->result, v, &compared_null) < 0) ||
 	   (compared_null == COMPARED_NULL)) {
 		ctx->result = v;
 	}
+}
+
+AggregateResult AGG_MAX(SIValue *argv, int argc) {
+	SIValue v = argv[0];
+	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
+	AggregateCtx *ctx = argv[1].ptrval;
+
+	_MaxUpdate(ctx, v);
 
 	return AGGREGATE_OK;
 }
 
+void AGG_MAX_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	SIValue v = (t == T_INT64) ? SI_LongVal(AggKernel_MaxInts(values, count))
+		: SI_DoubleVal(AggKernel_MaxDoubles(values, count));
+	_MaxUpdate(ctx_ptr, v);
+}
+
 //------------------------------------------------------------------------------
 // Min
 //------------------------------------------------------------------------------
 
-AggregateResult AGG_MIN(SIValue *argv, int argc) {
-	SIValue v = argv[0];
-	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
-	AggregateCtx *ctx = argv[1].ptrval;
-
+static inline void _MinUpdate(AggregateCtx *ctx, SIValue v) {
 	// Update the result if the current element is lesser.
 	int compared_null;
 	if((SIValue_Compare(ctx->result, v, &compared_null) > 0) ||
 	   (compared_null == COMPARED_NULL)) {
 		ctx->result = v;
 	}
+}
+
+AggregateResult AGG_MIN(SIValue *argv, int argc) {
+	SIValue v = argv[0];
+	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
+	AggregateCtx *ctx = argv[1].ptrval;
+
+	_MinUpdate(ctx, v);
 
 	return AGGREGATE_OK;
 }
 
+void AGG_MIN_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	SIValue v = (t == T_INT64) ? SI_LongVal(AggKernel_MinInts(values, count))
+		: SI_DoubleVal(AggKernel_MinDoubles(values, count));
+	_MinUpdate(ctx_ptr, v);
+}
+
 //------------------------------------------------------------------------------
 // Count
 //------------------------------------------------------------------------------
@@ -214,6 +297,14 @@ AggregateResult AGG_PERC(SIValue *argv, int argc) {
 	return AGGREGATE_OK;
 }
 
+void AGG_PERC_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	AggregateCtx *ctx = ctx_ptr;
+	_agg_PercCtx *perc_ctx = ctx->private_ctx;
+	ASSERT(perc_ctx != NULL);
+
+	perc_ctx->values = _BatchAppend(perc_ctx->values, t, values, count);
+}
+
 void PercDiscFinalize(void *ctx_ptr) {
 	AggregateCtx *ctx = ctx_ptr;
 	_agg_PercCtx *perc_ctx = ctx->private_ctx;
@@ -305,6 +396,15 @@ AggregateResult AGG_STDEV(SIValue *argv, int argc) {
 	return AGGREGATE_OK;
 }
 
+void AGG_STDEV_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	AggregateCtx *ctx = ctx_ptr;
+	_agg_StDevCtx *stdev_ctx = ctx->private_ctx;
+	ASSERT(stdev_ctx != NULL);
+
+	stdev_ctx->values = _BatchAppend(stdev_ctx->values, t, values, count);
+	stdev_ctx->total += _BatchSum(t, values, count);
+}
+
 void StDevGenericFinalize(AggregateCtx *ctx, int is_sampled) {
 	_agg_StDevCtx *stdev_ctx = ctx->private_ctx;
 
@@ -364,6 +464,124 @@ AggregateResult AGG_COLLECT(SIValue *argv, int argc) {
 	return AGGREGATE_OK;
 }
 
+// the collected list is made shared, such that records it is projected into
+// reference rather than copy it
+void CollectFinalize(void *ctx_ptr) {
+	AggregateCtx *ctx = ctx_ptr;
+	SIValue_MakeShared(&ctx->result);
+}
+
+//------------------------------------------------------------------------------
+// Approximate count distinct
+//------------------------------------------------------------------------------
+
+// distinct values are estimated by a HyperLogLog sketch of fixed size
+// rather than retained in a set
+
+AggregateResult AGG_APPROX_COUNT_DISTINCT(SIValue *argv, int argc) {
+	AggregateCtx *ctx = argv[1].ptrval;
+
+	// on the first invocation, initialize the context
+	if(ctx->private_ctx == NULL) {
+		ctx->private_ctx = rm_malloc(sizeof(HLL));
+		HLL_Reset(ctx->private_ctx);
+	}
+
+	SIValue v = argv[0];
+	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
+
+	HLL_Add(ctx->private_ctx, SIValue_HashCode(v));
+
+	return AGGREGATE_OK;
+}
+
+void AGG_APPROX_COUNT_DISTINCT_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	AggregateCtx *ctx = ctx_ptr;
+	HLL *hll = ctx->private_ctx;
+	ASSERT(hll != NULL);
+
+	// values are hashed as they are by the regular step
+	for(uint i = 0; i < count; i++) {
+		SIValue v = (t == T_INT64) ? SI_LongVal(((const int64_t *)values)[i])
+			: SI_DoubleVal(((const double *)values)[i]);
+		HLL_Add(hll, SIValue_HashCode(v));
+	}
+}
+
+void ApproxCountDistinctFinalize(void *ctx_ptr) {
+	AggregateCtx *ctx = ctx_ptr;
+	HLL *hll = ctx->private_ctx;
+	Aggregate_SetResult(ctx, SI_LongVal(HLL_Count(hll)));
+}
+
+//------------------------------------------------------------------------------
+// Approximate percentile
+//------------------------------------------------------------------------------
+
+// values are summarized by a t-digest of fixed size
+// rather than retained and sorted
+
+typedef struct {
+	double percentile;
+	TDigest digest;
+} _agg_ApproxPercCtx;
+
+AggregateResult AGG_APPROX_PERC(SIValue *argv, int argc) {
+	AggregateCtx *ctx = argv[2].ptrval;
+	_agg_ApproxPercCtx *perc_ctx = ctx->private_ctx;
+
+	// on the first invocation, initialize the context
+	if(perc_ctx == NULL) {
+		ctx->private_ctx = rm_malloc(sizeof(_agg_ApproxPercCtx));
+		perc_ctx = ctx->private_ctx;
+		TDigest_Reset(&perc_ctx->digest);
+		// the second argument is the requested percentile, which we only
+		// need to apply on the first function invocation
+		SIValue_ToDouble(&argv[1], &perc_ctx->percentile);
+		if(!(perc_ctx->percentile >= 0 && perc_ctx->percentile <= 1)) {
+			ErrorCtx_SetError("Invalid input - '%f' is not a valid argument, must be a number in the range 0.0 to 1.0",
+							  perc_ctx->percentile);
+		}
+	}
+
+	SIValue v = argv[0];
+	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
+
+	double n;
+	SIValue_ToDouble(&v, &n);
+	TDigest_Add(&perc_ctx->digest, n);
+
+	return AGGREGATE_OK;
+}
+
+void AGG_APPROX_PERC_BATCH(void *ctx_ptr, SIType t, const void *values, uint count) {
+	AggregateCtx *ctx = ctx_ptr;
+	_agg_ApproxPercCtx *perc_ctx = ctx->private_ctx;
+	ASSERT(perc_ctx != NULL);
+
+	for(uint i = 0; i < count; i++) {
+		double n = (t == T_INT64) ? ((const int64_t *)values)[i]
+			: ((const double *)values)[i];
+		TDigest_Add(&perc_ctx->digest, n);
+	}
+}
+
+void ApproxPercFinalize(void *ctx_ptr) {
+	AggregateCtx *ctx = ctx_ptr;
+	_agg_ApproxPercCtx *perc_ctx = ctx->private_ctx;
+	double percentile = perc_ctx->percentile;
+
+	// an invalid percentile was reported on the first invocation
+	if(TDigest_Weight(&perc_ctx->digest) == 0 ||
+	   !(percentile >= 0 && percentile <= 1)) {
+		Aggregate_SetResult(ctx, SI_NullVal());
+		return;
+	}
+
+	double n = TDigest_Quantile(&perc_ctx->digest, percentile);
+	Aggregate_SetResult(ctx, SI_DoubleVal(n));
+}
+
 //------------------------------------------------------------------------------
 // Function registration
 //------------------------------------------------------------------------------
@@ -382,6 +600,7 @@ void Register_AggFuncs() {
 	array_append(types, T_PTR);
 	func_desc = AR_FuncDescNew("sum", AGG_SUM, 2, 2, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, Aggregate_Free, Aggregate_Clone);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_SUM_BATCH);
 	AR_RegFunc(func_desc);
 
 	//--------------------------------------------------------------------------
@@ -394,6 +613,7 @@ void Register_AggFuncs() {
 	func_desc = AR_FuncDescNew("avg", AGG_AVG, 2, 2, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, Aggregate_Free, Aggregate_Clone);
 	AR_SetFinalizeRoutine(func_desc, AvgFinalize);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_AVG_BATCH);
 	AR_RegFunc(func_desc);
 
 	//--------------------------------------------------------------------------
@@ -405,6 +625,7 @@ void Register_AggFuncs() {
 	array_append(types, T_PTR);
 	func_desc = AR_FuncDescNew("max", AGG_MAX, 2, 2, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, Aggregate_Free, Aggregate_Clone);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_MAX_BATCH);
 	AR_RegFunc(func_desc);
 
 	//--------------------------------------------------------------------------
@@ -416,6 +637,7 @@ void Register_AggFuncs() {
 	array_append(types, T_PTR);
 	func_desc = AR_FuncDescNew("min", AGG_MIN, 2, 2, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, Aggregate_Free, Aggregate_Clone);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_MIN_BATCH);
 	AR_RegFunc(func_desc);
 
 	//--------------------------------------------------------------------------
@@ -440,6 +662,7 @@ void Register_AggFuncs() {
 	func_desc = AR_FuncDescNew("percentileDisc", AGG_PERC, 3, 3, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, Percentile_Free, Aggregate_Clone);
 	AR_SetFinalizeRoutine(func_desc, PercDiscFinalize);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_PERC_BATCH);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 3);
@@ -449,6 +672,7 @@ void Register_AggFuncs() {
 	func_desc = AR_FuncDescNew("percentileCont", AGG_PERC, 3, 3, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, Percentile_Free, Aggregate_Clone);
 	AR_SetFinalizeRoutine(func_desc, PercContFinalize);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_PERC_BATCH);
 	AR_RegFunc(func_desc);
 
 	//--------------------------------------------------------------------------
@@ -461,6 +685,7 @@ void Register_AggFuncs() {
 	func_desc = AR_FuncDescNew("stDev", AGG_STDEV, 2, 2, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, StDev_Free, Aggregate_Clone);
 	AR_SetFinalizeRoutine(func_desc, StDevFinalize);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_STDEV_BATCH);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 2);
@@ -469,6 +694,7 @@ void Register_AggFuncs() {
 	func_desc = AR_FuncDescNew("stDevP", AGG_STDEV, 2, 2, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, StDev_Free, Aggregate_Clone);
 	AR_SetFinalizeRoutine(func_desc, StDevPFinalize);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_STDEV_BATCH);
 	AR_RegFunc(func_desc);
 
 	//--------------------------------------------------------------------------
@@ -480,6 +706,32 @@ void Register_AggFuncs() {
 	array_append(types, T_PTR);
 	func_desc = AR_FuncDescNew("collect", AGG_COLLECT, 2, 2, types, false, true);
 	AR_SetPrivateDataRoutines(func_desc, Aggregate_Free, Aggregate_Clone);
+	AR_SetFinalizeRoutine(func_desc, CollectFinalize);
+	AR_RegFunc(func_desc);
+
+	//--------------------------------------------------------------------------
+	// Approximate aggregations
+	//--------------------------------------------------------------------------
+
+	types = array_new(SIType, 2);
+	array_append(types, SI_ALL);
+	array_append(types, T_PTR);
+	func_desc = AR_FuncDescNew("approxCountDistinct", AGG_APPROX_COUNT_DISTINCT,
+			2, 2, types, false, true);
+	AR_SetPrivateDataRoutines(func_desc, Aggregate_Free, Aggregate_Clone);
+	AR_SetFinalizeRoutine(func_desc, ApproxCountDistinctFinalize);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_APPROX_COUNT_DISTINCT_BATCH);
+	AR_RegFunc(func_desc);
+
+	types = array_new(SIType, 3);
+	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
+	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
+	array_append(types, T_PTR);
+	func_desc = AR_FuncDescNew("approxPercentile", AGG_APPROX_PERC, 3, 3, types,
+			false, true);
+	AR_SetPrivateDataRoutines(func_desc, Aggregate_Free, Aggregate_Clone);
+	AR_SetFinalizeRoutine(func_desc, ApproxPercFinalize);
+	AR_SetAggregateBatchRoutine(func_desc, AGG_APPROX_PERC_BATCH);
 	AR_RegFunc(func_desc);
 }
 
@@ -0,0 +1,143 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "agg_kernels.h"
+
+// number of independent accumulators, two AVX2 registers worth of doubles
+#define LANES 8
+
+// compile kernel for multiple instruction sets, resolved at load time
+#if defined(__x86_64__) && defined(__GLIBC__) && defined(__GNUC__) && !defined(__clang__)
+#define AGG_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define AGG_KERNEL
+#endif
+
+// add 'v' to the compensated sum 'sum', 'c' holds the lost low-order bits
+static inline void _KahanAdd(double *sum, double *c, double v) {
+	double y = v - *c;
+	double t = *sum + y;
+	*c = (t - *sum) - y;
+	*sum = t;
+}
+
+// fold lane accumulators into a single compensated sum
+static inline double _KahanCombine(const double *sum, const double *c) {
+	double total = 0;
+	double comp = 0;
+	for(uint j = 0; j < LANES; j++) _KahanAdd(&total, &comp, sum[j] - c[j]);
+	return total;
+}
+
+AGG_KERNEL double AggKernel_SumDoubles
+(
+	const double *values,
+	uint count
+) {
+	double sum[LANES] = {0};
+	double c[LANES] = {0};
+
+	uint i = 0;
+	for(; i + LANES <= count; i += LANES) {
+		for(uint j = 0; j < LANES; j++) _KahanAdd(sum + j, c + j, values[i + j]);
+	}
+	for(; i < count; i++) _KahanAdd(sum, c, values[i]);
+
+	return _KahanCombine(sum, c);
+}
+
+AGG_KERNEL double AggKernel_SumInts
+(
+	const int64_t *values,
+	uint count
+) {
+	double sum[LANES] = {0};
+	double c[LANES] = {0};
+
+	uint i = 0;
+	for(; i + LANES <= count; i += LANES) {
+		for(uint j = 0; j < LANES; j++) {
+			_KahanAdd(sum + j, c + j, (double)values[i + j]);
+		}
+	}
+	for(; i < count; i++) _KahanAdd(sum, c, (double)values[i]);
+
+	return _KahanCombine(sum, c);
+}
+
+AGG_KERNEL double AggKernel_MinDoubles
+(
+	const double *values,
+	uint count
+) {
+	double m[LANES];
+	for(uint j = 0; j < LANES; j++) m[j] = values[0];
+
+	uint i = 0;
+	for(; i + LANES <= count; i += LANES) {
+		for(uint j = 0; j < LANES; j++) {
+			double v = values[i + j];
+			m[j] = (v < m[j]) ? v : m[j];
+		}
+	}
+	for(; i < count; i++) m[0] = (values[i] < m[0]) ? values[i] : m[0];
+
+	double res = m[0];
+	for(uint j = 1; j < LANES; j++) res = (m[j] < res) ? m[j] : res;
+	return res;
+}
+
+AGG_KERNEL double AggKernel_MaxDoubles
+(
+	const double *values,
+	uint count
+) {
+	double m[LANES];
+	for(uint j = 0; j < LANES; j++) m[j] = values[0];
+
+	uint i = 0;
+	for(; i + LANES <= count; i += LANES) {
+		for(uint j = 0; j < LANES; j++) {
+			double v = values[i + j];
+			m[j] = (v > m[j]) ? v : m[j];
+		}
+	}
+	for(; i < count; i++) m[0] = (values[i] > m[0]) ? values[i] : m[0];
+
+	double res = m[0];
+	for(uint j = 1; j < LANES; j++) res = (m[j] > res) ? m[j] : res;
+	return res;
+}
+
+AGG_KERNEL int64_t AggKernel_MinInts
+(
+	const int64_t *values,
+	uint count
+) {
+	int64_t m = values[0];
+	for(uint i = 1; i < count; i++) m = (values[i] < m) ? values[i] : m;
+	return m;
+}
+
+AGG_KERNEL int64_t AggKernel_MaxInts
+(
+	const int64_t *values,
+	uint count
+) {
+	int64_t m = values[0];
+	for(uint i = 1; i < count; i++) m = (values[i] > m) ? values[i] : m;
+	return m;
+}
+
+AGG_KERNEL void AggKernel_IntsToDoubles
+(
+	const int64_t *values,
+	uint count,
+	double *out
+) {
+	for(uint i = 0; i < count; i++) out[i] = (double)values[i];
+}
+
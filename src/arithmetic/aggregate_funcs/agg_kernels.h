@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// kernels reducing contiguous arrays of numeric values
+// used by the batch step routines of the numeric aggregation functions
+//
+// the kernels are written over independent lanes such that they
+// vectorize without relaxing floating point semantics, on x86-64 each
+// kernel is compiled for both AVX2 and the baseline instruction set and
+// the variant matching the CPU is selected at load time
+
+// compensated (Kahan) sum of 'count' doubles
+double AggKernel_SumDoubles
+(
+	const double *values,
+	uint count
+);
+
+// compensated (Kahan) sum of 'count' integers converted to doubles
+double AggKernel_SumInts
+(
+	const int64_t *values,
+	uint count
+);
+
+// minimum of 'count' doubles, count > 0
+double AggKernel_MinDoubles
+(
+	const double *values,
+	uint count
+);
+
+// maximum of 'count' doubles, count > 0
+double AggKernel_MaxDoubles
+(
+	const double *values,
+	uint count
+);
+
+// minimum of 'count' integers, count > 0
+int64_t AggKernel_MinInts
+(
+	const int64_t *values,
+	uint count
+);
+
+// maximum of 'count' integers, count > 0
+int64_t AggKernel_MaxInts
+(
+	const int64_t *values,
+	uint count
+);
+
+// convert 'count' integers to doubles
+void AggKernel_IntsToDoubles
+(
+	const int64_t *values,
+	uint count,
+	double *out
+);
+
@@ -8,6 +8,79 @@
 #include "../../query_ctx.h"
 #include "../algebraic_expression.h"
 
+// a trailing label operand is applied as a mask when it covers at most
+// 1/LABEL_MASK_SELECTIVITY of the nodes and the mask holds at most
+// LABEL_MASK_MAX_ENTRIES entries
+#define LABEL_MASK_SELECTIVITY 4
+#define LABEL_MASK_MAX_ENTRIES (1 << 20)
+
+// build a structural mask selecting the columns of label matrix 'L'
+// within the non empty rows of 'A'
+// (A * M) * L is then computed as (A * M)<mask>
+// sparing the computation of entries discarded by L
+// returns NULL if the label isn't selective enough
+static GrB_Matrix _label_mask
+(
+	const RG_Matrix A,  // left operand
+	const RG_Matrix L   // diagonal label matrix
+) {
+	GrB_Info   info;
+	GrB_Index  nrows;
+	GrB_Index  ncols;
+	GrB_Index  l_nvals;
+	GrB_Index  r_nvals;
+	GrB_Vector r     =  NULL;  // non empty rows of A
+	GrB_Vector d     =  NULL;  // labeled nodes
+	GrB_Matrix l     =  NULL;  // flat label matrix
+	GrB_Matrix mask  =  NULL;
+	GrB_Matrix _A    =  RG_MATRIX_M(A);
+
+	UNUSED(info);
+
+	info = GrB_Matrix_nrows(&nrows, _A);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_ncols(&ncols, L);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_nvals(&l_nvals, L);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(l_nvals * LABEL_MASK_SELECTIVITY > ncols) return NULL;
+
+	info = GrB_Vector_new(&r, GrB_BOOL, nrows);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_reduce_Monoid(r, NULL, NULL, GrB_LOR_MONOID_BOOL, _A,
+			NULL);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_nvals(&r_nvals, r);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(r_nvals * l_nvals > LABEL_MASK_MAX_ENTRIES) {
+		GrB_free(&r);
+		return NULL;
+	}
+
+	// extract labeled nodes out of the label matrix diagonal
+	info = RG_Matrix_export(&l, L);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_new(&d, GrB_BOOL, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Vector_diag(d, l, 0, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	// mask = r * d', every labeled column within each non empty row
+	info = GrB_Matrix_new(&mask, GrB_BOOL, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_kronecker_BinaryOp(mask, NULL, NULL, GrB_ONEB_BOOL,
+			(GrB_Matrix)r, (GrB_Matrix)d, GrB_DESC_T1);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_free(&r);
+	GrB_free(&d);
+	GrB_free(&l);
+
+	return mask;
+}
+
 RG_Matrix _Eval_Mul
 (
 	const AlgebraicExpression *exp,
@@ -49,7 +122,23 @@ RG_Matrix _Eval_Mul
 		}
 
 		// both A and M are valid matrices, perform multiplication
-		info = RG_mxm(res, semiring, A, M) ;
+		// when the last operand is a label matrix, apply it as a mask
+		// rather than multiplying by it
+		GrB_Matrix mask = NULL ;
+		if(i == child_count - 2 && !c->operand.diagonal) {
+			AlgebraicExpression *l = CHILD_AT(exp, i + 1) ;
+			if(l->operand.diagonal && l->operand.matrix != IDENTITY_MATRIX) {
+				mask = _label_mask(A, l->operand.matrix) ;
+			}
+		}
+
+		if(mask != NULL) {
+			info = RG_mxm_masked(res, mask, semiring, A, M) ;
+			GrB_free(&mask) ;
+			i++ ;  // label operand applied
+		} else {
+			info = RG_mxm(res, semiring, A, M) ;
+		}
 		res_modified = true ;
 		// setup for next iteration
 		A = res ;
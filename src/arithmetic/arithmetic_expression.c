@@ -31,6 +31,24 @@
 // return child at position 'idx' of 'n'
 #define NODE_CHILD(n, idx) (n)->op.children[(idx)]
 
+// value of a subexpression, shared by all of its occurrences within a tree
+typedef struct AR_ExpMemo {
+	uint64_t epoch;     // evaluation in which 'v' was computed
+	SIValue v;          // computed value
+	AR_EXP_Result res;  // evaluation result
+	uint refcount;      // number of nodes sharing the memo
+} AR_ExpMemo;
+
+// maps memos of a cloned tree to the memos of its clone
+typedef struct {
+	AR_ExpMemo *orig;
+	AR_ExpMemo *clone;
+} AR_ExpMemoMapping;
+
+// current evaluation, advanced whenever a tree is evaluated
+// memoized values are valid only within the evaluation computing them
+static __thread uint64_t _epoch = 0;
+
 //------------------------------------------------------------------------------
 // Forward declarations
 //------------------------------------------------------------------------------
@@ -137,16 +155,39 @@ static AR_ExpNode *_AR_EXP_NewOpNode(uint child_count) {
 	return node;
 }
 
-static AR_ExpNode *_AR_EXP_CloneOp(AR_ExpNode *exp) {
+static AR_ExpNode *_AR_EXP_Clone(AR_ExpNode *exp, AR_ExpMemoMapping **memos);
+
+// clone memo, memos shared by multiple nodes are cloned once per tree
+static AR_ExpMemo *_AR_EXP_CloneMemo(AR_ExpMemo *memo,
+		AR_ExpMemoMapping **memos) {
+	if(*memos == NULL) *memos = array_new(AR_ExpMemoMapping, 1);
+
+	uint count = array_len(*memos);
+	for(uint i = 0; i < count; i++) {
+		if((*memos)[i].orig == memo) {
+			(*memos)[i].clone->refcount++;
+			return (*memos)[i].clone;
+		}
+	}
+
+	AR_ExpMemo *clone = rm_calloc(1, sizeof(AR_ExpMemo));
+	clone->refcount = 1;
+	AR_ExpMemoMapping mapping = {.orig = memo, .clone = clone};
+	array_append(*memos, mapping);
+	return clone;
+}
+
+static AR_ExpNode *_AR_EXP_CloneOp(AR_ExpNode *exp, AR_ExpMemoMapping **memos) {
 	AR_ExpNode *clone = _AR_EXP_NewOpNode(exp->op.child_count);
 	/* If the function has private data, the function descriptor
 	 * itself should be cloned. Otherwise, we can perform a direct assignment. */
 	if(exp->op.f->bclone) clone->op.f = AR_CloneFuncDesc(exp->op.f);
 	else clone->op.f = exp->op.f;
 	for(uint i = 0; i < exp->op.child_count; i++) {
-		AR_ExpNode *child = AR_EXP_Clone(exp->op.children[i]);
+		AR_ExpNode *child = _AR_EXP_Clone(exp->op.children[i], memos);
 		clone->op.children[i] = child;
 	}
+	if(exp->op.memo) clone->op.memo = _AR_EXP_CloneMemo(exp->op.memo, memos);
 	return clone;
 }
 
@@ -256,8 +297,9 @@ bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val) {
 		// Can't reduce root as one of its children is not a constant.
 		if(!reduce_children) return false;
 
-		// All child nodes are constants, make sure function is marked as reducible.
-		if(!root->op.f->reducible) return false;
+		// All child nodes are constants, make sure function is marked as reducible
+		// and always returns the same result for the same input.
+		if(!root->op.f->reducible || !root->op.f->deterministic) return false;
 
 		// Evaluate function.
 		SIValue v = AR_EXP_Evaluate(root, NULL);
@@ -277,6 +319,115 @@ bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val) {
 	}
 }
 
+// returns true if 'exp' always evaluates to the same value for a given record
+// sets 'dependent' if the value of 'exp' depends on the record
+static bool _AR_EXP_Pure(const AR_ExpNode *exp, bool *dependent) {
+	if(exp->type == AR_EXP_OPERAND) {
+		switch(exp->operand.type) {
+		case AR_EXP_CONSTANT:
+		case AR_EXP_PARAM:
+			return true;
+		case AR_EXP_VARIADIC:
+			*dependent = true;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// aggregations and functions with private data hold state
+	AR_FuncDesc *f = exp->op.f;
+	if(f->aggregate || !f->deterministic || f->privdata != NULL) return false;
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(!_AR_EXP_Pure(exp->op.children[i], dependent)) return false;
+	}
+
+	return true;
+}
+
+// returns true if 'a' and 'b' represent the same computation
+static bool _AR_EXP_Equivalent(const AR_ExpNode *a, const AR_ExpNode *b) {
+	if(a->type != b->type) return false;
+
+	if(a->type == AR_EXP_OPERAND) {
+		if(a->operand.type != b->operand.type) return false;
+		switch(a->operand.type) {
+		case AR_EXP_CONSTANT: {
+			SIValue va = a->operand.constant;
+			SIValue vb = b->operand.constant;
+			if(SI_TYPE(va) != SI_TYPE(vb)) return false;
+			if(SI_TYPE(va) == T_NULL) return true;
+			int disjointOrNull = 0;
+			int rel = SIValue_Compare(va, vb, &disjointOrNull);
+			return (disjointOrNull == 0 && rel == 0);
+		}
+		case AR_EXP_VARIADIC:
+			return strcmp(a->operand.variadic.entity_alias,
+						  b->operand.variadic.entity_alias) == 0;
+		case AR_EXP_PARAM:
+			return strcmp(a->operand.param_name, b->operand.param_name) == 0;
+		default:
+			return false;
+		}
+	}
+
+	if(a->op.f != b->op.f || a->op.child_count != b->op.child_count) {
+		return false;
+	}
+
+	for(int i = 0; i < a->op.child_count; i++) {
+		if(!_AR_EXP_Equivalent(a->op.children[i], b->op.children[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// collect operations which can be shared, in pre-order
+static void _AR_EXP_CollectShareable(AR_ExpNode *exp, AR_ExpNode ***nodes) {
+	if(!AR_EXP_IsOperation(exp)) return;
+
+	// operations independent of the record are reduced once parameters
+	// are known, there's no need to share them
+	bool dependent = false;
+	if(_AR_EXP_Pure(exp, &dependent) && dependent) array_append(*nodes, exp);
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		_AR_EXP_CollectShareable(exp->op.children[i], nodes);
+	}
+}
+
+void AR_EXP_ShareSubexpressions(AR_ExpNode *root) {
+	ASSERT(root != NULL);
+
+	if(!AR_EXP_IsOperation(root)) return;
+
+	AR_ExpNode **nodes = array_new(AR_ExpNode *, 0);
+	_AR_EXP_CollectShareable(root, &nodes);
+
+	uint count = array_len(nodes);
+	for(uint i = 0; i < count; i++) {
+		AR_ExpNode *a = nodes[i];
+		if(a->op.memo != NULL) continue;
+
+		for(uint j = i + 1; j < count; j++) {
+			AR_ExpNode *b = nodes[j];
+			if(b->op.memo != NULL || !_AR_EXP_Equivalent(a, b)) continue;
+
+			if(a->op.memo == NULL) {
+				a->op.memo = rm_calloc(1, sizeof(AR_ExpMemo));
+				a->op.memo->refcount = 1;
+			}
+			b->op.memo = a->op.memo;
+			b->op.memo->refcount++;
+		}
+	}
+
+	array_free(nodes);
+}
+
 static void _AR_EXP_OpResolveVariables(AR_ExpNode *node, const Record r) {
 	ASSERT(node->type == AR_EXP_OP);
 
@@ -432,6 +583,15 @@ static AR_EXP_Result _AR_EXP_EvaluateFunctionCall(AR_ExpNode *node,
 
 cleanup:
 	_AR_EXP_FreeResultsArray(sub_trees, node->op.child_count);
+
+	// functions returning the same result throughout a query are evaluated
+	// once, the node is replaced in place by its value as parameters are
+	if(res != EVAL_ERR && node->op.f->query_constant) {
+		_AR_EXP_InplaceRepurposeConstant(node, v);
+		if(result) *result = SI_ShareValue(v);
+		res = EVAL_FOUND_PARAM;
+	}
+
 	return res;
 }
 
@@ -492,6 +652,29 @@ static inline AR_EXP_Result _AR_EXP_EvaluateBorrowRecord(AR_ExpNode *node, const
 	return EVAL_OK;
 }
 
+/* Evaluate a subexpression shared by multiple nodes,
+ * the first occurrence evaluated computes the value for all others. */
+static AR_EXP_Result _AR_EXP_EvaluateShared(AR_ExpNode *node, const Record r,
+											SIValue *result) {
+	AR_ExpMemo *memo = node->op.memo;
+	if(memo->epoch == _epoch) {
+		*result = memo->v;
+		return memo->res;
+	}
+
+	AR_EXP_Result res = _AR_EXP_EvaluateFunctionCall(node, r, result);
+
+	// retain only values which don't reference any allocation
+	// such that the value can be handed out any number of times
+	if(res != EVAL_ERR && result->allocation == M_NONE) {
+		memo->v = *result;
+		memo->res = res;
+		memo->epoch = _epoch;
+	}
+
+	return res;
+}
+
 /* Evaluate an expression tree,
  * placing the calculated value in 'result'
  * and returning whether an error occurred during evaluation. */
@@ -500,6 +683,7 @@ static AR_EXP_Result _AR_EXP_Evaluate(AR_ExpNode *root, const Record r,
 	AR_EXP_Result res = EVAL_OK;
 	switch(root->type) {
 	case AR_EXP_OP:
+		if(root->op.memo != NULL) return _AR_EXP_EvaluateShared(root, r, result);
 		return _AR_EXP_EvaluateFunctionCall(root, r, result);
 	case AR_EXP_OPERAND:
 		switch(root->operand.type) {
@@ -524,6 +708,9 @@ static AR_EXP_Result _AR_EXP_Evaluate(AR_ExpNode *root, const Record r,
 }
 
 SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r) {
+	// values memoized by earlier evaluations are not valid for 'r'
+	_epoch++;
+
 	SIValue result;
 	AR_EXP_Result res = _AR_EXP_Evaluate(root, r, &result);
 
@@ -539,6 +726,8 @@ SIValue AR_EXP_Evaluate(AR_ExpNode *root, const Record r) {
 }
 
 void AR_EXP_Aggregate(AR_ExpNode *root, const Record r) {
+	_epoch++;
+
 	if(AR_EXP_IsOperation(root)) {
 		if(root->op.f->aggregate == true) {
 			AR_EXP_Result res = _AR_EXP_EvaluateFunctionCall(root, r, NULL);
@@ -620,6 +809,16 @@ void AR_EXP_CollectAttributes(AR_ExpNode *root, rax *attributes) {
 			raxInsert(attributes, (unsigned char *)attr, strlen(attr), NULL, NULL);
 		}
 
+		// map projection property selectors, e.g. n {.v}
+		if(RG_STRCMP(AR_EXP_GetFuncName(root), "mapprojection") == 0) {
+			SIValue attrs = root->op.children[1]->operand.constant;
+			for(int i = 2; i < root->op.child_count; i += 2) {
+				if(SI_TYPE(SIArray_Get(attrs, (i - 2) / 2)) == T_NULL) continue;
+				const char *attr = root->op.children[i]->operand.constant.stringval;
+				raxInsert(attributes, (unsigned char *)attr, strlen(attr), NULL, NULL);
+			}
+		}
+
 		// continue scanning expression
 		for(int i = 0; i < root->op.child_count; i ++) {
 			AR_EXP_CollectAttributes(root->op.children[i], attributes);
@@ -753,7 +952,7 @@ inline const char *AR_EXP_GetFuncName(const AR_ExpNode *exp) {
 	return exp->op.f->name;
 }
 
-AR_ExpNode *AR_EXP_Clone(AR_ExpNode *exp) {
+static AR_ExpNode *_AR_EXP_Clone(AR_ExpNode *exp, AR_ExpMemoMapping **memos) {
 	if(exp == NULL) return NULL;
 
 	AR_ExpNode *clone = NULL;
@@ -763,7 +962,7 @@ AR_ExpNode *AR_EXP_Clone(AR_ExpNode *exp) {
 		clone = _AR_EXP_CloneOperand(exp);
 		break;
 	case AR_EXP_OP:
-		clone = _AR_EXP_CloneOp(exp);
+		clone = _AR_EXP_CloneOp(exp, memos);
 		break;
 	default:
 		ASSERT(false);
@@ -775,6 +974,13 @@ AR_ExpNode *AR_EXP_Clone(AR_ExpNode *exp) {
 	return clone;
 }
 
+AR_ExpNode *AR_EXP_Clone(AR_ExpNode *exp) {
+	AR_ExpMemoMapping *memos = NULL;
+	AR_ExpNode *clone = _AR_EXP_Clone(exp, &memos);
+	if(memos != NULL) array_free(memos);
+	return clone;
+}
+
 static inline void _AR_EXP_FreeOpInternals(AR_ExpNode *op_node) {
 	void *pdata = op_node->op.f->privdata;
 	AR_Func_Free free_func = op_node->op.f->bfree;
@@ -793,6 +999,11 @@ static inline void _AR_EXP_FreeOpInternals(AR_ExpNode *op_node) {
 	}
 
 	rm_free(op_node->op.children);
+
+	// release shared value, memoized values never own an allocation
+	AR_ExpMemo *memo = op_node->op.memo;
+	if(memo != NULL && --memo->refcount == 0) rm_free(memo);
+	op_node->op.memo = NULL;
 }
 
 inline void AR_EXP_Free(AR_ExpNode *root) {
@@ -42,6 +42,7 @@ typedef struct {
 	AR_FuncDesc *f;                 // Operation to perform on children
 	int child_count;                // Number of children
 	struct AR_ExpNode **children;   // Child nodes
+	struct AR_ExpMemo *memo;        // [optional] Value shared with equivalent nodes
 } AR_OpNode;
 
 // OperandNode represents either constant, parameter, or graph entity
@@ -95,6 +96,11 @@ AR_ExpNode *AR_EXP_NewRecordNode(void);
  * The val pointer is out-by-ref returned computation. */
 bool AR_EXP_ReduceToScalar(AR_ExpNode *root, bool reduce_params, SIValue *val);
 
+/* Share repeated subexpressions within the expression tree,
+ * e.g. in n.v * 2 + n.v * 2 * 0.1 the subexpression n.v * 2 is evaluated once
+ * per evaluation of the tree, its value is reused by all of its occurrences. */
+void AR_EXP_ShareSubexpressions(AR_ExpNode *root);
+
 /* Resolve variables to constants */
 void AR_EXP_ResolveVariables(AR_ExpNode *root, const Record r);
 
@@ -0,0 +1,94 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "arithmetic_expression_compile.h"
+#include "../query_ctx.h"
+#include "../graph/graphcontext.h"
+
+AR_CompiledExp AR_EXP_Compile
+(
+	AR_ExpNode *exp
+) {
+	ASSERT(exp != NULL);
+
+	AR_CompiledExp compiled = {.t = AR_COMPILED_EXP, .exp = exp};
+
+	if(AR_EXP_IsConstant(exp)) {
+		compiled.t = AR_COMPILED_CONST;
+		compiled.constant = exp->operand.constant;
+		return compiled;
+	}
+
+	if(AR_EXP_IsVariadic(exp)) {
+		compiled.t        = AR_COMPILED_VAR;
+		compiled.alias    = exp->operand.variadic.entity_alias;
+		compiled.resolved = false;
+		return compiled;
+	}
+
+	char *attr_name;
+	if(AR_EXP_IsAttribute(exp, &attr_name) &&
+	   AR_EXP_IsVariadic(exp->op.children[0])) {
+		AR_ExpNode *attr_idx = exp->op.children[2];
+		ASSERT(AR_EXP_IsConstant(attr_idx));
+
+		compiled.t         = AR_COMPILED_ATTR;
+		compiled.alias     = exp->op.children[0]->operand.variadic.entity_alias;
+		compiled.attr_name = attr_name;
+		compiled.attr      = attr_idx->operand.constant.longval;
+		compiled.resolved  = false;
+	}
+
+	return compiled;
+}
+
+// resolves the record position of the compiled expression's alias
+// falls back to the interpreter if the alias isn't part of the record
+static inline void _Resolve
+(
+	AR_CompiledExp *exp,
+	const Record r
+) {
+	exp->rec_idx = Record_GetEntryIdx(r, exp->alias);
+	exp->resolved = true;
+	// let the expression report the missing alias
+	if(exp->rec_idx == INVALID_INDEX) exp->t = AR_COMPILED_EXP;
+}
+
+SIValue AR_CompiledExp_Evaluate
+(
+	AR_CompiledExp *exp,
+	const Record r
+) {
+	ASSERT(exp != NULL);
+
+	if(exp->t == AR_COMPILED_CONST) return exp->constant;
+
+	if(exp->t == AR_COMPILED_VAR) {
+		if(!exp->resolved) _Resolve(exp, r);
+		if(exp->t == AR_COMPILED_VAR) {
+			return SI_ShareValue(Record_Get(r, exp->rec_idx));
+		}
+	}
+
+	if(exp->t == AR_COMPILED_ATTR) {
+		if(!exp->resolved) _Resolve(exp, r);
+		if(exp->t == AR_COMPILED_ATTR) {
+			RecordEntryType t = Record_GetType(r, exp->rec_idx);
+			if(t == REC_TYPE_NODE || t == REC_TYPE_EDGE) {
+				if(exp->attr == ATTRIBUTE_NOTFOUND) {
+					GraphContext *gc = QueryCtx_GetGraphCtx();
+					exp->attr = GraphContext_GetAttributeID(gc, exp->attr_name);
+				}
+				GraphEntity *e = Record_GetGraphEntity(r, exp->rec_idx);
+				return GraphEntity_GetPropertyValue(e, exp->attr);
+			}
+		}
+	}
+
+	return AR_EXP_Evaluate(exp->exp, r);
+}
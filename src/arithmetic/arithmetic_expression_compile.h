@@ -0,0 +1,56 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "arithmetic_expression.h"
+
+// compiled expressions specialise the evaluation of the most common
+// expression shapes, constants, variables and attribute accesses e.g. n.v
+// reading their value directly rather than walking the expression tree
+// any other expression is evaluated by the interpreter, AR_EXP_Evaluate
+
+typedef enum {
+	AR_COMPILED_CONST,  // constant value
+	AR_COMPILED_ATTR,   // attribute of a graph entity, e.g. n.v
+	AR_COMPILED_VAR,    // record entry, e.g. x
+	AR_COMPILED_EXP,    // arbitrary expression, interpreted
+} AR_CompiledExpType;
+
+typedef struct {
+	AR_CompiledExpType t;   // compiled expression type
+	AR_ExpNode *exp;        // compiled expression
+	SIValue constant;       // constant value, AR_COMPILED_CONST
+	const char *alias;      // entity alias, AR_COMPILED_ATTR, AR_COMPILED_VAR
+	const char *attr_name;  // attribute name, AR_COMPILED_ATTR
+	Attribute_ID attr;      // attribute ID, resolved lazily
+	uint rec_idx;           // alias position within record, resolved lazily
+	bool resolved;          // rec_idx is resolved
+} AR_CompiledExp;
+
+// compiles 'exp', which must outlive the compiled expression
+// record positions are resolved against the first evaluated record
+// and must be the same for all following records
+AR_CompiledExp AR_EXP_Compile
+(
+	AR_ExpNode *exp  // expression to compile
+);
+
+// returns true if 'exp' is evaluated by the interpreter
+static inline bool AR_CompiledExp_Interpreted
+(
+	const AR_CompiledExp *exp
+) {
+	return exp->t == AR_COMPILED_EXP;
+}
+
+// evaluates compiled expression 'exp' against 'r'
+// the returned value is to be freed by the caller, as with AR_EXP_Evaluate
+SIValue AR_CompiledExp_Evaluate
+(
+	AR_CompiledExp *exp,  // compiled expression
+	const Record r        // record to evaluate against
+);
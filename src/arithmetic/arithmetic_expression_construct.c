@@ -9,6 +9,7 @@
 #include "funcs.h"
 #include "../errors.h"
 #include "../query_ctx.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
 #include "../datatypes/array.h"
 #include "../configuration/config.h"
@@ -18,6 +19,7 @@
 static AR_ExpNode *_AR_EXP_FromASTNode(const cypher_astnode_t *expr);
 static AR_ExpNode *_AR_ExpNodeFromGraphEntity(const cypher_astnode_t *entity);
 static AR_ExpNode *_AR_ExpFromNamedPath(const cypher_astnode_t *path);
+static AR_ExpNode *_AR_ExpFromShortestPath(const cypher_astnode_t *path, bool count);
 
 static bool __AR_EXP_ContainsNestedAgg(const AR_ExpNode *root, bool in_agg) {
 	// Is this an aggregation node?
@@ -44,12 +46,12 @@ static bool _AR_EXP_ContainsNestedAgg(const AR_ExpNode *exp) {
 	return __AR_EXP_ContainsNestedAgg(exp, in_agg);
 }
 
-#define OP_COUNT 25
+#define OP_COUNT 26
 // The OpName array is strictly parallel with the AST_Operator enum.
 static const char *OpName[OP_COUNT] = {
 	"UNKNOWN", "NULL", "OR", "XOR", "AND", "NOT", "EQ", "NEQ", "LT", "GT", "LE",  "GE",
 	"ADD", "SUB", "MUL", "DIV", "MOD", "POW", "CONTAINS", "STARTS WITH",
-	"ENDS WITH", "IN", "IS NULL", "IS NOT NULL", "XNOR"
+	"ENDS WITH", "IN", "IS NULL", "IS NOT NULL", "XNOR", "=~"
 };
 
 static inline const char *_ASTOpToString(AST_Operator op) {
@@ -59,7 +61,14 @@ static inline const char *_ASTOpToString(AST_Operator op) {
 
 static AR_ExpNode *AR_EXP_NewOpNodeFromAST(AST_Operator op, uint child_count) {
 	const char *func_name = _ASTOpToString(op);
-	return AR_EXP_NewOpNode(func_name, child_count);
+	AR_ExpNode *node = AR_EXP_NewOpNode(func_name, child_count);
+
+	// regex operations cache their compiled pattern
+	if(op == OP_REGEX) {
+		node->op.f = AR_SetPrivateData(node->op.f, StringRegexCtx_New());
+	}
+
+	return node;
 }
 
 static AR_ExpNode *_AR_EXP_FromApplyExpression(const cypher_astnode_t *expr) {
@@ -71,6 +80,15 @@ static AR_ExpNode *_AR_EXP_FromApplyExpression(const cypher_astnode_t *expr) {
 	const char              *func_name  =  cypher_ast_function_name_get_value(func_node);
 	bool                    aggregate   =  AR_FuncIsAggregate(func_name);
 
+	// size(allShortestPaths(...)) counts the paths without enumerating them
+	if(arg_count == 1 && strcasecmp(func_name, "size") == 0) {
+		const cypher_astnode_t *arg = cypher_ast_apply_operator_get_argument(expr, 0);
+		if(cypher_astnode_type(arg) == CYPHER_AST_SHORTEST_PATH &&
+		   !cypher_ast_shortest_path_is_single(arg)) {
+			return _AR_ExpFromShortestPath(arg, true);
+		}
+	}
+
 	op = AR_EXP_NewOpNode(func_name, arg_count);
 
 	for(unsigned int i = 0; i < arg_count; i ++) {
@@ -346,10 +364,32 @@ static AR_ExpNode *_AR_ExpFromMapExpression(const cypher_astnode_t *expr) {
 	return op;
 }
 
+// returns the key of a map projection selector
+static const char *_AR_MapProjectionSelectorKey(const cypher_astnode_t *selector) {
+	const cypher_astnode_t *prop = NULL;
+	cypher_astnode_type_t t = cypher_astnode_type(selector);
+
+	if(t == CYPHER_AST_MAP_PROJECTION_PROPERTY) {
+		// { .name }
+		prop = cypher_ast_map_projection_property_get_prop_name(selector);
+		return cypher_ast_prop_name_get_value(prop);
+	} else if(t == CYPHER_AST_MAP_PROJECTION_LITERAL) {
+		// { v: n.v }
+		prop = cypher_ast_map_projection_literal_get_prop_name(selector);
+		return cypher_ast_prop_name_get_value(prop);
+	} else if(t == CYPHER_AST_MAP_PROJECTION_IDENTIFIER) {
+		// { v }
+		prop = cypher_ast_map_projection_identifier_get_identifier(selector);
+		return cypher_ast_identifier_get_name(prop);
+	}
+
+	ASSERT("Unexpected AST node type" && false);
+	return NULL;
+}
+
 static AR_ExpNode *_AR_ExpFromMapProjection(const cypher_astnode_t *expr) {
 	// MATCH (n) RETURN n { .name, .age, scores: collect(m.score) }
 
-	cypher_astnode_type_t t;
 	const cypher_astnode_t *identifier = cypher_ast_map_projection_get_expression(expr);
 	// Return an error if the identifier is not a string literal, like 5 in:
 	// RETURN 5 {v: 'b'}
@@ -359,46 +399,64 @@ static AR_ExpNode *_AR_ExpFromMapProjection(const cypher_astnode_t *expr) {
 	}
 	const char *entity_name = cypher_ast_identifier_get_name(identifier);
 
-	const cypher_astnode_t *selector = NULL;
+	// a selector is dropped if a later selector shares its key
+	// e.g. n {.v, v: 1}, such that the projected keys are distinct
 	unsigned int n_selectors = cypher_ast_map_projection_nselectors(expr);
+	const char **keys = array_newlen(const char *, n_selectors);
+	for(uint i = 0; i < n_selectors; i++) {
+		keys[i] = _AR_MapProjectionSelectorKey(
+				cypher_ast_map_projection_get_selector(expr, i));
+	}
+
+	uint n = 0;
+	bool *overridden = rm_calloc(n_selectors, sizeof(bool));
+	for(uint i = 0; i < n_selectors; i++) {
+		for(uint j = i + 1; j < n_selectors && !overridden[i]; j++) {
+			overridden[i] = strcmp(keys[i], keys[j]) == 0;
+		}
+		if(!overridden[i]) n++;
+	}
 
-	AR_ExpNode *op = AR_EXP_NewOpNode("tomap", n_selectors * 2);
+	// mapprojection(entity, attribute IDs, key, value, key, value...)
+	// values of property selectors are retrieved in a single pass over the
+	// entity's properties, their attribute IDs are resolved here if known
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	SIValue attrs = SI_Array(n);
+	AR_ExpNode *op = AR_EXP_NewOpNode("mapprojection", 2 + n * 2);
 	AR_ExpNode **children = op->op.children;
+	children[0] = AR_EXP_NewVariableOperandNode(entity_name);
 
+	uint idx = 2;
 	for(uint i = 0; i < n_selectors; i++) {
-		selector = cypher_ast_map_projection_get_selector(expr, i);
+		if(overridden[i]) continue;
 
-		const char *prop_name = NULL;
-		const cypher_astnode_t *prop = NULL;
-		t = cypher_astnode_type(selector);
+		const cypher_astnode_t *selector = cypher_ast_map_projection_get_selector(expr, i);
+		cypher_astnode_type_t t = cypher_astnode_type(selector);
+		SIValue attr = SI_NullVal();
+		AR_ExpNode *value;
 
 		if(t == CYPHER_AST_MAP_PROJECTION_PROPERTY) {
 			// { .name }
-			prop = cypher_ast_map_projection_property_get_prop_name(selector);
-			prop_name = cypher_ast_prop_name_get_value(prop);
-			children[i * 2] = AR_EXP_NewConstOperandNode(SI_ConstStringVal((char *)prop_name));
-			AR_ExpNode *entity = AR_EXP_NewVariableOperandNode(entity_name);
-			children[i * 2 + 1] = AR_EXP_NewAttributeAccessNode(entity, prop_name);
+			attr = SI_LongVal(GraphContext_GetAttributeID(gc, keys[i]));
+			value = AR_EXP_NewConstOperandNode(SI_NullVal());
 		} else if(t == CYPHER_AST_MAP_PROJECTION_LITERAL) {
 			// { v: n.v }
-			prop = cypher_ast_map_projection_literal_get_prop_name(selector);
-			prop_name = cypher_ast_prop_name_get_value(prop);
 			const cypher_astnode_t *literal_exp =
 				cypher_ast_map_projection_literal_get_expression(selector);
-			children[i * 2] = AR_EXP_NewConstOperandNode(SI_ConstStringVal((char *)prop_name));
-			children[i * 2 + 1] = AR_EXP_FromASTNode(literal_exp);
-		} else if(t == CYPHER_AST_MAP_PROJECTION_IDENTIFIER) {
-			// { v }
-			prop = cypher_ast_map_projection_identifier_get_identifier(selector);
-			prop_name = cypher_ast_identifier_get_name(prop);
-
-			children[i * 2] = AR_EXP_NewConstOperandNode(SI_ConstStringVal((char *)prop_name));
-
-			children[i * 2 + 1] = AR_EXP_NewVariableOperandNode(prop_name);
+			value = AR_EXP_FromASTNode(literal_exp);
 		} else {
-			ASSERT("Unexpected AST node type" && false);
+			// { v }
+			value = AR_EXP_NewVariableOperandNode(keys[i]);
 		}
+
+		SIArray_Append(&attrs, attr);
+		children[idx++] = AR_EXP_NewConstOperandNode(SI_ConstStringVal((char *)keys[i]));
+		children[idx++] = value;
 	}
+	children[1] = AR_EXP_NewConstOperandNode(attrs);
+
+	rm_free(overridden);
+	array_free(keys);
 
 	return op;
 }
@@ -444,7 +502,7 @@ static AR_ExpNode *_AR_ExpFromNamedPath(const cypher_astnode_t *path) {
 	return op;
 }
 
-static AR_ExpNode *_AR_ExpFromShortestPath(const cypher_astnode_t *path) {
+static AR_ExpNode *_AR_ExpFromShortestPath(const cypher_astnode_t *path, bool count) {
 	uint path_len = cypher_ast_pattern_path_nelements(path);
 	if(path_len != 3) {
 		ErrorCtx_SetError("shortestPath requires a path containing a single relationship");
@@ -477,11 +535,6 @@ static AR_ExpNode *_AR_ExpFromShortestPath(const cypher_astnode_t *path) {
 		}
 	}
 
-	if(!cypher_ast_shortest_path_is_single(path)) {
-		ErrorCtx_SetError("RedisGraph does not currently support allShortestPaths");
-		return AR_EXP_NewConstOperandNode(SI_NullVal());
-	}
-
 	enum cypher_rel_direction dir = cypher_ast_rel_pattern_get_direction(edge);
 	if(dir == CYPHER_REL_BIDIRECTIONAL) {
 		ErrorCtx_SetError("RedisGraph does not currently support undirected shortestPath traversals");
@@ -510,18 +563,21 @@ static AR_ExpNode *_AR_ExpFromShortestPath(const cypher_astnode_t *path) {
 		}
 	}
 
-	AR_ExpNode *op = AR_EXP_NewOpNode("shortestpath", 2);
+	const char *func_name = "shortestpath";
+	if(!cypher_ast_shortest_path_is_single(path)) {
+		func_name = count ? "allshortestpathscount" : "allshortestpaths";
+	}
+	AR_ExpNode *op = AR_EXP_NewOpNode(func_name, 2);
 
 	// Instantiate a context struct with traversal details.
 	ShortestPathCtx *ctx = rm_malloc(sizeof(ShortestPathCtx));
-	ctx->R              =  GrB_NULL;
-	ctx->TR             =  GrB_NULL;
+	ctx->R              =  NULL;
+	ctx->TR             =  NULL;
 	ctx->minHops        =  start;
 	ctx->maxHops        =  end;
 	ctx->reltypes       =  NULL;
 	ctx->reltype_names  =  reltype_names;
 	ctx->reltype_count  =  array_len(reltype_names);
-	ctx->free_matrices  =  false;
 
 	// Add the context to the function descriptor as the function's private data.
 	op->op.f = AR_SetPrivateData(op->op.f, ctx);
@@ -574,6 +630,8 @@ static AR_ExpNode *_AR_ExpNodeFromComprehensionFunction(const cypher_astnode_t *
 	ListComprehensionCtx *ctx = rm_malloc(sizeof(ListComprehensionCtx));
 	ctx->ft            =  NULL;
 	ctx->eval_exp      =  NULL;
+	ctx->program       =  NULL;
+	ctx->outer_refs    =  true;
 	ctx->local_record  =  NULL;
 	ctx->variable_str  =  NULL;
 	ctx->variable_idx  =  INVALID_INDEX;
@@ -768,7 +826,7 @@ static AR_ExpNode *_AR_EXP_FromASTNode(const cypher_astnode_t *expr) {
 	} else if(t == CYPHER_AST_NAMED_PATH) {
 		return _AR_ExpFromNamedPath(expr);
 	} else if(t == CYPHER_AST_SHORTEST_PATH) {
-		return _AR_ExpFromShortestPath(expr);
+		return _AR_ExpFromShortestPath(expr, false);
 	} else if(t == CYPHER_AST_NODE_PATTERN || t == CYPHER_AST_REL_PATTERN) {
 		return _AR_ExpNodeFromGraphEntity(expr);
 	} else if(t == CYPHER_AST_PARAMETER) {
@@ -805,10 +863,36 @@ static AR_ExpNode *_AR_EXP_FromASTNode(const cypher_astnode_t *expr) {
 	return NULL;
 }
 
+// attaches a hash index context to IN operations over a constant
+// or parameter list, such that the list is hashed once per execution
+static void _AR_EXP_IndexInLists(AR_ExpNode *root) {
+	if(!AR_EXP_IsOperation(root)) return;
+
+	for(int i = 0; i < root->op.child_count; i++) {
+		_AR_EXP_IndexInLists(root->op.children[i]);
+	}
+
+	if(root->op.f->privdata != NULL) return;
+	if(strcasecmp(AR_EXP_GetFuncName(root), "in") != 0) return;
+
+	AR_ExpNode *list = root->op.children[1];
+	bool constant_list = AR_EXP_IsConstant(list) &&
+		SI_TYPE(list->operand.constant) == T_ARRAY;
+	if(!constant_list && !AR_EXP_IsParameter(list)) return;
+
+	root->op.f = AR_SetPrivateData(root->op.f, ListInCtx_New());
+	AR_SetPrivateDataRoutines(root->op.f, ListInCtx_Free, ListInCtx_Clone);
+}
+
 AR_ExpNode *AR_EXP_FromASTNode(const cypher_astnode_t *expr) {
 	AR_ExpNode *root = _AR_EXP_FromASTNode(expr);
 	AR_EXP_ReduceToScalar(root, false, NULL);
 
+	// evaluate repeated subexpressions once per evaluation
+	AR_EXP_ShareSubexpressions(root);
+
+	_AR_EXP_IndexInLists(root);
+
 	/* Make sure expression doesn't contains nested aggregation functions
 	 * count(max(n.v)) */
 	if(_AR_EXP_ContainsNestedAgg(root)) {
@@ -21,6 +21,8 @@ void ListComprehension_Free(void *ctx_ptr) {
 
 	// If this comprehension has a filter tree, free it.
 	if(ctx->ft) FilterTree_Free(ctx->ft);
+	// The compiled predicate references the filter tree, free it as well.
+	if(ctx->program) FT_Program_Free(ctx->program);
 	// If this comprehension has an eval routine, free it.
 	if(ctx->eval_exp) AR_EXP_Free(ctx->eval_exp);
 
@@ -45,6 +47,8 @@ void *ListComprehension_Clone(void *orig) {
 	ctx_clone->variable_str = ctx->variable_str;
 	ctx_clone->variable_idx = ctx->variable_idx;
 	ctx_clone->local_record = NULL;
+	ctx_clone->program = NULL;
+	ctx_clone->outer_refs = true;
 
 	// Clone the predicate filter tree, if present.
 	ctx_clone->ft = FilterTree_Clone(ctx->ft);
@@ -54,6 +58,42 @@ void *ListComprehension_Clone(void *orig) {
 	return ctx_clone;
 }
 
+// returns true if 'exp' reads any record entry other than the local variable
+static bool _ExpReferencesOuter(const AR_ExpNode *exp, const char *var) {
+	if(AR_EXP_IsOperation(exp)) {
+		for(int i = 0; i < exp->op.child_count; i++) {
+			if(_ExpReferencesOuter(exp->op.children[i], var)) return true;
+		}
+		return false;
+	}
+
+	switch(exp->operand.type) {
+		case AR_EXP_VARIADIC:
+			return strcmp(exp->operand.variadic.entity_alias, var) != 0;
+		case AR_EXP_BORROW_RECORD:
+			// nested comprehensions may access any record entry
+			return true;
+		default:
+			return false;
+	}
+}
+
+static bool _FilterReferencesOuter(const FT_FilterNode *ft, const char *var) {
+	switch(ft->t) {
+		case FT_N_COND:
+			return (ft->cond.left && _FilterReferencesOuter(ft->cond.left, var)) ||
+				   (ft->cond.right && _FilterReferencesOuter(ft->cond.right, var));
+		case FT_N_PRED:
+			return _ExpReferencesOuter(ft->pred.lhs, var) ||
+				   _ExpReferencesOuter(ft->pred.rhs, var);
+		case FT_N_EXP:
+			return _ExpReferencesOuter(ft->exp.exp, var);
+		default:
+			ASSERT(false);
+			return true;
+	}
+}
+
 static void _PopulateComprehensionCtx(ListComprehensionCtx *ctx, Record outer_record) {
 	rax *local_record_map = raxClone(outer_record->mapping);
 	intptr_t id = raxSize(local_record_map);
@@ -70,6 +110,28 @@ static void _PopulateComprehensionCtx(ListComprehensionCtx *ctx, Record outer_re
 	// This could just be assigned to 'id', but for safety we'll use a Record lookup.
 	ctx->variable_idx = Record_GetEntryIdx(ctx->local_record, ctx->variable_str);
 	ASSERT(ctx->variable_idx != INVALID_INDEX);
+
+	// The predicate is evaluated once per element, compile it.
+	if(ctx->ft) ctx->program = FilterTree_Compile(ctx->ft);
+
+	// Predicates and projections which only access the local variable
+	// don't require the outer Record's values.
+	ctx->outer_refs =
+		(ctx->ft && _FilterReferencesOuter(ctx->ft, ctx->variable_str)) ||
+		(ctx->eval_exp && _ExpReferencesOuter(ctx->eval_exp, ctx->variable_str));
+}
+
+// Retrieves the local Record, populated with the outer Record's values
+// if the comprehension references them.
+static inline Record _LocalRecord(ListComprehensionCtx *ctx, Record outer_record) {
+	// On the first invocation, build the local Record.
+	if(ctx->local_record == NULL) _PopulateComprehensionCtx(ctx, outer_record);
+	Record r = ctx->local_record;
+
+	// Populate the local Record with the contents of the outer Record.
+	if(ctx->outer_refs) Record_Clone(outer_record, r);
+
+	return r;
 }
 
 
@@ -83,12 +145,7 @@ SIValue AR_ANY(SIValue *argv, int argc) {
 	Record outer_record = argv[1].ptrval;
 	ListComprehensionCtx *ctx = argv[2].ptrval;
 
-	// On the first invocation, build the local Record.
-	if(ctx->local_record == NULL) _PopulateComprehensionCtx(ctx, outer_record);
-	Record r = ctx->local_record;
-
-	// Populate the local Record with the contents of the outer Record.
-	Record_Clone(outer_record, r);
+	Record r = _LocalRecord(ctx, outer_record);
 
 	uint len = SIArray_Length(list);
 	for(uint i = 0; i < len; i++) {
@@ -98,7 +155,7 @@ SIValue AR_ANY(SIValue *argv, int argc) {
 		Record_AddScalar(r, ctx->variable_idx, current_elem);
 
 		// If any element in an ANY function passes the predicate, return true.
-		if(FilterTree_applyFilters(ctx->ft, r)) return SI_BoolVal(true);
+		if(FT_Program_Apply(ctx->program, r)) return SI_BoolVal(true);
 	}
 
 	// No element passed, return false.
@@ -115,12 +172,7 @@ SIValue AR_ALL(SIValue *argv, int argc) {
 	Record outer_record = argv[1].ptrval;
 	ListComprehensionCtx *ctx = argv[2].ptrval;
 
-	// On the first invocation, build the local Record.
-	if(ctx->local_record == NULL) _PopulateComprehensionCtx(ctx, outer_record);
-	Record r = ctx->local_record;
-
-	// Populate the local Record with the contents of the outer Record.
-	Record_Clone(outer_record, r);
+	Record r = _LocalRecord(ctx, outer_record);
 
 	uint len = SIArray_Length(list);
 	for(uint i = 0; i < len; i++) {
@@ -130,7 +182,7 @@ SIValue AR_ALL(SIValue *argv, int argc) {
 		Record_AddScalar(r, ctx->variable_idx, current_elem);
 
 		// If any element in an ALL function does not pass the predicate, return false.
-		if(!FilterTree_applyFilters(ctx->ft, r)) return SI_BoolVal(false);
+		if(!FT_Program_Apply(ctx->program, r)) return SI_BoolVal(false);
 	}
 
 	// All elements passed, return true.
@@ -147,12 +199,7 @@ SIValue AR_SINGLE(SIValue *argv, int argc) {
 	Record outer_record = argv[1].ptrval;
 	ListComprehensionCtx *ctx = argv[2].ptrval;
 
-	// On the first invocation, build the local Record.
-	if(ctx->local_record == NULL) _PopulateComprehensionCtx(ctx, outer_record);
-	Record r = ctx->local_record;
-
-	// Populate the local Record with the contents of the outer Record.
-	Record_Clone(outer_record, r);
+	Record r = _LocalRecord(ctx, outer_record);
 
 	bool single = false;
 	uint len = SIArray_Length(list);
@@ -163,7 +210,7 @@ SIValue AR_SINGLE(SIValue *argv, int argc) {
 		Record_AddScalar(r, ctx->variable_idx, current_elem);
 
 		// If more then 1 element in a SINGLE function pass the predicate, return false.
-		if(FilterTree_applyFilters(ctx->ft, r)) {
+		if(FT_Program_Apply(ctx->program, r)) {
 			if(single) return SI_BoolVal(false);
 			else single = true;
 		}
@@ -183,12 +230,7 @@ SIValue AR_NONE(SIValue *argv, int argc) {
 	Record outer_record = argv[1].ptrval;
 	ListComprehensionCtx *ctx = argv[2].ptrval;
 
-	// On the first invocation, build the local Record.
-	if(ctx->local_record == NULL) _PopulateComprehensionCtx(ctx, outer_record);
-	Record r = ctx->local_record;
-
-	// Populate the local Record with the contents of the outer Record.
-	Record_Clone(outer_record, r);
+	Record r = _LocalRecord(ctx, outer_record);
 
 	uint len = SIArray_Length(list);
 	for(uint i = 0; i < len; i++) {
@@ -198,7 +240,7 @@ SIValue AR_NONE(SIValue *argv, int argc) {
 		Record_AddScalar(r, ctx->variable_idx, current_elem);
 
 		// If any element in an NONE function pass the predicate, return false.
-		if(FilterTree_applyFilters(ctx->ft, r)) return SI_BoolVal(false);
+		if(FT_Program_Apply(ctx->program, r)) return SI_BoolVal(false);
 	}
 
 	// No elements passed, return true.
@@ -216,12 +258,7 @@ SIValue AR_LIST_COMPREHENSION(SIValue *argv, int argc) {
 	Record outer_record = argv[1].ptrval;
 	ListComprehensionCtx *ctx = argv[2].ptrval;
 
-	// On the first invocation, build the local Record.
-	if(ctx->local_record == NULL) _PopulateComprehensionCtx(ctx, outer_record);
-	Record r = ctx->local_record;
-
-	// Populate the local Record with the contents of the outer Record.
-	Record_Clone(outer_record, r);
+	Record r = _LocalRecord(ctx, outer_record);
 	// Instantiate the array to be returned.
 	SIValue retval = SI_Array(0);
 
@@ -234,7 +271,7 @@ SIValue AR_LIST_COMPREHENSION(SIValue *argv, int argc) {
 
 		/* If the comprehension has a filter tree, run the current element through it.
 		 * If it does not pass, skip this element. */
-		if(ctx->ft && !(FilterTree_applyFilters(ctx->ft, r))) continue;
+		if(ctx->ft && !(FT_Program_Apply(ctx->program, r))) continue;
 
 		if(ctx->eval_exp) {
 			// Compute the current element to append to the return list.
@@ -8,6 +8,7 @@
 
 #include "../arithmetic_expression.h"
 #include "../../filter_tree/filter_tree.h"
+#include "../../filter_tree/ft_program.h"
 
 typedef struct {
 	const char *variable_str;  // String name of the comprehension's local variable
@@ -15,6 +16,8 @@ typedef struct {
 	FT_FilterNode *ft;         // [optional] The predicate tree to evaluate each element against.
 	AR_ExpNode *eval_exp;      // [optional] The projection routine to build each return element.
 	Record local_record;       // Record to populate with the input record's values and the list element.
+	FT_Program *program;       // [optional] The compiled predicate, built on first invocation.
+	bool outer_refs;           // The predicate or projection reference the input record's values.
 } ListComprehensionCtx;
 
 void Register_ComprehensionFuncs(void);
@@ -217,8 +217,7 @@ SIValue AR_PROPERTY(SIValue *argv, int argc) {
 		}
 
 		// Retrieve the property.
-		SIValue *value = GraphEntity_GetProperty(graph_entity, prop_idx);
-		return SI_ConstValue(value);
+		return GraphEntity_GetPropertyValue(graph_entity, prop_idx);
 	} else {
 		// retrieve map key
 		SIValue key = argv[1];
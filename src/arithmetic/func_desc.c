@@ -32,12 +32,15 @@ AR_FuncDesc *AR_FuncDescNew
 	desc->bfree      =  NULL;
 	desc->bclone     =  NULL;
 	desc->types      =  types;
+	desc->batch      =  NULL;
 	desc->finalize   =  NULL;
 	desc->privdata   =  NULL;
 	desc->min_argc   =  min_argc;
 	desc->max_argc   =  max_argc;
 	desc->aggregate  =  aggregate;
 	desc->reducible  =  reducible;
+	desc->deterministic = true;
+	desc->query_constant = false;
 
 	return desc;
 }
@@ -81,24 +84,41 @@ AR_FuncDesc *AR_GetFunc(const char *func_name) {
 
 }
 
-bool AR_FuncExists(const char *func_name) {
+const AR_FuncDesc *AR_FuncLookup(const char *func_name) {
 	size_t len = strlen(func_name);
 	char lower_func_name[len];
 	str_tolower(func_name, lower_func_name, &len);
-	void *f = raxFind(__aeRegisteredFuncs, (unsigned char *)lower_func_name, len);
+	AR_FuncDesc *f = raxFind(__aeRegisteredFuncs, (unsigned char *)lower_func_name, len);
 
-	return f != raxNotFound;
+	return (f == raxNotFound) ? NULL : f;
+}
+
+bool AR_FuncExists(const char *func_name) {
+	return AR_FuncLookup(func_name) != NULL;
 }
 
 bool AR_FuncIsAggregate(const char *func_name) {
+	const AR_FuncDesc *f = AR_FuncLookup(func_name);
+	return f != NULL && f->aggregate;
+}
+
+bool AR_FuncIsDeterministic(const char *func_name) {
 	size_t len = strlen(func_name);
 	char lower_func_name[len];
 	str_tolower(func_name, lower_func_name, &len);
 	AR_FuncDesc *f = raxFind(__aeRegisteredFuncs, (unsigned char *)lower_func_name, len);
 
-	if(f == raxNotFound) return false;
+	if(f == raxNotFound) return true;
+
+	return f->deterministic;
+}
 
-	return f->aggregate;
+void AR_SetNonDeterministic(AR_FuncDesc *func_desc) {
+	func_desc->deterministic = false;
+}
+
+void AR_SetQueryConstant(AR_FuncDesc *func_desc) {
+	func_desc->query_constant = true;
 }
 
 inline void AR_SetPrivateDataRoutines(AR_FuncDesc *func_desc, AR_Func_Free bfree,
@@ -111,6 +131,11 @@ void AR_SetFinalizeRoutine(AR_FuncDesc *func_desc, AR_Func_Finalize finalize) {
 	func_desc->finalize = finalize;
 }
 
+void AR_SetAggregateBatchRoutine(AR_FuncDesc *func_desc,
+		AR_Func_AggregateBatch batch) {
+	func_desc->batch = batch;
+}
+
 void AR_Finalize(AR_FuncDesc *func_desc) {
 	if(func_desc->finalize) func_desc->finalize(func_desc->privdata);
 }
@@ -17,6 +17,10 @@ typedef SIValue(*AR_Func)(SIValue *argv, int argc);
 /* AR_Func_Finalize - Function pointer to a routine for computing an aggregate function's final value. */
 typedef void (*AR_Func_Finalize)(void *ctx);
 
+/* AR_Func_AggregateBatch - Function pointer to a routine aggregating a batch of numeric values,
+ * 'values' is an array of 'count' int64_t if 't' is T_INT64, or doubles if 't' is T_DOUBLE. */
+typedef void (*AR_Func_AggregateBatch)(void *ctx, SIType t, const void *values, uint count);
+
 /* AR_Func_Free - Function pointer to a routine for freeing a function's private data. */
 typedef void (*AR_Func_Free)(void *ctx);
 /* AR_Func_Clone - Function pointer to a routine for cloning a function's private data. */
@@ -29,11 +33,14 @@ typedef struct {
 	uint max_argc;             // Maximal number of arguments function expects
 	bool reducible;            // Can be reduced using static evaluation.
 	bool aggregate;            // True if the function is an aggregation.
+	bool deterministic;        // False if the function may return different results for the same input.
+	bool query_constant;       // Returns the same result throughout a query, e.g. timestamp().
 	void *privdata;            // [optional] Private data used in evaluating this function.
 	const char *name;          // Function name.
 	AR_Func_Free bfree;        // [optional] Function pointer to function cleanup routine.
 	AR_Func_Clone bclone;      // [optional] Function pointer to function clone routine.
 	AR_Func_Finalize finalize; // [optional] Function pointer to routine for finalizing aggregate value.
+	AR_Func_AggregateBatch batch; // [optional] Function pointer to routine aggregating a batch of numeric values.
 } AR_FuncDesc;
 
 AR_FuncDesc *AR_FuncDescNew(const char *name, AR_Func func, uint min_argc, uint max_argc,
@@ -45,6 +52,11 @@ void AR_RegFunc(AR_FuncDesc *func);
 /* Retrieves an arithmetic function by its name. */
 AR_FuncDesc *AR_GetFunc(const char *func_name);
 
+/* Retrieves the registered descriptor of an arithmetic function by its name,
+ * unlike AR_GetFunc the descriptor is shared and must not be modified.
+ * Returns NULL if the function doesn't exist. */
+const AR_FuncDesc *AR_FuncLookup(const char *func_name);
+
 /* Check to see if function exists.
  * TODO: move this function to more appropriate place. */
 bool AR_FuncExists(const char *func_name);
@@ -52,12 +64,26 @@ bool AR_FuncExists(const char *func_name);
 /* Check to see if function is an aggregation. */
 bool AR_FuncIsAggregate(const char *func_name);
 
+/* Check to see if function always returns the same result for the same input. */
+bool AR_FuncIsDeterministic(const char *func_name);
+
+/* Mark function as returning different results for the same input, e.g. rand(). */
+void AR_SetNonDeterministic(AR_FuncDesc *func_desc);
+
+/* Mark function as returning the same result throughout a query,
+ * such that it is evaluated once per query, e.g. timestamp(). */
+void AR_SetQueryConstant(AR_FuncDesc *func_desc);
+
 /* Set the function pointers for cloning and freeing a function's private data. */
 void AR_SetPrivateDataRoutines(AR_FuncDesc *func_desc, AR_Func_Free bfree, AR_Func_Clone bclone);
 
 /* Set the function pointer for computing an aggregate function's final value. */
 void AR_SetFinalizeRoutine(AR_FuncDesc *func_desc, AR_Func_Finalize finalize);
 
+/* Set the function pointer for aggregating a batch of numeric values,
+ * the batch routine is only invoked once the function's context was initialized by 'func'. */
+void AR_SetAggregateBatchRoutine(AR_FuncDesc *func_desc, AR_Func_AggregateBatch batch);
+
 /* Invoke finalize routine for function. */
 void AR_Finalize(AR_FuncDesc *func_desc);
 
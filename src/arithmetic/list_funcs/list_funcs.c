@@ -5,6 +5,7 @@
  */
 
 #include "list_funcs.h"
+#include <math.h>
 #include "RG.h"
 #include "../func_desc.h"
 #include "../../errors.h"
@@ -104,6 +105,84 @@ static void _PopulateReduceCtx
 	ASSERT(ctx->accumulator_idx != INVALID_INDEX);
 }
 
+//------------------------------------------------------------------------------
+// IN context
+//------------------------------------------------------------------------------
+
+// lists shorter than this are scanned rather than indexed
+#define IN_INDEX_THRESHOLD 16
+
+// largest magnitude at which every integer has an exact double representation
+#define IN_MAX_EXACT_INT 9007199254740992LL
+
+void *ListInCtx_New(void) {
+	return rm_calloc(1, sizeof(ListInCtx));
+}
+
+void *ListInCtx_Clone
+(
+	void *orig
+) {
+	UNUSED(orig);
+	// the clone indexes its own list operand on first evaluation
+	return ListInCtx_New();
+}
+
+void ListInCtx_Free
+(
+	void *ctx_ptr
+) {
+	ListInCtx *ctx = ctx_ptr;
+	if(ctx->index) raxFree(ctx->index);
+	rm_free(ctx);
+}
+
+// maps the hash of each scalar element of 'list' to the element's position
+static void _ListInCtx_Index
+(
+	ListInCtx *ctx,
+	SIValue list
+) {
+	if(ctx->index) raxFree(ctx->index);
+
+	ctx->index  =  raxNew();
+	ctx->list   =  list.array;
+	ctx->nulls  =  false;
+	ctx->exact  =  true;
+
+	uint n = SIArray_Length(list);
+	for(uint i = 0; i < n; i++) {
+		SIValue v = SIArray_Get(list, i);
+		switch(SI_TYPE(v)) {
+			case T_NULL:
+				ctx->nulls = true;
+				continue;
+			case T_INT64:
+				// large integers compare equal to doubles of a different hash
+				if(v.longval > IN_MAX_EXACT_INT || v.longval < -IN_MAX_EXACT_INT) {
+					ctx->exact = false;
+				}
+				break;
+			case T_DOUBLE:
+				if(!isfinite(v.doubleval) || fabs(v.doubleval) > IN_MAX_EXACT_INT) {
+					ctx->exact = false;
+				}
+				break;
+			case T_BOOL:
+			case T_STRING:
+				break;
+			default:
+				// composite values never equal a scalar lookup value
+				continue;
+		}
+
+		// duplicates keep the position of their first occurrence
+		XXH64_hash_t hash = SIValue_HashCode(v);
+		raxTryInsert(ctx->index, (unsigned char *)&hash, sizeof(hash),
+				(void *)(uintptr_t)i, NULL);
+	}
+}
+
 // Forward declaration of property function.
 SIValue AR_PROPERTY(SIValue *argv, int argc);
 
@@ -241,14 +320,41 @@ SIValue AR_RANGE(SIValue *argv, int argc) {
 /* Checks if a value is in a given list.
    "RETURN 3 IN [1, 2, 3]" will return true */
 SIValue AR_IN(SIValue *argv, int argc) {
-	ASSERT(argc == 2);
+	ASSERT(argc == 2 || argc == 3);
 	if(SI_TYPE(argv[1]) == T_NULL) return SI_NullVal();
 	ASSERT(SI_TYPE(argv[1]) == T_ARRAY);
 	SIValue lookupValue = argv[0];
 	SIValue lookupList = argv[1];
+	uint arrayLen = SIArray_Length(lookupList);
+
+	// a constant list carries a context, probe its hash index
+	// rather than comparing against every element
+	SIType t = SI_TYPE(lookupValue);
+	if(argc == 3 && arrayLen >= IN_INDEX_THRESHOLD &&
+	   (t & (T_INT64 | T_BOOL | T_STRING) ||
+		(t == T_DOUBLE && isfinite(lookupValue.doubleval)))) {
+		ListInCtx *ctx = argv[2].ptrval;
+		if(ctx->list != lookupList.array) _ListInCtx_Index(ctx, lookupList);
+
+		if(ctx->exact) {
+			XXH64_hash_t hash = SIValue_HashCode(lookupValue);
+			void *pos = raxFind(ctx->index, (unsigned char *)&hash,
+					sizeof(hash));
+			if(pos == raxNotFound) {
+				// no element is equal to the lookup value
+				return ctx->nulls ? SI_NullVal() : SI_BoolVal(false);
+			}
+
+			SIValue elem = SIArray_Get(lookupList, (uintptr_t)pos);
+			if(SIValue_Compare(lookupValue, elem, NULL) == 0) {
+				return SI_BoolVal(true);
+			}
+			// hash collision, fall back to a scan
+		}
+	}
+
 	// indicate if there was a null comparison during the array scan
 	bool comparedNull = false;
-	uint arrayLen = SIArray_Length(lookupList);
 	for(uint i = 0; i < arrayLen; i++) {
 		int disjointOrNull = 0;
 		int compareValue = SIValue_Compare(lookupValue, SIArray_Get(lookupList, i), &disjointOrNull);
@@ -393,10 +499,11 @@ void Register_ListFuncs() {
 	func_desc = AR_FuncDescNew("range", AR_RANGE, 2, 3, types, true, false);
 	AR_RegFunc(func_desc);
 
-	types = array_new(SIType, 2);
+	types = array_new(SIType, 3);
 	array_append(types, SI_ALL);
 	array_append(types, T_ARRAY | T_NULL);
-	func_desc = AR_FuncDescNew("in", AR_IN, 2, 2, types, true, false);
+	array_append(types, T_PTR);  // context over a constant list, if any
+	func_desc = AR_FuncDescNew("in", AR_IN, 2, 3, types, true, false);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 1);
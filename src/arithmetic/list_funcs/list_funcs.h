@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "rax.h"
 #include "../../value.h"
 #include "../arithmetic_expression.h"
 
@@ -19,5 +20,29 @@ typedef struct {
 	Record record;            // internal private record
 } ListReduceCtx;
 
+// IN function context object
+// indexes a constant list operand by element hash
+typedef struct {
+	const SIValue *list;  // list the index was built for
+	rax *index;           // element hash to element position
+	bool nulls;           // list contains null elements
+	bool exact;           // element hashes agree with element comparison
+} ListInCtx;
+
+// creates an empty IN context, the index is built on first evaluation
+void *ListInCtx_New(void);
+
+// routine for cloning an IN function private data
+void *ListInCtx_Clone
+(
+	void *orig
+);
+
+// routine for freeing an IN function private data
+void ListInCtx_Free
+(
+	void *ctx_ptr
+);
+
 void Register_ListFuncs();
 
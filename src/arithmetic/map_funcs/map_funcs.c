@@ -8,8 +8,11 @@
 #include "RG.h"
 #include "../func_desc.h"
 #include "../../errors.h"
+#include "../../query_ctx.h"
 #include "../../util/arr.h"
+#include "../../util/rmalloc.h"
 #include "../../datatypes/map.h"
+#include "../../datatypes/array.h"
 #include "../../graph/entities/graph_entity.h"
 
 SIValue AR_TOMAP(SIValue *argv, int argc) {
@@ -41,6 +44,87 @@ SIValue AR_TOMAP(SIValue *argv, int argc) {
 	return map;
 }
 
+// map projection, e.g. n {.name, .age, v: 1}
+// argv[0] - projected node, edge or map
+// argv[1] - attribute ID of each selector, null for non-property selectors
+// argv[2..] - selectors key/value pairs, keys are distinct string literals
+SIValue AR_MAPPROJECTION(SIValue *argv, int argc) {
+	SIValue obj   = argv[0];
+	SIValue attrs = argv[1];
+	int n = (argc - 2) / 2;
+	ASSERT(SIArray_Length(attrs) == (uint32_t)n);
+
+	// small selector sets are staged on the stack
+	Attribute_ID _ids[16];
+	SIValue _values[16];
+	Attribute_ID *ids = (n > 16) ? rm_malloc(sizeof(Attribute_ID) * n) : _ids;
+	SIValue *values = (n > 16) ? rm_malloc(sizeof(SIValue) * n) : _values;
+
+	// retrieve property selectors
+	int k = 0;
+	GraphContext *gc = NULL;
+	for(int i = 0; i < n; i++) {
+		SIValue attr = SIArray_Get(attrs, i);
+		if(SI_TYPE(attr) == T_NULL) continue;
+
+		SIValue key = argv[2 + i * 2];
+		Attribute_ID id = attr.longval;
+		if(SI_TYPE(obj) == T_MAP) {
+			Map_Get(obj, key, values + k);
+		} else if(id == ATTRIBUTE_NOTFOUND) {
+			// attribute was unknown when the expression was constructed
+			if(gc == NULL) gc = QueryCtx_GetGraphCtx();
+			id = GraphContext_GetAttributeID(gc, key.stringval);
+		}
+		ids[k++] = id;
+	}
+
+	if(SI_TYPE(obj) & SI_GRAPHENTITY) {
+		// a single pass over the entity's properties
+		GraphEntity_GetProperties(obj.ptrval, ids, k, values);
+	} else if(SI_TYPE(obj) == T_NULL) {
+		for(int i = 0; i < k; i++) values[i] = SI_NullVal();
+	}
+
+	// keys are referenced rather than duplicated
+	k = 0;
+	SIValue map = SI_Map(n);
+	for(int i = 0; i < n; i++) {
+		bool property = SI_TYPE(SIArray_Get(attrs, i)) != T_NULL;
+		SIValue val = property ? values[k++] : argv[3 + i * 2];
+		Map_AddConstKey(&map, argv[2 + i * 2].stringval, val);
+	}
+
+	// the map holds its own copies of the retrieved values
+	for(int i = 0; i < k; i++) SIValue_Free(values[i]);
+
+	if(ids != _ids) rm_free(ids);
+	if(values != _values) rm_free(values);
+
+	return map;
+}
+
+// returns a map of all properties of a node or an edge
+// attribute names are referenced rather than duplicated
+SIValue AR_PROPERTIES(SIValue *argv, int argc) {
+	SIValue obj = argv[0];
+	if(SI_TYPE(obj) == T_NULL) return SI_NullVal();
+	if(SI_TYPE(obj) == T_MAP) return SI_ShareValue(obj);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GraphEntity *e = obj.ptrval;
+	int n = ENTITY_PROP_COUNT(e);
+	const Attribute_ID *ids = ENTITY_PROP_IDS(e);
+
+	SIValue map = SI_Map(n);
+	for(int i = 0; i < n; i++) {
+		const char *key = GraphContext_GetAttributeString(gc, ids[i]);
+		Map_AddConstKey(&map, key, *Entity_ReadValue(ENTITY_PROP_VALUES(e) + i));
+	}
+
+	return map;
+}
+
 SIValue AR_KEYS(SIValue *argv, int argc) {
 	ASSERT(argc == 1);
 	switch(SI_TYPE(argv[0])) {
@@ -70,5 +154,18 @@ void Register_MapFuncs() {
 	array_append(types, T_NULL | T_MAP | T_NODE | T_EDGE);
 	func_desc = AR_FuncDescNew("keys", AR_KEYS, 1, 1, types, true, false);
 	AR_RegFunc(func_desc);
+
+	types = array_new(SIType, 3);
+	array_append(types, T_NULL | T_MAP | T_NODE | T_EDGE);
+	array_append(types, T_ARRAY);
+	array_append(types, SI_ALL);
+	func_desc = AR_FuncDescNew("mapprojection", AR_MAPPROJECTION, 2, VAR_ARG_LEN,
+			types, true, false);
+	AR_RegFunc(func_desc);
+
+	types = array_new(SIType, 1);
+	array_append(types, T_NULL | T_MAP | T_NODE | T_EDGE);
+	func_desc = AR_FuncDescNew("properties", AR_PROPERTIES, 1, 1, types, true, false);
+	AR_RegFunc(func_desc);
 }
 
@@ -193,6 +193,7 @@ void Register_NumericFuncs() {
 
 	types = array_new(SIType, 0);
 	func_desc = AR_FuncDescNew("rand", AR_RAND, 0, 0, types, false, false);
+	AR_SetNonDeterministic(func_desc);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 1);
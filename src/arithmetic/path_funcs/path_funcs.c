@@ -11,8 +11,10 @@
 #include "../../query_ctx.h"
 #include "../../util/rmalloc.h"
 #include "../../configuration/config.h"
+#include "../../datatypes/array.h"
 #include "../../datatypes/path/sipath_builder.h"
-#include "../../algorithms/LAGraph_bfs_pushpull.h"
+#include "../../algorithms/bidirectional_bfs.h"
+#include "../../algorithms/all_shortest_paths.h"
 
 /* Creates a path from a given sequence of graph entities.
  * The first argument is the ast node represents the path.
@@ -69,10 +71,8 @@ void ShortestPath_Free(void *ctx_ptr) {
 	ShortestPathCtx *ctx = ctx_ptr;
 	if(ctx->reltypes) array_free(ctx->reltypes);
 	if(ctx->reltype_names) array_free(ctx->reltype_names);
-	if(ctx->free_matrices) {
-		GrB_free(&ctx->R);
-		GrB_free(&ctx->TR);
-	}
+	if(ctx->R) array_free(ctx->R);
+	if(ctx->TR) array_free(ctx->TR);
 	rm_free(ctx);
 }
 
@@ -91,37 +91,19 @@ void *ShortestPath_Clone(void *orig) {
 	if(ctx->reltype_names) array_clone(ctx_clone->reltype_names, ctx->reltype_names);
 	else ctx_clone->reltype_names = NULL;
 	// Do not clone matrix data
-	ctx_clone->R = GrB_NULL;
-	ctx_clone->TR = GrB_NULL;
-	ctx_clone->free_matrices = false;
+	ctx_clone->R = NULL;
+	ctx_clone->TR = NULL;
 
 	return ctx_clone;
 }
 
-SIValue AR_SHORTEST_PATH(SIValue *argv, int argc) {
-	if(SI_TYPE(argv[0]) == T_NULL) return SI_NullVal();
-	if(SI_TYPE(argv[1]) == T_NULL) return SI_NullVal();
-	ASSERT(SI_TYPE(argv[2]) != T_NULL);
-
-	Node             *srcNode   =  argv[0].ptrval;
-	Node             *destNode  =  argv[1].ptrval;
-	ShortestPathCtx  *ctx       =  argv[2].ptrval;
-	int64_t src_id              =  ENTITY_GET_ID(srcNode);
-	int64_t dest_id             =  ENTITY_GET_ID(destNode);
-
-	GrB_Info res;
-	UNUSED(res);
-	Edge *edges = NULL;
-	GrB_Vector V = GrB_NULL;  // vector of results
-	GrB_Vector PI = GrB_NULL; // vector backtracking results to their parents
-	GraphContext *gc = QueryCtx_GetGraphCtx();
-
-	/* The BFS algorithm uses a level of 1 to indicate the source node.
-	 * If this value is not zero (unlimited), increment it by 1
-	 * to make level 1 indicate the source's direct neighbors. */
-	int64_t max_level = (ctx->maxHops == EDGE_LENGTH_INF) ? 0 : ctx->maxHops + 1;
-
-	if(ctx->R == GrB_NULL) {
+// retrieves the matrices traversed by 'ctx'
+static void _ShortestPath_CollectMatrices
+(
+	ShortestPathCtx *ctx,
+	GraphContext *gc
+) {
+	if(ctx->R == NULL) {
 		// First invocation, initialize unset context members.
 		if(ctx->reltype_count > 0) {
 			// Retrieve IDs of traversed relationship types.
@@ -136,101 +118,96 @@ SIValue AR_SHORTEST_PATH(SIValue *argv, int argc) {
 			ctx->reltype_count = array_len(ctx->reltypes);
 		}
 
-		// Get edge matrix and transpose matrix, if available.
-		if(ctx->reltypes == NULL) {
-			// No edge types were specified, use the overall adjacency matrix.
-			ctx->free_matrices = true;
-			res = RG_Matrix_export(&ctx->R, Graph_GetAdjacencyMatrix(gc->g,
-						false));
-			ASSERT(res == GrB_SUCCESS);
-			res = RG_Matrix_export(&ctx->TR, Graph_GetAdjacencyMatrix(gc->g,
-						true));
-			ASSERT(res == GrB_SUCCESS);
-		} else if(ctx->reltype_count == 0) {
-			// If edge types were specified but none were valid,
-			// use the zero matrix
-			ctx->free_matrices = true;
-			res = RG_Matrix_export(&ctx->R, Graph_GetZeroMatrix(gc->g));
-			ASSERT(res == GrB_SUCCESS);
-			res = RG_Matrix_export(&ctx->TR, Graph_GetZeroMatrix(gc->g));
-			ASSERT(res == GrB_SUCCESS);
-		} else if(ctx->reltype_count == 1) {
-			ctx->free_matrices = true;
-			res = RG_Matrix_export(&ctx->R, Graph_GetRelationMatrix(gc->g,
-						ctx->reltypes[0], false));
-			ASSERT(res == GrB_SUCCESS);
-			res = RG_Matrix_export(&ctx->TR, Graph_GetRelationMatrix(gc->g,
-						ctx->reltypes[0], true));
-			ASSERT(res == GrB_SUCCESS);
-		} else {
-			// we have multiple edge types, combine them into a boolean matrix
-			ctx->free_matrices = true;
-			GrB_Index dims = Graph_RequiredMatrixDim(gc->g);
-			res = GrB_Matrix_new(&ctx->R, GrB_BOOL, dims, dims);
-			ASSERT(res == GrB_SUCCESS);
-
-			for(uint i = 0; i < ctx->reltype_count; i ++) {
-				GrB_Matrix adj;
-				res = RG_Matrix_export(&adj, Graph_GetRelationMatrix(gc->g,
-							ctx->reltypes[i], false));
-				ASSERT(res == GrB_SUCCESS);
-				res = GrB_eWiseAdd(ctx->R, GrB_NULL, GrB_NULL,
-						GxB_ANY_PAIR_BOOL, ctx->R, adj, GrB_NULL);
-				ASSERT(res == GrB_SUCCESS);
-				res = GrB_Matrix_free(&adj);
-				ASSERT(res == GrB_SUCCESS);
-			}
+		ctx->R = array_new(RG_Matrix, 1);
+		ctx->TR = array_new(RG_Matrix, 1);
+	}
 
-			GrB_Index nrows;
-			res = GrB_Matrix_nrows(&nrows, ctx->R);
-			ASSERT(res == GrB_SUCCESS);
-			res = GrB_Matrix_new(&ctx->TR, GrB_BOOL, nrows, nrows);
-			ASSERT(res == GrB_SUCCESS);
-			res = GrB_transpose(ctx->TR, NULL, NULL, ctx->R, GrB_DESC_R);
-			ASSERT(res == GrB_SUCCESS);
+	// Get edge matrices and their transposes, these are retrieved
+	// on every invocation as the graph may have been modified in between
+	array_clear(ctx->R);
+	array_clear(ctx->TR);
+	if(ctx->reltypes == NULL) {
+		// No edge types were specified, use the overall adjacency matrix.
+		array_append(ctx->R, Graph_GetAdjacencyMatrix(gc->g, false));
+		array_append(ctx->TR, Graph_GetAdjacencyMatrix(gc->g, true));
+	} else {
+		// Traverse each specified edge type,
+		// if none of them exist there's nothing to traverse
+		for(uint i = 0; i < ctx->reltype_count; i ++) {
+			array_append(ctx->R, Graph_GetRelationMatrix(gc->g,
+						ctx->reltypes[i], false));
+			array_append(ctx->TR, Graph_GetRelationMatrix(gc->g,
+						ctx->reltypes[i], true));
 		}
 	}
+}
 
-	// Invoke the BFS algorithm
-	res = LAGraph_bfs_pushpull(&V, &PI, ctx->R, ctx->TR, src_id,
-							   &dest_id, max_level, true);
-	ASSERT(res == GrB_SUCCESS);
-
-	SIValue p = SI_NullVal();
+// flattens the matrices traversed by 'ctx' into a single matrix
+// the caller is responsible for freeing it
+static GrB_Matrix _ShortestPath_Matrix
+(
+	ShortestPathCtx *ctx,
+	GraphContext *gc
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	_ShortestPath_CollectMatrices(ctx, gc);
+
+	GrB_Matrix A;
+	uint n = array_len(ctx->R);
+	if(n == 0) {
+		// nothing to traverse
+		GrB_Index dim = Graph_RequiredMatrixDim(gc->g);
+		info = GrB_Matrix_new(&A, GrB_BOOL, dim, dim);
+		ASSERT(info == GrB_SUCCESS);
+		return A;
+	}
 
-	// The length of the path is equal to the level of the destination node
-	GrB_Index path_len;
-	res = GrB_Vector_extractElement(&path_len, V, dest_id);
-	if(res == GrB_NO_VALUE) goto cleanup; // no path found
+	info = RG_Matrix_export(&A, ctx->R[0]);
+	ASSERT(info == GrB_SUCCESS);
+
+	// connect any two nodes connected by either type
+	for(uint i = 1; i < n; i++) {
+		GrB_Matrix B;
+		info = RG_Matrix_export(&B, ctx->R[i]);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_eWiseAdd_BinaryOp(A, NULL, NULL, GxB_PAIR_UINT64,
+				A, B, NULL);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_Matrix_free(&B);
+	}
 
-	path_len -= 1; // Convert node count to edge count
+	return A;
+}
 
-	// Only emit a path with no edges if minHops is 0
-	if(path_len == 0 && ctx->minHops != 0) goto cleanup;
+// builds a path starting at 'srcNode' through the node IDs 'nodes'
+// consecutive nodes are connected by the first edge found between them
+static SIValue _ShortestPath_Build
+(
+	ShortestPathCtx *ctx,
+	GraphContext *gc,
+	Node *srcNode,
+	NodeID *nodes
+) {
+	uint path_len = array_len(nodes) - 1; // Convert node count to edge count
 
-	/* Build path in reverse, starting by appending the destination node.
-	 * The path is built in reverse because we have the destination's parent
-	 * in the PI array, and can use this to backtrack until we reach the source. */
-	p = SIPathBuilder_New(path_len);
-	SIPathBuilder_AppendNode(p, SI_Node(destNode));
+	SIValue p = SIPathBuilder_New(path_len);
+	SIPathBuilder_AppendNode(p, SI_Node(srcNode));
 
-	edges = array_new(Edge, 1);
+	Edge *edges = array_new(Edge, 1);
 
-	NodeID id = destNode->id;
 	for(uint i = 0; i < path_len; i ++) {
 		array_clear(edges);
-		GrB_Index parent_id;
-		// Find the parent of the reached node.
-		GrB_Info res = GrB_Vector_extractElement(&parent_id, PI, id);
-		ASSERT(res == GrB_SUCCESS);
-		parent_id --; // Decrement the parent ID by 1 to correct 1-indexing.
+		NodeID src = nodes[i];
+		NodeID dest = nodes[i + 1];
 
-		// Retrieve edges connecting the parent node to the current node.
+		// Retrieve edges connecting the current node to the next one.
 		if(ctx->reltype_count == 0) {
-			Graph_GetEdgesConnectingNodes(gc->g, parent_id, id, GRAPH_NO_RELATION, &edges);
+			Graph_GetEdgesConnectingNodes(gc->g, src, dest, GRAPH_NO_RELATION, &edges);
 		} else {
 			for(uint j = 0; j < ctx->reltype_count; j ++) {
-				Graph_GetEdgesConnectingNodes(gc->g, parent_id, id, ctx->reltypes[j], &edges);
+				Graph_GetEdgesConnectingNodes(gc->g, src, dest, ctx->reltypes[j], &edges);
 				if(array_len(edges) > 0) break;
 			}
 		}
@@ -239,23 +216,107 @@ SIValue AR_SHORTEST_PATH(SIValue *argv, int argc) {
 		SIPathBuilder_AppendEdge(p, SI_Edge(&edges[0]), false);
 
 		// Append the reached node to the path.
-		id = edges[0].srcNodeID;
 		Node n = GE_NEW_NODE();
-		Graph_GetNode(gc->g, id, &n);
+		Graph_GetNode(gc->g, dest, &n);
 		SIPathBuilder_AppendNode(p, SI_Node(&n));
 	}
 
-	// Reverse the path so it starts at the source
-	Path_Reverse(p.ptrval);
+	array_free(edges);
+
+	return p;
+}
+
+SIValue AR_SHORTEST_PATH(SIValue *argv, int argc) {
+	if(SI_TYPE(argv[0]) == T_NULL) return SI_NullVal();
+	if(SI_TYPE(argv[1]) == T_NULL) return SI_NullVal();
+	ASSERT(SI_TYPE(argv[2]) != T_NULL);
+
+	Node             *srcNode   =  argv[0].ptrval;
+	Node             *destNode  =  argv[1].ptrval;
+	ShortestPathCtx  *ctx       =  argv[2].ptrval;
+	NodeID           src_id     =  ENTITY_GET_ID(srcNode);
+	NodeID           dest_id    =  ENTITY_GET_ID(destNode);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	_ShortestPath_CollectMatrices(ctx, gc);
+
+	// Meet in the middle, expanding from both the source and the destination
+	NodeID *nodes = BidirectionalBFS(ctx->R, ctx->TR, array_len(ctx->R),
+			src_id, dest_id, ctx->maxHops);
+
+	SIValue p = SI_NullVal();
+	if(nodes == NULL) return p; // no path found
+
+	// Only emit a path with no edges if minHops is 0
+	if(array_len(nodes) > 1 || ctx->minHops == 0) {
+		p = _ShortestPath_Build(ctx, gc, srcNode, nodes);
+	}
 
-cleanup:
-	if(V) GrB_free(&V);
-	if(PI) GrB_free(&PI);
-	if(edges) array_free(edges);
+	array_free(nodes);
 
 	return p;
 }
 
+// returns a list of all shortest paths from argv[0] to argv[1]
+SIValue AR_ALL_SHORTEST_PATHS(SIValue *argv, int argc) {
+	if(SI_TYPE(argv[0]) == T_NULL) return SI_NullVal();
+	if(SI_TYPE(argv[1]) == T_NULL) return SI_NullVal();
+	ASSERT(SI_TYPE(argv[2]) != T_NULL);
+
+	Node             *srcNode   =  argv[0].ptrval;
+	Node             *destNode  =  argv[1].ptrval;
+	ShortestPathCtx  *ctx       =  argv[2].ptrval;
+	NodeID           src_id     =  ENTITY_GET_ID(srcNode);
+	NodeID           dest_id    =  ENTITY_GET_ID(destNode);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GrB_Matrix A = _ShortestPath_Matrix(ctx, gc);
+	NodeID **paths = AllShortestPaths(A, src_id, dest_id, ctx->maxHops);
+	GrB_Matrix_free(&A);
+
+	uint path_count = array_len(paths);
+	SIValue list = SIArray_New(path_count);
+
+	for(uint i = 0; i < path_count; i++) {
+		NodeID *nodes = paths[i];
+		// Only emit a path with no edges if minHops is 0
+		if(array_len(nodes) > 1 || ctx->minHops == 0) {
+			SIValue p = _ShortestPath_Build(ctx, gc, srcNode, nodes);
+			SIArray_Append(&list, p);
+			SIValue_Free(p);
+		}
+		array_free(nodes);
+	}
+
+	if(paths) array_free(paths);
+
+	return list;
+}
+
+// returns the number of shortest paths from argv[0] to argv[1]
+// without enumerating them, size(allShortestPaths(...)) is reduced to it
+SIValue AR_ALL_SHORTEST_PATHS_COUNT(SIValue *argv, int argc) {
+	if(SI_TYPE(argv[0]) == T_NULL) return SI_NullVal();
+	if(SI_TYPE(argv[1]) == T_NULL) return SI_NullVal();
+	ASSERT(SI_TYPE(argv[2]) != T_NULL);
+
+	Node             *srcNode   =  argv[0].ptrval;
+	Node             *destNode  =  argv[1].ptrval;
+	ShortestPathCtx  *ctx       =  argv[2].ptrval;
+	NodeID           src_id     =  ENTITY_GET_ID(srcNode);
+	NodeID           dest_id    =  ENTITY_GET_ID(destNode);
+
+	// the only path with no edges is emitted if minHops is 0
+	if(src_id == dest_id) return SI_LongVal(ctx->minHops == 0);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GrB_Matrix A = _ShortestPath_Matrix(ctx, gc);
+	uint64_t count = AllShortestPaths_Count(A, src_id, dest_id, ctx->maxHops);
+	GrB_Matrix_free(&A);
+
+	return SI_LongVal(count);
+}
+
 SIValue AR_PATH_NODES(SIValue *argv, int argc) {
 	if(SI_TYPE(argv[0]) == T_NULL) return SI_NullVal();
 	return SIPath_Nodes(argv[0]);
@@ -289,6 +350,22 @@ void Register_PathFuncs() {
 	AR_SetPrivateDataRoutines(func_desc, ShortestPath_Free, ShortestPath_Clone);
 	AR_RegFunc(func_desc);
 
+	types = array_new(SIType, 3);
+	array_append(types, T_NULL | T_NODE);
+	array_append(types, T_NULL | T_NODE);
+	array_append(types, T_PTR); // pointer to ShortestPathCtx struct
+	func_desc = AR_FuncDescNew("allshortestpaths", AR_ALL_SHORTEST_PATHS, 3, 3, types, false, false);
+	AR_SetPrivateDataRoutines(func_desc, ShortestPath_Free, ShortestPath_Clone);
+	AR_RegFunc(func_desc);
+
+	types = array_new(SIType, 3);
+	array_append(types, T_NULL | T_NODE);
+	array_append(types, T_NULL | T_NODE);
+	array_append(types, T_PTR); // pointer to ShortestPathCtx struct
+	func_desc = AR_FuncDescNew("allshortestpathscount", AR_ALL_SHORTEST_PATHS_COUNT, 3, 3, types, false, false);
+	AR_SetPrivateDataRoutines(func_desc, ShortestPath_Free, ShortestPath_Clone);
+	AR_RegFunc(func_desc);
+
 	types = array_new(SIType, 1);
 	array_append(types, T_NULL | T_PATH);
 	func_desc = AR_FuncDescNew("nodes", AR_PATH_NODES, 1, 1, types, false, false);
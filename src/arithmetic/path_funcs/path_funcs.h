@@ -6,7 +6,7 @@
 
 #pragma once
 #include "../../value.h"
-#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+#include "../../graph/rg_matrix/rg_matrix.h"
 
 // Context struct containing traversal data for shortestPath function calls
 typedef struct {
@@ -15,9 +15,8 @@ typedef struct {
 	const char **reltype_names;  /* Relationship type names */
 	int *reltypes;               /* Relationship type IDs */
 	uint reltype_count;          /* Number of traversed relationship types */
-	GrB_Matrix R;                /* Traversed relationship matrix */
-	GrB_Matrix TR;               /* Transpose of traversed relationship matrix */
-	bool free_matrices;          /* If true, R and TR will ultimately be freed */
+	RG_Matrix *R;                /* Traversed relationship matrices */
+	RG_Matrix *TR;               /* Transposes of traversed relationship matrices */
 } ShortestPathCtx;
 
 void Register_PathFuncs();
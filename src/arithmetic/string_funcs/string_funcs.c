@@ -7,6 +7,7 @@
 #include "string_funcs.h"
 #include "../func_desc.h"
 #include "../../errors.h"
+#include "../../query_ctx.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
 #include "../../util/uuid.h"
@@ -242,6 +243,111 @@ SIValue AR_ENDSWITH(SIValue *argv, int argc) {
 	return SI_BoolVal(true);
 }
 
+//------------------------------------------------------------------------------
+// regex context
+//------------------------------------------------------------------------------
+
+// case-insensitive matching flag, the only inline flag supported
+#define REGEX_ICASE_FLAG "(?i)"
+
+void *StringRegexCtx_New(void) {
+	return rm_calloc(1, sizeof(StringRegexCtx));
+}
+
+void *StringRegexCtx_Clone
+(
+	void *orig
+) {
+	UNUSED(orig);
+	// the clone compiles its own pattern on first evaluation
+	return StringRegexCtx_New();
+}
+
+void StringRegexCtx_Free
+(
+	void *ctx_ptr
+) {
+	StringRegexCtx *ctx = ctx_ptr;
+	if(ctx->pattern) {
+		regfree(&ctx->regex);
+		rm_free(ctx->pattern);
+	}
+	rm_free(ctx);
+}
+
+// compiles 'pattern' into 'ctx', replacing any previously compiled pattern
+// the pattern must match the entire string
+static void _StringRegexCtx_Compile
+(
+	StringRegexCtx *ctx,
+	const char *pattern
+) {
+	if(ctx->pattern) {
+		regfree(&ctx->regex);
+		rm_free(ctx->pattern);
+		ctx->pattern = NULL;
+	}
+
+	int flags = REG_EXTENDED | REG_NOSUB;
+	const char *p = pattern;
+	size_t flag_len = strlen(REGEX_ICASE_FLAG);
+	if(strncmp(p, REGEX_ICASE_FLAG, flag_len) == 0) {
+		flags |= REG_ICASE;
+		p += flag_len;
+	}
+
+	char *anchored;
+	asprintf(&anchored, "^(%s)$", p);
+	int rc = regcomp(&ctx->regex, anchored, flags);
+	free(anchored);
+
+	if(rc != 0) {
+		ErrorCtx_RaiseRuntimeException("Invalid regular expression '%s'",
+				pattern);
+		return;
+	}
+
+	ctx->pattern = rm_strdup(pattern);
+}
+
+char *StringRegex_LiteralPrefix
+(
+	const char *pattern
+) {
+	// alternations may start with different literals
+	// the index is case-sensitive
+	if(strchr(pattern, '|') != NULL) return NULL;
+	if(strncmp(pattern, REGEX_ICASE_FLAG, strlen(REGEX_ICASE_FLAG)) == 0) {
+		return NULL;
+	}
+
+	size_t len = strcspn(pattern, ".[]()*+?{}^$\\");
+
+	// a quantifier which allows zero occurrences applies to the last literal
+	char next = pattern[len];
+	if(len > 0 && (next == '*' || next == '?' || next == '{')) len--;
+
+	if(len == 0) return NULL;
+	return rm_strndup(pattern, len);
+}
+
+// returns true if argv[0] matches the regular expression argv[1]
+SIValue AR_REGEX(SIValue *argv, int argc) {
+	ASSERT(argc == 3);
+	if(SIValue_IsNull(argv[0]) || SIValue_IsNull(argv[1])) return SI_NullVal();
+
+	const char *str = argv[0].stringval;
+	const char *pattern = argv[1].stringval;
+	StringRegexCtx *ctx = argv[2].ptrval;
+
+	// recompile only when the pattern changes
+	if(ctx->pattern == NULL || strcmp(ctx->pattern, pattern) != 0) {
+		_StringRegexCtx_Compile(ctx, pattern);
+	}
+
+	return SI_BoolVal(regexec(&ctx->regex, str, 0, NULL, 0) == 0);
+}
+
 // returns a string in which all occurrences of a specified string in the original string have been replaced by ANOTHER (specified) string.
 // for example: RETURN replace('Well I wish I was in the land of cotton', 'cotton', 'the free')
 // the result is Well I wish I was in the land of the free
@@ -417,8 +523,18 @@ void Register_StringFuncs() {
 	func_desc = AR_FuncDescNew("ends with", AR_ENDSWITH, 2, 2, types, true, false);
 	AR_RegFunc(func_desc);
 
+	types = array_new(SIType, 3);
+	array_append(types, (T_STRING | T_NULL));
+	array_append(types, (T_STRING | T_NULL));
+	array_append(types, T_PTR);  // compiled pattern cache
+	func_desc = AR_FuncDescNew("=~", AR_REGEX, 3, 3, types, true, false);
+	AR_SetPrivateDataRoutines(func_desc, StringRegexCtx_Free,
+			StringRegexCtx_Clone);
+	AR_RegFunc(func_desc);
+
 	types = array_new(SIType, 0);
 	func_desc = AR_FuncDescNew("randomuuid", AR_RANDOMUUID, 0, 0, types, false, false);
+	AR_SetNonDeterministic(func_desc);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 3);
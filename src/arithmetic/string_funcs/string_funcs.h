@@ -6,8 +6,38 @@
 
 #pragma once
 
+#include <regex.h>
 #include "../../value.h"
 
+// regex operator context object
+// caches the pattern last compiled by a =~ operation
+typedef struct {
+	char *pattern;  // pattern 'regex' was compiled from
+	regex_t regex;  // compiled pattern
+} StringRegexCtx;
+
+// creates an empty regex context, patterns are compiled on evaluation
+void *StringRegexCtx_New(void);
+
+// routine for cloning a regex operation private data
+void *StringRegexCtx_Clone
+(
+	void *orig
+);
+
+// routine for freeing a regex operation private data
+void StringRegexCtx_Free
+(
+	void *ctx_ptr
+);
+
+// returns the literal prefix every string matching 'pattern' starts with
+// NULL if there's none, the caller is responsible for freeing the prefix
+char *StringRegex_LiteralPrefix
+(
+	const char *pattern
+);
+
 void Register_StringFuncs();
 
 /* returns a list of strings resulting from the splitting of the original string around matches of the given delimiter. */
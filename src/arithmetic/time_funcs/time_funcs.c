@@ -6,12 +6,13 @@
 
 #include "time_funcs.h"
 #include "../func_desc.h"
+#include "../../query_ctx.h"
 #include "../../util/arr.h"
-#include "../../datatypes/temporal_value.h"
 
-/* returns a timestamp - millis from epoch */
+/* returns a timestamp - millis from epoch
+ * the query's start time is returned throughout the query */
 SIValue AR_TIMESTAMP(SIValue *argv, int argc) {
-	return SI_LongVal(TemporalValue_NewTimestamp());
+	return SI_LongVal(QueryCtx_GetTimestamp());
 }
 
 void Register_TimeFuncs() {
@@ -20,6 +21,8 @@ void Register_TimeFuncs() {
 
 	types = array_new(SIType, 0);
 	func_desc = AR_FuncDescNew("timestamp", AR_TIMESTAMP, 0, 0, types, false, false);
+	AR_SetNonDeterministic(func_desc);
+	AR_SetQueryConstant(func_desc);
 	AR_RegFunc(func_desc);
 }
 
@@ -109,13 +109,15 @@ bool AST_ReadOnly(const cypher_astnode_t *root) {
 	if(root == NULL) return true;
 
 	cypher_astnode_type_t type = cypher_astnode_type(root);
-	if(type == CYPHER_AST_CREATE                     ||
-	   type == CYPHER_AST_MERGE                      ||
-	   type == CYPHER_AST_DELETE                     ||
-	   type == CYPHER_AST_SET                        ||
-	   type == CYPHER_AST_CREATE_NODE_PROPS_INDEX    ||
-	   type == CYPHER_AST_CREATE_PATTERN_PROPS_INDEX ||
-	   type == CYPHER_AST_DROP_PROPS_INDEX) {
+	if(type == CYPHER_AST_CREATE                      ||
+	   type == CYPHER_AST_MERGE                       ||
+	   type == CYPHER_AST_DELETE                      ||
+	   type == CYPHER_AST_SET                         ||
+	   type == CYPHER_AST_CREATE_NODE_PROPS_INDEX     ||
+	   type == CYPHER_AST_CREATE_PATTERN_PROPS_INDEX  ||
+	   type == CYPHER_AST_DROP_PROPS_INDEX            ||
+	   type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT ||
+	   type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
 		return false;
 	}
 
@@ -140,6 +142,29 @@ bool AST_ReadOnly(const cypher_astnode_t *root) {
 	return true;
 }
 
+bool AST_Deterministic(const cypher_astnode_t *root) {
+	if(root == NULL) return true;
+
+	cypher_astnode_type_t type = cypher_astnode_type(root);
+	if(type == CYPHER_AST_APPLY_OPERATOR ||
+	   type == CYPHER_AST_APPLY_ALL_OPERATOR) {
+		const cypher_astnode_t *func = (type == CYPHER_AST_APPLY_OPERATOR) ?
+									   cypher_ast_apply_operator_get_func_name(root) :
+									   cypher_ast_apply_all_operator_get_func_name(root);
+		const char *func_name = cypher_ast_function_name_get_value(func);
+		if(!AR_FuncIsDeterministic(func_name)) return false;
+	}
+
+	// function arguments might call non-deterministic functions as well
+	uint num_children = cypher_astnode_nchildren(root);
+	for(uint i = 0; i < num_children; i ++) {
+		const cypher_astnode_t *child = cypher_astnode_get_child(root, i);
+		if(!AST_Deterministic(child)) return false;
+	}
+
+	return true;
+}
+
 inline bool AST_ContainsClause(const AST *ast, cypher_astnode_type_t clause) {
 	return AST_GetClause(ast, clause, NULL) != NULL;
 }
@@ -571,9 +596,9 @@ void AST_Free(AST *ast) {
 }
 
 cypher_parse_result_t *parse_query(const char *query) {
-	FILE *f = fmemopen((char *)query, strlen(query), "r");
-	cypher_parse_result_t *result = cypher_fparse(f, NULL, NULL, CYPHER_PARSE_ONLY_STATEMENTS);
-	fclose(f);
+	// parse directly out of the query string, avoiding a stream wrapper
+	cypher_parse_result_t *result = cypher_uparse(query, strlen(query), NULL,
+			NULL, CYPHER_PARSE_ONLY_STATEMENTS);
 	if(!result) return NULL;
 	if(AST_Validate_Query(result) != AST_VALID) {
 		parse_result_free(result);
@@ -584,9 +609,8 @@ cypher_parse_result_t *parse_query(const char *query) {
 
 
 cypher_parse_result_t *parse_params(const char *query, const char **query_body) {
-	FILE *f = fmemopen((char *)query, strlen(query), "r");
-	cypher_parse_result_t *result = cypher_fparse(f, NULL, NULL, CYPHER_PARSE_ONLY_PARAMETERS);
-	fclose(f);
+	cypher_parse_result_t *result = cypher_uparse(query, strlen(query), NULL,
+			NULL, CYPHER_PARSE_ONLY_PARAMETERS);
 	if(!result) return NULL;
 	if(AST_Validate_QueryParams(result) != AST_VALID) {
 		parse_result_free(result);
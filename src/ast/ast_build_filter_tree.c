@@ -132,6 +132,15 @@ static FT_FilterNode *_convertOperator(const cypher_astnode_t *expr) {
 static FT_FilterNode *_convertComparison(const cypher_astnode_t *comparison_node) {
 	// "x < y <= z"
 	uint nelems = cypher_ast_comparison_get_length(comparison_node);
+
+	// regex matches are evaluated as expressions
+	for(uint i = 0; i < nelems; i++) {
+		const cypher_operator_t *operator = cypher_ast_comparison_get_operator(comparison_node, i);
+		if(AST_ConvertOperatorNode(operator) == OP_REGEX) {
+			return _convertOperator(comparison_node);
+		}
+	}
+
 	FT_FilterNode **filters = array_new(FT_FilterNode *, nelems);
 
 	// Create and accumulate simple predicates x < y.
@@ -0,0 +1,90 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "ast_hints.h"
+#include "../util/arr.h"
+#include <string.h>
+
+void AST_CollectMatchHints
+(
+	const cypher_astnode_t *match,
+	PlanHint **hints
+) {
+	ASSERT(match != NULL);
+	ASSERT(hints != NULL && *hints != NULL);
+
+	uint hint_count = cypher_ast_match_nhints(match);
+	for(uint i = 0; i < hint_count; i++) {
+		const cypher_astnode_t *node = cypher_ast_match_get_hint(match, i);
+		cypher_astnode_type_t type = cypher_astnode_type(node);
+
+		PlanHint hint = {0};
+		if(type == CYPHER_AST_USING_INDEX) {
+			hint.type = HINT_INDEX;
+			hint.alias = cypher_ast_identifier_get_name(
+					cypher_ast_using_index_get_identifier(node));
+			hint.label = cypher_ast_label_get_name(
+					cypher_ast_using_index_get_label(node));
+			hint.attribute = cypher_ast_prop_name_get_value(
+					cypher_ast_using_index_get_prop_name(node));
+			array_append(*hints, hint);
+		} else if(type == CYPHER_AST_USING_SCAN) {
+			hint.type = HINT_SCAN;
+			hint.alias = cypher_ast_identifier_get_name(
+					cypher_ast_using_scan_get_identifier(node));
+			hint.label = cypher_ast_label_get_name(
+					cypher_ast_using_scan_get_label(node));
+			array_append(*hints, hint);
+		} else if(type == CYPHER_AST_USING_JOIN) {
+			hint.type = HINT_JOIN;
+			uint n = cypher_ast_using_join_nidentifiers(node);
+			for(uint j = 0; j < n; j++) {
+				hint.alias = cypher_ast_identifier_get_name(
+						cypher_ast_using_join_get_identifier(node, j));
+				array_append(*hints, hint);
+			}
+		}
+	}
+}
+
+bool AST_GetHint
+(
+	const AST *ast,
+	PlanHintType t,
+	const char *alias,
+	PlanHint *hint
+) {
+	ASSERT(alias != NULL);
+
+	if(ast == NULL) return false;
+
+	const cypher_astnode_t **match_clauses = AST_GetClauses(ast,
+			CYPHER_AST_MATCH);
+	if(match_clauses == NULL) return false;
+
+	bool found = false;
+	PlanHint *hints = array_new(PlanHint, 0);
+	uint match_count = array_len(match_clauses);
+	for(uint i = 0; i < match_count && !found; i++) {
+		array_clear(hints);
+		AST_CollectMatchHints(match_clauses[i], &hints);
+
+		uint hint_count = array_len(hints);
+		for(uint j = 0; j < hint_count; j++) {
+			if(hints[j].type != t || strcmp(hints[j].alias, alias) != 0) {
+				continue;
+			}
+			if(hint != NULL) *hint = hints[j];
+			found = true;
+			break;
+		}
+	}
+
+	array_free(hints);
+	array_free(match_clauses);
+	return found;
+}
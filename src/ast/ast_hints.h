@@ -0,0 +1,43 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "ast.h"
+
+// planner hint types
+typedef enum {
+	HINT_INDEX,  // USING INDEX n:L(p), resolve 'n' via L's index on 'p'
+	HINT_SCAN,   // USING SCAN n:L, resolve 'n' by scanning label L
+	HINT_JOIN,   // USING JOIN ON n, join on the stream resolving 'n'
+} PlanHintType;
+
+// planner hint attached to a MATCH clause
+// strings are owned by the AST
+typedef struct {
+	PlanHintType type;      // hint type
+	const char *alias;      // hinted entity
+	const char *label;      // hinted label, NULL for JOIN hints
+	const char *attribute;  // hinted attribute, INDEX hints only
+} PlanHint;
+
+// appends the hints of MATCH clause 'match' to 'hints'
+// a JOIN hint over multiple entities contributes a hint per entity
+void AST_CollectMatchHints
+(
+	const cypher_astnode_t *match,  // MATCH clause
+	PlanHint **hints                // [in/out] array of hints
+);
+
+// searches the MATCH clauses of 'ast' for a hint of type 't' on 'alias'
+// returns true and sets 'hint' if one is found
+bool AST_GetHint
+(
+	const AST *ast,     // AST to search
+	PlanHintType t,     // hint type
+	const char *alias,  // hinted entity
+	PlanHint *hint      // [output] located hint, may be NULL
+);
@@ -0,0 +1,224 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "ast_parameterize.h"
+#include "RG.h"
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+// clauses within which literals are lifted
+static const char *_lift_clauses[] = {"MATCH", "WHERE"};
+
+// clauses within which literals are left as is
+static const char *_keep_clauses[] = {"RETURN", "WITH", "UNWIND", "ORDER",
+	"SKIP", "LIMIT", "CALL", "YIELD", "CREATE", "MERGE", "SET", "DELETE",
+	"DETACH", "REMOVE", "ON", "FOREACH", "UNION"};
+
+#define KEYWORDS_COUNT(arr) (sizeof(arr) / sizeof(arr[0]))
+
+static inline bool _WordIs(const char *word, size_t len, const char *keyword) {
+	return (strlen(keyword) == len && strncasecmp(word, keyword, len) == 0);
+}
+
+static bool _WordIn(const char *word, size_t len, const char **keywords,
+		uint n) {
+	for(uint i = 0; i < n; i++) {
+		if(_WordIs(word, len, keywords[i])) return true;
+	}
+	return false;
+}
+
+// locate the parameters header, which precedes the query body
+// returns the header length or -1 if body isn't part of the query
+static int _HeaderLength(const char *query, const char *body) {
+	size_t query_len = strlen(query);
+	size_t body_len  = strlen(body);
+	if(body_len > query_len) return -1;
+
+	// scan backwards, the body is the query's tail
+	for(int i = query_len - body_len; i >= 0; i--) {
+		if(strncmp(query + i, body, body_len) == 0) return i;
+	}
+
+	return -1;
+}
+
+sds AST_AutoParameterize(const char *query, const char *body) {
+	ASSERT(body  != NULL);
+	ASSERT(query != NULL);
+
+	// avoid clashing with user provided parameters
+	if(strstr(query, AUTO_PARAM_PREFIX) != NULL) return NULL;
+
+	int header_len = _HeaderLength(query, body);
+	if(header_len < 0) return NULL;
+
+	sds params = sdsempty();          // lifted literals
+	sds out    = sdsempty();          // rewritten query body
+
+	uint lifted         = 0;          // number of lifted literals
+	bool active         = false;      // within a clause which lifts literals
+	bool liftable       = false;      // previous token is a comparison
+	int  map_depth      = 0;          // nesting level of maps
+	int  list_depth     = 0;          // nesting level of lists and patterns
+	char prev           = '\0';       // last char of previous token
+	const char *word    = NULL;       // previous word
+	size_t word_len     = 0;          // length of previous word
+	const char *c       = body;
+
+	while(*c != '\0') {
+		const char *start = c;
+
+		if(isspace((unsigned char)*c)) {
+			out = sdscatlen(out, c++, 1);
+			continue;
+		}
+
+		// comments are rare, don't bother skipping over them
+		if(*c == '/' && (c[1] == '/' || c[1] == '*')) goto bail;
+
+		if(*c == '\'' || *c == '"' || isdigit((unsigned char)*c)) {
+			//------------------------------------------------------------------
+			// literal
+			//------------------------------------------------------------------
+
+			bool range = false;
+			if(isdigit((unsigned char)*c)) {
+				bool hex = (c[0] == '0' && (c[1] == 'x' || c[1] == 'X'));
+				while(isalnum((unsigned char)*c) || *c == '_' || *c == '.' ||
+					  (!hex && (*c == '+' || *c == '-') &&
+					   (c[-1] == 'e' || c[-1] == 'E'))) {
+					// variable length edge, e.g. [*1..3]
+					if(*c == '.' && c[1] == '.') range = true;
+					c++;
+				}
+			} else {
+				char quote = *c++;
+				while(*c != '\0' && *c != quote) {
+					if(*c == '\\' && c[1] != '\0') c++;
+					c++;
+				}
+				// unterminated string, let the parser report it
+				if(*c == '\0') goto bail;
+				c++;
+			}
+
+			if(active && liftable && !range) {
+				params = sdscatprintf(params, " " AUTO_PARAM_PREFIX "%u=", lifted);
+				params = sdscatlen(params, start, c - start);
+				out = sdscatprintf(out, "$" AUTO_PARAM_PREFIX "%u", lifted);
+				lifted++;
+			} else {
+				out = sdscatlen(out, start, c - start);
+			}
+			liftable = false;
+		} else if(isalpha((unsigned char)*c) || *c == '_' || *c == '$') {
+			//------------------------------------------------------------------
+			// identifier, keyword or parameter
+			//------------------------------------------------------------------
+
+			bool param = (*c == '$');
+			if(param) c++;
+			while(isalnum((unsigned char)*c) || *c == '_') c++;
+			size_t len = c - start;
+			out = sdscatlen(out, start, len);
+
+			// ID(n) = 1 is resolved while the plan is constructed,
+			// lifting its operand would bake the first value into the plan
+			const char *next = c;
+			while(isspace((unsigned char)*next)) next++;
+			if(*next == '(' && _WordIs(start, len, "id")) goto bail;
+
+			// STARTS WITH and ENDS WITH are operators rather than a clause
+			bool op = (word != NULL && _WordIs(start, len, "WITH") &&
+					   (_WordIs(word, word_len, "STARTS") ||
+						_WordIs(word, word_len, "ENDS")));
+			op |= _WordIs(start, len, "CONTAINS");
+			liftable = op;
+
+			// property keys, labels and map keys are not keywords
+			bool keyword = (!param && !op && prev != '.' && prev != ':' &&
+							map_depth == 0 && list_depth == 0);
+			if(keyword) {
+				if(_WordIn(start, len, _lift_clauses,
+							KEYWORDS_COUNT(_lift_clauses))) {
+					active = true;
+				} else if(_WordIn(start, len, _keep_clauses,
+							KEYWORDS_COUNT(_keep_clauses))) {
+					active = false;
+				}
+			}
+
+			word     = start;
+			word_len = len;
+		} else if(*c == '`') {
+			//------------------------------------------------------------------
+			// escaped identifier
+			//------------------------------------------------------------------
+
+			c = strchr(c + 1, '`');
+			if(c == NULL) goto bail;
+			c++;
+			out = sdscatlen(out, start, c - start);
+			liftable = false;
+		} else if(*c == '<' || *c == '>' || *c == '=' || *c == '~') {
+			//------------------------------------------------------------------
+			// comparison
+			//------------------------------------------------------------------
+
+			while(*c == '<' || *c == '>' || *c == '=' || *c == '~') c++;
+			out = sdscatlen(out, start, c - start);
+			liftable = true;
+		} else {
+			//------------------------------------------------------------------
+			// punctuation
+			//------------------------------------------------------------------
+
+			switch(*c) {
+				case '{':
+					map_depth++;
+					break;
+				case '}':
+					map_depth--;
+					break;
+				case '[':
+					list_depth++;
+					break;
+				case ']':
+					list_depth--;
+					break;
+				default:
+					break;
+			}
+			// map value, e.g. (n {v: 1})
+			liftable = (*c == ':' && map_depth > 0);
+			out = sdscatlen(out, c++, 1);
+		}
+
+		prev = c[-1];
+	}
+
+	if(lifted == 0) goto bail;
+
+	// compose rewritten query, extending the original parameters header
+	sds rewritten = (header_len == 0) ?
+		sdsnew("CYPHER") :
+		sdsnewlen(query, header_len);
+	rewritten = sdscatsds(rewritten, params);
+	rewritten = sdscat(rewritten, " ");
+	rewritten = sdscatsds(rewritten, out);
+
+	sdsfree(params);
+	sdsfree(out);
+	return rewritten;
+
+bail:
+	sdsfree(params);
+	sdsfree(out);
+	return NULL;
+}
+
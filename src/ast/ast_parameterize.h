@@ -0,0 +1,32 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../util/sds/sds.h"
+
+// prefix of hidden parameters introduced by auto-parameterization
+#define AUTO_PARAM_PREFIX "__ap"
+
+// lift literals compared against within MATCH and WHERE clauses
+// into hidden parameters, such that queries which differ only by their
+// literals share the same query body, e.g.
+//
+// MATCH (n {v: 1}) WHERE n.x > 'a' RETURN n
+//
+// is rewritten as
+//
+// CYPHER __ap0=1 __ap1='a' MATCH (n {v: $__ap0}) WHERE n.x > $__ap1 RETURN n
+//
+// literals within projections (RETURN, WITH), SKIP and LIMIT
+// and write clauses are left as is
+// returns NULL if no literal was lifted, otherwise the rewritten query
+// which is owned by the caller
+sds AST_AutoParameterize
+(
+	const char *query,  // complete query, including parameters header
+	const char *body    // query body, following the parameters header
+);
@@ -45,6 +45,8 @@ AST_Operator AST_ConvertOperatorNode(const cypher_operator_t *op) {
 		return OP_STARTSWITH;
 	} else if(op == CYPHER_OP_ENDS_WITH) {
 		return OP_ENDSWITH;
+	} else if(op == CYPHER_OP_REGEX) {
+		return OP_REGEX;
 	} else if(op == CYPHER_OP_IN) {
 		return OP_IN;
 	} else if(op == CYPHER_OP_IS_NULL) {
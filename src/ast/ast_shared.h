@@ -41,7 +41,8 @@ typedef enum {
 	OP_IN = 21,
 	OP_IS_NULL = 22,
 	OP_IS_NOT_NULL = 23,
-	OP_XNOR = 24
+	OP_XNOR = 24,
+	OP_REGEX = 25
 } AST_Operator;
 
 typedef struct {
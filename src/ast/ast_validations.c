@@ -7,6 +7,7 @@
 #include "ast.h"
 #include "../RG.h"
 #include "../errors.h"
+#include "ast_hints.h"
 #include "ast_shared.h"
 #include "../util/arr.h"
 #include "cypher_whitelist.h"
@@ -16,6 +17,7 @@
 
 // Forward declaration
 static void _AST_GetDefinedIdentifiers(const cypher_astnode_t *node, rax *identifiers);
+static void _AST_Pattern_GetDefinedIdentifiers(const cypher_astnode_t *pattern, rax *identifiers);
 
 inline static void _prepareIterateAll(rax *map, raxIterator *iter) {
 	raxStart(iter, map);
@@ -222,65 +224,41 @@ static rax *_AST_GetReturnProjections(const cypher_astnode_t *return_clause) {
 }
 
 /* Compares a triemap of user-specified functions with the registered functions we provide. */
-static AST_Validation _ValidateReferredFunctions(rax *referred_functions, bool include_aggregates) {
-	AST_Validation res = AST_VALID;
-	char funcName[32];
-	raxIterator it;
-	_prepareIterateAll(referred_functions, &it);
-	bool found = true;
-	while(raxNext(&it)) {
-		size_t len = it.key_len;
-		// No functions have a name longer than 32 characters
-		if(len >= 32) {
-			res = AST_INVALID;
-			break;
-		}
-
-		// Copy the triemap key so that we can safely add a terinator character
-		memcpy(funcName, it.key, len);
-		funcName[len] = 0;
-
-		if(!include_aggregates && AR_FuncIsAggregate(funcName)) {
-			// Provide a unique error for using aggregate functions from inappropriate contexts
-			ErrorCtx_SetError("Invalid use of aggregating function '%s'", funcName);
-			res = AST_INVALID;
-			break;
-		}
-
-		if(AR_FuncExists(funcName)) continue;
-
-		// If we reach this point, the function was not found
-		found = false;
-		res = AST_INVALID;
-		break;
-	}
-
-	// If the function was not found, provide a reason if one is not set
-	if(res == AST_INVALID && !found) {
-		ErrorCtx_SetError("Unknown function '%s'", funcName);
+// validate a single function call
+// the function must exist, aggregations are only allowed if
+// 'include_aggregates' is set and are never allowed within maps
+static AST_Validation _ValidateFunction(const char *func_name,
+		bool include_aggregates, bool in_map) {
+	const AR_FuncDesc *f = AR_FuncLookup(func_name);
+	if(f == NULL) {
+		ErrorCtx_SetError("Unknown function '%s'", func_name);
+		return AST_INVALID;
 	}
 
-	raxStop(&it);
-	return res;
-}
-
-// validate that a map doesn't contains a nested aggregation function
-// e.g. {key: count(v)}
-static AST_Validation _ValidateMapExp(const cypher_astnode_t *node) {
-	ASSERT(cypher_astnode_type(node) == CYPHER_AST_MAP);
+	if(!f->aggregate) return AST_VALID;
 
-	if(AST_ClauseContainsAggregation(node)) {
+	// validate that a map doesn't contain a nested aggregation function
+	// e.g. {key: count(v)}
+	if(in_map) {
 		ErrorCtx_SetError("RedisGraph does not allow aggregate function calls \
 to be nested within maps. Aggregate functions should instead be called in a \
 preceding WITH clause and have their aliased values referenced in the map.");
 		return AST_INVALID;
 	}
 
+	if(!include_aggregates) {
+		// Provide a unique error for using aggregate functions from inappropriate contexts
+		ErrorCtx_SetError("Invalid use of aggregating function '%s'", func_name);
+		return AST_INVALID;
+	}
+
 	return AST_VALID;
 }
 
-// Recursively collect function names and perform validations on functions with STAR arguments.
-static AST_Validation _VisitFunctions(const cypher_astnode_t *node, rax *func_names) {
+// Recursively validate function calls, each call is validated as it is
+// visited, such that the sub-tree is walked exactly once.
+static AST_Validation _VisitFunctions(const cypher_astnode_t *node,
+		bool include_aggregates, bool in_map) {
 	cypher_astnode_type_t type = cypher_astnode_type(node);
 	if(type == CYPHER_AST_APPLY_ALL_OPERATOR) {
 		// Working with a function call that has * as its argument.
@@ -300,30 +278,24 @@ static AST_Validation _VisitFunctions(const cypher_astnode_t *node, rax *func_na
 			return AST_INVALID;
 		}
 
-		// Collect the function name, which is always "count" here.
-		raxInsert(func_names, (unsigned char *)"count", 5, NULL, NULL);
-
 		// As Apply All operators have no children, we can return here.
-		return AST_VALID;
+		return _ValidateFunction("count", include_aggregates, in_map);
 	}
 
 	if(type == CYPHER_AST_APPLY_OPERATOR) {
-		// Collect the function name.
 		const cypher_astnode_t *func = cypher_ast_apply_operator_get_func_name(node);
 		const char *func_name = cypher_ast_function_name_get_value(func);
-		raxInsert(func_names, (unsigned char *)func_name, strlen(func_name), NULL, NULL);
-	}
-
-	if(type == CYPHER_AST_MAP) {
-		// validate map expression
-		AST_Validation res = _ValidateMapExp(node);
+		AST_Validation res = _ValidateFunction(func_name, include_aggregates,
+				in_map);
 		if(res != AST_VALID) return res;
 	}
 
+	if(type == CYPHER_AST_MAP) in_map = true;
+
 	uint child_count = cypher_astnode_nchildren(node);
 	for(uint i = 0; i < child_count; i ++) {
 		const cypher_astnode_t *child = cypher_astnode_get_child(node, i);
-		AST_Validation res = _VisitFunctions(child, func_names);
+		AST_Validation res = _VisitFunctions(child, include_aggregates, in_map);
 		if(res != AST_VALID) return res;
 	}
 
@@ -332,19 +304,7 @@ static AST_Validation _VisitFunctions(const cypher_astnode_t *node, rax *func_na
 
 static AST_Validation _ValidateFunctionCalls(const cypher_astnode_t *node,
 											 bool include_aggregates) {
-	AST_Validation res = AST_VALID;
-	rax *func_names = raxNew();
-
-	// Collect function names and perform in-place validations.
-	res = _VisitFunctions(node, func_names);
-	if(res != AST_VALID) goto cleanup;
-
-	// Validate all provided function names.
-	res = _ValidateReferredFunctions(func_names, include_aggregates);
-
-cleanup:
-	raxFree(func_names);
-	return res;
+	return _VisitFunctions(node, include_aggregates, false);
 }
 
 static inline bool _AliasIsReturned(rax *projections, const char *identifier) {
@@ -629,6 +589,32 @@ static AST_Validation _ValidateReusedAliases(rax *edge_aliases, const cypher_ast
 	return res;
 }
 
+// Validate that planner hints only refer to entities defined by their MATCH pattern
+static AST_Validation _Validate_MATCH_Clause_Hints(const cypher_astnode_t *match_clause) {
+	if(cypher_ast_match_nhints(match_clause) == 0) return AST_VALID;
+
+	AST_Validation res = AST_VALID;
+	rax *defined = raxNew();
+	PlanHint *hints = array_new(PlanHint, 1);
+	_AST_Pattern_GetDefinedIdentifiers(cypher_ast_match_get_pattern(match_clause), defined);
+	AST_CollectMatchHints(match_clause, &hints);
+
+	uint hint_count = array_len(hints);
+	for(uint i = 0; i < hint_count; i++) {
+		const char *alias = hints[i].alias;
+		if(raxFind(defined, (unsigned char *)alias, strlen(alias)) == raxNotFound) {
+			ErrorCtx_SetError("Hint refers to '%s' which is not defined by the MATCH pattern",
+							  alias);
+			res = AST_INVALID;
+			break;
+		}
+	}
+
+	array_free(hints);
+	raxFree(defined);
+	return res;
+}
+
 static AST_Validation _Validate_MATCH_Clauses(const AST *ast) {
 	// Check to see if all mentioned inlined, outlined functions exists.
 	// Inlined functions appear within entity definition ({a:v})
@@ -656,6 +642,10 @@ static AST_Validation _Validate_MATCH_Clauses(const AST *ast) {
 		res = _Validate_MATCH_Clause_Filters(match_clause);
 		if(res == AST_INVALID) goto cleanup;
 
+		// Validate that hints refer to entities defined by the pattern
+		res = _Validate_MATCH_Clause_Hints(match_clause);
+		if(res == AST_INVALID) goto cleanup;
+
 		// Validate all function references in clause. Aggregate calls cannot be made in MATCH
 		// clauses or their WHERE predicates.
 		bool include_aggregates = false;
@@ -1639,10 +1629,12 @@ AST_Validation AST_Validate_Query(const cypher_parse_result_t *result) {
 
 	const cypher_astnode_t *body = cypher_ast_statement_get_body(root);
 	cypher_astnode_type_t body_type = cypher_astnode_type(body);
-	if(body_type == CYPHER_AST_CREATE_NODE_PROPS_INDEX    ||
-	   body_type == CYPHER_AST_CREATE_PATTERN_PROPS_INDEX ||
-	   body_type == CYPHER_AST_DROP_PROPS_INDEX) {
-		// Index operation; validations are handled elsewhere.
+	if(body_type == CYPHER_AST_CREATE_NODE_PROPS_INDEX     ||
+	   body_type == CYPHER_AST_CREATE_PATTERN_PROPS_INDEX  ||
+	   body_type == CYPHER_AST_DROP_PROPS_INDEX            ||
+	   body_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT ||
+	   body_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) {
+		// Index or constraint operation; validations are handled elsewhere.
 		return AST_VALID;
 	}
 
@@ -37,8 +37,8 @@ static void _buildTypesWhitelist(void) {
 		CYPHER_AST_CREATE_NODE_PROPS_INDEX,
 		CYPHER_AST_DROP_PROPS_INDEX,
 		CYPHER_AST_CREATE_PATTERN_PROPS_INDEX,
-		// CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT,
-		// CYPHER_AST_DROP_NODE_PROP_CONSTRAINT,
+		CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT,
+		CYPHER_AST_DROP_NODE_PROP_CONSTRAINT,
 		// CYPHER_AST_CREATE_REL_PROP_CONSTRAINT,
 		// CYPHER_AST_DROP_REL_PROP_CONSTRAINT,
 		CYPHER_AST_QUERY,
@@ -57,10 +57,10 @@ static void _buildTypesWhitelist(void) {
 		// CYPHER_AST_REL_ID_LOOKUP,
 		// CYPHER_AST_ALL_RELS_SCAN,
 		CYPHER_AST_MATCH,
-		// CYPHER_AST_MATCH_HINT,
-		// CYPHER_AST_USING_INDEX,
-		// CYPHER_AST_USING_JOIN,
-		// CYPHER_AST_USING_SCAN,
+		CYPHER_AST_MATCH_HINT,
+		CYPHER_AST_USING_INDEX,
+		CYPHER_AST_USING_JOIN,
+		CYPHER_AST_USING_SCAN,
 		CYPHER_AST_MERGE,
 		CYPHER_AST_MERGE_ACTION,
 		CYPHER_AST_ON_MATCH,
@@ -179,7 +179,7 @@ static void _buildOperatorsWhitelist(void) {
 		CYPHER_OP_UNARY_MINUS,
 		// CYPHER_OP_SUBSCRIPT,
 		// CYPHER_OP_MAP_PROJECTION,
-		// CYPHER_OP_REGEX,
+		CYPHER_OP_REGEX,
 		CYPHER_OP_IN,
 		CYPHER_OP_STARTS_WITH,
 		CYPHER_OP_ENDS_WITH,
@@ -0,0 +1,580 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "bulk_export.h"
+#include "rax.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../graph/rg_matrix/rg_matrix_iter.h"
+#include <errno.h>
+#include <stdio.h>
+
+// property types of the GRAPH.BULK binary format, see bulk_insert.c
+#define BE_NULL   0
+#define BE_BOOL   1
+#define BE_DOUBLE 2
+#define BE_STRING 3
+#define BE_LONG   4
+#define BE_ARRAY  5
+
+// child process exit codes
+#define EXPORT_OK     0
+#define EXPORT_FAILED 1
+
+struct BulkExport {
+	char *dir;                     // directory to export into
+	RedisModuleBlockedClient *bc;  // client awaiting the export
+	int exitcode;                  // child's exit code
+	int bysignal;                  // child was killed by a signal
+};
+
+// nodes sharing a label set, exported to the same file
+typedef struct {
+	LabelID *labels;  // group's labels
+	NodeID *ids;      // group's nodes, in scan order
+	bool *attrs;      // attributes set on any of the group's nodes
+} NodeGroup;
+
+// an open export file, header and entities
+typedef struct {
+	FILE *f;                // file
+	char *buf;              // file buffer
+	int *columns;           // column of each attribute, -1 if absent
+	uint prop_count;        // number of columns
+	const SIValue **values; // entity's value per column
+} ExportFile;
+
+//------------------------------------------------------------------------------
+// writing
+//------------------------------------------------------------------------------
+
+static inline void _WriteType
+(
+	FILE *f,
+	uint8_t t
+) {
+	fputc(t, f);
+}
+
+static void _WriteValue
+(
+	FILE *f,
+	const SIValue *v
+) {
+	// property format, see docs/bulk_spec.md
+	// values the bulk format can't represent are exported as null
+	// e.g. points and maps, nulls aren't set as properties once imported
+
+	v = Entity_ReadValue((SIValue *)v);
+	switch(SI_TYPE(*v)) {
+		case T_BOOL: {
+			_WriteType(f, BE_BOOL);
+			fputc(v->longval != 0, f);
+			break;
+		}
+		case T_DOUBLE:
+			_WriteType(f, BE_DOUBLE);
+			fwrite(&v->doubleval, sizeof(double), 1, f);
+			break;
+		case T_INT64:
+			_WriteType(f, BE_LONG);
+			fwrite(&v->longval, sizeof(int64_t), 1, f);
+			break;
+		case T_STRING:
+			_WriteType(f, BE_STRING);
+			fwrite(v->stringval, 1, strlen(v->stringval) + 1, f);
+			break;
+		case T_ARRAY: {
+			int64_t len = SIArray_Length(*v);
+			_WriteType(f, BE_ARRAY);
+			fwrite(&len, sizeof(int64_t), 1, f);
+			for(int64_t i = 0; i < len; i++) {
+				SIValue elem = SIArray_Get(*v, i);
+				_WriteValue(f, &elem);
+			}
+			break;
+		}
+		default:
+			_WriteType(f, BE_NULL);
+			break;
+	}
+}
+
+// open 'path' and write its header
+// the header's properties are the attributes flagged by 'attrs'
+static bool _ExportFile_Open
+(
+	ExportFile *file,
+	GraphContext *gc,
+	const char *path,
+	const char *name,   // label(s) or relationship type
+	const bool *attrs,  // attributes to export
+	uint attr_count     // length of 'attrs'
+) {
+	file->f = fopen(path, "wb");
+	if(file->f == NULL) {
+		RedisModule_Log(NULL, "warning", "Failed to open '%s': %s", path,
+				strerror(errno));
+		return false;
+	}
+
+	// bound the memory held by each file to its buffer
+	file->buf = rm_malloc(BULK_EXPORT_BUFFER_SIZE);
+	setvbuf(file->f, file->buf, _IOFBF, BULK_EXPORT_BUFFER_SIZE);
+
+	file->prop_count = 0;
+	file->columns = rm_malloc(sizeof(int) * attr_count);
+	for(uint i = 0; i < attr_count; i++) {
+		file->columns[i] = attrs[i] ? file->prop_count++ : -1;
+	}
+	file->values = rm_malloc(sizeof(SIValue *) * (file->prop_count + 1));
+
+	// header format:
+	//  name, NULL terminated
+	//  property count, 4 bytes
+	//  property names, NULL terminated
+	fwrite(name, 1, strlen(name) + 1, file->f);
+	uint32_t prop_count = file->prop_count;
+	fwrite(&prop_count, sizeof(uint32_t), 1, file->f);
+	for(uint i = 0; i < attr_count; i++) {
+		if(!attrs[i]) continue;
+		const char *attr = GraphContext_GetAttributeString(gc, i);
+		fwrite(attr, 1, strlen(attr) + 1, file->f);
+	}
+
+	return true;
+}
+
+// write the properties of 'e' in column order
+// attributes missing from 'e' are written as null
+static void _ExportFile_WriteProperties
+(
+	ExportFile *file,
+	const Entity *e
+) {
+	memset(file->values, 0, sizeof(SIValue *) * file->prop_count);
+
+	int prop_count = Entity_PropCount(e);
+	const Attribute_ID *ids = Entity_AttributeIDs(e);
+	for(int i = 0; i < prop_count; i++) {
+		file->values[file->columns[ids[i]]] = e->properties + i;
+	}
+
+	for(uint i = 0; i < file->prop_count; i++) {
+		if(file->values[i] == NULL) _WriteType(file->f, BE_NULL);
+		else _WriteValue(file->f, file->values[i]);
+	}
+}
+
+// flush and close file, returns false if any write failed
+static bool _ExportFile_Close
+(
+	ExportFile *file,
+	const char *path
+) {
+	bool ok = !ferror(file->f);
+	ok = (fclose(file->f) == 0) && ok;
+	if(!ok) {
+		RedisModule_Log(NULL, "warning", "Failed to write '%s': %s", path,
+				strerror(errno));
+	}
+
+	rm_free(file->buf);
+	rm_free(file->columns);
+	rm_free(file->values);
+	return ok;
+}
+
+//------------------------------------------------------------------------------
+// nodes
+//------------------------------------------------------------------------------
+
+// group nodes by label set, groups are ordered by first appearance
+static NodeGroup *_GroupNodes
+(
+	GraphContext *gc
+) {
+	Graph *g = gc->g;
+	uint attr_count = GraphContext_AttributeCount(gc);
+	NodeGroup *groups = array_new(NodeGroup, 1);
+	rax *lookup = raxNew();
+
+	Node n;
+	DataBlockIterator *it = Graph_ScanNodes(g);
+	while((n.entity = DataBlockIterator_Next(it, &n.id)) != NULL) {
+		uint label_count;
+		NODE_GET_LABELS(g, &n, label_count);
+
+		// map label set to group
+		void *idx = raxFind(lookup, (unsigned char *)labels,
+				sizeof(LabelID) * label_count);
+		if(idx == raxNotFound) {
+			NodeGroup group;
+			group.labels = array_new(LabelID, label_count);
+			for(uint i = 0; i < label_count; i++) {
+				array_append(group.labels, labels[i]);
+			}
+			group.ids = array_new(NodeID, 1);
+			group.attrs = rm_calloc(attr_count, sizeof(bool));
+
+			idx = (void *)(uintptr_t)array_len(groups);
+			raxInsert(lookup, (unsigned char *)labels,
+					sizeof(LabelID) * label_count, idx, NULL);
+			array_append(groups, group);
+		}
+
+		NodeGroup *group = groups + (uintptr_t)idx;
+		array_append(group->ids, n.id);
+
+		int prop_count = Entity_PropCount(n.entity);
+		const Attribute_ID *ids = Entity_AttributeIDs(n.entity);
+		for(int i = 0; i < prop_count; i++) group->attrs[ids[i]] = true;
+	}
+
+	DataBlockIterator_Free(it);
+	raxFree(lookup);
+	return groups;
+}
+
+// write group's nodes to 'path'
+static bool _ExportNodes
+(
+	GraphContext *gc,
+	const NodeGroup *group,
+	const char *path
+) {
+	// header name, labels delimited by ':'
+	// nodes without labels are exported under an empty name
+	size_t len = 1;
+	uint label_count = array_len(group->labels);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, group->labels[i],
+				SCHEMA_NODE);
+		len += strlen(Schema_GetName(s)) + 1;
+	}
+
+	char name[len];
+	name[0] = '\0';
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, group->labels[i],
+				SCHEMA_NODE);
+		if(i > 0) strcat(name, ":");
+		strcat(name, Schema_GetName(s));
+	}
+
+	ExportFile file;
+	if(!_ExportFile_Open(&file, gc, path, name, group->attrs,
+				GraphContext_AttributeCount(gc))) {
+		return false;
+	}
+
+	// node format:
+	//  properties
+	uint count = array_len(group->ids);
+	for(uint i = 0; i < count; i++) {
+		Node n;
+		Graph_GetNode(gc->g, group->ids[i], &n);
+		_ExportFile_WriteProperties(&file, n.entity);
+	}
+
+	return _ExportFile_Close(&file, path);
+}
+
+//------------------------------------------------------------------------------
+// relations
+//------------------------------------------------------------------------------
+
+// scan edges of relationship type 'r'
+// if 'file' is NULL, collects the attributes set on its edges into 'attrs'
+// returns the number of edges
+static uint64_t _ScanRelation
+(
+	GraphContext *gc,
+	int r,
+	const NodeID *new_ids,  // node ID mapping
+	bool *attrs,            // [output] attributes set on edges
+	ExportFile *file        // file to write edges to
+) {
+	Graph *g = gc->g;
+	RG_Matrix R = Graph_GetRelationMatrix(g, r, false);
+
+	RG_MatrixTupleIter it;
+	RG_MatrixTupleIter_reuse(&it, R);
+	RG_MatrixTupleIter_iterate_range(&it, 0, UINT64_MAX);
+
+	uint64_t  x;
+	uint64_t  count     =  0;
+	NodeID    src       =  INVALID_ENTITY_ID;
+	NodeID    dest      =  INVALID_ENTITY_ID;
+	bool      depleted  =  false;
+
+	while(true) {
+		RG_MatrixTupleIter_next(&it, &src, &dest, &x, &depleted);
+		if(depleted) break;
+
+		uint64_t edge_count = 1;
+		const EdgeID *ids = &x;
+		if(!SINGLE_EDGE(x)) ids = RG_Matrix_multiEdgeIDs(R, x, &edge_count);
+
+		for(uint64_t i = 0; i < edge_count; i++) {
+			Edge e;
+			Graph_GetEdge(g, ids[i], &e);
+
+			if(file == NULL) {
+				int prop_count = Entity_PropCount(e.entity);
+				const Attribute_ID *attr_ids = Entity_AttributeIDs(e.entity);
+				for(int j = 0; j < prop_count; j++) attrs[attr_ids[j]] = true;
+				continue;
+			}
+
+			// edge format:
+			//  source node ID, 8 bytes
+			//  destination node ID, 8 bytes
+			//  properties
+			fwrite(new_ids + src, sizeof(NodeID), 1, file->f);
+			fwrite(new_ids + dest, sizeof(NodeID), 1, file->f);
+			_ExportFile_WriteProperties(file, e.entity);
+		}
+
+		count += edge_count;
+	}
+
+	return count;
+}
+
+// write edges of relationship type 'r' to 'path'
+// sets 'exported' to false if 'r' has no edges, in which case no file is written
+static bool _ExportRelation
+(
+	GraphContext *gc,
+	int r,
+	const NodeID *new_ids,
+	const char *path,
+	bool *exported
+) {
+	uint attr_count = GraphContext_AttributeCount(gc);
+	bool *attrs = rm_calloc(attr_count, sizeof(bool));
+
+	*exported = (_ScanRelation(gc, r, new_ids, attrs, NULL) > 0);
+	if(!*exported) {
+		rm_free(attrs);
+		return true;
+	}
+
+	Schema *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+	ExportFile file;
+	bool ok = _ExportFile_Open(&file, gc, path, Schema_GetName(s), attrs,
+			attr_count);
+	rm_free(attrs);
+	if(!ok) return false;
+
+	_ScanRelation(gc, r, new_ids, NULL, &file);
+	return _ExportFile_Close(&file, path);
+}
+
+//------------------------------------------------------------------------------
+// child
+//------------------------------------------------------------------------------
+
+// export 'gc' into 'dir', runs within the forked child
+// writes the exported files, followed by a manifest listing them
+static bool _BulkExport_Write
+(
+	GraphContext *gc,
+	const char *dir
+) {
+	bool ok = true;
+	char *path = NULL;
+	Graph *g = gc->g;
+	char **manifest = array_new(char *, 0);
+
+	// nodes are reassigned IDs in the order they'll be imported
+	NodeGroup *groups = _GroupNodes(gc);
+	uint group_count = array_len(groups);
+	NodeID *new_ids = rm_malloc(sizeof(NodeID) *
+			(Graph_RequiredMatrixDim(g) + 1));
+
+	NodeID next_id = 0;
+	for(uint i = 0; i < group_count; i++) {
+		uint count = array_len(groups[i].ids);
+		for(uint j = 0; j < count; j++) new_ids[groups[i].ids[j]] = next_id++;
+	}
+
+	for(uint i = 0; i < group_count && ok; i++) {
+		asprintf(&path, "%s/nodes_%u.bin", dir, i);
+		ok = _ExportNodes(gc, groups + i, path);
+		array_append(manifest, path);
+	}
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count && ok; r++) {
+		bool exported;
+		asprintf(&path, "%s/relations_%d.bin", dir, r);
+		ok = _ExportRelation(gc, r, new_ids, path, &exported);
+		if(exported) array_append(manifest, path);
+		else free(path);
+	}
+
+	// manifest format, a line per exported file:
+	//  NODES|RELATIONS <path>
+	if(ok) {
+		asprintf(&path, "%s/%s", dir, BULK_EXPORT_MANIFEST);
+		FILE *f = fopen(path, "w");
+		ok = (f != NULL);
+		uint count = array_len(manifest);
+		for(uint i = 0; i < count && ok; i++) {
+			fprintf(f, "%s %s\n", i < group_count ? "NODES" : "RELATIONS",
+					manifest[i]);
+		}
+		if(f != NULL) ok = !ferror(f) && (fclose(f) == 0) && ok;
+		if(!ok) {
+			RedisModule_Log(NULL, "warning", "Failed to write '%s': %s",
+					path, strerror(errno));
+		}
+		free(path);
+	}
+
+	for(uint i = 0; i < group_count; i++) {
+		array_free(groups[i].labels);
+		array_free(groups[i].ids);
+		rm_free(groups[i].attrs);
+	}
+	array_free(groups);
+	array_free_cb(manifest, free);
+	rm_free(new_ids);
+
+	return ok;
+}
+
+//------------------------------------------------------------------------------
+// parent
+//------------------------------------------------------------------------------
+
+// fork done handler, invoked on the main thread once the child exits
+static void _BulkExport_Done
+(
+	int exitcode,
+	int bysignal,
+	void *user_data
+) {
+	BulkExport *export = (BulkExport *)user_data;
+	export->exitcode = exitcode;
+	export->bysignal = bysignal;
+	RedisModule_UnblockClient(export->bc, export);
+}
+
+BulkExport *BulkExport_New
+(
+	const char *dir
+) {
+	ASSERT(dir != NULL);
+
+	BulkExport *export = rm_calloc(1, sizeof(BulkExport));
+	export->dir = rm_strdup(dir);
+	export->exitcode = EXPORT_FAILED;
+	return export;
+}
+
+bool BulkExport_Start
+(
+	BulkExport *export,
+	RedisModuleCtx *ctx,
+	GraphContext *gc,
+	char **err
+) {
+	ASSERT(gc     != NULL);
+	ASSERT(ctx    != NULL);
+	ASSERT(err    != NULL);
+	ASSERT(export != NULL);
+
+	// the fork hooks make sure the child inherits a consistent graph,
+	// writers are held back only while forking
+	int pid = RedisModule_Fork(_BulkExport_Done, export);
+	if(pid < 0) {
+		asprintf(err, "Failed to fork an export process: %s, "
+				"another background save or export may be in progress",
+				strerror(errno));
+		return false;
+	}
+
+	if(pid == 0) {
+		// child
+		bool ok = _BulkExport_Write(gc, export->dir);
+		RedisModule_ExitFromChild(ok ? EXPORT_OK : EXPORT_FAILED);
+	}
+
+	// parent, the done handler runs on this thread
+	// hence the client is blocked before the child can be reaped
+	export->bc = RedisModule_BlockClient(ctx, BulkExport_Reply, NULL,
+			BulkExport_FreePrivData, 0);
+	return true;
+}
+
+int BulkExport_Reply
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+) {
+	BulkExport *export = RedisModule_GetBlockedClientPrivateData(ctx);
+
+	FILE *f = NULL;
+	char *path = NULL;
+	asprintf(&path, "%s/%s", export->dir, BULK_EXPORT_MANIFEST);
+	if(export->exitcode == EXPORT_OK && !export->bysignal) {
+		f = fopen(path, "r");
+	}
+	free(path);
+
+	if(f == NULL) {
+		char *err;
+		asprintf(&err, "Failed to export graph to '%s', see the server log",
+				export->dir);
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		return REDISMODULE_OK;
+	}
+
+	// reply with the manifest's NODES|RELATIONS <path> pairs
+	long len = 0;
+	char *line = NULL;
+	size_t cap = 0;
+	ssize_t n;
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+	while((n = getline(&line, &cap, f)) > 0) {
+		if(line[n - 1] == '\n') line[--n] = '\0';
+		char *sep = strchr(line, ' ');
+		if(sep == NULL) continue;
+		RedisModule_ReplyWithStringBuffer(ctx, line, sep - line);
+		RedisModule_ReplyWithStringBuffer(ctx, sep + 1, n - (sep + 1 - line));
+		len += 2;
+	}
+	RedisModule_ReplySetArrayLength(ctx, len);
+
+	free(line);
+	fclose(f);
+	return REDISMODULE_OK;
+}
+
+void BulkExport_FreePrivData
+(
+	RedisModuleCtx *ctx,
+	void *privdata
+) {
+	BulkExport_Free((BulkExport *)privdata);
+}
+
+void BulkExport_Free
+(
+	BulkExport *export
+) {
+	ASSERT(export != NULL);
+
+	rm_free(export->dir);
+	rm_free(export);
+}
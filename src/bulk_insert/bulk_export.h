@@ -0,0 +1,65 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+#include "../graph/graphcontext.h"
+
+// number of bytes buffered per exported file before it is written out
+#define BULK_EXPORT_BUFFER_SIZE (1 << 20)
+
+// name of the file listing an export's files, in import order
+#define BULK_EXPORT_MANIFEST "manifest"
+
+// BulkExport writes a graph into a directory as files in the GRAPH.BULK
+// binary format, a file per node label set and a file per relationship type
+//
+// the export is taken by a forked child process, which sees a consistent
+// snapshot of the graph while the server keeps serving readers and writers,
+// files are written through a bounded buffer
+//
+// node IDs are reassigned densely in export order, such that passing the
+// exported files in order to GRAPH.IMPORT reconstructs the graph
+typedef struct BulkExport BulkExport;
+
+// create a new export into directory 'dir'
+BulkExport *BulkExport_New
+(
+	const char *dir  // directory to export into
+);
+
+// fork a child exporting 'gc' and block the calling client until it exits
+// returns false and sets 'err' if the child can't be forked
+bool BulkExport_Start
+(
+	BulkExport *export,   // export
+	RedisModuleCtx *ctx,  // calling client
+	GraphContext *gc,     // graph to export
+	char **err            // [output] error message
+);
+
+// blocked client reply callback, replies with the exported files
+// as NODES|RELATIONS <path> pairs, in import order
+int BulkExport_Reply
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// blocked client free callback
+void BulkExport_FreePrivData
+(
+	RedisModuleCtx *ctx,
+	void *privdata
+);
+
+// free an export which wasn't started
+void BulkExport_Free
+(
+	BulkExport *export
+);
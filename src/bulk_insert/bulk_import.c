@@ -0,0 +1,429 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "bulk_import.h"
+#include "bulk_insert.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+
+// a single file to import
+typedef struct {
+	char *path;    // file path
+	FILE *f;       // open file
+	SchemaType t;  // file entities type
+} ImportFile;
+
+struct BulkImport {
+	GraphContext *gc;              // graph to import into, retained
+	RedisModuleBlockedClient *bc;  // client awaiting the import
+	ImportFile *files;             // files to import
+	uint current;                  // index of the file being imported
+	uint64_t bytes_read;           // bytes read from the current file
+	uint64_t node_count;           // number of created nodes
+	uint64_t edge_count;           // number of created edges
+	bool replicated;               // at least one chunk was replicated
+	char *err;                     // import error, NULL on success
+};
+
+// imports in progress, guarded by 'imports_lock'
+// also guards the progress of each listed import
+static BulkImport **imports = NULL;
+static pthread_mutex_t imports_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void _BulkImport_Register
+(
+	BulkImport *import
+) {
+	pthread_mutex_lock(&imports_lock);
+	if(imports == NULL) imports = array_new(BulkImport *, 1);
+	array_append(imports, import);
+	pthread_mutex_unlock(&imports_lock);
+}
+
+static void _BulkImport_Unregister
+(
+	BulkImport *import
+) {
+	pthread_mutex_lock(&imports_lock);
+	uint count = array_len(imports);
+	for(uint i = 0; i < count; i++) {
+		if(imports[i] == import) {
+			array_del_fast(imports, i);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&imports_lock);
+}
+
+// replicate a committed chunk as a GRAPH.BULK command
+// the first replicated chunk creates the graph on replicas
+static void _BulkImport_Replicate
+(
+	RedisModuleCtx *ctx,
+	BulkImport *import,
+	SchemaType t,
+	uint64_t created,
+	const char *data,
+	size_t len
+) {
+	const char *name = import->gc->graph_name;
+	long long nodes = (t == SCHEMA_NODE) ? created : 0;
+	long long edges = (t == SCHEMA_EDGE) ? created : 0;
+	long long node_tokens = (t == SCHEMA_NODE) ? 1 : 0;
+	long long relation_tokens = (t == SCHEMA_EDGE) ? 1 : 0;
+
+	if(!import->replicated) {
+		RedisModule_Replicate(ctx, "GRAPH.BULK", "ccllllb", name, "BEGIN",
+				nodes, edges, node_tokens, relation_tokens, data, len);
+	} else {
+		RedisModule_Replicate(ctx, "GRAPH.BULK", "cllllb", name, nodes,
+				edges, node_tokens, relation_tokens, data, len);
+	}
+
+	// each replicated command advances the replicas' commit sequence
+	GraphContext_AdvanceCommitSeq(import->gc);
+	import->replicated = true;
+}
+
+// commit a chunk, a header followed by complete entities
+// returns false if the graph had been deleted since the import started
+static bool _BulkImport_Commit
+(
+	BulkImport *import,
+	SchemaType t,
+	const char *data,
+	size_t len
+) {
+	GraphContext *gc = import->gc;
+	uint64_t created = 0;
+
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+	Graph_AcquireWriteLock(gc->g);
+
+	bool registered = GraphContext_GetRegisteredGraphContext(gc->graph_name)
+		== gc;
+
+	if(registered) {
+		QueryCtx_SetGraphCtx(gc);
+		created = BulkInsert_Stream(gc, t, data, len);
+		QueryCtx_Free();
+
+		// replicate while the GIL is held such that replicas observe
+		// chunks in the same order as commands executed in between
+		_BulkImport_Replicate(ctx, import, t, created, data, len);
+	}
+
+	Graph_ReleaseLock(gc->g);
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	pthread_mutex_lock(&imports_lock);
+	if(t == SCHEMA_NODE) import->node_count += created;
+	else import->edge_count += created;
+	pthread_mutex_unlock(&imports_lock);
+
+	return registered;
+}
+
+// import a single file in chunks of BULK_IMPORT_CHUNK_SIZE bytes
+// each chunk is made of the file's header followed by the complete entities
+// read so far, incomplete entities are carried over to the next chunk
+// returns false and sets the import's error on failure
+static bool _BulkImport_File
+(
+	BulkImport *import,
+	ImportFile *file
+) {
+	bool      ok          =  false;
+	bool      eof         =  false;
+	bool      malformed   =  false;
+	uint      prop_count  =  0;
+	size_t    len         =  0;  // number of bytes in buffer
+	size_t    header_len  =  0;  // header length, 0 until read
+	size_t    cap         =  BULK_IMPORT_CHUNK_SIZE;
+	char     *buf         =  rm_malloc(cap);
+
+	while(!eof) {
+		// grow buffer if a single entity exceeds it
+		if(len == cap) {
+			cap *= 2;
+			buf = rm_realloc(buf, cap);
+		}
+
+		size_t n = fread(buf + len, 1, cap - len, file->f);
+		if(n < cap - len) {
+			if(ferror(file->f)) {
+				asprintf(&import->err, "Failed to read '%s': %s", file->path,
+						strerror(errno));
+				goto cleanup;
+			}
+			eof = feof(file->f);
+		}
+		len += n;
+
+		pthread_mutex_lock(&imports_lock);
+		import->bytes_read += n;
+		pthread_mutex_unlock(&imports_lock);
+
+		if(header_len == 0) {
+			header_len = BulkInsert_HeaderLength(buf, len, &prop_count);
+			// header is incomplete, read on
+			if(header_len == 0) continue;
+
+			// relations are of a single type
+			if(file->t == SCHEMA_EDGE && strchr(buf, ':') != NULL) {
+				asprintf(&import->err, "Relations in '%s' must have a single "
+						"type", file->path);
+				goto cleanup;
+			}
+		}
+
+		size_t entities_len = BulkInsert_EntitiesLength(buf + header_len,
+				len - header_len, file->t, prop_count, &malformed);
+
+		if(malformed) {
+			asprintf(&import->err, "Malformed entity in '%s' near byte %llu",
+					file->path, (unsigned long long)(import->bytes_read - len +
+					header_len + entities_len));
+			goto cleanup;
+		}
+
+		if(entities_len == 0) continue;
+
+		if(!_BulkImport_Commit(import, file->t, buf,
+					header_len + entities_len)) {
+			asprintf(&import->err, "Graph '%s' was deleted during import",
+					import->gc->graph_name);
+			goto cleanup;
+		}
+
+		// carry incomplete entity over to the next chunk
+		size_t remaining = len - header_len - entities_len;
+		memmove(buf + header_len, buf + header_len + entities_len, remaining);
+		len = header_len + remaining;
+	}
+
+	if(header_len == 0 && len > 0) {
+		asprintf(&import->err, "Incomplete header in '%s'", file->path);
+		goto cleanup;
+	}
+
+	if(len > header_len) {
+		asprintf(&import->err, "Truncated entity at the end of '%s'",
+				file->path);
+		goto cleanup;
+	}
+
+	ok = true;
+
+cleanup:
+	rm_free(buf);
+	return ok;
+}
+
+// import thread entry point
+static void *_BulkImport_Run
+(
+	void *arg
+) {
+	BulkImport *import = (BulkImport *)arg;
+
+	uint file_count = array_len(import->files);
+	for(uint i = 0; i < file_count; i++) {
+		pthread_mutex_lock(&imports_lock);
+		import->current    = i;
+		import->bytes_read = 0;
+		pthread_mutex_unlock(&imports_lock);
+
+		if(!_BulkImport_File(import, import->files + i)) break;
+	}
+
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+
+	const char *name = import->gc->graph_name;
+	if(GraphContext_GetRegisteredGraphContext(name) == import->gc) {
+		if(import->err != NULL) {
+			// drop partially imported graph, as a failed GRAPH.BULK does
+			RedisModuleString *rs_name = RedisModule_CreateString(ctx, name,
+					strlen(name));
+			RedisModuleKey *key = RedisModule_OpenKey(ctx, rs_name,
+					REDISMODULE_WRITE);
+			RedisModule_DeleteKey(key);
+			RedisModule_CloseKey(key);
+			RedisModule_FreeString(ctx, rs_name);
+
+			if(import->replicated) RedisModule_Replicate(ctx, "DEL", "c", name);
+		} else if(!import->replicated) {
+			// replicas must create the graph even if nothing was imported
+			GraphContext_AdvanceCommitSeq(import->gc);
+			RedisModule_Replicate(ctx, "GRAPH.BULK", "ccllll", name, "BEGIN",
+					0LL, 0LL, 0LL, 0LL);
+		}
+	}
+
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	_BulkImport_Unregister(import);
+	RedisModule_UnblockClient(import->bc, import);
+
+	return NULL;
+}
+
+BulkImport *BulkImport_New
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+
+	BulkImport *import = rm_calloc(1, sizeof(BulkImport));
+	import->gc    = gc;
+	import->files = array_new(ImportFile, 1);
+
+	GraphContext_Retain(gc);
+
+	return import;
+}
+
+bool BulkImport_AddFile
+(
+	BulkImport *import,
+	const char *path,
+	SchemaType t,
+	char **err
+) {
+	ASSERT(import != NULL);
+	ASSERT(path   != NULL);
+	ASSERT(err    != NULL);
+
+	FILE *f = fopen(path, "rb");
+	if(f == NULL) {
+		asprintf(err, "Failed to open '%s': %s", path, strerror(errno));
+		return false;
+	}
+
+	ImportFile file = {.path = rm_strdup(path), .f = f, .t = t};
+	array_append(import->files, file);
+
+	return true;
+}
+
+void BulkImport_Start
+(
+	BulkImport *import,
+	RedisModuleBlockedClient *bc
+) {
+	ASSERT(import != NULL);
+	ASSERT(bc     != NULL);
+
+	import->bc = bc;
+
+	_BulkImport_Register(import);
+
+	pthread_t thread;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	if(pthread_create(&thread, &attr, _BulkImport_Run, import) != 0) {
+		asprintf(&import->err, "Failed to start import thread");
+		_BulkImport_Unregister(import);
+		RedisModule_UnblockClient(import->bc, import);
+	}
+
+	pthread_attr_destroy(&attr);
+}
+
+int BulkImport_Reply
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+) {
+	BulkImport *import = RedisModule_GetBlockedClientPrivateData(ctx);
+
+	if(import->err != NULL) {
+		return RedisModule_ReplyWithError(ctx, import->err);
+	}
+
+	char reply[1024];
+	int len = snprintf(reply, 1024, "%llu nodes created, %llu edges created",
+			(unsigned long long)import->node_count,
+			(unsigned long long)import->edge_count);
+	return RedisModule_ReplyWithStringBuffer(ctx, reply, len);
+}
+
+void BulkImport_FreePrivData
+(
+	RedisModuleCtx *ctx,
+	void *privdata
+) {
+	BulkImport_Free((BulkImport *)privdata);
+}
+
+void BulkImport_ReplyStatus
+(
+	RedisModuleCtx *ctx,
+	const char *graph_name
+) {
+	ASSERT(ctx        != NULL);
+	ASSERT(graph_name != NULL);
+
+	pthread_mutex_lock(&imports_lock);
+
+	BulkImport *import = NULL;
+	uint count = array_len(imports);
+	for(uint i = 0; i < count; i++) {
+		if(strcmp(imports[i]->gc->graph_name, graph_name) == 0) {
+			import = imports[i];
+			break;
+		}
+	}
+
+	if(import == NULL) {
+		RedisModule_ReplyWithNull(ctx);
+	} else {
+		RedisModule_ReplyWithArray(ctx, 8);
+		RedisModule_ReplyWithStringBuffer(ctx, "file", 4);
+		RedisModule_ReplyWithStringBuffer(ctx, import->files[import->current].path,
+				strlen(import->files[import->current].path));
+		RedisModule_ReplyWithStringBuffer(ctx, "bytes_read", 10);
+		RedisModule_ReplyWithLongLong(ctx, import->bytes_read);
+		RedisModule_ReplyWithStringBuffer(ctx, "nodes_created", 13);
+		RedisModule_ReplyWithLongLong(ctx, import->node_count);
+		RedisModule_ReplyWithStringBuffer(ctx, "edges_created", 13);
+		RedisModule_ReplyWithLongLong(ctx, import->edge_count);
+	}
+
+	pthread_mutex_unlock(&imports_lock);
+}
+
+void BulkImport_Free
+(
+	BulkImport *import
+) {
+	ASSERT(import != NULL);
+
+	uint file_count = array_len(import->files);
+	for(uint i = 0; i < file_count; i++) {
+		fclose(import->files[i].f);
+		rm_free(import->files[i].path);
+	}
+	array_free(import->files);
+
+	if(import->err != NULL) free(import->err);
+	GraphContext_Release(import->gc);
+	rm_free(import);
+}
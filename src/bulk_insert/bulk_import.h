@@ -0,0 +1,77 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+#include "../schema/schema.h"
+#include "../graph/graphcontext.h"
+
+// number of bytes read from an imported file per chunk
+#define BULK_IMPORT_CHUNK_SIZE (8 << 20)
+
+// BulkImport loads node and relation files, each holding a single binary
+// stream in the GRAPH.BULK format, into a new graph
+//
+// files are read by a dedicated thread in fixed-size chunks, each chunk's
+// complete entities are committed under the graph's write lock and
+// replicated as a GRAPH.BULK command, such that neither the importing
+// server nor its replicas ever hold more than a chunk of the input
+// files may be named pipes
+typedef struct BulkImport BulkImport;
+
+// create a new import into 'gc', the import retains 'gc'
+BulkImport *BulkImport_New
+(
+	GraphContext *gc  // graph to import into
+);
+
+// add a file to import, files are imported in order
+// returns false and sets 'err' if the file can't be opened
+bool BulkImport_AddFile
+(
+	BulkImport *import,  // import
+	const char *path,    // file path
+	SchemaType t,        // file entities type
+	char **err           // [output] error message
+);
+
+// start importing in the background, replies to 'bc' once done
+// the import is freed by the blocked client's free callback
+void BulkImport_Start
+(
+	BulkImport *import,           // import
+	RedisModuleBlockedClient *bc  // client awaiting the import
+);
+
+// blocked client reply callback, replies with the import's outcome
+int BulkImport_Reply
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString **argv,
+	int argc
+);
+
+// blocked client free callback
+void BulkImport_FreePrivData
+(
+	RedisModuleCtx *ctx,
+	void *privdata
+);
+
+// replies with the progress of the import into graph 'graph_name'
+// replies with null if no such import is in progress
+void BulkImport_ReplyStatus
+(
+	RedisModuleCtx *ctx,
+	const char *graph_name
+);
+
+// free an import which wasn't started
+void BulkImport_Free
+(
+	BulkImport *import
+);
@@ -10,6 +10,9 @@
 #include "../schema/schema.h"
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../configuration/config.h"
+#include <omp.h>
+#include <pthread.h>
 
 // the first byte of each property in the binary stream
 // is used to indicate the type of the subsequent SIValue
@@ -47,6 +50,8 @@ static int* _BulkInsert_ReadHeaderLabels
 
     // array of all label IDs
     int* label_ids = array_new(int, 1);
+    // an empty name describes nodes without labels
+    if (labels_len == 0 && t == SCHEMA_NODE) return label_ids;
     // stack variable to contain a single label
     char label[labels_len];
 
@@ -193,122 +198,289 @@ static SIValue _BulkInsert_ReadProperty
     return v;
 }
 
-static int _BulkInsert_ProcessNodeFile
+// skip over an SIValue in the data stream without decoding it
+static void _BulkInsert_SkipProperty
 (
-	GraphContext* gc,
 	const char* data,
-	size_t data_len
+	size_t* data_idx
 ) {
-    uint prop_count;
-    size_t data_idx = 0;
+	int64_t len;
+	TYPE t = data[*data_idx];
+	*data_idx += 1;
 
-    // read the CSV file header labels and update all schemas
-    int* label_ids = _BulkInsert_ReadHeaderLabels(gc, SCHEMA_NODE, data, &data_idx);
-    uint label_count = array_len(label_ids);
-    // read the CSV header properties and collect their indices
-    Attribute_ID* prop_indices = _BulkInsert_ReadHeaderProperties(gc, SCHEMA_NODE, data,
-	&data_idx, &prop_count);
+	switch (t) {
+		case BI_NULL:
+			break;
 
-    // sync each matrix once
-    ASSERT(Graph_GetMatrixPolicy(gc->g) == SYNC_POLICY_RESIZE);
+		case BI_BOOL:
+			*data_idx += 1;
+			break;
 
-	for (uint i = 0; i < label_count; i++) {
-		Graph_GetLabelMatrix(gc->g, label_ids[i]);
+		case BI_DOUBLE:
+			*data_idx += sizeof(double);
+			break;
+
+		case BI_LONG:
+			*data_idx += sizeof(int64_t);
+			break;
+
+		case BI_STRING:
+			*data_idx += strlen(data + *data_idx) + 1;
+			break;
+
+		case BI_ARRAY:
+			len = *(int64_t*)&data[*data_idx];
+			*data_idx += sizeof(int64_t);
+			for (int64_t i = 0; i < len; i++) {
+				_BulkInsert_SkipProperty(data, data_idx);
+			}
+			break;
+
+		default:
+			ASSERT(false);
+			break;
 	}
+}
+
+// a single node or edge binary stream
+// blobs are processed in three phases:
+// 1. scan, locates each entity's properties, for edges reads its endpoints
+// 2. create, allocates all entities and updates matrices in bulk
+// 3. decode, sets entities properties
+// phases 1 and 3 run in parallel as blobs share no state
+typedef struct {
+	const char* data;            // binary stream
+	size_t data_len;             // binary stream length
+	size_t body_idx;             // position of first entity
+	int* label_ids;              // labels or relationship type
+	Attribute_ID* prop_indices;  // header attribute IDs
+	uint prop_count;             // number of header attributes
+	size_t* offsets;             // position of each entity's properties
+	NodeID* src;                 // edge source nodes
+	NodeID* dest;                // edge destination nodes
+	GraphEntity* entities;       // created entities
+} BulkBlob;
+
+// a range of entities within a blob, the unit of parallel decoding
+typedef struct {
+	BulkBlob* blob;  // blob holding the entities
+	uint start;      // first entity
+	uint end;        // last entity, exclusive
+} BulkMorsel;
+
+// number of entities decoded by a single task
+#define BULK_MORSEL_SIZE 4096
+
+// read the blob's header, introducing its labels and attributes
+static void _BulkInsert_ReadHeader
+(
+	GraphContext* gc,
+	SchemaType t,
+	BulkBlob* blob
+) {
+	size_t data_idx = 0;
+
+	// read the CSV file header labels and update all schemas
+	blob->label_ids = _BulkInsert_ReadHeaderLabels(gc, t, blob->data,
+			&data_idx);
+
+	// edges can only have one type
+	ASSERT(t == SCHEMA_NODE || array_len(blob->label_ids) == 1);
 
-    // sync node-label matrix
-    Graph_GetNodeLabelMatrix(gc->g);
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
-
-    //--------------------------------------------------------------------------
-    // load nodes
-    //--------------------------------------------------------------------------
-
-	while (data_idx < data_len) {
-		Node n;
-		GraphEntity* ge;
-		Graph_CreateNode(gc->g, &n, label_ids, label_count);
-		ge = (GraphEntity*)&n;
-		// process entity attributes
-		for (uint i = 0; i < prop_count; i++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
-			// skip invalid attribute values
-			if (!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE))
-				continue;
-			GraphEntity_AddProperty(ge, prop_indices[i], value);
+	// read the CSV header properties and collect their indices
+	blob->prop_indices = _BulkInsert_ReadHeaderProperties(gc, t, blob->data,
+			&data_idx, &blob->prop_count);
+
+	blob->body_idx = data_idx;
+}
+
+// locate each entity within the blob
+static void _BulkInsert_ScanBlob
+(
+	SchemaType t,
+	BulkBlob* blob
+) {
+	const char* data = blob->data;
+	size_t data_idx = blob->body_idx;
+
+	blob->offsets = array_new(size_t, 0);
+	if (t == SCHEMA_EDGE) {
+		blob->src  = array_new(NodeID, 0);
+		blob->dest = array_new(NodeID, 0);
+	}
+
+	while (data_idx < blob->data_len) {
+		if (t == SCHEMA_EDGE) {
+			// next 8 bytes are source ID
+			array_append(blob->src, *(NodeID*)&data[data_idx]);
+			data_idx += sizeof(NodeID);
+			// next 8 bytes are destination ID
+			array_append(blob->dest, *(NodeID*)&data[data_idx]);
+			data_idx += sizeof(NodeID);
+		}
+
+		array_append(blob->offsets, data_idx);
+		for (uint i = 0; i < blob->prop_count; i++) {
+			_BulkInsert_SkipProperty(data, &data_idx);
 		}
 	}
+}
+
+// create the blob's entities
+// entities are created in stream order, assigned IDs are the same as if
+// each entity was created individually
+static void _BulkInsert_CreateEntities
+(
+	GraphContext* gc,
+	SchemaType t,
+	BulkBlob* blob
+) {
+	Graph* g = gc->g;
+	uint n = array_len(blob->offsets);
+	uint label_count = array_len(blob->label_ids);
+
+	if (t == SCHEMA_NODE) {
+		Node* nodes = rm_malloc(sizeof(Node) * n);
+		Graph_CreateNodes(g, blob->label_ids, label_count, nodes, n);
+		blob->entities = (GraphEntity*)nodes;
+	} else {
+		Edge* edges = rm_malloc(sizeof(Edge) * n);
+		Edge** edge_ptrs = rm_malloc(sizeof(Edge*) * n);
+		for (uint i = 0; i < n; i++) edge_ptrs[i] = edges + i;
+
+		Graph_CreateEdges(g, blob->label_ids[0], blob->src, blob->dest,
+				edge_ptrs, n);
+
+		rm_free(edge_ptrs);
+		blob->entities = (GraphEntity*)edges;
+	}
+}
+
+// decode the properties of entities [start, end) of the blob
+static void _BulkInsert_DecodeProperties
+(
+	GraphContext* gc,
+	SchemaType t,
+	BulkMorsel* morsel,
+	pthread_mutex_t* lock
+) {
+	BulkBlob* blob = morsel->blob;
+	uint prop_count = blob->prop_count;
+	if (prop_count == 0) return;
+
+	SIValue values[prop_count];
+	size_t entity_size = (t == SCHEMA_NODE) ? sizeof(Node) : sizeof(Edge);
+
+	for (uint i = morsel->start; i < morsel->end; i++) {
+		GraphEntity* ge = (GraphEntity*)((char*)blob->entities + i * entity_size);
+		size_t data_idx = blob->offsets[i];
+
+		for (uint j = 0; j < prop_count; j++) {
+			values[j] = _BulkInsert_ReadProperty(blob->data, &data_idx);
+			if (SI_TYPE(values[j]) == T_STRING) {
+				// string pool and cold storage aren't thread-safe
+				pthread_mutex_lock(lock);
+				GraphContext_PreparePropertyValue(gc, values + j);
+				pthread_mutex_unlock(lock);
+			}
+		}
+
+		// invalid attribute values are skipped
+		GraphEntity_AddProperties(ge, blob->prop_indices, values, prop_count);
 
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
-    if (prop_indices) rm_free(prop_indices);
-    array_free(label_ids);
+		for (uint j = 0; j < prop_count; j++) SIValue_Free(values[j]);
+	}
+}
 
-    return BULK_OK;
+static void _BulkInsert_FreeBlob
+(
+	BulkBlob* blob
+) {
+	array_free(blob->label_ids);
+	if (blob->prop_indices) rm_free(blob->prop_indices);
+	if (blob->offsets) array_free(blob->offsets);
+	if (blob->src) array_free(blob->src);
+	if (blob->dest) array_free(blob->dest);
+	if (blob->entities) rm_free(blob->entities);
 }
 
-static int _BulkInsert_ProcessEdgeFile
+// process blobs of the same type, returns the number of created entities
+// expects the graph to be write locked with a resize sync policy
+static uint64_t _BulkInsert_ProcessBlobs
 (
 	GraphContext* gc,
-	const char* data,
-	size_t data_len
+	BulkBlob* blobs,
+	int token_count,
+	SchemaType type
 ) {
-    int relation_id;
-    uint prop_count;
-    size_t data_idx = 0;
-
-    // read the CSV file header
-    // and commit all labels and properties it introduces
-    int* type_ids = _BulkInsert_ReadHeaderLabels(gc, SCHEMA_EDGE, data, &data_idx);
-    uint type_count = array_len(type_ids);
-
-    // edges can only have one type
-    ASSERT(type_count == 1);
-
-    int type_id = type_ids[0];
-    Attribute_ID* prop_indices = _BulkInsert_ReadHeaderProperties(gc, SCHEMA_EDGE,
-	data, &data_idx, &prop_count);
-
-    // sync matrix once
-    ASSERT(Graph_GetMatrixPolicy(gc->g) == SYNC_POLICY_RESIZE);
-    Graph_GetRelationMatrix(gc->g, type_id, false);
-    Graph_GetAdjacencyMatrix(gc->g, false);
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
-
-    //--------------------------------------------------------------------------
-    // load edges
-    //--------------------------------------------------------------------------
-
-	while (data_idx < data_len) {
-		Edge e;
-		GraphEntity* ge;
-
-		// next 8 bytes are source ID
-		NodeID src = *(NodeID*)&data[data_idx];
-		data_idx += sizeof(NodeID);
-		// next 8 bytes are destination ID
-		NodeID dest = *(NodeID*)&data[data_idx];
-		data_idx += sizeof(NodeID);
-
-		Graph_CreateEdge(gc->g, src, dest, type_id, &e);
-		ge = (GraphEntity*)&e;
-
-		// process entity attributes
-		for (uint i = 0; i < prop_count; i++) {
-			SIValue value = _BulkInsert_ReadProperty(data, &data_idx);
-			// skip invalid attribute values
-			if (!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) {
-				continue;
+	Graph* g = gc->g;
+
+	uint nthreads;
+	Config_Option_get(Config_OPENMP_NTHREAD, &nthreads);
+
+	// schemas and attributes are introduced sequentially
+	for (int i = 0; i < token_count; i++) {
+		_BulkInsert_ReadHeader(gc, type, blobs + i);
+	}
+
+	#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 1)
+	for (int i = 0; i < token_count; i++) {
+		_BulkInsert_ScanBlob(type, blobs + i);
+	}
+
+	uint64_t entity_count = 0;
+	for (int i = 0; i < token_count; i++) {
+		entity_count += array_len(blobs[i].offsets);
+	}
+	if (type == SCHEMA_NODE) Graph_AllocateNodes(g, entity_count);
+	else Graph_AllocateEdges(g, entity_count);
+
+	// sync each matrix once
+	ASSERT(Graph_GetMatrixPolicy(g) == SYNC_POLICY_RESIZE);
+	for (int i = 0; i < token_count; i++) {
+		uint label_count = array_len(blobs[i].label_ids);
+		for (uint j = 0; j < label_count; j++) {
+			if (type == SCHEMA_NODE) {
+				Graph_GetLabelMatrix(g, blobs[i].label_ids[j]);
+			} else {
+				Graph_GetRelationMatrix(g, blobs[i].label_ids[j], false);
 			}
+		}
+	}
+	if (type == SCHEMA_NODE) Graph_GetNodeLabelMatrix(g);
+	else Graph_GetAdjacencyMatrixForUpdate(g);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
 
-			GraphEntity_AddProperty(ge, prop_indices[i], value);
+	// split entities into morsels
+	BulkMorsel* morsels = array_new(BulkMorsel, token_count);
+	for (int i = 0; i < token_count; i++) {
+		_BulkInsert_CreateEntities(gc, type, blobs + i);
+
+		uint n = array_len(blobs[i].offsets);
+		for (uint start = 0; start < n; start += BULK_MORSEL_SIZE) {
+			uint end = (n - start > BULK_MORSEL_SIZE) ? start + BULK_MORSEL_SIZE : n;
+			BulkMorsel morsel = {.blob = blobs + i, .start = start, .end = end};
+			array_append(morsels, morsel);
 		}
 	}
 
-    array_free(type_ids);
-    if (prop_indices) rm_free(prop_indices);
-    Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_RESIZE);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+
+	pthread_mutex_t lock;
+	pthread_mutex_init(&lock, NULL);
+
+	int morsel_count = array_len(morsels);
+	#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 1)
+	for (int i = 0; i < morsel_count; i++) {
+		_BulkInsert_DecodeProperties(gc, type, morsels + i, &lock);
+	}
+
+	pthread_mutex_destroy(&lock);
+
+	for (int i = 0; i < token_count; i++) _BulkInsert_FreeBlob(blobs + i);
+	array_free(morsels);
 
-    return BULK_OK;
+	return entity_count;
 }
 
 static int _BulkInsert_ProcessTokens
@@ -318,18 +490,161 @@ static int _BulkInsert_ProcessTokens
 	RedisModuleString** argv,
 	SchemaType type
 ) {
+	BulkBlob* blobs = rm_calloc(token_count, sizeof(BulkBlob));
+
 	for (int i = 0; i < token_count; i++) {
-		size_t len;
 		// retrieve a pointer to the next binary stream and record its length
-		const char* data = RedisModule_StringPtrLen(argv[i], &len);
-		int rc = (type == SCHEMA_NODE)
-			? _BulkInsert_ProcessNodeFile(gc, data, len)
-			: _BulkInsert_ProcessEdgeFile(gc, data, len);
-		UNUSED(rc);
-		ASSERT(rc == BULK_OK);
+		blobs[i].data = RedisModule_StringPtrLen(argv[i], &blobs[i].data_len);
+	}
+
+	_BulkInsert_ProcessBlobs(gc, blobs, token_count, type);
+	rm_free(blobs);
+
+	return BULK_OK;
+}
+
+// skip over an SIValue of at most 'len' bytes
+// returns false if the value is incomplete or malformed
+static bool _BulkInsert_SkipPropertyBounded
+(
+	const char* data,
+	size_t len,
+	size_t* data_idx,
+	bool* malformed
+) {
+	int64_t n;
+	const char* end;
+
+	if (*data_idx >= len) return false;
+	TYPE t = data[*data_idx];
+	*data_idx += 1;
+
+	switch (t) {
+		case BI_NULL:
+			return true;
+
+		case BI_BOOL:
+			*data_idx += 1;
+			return *data_idx <= len;
+
+		case BI_DOUBLE:
+			*data_idx += sizeof(double);
+			return *data_idx <= len;
+
+		case BI_LONG:
+			*data_idx += sizeof(int64_t);
+			return *data_idx <= len;
+
+		case BI_STRING:
+			end = memchr(data + *data_idx, '\0', len - *data_idx);
+			if (end == NULL) return false;
+			*data_idx = end - data + 1;
+			return true;
+
+		case BI_ARRAY:
+			if (*data_idx + sizeof(int64_t) > len) return false;
+			n = *(int64_t*)&data[*data_idx];
+			*data_idx += sizeof(int64_t);
+			if (n < 0) {
+				*malformed = true;
+				return false;
+			}
+			for (int64_t i = 0; i < n; i++) {
+				if (!_BulkInsert_SkipPropertyBounded(data, len, data_idx,
+							malformed)) {
+					return false;
+				}
+			}
+			return true;
+
+		default:
+			*malformed = true;
+			return false;
+	}
+}
+
+size_t BulkInsert_HeaderLength
+(
+	const char* data,
+	size_t len,
+	uint* prop_count
+) {
+	ASSERT(data        !=  NULL);
+	ASSERT(prop_count  !=  NULL);
+
+	// entity label(s)
+	const char* end = memchr(data, '\0', len);
+	if (end == NULL) return 0;
+	size_t data_idx = end - data + 1;
+
+	// property count
+	if (data_idx + sizeof(uint) > len) return 0;
+	*prop_count = *(uint*)&data[data_idx];
+	data_idx += sizeof(uint);
+
+	// property keys
+	for (uint i = 0; i < *prop_count; i++) {
+		if (data_idx >= len) return 0;
+		end = memchr(data + data_idx, '\0', len - data_idx);
+		if (end == NULL) return 0;
+		data_idx = end - data + 1;
+	}
+
+	return data_idx;
+}
+
+size_t BulkInsert_EntitiesLength
+(
+	const char* data,
+	size_t len,
+	SchemaType t,
+	uint prop_count,
+	bool* malformed
+) {
+	ASSERT(data       !=  NULL);
+	ASSERT(malformed  !=  NULL);
+
+	*malformed = false;
+	size_t complete = 0;
+	size_t data_idx = 0;
+
+	while (data_idx < len) {
+		// edges start with their source and destination IDs
+		if (t == SCHEMA_EDGE) data_idx += 2 * sizeof(NodeID);
+
+		uint i = 0;
+		for (; i < prop_count; i++) {
+			if (!_BulkInsert_SkipPropertyBounded(data, len, &data_idx,
+						malformed)) {
+				break;
+			}
+		}
+
+		if (*malformed || i < prop_count || data_idx > len) break;
+		complete = data_idx;
 	}
 
-    return BULK_OK;
+	return complete;
+}
+
+uint64_t BulkInsert_Stream
+(
+	GraphContext* gc,
+	SchemaType t,
+	const char* data,
+	size_t len
+) {
+	ASSERT(gc    !=  NULL);
+	ASSERT(data  !=  NULL);
+
+	Graph* g = gc->g;
+	BulkBlob blob = {.data = data, .data_len = len};
+
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+	uint64_t entity_count = _BulkInsert_ProcessBlobs(gc, &blob, 1, t);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+
+	return entity_count;
 }
 
 int BulkInsert
@@ -10,6 +10,7 @@
 #include "../redismodule.h"
 #include "../graph/graph.h"
 #include "../graph/graphcontext.h"
+#include "../schema/schema.h"
 
 #define BULK_OK 1
 #define BULK_FAIL 0
@@ -30,5 +31,35 @@ int BulkInsert(
 	uint edge_count             // Number of edges to be created.
 );
 
+/* Returns the length of the binary stream header held by 'data'
+ * sets 'prop_count' to the number of properties each entity holds
+ * returns 0 if 'data' doesn't hold a complete header */
+size_t BulkInsert_HeaderLength(
+	const char *data,           // binary stream
+	size_t len,                 // binary stream length
+	uint *prop_count            // [output] number of properties per entity
+);
+
+/* Returns the length of the longest prefix of 'data' holding complete
+ * entities, 'data' is expected to start at an entity
+ * sets 'malformed' if 'data' holds an invalid value */
+size_t BulkInsert_EntitiesLength(
+	const char *data,           // entities
+	size_t len,                 // entities length
+	SchemaType t,               // entities type
+	uint prop_count,            // number of properties per entity
+	bool *malformed             // [output] true if data is malformed
+);
+
+/* Inserts the entities of a single binary stream, a header followed by
+ * complete entities, expects the graph to be write locked
+ * returns the number of created entities */
+uint64_t BulkInsert_Stream(
+	GraphContext *gc,           // GraphContext hosting schemas and Graph.
+	SchemaType t,               // entities type
+	const char *data,           // binary stream
+	size_t len                  // binary stream length
+);
+
 #endif
 
@@ -101,6 +101,7 @@ int Graph_BulkInsert(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	}
 
 	// successful bulk commands should always modify slaves
+	GraphContext_AdvanceCommitSeq(gc);
 	RedisModule_ReplicateVerbatim(ctx);
 
 	// replay to caller
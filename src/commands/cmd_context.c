@@ -7,7 +7,9 @@
 #include "cmd_context.h"
 #include "RG.h"
 #include "../query_ctx.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../util/thpool/pools.h"
 #include "../slow_log/slow_log.h"
 
@@ -25,19 +27,29 @@ CommandCtx *CommandCtx_New
 	GraphContext *graph_ctx,
 	ExecutorThread thread,
 	bool replicated_command,
-	bool compact,
+	ResultSetFormatterType format,
 	long long timeout
 ) {
 	CommandCtx *context = rm_malloc(sizeof(CommandCtx));
 	context->bc = bc;
 	context->ctx = ctx;
 	context->query = NULL;
+	context->queries = NULL;
+	context->params = NULL;
+	context->binary_params = NULL;
+	context->binary_params_len = 0;
+	context->min_commit_seq = 0;
+	context->statement = NULL;
+	context->args = NULL;
+	context->view = NULL;
+	context->read_locked = false;
 	context->thread = thread;
-	context->compact = compact;
+	context->format = format;
 	context->timeout = timeout;
 	context->command_name = NULL;
 	context->graph_ctx = graph_ctx;
 	context->replicated_command = replicated_command;
+	simple_tic(context->timer);
 
 	if(cmd_name) {
 		// Make a copy of command name.
@@ -54,6 +66,119 @@ CommandCtx *CommandCtx_New
 	return context;
 }
 
+CommandCtx *CommandCtx_NewBatched
+(
+	CommandCtx *batch,
+	const char *query
+) {
+	ASSERT(batch != NULL);
+	ASSERT(query != NULL);
+
+	// each batched query releases its own graph reference
+	GraphContext_Retain(batch->graph_ctx);
+
+	// replies are issued through the batch context,
+	// only the batch unblocks its client
+	CommandCtx *context = CommandCtx_New(CommandCtx_GetRedisCtx(batch), NULL,
+			NULL, NULL, batch->graph_ctx, batch->thread,
+			batch->replicated_command, batch->format, batch->timeout);
+
+	context->read_locked = true;
+	context->query = rm_strdup(query);
+	if(batch->binary_params != NULL) {
+		context->binary_params = rm_malloc(batch->binary_params_len);
+		context->binary_params_len = batch->binary_params_len;
+		memcpy(context->binary_params, batch->binary_params,
+				batch->binary_params_len);
+	}
+	context->command_name = rm_strdup(batch->command_name);
+
+	return context;
+}
+
+void CommandCtx_AddQuery
+(
+	CommandCtx *ctx,
+	RedisModuleString *query
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(query != NULL);
+
+	if(ctx->queries == NULL) ctx->queries = array_new(char *, 1);
+	const char *q = RedisModule_StringPtrLen(query, NULL);
+	array_append(ctx->queries, rm_strdup(q));
+}
+
+void CommandCtx_SetStatement
+(
+	CommandCtx *ctx,
+	PreparedStatement *statement,
+	RedisModuleString **params,
+	int nparams
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(statement != NULL);
+	ASSERT(ctx->query == NULL);
+	ASSERT(nparams >= 0);
+
+	ctx->params = array_new(char *, nparams);
+	for(int i = 0; i < nparams; i++) {
+		const char *p = RedisModule_StringPtrLen(params[i], NULL);
+		array_append(ctx->params, rm_strdup(p));
+	}
+	ctx->statement = statement;
+	// the statement's query is reported by the slowlog and query stats
+	ctx->query = rm_strdup(PreparedStatement_Query(statement));
+}
+
+void CommandCtx_SetArgs
+(
+	CommandCtx *ctx,
+	RedisModuleString **args,
+	int nargs
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(nargs >= 0);
+	ASSERT(ctx->args == NULL);
+
+	ctx->args = array_new(char *, nargs);
+	for(int i = 0; i < nargs; i++) {
+		const char *arg = RedisModule_StringPtrLen(args[i], NULL);
+		array_append(ctx->args, rm_strdup(arg));
+	}
+}
+
+void CommandCtx_SetView
+(
+	CommandCtx *ctx,
+	MaterializedView *view
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(view != NULL);
+	ASSERT(ctx->query == NULL);
+
+	ctx->view = view;
+	// the view's query is reported by the slowlog and query stats
+	ctx->query = rm_strdup(MaterializedView_Query(view));
+}
+
+void CommandCtx_SetBinaryParams
+(
+	CommandCtx *ctx,
+	RedisModuleString *params
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(params != NULL);
+	ASSERT(ctx->binary_params == NULL);
+
+	// copied, as arguments are released once the command returns
+	size_t len;
+	const char *buf = RedisModule_StringPtrLen(params, &len);
+	ctx->binary_params = rm_malloc(len);
+	ctx->binary_params_len = len;
+	memcpy(ctx->binary_params, buf, len);
+}
+
 // place given 'ctx' in 'command_ctxs' at position 'tid'
 // representing the current thread
 void CommandCtx_TrackCtx(CommandCtx *ctx) {
@@ -142,6 +267,11 @@ void CommandCtx_Free(CommandCtx *command_ctx) {
 	CommandCtx_UntrackCtx(command_ctx);
 
 	if(command_ctx->query) rm_free(command_ctx->query);
+	array_free_cb(command_ctx->queries, rm_free);
+	if(command_ctx->binary_params) rm_free(command_ctx->binary_params);
+	array_free_cb(command_ctx->params, rm_free);
+	array_free_cb(command_ctx->args, rm_free);
+	if(command_ctx->view) MaterializedView_Release(command_ctx->view);
 	rm_free(command_ctx->command_name);
 	rm_free(command_ctx);
 }
@@ -9,25 +9,37 @@
 #include "cypher-parser.h"
 #include "../redismodule.h"
 #include "../graph/graphcontext.h"
+#include "../resultset/formatters/resultset_formatters.h"
 
 // ExecutorThread lists the diffrent types of threads in the system
 typedef enum {
 	EXEC_THREAD_MAIN,    // redis main thread
 	EXEC_THREAD_READER,  // read only thread
 	EXEC_THREAD_WRITER,  // write only thread
+	EXEC_THREAD_HEAVY,   // expensive read only thread
 } ExecutorThread;
 
 /* Query context, used for concurent query processing. */
 typedef struct {
 	char *query;                    // Query string.
+	char **queries;                 // Queries batched by GRAPH.MULTI_RO_QUERY.
 	RedisModuleCtx *ctx;            // Redis module context.
 	char *command_name;             // Command to execute.
 	GraphContext *graph_ctx;        // Graph context.
 	RedisModuleBlockedClient *bc;   // Blocked client.
 	bool replicated_command;        // Whether this instance was spawned by a replication command.
-	bool compact;                   // Whether this query was issued with the compact flag.
+	ResultSetFormatterType format;  // Reply format, set by the --compact, --arrow and --json flags.
 	ExecutorThread thread;          // Which thread executes this command
 	long long timeout;              // The query timeout, if specified.
+	double timer[2];                // Time since the command was last queued.
+	bool read_locked;               // Graph read lock is held by the issuing batch.
+	PreparedStatement *statement;   // Statement executed by GRAPH.EXECUTE.
+	char **params;                  // Unparsed name, type and value triples bound to the executed statement.
+	char *binary_params;            // MessagePack encoded parameters, NULL if none.
+	size_t binary_params_len;       // Length of binary_params.
+	uint64_t min_commit_seq;        // Graph commit sequence to wait for, set by the min_version flag.
+	char **args;                    // Subcommand and its arguments, e.g. GRAPH.VIEW CREATE.
+	MaterializedView *view;         // View read by GRAPH.VIEW READ.
 } CommandCtx;
 
 // Create a new command context.
@@ -40,10 +52,59 @@ CommandCtx *CommandCtx_New
 	GraphContext *graph_ctx,        // Graph context.
 	ExecutorThread thread,          // Which thread executes this command
 	bool replicated_command,        // Whether this instance was spawned by a replication command.
-	bool compact,                   // Whether this query was issued with the compact flag.
+	ResultSetFormatterType format,  // Reply format, set by the --compact, --arrow and --json flags.
 	long long timeout               // The query timeout, if specified.
 );
 
+// Create a context for a query batched by 'batch'.
+// The query replies through the batch's Redis context and executes under
+// the graph read lock held by the batch.
+CommandCtx *CommandCtx_NewBatched
+(
+	CommandCtx *batch,  // Batch command context.
+	const char *query   // Query string.
+);
+
+// Append 'query' to the queries batched by 'ctx'.
+void CommandCtx_AddQuery
+(
+	CommandCtx *ctx,          // Command context.
+	RedisModuleString *query  // Query string.
+);
+
+// Bind prepared 'statement' and its parameters to the command context.
+// Parameters are copied as is and parsed by the executing thread.
+void CommandCtx_SetStatement
+(
+	CommandCtx *ctx,               // Command context.
+	PreparedStatement *statement,  // Statement to execute.
+	RedisModuleString **params,    // Name, type and value triples.
+	int nparams                    // Number of arguments in 'params'.
+);
+
+// Set the subcommand and its arguments.
+// Arguments are copied, as they are released once the command returns.
+void CommandCtx_SetArgs
+(
+	CommandCtx *ctx,             // Command context.
+	RedisModuleString **args,    // Subcommand and its arguments.
+	int nargs                    // Number of arguments in 'args'.
+);
+
+// Bind 'view' to the command context, taking ownership over the reference.
+void CommandCtx_SetView
+(
+	CommandCtx *ctx,          // Command context.
+	MaterializedView *view    // View to read.
+);
+
+// Set the MessagePack encoded parameters passed via the params flag.
+void CommandCtx_SetBinaryParams
+(
+	CommandCtx *ctx,           // Command context.
+	RedisModuleString *params  // Encoded parameters.
+);
+
 // Tracks given 'ctx' such that in case of a crash we will be able to report
 // back all of the currently running commands
 void CommandCtx_TrackCtx(CommandCtx *ctx);
@@ -0,0 +1,65 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "./cmd_context.h"
+#include "../graph/graph.h"
+#include "../graph/graph_copy.h"
+#include "../graph/graphcontext.h"
+#include "../query_ctx.h"
+
+// GraphContext type as it is registered at Redis.
+extern RedisModuleType *GraphContextRedisModuleType;
+
+/* Copy graph to a new key, the copy is built in memory
+ * out of the source graph without going through an RDB encoding.
+ * GRAPH.COPY <source> <destination> */
+int Graph_Copy(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	int res = REDISMODULE_OK;
+	char *strElapsed = NULL;
+	QueryCtx_BeginTimer(); // Start copy timing.
+
+	RedisModuleString *src_name = argv[1];
+	RedisModuleString *dst_name = argv[2];
+	GraphContext *gc = GraphContext_Retrieve(ctx, src_name, true, false);    // Increase ref count.
+	// If the GraphContext is null, key access failed and an error has been emitted.
+	if(!gc) {
+		res = REDISMODULE_ERR;
+		goto cleanup;
+	}
+
+	RedisModuleKey *key = RedisModule_OpenKey(ctx, dst_name, REDISMODULE_WRITE);
+	if(RedisModule_KeyType(key) != REDISMODULE_KEYTYPE_EMPTY) {
+		RedisModule_CloseKey(key);
+		GraphContext_Release(gc);
+		RedisModule_ReplyWithError(ctx, "ERR destination key already exists");
+		goto cleanup;
+	}
+
+	// writers may be modifying the source graph on the writer thread
+	Graph_AcquireReadLock(gc->g);
+	GraphContext *copy = GraphContext_Copy(gc,
+			RedisModule_StringPtrLen(dst_name, NULL));
+	Graph_ReleaseLock(gc->g);
+
+	RedisModule_ModuleTypeSetValue(key, GraphContextRedisModuleType, copy);
+	GraphContext_RegisterWithModule(copy);
+	RedisModule_CloseKey(key);
+	GraphContext_Release(gc);   // Decrease graph ref count.
+
+	double t = QueryCtx_GetExecutionTime();
+	asprintf(&strElapsed, "Graph copied, internal execution time: %.6f milliseconds", t);
+	RedisModule_ReplyWithStringBuffer(ctx, strElapsed, strlen(strElapsed));
+
+	// Replicas copy their own source graph.
+	RedisModule_ReplicateVerbatim(ctx);
+
+cleanup:
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+	if(strElapsed) free(strElapsed);
+	return res;
+}
@@ -7,37 +7,99 @@
 #include "RG.h"
 #include "commands.h"
 #include "cmd_context.h"
+#include "../query_ctx.h"
 #include "../util/thpool/pools.h"
 #include "../configuration/config.h"
+#include "../arithmetic/arithmetic_expression.h"
 
 #define GRAPH_VERSION_MISSING -1
 
 // Command handler function pointer.
 typedef void(*Command_Handler)(void *args);
 
+// Returns true if 'arg' is a configuration flag.
+static bool _is_flag(RedisModuleString *arg) {
+	const char *s = RedisModule_StringPtrLen(arg, NULL);
+	return (!strcasecmp(s, "--compact") || !strcasecmp(s, "--arrow") ||
+			!strcasecmp(s, "--json") ||
+			!strcasecmp(s, "version") || !strcasecmp(s, "timeout") ||
+			!strcasecmp(s, "min_version") || !strcasecmp(s, "params"));
+}
+
+// Index of the first configuration flag.
+// GRAPH.MULTI_RO_QUERY <GRAPH_KEY> <QUERY> [<QUERY> ...] [FLAGS]
+// batches queries up to the first flag
+// GRAPH.EXECUTE <GRAPH_KEY> <HANDLE> [<NAME> <TYPE> <VALUE> ...] [FLAGS]
+// binds parameters up to the first flag
+// GRAPH.VIEW <GRAPH_KEY> CREATE <NAME> <QUERY>
+// GRAPH.VIEW <GRAPH_KEY> READ|DROP <NAME> [FLAGS]
+// other commands accept a single query.
+static int _flags_offset(GRAPH_Commands cmd, RedisModuleString **argv,
+		int argc) {
+	int i = 2;
+	if(cmd == CMD_MULTI_RO_QUERY) {
+		while(i < argc && !_is_flag(argv[i])) i++;
+	} else if(cmd == CMD_EXECUTE) {
+		i = 3;
+		while(i < argc && !_is_flag(argv[i])) i += 3;
+	} else if(cmd == CMD_VIEW) {
+		const char *sub = RedisModule_StringPtrLen(argv[2], NULL);
+		i = (strcasecmp(sub, "CREATE") == 0) ? 5 : 4;
+	} else {
+		i = 3;
+	}
+	return i;
+}
+
+// Add queries batched by GRAPH.MULTI_RO_QUERY to the command context.
+static void _batch_queries(CommandCtx *context, GRAPH_Commands cmd,
+		RedisModuleString **argv, int offset) {
+	if(cmd != CMD_MULTI_RO_QUERY) return;
+	for(int i = 2; i < offset; i++) CommandCtx_AddQuery(context, argv[i]);
+}
+
 // Read configuration flags, returning REDIS_MODULE_ERR if flag parsing failed.
-static int _read_flags(RedisModuleString **argv, int argc, bool *compact,
-					   long long *timeout, uint *graph_version, char **errmsg) {
+static int _read_flags(RedisModuleString **argv, int argc, int offset,
+					   ResultSetFormatterType *format,
+					   long long *timeout, uint *graph_version,
+					   uint64_t *min_commit_seq,
+					   RedisModuleString **binary_params, char **errmsg) {
 
-	ASSERT(compact);
+	ASSERT(format);
 	ASSERT(timeout);
+	ASSERT(min_commit_seq);
+	ASSERT(binary_params);
 
 	// set defaults
-	*compact = false;  // verbose
+	*format = FORMATTER_VERBOSE;
+	*binary_params = NULL;
+	*min_commit_seq = 0;
 	*graph_version = GRAPH_VERSION_MISSING;
 	Config_Option_get(Config_TIMEOUT, timeout);
 
 	// GRAPH.QUERY <GRAPH_KEY> <QUERY>
-	// make sure we've got more than 3 arguments
-	if(argc <= 3) return REDISMODULE_OK;
+	// make sure we've got arguments following the query
+	if(argc <= offset) return REDISMODULE_OK;
 
 	// scan arguments
-	for(int i = 3; i < argc; i++) {
+	for(int i = offset; i < argc; i++) {
 		const char *arg = RedisModule_StringPtrLen(argv[i], NULL);
 
 		// compact result-set
 		if(!strcasecmp(arg, "--compact")) {
-			*compact = true;
+			*format = FORMATTER_COMPACT;
+			continue;
+		}
+
+		// columnar result-set, Arrow IPC streams
+		if(!strcasecmp(arg, "--arrow")) {
+			*format = FORMATTER_ARROW;
+			continue;
+		}
+
+		// JSON result-set
+		if(!strcasecmp(arg, "--json")) {
+			*format = FORMATTER_JSON;
 			continue;
 		}
 
@@ -59,6 +121,25 @@ static int _read_flags(RedisModuleString **argv, int argc, bool *compact,
 			continue;
 		}
 
+		// commit sequence the graph must reach before the query executes
+		if(!strcasecmp(arg, "min_version")) {
+			long long v = -1;
+			int err = REDISMODULE_ERR;
+			if(i < argc - 1) {
+				i++; // Set the current argument to the sequence value.
+				err = RedisModule_StringToLongLong(argv[i], &v);
+			}
+
+			// Emit error on missing, negative, or non-numeric sequence values.
+			if(err != REDISMODULE_OK || v < 0) {
+				asprintf(errmsg, "Failed to parse min version value");
+				return REDISMODULE_ERR;
+			}
+
+			*min_commit_seq = v;
+			continue;
+		}
+
 		// query timeout
 		if(!strcasecmp(arg, "timeout")) {
 			int err = REDISMODULE_ERR;
@@ -72,6 +153,19 @@ static int _read_flags(RedisModuleString **argv, int argc, bool *compact,
 				asprintf(errmsg, "Failed to parse query timeout value");
 				return REDISMODULE_ERR;
 			}
+
+			continue;
+		}
+
+		// MessagePack encoded parameters, decoded by the executing thread
+		if(!strcasecmp(arg, "params")) {
+			if(i == argc - 1) {
+				asprintf(errmsg, "Failed to parse query parameters value");
+				return REDISMODULE_ERR;
+			}
+
+			i++; // Set the current argument to the parameters value.
+			*binary_params = argv[i];
 		}
 	}
 	return REDISMODULE_OK;
@@ -99,8 +193,27 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 		case CMD_EXPLAIN:
 		case CMD_PROFILE:
 			// Expect a command, graph name, a query, and optional config flags.
-			return arity >= 3 && arity <= 8;
+			return arity >= 3 && arity <= 10;
+		case CMD_MULTI_RO_QUERY:
+			// Expect a command, graph name, queries, and optional config flags.
+			return arity >= 3;
+		case CMD_PREPARE:
+			// Expect a command, graph name and a query.
+			return arity == 3;
+		case CMD_EXECUTE:
+			// Expect a command, graph name, a handle, parameters,
+			// and optional config flags.
+			return arity >= 3;
+		case CMD_VIEW:
+			// Expect a command, graph name, a subcommand, a view name,
+			// an optional query and optional config flags.
+			return arity >= 4;
 		case CMD_SLOWLOG:
+			// Expect a command, graph name and an optional subcommand.
+			return arity == 2 || arity == 3;
+		case CMD_PLANSTATS:
+		case CMD_MEMORY:
+		case CMD_MATRICES:
 			// Expect just a command and graph name.
 			return arity == 2;
 		default:
@@ -114,13 +227,26 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 	switch(cmd) {
 		case CMD_QUERY:
 		case CMD_RO_QUERY:
+		case CMD_EXECUTE:
 			return Graph_Query;
+		case CMD_MULTI_RO_QUERY:
+			return Graph_MultiQuery;
+		case CMD_PREPARE:
+			return Graph_Prepare;
+		case CMD_VIEW:
+			return Graph_View;
 		case CMD_EXPLAIN:
 			return Graph_Explain;
 		case CMD_PROFILE:
 			return Graph_Profile;
 		case CMD_SLOWLOG:
 			return Graph_Slowlog;
+		case CMD_PLANSTATS:
+			return Graph_PlanStats;
+		case CMD_MEMORY:
+			return Graph_Memory;
+		case CMD_MATRICES:
+			return Graph_Matrices;
 		default:
 			ASSERT(false);
 	}
@@ -131,9 +257,16 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 static GRAPH_Commands determine_command(const char *cmd_name) {
 	if(strcasecmp(cmd_name, "graph.QUERY")    == 0) return CMD_QUERY;
 	if(strcasecmp(cmd_name, "graph.RO_QUERY") == 0) return CMD_RO_QUERY;
+	if(strcasecmp(cmd_name, "graph.MULTI_RO_QUERY") == 0) return CMD_MULTI_RO_QUERY;
+	if(strcasecmp(cmd_name, "graph.PREPARE")  == 0) return CMD_PREPARE;
+	if(strcasecmp(cmd_name, "graph.EXECUTE")  == 0) return CMD_EXECUTE;
+	if(strcasecmp(cmd_name, "graph.VIEW")     == 0) return CMD_VIEW;
 	if(strcasecmp(cmd_name, "graph.EXPLAIN")  == 0) return CMD_EXPLAIN;
 	if(strcasecmp(cmd_name, "graph.PROFILE")  == 0) return CMD_PROFILE;
 	if(strcasecmp(cmd_name, "graph.SLOWLOG")  == 0) return CMD_SLOWLOG;
+	if(strcasecmp(cmd_name, "graph.PLANSTATS") == 0) return CMD_PLANSTATS;
+	if(strcasecmp(cmd_name, "graph.MEMORY")   == 0) return CMD_MEMORY;
+	if(strcasecmp(cmd_name, "graph.MATRICES") == 0) return CMD_MATRICES;
 
 	// we shouldn't reach this point
 	ASSERT(false);
@@ -144,10 +277,17 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 	switch(cmd) {
 		case CMD_QUERY:
 		case CMD_RO_QUERY:
+		case CMD_MULTI_RO_QUERY:
+		case CMD_PREPARE:
 		case CMD_EXPLAIN:
 		case CMD_PROFILE:
 			return true;
+		case CMD_EXECUTE:
+		case CMD_VIEW:
 		case CMD_SLOWLOG:
+		case CMD_PLANSTATS:
+		case CMD_MEMORY:
+		case CMD_MATRICES:
 			return false;
 		default:
 			ASSERT(false);
@@ -157,20 +297,32 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	char *errmsg;
-	bool compact;
+	ResultSetFormatterType format;
+	RedisModuleString *binary_params;
 	uint version;
 	long long timeout;
+	uint64_t min_commit_seq;
 	CommandCtx *context = NULL;
 
 	RedisModuleString *graph_name = argv[1];
-	RedisModuleString *query = (argc > 2) ? argv[2] : NULL;
 	const char *command_name = RedisModule_StringPtrLen(argv[0], NULL);
 	GRAPH_Commands cmd = determine_command(command_name);
 
 	if(_validate_command_arity(cmd, argc) == false) return RedisModule_WrongArity(ctx);
 
+	// batched queries are added to the command context once created
+	int offset = _flags_offset(cmd, argv, argc);
+	RedisModuleString *query = (argc > 2 && cmd != CMD_MULTI_RO_QUERY &&
+			cmd != CMD_EXECUTE && cmd != CMD_VIEW) ? argv[2] : NULL;
+
+	if(offset == 2) {
+		RedisModule_ReplyWithError(ctx, "Error: no queries to execute.");
+		return REDISMODULE_OK;
+	}
+
 	// parse additional arguments
-	int res = _read_flags(argv, argc, &compact, &timeout, &version, &errmsg);
+	int res = _read_flags(argv, argc, offset, &format, &timeout, &version,
+			&min_commit_seq, &binary_params, &errmsg);
 	if(res == REDISMODULE_ERR) {
 		// emit error and exit if argument parsing failed
 		RedisModule_ReplyWithError(ctx, errmsg);
@@ -193,6 +345,58 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 		return REDISMODULE_OK;
 	}
 
+	// resolve the prepared statement
+	// its parameters are parsed by the executing thread
+	PreparedStatement *statement = NULL;
+	if(cmd == CMD_EXECUTE) {
+		long long handle;
+		const char *err = NULL;
+		if(RedisModule_StringToLongLong(argv[2], &handle) == REDISMODULE_OK) {
+			statement = PreparedStatements_Get(gc->prepared, handle);
+		}
+
+		if(statement == NULL) {
+			err = "Error: unknown prepared statement";
+		} else if(offset > argc) {
+			err = "Error: parameters are expected as name, type and value";
+		}
+
+		if(err != NULL) {
+			RedisModule_ReplyWithError(ctx, err);
+			GraphContext_Release(gc);
+			return REDISMODULE_OK;
+		}
+	}
+
+	// resolve the view being read
+	// views are created and dropped by the executing thread
+	MaterializedView *view = NULL;
+	if(cmd == CMD_VIEW) {
+		const char *sub = RedisModule_StringPtrLen(argv[2], NULL);
+		const char *err = NULL;
+		if(strcasecmp(sub, "READ") == 0) {
+			view = MaterializedViews_Get(gc->views,
+					RedisModule_StringPtrLen(argv[3], NULL));
+			if(view == NULL) err = "Error: unknown view";
+		} else if(strcasecmp(sub, "CREATE") != 0 &&
+				  strcasecmp(sub, "DROP") != 0) {
+			err = "Error: unknown GRAPH.VIEW subcommand";
+		} else if(offset > argc) {
+			err = "Error: GRAPH.VIEW CREATE expects a view name and a query";
+		}
+
+		if(err == NULL && binary_params != NULL) {
+			err = "Error: views don't accept parameters";
+		}
+
+		if(err != NULL) {
+			if(view != NULL) MaterializedView_Release(view);
+			RedisModule_ReplyWithError(ctx, err);
+			GraphContext_Release(gc);
+			return REDISMODULE_OK;
+		}
+	}
+
 	/* Determin query execution context
 	 * queries issued within a LUA script or multi exec block must
 	 * run on Redis main thread, others can run on different threads. */
@@ -209,15 +413,43 @@ int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	if(exec_thread == EXEC_THREAD_MAIN) {
 		// run query on Redis main thread
 		context = CommandCtx_New(ctx, NULL, argv[0], query, gc, exec_thread,
-								 is_replicated, compact, timeout);
+								 is_replicated, format, timeout);
+		_batch_queries(context, cmd, argv, offset);
+		if(statement) {
+			CommandCtx_SetStatement(context, statement, argv + 3, offset - 3);
+		}
+		if(cmd == CMD_VIEW) CommandCtx_SetArgs(context, argv + 2, offset - 2);
+		if(view) CommandCtx_SetView(context, view);
+		if(binary_params) CommandCtx_SetBinaryParams(context, binary_params);
+		context->min_commit_seq = min_commit_seq;
+
+		// a loading server serves queries in between decoding keys
+		// set aside the decoder's thread-local query context
+		QueryCtx *decoding_ctx = NULL;
+		if(flags & REDISMODULE_CTX_FLAGS_LOADING) {
+			decoding_ctx = QueryCtx_GetQueryCtx();
+			QueryCtx_RemoveFromTLS();
+		}
+
 		handler(context);
+
+		if(decoding_ctx) QueryCtx_SetTLS(decoding_ctx);
 	} else {
 		// run query on a dedicated thread
 		RedisModuleBlockedClient *bc = RedisModule_BlockClient(ctx, NULL, NULL, NULL, 0);
 		context = CommandCtx_New(NULL, bc, argv[0], query, gc, exec_thread,
-								 is_replicated, compact, timeout);
+								 is_replicated, format, timeout);
+		_batch_queries(context, cmd, argv, offset);
+		if(statement) {
+			CommandCtx_SetStatement(context, statement, argv + 3, offset - 3);
+		}
+		if(cmd == CMD_VIEW) CommandCtx_SetArgs(context, argv + 2, offset - 2);
+		if(view) CommandCtx_SetView(context, view);
+		if(binary_params) CommandCtx_SetBinaryParams(context, binary_params);
+		context->min_commit_seq = min_commit_seq;
 
-		if(ThreadPools_AddWorkReader(handler, context) == THPOOL_QUEUE_FULL) {
+		// queries are grouped by graph, sharing readers fairly between graphs
+		if(ThreadPools_AddWorkReader(handler, context, gc) == THPOOL_QUEUE_FULL) {
 			// Report an error once our workers thread pool internal queue
 			// is full, this error usually happens when the server is
 			// under heavy load and is unable to catch up
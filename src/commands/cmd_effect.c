@@ -0,0 +1,60 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../query_ctx.h"
+#include "../graph/graph.h"
+#include "../effects/effects.h"
+#include "../graph/graphcontext.h"
+
+// apply the effects of a write query, replicated by the master in place of
+// the query itself, see _QueryCtx_Replicate
+// GRAPH.EFFECT <graph> <effects>
+int Graph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	size_t len;
+	RedisModuleString *graph_name = argv[1];
+	const char *effects = RedisModule_StringPtrLen(argv[2], &len);
+
+	// effects of the query which created the graph create it on the replica
+	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, false, true);
+	// if the GraphContext is null, key access failed and an error has been emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	// index modifications are staged on the query context
+	QueryCtx_SetGraphCtx(gc);
+
+	// running on Redis main thread, GIL is held
+	Graph *g = gc->g;
+	Graph_AcquireWriteLock(g);
+
+	// mirror the master's commit, which releases deleted storage on lock
+	Graph_ReleaseDeletedBlocks(g);
+
+	// matrices are resized as entities are introduced and synced once done
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
+	bool applied = Effects_Apply(gc, effects, len);
+	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+
+	QueryCtx_ApplyIndexChanges();
+	// mirror the master's commit sequence
+	if(applied) GraphContext_AdvanceCommitSeq(gc);
+	Graph_ReleaseLock(g);
+
+	if(applied) {
+		RedisModule_ReplicateVerbatim(ctx);
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		RedisModule_Log(ctx, "warning", "failed to apply effects to graph %s",
+				RedisModule_StringPtrLen(graph_name, NULL));
+		RedisModule_ReplyWithError(ctx, "Malformed effects");
+	}
+
+	GraphContext_Release(gc);
+	QueryCtx_Free(); // reset the QueryCtx and free its allocations
+	return REDISMODULE_OK;
+}
@@ -51,6 +51,12 @@ void Graph_Explain(void *args) {
 	} else if(exec_type == EXECUTION_TYPE_INDEX_DROP) {
 		RedisModule_ReplyWithSimpleString(ctx, "Drop Index");
 		goto cleanup;
+	} else if(exec_type == EXECUTION_TYPE_CONSTRAINT_CREATE) {
+		RedisModule_ReplyWithSimpleString(ctx, "Create Constraint");
+		goto cleanup;
+	} else if(exec_type == EXECUTION_TYPE_CONSTRAINT_DROP) {
+		RedisModule_ReplyWithSimpleString(ctx, "Drop Constraint");
+		goto cleanup;
 	}
 
 	Graph_AcquireReadLock(gc->g);
@@ -0,0 +1,44 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../graph/graphcontext.h"
+#include "../bulk_insert/bulk_export.h"
+#include <unistd.h>
+
+// export a graph into a directory as files in the GRAPH.BULK format
+// the files are written by a forked child, the client is blocked until done
+// GRAPH.EXPORT <graph> <directory>
+int Graph_Export(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc != 3) return RedisModule_WrongArity(ctx);
+
+	const char *dir = RedisModule_StringPtrLen(argv[2], NULL);
+
+	// validate the directory before forking
+	if(access(dir, W_OK | X_OK) != 0) {
+		char *err;
+		asprintf(&err, "Export directory '%s' isn't writable", dir);
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		return REDISMODULE_OK;
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+	// failed to retrieve GraphContext; an error has been emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	char *err = NULL;
+	BulkExport *export = BulkExport_New(dir);
+	if(!BulkExport_Start(export, ctx, gc, &err)) {
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		BulkExport_Free(export);
+	}
+
+	// the child holds its own copy of the graph
+	GraphContext_Release(gc);
+	return REDISMODULE_OK;
+}
@@ -0,0 +1,96 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../graph/graphcontext.h"
+#include "../bulk_insert/bulk_import.h"
+
+// GRAPH.IMPORT <graph> STATUS
+static int _Graph_ImportStatus(RedisModuleCtx *ctx, RedisModuleString *rs_graph_name) {
+	const char *graphname = RedisModule_StringPtrLen(rs_graph_name, NULL);
+	BulkImport_ReplyStatus(ctx, graphname);
+	return REDISMODULE_OK;
+}
+
+// import files holding binary streams in the GRAPH.BULK format into a new graph
+// files are read by the server, the client is blocked until the import is done
+// GRAPH.IMPORT <graph> NODES|RELATIONS <path> [NODES|RELATIONS <path> ...]
+int Graph_Import(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	if(argc < 3) return RedisModule_WrongArity(ctx);
+
+	RedisModuleString *rs_graph_name = argv[1];
+	const char *graphname = RedisModule_StringPtrLen(rs_graph_name, NULL);
+
+	if(argc == 3) {
+		const char *token = RedisModule_StringPtrLen(argv[2], NULL);
+		if(strcasecmp(token, "STATUS") == 0) {
+			return _Graph_ImportStatus(ctx, rs_graph_name);
+		}
+	}
+
+	if((argc - 2) % 2 != 0) return RedisModule_WrongArity(ctx);
+
+	// validate file types before touching the keyspace
+	for(int i = 2; i < argc; i += 2) {
+		const char *token = RedisModule_StringPtrLen(argv[i], NULL);
+		if(strcasecmp(token, "NODES") != 0 &&
+		   strcasecmp(token, "RELATIONS") != 0) {
+			RedisModule_ReplyWithError(ctx,
+					"Expecting NODES or RELATIONS before each file path");
+			return REDISMODULE_OK;
+		}
+	}
+
+	// graph must not exist
+	RedisModuleKey *key = RedisModule_OpenKey(ctx, rs_graph_name,
+			REDISMODULE_READ);
+	RedisModule_CloseKey(key);
+
+	if(key) {
+		char *err;
+		asprintf(&err, "Graph with name '%s' cannot be created, \
+				as key '%s' already exists.", graphname, graphname);
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		return REDISMODULE_OK;
+	}
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, rs_graph_name, false, true);
+	// failed to retrieve GraphContext; an error has been emitted
+	if(gc == NULL) return REDISMODULE_OK;
+
+	// open all files upfront, such that missing files fail the command
+	// before the client is blocked
+	BulkImport *import = BulkImport_New(gc);
+	for(int i = 2; i < argc; i += 2) {
+		const char *token = RedisModule_StringPtrLen(argv[i], NULL);
+		const char *path = RedisModule_StringPtrLen(argv[i + 1], NULL);
+		SchemaType t = (strcasecmp(token, "NODES") == 0) ?
+			SCHEMA_NODE : SCHEMA_EDGE;
+
+		char *err = NULL;
+		if(!BulkImport_AddFile(import, path, t, &err)) {
+			RedisModule_ReplyWithError(ctx, err);
+			free(err);
+			BulkImport_Free(import);
+			GraphContext_Release(gc);
+
+			// remove the graph created by this command
+			key = RedisModule_OpenKey(ctx, rs_graph_name, REDISMODULE_WRITE);
+			RedisModule_DeleteKey(key);
+			RedisModule_CloseKey(key);
+			return REDISMODULE_OK;
+		}
+	}
+
+	RedisModuleBlockedClient *bc = RedisModule_BlockClient(ctx,
+			BulkImport_Reply, NULL, BulkImport_FreePrivData, 0);
+	BulkImport_Start(import, bc);
+
+	// import holds its own reference to the graph
+	GraphContext_Release(gc);
+	return REDISMODULE_OK;
+}
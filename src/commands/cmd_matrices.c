@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_context.h"
+#include "../schema/schema.h"
+
+static inline void _ReplyWithCounter
+(
+	RedisModuleCtx *ctx,
+	const char *name,
+	uint64_t value
+) {
+	RedisModule_ReplyWithSimpleString(ctx, name);
+	RedisModule_ReplyWithLongLong(ctx, value);
+}
+
+// reply with the pending changes, flush and resize counters of
+// each of the graph's relationship matrices
+// GRAPH.MATRICES <graph>
+void Graph_Matrices(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	Graph *g = gc->g;
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	Graph_AcquireReadLock(g);
+
+	int relation_count = Graph_RelationTypeCount(g);
+	RedisModule_ReplyWithArray(ctx, relation_count);
+
+	for(int r = 0; r < relation_count; r++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+		RG_Matrix R = Graph_GetRelationMatrix(g, r, false);
+
+		GrB_Index m_nvals;
+		GrB_Index dp_nvals;
+		GrB_Index dm_nvals;
+		RG_Matrix_component_nvals(&m_nvals, &dp_nvals, &dm_nvals, R);
+		RG_MatrixStats stats = RG_Matrix_stats(R);
+
+		RedisModule_ReplyWithArray(ctx, 8 * 2);
+		RedisModule_ReplyWithSimpleString(ctx, "relationship");
+		RedisModule_ReplyWithStringBuffer(ctx, Schema_GetName(s),
+				strlen(Schema_GetName(s)));
+		_ReplyWithCounter(ctx, "nvals",             m_nvals);
+		_ReplyWithCounter(ctx, "pending_additions", dp_nvals);
+		_ReplyWithCounter(ctx, "pending_deletions", dm_nvals);
+		_ReplyWithCounter(ctx, "flushes",           stats.flushes);
+		_ReplyWithCounter(ctx, "last_flush_us",     stats.last_flush_us);
+		_ReplyWithCounter(ctx, "total_flush_us",    stats.total_flush_us);
+		_ReplyWithCounter(ctx, "resizes",           stats.resizes);
+	}
+
+	Graph_ReleaseLock(g);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,57 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_context.h"
+
+static inline void _ReplyWithComponent
+(
+	RedisModuleCtx *ctx,
+	const char *name,
+	size_t bytes
+) {
+	RedisModule_ReplyWithSimpleString(ctx, name);
+	RedisModule_ReplyWithLongLong(ctx, bytes);
+}
+
+// reply with the number of bytes used by each of the graph's components
+// GRAPH.MEMORY <graph>
+void Graph_Memory(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	GraphMemoryUsage usage;
+	Graph_AcquireReadLock(gc->g);
+	GraphContext_MemoryUsage(gc, &usage);
+	Graph_ReleaseLock(gc->g);
+
+	size_t total = usage.matrices + usage.delta_plus + usage.delta_minus +
+		usage.transposes + usage.node_blocks + usage.edge_blocks +
+		usage.properties + usage.interned_strings + usage.cold_strings +
+		usage.indexes + usage.adjacency_cache + usage.plan_cache +
+		usage.result_cache;
+
+	RedisModule_ReplyWithArray(ctx, 14 * 2);
+	_ReplyWithComponent(ctx, "total",                 total);
+	_ReplyWithComponent(ctx, "matrices",              usage.matrices);
+	_ReplyWithComponent(ctx, "matrices_delta_plus",   usage.delta_plus);
+	_ReplyWithComponent(ctx, "matrices_delta_minus",  usage.delta_minus);
+	_ReplyWithComponent(ctx, "matrices_transposed",   usage.transposes);
+	_ReplyWithComponent(ctx, "node_blocks",           usage.node_blocks);
+	_ReplyWithComponent(ctx, "edge_blocks",           usage.edge_blocks);
+	_ReplyWithComponent(ctx, "properties",            usage.properties);
+	_ReplyWithComponent(ctx, "interned_strings",      usage.interned_strings);
+	_ReplyWithComponent(ctx, "cold_strings",          usage.cold_strings);
+	_ReplyWithComponent(ctx, "indexes",               usage.indexes);
+	_ReplyWithComponent(ctx, "adjacency_cache",       usage.adjacency_cache);
+	_ReplyWithComponent(ctx, "plan_cache",            usage.plan_cache);
+	_ReplyWithComponent(ctx, "result_cache",          usage.result_cache);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,54 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "cmd_context.h"
+#include "execution_ctx.h"
+#include "../util/cache/cache.h"
+
+typedef struct {
+	RedisModuleCtx *ctx;  // context to reply on
+	uint count;           // number of plans replied
+} PlanStatsReplyCtx;
+
+static void _ReplyWithPlan
+(
+	const char *key,
+	void *value,
+	void *privdata
+) {
+	PlanStatsReplyCtx *reply_ctx = privdata;
+	ExecutionCtx *exec_ctx = value;
+	if(exec_ctx->stats == NULL) return;
+
+	// strip the index version and parameter signature prefix
+	// see _PlanCacheKey
+	const char *query = key;
+	for(int i = 0; i < 2; i++) {
+		const char *sep = strchr(query, ':');
+		if(sep == NULL) break;
+		query = sep + 1;
+	}
+
+	PlanStats_Reply(exec_ctx->stats, reply_ctx->ctx, query);
+	reply_ctx->count++;
+}
+
+// reply with the sampled statistics of each cached execution plan
+void Graph_PlanStats(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+
+	CommandCtx_TrackCtx(command_ctx);
+
+	PlanStatsReplyCtx reply_ctx = {.ctx = ctx, .count = 0};
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+	Cache_ForEach(GraphContext_GetCache(gc), _ReplyWithPlan, &reply_ctx);
+	RedisModule_ReplySetArrayLength(ctx, reply_ctx.count);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
@@ -0,0 +1,75 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "../errors.h"
+#include "cmd_context.h"
+#include "../ast/ast.h"
+#include "../query_ctx.h"
+
+/* Registers a read-only query for repeated execution via GRAPH.EXECUTE
+ * replies with the handle identifying the prepared statement
+ * Args:
+ * argv[1] graph name
+ * argv[2] query */
+void Graph_Prepare(void *args) {
+	CommandCtx     *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx         = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext   *gc          = CommandCtx_GetGraphContext(command_ctx);
+	AST            *ast         = NULL;
+	cypher_parse_result_t *params_parse_result = NULL;
+
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+	CommandCtx_TrackCtx(command_ctx);
+
+	if(strcmp(command_ctx->query, "") == 0) {
+		ErrorCtx_SetError("Error: empty query.");
+		goto cleanup;
+	}
+
+	const char *query_string;
+	params_parse_result = parse_params(command_ctx->query, &query_string);
+	if(params_parse_result == NULL) goto cleanup;
+
+	// parameters are bound on execution
+	if(QueryCtx_GetParams() != NULL) {
+		ErrorCtx_SetError("Error: parameters are bound to prepared statements on execution.");
+		goto cleanup;
+	}
+
+	// validate the query
+	cypher_parse_result_t *query_parse_result = parse_query(query_string);
+	if(query_parse_result == NULL) {
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError("Error: could not parse query");
+		}
+		goto cleanup;
+	}
+	ast = AST_Build(query_parse_result);
+
+	// write queries replicate the command which executed them
+	// replicas are unaware of prepared statements, restrict to reads
+	if(!AST_ReadOnly(ast->root)) {
+		ErrorCtx_SetError("Error: only read-only queries can be prepared.");
+		goto cleanup;
+	}
+
+	int64_t handle = PreparedStatements_Add(gc->prepared, query_string);
+	if(handle < 0) {
+		ErrorCtx_SetError("Error: max prepared statements exceeded.");
+		goto cleanup;
+	}
+
+	RedisModule_ReplyWithLongLong(ctx, handle);
+
+cleanup:
+	if(ErrorCtx_EncounteredError()) ErrorCtx_EmitException();
+	AST_Free(ast);
+	parse_result_free(params_parse_result);
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+	ErrorCtx_Clear();
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "RG.h"
+#include "../redismodule.h"
+#include "../query_registry.h"
+
+// GRAPH.LIST_QUERIES
+// replies with the in-flight queries, each as:
+// [id, graph, command, query, elapsed ms, "running" | "cancelled"]
+int Graph_ListQueries(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	ASSERT(ctx != NULL);
+	if(argc != 1) return RedisModule_WrongArity(ctx);
+
+	QueryRegistry_Reply(ctx);
+
+	return REDISMODULE_OK;
+}
+
+// GRAPH.KILL <query-id>
+// cancels an in-flight query, the query aborts at its next checkpoint
+// replying with a "Query was killed" error
+int Graph_Kill(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+	ASSERT(ctx != NULL);
+	if(argc != 2) return RedisModule_WrongArity(ctx);
+
+	long long id;
+	if(RedisModule_StringToLongLong(argv[1], &id) != REDISMODULE_OK || id <= 0) {
+		RedisModule_ReplyWithError(ctx, "Invalid query ID");
+		return REDISMODULE_OK;
+	}
+
+	if(!QueryRegistry_Kill(id)) {
+		RedisModule_ReplyWithError(ctx, "Unknown query ID");
+		return REDISMODULE_OK;
+	}
+
+	RedisModule_ReplyWithSimpleString(ctx, "OK");
+	return REDISMODULE_OK;
+}
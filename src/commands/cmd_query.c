@@ -9,14 +9,26 @@
 #include "cmd_context.h"
 #include "../ast/ast.h"
 #include "../util/arr.h"
-#include "../util/cron.h"
+#include "../util/msgpack.h"
 #include "../query_ctx.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../util/cache/cache.h"
 #include "../util/thpool/pools.h"
+#include "../configuration/config.h"
+#include "../index/index_builder.h"
+#include "../resultset/resultset_cache.h"
+#include "../slow_log/query_capture.h"
 #include "../execution_plan/execution_plan.h"
+#include "../execution_plan/execution_plan_cost.h"
 #include "execution_ctx.h"
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+
+// default bound on waiting for a commit sequence, in milliseconds
+#define COMMIT_SEQ_WAIT_MS 1000
 
 // GraphQueryCtx stores the allocations required to execute a query.
 typedef struct {
@@ -27,7 +39,7 @@ typedef struct {
 	CommandCtx *command_ctx;  // command context
 	bool readonly_query;      // read only query
 	bool profile;             // profile query
-	CronTaskHandle timeout;   // timeout cron task
+	bool cache_result;        // store the result-set in the result cache
 } GraphQueryCtx;
 
 static GraphQueryCtx *GraphQueryCtx_New
@@ -37,8 +49,7 @@ static GraphQueryCtx *GraphQueryCtx_New
 	ExecutionCtx *exec_ctx,
 	CommandCtx *command_ctx,
 	bool readonly_query,
-	bool profile,
-	CronTaskHandle timeout
+	bool profile
 ) {
 	GraphQueryCtx *ctx = rm_malloc(sizeof(GraphQueryCtx));
 
@@ -49,7 +60,7 @@ static GraphQueryCtx *GraphQueryCtx_New
 	ctx->command_ctx     =  command_ctx;
 	ctx->readonly_query  =  readonly_query;
 	ctx->profile         =  profile;
-	ctx->timeout         =  timeout;
+	ctx->cache_result    =  false;
 
 	return ctx;
 }
@@ -100,7 +111,7 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		}
 
 		// populate the index only when at least one attribute was introduced
-		if(index_added) Index_Construct(idx);
+		if(index_added) IndexBuilder_Build(gc, idx);
 
 		QueryCtx_UnlockCommit(NULL);
 	} else if(exec_type == EXECUTION_TYPE_INDEX_DROP) {
@@ -113,10 +124,18 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 		// determine if schema type from which index is removed
 		// default to node
 		// TODO: support index name
-		if(GraphContext_GetSchema(gc, label, schema_type) == NULL) {
+		Schema *s = GraphContext_GetSchema(gc, label, schema_type);
+		if(s == NULL) {
 			schema_type = SCHEMA_EDGE;
 		}
 
+		// unique constraints are enforced through the index
+		Attribute_ID attr = GraphContext_GetAttributeID(gc, prop);
+		if(s != NULL && Schema_GetConstraint(s, CT_UNIQUE, attr) != NULL) {
+			ErrorCtx_SetError("ERR Unable to drop index on :%s(%s): index enforces a unique constraint.", label, prop);
+			return;
+		}
+
 		QueryCtx_LockForCommit();
 		int res = GraphContext_DeleteIndex(gc, schema_type, label, prop,
 				idx_type);
@@ -130,25 +149,353 @@ static void _index_operation(RedisModuleCtx *ctx, GraphContext *gc, AST *ast,
 	}
 }
 
+// resolves the label, attribute and type of a constraint operation
+// returns false if the constrained expression isn't an attribute
+// of the constrained node, e.g. n.v
+static bool _constraint_target
+(
+	const cypher_astnode_t *constraint_op,
+	const char **label,
+	const char **attr,
+	ConstraintType *t
+) {
+	const cypher_astnode_t *identifier;
+	const cypher_astnode_t *label_node;
+	const cypher_astnode_t *exp;
+	bool unique;
+
+	if(cypher_astnode_type(constraint_op) ==
+	   CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT) {
+		identifier = cypher_ast_create_node_prop_constraint_get_identifier(constraint_op);
+		label_node = cypher_ast_create_node_prop_constraint_get_label(constraint_op);
+		exp        = cypher_ast_create_node_prop_constraint_get_expression(constraint_op);
+		unique     = cypher_ast_create_node_prop_constraint_is_unique(constraint_op);
+	} else {
+		identifier = cypher_ast_drop_node_prop_constraint_get_identifier(constraint_op);
+		label_node = cypher_ast_drop_node_prop_constraint_get_label(constraint_op);
+		exp        = cypher_ast_drop_node_prop_constraint_get_expression(constraint_op);
+		unique     = cypher_ast_drop_node_prop_constraint_is_unique(constraint_op);
+	}
+
+	*label = cypher_ast_label_get_name(label_node);
+	*t = unique ? CT_UNIQUE : CT_EXISTS;
+
+	// existence constraints may wrap the attribute, exists(n.v)
+	if(cypher_astnode_type(exp) == CYPHER_AST_APPLY_OPERATOR &&
+	   cypher_ast_apply_operator_narguments(exp) == 1) {
+		exp = cypher_ast_apply_operator_get_argument(exp, 0);
+	}
+
+	if(cypher_astnode_type(exp) != CYPHER_AST_PROPERTY_OPERATOR) return false;
+
+	const cypher_astnode_t *entity =
+		cypher_ast_property_operator_get_expression(exp);
+	if(cypher_astnode_type(entity) != CYPHER_AST_IDENTIFIER) return false;
+	if(strcmp(cypher_ast_identifier_get_name(entity),
+			  cypher_ast_identifier_get_name(identifier)) != 0) {
+		return false;
+	}
+
+	*attr = cypher_ast_prop_name_get_value(
+			cypher_ast_property_operator_get_prop_name(exp));
+	return true;
+}
+
+static void _constraint_operation(GraphContext *gc, AST *ast,
+		ExecutionType exec_type) {
+	const char     *label;
+	const char     *attr_name;
+	ConstraintType t;
+
+	if(!_constraint_target(ast->root, &label, &attr_name, &t)) {
+		ErrorCtx_SetError("ERR Constraints must be declared over a property of the constrained node, e.g. n.v");
+		return;
+	}
+
+	ResultSet *result_set = QueryCtx_GetResultSet();
+
+	if(exec_type == EXECUTION_TYPE_CONSTRAINT_CREATE) {
+		QueryCtx_LockForCommit();
+
+		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+		if(s == NULL) s = GraphContext_AddSchema(gc, label, SCHEMA_NODE);
+		Attribute_ID attr = GraphContext_FindOrAddAttribute(gc, attr_name);
+
+		// constraint already exists
+		if(Schema_GetConstraint(s, t, attr) != NULL) {
+			ResultSet_ConstraintCreated(result_set, false);
+			QueryCtx_UnlockCommit(NULL);
+			return;
+		}
+
+		// existing nodes must satisfy the constraint
+		Constraint c = {.t = t, .attr = attr, .attr_name = (char *)attr_name};
+		if(!Constraint_Holds(s->id, &c)) {
+			QueryCtx_UnlockCommit(NULL);
+			return;
+		}
+
+		// unique constraints are enforced through an exact-match index
+		// lookups fall back to scanning the label while it is populated
+		Index *idx = NULL;
+		if(t == CT_UNIQUE && Schema_GetIndex(s, &attr, IDX_EXACT_MATCH) == NULL &&
+		   GraphContext_AddIndex(&idx, gc, SCHEMA_NODE, label, attr_name,
+				   IDX_EXACT_MATCH) == INDEX_OK) {
+			IndexBuilder_Build(gc, idx);
+		}
+
+		Schema_AddConstraint(s, t, attr, attr_name);
+		ResultSet_ConstraintCreated(result_set, true);
+
+		// plans may rely on the constraint
+		GraphContext_BumpIndexVersion(gc);
+
+		QueryCtx_UnlockCommit(NULL);
+	} else {
+		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+		Attribute_ID attr = GraphContext_GetAttributeID(gc, attr_name);
+
+		bool removed = false;
+		QueryCtx_LockForCommit();
+		if(s != NULL && attr != ATTRIBUTE_NOTFOUND) {
+			removed = Schema_RemoveConstraint(s, t, attr);
+		}
+		if(removed) {
+			// plans relying on the constraint must not be reused
+			GraphContext_BumpIndexVersion(gc);
+			ResultSet_ConstraintDeleted(result_set, true);
+		}
+		QueryCtx_UnlockCommit(NULL);
+
+		if(!removed) {
+			ErrorCtx_SetError("ERR Unable to drop constraint on :%s(%s): no such constraint.", label, attr_name);
+		}
+	}
+}
+
+inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
+	const char *command_name = CommandCtx_GetCommandName(ctx);
+	return strcasecmp(command_name, "graph.RO_QUERY") == 0 ||
+		strcasecmp(command_name, "graph.MULTI_RO_QUERY") == 0 ||
+		strcasecmp(command_name, "graph.EXECUTE") == 0 ||
+		strcasecmp(command_name, "graph.VIEW") == 0;
+}
+
 //------------------------------------------------------------------------------
-// Query timeout
+// Result cache
 //------------------------------------------------------------------------------
 
-// timeout handler
-void QueryTimedOut(void *pdata) {
-	ASSERT(pdata != NULL);
-	ExecutionPlan *plan = (ExecutionPlan *)pdata;
-	ExecutionPlan_Drain(plan);
+// builds the result cache key of a query
+// the key holds the graph write epoch, such that once the graph is modified
+// previously cached results are never hit again and are eventually evicted
+static char *_ResultCacheKey
+(
+	uint64_t epoch,                 // graph write epoch
+	ResultSetFormatterType format,  // reply format
+	const char *query               // query including its parameters
+) {
+	int len = snprintf(NULL, 0, "%" PRIu64 ":%d:%s", epoch, format, query);
+	char *key = rm_malloc(len + 1);
+	snprintf(key, len + 1, "%" PRIu64 ":%d:%s", epoch, format, query);
+	return key;
 }
 
-// set timeout for query execution
-CronTaskHandle Query_SetTimeOut(uint timeout, ExecutionPlan *plan) {
-	// increase execution plan ref count
-	return Cron_AddTask(timeout, QueryTimedOut, plan);
+// waits for the graph to reach the commit sequence requested via the
+// min_version flag, such that a replica serves reads only once it applied
+// the writes the client depends on
+// the wait is bounded by the query timeout, or COMMIT_SEQ_WAIT_MS if none
+// returns false if the sequence wasn't reached
+static bool _WaitForCommitSeq
+(
+	const CommandCtx *command_ctx,
+	GraphContext *gc
+) {
+	uint64_t seq = command_ctx->min_commit_seq;
+	if(GraphContext_CommitSeq(gc) >= seq) return true;
+
+	// commits are applied by the main thread, which can't wait for itself
+	if(command_ctx->thread == EXEC_THREAD_MAIN) return false;
+
+	double limit = (command_ctx->timeout > 0) ? command_ctx->timeout :
+		COMMIT_SEQ_WAIT_MS;
+
+	double timer[2];
+	simple_tic(timer);
+	struct timespec interval = {.tv_sec = 0, .tv_nsec = 1000000};  // 1ms
+	while(simple_toc(timer) * 1000 < limit) {
+		nanosleep(&interval, NULL);
+		if(GraphContext_CommitSeq(gc) >= seq) return true;
+	}
+
+	return false;
 }
 
-inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
-	return strcasecmp(CommandCtx_GetCommandName(ctx), "graph.RO_QUERY") == 0;
+// formats the error reported when the commit sequence wasn't reached
+static void _CommitSeqError
+(
+	const CommandCtx *command_ctx,
+	GraphContext *gc,
+	char *buf,
+	size_t len
+) {
+	snprintf(buf, len, "Graph has not reached version %llu, current version %llu",
+			(unsigned long long)command_ctx->min_commit_seq,
+			(unsigned long long)GraphContext_CommitSeq(gc));
+}
+
+// replies with a cached result-set of the query if one exists
+// returns true if a reply was sent
+static bool _ReplyFromResultCache
+(
+	RedisModuleCtx *ctx,
+	GraphContext *gc,
+	CommandCtx *command_ctx
+) {
+	Graph *g = gc->g;
+	uint64_t epoch = Graph_WriteEpoch(g);
+	char *key = _ResultCacheKey(epoch, command_ctx->format,
+			command_ctx->query);
+	CachedResultSet *cached = Cache_GetValue(gc->result_cache, key);
+	rm_free(key);
+	if(cached == NULL) return false;
+
+	// the graph might have been modified since the lookup
+	// unless the read lock is already held
+	bool locked = command_ctx->read_locked;
+	if(!locked) Graph_AcquireReadLock(g);
+	bool valid = (Graph_WriteEpoch(g) == epoch);
+	if(valid) ResultSet_ReplyCached(cached->set, ctx);
+	if(!locked) Graph_ReleaseLock(g);
+
+	CachedResultSet_Release(cached);
+	return valid;
+}
+
+// stores a replied result-set in the result cache
+// 'epoch' is the graph write epoch the result-set reflects
+static void _StoreInResultCache
+(
+	GraphContext *gc,
+	CommandCtx *command_ctx,
+	ResultSet *result_set,
+	uint64_t epoch
+) {
+	char *key = _ResultCacheKey(epoch, command_ctx->format,
+			command_ctx->query);
+
+	// replays report the result-set as a cached execution
+	ResultSet_CachedExecution(result_set);
+	CachedResultSet *cached = CachedResultSet_New(result_set);
+
+	// returns either a new reference to the stored entry or 'cached' itself
+	// if the key was already stored by a concurrent query
+	CachedResultSet_Release(Cache_SetGetValue(gc->result_cache, key, cached));
+	rm_free(key);
+}
+
+//------------------------------------------------------------------------------
+// Materialized views
+//------------------------------------------------------------------------------
+
+// version of the labels and relationship types 'view' depends on
+// modification counters only grow, such that their sum changes once
+// any of the view's dependencies is modified
+// must be called while holding the graph read lock
+static uint64_t _ViewVersion
+(
+	GraphContext *gc,
+	const MaterializedView *view
+) {
+	Graph *g = gc->g;
+	if(MaterializedView_Global(view)) return Graph_WriteEpoch(g);
+
+	uint64_t version = 0;
+
+	const char **labels = MaterializedView_Labels(view);
+	uint n = array_len(labels);
+	for(uint i = 0; i < n; i++) {
+		Schema *s = GraphContext_GetSchema(gc, labels[i], SCHEMA_NODE);
+		if(s == NULL) continue;
+		version += GraphStatistics_NodeModifications(&g->stats,
+				Schema_GetID(s));
+	}
+
+	const char **relations = MaterializedView_Relations(view);
+	n = array_len(relations);
+	for(uint i = 0; i < n; i++) {
+		Schema *s = GraphContext_GetSchema(gc, relations[i], SCHEMA_EDGE);
+		if(s == NULL) continue;
+		version += GraphStatistics_EdgeModifications(&g->stats,
+				Schema_GetID(s));
+	}
+
+	return version;
+}
+
+// replies with the view's result if its dependencies weren't modified
+// since it was computed, returns true if a reply was sent
+static bool _ReplyFromView
+(
+	RedisModuleCtx *ctx,
+	GraphContext *gc,
+	CommandCtx *command_ctx
+) {
+	Graph *g = gc->g;
+	MaterializedView *view = command_ctx->view;
+
+	bool locked = command_ctx->read_locked;
+	if(!locked) Graph_AcquireReadLock(g);
+	CachedResultSet *cached = MaterializedView_GetResult(view,
+			_ViewVersion(gc, view), command_ctx->format);
+	if(cached != NULL) ResultSet_ReplyCached(cached->set, ctx);
+	if(!locked) Graph_ReleaseLock(g);
+
+	if(cached == NULL) return false;
+
+	CachedResultSet_Release(cached);
+	return true;
+}
+
+// sets a replied result-set as the view's result
+// 'version' is the version of the view's dependencies the result-set reflects
+static void _StoreInView
+(
+	CommandCtx *command_ctx,
+	ResultSet *result_set,
+	uint64_t version
+) {
+	// replays report the result-set as a cached execution
+	ResultSet_CachedExecution(result_set);
+	MaterializedView_SetResult(command_ctx->view, version,
+			command_ctx->format, CachedResultSet_New(result_set));
+}
+
+// state of the graph a query's result reflects
+// keys the result once stored in the result cache or a view
+// must be called while holding the graph read lock
+static uint64_t _ResultVersion
+(
+	GraphContext *gc,
+	const CommandCtx *command_ctx
+) {
+	if(command_ctx->view != NULL) return _ViewVersion(gc, command_ctx->view);
+	return Graph_WriteEpoch(gc->g);
+}
+
+// divide the OpenMP threads among the queries currently executing
+// a query executing alone may use all of them, under load each gets one
+static void _SetThreadBudget(void) {
+	uint omp_threads;
+	Config_Option_get(Config_OPENMP_NTHREAD, &omp_threads);
+
+	// the calling thread is busy unless it's Redis main thread
+	uint busy = ThreadPools_BusyCount();
+	if(busy == 0) busy = 1;
+
+	uint budget = omp_threads / busy;
+	if(budget == 0) budget = 1;
+
+	RG_Matrix_setThreadBudget(budget);
 }
 
 /* _ExecuteQuery accepts a GraphQeuryCtx as an argument
@@ -169,28 +516,35 @@ static void _ExecuteQuery(void *args) {
 	ExecutionPlan   *plan         =  exec_ctx->plan;
 	ExecutionType   exec_type     =  exec_ctx->exec_type;
 
-	// if we have migrated to a writer thread,
+	// if we have migrated to a writer or heavy thread,
 	// update thread-local storage and track the CommandCtx
-	if(command_ctx->thread == EXEC_THREAD_WRITER) {
+	if(command_ctx->thread == EXEC_THREAD_WRITER ||
+	   command_ctx->thread == EXEC_THREAD_HEAVY) {
 		QueryCtx_SetTLS(query_ctx);
 		CommandCtx_TrackCtx(command_ctx);
+		QueryCtx_AddStageTime(QUERY_STAGE_WAIT,
+				simple_toc(command_ctx->timer) * 1000);
+		if(command_ctx->thread == EXEC_THREAD_WRITER) {
+			QueryCtx_Trace(QUERY_TRACE_WRITER_DEQUEUED);
+		}
 	}
 
 	// instantiate the query ResultSet
-	bool compact = command_ctx->compact;
 	ResultSetFormatterType resultset_format = profile
-		? FORMATTER_NOP 
-		: (compact) 
-			? FORMATTER_COMPACT 
-			: FORMATTER_VERBOSE;
+		? FORMATTER_NOP
+		: command_ctx->format;
 	ResultSet *result_set = NewResultSet(rm_ctx, resultset_format);
 	if(exec_ctx->cached) ResultSet_CachedExecution(result_set); // indicate a cached execution
 
 	QueryCtx_SetResultSet(result_set);
 
 	// acquire the appropriate lock
+	// batched queries execute under the batch read lock
+	bool locked = command_ctx->read_locked;
+	double tic[2];
+	simple_tic(tic);
 	if(readonly) {
-		Graph_AcquireReadLock(gc->g);
+		if(!locked) Graph_AcquireReadLock(gc->g);
 	} else {
 		/* if this is a writer query `we need to re-open the graph key with write flag
 		 * this notifies Redis that the key is "dirty" any watcher on that key will
@@ -201,6 +555,12 @@ static void _ExecuteQuery(void *args) {
 		}
 		CommandCtx_ThreadSafeContextUnlock(command_ctx);
 	}
+	QueryCtx_AddStageTime(QUERY_STAGE_LOCK, simple_toc(tic) * 1000);
+	QueryCtx_Trace(QUERY_TRACE_LOCKED);
+
+	// commit locks acquired during execution aren't accounted as execution
+	double lock_time = QueryCtx_GetStageTime(QUERY_STAGE_LOCK);
+	simple_tic(tic);
 
 	if(exec_type == EXECUTION_TYPE_QUERY) {  // query operation
 		// set policy after lock acquisition,
@@ -208,43 +568,101 @@ static void _ExecuteQuery(void *args) {
 		Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
 		ExecutionPlan_PreparePlan(plan);
+		QueryCtx_Trace(QUERY_TRACE_PREPARED);
+		_SetThreadBudget();
+		// sampled executions are profiled and reply as usual
+		bool sampled = !profile && PlanStats_ShouldSample(exec_ctx->stats);
+		// hot plans evaluate their expressions compiled
+		if(PlanStats_ShouldCompile(exec_ctx->stats)) ExecutionPlan_Compile(plan);
 		if(profile) {
 			ExecutionPlan_Profile(plan);
 			if(!ErrorCtx_EncounteredError()) ExecutionPlan_Print(plan, rm_ctx);
-		}
-		else {
+		} else if(sampled) {
+			result_set = ExecutionPlan_Profile(plan);
+		} else {
 			result_set = ExecutionPlan_Execute(plan);
 		}
 
-		// abort timeout if set
-		if(gq_ctx->timeout != 0) Cron_AbortTask(gq_ctx->timeout);
+		if(sampled && !ErrorCtx_EncounteredError()) {
+			PlanStats_Record(exec_ctx->stats, plan->root);
+		}
 
-		// emit error if query timed out
-		if(ExecutionPlan_Drained(plan)) ErrorCtx_SetError("Query timed out");
+		// restore the global OpenMP thread count
+		RG_Matrix_setThreadBudget(0);
 
 		ExecutionPlan_Free(plan);
 		exec_ctx->plan = NULL;
 	} else if(exec_type == EXECUTION_TYPE_INDEX_CREATE ||
 			  exec_type == EXECUTION_TYPE_INDEX_DROP) {
 		_index_operation(rm_ctx, gc, ast, exec_type);
+	} else if(exec_type == EXECUTION_TYPE_CONSTRAINT_CREATE ||
+			  exec_type == EXECUTION_TYPE_CONSTRAINT_DROP) {
+		_constraint_operation(gc, ast, exec_type);
 	} else {
 		ASSERT("Unhandled query type" && false);
 	}
 
 	QueryCtx_ForceUnlockCommit();
+	QueryCtx_Trace(QUERY_TRACE_EXECUTED);
+
+	// streamed rows were released once sent and can't be cached
+	bool cache_result = gq_ctx->cache_result && !result_set->streaming &&
+		!ErrorCtx_EncounteredError();
+	if(cache_result) ResultSet_RetainRows(result_set);
+	uint64_t version = cache_result ? _ResultVersion(gc, command_ctx) : 0;
+
+	// rows which don't reference graph entities are formatted and replied
+	// once the read lock is released, such that writers aren't blocked
+	// by reply serialization
+	bool unlocked = readonly && !locked && ResultSet_Detach(result_set);
+	if(unlocked) Graph_ReleaseLock(gc->g);
 
 	if(!profile || ErrorCtx_EncounteredError()) {
 		// if we encountered an error, ResultSet_Reply will emit the error
 		// send result-set back to client
 		ResultSet_Reply(result_set);
 	}
+	QueryCtx_Trace(QUERY_TRACE_REPLIED);
+	uint64_t rows = ResultSet_RowCount(result_set);
+	lock_time = QueryCtx_GetStageTime(QUERY_STAGE_LOCK) - lock_time;
+	QueryCtx_AddStageTime(QUERY_STAGE_EXECUTE,
+			simple_toc(tic) * 1000 - lock_time);
 
-	if(readonly) Graph_ReleaseLock(gc->g); // release read lock
+	// the result cache or view takes ownership over the result-set
+	if(cache_result) {
+		if(command_ctx->view != NULL) {
+			_StoreInView(command_ctx, result_set, version);
+		} else {
+			_StoreInResultCache(gc, command_ctx, result_set, version);
+		}
+		result_set = NULL;
+	}
+
+	// release read lock
+	if(readonly && !locked && !unlocked) Graph_ReleaseLock(gc->g);
 
 	// log query to slowlog
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
 	SlowLog_Add(slowlog, command_ctx->command_name, command_ctx->query,
-				QueryCtx_GetExecutionTime(), NULL);
+				QueryCtx_GetExecutionTime(), NULL, QueryCtx_GetTrace());
+	QueryStats_Add(GraphContext_GetQueryStats(gc), command_ctx->query,
+				QueryCtx_GetExecutionTime(), rows);
+	QueryCapture_Add(GraphContext_GetName(gc), command_ctx->command_name,
+				command_ctx->query, QueryCtx_GetExecutionTime(), rows,
+				(readonly ? QUERY_CAPTURE_READONLY : 0) |
+				(command_ctx->format == FORMATTER_COMPACT ? QUERY_CAPTURE_COMPACT : 0) |
+				(command_ctx->format == FORMATTER_ARROW ? QUERY_CAPTURE_ARROW : 0) |
+				(command_ctx->format == FORMATTER_JSON ? QUERY_CAPTURE_JSON : 0));
+	QueryCtx_RecordStageTimes();
+	QueryCtx_Trace(QUERY_TRACE_LOGGED);
+	QueryTraceLog_Add(GraphContext_GetQueryTraces(gc),
+				command_ctx->command_name, command_ctx->query,
+				QueryCtx_GetExecutionTime(), QueryCtx_GetTrace());
+
+	// reply was sent, rebuild a cached plan which no longer fits the data
+	// or prepare a spare copy of it for the next hit
+	if(PlanStats_ShouldReplan(exec_ctx->stats)) ExecutionCtx_Evict(exec_ctx);
+	else ExecutionCtx_Replenish(exec_ctx);
 
 	// clean up
 	ExecutionCtx_Free(exec_ctx);
@@ -256,6 +674,43 @@ static void _ExecuteQuery(void *args) {
 	GraphQueryCtx_Free(gq_ctx);
 }
 
+//------------------------------------------------------------------------------
+// Group commit
+//------------------------------------------------------------------------------
+
+// write queries pending execution on the writer thread, in arrival order
+static GraphQueryCtx **_pending_writes = NULL;
+static pthread_mutex_t _pending_writes_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// executes all pending write queries
+// consecutive queries against the same graph commit through a shared context
+static void _ExecuteWriteBatch(void *args) {
+	uint64_t batch_size;
+	Config_Option_get(Config_WRITE_BATCH_SIZE, &batch_size);
+
+	// take over pending queries, queries arriving from now on
+	// schedule a new batch
+	pthread_mutex_lock(&_pending_writes_lock);
+	GraphQueryCtx **queries = _pending_writes;
+	_pending_writes = NULL;
+	pthread_mutex_unlock(&_pending_writes_lock);
+
+	uint n = array_len(queries);
+	uint i = 0;
+	while(i < n) {
+		GraphContext *gc = queries[i]->graph_ctx;
+
+		QueryCtx_BeginGroupCommit(gc);
+		uint group_end = i + batch_size;
+		do {
+			_ExecuteQuery(queries[i++]);
+		} while(i < n && i < group_end && queries[i]->graph_ctx == gc);
+		QueryCtx_EndGroupCommit();
+	}
+
+	array_free(queries);
+}
+
 static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 	ASSERT(gq_ctx != NULL);
 
@@ -273,10 +728,136 @@ static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 
 	// update execution thread to writer
 	gq_ctx->command_ctx->thread = EXEC_THREAD_WRITER;
+	simple_tic(gq_ctx->command_ctx->timer);
 
 	// dispatch work to the writer thread
-	int res = ThreadPools_AddWorkWriter(_ExecuteQuery, gq_ctx);
-	ASSERT(res == 0);
+	uint64_t batch_size;
+	Config_Option_get(Config_WRITE_BATCH_SIZE, &batch_size);
+	if(batch_size <= 1) {
+		int res = ThreadPools_AddWorkWriter(_ExecuteQuery, gq_ctx);
+		ASSERT(res == 0);
+		return;
+	}
+
+	// queue query, schedule a batch only if one isn't pending already
+	pthread_mutex_lock(&_pending_writes_lock);
+	bool schedule = (_pending_writes == NULL);
+	if(schedule) _pending_writes = array_new(GraphQueryCtx *, 1);
+	array_append(_pending_writes, gq_ctx);
+	pthread_mutex_unlock(&_pending_writes_lock);
+
+	if(schedule) {
+		int res = ThreadPools_AddWorkWriter(_ExecuteWriteBatch, NULL);
+		ASSERT(res == 0);
+	}
+}
+
+// migrates an expensive read-only query to the heavy thread pool
+// returns false if the heavy pool's queue is full
+// in which case the query remains on the calling reader thread
+static bool _DelegateHeavy(GraphQueryCtx *gq_ctx) {
+	ASSERT(gq_ctx != NULL);
+
+	CommandCtx *command_ctx = gq_ctx->command_ctx;
+
+	// clear this thread data
+	ErrorCtx_Clear();
+	QueryCtx_RemoveFromTLS();
+	CommandCtx_UntrackCtx(command_ctx);
+
+	command_ctx->thread = EXEC_THREAD_HEAVY;
+	simple_tic(command_ctx->timer);
+
+	if(ThreadPools_AddWorkHeavy(_ExecuteQuery, gq_ctx) == 0) return true;
+
+	// restore this thread data
+	command_ctx->thread = EXEC_THREAD_READER;
+	QueryCtx_SetTLS(gq_ctx->query_ctx);
+	CommandCtx_TrackCtx(command_ctx);
+
+	return false;
+}
+
+// parses the typed name, type and value triples bound to a prepared statement
+// parsing is left to the executing thread, off Redis main thread
+static bool _SetStatementParams(char **args) {
+	uint n = array_len(args);
+	if(n == 0) return true;
+
+	rax *params = raxNew();
+	for(uint i = 0; i < n; i += 3) {
+		const char *name = args[i];
+		const char *type = args[i + 1];
+		const char *str  = args[i + 2];
+
+		char *end = NULL;
+		bool valid = true;
+		SIValue v = SI_NullVal();
+		errno = 0;
+		if(!strcasecmp(type, "INT")) {
+			v = SI_LongVal(strtoll(str, &end, 10));
+		} else if(!strcasecmp(type, "DOUBLE")) {
+			v = SI_DoubleVal(strtod(str, &end));
+		} else if(!strcasecmp(type, "BOOL")) {
+			valid = !strcasecmp(str, "true") || !strcasecmp(str, "false");
+			v = SI_BoolVal(!strcasecmp(str, "true"));
+		} else if(!strcasecmp(type, "STRING")) {
+			v = SI_DuplicateStringVal(str);
+		} else {
+			valid = false;
+		}
+
+		// numeric values must be consumed entirely
+		if(end != NULL) valid = errno == 0 && end != str && *end == '\0';
+
+		if(!valid) {
+			ErrorCtx_SetError("Error: invalid %s parameter '%s'", type, name);
+			raxFreeWithCallback(params, (void (*)(void *))AR_EXP_Free);
+			return false;
+		}
+
+		AR_ExpNode *exp = AR_EXP_NewConstOperandNode(v);
+		void *prev = NULL;
+		raxInsert(params, (unsigned char *)name, strlen(name), exp, &prev);
+		// the last value bound to a parameter wins
+		if(prev != NULL) AR_EXP_Free(prev);
+	}
+
+	QueryCtx_SetParams(params);
+	return true;
+}
+
+// decodes the MessagePack encoded parameters passed via the params flag
+// a map of parameter names to values, e.g. {"name": "Ann", "age": 32}
+static bool _SetBinaryParams(const char *buf, size_t len) {
+	uint32_t n;
+	MsgPackReader reader = MsgPack_Reader(buf, len);
+	if(!MsgPack_ReadMapHeader(&reader, &n)) return false;
+
+	rax *params = raxNew();
+	for(uint32_t i = 0; i < n; i++) {
+		SIValue v;
+		uint32_t name_len;
+		const char *name;
+		if(!MsgPack_ReadString(&reader, &name, &name_len) ||
+		   !MsgPack_ReadValue(&reader, &v)) {
+			raxFreeWithCallback(params, (void (*)(void *))AR_EXP_Free);
+			return false;
+		}
+
+		AR_ExpNode *exp = AR_EXP_NewConstOperandNode(v);
+		void *prev = NULL;
+		raxInsert(params, (unsigned char *)name, name_len, exp, &prev);
+		if(prev != NULL) AR_EXP_Free(prev);
+	}
+
+	if(!MsgPack_Done(&reader)) {
+		raxFreeWithCallback(params, (void (*)(void *))AR_EXP_Free);
+		return false;
+	}
+
+	QueryCtx_SetParams(params);
+	return true;
 }
 
 void _query(bool profile, void *args) {
@@ -293,11 +874,64 @@ void _query(bool profile, void *args) {
 		goto cleanup;
 	}
 
+	double wait = simple_toc(command_ctx->timer);
+	QueryCtx_AddStageTime(QUERY_STAGE_WAIT, wait * 1000);
 	QueryCtx_BeginTimer(); // Start query timing.
 
+	// list the query as in-flight, cancellable by GRAPH.KILL
+	QueryCtx_Register(GraphContext_GetName(gc), command_ctx->command_name,
+			command_ctx->query);
+
+	// the command was received once it was queued
+	uint64_t now = QueryTrace_Now();
+	QueryTrace *trace = QueryCtx_GetTrace();
+	QueryTrace_Record(trace, QUERY_TRACE_RECEIVED, now - wait * 1e9);
+	QueryTrace_Record(trace, QUERY_TRACE_DEQUEUED, now);
+
+	if(!_WaitForCommitSeq(command_ctx, gc)) {
+		char err[128];
+		_CommitSeqError(command_ctx, gc, err, sizeof(err));
+		ErrorCtx_SetError("%s", err);
+		goto cleanup;
+	}
+
+	// serve read-only queries from the result cache if enabled
+	// prepared statements and binary parameters are not cached
+	// as the query text omits the parameters
+	bool use_result_cache = !profile && gc->result_cache != NULL &&
+		command_ctx->statement == NULL && command_ctx->binary_params == NULL &&
+		command_ctx->view == NULL;
+	if(use_result_cache && _ReplyFromResultCache(ctx, gc, command_ctx)) {
+		goto cleanup;
+	}
+
+	// views replay their result unless their dependencies were modified
+	if(command_ctx->view != NULL && _ReplyFromView(ctx, gc, command_ctx)) {
+		goto cleanup;
+	}
+
 	// parse query parameters and build an execution plan or retrieve it from the cache
-	exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	double tic[2];
+	simple_tic(tic);
+	// binary parameters are set first, parameters within
+	// the query's CYPHER header take precedence
+	if(command_ctx->binary_params != NULL &&
+	   !_SetBinaryParams(command_ctx->binary_params,
+			   command_ctx->binary_params_len)) {
+		ErrorCtx_SetError("Error: invalid binary parameters");
+		goto cleanup;
+	}
+
+	if(command_ctx->statement != NULL) {
+		// prepared statements carry their parameters outside of the query
+		if(!_SetStatementParams(command_ctx->params)) goto cleanup;
+		exec_ctx = ExecutionCtx_FromPrepared(command_ctx->statement);
+	} else {
+		exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	}
+	QueryCtx_AddStageTime(QUERY_STAGE_PLAN, simple_toc(tic) * 1000);
 	if(exec_ctx == NULL) goto cleanup;
+	QueryCtx_Trace(QUERY_TRACE_PLANNED);
 
 	ExecutionType exec_type = exec_ctx->exec_type;
 
@@ -308,6 +942,13 @@ void _query(bool profile, void *args) {
 		goto cleanup;
 	}
 
+	if(profile &&
+		(exec_type == EXECUTION_TYPE_CONSTRAINT_CREATE ||
+	     exec_type == EXECUTION_TYPE_CONSTRAINT_DROP)) {
+		RedisModule_ReplyWithError(ctx, "Can't profile constraint operations.");
+		goto cleanup;
+	}
+
 	bool readonly = AST_ReadOnly(exec_ctx->ast->root);
 
 	// write query executing via GRAPH.RO_QUERY isn't allowed
@@ -316,20 +957,59 @@ void _query(bool profile, void *args) {
 		goto cleanup;
 	}
 
-	CronTaskHandle timeout_task = 0;
+	// admission control, reject queries estimated to exceed the cost limit
+	// and route expensive read-only queries to the heavy thread pool
+	// such that they can't occupy all of the readers
+	bool heavy = false;
+	uint64_t cost_limit;
+	uint64_t heavy_cost;
+	Config_Option_get(Config_QUERY_COST_LIMIT, &cost_limit);
+	Config_Option_get(Config_HEAVY_QUERY_COST, &heavy_cost);
+	if(exec_type == EXECUTION_TYPE_QUERY &&
+	   (cost_limit != QUERY_COST_UNLIMITED ||
+		heavy_cost != HEAVY_QUERY_COST_DISABLED)) {
+		// scaled by the misestimate observed by sampled executions
+		double cost = ExecutionPlan_EstimateCost(exec_ctx->plan) *
+			PlanStats_CostCorrection(exec_ctx->stats);
+		if(cost_limit != QUERY_COST_UNLIMITED && cost > cost_limit) {
+			ErrorCtx_SetError("Query estimated cost %.0f exceeds the limit of %llu",
+					cost, (unsigned long long)cost_limit);
+			goto cleanup;
+		}
+
+		// batched queries execute under the batch read lock and can't migrate
+		heavy = readonly && heavy_cost != HEAVY_QUERY_COST_DISABLED &&
+			cost >= heavy_cost && command_ctx->thread == EXEC_THREAD_READER &&
+			!command_ctx->read_locked;
+	}
 
 	// set the query timeout if one was specified
+	// the query checks its deadline at cancellation checkpoints
 	if(command_ctx->timeout != 0) {
 		// disallow timeouts on write operations to avoid leaving the graph in an inconsistent state
-		if(readonly) {
-			timeout_task = Query_SetTimeOut(command_ctx->timeout,
-					exec_ctx->plan);
-		}
+		if(readonly) QueryCtx_SetDeadline(command_ctx->timeout);
 	}
 
 	// populate the container struct for invoking _ExecuteQuery.
 	GraphQueryCtx *gq_ctx = GraphQueryCtx_New(gc, ctx, exec_ctx, command_ctx,
-											  readonly, profile, timeout_task);
+											  readonly, profile);
+
+	// results depend only on the graph state when the query doesn't call
+	// non-deterministic functions, e.g. rand()
+	gq_ctx->cache_result = readonly &&
+		(use_result_cache || command_ctx->view != NULL) &&
+		exec_type == EXECUTION_TYPE_QUERY &&
+		AST_Deterministic(exec_ctx->ast->root);
+
+	// replicas can't reproduce non-deterministic writes by re-executing them
+	if(!readonly && exec_type == EXECUTION_TYPE_QUERY &&
+	   !AST_Deterministic(exec_ctx->ast->root)) {
+		QueryCtx_SetNonDeterministic();
+	}
+
+	// expensive read-only queries are handed over to the heavy pool
+	// once its queue is full they are executed by the current reader
+	if(heavy && _DelegateHeavy(gq_ctx)) return;
 
 	// if 'thread' is redis main thread, continue running
 	// if readonly is true we're executing on a worker thread from
@@ -361,3 +1041,40 @@ void Graph_Profile(void *args) {
 void Graph_Query(void *args) {
 	_query(false, args);
 }
+
+// executes a batch of read-only queries under a single read lock
+// all queries observe the same graph snapshot, the reply holds
+// one result-set per query, in order
+void Graph_MultiQuery(void *args) {
+	CommandCtx     *command_ctx = (CommandCtx *)args;
+	RedisModuleCtx *ctx         = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext   *gc          = CommandCtx_GetGraphContext(command_ctx);
+	uint           n            = array_len(command_ctx->queries);
+
+	// wait before taking the read lock, which holds off the awaited writers
+	if(!_WaitForCommitSeq(command_ctx, gc)) {
+		char err[128];
+		_CommitSeqError(command_ctx, gc, err, sizeof(err));
+		RedisModule_ReplyWithError(ctx, err);
+		GraphContext_Release(gc);
+		CommandCtx_Free(command_ctx);
+		return;
+	}
+
+	RedisModule_ReplyWithArray(ctx, n);
+
+	// writers are held off until the last query replied
+	Graph_AcquireReadLock(gc->g);
+
+	for(uint i = 0; i < n; i++) {
+		// each query either replies with its result-set or with an error
+		CommandCtx *query_ctx = CommandCtx_NewBatched(command_ctx,
+				command_ctx->queries[i]);
+		_query(false, query_ctx);
+	}
+
+	Graph_ReleaseLock(gc->g);
+
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+}
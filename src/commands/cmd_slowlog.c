@@ -6,18 +6,46 @@
 
 #include "cmd_context.h"
 #include "../slow_log/slow_log.h"
+#include "../slow_log/query_stats.h"
 
+// GRAPH.SLOWLOG <graph>            slowest queries
+// GRAPH.SLOWLOG <graph> SPANS      slowest queries and their phase times
+// GRAPH.SLOWLOG <graph> TRACES     recently sampled query phase traces
+// GRAPH.SLOWLOG <graph> SHAPES     latency statistics by query shape
+// GRAPH.SLOWLOG <graph> LOCKS      graph lock contention statistics
+// GRAPH.SLOWLOG <graph> RESET      clear slowlog, query shape, lock statistics and traces
 void Graph_Slowlog(void *args) {
 	CommandCtx *command_ctx = (CommandCtx *)args;
 	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
 	GraphContext *gc = CommandCtx_GetGraphContext(command_ctx);
+	const char *subcmd = CommandCtx_GetQuery(command_ctx);
 
 	CommandCtx_TrackCtx(command_ctx);
 
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
-	SlowLog_Replay(slowlog, ctx);
+	QueryStats *stats = GraphContext_GetQueryStats(gc);
+	QueryTraceLog *traces = GraphContext_GetQueryTraces(gc);
+
+	if(subcmd == NULL || subcmd[0] == '\0') {
+		SlowLog_Replay(slowlog, ctx, false);
+	} else if(strcasecmp(subcmd, "SPANS") == 0) {
+		SlowLog_Replay(slowlog, ctx, true);
+	} else if(strcasecmp(subcmd, "TRACES") == 0) {
+		QueryTraceLog_Replay(traces, ctx);
+	} else if(strcasecmp(subcmd, "SHAPES") == 0) {
+		QueryStats_Replay(stats, ctx);
+	} else if(strcasecmp(subcmd, "LOCKS") == 0) {
+		GraphLockStats_Replay(&gc->g->lock_stats, ctx);
+	} else if(strcasecmp(subcmd, "RESET") == 0) {
+		SlowLog_Reset(slowlog);
+		QueryStats_Reset(stats);
+		GraphLockStats_Reset(&gc->g->lock_stats);
+		QueryTraceLog_Reset(traces);
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		RedisModule_ReplyWithError(ctx, "Unknown subcommand");
+	}
 
 	GraphContext_Release(gc);
 	CommandCtx_Free(command_ctx);
 }
-
@@ -0,0 +1,181 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "../errors.h"
+#include "commands.h"
+#include "cmd_context.h"
+#include "../ast/ast.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+
+// collects the labels and relationship types the query depends on
+// returns true if the query depends on every modification of the graph
+static bool _CollectDependencies
+(
+	const cypher_astnode_t *root,  // query root
+	const char ***labels,          // [output] labels
+	const char ***relations        // [output] relationship types
+) {
+	// procedures might read any part of the graph
+	if(AST_TreeContainsType(root, CYPHER_AST_CALL)) return true;
+
+	bool global = false;
+	const cypher_astnode_t **paths = AST_GetTypedNodes(root,
+			CYPHER_AST_PATTERN_PATH);
+	uint path_count = array_len(paths);
+
+	for(uint i = 0; i < path_count && !global; i++) {
+		const cypher_astnode_t *path = paths[i];
+		uint n = cypher_ast_pattern_path_nelements(path);
+
+		// even elements are nodes, odd elements are relationships
+		for(uint j = 0; j < n && !global; j++) {
+			const cypher_astnode_t *e =
+				cypher_ast_pattern_path_get_element(path, j);
+
+			if(j % 2 == 1) {
+				uint reltype_count = cypher_ast_rel_pattern_nreltypes(e);
+				// untyped relationships match edges of every type
+				if(reltype_count == 0) global = true;
+				for(uint k = 0; k < reltype_count; k++) {
+					const cypher_astnode_t *t =
+						cypher_ast_rel_pattern_get_reltype(e, k);
+					array_append(*relations, cypher_ast_reltype_get_name(t));
+				}
+				continue;
+			}
+
+			uint label_count = cypher_ast_node_pattern_nlabels(e);
+			for(uint k = 0; k < label_count; k++) {
+				const cypher_astnode_t *l =
+					cypher_ast_node_pattern_get_label(e, k);
+				array_append(*labels, cypher_ast_label_get_name(l));
+			}
+
+			// an anonymous unlabeled node connected by a relationship
+			// only changes along with its edges
+			// other unlabeled nodes can be any node of the graph
+			if(label_count == 0) {
+				bool anonymous =
+					cypher_ast_node_pattern_get_identifier(e) == NULL &&
+					cypher_ast_node_pattern_get_properties(e) == NULL;
+				global = !anonymous || n == 1;
+			}
+		}
+	}
+
+	array_free(paths);
+	return global;
+}
+
+// creates view args[1] over query args[2]
+static void _CreateView
+(
+	RedisModuleCtx *ctx,
+	GraphContext *gc,
+	char **args
+) {
+	AST *ast = NULL;
+	const char **labels = NULL;
+	const char **relations = NULL;
+	cypher_parse_result_t *params_parse_result = NULL;
+
+	const char *name  = args[1];
+	const char *query = args[2];
+
+	if(strcmp(query, "") == 0) {
+		ErrorCtx_SetError("Error: empty query.");
+		goto cleanup;
+	}
+
+	const char *query_string;
+	params_parse_result = parse_params(query, &query_string);
+	if(params_parse_result == NULL) goto cleanup;
+
+	// views are re-executed on demand, their parameters can't change
+	if(QueryCtx_GetParams() != NULL) {
+		ErrorCtx_SetError("Error: views don't accept parameters.");
+		goto cleanup;
+	}
+
+	// validate the query
+	cypher_parse_result_t *query_parse_result = parse_query(query_string);
+	if(query_parse_result == NULL) {
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError("Error: could not parse query");
+		}
+		goto cleanup;
+	}
+	ast = AST_Build(query_parse_result);
+
+	if(!AST_ReadOnly(ast->root)) {
+		ErrorCtx_SetError("Error: views are defined by read-only queries.");
+		goto cleanup;
+	}
+
+	// a view's result must depend only on the graph state
+	if(!AST_Deterministic(ast->root)) {
+		ErrorCtx_SetError("Error: views are defined by deterministic queries.");
+		goto cleanup;
+	}
+
+	labels    = array_new(const char *, 1);
+	relations = array_new(const char *, 1);
+	bool global = _CollectDependencies(ast->root, &labels, &relations);
+
+	if(!MaterializedViews_Add(gc->views, name, query_string, labels,
+				relations, global)) {
+		ErrorCtx_SetError("Error: view %s already exists or max views exceeded.",
+				name);
+		goto cleanup;
+	}
+
+	RedisModule_ReplyWithSimpleString(ctx, "OK");
+
+cleanup:
+	if(labels) array_free(labels);
+	if(relations) array_free(relations);
+	AST_Free(ast);
+	parse_result_free(params_parse_result);
+}
+
+/* Manages views, named read-only queries whose result is kept
+ * until the labels and relationship types they depend on are modified
+ * Args:
+ * argv[1] graph name
+ * argv[2] subcommand, CREATE, READ or DROP
+ * argv[3] view name
+ * argv[4] query, CREATE only */
+void Graph_View(void *args) {
+	CommandCtx *command_ctx = (CommandCtx *)args;
+
+	// reading a view executes its query unless its result is up to date
+	if(command_ctx->view != NULL) {
+		Graph_Query(args);
+		return;
+	}
+
+	RedisModuleCtx *ctx = CommandCtx_GetRedisCtx(command_ctx);
+	GraphContext   *gc  = CommandCtx_GetGraphContext(command_ctx);
+	char          **argv = command_ctx->args;
+
+	QueryCtx_SetGlobalExecutionCtx(command_ctx);
+	CommandCtx_TrackCtx(command_ctx);
+
+	if(strcasecmp(argv[0], "CREATE") == 0) {
+		_CreateView(ctx, gc, argv);
+	} else if(MaterializedViews_Remove(gc->views, argv[1])) {
+		RedisModule_ReplyWithSimpleString(ctx, "OK");
+	} else {
+		ErrorCtx_SetError("Error: unknown view");
+	}
+
+	if(ErrorCtx_EncounteredError()) ErrorCtx_EmitException();
+	GraphContext_Release(gc);
+	CommandCtx_Free(command_ctx);
+	QueryCtx_Free(); // Reset the QueryCtx and free its allocations.
+	ErrorCtx_Clear();
+}
@@ -24,7 +24,14 @@ typedef enum {
 	CMD_PROFILE        = 6,
 	CMD_BULK_INSERT    = 7,
 	CMD_SLOWLOG        = 8,
-	CMD_LIST           = 9
+	CMD_LIST           = 9,
+	CMD_PLANSTATS      = 10,
+	CMD_MEMORY         = 11,
+	CMD_MULTI_RO_QUERY = 12,
+	CMD_PREPARE        = 13,
+	CMD_EXECUTE        = 14,
+	CMD_VIEW           = 15,
+	CMD_MATRICES       = 16
 } GRAPH_Commands;
 
 //------------------------------------------------------------------------------
@@ -32,11 +39,23 @@ typedef enum {
 //------------------------------------------------------------------------------
 
 void Graph_Query(void *args);
+void Graph_MultiQuery(void *args);
+void Graph_Prepare(void *args);
+void Graph_View(void *args);
 void Graph_Slowlog(void *args);
+void Graph_PlanStats(void *args);
+void Graph_Memory(void *args);
+void Graph_Matrices(void *args);
 void Graph_Profile(void *args);
 void Graph_Explain(void *args);
 int Graph_List(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_ListQueries(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Kill(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Debug(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Delete(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Copy(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Config(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Import(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Export(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
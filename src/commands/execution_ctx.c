@@ -8,6 +8,7 @@
 #include "RG.h"
 #include "../errors.h"
 #include "../query_ctx.h"
+#include "../ast/ast_parameterize.h"
 #include "../execution_plan/execution_plan_clone.h"
 
 static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
@@ -16,6 +17,8 @@ static ExecutionType _GetExecutionTypeFromAST(AST *ast) {
 	if(root_type == CYPHER_AST_CREATE_NODE_PROPS_INDEX) return EXECUTION_TYPE_INDEX_CREATE;
 	if(root_type == CYPHER_AST_CREATE_PATTERN_PROPS_INDEX) return EXECUTION_TYPE_INDEX_CREATE;
 	if(root_type == CYPHER_AST_DROP_PROPS_INDEX) return EXECUTION_TYPE_INDEX_DROP;
+	if(root_type == CYPHER_AST_CREATE_NODE_PROP_CONSTRAINT) return EXECUTION_TYPE_CONSTRAINT_CREATE;
+	if(root_type == CYPHER_AST_DROP_NODE_PROP_CONSTRAINT) return EXECUTION_TYPE_CONSTRAINT_DROP;
 	ASSERT(false && "Unknown execution type");
 	return 0;
 }
@@ -28,6 +31,9 @@ static ExecutionCtx *_ExecutionCtx_New(AST *ast, ExecutionPlan *plan,
 	exec_ctx->plan      = plan;
 	exec_ctx->cached    = false;
 	exec_ctx->exec_type = exec_type;
+	exec_ctx->cache_key = NULL;
+	exec_ctx->query     = NULL;
+	exec_ctx->stats     = NULL;
 
 	return exec_ctx;
 }
@@ -42,6 +48,11 @@ ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *orig) {
 	execution_ctx->plan      = ExecutionPlan_Clone(orig->plan);
 	execution_ctx->cached    = orig->cached;
 	execution_ctx->exec_type = orig->exec_type;
+	execution_ctx->cache_key = NULL;
+	execution_ctx->query     = NULL;
+	execution_ctx->stats     = (orig->stats != NULL)
+		? PlanStats_Retain(orig->stats)
+		: NULL;
 
 	return execution_ctx;
 }
@@ -62,6 +73,82 @@ static AST *_ExecutionCtx_ParseAST(const char *query_string,
 	return ast;
 }
 
+// parses 'query_string' and builds its execution plan
+// returns NULL if either failed
+static ExecutionCtx *_ExecutionCtx_Build(const char *query_string,
+		cypher_parse_result_t *params_parse_result) {
+	AST *ast = _ExecutionCtx_ParseAST(query_string, params_parse_result);
+	// if query parsing failed, return NULL
+	if(!ast) {
+		// if no error has been set, emit one now
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError("Error: could not parse query");
+		}
+		return NULL;
+	}
+
+	ExecutionType exec_type = _GetExecutionTypeFromAST(ast);
+	if(exec_type != EXECUTION_TYPE_QUERY) {
+		return _ExecutionCtx_New(ast, NULL, exec_type);
+	}
+
+	ExecutionPlan *plan = NewExecutionPlan();
+
+	// TODO: there must be a better way to understand if the execution-plan
+	// was constructed correctly,
+	// maybe free the plan within NewExecutionPlan, if error was encountered
+	// and return NULL ?
+	if(ErrorCtx_EncounteredError()) {
+		// Encountered an error in ExecutionPlan construction,
+		// clean up and return NULL.
+		AST_Free(ast);
+		ExecutionPlan_Free(plan);
+		return NULL;
+	}
+
+	return _ExecutionCtx_New(ast, plan, exec_type);
+}
+
+// appends the query parameters' type signature to 'key'
+// e.g. "id=2;name=8;" parameters are visited in lexicographic order
+static sds _ParamsSignature(sds key) {
+	rax *params = QueryCtx_GetParams();
+	if(params == NULL) return key;
+
+	raxIterator it;
+	raxStart(&it, params);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		AR_ExpNode *exp = it.data;
+		SIType t = AR_EXP_IsConstant(exp) ? SI_TYPE(exp->operand.constant) : 0;
+		key = sdscatlen(key, it.key, it.key_len);
+		key = sdscatprintf(key, "=%x;", t);
+	}
+	raxStop(&it);
+
+	return key;
+}
+
+// builds the execution plan cache key of a query
+// the key holds the graph's index version, such that plans built before
+// an index became usable, or while it was still in use, are never hit again
+// and the parameters' type signature, as plans are specialized for the
+// types of the parameters they were built with, e.g. an index is only
+// utilized for a parameter holding an indexable value
+static char *_PlanCacheKey(const GraphContext *gc, const char *query) {
+	uint64_t version = GraphContext_IndexVersion(gc);
+	sds key = sdscatprintf(sdsempty(), "%" PRIu64 ":", version);
+	key = _ParamsSignature(key);
+	key = sdscatprintf(key, ":%s", query);
+
+	size_t len = sdslen(key);
+	char *cache_key = rm_malloc(len + 1);
+	memcpy(cache_key, key, len + 1);
+	sdsfree(key);
+
+	return cache_key;
+}
+
 ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	ASSERT(query != NULL);
 
@@ -79,56 +166,112 @@ ExecutionCtx *ExecutionCtx_FromQuery(const char *query) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Cache *cache = GraphContext_GetCache(gc);
 
+	// Lift literals into parameters, such that queries which differ only
+	// by their literals share a single cached execution plan.
+	if(GraphContext_AutoParameterize(gc)) {
+		sds normalized = AST_AutoParameterize(query, query_string);
+		if(normalized != NULL) {
+			// query_string is owned by the params parse result, re-parse.
+			parse_result_free(params_parse_result);
+			params_parse_result = parse_params(normalized, &query_string);
+			sdsfree(normalized);
+			if(params_parse_result == NULL) return NULL;
+		}
+	}
+
+	QueryCtx_Trace(QUERY_TRACE_PARAMS_PARSED);
+
 	// Check the cache to see if we already have a cached context for this query.
-	ret = Cache_GetValue(cache, query_string);
+	char *cache_key = _PlanCacheKey(gc, query_string);
+	ret = Cache_GetValue(cache, cache_key);
 	if(ret) {
+		// A spare copy might have been cloned by a different query,
+		// set its AST in thread local storage.
+		QueryCtx_SetAST(ret->ast);
 		// Set parameters parse result in the execution ast.
 		AST_SetParamsParseResult(ret->ast, params_parse_result);
 		ret->cached = true;
+		ret->cache_key = cache_key;
 		return ret;
 	}
 
-	// No cached execution plan, try to parse the query.
-	AST *ast = _ExecutionCtx_ParseAST(query_string, params_parse_result);
-	// if query parsing failed, return NULL
-	if(!ast) {
-		// if no error has been set, emit one now
-		if(!ErrorCtx_EncounteredError()) {
-			ErrorCtx_SetError("Error: could not parse query");
-		}
-		return NULL;
+	// No cached execution plan, build one.
+	ExecutionCtx *exec_ctx = _ExecutionCtx_Build(query_string,
+			params_parse_result);
+
+	// only query execution plans are cached
+	if(exec_ctx == NULL || exec_ctx->exec_type != EXECUTION_TYPE_QUERY) {
+		rm_free(cache_key);
+		return exec_ctx;
 	}
 
-	ExecutionType exec_type = _GetExecutionTypeFromAST(ast);
-	// In case of valid query, create execution plan, and cache it and the AST.
-	if(exec_type == EXECUTION_TYPE_QUERY) {
-		ExecutionPlan *plan = NewExecutionPlan();
-
-		// TODO: there must be a better way to understand if the execution-plan
-		// was constructed correctly,
-		// maybe free the plan within NewExecutionPlan, if error was encountered
-		// and return NULL ?
-		if(ErrorCtx_EncounteredError()) {
-			// Encountered an error in ExecutionPlan construction,
-			// clean up and return NULL.
-			AST_Free(ast);
-			ExecutionPlan_Free(plan);
-			return NULL;
-		}
-		ExecutionCtx *exec_ctx_to_cache = _ExecutionCtx_New(ast, plan,
-															exec_type);
-		ExecutionCtx *exec_ctx_from_cache = Cache_SetGetValue(cache,
-															  query_string, exec_ctx_to_cache);
-		return exec_ctx_from_cache;
-	} else {
-		return _ExecutionCtx_New(ast, NULL, exec_type);
+	// the original query, parameters included, rebuilds the same cache key
+	// once re-planned after load, see plan_warmup.h
+	exec_ctx->stats = PlanStats_New();
+	exec_ctx->query = rm_strdup(query);
+	ExecutionCtx *exec_ctx_from_cache = Cache_SetGetValue(cache, cache_key,
+			exec_ctx);
+	exec_ctx_from_cache->cache_key = cache_key;
+	return exec_ctx_from_cache;
+}
+
+ExecutionCtx *ExecutionCtx_FromPrepared(PreparedStatement *statement) {
+	ASSERT(statement != NULL);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	QueryCtx_Trace(QUERY_TRACE_PARAMS_PARSED);
+
+	// the statement pins a single plan, rebuilt whenever the parameter types
+	// or the usable indices differ from those it was built for
+	char *plan_key = _PlanCacheKey(gc, "");
+	ExecutionCtx *ret = PreparedStatement_GetPlan(statement, plan_key);
+	if(ret != NULL) {
+		rm_free(plan_key);
+		ret->cached = true;
+		return ret;
 	}
+
+	ExecutionCtx *exec_ctx = _ExecutionCtx_Build(
+			PreparedStatement_Query(statement), NULL);
+
+	if(exec_ctx == NULL || exec_ctx->exec_type != EXECUTION_TYPE_QUERY) {
+		rm_free(plan_key);
+		return exec_ctx;
+	}
+
+	// hand out a copy, the statement keeps the origin
+	exec_ctx->stats = PlanStats_New();
+	ret = ExecutionCtx_Clone(exec_ctx);
+	PreparedStatement_PinPlan(statement, plan_key, exec_ctx);
+	return ret;
+}
+
+void ExecutionCtx_Replenish(const ExecutionCtx *ctx) {
+	ASSERT(ctx != NULL);
+	if(ctx->cache_key == NULL) return;
+
+	// cloning sets the copy's AST in thread local storage, restore it
+	AST *ast = QueryCtx_GetAST();
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Cache_Replenish(GraphContext_GetCache(gc), ctx->cache_key);
+	QueryCtx_SetAST(ast);
+}
+
+void ExecutionCtx_Evict(const ExecutionCtx *ctx) {
+	ASSERT(ctx != NULL);
+	if(ctx->cache_key == NULL) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Cache_Remove(GraphContext_GetCache(gc), ctx->cache_key);
 }
 
 void ExecutionCtx_Free(ExecutionCtx *ctx) {
 	if(ctx == NULL) return;
 	if(ctx->plan != NULL) ExecutionPlan_Free(ctx->plan);
 	if(ctx->ast != NULL) AST_Free(ctx->ast);
+	if(ctx->cache_key != NULL) rm_free(ctx->cache_key);
+	if(ctx->query != NULL) rm_free(ctx->query);
+	if(ctx->stats != NULL) PlanStats_Release(ctx->stats);
 
 	rm_free(ctx);
 }
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "../ast/ast.h"
+#include "../graph/prepared_statements.h"
+#include "../execution_plan/plan_stats.h"
 #include "../execution_plan/execution_plan.h"
 
 /**
@@ -14,8 +16,10 @@
  */
 typedef enum {
 	EXECUTION_TYPE_QUERY,           // Normal query execution.
-	EXECUTION_TYPE_INDEX_CREATE,    // Create index execution.
-	EXECUTION_TYPE_INDEX_DROP       // Drop index execution.
+	EXECUTION_TYPE_INDEX_CREATE,       // Create index execution.
+	EXECUTION_TYPE_INDEX_DROP,         // Drop index execution.
+	EXECUTION_TYPE_CONSTRAINT_CREATE,  // Create constraint execution.
+	EXECUTION_TYPE_CONSTRAINT_DROP     // Drop constraint execution.
 } ExecutionType;
 
 /**
@@ -26,6 +30,9 @@ typedef struct {
 	bool cached;                // cache hit/miss
 	ExecutionPlan *plan;        // execution plan
 	ExecutionType exec_type;    // execution type: query, index create/delete
+	char *cache_key;            // key under which the plan is cached, NULL if not cached
+	char *query;                // query the cached plan was built for, NULL for copies
+	PlanStats *stats;           // sampled statistics shared with the cached plan
 } ExecutionCtx;
 
 /**
@@ -36,12 +43,38 @@ typedef struct {
  */
 ExecutionCtx *ExecutionCtx_FromQuery(const char *query);
 
+/**
+ * @brief  Returns the objects required to execute a prepared statement.
+ * @note   The statement's parameters are expected to be set in the QueryCtx,
+ *         the plan pinned by the statement is used if it was built for
+ *         the same parameter types.
+ * @param  *statement: Prepared statement to execute.
+ * @retval ExecutionCtx populated with the current execution relevant objects.
+ */
+ExecutionCtx *ExecutionCtx_FromPrepared(PreparedStatement *statement);
+
 /**
  * @brief  Clone the execution ctx and return it (shallow copy for the ast, deep copy for the execution plan).
  * @param  *ctx: A pointer to ExecutionCTX struct
  */
 ExecutionCtx *ExecutionCtx_Clone(ExecutionCtx *ctx);
 
+/**
+ * @brief  Tops up the cache's pool of spare copies of ctx.
+ * @note   Invoked once a reply was sent, such that the next cache hit
+ *         for the same query does not have to clone the execution plan.
+ * @param  *ctx: A pointer to ExecutionCTX struct
+ */
+void ExecutionCtx_Replenish(const ExecutionCtx *ctx);
+
+/**
+ * @brief  Removes the cached execution plan ctx was copied from.
+ * @note   The next execution of the same query builds a new plan
+ *         from the graph's current statistics.
+ * @param  *ctx: A pointer to ExecutionCTX struct
+ */
+void ExecutionCtx_Evict(const ExecutionCtx *ctx);
+
 /**
  * @brief  Free an ExecutionCTX struct and its inner fields.
  * @param  *ctx: ExecutionCTX struct
@@ -0,0 +1,204 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "plan_warmup.h"
+#include "execution_ctx.h"
+#include "../errors.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+#include "../configuration/config.h"
+
+extern bool process_is_child; // global variable declared in module.c
+
+// queries loaded for a single graph
+typedef struct {
+	char *graph_name;  // name of the graph the queries were saved for
+	char **queries;    // queries to re-plan
+} PendingWarmup;
+
+// background re-planning of a graph's queries
+typedef struct {
+	GraphContext *gc;  // graph context, retained by the warmup
+	char **queries;    // queries to re-plan
+} PlanWarmup;
+
+// a cached query and the number of times its plan was executed
+typedef struct {
+	uint64_t executions;
+	char *query;
+} WarmupCandidate;
+
+// queries loaded from the RDB, accessed by the main thread only
+static PendingWarmup *pending = NULL;
+
+static void _CollectCandidate
+(
+	const char *key,
+	void *value,
+	void *privdata
+) {
+	WarmupCandidate **candidates = privdata;
+	ExecutionCtx *exec_ctx = value;
+	if(exec_ctx->query == NULL || exec_ctx->stats == NULL) return;
+
+	// the query is copied as the cache keeps evicting once the scan is done
+	WarmupCandidate candidate = {
+		.executions = PlanStats_Executions(exec_ctx->stats),
+		.query      = rm_strdup(exec_ctx->query)
+	};
+	array_append(*candidates, candidate);
+}
+
+// orders candidates by descending number of executions
+static int _CompareCandidates
+(
+	const void *a,
+	const void *b
+) {
+	uint64_t x = ((const WarmupCandidate *)a)->executions;
+	uint64_t y = ((const WarmupCandidate *)b)->executions;
+	return (x < y) - (x > y);
+}
+
+// executed on a reader thread, re-plans each query
+// cache hits are discarded, misses build and cache the query's plan
+static void _PlanWarmup_Run
+(
+	void *arg
+) {
+	PlanWarmup *warmup = (PlanWarmup *)arg;
+
+	uint n = array_len(warmup->queries);
+	for(uint i = 0; i < n; i++) {
+		QueryCtx_SetGraphCtx(warmup->gc);
+
+		ExecutionCtx *exec_ctx = ExecutionCtx_FromQuery(warmup->queries[i]);
+		ExecutionCtx_Free(exec_ctx);
+
+		// queries failing to plan, e.g. due to a dropped procedure, are skipped
+		QueryCtx_Free();
+		ErrorCtx_Clear();
+	}
+
+	GraphContext_Release(warmup->gc);
+	array_free_cb(warmup->queries, rm_free);
+	rm_free(warmup);
+}
+
+void PlanWarmup_Save
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(rdb != NULL);
+
+	uint64_t n;
+	Config_Option_get(Config_WARM_PLAN_COUNT, &n);
+
+	// the plan cache is built by the graph's first query
+	Cache *cache = __atomic_load_n(&gc->cache, __ATOMIC_ACQUIRE);
+
+	WarmupCandidate *candidates = array_new(WarmupCandidate, 0);
+	if(n > 0 && cache != NULL) {
+		// a forked child can't wait for a writer which didn't fork with it
+		// in which case the graph's queries aren't saved
+		if(process_is_child) {
+			Cache_TryForEach(cache, _CollectCandidate, &candidates);
+		} else {
+			Cache_ForEach(cache, _CollectCandidate, &candidates);
+		}
+	}
+
+	uint count = array_len(candidates);
+	qsort(candidates, count, sizeof(WarmupCandidate), _CompareCandidates);
+	if(count > n) count = n;
+
+	RedisModule_SaveUnsigned(rdb, count);
+	for(uint i = 0; i < count; i++) {
+		const char *query = candidates[i].query;
+		RedisModule_SaveStringBuffer(rdb, query, strlen(query) + 1);
+	}
+
+	for(uint i = 0; i < array_len(candidates); i++) {
+		rm_free(candidates[i].query);
+	}
+	array_free(candidates);
+}
+
+void PlanWarmup_Load
+(
+	RedisModuleIO *rdb,
+	const char *graph_name
+) {
+	ASSERT(rdb        != NULL);
+	ASSERT(graph_name != NULL);
+
+	uint64_t n;
+	Config_Option_get(Config_WARM_PLAN_COUNT, &n);
+
+	uint64_t count = RedisModule_LoadUnsigned(rdb);
+	char **queries = array_new(char *, count);
+	for(uint64_t i = 0; i < count; i++) {
+		char *query = RedisModule_LoadStringBuffer(rdb, NULL);
+		// the queries are consumed either way, kept only if warmup is enabled
+		if(i < n) array_append(queries, rm_strdup(query));
+		RedisModule_Free(query);
+	}
+
+	if(array_len(queries) == 0) {
+		array_free(queries);
+		return;
+	}
+
+	if(pending == NULL) pending = array_new(PendingWarmup, 1);
+	PendingWarmup p = {.graph_name = rm_strdup(graph_name), .queries = queries};
+	array_append(pending, p);
+}
+
+void PlanWarmup_Start(void) {
+	if(pending == NULL) return;
+
+	uint n = array_len(pending);
+	for(uint i = 0; i < n; i++) {
+		PendingWarmup *p = pending + i;
+		GraphContext *gc = GraphContext_GetRegisteredGraphContext(p->graph_name);
+		if(gc == NULL) continue;
+
+		PlanWarmup *warmup = rm_malloc(sizeof(PlanWarmup));
+		warmup->gc      = gc;
+		warmup->queries = p->queries;
+
+		GraphContext_Retain(gc);
+		if(ThreadPools_AddWorkReader(_PlanWarmup_Run, warmup, gc) != 0) {
+			// failed to queue the warmup, plans are built on demand
+			GraphContext_Release(gc);
+			rm_free(warmup);
+			continue;
+		}
+
+		// queries are owned by the warmup
+		p->queries = NULL;
+	}
+
+	PlanWarmup_Discard();
+}
+
+void PlanWarmup_Discard(void) {
+	if(pending == NULL) return;
+
+	uint n = array_len(pending);
+	for(uint i = 0; i < n; i++) {
+		rm_free(pending[i].graph_name);
+		if(pending[i].queries != NULL) array_free_cb(pending[i].queries, rm_free);
+	}
+
+	array_free(pending);
+	pending = NULL;
+}
@@ -0,0 +1,36 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../redismodule.h"
+#include "../graph/graphcontext.h"
+
+// plan warmup persists each graph's most executed queries within the RDB
+// and re-plans them in the background once loading ends
+// such that the queries following a restart or a failover hit
+// the execution plan cache rather than building their plans
+
+// saves the WARM_PLAN_COUNT most executed queries cached by 'gc'
+void PlanWarmup_Save
+(
+	RedisModuleIO *rdb,  // RDB to save into
+	GraphContext *gc     // graph whose queries are saved
+);
+
+// loads the queries saved by PlanWarmup_Save
+// the queries are kept until PlanWarmup_Start or PlanWarmup_Discard
+void PlanWarmup_Load
+(
+	RedisModuleIO *rdb,     // RDB to load from
+	const char *graph_name  // name of the graph the queries were saved for
+);
+
+// re-plans the loaded queries in the background
+void PlanWarmup_Start(void);
+
+// discards the loaded queries
+void PlanWarmup_Discard(void);
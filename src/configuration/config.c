@@ -11,6 +11,7 @@
 #include <limits.h>
 #include <errno.h>
 #include "util/redis_version.h"
+#include "util/thpool/pools.h"
 #include "../deps/GraphBLAS/Include/GraphBLAS.h"
 
 //-----------------------------------------------------------------------------
@@ -46,6 +47,81 @@
 // number of pending changed befor RG_Matrix flushed
 #define DELTA_MAX_PENDING_CHANGES "DELTA_MAX_PENDING_CHANGES"
 
+// number of rows buffered before streaming them to the client, 0 buffers all
+#define RESULTSET_CHUNK_SIZE "RESULTSET_CHUNK_SIZE"
+
+// number of threads a single query may use to evaluate filters over scans
+#define QUERY_PARALLELISM "QUERY_PARALLELISM"
+
+// max number of records a traversal accumulates before multiplying
+#define MAX_TRAVERSE_BATCH_SIZE "MAX_TRAVERSE_BATCH_SIZE"
+
+// max number of write queries sharing a single commit
+#define WRITE_BATCH_SIZE "WRITE_BATCH_SIZE"
+
+// percentage of max pending changes triggering background compaction
+#define DELTA_COMPACTION_RATIO "DELTA_COMPACTION_RATIO"
+
+// number of read-only query results cached per graph
+#define RESULTSET_CACHE_SIZE "RESULTSET_CACHE_SIZE"
+
+// maintain native ordered exact-match indices
+#define NATIVE_INDEX "NATIVE_INDEX"
+
+// minimum number of entities indexed in the background
+#define ASYNC_INDEX_THRESHOLD "ASYNC_INDEX_THRESHOLD"
+
+// back large allocations with transparent huge pages
+#define HUGE_PAGES "HUGE_PAGES"
+
+// minimum length of string properties kept in memory-mapped storage
+#define COLD_STORAGE_THRESHOLD "COLD_STORAGE_THRESHOLD"
+
+// sample one in every N executions of a cached plan
+#define PLAN_STATS_SAMPLE_RATE "PLAN_STATS_SAMPLE_RATE"
+
+// capture one in every N executed queries
+#define CAPTURE_SAMPLE_RATE "CAPTURE_SAMPLE_RATE"
+
+// keep the phase trace of one in every N executed queries
+#define TRACE_SAMPLE_RATE "TRACE_SAMPLE_RATE"
+
+// minimum write query execution time (µs) replicated via effects
+#define EFFECTS_THRESHOLD "EFFECTS_THRESHOLD"
+
+// max estimated query cost admitted for execution
+#define QUERY_COST_LIMIT "QUERY_COST_LIMIT"
+
+// minimum estimated cost of read-only queries executed by the heavy pool
+#define HEAVY_QUERY_COST "HEAVY_QUERY_COST"
+
+// compute the adjacency matrix from the relation matrices on demand
+#define DERIVED_ADJACENCY "DERIVED_ADJACENCY"
+
+// maintain transposed relation matrices only while reverse traversals use them
+#define ADAPTIVE_TRANSPOSE "ADAPTIVE_TRANSPOSE"
+
+// max number of entries kept in each graph's change stream, 0 disables
+#define CHANGE_STREAM_LENGTH "CHANGE_STREAM_LENGTH"
+
+// number of each graph's most executed queries persisted and re-planned on load
+#define WARM_PLAN_COUNT "WARM_PLAN_COUNT"
+
+// masks of the CPUs reader, writer and OpenMP threads are pinned to
+#define READER_AFFINITY "READER_AFFINITY"
+#define WRITER_AFFINITY "WRITER_AFFINITY"
+#define OMP_AFFINITY "OMP_AFFINITY"
+
+// growth of observed cardinality over a cached plan's expectation
+// triggering re-planning
+#define REPLAN_FACTOR "REPLAN_FACTOR"
+
+// number of executions after which a cached plan's expressions are compiled
+#define COMPILE_THRESHOLD "COMPILE_THRESHOLD"
+
+// minimum length of string properties stored compressed
+#define COMPRESSION_THRESHOLD "COMPRESSION_THRESHOLD"
+
 //------------------------------------------------------------------------------
 // Configuration defaults
 //------------------------------------------------------------------------------
@@ -66,6 +142,32 @@ typedef struct {
 	uint64_t max_queued_queries;       // max number of queued queries
 	int64_t query_mem_capacity;        // Max mem(bytes) that query/thread can utilize at any given time
 	int64_t delta_max_pending_changes; // number of pending changed befor RG_Matrix flushed
+	uint64_t resultset_chunk_size;     // number of rows buffered before streaming, 0 disables
+	uint64_t query_parallelism;        // max number of threads a query scan can utilize
+	uint64_t max_traverse_batch_size;  // max number of records batched by a traversal
+	uint64_t write_batch_size;         // max number of write queries sharing a commit
+	uint64_t delta_compaction_ratio;   // percentage of DELTA_MAX_PENDING_CHANGES compacted in the background
+	uint64_t resultset_cache_size;     // number of read-only query results cached per graph
+	bool native_index;                 // maintain native ordered exact-match indices
+	uint64_t async_index_threshold;    // minimum number of entities indexed in the background
+	bool huge_pages;                   // back large allocations with transparent huge pages
+	uint64_t cold_storage_threshold;   // minimum length of string properties kept in memory-mapped storage
+	uint64_t plan_stats_sample_rate;   // sample one in every N executions of a cached plan
+	uint64_t capture_sample_rate;      // capture one in every N executed queries
+	uint64_t trace_sample_rate;        // keep the phase trace of one in every N executed queries
+	uint64_t effects_threshold;        // minimum write query execution time (µs) replicated via effects
+	uint64_t query_cost_limit;         // max estimated query cost admitted for execution, 0 unlimited
+	uint64_t heavy_query_cost;         // minimum estimated cost of read-only queries executed by the heavy pool, 0 disabled
+	bool derived_adjacency;            // compute the adjacency matrix from the relation matrices on demand
+	bool adaptive_transpose;           // maintain transposed relation matrices only while in use
+	uint64_t change_stream_length;     // max number of entries kept in each graph's change stream, 0 disables
+	uint64_t warm_plan_count;          // number of each graph's most executed queries re-planned after load, 0 disables
+	uint64_t reader_affinity;          // mask of the CPUs reader threads are pinned to, 0 disables
+	uint64_t writer_affinity;          // mask of the CPUs writer threads are pinned to, 0 disables
+	uint64_t omp_affinity;             // mask of the CPUs OpenMP threads are pinned to, 0 disables
+	uint64_t replan_factor;            // growth of observed cardinality triggering re-planning, 0 disables
+	uint64_t compile_threshold;        // number of executions after which a cached plan is compiled, 0 disables
+	uint64_t compression_threshold;    // minimum length of string properties stored compressed, 0 disables
 	Config_on_change cb;               // callback function which being called when config param changed
 } RG_Config;
 
@@ -102,6 +204,17 @@ static inline bool _Config_ParseNonNegativeInteger(const char *integer_str, long
 	return (res == true && *value >= 0);
 }
 
+// parse CPU mask, either decimal or hexadecimal prefixed by 0x
+// return true if string represents a non-negative integer
+static inline bool _Config_ParseCPUMask(const char *mask_str, uint64_t *value) {
+	char *endptr;
+	errno = 0;    // To distinguish success/failure after call
+	*value = strtoull(mask_str, &endptr, 0);
+
+	return (errno == 0 && endptr != mask_str && *endptr == '\0' &&
+			mask_str[0] != '-');
+}
+
 // return true if 'str' is either "yes" or "no" otherwise returns false
 // sets 'value' to true if 'str' is "yes"
 // sets 'value to false if 'str' is "no"
@@ -255,6 +368,310 @@ uint64_t Config_delta_max_pending_changes_get(void)
 	return config.delta_max_pending_changes;
 }
 
+//------------------------------------------------------------------------------
+// result-set chunk size
+//------------------------------------------------------------------------------
+
+void Config_resultset_chunk_size_set(uint64_t chunk_size) {
+	config.resultset_chunk_size = chunk_size;
+}
+
+uint64_t Config_resultset_chunk_size_get(void) {
+	return config.resultset_chunk_size;
+}
+
+//------------------------------------------------------------------------------
+// query parallelism
+//------------------------------------------------------------------------------
+
+void Config_query_parallelism_set(uint64_t parallelism) {
+	config.query_parallelism = parallelism;
+}
+
+uint64_t Config_query_parallelism_get(void) {
+	return config.query_parallelism;
+}
+
+//------------------------------------------------------------------------------
+// max traverse batch size
+//------------------------------------------------------------------------------
+
+void Config_max_traverse_batch_size_set(uint64_t batch_size) {
+	config.max_traverse_batch_size = batch_size;
+}
+
+uint64_t Config_max_traverse_batch_size_get(void) {
+	return config.max_traverse_batch_size;
+}
+
+//------------------------------------------------------------------------------
+// write batch size
+//------------------------------------------------------------------------------
+
+void Config_write_batch_size_set(uint64_t batch_size) {
+	config.write_batch_size = batch_size;
+}
+
+uint64_t Config_write_batch_size_get(void) {
+	return config.write_batch_size;
+}
+
+//------------------------------------------------------------------------------
+// delta compaction ratio
+//------------------------------------------------------------------------------
+
+void Config_delta_compaction_ratio_set(uint64_t ratio) {
+	config.delta_compaction_ratio = ratio;
+}
+
+uint64_t Config_delta_compaction_ratio_get(void) {
+	return config.delta_compaction_ratio;
+}
+
+//------------------------------------------------------------------------------
+// resultset cache size
+//------------------------------------------------------------------------------
+
+void Config_resultset_cache_size_set(uint64_t cache_size) {
+	config.resultset_cache_size = cache_size;
+}
+
+uint64_t Config_resultset_cache_size_get(void) {
+	return config.resultset_cache_size;
+}
+
+//------------------------------------------------------------------------------
+// native index
+//------------------------------------------------------------------------------
+
+void Config_native_index_set(bool native_index) {
+	config.native_index = native_index;
+}
+
+bool Config_native_index_get(void) {
+	return config.native_index;
+}
+
+//------------------------------------------------------------------------------
+// async index threshold
+//------------------------------------------------------------------------------
+
+void Config_async_index_threshold_set(uint64_t threshold) {
+	config.async_index_threshold = threshold;
+}
+
+uint64_t Config_async_index_threshold_get(void) {
+	return config.async_index_threshold;
+}
+
+//------------------------------------------------------------------------------
+// huge pages
+//------------------------------------------------------------------------------
+
+void Config_huge_pages_set(bool enabled) {
+	config.huge_pages = enabled;
+}
+
+bool Config_huge_pages_get(void) {
+	return config.huge_pages;
+}
+
+//------------------------------------------------------------------------------
+// cold storage threshold
+//------------------------------------------------------------------------------
+
+void Config_cold_storage_threshold_set(uint64_t threshold) {
+	config.cold_storage_threshold = threshold;
+}
+
+uint64_t Config_cold_storage_threshold_get(void) {
+	return config.cold_storage_threshold;
+}
+
+//------------------------------------------------------------------------------
+// plan stats sample rate
+//------------------------------------------------------------------------------
+
+void Config_plan_stats_sample_rate_set(uint64_t rate) {
+	config.plan_stats_sample_rate = rate;
+}
+
+uint64_t Config_plan_stats_sample_rate_get(void) {
+	return config.plan_stats_sample_rate;
+}
+
+//------------------------------------------------------------------------------
+// capture sample rate
+//------------------------------------------------------------------------------
+
+void Config_capture_sample_rate_set(uint64_t rate) {
+	config.capture_sample_rate = rate;
+}
+
+uint64_t Config_capture_sample_rate_get(void) {
+	return config.capture_sample_rate;
+}
+
+//------------------------------------------------------------------------------
+// trace sample rate
+//------------------------------------------------------------------------------
+
+void Config_trace_sample_rate_set(uint64_t rate) {
+	config.trace_sample_rate = rate;
+}
+
+uint64_t Config_trace_sample_rate_get(void) {
+	return config.trace_sample_rate;
+}
+
+//------------------------------------------------------------------------------
+// effects threshold
+//------------------------------------------------------------------------------
+
+void Config_effects_threshold_set(uint64_t threshold) {
+	config.effects_threshold = threshold;
+}
+
+uint64_t Config_effects_threshold_get(void) {
+	return config.effects_threshold;
+}
+
+//------------------------------------------------------------------------------
+// query cost limit
+//------------------------------------------------------------------------------
+
+void Config_query_cost_limit_set(uint64_t limit) {
+	config.query_cost_limit = limit;
+}
+
+uint64_t Config_query_cost_limit_get(void) {
+	return config.query_cost_limit;
+}
+
+//------------------------------------------------------------------------------
+// heavy query cost
+//------------------------------------------------------------------------------
+
+void Config_heavy_query_cost_set(uint64_t cost) {
+	config.heavy_query_cost = cost;
+}
+
+uint64_t Config_heavy_query_cost_get(void) {
+	return config.heavy_query_cost;
+}
+
+//------------------------------------------------------------------------------
+// derived adjacency
+//------------------------------------------------------------------------------
+
+void Config_derived_adjacency_set(bool derived) {
+	config.derived_adjacency = derived;
+}
+
+bool Config_derived_adjacency_get(void) {
+	return config.derived_adjacency;
+}
+
+//------------------------------------------------------------------------------
+// adaptive transpose
+//------------------------------------------------------------------------------
+
+void Config_adaptive_transpose_set(bool adaptive) {
+	config.adaptive_transpose = adaptive;
+}
+
+bool Config_adaptive_transpose_get(void) {
+	return config.adaptive_transpose;
+}
+
+//------------------------------------------------------------------------------
+// change stream length
+//------------------------------------------------------------------------------
+
+void Config_change_stream_length_set(uint64_t length) {
+	config.change_stream_length = length;
+}
+
+uint64_t Config_change_stream_length_get(void) {
+	return config.change_stream_length;
+}
+
+//------------------------------------------------------------------------------
+// warm plan count
+//------------------------------------------------------------------------------
+
+void Config_warm_plan_count_set(uint64_t count) {
+	config.warm_plan_count = count;
+}
+
+uint64_t Config_warm_plan_count_get(void) {
+	return config.warm_plan_count;
+}
+
+//------------------------------------------------------------------------------
+// replan factor
+//------------------------------------------------------------------------------
+
+void Config_replan_factor_set(uint64_t factor) {
+	config.replan_factor = factor;
+}
+
+uint64_t Config_replan_factor_get(void) {
+	return config.replan_factor;
+}
+
+//------------------------------------------------------------------------------
+// compile threshold
+//------------------------------------------------------------------------------
+
+void Config_compile_threshold_set(uint64_t threshold) {
+	config.compile_threshold = threshold;
+}
+
+uint64_t Config_compile_threshold_get(void) {
+	return config.compile_threshold;
+}
+
+//------------------------------------------------------------------------------
+// compression threshold
+//------------------------------------------------------------------------------
+
+void Config_compression_threshold_set(uint64_t threshold) {
+	config.compression_threshold = threshold;
+}
+
+uint64_t Config_compression_threshold_get(void) {
+	return config.compression_threshold;
+}
+
+//------------------------------------------------------------------------------
+// CPU affinity
+//------------------------------------------------------------------------------
+
+void Config_reader_affinity_set(uint64_t mask) {
+	config.reader_affinity = mask;
+}
+
+uint64_t Config_reader_affinity_get(void) {
+	return config.reader_affinity;
+}
+
+void Config_writer_affinity_set(uint64_t mask) {
+	config.writer_affinity = mask;
+}
+
+uint64_t Config_writer_affinity_get(void) {
+	return config.writer_affinity;
+}
+
+void Config_omp_affinity_set(uint64_t mask) {
+	config.omp_affinity = mask;
+}
+
+uint64_t Config_omp_affinity_get(void) {
+	return config.omp_affinity;
+}
+
 bool Config_Contains_field(const char *field_str, Config_Option_Field *field)
 {
 	ASSERT(field_str != NULL);
@@ -279,6 +696,58 @@ bool Config_Contains_field(const char *field_str, Config_Option_Field *field)
 		f = Config_QUERY_MEM_CAPACITY;
 	} else if (!(strcasecmp(field_str, DELTA_MAX_PENDING_CHANGES))) {
 		f = Config_DELTA_MAX_PENDING_CHANGES;
+	} else if (!(strcasecmp(field_str, RESULTSET_CHUNK_SIZE))) {
+		f = Config_RESULTSET_CHUNK_SIZE;
+	} else if (!(strcasecmp(field_str, QUERY_PARALLELISM))) {
+		f = Config_QUERY_PARALLELISM;
+	} else if (!(strcasecmp(field_str, MAX_TRAVERSE_BATCH_SIZE))) {
+		f = Config_MAX_TRAVERSE_BATCH_SIZE;
+	} else if (!(strcasecmp(field_str, WRITE_BATCH_SIZE))) {
+		f = Config_WRITE_BATCH_SIZE;
+	} else if (!(strcasecmp(field_str, DELTA_COMPACTION_RATIO))) {
+		f = Config_DELTA_COMPACTION_RATIO;
+	} else if (!(strcasecmp(field_str, RESULTSET_CACHE_SIZE))) {
+		f = Config_RESULTSET_CACHE_SIZE;
+	} else if (!(strcasecmp(field_str, NATIVE_INDEX))) {
+		f = Config_NATIVE_INDEX;
+	} else if (!(strcasecmp(field_str, ASYNC_INDEX_THRESHOLD))) {
+		f = Config_ASYNC_INDEX_THRESHOLD;
+	} else if (!(strcasecmp(field_str, HUGE_PAGES))) {
+		f = Config_HUGE_PAGES;
+	} else if (!(strcasecmp(field_str, COLD_STORAGE_THRESHOLD))) {
+		f = Config_COLD_STORAGE_THRESHOLD;
+	} else if (!(strcasecmp(field_str, PLAN_STATS_SAMPLE_RATE))) {
+		f = Config_PLAN_STATS_SAMPLE_RATE;
+	} else if (!(strcasecmp(field_str, CAPTURE_SAMPLE_RATE))) {
+		f = Config_CAPTURE_SAMPLE_RATE;
+	} else if (!(strcasecmp(field_str, TRACE_SAMPLE_RATE))) {
+		f = Config_TRACE_SAMPLE_RATE;
+	} else if (!(strcasecmp(field_str, EFFECTS_THRESHOLD))) {
+		f = Config_EFFECTS_THRESHOLD;
+	} else if (!(strcasecmp(field_str, QUERY_COST_LIMIT))) {
+		f = Config_QUERY_COST_LIMIT;
+	} else if (!(strcasecmp(field_str, HEAVY_QUERY_COST))) {
+		f = Config_HEAVY_QUERY_COST;
+	} else if (!(strcasecmp(field_str, DERIVED_ADJACENCY))) {
+		f = Config_DERIVED_ADJACENCY;
+	} else if (!(strcasecmp(field_str, ADAPTIVE_TRANSPOSE))) {
+		f = Config_ADAPTIVE_TRANSPOSE;
+	} else if (!(strcasecmp(field_str, CHANGE_STREAM_LENGTH))) {
+		f = Config_CHANGE_STREAM_LENGTH;
+	} else if (!(strcasecmp(field_str, WARM_PLAN_COUNT))) {
+		f = Config_WARM_PLAN_COUNT;
+	} else if (!(strcasecmp(field_str, READER_AFFINITY))) {
+		f = Config_READER_AFFINITY;
+	} else if (!(strcasecmp(field_str, WRITER_AFFINITY))) {
+		f = Config_WRITER_AFFINITY;
+	} else if (!(strcasecmp(field_str, OMP_AFFINITY))) {
+		f = Config_OMP_AFFINITY;
+	} else if (!(strcasecmp(field_str, REPLAN_FACTOR))) {
+		f = Config_REPLAN_FACTOR;
+	} else if (!(strcasecmp(field_str, COMPILE_THRESHOLD))) {
+		f = Config_COMPILE_THRESHOLD;
+	} else if (!(strcasecmp(field_str, COMPRESSION_THRESHOLD))) {
+		f = Config_COMPRESSION_THRESHOLD;
 	} else {
 		return false;
 	}
@@ -331,56 +800,235 @@ const char *Config_Field_name(Config_Option_Field field) {
 			name = DELTA_MAX_PENDING_CHANGES;
 			break;
 
-        //----------------------------------------------------------------------
-        // invalid option
-        //----------------------------------------------------------------------
+		case Config_RESULTSET_CHUNK_SIZE:
+			name = RESULTSET_CHUNK_SIZE;
+			break;
 
-        default :
-			ASSERT("invalid option field" && false);
-            break;
-    }
+		case Config_QUERY_PARALLELISM:
+			name = QUERY_PARALLELISM;
+			break;
 
-	return name;
-}
+		case Config_MAX_TRAVERSE_BATCH_SIZE:
+			name = MAX_TRAVERSE_BATCH_SIZE;
+			break;
 
-// initialize every module-level configuration to its default value
-void _Config_SetToDefaults(void) {
-	// the thread pool's default size is equal to the system's number of cores
-	int CPUCount = sysconf(_SC_NPROCESSORS_ONLN);
-	config.thread_pool_size = (CPUCount != -1) ? CPUCount : 1;
+		case Config_WRITE_BATCH_SIZE:
+			name = WRITE_BATCH_SIZE;
+			break;
 
-	// use the GraphBLAS-defined number of OpenMP threads by default
-	GxB_get(GxB_NTHREADS, &config.omp_thread_count);
+		case Config_DELTA_COMPACTION_RATIO:
+			name = DELTA_COMPACTION_RATIO;
+			break;
 
-	// the default entity count of virtual keys
-	config.vkey_entity_count = VKEY_MAX_ENTITY_COUNT_DEFAULT;
+		case Config_RESULTSET_CACHE_SIZE:
+			name = RESULTSET_CACHE_SIZE;
+			break;
 
-	// MEMCHECK compile flag;
-	#ifdef MEMCHECK
-		// disable async delete during memcheck
-		config.async_delete = false;
-	#else
-		// always perform async delete when no checking for memory issues
-		config.async_delete = true;
-	#endif
+		case Config_NATIVE_INDEX:
+			name = NATIVE_INDEX;
+			break;
 
-	config.cache_size = CACHE_SIZE_DEFAULT;
+		case Config_ASYNC_INDEX_THRESHOLD:
+			name = ASYNC_INDEX_THRESHOLD;
+			break;
 
-	// no limit on result-set size
-	config.resultset_size = RESULTSET_SIZE_UNLIMITED;
+		case Config_HUGE_PAGES:
+			name = HUGE_PAGES;
+			break;
 
-	// no query timeout by default
-	config.timeout = CONFIG_TIMEOUT_NO_TIMEOUT;
+		case Config_COLD_STORAGE_THRESHOLD:
+			name = COLD_STORAGE_THRESHOLD;
+			break;
 
-	// no limit on number of queued queries by default
-	config.max_queued_queries = QUEUED_QUERIES_UNLIMITED;
+		case Config_PLAN_STATS_SAMPLE_RATE:
+			name = PLAN_STATS_SAMPLE_RATE;
+			break;
 
-	// no limit on query memory capacity
-	config.query_mem_capacity = QUERY_MEM_CAPACITY_UNLIMITED;
+		case Config_CAPTURE_SAMPLE_RATE:
+			name = CAPTURE_SAMPLE_RATE;
+			break;
 
-	// number of pending changed befor RG_Matrix flushed
-	config.delta_max_pending_changes = DELTA_MAX_PENDING_CHANGES_DEFAULT;
-}
+		case Config_TRACE_SAMPLE_RATE:
+			name = TRACE_SAMPLE_RATE;
+			break;
+
+		case Config_EFFECTS_THRESHOLD:
+			name = EFFECTS_THRESHOLD;
+			break;
+
+		case Config_QUERY_COST_LIMIT:
+			name = QUERY_COST_LIMIT;
+			break;
+
+		case Config_HEAVY_QUERY_COST:
+			name = HEAVY_QUERY_COST;
+			break;
+
+		case Config_DERIVED_ADJACENCY:
+			name = DERIVED_ADJACENCY;
+			break;
+
+		case Config_ADAPTIVE_TRANSPOSE:
+			name = ADAPTIVE_TRANSPOSE;
+			break;
+
+		case Config_CHANGE_STREAM_LENGTH:
+			name = CHANGE_STREAM_LENGTH;
+			break;
+
+		case Config_WARM_PLAN_COUNT:
+			name = WARM_PLAN_COUNT;
+			break;
+
+		case Config_READER_AFFINITY:
+			name = READER_AFFINITY;
+			break;
+
+		case Config_WRITER_AFFINITY:
+			name = WRITER_AFFINITY;
+			break;
+
+		case Config_OMP_AFFINITY:
+			name = OMP_AFFINITY;
+			break;
+
+		case Config_REPLAN_FACTOR:
+			name = REPLAN_FACTOR;
+			break;
+
+		case Config_COMPILE_THRESHOLD:
+			name = COMPILE_THRESHOLD;
+			break;
+
+		case Config_COMPRESSION_THRESHOLD:
+			name = COMPRESSION_THRESHOLD;
+			break;
+
+        //----------------------------------------------------------------------
+        // invalid option
+        //----------------------------------------------------------------------
+
+        default :
+			ASSERT("invalid option field" && false);
+            break;
+    }
+
+	return name;
+}
+
+// initialize every module-level configuration to its default value
+void _Config_SetToDefaults(void) {
+	// the thread pool's default size is equal to the system's number of cores
+	int CPUCount = sysconf(_SC_NPROCESSORS_ONLN);
+	config.thread_pool_size = (CPUCount != -1) ? CPUCount : 1;
+
+	// use the GraphBLAS-defined number of OpenMP threads by default
+	GxB_get(GxB_NTHREADS, &config.omp_thread_count);
+
+	// the default entity count of virtual keys
+	config.vkey_entity_count = VKEY_MAX_ENTITY_COUNT_DEFAULT;
+
+	// MEMCHECK compile flag;
+	#ifdef MEMCHECK
+		// disable async delete during memcheck
+		config.async_delete = false;
+	#else
+		// always perform async delete when no checking for memory issues
+		config.async_delete = true;
+	#endif
+
+	config.cache_size = CACHE_SIZE_DEFAULT;
+
+	// no limit on result-set size
+	config.resultset_size = RESULTSET_SIZE_UNLIMITED;
+
+	// no query timeout by default
+	config.timeout = CONFIG_TIMEOUT_NO_TIMEOUT;
+
+	// no limit on number of queued queries by default
+	config.max_queued_queries = QUEUED_QUERIES_UNLIMITED;
+
+	// no limit on query memory capacity
+	config.query_mem_capacity = QUERY_MEM_CAPACITY_UNLIMITED;
+
+	// number of pending changed befor RG_Matrix flushed
+	config.delta_max_pending_changes = DELTA_MAX_PENDING_CHANGES_DEFAULT;
+
+	// buffer the entire result-set by default
+	config.resultset_chunk_size = RESULTSET_CHUNK_SIZE_DISABLED;
+
+	// queries are executed by a single thread by default
+	config.query_parallelism = QUERY_PARALLELISM_DEFAULT;
+
+	// traversal batches grow up to 1024 records by default
+	config.max_traverse_batch_size = MAX_TRAVERSE_BATCH_SIZE_DEFAULT;
+
+	// each write query commits on its own by default
+	config.write_batch_size = WRITE_BATCH_SIZE_DEFAULT;
+
+	// compact matrices half way to a foreground flush
+	config.delta_compaction_ratio = DELTA_COMPACTION_RATIO_DEFAULT;
+
+	// results are not cached by default
+	config.resultset_cache_size = RESULTSET_CACHE_SIZE_DEFAULT;
+
+	// exact-match indices rely on RediSearch alone by default
+	config.native_index = false;
+
+	// labels holding fewer entities are indexed inline
+	config.async_index_threshold = ASYNC_INDEX_THRESHOLD_DEFAULT;
+
+	// huge pages are disabled by default
+	config.huge_pages = false;
+
+	// string properties are kept in RAM by default
+	config.cold_storage_threshold = COLD_STORAGE_THRESHOLD_DEFAULT;
+
+	// sample one in every 100 executions
+	config.plan_stats_sample_rate = PLAN_STATS_SAMPLE_RATE_DEFAULT;
+
+	// query capture is disabled by default
+	config.capture_sample_rate = CAPTURE_SAMPLE_RATE_DEFAULT;
+
+	// query traces are not kept by default
+	config.trace_sample_rate = TRACE_SAMPLE_RATE_DEFAULT;
+
+	// write queries running for at least 300µs are replicated via effects
+	config.effects_threshold = EFFECTS_THRESHOLD_DEFAULT;
+
+	// queries are admitted regardless of their estimated cost by default
+	config.query_cost_limit = QUERY_COST_UNLIMITED;
+
+	// all read-only queries are executed by the readers by default
+	config.heavy_query_cost = HEAVY_QUERY_COST_DISABLED;
+
+	// the adjacency matrix is maintained along with the relation matrices
+	config.derived_adjacency = false;
+
+	// every relation matrix maintains its transpose
+	config.adaptive_transpose = false;
+
+	// committed modifications aren't streamed
+	config.change_stream_length = CHANGE_STREAM_DISABLED;
+
+	// plan caches start out empty after load
+	config.warm_plan_count = WARM_PLAN_COUNT_DISABLED;
+
+	// threads may run on any CPU by default
+	config.reader_affinity = CPU_AFFINITY_DISABLED;
+	config.writer_affinity = CPU_AFFINITY_DISABLED;
+	config.omp_affinity    = CPU_AFFINITY_DISABLED;
+
+	// cached plans are re-planned once a sampled execution observes
+	// 100 times the records expected
+	config.replan_factor = REPLAN_FACTOR_DEFAULT;
+
+	// cached plans are compiled once executed 10 times
+	config.compile_threshold = COMPILE_THRESHOLD_DEFAULT;
+
+	// string properties are stored uncompressed
+	config.compression_threshold = COMPRESSION_THRESHOLD_DEFAULT;
+}
 
 int Config_Init(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	// make sure reconfiguration callback is already registered
@@ -583,151 +1231,871 @@ bool Config_Option_get(Config_Option_Field field, ...) {
 			}
 			break;
 
-        //----------------------------------------------------------------------
-        // invalid option
-        //----------------------------------------------------------------------
+		//----------------------------------------------------------------------
+		// result-set chunk size
+		//----------------------------------------------------------------------
 
-        default :
-			ASSERT("invalid option field" && false);
-			return false;
-    }
+		case Config_RESULTSET_CHUNK_SIZE:
+			{
+				va_start(ap, field);
+				uint64_t *resultset_chunk_size = va_arg(ap, uint64_t *);
+				va_end(ap);
 
-	return true;
-}
+				ASSERT(resultset_chunk_size != NULL);
+				(*resultset_chunk_size) = Config_resultset_chunk_size_get();
+			}
+			break;
 
-bool Config_Option_set(Config_Option_Field field, const char *val) {
-	//--------------------------------------------------------------------------
-	// set the option
-	//--------------------------------------------------------------------------
+		//----------------------------------------------------------------------
+		// query parallelism
+		//----------------------------------------------------------------------
+
+		case Config_QUERY_PARALLELISM:
+			{
+				va_start(ap, field);
+				uint64_t *query_parallelism = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(query_parallelism != NULL);
+				(*query_parallelism) = Config_query_parallelism_get();
+			}
+			break;
 
-	switch (field)
-	{
 		//----------------------------------------------------------------------
-		// max queued queries
+		// max traverse batch size
 		//----------------------------------------------------------------------
 
-		case Config_MAX_QUEUED_QUERIES:
+		case Config_MAX_TRAVERSE_BATCH_SIZE:
 			{
-				long long max_queued_queries;
-				if(!_Config_ParsePositiveInteger(val, &max_queued_queries)) {
-					return false;
-				}
-				Config_max_queued_queries_set(max_queued_queries);
+				va_start(ap, field);
+				uint64_t *max_traverse_batch_size = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(max_traverse_batch_size != NULL);
+				(*max_traverse_batch_size) = Config_max_traverse_batch_size_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// timeout
+		// write batch size
 		//----------------------------------------------------------------------
 
-		case Config_TIMEOUT:
+		case Config_WRITE_BATCH_SIZE:
 			{
-				long long timeout;
-				if(!_Config_ParseNonNegativeInteger(val, &timeout)) return false;
-				Config_timeout_set(timeout);
+				va_start(ap, field);
+				uint64_t *write_batch_size = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(write_batch_size != NULL);
+				(*write_batch_size) = Config_write_batch_size_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// cache size
+		// delta compaction ratio
 		//----------------------------------------------------------------------
 
-		case Config_CACHE_SIZE:
+		case Config_DELTA_COMPACTION_RATIO:
 			{
-				long long cache_size;
-				if(!_Config_ParsePositiveInteger(val, &cache_size)) return false;
-				Config_cache_size_set(cache_size);
+				va_start(ap, field);
+				uint64_t *delta_compaction_ratio = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(delta_compaction_ratio != NULL);
+				(*delta_compaction_ratio) = Config_delta_compaction_ratio_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// OpenMP thread count
+		// resultset cache size
 		//----------------------------------------------------------------------
 
-		case Config_OPENMP_NTHREAD:
+		case Config_RESULTSET_CACHE_SIZE:
 			{
-				long long omp_nthreads;
-				if(!_Config_ParsePositiveInteger(val, &omp_nthreads)) return false;
+				va_start(ap, field);
+				uint64_t *resultset_cache_size = va_arg(ap, uint64_t *);
+				va_end(ap);
 
-				Config_OMP_thread_count_set(omp_nthreads);
+				ASSERT(resultset_cache_size != NULL);
+				(*resultset_cache_size) = Config_resultset_cache_size_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// thread-pool size
+		// native index
 		//----------------------------------------------------------------------
 
-		case Config_THREAD_POOL_SIZE:
+		case Config_NATIVE_INDEX:
 			{
-				long long pool_nthreads;
-				if(!_Config_ParsePositiveInteger(val, &pool_nthreads)) return false;
+				va_start(ap, field);
+				bool *native_index = va_arg(ap, bool *);
+				va_end(ap);
 
-				Config_thread_pool_size_set(pool_nthreads);
+				ASSERT(native_index != NULL);
+				(*native_index) = Config_native_index_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// result-set size
+		// async index threshold
 		//----------------------------------------------------------------------
 
-		case Config_RESULTSET_MAX_SIZE:
+		case Config_ASYNC_INDEX_THRESHOLD:
 			{
-				long long resultset_max_size;
-				if(!_Config_ParseInteger(val, &resultset_max_size)) return false;
+				va_start(ap, field);
+				uint64_t *async_index_threshold = va_arg(ap, uint64_t *);
+				va_end(ap);
 
-				Config_resultset_max_size_set(resultset_max_size);
+				ASSERT(async_index_threshold != NULL);
+				(*async_index_threshold) = Config_async_index_threshold_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// virtual key entity count
+		// huge pages
 		//----------------------------------------------------------------------
 
-		case Config_VKEY_MAX_ENTITY_COUNT:
+		case Config_HUGE_PAGES:
 			{
-				long long vkey_max_entity_count;
-				if(!_Config_ParseNonNegativeInteger(val, &vkey_max_entity_count)) return false;
+				va_start(ap, field);
+				bool *huge_pages = va_arg(ap, bool *);
+				va_end(ap);
 
-				Config_virtual_key_entity_count_set(vkey_max_entity_count);
+				ASSERT(huge_pages != NULL);
+				(*huge_pages) = Config_huge_pages_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// async deleteion
+		// cold storage threshold
 		//----------------------------------------------------------------------
 
-		case Config_ASYNC_DELETE:
+		case Config_COLD_STORAGE_THRESHOLD:
 			{
-				bool async_delete;
-				if(!_Config_ParseYesNo(val, &async_delete)) return false;
+				va_start(ap, field);
+				uint64_t *cold_storage_threshold = va_arg(ap, uint64_t *);
+				va_end(ap);
 
-				Config_async_delete_set(async_delete);
+				ASSERT(cold_storage_threshold != NULL);
+				(*cold_storage_threshold) = Config_cold_storage_threshold_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// query mem capacity
+		// plan stats sample rate
 		//----------------------------------------------------------------------
 
-		case Config_QUERY_MEM_CAPACITY:
+		case Config_PLAN_STATS_SAMPLE_RATE:
 			{
-				long long query_mem_capacity;
-				if (!_Config_ParseNonNegativeInteger(val, &query_mem_capacity)) return false;
+				va_start(ap, field);
+				uint64_t *plan_stats_sample_rate = va_arg(ap, uint64_t *);
+				va_end(ap);
 
-				Config_query_mem_capacity_set(query_mem_capacity);
+				ASSERT(plan_stats_sample_rate != NULL);
+				(*plan_stats_sample_rate) = Config_plan_stats_sample_rate_get();
 			}
 			break;
 
 		//----------------------------------------------------------------------
-		// number of pending changed befor RG_Matrix flushed
+		// capture sample rate
 		//----------------------------------------------------------------------
 
-		case Config_DELTA_MAX_PENDING_CHANGES:
+		case Config_CAPTURE_SAMPLE_RATE:
 			{
-				long long delta_max_pending_changes;
-				if (!_Config_ParseNonNegativeInteger(val, &delta_max_pending_changes)) return false;
+				va_start(ap, field);
+				uint64_t *capture_sample_rate = va_arg(ap, uint64_t *);
+				va_end(ap);
 
-				Config_delta_max_pending_changes_set(delta_max_pending_changes);
+				ASSERT(capture_sample_rate != NULL);
+				(*capture_sample_rate) = Config_capture_sample_rate_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// trace sample rate
+		//----------------------------------------------------------------------
+
+		case Config_TRACE_SAMPLE_RATE:
+			{
+				va_start(ap, field);
+				uint64_t *trace_sample_rate = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(trace_sample_rate != NULL);
+				(*trace_sample_rate) = Config_trace_sample_rate_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// effects threshold
+		//----------------------------------------------------------------------
+
+		case Config_EFFECTS_THRESHOLD:
+			{
+				va_start(ap, field);
+				uint64_t *effects_threshold = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(effects_threshold != NULL);
+				(*effects_threshold) = Config_effects_threshold_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// query cost limit
+		//----------------------------------------------------------------------
+
+		case Config_QUERY_COST_LIMIT:
+			{
+				va_start(ap, field);
+				uint64_t *query_cost_limit = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(query_cost_limit != NULL);
+				(*query_cost_limit) = Config_query_cost_limit_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// heavy query cost
+		//----------------------------------------------------------------------
+
+		case Config_HEAVY_QUERY_COST:
+			{
+				va_start(ap, field);
+				uint64_t *heavy_query_cost = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(heavy_query_cost != NULL);
+				(*heavy_query_cost) = Config_heavy_query_cost_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// derived adjacency
+		//----------------------------------------------------------------------
+
+		case Config_DERIVED_ADJACENCY:
+			{
+				va_start(ap, field);
+				bool *derived_adjacency = va_arg(ap, bool *);
+				va_end(ap);
+
+				ASSERT(derived_adjacency != NULL);
+				(*derived_adjacency) = Config_derived_adjacency_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// adaptive transpose
+		//----------------------------------------------------------------------
+
+		case Config_ADAPTIVE_TRANSPOSE:
+			{
+				va_start(ap, field);
+				bool *adaptive_transpose = va_arg(ap, bool *);
+				va_end(ap);
+
+				ASSERT(adaptive_transpose != NULL);
+				(*adaptive_transpose) = Config_adaptive_transpose_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// change stream length
+		//----------------------------------------------------------------------
+
+		case Config_CHANGE_STREAM_LENGTH:
+			{
+				va_start(ap, field);
+				uint64_t *change_stream_length = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(change_stream_length != NULL);
+				(*change_stream_length) = Config_change_stream_length_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// warm plan count
+		//----------------------------------------------------------------------
+
+		case Config_WARM_PLAN_COUNT:
+			{
+				va_start(ap, field);
+				uint64_t *warm_plan_count = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(warm_plan_count != NULL);
+				(*warm_plan_count) = Config_warm_plan_count_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// CPU affinity
+		//----------------------------------------------------------------------
+
+		case Config_READER_AFFINITY:
+			{
+				va_start(ap, field);
+				uint64_t *reader_affinity = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(reader_affinity != NULL);
+				(*reader_affinity) = Config_reader_affinity_get();
+			}
+			break;
+
+		case Config_WRITER_AFFINITY:
+			{
+				va_start(ap, field);
+				uint64_t *writer_affinity = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(writer_affinity != NULL);
+				(*writer_affinity) = Config_writer_affinity_get();
+			}
+			break;
+
+		case Config_OMP_AFFINITY:
+			{
+				va_start(ap, field);
+				uint64_t *omp_affinity = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(omp_affinity != NULL);
+				(*omp_affinity) = Config_omp_affinity_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// replan factor
+		//----------------------------------------------------------------------
+
+		case Config_REPLAN_FACTOR:
+			{
+				va_start(ap, field);
+				uint64_t *replan_factor = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(replan_factor != NULL);
+				(*replan_factor) = Config_replan_factor_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// compile threshold
+		//----------------------------------------------------------------------
+
+		case Config_COMPILE_THRESHOLD:
+			{
+				va_start(ap, field);
+				uint64_t *compile_threshold = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(compile_threshold != NULL);
+				(*compile_threshold) = Config_compile_threshold_get();
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// compression threshold
+		//----------------------------------------------------------------------
+
+		case Config_COMPRESSION_THRESHOLD:
+			{
+				va_start(ap, field);
+				uint64_t *compression_threshold = va_arg(ap, uint64_t *);
+				va_end(ap);
+
+				ASSERT(compression_threshold != NULL);
+				(*compression_threshold) = Config_compression_threshold_get();
+			}
+			break;
+
+        //----------------------------------------------------------------------
+        // invalid option
+        //----------------------------------------------------------------------
+
+        default :
+			ASSERT("invalid option field" && false);
+			return false;
+    }
+
+	return true;
+}
+
+bool Config_Option_set(Config_Option_Field field, const char *val) {
+	//--------------------------------------------------------------------------
+	// set the option
+	//--------------------------------------------------------------------------
+
+	switch (field)
+	{
+		//----------------------------------------------------------------------
+		// max queued queries
+		//----------------------------------------------------------------------
+
+		case Config_MAX_QUEUED_QUERIES:
+			{
+				long long max_queued_queries;
+				if(!_Config_ParsePositiveInteger(val, &max_queued_queries)) {
+					return false;
+				}
+				Config_max_queued_queries_set(max_queued_queries);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// timeout
+		//----------------------------------------------------------------------
+
+		case Config_TIMEOUT:
+			{
+				long long timeout;
+				if(!_Config_ParseNonNegativeInteger(val, &timeout)) return false;
+				Config_timeout_set(timeout);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// cache size
+		//----------------------------------------------------------------------
+
+		case Config_CACHE_SIZE:
+			{
+				long long cache_size;
+				if(!_Config_ParsePositiveInteger(val, &cache_size)) return false;
+				Config_cache_size_set(cache_size);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// OpenMP thread count
+		//----------------------------------------------------------------------
+
+		case Config_OPENMP_NTHREAD:
+			{
+				long long omp_nthreads;
+				if(!_Config_ParsePositiveInteger(val, &omp_nthreads)) return false;
+
+				Config_OMP_thread_count_set(omp_nthreads);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// thread-pool size
+		//----------------------------------------------------------------------
+
+		case Config_THREAD_POOL_SIZE:
+			{
+				long long pool_nthreads;
+				if(!_Config_ParsePositiveInteger(val, &pool_nthreads)) return false;
+
+				// once created, the readers can't outgrow their capacity
+				uint capacity = ThreadPools_ReadersCapacity();
+				if(capacity > 0 && pool_nthreads > capacity) return false;
+
+				Config_thread_pool_size_set(pool_nthreads);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// result-set size
+		//----------------------------------------------------------------------
+
+		case Config_RESULTSET_MAX_SIZE:
+			{
+				long long resultset_max_size;
+				if(!_Config_ParseInteger(val, &resultset_max_size)) return false;
+
+				Config_resultset_max_size_set(resultset_max_size);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// virtual key entity count
+		//----------------------------------------------------------------------
+
+		case Config_VKEY_MAX_ENTITY_COUNT:
+			{
+				long long vkey_max_entity_count;
+				if(!_Config_ParseNonNegativeInteger(val, &vkey_max_entity_count)) return false;
+
+				Config_virtual_key_entity_count_set(vkey_max_entity_count);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// async deleteion
+		//----------------------------------------------------------------------
+
+		case Config_ASYNC_DELETE:
+			{
+				bool async_delete;
+				if(!_Config_ParseYesNo(val, &async_delete)) return false;
+
+				Config_async_delete_set(async_delete);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// query mem capacity
+		//----------------------------------------------------------------------
+
+		case Config_QUERY_MEM_CAPACITY:
+			{
+				long long query_mem_capacity;
+				if (!_Config_ParseNonNegativeInteger(val, &query_mem_capacity)) return false;
+
+				Config_query_mem_capacity_set(query_mem_capacity);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// number of pending changed befor RG_Matrix flushed
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_MAX_PENDING_CHANGES:
+			{
+				long long delta_max_pending_changes;
+				if (!_Config_ParseNonNegativeInteger(val, &delta_max_pending_changes)) return false;
+
+				Config_delta_max_pending_changes_set(delta_max_pending_changes);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// result-set chunk size
+		//----------------------------------------------------------------------
+
+		case Config_RESULTSET_CHUNK_SIZE:
+			{
+				long long resultset_chunk_size;
+				if (!_Config_ParseNonNegativeInteger(val, &resultset_chunk_size)) return false;
+
+				Config_resultset_chunk_size_set(resultset_chunk_size);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// query parallelism
+		//----------------------------------------------------------------------
+
+		case Config_QUERY_PARALLELISM:
+			{
+				long long query_parallelism;
+				if (!_Config_ParsePositiveInteger(val, &query_parallelism)) return false;
+
+				Config_query_parallelism_set(query_parallelism);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// max traverse batch size
+		//----------------------------------------------------------------------
+
+		case Config_MAX_TRAVERSE_BATCH_SIZE:
+			{
+				long long max_traverse_batch_size;
+				if (!_Config_ParsePositiveInteger(val, &max_traverse_batch_size)) return false;
+
+				Config_max_traverse_batch_size_set(max_traverse_batch_size);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// write batch size
+		//----------------------------------------------------------------------
+
+		case Config_WRITE_BATCH_SIZE:
+			{
+				long long write_batch_size;
+				if (!_Config_ParsePositiveInteger(val, &write_batch_size)) return false;
+
+				Config_write_batch_size_set(write_batch_size);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// delta compaction ratio
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_COMPACTION_RATIO:
+			{
+				long long delta_compaction_ratio;
+				if (!_Config_ParseNonNegativeInteger(val, &delta_compaction_ratio)) return false;
+
+				Config_delta_compaction_ratio_set(delta_compaction_ratio);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// resultset cache size
+		//----------------------------------------------------------------------
+
+		case Config_RESULTSET_CACHE_SIZE:
+			{
+				long long resultset_cache_size;
+				if (!_Config_ParseNonNegativeInteger(val, &resultset_cache_size)) return false;
+
+				Config_resultset_cache_size_set(resultset_cache_size);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// native index
+		//----------------------------------------------------------------------
+
+		case Config_NATIVE_INDEX:
+			{
+				bool native_index;
+				if(!_Config_ParseYesNo(val, &native_index)) return false;
+
+				Config_native_index_set(native_index);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// async index threshold
+		//----------------------------------------------------------------------
+
+		case Config_ASYNC_INDEX_THRESHOLD:
+			{
+				long long async_index_threshold;
+				if (!_Config_ParseNonNegativeInteger(val, &async_index_threshold)) return false;
+
+				Config_async_index_threshold_set(async_index_threshold);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// huge pages
+		//----------------------------------------------------------------------
+
+		case Config_HUGE_PAGES:
+			{
+				bool huge_pages;
+				if(!_Config_ParseYesNo(val, &huge_pages)) return false;
+
+				Config_huge_pages_set(huge_pages);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// cold storage threshold
+		//----------------------------------------------------------------------
+
+		case Config_COLD_STORAGE_THRESHOLD:
+			{
+				long long cold_storage_threshold;
+				if (!_Config_ParseNonNegativeInteger(val, &cold_storage_threshold)) return false;
+
+				Config_cold_storage_threshold_set(cold_storage_threshold);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// plan stats sample rate
+		//----------------------------------------------------------------------
+
+		case Config_PLAN_STATS_SAMPLE_RATE:
+			{
+				long long plan_stats_sample_rate;
+				if (!_Config_ParseNonNegativeInteger(val, &plan_stats_sample_rate)) return false;
+
+				Config_plan_stats_sample_rate_set(plan_stats_sample_rate);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// capture sample rate
+		//----------------------------------------------------------------------
+
+		case Config_CAPTURE_SAMPLE_RATE:
+			{
+				long long capture_sample_rate;
+				if (!_Config_ParseNonNegativeInteger(val, &capture_sample_rate)) return false;
+
+				Config_capture_sample_rate_set(capture_sample_rate);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// trace sample rate
+		//----------------------------------------------------------------------
+
+		case Config_TRACE_SAMPLE_RATE:
+			{
+				long long trace_sample_rate;
+				if (!_Config_ParseNonNegativeInteger(val, &trace_sample_rate)) return false;
+
+				Config_trace_sample_rate_set(trace_sample_rate);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// effects threshold
+		//----------------------------------------------------------------------
+
+		case Config_EFFECTS_THRESHOLD:
+			{
+				long long effects_threshold;
+				if (!_Config_ParseNonNegativeInteger(val, &effects_threshold)) return false;
+
+				Config_effects_threshold_set(effects_threshold);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// query cost limit
+		//----------------------------------------------------------------------
+
+		case Config_QUERY_COST_LIMIT:
+			{
+				long long query_cost_limit;
+				if (!_Config_ParseNonNegativeInteger(val, &query_cost_limit)) return false;
+
+				Config_query_cost_limit_set(query_cost_limit);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// heavy query cost
+		//----------------------------------------------------------------------
+
+		case Config_HEAVY_QUERY_COST:
+			{
+				long long heavy_query_cost;
+				if (!_Config_ParseNonNegativeInteger(val, &heavy_query_cost)) return false;
+
+				Config_heavy_query_cost_set(heavy_query_cost);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// derived adjacency
+		//----------------------------------------------------------------------
+
+		case Config_DERIVED_ADJACENCY:
+			{
+				bool derived_adjacency;
+				if(!_Config_ParseYesNo(val, &derived_adjacency)) return false;
+
+				Config_derived_adjacency_set(derived_adjacency);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// adaptive transpose
+		//----------------------------------------------------------------------
+
+		case Config_ADAPTIVE_TRANSPOSE:
+			{
+				bool adaptive_transpose;
+				if(!_Config_ParseYesNo(val, &adaptive_transpose)) return false;
+
+				Config_adaptive_transpose_set(adaptive_transpose);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// change stream length
+		//----------------------------------------------------------------------
+
+		case Config_CHANGE_STREAM_LENGTH:
+			{
+				long long change_stream_length;
+				if(!_Config_ParseNonNegativeInteger(val, &change_stream_length)) return false;
+
+				Config_change_stream_length_set(change_stream_length);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// warm plan count
+		//----------------------------------------------------------------------
+
+		case Config_WARM_PLAN_COUNT:
+			{
+				long long warm_plan_count;
+				if(!_Config_ParseNonNegativeInteger(val, &warm_plan_count)) return false;
+
+				Config_warm_plan_count_set(warm_plan_count);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// CPU affinity
+		//----------------------------------------------------------------------
+
+		case Config_READER_AFFINITY:
+			{
+				uint64_t reader_affinity;
+				if(!_Config_ParseCPUMask(val, &reader_affinity)) return false;
+
+				Config_reader_affinity_set(reader_affinity);
+			}
+			break;
+
+		case Config_WRITER_AFFINITY:
+			{
+				uint64_t writer_affinity;
+				if(!_Config_ParseCPUMask(val, &writer_affinity)) return false;
+
+				Config_writer_affinity_set(writer_affinity);
+			}
+			break;
+
+		case Config_OMP_AFFINITY:
+			{
+				uint64_t omp_affinity;
+				if(!_Config_ParseCPUMask(val, &omp_affinity)) return false;
+
+				Config_omp_affinity_set(omp_affinity);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// replan factor
+		//----------------------------------------------------------------------
+
+		case Config_REPLAN_FACTOR:
+			{
+				long long replan_factor;
+				if(!_Config_ParseNonNegativeInteger(val, &replan_factor)) return false;
+
+				Config_replan_factor_set(replan_factor);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// compile threshold
+		//----------------------------------------------------------------------
+
+		case Config_COMPILE_THRESHOLD:
+			{
+				long long compile_threshold;
+				if(!_Config_ParseNonNegativeInteger(val, &compile_threshold)) {
+					return false;
+				}
+
+				Config_compile_threshold_set(compile_threshold);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// compression threshold
+		//----------------------------------------------------------------------
+
+		case Config_COMPRESSION_THRESHOLD:
+			{
+				long long compression_threshold;
+				if(!_Config_ParseNonNegativeInteger(val, &compression_threshold)) {
+					return false;
+				}
+
+				Config_compression_threshold_set(compression_threshold);
 			}
 			break;
 
@@ -14,6 +14,28 @@
 #define CONFIG_TIMEOUT_NO_TIMEOUT          0
 #define VKEY_ENTITY_COUNT_UNLIMITED        UINT64_MAX
 #define DELTA_MAX_PENDING_CHANGES_DEFAULT  10000
+#define RESULTSET_CHUNK_SIZE_DISABLED      0
+#define QUERY_PARALLELISM_DEFAULT          1
+#define MAX_TRAVERSE_BATCH_SIZE_DEFAULT    1024
+#define WRITE_BATCH_SIZE_DEFAULT           1
+#define DELTA_COMPACTION_RATIO_DEFAULT     50
+#define RESULTSET_CACHE_SIZE_DEFAULT       0
+#define ASYNC_INDEX_THRESHOLD_DEFAULT      100000
+#define COLD_STORAGE_THRESHOLD_DEFAULT     0
+#define PLAN_STATS_SAMPLE_RATE_DEFAULT     100
+#define CAPTURE_SAMPLE_RATE_DEFAULT        0
+#define TRACE_SAMPLE_RATE_DEFAULT          0
+#define EFFECTS_THRESHOLD_DEFAULT          300
+#define QUERY_COST_UNLIMITED               0
+#define HEAVY_QUERY_COST_DISABLED          0
+#define CHANGE_STREAM_DISABLED             0
+#define WARM_PLAN_COUNT_DISABLED           0
+#define CPU_AFFINITY_DISABLED              0
+#define REPLAN_FACTOR_DEFAULT              100
+#define REPLAN_DISABLED                    0
+#define COMPILE_THRESHOLD_DEFAULT          10
+#define COMPILE_DISABLED                   0
+#define COMPRESSION_THRESHOLD_DEFAULT      0
 
 typedef enum {
 	Config_TIMEOUT                   = 0,     // timeout value for queries
@@ -26,7 +48,33 @@ typedef enum {
 	Config_MAX_QUEUED_QUERIES        = 7,     // max number of queued queries
 	Config_QUERY_MEM_CAPACITY        = 8,     // max mem(bytes) that query/thread can utilize at any given time
 	Config_DELTA_MAX_PENDING_CHANGES = 9,    // number of pending changed befor RG_Matrix flushed
-	Config_END_MARKER                = 10
+	Config_RESULTSET_CHUNK_SIZE      = 10,    // number of rows buffered before streaming them to the client
+	Config_QUERY_PARALLELISM         = 11,    // max number of threads a query scan can utilize
+	Config_MAX_TRAVERSE_BATCH_SIZE   = 12,    // max number of records batched by a traversal
+	Config_WRITE_BATCH_SIZE          = 13,    // max number of write queries sharing a commit
+	Config_DELTA_COMPACTION_RATIO    = 14,    // pending changes percentage triggering background compaction
+	Config_RESULTSET_CACHE_SIZE      = 15,    // number of read-only query results cached per graph
+	Config_NATIVE_INDEX              = 16,    // maintain native ordered exact-match indices
+	Config_ASYNC_INDEX_THRESHOLD     = 17,    // minimum number of entities indexed in the background
+	Config_HUGE_PAGES                = 18,    // back large allocations with transparent huge pages
+	Config_COLD_STORAGE_THRESHOLD    = 19,    // minimum length of string properties kept in memory-mapped storage
+	Config_PLAN_STATS_SAMPLE_RATE    = 20,    // sample one in every N executions of a cached plan
+	Config_CAPTURE_SAMPLE_RATE       = 21,    // capture one in every N executed queries
+	Config_TRACE_SAMPLE_RATE         = 22,    // keep the phase trace of one in every N executed queries
+	Config_EFFECTS_THRESHOLD         = 23,    // minimum write query execution time (µs) replicated via effects
+	Config_QUERY_COST_LIMIT          = 24,    // max estimated query cost admitted for execution
+	Config_HEAVY_QUERY_COST          = 25,    // minimum estimated cost of read-only queries executed by the heavy pool
+	Config_DERIVED_ADJACENCY         = 26,    // compute the adjacency matrix from the relation matrices on demand
+	Config_ADAPTIVE_TRANSPOSE        = 27,    // maintain transposed relation matrices only while reverse traversals use them
+	Config_CHANGE_STREAM_LENGTH      = 28,    // max number of entries kept in each graph's change stream, 0 disables
+	Config_WARM_PLAN_COUNT           = 29,    // number of each graph's most executed queries re-planned after load, 0 disables
+	Config_READER_AFFINITY           = 30,    // mask of the CPUs reader threads are pinned to, 0 disables
+	Config_WRITER_AFFINITY           = 31,    // mask of the CPUs writer threads are pinned to, 0 disables
+	Config_OMP_AFFINITY              = 32,    // mask of the CPUs OpenMP threads are pinned to, 0 disables
+	Config_REPLAN_FACTOR             = 33,    // growth of observed cardinality over a cached plan's expectation triggering re-planning, 0 disables
+	Config_COMPILE_THRESHOLD         = 34,    // number of executions after which a cached plan's expressions are compiled, 0 disables
+	Config_COMPRESSION_THRESHOLD     = 35,    // minimum length of string properties stored compressed, 0 disables
+	Config_END_MARKER                = 36
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -34,15 +82,35 @@ typedef enum {
 typedef void (*Config_on_change)(Config_Option_Field type);
 
 // Run-time configurable fields
-#define RUNTIME_CONFIG_COUNT 6
+#define RUNTIME_CONFIG_COUNT 26
 static const Config_Option_Field RUNTIME_CONFIGS[] =
 {
 	Config_RESULTSET_MAX_SIZE,
 	Config_TIMEOUT,
+	Config_THREAD_POOL_SIZE,
 	Config_MAX_QUEUED_QUERIES,
 	Config_QUERY_MEM_CAPACITY,
 	Config_DELTA_MAX_PENDING_CHANGES,
-	Config_VKEY_MAX_ENTITY_COUNT
+	Config_VKEY_MAX_ENTITY_COUNT,
+	Config_RESULTSET_CHUNK_SIZE,
+	Config_QUERY_PARALLELISM,
+	Config_MAX_TRAVERSE_BATCH_SIZE,
+	Config_WRITE_BATCH_SIZE,
+	Config_DELTA_COMPACTION_RATIO,
+	Config_ASYNC_INDEX_THRESHOLD,
+	Config_HUGE_PAGES,
+	Config_COLD_STORAGE_THRESHOLD,
+	Config_PLAN_STATS_SAMPLE_RATE,
+	Config_CAPTURE_SAMPLE_RATE,
+	Config_TRACE_SAMPLE_RATE,
+	Config_EFFECTS_THRESHOLD,
+	Config_QUERY_COST_LIMIT,
+	Config_HEAVY_QUERY_COST,
+	Config_CHANGE_STREAM_LENGTH,
+	Config_WARM_PLAN_COUNT,
+	Config_REPLAN_FACTOR,
+	Config_COMPILE_THRESHOLD,
+	Config_COMPRESSION_THRESHOLD
 };
 
 // Set module-level configurations to defaults or to user arguments where provided.
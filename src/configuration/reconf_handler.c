@@ -8,6 +8,7 @@
 #include "util/rmalloc.h"
 #include "reconf_handler.h"
 #include "util/thpool/pools.h"
+#include "slow_log/query_capture.h"
 
 // handler function invoked when config changes
 void reconf_handler(Config_Option_Field type) {
@@ -26,6 +27,19 @@ void reconf_handler(Config_Option_Field type) {
 			}
 			break;
 		
+		//----------------------------------------------------------------------
+		// thread count
+		//----------------------------------------------------------------------
+
+		case Config_THREAD_POOL_SIZE:
+			{
+				uint thread_count;
+				bool res = Config_Option_get(type, &thread_count);
+				ASSERT(res);
+				ThreadPools_SetReadersCount(thread_count);
+			}
+			break;
+
 		//----------------------------------------------------------------------
 		// query mem capacity
 		//----------------------------------------------------------------------
@@ -39,6 +53,33 @@ void reconf_handler(Config_Option_Field type) {
 			}
 			break;
 
+		//----------------------------------------------------------------------
+		// huge pages
+		//----------------------------------------------------------------------
+
+		case Config_HUGE_PAGES:
+			{
+				bool huge_pages;
+				bool res = Config_Option_get(type, &huge_pages);
+				ASSERT(res);
+				rm_set_huge_pages(huge_pages);
+			}
+			break;
+
+		//----------------------------------------------------------------------
+		// capture sample rate
+		//----------------------------------------------------------------------
+
+		case Config_CAPTURE_SAMPLE_RATE:
+			{
+				// release the capture file once capture is disabled
+				uint64_t capture_sample_rate;
+				bool res = Config_Option_get(type, &capture_sample_rate);
+				ASSERT(res);
+				if(capture_sample_rate == 0) QueryCapture_Close();
+			}
+			break;
+
         //----------------------------------------------------------------------
         // all other options
         //----------------------------------------------------------------------
@@ -19,7 +19,10 @@ SIValue SIArray_New(uint32_t initialCapacity) {
 
 void SIArray_Append(SIValue *siarray, SIValue value) {
 	// clone and persist incase of pointer values
-	SIValue clone = SI_CloneValue(value);
+	// shared arrays and maps are referenced rather than copied
+	SIValue clone = (value.allocation == M_SHARED ||
+			value.allocation == M_SHARED_VOLATILE) ?
+		SI_ShallowCloneValue(value) : SI_CloneValue(value);
 	// append
 	array_append(siarray->array, clone);
 
@@ -11,6 +11,7 @@ SIValue SIArray_New(u_int32_t initialCapacity);
 
 /**
   * @brief  Appends a new SIValue to a given array
+  * @note   The value is cloned, shared arrays and maps are referenced instead
   * @param  siarray: pointer to array
   * @param  value: new value
   */
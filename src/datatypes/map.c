@@ -12,6 +12,18 @@
 #include "../util/rmalloc.h"
 #include "../util/strutil.h"
 
+// returns a copy of 'val' to be stored in a pair
+static inline SIValue Pair_Value
+(
+	SIValue val
+) {
+	// shared arrays and maps are referenced rather than copied
+	if(val.allocation == M_SHARED || val.allocation == M_SHARED_VOLATILE) {
+		return SI_ShallowCloneValue(val);
+	}
+	return SI_CloneValue(val);
+}
+
 static inline Pair Pair_New
 (
 	SIValue key,
@@ -19,7 +31,7 @@ static inline Pair Pair_New
 ) {
 	ASSERT(SI_TYPE(key) & T_STRING);
 	return (Pair) {
-		.key = SI_CloneValue(key), .val = SI_CloneValue(val)
+		.key = SI_CloneValue(key), .val = Pair_Value(val)
 	};
 }
 
@@ -104,6 +116,25 @@ void Map_Add
 	array_append(map->map, pair);
 }
 
+// adds key/value to map, 'key' must not already be in map
+void Map_AddConstKey
+(
+	SIValue *map,
+	const char *key,
+	SIValue value
+) {
+	ASSERT(key != NULL);
+	ASSERT(SI_TYPE(*map) & T_MAP);
+	ASSERT(Map_KeyIdx(*map, SI_ConstStringVal(key)) == -1);
+
+	// the key is referenced rather than duplicated
+	Pair pair = {
+		.key = SI_ConstStringVal(key), .val = Pair_Value(value)
+	};
+
+	array_append(map->map, pair);
+}
+
 // removes key from map
 void Map_Remove
 (
@@ -51,6 +51,16 @@ void Map_Add
 	SIValue value  // value to add under key
 );
 
+// adds key/value to map without checking for an existing key
+// 'key' is referenced rather than duplicated, as such it must outlive the map
+// e.g. an attribute name or a query string literal
+void Map_AddConstKey
+(
+	SIValue *map,     // map to add element to
+	const char *key,  // key under which value is added, not in map
+	SIValue value     // value to add under key
+);
+
 // removes key from map
 void Map_Remove
 (
@@ -12,14 +12,17 @@ Path *Path_New(size_t len) {
 	Path *path = rm_malloc(sizeof(Path));
 	path->edges = array_new(Edge, len);
 	path->nodes = array_new(Node, len + 1);
+	path->packed = false;
 	return path;
 }
 
 void Path_AppendNode(Path *p, Node n) {
+	ASSERT(!p->packed);
 	array_append(p->nodes, n);
 }
 
 void Path_AppendEdge(Path *p, Edge e) {
+	ASSERT(!p->packed);
 	array_append(p->edges, e);
 }
 
@@ -65,10 +68,41 @@ bool Path_ContainsNode(const Path *p, Node *n) {
 	return false;
 }
 
+// rounds 'size' up to a multiple of 8
+#define _ALIGN8(size) (((size) + 7) & ~(size_t)7)
+
+// lays out a copy of 'src' as an array whose elements start at 'buf'
+static void *_PackArray(char *buf, const void *src, uint32_t len,
+		uint32_t elem_sz) {
+	array_hdr_t *hdr = (array_hdr_t *)(buf - sizeof(array_hdr_t));
+	hdr->len = len;
+	hdr->cap = len;
+	hdr->elem_sz = elem_sz;
+	memcpy(buf, src, (size_t)len * elem_sz);
+	return buf;
+}
+
 Path *Path_Clone(const Path *p) {
-	Path *clone = rm_malloc(sizeof(Path));
-	array_clone(clone->nodes, p->nodes);
-	array_clone(clone->edges, p->edges);
+	// paths are cloned for every record a traversal produces
+	// allocate the path and both arrays at once
+	// layout: [Path][nodes hdr][nodes][edges hdr][edges]
+	// each array header is placed such that its elements are 8 bytes aligned
+	uint32_t node_count = array_len(p->nodes);
+	uint32_t edge_count = array_len(p->edges);
+
+	size_t nodes_offset = _ALIGN8(sizeof(Path) + sizeof(array_hdr_t));
+	size_t edges_offset = _ALIGN8(nodes_offset + node_count * sizeof(Node) +
+			sizeof(array_hdr_t));
+	size_t size = edges_offset + edge_count * sizeof(Edge);
+
+	char *block = rm_malloc(size);
+	Path *clone = (Path *)block;
+	clone->packed = true;
+	clone->nodes = _PackArray(block + nodes_offset, p->nodes,
+			node_count, sizeof(Node));
+	clone->edges = _PackArray(block + edges_offset, p->edges,
+			edge_count, sizeof(Edge));
+
 	return clone;
 }
 
@@ -78,6 +112,10 @@ void Path_Reverse(Path *p) {
 }
 
 void Path_Free(Path *p) {
+	if(p->packed) {
+		rm_free(p);
+		return;
+	}
 	array_free(p->nodes);
 	array_free(p->edges);
 	rm_free(p);
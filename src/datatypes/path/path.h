@@ -12,6 +12,7 @@
 typedef struct {
 	Node *nodes;    // Nodes in paths.
 	Edge *edges;    // Edges in path.
+	bool packed;    // Nodes and edges share the path's allocation.
 } Path;
 
 /**
@@ -113,6 +114,8 @@ bool Path_ContainsNode(const Path *p, Node *n);
 
 /**
  * @brief  Clones a path.
+ * @note   The clone is packed into a single allocation holding the path
+ *         and its nodes and edges arrays, it can't grow.
  * @param  p: Origin path.
  * @retval A pointer to a path struct with newly allocated array copies.
  */
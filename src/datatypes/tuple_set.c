@@ -0,0 +1,276 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "tuple_set.h"
+#include "../RG.h"
+#include "xxhash.h"
+#include "../util/rmalloc.h"
+#include "../graph/entities/graph_entity.h"
+
+// minimum number of hash table slots
+#define TUPLESET_MIN_CAP 16
+
+// marks a slot holding a fingerprint rather than a tuple ID
+#define FINGERPRINT_BIT (1ULL << 63)
+
+// seed of the hash used as a fingerprint
+#define FINGERPRINT_SEED 0x9E3779B97F4A7C15ULL
+
+// hash table slot, empty slots have 'ref' set to 0
+// otherwise 'ref' is either tuple ID + 1 or a fingerprint with
+// FINGERPRINT_BIT set
+typedef struct {
+	XXH64_hash_t hash;  // tuple hash
+	uint64_t ref;       // tuple reference
+} TupleSetSlot;
+
+struct TupleSet {
+	uint width;              // number of values in a tuple
+	TupleSetSlot *slots;     // hash table slots
+	uint64_t cap;            // number of slots, a power of two
+	uint64_t count;          // number of tuples in set
+	SIValue *keys;           // stored tuple values, 'width' values per tuple
+	uint64_t key_count;      // number of stored tuples
+	uint64_t key_cap;        // number of tuples 'keys' can hold
+	uint64_t key_bytes;      // approximate size of stored values
+	uint64_t max_key_bytes;  // stop storing values beyond this size
+};
+
+static XXH64_hash_t _HashTuple
+(
+	const SIValue *values,
+	uint width,
+	XXH64_hash_t seed
+) {
+	XXH64_state_t state;
+	XXH_errorcode res = XXH64_reset(&state, seed);
+	ASSERT(res != XXH_ERROR);
+
+	for(uint i = 0; i < width; i++) SIValue_HashUpdate(values[i], &state);
+
+	return XXH64_digest(&state);
+}
+
+// returns true if stored value equals 'v'
+static inline bool _ValueEquals
+(
+	SIValue stored,
+	SIValue v
+) {
+	SIType st = SI_TYPE(stored);
+	SIType vt = SI_TYPE(v);
+
+	// graph entities are stored by ID
+	if(st & (T_NODE | T_EDGE)) {
+		return st == vt &&
+			(int64_t)ENTITY_GET_ID((GraphEntity *)v.ptrval) == stored.longval;
+	}
+
+	// NULLs are equal to one another
+	if(st == T_NULL || vt == T_NULL) return st == vt;
+
+	if(st == T_INT64 && vt == T_INT64) return stored.longval == v.longval;
+	if(st == T_STRING && vt == T_STRING) {
+		return strcmp(stored.stringval, v.stringval) == 0;
+	}
+
+	return SIValue_Compare(stored, v, NULL) == 0;
+}
+
+// stores a copy of 'v' which remains valid for the lifetime of the set
+static inline SIValue _StoreValue
+(
+	TupleSet *s,
+	SIValue v
+) {
+	SIType t = SI_TYPE(v);
+	s->key_bytes += sizeof(SIValue);
+
+	if(t & (T_NODE | T_EDGE)) {
+		SIValue id = SI_LongVal(ENTITY_GET_ID((GraphEntity *)v.ptrval));
+		id.type = t;
+		return id;
+	}
+
+	if(t == T_STRING) s->key_bytes += strlen(v.stringval) + 1;
+	return SI_CloneValue(v);
+}
+
+// place slot in the first empty position of its probe sequence
+static void _Insert
+(
+	TupleSetSlot *slots,
+	uint64_t cap,
+	TupleSetSlot slot
+) {
+	uint64_t mask = cap - 1;
+	uint64_t pos = slot.hash & mask;
+	while(slots[pos].ref != 0) pos = (pos + 1) & mask;
+	slots[pos] = slot;
+}
+
+// double the number of slots, rehashing all tuples
+static void _Grow
+(
+	TupleSet *s
+) {
+	uint64_t cap = s->cap * 2;
+	TupleSetSlot *slots = rm_calloc(cap, sizeof(TupleSetSlot));
+
+	for(uint64_t i = 0; i < s->cap; i++) {
+		if(s->slots[i].ref != 0) _Insert(slots, cap, s->slots[i]);
+	}
+
+	rm_free(s->slots);
+	s->slots = slots;
+	s->cap = cap;
+}
+
+// returns the reference of a new tuple, storing its values if possible
+static uint64_t _NewRef
+(
+	TupleSet *s,
+	const SIValue *values,
+	XXH64_hash_t fingerprint
+) {
+	if(s->max_key_bytes != 0 && s->key_bytes >= s->max_key_bytes) {
+		return fingerprint | FINGERPRINT_BIT;
+	}
+
+	if(s->key_count == s->key_cap) {
+		s->key_cap = (s->key_cap == 0) ? TUPLESET_MIN_CAP : s->key_cap * 2;
+		s->keys = rm_realloc(s->keys, sizeof(SIValue) * s->width * s->key_cap);
+	}
+
+	SIValue *stored = s->keys + s->key_count * s->width;
+	for(uint i = 0; i < s->width; i++) stored[i] = _StoreValue(s, values[i]);
+
+	return ++s->key_count;
+}
+
+TupleSet *TupleSet_New
+(
+	uint width,
+	uint64_t expected,
+	uint64_t max_key_bytes
+) {
+	ASSERT(width > 0);
+
+	// size table such that 'expected' tuples fit without growing
+	uint64_t cap = TUPLESET_MIN_CAP;
+	while(cap * 3 < expected * 4) cap *= 2;
+
+	TupleSet *s = rm_malloc(sizeof(TupleSet));
+
+	s->width         = width;
+	s->cap           = cap;
+	s->count         = 0;
+	s->slots         = rm_calloc(cap, sizeof(TupleSetSlot));
+	s->keys          = NULL;
+	s->key_count     = 0;
+	s->key_cap       = 0;
+	s->key_bytes     = 0;
+	s->max_key_bytes = max_key_bytes;
+
+	return s;
+}
+
+bool TupleSet_Add
+(
+	TupleSet *s,
+	const SIValue *values,
+	uint64_t *id
+) {
+	ASSERT(s != NULL);
+	ASSERT(values != NULL);
+
+	XXH64_hash_t hash = _HashTuple(values, s->width, 0);
+	XXH64_hash_t fingerprint = 0;
+	bool fingerprinted = false;
+
+	uint64_t mask = s->cap - 1;
+	uint64_t pos = hash & mask;
+	const TupleSetSlot *slots = s->slots;
+
+	// the table is never full, probing ends at an empty slot
+	for(; slots[pos].ref != 0; pos = (pos + 1) & mask) {
+		if(slots[pos].hash != hash) continue;
+
+		uint64_t ref = slots[pos].ref;
+		if(ref & FINGERPRINT_BIT) {
+			// compute fingerprint only once it is needed
+			if(!fingerprinted) {
+				fingerprint = _HashTuple(values, s->width, FINGERPRINT_SEED);
+				fingerprinted = true;
+			}
+			if((ref & ~FINGERPRINT_BIT) == (fingerprint & ~FINGERPRINT_BIT)) {
+				if(id) *id = TUPLESET_NO_ID;
+				return false;
+			}
+		} else if(TupleSet_Matches(s, ref - 1, values)) {
+			if(id) *id = ref - 1;
+			return false;
+		}
+	}
+
+	// tuple is missing, add it
+	if(!fingerprinted) {
+		fingerprint = _HashTuple(values, s->width, FINGERPRINT_SEED);
+	}
+
+	TupleSetSlot slot = {.hash = hash, .ref = _NewRef(s, values, fingerprint)};
+	if(id) *id = (slot.ref & FINGERPRINT_BIT) ? TUPLESET_NO_ID : slot.ref - 1;
+
+	s->count++;
+	if(s->count * 4 >= s->cap * 3) {
+		_Grow(s);
+		_Insert(s->slots, s->cap, slot);
+	} else {
+		s->slots[pos] = slot;
+	}
+
+	return true;
+}
+
+bool TupleSet_Matches
+(
+	const TupleSet *s,
+	uint64_t id,
+	const SIValue *values
+) {
+	ASSERT(s != NULL);
+	ASSERT(id < s->key_count);
+
+	const SIValue *stored = s->keys + id * s->width;
+	for(uint i = 0; i < s->width; i++) {
+		if(!_ValueEquals(stored[i], values[i])) return false;
+	}
+
+	return true;
+}
+
+uint64_t TupleSet_Size
+(
+	const TupleSet *s
+) {
+	ASSERT(s != NULL);
+	return s->count;
+}
+
+void TupleSet_Free
+(
+	TupleSet *s
+) {
+	ASSERT(s != NULL);
+
+	uint64_t n = s->key_count * s->width;
+	for(uint64_t i = 0; i < n; i++) SIValue_Free(s->keys[i]);
+
+	if(s->keys != NULL) rm_free(s->keys);
+	rm_free(s->slots);
+	rm_free(s);
+}
+
@@ -0,0 +1,63 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+
+// ID of a tuple with no stored values
+#define TUPLESET_NO_ID UINT64_MAX
+
+// TupleSet is a hash set of fixed width value tuples
+//
+// tuples are hashed into an open addressing table and their values are
+// stored in an arena, lookups verify the stored values, such that tuples
+// sharing a hash are never mistaken for one another
+// graph entities are stored by ID
+//
+// once the values stored in the arena exceed 'max_key_bytes' the set
+// stops storing values, new tuples are represented by a pair of
+// independent 64 bit hashes instead
+typedef struct TupleSet TupleSet;
+
+// create a new tuple set
+TupleSet *TupleSet_New
+(
+	uint width,             // number of values in a tuple
+	uint64_t expected,      // expected number of tuples, 0 if unknown
+	uint64_t max_key_bytes  // maximum size of stored values, 0 for unlimited
+);
+
+// adds tuple to set
+// returns true if tuple wasn't already in the set
+bool TupleSet_Add
+(
+	TupleSet *s,            // set to update
+	const SIValue *values,  // tuple values
+	uint64_t *id            // [optional output] tuple ID, TUPLESET_NO_ID if
+	                        // tuple values aren't stored
+);
+
+// returns true if stored tuple 'id' equals 'values'
+bool TupleSet_Matches
+(
+	const TupleSet *s,     // set
+	uint64_t id,           // tuple ID
+	const SIValue *values  // tuple values
+);
+
+// number of tuples in set
+uint64_t TupleSet_Size
+(
+	const TupleSet *s
+);
+
+// free set
+void TupleSet_Free
+(
+	TupleSet *s
+);
+
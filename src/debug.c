@@ -9,10 +9,14 @@
 #include <pthread.h>
 #include <sys/types.h>
 #include "RG.h"
+#include "query_ctx.h"
 #include "util/thpool/pools.h"
+#include "util/arr.h"
+#include "graph/graphcontext.h"
 #include "commands/cmd_context.h"
 
 extern CommandCtx **command_ctxs;
+extern GraphContext **graphs_in_keyspace;
 
 static struct sigaction old_act;
 
@@ -25,7 +29,7 @@ static void endCrashReport(void) {
 }
 
 static void logCommands(void) {
-	// #readers + #writers + Redis main thread
+	// #readers + #writers + #heavy + Redis main thread
 	int nthreads = ThreadPools_ThreadCount() + 1;
 
 	for(int i = 0; i < nthreads; i++) {
@@ -37,9 +41,104 @@ static void logCommands(void) {
 	}
 }
 
+static void _InfoAddPoolStats
+(
+	RedisModuleInfoCtx *ctx,
+	const char *name,
+	const thpool_stats *stats
+) {
+	char field[64];
+	uint64_t avg_wait = (stats->dequeued > 0) ?
+		stats->wait_time_total_us / stats->dequeued : 0;
+
+	snprintf(field, sizeof(field), "%s_busy", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, stats->working);
+	snprintf(field, sizeof(field), "%s_queued", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, stats->queued);
+	snprintf(field, sizeof(field), "%s_enqueued", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, stats->enqueued);
+	snprintf(field, sizeof(field), "%s_stolen", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, stats->stolen);
+	snprintf(field, sizeof(field), "%s_wait_avg_us", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, avg_wait);
+	snprintf(field, sizeof(field), "%s_wait_p50_us", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, stats->wait_time_p50_us);
+	snprintf(field, sizeof(field), "%s_wait_p99_us", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, stats->wait_time_p99_us);
+	snprintf(field, sizeof(field), "%s_wait_max_us", name);
+	RedisModule_InfoAddFieldULongLong(ctx, field, stats->wait_time_max_us);
+}
+
+// report thread pools queue depth and wait time
+static void _InfoThreadPools
+(
+	RedisModuleInfoCtx *ctx
+) {
+	thpool_stats readers;
+	thpool_stats writers;
+	thpool_stats heavy;
+	ThreadPools_GetStats(&readers, &writers, &heavy);
+
+	RedisModule_InfoAddSection(ctx, "thread_pools");
+	_InfoAddPoolStats(ctx, "readers", &readers);
+	_InfoAddPoolStats(ctx, "writers", &writers);
+	_InfoAddPoolStats(ctx, "heavy", &heavy);
+}
+
+// report the time queries spent in each of their stages
+static void _InfoQueryStages
+(
+	RedisModuleInfoCtx *ctx
+) {
+	uint64_t queries;
+	uint64_t totals[QUERY_STAGE_COUNT];
+	QueryCtx_GetStageTotals(totals, &queries);
+
+	RedisModule_InfoAddSection(ctx, "query_stages");
+	RedisModule_InfoAddFieldULongLong(ctx, "queries", queries);
+	RedisModule_InfoAddFieldULongLong(ctx, "wait_total_us",
+			totals[QUERY_STAGE_WAIT]);
+	RedisModule_InfoAddFieldULongLong(ctx, "lock_total_us",
+			totals[QUERY_STAGE_LOCK]);
+	RedisModule_InfoAddFieldULongLong(ctx, "plan_total_us",
+			totals[QUERY_STAGE_PLAN]);
+	RedisModule_InfoAddFieldULongLong(ctx, "execute_total_us",
+			totals[QUERY_STAGE_EXECUTE]);
+}
+
+// report the flush and resize counters of each graph's matrices
+// INFO runs on the main thread, pending changes are reported by
+// GRAPH.MATRICES which inspects the matrices under the graph's read lock
+static void _InfoGraphMatrices
+(
+	RedisModuleInfoCtx *ctx
+) {
+	RedisModule_InfoAddSection(ctx, "graph_matrices");
+
+	uint n = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < n; i++) {
+		GraphContext *gc = graphs_in_keyspace[i];
+		RG_MatrixStats stats;
+		Graph_MatrixStats(gc->g, &stats);
+
+		RedisModule_InfoBeginDictField(ctx, (char *)GraphContext_GetName(gc));
+		RedisModule_InfoAddFieldULongLong(ctx, "flushes", stats.flushes);
+		RedisModule_InfoAddFieldULongLong(ctx, "last_flush_us",
+				stats.last_flush_us);
+		RedisModule_InfoAddFieldULongLong(ctx, "total_flush_us",
+				stats.total_flush_us);
+		RedisModule_InfoAddFieldULongLong(ctx, "resizes", stats.resizes);
+		RedisModule_InfoEndDictField(ctx);
+	}
+}
+
 void InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
-	// make sure information is requested for crash report
-	if(!for_crash_report) return;
+	if(!for_crash_report) {
+		_InfoThreadPools(ctx);
+		_InfoQueryStages(ctx);
+		_InfoGraphMatrices(ctx);
+		return;
+	}
 
 	// pause all working threads
 	// NOTE: pausing is not an atomic action;
@@ -47,7 +146,7 @@ void InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report) {
 	ThreadPools_Pause();
 
 	char *command_desc = NULL;
-	// #readers + #writers + Redis main thread
+	// #readers + #writers + #heavy + Redis main thread
 	int nthreads = ThreadPools_ThreadCount() + 1;
 
 	RedisModule_InfoAddSection(ctx, "executing commands");
@@ -0,0 +1,62 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "change_stream.h"
+#include "../util/rmalloc.h"
+#include "../configuration/config.h"
+#include <stdio.h>
+
+#define CHANGE_STREAM_SUFFIX ":changes"
+
+void ChangeStream_Publish
+(
+	RedisModuleCtx *ctx,
+	GraphContext *gc,
+	const ResultSetStatistics *stats,
+	EffectsBuffer *effects,
+	const char *query
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(ctx   != NULL);
+	ASSERT(stats != NULL);
+
+	uint64_t max_len;
+	Config_Option_get(Config_CHANGE_STREAM_LENGTH, &max_len);
+	if(max_len == CHANGE_STREAM_DISABLED) return;
+
+	// replicas receive the master's entries through replication
+	if(!(RedisModule_GetContextFlags(ctx) & REDISMODULE_CTX_FLAGS_MASTER)) {
+		return;
+	}
+
+	char *key;
+	asprintf(&key, "%s" CHANGE_STREAM_SUFFIX, gc->graph_name);
+
+	// prefer effects, replaying a query might not reproduce its changes
+	bool use_effects = (effects != NULL && EffectsBuffer_Valid(effects) &&
+						!EffectsBuffer_Empty(effects));
+	const char *change_field = use_effects ? "effects" : "query";
+	const char *change = use_effects ? EffectsBuffer_Buffer(effects) : query;
+	size_t change_len = use_effects ? EffectsBuffer_Length(effects) :
+		strlen(query);
+
+	// XADD <graph>:changes MAXLEN ~ <max_len> * <field> <value> ...
+	RedisModuleCallReply *reply = RedisModule_Call(ctx, "XADD",
+			"!ccclcclclclclclclclcb", key, "MAXLEN", "~", (long long)max_len,
+			"*",
+			"seq",                   (long long)stats->commit_seq,
+			"nodes_created",         (long long)stats->nodes_created,
+			"nodes_deleted",         (long long)stats->nodes_deleted,
+			"relationships_created", (long long)stats->relationships_created,
+			"relationships_deleted", (long long)stats->relationships_deleted,
+			"properties_set",        (long long)stats->properties_set,
+			"labels_added",          (long long)stats->labels_added,
+			change_field, change, change_len);
+
+	if(reply != NULL) RedisModule_FreeCallReply(reply);
+	free(key);
+}
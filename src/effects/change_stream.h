@@ -0,0 +1,29 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "effects.h"
+#include "../redismodule.h"
+#include "../graph/graphcontext.h"
+#include "../resultset/resultset_statistics.h"
+
+// change streams capture every committed modification of a graph
+// into a redis stream named "<graph>:changes"
+// each commit adds a single entry holding its commit sequence number,
+// its statistics and either its effects or the query which introduced them
+//
+// streams are capped at CHANGE_STREAM_LENGTH entries, 0 disables streaming
+
+// publish a committed modification to the graph's change stream
+void ChangeStream_Publish
+(
+	RedisModuleCtx *ctx,               // redis context
+	GraphContext *gc,                  // modified graph
+	const ResultSetStatistics *stats,  // commit statistics
+	EffectsBuffer *effects,            // commit effects, might be NULL
+	const char *query                  // query which introduced the changes
+);
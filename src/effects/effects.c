@@ -0,0 +1,788 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "effects.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+#include "../execution_plan/ops/shared/update_functions.h"
+#include "../execution_plan/ops/shared/delete_functions.h"
+#include <string.h>
+
+// initial effects buffer capacity in bytes
+#define EFFECTS_BUFFER_INITIAL_CAP 256
+
+// effect types
+typedef enum {
+	EFFECT_CREATE_NODE = 1,  // node creation
+	EFFECT_CREATE_EDGE,      // edge creation
+	EFFECT_DELETE,           // nodes and edges deletion
+	EFFECT_UPDATE,           // attribute update
+	EFFECT_CLEAR,            // removal of all attributes
+	EFFECT_ADD_ATTRIBUTE,    // attribute introduction
+	EFFECT_ADD_SCHEMA,       // label or relationship type introduction
+	EFFECT_ADD_INDEX,        // index introduction
+} EffectType;
+
+struct EffectsBuffer {
+	char *data;    // encoded effects
+	size_t len;    // number of bytes used
+	size_t cap;    // number of bytes allocated
+	bool valid;    // false if a modification couldn't be encoded
+};
+
+//------------------------------------------------------------------------------
+// encoding
+//------------------------------------------------------------------------------
+
+static void _Write(EffectsBuffer *buff, const void *src, size_t n) {
+	if(buff->len + n > buff->cap) {
+		while(buff->len + n > buff->cap) buff->cap *= 2;
+		buff->data = rm_realloc(buff->data, buff->cap);
+	}
+	memcpy(buff->data + buff->len, src, n);
+	buff->len += n;
+}
+
+static inline void _WriteUInt8(EffectsBuffer *buff, uint8_t v) {
+	_Write(buff, &v, sizeof(v));
+}
+
+static inline void _WriteUInt64(EffectsBuffer *buff, uint64_t v) {
+	_Write(buff, &v, sizeof(v));
+}
+
+static inline void _WriteString(EffectsBuffer *buff, const char *s) {
+	uint32_t len = strlen(s);
+	_Write(buff, &len, sizeof(len));
+	_Write(buff, s, len);
+}
+
+// encode value, returns false if value can't be encoded
+static bool _WriteValue(EffectsBuffer *buff, SIValue v) {
+	SIType t = SI_TYPE(v);
+	switch(t) {
+		case T_NULL:
+			_WriteUInt64(buff, t);
+			return true;
+		case T_BOOL:
+		case T_INT64:
+			_WriteUInt64(buff, t);
+			_WriteUInt64(buff, v.longval);
+			return true;
+		case T_DOUBLE:
+			_WriteUInt64(buff, t);
+			_Write(buff, &v.doubleval, sizeof(v.doubleval));
+			return true;
+		case T_STRING:
+			_WriteUInt64(buff, t);
+			_WriteString(buff, v.stringval);
+			return true;
+		case T_POINT:
+			_WriteUInt64(buff, t);
+			_Write(buff, &v.point, sizeof(v.point));
+			return true;
+		case T_ARRAY: {
+			_WriteUInt64(buff, t);
+			uint32_t n = SIArray_Length(v);
+			_Write(buff, &n, sizeof(n));
+			for(uint32_t i = 0; i < n; i++) {
+				if(!_WriteValue(buff, SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		default:
+			// temporal values, same as in RDB, aren't encoded
+			return false;
+	}
+}
+
+// encode entity's attributes as name, value pairs
+static bool _WriteAttributes(EffectsBuffer *buff, GraphContext *gc,
+		const GraphEntity *ge) {
+	int n = ENTITY_PROP_COUNT(ge);
+	SIValue *values = ENTITY_PROP_VALUES(ge);
+	Attribute_ID *ids = ENTITY_PROP_IDS(ge);
+
+	uint32_t count = n;
+	_Write(buff, &count, sizeof(count));
+	for(int i = 0; i < n; i++) {
+		_WriteString(buff, GraphContext_GetAttributeString(gc, ids[i]));
+		if(!_WriteValue(buff, *Entity_ReadValue(values + i))) return false;
+	}
+
+	return true;
+}
+
+// encode edge as id, relationship type, source and destination
+static void _WriteEdge(EffectsBuffer *buff, GraphContext *gc, Edge *e) {
+	int r = EDGE_GET_RELATION_ID(e, gc->g);
+	Schema *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+	ASSERT(s != NULL);
+
+	_WriteUInt64(buff, ENTITY_GET_ID(e));
+	_WriteString(buff, Schema_GetName(s));
+	_WriteUInt64(buff, Edge_GetSrcNodeID(e));
+	_WriteUInt64(buff, Edge_GetDestNodeID(e));
+}
+
+EffectsBuffer *EffectsBuffer_New(void) {
+	EffectsBuffer *buff = rm_malloc(sizeof(EffectsBuffer));
+
+	buff->cap   = EFFECTS_BUFFER_INITIAL_CAP;
+	buff->data  = rm_malloc(buff->cap);
+	buff->len   = 0;
+	buff->valid = true;
+
+	_WriteUInt8(buff, EFFECTS_VERSION);
+
+	return buff;
+}
+
+void EffectsBuffer_AddCreateNodeEffect(EffectsBuffer *buff, GraphContext *gc,
+		const Node *n, const int *labels, uint label_count) {
+	ASSERT(n    != NULL);
+	ASSERT(gc   != NULL);
+	ASSERT(buff != NULL);
+
+	if(!buff->valid) return;
+
+	_WriteUInt8(buff, EFFECT_CREATE_NODE);
+	_WriteUInt64(buff, ENTITY_GET_ID(n));
+
+	uint32_t count = label_count;
+	_Write(buff, &count, sizeof(count));
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		ASSERT(s != NULL);
+		_WriteString(buff, Schema_GetName(s));
+	}
+
+	if(!_WriteAttributes(buff, gc, (const GraphEntity *)n)) buff->valid = false;
+}
+
+void EffectsBuffer_AddCreateEdgeEffect(EffectsBuffer *buff, GraphContext *gc,
+		const Edge *e, NodeID src, NodeID dest, int r) {
+	ASSERT(e    != NULL);
+	ASSERT(gc   != NULL);
+	ASSERT(buff != NULL);
+
+	if(!buff->valid) return;
+
+	Schema *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+	ASSERT(s != NULL);
+
+	_WriteUInt8(buff, EFFECT_CREATE_EDGE);
+	_WriteUInt64(buff, ENTITY_GET_ID(e));
+	_WriteString(buff, Schema_GetName(s));
+	_WriteUInt64(buff, src);
+	_WriteUInt64(buff, dest);
+
+	if(!_WriteAttributes(buff, gc, (const GraphEntity *)e)) buff->valid = false;
+}
+
+void EffectsBuffer_AddDeleteEffect(EffectsBuffer *buff, GraphContext *gc,
+		Node *nodes, uint node_count, Edge *edges, uint edge_count) {
+	ASSERT(gc   != NULL);
+	ASSERT(buff != NULL);
+
+	if(!buff->valid) return;
+
+	_WriteUInt8(buff, EFFECT_DELETE);
+
+	uint32_t count = node_count;
+	_Write(buff, &count, sizeof(count));
+	for(uint i = 0; i < node_count; i++) {
+		_WriteUInt64(buff, ENTITY_GET_ID(nodes + i));
+	}
+
+	count = edge_count;
+	_Write(buff, &count, sizeof(count));
+	for(uint i = 0; i < edge_count; i++) _WriteEdge(buff, gc, edges + i);
+}
+
+void EffectsBuffer_AddUpdateEffect(EffectsBuffer *buff, GraphContext *gc,
+		GraphEntity *ge, GraphEntityType t, Attribute_ID attr_id, SIValue v) {
+	ASSERT(ge   != NULL);
+	ASSERT(gc   != NULL);
+	ASSERT(buff != NULL);
+	ASSERT(t == GETYPE_NODE || t == GETYPE_EDGE);
+
+	if(!buff->valid) return;
+
+	_WriteUInt8(buff, (attr_id == ATTRIBUTE_ALL) ? EFFECT_CLEAR : EFFECT_UPDATE);
+	_WriteUInt8(buff, t);
+	if(t == GETYPE_NODE) _WriteUInt64(buff, ENTITY_GET_ID(ge));
+	else _WriteEdge(buff, gc, (Edge *)ge);
+
+	if(attr_id == ATTRIBUTE_ALL) return;
+
+	_WriteString(buff, GraphContext_GetAttributeString(gc, attr_id));
+	if(!_WriteValue(buff, v)) buff->valid = false;
+}
+
+void EffectsBuffer_AddAttributeEffect(EffectsBuffer *buff, const char *attr) {
+	ASSERT(buff != NULL);
+	ASSERT(attr != NULL);
+
+	if(!buff->valid) return;
+
+	_WriteUInt8(buff, EFFECT_ADD_ATTRIBUTE);
+	_WriteString(buff, attr);
+}
+
+void EffectsBuffer_AddSchemaEffect(EffectsBuffer *buff, const Schema *s) {
+	ASSERT(s    != NULL);
+	ASSERT(buff != NULL);
+
+	if(!buff->valid) return;
+
+	_WriteUInt8(buff, EFFECT_ADD_SCHEMA);
+	_WriteUInt8(buff, s->type);
+	_WriteString(buff, Schema_GetName(s));
+}
+
+void EffectsBuffer_AddIndexEffect(EffectsBuffer *buff, const Schema *s,
+		Index *idx) {
+	ASSERT(s    != NULL);
+	ASSERT(idx  != NULL);
+	ASSERT(buff != NULL);
+
+	if(!buff->valid) return;
+
+	_WriteUInt8(buff, EFFECT_ADD_INDEX);
+	_WriteUInt8(buff, s->type);
+	_WriteString(buff, Schema_GetName(s));
+	_WriteUInt8(buff, idx->type);
+
+	if(idx->type == IDX_FULLTEXT) {
+		_WriteString(buff, Index_GetLanguage(idx));
+
+		size_t stopwords_count;
+		char **stopwords = Index_GetStopwords(idx, &stopwords_count);
+		uint32_t count = stopwords_count;
+		_Write(buff, &count, sizeof(count));
+		for(size_t i = 0; i < stopwords_count; i++) {
+			_WriteString(buff, stopwords[i]);
+			rm_free(stopwords[i]);
+		}
+		rm_free(stopwords);
+	} else if(idx->type == IDX_VECTOR) {
+		_Write(buff, &idx->dimension, sizeof(idx->dimension));
+	}
+
+	uint32_t fields_count = Index_FieldsCount(idx);
+	_Write(buff, &fields_count, sizeof(fields_count));
+	for(uint32_t i = 0; i < fields_count; i++) {
+		_WriteString(buff, idx->fields[i]);
+	}
+}
+
+void EffectsBuffer_Invalidate(EffectsBuffer *buff) {
+	ASSERT(buff != NULL);
+	buff->valid = false;
+}
+
+bool EffectsBuffer_Valid(const EffectsBuffer *buff) {
+	ASSERT(buff != NULL);
+	return buff->valid;
+}
+
+bool EffectsBuffer_Empty(const EffectsBuffer *buff) {
+	ASSERT(buff != NULL);
+	// only the version header has been written
+	return buff->len == sizeof(uint8_t);
+}
+
+const char *EffectsBuffer_Buffer(const EffectsBuffer *buff) {
+	ASSERT(buff != NULL);
+	return buff->data;
+}
+
+size_t EffectsBuffer_Length(const EffectsBuffer *buff) {
+	ASSERT(buff != NULL);
+	return buff->len;
+}
+
+void EffectsBuffer_Reset(EffectsBuffer *buff) {
+	ASSERT(buff != NULL);
+
+	buff->len   = 0;
+	buff->valid = true;
+	_WriteUInt8(buff, EFFECTS_VERSION);
+}
+
+void EffectsBuffer_Free(EffectsBuffer *buff) {
+	ASSERT(buff != NULL);
+
+	rm_free(buff->data);
+	rm_free(buff);
+}
+
+//------------------------------------------------------------------------------
+// decoding
+//------------------------------------------------------------------------------
+
+typedef struct {
+	const char *pos;   // current read position
+	const char *end;   // end of encoded effects
+} EffectsReader;
+
+static bool _Read(EffectsReader *reader, void *dest, size_t n) {
+	if((size_t)(reader->end - reader->pos) < n) return false;
+	memcpy(dest, reader->pos, n);
+	reader->pos += n;
+	return true;
+}
+
+// read a string, returned string is allocated and should be freed by caller
+static char *_ReadString(EffectsReader *reader) {
+	uint32_t len;
+	if(!_Read(reader, &len, sizeof(len))) return NULL;
+	if((size_t)(reader->end - reader->pos) < len) return NULL;
+
+	char *s = rm_malloc(len + 1);
+	memcpy(s, reader->pos, len);
+	s[len] = '\0';
+	reader->pos += len;
+
+	return s;
+}
+
+static bool _ReadValue(EffectsReader *reader, SIValue *v) {
+	uint64_t t;
+	if(!_Read(reader, &t, sizeof(t))) return false;
+
+	switch(t) {
+		case T_NULL:
+			*v = SI_NullVal();
+			return true;
+		case T_BOOL:
+		case T_INT64: {
+			int64_t i;
+			if(!_Read(reader, &i, sizeof(i))) return false;
+			*v = (t == T_BOOL) ? SI_BoolVal(i) : SI_LongVal(i);
+			return true;
+		}
+		case T_DOUBLE: {
+			double d;
+			if(!_Read(reader, &d, sizeof(d))) return false;
+			*v = SI_DoubleVal(d);
+			return true;
+		}
+		case T_STRING: {
+			char *s = _ReadString(reader);
+			if(s == NULL) return false;
+			*v = SI_TransferStringVal(s);
+			return true;
+		}
+		case T_POINT: {
+			SIValue p = SI_Point(0, 0);
+			if(!_Read(reader, &p.point, sizeof(p.point))) return false;
+			*v = p;
+			return true;
+		}
+		case T_ARRAY: {
+			uint32_t n;
+			if(!_Read(reader, &n, sizeof(n))) return false;
+			// each element is encoded by at least its type
+			if(n > (reader->end - reader->pos) / sizeof(uint64_t)) return false;
+			SIValue arr = SIArray_New(n);
+			for(uint32_t i = 0; i < n; i++) {
+				SIValue elem;
+				if(!_ReadValue(reader, &elem)) {
+					SIValue_Free(arr);
+					return false;
+				}
+				SIArray_Append(&arr, elem);
+				SIValue_Free(elem);
+			}
+			*v = arr;
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+// read attributes and add them to entity
+static bool _ReadAttributes(EffectsReader *reader, GraphContext *gc,
+		GraphEntity *ge) {
+	uint32_t n;
+	if(!_Read(reader, &n, sizeof(n))) return false;
+	if(n == 0) return true;
+
+	// each attribute is encoded by at least its name length and value type
+	if(n > (reader->end - reader->pos) / (sizeof(uint32_t) + sizeof(uint64_t))) {
+		return false;
+	}
+
+	bool          res     =  true;
+	uint32_t      count   =  0;
+	Attribute_ID  *ids    =  rm_malloc(sizeof(Attribute_ID) * n);
+	SIValue       *values =  rm_malloc(sizeof(SIValue) * n);
+
+	for(; count < n; count++) {
+		char *attr = _ReadString(reader);
+		if(attr == NULL) {
+			res = false;
+			break;
+		}
+		ids[count] = GraphContext_FindOrAddAttribute(gc, attr);
+		rm_free(attr);
+
+		if(!_ReadValue(reader, values + count)) {
+			res = false;
+			break;
+		}
+		GraphContext_PreparePropertyValue(gc, values + count);
+	}
+
+	if(res) GraphEntity_AddProperties(ge, ids, values, n);
+
+	for(uint32_t i = 0; i < count; i++) SIValue_Free(values[i]);
+	rm_free(ids);
+	rm_free(values);
+
+	return res;
+}
+
+// read schema name and retrieve its ID, creating schema if missing
+static bool _ReadSchema(EffectsReader *reader, GraphContext *gc, SchemaType t,
+		int *id) {
+	char *name = _ReadString(reader);
+	if(name == NULL) return false;
+
+	Schema *s = GraphContext_GetSchema(gc, name, t);
+	if(s == NULL) s = GraphContext_AddSchema(gc, name, t);
+	rm_free(name);
+
+	*id = Schema_GetID(s);
+	return true;
+}
+
+// read an edge encoded by _WriteEdge
+// returns false on malformed input, 'found' is set if edge exists
+static bool _ReadEdge(EffectsReader *reader, GraphContext *gc, Edge *e,
+		bool *found) {
+	EdgeID  id;
+	NodeID  src;
+	NodeID  dest;
+	int     r;
+
+	if(!_Read(reader, &id, sizeof(id)))                return false;
+	if(!_ReadSchema(reader, gc, SCHEMA_EDGE, &r))      return false;
+	if(!_Read(reader, &src, sizeof(src)))              return false;
+	if(!_Read(reader, &dest, sizeof(dest)))            return false;
+
+	Graph *g = gc->g;
+	*found = (id < Graph_EdgeCount(g) + Graph_DeletedEdgeCount(g) &&
+			  Graph_GetEdge(g, id, e));
+	e->srcNodeID  = src;
+	e->destNodeID = dest;
+	e->relationID = r;
+
+	return true;
+}
+
+static bool _ApplyCreateNode(EffectsReader *reader, GraphContext *gc) {
+	NodeID    id;
+	uint32_t  label_count;
+	bool      res     =  false;
+	int       *labels =  NULL;
+	Node      n       =  GE_NEW_NODE();
+
+	if(!_Read(reader, &id, sizeof(id)))                   return false;
+	if(!_Read(reader, &label_count, sizeof(label_count))) return false;
+
+	// each label is encoded by at least its length
+	if(label_count > (reader->end - reader->pos) / sizeof(uint32_t)) {
+		return false;
+	}
+
+	labels = rm_malloc(sizeof(int) * (label_count + 1));
+	for(uint32_t i = 0; i < label_count; i++) {
+		if(!_ReadSchema(reader, gc, SCHEMA_NODE, labels + i)) goto cleanup;
+	}
+
+	if(!Graph_CreateNodeWithID(gc->g, id, &n, labels, label_count)) {
+		goto cleanup;
+	}
+
+	if(!_ReadAttributes(reader, gc, (GraphEntity *)&n)) goto cleanup;
+
+	for(uint32_t i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		if(Schema_HasIndices(s)) Schema_AddNodeToIndices(s, &n);
+	}
+	res = true;
+
+cleanup:
+	rm_free(labels);
+	return res;
+}
+
+static bool _ApplyCreateEdge(EffectsReader *reader, GraphContext *gc) {
+	EdgeID  id;
+	NodeID  src;
+	NodeID  dest;
+	int     r;
+	Edge    e = GE_NEW_EDGE();
+
+	if(!_Read(reader, &id, sizeof(id)))           return false;
+	if(!_ReadSchema(reader, gc, SCHEMA_EDGE, &r)) return false;
+	if(!_Read(reader, &src, sizeof(src)))         return false;
+	if(!_Read(reader, &dest, sizeof(dest)))       return false;
+
+	if(!Graph_CreateEdgeWithID(gc->g, id, src, dest, r, &e)) return false;
+
+	if(!_ReadAttributes(reader, gc, (GraphEntity *)&e)) return false;
+
+	Schema *s = GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE);
+	if(Schema_HasIndices(s)) Schema_AddEdgeToIndices(s, &e);
+
+	return true;
+}
+
+static bool _ApplyDelete(EffectsReader *reader, GraphContext *gc) {
+	bool      res         =  false;
+	uint32_t  node_count  =  0;
+	uint32_t  edge_count  =  0;
+	Node      *nodes      =  NULL;
+	Edge      *edges      =  NULL;
+
+	if(!_Read(reader, &node_count, sizeof(node_count))) return false;
+
+	// entities which no longer exist are skipped, e.g. a node deleted twice
+	nodes = array_new(Node, node_count);
+	for(uint32_t i = 0; i < node_count; i++) {
+		NodeID id;
+		Node n = GE_NEW_NODE();
+		if(!_Read(reader, &id, sizeof(id))) goto cleanup;
+		if(id < Graph_UncompactedNodeCount(gc->g) && Graph_GetNode(gc->g, id, &n)) {
+			array_append(nodes, n);
+		}
+	}
+
+	if(!_Read(reader, &edge_count, sizeof(edge_count))) goto cleanup;
+
+	edges = array_new(Edge, edge_count);
+	for(uint32_t i = 0; i < edge_count; i++) {
+		bool found;
+		Edge e = GE_NEW_EDGE();
+		if(!_ReadEdge(reader, gc, &e, &found)) goto cleanup;
+		if(found) array_append(edges, e);
+	}
+
+	DeleteEntities(gc, nodes, array_len(nodes), edges, array_len(edges), NULL);
+	res = true;
+
+cleanup:
+	array_free(nodes);
+	if(edges != NULL) array_free(edges);
+	return res;
+}
+
+static bool _ApplyUpdate(EffectsReader *reader, GraphContext *gc, bool clear) {
+	uint8_t  t;
+	bool     found;
+	Node     n = GE_NEW_NODE();
+	Edge     e = GE_NEW_EDGE();
+
+	if(!_Read(reader, &t, sizeof(t))) return false;
+
+	GraphEntity *ge;
+	if(t == GETYPE_NODE) {
+		NodeID id;
+		if(!_Read(reader, &id, sizeof(id))) return false;
+		found = (id < Graph_UncompactedNodeCount(gc->g) &&
+				 Graph_GetNode(gc->g, id, &n));
+		ge = (GraphEntity *)&n;
+	} else if(t == GETYPE_EDGE) {
+		if(!_ReadEdge(reader, gc, &e, &found)) return false;
+		ge = (GraphEntity *)&e;
+	} else {
+		return false;
+	}
+
+	Attribute_ID  attr_id  =  ATTRIBUTE_ALL;
+	SIValue       v        =  SI_NullVal();
+
+	if(!clear) {
+		char *attr = _ReadString(reader);
+		if(attr == NULL) return false;
+		attr_id = GraphContext_FindOrAddAttribute(gc, attr);
+		rm_free(attr);
+
+		if(!_ReadValue(reader, &v)) return false;
+	}
+
+	// the master only records updates to existing entities
+	if(!found) {
+		SIValue_Free(v);
+		return false;
+	}
+
+	// reuse the query path, which handles attribute removal and reindexing
+	// CommitUpdates takes ownership of the value
+	ResultSetStatistics stats = {0};
+	PendingUpdateCtx *updates = array_new(PendingUpdateCtx, 1);
+	PendingUpdateCtx update = {
+		.ge            =  ge,
+		.attr_id       =  attr_id,
+		.new_value     =  v,
+		.update_index  =  GraphContext_HasIndices(gc),
+	};
+	array_append(updates, update);
+
+	CommitUpdates(gc, &stats, updates,
+			(t == GETYPE_NODE) ? ENTITY_NODE : ENTITY_EDGE);
+
+	array_free(updates);
+	return true;
+}
+
+static bool _ApplyAddAttribute(EffectsReader *reader, GraphContext *gc) {
+	char *attr = _ReadString(reader);
+	if(attr == NULL) return false;
+
+	GraphContext_FindOrAddAttribute(gc, attr);
+	rm_free(attr);
+
+	return true;
+}
+
+static bool _ApplyAddSchema(EffectsReader *reader, GraphContext *gc) {
+	uint8_t t;
+	int id;
+
+	if(!_Read(reader, &t, sizeof(t))) return false;
+	if(t != SCHEMA_NODE && t != SCHEMA_EDGE) return false;
+
+	return _ReadSchema(reader, gc, t, &id);
+}
+
+static bool _ApplyAddIndex(EffectsReader *reader, GraphContext *gc) {
+	uint8_t   t;
+	uint8_t   idx_type;
+	int       id;
+	bool      res        =  false;
+	char      *language  =  NULL;
+	char      **stopwords =  NULL;
+	uint32_t  dimension  =  0;
+	Index     *idx       =  NULL;
+
+	if(!_Read(reader, &t, sizeof(t))) return false;
+	if(t != SCHEMA_NODE && t != SCHEMA_EDGE) return false;
+	if(!_ReadSchema(reader, gc, t, &id)) return false;
+	if(!_Read(reader, &idx_type, sizeof(idx_type))) return false;
+	if(idx_type != IDX_EXACT_MATCH && idx_type != IDX_FULLTEXT &&
+	   idx_type != IDX_VECTOR) {
+		return false;
+	}
+	// vector indices are over nodes
+	if(idx_type == IDX_VECTOR && t != SCHEMA_NODE) return false;
+
+	Schema *s = GraphContext_GetSchemaByID(gc, id, t);
+	bool exists = (Schema_GetIndex(s, NULL, idx_type) != NULL);
+
+	if(idx_type == IDX_FULLTEXT) {
+		uint32_t stopwords_count;
+		language = _ReadString(reader);
+		if(language == NULL) goto cleanup;
+		if(!_Read(reader, &stopwords_count, sizeof(stopwords_count))) {
+			goto cleanup;
+		}
+		stopwords = array_new(char *, 0);
+		for(uint32_t i = 0; i < stopwords_count; i++) {
+			char *stopword = _ReadString(reader);
+			if(stopword == NULL) goto cleanup;
+			array_append(stopwords, stopword);
+		}
+	} else if(idx_type == IDX_VECTOR) {
+		if(!_Read(reader, &dimension, sizeof(dimension))) goto cleanup;
+		if(dimension == 0) goto cleanup;
+	}
+
+	uint32_t fields_count;
+	if(!_Read(reader, &fields_count, sizeof(fields_count))) goto cleanup;
+	for(uint32_t i = 0; i < fields_count; i++) {
+		char *field = _ReadString(reader);
+		if(field == NULL) goto cleanup;
+		// fields already indexed are skipped
+		Schema_AddIndex(&idx, s, field, idx_type);
+		rm_free(field);
+	}
+
+	if(idx != NULL) {
+		if(!exists && idx_type == IDX_FULLTEXT) {
+			Index_SetLanguage(idx, language);
+			if(array_len(stopwords) > 0) Index_SetStopwords(idx, stopwords);
+		}
+		if(!exists && idx_type == IDX_VECTOR) Index_SetDimension(idx, dimension);
+		Index_Construct(idx);
+	}
+	res = true;
+
+cleanup:
+	if(language != NULL) rm_free(language);
+	if(stopwords != NULL) {
+		for(uint32_t i = 0; i < array_len(stopwords); i++) rm_free(stopwords[i]);
+		array_free(stopwords);
+	}
+	return res;
+}
+
+bool Effects_Apply(GraphContext *gc, const char *effects, size_t len) {
+	ASSERT(gc      != NULL);
+	ASSERT(effects != NULL);
+
+	EffectsReader reader = { .pos = effects, .end = effects + len };
+
+	uint8_t version;
+	if(!_Read(&reader, &version, sizeof(version))) return false;
+	if(version != EFFECTS_VERSION) return false;
+
+	while(reader.pos < reader.end) {
+		uint8_t t;
+		bool res = false;
+		_Read(&reader, &t, sizeof(t));
+
+		switch(t) {
+			case EFFECT_CREATE_NODE:
+				res = _ApplyCreateNode(&reader, gc);
+				break;
+			case EFFECT_CREATE_EDGE:
+				res = _ApplyCreateEdge(&reader, gc);
+				break;
+			case EFFECT_DELETE:
+				res = _ApplyDelete(&reader, gc);
+				break;
+			case EFFECT_UPDATE:
+				res = _ApplyUpdate(&reader, gc, false);
+				break;
+			case EFFECT_CLEAR:
+				res = _ApplyUpdate(&reader, gc, true);
+				break;
+			case EFFECT_ADD_ATTRIBUTE:
+				res = _ApplyAddAttribute(&reader, gc);
+				break;
+			case EFFECT_ADD_SCHEMA:
+				res = _ApplyAddSchema(&reader, gc);
+				break;
+			case EFFECT_ADD_INDEX:
+				res = _ApplyAddIndex(&reader, gc);
+				break;
+			default:
+				break;
+		}
+
+		if(!res) return false;
+	}
+
+	return true;
+}
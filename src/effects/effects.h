@@ -0,0 +1,155 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../value.h"
+#include "../graph/graphcontext.h"
+#include "../graph/entities/node.h"
+#include "../graph/entities/edge.h"
+
+// effects are the concrete modifications a write query introduced to a graph
+// e.g. "node 12 was created with label Person and name 'a'"
+// replicas apply effects instead of re-executing the query
+//
+// effects are encoded into a binary buffer:
+// | version | effect | effect | ... |
+// each effect starts with its type followed by its payload,
+// labels, relationship types and attributes are encoded by name
+// such that replicas don't depend on the master's schema and attribute IDs
+
+#define EFFECTS_VERSION 1
+
+// EffectsBuffer accumulates the effects of a single query
+typedef struct EffectsBuffer EffectsBuffer;
+
+// create a new effects buffer
+EffectsBuffer *EffectsBuffer_New(void);
+
+// record the creation of node 'n', including its labels and properties
+void EffectsBuffer_AddCreateNodeEffect
+(
+	EffectsBuffer *buff,    // effects buffer
+	GraphContext *gc,       // graph context
+	const Node *n,          // created node
+	const int *labels,      // node label IDs
+	uint label_count        // number of labels
+);
+
+// record the creation of edge 'e', including its properties
+void EffectsBuffer_AddCreateEdgeEffect
+(
+	EffectsBuffer *buff,    // effects buffer
+	GraphContext *gc,       // graph context
+	const Edge *e,          // created edge
+	NodeID src,             // source node ID
+	NodeID dest,            // destination node ID
+	int r                   // relationship type ID
+);
+
+// record the deletion of nodes and edges
+// implicitly deleted edges, i.e. edges of deleted nodes, are not recorded
+void EffectsBuffer_AddDeleteEffect
+(
+	EffectsBuffer *buff,    // effects buffer
+	GraphContext *gc,       // graph context
+	Node *nodes,            // deleted nodes
+	uint node_count,        // number of deleted nodes
+	Edge *edges,            // deleted edges
+	uint edge_count         // number of deleted edges
+);
+
+// record an entity's attribute update
+// a NULL value removes the attribute, ATTRIBUTE_ALL clears all attributes
+void EffectsBuffer_AddUpdateEffect
+(
+	EffectsBuffer *buff,    // effects buffer
+	GraphContext *gc,       // graph context
+	GraphEntity *ge,        // updated entity
+	GraphEntityType t,      // entity type
+	Attribute_ID attr_id,   // updated attribute
+	SIValue v               // new value
+);
+
+// record the introduction of attribute 'attr'
+void EffectsBuffer_AddAttributeEffect
+(
+	EffectsBuffer *buff,    // effects buffer
+	const char *attr        // attribute name
+);
+
+// record the introduction of schema 's', excluding its indices
+void EffectsBuffer_AddSchemaEffect
+(
+	EffectsBuffer *buff,    // effects buffer
+	const Schema *s         // schema
+);
+
+// record the introduction of index 'idx' on schema 's'
+// the index is populated once applied
+void EffectsBuffer_AddIndexEffect
+(
+	EffectsBuffer *buff,    // effects buffer
+	const Schema *s,        // indexed schema
+	Index *idx              // index
+);
+
+// mark buffer as unable to describe the query's modifications
+// e.g. a value which can't be encoded or a write procedure call
+// an invalid buffer stays invalid until reset
+void EffectsBuffer_Invalidate
+(
+	EffectsBuffer *buff
+);
+
+// returns true if buffer describes all recorded modifications
+bool EffectsBuffer_Valid
+(
+	const EffectsBuffer *buff
+);
+
+// returns true if no effects were recorded
+bool EffectsBuffer_Empty
+(
+	const EffectsBuffer *buff
+);
+
+// returns the encoded effects
+const char *EffectsBuffer_Buffer
+(
+	const EffectsBuffer *buff
+);
+
+// returns the encoded effects length in bytes
+size_t EffectsBuffer_Length
+(
+	const EffectsBuffer *buff
+);
+
+// discard recorded effects
+void EffectsBuffer_Reset
+(
+	EffectsBuffer *buff
+);
+
+// free effects buffer
+void EffectsBuffer_Free
+(
+	EffectsBuffer *buff
+);
+
+// apply encoded effects to graph
+// the caller is expected to hold the graph's write lock
+// returns false if effects are malformed, in which case effects preceding
+// the malformed one remain applied
+bool Effects_Apply
+(
+	GraphContext *gc,       // graph to apply effects to
+	const char *effects,    // encoded effects
+	size_t len              // encoded effects length
+);
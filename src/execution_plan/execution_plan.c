@@ -11,6 +11,8 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../util/tsc.h"
+#include "execution_plan_cost.h"
 #include "./optimizations/optimizer.h"
 #include "../ast/ast_build_filter_tree.h"
 #include "execution_plan_build/execution_plan_modify.h"
@@ -127,6 +129,8 @@ static ExecutionPlan *_ExecutionPlan_UnionPlans(AST *ast) {
 		ExecutionPlan_AddOp(join_op, sub_plan->root);
 	}
 
+	optimizeUnionPlan(plan);
+
 	return plan;
 }
 
@@ -359,14 +363,43 @@ void ExecutionPlan_PreparePlan(ExecutionPlan *plan) {
 	plan->prepared = true;
 }
 
+// compiles the expressions of 'op' and its descendants
+static void _ExecutionPlan_CompileOps(OpBase *op) {
+	switch(op->type) {
+		case OPType_PROJECT:
+			ProjectOp_Compile((OpProject *)op);
+			break;
+		case OPType_AGGREGATE:
+			AggregateOp_Compile((OpAggregate *)op);
+			break;
+		default:
+			// operation remains interpreted
+			break;
+	}
+
+	for(uint i = 0; i < op->childCount; i++) {
+		_ExecutionPlan_CompileOps(op->children[i]);
+	}
+}
+
+void ExecutionPlan_Compile(ExecutionPlan *plan) {
+	ASSERT(plan->prepared);
+	_ExecutionPlan_CompileOps(plan->root);
+}
+
 inline rax *ExecutionPlan_GetMappings(const ExecutionPlan *plan) {
 	ASSERT(plan && plan->record_map);
 	return plan->record_map;
 }
 
+// number of Records borrowed by the current thread
+// attributed to the borrowing operation when profiling
+static __thread uint64_t _borrowed_records = 0;
+
 Record ExecutionPlan_BorrowRecord(ExecutionPlan *plan) {
 	rax *mapping = ExecutionPlan_GetMappings(plan);
 	ASSERT(plan->record_pool);
+	_borrowed_records++;
 
 	// Get a Record from the pool and set its owner and mapping.
 	Record r = ObjectPool_NewItem(plan->record_pool);
@@ -375,6 +408,10 @@ Record ExecutionPlan_BorrowRecord(ExecutionPlan *plan) {
 	return r;
 }
 
+uint64_t ExecutionPlan_BorrowedRecords(void) {
+	return _borrowed_records;
+}
+
 void ExecutionPlan_ReturnRecord(ExecutionPlan *plan, Record r) {
 	ASSERT(plan && r);
 	ObjectPool_DeleteItem(plan->record_pool, r);
@@ -424,42 +461,16 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 
 	ExecutionPlan_Init(plan);
 
-	Record r = NULL;
-	// Execute the root operation and free the processed Record until the data stream is depleted.
-	while((r = OpBase_Consume(plan->root)) != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
-
-	return QueryCtx_GetResultSet();
-}
-
-//------------------------------------------------------------------------------
-// Execution plan draining
-//------------------------------------------------------------------------------
-
-// NOP operation consume routine for immediately terminating execution.
-static Record deplete_consume(struct OpBase *op) {
-	return NULL;
-}
-
-// return true if execution plan been drained
-// false otherwise
-bool ExecutionPlan_Drained(ExecutionPlan *plan) {
-	ASSERT(plan != NULL);
-	ASSERT(plan->root != NULL);
-	return (plan->root->consume == deplete_consume);
-}
-
-static void _ExecutionPlan_Drain(OpBase *root) {
-	root->consume = deplete_consume;
-	for(int i = 0; i < root->childCount; i++) {
-		_ExecutionPlan_Drain(root->children[i]);
+	uint n = 0;
+	Record batch[OP_BATCH_CAPACITY];
+	// Execute the root operation and free the processed Records until the data stream is depleted.
+	while((n = OpBase_ConsumeBatch(plan->root, batch, OP_BATCH_CAPACITY)) > 0) {
+		for(uint i = 0; i < n; i++) ExecutionPlan_ReturnRecord(batch[i]->owner, batch[i]);
+		// abort if the query was cancelled, e.g. timed out
+		QueryCtx_CheckCancelled();
 	}
-}
 
-// Resets each operation consume function to simply return NULL
-// this will cause the execution-plan to quickly deplete
-void ExecutionPlan_Drain(ExecutionPlan *plan) {
-	ASSERT(plan && plan->root);
-	_ExecutionPlan_Drain(plan->root);
+	return QueryCtx_GetResultSet();
 }
 
 //------------------------------------------------------------------------------
@@ -469,9 +480,8 @@ void ExecutionPlan_Drain(ExecutionPlan *plan) {
 static void _ExecutionPlan_InitProfiling(OpBase *root) {
 	root->profile = root->consume;
 	root->consume = OpBase_Profile;
-	root->stats = rm_malloc(sizeof(OpStats));
-	root->stats->profileExecTime = 0;
-	root->stats->profileRecordCount = 0;
+	root->consumeBatch = NULL;
+	root->stats = rm_calloc(1, sizeof(OpStats));
 
 	if(root->childCount) {
 		for(int i = 0; i < root->childCount; i++) {
@@ -481,20 +491,48 @@ static void _ExecutionPlan_InitProfiling(OpBase *root) {
 	}
 }
 
+// converts accumulated ticks to the time spent within each operation
+// excluding the time spent by its children
+// the same goes for memory and Record allocations
 static void _ExecutionPlan_FinalizeProfiling(OpBase *root) {
+	OpStats *stats = root->stats;
+	stats->profileExecTime = TSC_ToMs(stats->profileTicks);
+	stats->profileBytesAllocated = stats->profileBytesAllocatedTotal;
+	stats->profileBytesRetained = stats->profileBytesRetainedTotal;
+	stats->profileRecordAllocs = stats->profileRecordAllocsTotal;
 	if(root->childCount) {
 		for(int i = 0; i < root->childCount; i++) {
 			OpBase *child = root->children[i];
-			root->stats->profileExecTime -= child->stats->profileExecTime;
+			OpStats *child_stats = child->stats;
+			stats->profileExecTime -= TSC_ToMs(child_stats->profileTicks);
+			stats->profileBytesAllocated -= child_stats->profileBytesAllocatedTotal;
+			stats->profileBytesRetained -= child_stats->profileBytesRetainedTotal;
+			stats->profileRecordAllocs -= child_stats->profileRecordAllocsTotal;
 			_ExecutionPlan_FinalizeProfiling(child);
 		}
 	}
-	root->stats->profileExecTime *= 1000;   // Milliseconds.
+}
+
+// sets the estimated number of records produced by each profiled operation
+static void _ExecutionPlan_SetEstimates(OpBase *root, const OpEstimate *estimates) {
+	root->stats->profileEstimatedRecords = OpEstimate_Records(estimates, root);
+	for(int i = 0; i < root->childCount; i++) {
+		_ExecutionPlan_SetEstimates(root->children[i], estimates);
+	}
 }
 
 ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan) {
 	_ExecutionPlan_InitProfiling(plan->root);
+
+	// estimate ahead of execution, which might modify the graph
+	double cost;
+	OpEstimate *estimates = ExecutionPlan_EstimateOps(plan, &cost);
+	_ExecutionPlan_SetEstimates(plan->root, estimates);
+	array_free(estimates);
+
+	rm_track_allocations(true);
 	ResultSet *rs = ExecutionPlan_Execute(plan);
+	rm_track_allocations(false);
 	_ExecutionPlan_FinalizeProfiling(plan->root);
 	return rs;
 }
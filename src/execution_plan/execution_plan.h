@@ -30,6 +30,13 @@ ExecutionPlan *NewExecutionPlan(void);
 /* Prepare an execution plan for execution: optimize, initialize result set schema. */
 void ExecutionPlan_PreparePlan(ExecutionPlan *plan);
 
+// compile the expressions evaluated by the plan's projections and
+// aggregations, such that the most common expressions, attribute accesses,
+// variables and constants, are evaluated without the interpreter
+// filters are always compiled, operations and expressions which can't be
+// compiled remain interpreted, 'plan' must be prepared
+void ExecutionPlan_Compile(ExecutionPlan *plan);
+
 /* Allocate a new ExecutionPlan segment. */
 ExecutionPlan *ExecutionPlan_NewEmptyExecutionPlan(void);
 
@@ -46,6 +53,9 @@ rax *ExecutionPlan_GetMappings(const ExecutionPlan *plan);
 /* Retrieves a Record from the ExecutionPlan's Record pool. */
 Record ExecutionPlan_BorrowRecord(ExecutionPlan *plan);
 
+/* Retrieve the number of Records borrowed by the calling thread. */
+uint64_t ExecutionPlan_BorrowedRecords(void);
+
 /* Free Record contents and return it to the Record pool. */
 void ExecutionPlan_ReturnRecord(ExecutionPlan *plan, Record r);
 
@@ -58,12 +68,6 @@ void ExecutionPlan_Init(ExecutionPlan *plan);
 /* Executes plan */
 ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan);
 
-/* Checks if execution plan been drained */
-bool ExecutionPlan_Drained(ExecutionPlan *plan);
-
-/* Drains execution plan */
-void ExecutionPlan_Drain(ExecutionPlan *plan);
-
 /* Profile executes plan */
 ResultSet *ExecutionPlan_Profile(ExecutionPlan *plan);
 
@@ -5,8 +5,28 @@
 #include "../../query_ctx.h"
 #include "../../util/rax_extensions.h"
 #include "../optimizations/optimizations.h"
+#include "../../ast/ast_hints.h"
 #include "../../ast/ast_build_filter_tree.h"
 
+// returns the alias of the first unbound node of 'cc' hinted by
+// either USING SCAN or USING INDEX, NULL if there's no such node
+static const char *_HintedStartPoint(const AST *ast, const QueryGraph *cc,
+									 rax *bound_vars) {
+	uint node_count = array_len(cc->nodes);
+	for(uint i = 0; i < node_count; i++) {
+		const char *alias = cc->nodes[i]->alias;
+		if(raxFind(bound_vars, (unsigned char *)alias, strlen(alias))
+			!= raxNotFound) {
+			continue;
+		}
+		if(AST_GetHint(ast, HINT_SCAN, alias, NULL) ||
+		   AST_GetHint(ast, HINT_INDEX, alias, NULL)) {
+			return alias;
+		}
+	}
+	return NULL;
+}
+
 static void _ExecutionPlan_ProcessQueryGraph(ExecutionPlan *plan, QueryGraph *qg,
 											 AST *ast) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
@@ -50,7 +70,8 @@ static void _ExecutionPlan_ProcessQueryGraph(ExecutionPlan *plan, QueryGraph *qg
 		uint expCount = array_len(exps);
 
 		// Reorder exps, to the most performant arrangement of evaluation.
-		orderExpressions(qg, exps, &expCount, ft, bound_vars);
+		const char *start = _HintedStartPoint(ast, cc, bound_vars);
+		orderExpressions(qg, exps, &expCount, ft, bound_vars, start);
 
 		// Create the SCAN operation that will be the tail of the traversal chain.
 		QGNode *src = QueryGraph_GetNodeByAlias(qg, AlgebraicExpression_Src(exps[0]));
@@ -16,13 +16,15 @@ static ExecutionPlan *_ClonePlanInternals(const ExecutionPlan *template) {
 	clone->record_map = raxClone(template->record_map);
 	if(template->ast_segment) clone->ast_segment = AST_ShallowCopy(template->ast_segment);
 	if(template->query_graph) {
-		QueryGraph_ResolveUnknownRelIDs(template->query_graph);
-		clone->query_graph = QueryGraph_Clone(template->query_graph);
-	}
-	// TODO improve QueryGraph logic so that we do not need to store or clone connected_components.
-	if(template->connected_components) {
-		array_clone_with_cb(clone->connected_components, template->connected_components, QueryGraph_Clone);
+		QueryGraph *qg = template->query_graph;
+		QueryGraph_ResolveUnknownRelIDs(qg);
+		// once all of its relationship types are resolved the query graph is
+		// never modified again, share it rather than copy it on every clone
+		clone->query_graph = (qg->unknown_reltype_ids) ? QueryGraph_Clone(qg) :
+			QueryGraph_Share(qg);
 	}
+	// connected components are only consulted while the plan is built
+	// as such they're not cloned
 
 	return clone;
 }
@@ -66,7 +68,8 @@ static ExecutionPlan *_ExecutionPlan_Clone(const ExecutionPlan *template) {
 
 /* This function clones the input ExecutionPlan by recursively visiting its tree of ops.
  * When an op is encountered that was constructed as part of a different ExecutionPlan segment, that segment
- * and its internal members (FilterTree, record mapping, query graphs, and AST segment) are also cloned. */
+ * and its internal members (FilterTree, record mapping and AST segment) are also cloned.
+ * Immutable segment members, the AST and resolved query graphs, are shared with the template. */
 ExecutionPlan *ExecutionPlan_Clone(const ExecutionPlan *template) {
 	ASSERT(template != NULL);
 	// Store the original AST pointer.
@@ -0,0 +1,358 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "execution_plan_cost.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "ops/op_limit.h"
+#include "ops/op_aggregate.h"
+#include "ops/op_conditional_traverse.h"
+#include "ops/op_cond_var_len_traverse.h"
+#include "optimizations/traverse_order_utils.h"
+#include <math.h>
+
+// estimated fraction of records passing a filter
+#define FILTER_SELECTIVITY (1.0 / 3.0)
+
+// graph statistics shared by all operations of a plan
+typedef struct {
+	double node_count;      // number of nodes
+	double edge_count;      // number of edges
+	double degree;          // average node degree
+	OpEstimate *estimates;  // per operation estimates, NULL if not collected
+} CostCtx;
+
+// reserves the estimate of 'op' ahead of its descendants'
+// returns its position, -1 if estimates aren't collected
+static int _ReserveEstimate
+(
+	CostCtx *ctx,
+	const OpBase *op
+) {
+	if(ctx->estimates == NULL) return -1;
+
+	OpEstimate e = {.op = op, .records = 0};
+	array_append(ctx->estimates, e);
+	return array_len(ctx->estimates) - 1;
+}
+
+// sets the number of records produced by the operation reserved at 'pos'
+static void _SetEstimate
+(
+	CostCtx *ctx,
+	int pos,
+	double records
+) {
+	if(pos >= 0) ctx->estimates[pos].records = records;
+}
+
+// scales the estimates collected from position 'from' onwards by 'factor'
+// e.g. a branch invoked once per record is scaled by the number of records
+static void _ScaleEstimates
+(
+	CostCtx *ctx,
+	int from,
+	double factor
+) {
+	if(ctx->estimates == NULL) return;
+
+	uint n = array_len(ctx->estimates);
+	for(uint i = from; i < n; i++) ctx->estimates[i].records *= factor;
+}
+
+// position the next collected estimate is stored at
+static inline int _NextEstimate
+(
+	const CostCtx *ctx
+) {
+	return (ctx->estimates != NULL) ? array_len(ctx->estimates) : 0;
+}
+
+// estimate the number of nodes resolved by scan operation 'op'
+static double _ScanCardinality
+(
+	const CostCtx *ctx,
+	const OpBase *op
+) {
+	const QueryGraph *qg = op->plan->query_graph;
+	const char *alias = op->modifies[0];
+
+	if(qg == NULL || QueryGraph_GetNodeByAlias(qg, alias) == NULL) {
+		return ctx->node_count;
+	}
+
+	return TraverseOrder_NodeCardinality(alias, qg);
+}
+
+// estimate the number of destinations reached per source by traversal 'op'
+// using the degree summaries of its relationship types
+// falls back to the graph's average degree when no summary is available
+static double _TraverseFanout
+(
+	const CostCtx *ctx,
+	const OpCondTraverse *op
+) {
+	const QueryGraph *qg = op->op.plan->query_graph;
+	const char *edge = AlgebraicExpression_Edge(op->ae);
+	const char *src = AlgebraicExpression_Src(op->ae);
+	if(qg == NULL || edge == NULL) return ctx->degree;
+
+	QGEdge *e = QueryGraph_GetEdgeByAlias(qg, edge);
+	if(e == NULL || QueryGraph_GetNodeByAlias(qg, src) == NULL) {
+		return ctx->degree;
+	}
+
+	// any relationship type
+	uint rel_count = QGEdge_RelationCount(e);
+	if(rel_count == 0) return ctx->degree;
+
+	// the expression traverses the edge from its source unless reversed
+	Graph *g = QueryCtx_GetGraph();
+	bool forward = (strcmp(src, QGEdge_Src(e)->alias) == 0);
+	double sources = TraverseOrder_NodeCardinality(src, qg);
+
+	double fanout = 0;
+	for(uint i = 0; i < rel_count; i++) {
+		int r = QGEdge_RelationID(e, i);
+		if(r < 0) continue;  // unknown relationship type, no edges
+
+		double edges = Graph_RelationEdgeCount(g, r);
+		if(edges == 0) continue;
+
+		for(int d = 0; d < (e->bidirectional ? 2 : 1); d++) {
+			double endpoints;
+			bool outgoing = (d == 0) ? forward : !forward;
+			if(!GraphStatistics_RelationEndpoints(&g->stats, r, outgoing,
+						&endpoints)) {
+				return ctx->degree;
+			}
+
+			// a source node is one of the relation's endpoints with
+			// probability endpoints / sources, each endpoint has
+			// edges / endpoints edges on average
+			fanout += edges / MAX(endpoints, sources);
+		}
+	}
+
+	return fanout;
+}
+
+// blocking operations consume their entire input before producing records
+static bool _Blocking
+(
+	const OpBase *op
+) {
+	if(op->type == OPType_SORT) return true;
+
+	for(int i = 0; i < EAGER_OP_COUNT; i++) {
+		if(op->type == EAGER_OPERATIONS[i]) return true;
+	}
+
+	return false;
+}
+
+// apply operations invoke their right-hand branches once per bound record
+static bool _Apply
+(
+	const OpBase *op
+) {
+	// merge has a bound branch only if it follows previous clauses
+	if(op->type == OPType_MERGE) return op->childCount == 3;
+
+	return op->type == OPType_APPLY || OP_IS_APPLY(op);
+}
+
+// estimates the number of records 'op' produces per invocation
+// the records produced by 'op' and its descendants are accumulated in 'cost'
+// 'streaming' is cleared if a blocking operation is encountered
+static double _Estimate
+(
+	CostCtx *ctx,
+	const OpBase *op,
+	double *cost,
+	bool *streaming
+) {
+	double card;
+	int n = op->childCount;
+	int pos = _ReserveEstimate(ctx, op);
+
+	if(_Blocking(op)) *streaming = false;
+
+	if(_Apply(op)) {
+		double lhs = _Estimate(ctx, op->children[0], cost, streaming);
+		card = lhs;
+		for(int i = 1; i < n; i++) {
+			double rhs_cost = 0;
+			int rhs_pos = _NextEstimate(ctx);
+			double rhs = _Estimate(ctx, op->children[i], &rhs_cost, streaming);
+			// the branch is invoked once per bound record
+			_ScaleEstimates(ctx, rhs_pos, lhs);
+			*cost += lhs * rhs_cost;
+			// only Apply extends bound records with its branch records
+			if(op->type == OPType_APPLY) card *= rhs;
+		}
+		_SetEstimate(ctx, pos, card);
+		*cost += card;
+		return card;
+	}
+
+	if(op->type == OPType_LIMIT) {
+		double child_cost = 0;
+		bool child_streaming = true;
+		int child_pos = _NextEstimate(ctx);
+		double input = _Estimate(ctx, op->children[0], &child_cost,
+				&child_streaming);
+
+		// a streaming input is pulled only up to the limit
+		double limit = ((const OpLimit *)op)->limit;
+		if(input > limit) {
+			if(child_streaming) {
+				child_cost *= limit / input;
+				_ScaleEstimates(ctx, child_pos, limit / input);
+			}
+			input = limit;
+		}
+
+		_SetEstimate(ctx, pos, input);
+		*streaming = *streaming && child_streaming;
+		*cost += child_cost + input;
+		return input;
+	}
+
+	// records produced by the first child, or a single invocation
+	double input = 1;
+	double children[n];
+	for(int i = 0; i < n; i++) {
+		children[i] = _Estimate(ctx, op->children[i], cost, streaming);
+	}
+	if(n > 0) input = children[0];
+
+	switch(op->type) {
+		case OPType_ALL_NODE_SCAN:
+		case OPType_NODE_BY_LABEL_SCAN:
+			card = input * _ScanCardinality(ctx, op);
+			break;
+		case OPType_NODE_BY_INDEX_SCAN:
+			// an index scan is a filtered label scan
+			card = input * _ScanCardinality(ctx, op) * FILTER_SELECTIVITY;
+			break;
+		case OPType_EDGE_BY_INDEX_SCAN:
+			card = input * ctx->edge_count * FILTER_SELECTIVITY;
+			break;
+		case OPType_NODE_BY_ID_SEEK:
+		case OPType_NODE_BY_LABEL_AND_ID_SCAN:
+		case OPType_ARGUMENT:
+			card = input;
+			break;
+		case OPType_CONDITIONAL_TRAVERSE:
+			card = input * _TraverseFanout(ctx, (const OpCondTraverse *)op);
+			break;
+		case OPType_CONDITIONAL_VAR_LEN_TRAVERSE: {
+			// each source reaches at most every node in the graph
+			const CondVarLenTraverse *t = (const CondVarLenTraverse *)op;
+			double reached = pow(ctx->degree, t->maxHops);
+			card = input * MIN(reached, MAX(ctx->node_count, 1));
+			break;
+		}
+		case OPType_FILTER:
+		case OPType_EXPAND_INTO:
+		case OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO:
+			card = input * FILTER_SELECTIVITY;
+			break;
+		case OPType_CARTESIAN_PRODUCT:
+			card = 1;
+			for(int i = 0; i < n; i++) card *= children[i];
+			break;
+		case OPType_VALUE_HASH_JOIN:
+			card = 0;
+			for(int i = 0; i < n; i++) card = MAX(card, children[i]);
+			break;
+		case OPType_LEAPFROG_JOIN:
+			card = input;
+			for(int i = 1; i < n; i++) card = MIN(card, children[i]);
+			break;
+		case OPType_JOIN:
+			card = 0;
+			for(int i = 0; i < n; i++) card += children[i];
+			break;
+		case OPType_AGGREGATE:
+			// a keyless aggregation produces a single record
+			card = (((const OpAggregate *)op)->key_count == 0) ? 1 : input;
+			break;
+		default:
+			card = input;
+			break;
+	}
+
+	_SetEstimate(ctx, pos, card);
+	*cost += card;
+	return card;
+}
+
+static void _CostCtx_Init
+(
+	CostCtx *ctx
+) {
+	Graph *g = QueryCtx_GetGraph();
+	ASSERT(g != NULL);
+
+	ctx->node_count = Graph_NodeCount(g);
+	ctx->edge_count = Graph_EdgeCount(g);
+	ctx->degree = (ctx->node_count > 0) ? ctx->edge_count / ctx->node_count : 0;
+	if(ctx->degree < 1) ctx->degree = 1;
+	ctx->estimates = NULL;
+}
+
+double ExecutionPlan_EstimateCost
+(
+	const ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	CostCtx ctx;
+	_CostCtx_Init(&ctx);
+
+	double cost = 0;
+	bool streaming = true;
+	_Estimate(&ctx, plan->root, &cost, &streaming);
+
+	return cost;
+}
+
+OpEstimate *ExecutionPlan_EstimateOps
+(
+	const ExecutionPlan *plan,
+	double *cost
+) {
+	ASSERT(plan != NULL);
+	ASSERT(cost != NULL);
+
+	CostCtx ctx;
+	_CostCtx_Init(&ctx);
+	ctx.estimates = array_new(OpEstimate, 16);
+
+	*cost = 0;
+	bool streaming = true;
+	_Estimate(&ctx, plan->root, cost, &streaming);
+
+	return ctx.estimates;
+}
+
+double OpEstimate_Records
+(
+	const OpEstimate *estimates,
+	const OpBase *op
+) {
+	ASSERT(estimates != NULL);
+
+	uint n = array_len((OpEstimate *)estimates);
+	for(uint i = 0; i < n; i++) {
+		if(estimates[i].op == op) return estimates[i].records;
+	}
+
+	return -1;
+}
@@ -0,0 +1,43 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "execution_plan.h"
+
+// estimates the cost of executing 'plan'
+// the cost is the estimated number of records produced by all of the plan's
+// operations, derived from the graph's label, node and edge counts
+// the estimate relies on the current graph statistics and
+// must be computed while the graph is accessible via the QueryCtx
+double ExecutionPlan_EstimateCost
+(
+	const ExecutionPlan *plan  // plan to estimate
+);
+
+// estimated number of records an operation produces
+// over the entire execution of its plan
+typedef struct {
+	const OpBase *op;  // estimated operation
+	double records;    // estimated number of records produced
+} OpEstimate;
+
+// estimates the number of records produced by each of 'plan''s operations
+// records produced by the operations sum up to the plan's cost
+// returns an array of estimates in pre-order, to be freed by array_free
+OpEstimate *ExecutionPlan_EstimateOps
+(
+	const ExecutionPlan *plan,  // plan to estimate
+	double *cost                // [output] estimated plan cost
+);
+
+// returns the estimated number of records produced by 'op'
+// or -1 if 'estimates' doesn't cover 'op'
+double OpEstimate_Records
+(
+	const OpEstimate *estimates,  // estimates of the plan 'op' is part of
+	const OpBase *op              // operation to look up
+);
@@ -7,9 +7,28 @@
 #include "execution_plan.h"
 #include "../RG.h"
 #include "./ops/ops.h"
+#include "../util/arr.h"
+#include "execution_plan_cost.h"
+
+// annotates an unprofiled operation with its estimated number of records
+// produced and consumed, and its share of the plan's estimated cost
+static void _EstimateToString(const OpBase *op, const OpEstimate *estimates,
+		double cost, sds *buffer) {
+	double records = OpEstimate_Records(estimates, op);
+	double input = 0;
+	for(int i = 0; i < op->childCount; i++) {
+		input += OpEstimate_Records(estimates, op->children[i]);
+	}
+	double share = (cost > 0) ? records / cost * 100 : 0;
+
+	*buffer = sdscatprintf(*buffer,
+			" | Estimated records: %.0f, Estimated input: %.0f, Cost: %.1f%%",
+			records, input, share);
+}
 
 void _ExecutionPlan_Print(const OpBase *op, RedisModuleCtx *ctx, sds *buffer,
-						  int ident, int *op_count) {
+						  int ident, int *op_count, const OpEstimate *estimates,
+						  double cost) {
 	if(!op) return;
 
 	*op_count += 1; // account for current operation.
@@ -18,12 +37,14 @@ void _ExecutionPlan_Print(const OpBase *op, RedisModuleCtx *ctx, sds *buffer,
 	sdsclear(*buffer);
 	*buffer = sdscatprintf(*buffer, "%*s", ident, "");
 	OpBase_ToString(op, buffer);
+	if(estimates) _EstimateToString(op, estimates, cost, buffer);
 
 	RedisModule_ReplyWithStringBuffer(ctx, *buffer, sdslen(*buffer));
 
 	// Recurse over child operations.
 	for(int i = 0; i < op->childCount; i++) {
-		_ExecutionPlan_Print(op->children[i], ctx, buffer, ident + 4, op_count);
+		_ExecutionPlan_Print(op->children[i], ctx, buffer, ident + 4, op_count,
+				estimates, cost);
 	}
 }
 
@@ -34,11 +55,20 @@ void ExecutionPlan_Print(const ExecutionPlan *plan, RedisModuleCtx *ctx) {
 	int op_count = 0;   // Number of operations printed.
 	sds buffer = sdsempty();
 
+	// profiled operations report their estimates along with their statistics
+	double cost = 0;
+	OpEstimate *estimates = NULL;
+	if(plan->root->stats == NULL) {
+		estimates = ExecutionPlan_EstimateOps(plan, &cost);
+	}
+
 	// No idea how many operation are in execution plan.
 	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
-	_ExecutionPlan_Print(plan->root, ctx, &buffer, 0, &op_count);
+	_ExecutionPlan_Print(plan->root, ctx, &buffer, 0, &op_count, estimates,
+			cost);
 
 	RedisModule_ReplySetArrayLength(ctx, op_count);
 	sdsfree(buffer);
+	if(estimates) array_free(estimates);
 }
 
@@ -7,10 +7,12 @@
 #include "op.h"
 #include "RG.h"
 #include "../../util/rmalloc.h"
-#include "../../util/simple_timer.h"
+#include "../../util/tsc.h"
+#include <inttypes.h>
 
 /* Forward declarations */
 Record ExecutionPlan_BorrowRecord(struct ExecutionPlan *plan);
+uint64_t ExecutionPlan_BorrowedRecords(void);
 rax *ExecutionPlan_GetMappings(const struct ExecutionPlan *plan);
 void ExecutionPlan_ReturnRecord(struct ExecutionPlan *plan, Record r);
 
@@ -39,12 +41,28 @@ void OpBase_Init(OpBase *op, OPType type, const char *name, fpInit init, fpConsu
 	op->clone = clone;
 	op->free = free;
 	op->profile = NULL;
+	op->consumeBatch = NULL;
 }
 
 inline Record OpBase_Consume(OpBase *op) {
 	return op->consume(op);
 }
 
+uint OpBase_ConsumeBatch(OpBase *op, Record *batch, uint cap) {
+	ASSERT(cap > 0);
+	if(op->consumeBatch) return op->consumeBatch(op, batch, cap);
+
+	// op doesn't support batching, consume a record at a time
+	uint n = 0;
+	while(n < cap) {
+		Record r = op->consume(op);
+		if(r == NULL) break;
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 int OpBase_Modifies(OpBase *op, const char *alias) {
 	if(!op->modifies) op->modifies = array_new(const char *, 1);
 	array_append(op->modifies, alias);
@@ -119,9 +137,21 @@ void OpBase_PropagateReset(OpBase *op) {
 
 static void _OpBase_StatsToString(const OpBase *op, sds *buff) {
 	*buff = sdscatprintf(*buff,
-					" | Records produced: %d, Execution time: %f ms",
+					" | Records produced: %d, Estimated records: %.0f"
+					", Execution time: %f ms"
+					", Memory allocated: %" PRId64 " bytes"
+					", Memory retained: %" PRId64 " bytes"
+					", Peak memory: %" PRId64 " bytes"
+					", GraphBLAS peak memory: %" PRId64 " bytes"
+					", Records allocated: %" PRIu64,
 					op->stats->profileRecordCount,
-					op->stats->profileExecTime);
+					op->stats->profileEstimatedRecords,
+					op->stats->profileExecTime,
+					op->stats->profileBytesAllocated,
+					op->stats->profileBytesRetained,
+					op->stats->profilePeakMemory,
+					op->stats->profileMatrixPeakMemory,
+					op->stats->profileRecordAllocs);
 }
 
 void OpBase_ToString(const OpBase *op, sds *buff) {
@@ -134,13 +164,42 @@ void OpBase_ToString(const OpBase *op, sds *buff) {
 }
 
 Record OpBase_Profile(OpBase *op) {
-	double tic [2];
-	// Start timer.
-	simple_tic(tic);
+	OpStats *stats = op->stats;
+	rm_alloc_counters before;
+	rm_alloc_counters after;
+
+	rm_get_alloc_counters(&before);
+	// measure GraphBLAS peak from this call's start
+	rm_set_matrix_peak(before.grb_retained);
+	uint64_t records = ExecutionPlan_BorrowedRecords();
+	// Time stamp counter reads are cheap enough to wrap every call.
+	uint64_t start = TSC_Now();
 	Record r = op->profile(op);
-	// Stop timer and accumulate.
-	op->stats->profileExecTime += simple_toc(tic);
-	if(r) op->stats->profileRecordCount++;
+	stats->profileTicks += TSC_Now() - start;
+	rm_get_alloc_counters(&after);
+
+	// GraphBLAS memory allocated on top of what was held as the call started
+	int64_t matrix_peak = after.grb_peak - before.grb_retained;
+	if(matrix_peak > stats->profileMatrixPeakMemory) {
+		stats->profileMatrixPeakMemory = matrix_peak;
+	}
+	// hide this call's transient peak from the calling operation
+	// which observes only the memory left held
+	rm_set_matrix_peak(MAX(before.grb_peak, after.grb_retained));
+
+	if(r) stats->profileRecordCount++;
+	stats->profileRecordAllocsTotal += ExecutionPlan_BorrowedRecords() - records;
+	stats->profileBytesAllocatedTotal += after.allocated - before.allocated;
+	stats->profileBytesRetainedTotal += (after.allocated - after.freed) -
+		(before.allocated - before.freed);
+
+	// memory currently retained by the operation, excluding its children
+	int64_t retained = stats->profileBytesRetainedTotal;
+	for(int i = 0; i < op->childCount; i++) {
+		retained -= op->children[i]->stats->profileBytesRetainedTotal;
+	}
+	if(retained > stats->profilePeakMemory) stats->profilePeakMemory = retained;
+
 	return r;
 }
 
@@ -156,6 +215,14 @@ void OpBase_UpdateConsume(OpBase *op, fpConsume consume) {
 	else op->consume = consume;
 }
 
+void OpBase_UpdateConsumeBatch(OpBase *op, fpConsumeBatch consumeBatch) {
+	ASSERT(op != NULL);
+	/* Profiled operations are consumed a record at a time
+	 * such that each produced record is accounted for. */
+	if(op->profile != NULL) return;
+	op->consumeBatch = consumeBatch;
+}
+
 inline Record OpBase_CreateRecord(const OpBase *op) {
 	return ExecutionPlan_BorrowRecord((struct ExecutionPlan *)op->plan);
 }
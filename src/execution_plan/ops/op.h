@@ -16,6 +16,9 @@
 
 #define OP_REQUIRE_NEW_DATA(opRes) (opRes & (OP_DEPLETED | OP_REFRESH)) > 0
 
+// Maximum number of records produced by a single batch consume call.
+#define OP_BATCH_CAPACITY 64
+
 typedef enum {
 	OPType_ALL_NODE_SCAN,
 	OPType_NODE_BY_LABEL_SCAN,
@@ -24,6 +27,7 @@ typedef enum {
 	OPType_NODE_BY_ID_SEEK,
 	OPType_NODE_BY_LABEL_AND_ID_SCAN,
 	OPType_EXPAND_INTO,
+	OPType_LEAPFROG_JOIN,
 	OPType_CONDITIONAL_TRAVERSE,
 	OPType_CONDITIONAL_VAR_LEN_TRAVERSE,
 	OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO,
@@ -107,14 +111,27 @@ struct ExecutionPlan;
 typedef void (*fpFree)(struct OpBase *);
 typedef OpResult(*fpInit)(struct OpBase *);
 typedef Record(*fpConsume)(struct OpBase *);
+typedef uint(*fpConsumeBatch)(struct OpBase *, Record *, uint);
 typedef OpResult(*fpReset)(struct OpBase *);
 typedef void (*fpToString)(const struct OpBase *, sds *);
 typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpBase *);
 
 // Execution plan operation statistics.
+// *Total fields include the operation's children
+// and are accumulated during execution.
 typedef struct {
 	int profileRecordCount;     // Number of records generated.
 	double profileExecTime;     // Operation total execution time in ms.
+	uint64_t profileTicks;      // Operation total execution time in TSC ticks.
+	int64_t profileBytesAllocated;        // Bytes allocated by the operation.
+	int64_t profileBytesRetained;         // Bytes allocated and not freed by the operation.
+	int64_t profilePeakMemory;            // Maximum bytes retained by the operation.
+	int64_t profileMatrixPeakMemory;      // Maximum GraphBLAS bytes held by the operation.
+	uint64_t profileRecordAllocs;         // Records allocated by the operation.
+	double profileEstimatedRecords;       // Records the operation was estimated to produce.
+	int64_t profileBytesAllocatedTotal;   // Bytes allocated, including children.
+	int64_t profileBytesRetainedTotal;    // Bytes retained, including children.
+	uint64_t profileRecordAllocsTotal;    // Records allocated, including children.
 }  OpStats;
 
 struct OpBase {
@@ -125,6 +142,7 @@ struct OpBase {
 	fpClone clone;              // Operation clone.
 	fpConsume consume;          // Produce next record.
 	fpConsume profile;          // Profiled version of consume.
+	fpConsumeBatch consumeBatch;// Produce up to N records, NULL if not supported.
 	fpToString toString;        // Operation string representation.
 	const char *name;           // Operation name.
 	int childCount;             // Number of children.
@@ -146,6 +164,12 @@ void OpBase_Free(OpBase *op);       // Free op.
 Record OpBase_Consume(OpBase *op);  // Consume op.
 Record OpBase_Profile(OpBase *op);  // Profile op.
 
+/* Consume up to 'cap' records from op into 'batch'.
+ * Returns the number of records produced, 0 once op is depleted.
+ * Operations which do not implement a native batch consume function
+ * are consumed one record at a time. */
+uint OpBase_ConsumeBatch(OpBase *op, Record *batch, uint cap);
+
 void OpBase_ToString(const OpBase *op, sds *buff);
 
 OpBase *OpBase_Clone(const struct ExecutionPlan *plan, const OpBase *op);
@@ -177,6 +201,9 @@ bool OpBase_IsWriter(OpBase *op);
 // Update operation consume function.
 void OpBase_UpdateConsume(OpBase *op, fpConsume consume);
 
+// Update operation batch consume function, NULL disables batching.
+void OpBase_UpdateConsumeBatch(OpBase *op, fpConsumeBatch consumeBatch);
+
 // Creates a new record that will be populated during execution.
 Record OpBase_CreateRecord(const OpBase *op);
 
@@ -14,6 +14,7 @@
 
 /* Forward declarations. */
 static Record AggregateConsume(OpBase *opBase);
+static uint AggregateConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpResult AggregateReset(OpBase *opBase);
 static OpBase *AggregateClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void AggregateFree(OpBase *opBase);
@@ -80,8 +81,9 @@ static Group *_CreateGroup(OpAggregate *op, Record r) {
 
 static void _ComputeGroupKey(OpAggregate *op, Record r) {
 	for(uint i = 0; i < op->key_count; i++) {
-		AR_ExpNode *exp = op->key_exps[i];
-		op->group_keys[i] = AR_EXP_Evaluate(exp, r);
+		op->group_keys[i] = (op->compiled_keys != NULL)
+			? AR_CompiledExp_Evaluate(op->compiled_keys + i, r)
+			: AR_EXP_Evaluate(op->key_exps[i], r);
 	}
 }
 
@@ -101,9 +103,10 @@ static XXH64_hash_t _HashCode(const SIValue *v, size_t n) {
 
 // retrieves group under which given record belongs to,
 // creates group if one doesn't exists
-static Group *_GetGroup(OpAggregate *op, Record r) {
+static Group *_GetGroup(OpAggregate *op, Record r, bool *created) {
 	XXH64_hash_t hash;
 	bool free_key_exps = true;
+	*created = false;
 
 	// construct group key
 	_ComputeGroupKey(op, r);
@@ -115,6 +118,7 @@ static Group *_GetGroup(OpAggregate *op, Record r) {
 		CacheGroupAdd(op->groups, hash, op->group);
 		// key expressions are owned by the new group and don't need to be freed
 		free_key_exps = false;
+		*created = true;
 		goto cleanup;
 	}
 
@@ -130,13 +134,14 @@ static Group *_GetGroup(OpAggregate *op, Record r) {
 
 	// can't reuse last accessed group, lookup group by identifier key
 	hash = _HashCode(op->group_keys, op->key_count);
-	op->group = CacheGroupGet(op->groups, hash);
+	op->group = CacheGroupGet(op->groups, hash, op->group_keys);
 	if(!op->group) {
 		// Group does not exists, create it.
 		op->group = _CreateGroup(op, r);
 		CacheGroupAdd(op->groups, hash, op->group);
 		// key expressions are owned by the new group and don't need to be freed
 		free_key_exps = false;
+		*created = true;
 	}
 
 cleanup:
@@ -151,7 +156,8 @@ cleanup:
 
 static void _aggregateRecord(OpAggregate *op, Record r) {
 	// get group
-	Group *group = _GetGroup(op, r);
+	bool created;
+	Group *group = _GetGroup(op, r, &created);
 	ASSERT(group != NULL);
 
 	// aggregate group exps
@@ -164,6 +170,163 @@ static void _aggregateRecord(OpAggregate *op, Record r) {
 	OpBase_DeleteRecord(r);
 }
 
+//------------------------------------------------------------------------------
+// batch aggregation
+//------------------------------------------------------------------------------
+
+// numeric aggregation functions which support batch steps, e.g. sum(n.v)
+// are fed arrays of the values they aggregate rather than one value at a time
+// values are gathered per function for as long as consecutive records
+// belong to the same group
+
+// collect aggregation function nodes within 'exp'
+// returns the number of nodes within 'nodes', set if not NULL
+static uint _CollectAggregations(AR_ExpNode *exp, AR_ExpNode **nodes, uint n) {
+	if(!AR_EXP_IsOperation(exp)) return n;
+
+	if(exp->op.f->aggregate) {
+		if(nodes != NULL) nodes[n] = exp;
+		return n + 1;
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		n = _CollectAggregations(exp->op.children[i], nodes, n);
+	}
+
+	return n;
+}
+
+// reset batches to an empty state, unbound to any group
+static void _ResetBatches(OpAggregate *op) {
+	AR_ExpNode *nodes[op->batch_count];
+	uint n = 0;
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		n = _CollectAggregations(op->aggregate_exps[i], nodes, n);
+	}
+
+	for(uint i = 0; i < n; i++) {
+		op->batches[i].agg    = NULL;
+		op->batches[i].count  = 0;
+		op->batches[i].scalar = (nodes[i]->op.f->batch == NULL);
+	}
+	op->batch_group = NULL;
+}
+
+// set up batching if any of the aggregation functions supports it
+static void _InitBatches(OpAggregate *op) {
+	uint n = 0;
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		n = _CollectAggregations(op->aggregate_exps[i], NULL, n);
+	}
+
+	AR_ExpNode *nodes[n];
+	n = 0;
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		n = _CollectAggregations(op->aggregate_exps[i], nodes, n);
+	}
+
+	bool supported = false;
+	for(uint i = 0; i < n; i++) supported |= (nodes[i]->op.f->batch != NULL);
+	if(!supported) return;
+
+	op->batch_count = n;
+	op->batches = rm_malloc(sizeof(AggregateBatch) * n);
+	for(uint i = 0; i < n; i++) op->batches[i].compiled = false;
+	_ResetBatches(op);
+}
+
+// aggregate values gathered for a single aggregation function
+static void _FlushBatch(AggregateBatch *batch) {
+	if(batch->count == 0) return;
+
+	AR_FuncDesc *f = batch->agg->op.f;
+	const void *values = (batch->t == T_INT64) ? (void *)batch->ints
+		: (void *)batch->doubles;
+	f->batch(f->privdata, batch->t, values, batch->count);
+	batch->count = 0;
+}
+
+// aggregate all gathered values
+static void _FlushBatches(OpAggregate *op) {
+	for(uint i = 0; i < op->batch_count; i++) _FlushBatch(op->batches + i);
+}
+
+// associate batches with the aggregation functions of 'group'
+static void _BindBatches(OpAggregate *op, Group *group) {
+	AR_ExpNode *nodes[op->batch_count];
+	uint n = 0;
+	for(uint i = 0; i < group->func_count; i++) {
+		n = _CollectAggregations(group->aggregationFunctions[i], nodes, n);
+	}
+	ASSERT(n == op->batch_count);
+
+	for(uint i = 0; i < n; i++) op->batches[i].agg = nodes[i];
+	op->batch_group = group;
+}
+
+// gather the value aggregated by 'batch' out of 'r'
+static void _GatherValue(AggregateBatch *batch, Record r) {
+	AR_ExpNode *agg = batch->agg;
+
+	if(batch->scalar) {
+		AR_EXP_Aggregate(agg, r);
+		return;
+	}
+
+	SIValue v = (batch->compiled)
+		? AR_CompiledExp_Evaluate(&batch->arg, r)
+		: AR_EXP_Evaluate(agg->op.children[0], r);
+	SIType t = SI_TYPE(v);
+
+	// aggregation functions skip NULLs
+	if(t == T_NULL) return;
+
+	if(!(t & SI_NUMERIC)) {
+		// non-numeric values are aggregated one by one from now on
+		// the regular step reports values of unexpected types
+		SIValue_Free(v);
+		_FlushBatch(batch);
+		batch->scalar = true;
+		AR_EXP_Aggregate(agg, r);
+		return;
+	}
+
+	// a batch holds values of a single type
+	if(batch->count > 0 && batch->t != t) _FlushBatch(batch);
+
+	batch->t = t;
+	if(t == T_INT64) batch->ints[batch->count++] = v.longval;
+	else batch->doubles[batch->count++] = v.doubleval;
+
+	if(batch->count == AGGREGATE_BATCH_SIZE) _FlushBatch(batch);
+}
+
+static void _aggregateRecordBatched(OpAggregate *op, Record r) {
+	// get group
+	bool created;
+	Group *group = _GetGroup(op, r, &created);
+	ASSERT(group != NULL);
+
+	if(group != op->batch_group) {
+		_FlushBatches(op);
+		_BindBatches(op, group);
+	}
+
+	if(created) {
+		// first step initializes the aggregation functions context
+		for(uint i = 0; i < op->aggregate_count; i++) {
+			AR_EXP_Aggregate(group->aggregationFunctions[i], r);
+		}
+	} else {
+		for(uint i = 0; i < op->batch_count; i++) {
+			_GatherValue(op->batches + i, r);
+		}
+	}
+
+	// free record
+	OpBase_DeleteRecord(r);
+}
+
 // returns a record populated with group data
 static Record _handoff(OpAggregate *op) {
 	Group *group;
@@ -198,8 +361,12 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	op->group = NULL;
 	op->group_iter = NULL;
 	op->group_keys = NULL;
+	op->compiled_keys = NULL;
 	op->groups = CacheGroupNew();
 	op->should_cache_records = should_cache_records;
+	op->batches = NULL;
+	op->batch_count = 0;
+	op->batch_group = NULL;
 
 	// Migrate each expression to the keys array or the aggregations array as appropriate.
 	_migrate_expressions(op, exps);
@@ -208,8 +375,11 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	// Allocate memory for group keys if we have any non-aggregate expressions.
 	if(op->key_count) op->group_keys = rm_malloc(op->key_count * sizeof(SIValue));
 
+	_InitBatches(op);
+
 	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL, AggregateConsume,
 				AggregateReset, NULL, AggregateClone, AggregateFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, AggregateConsumeBatch);
 
 	// The projected record will associate values with their resolved name
 	// to ensure that space is allocated for each entry.
@@ -228,25 +398,51 @@ OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should
 	return (OpBase *)op;
 }
 
-static Record AggregateConsume(OpBase *opBase) {
-	OpAggregate *op = (OpAggregate *)opBase;
-	if(op->group_iter) return _handoff(op);
-
+// consume and aggregate all child records
+static void _aggregateChild(OpAggregate *op) {
 	Record r;
 	if(op->op.childCount == 0) {
 		/* RETURN max (1)
 		 * Create a 'fake' record. */
-		r = OpBase_CreateRecord(opBase);
+		r = OpBase_CreateRecord((OpBase *)op);
 		_aggregateRecord(op, r);
 	} else {
+		uint n;
+		Record batch[OP_BATCH_CAPACITY];
 		OpBase *child = op->op.children[0];
-		while((r = OpBase_Consume(child))) _aggregateRecord(op, r);
+		if(op->batches != NULL) {
+			while((n = OpBase_ConsumeBatch(child, batch, OP_BATCH_CAPACITY))) {
+				for(uint i = 0; i < n; i++) _aggregateRecordBatched(op, batch[i]);
+				QueryCtx_CheckCancelled();
+			}
+			_FlushBatches(op);
+		} else {
+			while((n = OpBase_ConsumeBatch(child, batch, OP_BATCH_CAPACITY))) {
+				for(uint i = 0; i < n; i++) _aggregateRecord(op, batch[i]);
+				QueryCtx_CheckCancelled();
+			}
+		}
 	}
 
 	op->group_iter = CacheGroupIter(op->groups);
+}
+
+static Record AggregateConsume(OpBase *opBase) {
+	OpAggregate *op = (OpAggregate *)opBase;
+	if(!op->group_iter) _aggregateChild(op);
 	return _handoff(op);
 }
 
+static uint AggregateConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	OpAggregate *op = (OpAggregate *)opBase;
+	if(!op->group_iter) _aggregateChild(op);
+
+	uint n = 0;
+	Record r;
+	while(n < cap && (r = _handoff(op))) batch[n++] = r;
+	return n;
+}
+
 static OpResult AggregateReset(OpBase *opBase) {
 	OpAggregate *op = (OpAggregate *)opBase;
 
@@ -259,10 +455,46 @@ static OpResult AggregateReset(OpBase *opBase) {
 	}
 
 	op->group = NULL;
+	if(op->batches) _ResetBatches(op);
 
 	return OP_OK;
 }
 
+void AggregateOp_Compile(OpAggregate *op) {
+	ASSERT(op != NULL);
+
+	// compiling is worthwhile only if a key avoids the interpreter
+	if(op->compiled_keys == NULL && op->key_count > 0) {
+		bool specialised = false;
+		AR_CompiledExp *keys = rm_malloc(sizeof(AR_CompiledExp) * op->key_count);
+		for(uint i = 0; i < op->key_count; i++) {
+			keys[i] = AR_EXP_Compile(op->key_exps[i]);
+			specialised |= !AR_CompiledExp_Interpreted(keys + i);
+		}
+
+		if(specialised) op->compiled_keys = keys;
+		else rm_free(keys);
+	}
+
+	if(op->batches == NULL) return;
+
+	// compile the argument of each batched aggregation function
+	// out of the aggregate expression templates
+	AR_ExpNode *nodes[op->batch_count];
+	uint n = 0;
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		n = _CollectAggregations(op->aggregate_exps[i], nodes, n);
+	}
+
+	for(uint i = 0; i < n; i++) {
+		AggregateBatch *batch = op->batches + i;
+		if(batch->scalar || nodes[i]->op.child_count == 0) continue;
+
+		batch->arg = AR_EXP_Compile(nodes[i]->op.children[0]);
+		batch->compiled = !AR_CompiledExp_Interpreted(&batch->arg);
+	}
+}
+
 static OpBase *AggregateClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_AGGREGATE);
 	OpAggregate *op = (OpAggregate *)opBase;
@@ -290,6 +522,11 @@ static void AggregateFree(OpBase *opBase) {
 		op->group_iter = NULL;
 	}
 
+	if(op->compiled_keys) {
+		rm_free(op->compiled_keys);
+		op->compiled_keys = NULL;
+	}
+
 	if(op->key_exps) {
 		for(uint i = 0; i < op->key_count; i ++) AR_EXP_Free(op->key_exps[i]);
 		array_free(op->key_exps);
@@ -312,6 +549,11 @@ static void AggregateFree(OpBase *opBase) {
 		op->record_offsets = NULL;
 	}
 
+	if(op->batches) {
+		rm_free(op->batches);
+		op->batches = NULL;
+	}
+
 	op->group = NULL;
 }
 
@@ -10,20 +10,46 @@
 #include "../execution_plan.h"
 #include "../../grouping/group_cache.h"
 #include "../../arithmetic/arithmetic_expression.h"
+#include "../../arithmetic/arithmetic_expression_compile.h"
+
+// number of numeric values gathered per aggregation function
+// before they're aggregated at once
+#define AGGREGATE_BATCH_SIZE 1024
+
+// numeric values gathered for an aggregation function of the current group
+typedef struct {
+	AR_ExpNode *agg;     // aggregation function node of the current group
+	bool scalar;         // aggregate values one by one
+	bool compiled;       // aggregated argument is compiled
+	AR_CompiledExp arg;  // compiled aggregated argument, if compiled
+	SIType t;            // type of gathered values, T_INT64 or T_DOUBLE
+	uint count;          // number of gathered values
+	union {
+		int64_t ints[AGGREGATE_BATCH_SIZE];
+		double doubles[AGGREGATE_BATCH_SIZE];
+	};
+} AggregateBatch;
 
 typedef struct {
 	OpBase op;
 	uint *record_offsets;               /* Record IDs for key and aggregate exps. */
 	AR_ExpNode **key_exps;              /* Array of expressions used to calculate the group key. */
+	AR_CompiledExp *compiled_keys;      /* Compiled key expressions, NULL if not compiled. */
 	AR_ExpNode **aggregate_exps;        /* Array of expressions that aggregate data for each key. */
-	rax *groups;                        /* Map of all groups built by this operation. */
+	CacheGroup *groups;                 /* Map of all groups built by this operation. */
 	Group *group;                       /* Last accessed group. */
 	SIValue *group_keys;                /* Array of values that represent a key associated with a Group of aggregations. */
 	CacheGroupIterator *group_iter;     /* Iterator for walking all groups. */
 	uint key_count;                     /* Number of key expressions. */
 	uint aggregate_count;               /* Number of aggregating expressions. */
 	bool should_cache_records;          /* Records should be cached if we're sorting after aggregation. */
+	AggregateBatch *batches;            /* Values gathered per aggregation function, NULL if not batching. */
+	uint batch_count;                   /* Number of aggregation functions. */
+	Group *batch_group;                 /* Group gathered values belong to. */
 } OpAggregate;
 
 OpBase *NewAggregateOp(const ExecutionPlan *plan, AR_ExpNode **exps, bool should_cache_records);
 
+// compile group key expressions and the arguments of batched aggregation
+// functions, evaluating attribute accesses without the interpreter
+void AggregateOp_Compile(OpAggregate *op);
@@ -11,6 +11,7 @@
 /* Forward declarations. */
 static OpResult AllNodeScanInit(OpBase *opBase);
 static Record AllNodeScanConsume(OpBase *opBase);
+static uint AllNodeScanConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static Record AllNodeScanConsumeFromChild(OpBase *opBase);
 static OpResult AllNodeScanReset(OpBase *opBase);
 static OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *opBase);
@@ -36,11 +37,33 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 
 static OpResult AllNodeScanInit(OpBase *opBase) {
 	AllNodeScan *op = (AllNodeScan *)opBase;
-	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
-	else op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
+	} else {
+		op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+		OpBase_UpdateConsumeBatch(opBase, AllNodeScanConsumeBatch);
+	}
 	return OP_OK;
 }
 
+uint64_t AllNodeScanOp_Skip(AllNodeScan *op, uint64_t n) {
+	ASSERT(op != NULL);
+	ASSERT(op->op.childCount == 0);
+
+	if(op->iter == NULL) return 0;
+
+	// Without deleted nodes every position holds a node, seek directly.
+	if(Graph_DeletedNodeCount(QueryCtx_GetGraph()) == 0) {
+		return DataBlockIterator_Advance(op->iter, n);
+	}
+
+	uint64_t skipped = 0;
+	while(skipped < n && DataBlockIterator_Next(op->iter, NULL) != NULL) {
+		skipped++;
+	}
+	return skipped;
+}
+
 static Record AllNodeScanConsumeFromChild(OpBase *opBase) {
 	AllNodeScan *op = (AllNodeScan *)opBase;
 
@@ -89,6 +112,23 @@ static Record AllNodeScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint AllNodeScanConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	AllNodeScan *op = (AllNodeScan *)opBase;
+
+	uint n = 0;
+	Node node = GE_NEW_NODE();
+	while(n < cap) {
+		node.entity = (Entity *)DataBlockIterator_Next(op->iter, &node.id);
+		if(node.entity == NULL) break;
+
+		Record r = OpBase_CreateRecord(opBase);
+		Record_AddNode(r, op->nodeRecIdx, node);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 static OpResult AllNodeScanReset(OpBase *op) {
 	AllNodeScan *allNodeScan = (AllNodeScan *)op;
 	if(allNodeScan->iter) DataBlockIterator_Reset(allNodeScan->iter);
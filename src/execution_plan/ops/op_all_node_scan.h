@@ -25,3 +25,7 @@ typedef struct {
 
 OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias);
 
+/* Skip over the next 'n' nodes without producing records for them.
+ * Returns the number of nodes skipped, fewer than 'n' once depleted. */
+uint64_t AllNodeScanOp_Skip(AllNodeScan *op, uint64_t n);
+
@@ -5,6 +5,7 @@
  */
 
 #include "op_apply.h"
+#include "op_conditional_traverse.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
 /* Forward declarations. */
@@ -20,6 +21,9 @@ OpBase *NewApplyOp(const ExecutionPlan *plan) {
 	op->op_arg = NULL;
 	op->bound_branch = NULL;
 	op->rhs_branch = NULL;
+	op->traverse = NULL;
+	op->batch_cap = 0;
+	op->batch_size = 0;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_APPLY, "Apply", ApplyInit, ApplyConsume, ApplyReset, NULL,
@@ -28,6 +32,20 @@ OpBase *NewApplyOp(const ExecutionPlan *plan) {
 	return (OpBase *)op;
 }
 
+// returns the traversal resolving 'branch' if it is of the form
+// Optional -> Conditional Traverse -> Argument, NULL otherwise
+static OpBase *_BatchableTraversal(OpBase *branch) {
+	if(branch->type != OPType_OPTIONAL || branch->childCount != 1) return NULL;
+
+	OpBase *traverse = branch->children[0];
+	if(traverse->type != OPType_CONDITIONAL_TRAVERSE) return NULL;
+	if(traverse->childCount != 1) return NULL;
+	if(traverse->children[0]->type != OPType_ARGUMENT) return NULL;
+	if(((OpCondTraverse *)traverse)->count_dests) return NULL;
+
+	return traverse;
+}
+
 static OpResult ApplyInit(OpBase *opBase) {
 	ASSERT(opBase->childCount == 2);
 
@@ -41,12 +59,50 @@ static OpResult ApplyInit(OpBase *opBase) {
 	op->op_arg = (Argument *)ExecutionPlan_LocateOp(op->rhs_branch, OPType_ARGUMENT);
 	ASSERT(op->op_arg);
 
+	// feed an optional traversal batches of bound records
+	// rather than resolving it once per bound record
+	op->traverse = _BatchableTraversal(op->rhs_branch);
+	if(op->traverse) {
+		CondTraverseOp_Optional((OpCondTraverse *)op->traverse);
+		op->batch_cap = TraverseBatch_Cap(UNLIMITED);
+		op->batch_size = TraverseBatch_Initial(op->batch_cap);
+	}
+
 	return OP_OK;
 }
 
+// each output record of the batched traversal extends one of the bound
+// records it was fed, once the traversal is depleted it is fed a new batch
+static Record _ApplyConsumeBatch(Apply *op) {
+	while(true) {
+		Record r = OpBase_Consume(op->traverse);
+		if(r != NULL) return r;
+
+		// Reset the RHS branch and hand it the next batch of bound records.
+		OpBase_PropagateReset(op->rhs_branch);
+
+		uint n = 0;
+		for(; n < op->batch_size; n++) {
+			Record bound = OpBase_Consume(op->bound_branch);
+			if(bound == NULL) break;
+			Argument_AddRecord(op->op_arg, bound);
+		}
+
+		// Bound branch and this op are depleted.
+		if(n == 0) return NULL;
+
+		// Bound branch filled the batch, expect more data.
+		if(n == op->batch_size) {
+			op->batch_size = TraverseBatch_Grow(op->batch_size, op->batch_cap);
+		}
+	}
+}
+
 static Record ApplyConsume(OpBase *opBase) {
 	Apply *op = (Apply *)opBase;
 
+	if(op->traverse) return _ApplyConsumeBatch(op);
+
 	while(true) {
 		if(op->r == NULL) {
 			// Retrieve a Record from the bound branch if we're not currently holding one.
@@ -88,6 +144,7 @@ static OpResult ApplyReset(OpBase *opBase) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
 	}
+	if(op->traverse) op->batch_size = TraverseBatch_Initial(op->batch_cap);
 	return OP_OK;
 }
 
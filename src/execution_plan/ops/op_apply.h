@@ -17,13 +17,21 @@
  * it pulls data from the right-hand branch and passes
  * the merged record upwards until the right-hand branch
  * is depleted, at which time data is pulled from the
- * left-hand branch and the process repeats.  */
+ * left-hand branch and the process repeats.
+ *
+ * If the right-hand branch is an OPTIONAL MATCH resolved by a single
+ * traversal, the Argument op is handed a batch of bound records instead,
+ * which the traversal resolves at once, emitting records without
+ * destinations unmodified, each output record extends its bound record. */
 typedef struct {
 	OpBase op;
 	Record r;                       // Bound branch record.
 	OpBase *bound_branch;           // Bound branch.
 	OpBase *rhs_branch;             // Right-hand branch.
 	Argument *op_arg;               // Right-hand branch tap.
+	OpBase *traverse;               // Batched right-hand traversal, if any.
+	uint batch_cap;                 // Max number of bound records per batch.
+	uint batch_size;                // Number of bound records in the next batch.
 } Apply;
 
 OpBase *NewApplyOp(const ExecutionPlan *plan);
@@ -6,6 +6,7 @@
 
 #include "op_argument.h"
 #include "RG.h"
+#include "../../util/arr.h"
 
 // Forward declarations
 static Record ArgumentConsume(OpBase *opBase);
@@ -15,7 +16,8 @@ static void ArgumentFree(OpBase *opBase);
 
 OpBase *NewArgumentOp(const ExecutionPlan *plan, const char **variables) {
 	Argument *op = rm_malloc(sizeof(Argument));
-	op->r = NULL;
+	op->records = array_new(Record, 1);
+	op->pos = 0;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_ARGUMENT, "Argument", NULL,
@@ -29,31 +31,38 @@ OpBase *NewArgumentOp(const ExecutionPlan *plan, const char **variables) {
 	return (OpBase *)op;
 }
 
-static Record ArgumentConsume(OpBase *opBase) {
-	Argument *arg = (Argument *)opBase;
-
-	// Emit the record only once.
-	// arg->r can already be NULL if the op is depleted.
-	Record r = arg->r;
-	arg->r = NULL;
-	return r;
+// frees the Records which were not emitted
+static void _ArgumentClear(Argument *arg) {
+	uint count = array_len(arg->records);
+	for(uint i = arg->pos; i < count; i++) {
+		OpBase_DeleteRecord(arg->records[i]);
+	}
+	array_clear(arg->records);
+	arg->pos = 0;
 }
 
-static OpResult ArgumentReset(OpBase *opBase) {
-	// Reset operation, freeing the Record if one is held.
+static Record ArgumentConsume(OpBase *opBase) {
 	Argument *arg = (Argument *)opBase;
 
-	if(arg->r) {
-		OpBase_DeleteRecord(arg->r);
-		arg->r = NULL;
+	// Emit each record only once.
+	// The op is depleted once all held records were emitted.
+	if(arg->pos == array_len(arg->records)) {
+		array_clear(arg->records);
+		arg->pos = 0;
+		return NULL;
 	}
 
+	return arg->records[arg->pos++];
+}
+
+static OpResult ArgumentReset(OpBase *opBase) {
+	// Reset operation, freeing any held Records.
+	_ArgumentClear((Argument *)opBase);
 	return OP_OK;
 }
 
 void Argument_AddRecord(Argument *arg, Record r) {
-	ASSERT(!arg->r && "tried to insert into a populated Argument op");
-	arg->r = r;
+	array_append(arg->records, r);
 }
 
 static inline OpBase *ArgumentClone(const ExecutionPlan *plan, const OpBase *opBase) {
@@ -63,9 +72,9 @@ static inline OpBase *ArgumentClone(const ExecutionPlan *plan, const OpBase *opB
 
 static void ArgumentFree(OpBase *opBase) {
 	Argument *arg = (Argument *)opBase;
-	if(arg->r) {
-		OpBase_DeleteRecord(arg->r);
-		arg->r = NULL;
+	if(arg->records) {
+		_ArgumentClear(arg);
+		array_free(arg->records);
+		arg->records = NULL;
 	}
 }
-
@@ -9,13 +9,16 @@
 #include "op.h"
 #include "../execution_plan.h"
 
-/* The Argument operation holds an internal Record that it will emit exactly once. */
+/* The Argument operation holds a batch of Records, each emitted exactly once
+ * in the order it was added. */
 typedef struct {
 	OpBase op;
-	Record r;
+	Record *records;  // Records to emit.
+	uint pos;         // Position of the next Record to emit.
 } Argument;
 
 OpBase *NewArgumentOp(const ExecutionPlan *plan, const char **variables);
 
+// Appends 'r' to the Records emitted by the Argument op.
 void Argument_AddRecord(Argument *arg, Record r);
 
@@ -6,6 +6,8 @@
 
 #include "op_cartesian_product.h"
 #include "RG.h"
+#include "../../query_ctx.h"
+#include "../../util/arr.h"
 
 /* Forward declarations. */
 static OpResult CartesianProductInit(OpBase *opBase);
@@ -18,6 +20,9 @@ OpBase *NewCartesianProductOp(const ExecutionPlan *plan) {
 	CartesianProduct *op = rm_malloc(sizeof(CartesianProduct));
 	op->init = true;
 	op->r = NULL;
+	op->streams = NULL;
+	op->filter = NULL;
+	op->program = NULL;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CARTESIAN_PRODUCT, "Cartesian Product", CartesianProductInit,
@@ -26,102 +31,211 @@ OpBase *NewCartesianProductOp(const ExecutionPlan *plan) {
 	return (OpBase *)op;
 }
 
-static void _ResetStreams(CartesianProduct *cp, int streamIdx) {
-	// Reset each child stream, Reset propagates upwards.
-	for(int i = 0; i < streamIdx; i++) OpBase_PropagateReset(cp->op.children[i]);
+void CartesianProductOp_SetFilter(CartesianProduct *op, FT_FilterNode *filter) {
+	ASSERT(op != NULL);
+	ASSERT(filter != NULL);
+	ASSERT(op->filter == NULL);
+
+	op->filter = filter;
+	op->op.name = "Filtered Cartesian Product";
+}
+
+// sets the entries of 'src' in 'dest', 'dest' doesn't own them
+static void _ShareEntries(Record dest, const Record src) {
+	uint len = Record_length(src);
+	for(uint i = 0; i < len; i++) {
+		if(src->entries[i].type == REC_TYPE_UNKNOWN) continue;
+		dest->entries[i] = src->entries[i];
+		if(src->entries[i].type == REC_TYPE_SCALAR) {
+			SIValue_MakeVolatile(&dest->entries[i].value.s);
+		}
+	}
+}
+
+static void _FreeStreamRecords(CartesianProductStream *s) {
+	if(s->records == NULL) return;
+	uint count = array_len(s->records);
+	for(uint i = 0; i < count; i++) OpBase_DeleteRecord(s->records[i]);
+	array_free(s->records);
+	s->records = NULL;
+}
+
+// (re)initialize streams, every stream but the last is materialized
+static void _InitStreams(CartesianProduct *op) {
+	uint n = op->op.childCount;
+	for(uint i = 0; i < n; i++) {
+		CartesianProductStream *s = op->streams + i;
+		_FreeStreamRecords(s);
+		s->records = (i < n - 1) ? array_new(Record, 16) : NULL;
+		s->pos = 0;
+		s->materialized = false;
+		s->abandoned = false;
+	}
+}
+
+// sets the entries of stream i's next record in op->r
+// returns false if the stream is depleted
+static bool _StreamNext(CartesianProduct *op, int i) {
+	CartesianProductStream *s = op->streams + i;
+
+	// replay materialized records
+	if(s->materialized) {
+		if(s->pos == array_len(s->records)) return false;
+		_ShareEntries(op->r, s->records[s->pos++]);
+		return true;
+	}
+
+	Record r = OpBase_Consume(op->op.children[i]);
+	if(r == NULL) {
+		// all of the stream's records are held, replay them from now on
+		if(s->records != NULL && !s->abandoned) {
+			s->materialized = true;
+			s->pos = array_len(s->records);
+		}
+		return false;
+	}
+
+	if(s->records != NULL && !s->abandoned) {
+		if(array_len(s->records) < CARTESIAN_PRODUCT_MATERIALIZE_CAP) {
+			// hold on to the record, op->r only shares its entries
+			Record_PersistScalars(r);
+			array_append(s->records, r);
+			_ShareEntries(op->r, r);
+			return true;
+		}
+		// stream is too large, held records are released once it's depleted
+		s->abandoned = true;
+	}
+
+	Record_TransferEntries(&op->r, r);
+	OpBase_DeleteRecord(r);
+	return true;
 }
 
-static int _PullFromStreams(CartesianProduct *op) {
+// rewinds stream i, such that its records are produced again
+static void _StreamRewind(CartesianProduct *op, int i) {
+	CartesianProductStream *s = op->streams + i;
+
+	if(s->materialized) {
+		s->pos = 0;
+		return;
+	}
+
+	// stream is re-executed, Reset propagates upwards
+	_FreeStreamRecords(s);
+	OpBase_PropagateReset(op->op.children[i]);
+}
+
+static bool _PullFromStreams(CartesianProduct *op) {
 	for(int i = 1; i < op->op.childCount; i++) {
-		OpBase *child = op->op.children[i];
-		Record childRecord = OpBase_Consume(child);
-
-		if(childRecord) {
-			Record_TransferEntries(&op->r, childRecord);
-			OpBase_DeleteRecord(childRecord);
-			/* Managed to get new data
-			 * Reset streams [0-i] */
-			_ResetStreams(op, i);
-
-			// Pull from resetted streams.
-			for(int j = 0; j < i; j++) {
-				child = op->op.children[j];
-				childRecord = OpBase_Consume(child);
-				if(childRecord) {
-					Record_TransferEntries(&op->r, childRecord);
-					OpBase_DeleteRecord(childRecord);
-				} else {
-					return 0;
-				}
-			}
-			// Ready to continue.
-			return 1;
+		if(!_StreamNext(op, i)) continue;
+
+		/* Managed to get new data
+		 * rewind streams [0-i] and pull from them. */
+		for(int j = 0; j < i; j++) {
+			_StreamRewind(op, j);
+			if(!_StreamNext(op, j)) return false;
 		}
+
+		// Ready to continue.
+		return true;
 	}
 
 	/* If we're here, then we didn't manged to get new data.
 	 * Last stream depleted. */
-	return 0;
+	return false;
+}
+
+// sets op->r to the next combination of child records
+// returns false once all combinations were produced
+static bool _NextCombination(CartesianProduct *op) {
+	if(op->init) {
+		op->init = false;
+		for(int i = 0; i < op->op.childCount; i++) {
+			if(!_StreamNext(op, i)) return false;
+		}
+		return true;
+	}
+
+	// Pull from first stream,
+	// if it's depleted try pulling other streams for data.
+	return _StreamNext(op, 0) || _PullFromStreams(op);
 }
 
 static OpResult CartesianProductInit(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
 	op->r = OpBase_CreateRecord((OpBase *)op);
+
+	op->streams = rm_calloc(opBase->childCount, sizeof(CartesianProductStream));
+	_InitStreams(op);
+
+	if(op->filter != NULL && op->program == NULL) {
+		op->program = FilterTree_Compile(op->filter);
+	}
+
 	return OP_OK;
 }
 
 static Record CartesianProductConsume(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
-	OpBase *child;
-	Record childRecord;
+	uint64_t rejected = 0;
 
-	if(op->init) {
-		op->init = false;
-
-		for(int i = 0; i < op->op.childCount; i++) {
-			child = op->op.children[i];
-			childRecord = OpBase_Consume(child);
-			if(!childRecord) return NULL;
-			Record_TransferEntries(&op->r, childRecord);
-			OpBase_DeleteRecord(childRecord);
+	while(_NextCombination(op)) {
+		// Pass down a clone of record.
+		if(op->program == NULL ||
+		   FT_Program_Apply(op->program, op->r) == FILTER_PASS) {
+			return OpBase_CloneRecord(op->r);
 		}
-		return OpBase_CloneRecord(op->r);
-	}
 
-	// Pull from first stream.
-	child = op->op.children[0];
-	childRecord = OpBase_Consume(child);
-
-	if(childRecord) {
-		// Managed to get data from first stream.
-		Record_TransferEntries(&op->r, childRecord);
-		OpBase_DeleteRecord(childRecord);
-	} else {
-		// Failed to get data from first stream,
-		// try pulling other streams for data.
-		if(!_PullFromStreams(op)) return NULL;
+		// a selective filter may reject combinations for long
+		if((++rejected & QUERY_CANCEL_CHECK_MASK) == 0) QueryCtx_CheckCancelled();
 	}
 
-	// Pass down a clone of record.
-	return OpBase_CloneRecord(op->r);
+	return NULL;
 }
 
 static OpResult CartesianProductReset(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
 	op->init = true;
+	// child streams are reset as well, materialize them again
+	if(op->streams != NULL) _InitStreams(op);
 	return OP_OK;
 }
 
 static OpBase *CartesianProductClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_CARTESIAN_PRODUCT);
-	return NewCartesianProductOp(plan);
+	const CartesianProduct *op = (const CartesianProduct *)opBase;
+	OpBase *clone = NewCartesianProductOp(plan);
+	if(op->filter != NULL) {
+		CartesianProductOp_SetFilter((CartesianProduct *)clone,
+				FilterTree_Clone(op->filter));
+	}
+	return clone;
 }
 
 static void CartesianProductFree(OpBase *opBase) {
 	CartesianProduct *op = (CartesianProduct *)opBase;
+
+	if(op->streams) {
+		for(int i = 0; i < opBase->childCount; i++) {
+			_FreeStreamRecords(op->streams + i);
+		}
+		rm_free(op->streams);
+		op->streams = NULL;
+	}
+
 	if(op->r) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
 	}
-}
 
+	if(op->program) {
+		FT_Program_Free(op->program);
+		op->program = NULL;
+	}
+
+	if(op->filter) {
+		FilterTree_Free(op->filter);
+		op->filter = NULL;
+	}
+}
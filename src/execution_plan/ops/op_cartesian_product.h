@@ -8,12 +8,37 @@
 
 #include "op.h"
 #include "../execution_plan.h"
+#include "../../filter_tree/filter_tree.h"
+#include "../../filter_tree/ft_program.h"
+
+// maximum number of records materialized per inner stream
+// streams producing more records are re-executed instead
+#define CARTESIAN_PRODUCT_MATERIALIZE_CAP 65536
+
+/* A Cartesian product child stream.
+ * Every stream but the last is consumed over and over again, once per record
+ * of the streams following it, such streams are executed once and their
+ * records are replayed, unless they exceed CARTESIAN_PRODUCT_MATERIALIZE_CAP. */
+typedef struct {
+	Record *records;    // Materialized records, NULL if not materialized.
+	uint pos;           // Next materialized record to replay.
+	bool materialized;  // All of the stream's records are held.
+	bool abandoned;     // Stream exceeded the cap, re-executed once depleted.
+} CartesianProductStream;
 
 /* Cartesian product AKA Join. */
 typedef struct {
 	OpBase op;
 	Record r;
 	bool init;
+	CartesianProductStream *streams;  // Child streams.
+	FT_FilterNode *filter;            // Filter applied to combinations, optional.
+	FT_Program *program;              // Compiled filter.
 } CartesianProduct;
 
 OpBase *NewCartesianProductOp(const ExecutionPlan *plan);
+
+/* Have the operation only emit combinations passing 'filter',
+ * combinations are filtered prior to being copied into a new record.
+ * The operation takes ownership of the filter tree. */
+void CartesianProductOp_SetFilter(CartesianProduct *op, FT_FilterNode *filter);
@@ -13,12 +13,16 @@
 #include "../../algorithms/all_paths.h"
 #include "../../algorithms/all_neighbors.h"
 #include "../../query_ctx.h"
+#include "op_filter.h"
+#include "op_project.h"
+#include "op_aggregate.h"
 
 /* Forward declarations. */
 static OpResult CondVarLenTraverseInit(OpBase *opBase);
 static OpResult CondVarLenTraverseReset(OpBase *opBase);
 static Record CondVarLenTraverseConsume(OpBase *opBase);
 static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase);
+static Record CondVarLenTraverseReachableConsume(OpBase *opBase);
 static OpBase *CondVarLenTraverseClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void CondVarLenTraverseFree(OpBase *opBase);
 
@@ -53,6 +57,55 @@ static void _setupTraversedRelations(CondVarLenTraverse *op) {
 	}
 }
 
+// collect the matrices traversed when testing whether the destination
+// of an expand-into traversal is reachable from its source
+static void _setupReachability(CondVarLenTraverse *op) {
+	op->reach_src  = array_new(RG_Matrix, op->edgeRelationCount);
+	op->reach_dest = array_new(RG_Matrix, op->edgeRelationCount);
+
+	for(int i = 0; i < op->edgeRelationCount; i++) {
+		int rel_id = op->edgeRelationTypes[i];
+		RG_Matrix M  = Graph_GetRelationMatrix(op->g, rel_id, false);
+		RG_Matrix MT = Graph_GetRelationMatrix(op->g, rel_id, true);
+
+		switch(op->traverseDir) {
+			case GRAPH_EDGE_DIR_OUTGOING:
+				array_append(op->reach_src, M);
+				array_append(op->reach_dest, MT);
+				break;
+			case GRAPH_EDGE_DIR_INCOMING:
+				array_append(op->reach_src, MT);
+				array_append(op->reach_dest, M);
+				break;
+			case GRAPH_EDGE_DIR_BOTH:
+				// undirected, both sides follow edges in either direction
+				array_append(op->reach_src, M);
+				array_append(op->reach_src, MT);
+				array_append(op->reach_dest, M);
+				array_append(op->reach_dest, MT);
+				break;
+			default:
+				ASSERT(false && "unknown traversal direction");
+				break;
+		}
+	}
+}
+
+// returns false if 'dest' can't be reached from 'src' within maxHops
+// in which case there's no point enumerating paths between the two
+// reachability is a necessary condition for a path to exist, as such
+// it holds regardless of any filters applied to the traversed edges
+static bool _destReachable(CondVarLenTraverse *op, const Node *src,
+		const Node *dest) {
+	NodeID *path = BidirectionalBFS(op->reach_src, op->reach_dest,
+			array_len(op->reach_src), ENTITY_GET_ID(src), ENTITY_GET_ID(dest),
+			op->maxHops);
+	if(path == NULL) return false;
+
+	array_free(path);
+	return true;
+}
+
 // Set the traversal direction to match the traversed edge and AlgebraicExpression form.
 static inline void _setTraverseDirection(CondVarLenTraverse *op, const QGEdge *e) {
 	if(e->bidirectional) {
@@ -100,9 +153,13 @@ OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicEx
 	op->M                  =  NULL;
 	op->ae                 =  ae;
 	op->ft                 =  NULL;
+	op->edge_filter        =  NULL;
 	op->expandInto         =  false;
 	op->allPathsCtx        =  NULL;
 	op->collect_paths      =  true;
+	op->reachable_only     =  false;
+	op->reach_src          =  NULL;
+	op->reach_dest         =  NULL;
 	op->allNeighborsCtx    =  NULL;
 	op->edgeRelationTypes  =  NULL;
 
@@ -125,6 +182,110 @@ OpBase *NewCondVarLenTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicEx
 	return (OpBase *)op;
 }
 
+// returns true if 'ft' depends on nothing but the edge 'alias'
+// in which case its outcome is fixed per edge throughout the query
+static bool _edgeOnlyFilter(const FT_FilterNode *ft, const char *alias) {
+	rax *modified = FilterTree_CollectModified(ft);
+	bool edge_only = raxSize(modified) == 1 &&
+		raxFind(modified, (unsigned char *)alias, strlen(alias)) != raxNotFound;
+	raxFree(modified);
+
+	return edge_only &&
+		!FilterTree_ContainsFunc(ft, "rand", NULL) &&
+		!FilterTree_ContainsFunc(ft, "randomUUID", NULL);
+}
+
+// returns true if any of 'exps' references 'alias'
+static bool _expsReference(AR_ExpNode **exps, const char *alias) {
+	rax *entities = raxNew();
+	uint exp_count = array_len(exps);
+	for(uint i = 0; i < exp_count; i++) {
+		AR_EXP_CollectEntities(exps[i], entities);
+	}
+
+	bool referenced =
+		raxFind(entities, (unsigned char *)alias, strlen(alias)) != raxNotFound;
+	raxFree(entities);
+
+	return referenced;
+}
+
+// returns true if any of 'exps' is random, differing between duplicates
+static bool _expsRandom(AR_ExpNode **exps) {
+	uint exp_count = array_len(exps);
+	for(uint i = 0; i < exp_count; i++) {
+		if(AR_EXP_ContainsFunc(exps[i], "rand") ||
+		   AR_EXP_ContainsFunc(exps[i], "randomUUID")) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// returns true if 'aggregate' ignores duplicate records
+// that is the case when each of its aggregation functions is DISTINCT
+// e.g. RETURN a, count(DISTINCT b)
+static bool _aggregateDiscardsDuplicates(const OpAggregate *aggregate,
+		const char *edge) {
+	if(_expsRandom(aggregate->key_exps)) return false;
+	if(_expsRandom(aggregate->aggregate_exps)) return false;
+	if(edge && (_expsReference(aggregate->key_exps, edge) ||
+				_expsReference(aggregate->aggregate_exps, edge))) {
+		return false;
+	}
+
+	for(uint i = 0; i < aggregate->aggregate_count; i++) {
+		if(!AR_EXP_PerformsDistinct(aggregate->aggregate_exps[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// returns true if duplicate records produced by 'op' are discarded
+// further up the plan without affecting the query's result
+// that is the case when records flow unaltered through row-wise read-only
+// operations into a DISTINCT, or an aggregation of DISTINCT values only
+// if 'edge' is specified, operations accessing it are rejected as well
+static bool _duplicatesDiscarded(const OpBase *op, const char *edge) {
+	for(const OpBase *parent = op->parent; parent; parent = parent->parent) {
+		switch(parent->type) {
+			case OPType_DISTINCT:
+				return true;
+			case OPType_AGGREGATE:
+				return _aggregateDiscardsDuplicates(
+						(const OpAggregate *)parent, edge);
+			case OPType_PROJECT: {
+				// random projections differ between duplicates
+				const OpProject *project = (const OpProject *)parent;
+				if(_expsRandom(project->exps)) return false;
+				if(edge && _expsReference(project->exps, edge)) return false;
+				break;
+			}
+			case OPType_FILTER:
+				if(edge) {
+					const OpFilter *filter = (const OpFilter *)parent;
+					rax *modified = FilterTree_CollectModified(filter->filterTree);
+					bool referenced = raxFind(modified, (unsigned char *)edge,
+							strlen(edge)) != raxNotFound;
+					raxFree(modified);
+					if(referenced) return false;
+				}
+				break;
+			case OPType_EXPAND_INTO:
+			case OPType_LEAPFROG_JOIN:
+			case OPType_CONDITIONAL_TRAVERSE:
+			case OPType_CONDITIONAL_VAR_LEN_TRAVERSE:
+			case OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO:
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return false;
+}
+
 static OpResult CondVarLenTraverseInit(OpBase *opBase) {
 	CondVarLenTraverse *op = (CondVarLenTraverse *)opBase;
 
@@ -158,13 +319,46 @@ static OpResult CondVarLenTraverseInit(OpBase *opBase) {
 		}
 	}
 
-	if(op->ft          == NULL                && // no filter on path
-	   op->edgesIdx    == -1                  && // edge isn't required
-	   op->expandInto  == false               && // destination unknown
-	   reltype_count   == 1                   && // single relationship
-	   multi_edge      == false               && // no multi edge entries
-	   op->traverseDir != GRAPH_EDGE_DIR_BOTH    // directed
-	) {
+	// filters are applied to traversed edges through an EdgeFilter
+	// edge-only filters are evaluated once per edge
+	if(op->ft != NULL && op->edge_filter == NULL) {
+		op->edge_filter = EdgeFilter_New(op->ft, op->edgesIdx,
+				_edgeOnlyFilter(op->ft, e->alias));
+	}
+
+	bool reachability = (op->ft          == NULL  && // no filter on path
+	                     op->edgesIdx    == -1    && // edge isn't required
+	                     op->expandInto  == false && // destination unknown
+	                     reltype_count   == 1     && // single relationship
+	                     op->traverseDir != GRAPH_EDGE_DIR_BOTH); // directed
+
+	// edges passing an edge-only filter are known upfront
+	// the edge is otherwise unused if nothing above accesses it
+	bool filtered_reachability = (op->edge_filter != NULL          &&
+	                              op->edge_filter->memoize         &&
+	                              op->expandInto  == false         &&
+	                              reltype_count   == 1             &&
+	                              op->traverseDir != GRAPH_EDGE_DIR_BOTH);
+
+	// when duplicate destinations are discarded upstream, e.g.
+	// MATCH (a)-[*1..4]->(b) RETURN DISTINCT b
+	// MATCH (a)-[*]->(b) RETURN count(DISTINCT b)
+	// each reachable destination needs to be produced only once
+	// which is computed level by level using matrix multiplications
+	// in time proportional to the number of levels times number of edges
+	// rather than the number of paths
+	// a node's shortest distance from the source determines its level
+	// as such nodes reachable only through longer paths, required when
+	// the minimum number of hops exceeds 1, are missed
+	if(op->minHops <= 1 &&
+	   ((reachability && _duplicatesDiscarded(opBase, NULL)) ||
+	    (filtered_reachability && _duplicatesDiscarded(opBase, e->alias)))) {
+		AlgebraicExpression_Optimize(&op->ae);
+		ASSERT(op->ae->type == AL_OPERAND);
+		op->collect_paths = false;
+		op->reachable_only = true;
+		OpBase_UpdateConsume(opBase, CondVarLenTraverseReachableConsume);
+	} else if(reachability && multi_edge == false) { // no multi edge entries
 		AlgebraicExpression_Optimize(&op->ae);
 		ASSERT(op->ae->type == AL_OPERAND);
 		op->collect_paths = false;
@@ -239,6 +433,95 @@ static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 	return r;
 }
 
+// export the transpose of the traversed matrix, enabling the reachability
+// search to pull levels from unvisited nodes rather than push from the
+// frontier, returns NULL if the transpose isn't maintained
+static GrB_Matrix _reachableTranspose(CondVarLenTraverse *op) {
+	if(op->edgeRelationCount == 0) return NULL;
+
+	// op->M is the relation matrix when traversing outgoing edges
+	// and its transpose otherwise
+	bool transpose = op->traverseDir == GRAPH_EDGE_DIR_OUTGOING;
+	RG_Matrix MT = Graph_GetRelationMatrix(op->g, op->edgeRelationTypes[0],
+			transpose);
+	if(MT == NULL) return NULL;
+
+	GrB_Matrix AT;
+	GrB_Info info = RG_Matrix_export(&AT, MT);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	return AT;
+}
+
+static Record CondVarLenTraverseReachableConsume(OpBase *opBase) {
+	CondVarLenTraverse  *op     = (CondVarLenTraverse *)opBase;
+	OpBase              *child  =  op->op.children[0];
+	Node                dest    =  GE_NEW_NODE();
+	EntityID            dest_id =  INVALID_ENTITY_ID;
+
+	while(op->reachableCtx == NULL ||
+		  (dest_id = ReachableNodesCtx_NextNode(op->reachableCtx)) ==
+			INVALID_ENTITY_ID) {
+		Record childRecord = OpBase_Consume(child);
+		if(!childRecord) return NULL;
+
+		if(op->r) OpBase_DeleteRecord(op->r);
+		op->r = childRecord;
+
+		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
+		if(srcNode == NULL) {
+			// the child Record may not contain the source node
+			// in scenarios like a failed OPTIONAL MATCH
+			// in this case, delete the Record and try again
+			OpBase_DeleteRecord(op->r);
+			op->r = NULL;
+			continue;
+		}
+
+		// create edge relation type array on first call to consume
+		if(!op->edgeRelationTypes) {
+			_setupTraversedRelations(op);
+			// incase we don't have any relations to traverse
+			// and minimal traversal is at least one hop
+			// we can return quickly
+			if(op->edgeRelationCount == 0 && op->minHops > 0) return NULL;
+
+			op->M = op->ae->operand.matrix;
+		}
+
+		if(op->reachableCtx == NULL) {
+			GrB_Matrix A;
+			GrB_Matrix AT = NULL;
+			if(op->edge_filter && op->edgeRelationCount > 0) {
+				// keep only connections made by edges passing the filter
+				A = EdgeFilter_Matrix(op->edge_filter, op->r, op->g,
+						op->edgeRelationTypes[0],
+						op->traverseDir == GRAPH_EDGE_DIR_INCOMING);
+			} else {
+				// flatten pending changes into a matrix of our own
+				GrB_Info info = RG_Matrix_export(&A, op->M);
+				ASSERT(info == GrB_SUCCESS);
+				UNUSED(info);
+				AT = _reachableTranspose(op);
+			}
+			op->reachableCtx = ReachableNodesCtx_New(A, AT, op->minHops,
+					op->maxHops);
+		}
+		ReachableNodesCtx_Reset(op->reachableCtx, srcNode->id);
+	}
+
+	int res = Graph_GetNode(op->g, dest_id, &dest);
+	UNUSED(res);
+	ASSERT(res == true);
+
+	// add destination node to record
+	Record r = OpBase_CloneRecord(op->r);
+	Record_AddNode(r, op->destNodeIdx, dest);
+
+	return r;
+}
+
 static Record CondVarLenTraverseConsume(OpBase *opBase) {
 	CondVarLenTraverse  *op     = (CondVarLenTraverse *)opBase;
 	Path                *p      =  NULL;
@@ -268,16 +551,29 @@ static Record CondVarLenTraverseConsume(OpBase *opBase) {
 			 * Consider: MATCH (S)-[:L*]->(M) RETURN M
 			 * where label L does not exists. */
 			if(op->edgeRelationCount == 0 && op->minHops > 0) return NULL;
+			if(op->expandInto) _setupReachability(op);
 		}
 
+		AllPathsCtx_Free(op->allPathsCtx);
+		op->allPathsCtx = NULL;
+
 		Node *destNode = NULL;
 		// The destination node is known in advance if we're performing an ExpandInto.
-		if(op->expandInto) destNode = Record_GetNode(op->r, op->destNodeIdx);
+		if(op->expandInto) {
+			destNode = Record_GetNode(op->r, op->destNodeIdx);
+			// Searching from both ends for a shortest path is far cheaper
+			// than enumerating all paths, skip unreachable destinations.
+			if(destNode != NULL && !_destReachable(op, srcNode, destNode)) {
+				continue;
+			}
+		}
 
-		AllPathsCtx_Free(op->allPathsCtx);
 		op->allPathsCtx = AllPathsCtx_New(srcNode, destNode, op->g, op->edgeRelationTypes,
 										  op->edgeRelationCount, op->traverseDir, op->minHops,
 										  op->maxHops, op->r, op->ft, op->edgesIdx);
+		if(op->edge_filter) {
+			AllPathsCtx_SetEdgeFilter(op->allPathsCtx, op->edge_filter);
+		}
 
 	}
 
@@ -309,6 +605,11 @@ static OpResult CondVarLenTraverseReset(OpBase *ctx) {
 			AllPathsCtx_Free(op->allPathsCtx);
 			op->allPathsCtx = NULL;
 		}
+	} else if(op->reachable_only) {
+		if(op->reachableCtx) {
+			ReachableNodesCtx_Free(op->reachableCtx);
+			op->reachableCtx = NULL;
+		}
 	} else {
 		if(op->allNeighborsCtx) {
 			AllNeighborsCtx_Free(op->allNeighborsCtx);
@@ -335,6 +636,16 @@ static void CondVarLenTraverseFree(OpBase *ctx) {
 		op->edgeRelationTypes = NULL;
 	}
 
+	if(op->reach_src) {
+		array_free(op->reach_src);
+		op->reach_src = NULL;
+	}
+
+	if(op->reach_dest) {
+		array_free(op->reach_dest);
+		op->reach_dest = NULL;
+	}
+
 	if(op->ae) {
 		AlgebraicExpression_Free(op->ae);
 		op->ae = NULL;
@@ -350,6 +661,11 @@ static void CondVarLenTraverseFree(OpBase *ctx) {
 			AllPathsCtx_Free(op->allPathsCtx);
 			op->allPathsCtx = NULL;
 		}
+	} else if(op->reachable_only) {
+		if(op->reachableCtx) {
+			ReachableNodesCtx_Free(op->reachableCtx);
+			op->reachableCtx = NULL;
+		}
 	} else {
 		if(op->allNeighborsCtx) {
 			AllNeighborsCtx_Free(op->allNeighborsCtx);
@@ -357,6 +673,11 @@ static void CondVarLenTraverseFree(OpBase *ctx) {
 		}
 	}
 
+	if(op->edge_filter) {
+		EdgeFilter_Free(op->edge_filter);
+		op->edge_filter = NULL;
+	}
+
 	if(op->ft) {
 		FilterTree_Free(op->ft);
 		op->ft = NULL;
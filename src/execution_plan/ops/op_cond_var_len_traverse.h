@@ -10,6 +10,8 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../algorithms/algorithms.h"
+#include "../../algorithms/edge_filter.h"
+#include "../../algorithms/reachable_nodes.h"
 #include "../../arithmetic/algebraic_expression.h"
 
 /* OP Traverse */
@@ -23,6 +25,7 @@ typedef struct {
 	int destNodeIdx;                       /* Node set by operation. */
 	bool expandInto;                       /* Both src and dest already resolved. */
 	FT_FilterNode *ft;                     /* If not NULL, FilterTree applied to traversed edge. */
+	EdgeFilter *edge_filter;               /* Applies 'ft' to traversed edges. */
 	unsigned int minHops;                  /* Maximum number of hops to perform. */
 	unsigned int maxHops;                  /* Maximum number of hops to perform. */
 	int edgeRelationCount;                 /* Length of edgeRelationTypes. */
@@ -31,8 +34,12 @@ typedef struct {
 	union {
 		AllPathsCtx *allPathsCtx;          /* Context for collecting all paths. */
 		AllNeighborsCtx *allNeighborsCtx;  /* Context for collecting all neighbors . */
+		ReachableNodesCtx *reachableCtx;   /* Context for collecting reachable nodes. */
 	};
 	bool collect_paths;                    /* Whether we must populate the entire path. */
+	bool reachable_only;                   /* Whether each reachable node is produced once. */
+	RG_Matrix *reach_src;                  /* Matrices expanded from source when testing reachability. */
+	RG_Matrix *reach_dest;                 /* Matrices expanded from destination when testing reachability. */
 	GRAPH_EDGE_DIR traverseDir;            /* Traverse direction. */
 } CondVarLenTraverse;
 
@@ -8,9 +8,12 @@
 #include "RG.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
+#include "../../util/qsort.h"
 
-// default number of records to accumulate before traversing
-#define BATCH_SIZE 16
+// records lacking a source node are assigned no row of F
+#define NO_ROW UINT_MAX
+
+#define SOURCE_ISLT(a, b) ((a)->id < (b)->id)
 
 /* Forward declarations. */
 static OpResult CondTraverseInit(OpBase *opBase);
@@ -23,21 +26,90 @@ static void CondTraverseToString(const OpBase *ctx, sds *buf) {
 	TraversalToString(ctx, buf, ((const OpCondTraverse *)ctx)->ae);
 }
 
+/* Populates the filter matrix with a row per distinct source node,
+ * records sharing a source node, e.g. following a fan-in,
+ * share a row such that its adjacency is only traversed once. */
 static void _populate_filter_matrix(OpCondTraverse *op) {
 	GrB_Matrix FM = RG_MATRIX_M(op->F);
 
+	uint n = 0;
 	for(uint i = 0; i < op->record_count; i++) {
-		Record r = op->records[i];
-		/* Update filter matrix F, set row i at position srcId
-		 * F[i, srcId] = true. */
-		Node *n = Record_GetNode(r, op->srcNodeIdx);
-		NodeID srcId = ENTITY_GET_ID(n);	
-		GrB_Matrix_setElement_BOOL(FM, true, i, srcId);
+		op->rows[i] = NO_ROW;
+		Node *src = Record_GetNode(op->records[i], op->srcNodeIdx);
+		// optional traversals hold records lacking a source node
+		if(src == NULL) continue;
+		op->sources[n++] = (TraverseSource) {
+			.id = ENTITY_GET_ID(src), .record = i
+		};
+	}
+
+	// group records by source node
+	QSORT(TraverseSource, op->sources, n, SOURCE_ISLT);
+
+	op->row_count = 0;
+	for(uint i = 0; i < n; i++) {
+		NodeID srcId = op->sources[i].id;
+		if(i == 0 || srcId != op->sources[i - 1].id) {
+			/* Update filter matrix F, set row at position srcId
+			 * F[row, srcId] = true. */
+			op->row_srcs[op->row_count] = srcId;
+			GrB_Matrix_setElement_BOOL(FM, true, op->row_count++, srcId);
+		}
+		op->rows[op->sources[i].record] = op->row_count - 1;
 	}
 
 	GrB_Matrix_wait(FM, GrB_MATERIALIZE);
 }
 
+/* Groups the result matrix's entries by row, each row's number of
+ * destinations and, unless only counted, its destinations are recorded. */
+static void _index_destinations(OpCondTraverse *op) {
+	GrB_Index nvals;
+	GrB_Matrix M = RG_MATRIX_M(op->M);
+	GrB_Info info = GrB_Matrix_nvals(&nvals, M);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	bool collect = !op->count_dests;
+	if(collect && nvals > op->dest_cap) {
+		op->dest_cap = nvals;
+		op->dests = rm_realloc(op->dests, sizeof(GrB_Index) * nvals);
+	}
+
+	memset(op->row_offsets, 0, sizeof(GrB_Index) * (op->row_count + 1));
+
+	if(op->iter == NULL) GxB_MatrixTupleIter_new(&op->iter, M);
+	else GxB_MatrixTupleIter_reuse(op->iter, M);
+
+	// entries are visited in row order
+	GrB_Index k = 0;
+	GrB_Index row;
+	GrB_Index dest;
+	bool depleted = false;
+	while(true) {
+		GxB_MatrixTupleIter_next(op->iter, &row, &dest, NULL, &depleted);
+		if(depleted) break;
+		op->row_offsets[row + 1]++;
+		if(collect) op->dests[k++] = dest;
+	}
+
+	for(uint i = 0; i < op->row_count; i++) {
+		op->row_offsets[i + 1] += op->row_offsets[i];
+	}
+}
+
+// returns the range of record i's destinations within dests
+static inline void _dest_range(const OpCondTraverse *op, uint i,
+		GrB_Index *start, GrB_Index *end) {
+	uint row = op->rows[i];
+	if(row == NO_ROW) {
+		*start = *end = 0;
+		return;
+	}
+	*start = op->row_offsets[row];
+	*end = op->row_offsets[row + 1];
+}
+
 /* Evaluate algebraic expression:
  * prepends filter matrix as the left most operand
  * perform multiplications
@@ -50,8 +122,8 @@ void _traverse(OpCondTraverse *op) {
 		/* Create both filter and result matrices.
 		 * make sure M's format is SPARSE, required by the matrix iterator */
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
-		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
-		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
+		RG_Matrix_newScratch(&op->M, GrB_BOOL, op->record_cap, required_dim);
+		RG_Matrix_newScratch(&op->F, GrB_BOOL, op->record_cap, required_dim);
 
 		// Prepend the filter matrix to algebraic expression as the leftmost operand.
 		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
@@ -66,8 +138,19 @@ void _traverse(OpCondTraverse *op) {
 	// Evaluate expression.
 	AlgebraicExpression_Eval(op->ae, op->M);
 
-	if(op->iter == NULL) GxB_MatrixTupleIter_new(&op->iter, RG_MATRIX_M(op->M));
-	else GxB_MatrixTupleIter_reuse(op->iter, RG_MATRIX_M(op->M));
+	// Fan each row's destinations out to the records owning it.
+	_index_destinations(op);
+
+	// Resolve the batch's edges, rather than looking up each pair's edges.
+	if(op->edge_ctx) {
+		EdgeTraverseCtx_CollectBatch(op->edge_ctx, op->row_srcs, op->row_count,
+				op->dests, op->row_offsets[op->row_count]);
+	}
+
+	// Start emitting from the batch's first record.
+	GrB_Index end;
+	op->rec_idx = 0;
+	_dest_range(op, 0, &op->dest_idx, &end);
 
 	// Clear filter matrix.
 	RG_Matrix_clear(op->F);
@@ -84,7 +167,24 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	op->records = NULL;
 	op->record_count = 0;
 	op->edge_ctx = NULL;
-	op->record_cap = BATCH_SIZE;
+	op->record_cap = UNLIMITED;
+	op->batch_size = TRAVERSE_BATCH_SIZE;
+	op->count_dests = false;
+	op->count_edges = false;
+	op->R = NULL;
+	op->row_iter = NULL;
+	op->lazy = false;
+	op->dest_labels = NULL;
+	op->optional = false;
+	op->sources = NULL;
+	op->rows = NULL;
+	op->row_srcs = NULL;
+	op->row_count = 0;
+	op->row_offsets = NULL;
+	op->dests = NULL;
+	op->dest_cap = 0;
+	op->rec_idx = 0;
+	op->dest_idx = 0;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CONDITIONAL_TRAVERSE, "Conditional Traverse", CondTraverseInit,
@@ -110,27 +210,170 @@ OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpressi
 	return (OpBase *)op;
 }
 
+void CondTraverseOp_CountDestinations(OpCondTraverse *op) {
+	ASSERT(op != NULL);
+	// edges are counted off the relation matrix
+	ASSERT(op->edge_ctx == NULL ||
+			AlgebraicExpression_OperandCount(op->ae) == 1);
+	op->count_dests = true;
+	op->count_edges = (op->edge_ctx != NULL);
+	op->op.name = "Conditional Traverse Count";
+}
+
+void CondTraverseOp_Optional(OpCondTraverse *op) {
+	ASSERT(op != NULL);
+	ASSERT(!op->count_dests);
+	op->optional = true;
+}
+
+// returns true if the optimized 'ae' is a relation operand, possibly
+// multiplied to the right by label operands, e.g. R * L, such that
+// destinations of a single source can be read off the row of R
+// and checked against each label
+static bool _rowExtractable(const AlgebraicExpression *ae) {
+	if(ae->type == AL_OPERAND) return !ae->operand.diagonal;
+	if(ae->operation.op != AL_EXP_MUL) return false;
+
+	uint child_count = AlgebraicExpression_ChildCount(ae);
+	for(uint i = 0; i < child_count; i++) {
+		const AlgebraicExpression *child = ae->operation.children[i];
+		if(child->type != AL_OPERAND) return false;
+		// the relation matrix must be the left most operand
+		if(child->operand.diagonal != (i > 0)) return false;
+	}
+
+	return true;
+}
+
+// tries to set up row by row extraction, sets R to the expression's relation
+// matrix and collects its label matrices, returns false if not applicable
+static bool _setupRowExtraction(OpCondTraverse *op) {
+	if(AlgebraicExpression_ContainsOp(op->ae, AL_EXP_ADD)) return false;
+
+	// the optimized expression is inspected
+	// transposes are pushed down, possibly reordering operands
+	AlgebraicExpression *ae = AlgebraicExpression_Clone(op->ae);
+	AlgebraicExpression_Optimize(&ae);
+	if(!_rowExtractable(ae)) {
+		AlgebraicExpression_Free(ae);
+		return false;
+	}
+
+	AlgebraicExpression_Free(op->ae);
+	op->ae = ae;
+
+	if(ae->type == AL_OPERAND) {
+		op->R = ae->operand.matrix;
+	} else {
+		uint child_count = AlgebraicExpression_ChildCount(ae);
+		op->R = ae->operation.children[0]->operand.matrix;
+		op->dest_labels = array_new(RG_Matrix, child_count - 1);
+		for(uint i = 1; i < child_count; i++) {
+			array_append(op->dest_labels,
+					ae->operation.children[i]->operand.matrix);
+		}
+	}
+
+	RG_MatrixTupleIter_new(&op->row_iter, op->R);
+	return true;
+}
+
 static OpResult CondTraverseInit(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
+
+	// under a small limit most of a batch's destinations are discarded
+	// extract them lazily, one source row at a time
+	op->lazy = (!op->count_dests &&
+				!op->optional &&
+				op->record_cap <= LAZY_TRAVERSE_LIMIT &&
+				_setupRowExtraction(op));
+	if(op->lazy) return OP_OK;
+
 	// Create 'records' with this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// batches start small and grow up to 'record_cap' records
+	op->record_cap = TraverseBatch_Cap(op->record_cap);
+	op->batch_size = TraverseBatch_Initial(op->record_cap);
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
 
+	if(op->count_dests &&
+	   AlgebraicExpression_OperandCount(op->ae) == 1) {
+		// a single operand, e.g. (n)-[:R]->(), is counted row by row
+		AlgebraicExpression_Optimize(&op->ae);
+		ASSERT(op->ae->type == AL_OPERAND);
+		op->R = op->ae->operand.matrix;
+		RG_MatrixTupleIter_new(&op->row_iter, op->R);
+		return OP_OK;
+	}
+
+	op->sources = rm_malloc(op->record_cap * sizeof(TraverseSource));
+	op->rows = rm_malloc(op->record_cap * sizeof(uint));
+	op->row_srcs = rm_malloc(op->record_cap * sizeof(NodeID));
+	op->row_offsets = rm_malloc((op->record_cap + 1) * sizeof(GrB_Index));
+
 	return OP_OK;
 }
 
-/* Each call to CondTraverseConsume emits a Record containing the
- * traversal's endpoints and, if required, an edge.
- * Returns NULL once all traversals have been performed. */
-static Record CondTraverseConsume(OpBase *opBase) {
-	OpCondTraverse *op = (OpCondTraverse *)opBase;
+/* Collects a batch of child records holding a source node.
+ * Returns the number of collected records. */
+static uint _collect_records(OpCondTraverse *op) {
+	OpBase *child = op->op.children[0];
+
+	// Free old records.
+	op->r = NULL;
+	for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
+	op->record_count = 0;
+
+	// each batch is traversed by a single matrix multiplication
+	// check for cancellation in between
+	QueryCtx_CheckCancelled();
+
+	// Ask child operations for data.
+	for(op->record_count = 0; op->record_count < op->batch_size; op->record_count++) {
+		Record childRecord = OpBase_Consume(child);
+		// If the Record is NULL, the child has been depleted.
+		if(!childRecord) break;
+		if(!op->optional && !Record_GetNode(childRecord, op->srcNodeIdx)) {
+			/* The child Record may not contain the source node in scenarios like
+			 * a failed OPTIONAL MATCH. In this case, delete the Record and try again. */
+			OpBase_DeleteRecord(childRecord);
+			op->record_count--;
+			continue;
+		}
+
+		// Store received record.
+		Record_PersistScalars(childRecord);
+		op->records[op->record_count] = childRecord;
+	}
+
+	// Child filled the batch, expect more data.
+	if(op->record_count == op->batch_size) {
+		op->batch_size = TraverseBatch_Grow(op->batch_size, op->record_cap);
+	}
+
+	return op->record_count;
+}
+
+// returns true if 'dest' carries each of the destination labels
+static bool _labeledDestination(const OpCondTraverse *op, NodeID dest) {
+	if(op->dest_labels == NULL) return true;
+
+	bool x;
+	uint label_count = array_len(op->dest_labels);
+	for(uint i = 0; i < label_count; i++) {
+		GrB_Info info = RG_Matrix_extractElement_BOOL(&x, op->dest_labels[i],
+				dest, dest);
+		if(info != GrB_SUCCESS) return false;
+	}
+
+	return true;
+}
+
+/* Emits a record per destination on the current source's row of R,
+ * a new source record is consumed once the row is depleted. */
+static Record _CondTraverseConsumeLazy(OpCondTraverse *op) {
 	OpBase *child = op->op.children[0];
 
-	/* If we're required to update an edge and have one queued, we can return early.
-	 * Otherwise, try to get a new pair of source and destination nodes. */
 	if(op->r         != NULL  &&
 	   op->edge_ctx  != NULL  &&
 	   EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r)) {
@@ -138,56 +381,124 @@ static Record CondTraverseConsume(OpBase *opBase) {
 	}
 
 	bool depleted = true;
-	NodeID src_id = INVALID_ENTITY_ID;
-	NodeID dest_id = INVALID_ENTITY_ID;
+	GrB_Index dest_id;
 
 	while(true) {
-		if(op->iter) GxB_MatrixTupleIter_next(op->iter, &src_id, &dest_id,
-				NULL, &depleted);
+		if(op->r) {
+			RG_MatrixTupleIter_next(op->row_iter, NULL, &dest_id, NULL,
+					&depleted);
+			if(!depleted && !_labeledDestination(op, dest_id)) continue;
+			if(!depleted) break;
+
+			OpBase_DeleteRecord(op->r);
+			op->r = NULL;
+		}
 
-		// Managed to get a tuple, break.
-		if(!depleted) break;
+		op->r = OpBase_Consume(child);
+		if(op->r == NULL) return NULL;
 
-		/* Run out of tuples, try to get new data.
-		 * Free old records. */
-		op->r = NULL;
-		for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
+		Node *src = Record_GetNode(op->r, op->srcNodeIdx);
+		if(src == NULL) {
+			// source missing, e.g. a failed OPTIONAL MATCH
+			OpBase_DeleteRecord(op->r);
+			op->r = NULL;
+			continue;
+		}
 
-		// Ask child operations for data.
-		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
-			Record childRecord = OpBase_Consume(child);
-			// If the Record is NULL, the child has been depleted.
-			if(!childRecord) break;
-			if(!Record_GetNode(childRecord, op->srcNodeIdx)) {
-				/* The child Record may not contain the source node in scenarios like
-				 * a failed OPTIONAL MATCH. In this case, delete the Record and try again. */
-				OpBase_DeleteRecord(childRecord);
-				op->record_count--;
-				continue;
-			}
+		RG_MatrixTupleIter_iterate_row(op->row_iter, ENTITY_GET_ID(src));
+	}
+
+	// the destination's entity is retrieved only if accessed
+	Record_AddNode(op->r, op->destNodeIdx, GE_LAZY_NODE(dest_id));
+
+	if(op->edge_ctx) {
+		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
+		EdgeTraverseCtx_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), dest_id);
+		EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r);
+	}
 
-			// Store received record.
-			Record_PersistScalars(childRecord);
-			op->records[op->record_count] = childRecord;
+	return OpBase_CloneRecord(op->r);
+}
+
+/* Counts the entries of row 'src' in R, or the edges they hold.
+ * The row iterator merges delta-plus and skips delta-minus entries. */
+static uint64_t _row_degree(OpCondTraverse *op, NodeID src) {
+	uint64_t x;
+	uint64_t degree = 0;
+	bool depleted = false;
+	void *val = (op->count_edges) ? &x : NULL;
+
+	RG_MatrixTupleIter_iterate_row(op->row_iter, src);
+	while(true) {
+		RG_MatrixTupleIter_next(op->row_iter, NULL, NULL, val, &depleted);
+		if(depleted) break;
+
+		// an entry is either a single edge or a multi-edge entry
+		if(!op->count_edges || SINGLE_EDGE(x)) {
+			degree++;
+		} else {
+			uint64_t n;
+			RG_Matrix_multiEdgeIDs(op->R, x, &n);
+			degree += n;
 		}
+	}
 
-		// No data.
-		if(op->record_count == 0) return NULL;
+	return degree;
+}
 
+/* Emits each source record with at least one destination,
+ * along with its degree, no result matrix is computed. */
+static Record _CondTraverseConsumeDegrees(OpCondTraverse *op) {
+	OpBase *child = op->op.children[0];
+
+	Record r;
+	while((r = OpBase_Consume(child))) {
+		Node *n = Record_GetNode(r, op->srcNodeIdx);
+		uint64_t degree = (n) ? _row_degree(op, ENTITY_GET_ID(n)) : 0;
+		if(degree > 0) {
+			Record_AddScalar(r, op->destNodeIdx, SI_LongVal(degree));
+			return r;
+		}
+		OpBase_DeleteRecord(r);
+	}
+
+	return NULL;
+}
+
+/* Emits each source record once, along with its number of destinations. */
+static Record _CondTraverseConsumeCounts(OpCondTraverse *op) {
+	if(op->R != NULL) return _CondTraverseConsumeDegrees(op);
+
+	while(true) {
+		while(op->rec_idx < op->record_count) {
+			GrB_Index start;
+			GrB_Index end;
+			uint i = op->rec_idx++;
+			_dest_range(op, i, &start, &end);
+			if(start == end) continue;
+
+			Record r = op->records[i];
+			Record_AddScalar(r, op->destNodeIdx, SI_LongVal(end - start));
+			return OpBase_CloneRecord(r);
+		}
+
+		if(_collect_records(op) == 0) return NULL;
 		_traverse(op);
 	}
+}
 
-	/* Get node from current column. */
-	op->r = op->records[src_id];
-	// Populate the destination node and add it to the Record.
-	Node destNode = GE_NEW_NODE();
-	Graph_GetNode(op->graph, dest_id, &destNode);
-	Record_AddNode(op->r, op->destNodeIdx, destNode);
+/* Sets the destination of record 'rec_idx' of the current batch,
+ * along with a connecting edge if required, and emits a copy of it. */
+static Record _emit(OpCondTraverse *op, uint rec_idx, NodeID dest_id) {
+	op->r = op->records[rec_idx];
+	// Add the destination node to the Record,
+	// its entity is retrieved only if accessed.
+	Record_AddNode(op->r, op->destNodeIdx, GE_LAZY_NODE(dest_id));
 
 	if(op->edge_ctx) {
 		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
 		// Collect all appropriate edges connecting the current pair of endpoints.
-		EdgeTraverseCtx_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), ENTITY_GET_ID(&destNode));
+		EdgeTraverseCtx_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), dest_id);
 		// We're guaranteed to have at least one edge.
 		EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r);
 	}
@@ -195,14 +506,72 @@ static Record CondTraverseConsume(OpBase *opBase) {
 	return OpBase_CloneRecord(op->r);
 }
 
+/* Emits a record per destination of each of the batch's records in turn,
+ * under an optional traversal records lacking destinations
+ * are emitted unmodified. */
+static Record _CondTraverseConsumeBatch(OpCondTraverse *op) {
+	while(true) {
+		while(op->rec_idx < op->record_count) {
+			GrB_Index start;
+			GrB_Index end;
+			uint i = op->rec_idx;
+			_dest_range(op, i, &start, &end);
+			if(op->dest_idx < end) {
+				return _emit(op, i, op->dests[op->dest_idx++]);
+			}
+
+			// record depleted, move on to the next one
+			op->rec_idx++;
+			if(op->rec_idx < op->record_count) {
+				_dest_range(op, op->rec_idx, &op->dest_idx, &end);
+			}
+			if(op->optional && start == end) {
+				op->r = NULL;
+				return OpBase_CloneRecord(op->records[i]);
+			}
+		}
+
+		// Run out of records, try to get new data.
+		if(_collect_records(op) == 0) return NULL;
+
+		_traverse(op);
+	}
+}
+
+/* Each call to CondTraverseConsume emits a Record containing the
+ * traversal's endpoints and, if required, an edge.
+ * Returns NULL once all traversals have been performed. */
+static Record CondTraverseConsume(OpBase *opBase) {
+	OpCondTraverse *op = (OpCondTraverse *)opBase;
+
+	if(op->count_dests) return _CondTraverseConsumeCounts(op);
+	if(op->lazy) return _CondTraverseConsumeLazy(op);
+
+	/* If we're required to update an edge and have one queued, we can return early.
+	 * Otherwise, try to get a new pair of source and destination nodes. */
+	if(op->r         != NULL  &&
+	   op->edge_ctx  != NULL  &&
+	   EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r)) {
+		return OpBase_CloneRecord(op->r);
+	}
+
+	return _CondTraverseConsumeBatch(op);
+}
+
 static OpResult CondTraverseReset(OpBase *ctx) {
 	OpCondTraverse *op = (OpCondTraverse *)ctx;
 
 	// Do not explicitly free op->r, as the same pointer is also held
-	// in the op->records array and as such will be freed there.
+	// in the op->records array and as such will be freed there,
+	// unless destinations are extracted lazily.
+	if(op->lazy && op->r) OpBase_DeleteRecord(op->r);
 	op->r = NULL;
 	for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
 	op->record_count = 0;
+	op->batch_size = TraverseBatch_Initial(op->record_cap);
+	op->row_count = 0;
+	op->rec_idx = 0;
+	op->dest_idx = 0;
 
 	if(op->edge_ctx) EdgeTraverseCtx_Reset(op->edge_ctx);
 
@@ -216,7 +585,11 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 static inline OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_CONDITIONAL_TRAVERSE);
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
-	return NewCondTraverseOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	OpCondTraverse *clone = (OpCondTraverse *)NewCondTraverseOp(plan,
+			QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
+	if(op->count_dests) CondTraverseOp_CountDestinations(clone);
+	if(op->optional) CondTraverseOp_Optional(clone);
+	return (OpBase *)clone;
 }
 
 /* Frees CondTraverse */
@@ -228,12 +601,12 @@ static void CondTraverseFree(OpBase *ctx) {
 	}
 
 	if(op->F != NULL) {
-		RG_Matrix_free(&op->F);
+		RG_Matrix_freeScratch(&op->F);
 		op->F = NULL;
 	}
 
 	if(op->M != NULL) {
-		RG_Matrix_free(&op->M);
+		RG_Matrix_freeScratch(&op->M);
 		op->M = NULL;
 	}
 
@@ -247,6 +620,46 @@ static void CondTraverseFree(OpBase *ctx) {
 		op->edge_ctx = NULL;
 	}
 
+	if(op->row_iter) {
+		RG_MatrixTupleIter_free(&op->row_iter);
+		op->row_iter = NULL;
+	}
+
+	if(op->dest_labels) {
+		array_free(op->dest_labels);
+		op->dest_labels = NULL;
+	}
+
+	if(op->lazy && op->r) {
+		OpBase_DeleteRecord(op->r);
+		op->r = NULL;
+	}
+
+	if(op->sources) {
+		rm_free(op->sources);
+		op->sources = NULL;
+	}
+
+	if(op->rows) {
+		rm_free(op->rows);
+		op->rows = NULL;
+	}
+
+	if(op->row_srcs) {
+		rm_free(op->row_srcs);
+		op->row_srcs = NULL;
+	}
+
+	if(op->row_offsets) {
+		rm_free(op->row_offsets);
+		op->row_offsets = NULL;
+	}
+
+	if(op->dests) {
+		rm_free(op->dests);
+		op->dests = NULL;
+	}
+
 	if(op->records) {
 		for(uint i = 0; i < op->record_count; i++) OpBase_DeleteRecord(op->records[i]);
 		rm_free(op->records);
@@ -13,6 +13,17 @@
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
 
+// traversals under a limit no greater than this extract destinations
+// lazily, row by row, rather than evaluating the algebraic expression
+#define LAZY_TRAVERSE_LIMIT 64
+
+// a batched record's source node, records sharing a source node
+// are assigned a single row of the filter matrix
+typedef struct {
+	NodeID id;    // source node ID
+	uint record;  // record index within the batch
+} TraverseSource;
+
 /* OP Traverse */
 typedef struct {
 	OpBase op;
@@ -26,10 +37,40 @@ typedef struct {
 	int destNodeIdx;            // Destination node index into record.
 	uint record_count;          // Number of held records.
 	uint record_cap;            // Max number of records to process.
+	uint batch_size;            // Number of records to process next.
 	Record *records;            // Array of records.
 	Record r;                   // Currently selected record.
+	bool count_dests;           // Emit destination counts rather than destinations.
+	bool count_edges;           // Count edges rather than distinct destinations.
+	RG_Matrix R;                // Matrix counted rows are read from, if ae is a single operand.
+	RG_MatrixTupleIter *row_iter; // Iterator over a row of R.
+	bool lazy;                  // Extract destinations row by row.
+	RG_Matrix *dest_labels;     // Label matrices destinations are checked against.
+	bool optional;              // Emit records without destinations as well.
+	TraverseSource *sources;    // Batch's source nodes, sorted by ID.
+	uint *rows;                 // Row of F assigned to each record.
+	NodeID *row_srcs;           // Source node of each row of F.
+	uint row_count;             // Number of distinct source nodes in the batch.
+	GrB_Index *row_offsets;     // Start of each row's destinations within dests.
+	GrB_Index *dests;           // Batch's destinations, grouped by row of F.
+	GrB_Index dest_cap;         // Capacity of dests.
+	uint rec_idx;               // Record whose destinations are emitted.
+	GrB_Index dest_idx;         // Next destination to emit.
 } OpCondTraverse;
 
 /* Creates a new Traverse operation */
 OpBase *NewCondTraverseOp(const ExecutionPlan *plan, Graph *g, AlgebraicExpression *ae);
 
+/* Have the operation emit each source record once, with the number of
+ * reachable destinations set in place of the destination node,
+ * counts are computed by reducing the traversal's result matrix rows,
+ * or read directly off the relation matrix if the traversal's expression
+ * is a single operand, in which case edges are counted if populated. */
+void CondTraverseOp_CountDestinations(OpCondTraverse *op);
+
+/* Have the operation emit source records for which no destination was found
+ * unmodified, in between the records of their batch which were traversed,
+ * this allows an OPTIONAL MATCH fed a batch of records to be resolved by
+ * a single traversal while keeping the order of its input records. */
+void CondTraverseOp_Optional(OpCondTraverse *op);
+
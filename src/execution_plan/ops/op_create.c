@@ -139,6 +139,7 @@ static Record CreateConsume(OpBase *opBase) {
 	} else {
 		// Pull data until child is depleted.
 		child = op->op.children[0];
+		uint64_t consumed = 0;
 		while((r = OpBase_Consume(child))) {
 			/* Persist scalars from previous ops before storing the record,
 			 * as those ops will be freed before the records are handed off. */
@@ -150,6 +151,9 @@ static Record CreateConsume(OpBase *opBase) {
 
 			// save record for later use
 			array_append(op->records, r);
+
+			// nothing is committed yet, the query can still be cancelled
+			if((++consumed & QUERY_CANCEL_CHECK_MASK) == 0) QueryCtx_CheckCancelled();
 		}
 	}
 
@@ -8,6 +8,8 @@
 #include "../../errors.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
+#include "../../effects/effects.h"
+#include "shared/delete_functions.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
 /* Forward declarations. */
@@ -17,12 +19,8 @@ static OpBase *DeleteClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void DeleteFree(OpBase *opBase);
 
 void _DeleteEntities(OpDelete *op) {
-	Graph  *g                     =  op->gc->g;
-	uint   node_deleted           =  0;
-	uint   edge_deleted           =  0;
-	uint   implicit_edge_deleted  =  0;
-	uint   node_count             =  array_len(op->deleted_nodes);
-	uint   edge_count             =  array_len(op->deleted_edges);
+	uint node_count = array_len(op->deleted_nodes);
+	uint edge_count = array_len(op->deleted_edges);
 
 	// nothing to delete, quickly return
 	if((node_count + edge_count) == 0) goto cleanup;
@@ -30,33 +28,13 @@ void _DeleteEntities(OpDelete *op) {
 	// lock everything
 	QueryCtx_LockForCommit();
 
-	if(GraphContext_HasIndices(op->gc)) {
-		for(int i = 0; i < node_count; i++) {
-			Node *n = op->deleted_nodes + i;
-			GraphContext_DeleteNodeFromIndices(op->gc, n);
-		}
+	// record deletions prior to deleting, as deleted entities lose their data
+	EffectsBuffer *effects = QueryCtx_GetEffectsBuffer();
+	EffectsBuffer_AddDeleteEffect(effects, op->gc, op->deleted_nodes,
+			node_count, op->deleted_edges, edge_count);
 
-		for(int i = 0; i < edge_count; i++) {
-			Edge *e = op->deleted_edges + i;
-			GraphContext_DeleteEdgeFromIndices(op->gc, e);
-		}
-	}
-
-	if(edge_count <= EDGE_BULK_DELETE_THRESHOLD) {
-		for(uint i = 0; i < edge_count; i++) {
-			edge_deleted += Graph_DeleteEdge(g, op->deleted_edges + i);
-		}
-		edge_count = 0;
-	}
-
-	Graph_BulkDelete(g, op->deleted_nodes, node_count, op->deleted_edges,
-					 edge_count, &node_deleted, &implicit_edge_deleted);
-
-	if(op->stats != NULL) {
-		op->stats->nodes_deleted          +=  node_deleted;
-		op->stats->relationships_deleted  +=  edge_deleted;
-		op->stats->relationships_deleted  +=  implicit_edge_deleted;
-	}
+	DeleteEntities(op->gc, op->deleted_nodes, node_count, op->deleted_edges,
+			edge_count, op->stats);
 
 cleanup:
 	// release lock, no harm in trying to release an unlocked lock
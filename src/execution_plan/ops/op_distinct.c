@@ -7,8 +7,8 @@
 #include "op_distinct.h"
 #include "op_project.h"
 #include "op_aggregate.h"
-#include "xxhash.h"
 #include "../../util/arr.h"
+#include "../../configuration/config.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
 /* Forward declarations. */
@@ -16,26 +16,13 @@ static Record DistinctConsume(OpBase *opBase);
 static OpBase *DistinctClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void DistinctFree(OpBase *opBase);
 
-// compute hash on distinct values
+// collect distinct values
 // values that are required to be distinct are located at 'offset'
 // positions within the record
-static unsigned long long _compute_hash(OpDistinct *op, Record r) {
-	// initialize the hash state
-	XXH64_state_t state;
-	XXH_errorcode res = XXH64_reset(&state, 0);
-	ASSERT(res != XXH_ERROR);
-
+static void _collect_values(OpDistinct *op, Record r) {
 	for(uint i = 0; i < op->offset_count; i++) {
-		// retrieve the entry at 'idx' as an SIValue
-		uint idx = op->offsets[i];
-		SIValue v = Record_Get(r, idx);
-		// update the hash state with the current value.
-		SIValue_HashUpdate(v, &state);
+		op->values[i] = Record_Get(r, op->offsets[i]);
 	}
-
-	// finalize the hash
-	unsigned long long const hash = XXH64_digest(&state);
-	return hash;
 }
 
 // compute record offset to distinct values
@@ -56,7 +43,15 @@ OpBase *NewDistinctOp(const ExecutionPlan *plan, const char **aliases, uint alia
 
 	OpDistinct *op = rm_malloc(sizeof(OpDistinct));
 
-	op->found           =  raxNew();
+	// cap the memory spent on storing distinct values to a quarter of
+	// the query's memory capacity, beyond which tuples are fingerprinted
+	int64_t mem_cap = QUERY_MEM_CAPACITY_UNLIMITED;
+	Config_Option_get(Config_QUERY_MEM_CAPACITY, &mem_cap);
+	uint64_t max_key_bytes = (mem_cap > 0) ? mem_cap / 4 : 0;
+
+	op->found           =  TupleSet_New(alias_count, 0, max_key_bytes);
+	op->last            =  TUPLESET_NO_ID;
+	op->values          =  rm_malloc(alias_count * sizeof(SIValue));
 	op->mapping         =  NULL;
 	op->aliases         =  rm_malloc(alias_count * sizeof(const char *));
 	op->offset_count    =  alias_count;
@@ -93,8 +88,16 @@ static Record DistinctConsume(OpBase *opBase) {
 			op->mapping = record_mapping;
 		}
 
-		unsigned long long const hash = _compute_hash(op, r);
-		int is_new = raxInsert(op->found, (unsigned char *) &hash, sizeof(hash), NULL, NULL);
+		_collect_values(op, r);
+
+		// sorted input repeats the last tuple, skip the hash lookup
+		if(op->last != TUPLESET_NO_ID &&
+		   TupleSet_Matches(op->found, op->last, op->values)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
+
+		bool is_new = TupleSet_Add(op->found, op->values, &op->last);
 		if(is_new) return r;
 		OpBase_DeleteRecord(r);
 	}
@@ -109,10 +112,15 @@ static inline OpBase *DistinctClone(const ExecutionPlan *plan, const OpBase *opB
 static void DistinctFree(OpBase *ctx) {
 	OpDistinct *op = (OpDistinct *)ctx;
 	if(op->found) {
-		raxFree(op->found);
+		TupleSet_Free(op->found);
 		op->found = NULL;
 	}
 
+	if(op->values) {
+		rm_free(op->values);
+		op->values = NULL;
+	}
+
 	if(op->aliases) {
 		rm_free(op->aliases);
 		op->aliases = NULL;
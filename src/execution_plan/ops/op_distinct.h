@@ -9,10 +9,13 @@
 #include "op.h"
 #include "rax.h"
 #include "../execution_plan.h"
+#include "../../datatypes/tuple_set.h"
 
 typedef struct {
 	OpBase op;
-	rax *found;
+	TupleSet *found;       // distinct tuples encountered so far
+	uint64_t last;         // ID of the last encountered tuple
+	SIValue *values;       // distinct values of the current record
 	rax *mapping;          // record mapping
 	uint *offsets;         // offsets to expression values
 	const char **aliases;  // expression aliases to distinct by
@@ -6,9 +6,15 @@
 
 #include "op_edge_by_index_scan.h"
 #include "../../query_ctx.h"
+#include "../../util/qsort.h"
 #include "shared/print_functions.h"
 #include "../../filter_tree/ft_to_rsq.h"
 
+#define SRC_KEY_ISLT(a, b) ((a)->src_id < (b)->src_id || \
+	((a)->src_id == (b)->src_id && (a)->dest_id < (b)->dest_id))
+#define DEST_KEY_ISLT(a, b) ((a)->dest_id < (b)->dest_id || \
+	((a)->dest_id == (b)->dest_id && (a)->src_id < (b)->src_id))
+
 // forward declarations
 static OpResult EdgeIndexScanInit(OpBase *opBase);
 static Record EdgeIndexScanConsume(OpBase *opBase);
@@ -59,6 +65,14 @@ OpBase *NewEdgeIndexScanOp
 	op->current_dest_node_id =  NULL;
 	op->unresolved_filters   =  NULL;
 	op->rebuild_index_query  =  false;
+	op->edge_filter          =  NULL;
+	op->child_count          =  0;
+	op->keys                 =  NULL;
+	op->E                    =  NULL;
+	op->row_iter             =  NULL;
+	op->key_idx              =  0;
+	op->key_row              =  INVALID_ENTITY_ID;
+	op->key_col              =  INVALID_ENTITY_ID;
 
 	// set our Op operations
 	OpBase_Init(
@@ -79,6 +93,15 @@ OpBase *NewEdgeIndexScanOp
 	return (OpBase *)op;
 }
 
+// true if any operation within the plan modifies the graph
+static bool _planWrites(const OpBase *op) {
+	if(op->writer) return true;
+	for(int i = 0; i < op->childCount; i++) {
+		if(_planWrites(op->children[i])) return true;
+	}
+	return false;
+}
+
 static OpResult EdgeIndexScanInit
 (
 	OpBase *opBase
@@ -103,6 +126,21 @@ static OpResult EdgeIndexScanInit
 
 	if(opBase->childCount > 0) {
 		const char *alias =  QGEdge_Alias(op->edge);
+
+		// if the filter refers to the scanned edge alone, the index results
+		// are the same for each input record, up to the bound endpoints
+		// as long as the query doesn't modify the graph these can be
+		// materialized once and looked up by endpoint
+		const OpBase *root = opBase;
+		while(root->parent != NULL) root = root->parent;
+		if((op->srcAware || op->destAware) && !_planWrites(root)) {
+			rax *entities = FilterTree_CollectModified(op->filter);
+			if(raxSize(entities) == 1) {
+				op->edge_filter = FilterTree_Clone(op->filter);
+			}
+			raxFree(entities);
+		}
+
 		if(op->srcAware) {
 			op->current_src_node_id  = AR_EXP_NewConstOperandNode(SI_NullVal());
 			FT_FilterNode *ft = FilterTree_CreatePredicateFilter(OP_EQUAL, 
@@ -210,6 +248,158 @@ static void UpdateCurrentAwareIds(const OpEdgeIndexScan *op) {
 	}
 }
 
+// returns the endpoint of 'key' by which E is indexed
+static inline NodeID _KeyRow
+(
+	const OpEdgeIndexScan *op,
+	const EdgeIndexKey *key
+) {
+	return (op->srcAware) ? key->src_id : key->dest_id;
+}
+
+// returns the endpoint of 'key' E's columns correspond to
+static inline NodeID _KeyCol
+(
+	const OpEdgeIndexScan *op,
+	const EdgeIndexKey *key
+) {
+	return (op->srcAware) ? key->dest_id : key->src_id;
+}
+
+// runs the index query once, collecting its results sorted by
+// (bound endpoint, other endpoint) and indexes them by matrix E
+// E[row, col] is the position of the first key connecting row to col
+static void _Materialize
+(
+	OpEdgeIndexScan *op
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	// discard per record query
+	if(op->iter != NULL) {
+		RediSearch_ResultsIteratorFree(op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->unresolved_filters != NULL) {
+		FilterTree_Free(op->unresolved_filters);
+		op->unresolved_filters = NULL;
+	}
+
+	// the index must reflect the query's own modifications
+	QueryCtx_ApplyIndexChanges();
+
+	RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
+			op->edge_filter, op->idx);
+	ASSERT(rs_query_node != NULL);
+	RSResultsIterator *iter = RediSearch_GetResultsIterator(rs_query_node,
+			op->idx);
+
+	const EdgeIndexKey *edgeKey = NULL;
+	op->keys = array_new(EdgeIndexKey, 0);
+	while((edgeKey = RediSearch_ResultsIteratorNext(iter, op->idx, NULL))
+			!= NULL) {
+		array_append(op->keys, *edgeKey);
+	}
+	RediSearch_ResultsIteratorFree(iter);
+
+	uint64_t n = array_len(op->keys);
+	if(op->srcAware) {
+		QSORT(EdgeIndexKey, op->keys, n, SRC_KEY_ISLT);
+	} else {
+		QSORT(EdgeIndexKey, op->keys, n, DEST_KEY_ISLT);
+	}
+
+	GrB_Index  dim = Graph_RequiredMatrixDim(op->g);
+	GrB_Index  *I  = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index  *J  = rm_malloc(sizeof(GrB_Index) * n);
+	uint64_t   *X  = rm_malloc(sizeof(uint64_t) * n);
+	for(uint64_t i = 0; i < n; i++) {
+		I[i] = _KeyRow(op, op->keys + i);
+		J[i] = _KeyCol(op, op->keys + i);
+		X[i] = i;
+	}
+
+	info = GrB_Matrix_new(&op->E, GrB_UINT64, dim, dim);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_set(op->E, GxB_SPARSITY_CONTROL, GxB_SPARSE | GxB_HYPERSPARSE);
+	ASSERT(info == GrB_SUCCESS);
+	// parallel edges share an entry, holding the first of their keys
+	if(n > 0) {
+		info = GrB_Matrix_build_UINT64(op->E, I, J, X, n, GrB_MIN_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+	}
+	info = GxB_MatrixTupleIter_new(&op->row_iter, op->E);
+	ASSERT(info == GrB_SUCCESS);
+
+	rm_free(I);
+	rm_free(J);
+	rm_free(X);
+}
+
+// positions key_idx at the first materialized key
+// matching the input record's bound endpoints
+static void _SeekKeys
+(
+	OpEdgeIndexScan *op
+) {
+	uint64_t   start;
+	GrB_Index  nrows;
+	bool       depleted = false;
+
+	op->key_idx = array_len(op->keys);
+	op->key_col = INVALID_ENTITY_ID;
+
+	Node *src  = (op->srcAware) ?
+		Record_GetNode(op->child_record, op->srcRecIdx) : NULL;
+	Node *dest = (op->destAware) ?
+		Record_GetNode(op->child_record, op->destRecIdx) : NULL;
+
+	if(src != NULL) {
+		op->key_row = ENTITY_GET_ID(src);
+		if(dest != NULL) op->key_col = ENTITY_GET_ID(dest);
+	} else {
+		op->key_row = ENTITY_GET_ID(dest);
+	}
+
+	GrB_Matrix_nrows(&nrows, op->E);
+	if(op->key_row >= nrows) return;
+
+	if(op->key_col != INVALID_ENTITY_ID) {
+		// both endpoints are bound, a single entry of E
+		if(op->key_col >= nrows) return;
+		if(GrB_Matrix_extractElement_UINT64(&start, op->E, op->key_row,
+					op->key_col) == GrB_SUCCESS) {
+			op->key_idx = start;
+		}
+	} else {
+		// a row of E, whose keys are consecutive
+		// starting at the row's first entry
+		GxB_MatrixTupleIter_iterate_row(op->row_iter, op->key_row);
+		GxB_MatrixTupleIter_next(op->row_iter, NULL, NULL, &start, &depleted);
+		if(!depleted) op->key_idx = start;
+	}
+}
+
+// returns the next materialized key matching the input record
+// NULL once depleted
+static const EdgeIndexKey *_NextKey
+(
+	OpEdgeIndexScan *op
+) {
+	if(op->key_idx >= array_len(op->keys)) return NULL;
+
+	const EdgeIndexKey *key = op->keys + op->key_idx;
+	if(_KeyRow(op, key) != op->key_row) return NULL;
+	if(op->key_col != INVALID_ENTITY_ID && _KeyCol(op, key) != op->key_col) {
+		return NULL;
+	}
+
+	op->key_idx++;
+	return key;
+}
+
 static Record EdgeIndexScanConsumeFromChild
 (
 	OpBase *opBase
@@ -222,7 +412,17 @@ pull_index:
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
+	if(op->E != NULL && op->child_record != NULL) {
+		while((edgeKey = _NextKey(op)) != NULL) {
+			// populate record with edge
+			_UpdateRecord(op, op->child_record, edgeKey);
+			// apply unresolved filters
+			if(_PassUnresolvedFilters(op, op->child_record)) {
+				// clone the held Record, as it will be freed upstream
+				return OpBase_CloneRecord(op->child_record);
+			}
+		}
+	} else if(op->iter != NULL && op->child_record != NULL) {
 		while((edgeKey = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
 				!= NULL) {
 			// populate record with edge
@@ -252,6 +452,21 @@ pull_index:
 	op->child_record = OpBase_Consume(op->op.children[0]);
 	if(op->child_record == NULL) return NULL; // depleted
 
+	//--------------------------------------------------------------------------
+	// lookup materialized results
+	//--------------------------------------------------------------------------
+
+	// many input records, resolve the index query once
+	if(op->edge_filter != NULL && op->E == NULL &&
+	   ++op->child_count > EDGE_INDEX_SCAN_MATERIALIZE_MIN) {
+		_Materialize(op);
+	}
+
+	if(op->E != NULL) {
+		_SeekKeys(op);
+		goto pull_index;
+	}
+
 	//--------------------------------------------------------------------------
 	// reset index iterator
 	//--------------------------------------------------------------------------
@@ -285,6 +500,9 @@ pull_index:
 		}
 		#endif
 
+		// the index must reflect the query's own modifications
+		QueryCtx_ApplyIndexChanges();
+
 		// convert filter into a RediSearch query
 		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
 				filter, op->idx);
@@ -294,6 +512,8 @@ pull_index:
 		ASSERT(rs_query_node != NULL);
 		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
 	} else {
+		QueryCtx_ApplyIndexChanges();
+
 		// build index query only once (first call)
 		// reset it if already initialized
 		if(op->iter == NULL) {
@@ -321,6 +541,7 @@ static Record EdgeIndexScanConsume
 	// create iterator on first call
 	if(op->iter == NULL) {
 		UpdateCurrentAwareIds(op);
+		QueryCtx_ApplyIndexChanges();
 
 		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
 				op->filter, op->idx);
@@ -350,9 +571,14 @@ static Record EdgeIndexScanConsume
 static OpResult EdgeIndexScanReset(OpBase *opBase) {
 	OpEdgeIndexScan *op = (OpEdgeIndexScan *)opBase;
 
+	// materialized results remain valid, the query doesn't modify the graph
+	if(op->E != NULL) return OP_OK;
+
 	if(op->rebuild_index_query) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+		if(op->iter) {
+			RediSearch_ResultsIteratorFree(op->iter);
+			op->iter = NULL;
+		}
 		if(op->unresolved_filters) {
 			FilterTree_Free(op->unresolved_filters);
 			op->unresolved_filters = NULL;
@@ -389,5 +615,25 @@ static void EdgeIndexScanFree(OpBase *opBase) {
 		FilterTree_Free(op->unresolved_filters);
 		op->unresolved_filters = NULL;
 	}
+
+	if(op->edge_filter) {
+		FilterTree_Free(op->edge_filter);
+		op->edge_filter = NULL;
+	}
+
+	if(op->row_iter) {
+		GxB_MatrixTupleIter_free(&op->row_iter);
+		op->row_iter = NULL;
+	}
+
+	if(op->E) {
+		GrB_Matrix_free(&op->E);
+		op->E = NULL;
+	}
+
+	if(op->keys) {
+		array_free(op->keys);
+		op->keys = NULL;
+	}
 }
 
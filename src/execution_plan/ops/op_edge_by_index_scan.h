@@ -10,6 +10,12 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "redisearch_api.h"
+#include "../../index/index.h"
+
+// number of input records after which the index query is no longer
+// rebuilt for each record, instead its results are materialized once
+// into a matrix over the bound endpoint and the other endpoint
+#define EDGE_INDEX_SCAN_MATERIALIZE_MIN 16
 
 typedef struct {
 	OpBase op;
@@ -28,6 +34,14 @@ typedef struct {
 	AR_ExpNode *current_dest_node_id;   // current destination node id
 	FT_FilterNode *unresolved_filters;  // subset of filter, contains filters that couldn't be resolved by index
 	Record child_record;                // input record in case op ins't a tap
+	FT_FilterNode *edge_filter;         // filter lacking endpoint conditions, NULL if results can't be materialized
+	uint64_t child_count;               // number of input records consumed
+	EdgeIndexKey *keys;                 // materialized index results, sorted by E's position
+	GrB_Matrix E;                       // E[bound endpoint, other endpoint] = first matching key
+	GxB_MatrixTupleIter *row_iter;      // iterator over a row of E
+	uint64_t key_idx;                   // next key to emit for the input record
+	NodeID key_row;                     // bound endpoint of the input record
+	NodeID key_col;                     // other endpoint of the input record, if bound
 } OpEdgeIndexScan;
 
 // creates a new OpEdgeIndexScan operation
@@ -7,9 +7,10 @@
 #include "op_expand_into.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
+#include "../../util/qsort.h"
 
-// default number of records to accumulate before traversing
-#define BATCH_SIZE 16
+#define PAIR_ISLT(a, b) \
+	((a)->src < (b)->src || ((a)->src == (b)->src && (a)->dest < (b)->dest))
 
 // forward declarations
 static OpResult ExpandIntoInit(OpBase *opBase);
@@ -64,8 +65,8 @@ static void _traverse
 	if(op->F == NULL) {
 		// create both filter matrix F and result matrix M
 		size_t required_dim = Graph_RequiredMatrixDim(op->graph);
-		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
-		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
+		RG_Matrix_newScratch(&op->M, GrB_BOOL, op->record_cap, required_dim);
+		RG_Matrix_newScratch(&op->F, GrB_BOOL, op->record_cap, required_dim);
 
 		// prepend the filter matrix to algebraic expression
 		// as the leftmost operand
@@ -80,6 +81,181 @@ static void _traverse
 	AlgebraicExpression_Eval(op->ae, op->M);
 }
 
+// returns true if node 'id' carries each of the labels
+static bool _labeled
+(
+	RG_Matrix *labels,
+	NodeID id
+) {
+	if(labels == NULL) return true;
+
+	bool x;
+	uint label_count = array_len(labels);
+	for(uint i = 0; i < label_count; i++) {
+		GrB_Info info = RG_Matrix_extractElement_BOOL(&x, labels[i], id, id);
+		if(info != GrB_SUCCESS) return false;
+	}
+
+	return true;
+}
+
+// marks pairs [start, end), sharing a source, whose destination
+// is on the source's row of R, by merging the sorted row and destinations
+static void _intersect
+(
+	OpExpandInto *op,
+	uint start,
+	uint end
+) {
+	GrB_Index col;
+	bool depleted = false;
+	ExpandIntoPair *pairs = op->pairs;
+
+	RG_MatrixTupleIter_iterate_row(op->row_iter, pairs[start].src);
+
+	uint i = start;
+	while(i < end) {
+		RG_MatrixTupleIter_next(op->row_iter, NULL, &col, NULL, &depleted);
+		if(depleted) break;
+
+		while(i < end && pairs[i].dest < col) i++;
+		for(; i < end && pairs[i].dest == col; i++) {
+			op->connected[pairs[i].record] = true;
+		}
+	}
+}
+
+// determines which of the batch's records have connected endpoints
+// pairs sharing a source are grouped, a group's pairs are either probed
+// individually or intersected with the source's row if there are many
+static void _probe
+(
+	OpExpandInto *op
+) {
+	uint n = op->record_count;
+
+	for(uint i = 0; i < n; i++) {
+		Record r = op->records[i];
+		op->connected[i] = false;
+		op->pairs[i] = (ExpandIntoPair) {
+			.src    = ENTITY_GET_ID(Record_GetNode(r, op->srcNodeIdx)),
+			.dest   = ENTITY_GET_ID(Record_GetNode(r, op->destNodeIdx)),
+			.record = i
+		};
+	}
+
+	QSORT(ExpandIntoPair, op->pairs, n, PAIR_ISLT);
+
+	uint end;
+	for(uint start = 0; start < n; start = end) {
+		// pairs [start, end) share a source
+		NodeID src = op->pairs[start].src;
+		for(end = start + 1; end < n && op->pairs[end].src == src; end++);
+
+		if(!_labeled(op->src_labels, src)) continue;
+
+		if(end - start >= EXPAND_INTO_INTERSECT_MIN) {
+			_intersect(op, start, end);
+		} else {
+			bool x;
+			for(uint i = start; i < end; i++) {
+				GrB_Info res = RG_Matrix_extractElement_BOOL(&x, op->R, src,
+						op->pairs[i].dest);
+				op->connected[op->pairs[i].record] = (res == GrB_SUCCESS);
+			}
+		}
+	}
+
+	// discard pairs whose destination lacks a label
+	if(op->dest_labels == NULL) return;
+	for(uint i = 0; i < n; i++) {
+		ExpandIntoPair *pair = op->pairs + i;
+		if(op->connected[pair->record] && !_labeled(op->dest_labels, pair->dest)) {
+			op->connected[pair->record] = false;
+		}
+	}
+}
+
+// resolves the edges connecting the batch's endpoints up front
+// rather than looking up each connected pair's edges as it's emitted
+static void _collect_edges
+(
+	OpExpandInto *op
+) {
+	uint n = op->record_count;
+	for(uint i = 0; i < n; i++) {
+		Record r = op->records[i];
+		op->edge_srcs[i]  = ENTITY_GET_ID(Record_GetNode(r, op->srcNodeIdx));
+		op->edge_dests[i] = ENTITY_GET_ID(Record_GetNode(r, op->destNodeIdx));
+	}
+
+	EdgeTraverseCtx_CollectBatch(op->edge_ctx, op->edge_srcs, n,
+			op->edge_dests, n);
+}
+
+// returns true if the optimized 'ae' is a single relation operand,
+// possibly multiplied on either side by label operands, e.g. A * R * B
+// such that a pair's connectivity is determined by probing each operand
+static bool _probeable
+(
+	const AlgebraicExpression *ae
+) {
+	if(ae->type == AL_OPERAND) return !ae->operand.diagonal;
+	if(ae->operation.op != AL_EXP_MUL) return false;
+
+	uint relations = 0;
+	uint child_count = AlgebraicExpression_ChildCount(ae);
+	for(uint i = 0; i < child_count; i++) {
+		const AlgebraicExpression *child = ae->operation.children[i];
+		if(child->type != AL_OPERAND) return false;
+		if(!child->operand.diagonal) relations++;
+	}
+
+	return relations == 1;
+}
+
+// tries to set up probing, sets R to the expression's relation matrix
+// and collects its label matrices, returns false if not applicable
+static bool _setupProbing
+(
+	OpExpandInto *op
+) {
+	if(AlgebraicExpression_ContainsOp(op->ae, AL_EXP_ADD)) return false;
+
+	// the optimized expression is inspected
+	// transposes are pushed down to the relation operand
+	AlgebraicExpression *ae = AlgebraicExpression_Clone(op->ae);
+	AlgebraicExpression_Optimize(&ae);
+	if(!_probeable(ae)) {
+		AlgebraicExpression_Free(ae);
+		return false;
+	}
+
+	AlgebraicExpression_Free(op->ae);
+	op->ae = ae;
+
+	if(ae->type == AL_OPERAND) {
+		op->R = ae->operand.matrix;
+	} else {
+		uint child_count = AlgebraicExpression_ChildCount(ae);
+		for(uint i = 0; i < child_count; i++) {
+			const AlgebraicExpression *child = ae->operation.children[i];
+			if(!child->operand.diagonal) {
+				op->R = child->operand.matrix;
+				continue;
+			}
+
+			// labels preceding R apply to the source, following R to the destination
+			RG_Matrix **labels = (op->R == NULL) ? &op->src_labels : &op->dest_labels;
+			if(*labels == NULL) *labels = array_new(RG_Matrix, 1);
+			array_append(*labels, child->operand.matrix);
+		}
+	}
+
+	RG_MatrixTupleIter_new(&op->row_iter, op->R);
+	return true;
+}
+
 OpBase *NewExpandIntoOp
 (
 	const ExecutionPlan *plan,
@@ -95,9 +271,19 @@ OpBase *NewExpandIntoOp
 	op->graph           =  g;
 	op->records         =  NULL;
 	op->edge_ctx        =  NULL;
-	op->record_cap      =  BATCH_SIZE;
+	op->record_cap      =  UNLIMITED;
+	op->batch_size      =  TRAVERSE_BATCH_SIZE;
 	op->record_count    =  0;
-	op->single_operand  =  false;
+	op->record_idx      =  0;
+	op->probe           =  false;
+	op->R               =  NULL;
+	op->src_labels      =  NULL;
+	op->dest_labels     =  NULL;
+	op->row_iter        =  NULL;
+	op->pairs           =  NULL;
+	op->connected       =  NULL;
+	op->edge_srcs       =  NULL;
+	op->edge_dests      =  NULL;
 
 	// set our Op operations
 	OpBase_Init((OpBase *)op, OPType_EXPAND_INTO, "Expand Into", ExpandIntoInit,
@@ -132,43 +318,29 @@ static OpResult ExpandIntoInit
 	OpExpandInto *op = (OpExpandInto *)opBase;
 
 	// see if we can optimize by avoiding matrix multiplication
-	// if the algebraic expression passed in is just a single operand
-	// there's no need to compute F and perform F*X, we can simply inspect X
-	if(op->ae->type == AL_OPERAND) {
-		// if traversed expression is a single operand e.g. [R]
-		// check if specified operand R exists
-		GraphContext *gc = QueryCtx_GetGraphCtx();
-		const char *label = AlgebraicExpression_Label(op->ae);
-		if(label == NULL) {
-			// matrix isn't associated with a label, use the adjacency matrix
-			op->M = Graph_GetAdjacencyMatrix(op->graph, false);
-		} else {
-			// try to retrieve relationship matrix
-			// it is OK if the relationship doesn't exists, in this case
-			// we won't use this single operand optimization
-			Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_EDGE);
-			if(s != NULL) {
-				// stream records as they enter
-				op->M = Graph_GetRelationMatrix(op->graph, Schema_GetID(s), false);
-			}
-		}
-
-		// if we've managed to set M, restrict record cap to 1
-		// and note the optimization
-		if(op->M) {
-			op->record_cap      =  1;     // record buffer size will be set to 1
-			op->single_operand  =  true;
-		}
-	}
+	// if the algebraic expression is a single relation, possibly
+	// filtered by labels, there's no need to compute F and perform F*X
+	// each pair of endpoints is probed against X directly
+	op->probe = _setupProbing(op);
 
 	// create 'records' within this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// batches start small and grow up to 'record_cap' records
+	op->record_cap = TraverseBatch_Cap(op->record_cap);
+	op->batch_size = TraverseBatch_Initial(op->record_cap);
 
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
 
+	if(op->probe) {
+		op->pairs = rm_malloc(op->record_cap * sizeof(ExpandIntoPair));
+		op->connected = rm_malloc(op->record_cap * sizeof(bool));
+	}
+
+	if(op->edge_ctx != NULL) {
+		op->edge_srcs = rm_malloc(op->record_cap * sizeof(NodeID));
+		op->edge_dests = rm_malloc(op->record_cap * sizeof(NodeID));
+	}
+
 	return OP_OK;
 }
 
@@ -202,34 +374,32 @@ static Record _handoff
 	}
 
 	// find a record where both record's source and destination
-	// nodes are connected M[i,j] is set
-	while(op->record_count) {
-		op->record_count--;
-		r = op->records[op->record_count];
-
-		bool x;
-		uint row;
-
-		// resolve row index
-		if(op->single_operand) {
-			// row idx = src node ID
-			Node *srcNode = Record_GetNode(r, op->srcNodeIdx);
-			row = ENTITY_GET_ID(srcNode);
+	// nodes are connected
+	while(op->record_idx < op->record_count) {
+		uint i = op->record_idx++;
+		r = op->records[i];
+
+		Node    *srcNode   =  Record_GetNode(r, op->srcNodeIdx);
+		Node    *destNode  =  Record_GetNode(r, op->destNodeIdx);
+		NodeID  row        =  ENTITY_GET_ID(srcNode);
+		NodeID  col        =  ENTITY_GET_ID(destNode);
+
+		bool connected;
+		if(op->probe) {
+			connected = op->connected[i];
 		} else {
-			// row idx = record idx
-			row = op->record_count;
+			// M[i,j] is set, where row i = record idx
+			// TODO: in the case of multiple operands ()-[:A]->()-[:B]->()
+			// M is the result of F*A*B, in which case we can switch from
+			// M being a RG_Matrix to a GrB_Matrix, making the extract element
+			// operation a bit cheaper to compute
+			bool x;
+			connected = (RG_Matrix_extractElement_BOOL(&x, op->M, i, col)
+					== GrB_SUCCESS);
 		}
 
-		Node *destNode  =  Record_GetNode(r, op->destNodeIdx);
-		NodeID col      =  ENTITY_GET_ID(destNode);
-		// TODO: in the case of multiple operands ()-[:A]->()-[:B]->()
-		// M is the result of F*A*B, in which case we can switch from
-		// M being a RG_Matrix to a GrB_Matrix, making the extract element
-		// operation a bit cheaper to compute
-		GrB_Info res    =  RG_Matrix_extractElement_BOOL(&x, op->M, row, col);
-
 		// src is not connected to dest, free the current record and continue
-		if(res != GrB_SUCCESS) {
+		if(!connected) {
 			OpBase_DeleteRecord(r);
 			continue;
 		}
@@ -239,9 +409,6 @@ static Record _handoff
 		if(op->edge_ctx != NULL) {
 			op->r = r;
 
-			Node      *srcNode  =  Record_GetNode(r, op->srcNodeIdx);
-			EntityID  row       =  ENTITY_GET_ID(srcNode);
-
 			// collect all edges connecting the current pair of endpoints
 			EdgeTraverseCtx_CollectEdges(op->edge_ctx, row, col);
 			goto emit_edge;
@@ -271,15 +438,15 @@ static Record ExpandIntoConsume
 
 		// validate depleted
 		ASSERT(op->r == NULL);
-		ASSERT(op->record_count == 0);
+		ASSERT(op->record_idx == op->record_count);
 
 		//----------------------------------------------------------------------
 		// get data
 		//----------------------------------------------------------------------
 
-		// ask child operation for at most 'record_cap' records
+		// ask child operation for at most 'batch_size' records
 		int i = 0;
-		for(; i < op->record_cap; i++) {
+		for(; i < op->batch_size; i++) {
 			r = OpBase_Consume(child);
 			// did not manage to get new data, break
 			if(r == NULL) break;
@@ -301,11 +468,20 @@ static Record ExpandIntoConsume
 			op->records[i] = r;
 		}
 		op->record_count = i;
+		op->record_idx = 0;
 
 		// did not managed to produce data, depleted
 		if(op->record_count == 0) return NULL;
 
-		if(!op->single_operand) _traverse(op);
+		// child filled the batch, expect more data
+		if(op->record_count == op->batch_size) {
+			op->batch_size = TraverseBatch_Grow(op->batch_size, op->record_cap);
+		}
+
+		if(op->probe) _probe(op);
+		else _traverse(op);
+
+		if(op->edge_ctx != NULL) _collect_edges(op);
 	}
 
 	return r;
@@ -322,10 +498,12 @@ static OpResult ExpandIntoReset
 		op->r = NULL;
 	}
 
-	for(uint i = 0; i < op->record_count; i++) {
+	for(uint i = op->record_idx; i < op->record_count; i++) {
 		OpBase_DeleteRecord(op->records[i]);
 	}
 	op->record_count = 0;
+	op->record_idx = 0;
+	op->batch_size = TraverseBatch_Initial(op->record_cap);
 
 	if(op->edge_ctx != NULL) EdgeTraverseCtx_Reset(op->edge_ctx);
 
@@ -352,28 +530,62 @@ static void ExpandIntoFree
 	OpExpandInto *op = (OpExpandInto *)ctx;
 
 	if(op->F != NULL) {
-		RG_Matrix_free(&op->F);
+		RG_Matrix_freeScratch(&op->F);
 		op->F = NULL;
 	}
 
-	if(op->ae != NULL) {
-		// M was allocated by us
-		if(op->M != NULL && !op->single_operand) {
-			RG_Matrix_free(&op->M);
-			op->M = NULL;
-		}
+	if(op->M != NULL) {
+		RG_Matrix_freeScratch(&op->M);
+		op->M = NULL;
+	}
 
+	if(op->ae != NULL) {
 		AlgebraicExpression_Free(op->ae);
 		op->ae = NULL;
 	}
 
+	if(op->row_iter != NULL) {
+		RG_MatrixTupleIter_free(&op->row_iter);
+		op->row_iter = NULL;
+	}
+
+	if(op->src_labels != NULL) {
+		array_free(op->src_labels);
+		op->src_labels = NULL;
+	}
+
+	if(op->dest_labels != NULL) {
+		array_free(op->dest_labels);
+		op->dest_labels = NULL;
+	}
+
+	if(op->pairs != NULL) {
+		rm_free(op->pairs);
+		op->pairs = NULL;
+	}
+
+	if(op->connected != NULL) {
+		rm_free(op->connected);
+		op->connected = NULL;
+	}
+
+	if(op->edge_srcs != NULL) {
+		rm_free(op->edge_srcs);
+		op->edge_srcs = NULL;
+	}
+
+	if(op->edge_dests != NULL) {
+		rm_free(op->edge_dests);
+		op->edge_dests = NULL;
+	}
+
 	if(op->edge_ctx != NULL) {
 		EdgeTraverseCtx_Free(op->edge_ctx);
 		op->edge_ctx = NULL;
 	}
 
 	if(op->records != NULL) {
-		for(uint i = 0; i < op->record_count; i++) {
+		for(uint i = op->record_idx; i < op->record_count; i++) {
 			OpBase_DeleteRecord(op->records[i]);
 		}
 		rm_free(op->records);
@@ -11,8 +11,21 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../graph/entities/edge.h"
+#include "../../graph/rg_matrix/rg_matrix_iter.h"
 #include "../../arithmetic/algebraic_expression.h"
 
+// number of batched pairs sharing a source node from which
+// the source's row is intersected with their destinations
+// rather than probing each pair
+#define EXPAND_INTO_INTERSECT_MIN 8
+
+// a batched record's endpoints
+typedef struct {
+	NodeID src;    // source node ID
+	NodeID dest;   // destination node ID
+	uint record;   // record index within the batch
+} ExpandIntoPair;
+
 typedef struct {
 	OpBase op;
 	Graph *graph;
@@ -22,11 +35,21 @@ typedef struct {
 	EdgeTraverseCtx *edge_ctx;  // edge collection data if the edge needs to be set
 	int srcNodeIdx;             // source node index into record
 	int destNodeIdx;            // destination node index into record
-	bool single_operand;        // expression contains a single operand
 	uint record_count;          // number of held records
+	uint record_idx;            // next record to inspect
 	uint record_cap;            // max number of records to process
+	uint batch_size;            // number of records to process next
 	Record *records;            // array of records
 	Record r;                   // currently selected record
+	bool probe;                 // probe pairs rather than multiply matrices
+	RG_Matrix R;                // relation matrix pairs are probed against
+	RG_Matrix *src_labels;      // label matrices sources are checked against
+	RG_Matrix *dest_labels;     // label matrices destinations are checked against
+	RG_MatrixTupleIter *row_iter; // iterator over a row of R
+	ExpandIntoPair *pairs;      // batch's endpoints, sorted
+	bool *connected;            // whether each record's endpoints are connected
+	NodeID *edge_srcs;          // batch's source node IDs, if edges are collected
+	NodeID *edge_dests;         // batch's destination node IDs, if edges are collected
 } OpExpandInto;
 
 OpBase *NewExpandIntoOp
@@ -6,51 +6,285 @@
 
 #include "op_filter.h"
 #include "RG.h"
+#include "../../errors.h"
+#include "../../query_ctx.h"
+#include "../../util/compressed_string.h"
+#include "../../configuration/config.h"
+#include <omp.h>
 
 /* Forward declarations. */
+static OpResult FilterInit(OpBase *opBase);
 static Record FilterConsume(OpBase *opBase);
+static uint FilterConsumeBatch(OpBase *opBase, Record *batch, uint cap);
+static Record FilterConsumeParallel(OpBase *opBase);
+static OpResult FilterReset(OpBase *opBase);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
 
 OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree) {
 	OpFilter *op = rm_malloc(sizeof(OpFilter));
-	op->filterTree = filterTree;
+	op->filterTree       =  filterTree;
+	op->program          =  NULL;
+	op->prefetch         =  false;
+	op->parallel         =  false;
+	op->dop              =  1;
+	op->worker_trees     =  NULL;
+	op->worker_programs  =  NULL;
+	op->morsel           =  NULL;
+	op->passed           =  NULL;
+	op->morsel_len       =  0;
+	op->morsel_idx       =  0;
+
+	// batches are prefetched if the filter reads any attributes
+	rax *attributes = FilterTree_CollectAttributes(filterTree);
+	op->prefetch = raxSize(attributes) > 0;
+	raxFree(attributes);
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
-				NULL, NULL, FilterClone, FilterFree, false, plan);
+	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", FilterInit, FilterConsume,
+				FilterReset, NULL, FilterClone, FilterFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, FilterConsumeBatch);
 
 	return (OpBase *)op;
 }
 
+void FilterOp_EnableParallelism(OpFilter *op) {
+	ASSERT(op != NULL);
+	op->parallel = true;
+}
+
+static OpResult FilterInit(OpBase *opBase) {
+	OpFilter *op = (OpFilter *)opBase;
+
+	// compile filter tree once, programs are reused across resets
+	if(op->program == NULL) op->program = FilterTree_Compile(op->filterTree);
+
+	if(!op->parallel || op->worker_trees != NULL) return OP_OK;
+
+	// degree of parallelism is determined at run-time
+	// such that cached plans respect configuration changes
+	uint64_t dop;
+	Config_Option_get(Config_QUERY_PARALLELISM, &dop);
+	if(dop <= 1) return OP_OK;
+
+	op->dop = dop;
+	op->morsel = rm_malloc(sizeof(Record) * FILTER_MORSEL_SIZE);
+	op->passed = rm_malloc(sizeof(bool) * FILTER_MORSEL_SIZE);
+
+	// each thread evaluates its own copy of the filter tree
+	// as evaluation caches record indices and resolved parameters
+	op->worker_trees = rm_malloc(sizeof(FT_FilterNode *) * dop);
+	op->worker_trees[0] = op->filterTree;
+	for(uint i = 1; i < dop; i++) {
+		op->worker_trees[i] = FilterTree_Clone(op->filterTree);
+	}
+
+	op->worker_programs = rm_malloc(sizeof(FT_Program *) * dop);
+	op->worker_programs[0] = op->program;
+	for(uint i = 1; i < dop; i++) {
+		op->worker_programs[i] = FilterTree_Compile(op->worker_trees[i]);
+	}
+
+	OpBase_UpdateConsume(opBase, FilterConsumeParallel);
+	OpBase_UpdateConsumeBatch(opBase, NULL);
+
+	return OP_OK;
+}
+
 /* FilterConsume next operation
  * returns OP_OK when graph passes filter tree. */
 static Record FilterConsume(OpBase *opBase) {
 	Record r = NULL;
 	OpFilter *filter = (OpFilter *)opBase;
 	OpBase *child = filter->op.children[0];
+	uint64_t rejected = 0;
 
 	while(true) {
 		r = OpBase_Consume(child);
 		if(!r) break;
 
 		/* Pass record through filter tree */
-		if(FilterTree_applyFilters(filter->filterTree, r) == FILTER_PASS) break;
-		else OpBase_DeleteRecord(r);
+		if(FT_Program_Apply(filter->program, r) == FILTER_PASS) break;
+		OpBase_DeleteRecord(r);
+
+		// a selective filter may reject records for long, check for cancellation
+		if((++rejected & QUERY_CANCEL_CHECK_MASK) == 0) QueryCtx_CheckCancelled();
 	}
 
 	return r;
 }
 
+/* FilterConsumeBatch next operation
+ * compacts the child's batch to the records passing the filter tree,
+ * returns 0 only once the child is depleted. */
+static uint FilterConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	uint n = 0;
+	OpFilter *filter = (OpFilter *)opBase;
+	OpBase *child = filter->op.children[0];
+
+	while(n == 0) {
+		uint count = OpBase_ConsumeBatch(child, batch, cap);
+		if(count == 0) break;
+		if(filter->prefetch) Record_PrefetchNodes(batch, count);
+
+		/* Pass each record through filter tree */
+		for(uint i = 0; i < count; i++) {
+			Record r = batch[i];
+			if(FT_Program_Apply(filter->program, r) == FILTER_PASS) batch[n++] = r;
+			else OpBase_DeleteRecord(r);
+		}
+
+		// entire batch was rejected, check for cancellation
+		if(n == 0) QueryCtx_CheckCancelled();
+	}
+
+	return n;
+}
+
+// evaluate filter tree against every record in the morsel
+// using up to op->dop threads, returns false if an error was encountered
+static bool _FilterMorsel(OpFilter *op) {
+	char *err = NULL;
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+
+	// run-time exceptions must not jump out of the parallel region
+	// detach the calling thread's breakpoint for the duration of the region
+	ErrorCtx *error_ctx = ErrorCtx_Get();
+	jmp_buf *breakpoint = error_ctx->breakpoint;
+	error_ctx->breakpoint = NULL;
+
+	#pragma omp parallel num_threads(op->dop)
+	{
+		int tid = omp_get_thread_num();
+		FT_Program *program = op->worker_programs[tid];
+
+		// worker threads share the query context of the calling thread
+		if(tid != 0) QueryCtx_SetTLS(query_ctx);
+
+		#pragma omp for schedule(static)
+		for(uint i = 0; i < op->morsel_len; i++) {
+			op->passed[i] =
+				(FT_Program_Apply(program, op->morsel[i]) == FILTER_PASS);
+
+			if(ErrorCtx_EncounteredError()) {
+				// keep the first error, reported by the calling thread
+				#pragma omp critical
+				{
+					if(err == NULL) err = strdup(ErrorCtx_Get()->error);
+				}
+				ErrorCtx_Clear();
+			}
+		}
+
+		// worker threads' decompressed reads don't outlive the region
+		if(tid != 0) {
+			CompressedString_ReleaseReads();
+			QueryCtx_RemoveFromTLS();
+		}
+	}
+
+	error_ctx->breakpoint = breakpoint;
+
+	if(err != NULL) {
+		ErrorCtx_SetError("%s", err);
+		free(err);
+		return false;
+	}
+
+	return true;
+}
+
+// free records held by the current morsel, starting at morsel_idx
+static void _FilterDiscardMorsel(OpFilter *op) {
+	for(uint i = op->morsel_idx; i < op->morsel_len; i++) {
+		OpBase_DeleteRecord(op->morsel[i]);
+	}
+	op->morsel_len = 0;
+	op->morsel_idx = 0;
+}
+
+/* FilterConsumeParallel next operation
+ * pulls a morsel of records from child, filters it concurrently
+ * and emits passing records in their original order. */
+static Record FilterConsumeParallel(OpBase *opBase) {
+	OpFilter *op = (OpFilter *)opBase;
+	OpBase *child = op->op.children[0];
+
+	while(true) {
+		// emit next passing record from the current morsel
+		while(op->morsel_idx < op->morsel_len) {
+			uint i = op->morsel_idx++;
+			if(op->passed[i]) return op->morsel[i];
+			OpBase_DeleteRecord(op->morsel[i]);
+		}
+
+		// current morsel exhausted, pull the next one
+		QueryCtx_CheckCancelled();
+		op->morsel_idx = 0;
+		op->morsel_len = OpBase_ConsumeBatch(child, op->morsel,
+				FILTER_MORSEL_SIZE);
+		if(op->morsel_len == 0) return NULL;
+
+		if(!_FilterMorsel(op)) {
+			_FilterDiscardMorsel(op);
+			ErrorCtx_RaiseRuntimeException(NULL);
+			return NULL;
+		}
+	}
+}
+
+static OpResult FilterReset(OpBase *opBase) {
+	OpFilter *op = (OpFilter *)opBase;
+	if(op->morsel != NULL) _FilterDiscardMorsel(op);
+	return OP_OK;
+}
+
 static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_FILTER);
 	OpFilter *op = (OpFilter *)opBase;
-	return NewFilterOp(plan, FilterTree_Clone(op->filterTree));
+	OpBase *clone = NewFilterOp(plan, FilterTree_Clone(op->filterTree));
+	((OpFilter *)clone)->parallel = op->parallel;
+	return clone;
 }
 
 /* Frees OpFilter*/
 static void FilterFree(OpBase *ctx) {
 	OpFilter *filter = (OpFilter *)ctx;
+
+	if(filter->morsel) {
+		_FilterDiscardMorsel(filter);
+		rm_free(filter->morsel);
+		filter->morsel = NULL;
+	}
+
+	if(filter->passed) {
+		rm_free(filter->passed);
+		filter->passed = NULL;
+	}
+
+	if(filter->worker_programs) {
+		// worker_programs[0] is the op's own program, freed below
+		for(uint i = 1; i < filter->dop; i++) {
+			FT_Program_Free(filter->worker_programs[i]);
+		}
+		rm_free(filter->worker_programs);
+		filter->worker_programs = NULL;
+	}
+
+	if(filter->program) {
+		FT_Program_Free(filter->program);
+		filter->program = NULL;
+	}
+
+	if(filter->worker_trees) {
+		// worker_trees[0] is the op's own filter tree, freed below
+		for(uint i = 1; i < filter->dop; i++) {
+			FilterTree_Free(filter->worker_trees[i]);
+		}
+		rm_free(filter->worker_trees);
+		filter->worker_trees = NULL;
+	}
+
 	if(filter->filterTree) {
 		FilterTree_Free(filter->filterTree);
 		filter->filterTree = NULL;
@@ -9,13 +9,32 @@
 #include "op.h"
 #include "../execution_plan.h"
 #include "../../filter_tree/filter_tree.h"
+#include "../../filter_tree/ft_program.h"
+
+// number of records pulled from a scan and filtered in parallel at once
+#define FILTER_MORSEL_SIZE 4096
 
 /* Filter
  * filters graph according to where cluase */
 typedef struct {
 	OpBase op;
 	FT_FilterNode *filterTree;
+	FT_Program *program;          // compiled filterTree
+	bool prefetch;                // filter reads node attributes, prefetch nodes
+	bool parallel;                // filter may be evaluated by multiple threads
+	uint dop;                     // number of threads evaluating the filter
+	FT_FilterNode **worker_trees; // filter tree per thread, [0] is filterTree
+	FT_Program **worker_programs; // compiled worker_trees, [0] is program
+	Record *morsel;               // records pulled from child
+	bool *passed;                 // whether morsel[i] passed the filter
+	uint morsel_len;              // number of records in morsel
+	uint morsel_idx;              // next morsel record to inspect
 } OpFilter;
 
 /* Creates a new Filter operation */
 OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree);
+
+/* Mark filter as safe to evaluate concurrently,
+ * in which case the filter's child is consumed in morsels which are
+ * filtered by up to QUERY_PARALLELISM threads. */
+void FilterOp_EnableParallelism(OpFilter *op);
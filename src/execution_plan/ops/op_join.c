@@ -6,29 +6,71 @@
 
 #include "op_join.h"
 #include "RG.h"
+#include "../../errors.h"
 #include "../../query_ctx.h"
+#include "../../util/compressed_string.h"
+#include "../../util/rmalloc.h"
+#include "../../util/thpool/pools.h"
+#include "../../configuration/config.h"
+#include <omp.h>
 
 /* Forward declarations. */
 static Record JoinConsume(OpBase *opBase);
+static Record JoinConsumeParallel(OpBase *opBase);
 static OpResult JoinInit(OpBase *opBase);
 static OpBase *JoinClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void JoinFree(OpBase *opBase);
 
 OpBase *NewJoinOp(const ExecutionPlan *plan) {
 	OpJoin *op = rm_malloc(sizeof(OpJoin));
-	op->stream = NULL;
+	op->stream     = NULL;
+	op->parallel   = false;
+	op->dop        = 1;
+	op->morsels    = NULL;
+	op->counts     = NULL;
+	op->depleted   = NULL;
+	op->morsel_idx = 0;
+	op->mapping    = NULL;
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_JOIN, "Join", JoinInit, JoinConsume, 
-		NULL, NULL, JoinClone, NULL, false, plan);
+	OpBase_Init((OpBase *)op, OPType_JOIN, "Join", JoinInit, JoinConsume,
+		NULL, NULL, JoinClone, JoinFree, false, plan);
 
 	return (OpBase *)op;
 }
 
+void JoinOp_EnableParallelism(OpJoin *op) {
+	ASSERT(op != NULL);
+	op->parallel = true;
+}
+
 static OpResult JoinInit(OpBase *opBase) {
 	OpJoin *op = (OpJoin *)opBase;
 	// Start pulling from first stream.
 	op->streamIdx = 0;
 	op->stream = op->op.children[op->streamIdx];
+
+	if(!op->parallel || op->morsels != NULL) return OP_OK;
+
+	// degree of parallelism is determined at run-time
+	// such that cached plans respect configuration changes
+	uint64_t dop;
+	Config_Option_get(Config_QUERY_PARALLELISM, &dop);
+	if(dop <= 1) return OP_OK;
+
+	// branches are consumed concurrently only while reader threads are idle
+	// under load the threads are better spent on other queries
+	if(ThreadPools_BusyCount() >= ThreadPools_ReadersCount()) return OP_OK;
+
+	uint n = op->op.childCount;
+	op->dop        = MIN(dop, n);
+	op->morsels    = rm_malloc(sizeof(Record) * JOIN_MORSEL_SIZE * n);
+	op->counts     = rm_calloc(n, sizeof(uint));
+	op->depleted   = rm_calloc(n, sizeof(bool));
+	op->morsel_idx = 0;
+
+	OpBase_UpdateConsume(opBase, JoinConsumeParallel);
+
 	return OP_OK;
 }
 
@@ -62,8 +104,181 @@ static Record JoinConsume(OpBase *opBase) {
 	return r;
 }
 
+// pull a morsel of records from branch 'i'
+// executed by a worker thread, returns false if the branch raised an error
+// in which case the error is copied into 'err'
+static bool _JoinPullBranch(OpJoin *op, uint i, char **err) {
+	op->counts[i] = 0;
+
+	// run-time exceptions are caught by the pulling thread
+	if(SET_EXCEPTION_HANDLER()) {
+		ErrorCtx *error_ctx = ErrorCtx_Get();
+		if(error_ctx->error != NULL) *err = strdup(error_ctx->error);
+		ErrorCtx_Clear();
+		return false;
+	}
+
+	Record *morsel = op->morsels + (size_t)i * JOIN_MORSEL_SIZE;
+	uint count = OpBase_ConsumeBatch(op->op.children[i], morsel,
+			JOIN_MORSEL_SIZE);
+
+	op->counts[i] = count;
+	if(count == 0) op->depleted[i] = true;
+	return true;
+}
+
+// free records pulled in the current round yet to be emitted
+static void _JoinDiscardRound(OpJoin *op) {
+	uint n = op->op.childCount;
+	for(uint i = op->streamIdx; i < n; i++) {
+		uint from = (i == op->streamIdx) ? op->morsel_idx : 0;
+		Record *morsel = op->morsels + (size_t)i * JOIN_MORSEL_SIZE;
+		for(uint j = from; j < op->counts[i]; j++) OpBase_DeleteRecord(morsel[j]);
+		op->counts[i] = 0;
+	}
+	op->streamIdx  = 0;
+	op->morsel_idx = 0;
+}
+
+// pull a morsel from every branch which isn't depleted
+// using up to op->dop threads, returns false once all branches are depleted
+static bool _JoinRound(OpJoin *op) {
+	uint n = op->op.childCount;
+	uint live[n];
+	uint live_count = 0;
+	for(uint i = 0; i < n; i++) {
+		op->counts[i] = 0;
+		if(!op->depleted[i]) live[live_count++] = i;
+	}
+
+	op->streamIdx  = 0;
+	op->morsel_idx = 0;
+
+	if(live_count == 0) return false;
+
+	// a single branch left, pulled by the calling thread
+	if(live_count == 1) {
+		uint i = live[0];
+		Record *morsel = op->morsels + (size_t)i * JOIN_MORSEL_SIZE;
+		op->counts[i] = OpBase_ConsumeBatch(op->op.children[i], morsel,
+				JOIN_MORSEL_SIZE);
+		if(op->counts[i] == 0) op->depleted[i] = true;
+		return true;
+	}
+
+	bool failed = false;
+	char *err = NULL;
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+
+	// run-time exceptions must not jump out of the parallel region
+	// detach the calling thread's breakpoint for the duration of the region
+	ErrorCtx *error_ctx = ErrorCtx_Get();
+	jmp_buf *breakpoint = error_ctx->breakpoint;
+	error_ctx->breakpoint = NULL;
+
+	#pragma omp parallel num_threads(MIN(op->dop, live_count))
+	{
+		int tid = omp_get_thread_num();
+
+		// worker threads share the query context of the calling thread
+		if(tid != 0) QueryCtx_SetTLS(query_ctx);
+
+		#pragma omp for schedule(dynamic, 1)
+		for(uint j = 0; j < live_count; j++) {
+			char *branch_err = NULL;
+			if(!_JoinPullBranch(op, live[j], &branch_err)) {
+				// keep the first error, reported by the calling thread
+				#pragma omp critical
+				{
+					failed = true;
+					if(err == NULL) err = branch_err;
+					else free(branch_err);
+				}
+			}
+		}
+
+		// release the exception handler set by _JoinPullBranch
+		ErrorCtx_Clear();
+		// worker threads' decompressed reads don't outlive the region
+		if(tid != 0) {
+			CompressedString_ReleaseReads();
+			QueryCtx_RemoveFromTLS();
+		}
+	}
+
+	error_ctx->breakpoint = breakpoint;
+
+	if(failed) {
+		_JoinDiscardRound(op);
+		if(err != NULL) {
+			ErrorCtx_SetError("%s", err);
+			free(err);
+		}
+		ErrorCtx_RaiseRuntimeException(NULL);
+	}
+
+	return true;
+}
+
+/* JoinConsumeParallel next operation
+ * emits the records pulled in the current round branch after branch
+ * and pulls the next round once they're all emitted.
+ * as records of different branches interleave, the ResultSet column mapping
+ * is updated whenever the emitted record's mapping differs from its
+ * predecessor's. */
+static Record JoinConsumeParallel(OpBase *opBase) {
+	OpJoin *op = (OpJoin *)opBase;
+	uint n = op->op.childCount;
+
+	while(true) {
+		while(op->streamIdx < n) {
+			uint i = op->streamIdx;
+			if(op->morsel_idx < op->counts[i]) {
+				Record *morsel = op->morsels + (size_t)i * JOIN_MORSEL_SIZE;
+				Record r = morsel[op->morsel_idx++];
+
+				rax *mapping = Record_GetMappings(r);
+				if(mapping != op->mapping) {
+					ResultSet_MapProjection(QueryCtx_GetResultSet(), r);
+					op->mapping = mapping;
+				}
+				return r;
+			}
+
+			op->streamIdx++;
+			op->morsel_idx = 0;
+		}
+
+		// current round exhausted, pull the next one
+		QueryCtx_CheckCancelled();
+		if(!_JoinRound(op)) return NULL;
+	}
+}
+
 static inline OpBase *JoinClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_JOIN);
-	return NewJoinOp(plan);
+	OpJoin *op = (OpJoin *)opBase;
+	OpBase *clone = NewJoinOp(plan);
+	((OpJoin *)clone)->parallel = op->parallel;
+	return clone;
 }
 
+static void JoinFree(OpBase *opBase) {
+	OpJoin *op = (OpJoin *)opBase;
+
+	if(op->morsels != NULL) {
+		_JoinDiscardRound(op);
+		rm_free(op->morsels);
+		op->morsels = NULL;
+	}
+
+	if(op->counts != NULL) {
+		rm_free(op->counts);
+		op->counts = NULL;
+	}
+
+	if(op->depleted != NULL) {
+		rm_free(op->depleted);
+		op->depleted = NULL;
+	}
+}
@@ -9,10 +9,25 @@
 #include "op.h"
 #include "../execution_plan.h"
 
+// number of records pulled from each branch per round of parallel execution
+#define JOIN_MORSEL_SIZE 1024
+
 typedef struct {
 	OpBase op;
-    OpBase *stream;     // Current stream to pull from.
-    int streamIdx;      // Current stream index.
+	OpBase *stream;     // Current stream to pull from.
+	int streamIdx;      // Current stream index.
+	bool parallel;      // branches may be consumed concurrently
+	uint dop;           // number of threads consuming branches
+	Record *morsels;    // records pulled from each branch in the current round
+	uint *counts;       // number of records pulled from each branch
+	uint morsel_idx;    // next record to emit from the current branch's morsel
+	bool *depleted;     // whether each branch has been depleted
+	rax *mapping;       // mapping of the last emitted record
 } OpJoin;
 
 OpBase *NewJoinOp(const ExecutionPlan *plan);
+
+/* Mark join's branches as safe to consume concurrently,
+ * in which case up to QUERY_PARALLELISM threads pull a morsel of records
+ * from every branch in rounds, records of different branches interleave. */
+void JoinOp_EnableParallelism(OpJoin *op);
@@ -0,0 +1,424 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "op_leapfrog_join.h"
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../../util/strcmp.h"
+#include "../../query_ctx.h"
+
+// forward declarations
+static OpResult LeapfrogJoinInit(OpBase *opBase);
+static Record LeapfrogJoinConsume(OpBase *opBase);
+static OpResult LeapfrogJoinReset(OpBase *opBase);
+static OpBase *LeapfrogJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void LeapfrogJoinFree(OpBase *opBase);
+
+// string representation of operation
+// e.g. Leapfrog Join | (b)->(c), (a)<-(c)
+static void LeapfrogJoinToString
+(
+	const OpBase *ctx,
+	sds *buf
+) {
+	const OpLeapfrogJoin *op = (const OpLeapfrogJoin *)ctx;
+
+	*buf = sdscatprintf(*buf, "%s | ", ctx->name);
+	for(uint i = 0; i < array_len(op->exps); i++) {
+		AlgebraicExpression *ae = op->exps[i];
+		if(i > 0) *buf = sdscatprintf(*buf, ", ");
+		*buf = sdscatprintf(*buf, "(%s)->(%s)", AlgebraicExpression_Src(ae),
+				AlgebraicExpression_Dest(ae));
+	}
+}
+
+// returns the relationship operand of 'ae' skipping over transpose operations
+// NULL if 'ae' isn't a, possibly transposed, relationship operand
+static AlgebraicExpression *_relation_operand
+(
+	AlgebraicExpression *ae,
+	bool *transposed
+) {
+	*transposed = false;
+	while(ae->type == AL_OPERATION && ae->operation.op == AL_EXP_TRANSPOSE) {
+		ASSERT(AlgebraicExpression_ChildCount(ae) == 1);
+		*transposed = !*transposed;
+		ae = ae->operation.children[0];
+	}
+
+	if(ae->type != AL_OPERAND || ae->operand.diagonal) return NULL;
+	return ae;
+}
+
+bool LeapfrogJoin_SupportedExpression
+(
+	AlgebraicExpression *ae,
+	bool allow_label
+) {
+	ASSERT(ae != NULL);
+
+	// edges aren't collected
+	if(AlgebraicExpression_Edge(ae) != NULL) return false;
+
+	bool transposed;
+	if(_relation_operand(ae, &transposed) != NULL) return true;
+	if(!allow_label) return false;
+
+	// relationship operand followed by a label operand, e.g. R * L
+	if(ae->type != AL_OPERATION || ae->operation.op != AL_EXP_MUL ||
+	   AlgebraicExpression_ChildCount(ae) != 2) {
+		return false;
+	}
+
+	AlgebraicExpression *l = ae->operation.children[1];
+	return _relation_operand(ae->operation.children[0], &transposed) != NULL &&
+		l->type == AL_OPERAND && l->operand.diagonal;
+}
+
+OpBase *NewLeapfrogJoinOp
+(
+	const ExecutionPlan *plan,
+	Graph *g,
+	AlgebraicExpression **exps
+) {
+	ASSERT(exps != NULL);
+	ASSERT(array_len(exps) > 1);
+
+	OpLeapfrogJoin *op = rm_calloc(1, sizeof(OpLeapfrogJoin));
+
+	op->graph       =  g;
+	op->exps        =  exps;
+	op->alias       =  AlgebraicExpression_Dest(exps[0]);
+	op->side_count  =  array_len(exps);
+	op->sides       =  rm_calloc(op->side_count, sizeof(LeapfrogSide));
+
+	// set our Op operations
+	OpBase_Init((OpBase *)op, OPType_LEAPFROG_JOIN, "Leapfrog Join",
+			LeapfrogJoinInit, LeapfrogJoinConsume, LeapfrogJoinReset,
+			LeapfrogJoinToString, LeapfrogJoinClone, LeapfrogJoinFree, false,
+			plan);
+
+	AlgebraicExpression *rel;
+	bool transposed;
+
+	// resolved node label, e.g. R * L
+	rel = _relation_operand(exps[0], &transposed);
+	if(rel == NULL) {
+		op->label = AlgebraicExpression_Label(exps[0]->operation.children[1]);
+		rel = _relation_operand(exps[0]->operation.children[0], &transposed);
+	}
+
+	for(uint i = 0; i < op->side_count; i++) {
+		AlgebraicExpression *ae = exps[i];
+		ASSERT(LeapfrogJoin_SupportedExpression(ae, i == 0));
+
+		LeapfrogSide *side = op->sides + i;
+		if(i > 0) rel = _relation_operand(ae, &transposed);
+
+		const char *src  = AlgebraicExpression_Src(ae);
+		const char *dest = AlgebraicExpression_Dest(ae);
+		const char *bound = src;
+
+		// expression leads to the resolved node, ae[bound, alias]
+		// otherwise the resolved node is the expression's source
+		// and the expression is traversed backwards, ae'[bound, alias]
+		if(RG_STRCMP(dest, op->alias) != 0) {
+			ASSERT(RG_STRCMP(src, op->alias) == 0);
+			bound = dest;
+			transposed = !transposed;
+		}
+
+		side->label       =  AlgebraicExpression_Label(rel);
+		side->transposed  =  transposed;
+
+		bool aware = OpBase_Aware((OpBase *)op, bound, &side->bound_idx);
+		ASSERT(aware);
+		UNUSED(aware);
+	}
+
+	op->nodeIdx = OpBase_Modifies((OpBase *)op, op->alias);
+
+	return (OpBase *)op;
+}
+
+static OpResult LeapfrogJoinInit
+(
+	OpBase *opBase
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)opBase;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// resolve matrices, a missing relationship type or label
+	// means the join can't produce any records
+	for(uint i = 0; i < op->side_count; i++) {
+		LeapfrogSide *side = op->sides + i;
+		if(side->label == NULL) {
+			side->M = Graph_GetAdjacencyMatrix(op->graph, side->transposed);
+			continue;
+		}
+
+		Schema *s = GraphContext_GetSchema(gc, side->label, SCHEMA_EDGE);
+		if(s == NULL) {
+			op->depleted = true;
+			return OP_OK;
+		}
+		side->M = Graph_GetRelationMatrix(op->graph, Schema_GetID(s),
+				side->transposed);
+	}
+
+	if(op->label != NULL) {
+		Schema *s = GraphContext_GetSchema(gc, op->label, SCHEMA_NODE);
+		if(s == NULL) {
+			op->depleted = true;
+			return OP_OK;
+		}
+		op->L = Graph_GetLabelMatrix(op->graph, Schema_GetID(s));
+	}
+
+	RG_MatrixTupleIter_new(&op->iter, op->sides[0].M);
+
+	return OP_OK;
+}
+
+// load the sorted columns of 'row' into 'side'
+// the matrix iterator produces columns in order, pending changes included
+static void _load_row
+(
+	OpLeapfrogJoin *op,
+	LeapfrogSide *side,
+	GrB_Index row
+) {
+	GrB_Index col;
+	bool depleted = false;
+
+	side->pos = 0;
+	side->row_count = 0;
+
+	RG_MatrixTupleIter_reuse(op->iter, side->M);
+	RG_MatrixTupleIter_iterate_row(op->iter, row);
+
+	while(true) {
+		RG_MatrixTupleIter_next(op->iter, NULL, &col, NULL, &depleted);
+		if(depleted) break;
+
+		if(side->row_count == side->row_cap) {
+			side->row_cap = (side->row_cap == 0) ? 64 : side->row_cap * 2;
+			side->row = rm_realloc(side->row, side->row_cap * sizeof(GrB_Index));
+		}
+
+		ASSERT(side->row_count == 0 || side->row[side->row_count - 1] < col);
+		side->row[side->row_count++] = col;
+	}
+}
+
+// advance 'side' to its first column >= 'target'
+// gallops forward from the current position then binary searches
+static inline uint _seek
+(
+	const LeapfrogSide *side,
+	GrB_Index target
+) {
+	const GrB_Index *row = side->row;
+	uint n = side->row_count;
+	uint lo = side->pos;
+
+	if(lo >= n || row[lo] >= target) return lo;
+
+	// row[lo] < target, find hi such that row[hi] >= target
+	uint step = 1;
+	uint hi = lo + 1;
+	while(hi < n && row[hi] < target) {
+		lo = hi;
+		step <<= 1;
+		hi = lo + step;
+	}
+	if(hi > n) hi = n;
+
+	// first position within (lo, hi] holding a column >= target
+	lo++;
+	while(lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if(row[mid] < target) lo = mid + 1;
+		else hi = mid;
+	}
+
+	return lo;
+}
+
+// intersect the rows of all sides into 'nodes'
+static void _intersect
+(
+	OpLeapfrogJoin *op
+) {
+	op->node_pos = 0;
+	op->node_count = 0;
+
+	for(uint i = 0; i < op->side_count; i++) {
+		if(op->sides[i].row_count == 0) return;
+	}
+
+	GrB_Index target = op->sides[0].row[0];
+	while(true) {
+		// seek every side to target, restart at the largest column found
+		bool aligned = true;
+		for(uint i = 0; i < op->side_count; i++) {
+			LeapfrogSide *side = op->sides + i;
+			side->pos = _seek(side, target);
+			if(side->pos == side->row_count) return;
+
+			GrB_Index col = side->row[side->pos];
+			if(col != target) {
+				target = col;
+				aligned = false;
+			}
+		}
+
+		if(!aligned) continue;
+
+		// all sides agree on target
+		bool x;
+		if(op->L == NULL ||
+		   RG_Matrix_extractElement_BOOL(&x, op->L, target, target) ==
+		   GrB_SUCCESS) {
+			if(op->node_count == op->node_cap) {
+				op->node_cap = (op->node_cap == 0) ? 64 : op->node_cap * 2;
+				op->nodes = rm_realloc(op->nodes,
+						op->node_cap * sizeof(GrB_Index));
+			}
+			op->nodes[op->node_count++] = target;
+		}
+		target++;
+	}
+}
+
+static Record LeapfrogJoinConsume
+(
+	OpBase *opBase
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)opBase;
+	OpBase *child = op->op.children[0];
+
+	if(op->depleted) return NULL;
+
+	while(op->node_pos == op->node_count) {
+		if(op->r != NULL) {
+			OpBase_DeleteRecord(op->r);
+			op->r = NULL;
+		}
+
+		Record r = OpBase_Consume(child);
+		if(r == NULL) return NULL;
+
+		// load the row of each bound node
+		bool resolved = true;
+		for(uint i = 0; i < op->side_count && resolved; i++) {
+			LeapfrogSide *side = op->sides + i;
+			Node *n = Record_GetNode(r, side->bound_idx);
+			// bound node may be missing, e.g. a failed OPTIONAL MATCH
+			if(n == NULL) resolved = false;
+			else _load_row(op, side, ENTITY_GET_ID(n));
+		}
+
+		if(!resolved) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
+
+		Record_PersistScalars(r);
+		op->r = r;
+		_intersect(op);
+	}
+
+	// hand off the current record along with its last node
+	Record r;
+	GrB_Index id = op->nodes[op->node_pos++];
+	if(op->node_pos == op->node_count) {
+		r = op->r;
+		op->r = NULL;
+	} else {
+		r = OpBase_CloneRecord(op->r);
+	}
+
+	Node n = GE_NEW_NODE();
+	Graph_GetNode(op->graph, id, &n);
+	Record_AddNode(r, op->nodeIdx, n);
+
+	return r;
+}
+
+static OpResult LeapfrogJoinReset
+(
+	OpBase *opBase
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)opBase;
+
+	if(op->r != NULL) {
+		OpBase_DeleteRecord(op->r);
+		op->r = NULL;
+	}
+
+	op->node_pos = 0;
+	op->node_count = 0;
+
+	return OP_OK;
+}
+
+static OpBase *LeapfrogJoinClone
+(
+	const ExecutionPlan *plan,
+	const OpBase *opBase
+) {
+	ASSERT(opBase->type == OPType_LEAPFROG_JOIN);
+	const OpLeapfrogJoin *op = (const OpLeapfrogJoin *)opBase;
+
+	uint exp_count = array_len(op->exps);
+	AlgebraicExpression **exps = array_new(AlgebraicExpression *, exp_count);
+	for(uint i = 0; i < exp_count; i++) {
+		array_append(exps, AlgebraicExpression_Clone(op->exps[i]));
+	}
+
+	return NewLeapfrogJoinOp(plan, QueryCtx_GetGraph(), exps);
+}
+
+static void LeapfrogJoinFree
+(
+	OpBase *opBase
+) {
+	OpLeapfrogJoin *op = (OpLeapfrogJoin *)opBase;
+
+	if(op->r != NULL) {
+		OpBase_DeleteRecord(op->r);
+		op->r = NULL;
+	}
+
+	if(op->iter != NULL) {
+		RG_MatrixTupleIter_free(&op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->sides != NULL) {
+		for(uint i = 0; i < op->side_count; i++) {
+			if(op->sides[i].row != NULL) rm_free(op->sides[i].row);
+		}
+		rm_free(op->sides);
+		op->sides = NULL;
+	}
+
+	if(op->nodes != NULL) {
+		rm_free(op->nodes);
+		op->nodes = NULL;
+	}
+
+	if(op->exps != NULL) {
+		uint exp_count = array_len(op->exps);
+		for(uint i = 0; i < exp_count; i++) {
+			AlgebraicExpression_Free(op->exps[i]);
+		}
+		array_free(op->exps);
+		op->exps = NULL;
+	}
+}
+
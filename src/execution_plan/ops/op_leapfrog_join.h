@@ -0,0 +1,74 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../graph/rg_matrix/rg_matrix_iter.h"
+#include "../../arithmetic/algebraic_expression.h"
+
+// a single constraint on the node resolved by the join
+// the node must be a column within row 'bound' of 'M'
+typedef struct {
+	const char *label;     // relationship type, NULL for any type
+	bool transposed;       // traverse the transposed relationship matrix
+	int bound_idx;         // bound node index into record
+	RG_Matrix M;           // relationship matrix
+	GrB_Index *row;        // sorted columns of the current row
+	uint row_count;        // number of columns in 'row'
+	uint row_cap;          // allocated size of 'row'
+	uint pos;              // position within 'row'
+} LeapfrogSide;
+
+// resolves a node connected to multiple bound nodes
+// by intersecting the adjacency rows of the bound nodes
+//
+// MATCH (a)-[:F]->(b)-[:F]->(c)-[:F]->(a)
+// rather than traversing from 'b' to every 'c' and then checking each 'c'
+// for a connection to 'a', 'c' is resolved by intersecting
+// the outgoing row of 'b' with the incoming row of 'a'
+// such that partial matches which do not close the cycle are never produced
+typedef struct {
+	OpBase op;
+	Graph *graph;
+	AlgebraicExpression **exps;  // expressions resolving 'alias'
+	const char *alias;           // resolved node alias
+	const char *label;           // [optional] resolved node label
+	RG_Matrix L;                 // label matrix of 'label'
+	int nodeIdx;                 // resolved node index into record
+	LeapfrogSide *sides;         // constraints, one per expression
+	uint side_count;             // number of constraints
+	RG_MatrixTupleIter *iter;    // iterator over relationship rows
+	bool depleted;               // a relationship or label doesn't exist
+	GrB_Index *nodes;            // nodes matching the current record
+	uint node_count;             // number of nodes in 'nodes'
+	uint node_cap;               // allocated size of 'nodes'
+	uint node_pos;               // next node to emit
+	Record r;                    // current record
+} OpLeapfrogJoin;
+
+// returns true if 'ae' can be evaluated by a leapfrog join
+// 'ae' must be a single relationship operand, possibly transposed,
+// if 'allow_label' is set the operand may be followed by a label operand
+bool LeapfrogJoin_SupportedExpression
+(
+	AlgebraicExpression *ae,
+	bool allow_label
+);
+
+// creates a new leapfrog join operation
+// exps[0] is the traversal resolving 'alias' from a bound node
+// the remaining expressions connect 'alias' to additional bound nodes
+// takes ownership over 'exps'
+OpBase *NewLeapfrogJoinOp
+(
+	const ExecutionPlan *plan,
+	Graph *g,
+	AlgebraicExpression **exps
+);
+
@@ -11,6 +11,8 @@
 #include "../../query_ctx.h"
 #include "../../schema/schema.h"
 #include "../../util/rax_extensions.h"
+#include "../../util/range/string_range.h"
+#include "../../util/range/numeric_range.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
@@ -42,6 +44,146 @@ static void _UpdateProperties(PendingUpdateCtx **node_pending_updates,
 	}
 }
 
+//------------------------------------------------------------------------------
+// Index probe
+//------------------------------------------------------------------------------
+
+// MERGE (n:User {id: r.id}) is matched by an index scan over the bound record
+// rather than pulling each bound record through the Match stream,
+// rebuilding the index query for every record, the key is evaluated
+// and looked up in the native index directly
+// lookups are cached for the duration of the batch such that
+// repeated keys are probed once
+static void _InitIndexProbe(OpMerge *op) {
+	if(op->bound_variable_stream == NULL) return;
+	if(op->match_stream->type != OPType_NODE_BY_INDEX_SCAN) return;
+
+	IndexScan *scan = (IndexScan *)op->match_stream;
+	if(scan->native == NULL) return;
+	if(scan->op.childCount != 1) return;
+	if(scan->op.children[0] != (OpBase *)op->match_argument_tap) return;
+
+	// filter must be a single equality on an indexed attribute
+	FT_FilterNode *filter = scan->filter;
+	if(filter->t != FT_N_PRED || filter->pred.op != OP_EQUAL) return;
+
+	char *attr_name;
+	AR_ExpNode *lhs = filter->pred.lhs;
+	if(!AR_EXP_IsAttribute(lhs, &attr_name)) return;
+	if(!AR_EXP_IsVariadic(lhs->op.children[0])) return;
+	if(strcmp(lhs->op.children[0]->operand.variadic.entity_alias,
+			  scan->n.alias) != 0) return;
+
+	// key must be computable from the bound record alone
+	rax *entities = raxNew();
+	AR_EXP_CollectEntities(filter->pred.rhs, entities);
+	bool self_ref = raxFind(entities, (unsigned char *)scan->n.alias,
+			strlen(scan->n.alias)) != raxNotFound;
+	raxFree(entities);
+	if(self_ref) return;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Attribute_ID attr = GraphContext_GetAttributeID(gc, attr_name);
+	if(attr == ATTRIBUTE_NOTFOUND) return;
+
+	bool indexed = false;
+	const Attribute_ID *attrs = scan->native->attrs;
+	uint attr_count = NativeIndex_AttributeCount(scan->native);
+	for(uint i = 0; i < attr_count && !indexed; i++) indexed = (attrs[i] == attr);
+	if(!indexed) return;
+
+	op->index_probe  = scan;
+	op->probe_key    = filter->pred.rhs;
+	op->probe_attr   = attr;
+	op->probe_unique = scan->unique;
+}
+
+// collect the IDs of all nodes indexed under 'key'
+// a uniquely constrained key is held by at most one node
+static EntityID *_LookupKey(OpMerge *op, SIValue key) {
+	NativeIndexIterator *it;
+	NativeIndex *idx = op->index_probe->native;
+
+	if(SI_TYPE(key) & SI_NUMERIC) {
+		NumericRange *range = NumericRange_New();
+		NumericRange_TightenRange(range, OP_EQUAL, SI_GET_NUMERIC(key));
+		it = NativeIndex_NumericRange(idx, op->probe_attr, range);
+		NumericRange_Free(range);
+	} else {
+		StringRange *range = StringRange_New();
+		StringRange_TightenRange(range, OP_EQUAL, key.stringval);
+		it = NativeIndex_StringRange(idx, op->probe_attr, range);
+		StringRange_Free(range);
+	}
+
+	const EntityID *id;
+	EntityID *ids = array_new(EntityID, 1);
+	while((id = NativeIndexIterator_Next(it)) != NULL) {
+		array_append(ids, *id);
+		if(op->probe_unique) break;
+	}
+	NativeIndexIterator_Free(it);
+
+	return ids;
+}
+
+static void _FreeProbe(void *ids) {
+	array_free(ids);
+}
+
+// match 'r' by probing the index with its key
+// returns false if the key can't be looked up by the index
+// in which case 'r' should be resolved by the Match stream
+// otherwise 'matches' is set to the number of matched records
+static bool _ProbeIndex(OpMerge *op, rax *num_probes, rax *str_probes,
+		Record r, uint *matches) {
+	SIValue key = AR_EXP_Evaluate(op->probe_key, r);
+	if(!(SI_TYPE(key) & (SI_NUMERIC | T_STRING)) ||
+	   !NativeIndex_SupportedValue(key)) {
+		SIValue_Free(key);
+		return false;
+	}
+
+	// numeric keys are cached by their double representation
+	// matching the encoding of the native index
+	rax *probes = str_probes;
+	unsigned char *k = (unsigned char *)key.stringval;
+	size_t k_len = 0;
+	double d;
+	if(SI_TYPE(key) & SI_NUMERIC) {
+		d = SI_GET_NUMERIC(key);
+		probes = num_probes;
+		k = (unsigned char *)&d;
+		k_len = sizeof(double);
+	} else {
+		k_len = strlen(key.stringval);
+	}
+
+	EntityID *ids = raxFind(probes, k, k_len);
+	if(ids == raxNotFound) {
+		ids = _LookupKey(op, key);
+		raxInsert(probes, k, k_len, ids, NULL);
+	}
+	SIValue_Free(key);
+
+	Graph *g = op->index_probe->g;
+	uint node_idx = op->index_probe->nodeRecIdx;
+	uint count = array_len(ids);
+	for(uint i = 0; i < count; i++) {
+		Node n = GE_NEW_NODE();
+		int res = Graph_GetNode(g, ids[i], &n);
+		ASSERT(res != 0);
+		UNUSED(res);
+
+		Record match = OpBase_CloneRecord(r);
+		Record_AddNode(match, node_idx, n);
+		array_append(op->output_records, match);
+	}
+
+	*matches = count;
+	return true;
+}
+
 //------------------------------------------------------------------------------
 // Merge logic
 //------------------------------------------------------------------------------
@@ -73,6 +215,8 @@ OpBase *NewMergeOp(const ExecutionPlan *plan, rax *on_match, rax *on_create) {
 	op->on_create             =  on_create;
 	op->node_pending_updates  =  NULL;
 	op->edge_pending_updates  =  NULL;
+	op->index_probe           =  NULL;
+	op->probe_key             =  NULL;
 	
 	// set our Op operations
 	OpBase_Init((OpBase *)op, OPType_MERGE, "Merge", MergeInit, MergeConsume, NULL, NULL, MergeClone,
@@ -170,6 +314,9 @@ static OpResult MergeInit(OpBase *opBase) {
 	// Set up an array to store records produced by the bound variable stream.
 	op->input_records = array_new(Record, 1);
 
+	// see if the Match stream can be resolved by probing an index directly
+	_InitIndexProbe(op);
+
 	return OP_OK;
 }
 
@@ -209,6 +356,12 @@ static Record MergeConsume(OpBase *opBase) {
 	uint  match_count          =  0;
 	bool  reading_matches      =  true;
 	bool  must_create_records  =  false;
+	rax   *num_probes          =  NULL;  // cached numeric key lookups
+	rax   *str_probes          =  NULL;  // cached string key lookups
+	if(op->index_probe) {
+		num_probes = raxNew();
+		str_probes = raxNew();
+	}
 	// match mode: attempt to resolve the pattern for every record from
 	// the bound variable stream, or once if we have no bound variables
 	while(reading_matches) {
@@ -220,22 +373,34 @@ static Record MergeConsume(OpBase *opBase) {
 
 			// pull a new input record
 			lhs_record = array_pop(op->input_records);
-			// propagate record to the top of the Match stream
-			// (must clone the Record, as it will be freed in the Match stream)
-			Argument_AddRecord(op->match_argument_tap, OpBase_CloneRecord(lhs_record));
 		} else {
 			// this loop only executes once if we don't have input records resolving bound variables
 			reading_matches = false;
 		}
 
-		Record rhs_record;
+		uint probed = 0;
 		bool should_create_pattern = true;
-		// retrieve Records from the Match stream until it's depleted
-		while((rhs_record = _pullFromStream(op->match_stream))) {
-			// pattern was successfully matched
-			should_create_pattern = false;
-			array_append(op->output_records, rhs_record);
-			match_count++;
+		if(op->index_probe && lhs_record &&
+		   _ProbeIndex(op, num_probes, str_probes, lhs_record, &probed)) {
+			// pattern resolved by index lookup
+			should_create_pattern = (probed == 0);
+			match_count += probed;
+		} else {
+			// propagate record to the top of the Match stream
+			// (must clone the Record, as it will be freed in the Match stream)
+			if(lhs_record) {
+				Argument_AddRecord(op->match_argument_tap,
+						OpBase_CloneRecord(lhs_record));
+			}
+
+			Record rhs_record;
+			// retrieve Records from the Match stream until it's depleted
+			while((rhs_record = _pullFromStream(op->match_stream))) {
+				// pattern was successfully matched
+				should_create_pattern = false;
+				array_append(op->output_records, rhs_record);
+				match_count++;
+			}
 		}
 
 		if(should_create_pattern) {
@@ -262,6 +427,11 @@ static Record MergeConsume(OpBase *opBase) {
 	// compute updates and create
 	//--------------------------------------------------------------------------
 
+	if(op->index_probe) {
+		raxFreeWithCallback(num_probes, _FreeProbe);
+		raxFreeWithCallback(str_probes, _FreeProbe);
+	}
+
 	// explicitly free the read streams in case either holds an index read lock
 	if(op->bound_variable_stream) OpBase_PropagateFree(op->bound_variable_stream);
 	OpBase_PropagateFree(op->match_stream);
@@ -372,6 +542,8 @@ static void MergeFree(OpBase *opBase) {
 		}
 		array_free(op->edge_pending_updates);
 		op->edge_pending_updates  =  NULL;
+	op->index_probe           =  NULL;
+	op->probe_key             =  NULL;
 	}
 
 	if(op->on_match) {
@@ -8,6 +8,7 @@
 
 #include "op.h"
 #include "op_argument.h"
+#include "op_node_by_index_scan.h"
 #include "../execution_plan.h"
 #include "shared/update_functions.h"
 #include "../../resultset/resultset_statistics.h"
@@ -31,6 +32,10 @@ typedef struct {
 	PendingUpdateCtx *node_pending_updates;  // Pending updates to apply, generated 
 	PendingUpdateCtx *edge_pending_updates;  // Pending updates to apply, generated 
 	ResultSetStatistics *stats;              // Required for tracking statistics updates in ON MATCH.
+	IndexScan *index_probe;                  // [optional] Index scan resolving the Match stream.
+	AR_ExpNode *probe_key;                   // Key looked up in the index, evaluated against bound records.
+	Attribute_ID probe_attr;                 // Indexed attribute the key is looked up by.
+	bool probe_unique;                       // Probed attribute is uniquely constrained.
 } OpMerge;
 
 OpBase *NewMergeOp(const ExecutionPlan *plan, rax *on_match, rax *on_create);
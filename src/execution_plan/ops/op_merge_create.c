@@ -165,17 +165,17 @@ static bool _CreateEntities(OpMergeCreate *op, Record r) {
 		/* Update the hash code with this entity, an edge is represented by its
 		 * relation, properties and nodes.
 		 * Note that unbounded nodes were already presented to the hash.
-		 * Incase node has its internal entity set, this means the node has been retrieved from the graph
+		 * Incase node has its ID set, this means the node has been retrieved from the graph
 		 * i.e. bounded node. */
 		_IncrementalHashEntity(op->hash_state, e->relation, converted_properties);
-		if(src_node->entity != NULL) {
+		if(ENTITY_GET_ID(src_node) != INVALID_ENTITY_ID) {
 			EntityID id = ENTITY_GET_ID(src_node);
 			void *data = &id;
 			size_t len = sizeof(id);
 			res = XXH64_update(op->hash_state, data, len);
 			ASSERT(res != XXH_ERROR);
 		}
-		if(dest_node->entity != NULL) {
+		if(ENTITY_GET_ID(dest_node) != INVALID_ENTITY_ID) {
 			EntityID id = ENTITY_GET_ID(dest_node);
 			void *data = &id;
 			size_t len = sizeof(id);
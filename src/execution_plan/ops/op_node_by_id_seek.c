@@ -8,11 +8,18 @@
 #include "RG.h"
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
+#include "../../util/arr.h"
+#include "../../util/qsort.h"
+#include "../../datatypes/array.h"
+
+// compares node IDs, used to sort an ID list
+#define ID_ISLT(a, b) (*(a) < *(b))
 
 /* Forward declarations. */
 static OpResult NodeByIdSeekInit(OpBase *opBase);
 static Record NodeByIdSeekConsume(OpBase *opBase);
 static Record NodeByIdSeekConsumeFromChild(OpBase *opBase);
+static uint NodeByIdSeekConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpResult NodeByIdSeekReset(OpBase *opBase);
 static OpBase *NodeByIdSeekClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void NodeByIdSeekFree(OpBase *opBase);
@@ -44,6 +51,10 @@ OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const char *alias, Unsigned
 
 	op->currentId = op->minId;
 
+	op->ids_exp = NULL;
+	op->ids = NULL;
+	op->ids_pos = 0;
+
 	OpBase_Init((OpBase *)op, OPType_NODE_BY_ID_SEEK, "NodeByIdSeek", NodeByIdSeekInit,
 				NodeByIdSeekConsume, NodeByIdSeekReset, NodeByIdSeekToString, NodeByIdSeekClone, NodeByIdSeekFree,
 				false, plan);
@@ -53,22 +64,106 @@ OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const char *alias, Unsigned
 	return (OpBase *)op;
 }
 
+OpBase *NewNodeByIdListSeekOp(const ExecutionPlan *plan, const char *alias, AR_ExpNode *ids_exp) {
+	ASSERT(ids_exp != NULL);
+
+	UnsignedRange *id_range = UnsignedRange_New();
+	NodeByIdSeek *op = (NodeByIdSeek *)NewNodeByIdSeekOp(plan, alias, id_range);
+	UnsignedRange_Free(id_range);
+
+	op->ids_exp = ids_exp;
+
+	return (OpBase *)op;
+}
+
+// evaluates the list of IDs to seek
+// IDs are sorted and deduplicated, such that nodes are fetched in storage order
+static void _EvaluateIDs(NodeByIdSeek *op) {
+	uint64_t node_count = Graph_UncompactedNodeCount(op->g);
+	SIValue list = AR_EXP_Evaluate(op->ids_exp, NULL);
+	uint32_t n = (SI_TYPE(list) == T_ARRAY) ? SIArray_Length(list) : 0;
+
+	op->ids = array_new(NodeID, n);
+	op->ids_pos = 0;
+
+	for(uint32_t i = 0; i < n; i++) {
+		NodeID id;
+		SIValue v = SIArray_Get(list, i);
+
+		// only integral values within the graph can match an ID
+		if(SI_TYPE(v) == T_INT64) {
+			if(v.longval < 0) continue;
+			id = v.longval;
+		} else if(SI_TYPE(v) == T_DOUBLE) {
+			if(!(v.doubleval >= 0 && v.doubleval < node_count)) continue;
+			id = v.doubleval;
+			if(id != v.doubleval) continue;
+		} else {
+			continue;
+		}
+		if(id >= node_count) continue;
+
+		array_append(op->ids, id);
+	}
+
+	SIValue_Free(list);
+
+	n = array_len(op->ids);
+	QSORT(NodeID, op->ids, n, ID_ISLT);
+
+	uint32_t j = 0;
+	for(uint32_t i = 0; i < n; i++) {
+		if(j > 0 && op->ids[j - 1] == op->ids[i]) continue;
+		op->ids[j++] = op->ids[i];
+	}
+	op->ids = array_trimm_len(op->ids, j);
+}
+
 static OpResult NodeByIdSeekInit(OpBase *opBase) {
 	ASSERT(opBase->type == OPType_NODE_BY_ID_SEEK);
 	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
 	// The largest possible entity ID is the number of nodes - deleted and real - in the DataBlock.
 	size_t node_count = Graph_UncompactedNodeCount(op->g);
 	op->maxId = MIN(node_count - 1, op->maxId);
+	if(op->ids_exp != NULL) _EvaluateIDs(op);
 	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, NodeByIdSeekConsumeFromChild);
+	else OpBase_UpdateConsumeBatch(opBase, NodeByIdSeekConsumeBatch);
 	return OP_OK;
 }
 
+// seeks the next listed node, loading nodes and their properties ahead of
+// time, by the time a node's properties are requested the node itself is
+// expected to have been loaded
+static inline Node _SeekNextListedNode(NodeByIdSeek *op) {
+	Node n = GE_NEW_NODE();
+	uint64_t count = array_len(op->ids);
+
+	while(op->ids_pos < count) {
+		uint64_t ahead = op->ids_pos + ID_SEEK_PREFETCH_DISTANCE;
+		if(ahead + ID_SEEK_PREFETCH_DISTANCE < count) {
+			Graph_PrefetchNode(op->g, op->ids[ahead + ID_SEEK_PREFETCH_DISTANCE]);
+		}
+		if(ahead < count) Graph_PrefetchNodeProperties(op->g, op->ids[ahead]);
+
+		if(Graph_GetNode(op->g, op->ids[op->ids_pos++], &n)) break;
+	}
+
+	return n;
+}
+
 static inline Node _SeekNextNode(NodeByIdSeek *op) {
+	if(op->ids != NULL) return _SeekNextListedNode(op);
+
 	Node n = GE_NEW_NODE();
 
 	/* As long as we're within range bounds
 	 * and we've yet to get a node. */
 	while(!_outOfBounds(op)) {
+		// consecutive nodes are loaded by the hardware prefetcher
+		// their scattered properties are not
+		uint64_t ahead = op->currentId + ID_SEEK_PREFETCH_DISTANCE;
+		if(ahead <= op->maxId) Graph_PrefetchNodeProperties(op->g, ahead);
+
 		if(Graph_GetNode(op->g, op->currentId, &n)) break;
 		op->currentId++;
 	}
@@ -79,6 +174,30 @@ static inline Node _SeekNextNode(NodeByIdSeek *op) {
 	return n;
 }
 
+uint64_t NodeByIdSeekOp_Skip(NodeByIdSeek *op, uint64_t n) {
+	ASSERT(op != NULL);
+	ASSERT(op->op.childCount == 0);
+
+	// Without deleted nodes every ID within range exists, seek directly.
+	if(Graph_DeletedNodeCount(op->g) == 0) {
+		uint64_t remaining;
+		if(op->ids != NULL) {
+			remaining = array_len(op->ids) - op->ids_pos;
+			if(n > remaining) n = remaining;
+			op->ids_pos += n;
+		} else {
+			remaining = _outOfBounds(op) ? 0 : op->maxId - op->currentId + 1;
+			if(n > remaining) n = remaining;
+			op->currentId += n;
+		}
+		return n;
+	}
+
+	uint64_t skipped = 0;
+	while(skipped < n && _SeekNextNode(op).entity != NULL) skipped++;
+	return skipped;
+}
+
 static Record NodeByIdSeekConsumeFromChild(OpBase *opBase) {
 	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
 
@@ -126,15 +245,36 @@ static Record NodeByIdSeekConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint NodeByIdSeekConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
+
+	uint n = 0;
+	while(n < cap) {
+		Node node = _SeekNextNode(op);
+		if(node.entity == NULL) break; // Depleted.
+
+		Record r = OpBase_CreateRecord(opBase);
+		Record_AddNode(r, op->nodeRecIdx, node);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 static OpResult NodeByIdSeekReset(OpBase *ctx) {
 	NodeByIdSeek *op = (NodeByIdSeek *)ctx;
 	op->currentId = op->minId;
+	op->ids_pos = 0;
 	return OP_OK;
 }
 
 static OpBase *NodeByIdSeekClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_NODE_BY_ID_SEEK);
 	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
+	if(op->ids_exp != NULL) {
+		return NewNodeByIdListSeekOp(plan, op->alias, AR_EXP_Clone(op->ids_exp));
+	}
+
 	UnsignedRange range;
 	range.min = op->minId;
 	range.max = op->maxId;
@@ -151,6 +291,16 @@ static OpBase *NodeByIdSeekClone(const ExecutionPlan *plan, const OpBase *opBase
 
 static void NodeByIdSeekFree(OpBase *opBase) {
 	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
+	if(op->ids_exp) {
+		AR_EXP_Free(op->ids_exp);
+		op->ids_exp = NULL;
+	}
+
+	if(op->ids) {
+		array_free(op->ids);
+		op->ids = NULL;
+	}
+
 	if(op->child_record) {
 		OpBase_DeleteRecord(op->child_record);
 		op->child_record = NULL;
@@ -10,9 +10,14 @@
 #include "../execution_plan.h"
 #include "../../graph/graph.h"
 #include "../../util/range/unsigned_range.h"
+#include "../../arithmetic/arithmetic_expression.h"
 
 #define ID_RANGE_UNBOUND -1
 
+// number of IDs looked ahead of the current one when seeking
+// nodes are loaded twice as far ahead, followed by their properties
+#define ID_SEEK_PREFETCH_DISTANCE 8
+
 /* Node by ID seek locates an entity by its ID */
 typedef struct {
 	OpBase op;
@@ -22,8 +27,20 @@ typedef struct {
 	NodeID currentId;       // Current ID fetched.
 	NodeID minId;           // Min ID to fetch.
 	NodeID maxId;           // Max ID to fetch.
+	AR_ExpNode *ids_exp;    // [optional] List of IDs to fetch.
+	NodeID *ids;            // Sorted, deduplicated IDs, evaluated on init.
+	uint64_t ids_pos;       // Position of the next ID within ids.
 	int nodeRecIdx;         // Position of entity within record.
 } NodeByIdSeek;
 
 OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const char *alias, UnsignedRange *id_range);
 
+/* Skip over the next 'n' nodes without producing records for them.
+ * Returns the number of nodes skipped, fewer than 'n' once depleted. */
+uint64_t NodeByIdSeekOp_Skip(NodeByIdSeek *op, uint64_t n);
+
+/* Creates a seek over the IDs in the list 'ids_exp' evaluates to,
+ * the list is evaluated once the op is initialized.
+ * The op takes ownership of 'ids_exp'. */
+OpBase *NewNodeByIdListSeekOp(const ExecutionPlan *plan, const char *alias, AR_ExpNode *ids_exp);
+
@@ -8,21 +8,30 @@
 #include "../../query_ctx.h"
 #include "shared/print_functions.h"
 #include "../../filter_tree/ft_to_rsq.h"
+#include "../../filter_tree/ft_to_native.h"
 
 // forward declarations
 static OpResult IndexScanInit(OpBase *opBase);
 static Record IndexScanConsume(OpBase *opBase);
 static Record IndexScanConsumeFromChild(OpBase *opBase);
+static Record IndexScanConsumeIndexOnly(OpBase *opBase);
+static Record IndexScanConsumeAggregate(OpBase *opBase);
 static OpResult IndexScanReset(OpBase *opBase);
 static void IndexScanFree(OpBase *opBase);
 
 static void IndexScanToString(const OpBase *ctx, sds *buf) {
 	IndexScan *op = (IndexScan *)ctx;
 	ScanToString(ctx, buf, op->n.alias, op->n.label);
+	if(op->index_only) *buf = sdscatprintf(*buf, " | Index Only");
+	if(op->order_attr != ATTRIBUTE_NOTFOUND) *buf = sdscatprintf(*buf, " | Ordered");
+	if(op->unique) *buf = sdscatprintf(*buf, " | Unique");
+	if(op->aggregate == INDEX_SCAN_AGGREGATE_COUNT) *buf = sdscatprintf(*buf, " | Count");
+	if(op->aggregate == INDEX_SCAN_AGGREGATE_MIN) *buf = sdscatprintf(*buf, " | Min");
+	if(op->aggregate == INDEX_SCAN_AGGREGATE_MAX) *buf = sdscatprintf(*buf, " | Max");
 }
 
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
-		RSIndex *idx, FT_FilterNode *filter) {
+		RSIndex *idx, NativeIndex *native, FT_FilterNode *filter) {
 	// validate inputs
 	ASSERT(g      != NULL);
 	ASSERT(idx    != NULL);
@@ -34,10 +43,25 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
 	op->n                    =  n;
 	op->idx                  =  idx;
 	op->iter                 =  NULL;
+	op->native               =  native;
+	op->native_iter          =  NULL;
 	op->filter               =  filter;
 	op->child_record         =  NULL;
 	op->unresolved_filters   =  NULL;
 	op->rebuild_index_query  =  false;
+	op->index_only           =  false;
+	op->covered_attrs        =  array_new(Attribute_ID, 0);
+	op->covered_aliases      =  array_new(char *, 0);
+	op->covered_offsets      =  array_new(uint, 0);
+	op->order_attr           =  ATTRIBUTE_NOTFOUND;
+	op->order_desc           =  false;
+	op->ahead_pos            =  0;
+	op->ahead_count          =  0;
+	op->depleted             =  false;
+	op->unique               =  false;
+	op->aggregate            =  INDEX_SCAN_AGGREGATE_NONE;
+	op->aggregate_attr       =  ATTRIBUTE_NOTFOUND;
+	op->aggregate_alias      =  NULL;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_NODE_BY_INDEX_SCAN, "Node By Index Scan", IndexScanInit, IndexScanConsume,
@@ -47,10 +71,83 @@ OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
 	return (OpBase *)op;
 }
 
+const char *IndexScanOp_CoverAttribute(IndexScan *op, Attribute_ID attr,
+		const char *attr_name) {
+	ASSERT(op        != NULL);
+	ASSERT(attr_name != NULL);
+
+	uint count = array_len(op->covered_attrs);
+	for(uint i = 0; i < count; i++) {
+		if(op->covered_attrs[i] == attr) return op->covered_aliases[i];
+	}
+
+	// internal alias, can't be referred to by queries
+	char *alias;
+	asprintf(&alias, "@%s.%s", op->n.alias, attr_name);
+
+	array_append(op->covered_attrs, attr);
+	array_append(op->covered_aliases, alias);
+	array_append(op->covered_offsets, OpBase_Modifies((OpBase *)op, alias));
+
+	return alias;
+}
+
+void IndexScanOp_SetOrder(IndexScan *op, Attribute_ID attr, bool descending) {
+	ASSERT(op         != NULL);
+	ASSERT(op->native != NULL);
+	ASSERT(attr       != ATTRIBUTE_NOTFOUND);
+
+	op->order_attr = attr;
+	op->order_desc = descending;
+}
+
+void IndexScanOp_SetUnique(IndexScan *op) {
+	ASSERT(op != NULL);
+	op->unique = true;
+}
+
+void IndexScanOp_SetIndexOnly(IndexScan *op) {
+	ASSERT(op != NULL);
+	ASSERT(op->op.childCount == 0);
+
+	op->index_only = true;
+	OpBase_UpdateConsume((OpBase *)op, IndexScanConsumeIndexOnly);
+}
+
+const char *IndexScanOp_SetAggregate(IndexScan *op,
+		IndexScanAggregate aggregate, Attribute_ID attr) {
+	ASSERT(op                != NULL);
+	ASSERT(op->native        != NULL);
+	ASSERT(op->op.childCount == 0);
+	ASSERT(op->aggregate     == INDEX_SCAN_AGGREGATE_NONE);
+	ASSERT(aggregate         != INDEX_SCAN_AGGREGATE_NONE);
+
+	const char *func = "count";
+	if(aggregate != INDEX_SCAN_AGGREGATE_COUNT) {
+		// the first node of a scan ordered by 'attr' holds the aggregate
+		bool max = (aggregate == INDEX_SCAN_AGGREGATE_MAX);
+		IndexScanOp_SetOrder(op, attr, max);
+		func = max ? "max" : "min";
+	}
+
+	// internal alias, can't be referred to by queries
+	asprintf(&op->aggregate_alias, "@%s(%s)", func, op->n.alias);
+
+	op->aggregate         =  aggregate;
+	op->aggregate_attr    =  attr;
+	op->aggregate_offset  =  OpBase_Modifies((OpBase *)op, op->aggregate_alias);
+	OpBase_UpdateConsume((OpBase *)op, IndexScanConsumeAggregate);
+
+	return op->aggregate_alias;
+}
+
 static OpResult IndexScanInit(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
 	if(opBase->childCount > 0) {
+		// index only scans don't consume from a child
+		ASSERT(!op->index_only);
+
 		// find out how many different entities are refered to 
 		// within the filter tree, if number of entities equals 1
 		// (current node being scanned) there's no need to re-build the index
@@ -87,6 +184,162 @@ static inline bool _PassUnresolvedFilters(const IndexScan *op, Record r) {
 	return FilterTree_applyFilters(unresolved_filters, r) == FILTER_PASS;
 }
 
+// project covered attributes out of the native index key
+// returns false if the key doesn't hold all of them
+// or if unresolved filters require the node itself
+static bool _ProjectFromIndex(const IndexScan *op, Record r) {
+	if(op->native_iter == NULL || op->unresolved_filters != NULL) return false;
+
+	uint count = array_len(op->covered_attrs);
+	SIValue values[count];
+	for(uint i = 0; i < count; i++) {
+		if(!NativeIndexIterator_Value(op->native_iter, op->covered_attrs[i],
+					values + i)) {
+			return false;
+		}
+	}
+
+	for(uint i = 0; i < count; i++) {
+		// index owned values must be copied
+		SIValue_Persist(values + i);
+		Record_Add(r, op->covered_offsets[i], values[i]);
+	}
+
+	return true;
+}
+
+// project covered attributes out of the scanned node
+static void _ProjectFromNode(const IndexScan *op, Record r) {
+	Node *n = Record_GetNode(r, op->nodeRecIdx);
+	uint count = array_len(op->covered_attrs);
+	for(uint i = 0; i < count; i++) {
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)n,
+				op->covered_attrs[i]);
+		SIValue value = (v == PROPERTY_NOTFOUND) ? SI_NullVal() :
+			SI_CloneValue(*v);
+		Record_Add(r, op->covered_offsets[i], value);
+	}
+}
+
+// create an iterator over the nodes passing 'filter'
+// prefer the native index when it resolves the filter
+static void _BuildIterator(IndexScan *op, const FT_FilterNode *filter) {
+	// the index must reflect the query's own modifications
+	QueryCtx_ApplyIndexChanges();
+
+	if(op->order_attr != ATTRIBUTE_NOTFOUND) {
+		// upstream operations rely on the order of produced nodes
+		op->native_iter = FilterTreeToOrderedNativeIterator(
+				&op->unresolved_filters, filter, op->native, op->order_attr);
+		ASSERT(op->native_iter != NULL);
+		if(op->order_desc) NativeIndexIterator_Reverse(op->native_iter);
+		return;
+	}
+
+	if(op->native != NULL) {
+		op->native_iter = FilterTreeToNativeIterator(&op->unresolved_filters,
+				filter, op->native);
+		if(op->native_iter != NULL) return;
+	}
+
+	RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
+			filter, op->idx);
+	ASSERT(rs_query_node != NULL);
+	op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+}
+
+static inline bool _HasIterator(const IndexScan *op) {
+	return (op->iter != NULL || op->native_iter != NULL);
+}
+
+static inline const EntityID *_NextNodeID(IndexScan *op) {
+	if(op->native_iter != NULL) {
+		return NativeIndexIterator_Next(op->native_iter);
+	}
+	return RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL);
+}
+
+#define AHEAD_MASK (INDEX_SCAN_PREFETCH_DISTANCE - 1)
+
+// pulls the next ID out of the index, keeping INDEX_SCAN_PREFETCH_DISTANCE
+// IDs pulled ahead of it, nodes are loaded once their ID is pulled
+// and their properties once half way through
+static inline bool _NextPrefetchedNodeID(IndexScan *op, EntityID *id) {
+	// unique scans produce a single node, there's nothing to pull ahead
+	uint distance = op->unique ? 1 : INDEX_SCAN_PREFETCH_DISTANCE;
+	while(!op->depleted && op->ahead_count < distance) {
+		const EntityID *next = _NextNodeID(op);
+		if(next == NULL) {
+			op->depleted = true;
+			break;
+		}
+
+		uint tail = (op->ahead_pos + op->ahead_count++) & AHEAD_MASK;
+		op->ahead[tail] = *next;
+		Graph_PrefetchNode(op->g, *next);
+	}
+
+	if(op->ahead_count == 0) return false;
+
+	uint half = INDEX_SCAN_PREFETCH_DISTANCE / 2;
+	if(op->ahead_count > half) {
+		uint mid = (op->ahead_pos + half) & AHEAD_MASK;
+		Graph_PrefetchNodeProperties(op->g, op->ahead[mid]);
+	}
+
+	*id = op->ahead[op->ahead_pos];
+	op->ahead_pos = (op->ahead_pos + 1) & AHEAD_MASK;
+	op->ahead_count--;
+	return true;
+}
+
+// discard IDs pulled ahead of time
+static inline void _ClearPrefetchedNodeIDs(IndexScan *op) {
+	op->ahead_pos   = 0;
+	op->ahead_count = 0;
+	op->depleted    = false;
+}
+
+static void _ResetIterator(IndexScan *op) {
+	// the index must reflect the query's own modifications
+	QueryCtx_ApplyIndexChanges();
+
+	if(op->native_iter != NULL) NativeIndexIterator_Reset(op->native_iter);
+	else RediSearch_ResultsIteratorReset(op->iter);
+}
+
+static void _FreeIterator(IndexScan *op) {
+	if(op->iter != NULL) {
+		RediSearch_ResultsIteratorFree(op->iter);
+		op->iter = NULL;
+	}
+
+	if(op->native_iter != NULL) {
+		NativeIndexIterator_Free(op->native_iter);
+		op->native_iter = NULL;
+	}
+}
+
+uint64_t IndexScanOp_Skip(IndexScan *op, uint64_t n) {
+	ASSERT(op != NULL);
+	ASSERT(op->op.childCount == 0);
+
+	// create iterator on first call
+	if(!_HasIterator(op)) _BuildIterator(op, op->filter);
+
+	// nodes failing unresolved filters don't count as skipped
+	if(op->unresolved_filters != NULL) return 0;
+
+	uint64_t skipped = 0;
+	EntityID id;
+	while(skipped < n && op->ahead_count > 0) {
+		_NextPrefetchedNodeID(op, &id);
+		skipped++;
+	}
+	while(skipped < n && _NextNodeID(op) != NULL) skipped++;
+	return skipped;
+}
+
 static Record IndexScanConsumeFromChild(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 	const EntityID *nodeId = NULL;
@@ -96,13 +349,14 @@ pull_index:
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
-		while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-				!= NULL) {
+	if(_HasIterator(op) && op->child_record != NULL && !op->depleted) {
+		while((nodeId = _NextNodeID(op)) != NULL) {
 			// populate record with node
 			_UpdateRecord(op, op->child_record, *nodeId);
 			// apply unresolved filters
 			if(_PassUnresolvedFilters(op, op->child_record)) {
+				// no other node matches the current input record
+				op->depleted = op->unique;
 				// clone the held Record, as it will be freed upstream
 				return OpBase_CloneRecord(op->child_record);
 			}
@@ -125,6 +379,7 @@ pull_index:
 
 	op->child_record = OpBase_Consume(op->op.children[0]);
 	if(op->child_record == NULL) return NULL; // depleted
+	op->depleted = false;
 
 	//--------------------------------------------------------------------------
 	// reset index iterator
@@ -132,10 +387,7 @@ pull_index:
 
 	if(op->rebuild_index_query) {
 		// free previous iterator
-		if(op->iter != NULL) {
-			RediSearch_ResultsIteratorFree(op->iter);
-			op->iter = NULL;
-		}
+		_FreeIterator(op);
 
 		// free previous unresolved filters
 		if(op->unresolved_filters != NULL) {
@@ -157,25 +409,18 @@ pull_index:
 		}
 		#endif
 
-		// convert filter into a RediSearch query
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				filter, op->idx);
+		// convert filter into an index query and create iterator
+		_BuildIterator(op, filter);
 		FilterTree_Free(filter);
-
-		// create iterator
-		ASSERT(rs_query_node != NULL);
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
 	} else {
 		// build index query only once (first call)
 		// reset it if already initialized
-		if(op->iter == NULL) {
+		if(!_HasIterator(op)) {
 			// first call to consume, create query and iterator
-			RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters, op->filter, op->idx);
-			ASSERT(rs_query_node != NULL);
-			op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+			_BuildIterator(op, op->filter);
 		} else {
 			// reset existing iterator
-			RediSearch_ResultsIteratorReset(op->iter);
+			_ResetIterator(op);
 		}
 	}
 
@@ -187,23 +432,52 @@ static Record IndexScanConsume(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
 	// create iterator on first call
-	if(op->iter == NULL) {
-		RSQNode *rs_query_node = FilterTreeToQueryNode(&op->unresolved_filters,
-				op->filter, op->idx);
+	if(!_HasIterator(op)) _BuildIterator(op, op->filter);
+
+	EntityID nodeId;
 
-		op->iter = RediSearch_GetResultsIterator(rs_query_node, op->idx);
+	// populate the Record with the actual node
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	while(_NextPrefetchedNodeID(op, &nodeId)) {
+		// populate record with node
+		_UpdateRecord(op, r, nodeId);
+		// apply unresolved filters
+		if(_PassUnresolvedFilters(op, r)) {
+			// no other node passes the filter
+			if(op->unique) op->depleted = true;
+			return r;
+		}
 	}
 
+	OpBase_DeleteRecord(r);
+
+	return NULL;
+}
+
+// projects covered attributes without accessing the scanned nodes
+// whenever the native index holds their values
+static Record IndexScanConsumeIndexOnly(OpBase *opBase) {
+	IndexScan *op = (IndexScan *)opBase;
+
+	// create iterator on first call
+	if(!_HasIterator(op)) _BuildIterator(op, op->filter);
+
 	const EntityID *nodeId = NULL;
+	if(op->depleted) return NULL;
 
-	// populate the Record with the actual node
 	Record r = OpBase_CreateRecord((OpBase *)op);
-	while((nodeId = RediSearch_ResultsIteratorNext(op->iter, op->idx, NULL))
-			!= NULL) {
-		// populate record with node
+	while((nodeId = _NextNodeID(op)) != NULL) {
+		// no other node passes the filter
+		if(_ProjectFromIndex(op, r)) {
+			op->depleted = op->unique;
+			return r;
+		}
+
+		// fallback, read attributes from the node
 		_UpdateRecord(op, r, *nodeId);
-		// apply unresolved filters
 		if(_PassUnresolvedFilters(op, r)) {
+			_ProjectFromNode(op, r);
+			op->depleted = op->unique;
 			return r;
 		}
 	}
@@ -213,18 +487,83 @@ static Record IndexScanConsume(OpBase *opBase) {
 	return NULL;
 }
 
+// counts the nodes passing the filter
+// out of the index buckets when the native index resolves the entire filter
+static SIValue _AggregateCount(IndexScan *op, Record r) {
+	if(op->native_iter != NULL && op->unresolved_filters == NULL) {
+		return SI_LongVal(NativeIndexIterator_Count(op->native_iter));
+	}
+
+	// fallback, apply unresolved filters to each node
+	int64_t count = 0;
+	const EntityID *nodeId = NULL;
+	while((nodeId = _NextNodeID(op)) != NULL) {
+		_UpdateRecord(op, r, *nodeId);
+		if(_PassUnresolvedFilters(op, r)) count++;
+	}
+
+	return SI_LongVal(count);
+}
+
+// value of the aggregated attribute of the first node passing the filter
+// nodes are scanned ordered by that attribute, NULL if no node passes
+static SIValue _AggregateExtremum(IndexScan *op, Record r) {
+	SIValue v;
+	const EntityID *nodeId = NULL;
+	while((nodeId = _NextNodeID(op)) != NULL) {
+		if(op->unresolved_filters == NULL &&
+		   NativeIndexIterator_Value(op->native_iter, op->aggregate_attr, &v)) {
+			// index owned values must be copied
+			SIValue_Persist(&v);
+			return v;
+		}
+
+		// fallback, read attribute from the node
+		_UpdateRecord(op, r, *nodeId);
+		if(!_PassUnresolvedFilters(op, r)) continue;
+
+		Node *n = Record_GetNode(r, op->nodeRecIdx);
+		SIValue *attr = GraphEntity_GetProperty((GraphEntity *)n,
+				op->aggregate_attr);
+		ASSERT(attr != PROPERTY_NOTFOUND);
+		return SI_CloneValue(*attr);
+	}
+
+	return SI_NullVal();
+}
+
+// produces a single record holding the aggregated value
+// without producing a record per scanned node
+static Record IndexScanConsumeAggregate(OpBase *opBase) {
+	IndexScan *op = (IndexScan *)opBase;
+
+	if(op->depleted) return NULL;
+
+	// create iterator on first call
+	if(!_HasIterator(op)) _BuildIterator(op, op->filter);
+
+	Record r = OpBase_CreateRecord((OpBase *)op);
+	SIValue v = (op->aggregate == INDEX_SCAN_AGGREGATE_COUNT) ?
+		_AggregateCount(op, r) : _AggregateExtremum(op, r);
+	Record_Add(r, op->aggregate_offset, v);
+
+	op->depleted = true;
+	return r;
+}
+
 static OpResult IndexScanReset(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
+	_ClearPrefetchedNodeIDs(op);
+
 	if(op->rebuild_index_query) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
+		_FreeIterator(op);
 		if(op->unresolved_filters) {
 			FilterTree_Free(op->unresolved_filters);
 			op->unresolved_filters = NULL;
 		}
-	} else {
-		RediSearch_ResultsIteratorReset(op->iter);
+	} else if(_HasIterator(op)) {
+		_ResetIterator(op);
 	}
 
 	return OP_OK;
@@ -236,10 +575,7 @@ static void IndexScanFree(OpBase *opBase) {
 	 * read locked, if this index scan operation is part of
 	 * a query which will modified this index we'll be stuck in
 	 * a dead lock, as we're unable to acquire index write lock. */
-	if(op->iter) {
-		RediSearch_ResultsIteratorFree(op->iter);
-		op->iter = NULL;
-	}
+	_FreeIterator(op);
 
 	if(op->child_record) {
 		OpBase_DeleteRecord(op->child_record);
@@ -255,5 +591,27 @@ static void IndexScanFree(OpBase *opBase) {
 		FilterTree_Free(op->unresolved_filters);
 		op->unresolved_filters = NULL;
 	}
+
+	if(op->covered_attrs) {
+		array_free(op->covered_attrs);
+		op->covered_attrs = NULL;
+	}
+
+	if(op->covered_aliases) {
+		uint count = array_len(op->covered_aliases);
+		for(uint i = 0; i < count; i++) free(op->covered_aliases[i]);
+		array_free(op->covered_aliases);
+		op->covered_aliases = NULL;
+	}
+
+	if(op->covered_offsets) {
+		array_free(op->covered_offsets);
+		op->covered_offsets = NULL;
+	}
+
+	if(op->aggregate_alias) {
+		free(op->aggregate_alias);
+		op->aggregate_alias = NULL;
+	}
 }
 
@@ -13,20 +13,81 @@
 #include "shared/scan_functions.h"
 #include "redisearch_api.h"
 
+// number of IDs pulled out of the index ahead of the current one
+// their nodes are loaded while preceding nodes are processed
+// must be a power of 2
+#define INDEX_SCAN_PREFETCH_DISTANCE 16
+
+// aggregation computed by the scan itself, see IndexScanOp_SetAggregate
+typedef enum {
+	INDEX_SCAN_AGGREGATE_NONE,   // produce a record per node
+	INDEX_SCAN_AGGREGATE_COUNT,  // count scanned nodes
+	INDEX_SCAN_AGGREGATE_MIN,    // minimum value of an indexed attribute
+	INDEX_SCAN_AGGREGATE_MAX,    // maximum value of an indexed attribute
+} IndexScanAggregate;
+
 typedef struct {
 	OpBase op;
 	Graph *g;
 	bool rebuild_index_query;           // should we rebuild RediSearch index query for each input record
 	RSIndex *idx;                       // index to query
+	NativeIndex *native;                // [optional] native index to query
 	NodeScanCtx n;                      // label data of node being scanned
 	uint nodeRecIdx;                    // index of the node being scanned in the Record
 	RSResultsIterator *iter;            // rediSearch iterator over an index with the appropriate filters
+	NativeIndexIterator *native_iter;   // native index iterator, used when it resolves the entire filter
 	FT_FilterNode *filter;              // filter from which to compose index query
 	FT_FilterNode *unresolved_filters;  // subset of filter, contains filters that couldn't be resolved by index
 	Record child_record;                // the Record this op acts on if it is not a tap
+	bool index_only;                    // scanned node isn't required upstream
+	Attribute_ID *covered_attrs;        // attributes projected out of the index
+	char **covered_aliases;             // aliases of projected attributes
+	uint *covered_offsets;              // record offsets of projected attributes
+	Attribute_ID order_attr;            // attribute nodes are produced ordered by
+	bool order_desc;                    // produce nodes by descending order
+	EntityID ahead[INDEX_SCAN_PREFETCH_DISTANCE];  // IDs pulled ahead of time
+	uint ahead_pos;                     // position of the next ID within ahead
+	uint ahead_count;                   // number of IDs pulled ahead of time
+	bool depleted;                      // index iterator is depleted
+	bool unique;                        // at most a single node passes the filter
+	IndexScanAggregate aggregate;       // aggregation computed by the scan
+	Attribute_ID aggregate_attr;        // aggregated attribute
+	char *aggregate_alias;              // alias of the aggregated value
+	uint aggregate_offset;              // record offset of the aggregated value
 } IndexScan;
 
 // creates a new IndexScan operation
 OpBase *NewIndexScanOp(const ExecutionPlan *plan, Graph *g, NodeScanCtx n,
-		RSIndex *idx, FT_FilterNode *filter);
+		RSIndex *idx, NativeIndex *native, FT_FilterNode *filter);
+
+// project 'attr' of the scanned node into the record
+// values are read from the native index when possible
+// returns the alias under which the attribute is projected
+const char *IndexScanOp_CoverAttribute(IndexScan *op, Attribute_ID attr,
+		const char *attr_name);
+
+// produce nodes ordered by the value of 'attr', through the native index
+// the filter must bound 'attr', see FilterTree_NativeOrderable
+void IndexScanOp_SetOrder(IndexScan *op, Attribute_ID attr, bool descending);
+
+// skip over the next 'n' nodes without producing records for them
+// returns the number of nodes skipped, fewer than 'n' once depleted
+// or 0 if nodes must be fetched to be filtered
+uint64_t IndexScanOp_Skip(IndexScan *op, uint64_t n);
+
+// the filter pins a uniquely constrained attribute to a single value
+// stop pulling from the index once a node passes the filter
+void IndexScanOp_SetUnique(IndexScan *op);
+
+// stop introducing the scanned node into the record
+// upstream operations only access its covered attributes
+void IndexScanOp_SetIndexOnly(IndexScan *op);
+
+// produce a single record holding 'aggregate' over the scanned nodes
+// counts are summed out of the native index buckets, minimum and maximum
+// values are read off the first node of a scan ordered by 'attr'
+// the filter must bound 'attr', see FilterTree_NativeOrderable
+// returns the alias under which the aggregated value is projected
+const char *IndexScanOp_SetAggregate(IndexScan *op,
+		IndexScanAggregate aggregate, Attribute_ID attr);
 
@@ -9,10 +9,12 @@
 #include "shared/print_functions.h"
 #include "../../ast/ast.h"
 #include "../../query_ctx.h"
+#include "../../util/arr.h"
 
 /* Forward declarations. */
 static OpResult NodeByLabelScanInit(OpBase *opBase);
 static Record NodeByLabelScanConsume(OpBase *opBase);
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase);
 static Record NodeByLabelScanNoOp(OpBase *opBase);
 static OpResult NodeByLabelScanReset(OpBase *opBase);
@@ -22,6 +24,22 @@ static void NodeByLabelScanFree(OpBase *opBase);
 static inline void NodeByLabelScanToString(const OpBase *ctx, sds *buf) {
 	NodeByLabelScan *op = (NodeByLabelScan *)ctx;
 	ScanToString(ctx, buf, op->n.alias, op->n.label);
+
+	if(op->labels != NULL) {
+		*buf = sdscatprintf(*buf, " | intersect ");
+		uint n = array_len(op->labels);
+		for(uint i = 0; i < n; i++) {
+			*buf = sdscatprintf(*buf, ":%s", op->labels[i]);
+		}
+	}
+
+	if(op->excluded != NULL) {
+		*buf = sdscatprintf(*buf, " | exclude ");
+		uint n = array_len(op->excluded);
+		for(uint i = 0; i < n; i++) {
+			*buf = sdscatprintf(*buf, ":%s", op->excluded[i]);
+		}
+	}
 }
 
 OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n) {
@@ -30,6 +48,10 @@ OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n) {
 	op->g = gc->g;
 	op->n = n;
 	op->iter = NULL;
+	op->labels = NULL;
+	op->excluded = NULL;
+	op->ids = NULL;
+	op->ids_pos = 0;
 	op->child_record = NULL;
 	// Defaults to [0...UINT64_MAX].
 	op->id_range = UnsignedRange_New();
@@ -52,6 +74,111 @@ void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range)
 	op->op.name = "Node By Label and ID Scan";
 }
 
+void NodeByLabelScanOp_IntersectLabel(NodeByLabelScan *op, const char *label) {
+	ASSERT(op != NULL);
+	ASSERT(label != NULL);
+
+	if(op->labels == NULL) op->labels = array_new(const char *, 1);
+	array_append(op->labels, label);
+}
+
+void NodeByLabelScanOp_ExcludeLabel(NodeByLabelScan *op, const char *label) {
+	ASSERT(op != NULL);
+	ASSERT(label != NULL);
+
+	if(op->excluded == NULL) op->excluded = array_new(const char *, 1);
+	array_append(op->excluded, label);
+}
+
+bool NodeByLabelScanOp_MultiLabel(const NodeByLabelScan *op) {
+	ASSERT(op != NULL);
+	return (op->labels != NULL || op->excluded != NULL);
+}
+
+// extracts the diagonal of label matrix 'L' into a vector
+static GrB_Vector _LabelVector(RG_Matrix L) {
+	GrB_Info   info;
+	GrB_Index  n;
+	GrB_Matrix l = NULL;
+	GrB_Vector d = NULL;
+
+	UNUSED(info);
+
+	info = RG_Matrix_export(&l, L);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nrows(&n, l);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_new(&d, GrB_BOOL, n);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Vector_diag(d, l, 0, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_free(&l);
+	return d;
+}
+
+// computes the entry points of a multi-label scan within [minId, maxId]
+// a single eWiseMult per additional label intersects the labels' diagonals
+// excluded labels are removed through a complemented mask
+static void _ConstructIDs(NodeByLabelScan *op, NodeID minId, NodeID maxId) {
+	GrB_Info      info;
+	GrB_Index     nvals;
+	GraphContext  *gc  =  QueryCtx_GetGraphCtx();
+	GrB_Vector    v    =  _LabelVector(Graph_GetLabelMatrix(gc->g,
+				op->n.label_id));
+
+	UNUSED(info);
+
+	uint n = (op->labels != NULL) ? array_len(op->labels) : 0;
+	for(uint i = 0; i < n; i++) {
+		Schema *s = GraphContext_GetSchema(gc, op->labels[i], SCHEMA_NODE);
+		if(s == NULL) {
+			// missing label, no node carries it
+			info = GrB_Vector_clear(v);
+			ASSERT(info == GrB_SUCCESS);
+			break;
+		}
+
+		GrB_Vector l = _LabelVector(Graph_GetLabelMatrix(gc->g, s->id));
+		info = GrB_eWiseMult(v, NULL, NULL, GrB_LAND, v, l, NULL);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_free(&l);
+	}
+
+	n = (op->excluded != NULL) ? array_len(op->excluded) : 0;
+	for(uint i = 0; i < n; i++) {
+		Schema *s = GraphContext_GetSchema(gc, op->excluded[i], SCHEMA_NODE);
+		// missing label, no node is excluded
+		if(s == NULL) continue;
+
+		// v<!l> = v
+		GrB_Vector l = _LabelVector(Graph_GetLabelMatrix(gc->g, s->id));
+		info = GrB_Vector_apply(v, l, NULL, GrB_IDENTITY_BOOL, v,
+				GrB_DESC_RC);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_free(&l);
+	}
+
+	info = GrB_Vector_nvals(&nvals, v);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(op->ids != NULL) array_free(op->ids);
+	op->ids = array_newlen(NodeID, nvals);
+	op->ids_pos = 0;
+
+	info = GrB_Vector_extractTuples_BOOL(op->ids, NULL, &nvals, v);
+	ASSERT(info == GrB_SUCCESS);
+
+	// discard entry points outside of the ID range
+	uint64_t j = 0;
+	for(uint64_t i = 0; i < nvals; i++) {
+		if(op->ids[i] >= minId && op->ids[i] <= maxId) op->ids[j++] = op->ids[i];
+	}
+	op->ids = array_trimm_len(op->ids, j);
+
+	GrB_free(&v);
+}
+
 static GrB_Info _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
 	NodeID minId;
 	NodeID maxId;
@@ -76,6 +203,12 @@ static GrB_Info _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
 	if(op->id_range->include_max) maxId = op->id_range->max;
 	else maxId = op->id_range->max - 1;
 
+	if(NodeByLabelScanOp_MultiLabel(op)) {
+		op->n.label_id = schema->id;
+		_ConstructIDs(op, minId, maxId);
+		return GrB_SUCCESS;
+	}
+
 	info = RG_MatrixTupleIter_new(&(op->iter), L);
 	ASSERT(info == GrB_SUCCESS);
 
@@ -90,6 +223,7 @@ static GrB_Info _ConstructIterator(NodeByLabelScan *op, Schema *schema) {
 static OpResult NodeByLabelScanInit(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase_UpdateConsume(opBase, NodeByLabelScanConsume); // Default consume function.
+	OpBase_UpdateConsumeBatch(opBase, NULL);
 
 	// Operation has children, consume from child.
 	if(opBase->childCount > 0) {
@@ -116,29 +250,73 @@ static OpResult NodeByLabelScanInit(OpBase *opBase) {
 		return OP_OK;
 	}
 
+	// Scanning the label matrix, records can be produced in batches.
+	OpBase_UpdateConsumeBatch(opBase, NodeByLabelScanConsumeBatch);
+
 	return OP_OK;
 }
 
 static inline void _UpdateRecord(NodeByLabelScan *op, Record r, GrB_Index node_id) {
-	// Populate the Record with the graph entity data.
-	Node n = GE_NEW_NODE();
-	Graph_GetNode(op->g, node_id, &n);
-	Record_AddNode(r, op->nodeRecIdx, n);
+	// Populate the Record with the node's ID,
+	// its entity is retrieved only if accessed.
+	Record_AddNode(r, op->nodeRecIdx, GE_LAZY_NODE(node_id));
 }
 
 static inline void _ResetIterator(NodeByLabelScan *op) {
 	NodeID minId = op->id_range->include_min ? op->id_range->min : op->id_range->min + 1;
 	NodeID maxId = op->id_range->include_max ? op->id_range->max : op->id_range->max - 1 ;
+
+	// recompute entry points, labels might have been modified
+	if(NodeByLabelScanOp_MultiLabel(op)) {
+		if(op->ids != NULL) _ConstructIDs(op, minId, maxId);
+		return;
+	}
+
 	RG_MatrixTupleIter_iterate_range(op->iter, minId, maxId);
 }
 
+// advance to the next scanned node
+// returns false once the scan is depleted
+static inline bool _NextID(NodeByLabelScan *op, GrB_Index *node_id) {
+	if(NodeByLabelScanOp_MultiLabel(op)) {
+		if(op->ids == NULL || op->ids_pos == array_len(op->ids)) return false;
+		*node_id = op->ids[op->ids_pos++];
+		return true;
+	}
+
+	bool depleted = true;
+	RG_MatrixTupleIter_next(op->iter, NULL, node_id, NULL, &depleted);
+	return !depleted;
+}
+
+uint64_t NodeByLabelScanOp_Skip(NodeByLabelScan *op, uint64_t n) {
+	ASSERT(op != NULL);
+	ASSERT(op->op.childCount == 0);
+
+	// Missing label or invalid range, nothing to skip.
+	if(op->iter == NULL && op->ids == NULL) return 0;
+
+	// Entry points were computed up front, jump over them.
+	if(NodeByLabelScanOp_MultiLabel(op)) {
+		uint64_t remaining = array_len(op->ids) - op->ids_pos;
+		if(n > remaining) n = remaining;
+		op->ids_pos += n;
+		return n;
+	}
+
+	// Walk the label matrix without fetching the skipped nodes.
+	uint64_t skipped = 0;
+	GrB_Index nodeId;
+	while(skipped < n && _NextID(op, &nodeId)) skipped++;
+	return skipped;
+}
+
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 
 	// Try to get new nodeID.
 	GrB_Index nodeId;
-	bool depleted = true;
-	RG_MatrixTupleIter_next(op->iter, NULL, &nodeId, NULL, &depleted);
+	bool depleted = !_NextID(op, &nodeId);
 	/* depleted will be true in the following cases:
 	 * 1. No iterator: GxB_MatrixTupleIter_next will fail and depleted will stay true. This scenario means
 	 * that there was no consumption of a record from a child, otherwise there was an iterator.
@@ -152,7 +330,7 @@ static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 		if(op->child_record == NULL) return NULL;
 
 		// Got a record.
-		if(!op->iter) {
+		if(!op->iter && !op->ids) {
 			// Iterator wasn't set up until now.
 			GraphContext *gc = QueryCtx_GetGraphCtx();
 			Schema *schema = GraphContext_GetSchema(gc, op->n.label, SCHEMA_NODE);
@@ -165,7 +343,7 @@ static Record NodeByLabelScanConsumeFromChild(OpBase *opBase) {
 			_ResetIterator(op);
 		}
 		// Try to get new NodeID.
-		RG_MatrixTupleIter_next(op->iter, NULL, &nodeId, NULL, &depleted);
+		depleted = !_NextID(op, &nodeId);
 	}
 
 	// We've got a record and NodeID.
@@ -180,9 +358,7 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 
 	GrB_Index nodeId;
-	bool depleted = false;
-	RG_MatrixTupleIter_next(op->iter, NULL, &nodeId, NULL, &depleted);
-	if(depleted) return NULL;
+	if(!_NextID(op, &nodeId)) return NULL;
 
 	Record r = OpBase_CreateRecord((OpBase *)op);
 
@@ -192,6 +368,23 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	return r;
 }
 
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	uint n = 0;
+	GrB_Index nodeId;
+	while(n < cap) {
+		if(!_NextID(op, &nodeId)) break;
+
+		Record r = OpBase_CreateRecord(opBase);
+		// Populate the Record with the actual node.
+		_UpdateRecord(op, r, nodeId);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 /* This function is invoked when the op has no children and no valid label is requested (either no label, or non existing label).
  * The op simply needs to return NULL */
 static Record NodeByLabelScanNoOp(OpBase *opBase) {
@@ -212,6 +405,12 @@ static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opB
 	ASSERT(opBase->type == OPType_NODE_BY_LABEL_SCAN);
 	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
 	OpBase *clone = NewNodeByLabelScanOp(plan, op->n);
+	if(op->labels != NULL) {
+		array_clone(((NodeByLabelScan *)clone)->labels, op->labels);
+	}
+	if(op->excluded != NULL) {
+		array_clone(((NodeByLabelScan *)clone)->excluded, op->excluded);
+	}
 	return clone;
 }
 
@@ -223,6 +422,21 @@ static void NodeByLabelScanFree(OpBase *op) {
 		nodeByLabelScan->iter = NULL;
 	}
 
+	if(nodeByLabelScan->labels) {
+		array_free(nodeByLabelScan->labels);
+		nodeByLabelScan->labels = NULL;
+	}
+
+	if(nodeByLabelScan->excluded) {
+		array_free(nodeByLabelScan->excluded);
+		nodeByLabelScan->excluded = NULL;
+	}
+
+	if(nodeByLabelScan->ids) {
+		array_free(nodeByLabelScan->ids);
+		nodeByLabelScan->ids = NULL;
+	}
+
 	if(nodeByLabelScan->child_record) {
 		OpBase_DeleteRecord(nodeByLabelScan->child_record);
 		nodeByLabelScan->child_record = NULL;
@@ -24,6 +24,10 @@ typedef struct {
 	unsigned int nodeRecIdx;    // Node position within record
 	UnsignedRange *id_range;    // ID range to iterate over
 	RG_MatrixTupleIter *iter;
+	const char **labels;        // Additional labels scanned nodes must carry
+	const char **excluded;      // Labels scanned nodes must not carry
+	NodeID *ids;                // Multi-label entry points, computed up front
+	uint64_t ids_pos;           // Position of the next entry point within ids
 	Record child_record;        // The Record this op acts on if it is not a tap
 } NodeByLabelScan;
 
@@ -33,3 +37,17 @@ OpBase *NewNodeByLabelScanOp(const ExecutionPlan *plan, NodeScanCtx n);
 /* Transform a simple label scan to perform additional range query over the label  matrix. */
 void NodeByLabelScanOp_SetIDRange(NodeByLabelScan *op, UnsignedRange *id_range);
 
+/* Require scanned nodes to carry 'label' in addition to the scanned label.
+ * Entry points are computed as the intersection of the labels' diagonals. */
+void NodeByLabelScanOp_IntersectLabel(NodeByLabelScan *op, const char *label);
+
+/* Require scanned nodes not to carry 'label'. */
+void NodeByLabelScanOp_ExcludeLabel(NodeByLabelScan *op, const char *label);
+
+/* Skip over the next 'n' nodes without producing records for them.
+ * Returns the number of nodes skipped, fewer than 'n' once depleted. */
+uint64_t NodeByLabelScanOp_Skip(NodeByLabelScan *op, uint64_t n);
+
+/* Returns true if the scan considers labels other than its scanned label. */
+bool NodeByLabelScanOp_MultiLabel(const NodeByLabelScan *op);
+
@@ -9,6 +9,7 @@
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
 #include "../../query_ctx.h"
+#include "../../effects/effects.h"
 
 /* Forward declarations. */
 static Record ProcCallConsume(OpBase *opBase);
@@ -66,6 +67,7 @@ OpBase *NewProcCallOp
 	op->yield_map   =  NULL;
 	op->first_call  =  true;
 	op->yield_exps  =  yield_exps;
+	op->hint.output =  NULL;
 
 	// procedure must exist
 	op->procedure = Proc_Get(proc_name);
@@ -122,6 +124,7 @@ static Record ProcCallConsume(OpBase *opBase) {
 		// TODO: replace with Proc_Reset
 		Proc_Free(op->procedure);
 		op->procedure = Proc_Get(op->proc_name);
+		Procedure_SetOrderHint(op->procedure, op->hint);
 
 		// at the moment the only two procedures that can modify the graph are:
 		// proc_fulltext_create_index
@@ -133,7 +136,12 @@ static Record ProcCallConsume(OpBase *opBase) {
 		// introduced
 
 		// lock if procedure can modify the graph
-		if(!Procedure_IsReadOnly(op->procedure)) QueryCtx_LockForCommit();
+		// procedure modifications aren't described as effects
+		// the query is replicated as is
+		if(!Procedure_IsReadOnly(op->procedure)) {
+			QueryCtx_LockForCommit();
+			EffectsBuffer_Invalidate(QueryCtx_GetEffectsBuffer());
+		}
 
 		ProcedureResult res = Proc_Invoke(op->procedure, op->args, op->output);
 
@@ -161,7 +169,10 @@ static OpBase *ProcCallClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	AR_ExpNode **yield_exps;
 	array_clone_with_cb(args_exp, op->arg_exps, AR_EXP_Clone);
 	array_clone_with_cb(yield_exps, op->yield_exps, AR_EXP_Clone);
-	return NewProcCallOp(plan, op->proc_name, args_exp, yield_exps);
+	OpProcCall *clone = (OpProcCall *)NewProcCallOp(plan, op->proc_name,
+			args_exp, yield_exps);
+	clone->hint = op->hint;
+	return (OpBase *)clone;
 }
 
 static void ProcCallFree(OpBase *ctx) {
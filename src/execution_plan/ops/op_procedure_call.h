@@ -31,6 +31,7 @@ typedef struct {
     AR_ExpNode **yield_exps;    // Yield expressions.
 	ProcedureCtx *procedure;    // Procedure to call.
 	OutputMap *yield_map;       // Maps between yield to procedure output and record idx.
+	ProcedureOrderHint hint;    // Records retained by consumers, passed to procedure.
     bool first_call;            // Indicate first call.
 } OpProcCall;
 
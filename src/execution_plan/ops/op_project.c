@@ -13,21 +13,27 @@
 
 /* Forward declarations. */
 static Record ProjectConsume(OpBase *opBase);
+static uint ProjectConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ProjectFree(OpBase *opBase);
 
 OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	OpProject *op = rm_malloc(sizeof(OpProject));
 	op->exps = exps;
+	op->compiled = NULL;
 	op->singleResponse = false;
 	op->exp_count = array_len(exps);
 	op->record_offsets = array_new(uint, op->exp_count);
 	op->r = NULL;
 	op->projection = NULL;
+	op->staging = NULL;
+	op->src_mapping = NULL;
+	op->src_offsets = rm_malloc(sizeof(int) * op->exp_count);
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_PROJECT, "Project", NULL, ProjectConsume,
 				NULL, NULL, ProjectClone, ProjectFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, ProjectConsumeBatch);
 
 	for(uint i = 0; i < op->exp_count; i ++) {
 		// The projected record will associate values with their resolved name
@@ -36,9 +42,145 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 		array_append(op->record_offsets, record_idx);
 	}
 
+	// batches are prefetched if any projection reads attributes
+	rax *attributes = raxNew();
+	for(uint i = 0; i < op->exp_count; i++) {
+		AR_EXP_CollectAttributes(op->exps[i], attributes);
+	}
+	op->prefetch = raxSize(attributes) > 0;
+	raxFree(attributes);
+
 	return (OpBase *)op;
 }
 
+// resolves the input offset of each projected variable against 'r' mapping
+static void _ResolveSources(OpProject *op, const Record r) {
+	op->src_mapping = r->mapping;
+
+	for(uint i = 0; i < op->exp_count; i++) {
+		AR_ExpNode *exp = op->exps[i];
+		op->src_offsets[i] = INVALID_INDEX;
+		// compiled expressions resolve their aliases against the new mapping
+		if(op->compiled != NULL) op->compiled[i] = AR_EXP_Compile(exp);
+		if(!AR_EXP_IsVariadic(exp)) continue;
+		op->src_offsets[i] = Record_GetEntryIdx(r,
+				exp->operand.variadic.entity_alias);
+	}
+}
+
+// returns true if the i'th projection can be moved out of 'r'
+static inline bool _Movable(const OpProject *op, const Record r, uint i) {
+	int src = op->src_offsets[i];
+	if(src == INVALID_INDEX) return false;
+
+	RecordEntryType t = Record_GetType(r, src);
+	return (t == REC_TYPE_NODE || t == REC_TYPE_EDGE || t == REC_TYPE_SCALAR);
+}
+
+// sets entry 'src' of 'from' at position 'dst' of 'to'
+// owned scalars are transferred, 'from' retains access to but not ownership
+// of them, scalars 'from' doesn't own are persisted
+static void _MoveEntry(Record to, uint dst, Record from, uint src) {
+	Entry *e = to->entries + dst;
+	*e = from->entries[src];
+	if(e->type != REC_TYPE_SCALAR) return;
+
+	SIAllocation allocation = e->value.s.allocation;
+	if(allocation == M_SELF || allocation == M_INTERN || allocation == M_SHARED) {
+		SIValue_MakeVolatile(&from->entries[src].value.s);
+	} else {
+		SIValue_Persist(&e->value.s);
+	}
+}
+
+// evaluates the i'th projected expression into 'r'
+static void _EvaluateInto(OpProject *op, Record r, uint i) {
+	SIValue v = (op->compiled != NULL)
+		? AR_CompiledExp_Evaluate(op->compiled + i, op->r)
+		: AR_EXP_Evaluate(op->exps[i], op->r);
+	int rec_idx = op->record_offsets[i];
+	/* Persisting a value is only necessary here if 'v' refers to a scalar held in Record 'r'.
+	 * Graph entities don't need to be persisted here as Record_Add will copy them internally.
+	 * The RETURN projection here requires persistence:
+	 * MATCH (a) WITH toUpper(a.name) AS e RETURN e
+	 * TODO This is a rare case; the logic of when to persist can be improved.  */
+	if(!(v.type & SI_GRAPHENTITY)) SIValue_Persist(&v);
+	Record_Add(r, rec_idx, v);
+	/* If the value was a graph entity with its own allocation, as with a query like:
+	 * MATCH p = (src) RETURN nodes(p)[0]
+	 * Ensure that the allocation is freed here. */
+	if((v.type & SI_GRAPHENTITY)) SIValue_Free(v);
+}
+
+// project op->r in place, only computed expressions are evaluated
+static Record _ProjectInPlace(OpProject *op) {
+	Record r = op->r;
+	Record staging = op->staging;
+
+	// evaluate every expression prior to modifying the record
+	// as expressions may refer to entries which are about to be overwritten
+	for(uint i = 0; i < op->exp_count; i++) {
+		int dst = op->record_offsets[i];
+		if(op->src_offsets[i] == dst && _Movable(op, r, i)) {
+			// variable projected onto itself, keep it as is
+			if(Record_GetType(r, dst) == REC_TYPE_SCALAR) {
+				SIValue_Persist(&r->entries[dst].value.s);
+			}
+			continue;
+		}
+		_EvaluateInto(op, staging, i);
+	}
+
+	// migrate computed values into the record
+	for(uint i = 0; i < op->exp_count; i++) {
+		int dst = op->record_offsets[i];
+		if(Record_GetType(staging, dst) == REC_TYPE_UNKNOWN) continue;
+
+		// release overwritten scalar
+		if(Record_GetType(r, dst) == REC_TYPE_SCALAR) {
+			SIValue_Free(r->entries[dst].value.s);
+		}
+		r->entries[dst] = staging->entries[dst];
+		Record_Remove(staging, dst);
+	}
+
+	// Emit the projected Record once.
+	op->r = NULL;
+	return r;
+}
+
+// project op->r, consuming it
+static Record _ProjectRecord(OpProject *op) {
+	if(op->r->mapping != op->src_mapping) _ResolveSources(op, op->r);
+
+	// input shares the projection's mapping, project in place
+	if(op->r->mapping == ExecutionPlan_GetMappings(op->op.plan)) {
+		// staging record is created on demand, as op->plan's record pool
+		// is only available at execution time
+		if(op->staging == NULL) op->staging = OpBase_CreateRecord((OpBase *)op);
+		return _ProjectInPlace(op);
+	}
+
+	op->projection = OpBase_CreateRecord((OpBase *)op);
+
+	for(uint i = 0; i < op->exp_count; i++) {
+		if(_Movable(op, op->r, i)) {
+			_MoveEntry(op->projection, op->record_offsets[i], op->r,
+					op->src_offsets[i]);
+		} else {
+			_EvaluateInto(op, op->projection, i);
+		}
+	}
+
+	OpBase_DeleteRecord(op->r);
+	op->r = NULL;
+
+	// Emit the projected Record once.
+	Record projection = op->projection;
+	op->projection = NULL;
+	return projection;
+}
+
 static Record ProjectConsume(OpBase *opBase) {
 	OpProject *op = (OpProject *)opBase;
 
@@ -54,32 +196,48 @@ static Record ProjectConsume(OpBase *opBase) {
 		op->r = OpBase_CreateRecord(opBase);
 	}
 
-	op->projection = OpBase_CreateRecord(opBase);
+	return _ProjectRecord(op);
+}
 
-	for(uint i = 0; i < op->exp_count; i++) {
-		AR_ExpNode *exp = op->exps[i];
-		SIValue v = AR_EXP_Evaluate(exp, op->r);
-		int rec_idx = op->record_offsets[i];
-		/* Persisting a value is only necessary here if 'v' refers to a scalar held in Record 'r'.
-		 * Graph entities don't need to be persisted here as Record_Add will copy them internally.
-		 * The RETURN projection here requires persistence:
-		 * MATCH (a) WITH toUpper(a.name) AS e RETURN e
-		 * TODO This is a rare case; the logic of when to persist can be improved.  */
-		if(!(v.type & SI_GRAPHENTITY)) SIValue_Persist(&v);
-		Record_Add(op->projection, rec_idx, v);
-		/* If the value was a graph entity with its own allocation, as with a query like:
-		 * MATCH p = (src) RETURN nodes(p)[0]
-		 * Ensure that the allocation is freed here. */
-		if((v.type & SI_GRAPHENTITY)) SIValue_Free(v);
+// project an entire batch of child records in place
+static uint ProjectConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	OpProject *op = (OpProject *)opBase;
+
+	// no child, produce a single record
+	if(op->op.childCount == 0) {
+		Record r = ProjectConsume(opBase);
+		if(r == NULL) return 0;
+		batch[0] = r;
+		return 1;
 	}
 
-	OpBase_DeleteRecord(op->r);
-	op->r = NULL;
+	OpBase *child = op->op.children[0];
+	uint n = OpBase_ConsumeBatch(child, batch, cap);
+	if(op->prefetch) Record_PrefetchNodes(batch, n);
 
-	// Emit the projected Record once.
-	Record projection = op->projection;
-	op->projection = NULL;
-	return projection;
+	for(uint i = 0; i < n; i++) {
+		op->r = batch[i];
+		batch[i] = _ProjectRecord(op);
+	}
+
+	return n;
+}
+
+void ProjectOp_Compile(OpProject *op) {
+	ASSERT(op != NULL);
+	if(op->compiled != NULL) return;
+
+	AR_CompiledExp *compiled = rm_malloc(sizeof(AR_CompiledExp) * op->exp_count);
+
+	// compiling is worthwhile only if an expression avoids the interpreter
+	bool specialised = false;
+	for(uint i = 0; i < op->exp_count; i++) {
+		compiled[i] = AR_EXP_Compile(op->exps[i]);
+		specialised |= !AR_CompiledExp_Interpreted(compiled + i);
+	}
+
+	if(specialised) op->compiled = compiled;
+	else rm_free(compiled);
 }
 
 static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase) {
@@ -99,11 +257,26 @@ static void ProjectFree(OpBase *ctx) {
 		op->exps = NULL;
 	}
 
+	if(op->compiled) {
+		rm_free(op->compiled);
+		op->compiled = NULL;
+	}
+
 	if(op->record_offsets) {
 		array_free(op->record_offsets);
 		op->record_offsets = NULL;
 	}
 
+	if(op->src_offsets) {
+		rm_free(op->src_offsets);
+		op->src_offsets = NULL;
+	}
+
+	if(op->staging) {
+		OpBase_DeleteRecord(op->staging);
+		op->staging = NULL;
+	}
+
 	if(op->r) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
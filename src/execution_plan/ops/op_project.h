@@ -9,16 +9,29 @@
 #include "op.h"
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
+#include "../../arithmetic/arithmetic_expression_compile.h"
 
 typedef struct {
 	OpBase op;
 	Record r;                       // Input Record being read from (stored to free if we encounter an error).
 	Record projection;              // Record projected by this operation (stored to free if we encounter an error).
 	AR_ExpNode **exps;              // Projected expressions (including order exps).
+	AR_CompiledExp *compiled;       // Compiled projected expressions, NULL if not compiled.
 	uint *record_offsets;           // Record IDs corresponding to each projection (including order exps).
+	int *src_offsets;               // Input Record IDs of projected variables, INVALID_INDEX for computed expressions.
+	rax *src_mapping;               // Input Record mapping src_offsets were resolved against.
+	Record staging;                 // Computed values of a Record projected in place.
 	bool singleResponse;            // When no child operations, return NULL after a first response.
+	bool prefetch;                  // Projections read node attributes, prefetch batches' nodes.
 	uint exp_count;                 // Number of projected expressions.
 } OpProject;
 
+/* Projected variables are moved from the input Record rather than evaluated,
+ * transferring ownership of their values, if the input Record shares the
+ * projection's mapping it is projected in place, only computed expressions
+ * are evaluated and variables projected onto themselves are left as is. */
 OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps);
 
+// compile projected expressions
+// evaluating attribute accesses and constants without the interpreter
+void ProjectOp_Compile(OpProject *op);
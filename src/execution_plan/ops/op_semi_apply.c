@@ -21,7 +21,7 @@ static inline Record _pullFromMatchStream(OpSemiApply *op) {
 }
 
 OpBase *NewSemiApplyOp(const ExecutionPlan *plan, bool anti) {
-	OpSemiApply *op = rm_malloc(sizeof(OpSemiApply));
+	OpSemiApply *op = rm_calloc(1, sizeof(OpSemiApply));
 	op->r = NULL;
 	op->op_arg = NULL;
 	op->bound_branch = NULL;
@@ -50,9 +50,36 @@ static OpResult SemiApplyInit(OpBase *opBase) {
 	// Locate branch's Argument op tap.
 	op->op_arg = (Argument *)ExecutionPlan_LocateOp(op->match_branch, OPType_ARGUMENT);
 	ASSERT(op->op_arg && op->op_arg->op.childCount == 0);
+
+	// single hop patterns are resolved for all bound nodes at once
+	// other deterministic match branches have their outcomes memoized
+	SemiJoin_Init(&op->sj, op->bound_branch, op->match_branch);
+	ApplyMemo_Init(&op->memo, op->bound_branch, op->match_branch);
 	return OP_OK;
 }
 
+/* Sets the bound branch record as an argument for the match branch
+ * and returns true if the match branch produces a record. */
+static bool _matches(OpSemiApply *op) {
+	bool matched;
+	if(SemiJoin_Lookup(&op->sj, op->r, &matched)) return matched;
+	if(ApplyMemo_Lookup(&op->memo, op->r, &matched)) return matched;
+
+	// Propagate record to the top of the Match stream.
+	// (Must clone the Record, as it will be freed in the Match stream.)
+	if(op->op_arg) Argument_AddRecord(op->op_arg, OpBase_CloneRecord(op->r));
+
+	Record rhs_record = _pullFromMatchStream(op);
+	// Reset the match branch to maintain parity with the bound branch.
+	OpBase_PropagateReset(op->match_branch);
+
+	matched = (rhs_record != NULL);
+	if(matched) OpBase_DeleteRecord(rhs_record);
+
+	ApplyMemo_Store(&op->memo, matched);
+	return matched;
+}
+
 /* This function pulls a record from the op's bounded branch, set it as an argument for the op match branch
  * and consumes a record from the match branch. If there is a record from the match branch,
  * the bounded branch record is returned. */
@@ -62,16 +89,9 @@ static Record SemiApplyConsume(OpBase *opBase) {
 		// Try to get a record from bound stream.
 		op->r = OpBase_Consume(op->bound_branch);
 		if(!op->r) return NULL; // Depleted.
-		// Propagate Record to the top of the Match stream.
-		if(op->op_arg) Argument_AddRecord(op->op_arg, OpBase_CloneRecord(op->r));
-
-		Record rhs_record = _pullFromMatchStream(op);
-		// Reset the match branch to maintain parity with the bound branch.
-		OpBase_PropagateReset(op->match_branch);
-		if(rhs_record) {
-			/* Successfully retrieved a Record from the match stream,
-			 * free it and return the bound Record. */
-			OpBase_DeleteRecord(rhs_record);
+
+		if(_matches(op)) {
+			// The match stream produced a Record, return the bound Record.
 			Record r = op->r;
 			op->r = NULL;   // Null to avoid double free.
 			return r;
@@ -91,18 +111,10 @@ static Record AntiSemiApplyConsume(OpBase *opBase) {
 		op->r = OpBase_Consume(op->bound_branch);
 		if(!op->r) return NULL; // Depleted.
 
-		// Propagate record to the top of the Match stream.
-		// (Must clone the Record, as it will be freed in the Match stream.)
-		if(op->op_arg) Argument_AddRecord(op->op_arg, OpBase_CloneRecord(op->r));
 		/* Try to pull data from the right stream,
 		 * returning the bound stream record if unsuccessful. */
-		Record rhs_record = _pullFromMatchStream(op);
-		// Reset the match branch to maintain parity with the bound branch.
-		OpBase_PropagateReset(op->match_branch);
-		if(rhs_record) {
-			/* Successfully retrieved a Record from the match stream,
-			 * free it and pull again from the bound stream. */
-			OpBase_DeleteRecord(rhs_record);
+		if(_matches(op)) {
+			// The match stream produced a Record, pull again from the bound stream.
 			OpBase_DeleteRecord(op->r);
 		} else {
 			// Right stream returned NULL, return left handside record.
@@ -131,6 +143,9 @@ static inline OpBase *SemiApplyClone(const ExecutionPlan *plan, const OpBase *op
 static void SemiApplyFree(OpBase *opBase) {
 	OpSemiApply *op = (OpSemiApply *)opBase;
 
+	SemiJoin_Free(&op->sj);
+	ApplyMemo_Free(&op->memo);
+
 	if(op->r) {
 		OpBase_DeleteRecord(op->r);
 		op->r = NULL;
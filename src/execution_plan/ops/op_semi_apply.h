@@ -8,6 +8,8 @@
 
 #include "op.h"
 #include "op_argument.h"
+#include "shared/semi_join.h"
+#include "shared/apply_memo.h"
 #include "../execution_plan.h"
 
 /* SemiApply operation tests for the presence of a pattern
@@ -26,6 +28,8 @@ typedef struct OpSemiApply {
 	OpBase *bound_branch;           // Bound branch root;
 	OpBase *match_branch;           // Match branch root;
 	Argument *op_arg;               // Match branch tap.
+	SemiJoin sj;                    // Match branch outcomes for all bound nodes.
+	ApplyMemo memo;                 // Memoized match branch outcomes.
 } OpSemiApply;
 
 OpBase *NewSemiApplyOp(const ExecutionPlan *plan, bool anti);
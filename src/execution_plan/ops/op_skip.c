@@ -5,6 +5,10 @@
  */
 
 #include "op_skip.h"
+#include "op_all_node_scan.h"
+#include "op_node_by_id_seek.h"
+#include "op_node_by_label_scan.h"
+#include "op_node_by_index_scan.h"
 #include "../../RG.h"
 #include "../../errors.h"
 #include "../../arithmetic/arithmetic_expression.h"
@@ -41,6 +45,7 @@ OpBase *NewSkipOp(const ExecutionPlan *plan, AR_ExpNode *skip_exp) {
 	op->skip = 0;
 	op->skipped = 0;
 	op->skip_exp = NULL;
+	op->pushdown = false;
 
 	_eval_skip(op, skip_exp);
 
@@ -51,10 +56,43 @@ OpBase *NewSkipOp(const ExecutionPlan *plan, AR_ExpNode *skip_exp) {
 	return (OpBase *)op;
 }
 
+void SkipOp_PushDown(OpSkip *op) {
+	ASSERT(op != NULL);
+	op->pushdown = true;
+}
+
+// skips up to 'n' records within the scan at the bottom of the
+// projections below 'op', returns the number of records skipped
+static uint64_t _SkipInScan(OpSkip *op, uint64_t n) {
+	OpBase *scan = op->op.children[0];
+	while(scan->type == OPType_PROJECT) scan = scan->children[0];
+	ASSERT(scan->childCount == 0);
+
+	switch(scan->type) {
+		case OPType_ALL_NODE_SCAN:
+			return AllNodeScanOp_Skip((AllNodeScan *)scan, n);
+		case OPType_NODE_BY_LABEL_SCAN:
+			return NodeByLabelScanOp_Skip((NodeByLabelScan *)scan, n);
+		case OPType_NODE_BY_ID_SEEK:
+			return NodeByIdSeekOp_Skip((NodeByIdSeek *)scan, n);
+		case OPType_NODE_BY_INDEX_SCAN:
+			return IndexScanOp_Skip((IndexScan *)scan, n);
+		default:
+			ASSERT(false);
+			return 0;
+	}
+}
+
 static Record SkipConsume(OpBase *opBase) {
 	OpSkip *skip = (OpSkip *)opBase;
 	OpBase *child = skip->op.children[0];
 
+	// Let the scan seek past skipped records, whatever it can't skip
+	// is consumed and discarded.
+	if(skip->pushdown && skip->skipped < skip->skip) {
+		skip->skipped += _SkipInScan(skip, skip->skip - skip->skipped);
+	}
+
 	// As long as we're required to skip
 	while(skip->skipped < skip->skip) {
 		Record discard = OpBase_Consume(child);
@@ -86,7 +124,9 @@ static inline OpBase *SkipClone(const ExecutionPlan *plan, const OpBase *opBase)
 	 * as we don't want to modify the templated ExecutionPlan
 	 * (which may occur if this expression is a parameter). */
 	AR_ExpNode *skip_exp = AR_EXP_Clone(op->skip_exp);
-	return NewSkipOp(plan, skip_exp);
+	OpSkip *clone = (OpSkip *)NewSkipOp(plan, skip_exp);
+	clone->pushdown = op->pushdown;
+	return (OpBase *)clone;
 }
 
 static void SkipFree(OpBase *opBase) {
@@ -14,8 +14,13 @@ typedef struct {
 	unsigned int skip;    // number of records to skip
 	unsigned int skipped; // number of records already skipped
 	AR_ExpNode *skip_exp; // expression evaluated to 'skip'
+	bool pushdown;        // skipped records are skipped by the scan below
 } OpSkip;
 
 // Skips 'n' records.
 OpBase *NewSkipOp(const ExecutionPlan *plan, AR_ExpNode *skip_exp);
 
+// Have the scan feeding this operation through projections skip records
+// itself, rather than producing records only to have them discarded.
+void SkipOp_PushDown(OpSkip *op);
+
@@ -4,6 +4,8 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
+#include <omp.h>
+#include <math.h>
 #include "op_sort.h"
 #include "op_project.h"
 #include "op_aggregate.h"
@@ -11,6 +13,10 @@
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
 #include "../../query_ctx.h"
+#include "../../configuration/config.h"
+
+// minimum number of buffered records sorted in parallel
+#define PARALLEL_SORT_THRESHOLD 65536
 
 /* Forward declarations. */
 static OpResult SortInit(OpBase *opBase);
@@ -41,6 +47,69 @@ static bool _record_islt(Record a, Record b, const OpSort *op) {
 		   0; // Return true if the current left element is less than the right.
 }
 
+// Computes an order preserving 64 bit prefix of 'v'
+// the top byte holds the type's rank and the remaining bytes hold the
+// leading bits of an order preserving encoding of the value, such that
+// prefix(a) < prefix(b) implies a < b, values sharing a prefix must be
+// compared in full
+// returns false for values with no such prefix
+static bool _sort_prefix(SIValue v, uint64_t *prefix) {
+	SIType t = SI_TYPE(v);
+	uint64_t bits = 0;
+
+	switch(t) {
+		case T_INT64:
+		case T_DOUBLE: {
+			// integers and doubles compare numerically, share a rank
+			t = T_INT64;
+			double d = SI_GET_NUMERIC(v);
+			if(isnan(d)) return false;
+			if(d == 0) d = 0; // -0.0 equals 0.0
+			memcpy(&bits, &d, sizeof(bits));
+			// flip negatives entirely and positives' sign bit
+			bits = (bits & (1ULL << 63)) ? ~bits : bits ^ (1ULL << 63);
+			bits >>= 8;
+			break;
+		}
+		case T_STRING: {
+			// leading 7 bytes, big endian, as compared by strcmp
+			const unsigned char *str = (const unsigned char *)v.stringval;
+			for(int i = 0; i < 7; i++) {
+				bits <<= 8;
+				if(*str) bits |= *str++;
+			}
+			break;
+		}
+		case T_BOOL:
+			bits = v.longval != 0;
+			break;
+		case T_NODE:
+		case T_EDGE: {
+			uint64_t id = ENTITY_GET_ID((GraphEntity *)v.ptrval);
+			bits = (id < (1ULL << 56)) ? id : (1ULL << 56) - 1;
+			break;
+		}
+		case T_NULL:
+			break;
+		default:
+			return false;
+	}
+
+	uint64_t rank = __builtin_ctzll(t);
+	*prefix = (rank << 56) | bits;
+	return true;
+}
+
+// Quicksort function to compare two buffered records.
+// Same semantics as _record_islt.
+static inline bool _entry_islt(const SortEntry *a, const SortEntry *b,
+		const OpSort *op) {
+	if(a->has_prefix && b->has_prefix && a->prefix != b->prefix) {
+		return a->prefix > b->prefix;
+	}
+	return _record_islt(a->r, b->r, op);
+}
+
 // Compares two heap record nodes.
 static int _heap_elem_compare(const void *A, const void *B, const void *udata) {
 	OpSort *op = (OpSort *)udata;
@@ -52,7 +121,12 @@ static int _heap_elem_compare(const void *A, const void *B, const void *udata) {
 static void _accumulate(OpSort *op, Record r) {
 	if(op->limit == UNLIMITED) {
 		/* Not using a heap and there's room for record. */
-		array_append(op->buffer, r);
+		SortEntry e = {.prefix = 0, .has_prefix = false, .r = r};
+		SIValue v = Record_Get(r, op->record_offsets[0]);
+		e.has_prefix = _sort_prefix(v, &e.prefix);
+		// flip prefix for descending order
+		if(op->directions[0] < 0) e.prefix = ~e.prefix;
+		array_append(op->buffer, e);
 		return;
 	}
 
@@ -72,7 +146,7 @@ static void _accumulate(OpSort *op, Record r) {
 }
 
 static inline Record _handoff(OpSort *op) {
-	if(array_len(op->buffer) > 0) return array_pop(op->buffer);
+	if(array_len(op->buffer) > 0) return array_pop(op->buffer).r;
 	return NULL;
 }
 
@@ -114,7 +188,7 @@ static OpResult SortInit(OpBase *opBase) {
 		op->heap = Heap_new(_heap_elem_compare, op);
 	} else {
 		// If all records are being sorted, use quicksort.
-		op->buffer = array_new(Record, 32);
+		op->buffer = array_new(SortEntry, 32);
 	}
 
 	return OP_OK;
@@ -123,7 +197,73 @@ static OpResult SortInit(OpBase *opBase) {
 /* `op` is an actual variable in the caller function. Using it in a
  * macro like this is rather ugly, but the macro passed to QSORT must
  * accept only 2 arguments. */
-#define RECORD_SORT(a, b) (_record_islt((*a), (*b), op))
+#define RECORD_SORT(a, b) (_entry_islt((a), (b), op))
+
+// merges sorted runs 'a' and 'b' into 'dest'
+static void _merge_runs(const SortEntry *a, uint a_len, const SortEntry *b,
+		uint b_len, SortEntry *dest, const OpSort *op) {
+	uint i = 0;
+	uint j = 0;
+	uint k = 0;
+
+	while(i < a_len && j < b_len) {
+		if(_entry_islt(b + j, a + i, op)) dest[k++] = b[j++];
+		else dest[k++] = a[i++];
+	}
+
+	while(i < a_len) dest[k++] = a[i++];
+	while(j < b_len) dest[k++] = b[j++];
+}
+
+// sorts buffered records
+// large buffers are split into a run per thread, runs are sorted in
+// parallel and merged pairwise, each round of merges running in parallel
+static void _sort_buffer(OpSort *op) {
+	uint n = array_len(op->buffer);
+
+	uint64_t dop;
+	Config_Option_get(Config_QUERY_PARALLELISM, &dop);
+
+	if(dop <= 1 || n < PARALLEL_SORT_THRESHOLD) {
+		QSORT(SortEntry, op->buffer, n, RECORD_SORT);
+		return;
+	}
+
+	uint runs = dop;
+	uint *bounds = rm_malloc(sizeof(uint) * (runs + 1));
+	for(uint i = 0; i <= runs; i++) bounds[i] = ((uint64_t)n * i) / runs;
+
+	SortEntry *src = op->buffer;
+	#pragma omp parallel for num_threads(dop) schedule(static, 1)
+	for(uint i = 0; i < runs; i++) {
+		QSORT(SortEntry, src + bounds[i], bounds[i + 1] - bounds[i],
+				RECORD_SORT);
+	}
+
+	SortEntry *dest = rm_malloc(sizeof(SortEntry) * n);
+	SortEntry *tmp = dest;
+
+	for(uint width = 1; width < runs; width *= 2) {
+		#pragma omp parallel for num_threads(dop) schedule(static, 1)
+		for(uint i = 0; i < runs; i += 2 * width) {
+			uint m   = (i + width < runs) ? i + width : runs;
+			uint h   = (i + 2 * width < runs) ? i + 2 * width : runs;
+			uint lo  = bounds[i];
+			uint mid = bounds[m];
+			uint hi  = bounds[h];
+			_merge_runs(src + lo, mid - lo, src + mid, hi - mid, dest + lo, op);
+		}
+
+		SortEntry *swap = src;
+		src = dest;
+		dest = swap;
+	}
+
+	if(src != op->buffer) memcpy(op->buffer, src, sizeof(SortEntry) * n);
+
+	rm_free(tmp);
+	rm_free(bounds);
+}
 
 static Record SortConsume(OpBase *opBase) {
 	OpSort *op = (OpSort *)opBase;
@@ -133,24 +273,25 @@ static Record SortConsume(OpBase *opBase) {
 	// If we're here, we don't have any records to return
 	// try to get records.
 	OpBase *child = op->op.children[0];
-	bool newData = false;
+	uint64_t consumed = 0;
 	while((r = OpBase_Consume(child))) {
 		_accumulate(op, r);
-		newData = true;
+		// materialisation may take long, check for cancellation periodically
+		if((++consumed & QUERY_CANCEL_CHECK_MASK) == 0) QueryCtx_CheckCancelled();
 	}
-	if(!newData) return NULL;
+	if(consumed == 0) return NULL;
 
 	if(op->buffer) {
-		QSORT(Record, op->buffer, array_len(op->buffer), RECORD_SORT);
+		_sort_buffer(op);
 	} else {
 		// Heap, responses need to be reversed.
 		int records_count = Heap_count(op->heap);
-		op->buffer = array_new(Record, records_count);
+		op->buffer = array_new(SortEntry, records_count);
 
 		/* Pop items from heap */
 		while(records_count > 0) {
-			r = Heap_poll(op->heap);
-			array_append(op->buffer, r);
+			SortEntry e = {.prefix = 0, .has_prefix = false, .r = Heap_poll(op->heap)};
+			array_append(op->buffer, e);
 			records_count--;
 		}
 	}
@@ -175,7 +316,7 @@ static OpResult SortReset(OpBase *ctx) {
 	if(op->buffer) {
 		recordCount = array_len(op->buffer);
 		for(uint i = 0; i < recordCount; i++) {
-			Record r = array_pop(op->buffer);
+			Record r = array_pop(op->buffer).r;
 			OpBase_DeleteRecord(r);
 		}
 	}
@@ -210,7 +351,7 @@ static void SortFree(OpBase *ctx) {
 	if(op->buffer) {
 		uint recordCount = array_len(op->buffer);
 		for(uint i = 0; i < recordCount; i++) {
-			Record r = array_pop(op->buffer);
+			Record r = array_pop(op->buffer).r;
 			OpBase_DeleteRecord(r);
 		}
 		array_free(op->buffer);
@@ -11,11 +11,20 @@
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// record buffered for sorting
+// along with a normalized prefix of its first sort key, such that
+// records whose prefixes differ are ordered by comparing prefixes alone
+typedef struct {
+	uint64_t prefix;            // Order preserving prefix of the first sort key.
+	bool has_prefix;            // First sort key has a prefix.
+	Record r;                   // Buffered record.
+} SortEntry;
+
 typedef struct {
 	OpBase op;
 	uint *record_offsets;       // All Record offsets containing values to sort by.
 	heap_t *heap;               // Holds top n records.
-	Record *buffer;             // Holds all records.
+	SortEntry *buffer;          // Holds all records.
 	uint skip;                  // Total number of records to skip
 	uint limit;                 // Total number of records to produce
 	int *directions;            // Array of sort directions(ascending / desending) for each item.
@@ -35,6 +35,7 @@ OpBase *NewUpdateOp(const ExecutionPlan *plan, rax *update_exps) {
 	op->node_updates       =  NULL;
 	op->edge_updates       =  NULL;
 	op->updates_committed  =  false;
+	op->stream             =  false;
 	op->update_ctxs        =  update_exps;
 	op->gc                 =  QueryCtx_GetGraphCtx();
 
@@ -65,25 +66,74 @@ static OpResult UpdateInit(OpBase *opBase) {
 	return OP_OK;
 }
 
+void UpdateOp_Stream(OpUpdate *op) {
+	ASSERT(op != NULL);
+	op->stream = true;
+}
+
+static void _evalUpdates(OpUpdate *op, Record r) {
+	Record_PersistScalars(r);
+
+	// evaluate update expressions
+	raxSeek(&op->it, "^", NULL, 0);
+	while(raxNext(&op->it)) {
+		EntityUpdateEvalCtx *ctx = op->it.data;
+		EvalEntityUpdates(op->gc, &op->node_updates, &op->edge_updates, r, ctx, true);
+	}
+
+	array_append(op->records, r);
+}
+
+// commits updates one chunk at a time
+// the commit lock is held from the first chunk until the input is depleted
+// such that the query is replicated once
+static Record _UpdateConsumeChunk(OpUpdate *op) {
+	Record r = _handoff(op);
+	if(r != NULL || op->updates_committed) return r;
+
+	OpBase *child = op->op.children[0];
+	uint64_t consumed = 0;
+	while((r = OpBase_Consume(child))) {
+		_evalUpdates(op, r);
+		if(array_len(op->records) == UPDATE_CHUNK_SIZE) break;
+		// no-op once the first chunk acquired the commit lock
+		if((++consumed & QUERY_CANCEL_CHECK_MASK) == 0) QueryCtx_CheckCancelled();
+	}
+
+	// last chunk
+	if(r == NULL) {
+		OpBase_PropagateFree(child);
+		op->updates_committed = true;
+	}
+
+	QueryCtx_LockForCommit();
+	{
+		CommitUpdates(op->gc, op->stats, op->node_updates, ENTITY_NODE);
+		CommitUpdates(op->gc, op->stats, op->edge_updates, ENTITY_EDGE);
+	}
+	array_clear(op->node_updates);
+	array_clear(op->edge_updates);
+
+	if(op->updates_committed) QueryCtx_UnlockCommit((OpBase *)op);
+
+	return _handoff(op);
+}
+
 static Record UpdateConsume(OpBase *opBase) {
 	OpUpdate *op = (OpUpdate *)opBase;
 	OpBase *child = op->op.children[0];
 	Record r;
 
+	if(op->stream) return _UpdateConsumeChunk(op);
+
 	// updates already performed
 	if(op->updates_committed) return _handoff(op);
 
+	uint64_t consumed = 0;
 	while((r = OpBase_Consume(child))) {
-		Record_PersistScalars(r);
-
-		// evaluate update expressions
-		raxSeek(&op->it, "^", NULL, 0);
-		while(raxNext(&op->it)) {
-			EntityUpdateEvalCtx *ctx = op->it.data;
-			EvalEntityUpdates(op->gc, &op->node_updates, &op->edge_updates, r, ctx, true);
-		}
-
-		array_append(op->records, r);
+		_evalUpdates(op, r);
+		// nothing is committed yet, the query can still be cancelled
+		if((++consumed & QUERY_CANCEL_CHECK_MASK) == 0) QueryCtx_CheckCancelled();
 	}
 
 	// done reading; we're not going to call Consume any longer
@@ -110,7 +160,9 @@ static OpBase *UpdateClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	OpUpdate *op = (OpUpdate *)opBase;
 
 	rax *update_ctxs = raxCloneWithCallback(op->update_ctxs, (void *(*)(void *))UpdateCtx_Clone);
-	return NewUpdateOp(plan, update_ctxs);
+	OpUpdate *clone = (OpUpdate *)NewUpdateOp(plan, update_ctxs);
+	clone->stream = op->stream;
+	return (OpBase *)clone;
 }
 
 static OpResult UpdateReset(OpBase *ctx) {
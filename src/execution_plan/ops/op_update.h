@@ -11,6 +11,8 @@
 #include "shared/update_functions.h"
 #include "../../resultset/resultset_statistics.h"
 
+#define UPDATE_CHUNK_SIZE 1024
+
 typedef struct {
 	OpBase op;
 	raxIterator it;                 // Iterator for traversing update contexts
@@ -18,6 +20,7 @@ typedef struct {
 	GraphContext *gc;
 	rax *update_ctxs;               // Entities to update and their expressions
 	bool updates_committed;         // True if we've already committed updates and are now in handoff mode.
+	bool stream;                    // True if updates are committed in chunks
 	PendingUpdateCtx *node_updates; // Enqueued node updates
 	PendingUpdateCtx *edge_updates; // Enqueued edge updates
 	ResultSetStatistics *stats;
@@ -25,3 +28,10 @@ typedef struct {
 
 OpBase *NewUpdateOp(const ExecutionPlan *plan, rax *update_exps);
 
+/* commit updates in chunks of UPDATE_CHUNK_SIZE records rather than
+ * buffering the entire input, records are handed off once their chunk
+ * is committed
+ * only valid if the updates can't affect the records read by the operation
+ * or by the rest of the plan, see streamUpdates */
+void UpdateOp_Stream(OpUpdate *op);
+
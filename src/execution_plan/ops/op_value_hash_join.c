@@ -8,7 +8,6 @@
 #include "../../value.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
-#include "../../util/qsort.h"
 
 /* Forward declarations. */
 static OpResult ValueHashJoinInit(OpBase *opBase);
@@ -17,155 +16,149 @@ static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-/* Determins order between two records by inspecting
- * element stored at postion idx. */
-static bool _record_islt(Record l, Record r, uint idx) {
-	SIValue lv = Record_Get(l, idx);
-	SIValue rv = Record_Get(r, idx);
-	return SIValue_Compare(lv, rv, NULL) < 0;
-}
-
-/* `idx` is an actual variable in the caller function.
- * Using it in a macro like this is rather ugly,
- * but the macro passed to QSORT must accept only 2 arguments. */
-#define RECORD_SORT_ON_ENTRY(a, b) (_record_islt((*a), (*b), idx))
-
-// Performs binary search, returns the leftmost index of a match.
-static bool _binarySearchLeftmost(uint *idx, Record *array, uint array_len,
-								  int join_key_idx, SIValue v) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
-		else right = pos;
+// hash joined value
+// integral values, the common join key, are mixed directly
+// rather than fed through the generic value hash
+// integral doubles hash as integers as they compare equal to them
+static inline XXH64_hash_t _join_hash(SIValue v) {
+	int64_t i;
+	SIType t = SI_TYPE(v);
+
+	if(t == T_INT64) {
+		i = v.longval;
+	} else if(t == T_DOUBLE && v.doubleval >= (double)INT64_MIN &&
+			  v.doubleval < (double)INT64_MAX &&
+			  v.doubleval == (double)(int64_t)v.doubleval) {
+		i = (int64_t)v.doubleval;
+	} else {
+		return SIValue_HashCode(v);
 	}
 
-	// Make sure value was found.
-	*idx = left;
-
-	if(left == array_len) return false;
-
-	x = Record_Get(array[*idx], join_key_idx);
-	// Return false if the value wasn't found or evaluated to NULL.
-	int disjointOrNull = 0;
-	return (SIValue_Compare(x, v, &disjointOrNull) == 0 &&
-			disjointOrNull != COMPARED_NULL);
+	// splitmix64 finalizer
+	uint64_t x = (uint64_t)i;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
 }
 
-// Performs binary search, returns the rightmost index of a match.
-// assuming 'v' exists in 'array'
-static bool _binarySearchRightmost(uint *idx, Record *array, uint array_len, int join_key_idx,
-								   SIValue v) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
-		else left = pos + 1;
+// returns true if joined values match
+static inline bool _join_match(SIValue a, SIValue b) {
+	if(SI_TYPE(a) == T_INT64 && SI_TYPE(b) == T_INT64) {
+		return a.longval == b.longval;
 	}
 
-	*idx = right - 1;
-	return true;
+	// values evaluated to NULL don't match
+	int disjointOrNull = 0;
+	return (SIValue_Compare(a, b, &disjointOrNull) == 0 &&
+			disjointOrNull != COMPARED_NULL);
 }
 
-/* Retrive the next intersecting record
+/* Retrive the next cached record intersecting
+ * with the current right hand side record
  * if such exists, otherwise returns NULL. */
 static Record _get_intersecting_record(OpValueHashJoin *op) {
-	// No more intersecting records.
-	if(op->intersect_idx == -1 ||
-	   op->number_of_intersections == 0) return NULL;
-
-	Record cr = op->cached_records[op->intersect_idx];
-
-	// Update intersection trackers.
-	op->intersect_idx++;
-	op->number_of_intersections--;
+	while(op->probe != -1) {
+		int64_t i = op->probe;
+		op->probe = op->chain[i];
 
-	return cr;
-}
-
-/* Look up first intersecting cached record CR position.
- * Returns false if no intersecting record is found. */
-static bool _set_intersection_idx(OpValueHashJoin *op, SIValue v) {
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-	uint record_count = array_len(op->cached_records);
+		if(op->hashes[i] != op->rhs_hash) continue;
 
-	uint leftmost_idx = 0;
-	uint rightmost_idx = 0;
-
-	if(!_binarySearchLeftmost(&leftmost_idx, op->cached_records,
-							  array_len(op->cached_records), op->join_value_rec_idx, v)) {
-		return false;
+		Record cr = op->cached_records[i];
+		SIValue x = Record_Get(cr, op->join_value_rec_idx);
+		if(_join_match(x, op->rhs_value)) return cr;
 	}
 
-	/* Value was found
-	 * idx points to the first intersecting record.
-	 * update number_of_intersections to count how many
-	 * records share the same value. */
-	op->intersect_idx = leftmost_idx;
-
-	/* Count how many records share the same node.
-	 * reduce search space by truncating left bound */
-	bool found = _binarySearchRightmost(&rightmost_idx, op->cached_records +
-								  leftmost_idx, record_count - leftmost_idx,
-								  op->join_value_rec_idx, v);
-	UNUSED(found);
-	ASSERT(found == true);
-
-	// Compensate index.
-	rightmost_idx += leftmost_idx;
-	// +1 consider rightmost_idx == leftmost_idx.
-	op->number_of_intersections = rightmost_idx - leftmost_idx + 1;
-	ASSERT(op->number_of_intersections > 0);
-
-	return true;
+	return NULL;
 }
 
-/* Sorts cached records by joined value. */
-void _sort_cached_records(OpValueHashJoin *op) {
-	uint idx = op->join_value_rec_idx;
-	QSORT(Record, op->cached_records,
-		  array_len(op->cached_records), RECORD_SORT_ON_ENTRY);
+/* Discard current right hand side record. */
+static void _discard_rhs_record(OpValueHashJoin *op) {
+	if(!op->rhs_rec) return;
+
+	SIValue_Free(op->rhs_value);
+	op->rhs_value = SI_NullVal();
+	OpBase_DeleteRecord(op->rhs_rec);
+	op->rhs_rec = NULL;
+	op->probe = -1;
 }
 
 /* Caches all records coming from left branch. */
-void _cache_records(OpValueHashJoin *op) {
+static void _cache_records(OpValueHashJoin *op) {
 	ASSERT(op->cached_records == NULL);
 
 	OpBase *left_child = op->op.children[0];
 	op->cached_records = array_new(Record, 32);
+	op->hashes = array_new(XXH64_hash_t, 32);
 
-	Record r = left_child->consume(left_child);
-	if(!r) return;
-
+	Record r;
 	// As long as there's data coming in from left branch.
-	do {
+	while((r = left_child->consume(left_child))) {
 		// Evaluate joined expression.
 		SIValue v = AR_EXP_Evaluate(op->lhs_exp, r);
 
 		// If the joined value is NULL, it cannot be compared to other values - skip this record.
-		if(SIValue_IsNull(v)) continue;
+		if(SIValue_IsNull(v)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
 
 		// Add joined value to record.
 		Record_AddScalar(r, op->join_value_rec_idx, v);
 
 		// Cache the record.
 		array_append(op->cached_records, r);
-	} while((r = left_child->consume(left_child)));
+		array_append(op->hashes, _join_hash(v));
+	}
+}
+
+/* Builds hash table over cached records.
+ * records sharing a bucket are chained in the order they were cached. */
+static void _build_hash_table(OpValueHashJoin *op) {
+	uint record_count = array_len(op->cached_records);
+
+	// a bucket per cached record, rounded up to a power of two
+	uint64_t bucket_count = 1;
+	while(bucket_count < record_count) bucket_count <<= 1;
+
+	op->bucket_mask = bucket_count - 1;
+	op->buckets = rm_malloc(sizeof(int64_t) * bucket_count);
+	op->chain = rm_malloc(sizeof(int64_t) * (record_count + 1));
+	for(uint64_t i = 0; i < bucket_count; i++) op->buckets[i] = -1;
+
+	// link records in reverse, such that chains start at the earliest record
+	for(int64_t i = (int64_t)record_count - 1; i >= 0; i--) {
+		uint64_t b = op->hashes[i] & op->bucket_mask;
+		op->chain[i] = op->buckets[b];
+		op->buckets[b] = i;
+	}
+}
+
+/* Free cached records and hash table. */
+static void _free_hash_table(OpValueHashJoin *op) {
+	if(op->cached_records) {
+		uint record_count = array_len(op->cached_records);
+		for(uint i = 0; i < record_count; i++) {
+			Record r = op->cached_records[i];
+			OpBase_DeleteRecord(r);
+		}
+		array_free(op->cached_records);
+		op->cached_records = NULL;
+	}
+
+	if(op->hashes) {
+		array_free(op->hashes);
+		op->hashes = NULL;
+	}
+
+	if(op->buckets) {
+		rm_free(op->buckets);
+		op->buckets = NULL;
+	}
+
+	if(op->chain) {
+		rm_free(op->chain);
+		op->chain = NULL;
+	}
 }
 
 /* String representation of operation */
@@ -196,11 +189,16 @@ static void ValueHashJoinToString(const OpBase *ctx, sds *buff) {
 OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpNode *rhs_exp) {
 	OpValueHashJoin *op = rm_malloc(sizeof(OpValueHashJoin));
 	op->rhs_rec = NULL;
+	op->rhs_value = SI_NullVal();
+	op->rhs_hash = 0;
 	op->lhs_exp = lhs_exp;
 	op->rhs_exp = rhs_exp;
-	op->intersect_idx = -1;
 	op->cached_records = NULL;
-	op->number_of_intersections = 0;
+	op->hashes = NULL;
+	op->buckets = NULL;
+	op->chain = NULL;
+	op->bucket_mask = 0;
+	op->probe = -1;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_VALUE_HASH_JOIN, "Value Hash Join", ValueHashJoinInit,
@@ -226,8 +224,8 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 	// Eager, pull from left branch until depleted.
 	if(op->cached_records == NULL) {
 		_cache_records(op);
-		// Sort cache on intersect node ID.
-		_sort_cached_records(op);
+		// Hash cache on joined value.
+		_build_hash_table(op);
 	}
 
 	/* Try to produce a record:
@@ -240,8 +238,9 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 	 * X merged with R. */
 
 	Record l;
-	if(op->number_of_intersections > 0) {
-		while((l = _get_intersecting_record(op))) {
+	if(op->rhs_rec) {
+		l = _get_intersecting_record(op);
+		if(l) {
 			// Clone cached record before merging rhs.
 			Record c = OpBase_CloneRecord(l);
 			Record_Merge(c, op->rhs_rec);
@@ -252,7 +251,7 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 	/* If we're here there are no more
 	 * left hand side records which intersect with R
 	 * discard R. */
-	if(op->rhs_rec) OpBase_DeleteRecord(op->rhs_rec);
+	_discard_rhs_record(op);
 
 	/* Try to get new right hand side record
 	 * which intersect with a left hand side record. */
@@ -262,18 +261,21 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 		if(!op->rhs_rec) return NULL;
 
 		// Get value on which we're intersecting.
-		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
-
-		bool found_intersection = _set_intersection_idx(op, v);
-		SIValue_Free(v);
-		// No intersection, discard R.
-		if(!found_intersection) {
-			OpBase_DeleteRecord(op->rhs_rec);
+		op->rhs_value = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
+		if(SIValue_IsNull(op->rhs_value)) {
+			_discard_rhs_record(op);
 			continue;
 		}
 
-		// Found atleast one intersecting record.
+		op->rhs_hash = _join_hash(op->rhs_value);
+		op->probe = op->buckets[op->rhs_hash & op->bucket_mask];
+
 		l = _get_intersecting_record(op);
+		// No intersection, discard R.
+		if(!l) {
+			_discard_rhs_record(op);
+			continue;
+		}
 
 		// Clone cached record before merging rhs.
 		Record c = OpBase_CloneRecord(l);
@@ -285,24 +287,10 @@ static Record ValueHashJoinConsume(OpBase *opBase) {
 
 static OpResult ValueHashJoinReset(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
 
 	// Clear cached records.
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
-
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_discard_rhs_record(op);
+	_free_hash_table(op);
 
 	return OP_OK;
 }
@@ -317,20 +305,8 @@ static inline OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase
 static void ValueHashJoinFree(OpBase *ctx) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
 	// Free cached records.
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
-
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	_discard_rhs_record(op);
+	_free_hash_table(op);
 
 	if(op->lhs_exp) {
 		AR_EXP_Free(op->lhs_exp);
@@ -342,4 +318,3 @@ static void ValueHashJoinFree(OpBase *ctx) {
 		op->rhs_exp = NULL;
 	}
 }
-
@@ -9,16 +9,22 @@
 #include "op.h"
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
+#include "xxhash.h"
 
 typedef struct {
 	OpBase op;
 	Record rhs_rec;                     // Right hand side record.
+	SIValue rhs_value;                  // Joined value of the right hand side record.
+	XXH64_hash_t rhs_hash;              // Hash of the right hand side joined value.
 	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
 	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
-	int64_t intersect_idx;              // Current intersection, < number_of_intersections
 	Record *cached_records;             // Cached left hand side records.
+	XXH64_hash_t *hashes;               // Hash of each cached record joined value.
+	int64_t *buckets;                   // First cached record of each bucket, -1 if empty.
+	int64_t *chain;                     // Next cached record within bucket, -1 if last.
+	uint64_t bucket_mask;               // Number of buckets - 1.
+	int64_t probe;                      // Next cached record to match against rhs_rec.
 	uint join_value_rec_idx;            // position on joined expression within record.
-	int64_t number_of_intersections;    // Number of intersections located.
 } OpValueHashJoin;
 
 /* Creates a new ValueHashJoin operation */
@@ -0,0 +1,262 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "RG.h"
+#include "apply_memo.h"
+#include "../op_filter.h"
+#include "../op_expand_into.h"
+#include "../op_conditional_traverse.h"
+#include "../../../util/arr.h"
+#include "../../../util/rax_extensions.h"
+#include "../../execution_plan_build/execution_plan_modify.h"
+
+// memoized outcomes, rax values can't be NULL
+#define OUTCOME_TRUE  ((void *)2)
+#define OUTCOME_FALSE ((void *)1)
+
+// operations which produce the same records given the same argument
+static const OPType _memoizable[] = {
+	OPType_ARGUMENT,
+	OPType_FILTER,
+	OPType_CONDITIONAL_TRAVERSE,
+	OPType_EXPAND_INTO,
+	OPType_ALL_NODE_SCAN,
+	OPType_NODE_BY_LABEL_SCAN,
+	OPType_NODE_BY_INDEX_SCAN,
+	OPType_NODE_BY_ID_SEEK,
+	OPType_NODE_BY_LABEL_AND_ID_SCAN,
+	OPType_CARTESIAN_PRODUCT,
+};
+
+static void _collectTraversed(const AlgebraicExpression *ae, rax *refs) {
+	const char *aliases[3] = {AlgebraicExpression_Src((AlgebraicExpression *)ae),
+		AlgebraicExpression_Dest((AlgebraicExpression *)ae),
+		AlgebraicExpression_Edge(ae)};
+	for(int i = 0; i < 3; i++) {
+		if(aliases[i] == NULL) continue;
+		raxTryInsert(refs, (unsigned char *)aliases[i], strlen(aliases[i]),
+				NULL, NULL);
+	}
+}
+
+// collects the aliases referred to by 'op' and its children into 'refs'
+// returns false if 'op' might produce different records for the same input
+static bool _collectReferences(const OpBase *op, rax *refs) {
+	bool memoizable = false;
+	uint n = sizeof(_memoizable) / sizeof(_memoizable[0]);
+	for(uint i = 0; i < n && !memoizable; i++) {
+		memoizable = (op->type == _memoizable[i]);
+	}
+	if(!memoizable) return false;
+
+	if(op->type == OPType_FILTER) {
+		const FT_FilterNode *tree = ((const OpFilter *)op)->filterTree;
+		if(!FilterTree_Deterministic(tree)) return false;
+		rax *filtered = FilterTree_CollectModified(tree);
+		raxIterator it;
+		raxStart(&it, filtered);
+		raxSeek(&it, "^", NULL, 0);
+		while(raxNext(&it)) raxTryInsert(refs, it.key, it.key_len, NULL, NULL);
+		raxStop(&it);
+		raxFree(filtered);
+	} else if(op->type == OPType_CONDITIONAL_TRAVERSE) {
+		_collectTraversed(((const OpCondTraverse *)op)->ae, refs);
+	} else if(op->type == OPType_EXPAND_INTO) {
+		_collectTraversed(((const OpExpandInto *)op)->ae, refs);
+	}
+
+	for(int i = 0; i < op->childCount; i++) {
+		if(!_collectReferences(op->children[i], refs)) return false;
+	}
+
+	return true;
+}
+
+// true if any operation within the plan modifies the graph
+static bool _planWrites(const OpBase *op) {
+	if(op->writer) return true;
+	for(int i = 0; i < op->childCount; i++) {
+		if(_planWrites(op->children[i])) return true;
+	}
+	return false;
+}
+
+void ApplyMemo_Init
+(
+	ApplyMemo *memo,
+	OpBase *bound,
+	OpBase *branch
+) {
+	ASSERT(memo   != NULL);
+	ASSERT(bound  != NULL);
+	ASSERT(branch != NULL);
+
+	memo->key      = NULL;
+	memo->hits     = 0;
+	memo->pending  = false;
+	memo->lookups  = 0;
+	memo->key_idx  = NULL;
+	memo->outcomes = NULL;
+
+	// outcomes may change as the graph is modified
+	const OpBase *root = branch;
+	while(root->parent != NULL) root = root->parent;
+	if(_planWrites(root)) return;
+
+	rax *refs = raxNew();
+	if(!_collectReferences(branch, refs)) {
+		raxFree(refs);
+		return;
+	}
+
+	// key the memo by the referenced variables resolved by the bound branch
+	rax *bound_vars = raxNew();
+	ExecutionPlan_BoundVariables(bound, bound_vars);
+
+	bool keyable = true;
+	memo->key_idx = array_new(int, 1);
+
+	raxIterator it;
+	raxStart(&it, refs);
+	raxSeek(&it, "^", NULL, 0);
+	while(keyable && raxNext(&it)) {
+		if(raxFind(bound_vars, it.key, it.key_len) == raxNotFound) continue;
+		char var[it.key_len + 1];
+		memcpy(var, it.key, it.key_len);
+		var[it.key_len] = '\0';
+		int idx;
+		keyable = OpBase_Aware(bound, var, &idx);
+		array_append(memo->key_idx, idx);
+	}
+	raxStop(&it);
+	raxFree(bound_vars);
+	raxFree(refs);
+
+	if(!keyable) {
+		array_free(memo->key_idx);
+		memo->key_idx = NULL;
+		return;
+	}
+
+	memo->key = sdsempty();
+	memo->outcomes = raxNew();
+}
+
+// builds the memo key for 'r', returns false if 'r' can't be keyed
+static bool _buildKey(ApplyMemo *memo, const Record r) {
+	sdsclear(memo->key);
+
+	uint n = array_len(memo->key_idx);
+	for(uint i = 0; i < n; i++) {
+		SIValue v = Record_Get(r, memo->key_idx[i]);
+		SIType t = SI_TYPE(v);
+		memo->key = sdscatlen(memo->key, &t, sizeof(t));
+
+		switch(t) {
+			case T_NODE:
+			case T_EDGE: {
+				EntityID id = ENTITY_GET_ID((GraphEntity *)v.ptrval);
+				memo->key = sdscatlen(memo->key, &id, sizeof(id));
+				break;
+			}
+			case T_INT64:
+			case T_BOOL:
+				memo->key = sdscatlen(memo->key, &v.longval, sizeof(v.longval));
+				break;
+			case T_DOUBLE:
+				memo->key = sdscatlen(memo->key, &v.doubleval,
+						sizeof(v.doubleval));
+				break;
+			case T_STRING:
+				memo->key = sdscatlen(memo->key, v.stringval,
+						strlen(v.stringval) + 1);
+				break;
+			case T_NULL:
+				break;
+			default:
+				// composite values aren't keyed
+				return false;
+		}
+	}
+
+	return true;
+}
+
+bool ApplyMemo_Lookup
+(
+	ApplyMemo *memo,
+	const Record r,
+	bool *outcome
+) {
+	ASSERT(memo    != NULL);
+	ASSERT(outcome != NULL);
+
+	memo->pending = false;
+	if(memo->outcomes == NULL) return false;
+
+	// abandon memoization if keys don't repeat
+	if(memo->lookups == APPLY_MEMO_PROBE && memo->hits == 0) {
+		raxFree(memo->outcomes);
+		memo->outcomes = NULL;
+		return false;
+	}
+
+	if(!_buildKey(memo, r)) return false;
+
+	memo->lookups++;
+	void *v = raxFind(memo->outcomes, (unsigned char *)memo->key,
+			sdslen(memo->key));
+	if(v == raxNotFound) {
+		memo->pending = true;
+		return false;
+	}
+
+	memo->hits++;
+	*outcome = (v == OUTCOME_TRUE);
+	return true;
+}
+
+void ApplyMemo_Store
+(
+	ApplyMemo *memo,
+	bool outcome
+) {
+	ASSERT(memo != NULL);
+
+	if(!memo->pending) return;
+	memo->pending = false;
+
+	// memo is full, start over
+	if(raxSize(memo->outcomes) == APPLY_MEMO_CAP) {
+		raxFree(memo->outcomes);
+		memo->outcomes = raxNew();
+	}
+
+	raxInsert(memo->outcomes, (unsigned char *)memo->key, sdslen(memo->key),
+			outcome ? OUTCOME_TRUE : OUTCOME_FALSE, NULL);
+}
+
+void ApplyMemo_Free
+(
+	ApplyMemo *memo
+) {
+	ASSERT(memo != NULL);
+
+	if(memo->outcomes != NULL) {
+		raxFree(memo->outcomes);
+		memo->outcomes = NULL;
+	}
+
+	if(memo->key_idx != NULL) {
+		array_free(memo->key_idx);
+		memo->key_idx = NULL;
+	}
+
+	if(memo->key != NULL) {
+		sdsfree(memo->key);
+		memo->key = NULL;
+	}
+}
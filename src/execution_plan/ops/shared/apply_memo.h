@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../op.h"
+#include "../../../util/sds/sds.h"
+#include "rax.h"
+
+// maximum number of outcomes memoized per operation
+#define APPLY_MEMO_CAP 4096
+
+// number of lookups after which memoization is abandoned
+// if none of them was served by the memo
+#define APPLY_MEMO_PROBE 1024
+
+// memoizes whether a branch fed by an Argument produced a record
+// outcomes are keyed by the values of the bound variables the branch uses
+typedef struct {
+	rax *outcomes;       // key to branch outcome
+	int *key_idx;        // record offsets of the key variables
+	sds key;             // key of the last lookup
+	bool pending;        // last lookup missed, its outcome is expected
+	uint64_t lookups;    // number of lookups
+	uint64_t hits;       // lookups served by the memo
+} ApplyMemo;
+
+// initialize memo for 'branch' fed by records of 'bound'
+// memoization is disabled if 'branch' might produce different
+// outcomes for the same key
+void ApplyMemo_Init
+(
+	ApplyMemo *memo,      // memo to initialize
+	OpBase *bound,        // branch producing argument records
+	OpBase *branch        // branch to memoize
+);
+
+// looks up the outcome of 'r', returns false if it isn't memoized
+// on a miss, the outcome should be reported via ApplyMemo_Store
+bool ApplyMemo_Lookup
+(
+	ApplyMemo *memo,      // memo
+	const Record r,       // argument record
+	bool *outcome         // [output] memoized outcome
+);
+
+// memoizes the outcome of the last missed lookup
+void ApplyMemo_Store
+(
+	ApplyMemo *memo,      // memo
+	bool outcome          // branch outcome
+);
+
+// release memo
+void ApplyMemo_Free
+(
+	ApplyMemo *memo       // memo to free
+);
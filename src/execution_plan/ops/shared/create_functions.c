@@ -8,19 +8,18 @@
 #include "RG.h"
 #include "../../../errors.h"
 #include "../../../query_ctx.h"
+#include "../../../effects/effects.h"
 #include "../../../ast/ast_shared.h"
 #include "../../../datatypes/array.h"
+#include "../../../util/rmalloc.h"
 
 // Add properties to the GraphEntity.
 static inline void _AddProperties(ResultSetStatistics *stats, GraphEntity *ge,
 								  PendingProperties *props) {
-	int failed_updates = 0;
-	for(int i = 0; i < props->property_count; i++) {
-		bool updated = GraphEntity_AddProperty(ge, props->attr_keys[i], props->values[i]);
-		if(!updated) failed_updates++;
-	}
+	int added = GraphEntity_AddProperties(ge, props->attr_keys, props->values,
+			props->property_count);
 
-	if(stats) stats->properties_set += props->property_count - failed_updates;
+	if(stats) stats->properties_set += added;
 }
 
 // commit node blueprints
@@ -60,12 +59,59 @@ static void _CommitNodesBlueprint(PendingCreations *pending) {
 	}
 }
 
+// validates the nodes about to be created against their labels' constraints
+// returns false and sets an error if a constraint is violated
+static bool _EnforceNodeConstraints(PendingCreations *pending) {
+	GraphContext     *gc          =  QueryCtx_GetGraphCtx();
+	uint             node_count   =  array_len(pending->created_nodes);
+	ConstraintCheck  *checks      =  NULL;
+
+	for(uint i = 0; i < node_count; i++) {
+		int *labels = pending->node_labels[i];
+		uint label_count = array_len(labels);
+		PendingProperties *props = pending->node_properties[i];
+
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[j], SCHEMA_NODE);
+			uint constraint_count = Schema_ConstraintCount(s);
+			if(constraint_count == 0) continue;
+
+			if(checks == NULL) checks = array_new(ConstraintCheck, node_count);
+			for(uint k = 0; k < constraint_count; k++) {
+				const Constraint *c = s->constraints + k;
+				ConstraintCheck check = {
+					.label_id  =  labels[j],
+					.c         =  c,
+					.id        =  INVALID_ENTITY_ID,
+					.v         =  SI_NullVal(),
+				};
+
+				// pending values are NULL for skipped properties
+				for(int l = 0; props != NULL && l < props->property_count; l++) {
+					if(props->attr_keys[l] == c->attr) {
+						check.v = props->values[l];
+						break;
+					}
+				}
+				array_append(checks, check);
+			}
+		}
+	}
+
+	if(checks == NULL) return true;
+
+	bool valid = Constraint_Validate(checks, array_len(checks));
+	array_free(checks);
+	return valid;
+}
+
 // commit nodes
 static void _CommitNodes(PendingCreations *pending) {
-	Node          *n          =  NULL;
-	GraphContext  *gc         =  QueryCtx_GetGraphCtx();
-	Graph         *g          =  gc->g;
-	uint          node_count  =  array_len(pending->created_nodes);
+	Node           *n          =  NULL;
+	GraphContext   *gc         =  QueryCtx_GetGraphCtx();
+	Graph          *g          =  gc->g;
+	EffectsBuffer  *effects    =  QueryCtx_GetEffectsBuffer();
+	uint           node_count  =  array_len(pending->created_nodes);
 
 	// sync policy should be set to NOP, no need to sync/resize
 	ASSERT(Graph_GetMatrixPolicy(g) == SYNC_POLICY_NOP);
@@ -83,6 +129,8 @@ static void _CommitNodes(PendingCreations *pending) {
 						   pending->node_properties[i]);
 		}
 
+		EffectsBuffer_AddCreateNodeEffect(effects, gc, n, labels, label_count);
+
 		// add node labels
 		for(uint i = 0; i < label_count; i++) {
 			Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
@@ -118,49 +166,98 @@ static void _CommitEdgesBlueprint(EdgeCreateCtx *blueprints) {
 		Graph_GetRelationMatrix(g, Schema_GetID(s), false);
 	}
 
-	// call Graph_GetAdjacencyMatrix will make sure the adjacency matrix
-	// is of the right dimensions
-	Graph_GetAdjacencyMatrix(g, false);
+	// call Graph_GetAdjacencyMatrixForUpdate will make sure the adjacency
+	// matrix is of the right dimensions
+	Graph_GetAdjacencyMatrixForUpdate(g);
 }
 
 // commit edges
 static void _CommitEdges(PendingCreations *pending) {
-	Edge          *e          =  NULL;
-	GraphContext  *gc         =  QueryCtx_GetGraphCtx();
-	Graph         *g          =  gc->g;
-	uint          edge_count  =  array_len(pending->created_edges);
+	Edge           *e          =  NULL;
+	GraphContext   *gc         =  QueryCtx_GetGraphCtx();
+	Graph          *g          =  gc->g;
+	EffectsBuffer  *effects    =  QueryCtx_GetEffectsBuffer();
+	uint           edge_count  =  array_len(pending->created_edges);
 
 	// sync policy should be set to NOP, no need to sync/resize
 	ASSERT(Graph_GetMatrixPolicy(g) == SYNC_POLICY_NOP);
 
+	int     relation_count  =  Graph_RelationTypeCount(g);
+	uint    *type_counts    =  rm_calloc(relation_count, sizeof(uint));
+	int     *relations      =  rm_malloc(sizeof(int) * edge_count);
+	NodeID  *srcs           =  rm_malloc(sizeof(NodeID) * edge_count);
+	NodeID  *dests          =  rm_malloc(sizeof(NodeID) * edge_count);
+
 	for(uint i = 0; i < edge_count; i++) {
 		e = pending->created_edges[i];
-		NodeID srcNodeID;
-		NodeID destNodeID;
 
 		// Nodes which already existed prior to this query would
 		// have their ID set under e->srcNodeID and e->destNodeID
 		// Nodes which are created as part of this query would be
 		// saved under edge src/dest pointer.
-		if(e->srcNodeID != INVALID_ENTITY_ID) srcNodeID = e->srcNodeID;
-		else srcNodeID = ENTITY_GET_ID(Edge_GetSrcNode(e));
-		if(e->destNodeID != INVALID_ENTITY_ID) destNodeID = e->destNodeID;
-		else destNodeID = ENTITY_GET_ID(Edge_GetDestNode(e));
+		if(e->srcNodeID != INVALID_ENTITY_ID) srcs[i] = e->srcNodeID;
+		else srcs[i] = ENTITY_GET_ID(Edge_GetSrcNode(e));
+		if(e->destNodeID != INVALID_ENTITY_ID) dests[i] = e->destNodeID;
+		else dests[i] = ENTITY_GET_ID(Edge_GetDestNode(e));
 
 		Schema *s = GraphContext_GetSchema(gc, e->relationship, SCHEMA_EDGE);
 		// all schemas have been created in the edge blueprint loop or earlier
 		ASSERT(s != NULL);
-		int relation_id = Schema_GetID(s);
+		relations[i] = Schema_GetID(s);
+		type_counts[relations[i]]++;
+	}
+
+	// relationship types introducing many edges, e.g.
+	// UNWIND range(0, 100000) AS x MATCH ... CREATE (a)-[:R]->(b)
+	// are committed in bulk, building their matrices' delta at once
+	for(int r = 0; r < relation_count; r++) {
+		uint n = type_counts[r];
+		if(n < EDGE_BULK_CREATE_THRESHOLD) continue;
+
+		uint     k      =  0;
+		NodeID   *src   =  rm_malloc(sizeof(NodeID) * n);
+		NodeID   *dest  =  rm_malloc(sizeof(NodeID) * n);
+		Edge     **es   =  rm_malloc(sizeof(Edge *) * n);
+
+		for(uint i = 0; i < edge_count && k < n; i++) {
+			if(relations[i] != r) continue;
+			src[k]  = srcs[i];
+			dest[k] = dests[i];
+			es[k]   = pending->created_edges[i];
+			k++;
+		}
+
+		Graph_CreateEdges(g, r, src, dest, es, n);
+
+		rm_free(src);
+		rm_free(dest);
+		rm_free(es);
+	}
+
+	for(uint i = 0; i < edge_count; i++) {
+		e = pending->created_edges[i];
+		int relation_id = relations[i];
 
-		Graph_CreateEdge(g, srcNodeID, destNodeID, relation_id, e);
+		if(type_counts[relation_id] < EDGE_BULK_CREATE_THRESHOLD) {
+			Graph_CreateEdge(g, srcs[i], dests[i], relation_id, e);
+		}
 
 		if(pending->edge_properties[i]) {
 			_AddProperties(pending->stats, (GraphEntity *)e,
 						   pending->edge_properties[i]);
 		}
 
+		EffectsBuffer_AddCreateEdgeEffect(effects, gc, e, srcs[i], dests[i],
+				relation_id);
+
+		Schema *s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
 		if(s && Schema_HasIndices(s)) Schema_AddEdgeToIndices(s, e);
 	}
+
+	rm_free(type_counts);
+	rm_free(relations);
+	rm_free(srcs);
+	rm_free(dests);
 }
 
 // Initialize all variables for storing pending creations.
@@ -195,6 +292,13 @@ void CommitNewEntities(OpBase *op, PendingCreations *pending) {
 		Graph_SetMatrixPolicy(g, SYNC_POLICY_RESIZE);
 		_CommitNodesBlueprint(pending);
 
+		// constraints are validated before any node is introduced
+		if(!_EnforceNodeConstraints(pending)) {
+			Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
+			ErrorCtx_RaiseRuntimeException(NULL);
+			return;
+		}
+
 		// set graph matrix sync policy to NOP
 		// no need to perform sync/resize
 		Graph_SetMatrixPolicy(g, SYNC_POLICY_NOP);
@@ -227,6 +331,7 @@ void CommitNewEntities(OpBase *op, PendingCreations *pending) {
 
 // Resolve the properties specified in the query into constant values.
 PendingProperties *ConvertPropertyMap(Record r, PropertyMap *map, bool fail_on_null) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
 	PendingProperties *converted = rm_malloc(sizeof(PendingProperties));
 	uint property_count = array_len(map->keys);
 	converted->values = rm_malloc(sizeof(SIValue) * property_count);
@@ -269,6 +374,9 @@ PendingProperties *ConvertPropertyMap(Record r, PropertyMap *map, bool fail_on_n
 				ErrorCtx_RaiseRuntimeException(NULL);
 			}
 		}
+		// intern short strings, move large strings to memory-mapped storage
+		GraphContext_PreparePropertyValue(gc, &val);
+
 		// Set the converted property.
 		converted->values[i] = val;
 	}
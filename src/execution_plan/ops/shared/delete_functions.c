@@ -0,0 +1,46 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "delete_functions.h"
+#include "RG.h"
+
+void DeleteEntities(GraphContext *gc, Node *nodes, uint node_count,
+					Edge *edges, uint edge_count, ResultSetStatistics *stats) {
+	ASSERT(gc != NULL);
+
+	Graph  *g                     =  gc->g;
+	uint   node_deleted           =  0;
+	uint   edge_deleted           =  0;
+	uint   implicit_edge_deleted  =  0;
+
+	if(GraphContext_HasIndices(gc)) {
+		for(int i = 0; i < node_count; i++) {
+			Node *n = nodes + i;
+			GraphContext_DeleteNodeFromIndices(gc, n);
+		}
+
+		for(int i = 0; i < edge_count; i++) {
+			Edge *e = edges + i;
+			GraphContext_DeleteEdgeFromIndices(gc, e);
+		}
+	}
+
+	if(edge_count <= EDGE_BULK_DELETE_THRESHOLD) {
+		for(uint i = 0; i < edge_count; i++) {
+			edge_deleted += Graph_DeleteEdge(g, edges + i);
+		}
+		edge_count = 0;
+	}
+
+	Graph_BulkDelete(g, nodes, node_count, edges, edge_count, &node_deleted,
+					 &implicit_edge_deleted);
+
+	if(stats != NULL) {
+		stats->nodes_deleted          +=  node_deleted;
+		stats->relationships_deleted  +=  edge_deleted;
+		stats->relationships_deleted  +=  implicit_edge_deleted;
+	}
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../../../graph/graphcontext.h"
+#include "../../../resultset/resultset_statistics.h"
+
+// delete nodes and edges from the graph and its indices
+// edges connected to deleted nodes are deleted as well
+// the caller is expected to hold the graph's write lock
+void DeleteEntities(GraphContext *gc, Node *nodes, uint node_count,
+					Edge *edges, uint edge_count, ResultSetStatistics *stats);
@@ -0,0 +1,299 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "RG.h"
+#include "semi_join.h"
+#include "../op_filter.h"
+#include "../op_conditional_traverse.h"
+#include "../../../query_ctx.h"
+#include "../../../util/arr.h"
+#include "../../../util/rax_extensions.h"
+#include "../../execution_plan_build/execution_plan_modify.h"
+
+// returns the index of the single relation operand of 'ae'
+// -1 if 'ae' isn't a product of a relation and label matrices
+static int _relationOperand(const AlgebraicExpression *ae) {
+	if(ae->type == AL_OPERAND) return ae->operand.diagonal ? -1 : 0;
+	if(ae->operation.op != AL_EXP_MUL) return -1;
+
+	int relation = -1;
+	uint child_count = AlgebraicExpression_ChildCount(ae);
+	for(uint i = 0; i < child_count; i++) {
+		const AlgebraicExpression *child = ae->operation.children[i];
+		if(child->type != AL_OPERAND) return -1;
+		if(child->operand.diagonal) continue;
+		if(relation != -1) return -1;
+		relation = i;
+	}
+
+	return relation;
+}
+
+static const AlgebraicExpression *_operand(const AlgebraicExpression *ae,
+		uint i) {
+	return (ae->type == AL_OPERAND) ? ae : ae->operation.children[i];
+}
+
+// true if any operation within the plan modifies the graph
+static bool _planWrites(const OpBase *op) {
+	if(op->writer) return true;
+	for(int i = 0; i < op->childCount; i++) {
+		if(_planWrites(op->children[i])) return true;
+	}
+	return false;
+}
+
+// true if 'filter' only refers to 'alias' and is deterministic
+static bool _filtersOnly(const OpFilter *filter, const char *alias) {
+	if(!FilterTree_Deterministic(filter->filterTree)) return false;
+
+	rax *refs = FilterTree_CollectModified(filter->filterTree);
+	bool only = raxSize(refs) == 1 &&
+		raxFind(refs, (unsigned char *)alias, strlen(alias)) != raxNotFound;
+	raxFree(refs);
+
+	return only;
+}
+
+void SemiJoin_Init
+(
+	SemiJoin *sj,
+	OpBase *bound,
+	OpBase *branch
+) {
+	ASSERT(sj     != NULL);
+	ASSERT(bound  != NULL);
+	ASSERT(branch != NULL);
+
+	sj->ae        = NULL;
+	sj->branch    = branch;
+	sj->filters   = NULL;
+	sj->sources   = NULL;
+	sj->evaluated = 0;
+
+	// qualifying sources may change as the graph is modified
+	const OpBase *root = branch;
+	while(root->parent != NULL) root = root->parent;
+	if(_planWrites(root)) return;
+
+	// skip destination filters
+	OpBase *op = branch;
+	while(op->type == OPType_FILTER) op = op->children[0];
+
+	if(op->type != OPType_CONDITIONAL_TRAVERSE) return;
+	if(op->children[0]->type != OPType_ARGUMENT) return;
+
+	OpCondTraverse *traverse = (OpCondTraverse *)op;
+	const char *src  = AlgebraicExpression_Src(traverse->ae);
+	const char *dest = AlgebraicExpression_Dest(traverse->ae);
+	if(AlgebraicExpression_Edge(traverse->ae) != NULL) return;
+
+	// source must be bound, destination is introduced by the branch
+	rax *bound_vars = raxNew();
+	ExecutionPlan_BoundVariables(bound, bound_vars);
+	bool applicable =
+		raxFind(bound_vars, (unsigned char *)src, strlen(src)) != raxNotFound &&
+		raxFind(bound_vars, (unsigned char *)dest, strlen(dest)) == raxNotFound;
+	raxFree(bound_vars);
+	if(!applicable) return;
+
+	for(OpBase *f = branch; f != op && applicable; f = f->children[0]) {
+		applicable = _filtersOnly((OpFilter *)f, dest);
+	}
+	if(!applicable) return;
+
+	// the optimized expression is inspected
+	// transposes are applied, possibly reordering operands
+	AlgebraicExpression *ae = AlgebraicExpression_Clone(traverse->ae);
+	AlgebraicExpression_Optimize(&ae);
+	int relation = _relationOperand(ae);
+
+	// destination filters are evaluated over labeled destinations only
+	bool labeled_dest = (ae->type == AL_OPERATION &&
+			relation < (int)AlgebraicExpression_ChildCount(ae) - 1);
+	if(relation == -1 || (branch != op && !labeled_dest)) {
+		AlgebraicExpression_Free(ae);
+		return;
+	}
+
+	bool aware = OpBase_Aware(bound, src, &sj->src_idx) &&
+		OpBase_Aware(branch, dest, &sj->dest_idx);
+	if(!aware) {
+		AlgebraicExpression_Free(ae);
+		return;
+	}
+
+	sj->ae = ae;
+	sj->filters = array_new(FT_FilterNode *, 1);
+	for(OpBase *f = branch; f != op; f = f->children[0]) {
+		array_append(sj->filters, ((OpFilter *)f)->filterTree);
+	}
+}
+
+// extracts the diagonal of label matrix 'L' into a vector
+static GrB_Vector _labelVector(RG_Matrix L) {
+	GrB_Info   info;
+	GrB_Index  n;
+	GrB_Matrix l = NULL;
+	GrB_Vector d = NULL;
+
+	UNUSED(info);
+
+	info = RG_Matrix_export(&l, L);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nrows(&n, l);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_new(&d, GrB_BOOL, n);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Vector_diag(d, l, 0, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_free(&l);
+	return d;
+}
+
+// intersects 'v' with the nodes of each label operand in [from, to)
+static void _applyLabels(const AlgebraicExpression *ae, uint from, uint to,
+		GrB_Vector *v) {
+	for(uint i = from; i < to; i++) {
+		GrB_Vector l = _labelVector(_operand(ae, i)->operand.matrix);
+		if(*v == NULL) {
+			*v = l;
+			continue;
+		}
+		GrB_Info info = GrB_eWiseMult(*v, NULL, NULL, GrB_LAND, *v, l, NULL);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+		GrB_free(&l);
+	}
+}
+
+// removes destinations failing the filters from 'd'
+static void _filterDestinations(SemiJoin *sj, GrB_Vector d) {
+	if(array_len(sj->filters) == 0) return;
+
+	GrB_Index nvals;
+	GrB_Info info = GrB_Vector_nvals(&nvals, d);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * MAX(nvals, 1));
+	info = GrB_Vector_extractTuples_BOOL(ids, NULL, &nvals, d);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+
+	Graph *g = QueryCtx_GetGraph();
+	Record r = OpBase_CreateRecord(sj->branch);
+	uint filter_count = array_len(sj->filters);
+
+	for(GrB_Index i = 0; i < nvals; i++) {
+		Node n = GE_NEW_NODE();
+		bool pass = Graph_GetNode(g, ids[i], &n);
+		if(pass) {
+			Record_AddNode(r, sj->dest_idx, n);
+			for(uint j = 0; j < filter_count && pass; j++) {
+				pass = FilterTree_applyFilters(sj->filters[j], r) == FILTER_PASS;
+			}
+		}
+		if(!pass) GrB_Vector_removeElement(d, ids[i]);
+	}
+
+	OpBase_DeleteRecord(r);
+	rm_free(ids);
+}
+
+// computes the qualifying sources
+// sources = src labels ∧ (R * (dest labels ∧ filters))
+static void _computeSources(SemiJoin *sj) {
+	GrB_Info   info;
+	GrB_Index  nrows;
+	GrB_Matrix R  =  NULL;
+	GrB_Vector d  =  NULL;
+
+	UNUSED(info);
+
+	const AlgebraicExpression *ae = sj->ae;
+	uint relation = _relationOperand(ae);
+	uint operand_count = (ae->type == AL_OPERAND) ? 1 :
+		AlgebraicExpression_ChildCount(ae);
+
+	info = RG_Matrix_export(&R, _operand(ae, relation)->operand.matrix);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nrows(&nrows, R);
+	ASSERT(info == GrB_SUCCESS);
+
+	// candidate destinations
+	_applyLabels(ae, relation + 1, operand_count, &d);
+	if(d == NULL) {
+		// unlabeled destination, any node qualifies
+		GrB_Index ncols;
+		info = GrB_Matrix_ncols(&ncols, R);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_new(&d, GrB_BOOL, ncols);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Vector_assign_BOOL(d, NULL, NULL, true, GrB_ALL, ncols,
+				NULL);
+		ASSERT(info == GrB_SUCCESS);
+	}
+	_filterDestinations(sj, d);
+
+	info = GrB_Vector_new(&sj->sources, GrB_BOOL, nrows);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_mxv(sj->sources, NULL, NULL, GxB_ANY_PAIR_BOOL, R, d, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	_applyLabels(ae, 0, relation, &sj->sources);
+
+	GrB_free(&R);
+	GrB_free(&d);
+}
+
+bool SemiJoin_Lookup
+(
+	SemiJoin *sj,
+	const Record r,
+	bool *outcome
+) {
+	ASSERT(sj      != NULL);
+	ASSERT(outcome != NULL);
+
+	if(sj->ae == NULL) return false;
+	if(Record_GetType(r, sj->src_idx) != REC_TYPE_NODE) return false;
+
+	if(sj->sources == NULL) {
+		// few records are evaluated one by one
+		if(sj->evaluated++ < SEMI_JOIN_THRESHOLD) return false;
+		_computeSources(sj);
+	}
+
+	bool x;
+	NodeID id = ENTITY_GET_ID(Record_GetNode(r, sj->src_idx));
+	*outcome = (GrB_Vector_extractElement_BOOL(&x, sj->sources, id) ==
+			GrB_SUCCESS);
+
+	return true;
+}
+
+void SemiJoin_Free
+(
+	SemiJoin *sj
+) {
+	ASSERT(sj != NULL);
+
+	if(sj->ae != NULL) {
+		AlgebraicExpression_Free(sj->ae);
+		sj->ae = NULL;
+	}
+
+	if(sj->filters != NULL) {
+		array_free(sj->filters);
+		sj->filters = NULL;
+	}
+
+	if(sj->sources != NULL) {
+		GrB_free(&sj->sources);
+		sj->sources = NULL;
+	}
+}
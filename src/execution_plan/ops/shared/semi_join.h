@@ -0,0 +1,55 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../op.h"
+#include "../../../filter_tree/filter_tree.h"
+#include "../../../arithmetic/algebraic_expression.h"
+
+// number of records evaluated one by one before the qualifying
+// sources are computed at once
+#define SEMI_JOIN_THRESHOLD 64
+
+// resolves a pattern predicate of the form
+// (n)-[:R]->(m:L) WHERE <filters on m>
+// for all bound nodes at once, the qualifying sources are computed by
+// a single matrix-vector multiplication R * d where d holds the
+// destinations passing the filters
+typedef struct {
+	AlgebraicExpression *ae;  // optimized traversal expression
+	FT_FilterNode **filters;  // filters applied on the destination
+	OpBase *branch;           // branch resolved by the semi join
+	int src_idx;              // record offset of the traversal source
+	int dest_idx;             // record offset of the traversal destination
+	GrB_Vector sources;       // qualifying sources, NULL until computed
+	uint64_t evaluated;       // records evaluated by the branch
+} SemiJoin;
+
+// initialize semi join for 'branch' fed by records of 'bound'
+// the semi join is disabled if 'branch' isn't a, possibly filtered,
+// single hop traversal from a bound node
+void SemiJoin_Init
+(
+	SemiJoin *sj,    // semi join to initialize
+	OpBase *bound,   // branch producing argument records
+	OpBase *branch   // branch to resolve
+);
+
+// returns true if the outcome of 'r' is resolved by the semi join
+// once SEMI_JOIN_THRESHOLD records were evaluated by the branch
+bool SemiJoin_Lookup
+(
+	SemiJoin *sj,      // semi join
+	const Record r,    // argument record
+	bool *outcome      // [output] true if the branch produces a record
+);
+
+// release semi join
+void SemiJoin_Free
+(
+	SemiJoin *sj     // semi join to free
+);
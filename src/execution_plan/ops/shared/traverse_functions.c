@@ -6,6 +6,153 @@
 
 #include "traverse_functions.h"
 #include "../../../query_ctx.h"
+#include "../../../util/qsort.h"
+#include "../../../configuration/config.h"
+#include "../../../graph/rg_matrix/rg_matrix_iter.h"
+
+#define NODEID_ISLT(a, b) (*(a) < *(b))
+
+// orders batched edges by endpoints, then by edge ID
+#define BATCH_EDGE_ISLT(a, b)                                   \
+	((a)->src != (b)->src ? (a)->src < (b)->src :               \
+	 (a)->dest != (b)->dest ? (a)->dest < (b)->dest :           \
+	 (a)->edge.id < (b)->edge.id)
+
+// returns true if sorted array 'ids' contains 'id'
+static bool _Traverse_Contains
+(
+	const NodeID *ids,
+	uint n,
+	NodeID id
+) {
+	uint lo = 0;
+	uint hi = n;
+	while(lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if(ids[mid] == id) return true;
+		if(ids[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return false;
+}
+
+// replaces 'arr' content with the distinct IDs of 'ids', sorted
+static NodeID *_Traverse_SortedSet
+(
+	NodeID *arr,
+	const NodeID *ids,
+	uint64_t n
+) {
+	array_clear(arr);
+	arr = array_ensure_cap(arr, n);
+	for(uint64_t i = 0; i < n; i++) array_append(arr, ids[i]);
+
+	QSORT(NodeID, arr, n, NODEID_ISLT);
+
+	uint len = 0;
+	for(uint64_t i = 0; i < n; i++) {
+		if(len == 0 || arr[len - 1] != arr[i]) arr[len++] = arr[i];
+	}
+	arr = array_trimm_len(arr, len);
+
+	return arr;
+}
+
+// adds the edges held by entry 'x' of relation 'r' to the batch
+// the entry connects 'src' to 'dest', traversed from 'from' to 'to'
+static void _Traverse_BatchEntry
+(
+	EdgeTraverseCtx *edge_ctx,
+	const Graph *g,
+	RG_Matrix R,
+	int r,
+	uint64_t x,
+	NodeID src,
+	NodeID dest,
+	NodeID from,
+	NodeID to
+) {
+	BatchEdge be = {.src = from, .dest = to};
+	be.edge.relationID = r;
+	be.edge.srcNodeID  = src;
+	be.edge.destNodeID = dest;
+
+	uint64_t n = 1;
+	const EdgeID *ids = &x;
+	// multiple edges connecting src to dest
+	if(!SINGLE_EDGE(x)) ids = RG_Matrix_multiEdgeIDs(R, x, &n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		Graph_GetEdge(g, ids[i], &be.edge);
+		ASSERT(be.edge.entity != NULL);
+		array_append(edge_ctx->batch, be);
+	}
+}
+
+// scans the rows of relation 'r' of either the batch's sources
+// or, when traversing incoming edges, the batch's destinations
+static void _Traverse_BatchRelation
+(
+	EdgeTraverseCtx *edge_ctx,
+	const Graph *g,
+	int r,
+	bool outgoing
+) {
+	RG_MatrixTupleIter it;
+	RG_Matrix R = Graph_GetRelationMatrix(g, r, false);
+
+	NodeID *rows = (outgoing) ? edge_ctx->srcs  : edge_ctx->dests;
+	NodeID *cols = (outgoing) ? edge_ctx->dests : edge_ctx->srcs;
+	uint nrows = array_len(rows);
+	uint ncols = array_len(cols);
+
+	RG_MatrixTupleIter_reuse(&it, R);
+	for(uint i = 0; i < nrows; i++) {
+		GrB_Index col;
+		uint64_t x;
+		bool depleted = false;
+		NodeID row = rows[i];
+
+		RG_MatrixTupleIter_iterate_row(&it, row);
+		while(true) {
+			RG_MatrixTupleIter_next(&it, NULL, &col, &x, &depleted);
+			if(depleted) break;
+			if(!_Traverse_Contains(cols, ncols, col)) continue;
+
+			if(outgoing) {
+				_Traverse_BatchEntry(edge_ctx, g, R, r, x, row, col, row, col);
+			} else {
+				_Traverse_BatchEntry(edge_ctx, g, R, r, x, row, col, col, row);
+			}
+		}
+	}
+}
+
+// collect edges between the source and destination nodes
+// from the resolved batch
+static void _Traverse_CollectBatchEdges
+(
+	EdgeTraverseCtx *edge_ctx,
+	NodeID src,
+	NodeID dest
+) {
+	// locate the first edge traversed from src to dest
+	uint lo = 0;
+	uint hi = array_len(edge_ctx->batch);
+	while(lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		BatchEdge *be = edge_ctx->batch + mid;
+		if(be->src < src || (be->src == src && be->dest < dest)) lo = mid + 1;
+		else hi = mid;
+	}
+
+	uint n = array_len(edge_ctx->batch);
+	for(uint i = lo; i < n; i++) {
+		BatchEdge *be = edge_ctx->batch + i;
+		if(be->src != src || be->dest != dest) break;
+		array_append(edge_ctx->edges, be->edge);
+	}
+}
 
 // collect edges between the source and destination nodes
 static void _Traverse_CollectEdges
@@ -94,9 +241,57 @@ EdgeTraverseCtx *EdgeTraverseCtx_New
 	_Traverse_SetRelationTypes(edge_ctx, e); // Build the array of relation type IDs.
 	edge_ctx->edgeRecIdx = idx;
 	edge_ctx->direction = _Traverse_SetDirection(ae, e);
+	edge_ctx->batched = false;
+	edge_ctx->batch = array_new(BatchEdge, 0);
+	edge_ctx->srcs = array_new(NodeID, 0);
+	edge_ctx->dests = array_new(NodeID, 0);
 	return edge_ctx;
 }
 
+void EdgeTraverseCtx_CollectBatch
+(
+	EdgeTraverseCtx *edge_ctx,
+	const NodeID *srcs,
+	uint64_t src_count,
+	const NodeID *dests,
+	uint64_t dest_count
+) {
+	ASSERT(edge_ctx != NULL);
+
+	Graph *g = QueryCtx_GetGraph();
+
+	edge_ctx->batched = true;
+	array_clear(edge_ctx->batch);
+	edge_ctx->srcs = _Traverse_SortedSet(edge_ctx->srcs, srcs, src_count);
+	edge_ctx->dests = _Traverse_SortedSet(edge_ctx->dests, dests, dest_count);
+
+	bool outgoing = edge_ctx->direction != GRAPH_EDGE_DIR_INCOMING;
+	bool incoming = edge_ctx->direction != GRAPH_EDGE_DIR_OUTGOING;
+
+	uint count = array_len(edge_ctx->edgeRelationTypes);
+	for(uint i = 0; i < count; i++) {
+		int r = edge_ctx->edgeRelationTypes[i];
+		// invalid relation type, e.g. MATCH ()-[:real_type|fake_type]->()
+		if(r == GRAPH_UNKNOWN_RELATION) continue;
+
+		// relation type missing, scan through each relation type
+		int first = r;
+		int last  = r + 1;
+		if(r == GRAPH_NO_RELATION) {
+			first = 0;
+			last  = Graph_RelationTypeCount(g);
+		}
+
+		for(r = first; r < last; r++) {
+			if(outgoing) _Traverse_BatchRelation(edge_ctx, g, r, true);
+			if(incoming) _Traverse_BatchRelation(edge_ctx, g, r, false);
+		}
+	}
+
+	uint n = array_len(edge_ctx->batch);
+	QSORT(BatchEdge, edge_ctx->batch, n, BATCH_EDGE_ISLT);
+}
+
 // populate the traverse context's edges array with all edges of the appropriate
 // direction connecting the source and destination nodes
 void EdgeTraverseCtx_CollectEdges
@@ -107,6 +302,12 @@ void EdgeTraverseCtx_CollectEdges
 ) {
 	ASSERT(edge_ctx != NULL);
 
+	// edges were resolved along with the rest of the batch
+	if(edge_ctx->batched) {
+		_Traverse_CollectBatchEdges(edge_ctx, src, dest);
+		return;
+	}
+
 	switch(edge_ctx->direction) {
 	case GRAPH_EDGE_DIR_OUTGOING:
 		_Traverse_CollectEdges(edge_ctx, src, dest);
@@ -156,6 +357,8 @@ void EdgeTraverseCtx_Reset
 	ASSERT(edge_ctx != NULL);
 
 	array_clear(edge_ctx->edges);
+	array_clear(edge_ctx->batch);
+	edge_ctx->batched = false;
 }
 
 void EdgeTraverseCtx_Free
@@ -165,7 +368,39 @@ void EdgeTraverseCtx_Free
 	if(!edge_ctx) return;
 
 	array_free(edge_ctx->edges);
+	array_free(edge_ctx->batch);
+	array_free(edge_ctx->srcs);
+	array_free(edge_ctx->dests);
 	array_free(edge_ctx->edgeRelationTypes);
 	rm_free(edge_ctx);
 }
 
+
+uint TraverseBatch_Cap
+(
+	uint limit
+) {
+	uint64_t max_batch_size;
+	Config_Option_get(Config_MAX_TRAVERSE_BATCH_SIZE, &max_batch_size);
+
+	// no point in batching more records than the limit allows
+	return (limit < max_batch_size) ? limit : max_batch_size;
+}
+
+uint TraverseBatch_Initial
+(
+	uint cap
+) {
+	return (TRAVERSE_BATCH_SIZE < cap) ? TRAVERSE_BATCH_SIZE : cap;
+}
+
+uint TraverseBatch_Grow
+(
+	uint batch_size,
+	uint cap
+) {
+	// a full batch suggests the child has many more records to offer
+	// grow the batch to amortize the fixed cost of each multiplication
+	uint64_t next = (uint64_t)batch_size * TRAVERSE_BATCH_GROWTH;
+	return (next < cap) ? next : cap;
+}
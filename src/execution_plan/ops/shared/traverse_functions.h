@@ -9,6 +9,19 @@
 #include "../../execution_plan.h"
 #include "../../../arithmetic/algebraic_expression.h"
 
+// initial number of records to accumulate before traversing
+#define TRAVERSE_BATCH_SIZE 16
+
+// factor by which a traversal batch grows each time it is filled
+#define TRAVERSE_BATCH_GROWTH 4
+
+// an edge resolved ahead of time for a batch of traversals
+typedef struct {
+	NodeID src;   // traversal source node ID
+	NodeID dest;  // traversal destination node ID
+	Edge edge;    // edge connecting the traversal's endpoints
+} BatchEdge;
+
 // container struct for traversing and populating referenced edges in
 // traversal ops like CondTraverse and ExpandInto
 typedef struct {
@@ -16,6 +29,10 @@ typedef struct {
 	Edge *edges;                // flexible array of all matching edges for the current endpoints
 	int edgeRecIdx;             // the record index for the referenced edge
 	GRAPH_EDGE_DIR direction;   // the direction of the referenced edge being traversed
+	bool batched;               // edges are looked up in 'batch' rather than the graph
+	BatchEdge *batch;           // edges of the current batch, sorted by endpoints
+	NodeID *srcs;               // batch's distinct source node IDs, sorted
+	NodeID *dests;              // batch's distinct destination node IDs, sorted
 } EdgeTraverseCtx;
 
 // initialize an EdgeTraverseCtx struct to populate edges appropriately
@@ -35,6 +52,19 @@ void EdgeTraverseCtx_CollectEdges
 	NodeID desti
 );
 
+// resolve the edges connecting any of the batch's sources to any of its
+// destinations, each relation matrix is scanned once, row by row
+// subsequent calls to EdgeTraverseCtx_CollectEdges look edges up
+// within the batch until the context is reset
+void EdgeTraverseCtx_CollectBatch
+(
+	EdgeTraverseCtx *edge_ctx,
+	const NodeID *srcs,      // batch's source node IDs
+	uint64_t src_count,      // number of source node IDs
+	const NodeID *dests,     // batch's destination node IDs
+	uint64_t dest_count      // number of destination node IDs
+);
+
 // remove a matching edge from the edges array if one is available
 // and set it in the record
 bool EdgeTraverseCtx_SetEdge
@@ -61,3 +91,25 @@ void EdgeTraverseCtx_Free
 	EdgeTraverseCtx *edge_ctx
 );
 
+
+// returns the maximum number of records a traversal should batch
+// bounded by both the downstream limit and MAX_TRAVERSE_BATCH_SIZE
+uint TraverseBatch_Cap
+(
+	uint limit  // downstream limit, UNLIMITED if there is none
+);
+
+// returns the size of the first batch
+// a traversal accumulates, at most 'cap' records
+uint TraverseBatch_Initial
+(
+	uint cap  // maximum batch size
+);
+
+// returns the size of the next batch after a batch of 'batch_size'
+// records was filled, batches grow geometrically up to 'cap'
+uint TraverseBatch_Grow
+(
+	uint batch_size,  // size of the batch just filled
+	uint cap          // maximum batch size
+);
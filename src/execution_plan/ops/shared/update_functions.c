@@ -7,6 +7,7 @@
 #include "update_functions.h"
 #include "../../../errors.h"
 #include "../../../query_ctx.h"
+#include "../../../effects/effects.h"
 #include "../../../datatypes/map.h"
 #include "../../../datatypes/array.h"
 
@@ -16,14 +17,22 @@
  * for NULL values, the property will be deleted if present
  * and nothing will be done otherwise
  * returns 1 if a property was set or deleted */
-static int _UpdateEntity(PendingUpdateCtx *update) {
+static int _UpdateEntity(GraphContext *gc, PendingUpdateCtx *update,
+		GraphEntityType t) {
 	int           res        =  0;
 	GraphEntity   *ge        =  update->ge;
 	Attribute_ID  attr_id    =  update->attr_id;
 	SIValue       new_value  =  update->new_value;
 
 	// handle the case in which we are deleting all properties
-	if(attr_id == ATTRIBUTE_ALL) return GraphEntity_ClearProperties(ge);
+	if(attr_id == ATTRIBUTE_ALL) {
+		res = GraphEntity_ClearProperties(ge);
+		if(res > 0) {
+			EffectsBuffer_AddUpdateEffect(QueryCtx_GetEffectsBuffer(), gc, ge,
+					t, attr_id, new_value);
+		}
+		return res;
+	}
 
 	// try to get current property value
 	SIValue *old_value = GraphEntity_GetProperty(ge, attr_id);
@@ -31,17 +40,39 @@ static int _UpdateEntity(PendingUpdateCtx *update) {
 	if(old_value == PROPERTY_NOTFOUND) {
 		// adding a new property; do nothing if its value is NULL
 		if(SI_TYPE(new_value) != T_NULL) {
+			GraphContext_PreparePropertyValue(gc, &new_value);
 			res = GraphEntity_AddProperty(ge, attr_id, new_value);
 		}
-	} else {
-		// update property
+	} else if(SIValue_Compare(*old_value, new_value, NULL) != 0) {
+		// update property, values in storage are only prepared if modified
+		GraphContext_PreparePropertyValue(gc, &new_value);
 		res = GraphEntity_SetProperty(ge, attr_id, new_value);
 	}
 
+	if(res) {
+		EffectsBuffer_AddUpdateEffect(QueryCtx_GetEffectsBuffer(), gc, ge, t,
+				attr_id, new_value);
+	}
+
 	SIValue_Free(new_value);
 	return res;
 }
 
+// mark the labels or relationship type of an updated entity as modified
+static void _MarkModified(GraphContext *gc, GraphEntity *ge, SchemaType t) {
+	GraphStatistics *stats = &gc->g->stats;
+	if(t == SCHEMA_NODE) {
+		uint label_count;
+		NODE_GET_LABELS(gc->g, (Node *)ge, label_count);
+		for(uint i = 0; i < label_count; i ++) {
+			GraphStatistics_NodesModified(stats, labels[i]);
+		}
+	} else {
+		GraphStatistics_EdgesModified(stats,
+				EDGE_GET_RELATION_ID((Edge *)ge, gc->g));
+	}
+}
+
 static PendingUpdateCtx _PreparePendingUpdate
 (
 	GraphContext *gc,
@@ -99,6 +130,71 @@ static PendingUpdateCtx _PreparePendingUpdate
 	};
 }
 
+// key of a node's constrained attribute, the constraint identifies the label
+typedef struct {
+	EntityID id;          // updated node
+	const Constraint *c;  // constraint
+} ConstraintKey;
+
+// validates the values updated nodes end up holding under constrained
+// attributes, returns false and sets an error if a constraint is violated
+static bool _EnforceNodeConstraints(GraphContext *gc,
+		PendingUpdateCtx *updates, uint update_count) {
+	rax              *checked  =  NULL;  // key -> position within checks + 1
+	ConstraintCheck  *checks   =  NULL;
+
+	for(uint i = 0; i < update_count; i++) {
+		PendingUpdateCtx *update = updates + i;
+		if(GraphEntity_IsDeleted(update->ge)) continue;
+
+		Node *n = (Node *)update->ge;
+		uint label_count;
+		NODE_GET_LABELS(gc->g, n, label_count);
+		for(uint j = 0; j < label_count; j++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[j], SCHEMA_NODE);
+			uint constraint_count = Schema_ConstraintCount(s);
+			for(uint k = 0; k < constraint_count; k++) {
+				const Constraint *c = s->constraints + k;
+
+				// clearing all attributes removes the constrained one
+				bool clear = (update->attr_id == ATTRIBUTE_ALL);
+				if(!clear && update->attr_id != c->attr) continue;
+				SIValue v = clear ? SI_NullVal() : update->new_value;
+
+				if(checked == NULL) {
+					checked = raxNew();
+					checks = array_new(ConstraintCheck, 1);
+				}
+
+				// later updates of the same attribute override earlier ones
+				ConstraintKey key = {.id = ENTITY_GET_ID(n), .c = c};
+				void *pos = raxFind(checked, (unsigned char *)&key, sizeof(key));
+				if(pos != raxNotFound) {
+					checks[(uintptr_t)pos - 1].v = v;
+					continue;
+				}
+
+				ConstraintCheck check = {
+					.label_id  =  labels[j],
+					.c         =  c,
+					.id        =  key.id,
+					.v         =  v,
+				};
+				array_append(checks, check);
+				raxInsert(checked, (unsigned char *)&key, sizeof(key),
+						(void *)(uintptr_t)array_len(checks), NULL);
+			}
+		}
+	}
+
+	if(checked == NULL) return true;
+
+	bool valid = Constraint_Validate(checks, array_len(checks));
+	array_free(checks);
+	raxFree(checked);
+	return valid;
+}
+
 // commits delayed updates
 void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 				   PendingUpdateCtx *updates, EntityType type) {
@@ -116,6 +212,13 @@ void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 	// return early if no updates are enqueued
 	if(update_count == 0) return;
 
+	// constraints are validated before any update is applied
+	if(t == SCHEMA_NODE &&
+	   !_EnforceNodeConstraints(gc, updates, update_count)) {
+		ErrorCtx_RaiseRuntimeException(NULL);
+		return;
+	}
+
 	uint i = 0;
 	GraphEntity *ge = updates[0].ge;
 
@@ -154,8 +257,10 @@ void CommitUpdates(GraphContext *gc, ResultSetStatistics *stats,
 		if(GraphEntity_IsDeleted(ge)) continue;
 
 		// update the property on the graph entity
-		int updated = _UpdateEntity(update);
+		int updated = _UpdateEntity(gc, update,
+				t == SCHEMA_NODE ? GETYPE_NODE : GETYPE_EDGE);
 		properties_set += updated;
+		if(updated) _MarkModified(gc, ge, t);
 		// reindex only if update performed
 		reindex |= update->update_index & (bool)updated;
 	}
@@ -289,9 +394,13 @@ void EvalEntityUpdates(GraphContext *gc, PendingUpdateCtx **node_updates,
 			}
 			// iterate over all entity properties to build updates
 			uint property_count = ENTITY_PROP_COUNT(ge);
+			SIValue *values = ENTITY_PROP_VALUES(ge);
+			const Attribute_ID *ids = ENTITY_PROP_IDS(ge);
 			for(uint j = 0; j < property_count; j ++) {
-				Attribute_ID attr_id = ENTITY_PROPS(ge)[j].id;
-				SIValue value = ENTITY_PROPS(ge)[j].value;
+				Attribute_ID attr_id = ids[j];
+				// the value remains owned by the source entity
+				// unless it had to be decompressed
+				SIValue value = Entity_ConstValue(values + j);
 
 				update = _PreparePendingUpdate(gc, accepted_properties, entity,
 											   attr_id, value, st);
@@ -0,0 +1,227 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// applyIndexOnlyScan looks for index scans feeding directly into
+// a projection or an aggregation, which access the scanned node solely
+// through attributes held by the label's native index, e.g.
+//
+// MATCH (n:L) WHERE n.v > 1 RETURN n.v, n.s
+// MATCH (n:L) WHERE n.v > 1 RETURN count(n)
+//
+// in which case the index scan projects these attributes out of
+// the index itself, avoiding fetching each node from the graph
+
+// returns true if 'exp' accesses an attribute of 'alias'
+static bool _AliasAttribute
+(
+	const AR_ExpNode *exp,
+	const char *alias,
+	char **attr
+) {
+	if(!AR_EXP_IsAttribute(exp, attr)) return false;
+
+	const AR_ExpNode *entity = exp->op.children[0];
+	return (AR_EXP_IsVariadic(entity) &&
+			strcmp(entity->operand.variadic.entity_alias, alias) == 0);
+}
+
+// returns true if 'exp' counts 'alias', e.g. count(n)
+static bool _AliasCount
+(
+	const AR_ExpNode *exp,
+	const char *alias
+) {
+	if(!AR_EXP_IsOperation(exp)) return false;
+	if(strcasecmp(AR_EXP_GetFuncName(exp), "count") != 0) return false;
+	if(exp->op.child_count != 1) return false;
+
+	const AR_ExpNode *arg = exp->op.children[0];
+	return (AR_EXP_IsVariadic(arg) &&
+			strcmp(arg->operand.variadic.entity_alias, alias) == 0);
+}
+
+static bool _IndexedAttribute
+(
+	const NativeIndex *native,
+	const char *attr_name,
+	Attribute_ID *attr
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	*attr = GraphContext_GetAttributeID(gc, attr_name);
+	if(*attr == ATTRIBUTE_NOTFOUND) return false;
+
+	uint attr_count = NativeIndex_AttributeCount(native);
+	for(uint i = 0; i < attr_count; i++) {
+		if(native->attrs[i] == *attr) return true;
+	}
+	return false;
+}
+
+// returns true if 'exp' refers to 'alias' only through indexed attributes
+static bool _Covered
+(
+	const AR_ExpNode *exp,
+	const char *alias,
+	const NativeIndex *native,
+	bool aggregate
+) {
+	char *attr_name;
+	Attribute_ID attr;
+
+	if(_AliasAttribute(exp, alias, &attr_name)) {
+		return _IndexedAttribute(native, attr_name, &attr);
+	}
+
+	// scanned nodes are never NULL, counting them requires no access
+	if(aggregate && _AliasCount(exp, alias)) return true;
+
+	if(AR_EXP_IsVariadic(exp)) {
+		return strcmp(exp->operand.variadic.entity_alias, alias) != 0;
+	}
+
+	if(AR_EXP_IsOperation(exp)) {
+		for(int i = 0; i < exp->op.child_count; i++) {
+			if(!_Covered(exp->op.children[i], alias, native, aggregate)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// replace attribute accesses of 'alias' within 'exp' with references to
+// the values projected by 'scan', returns the rewritten expression
+static AR_ExpNode *_Rewrite
+(
+	AR_ExpNode *exp,
+	const char *alias,
+	IndexScan *scan
+) {
+	char *attr_name;
+	Attribute_ID attr;
+
+	if(_AliasAttribute(exp, alias, &attr_name)) {
+		bool indexed = _IndexedAttribute(scan->native, attr_name, &attr);
+		ASSERT(indexed);
+		UNUSED(indexed);
+
+		const char *covered = IndexScanOp_CoverAttribute(scan, attr, attr_name);
+		AR_ExpNode *var = AR_EXP_NewVariableOperandNode(covered);
+		var->resolved_name = exp->resolved_name;
+		AR_EXP_Free(exp);
+		return var;
+	}
+
+	if(_AliasCount(exp, alias)) {
+		// count(n) -> count(true)
+		AR_EXP_Free(exp->op.children[0]);
+		exp->op.children[0] = AR_EXP_NewConstOperandNode(SI_BoolVal(true));
+		return exp;
+	}
+
+	if(AR_EXP_IsOperation(exp)) {
+		for(int i = 0; i < exp->op.child_count; i++) {
+			exp->op.children[i] = _Rewrite(exp->op.children[i], alias, scan);
+		}
+	}
+
+	return exp;
+}
+
+static bool _CoveredExpressions
+(
+	AR_ExpNode **exps,
+	uint count,
+	const char *alias,
+	const NativeIndex *native,
+	bool aggregate
+) {
+	for(uint i = 0; i < count; i++) {
+		if(!_Covered(exps[i], alias, native, aggregate)) return false;
+	}
+	return true;
+}
+
+static void _RewriteExpressions
+(
+	AR_ExpNode **exps,
+	uint count,
+	const char *alias,
+	IndexScan *scan
+) {
+	for(uint i = 0; i < count; i++) {
+		exps[i] = _Rewrite(exps[i], alias, scan);
+	}
+}
+
+static void _TryIndexOnlyScan
+(
+	IndexScan *scan
+) {
+	// index only scans are supported by the native index
+	if(scan->native == NULL) return;
+
+	// scan must be a tap
+	if(scan->op.childCount != 0) return;
+
+	// scan already aggregates its nodes, see reduceCount
+	if(scan->aggregate != INDEX_SCAN_AGGREGATE_NONE) return;
+
+	OpBase *parent = scan->op.parent;
+	if(parent == NULL || parent->plan != scan->op.plan) return;
+
+	const char *alias = scan->n.alias;
+
+	if(parent->type == OPType_PROJECT) {
+		OpProject *project = (OpProject *)parent;
+		if(!_CoveredExpressions(project->exps, project->exp_count, alias,
+					scan->native, false)) {
+			return;
+		}
+		_RewriteExpressions(project->exps, project->exp_count, alias, scan);
+	} else if(parent->type == OPType_AGGREGATE) {
+		OpAggregate *aggregate = (OpAggregate *)parent;
+		if(!_CoveredExpressions(aggregate->key_exps, aggregate->key_count,
+					alias, scan->native, false) ||
+		   !_CoveredExpressions(aggregate->aggregate_exps,
+					aggregate->aggregate_count, alias, scan->native, true)) {
+			return;
+		}
+		_RewriteExpressions(aggregate->key_exps, aggregate->key_count, alias,
+				scan);
+		_RewriteExpressions(aggregate->aggregate_exps,
+				aggregate->aggregate_count, alias, scan);
+	} else {
+		return;
+	}
+
+	IndexScanOp_SetIndexOnly(scan);
+}
+
+void applyIndexOnlyScan
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	OpBase **scans = ExecutionPlan_CollectOps(plan->root,
+			OPType_NODE_BY_INDEX_SCAN);
+
+	uint scan_count = array_len(scans);
+	for(uint i = 0; i < scan_count; i++) {
+		_TryIndexOnlyScan((IndexScan *)scans[i]);
+	}
+
+	array_free(scans);
+}
+
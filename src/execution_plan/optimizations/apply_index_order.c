@@ -0,0 +1,176 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include <strings.h>
+#include "../ops/op_sort.h"
+#include "../ops/op_project.h"
+#include "../ops/op_all_node_scan.h"
+#include "../ops/op_node_by_id_seek.h"
+#include "../ops/op_node_by_label_scan.h"
+#include "../ops/op_node_by_index_scan.h"
+#include "../execution_plan.h"
+#include "../../query_ctx.h"
+#include "../../ast/ast_build_op_contexts.h"
+#include "../../filter_tree/ft_to_native.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* applyIndexOrder looks for a Sort operation ordering by a single key
+ * which the scan feeding it already produces in order, e.g.
+ *
+ * MATCH (n:L) WHERE n.v > 0 RETURN n ORDER BY n.v DESC LIMIT 10
+ * MATCH (n:L) RETURN n ORDER BY id(n) LIMIT 10
+ *
+ * in which case the Sort is removed:
+ * 1. an index scan resolved by the native index is told to iterate its
+ *    range by the attribute's value, in either direction
+ * 2. label scans, all node scans and ID seeks produce ascending IDs
+ *
+ * a LIMIT then stops the scan as soon as enough records were produced
+ * rather than once the entire input was sorted.
+ * only projections and filters may reside between the Sort and the scan,
+ * any other operation might reorder, discard or duplicate records.
+ * must run after applyIndexOnlyScan and before applyLimit. */
+
+// sort key, attribute or ID of a scanned node
+typedef struct {
+	const char *alias;  // node alias
+	const char *attr;   // attribute name, NULL for the node's ID
+} SortKey;
+
+// resolves the sort key projected under 'alias' by 'project'
+// returns the record alias 'alias' is projected from as is
+// or NULL if it is computed, in which case 'key' is set
+// if the computation is an attribute or ID of a node
+static const char *_projectedFrom(const OpProject *project, const char *alias,
+		SortKey *key) {
+	for(uint i = 0; i < project->exp_count; i++) {
+		AR_ExpNode *exp = project->exps[i];
+		if(strcmp(exp->resolved_name, alias) != 0) continue;
+		if(AR_EXP_IsVariadic(exp)) return exp->operand.variadic.entity_alias;
+
+		if(exp->type != AR_EXP_OP || exp->op.child_count < 1) return NULL;
+		AR_ExpNode *entity = exp->op.children[0];
+		if(!AR_EXP_IsVariadic(entity)) return NULL;
+
+		char *attr = NULL;
+		if(AR_EXP_IsAttribute(exp, &attr)) {
+			key->attr = attr;
+		} else if(strcasecmp(AR_EXP_GetFuncName(exp), "id") == 0) {
+			key->attr = NULL;
+		} else {
+			return NULL;
+		}
+		key->alias = entity->operand.variadic.entity_alias;
+		return NULL;
+	}
+	return NULL;
+}
+
+// returns the alias of the node introduced by scan operation 'op'
+// NULL if 'op' doesn't produce nodes by ascending ID
+static const char *_idOrderedScan(const OpBase *op) {
+	switch(op->type) {
+		case OPType_ALL_NODE_SCAN:
+			return ((const AllNodeScan *)op)->alias;
+		case OPType_NODE_BY_LABEL_SCAN:
+			return ((const NodeByLabelScan *)op)->n.alias;
+		case OPType_NODE_BY_ID_SEEK:
+			return ((const NodeByIdSeek *)op)->alias;
+		default:
+			return NULL;
+	}
+}
+
+// tries to have index scan 'scan' produce records ordered by 'key'
+static bool _orderIndexScan(IndexScan *scan, const SortKey *key,
+		const char *covered, int direction) {
+	if(scan->native == NULL) return false;
+
+	// resolve ordering attribute
+	Attribute_ID attr = ATTRIBUTE_NOTFOUND;
+	if(covered != NULL) {
+		// key is read out of the index
+		uint count = array_len(scan->covered_aliases);
+		for(uint i = 0; i < count; i++) {
+			if(strcmp(scan->covered_aliases[i], covered) == 0) {
+				attr = scan->covered_attrs[i];
+			}
+		}
+	} else if(key->attr != NULL && strcmp(key->alias, scan->n.alias) == 0) {
+		GraphContext *gc = QueryCtx_GetGraphCtx();
+		attr = GraphContext_GetAttributeID(gc, key->attr);
+	}
+	if(attr == ATTRIBUTE_NOTFOUND) return false;
+
+	// attribute must be indexed
+	uint attr_count = NativeIndex_AttributeCount(scan->native);
+	uint i = 0;
+	for(; i < attr_count; i++) {
+		if(scan->native->attrs[i] == attr) break;
+	}
+	if(i == attr_count) return false;
+
+	// the filter must bound the attribute, excluding nodes missing it
+	if(!FilterTree_NativeOrderable(scan->filter, attr)) return false;
+
+	IndexScanOp_SetOrder(scan, attr, direction == DIR_DESC);
+	return true;
+}
+
+static void _applyOrder(ExecutionPlan *plan, OpSort *sort) {
+	if(array_len(sort->exps) != 1) return;
+
+	const char *alias = sort->exps[0]->resolved_name;
+	SortKey key = {0};
+
+	// follow the sort key down through projections and filters
+	OpBase *op = sort->op.children[0];
+	while(op->type == OPType_PROJECT || op->type == OPType_FILTER) {
+		if(op->type == OPType_PROJECT) {
+			const OpProject *project = (const OpProject *)op;
+			if(key.alias == NULL) {
+				alias = _projectedFrom(project, alias, &key);
+				if(alias == NULL && key.alias == NULL) return;
+			} else {
+				// the sorted node must be projected as is
+				SortKey computed = {0};
+				key.alias = _projectedFrom(project, key.alias, &computed);
+				if(key.alias == NULL) return;
+			}
+		}
+		if(op->childCount != 1) return;
+		op = op->children[0];
+	}
+
+	// scans consuming from a child restart per input record
+	if(op->childCount != 0) return;
+
+	int direction = sort->directions[0];
+
+	if(op->type == OPType_NODE_BY_INDEX_SCAN) {
+		if(!_orderIndexScan((IndexScan *)op, &key, alias, direction)) return;
+	} else {
+		// scans produce ascending IDs
+		const char *scanned = _idOrderedScan(op);
+		if(scanned == NULL || key.alias == NULL || key.attr != NULL) return;
+		if(direction != DIR_ASC || strcmp(scanned, key.alias) != 0) return;
+	}
+
+	ExecutionPlan_RemoveOp(plan, (OpBase *)sort);
+	OpBase_Free((OpBase *)sort);
+}
+
+void applyIndexOrder(ExecutionPlan *plan) {
+	OpBase **sort_ops = ExecutionPlan_CollectOps(plan->root, OPType_SORT);
+
+	uint sort_count = array_len(sort_ops);
+	for(uint i = 0; i < sort_count; i++) {
+		_applyOrder(plan, (OpSort *)sort_ops[i]);
+	}
+
+	array_free(sort_ops);
+}
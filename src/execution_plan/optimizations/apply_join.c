@@ -5,8 +5,10 @@
 */
 
 #include "../../util/arr.h"
+#include "../../query_ctx.h"
 #include "../ops/op_filter.h"
 #include "../../util/strcmp.h"
+#include "../../ast/ast_hints.h"
 #include "../ops/op_value_hash_join.h"
 #include "../../util/rax_extensions.h"
 #include "../ops/op_cartesian_product.h"
@@ -70,6 +72,29 @@ static OpFilter **_locate_filters(OpBase *cp) {
 	return filters;
 }
 
+// Checks if branch resolves an entity named by a USING JOIN ON hint.
+static bool _join_hinted(OpBase *branch) {
+	bool hinted = false;
+	AST *ast = QueryCtx_GetAST();
+	rax *bound_vars = raxNew();
+	ExecutionPlan_BoundVariables(branch, bound_vars);
+
+	raxIterator it;
+	raxStart(&it, bound_vars);
+	raxSeek(&it, "^", NULL, 0);
+	while(!hinted && raxNext(&it)) {
+		// rax keys aren't NULL terminated
+		char alias[it.key_len + 1];
+		memcpy(alias, it.key, it.key_len);
+		alias[it.key_len] = '\0';
+		hinted = AST_GetHint(ast, HINT_JOIN, alias, NULL);
+	}
+	raxStop(&it);
+	raxFree(bound_vars);
+
+	return hinted;
+}
+
 // This function builds a Hash Join operation given its left and right branches and join criteria.
 static OpBase *_build_hash_join_op(const ExecutionPlan *plan, OpBase *left_branch,
 								   OpBase *right_branch, AR_ExpNode *lhs_join_exp, AR_ExpNode *rhs_join_exp) {
@@ -77,11 +102,20 @@ static OpBase *_build_hash_join_op(const ExecutionPlan *plan, OpBase *left_branc
 
 	/* The Value Hash Join will cache its left-hand stream. To reduce the cache size,
 	 * prefer to cache the stream which will produce the smallest number of records.
-	 * Our current heuristic for this is to prefer a stream which contains a filter operation. */
-	bool left_branch_filtered = (ExecutionPlan_LocateOp(left_branch, OPType_FILTER) != NULL);
-	bool right_branch_filtered = (ExecutionPlan_LocateOp(right_branch, OPType_FILTER) != NULL);
-	if(!left_branch_filtered && right_branch_filtered) {
-		// Only the RHS stream is filtered, swap the input streams and expressions.
+	 * A USING JOIN ON hint names the stream to cache, otherwise our heuristic
+	 * is to prefer a stream which contains a filter operation. */
+	bool swap;
+	bool left_branch_hinted = _join_hinted(left_branch);
+	bool right_branch_hinted = _join_hinted(right_branch);
+	if(left_branch_hinted != right_branch_hinted) {
+		swap = right_branch_hinted;
+	} else {
+		bool left_branch_filtered = (ExecutionPlan_LocateOp(left_branch, OPType_FILTER) != NULL);
+		bool right_branch_filtered = (ExecutionPlan_LocateOp(right_branch, OPType_FILTER) != NULL);
+		swap = (!left_branch_filtered && right_branch_filtered);
+	}
+	if(swap) {
+		// Cache the RHS stream, swap the input streams and expressions.
 		value_hash_join = NewValueHashJoin(plan, rhs_join_exp, lhs_join_exp);
 		OpBase *t = left_branch;
 		left_branch = right_branch;
@@ -0,0 +1,117 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../../util/strcmp.h"
+#include "../ops/op_expand_into.h"
+#include "../ops/op_leapfrog_join.h"
+#include "../ops/op_conditional_traverse.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// apply leapfrog join searches for traversals immediately followed by
+// expand into operations closing a cycle on the traversal's destination
+//
+// MATCH (a)-[:F]->(b)-[:F]->(c)-[:F]->(a) RETURN a, b, c
+// SCAN (a)
+// TRAVERSE (a)-[:F]->(b)
+// TRAVERSE (b)-[:F]->(c)
+// EXPAND INTO (c)-[:F]->(a)
+//
+// the last traversal produces every 2-path (a)->(b)->(c)
+// only for expand into to discard the ones not leading back to 'a'
+// both operations are replaced by a single leapfrog join which resolves 'c'
+// by intersecting the outgoing row of 'b' with the incoming row of 'a'
+//
+// traverse order places the closing expand into operations right after
+// the traversal resolving their shared node
+
+// returns true if 'ae' closes a cycle on 'alias'
+static bool _closes_on
+(
+	AlgebraicExpression *ae,
+	const char *alias
+) {
+	const char *src  = AlgebraicExpression_Src(ae);
+	const char *dest = AlgebraicExpression_Dest(ae);
+
+	// self loops are not intersected
+	if(RG_STRCMP(src, dest) == 0) return false;
+
+	return (RG_STRCMP(src, alias) == 0 || RG_STRCMP(dest, alias) == 0) &&
+		LeapfrogJoin_SupportedExpression(ae, false);
+}
+
+static void _applyLeapfrogJoin
+(
+	ExecutionPlan *plan,
+	OpCondTraverse *traverse
+) {
+	AlgebraicExpression *ae = traverse->ae;
+	if(!LeapfrogJoin_SupportedExpression(ae, true)) return;
+
+	const char *src  = AlgebraicExpression_Src(ae);
+	const char *dest = AlgebraicExpression_Dest(ae);
+	if(RG_STRCMP(src, dest) == 0) return;
+
+	// collect expand into operations closing a cycle on 'dest'
+	OpBase *parent = traverse->op.parent;
+	OpExpandInto **expands = array_new(OpExpandInto *, 1);
+	while(parent != NULL && parent->type == OPType_EXPAND_INTO &&
+		  parent->plan == traverse->op.plan) {
+		OpExpandInto *expand = (OpExpandInto *)parent;
+		if(!_closes_on(expand->ae, dest)) break;
+
+		array_append(expands, expand);
+		parent = parent->parent;
+	}
+
+	uint expand_count = array_len(expands);
+	if(expand_count == 0) {
+		array_free(expands);
+		return;
+	}
+
+	// migrate expressions into the join
+	AlgebraicExpression **exps = array_new(AlgebraicExpression *,
+			expand_count + 1);
+	array_append(exps, ae);
+	traverse->ae = NULL;
+
+	for(uint i = 0; i < expand_count; i++) {
+		OpExpandInto *expand = expands[i];
+		array_append(exps, expand->ae);
+		// set expand into algebraic expression to NULL to avoid early free
+		expand->ae = NULL;
+		ExecutionPlan_RemoveOp(plan, (OpBase *)expand);
+		OpBase_Free((OpBase *)expand);
+	}
+
+	OpBase *join = NewLeapfrogJoinOp(traverse->op.plan, traverse->graph, exps);
+	ExecutionPlan_ReplaceOp(plan, (OpBase *)traverse, join);
+	OpBase_Free((OpBase *)traverse);
+
+	array_free(expands);
+}
+
+void applyLeapfrogJoin
+(
+	ExecutionPlan *plan
+) {
+	ASSERT(plan != NULL);
+
+	const OPType types[] = {OPType_CONDITIONAL_TRAVERSE};
+	OpBase **traversals = ExecutionPlan_CollectOpsMatchingType(plan->root,
+			types, 1);
+
+	uint traversals_count = array_len(traversals);
+	for(uint i = 0; i < traversals_count; i++) {
+		_applyLeapfrogJoin(plan, (OpCondTraverse *)traversals[i]);
+	}
+
+	array_free(traversals);
+}
+
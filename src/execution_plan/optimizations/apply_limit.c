@@ -33,7 +33,9 @@ static void notify_limit(OpBase *op, uint limit) {
 			limit = ((OpLimit *)op)->limit;
 			break;
 		case OPType_SORT:
+			// sort consumes its entire input, retaining the top records
 			((OpSort *)op)->limit = limit;
+			limit = UNLIMITED;
 			break;
 		case OPType_EXPAND_INTO:
 			((OpExpandInto *)op)->record_cap = limit;
@@ -0,0 +1,87 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../ops/op_sort.h"
+#include "../ops/op_project.h"
+#include "../ops/op_procedure_call.h"
+#include "../execution_plan.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* applyProcedureOrder looks for a Sort operation with a limit
+ * sorting by a single output of a procedure call, e.g.
+ *
+ * CALL algo.weightedPageRank(NULL, NULL, 'w') YIELD node, score
+ * RETURN node ORDER BY score DESC LIMIT 10
+ *
+ * in which case the procedure is told that only the top records
+ * ordered by that output are retained, such procedures can then avoid
+ * producing a record per node.
+ * must run after applyLimit and applySkip. */
+
+// returns the record alias 'alias' is projected from by 'project'
+// NULL if it is computed rather than projected as is
+static const char *_projectedFrom(const OpProject *project, const char *alias) {
+	for(uint i = 0; i < project->exp_count; i++) {
+		AR_ExpNode *exp = project->exps[i];
+		if(strcmp(exp->resolved_name, alias) != 0) continue;
+		if(!AR_EXP_IsVariadic(exp)) return NULL;
+		return exp->operand.variadic.entity_alias;
+	}
+	return NULL;
+}
+
+static void _pushOrder(OpSort *sort) {
+	if(sort->limit == UNLIMITED) return;
+	if(array_len(sort->exps) != 1) return;
+
+	const char *alias = sort->exps[0]->resolved_name;
+
+	// follow the sort key down through projections
+	// any other operation might discard or duplicate records
+	OpBase *op = sort->op.children[0];
+	while(op->type == OPType_PROJECT) {
+		alias = _projectedFrom((const OpProject *)op, alias);
+		if(alias == NULL || op->childCount == 0) return;
+		op = op->children[0];
+	}
+
+	if(op->type != OPType_PROC_CALL) return;
+
+	OpProcCall *call = (OpProcCall *)op;
+	const char *orderable = Procedure_OrderableOutput(call->procedure);
+	if(orderable == NULL) return;
+
+	uint yield_count = array_len(call->yield_exps);
+	for(uint i = 0; i < yield_count; i++) {
+		AR_ExpNode *yield = call->yield_exps[i];
+		if(strcmp(yield->resolved_name, alias) != 0) continue;
+		if(strcasecmp(yield->operand.variadic.entity_alias, orderable) != 0) {
+			return;
+		}
+
+		// skipped records are sorted as well
+		uint64_t limit = (uint64_t)sort->limit + sort->skip;
+		ProcedureOrderHint hint = {
+			.output    = orderable,
+			.direction = sort->directions[0],
+			.limit     = limit,
+		};
+		call->hint = hint;
+		return;
+	}
+}
+
+void applyProcedureOrder(ExecutionPlan *plan) {
+	OpBase **sort_ops = ExecutionPlan_CollectOps(plan->root, OPType_SORT);
+
+	uint sort_count = array_len(sort_ops);
+	for(uint i = 0; i < sort_count; i++) {
+		_pushOrder((OpSort *)sort_ops[i]);
+	}
+
+	array_free(sort_ops);
+}
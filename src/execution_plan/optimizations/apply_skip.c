@@ -12,7 +12,34 @@
  * Once one is found, all relevant child operations (e.g. Sort) will be
  * notified about the current skip value.
  * This is beneficial as a number of different optimizations can be applied
- * once a skip is known */
+ * once a skip is known.
+ * A Skip fed by a scan through projections alone has the scan skip records
+ * itself, seeking past them rather than producing records to be discarded.
+ * Skip values are evaluated per execution, hence the scan is only told
+ * to skip once the Skip operation is consumed. */
+
+// returns true if 'op' is fed by a scan able to skip records
+// with nothing but projections in between
+static bool _skippable_scan(const OpBase *op) {
+	const OpBase *scan = op->children[0];
+	while(scan->type == OPType_PROJECT) {
+		if(scan->childCount != 1) return false;
+		scan = scan->children[0];
+	}
+
+	// scans consuming from a child restart per input record
+	if(scan->childCount != 0) return false;
+
+	switch(scan->type) {
+		case OPType_ALL_NODE_SCAN:
+		case OPType_NODE_BY_LABEL_SCAN:
+		case OPType_NODE_BY_ID_SEEK:
+		case OPType_NODE_BY_INDEX_SCAN:
+			return true;
+		default:
+			return false;
+	}
+}
 
 static void notify_skip(OpBase *op, uint skip) {
 	OPType t = op->type;
@@ -21,6 +48,7 @@ static void notify_skip(OpBase *op, uint skip) {
 		case OPType_SKIP:
 			// update skip
 			skip = ((OpSkip *)op)->skip;
+			if(_skippable_scan(op)) SkipOp_PushDown((OpSkip *)op);
 			break;
 		case OPType_SORT:
 			((OpSort *)op)->skip = skip;
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../ops/op_filter.h"
+#include "../ops/op_cartesian_product.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* The filterCartesianProducts optimization migrates filter ops immediately
+ * following a Cartesian Product into the product itself.
+ *
+ * Filters which could be reduced to joins or applied to fewer branches were
+ * already handled by orderJoins, reduceCartesianProductStreamCount and
+ * applyJoin, the remaining filters require every combination to be inspected,
+ * which the product can do in place, prior to copying the combination
+ * into a new record. */
+
+static void _filterCartesianProduct(ExecutionPlan *plan, CartesianProduct *cp) {
+	FT_FilterNode *root = NULL;
+	OpBase *parent = cp->op.parent;
+
+	while(parent && parent->type == OPType_FILTER) {
+		// track the next op to visit as we free parent
+		OpFilter *filter_op = (OpFilter *)parent;
+		FT_FilterNode *ft = filter_op->filterTree;
+		parent = parent->parent;
+
+		// remove filter operation from execution plan
+		ExecutionPlan_RemoveOp(plan, (OpBase *)filter_op);
+		// NULL-set the filter tree to avoid a double free
+		filter_op->filterTree = NULL;
+		OpBase_Free((OpBase *)filter_op);
+
+		// concat filters using AND condition
+		if(root == NULL) {
+			root = ft;
+		} else {
+			FT_FilterNode *cond = FilterTree_CreateConditionFilter(OP_AND);
+			FilterTree_AppendLeftChild(cond, root);
+			FilterTree_AppendRightChild(cond, ft);
+			root = cond;
+		}
+	}
+
+	// embed the filter tree in the Cartesian Product
+	if(root != NULL) CartesianProductOp_SetFilter(cp, root);
+}
+
+void filterCartesianProducts(ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+
+	OpBase **cps = ExecutionPlan_CollectOps(plan->root,
+			OPType_CARTESIAN_PRODUCT);
+
+	uint count = array_len(cps);
+	for(uint i = 0; i < count; i++) {
+		_filterCartesianProduct(plan, (CartesianProduct *)cps[i]);
+	}
+
+	array_free(cps);
+}
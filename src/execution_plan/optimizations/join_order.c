@@ -0,0 +1,305 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../../query_ctx.h"
+#include "../ops/op_filter.h"
+#include "../ops/op_cartesian_product.h"
+#include "../../util/rax_extensions.h"
+#include "traverse_order_utils.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+#include "../execution_plan_build/execution_plan_construct.h"
+
+/* orderJoins picks the order in which the branches of a Cartesian Product
+ * with three or more branches are combined, e.g.
+ *
+ * MATCH (a:A), (b:B), (c:C) WHERE a.v = c.v AND b.v = c.v
+ *
+ * the branches are combined one at a time, the order minimizing the sum
+ * of estimated intermediate result sizes is found by dynamic programming
+ * over subsets of branches, estimates are based on label cardinalities
+ * and on the filters applied on top of the Cartesian Product.
+ *
+ * the product is then split into nested products, a new level is introduced
+ * whenever a filter is resolved, such that the filter is applied as soon
+ * as its branches are combined, e.g. (c, a) are combined first, then b.
+ * equality filters connecting two branches are later reduced to
+ * value hash joins by applyJoin.
+ * must run before reduceCartesianProductStreamCount and applyJoin. */
+
+// products with more branches are left as is
+#define JOIN_ORDER_MAX_BRANCHES 12
+
+// estimated fraction of records passing a filter
+#define FILTER_SELECTIVITY (1.0 / 3.0)
+
+// filter applied on top of a Cartesian Product
+typedef struct {
+	OpFilter *filter;    // filter operation
+	uint mask;           // branches referred to by the filter
+	bool equality;       // filter can act as a join condition
+	double selectivity;  // estimated fraction of records passing the filter
+} JoinPredicate;
+
+// estimate the number of records produced by 'branch'
+static double _branchCardinality(const OpBase *branch, const QueryGraph *qg) {
+	Graph *g = QueryCtx_GetGraph();
+	double node_count = Graph_NodeCount(g);
+	double degree = (node_count > 0) ? Graph_EdgeCount(g) / node_count : 0;
+	if(degree < 1) degree = 1;
+
+	// locate the branch entry point
+	const OpBase *tap = branch;
+	while(tap->childCount > 0) tap = tap->children[0];
+
+	double cardinality = node_count;
+	switch(tap->type) {
+		case OPType_NODE_BY_ID_SEEK:
+		case OPType_NODE_BY_LABEL_AND_ID_SCAN:
+			cardinality = 1;
+			break;
+		case OPType_NODE_BY_LABEL_SCAN:
+		case OPType_NODE_BY_INDEX_SCAN:
+		case OPType_ALL_NODE_SCAN: {
+			const char *alias = tap->modifies[0];
+			if(qg != NULL && QueryGraph_GetNodeByAlias(qg, alias) != NULL) {
+				cardinality = TraverseOrder_NodeCardinality(alias, qg);
+			}
+			// an index scan is a filtered label scan
+			if(tap->type == OPType_NODE_BY_INDEX_SCAN) {
+				cardinality *= FILTER_SELECTIVITY;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	// account for operations along the branch
+	for(const OpBase *op = tap->parent; op != NULL; op = op->parent) {
+		switch(op->type) {
+			case OPType_CONDITIONAL_TRAVERSE:
+			case OPType_CONDITIONAL_VAR_LEN_TRAVERSE:
+				cardinality *= degree;
+				break;
+			case OPType_FILTER:
+			case OPType_EXPAND_INTO:
+			case OPType_CONDITIONAL_VAR_LEN_TRAVERSE_EXPAND_INTO:
+				cardinality *= FILTER_SELECTIVITY;
+				break;
+			default:
+				break;
+		}
+		if(op == branch) break;
+	}
+
+	return (cardinality < 1) ? 1 : cardinality;
+}
+
+// maps each filter located directly above 'cp' to the branches it refers to
+// filters referring to entities not bound by any branch are discarded
+static JoinPredicate *_collectPredicates(OpBase *cp, rax **bound,
+		const double *cardinalities) {
+	JoinPredicate *preds = array_new(JoinPredicate, 0);
+
+	for(OpBase *op = cp->parent; op && op->type == OPType_FILTER;
+			op = op->parent) {
+		OpFilter *filter = (OpFilter *)op;
+		rax *refs = FilterTree_CollectModified(filter->filterTree);
+		uint mask = 0;
+
+		raxIterator it;
+		raxStart(&it, refs);
+		raxSeek(&it, "^", NULL, 0);
+		while(raxNext(&it)) {
+			int i = 0;
+			for(; i < cp->childCount; i++) {
+				if(raxFind(bound[i], it.key, it.key_len) != raxNotFound) break;
+			}
+			if(i == cp->childCount) {
+				mask = 0;
+				break;
+			}
+			mask |= (1 << i);
+		}
+		raxStop(&it);
+		raxFree(refs);
+
+		if(mask == 0) continue;
+
+		JoinPredicate pred = {.filter = filter, .mask = mask,
+			.equality = false, .selectivity = FILTER_SELECTIVITY};
+
+		// equality between two branches is as selective as the larger one
+		const FT_FilterNode *tree = filter->filterTree;
+		if(tree->t == FT_N_PRED && tree->pred.op == OP_EQUAL &&
+		   __builtin_popcount(mask) == 2) {
+			double max = 1;
+			for(int i = 0; i < cp->childCount; i++) {
+				if(mask & (1 << i)) max = MAX(max, cardinalities[i]);
+			}
+			pred.equality = true;
+			pred.selectivity = 1 / max;
+		}
+
+		array_append(preds, pred);
+	}
+
+	return preds;
+}
+
+// true if a filter joining 'branch' with 'set' is resolved once combined
+static bool _resolvesFilter(JoinPredicate *preds, uint set, int branch,
+		bool equality_only) {
+	uint combined = set | (1 << branch);
+	uint pred_count = array_len(preds);
+	for(uint i = 0; i < pred_count; i++) {
+		uint mask = preds[i].mask;
+		if(__builtin_popcount(mask) < 2) continue;
+		if(!(mask & (1 << branch)) || (mask & ~combined)) continue;
+		if(!equality_only || preds[i].equality) return true;
+	}
+	return false;
+}
+
+// computes the order in which branches are combined
+static void _orderBranches(int n, const double *cardinalities,
+		JoinPredicate *preds, int *order) {
+	uint set_count = 1 << n;
+	uint pred_count = array_len(preds);
+	double *card = rm_malloc(sizeof(double) * set_count);
+	double *cost = rm_malloc(sizeof(double) * set_count);
+	int *last = rm_malloc(sizeof(int) * set_count);
+
+	for(uint s = 1; s < set_count; s++) {
+		// estimated number of records produced by combining the set
+		card[s] = 1;
+		for(int i = 0; i < n; i++) {
+			if(s & (1 << i)) card[s] *= cardinalities[i];
+		}
+		for(uint i = 0; i < pred_count; i++) {
+			if((preds[i].mask & ~s) == 0) card[s] *= preds[i].selectivity;
+		}
+
+		if(__builtin_popcount(s) == 1) {
+			cost[s] = card[s];
+			last[s] = __builtin_ctz(s);
+			continue;
+		}
+
+		// combine the best plan for s \ {i} with branch i
+		// a hash join consumes each side once, a Cartesian Product
+		// reconsumes branch i for each record of s \ {i}
+		cost[s] = -1;
+		for(int i = 0; i < n; i++) {
+			if(!(s & (1 << i))) continue;
+			uint rest = s & ~(1 << i);
+			double combine = _resolvesFilter(preds, rest, i, true) ?
+				card[rest] + cardinalities[i] : card[rest] * cardinalities[i];
+			double c = cost[rest] + combine + card[s];
+			if(cost[s] < 0 || c < cost[s]) {
+				cost[s] = c;
+				last[s] = i;
+			}
+		}
+	}
+
+	uint s = set_count - 1;
+	for(int k = n - 1; k >= 0; k--) {
+		order[k] = last[s];
+		s &= ~(1 << last[s]);
+	}
+
+	rm_free(card);
+	rm_free(cost);
+	rm_free(last);
+}
+
+static void _orderJoin(ExecutionPlan *plan, OpBase *cp) {
+	int n = cp->childCount;
+	OpBase *branches[n];
+	rax *bound[n];
+	double cardinalities[n];
+	const QueryGraph *qg = cp->plan->query_graph;
+
+	for(int i = 0; i < n; i++) {
+		branches[i] = cp->children[i];
+		bound[i] = raxNew();
+		ExecutionPlan_BoundVariables(branches[i], bound[i]);
+		cardinalities[i] = _branchCardinality(branches[i], qg);
+	}
+
+	JoinPredicate *preds = _collectPredicates(cp, bound, cardinalities);
+	uint pred_count = array_len(preds);
+
+	// filters on a single branch narrow it down
+	for(uint i = 0; i < pred_count; i++) {
+		if(__builtin_popcount(preds[i].mask) != 1) continue;
+		int branch = __builtin_ctz(preds[i].mask);
+		cardinalities[branch] = MAX(1,
+				cardinalities[branch] * preds[i].selectivity);
+	}
+
+	int order[n];
+	_orderBranches(n, cardinalities, preds, order);
+
+	for(int i = 0; i < n; i++) ExecutionPlan_DetachOp(branches[i]);
+
+	// combine branches in order, introduce a nested product
+	// whenever a filter is resolved, combined branches are consumed once
+	// by placing them last
+	OpBase *combined = NULL;
+	OpBase *pending[n];
+	int pending_count = 0;
+	uint set = 0;
+
+	for(int k = 0; k < n; k++) {
+		int branch = order[k];
+		bool resolves = _resolvesFilter(preds, set, branch, false);
+		pending[pending_count++] = branches[branch];
+		set |= (1 << branch);
+
+		if(!resolves || k == n - 1) continue;
+
+		OpBase *level = NewCartesianProductOp(cp->plan);
+		for(int i = 0; i < pending_count; i++) {
+			ExecutionPlan_AddOp(level, pending[i]);
+		}
+		if(combined != NULL) ExecutionPlan_AddOp(level, combined);
+		combined = level;
+		pending_count = 0;
+	}
+
+	for(int i = 0; i < pending_count; i++) ExecutionPlan_AddOp(cp, pending[i]);
+	if(combined != NULL) ExecutionPlan_AddOp(cp, combined);
+
+	// place each filter right above the product resolving it
+	for(uint i = 0; i < pred_count; i++) {
+		OpBase *filter = (OpBase *)preds[i].filter;
+		ExecutionPlan_RemoveOp(plan, filter);
+		ExecutionPlan_RePositionFilterOp(plan, cp, NULL, filter);
+	}
+
+	for(int i = 0; i < n; i++) raxFree(bound[i]);
+	array_free(preds);
+}
+
+void orderJoins(ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+
+	OpBase **cps = ExecutionPlan_CollectOps(plan->root,
+			OPType_CARTESIAN_PRODUCT);
+
+	uint cp_count = array_len(cps);
+	for(uint i = 0; i < cp_count; i++) {
+		OpBase *cp = cps[i];
+		if(cp->childCount < 3) continue;
+		if(cp->childCount > JOIN_ORDER_MAX_BRANCHES) continue;
+		_orderJoin(plan, cp);
+	}
+
+	array_free(cps);
+}
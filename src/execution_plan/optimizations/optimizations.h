@@ -16,21 +16,32 @@ void orderExpressions(
 	AlgebraicExpression **exps,     // expressions to order
 	uint *exps_count,               // number of expressions
 	const FT_FilterNode *filters,   // filters
-	rax *bound_vars                 // previously-bound variables
+	rax *bound_vars,                // previously-bound variables
+	const char *start               // hinted start point, may be NULL
 );
 
 void compactFilters(ExecutionPlan *plan);
+void pushDownFilters(ExecutionPlan *plan);
 void reduceScans(ExecutionPlan *plan);
 void utilizeIndices(ExecutionPlan *plan);
 void seekByID(ExecutionPlan *plan);
 void filterVariableLengthEdges(ExecutionPlan *plan);
+void orderJoins(ExecutionPlan *plan);
 void reduceCartesianProductStreamCount(ExecutionPlan *plan);
 void applyJoin(ExecutionPlan *plan);
 void reduceFilters(ExecutionPlan *plan);
 void reduceTraversal(ExecutionPlan *plan);
+void applyLeapfrogJoin(ExecutionPlan *plan);
 void reduceDistinct(ExecutionPlan *plan);
 void reduceCount(ExecutionPlan *plan);
+void applyIndexOnlyScan(ExecutionPlan *plan);
+void applyIndexOrder(ExecutionPlan *plan);
 void applyLimit(ExecutionPlan *plan);
 void applySkip(ExecutionPlan *plan);
+void applyProcedureOrder(ExecutionPlan *plan);
 void optimizeLabelScan(ExecutionPlan *plan);
+void filterCartesianProducts(ExecutionPlan *plan);
+void parallelizeFilters(ExecutionPlan *plan);
+void parallelizeUnion(ExecutionPlan *plan);
+void streamUpdates(ExecutionPlan *plan);
 
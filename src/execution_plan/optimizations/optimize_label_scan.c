@@ -6,6 +6,9 @@
 
 #include "RG.h"
 #include "../../query_ctx.h"
+#include "../../ast/ast_hints.h"
+#include "../../datatypes/array.h"
+#include "../ops/op_filter.h"
 #include "../ops/op_node_by_label_scan.h"
 #include "../ops/op_conditional_traverse.h"
 #include "../execution_plan_build/execution_plan_modify.h"
@@ -14,88 +17,237 @@
 // this optimization scans through each label-scan operation
 // in case the node being scaned is associated with multiple labels
 // e.g. MATCH (n:A:B) RETURN n
-// we will prefer to scan through the label with the least amount of nodes
-// for the above example if NNZ(A) < NNZ(B) we will want to iterate over A
-//
-// in-case this optimization changed the label scanned e.g. from A to B
-// it will have to patch the following conditional traversal removing B operand
-// and adding A back
+// the scan computes its entry points as the intersection of the labels
+// diagonals, instead of scanning a single label and checking the others
+// for every node
 //
 // consider MATCH (n:A:B)-[:R]->(m) RETURN m
-// 
+//
 // Scan(A)
 // Traverse B*R
 //
-// if we switch from Scan(A) to Scan(B)
-// we will have to update the traversal pattern from B*R to A*R
+// the label operands at the source of the following traversal
+// are absorbed by the scan, which is set to iterate over the label
+// with the least amount of nodes
+//
+// Scan(A) intersect B
+// Traverse R
+//
+// label filters applied directly on the scanned node
+// e.g. MATCH (n:A) WHERE NOT n:B RETURN n
+// are absorbed as well, excluded labels are removed through a
+// complemented mask
 //
-// Scan(B)
-// Traverse A*R
+// a USING SCAN n:L hint overrides the choice of the scanned label
 
-static void _optimizeLabelScan(NodeByLabelScan *scan) {
-	ASSERT(scan != NULL);	
+// returns the label operand at the source of 'ae'
+// in case it is a diagonal operand over 'alias'
+// reached only through multiplications and transposes
+static AlgebraicExpression *_SourceLabelOperand
+(
+	AlgebraicExpression *ae,
+	const char *alias
+) {
+	bool transpose = false;
+	while(ae->type == AL_OPERATION) {
+		switch(ae->operation.op) {
+			case AL_EXP_TRANSPOSE:
+				transpose = !transpose;
+				ae = FIRST_CHILD(ae);
+				break;
+			case AL_EXP_MUL:
+				ae = transpose ? LAST_CHILD(ae) : FIRST_CHILD(ae);
+				break;
+			default:
+				// operand isn't shared by all terms of an addition
+				return NULL;
+		}
+	}
 
-	OpBase      *op  =  (OpBase*)scan;
-	Graph       *g   =  QueryCtx_GetGraph();
-	QueryGraph  *qg  =  op->plan->query_graph;
+	if(!ae->operand.diagonal || ae->operand.label == NULL) return NULL;
+	if(strcmp(ae->operand.src, alias) != 0) return NULL;
 
-	// see if scanned node has multiple labels
-	const char *node_alias = scan->n.alias;
-	QGNode *qn = QueryGraph_GetNodeByAlias(qg, node_alias);
-	ASSERT(qn != NULL);
+	return ae;
+}
 
-	// return if node has only one label
-	uint label_count = QGNode_LabelCount(qn);
-	ASSERT(label_count >= 1);
-	if(label_count == 1) return;
+// checks if 'ft' is a label filter over 'alias' e.g. n:A or NOT n:A
+// sets 'label' and 'negated' accordingly
+static bool _LabelFilter
+(
+	const FT_FilterNode *ft,
+	const char *alias,
+	const char **label,
+	bool *negated
+) {
+	*negated = false;
+
+	// NOT n:A
+	if(ft->t == FT_N_COND) {
+		if(ft->cond.op != OP_NOT || ft->cond.left->t != FT_N_EXP) return false;
+		*negated = true;
+		ft = ft->cond.left;
+	}
+	if(ft->t != FT_N_EXP) return false;
+
+	const AR_ExpNode *exp = ft->exp.exp;
+	if(!AR_EXP_IsOperation(exp)) return false;
+	if(strcmp(AR_EXP_GetFuncName(exp), "not") == 0) {
+		if(*negated) return false;
+		*negated = true;
+		exp = exp->op.children[0];
+		if(!AR_EXP_IsOperation(exp)) return false;
+	}
+	if(strcmp(AR_EXP_GetFuncName(exp), "hasLabels") != 0) return false;
+
+	// hasLabels(n, [A])
+	const AR_ExpNode *node = exp->op.children[0];
+	const AR_ExpNode *labels = exp->op.children[1];
+	if(!AR_EXP_IsVariadic(node) || !AR_EXP_IsConstant(labels)) return false;
+	if(strcmp(node->operand.variadic.entity_alias, alias) != 0) return false;
+
+	// a negated filter over multiple labels isn't a per-label exclusion
+	SIValue arr = labels->operand.constant;
+	if(SI_TYPE(arr) != T_ARRAY || SIArray_Length(arr) != 1) return false;
+
+	// label string must outlive the filter
+	SIValue l = SIArray_Get(arr, 0);
+	if(SI_TYPE(l) != T_STRING || l.allocation != M_CONST) return false;
+
+	*label = l.stringval;
+	return true;
+}
+
+// absorbs label filters applied directly on the scanned node
+static void _absorbLabelFilters
+(
+	ExecutionPlan *plan,
+	NodeByLabelScan *scan,
+	const char ***labels
+) {
+	OpBase *op = (OpBase*)scan;
+
+	OpBase *parent = op->parent;
+	while(parent != NULL && OpBase_Type(parent) == OPType_FILTER) {
+		OpBase *next = parent->parent;
+
+		bool negated;
+		const char *label;
+		OpFilter *filter = (OpFilter*)parent;
+		if(_LabelFilter(filter->filterTree, scan->n.alias, &label, &negated)) {
+			if(negated) NodeByLabelScanOp_ExcludeLabel(scan, label);
+			else array_append(*labels, label);
+
+			ExecutionPlan_RemoveOp(plan, parent);
+			OpBase_Free(parent);
+		}
+
+		parent = next;
+	}
+}
+
+// absorbs the label operands at the source of the following traversal
+static void _absorbTraversalLabels
+(
+	ExecutionPlan *plan,
+	NodeByLabelScan *scan,
+	const char ***labels
+) {
+	OpBase *op = (OpBase*)scan;
+
+	// locate following traversal, skip filters
+	OpBase *parent = op->parent;
+	while(parent != NULL && OpBase_Type(parent) == OPType_FILTER) {
+		parent = parent->parent;
+	}
+	if(parent == NULL || OpBase_Type(parent) != OPType_CONDITIONAL_TRAVERSE) {
+		return;
+	}
+
+	OpCondTraverse *op_traverse = (OpCondTraverse*)parent;
+	const char *alias = scan->n.alias;
+
+	while(true) {
+		AlgebraicExpression *operand =
+			_SourceLabelOperand(op_traverse->ae, alias);
+		if(operand == NULL) break;
+
+		array_append(*labels, AlgebraicExpression_Label(operand));
+
+		// traversal reduced to label checks, drop it
+		if(AlgebraicExpression_OperandCount(op_traverse->ae) == 1) {
+			ExecutionPlan_RemoveOp(plan, parent);
+			OpBase_Free(parent);
+			break;
+		}
+
+		operand = AlgebraicExpression_RemoveSource(&op_traverse->ae);
+		AlgebraicExpression_Free(operand);
+	}
+}
+
+static void _optimizeLabelScan
+(
+	ExecutionPlan *plan,
+	NodeByLabelScan *scan
+) {
+	ASSERT(plan != NULL);
+	ASSERT(scan != NULL);
+
+	Graph         *g   =  QueryCtx_GetGraph();
+	GraphContext  *gc  =  QueryCtx_GetGraphCtx();
+
+	// collect labels the scanned node is required to carry
+	const char **labels = array_new(const char *, 1);
+	array_append(labels, scan->n.label);
+
+	_absorbLabelFilters(plan, scan, &labels);
+	_absorbTraversalLabels(plan, scan, &labels);
 
-	// node has multiple labels
 	// find label with minimum entities
 	uint64_t    min_nnz       = UINT64_MAX; // tracks min entries
 	int         min_label_id  = 0;          // tracks min label ID
 	const char *min_label_str = NULL;       // tracks min label name
 
+	PlanHint hint;
+	bool hinted = AST_GetHint(QueryCtx_GetAST(), HINT_SCAN, scan->n.alias,
+			&hint);
+
+	uint label_count = array_len(labels);
 	for(uint i = 0; i < label_count; i++) {
-		uint64_t nnz;
-		int label_id = QGNode_GetLabelID(qn, i);
-		nnz = Graph_LabeledNodeCount(g, label_id);
+		// the hinted label wins over the label with the fewest nodes
+		if(hinted && strcmp(labels[i], hint.label) == 0) {
+			Schema *s = GraphContext_GetSchema(gc, labels[i], SCHEMA_NODE);
+			min_label_id  = (s != NULL) ? Schema_GetID(s) : GRAPH_UNKNOWN_LABEL;
+			min_label_str = labels[i];
+			break;
+		}
+
+		uint64_t nnz = 0;
+		int label_id = GRAPH_UNKNOWN_LABEL;
+		Schema *s = GraphContext_GetSchema(gc, labels[i], SCHEMA_NODE);
+		if(s != NULL) {
+			label_id = Schema_GetID(s);
+			nnz = Graph_LabeledNodeCount(g, label_id);
+		}
 		if(min_nnz > nnz) {
 			// update minimum
 			min_nnz        =  nnz;
 			min_label_id   =  label_id;
-			min_label_str  =  QGNode_GetLabel(qn, i);
+			min_label_str  =  labels[i];
 		}
 	}
 
-	// scanned label has the minimum number of entries
-	// no switching required
-	if(min_label_id == scan->n.label_id) return;
-
-	// swap current label with minimum label
+	// scan label with the minimum number of entries
+	// intersect it with the remaining labels
 	scan->n.label     =  min_label_str;
 	scan->n.label_id  =  min_label_id;
 
-	// patch following traversal, skip filters
-	OpBase *parent = op->parent;
-	while(OpBase_Type(parent) == OPType_FILTER) parent = parent->parent;
-	ASSERT(OpBase_Type(parent) == OPType_CONDITIONAL_TRAVERSE);
-
-	OpCondTraverse *op_traverse = (OpCondTraverse*)parent;
-	AlgebraicExpression *ae = op_traverse->ae;
-	AlgebraicExpression *operand;
-
-	const char *row_domain = scan->n.alias;
-	const char *column_domain = scan->n.alias;
-
-	bool found = AlgebraicExpression_LocateOperand(ae, &operand, NULL,
-			row_domain, column_domain, NULL, min_label_str);
-	ASSERT(found == true);
-
-	AlgebraicExpression *replacement = AlgebraicExpression_NewOperand(NULL,
-			true, AlgebraicExpression_Src(operand),
-			AlgebraicExpression_Dest(operand), NULL, min_label_str);
+	for(uint i = 0; i < label_count; i++) {
+		if(labels[i] == min_label_str) continue;
+		NodeByLabelScanOp_IntersectLabel(scan, labels[i]);
+	}
 
-	_AlgebraicExpression_InplaceRepurpose(operand, replacement);
+	array_free(labels);
 }
 
 void optimizeLabelScan(ExecutionPlan *plan) {
@@ -110,7 +262,7 @@ void optimizeLabelScan(ExecutionPlan *plan) {
 	uint op_count = array_len(label_scan_ops);
 	for(uint i = 0; i < op_count; i++) {
 		NodeByLabelScan *label_scan = (NodeByLabelScan*)label_scan_ops[i];
-		_optimizeLabelScan(label_scan);
+		_optimizeLabelScan(plan, label_scan);
 	}
 	array_free(label_scan_ops);
 }
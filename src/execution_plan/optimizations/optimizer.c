@@ -11,6 +11,10 @@ void optimizePlan(ExecutionPlan *plan) {
 	// tries to compact filter trees, and remove redundant filters
 	compactFilters(plan);
 
+	// migrate filters across WITH projections and into Apply bound branches
+	// prior to scan optimizations, which may then utilize them
+	pushDownFilters(plan);
+
 	// scan optimizations order:
 	// 1. remove redundant scans which checks for the same node
 	// 2. try to use the indices
@@ -36,6 +40,9 @@ void optimizePlan(ExecutionPlan *plan) {
 	// migrate filters on variable-length edges into the traversal operations
 	filterVariableLengthEdges(plan);
 
+	// order the branches of cartesian products by estimated cardinality
+	orderJoins(plan);
+
 	// try to optimize cartesian product
 	reduceCartesianProductStreamCount(plan);
 
@@ -49,16 +56,42 @@ void optimizePlan(ExecutionPlan *plan) {
 	// into an expand into operation
 	reduceTraversal(plan);
 
+	// resolve nodes closing a cycle by intersecting adjacency rows
+	applyLeapfrogJoin(plan);
+
 	// try to reduce distinct if it follows aggregation
 	reduceDistinct(plan);
 
 	// try to reduce execution plan incase it perform node or edge counting
 	reduceCount(plan);
 
+	// project indexed attributes out of the index rather than the graph
+	applyIndexOnlyScan(plan);
+
+	// drop sorts satisfied by the order in which scans produce nodes
+	applyIndexOrder(plan);
+
 	// let operations know about specified limit(s)
 	applyLimit(plan);
 
 	// let operations know about specified skip(s)
 	applySkip(plan);
+
+	// let procedures know about the top records sorted out of their output
+	applyProcedureOrder(plan);
+
+	// evaluate filters left on top of cartesian products within the product
+	filterCartesianProducts(plan);
+
+	// evaluate filters applied directly on scans concurrently
+	parallelizeFilters(plan);
+
+	// commit updates in chunks when they can't affect the records they read
+	streamUpdates(plan);
 }
 
+
+void optimizeUnionPlan(ExecutionPlan *plan) {
+	// consume independent read-only branches concurrently
+	parallelizeUnion(plan);
+}
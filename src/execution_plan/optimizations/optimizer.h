@@ -11,3 +11,6 @@
 /* Try to optimize an execution plan segment. */
 void optimizePlan(ExecutionPlan *plan);
 
+/* Try to optimize a UNION plan, joining its already optimized branches. */
+void optimizeUnionPlan(ExecutionPlan *plan);
+
@@ -0,0 +1,87 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include <strings.h>
+#include "../ops/op_filter.h"
+#include "../execution_plan.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* Filters applied directly on top of a node scan can be evaluated
+ * concurrently, the scan is consumed in morsels and each morsel is split
+ * between QUERY_PARALLELISM threads.
+ * this optimization marks such filters, given that their evaluation
+ * is free of side effects and does not access shared mutable state. */
+
+// functions which access graph matrices, unsafe to invoke concurrently
+static const char *_unsafe_funcs[] = {"labels", "haslabels", "indegree",
+	"outdegree"};
+
+static bool _AR_EXP_ThreadSafe(const AR_ExpNode *exp) {
+	if(exp->type == AR_EXP_OPERAND) {
+		// a borrowed record is handed to functions holding private data
+		return exp->operand.type != AR_EXP_BORROW_RECORD;
+	}
+
+	ASSERT(exp->type == AR_EXP_OP);
+	AR_FuncDesc *f = exp->op.f;
+
+	// non-reducible functions are either nondeterministic or stateful
+	if(!f->reducible || f->aggregate || f->privdata != NULL) return false;
+
+	uint n = sizeof(_unsafe_funcs) / sizeof(_unsafe_funcs[0]);
+	for(uint i = 0; i < n; i++) {
+		if(strcasecmp(f->name, _unsafe_funcs[i]) == 0) return false;
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(!_AR_EXP_ThreadSafe(exp->op.children[i])) return false;
+	}
+
+	return true;
+}
+
+static bool _FilterTree_ThreadSafe(const FT_FilterNode *root) {
+	switch(root->t) {
+		case FT_N_EXP:
+			return _AR_EXP_ThreadSafe(root->exp.exp);
+		case FT_N_PRED:
+			return _AR_EXP_ThreadSafe(root->pred.lhs) &&
+				   _AR_EXP_ThreadSafe(root->pred.rhs);
+		case FT_N_COND:
+			return _FilterTree_ThreadSafe(root->cond.left) &&
+				   (root->cond.right == NULL ||
+					_FilterTree_ThreadSafe(root->cond.right));
+		default:
+			ASSERT(false && "unknown filter tree node type");
+			return false;
+	}
+}
+
+static bool _ScanTap(const OpBase *op) {
+	if(op->childCount != 0) return false;
+
+	return (op->type == OPType_ALL_NODE_SCAN            ||
+			op->type == OPType_NODE_BY_LABEL_SCAN       ||
+			op->type == OPType_NODE_BY_LABEL_AND_ID_SCAN);
+}
+
+void parallelizeFilters(ExecutionPlan *plan) {
+	OpBase **filters = ExecutionPlan_CollectOps(plan->root, OPType_FILTER);
+
+	for(uint i = 0; i < array_len(filters); i++) {
+		OpFilter *filter = (OpFilter *)filters[i];
+		ASSERT(filter->op.childCount == 1);
+
+		if(!_ScanTap(filter->op.children[0])) continue;
+		if(!_FilterTree_ThreadSafe(filter->filterTree)) continue;
+
+		FilterOp_EnableParallelism(filter);
+	}
+
+	array_free(filters);
+}
+
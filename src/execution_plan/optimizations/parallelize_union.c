@@ -0,0 +1,75 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../ops/op_join.h"
+#include "../execution_plan.h"
+#include "../execution_plan_cost.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* The branches of a UNION are independent of one another,
+ * read-only branches can therefore be consumed concurrently by the Join
+ * operation joining them, see JoinOp_EnableParallelism.
+ * concurrent execution pays off only if it overlaps enough work, that is
+ * the estimated cost of all branches but the costliest one, smaller unions
+ * are executed by the query's own thread. */
+
+// minimal estimated number of records produced by the overlapped branches
+#define UNION_PARALLEL_MIN_COST 10000
+
+// a branch may be consumed by a worker thread if it doesn't write
+// and doesn't invoke procedures, which may call back into Redis
+static bool _BranchThreadSafe(OpBase *op) {
+	if(OpBase_IsWriter(op) || op->type == OPType_PROC_CALL) return false;
+
+	for(int i = 0; i < op->childCount; i++) {
+		if(!_BranchThreadSafe(op->children[i])) return false;
+	}
+
+	return true;
+}
+
+void parallelizeUnion(ExecutionPlan *plan) {
+	OpBase *join = ExecutionPlan_LocateOp(plan->root, OPType_JOIN);
+	if(join == NULL) return;
+
+	// a writing branch may affect the records read by the others
+	int n = join->childCount;
+	for(int i = 0; i < n; i++) {
+		if(!_BranchThreadSafe(join->children[i])) return;
+	}
+
+	// estimates are collected in pre-order, each branch root
+	// is followed by its descendants' estimates
+	double cost;
+	OpEstimate *estimates = ExecutionPlan_EstimateOps(plan, &cost);
+
+	int branch = -1;
+	double total = 0;
+	double costliest = 0;
+	double branch_cost = 0;
+	uint count = array_len(estimates);
+	for(uint i = 0; i < count; i++) {
+		if(branch + 1 < n && estimates[i].op == join->children[branch + 1]) {
+			costliest = MAX(costliest, branch_cost);
+			branch_cost = 0;
+			branch++;
+		}
+
+		// operations above the join aren't executed concurrently
+		if(branch < 0) continue;
+		branch_cost += estimates[i].records;
+		total += estimates[i].records;
+	}
+	costliest = MAX(costliest, branch_cost);
+
+	array_free(estimates);
+
+	if(total - costliest >= UNION_PARALLEL_MIN_COST) {
+		JoinOp_EnableParallelism((OpJoin *)join);
+	}
+}
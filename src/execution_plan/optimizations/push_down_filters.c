@@ -0,0 +1,235 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../ops/op_filter.h"
+#include "../ops/op_project.h"
+#include "../execution_plan.h"
+#include "../../util/rax_extensions.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* pushDownFilters migrates filters across WITH boundaries and into the
+ * bound branch of Apply operations, such that they're evaluated as early
+ * as possible and may be later on reduced to index scans, e.g.
+ *
+ * MATCH (n:User) WITH n AS u WHERE u.id = $id RETURN u
+ *
+ * the filter on 'u' is applied to 'n' directly above the label scan.
+ *
+ * MATCH (n:User) OPTIONAL MATCH (n)-[]->(m) WITH n, m WHERE n.id = $id
+ *
+ * the filter on 'n' is applied before the optional match is evaluated.
+ *
+ * a filter is pushed below a WITH projection only if each entity it refers
+ * to is projected as is, possibly renamed, and if its evaluation is
+ * deterministic and independent of the record layout.
+ * filters never pass operations which would observe a different set of
+ * records, these are: LIMIT, SKIP, OPTIONAL, MERGE and writing operations.
+ * must run before utilizeIndices. */
+
+// operations a migrated filter must remain above
+static const OPType _boundaries[] = {
+	OPType_APPLY,
+	OPType_MERGE,
+	OPType_MERGE_CREATE,
+	OPType_OPTIONAL,
+	OPType_LIMIT,
+	OPType_SKIP,
+	OPType_CREATE,
+	OPType_UPDATE,
+	OPType_DELETE,
+	OPType_JOIN,
+};
+
+#define BOUNDARY_COUNT (sizeof(_boundaries) / sizeof(_boundaries[0]))
+
+static bool _AR_EXP_Movable(const AR_ExpNode *exp) {
+	if(exp->type == AR_EXP_OPERAND) {
+		// functions handed the entire record depend on its layout
+		return exp->operand.type != AR_EXP_BORROW_RECORD;
+	}
+
+	// private data may refer to record entries by name
+	AR_FuncDesc *f = exp->op.f;
+	if(!f->deterministic || f->aggregate || f->privdata != NULL) return false;
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(!_AR_EXP_Movable(exp->op.children[i])) return false;
+	}
+
+	return true;
+}
+
+static bool _FilterTree_Movable(const FT_FilterNode *root) {
+	switch(root->t) {
+		case FT_N_EXP:
+			return _AR_EXP_Movable(root->exp.exp);
+		case FT_N_PRED:
+			return _AR_EXP_Movable(root->pred.lhs) &&
+				   _AR_EXP_Movable(root->pred.rhs);
+		case FT_N_COND:
+			return _FilterTree_Movable(root->cond.left) &&
+				   (root->cond.right == NULL ||
+					_FilterTree_Movable(root->cond.right));
+		default:
+			ASSERT(false && "unknown filter tree node type");
+			return false;
+	}
+}
+
+// returns the entity 'alias' is projected from by 'project'
+// NULL if it is computed rather than projected as is
+static const char *_projectedFrom(const OpProject *project, const char *alias) {
+	for(uint i = 0; i < project->exp_count; i++) {
+		AR_ExpNode *exp = project->exps[i];
+		if(strcmp(exp->resolved_name, alias) != 0) continue;
+		if(!AR_EXP_IsVariadic(exp)) return NULL;
+		return exp->operand.variadic.entity_alias;
+	}
+	return NULL;
+}
+
+// renames entity references within 'exp' to the entities they're projected from
+static void _AR_EXP_Rename(AR_ExpNode *exp, const OpProject *project) {
+	if(exp->type == AR_EXP_OPERAND) {
+		if(exp->operand.type != AR_EXP_VARIADIC) return;
+		const char *source = _projectedFrom(project,
+				exp->operand.variadic.entity_alias);
+		ASSERT(source != NULL);
+		exp->operand.variadic.entity_alias = source;
+		exp->operand.variadic.entity_alias_idx = IDENTIFIER_NOT_FOUND;
+		return;
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		_AR_EXP_Rename(exp->op.children[i], project);
+	}
+}
+
+static void _FilterTree_Rename(FT_FilterNode *root, const OpProject *project) {
+	switch(root->t) {
+		case FT_N_EXP:
+			_AR_EXP_Rename(root->exp.exp, project);
+			break;
+		case FT_N_PRED:
+			_AR_EXP_Rename(root->pred.lhs, project);
+			_AR_EXP_Rename(root->pred.rhs, project);
+			break;
+		case FT_N_COND:
+			_FilterTree_Rename(root->cond.left, project);
+			if(root->cond.right) _FilterTree_Rename(root->cond.right, project);
+			break;
+		default:
+			ASSERT(false && "unknown filter tree node type");
+	}
+}
+
+// returns true if every entity filtered by 'filter' is projected as is
+static bool _projectsFiltered(const OpProject *project, const OpFilter *filter) {
+	rax *refs = FilterTree_CollectModified(filter->filterTree);
+	bool projected = raxSize(refs) > 0;
+
+	raxIterator it;
+	raxStart(&it, refs);
+	raxSeek(&it, "^", NULL, 0);
+	while(projected && raxNext(&it)) {
+		char alias[it.key_len + 1];
+		memcpy(alias, it.key, it.key_len);
+		alias[it.key_len] = '\0';
+		projected = (_projectedFrom(project, alias) != NULL);
+	}
+	raxStop(&it);
+	raxFree(refs);
+
+	return projected;
+}
+
+// returns the first operation of 'segment' within 'root' which is fed by
+// an earlier segment, NULL if there's none
+static const OpBase *_segmentTap(const OpBase *root, const ExecutionPlan *segment) {
+	if(root->plan != segment) return NULL;
+	for(int i = 0; i < root->childCount; i++) {
+		if(root->children[i]->plan != segment) return root;
+		const OpBase *tap = _segmentTap(root->children[i], segment);
+		if(tap != NULL) return tap;
+	}
+	return NULL;
+}
+
+// places 'filter' at the earliest position within 'root' resolving all its
+// references, without passing boundaries or 'limit'
+// returns false if the filter wasn't moved
+static bool _sink(OpFilter *filter, OpBase *root, const OpBase *limit) {
+	rax *refs = FilterTree_CollectModified(filter->filterTree);
+	OpBase *op = ExecutionPlan_LocateReferencesExcludingOps(root, limit,
+			_boundaries, BOUNDARY_COUNT, refs);
+	bool resolved = (raxSize(refs) == 0);
+	raxFree(refs);
+
+	if(op == NULL || !resolved) return false;
+	if(op == filter->op.children[0]) return false;
+
+	// detach filter, its segment might be rooted at it
+	ExecutionPlan *segment = (ExecutionPlan *)filter->op.plan;
+	if(segment->root == (OpBase *)filter) segment->root = filter->op.children[0];
+	ExecutionPlan_RemoveOp(segment, (OpBase *)filter);
+
+	ExecutionPlan_PushBelow(op, (OpBase *)filter);
+	if(op == op->plan->root) ((ExecutionPlan *)op->plan)->root = (OpBase *)filter;
+
+	return true;
+}
+
+// tries to push 'filter' below its child, returns true on success
+static bool _pushDown(OpFilter *filter) {
+	if(!_FilterTree_Movable(filter->filterTree)) return false;
+
+	OpBase *child = filter->op.children[0];
+
+	if(child->type == OPType_APPLY) {
+		// filters on the bound branch alone are evaluated before the
+		// optional branch pads records
+		OpBase *bound = child->children[0];
+		return _sink(filter, bound, _segmentTap(bound, bound->plan));
+	}
+
+	if(child->type != OPType_PROJECT || child->childCount == 0) return false;
+
+	OpProject *project = (OpProject *)child;
+	if(!_projectsFiltered(project, filter)) return false;
+
+	// references are rewritten to the projected entities
+	// which are resolved by the previous segment
+	OpBase *lower = child->children[0];
+	FT_FilterNode *tree = filter->filterTree;
+	FT_FilterNode *renamed = FilterTree_Clone(tree);
+	_FilterTree_Rename(renamed, project);
+	filter->filterTree = renamed;
+
+	if(!_sink(filter, lower, _segmentTap(lower, lower->plan))) {
+		FilterTree_Free(renamed);
+		filter->filterTree = tree;
+		return false;
+	}
+
+	FilterTree_Free(tree);
+	return true;
+}
+
+void pushDownFilters(ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+
+	OpBase **filters = ExecutionPlan_CollectOps(plan->root, OPType_FILTER);
+	uint filter_count = array_len(filters);
+
+	// a filter may cross multiple WITH clauses, one at a time
+	for(uint i = 0; i < filter_count; i++) {
+		OpFilter *filter = (OpFilter *)filters[i];
+		while(_pushDown(filter));
+	}
+
+	array_free(filters);
+}
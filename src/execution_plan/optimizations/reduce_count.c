@@ -7,6 +7,8 @@
 #include "../ops/ops.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
+#include "../../util/rax_extensions.h"
+#include "../../filter_tree/ft_to_native.h"
 #include "../../arithmetic/aggregate_funcs/agg_funcs.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
@@ -14,7 +16,26 @@
  * performing solely node/edge counting: total number of nodes/edges
  * in the graph, total number of nodes/edges with a specific label/relation.
  * In which case we can avoid performing both SCAN* and AGGREGATE
- * operations by simply returning a precomputed count */
+ * operations by simply returning a precomputed count.
+ *
+ * Otherwise, aggregations counting a traversal's destinations grouped by
+ * its source, e.g.
+ *
+ * MATCH (c:Customer)-[:ORDERED]->(o:Order) RETURN c.country, count(o)
+ *
+ * have the traversal reduce its result matrix rows into per source counts
+ * which are then summed, rather than producing a record per destination,
+ * single relation traversals read each source's row degree directly
+ * MATCH (n)-[:R]->() WHERE ID(n) = $id RETURN count(*)
+ *
+ * Counting, or taking the minimum or maximum of an attribute of, the nodes
+ * of a native index scan is answered by the scan itself, e.g.
+ *
+ * MATCH (n:Order) WHERE n.amount > 100 RETURN count(n)
+ * MATCH (n:Order) WHERE n.amount > 100 RETURN max(n.amount)
+ *
+ * counts are summed out of the index buckets and extremes are read off
+ * the first entry of the index range, no record is produced per node */
 
 static int _identifyResultAndAggregateOps(OpBase *root, OpResult **opResult,
 										  OpAggregate **opAggregate) {
@@ -67,12 +88,15 @@ static int _identifyNodeCountPattern(OpBase *root, OpResult **opResult, OpAggreg
 		return 0;
 	}
 
-	*opScan = op;
 	if(op->type == OPType_NODE_BY_LABEL_SCAN) {
 		NodeByLabelScan *labelScan = (NodeByLabelScan *)op;
+		// the label count doesn't account for intersected or excluded labels
+		if(NodeByLabelScanOp_MultiLabel(labelScan)) return 0;
 		*label = labelScan->n.label;
 	}
 
+	*opScan = op;
+
 	return 1;
 }
 
@@ -154,7 +178,7 @@ static bool _identifyEdgeCountPattern(OpBase *root, OpResult **opResult,
 	return true;
 }
 
-void _reduceEdgeCount(ExecutionPlan *plan) {
+bool _reduceEdgeCount(ExecutionPlan *plan) {
 	// we'll only modify execution plan if it is structured as follows:
 	// "Full Scan -> Conditional Traverse -> Aggregate -> Results"
 	OpBase *opScan;
@@ -166,7 +190,7 @@ void _reduceEdgeCount(ExecutionPlan *plan) {
 	// "Full Scan -> Conditional Traverse -> Aggregate -> Results"
 	// if that's not the case, simply return without making any modifications
 	if(!_identifyEdgeCountPattern(plan->root, &opResult, &opAggregate,
-				&opTraverse, &opScan)) return;
+				&opTraverse, &opScan)) return false;
 
 	// user is trying to count edges (either in total or of specific types)
 	// in the graph. optimize by skipping Scan, Traverse and Aggregate
@@ -177,7 +201,7 @@ void _reduceEdgeCount(ExecutionPlan *plan) {
 	OpCondTraverse *condTraverse = (OpCondTraverse *)opTraverse;
 	// the traversal op doesn't contain information about the traversed edge,
 	// cannot apply optimization
-	if(!condTraverse->edge_ctx) return;
+	if(!condTraverse->edge_ctx) return false;
 
 	uint relationCount = array_len(condTraverse->edge_ctx->edgeRelationTypes);
 
@@ -218,11 +242,245 @@ void _reduceEdgeCount(ExecutionPlan *plan) {
 	OpBase_Free((OpBase *)opAggregate);
 
 	ExecutionPlan_AddOp((OpBase *)opResult, opProject);
+	return true;
+}
+
+// returns true if 'exp' is a non distinct count of all records,
+// of 'dest' or of 'edge' if specified
+static bool _countsTraversal(AR_ExpNode *exp, const char *dest,
+		const char *edge) {
+	if(exp->type != AR_EXP_OP ||
+	   exp->op.f->aggregate != true ||
+	   strcasecmp(AR_EXP_GetFuncName(exp), "count") ||
+	   AR_EXP_PerformsDistinct(exp) ||
+	   exp->op.child_count != 1) return false;
+
+	// count(*) counts records, the traversal's destinations are never NULL
+	AR_ExpNode *arg = exp->op.children[0];
+	if(AR_EXP_IsConstant(arg)) return !SIValue_IsNull(arg->operand.constant);
+
+	if(arg->type != AR_EXP_OPERAND || arg->operand.type != AR_EXP_VARIADIC) {
+		return false;
+	}
+
+	const char *alias = arg->operand.variadic.entity_alias;
+	return (strcmp(alias, dest) == 0 ||
+			(edge != NULL && strcmp(alias, edge) == 0));
+}
+
+// returns true if 'alias' is referred to by 'refs'
+static inline bool _refers(rax *refs, const char *alias) {
+	if(alias == NULL) return false;
+	return raxFind(refs, (unsigned char *)alias, strlen(alias)) != raxNotFound;
+}
+
+// returns true if 'exp' is handed the entire record
+static bool _borrowsRecord(const AR_ExpNode *exp) {
+	if(exp->type == AR_EXP_OPERAND) {
+		return exp->operand.type == AR_EXP_BORROW_RECORD;
+	}
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(_borrowsRecord(exp->op.children[i])) return true;
+	}
+
+	return false;
+}
+
+// checks if 'aggregate' solely counts destinations of 'traverse'
+// grouping by expressions which don't refer to the destination
+static bool _identifyDestinationCountPattern(OpAggregate *aggregate,
+		OpCondTraverse **traverse) {
+	OpBase *op = ((OpBase *)aggregate)->children[0];
+
+	// a traversal producing a record per source-destination pair
+	if(op->type != OPType_CONDITIONAL_TRAVERSE || op->childCount != 1) {
+		return false;
+	}
+
+	*traverse = (OpCondTraverse *)op;
+	if((*traverse)->count_dests) return false;
+
+	// a record is produced per edge when edges are populated
+	// these can only be counted off a typed relation matrix, e.g.
+	// MATCH (n)-[e:R]->() WHERE ID(n) = $id RETURN count(e)
+	AlgebraicExpression *ae = (*traverse)->ae;
+	const char *edge = NULL;
+	if((*traverse)->edge_ctx != NULL) {
+		if(ae->type != AL_OPERAND       ||
+		   ae->operand.diagonal         ||
+		   ae->operand.label == NULL) return false;
+		edge = AlgebraicExpression_Edge(ae);
+	}
+
+	const char *dest = AlgebraicExpression_Dest(ae);
+
+	for(uint i = 0; i < aggregate->aggregate_count; i++) {
+		if(!_countsTraversal(aggregate->aggregate_exps[i], dest, edge)) {
+			return false;
+		}
+	}
+
+	rax *refs = raxNew();
+	for(uint i = 0; i < aggregate->key_count; i++) {
+		if(_borrowsRecord(aggregate->key_exps[i])) {
+			raxFree(refs);
+			return false;
+		}
+		AR_EXP_CollectEntities(aggregate->key_exps[i], refs);
+	}
+	bool independent = !_refers(refs, dest) && !_refers(refs, edge);
+	raxFree(refs);
+
+	return independent;
+}
+
+// count(dest) over the traversal is the sum of destinations per source
+// coalesced to 0 and converted to an integer, matching count's result
+static AR_ExpNode *_SumDestinationCounts(AR_ExpNode *count, const char *dest) {
+	AR_ExpNode *sum = AR_EXP_NewOpNode("sum", 1);
+	sum->op.children[0] = AR_EXP_NewVariableOperandNode(dest);
+
+	AR_ExpNode *to_int = AR_EXP_NewOpNode("tointeger", 1);
+	to_int->op.children[0] = sum;
+
+	AR_ExpNode *exp = AR_EXP_NewOpNode("coalesce", 2);
+	exp->op.children[0] = to_int;
+	exp->op.children[1] = AR_EXP_NewConstOperandNode(SI_LongVal(0));
+	exp->resolved_name = count->resolved_name;
+
+	return exp;
+}
+
+static void _reduceDestinationCount(OpAggregate *aggregate) {
+	OpCondTraverse *traverse;
+	if(!_identifyDestinationCountPattern(aggregate, &traverse)) return;
+
+	const char *dest = AlgebraicExpression_Dest(traverse->ae);
+	for(uint i = 0; i < aggregate->aggregate_count; i++) {
+		AR_ExpNode *count = aggregate->aggregate_exps[i];
+		aggregate->aggregate_exps[i] = _SumDestinationCounts(count, dest);
+		AR_EXP_Free(count);
+	}
+
+	CondTraverseOp_CountDestinations(traverse);
+}
+
+// checks if execution plan solely aggregates the nodes of an index scan
+// "Index Scan -> Aggregate -> Results"
+static bool _identifyIndexAggregatePattern(OpBase *root, OpResult **opResult,
+		OpAggregate **opAggregate, IndexScan **opScan,
+		IndexScanAggregate *func, Attribute_ID *attr) {
+	OpBase *op = root;
+	if(op->type != OPType_RESULTS || op->childCount != 1) return false;
+	*opResult = (OpResult *)op;
+
+	// expecting a single aggregation, without keys
+	op = op->children[0];
+	if(op->type != OPType_AGGREGATE || op->childCount != 1) return false;
+	*opAggregate = (OpAggregate *)op;
+	if((*opAggregate)->aggregate_count != 1 ||
+	   (*opAggregate)->key_count != 0) {
+		return false;
+	}
+
+	// scan must be a tap over a native index
+	op = op->children[0];
+	if(op->type != OPType_NODE_BY_INDEX_SCAN || op->childCount != 0 ||
+	   op->plan != (*opAggregate)->op.plan) {
+		return false;
+	}
+	*opScan = (IndexScan *)op;
+	if((*opScan)->native == NULL) return false;
+
+	AR_ExpNode *exp = (*opAggregate)->aggregate_exps[0];
+	if(exp->type != AR_EXP_OP || exp->op.f->aggregate != true ||
+	   exp->op.child_count != 1 || AR_EXP_PerformsDistinct(exp)) {
+		return false;
+	}
+
+	const char *alias = (*opScan)->n.alias;
+	const char *name = AR_EXP_GetFuncName(exp);
+	AR_ExpNode *arg = exp->op.children[0];
+
+	// count(n), scanned nodes are never NULL
+	if(strcasecmp(name, "count") == 0) {
+		*func = INDEX_SCAN_AGGREGATE_COUNT;
+		*attr = ATTRIBUTE_NOTFOUND;
+		return (arg->type == AR_EXP_OPERAND &&
+				arg->operand.type == AR_EXP_VARIADIC &&
+				strcmp(arg->operand.variadic.entity_alias, alias) == 0);
+	}
+
+	// min(n.v) or max(n.v)
+	if(strcasecmp(name, "min") == 0) *func = INDEX_SCAN_AGGREGATE_MIN;
+	else if(strcasecmp(name, "max") == 0) *func = INDEX_SCAN_AGGREGATE_MAX;
+	else return false;
+
+	char *attr_name;
+	if(!AR_EXP_IsAttribute(arg, &attr_name)) return false;
+
+	const AR_ExpNode *entity = arg->op.children[0];
+	if(!AR_EXP_IsVariadic(entity) ||
+	   strcmp(entity->operand.variadic.entity_alias, alias) != 0) {
+		return false;
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	*attr = GraphContext_GetAttributeID(gc, attr_name);
+	if(*attr == ATTRIBUTE_NOTFOUND) return false;
+
+	// the filter must bound the attribute for the scan to be ordered by it
+	// which also restricts the range to values of a single type
+	return FilterTree_NativeOrderable((*opScan)->filter, *attr);
+}
+
+static bool _reduceIndexAggregate(ExecutionPlan *plan) {
+	IndexScan *opScan;
+	OpResult *opResult;
+	OpAggregate *opAggregate;
+	IndexScanAggregate func;
+	Attribute_ID attr;
+
+	if(!_identifyIndexAggregatePattern(plan->root, &opResult, &opAggregate,
+				&opScan, &func, &attr)) {
+		return false;
+	}
+
+	// the scan projects the aggregated value under an internal alias
+	const char *alias = IndexScanOp_SetAggregate(opScan, func, attr);
+	AR_ExpNode *exp = AR_EXP_NewVariableOperandNode(alias);
+	exp->resolved_name = opAggregate->aggregate_exps[0]->resolved_name;
+	AR_ExpNode **exps = array_new(AR_ExpNode *, 1);
+	array_append(exps, exp);
+
+	OpBase *opProject = NewProjectOp(opAggregate->op.plan, exps);
+
+	// new execution plan: "Index Scan -> Project -> Results"
+	ExecutionPlan_RemoveOp(plan, (OpBase *)opAggregate);
+	OpBase_Free((OpBase *)opAggregate);
+
+	ExecutionPlan_PushBelow((OpBase *)opScan, opProject);
+	return true;
 }
 
 void reduceCount(ExecutionPlan *plan) {
 	// start by trying to identify node count pattern
 	// if unsuccessful try edge count pattern
-	if(!_reduceNodeCount(plan)) _reduceEdgeCount(plan);
+	if(_reduceNodeCount(plan) || _reduceEdgeCount(plan)) return;
+
+	// aggregate the nodes of an index scan within the scan
+	if(_reduceIndexAggregate(plan)) return;
+
+	// count traversal destinations per source
+	OpBase **aggregates = ExecutionPlan_CollectOps(plan->root,
+			OPType_AGGREGATE);
+
+	uint aggregate_count = array_len(aggregates);
+	for(uint i = 0; i < aggregate_count; i++) {
+		_reduceDestinationCount((OpAggregate *)aggregates[i]);
+	}
+
+	array_free(aggregates);
 }
 
@@ -5,7 +5,12 @@
 */
 
 #include "RG.h"
+#include "../../query_ctx.h"
 #include "../execution_plan.h"
+#include "../ops/op_project.h"
+#include "../ops/op_distinct.h"
+#include "../ops/op_node_by_label_scan.h"
+#include "../ops/op_node_by_index_scan.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
 /* A distinct operation following an aggregation operation
@@ -14,6 +19,77 @@
  * followed by a distinct operation, in which case we can omit distinct
  * from the execution plan. */
 
+// returns true if 'alias' is one of the aliases 'distinct' operates on
+static bool _DistinctBy(const OpDistinct *distinct, const char *alias) {
+	for(uint i = 0; i < distinct->offset_count; i++) {
+		if(strcmp(distinct->aliases[i], alias) == 0) return true;
+	}
+	return false;
+}
+
+// a distinct operation over the projections of a scanned node is
+// unnecessary if it distincts by a uniquely constrained attribute of the node
+// which no node misses, as long as each node is produced once
+// e.g. MATCH (u:User) RETURN DISTINCT u.id, u.name
+static bool _UniqueProjection(const OpDistinct *distinct) {
+	OpBase *op = distinct->op.children[0];
+	if(op->type != OPType_PROJECT || op->childCount != 1) return false;
+	const OpProject *project = (const OpProject *)op;
+
+	// filters only drop records
+	op = op->children[0];
+	while(op->type == OPType_FILTER) op = op->children[0];
+	if(op->childCount != 0) return false;
+
+	const NodeScanCtx *n;
+	const FT_FilterNode *filter = NULL;
+	if(op->type == OPType_NODE_BY_LABEL_SCAN) {
+		n = &((NodeByLabelScan *)op)->n;
+	} else if(op->type == OPType_NODE_BY_INDEX_SCAN) {
+		IndexScan *scan = (IndexScan *)op;
+		// a single node is produced
+		if(scan->unique) return true;
+		n = &scan->n;
+		filter = scan->filter;
+	} else {
+		return false;
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchemaByID(gc, n->label_id, SCHEMA_NODE);
+	if(s == NULL || Schema_ConstraintCount(s) == 0) return false;
+
+	for(uint i = 0; i < project->exp_count; i++) {
+		AR_ExpNode *exp = project->exps[i];
+		if(!_DistinctBy(distinct, exp->resolved_name)) continue;
+
+		char *attr_name;
+		if(!AR_EXP_IsAttribute(exp, &attr_name)) continue;
+		AR_ExpNode *entity = exp->op.children[0];
+		if(!AR_EXP_IsVariadic(entity) ||
+		   strcmp(entity->operand.variadic.entity_alias, n->alias) != 0) {
+			continue;
+		}
+
+		Attribute_ID attr = GraphContext_GetAttributeID(gc, attr_name);
+		if(Schema_GetConstraint(s, CT_UNIQUE, attr) == NULL) continue;
+
+		// nodes missing the attribute all project NULL
+		if(Schema_GetConstraint(s, CT_EXISTS, attr) != NULL) return true;
+
+		// unless the index filters them out
+		if(filter != NULL) {
+			rax *attrs = FilterTree_CollectAttributes(filter);
+			bool filtered = raxFind(attrs, (unsigned char *)attr_name,
+					strlen(attr_name)) != raxNotFound;
+			raxFree(attrs);
+			if(filtered) return true;
+		}
+	}
+
+	return false;
+}
+
 void reduceDistinct(ExecutionPlan *plan) {
 	// Look for Distinct operations.
 	OpBase **distinct_ops = ExecutionPlan_CollectOps(plan->root, OPType_DISTINCT);
@@ -21,7 +97,8 @@ void reduceDistinct(ExecutionPlan *plan) {
 	for(uint i = 0; i < array_len(distinct_ops); i++) {
 		OpBase *distinct = distinct_ops[i];
 		ASSERT(distinct->childCount == 1);
-		if(distinct->children[0]->type == OPType_AGGREGATE) {
+		if(distinct->children[0]->type == OPType_AGGREGATE ||
+		   _UniqueProjection((OpDistinct *)distinct)) {
 			// We can remove the Distinct op if its child is an aggregate operation,
 			// as its results will inherently be unique.
 			ExecutionPlan_RemoveOp(plan, distinct);
@@ -31,4 +108,3 @@ void reduceDistinct(ExecutionPlan *plan) {
 
 	array_free(distinct_ops);
 }
-
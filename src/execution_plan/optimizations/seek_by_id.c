@@ -5,6 +5,8 @@
  */
 
 #include "../../util/arr.h"
+#include "../../query_ctx.h"
+#include "../../datatypes/array.h"
 #include "../ops/op_filter.h"
 #include "../ops/op_all_node_scan.h"
 #include "../ops/op_node_by_id_seek.h"
@@ -16,7 +18,10 @@
 /* The seek by ID optimization searches for a SCAN operation on which
  * a filter of the form ID(n) = X is applied in which case
  * both the SCAN and FILTER operations can be reduced into a single
- * NODE_BY_ID_SEEK operation. */
+ * NODE_BY_ID_SEEK operation.
+ * A filter of the form ID(n) IN [X, Y, Z] reduces the SCAN into
+ * a NODE_BY_ID_SEEK over the listed IDs, label scans are followed by
+ * a filter checking the scanned labels. */
 
 static bool _idFilter(FT_FilterNode *f, AST_Operator *rel, EntityID *id, bool *reverse) {
 	if(f->t != FT_N_PRED) return false;
@@ -56,7 +61,124 @@ static bool _idFilter(FT_FilterNode *f, AST_Operator *rel, EntityID *id, bool *r
 	return true;
 }
 
+// checks if 'f' is of the form ID(alias) IN X
+// where X is a constant list or a parameter holding a list
+static bool _idListFilter(FT_FilterNode *f, const char *alias, AR_ExpNode **list) {
+	if(f->t != FT_N_EXP) return false;
+
+	AR_ExpNode *exp = f->exp.exp;
+	if(!AR_EXP_IsOperation(exp)) return false;
+	if(strcasecmp(AR_EXP_GetFuncName(exp), "in")) return false;
+
+	// make sure applied function is ID, over the scanned node
+	AR_ExpNode *id = exp->op.children[0];
+	if(!AR_EXP_IsOperation(id)) return false;
+	if(strcasecmp(AR_EXP_GetFuncName(id), "id")) return false;
+
+	AR_ExpNode *node = id->op.children[0];
+	if(!AR_EXP_IsVariadic(node)) return false;
+	if(strcmp(node->operand.variadic.entity_alias, alias)) return false;
+
+	SIValue val;
+	AR_ExpNode *l = exp->op.children[1];
+	if(AR_EXP_IsParameter(l)) {
+		// plans are cached per parameter type, inspect the parameter
+		// without evaluating it, such that the list is read on every execution
+		rax *params = QueryCtx_GetParams();
+		if(params == NULL) return false;
+		AR_ExpNode *param = raxFind(params,
+				(unsigned char *)l->operand.param_name,
+				strlen(l->operand.param_name));
+		if(param == raxNotFound || !AR_EXP_IsConstant(param)) return false;
+		val = param->operand.constant;
+	} else if(!AR_EXP_ReduceToScalar(l, false, &val)) {
+		return false;
+	}
+	if(SI_TYPE(val) != T_ARRAY) return false;
+
+	*list = l;
+	return true;
+}
+
+// creates a filter checking the labels scanned by 'scan'
+static OpBase *_labelFilter(NodeByLabelScan *scan) {
+	const char *alias = scan->n.alias;
+	uint n = (scan->labels != NULL) ? array_len(scan->labels) : 0;
+
+	// hasLabels(n, [scanned label, intersected labels])
+	SIValue labels = SI_Array(n + 1);
+	SIArray_Append(&labels, SI_ConstStringVal((char *)scan->n.label));
+	for(uint i = 0; i < n; i++) {
+		SIArray_Append(&labels, SI_ConstStringVal((char *)scan->labels[i]));
+	}
+
+	AR_ExpNode *exp = AR_EXP_NewOpNode("hasLabels", 2);
+	exp->op.children[0] = AR_EXP_NewVariableOperandNode(alias);
+	exp->op.children[1] = AR_EXP_NewConstOperandNode(labels);
+	FT_FilterNode *root = FilterTree_CreateExpressionFilter(exp);
+
+	// NOT hasLabels(n, [excluded label])
+	n = (scan->excluded != NULL) ? array_len(scan->excluded) : 0;
+	for(uint i = 0; i < n; i++) {
+		SIValue excluded = SI_Array(1);
+		SIArray_Append(&excluded, SI_ConstStringVal((char *)scan->excluded[i]));
+
+		AR_ExpNode *has = AR_EXP_NewOpNode("hasLabels", 2);
+		has->op.children[0] = AR_EXP_NewVariableOperandNode(alias);
+		has->op.children[1] = AR_EXP_NewConstOperandNode(excluded);
+
+		AR_ExpNode *negate = AR_EXP_NewOpNode("not", 1);
+		negate->op.children[0] = has;
+
+		FT_FilterNode *cond = FilterTree_CreateConditionFilter(OP_AND);
+		FilterTree_AppendLeftChild(cond, root);
+		FilterTree_AppendRightChild(cond,
+				FilterTree_CreateExpressionFilter(negate));
+		root = cond;
+	}
+
+	return NewFilterOp(scan->op.plan, root);
+}
+
+// reduces 'scan_op' and a filter of the form ID(n) IN X into an ID list seek
+// returns true if the plan was modified
+static bool _UseIdListOptimization(ExecutionPlan *plan, OpBase *scan_op) {
+	const char *alias = (scan_op->type == OPType_NODE_BY_LABEL_SCAN) ?
+		((NodeByLabelScan *)scan_op)->n.alias :
+		((AllNodeScan *)scan_op)->alias;
+
+	OpBase *parent = scan_op->parent;
+	while(parent && parent->type == OPType_FILTER) {
+		AR_ExpNode *list;
+		OpFilter *filter = (OpFilter *)parent;
+		if(!_idListFilter(filter->filterTree, alias, &list)) {
+			parent = parent->parent;
+			continue;
+		}
+
+		OpBase *seek = NewNodeByIdListSeekOp(scan_op->plan, alias,
+				AR_EXP_Clone(list));
+		ExecutionPlan_ReplaceOp(plan, scan_op, seek);
+
+		// seeked nodes must carry the scanned labels
+		if(scan_op->type == OPType_NODE_BY_LABEL_SCAN) {
+			OpBase *labels = _labelFilter((NodeByLabelScan *)scan_op);
+			ExecutionPlan_PushBelow(seek, labels);
+		}
+		OpBase_Free(scan_op);
+
+		// Free replaced filter.
+		ExecutionPlan_RemoveOp(plan, parent);
+		OpBase_Free(parent);
+		return true;
+	}
+
+	return false;
+}
+
 static void _UseIdOptimization(ExecutionPlan *plan, OpBase *scan_op) {
+	if(_UseIdListOptimization(plan, scan_op)) return;
+
 	/* See if there's a filter of the form
 	 * ID(n) op X
 	 * where X is a constant and op in [EQ, GE, LE, GT, LT] */
@@ -0,0 +1,117 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../ops/op_update.h"
+#include "../execution_plan.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+/* streamUpdates looks for Update operations which can't affect the records
+ * they consume, nor the records observed by the rest of the plan, e.g.
+ *
+ * MATCH (n:X) WHERE n.v > 0 SET n.v = n.v + 1
+ *
+ * such operations commit their updates in chunks instead of buffering
+ * their entire input, memory is bounded by the chunk size rather than by
+ * the number of matched records.
+ *
+ * an update is free of read/write conflicts if:
+ * 1. its input is produced by a single node scan, optionally filtered
+ *    each record holds a distinct node, such that no record observes
+ *    an update made on behalf of another record
+ * 2. it only updates the scanned node, attribute updates don't modify
+ *    the matrices the scan iterates over
+ * 3. operations above it either consume their entire input before
+ *    producing a record, or observe only the record they're handed */
+
+// operations which only observe the record they're handed
+static const OPType _passthrough[] = {
+	OPType_RESULTS,
+	OPType_PROJECT,
+	OPType_FILTER,
+	OPType_SKIP,
+	OPType_DISTINCT,
+};
+
+// operations consuming their entire input before producing a record
+static const OPType _eager[] = {
+	OPType_AGGREGATE,
+	OPType_SORT,
+};
+
+// scans producing each node at most once
+static const OPType _scans[] = {
+	OPType_ALL_NODE_SCAN,
+	OPType_NODE_BY_LABEL_SCAN,
+	OPType_NODE_BY_ID_SEEK,
+	OPType_NODE_BY_LABEL_AND_ID_SCAN,
+};
+
+#define ARR_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+static bool _typeIn(OPType t, const OPType *types, uint n) {
+	for(uint i = 0; i < n; i++) {
+		if(types[i] == t) return true;
+	}
+	return false;
+}
+
+// returns the node scanned by 'op'
+// NULL if 'op' isn't a, possibly filtered, stand-alone node scan
+static const char *_scannedNode(const OpBase *op) {
+	while(op->type == OPType_FILTER) op = op->children[0];
+
+	if(!_typeIn(op->type, _scans, ARR_LEN(_scans))) return NULL;
+	if(op->childCount != 0) return NULL;
+
+	ASSERT(array_len(op->modifies) == 1);
+	return op->modifies[0];
+}
+
+static bool _updatesOnly(OpUpdate *update, const char *alias) {
+	bool only = true;
+
+	raxIterator it;
+	raxStart(&it, update->update_ctxs);
+	raxSeek(&it, "^", NULL, 0);
+	while(only && raxNext(&it)) {
+		EntityUpdateEvalCtx *ctx = it.data;
+		only = (strcmp(ctx->alias, alias) == 0);
+	}
+	raxStop(&it);
+
+	return only;
+}
+
+static bool _consumersIsolated(const OpBase *op) {
+	for(op = op->parent; op != NULL; op = op->parent) {
+		if(_typeIn(op->type, _eager, ARR_LEN(_eager))) return true;
+		if(!_typeIn(op->type, _passthrough, ARR_LEN(_passthrough))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void streamUpdates(ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+
+	OpBase **updates = ExecutionPlan_CollectOps(plan->root, OPType_UPDATE);
+
+	uint update_count = array_len(updates);
+	for(uint i = 0; i < update_count; i++) {
+		OpUpdate *update = (OpUpdate *)updates[i];
+		const char *alias = _scannedNode(update->op.children[0]);
+
+		if(alias == NULL) continue;
+		if(!_updatesOnly(update, alias)) continue;
+		if(!_consumersIsolated((OpBase *)update)) continue;
+
+		UpdateOp_Stream(update);
+	}
+
+	array_free(updates);
+}
@@ -5,6 +5,7 @@
  */
 
 #include "RG.h"
+#include <limits.h>
 #include "../../util/arr.h"
 #include "../../util/qsort.h"
 #include "../../util/strcmp.h"
@@ -43,6 +44,7 @@ static bool _should_transpose_entry_point
 	TraverseOrder_ScoreExpressions(scored_exp, exps, 2, bound_vars,
 								   filtered_entities, qg);
 	int src_score = scored_exp[0].score;
+	uint64_t src_cardinality = scored_exp[0].cardinality;
 
 	// transpose
 	AlgebraicExpression *tmp = exps[0];
@@ -53,9 +55,12 @@ static bool _should_transpose_entry_point
 	TraverseOrder_ScoreExpressions(scored_exp, exps, 2, bound_vars,
 								   filtered_entities, qg);
 	int dest_score = scored_exp[0].score;
+	uint64_t dest_cardinality = scored_exp[0].cardinality;
 
 	// transpose if top scored expression is 'dest_exp'
-	bool transpose = dest_score > src_score;
+	// on a tie, prefer the endpoint resolving to fewer nodes
+	bool transpose = dest_score > src_score ||
+		(dest_score == src_score && dest_cardinality < src_cardinality);
 
 	AlgebraicExpression_Free(exps[0]);
 	AlgebraicExpression_Free(exps[1]);
@@ -91,6 +96,68 @@ static void _resolve_winning_sequence
 	}
 }
 
+// returns the position of the first expression resolving 'alias'
+// -1 if 'alias' is bound prior to the traversal
+static int _resolving_expression
+(
+	AlgebraicExpression **exps,
+	uint exp_count,
+	const char *alias,
+	rax *bound_vars
+) {
+	if(bound_vars != NULL &&
+	   raxFind(bound_vars, (unsigned char *)alias, strlen(alias)) != raxNotFound) {
+		return -1;
+	}
+
+	for(uint i = 0; i < exp_count; i++) {
+		if(!RG_STRCMP(AlgebraicExpression_Src(exps[i]), alias) ||
+		   !RG_STRCMP(AlgebraicExpression_Dest(exps[i]), alias)) {
+			return i;
+		}
+	}
+
+	ASSERT(false);
+	return exp_count;
+}
+
+// move cycle closing expressions, whose both endpoints are resolved by
+// former expressions, right after the expression resolving their last endpoint
+//
+// MATCH (a)-[:F]->(b)-[:F]->(c)-[:F]->(a), (c)-[:G]->(d)
+// F(a,b), F(b,c), G(c,d), F(c,a) becomes F(a,b), F(b,c), F(c,a), G(c,d)
+//
+// closing a cycle as soon as possible discards partial matches early
+// and places the closing expressions next to the traversal resolving
+// their shared node, such that they can be evaluated together by
+// intersecting adjacency rows, see applyLeapfrogJoin
+static void _close_cycles_early
+(
+	AlgebraicExpression **exps,
+	uint exp_count,
+	rax *bound_vars
+) {
+	for(uint i = 1; i < exp_count; i++) {
+		AlgebraicExpression *exp = exps[i];
+		int src  = _resolving_expression(exps, exp_count,
+				AlgebraicExpression_Src(exp), bound_vars);
+		int dest = _resolving_expression(exps, exp_count,
+				AlgebraicExpression_Dest(exp), bound_vars);
+
+		// expression resolves one of its endpoints
+		if(src >= (int)i || dest >= (int)i) continue;
+
+		uint pos = ((src > dest) ? src : dest) + 1;
+		if(pos == 0) pos = 1;  // both endpoints bound prior to the traversal
+		if(pos >= i) continue;
+
+		// shift expressions [pos..i) one position to the right
+		memmove(exps + pos + 1, exps + pos,
+				(i - pos) * sizeof(AlgebraicExpression *));
+		exps[pos] = exp;
+	}
+}
+
 // construct a sorted list of valid expressions to consider, given a subset of
 // expression already in use 'arrangement' these will not show up in the
 // returned list.
@@ -209,7 +276,8 @@ void orderExpressions
 	AlgebraicExpression **exps,
 	uint *exp_count,
 	const FT_FilterNode *ft,
-	rax *bound_vars
+	rax *bound_vars,
+	const char *start
 ) {
 	// Validate inputs
 	ASSERT(qg          != NULL);
@@ -236,9 +304,22 @@ void orderExpressions
 	TraverseOrder_ScoreExpressions(scored_exps, exps, _exp_count, bound_vars,
 								   filtered_entities, qg);
 
-	// Sort scored_exps on score in descending order.
+	// a hinted start point outranks every other criteria
+	if(start != NULL) {
+		for(uint i = 0; i < _exp_count; i++) {
+			AlgebraicExpression *exp = scored_exps[i].exp;
+			if(!RG_STRCMP(AlgebraicExpression_Src(exp), start) ||
+			   !RG_STRCMP(AlgebraicExpression_Dest(exp), start)) {
+				scored_exps[i].score = INT_MAX;
+			}
+		}
+	}
+
+	// Sort scored_exps on score in descending order,
+	// breaking ties by estimated cardinality in ascending order.
 	// Compare macro used to sort scored expressions.
-#define score_cmp(a,b) ((*a).score > (*b).score)
+#define score_cmp(a,b) ((*a).score > (*b).score || \
+		((*a).score == (*b).score && (*a).cardinality < (*b).cardinality))
 	QSORT(ScoredExp, scored_exps, _exp_count, score_cmp);
 
 	//--------------------------------------------------------------------------
@@ -255,12 +336,22 @@ void orderExpressions
 	_resolve_winning_sequence(exps, _exp_count);
 
 	// transpose the winning expression if the destination node is a more
-	// efficient starting point
-	if(_should_transpose_entry_point(qg, exps[0], filtered_entities,
+	// efficient starting point, or if it is the hinted one
+	if(start != NULL) {
+		if(RG_STRCMP(AlgebraicExpression_Src(exps[0]), start) != 0 &&
+		   RG_STRCMP(AlgebraicExpression_Dest(exps[0]), start) == 0) {
+			AlgebraicExpression_Transpose(exps);
+		}
+	} else if(_should_transpose_entry_point(qg, exps[0], filtered_entities,
 									 bound_vars)) {
 		AlgebraicExpression_Transpose(exps);
 	}
 
+	// evaluate expressions closing a cycle as early as possible
+	if(QueryGraph_ContainsCycle(qg)) {
+		_close_cycles_early(exps, _exp_count, bound_vars);
+	}
+
 	// remove redundent operands from expressions
 	// MATCH (a:A)-[:R]->(b:B), (a)-[:R]->(c:C), (a:A)-[:R]->(d:D)
 	// will result in 2 expressions:
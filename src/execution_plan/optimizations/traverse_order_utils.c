@@ -5,6 +5,7 @@
  */
 
 #include "RG.h"
+#include "../../query_ctx.h"
 #include "../../util/arr.h"
 #include "../../util/strcmp.h"
 #include "traverse_order_utils.h"
@@ -28,6 +29,59 @@ static bool _AlgebraicExpression_IsVarLen
 	return QGEdge_VariableLength(e);
 }
 
+uint64_t TraverseOrder_NodeCardinality
+(
+	const char *alias,
+	const QueryGraph *qg
+) {
+	ASSERT(qg    != NULL);
+	ASSERT(alias != NULL);
+
+	Graph   *g     =  QueryCtx_GetGraph();
+	QGNode  *n     =  QueryGraph_GetNodeByAlias(qg, alias);
+	uint    count  =  QGNode_LabelCount(n);
+
+	// unlabeled node, all nodes are candidates
+	if(count == 0) return Graph_NodeCount(g);
+
+	// labeled node, scanned as the intersection of its labels
+	// estimate the intersection size assuming labels are independent
+	// each additional label keeps its share of the graph's nodes
+	// an unknown label has no nodes
+	uint64_t node_count = Graph_NodeCount(g);
+	uint64_t min_nnz = UINT64_MAX;
+	double selectivity = 1;
+	for(uint i = 0; i < count; i++) {
+		uint64_t nnz = Graph_LabeledNodeCount(g, QGNode_GetLabelID(n, i));
+		if(nnz == 0) return 0;
+		min_nnz = MIN(min_nnz, nnz);
+		selectivity *= (double)nnz / node_count;
+	}
+
+	// the smallest label isn't filtered by itself
+	selectivity /= (double)min_nnz / node_count;
+
+	// a non empty intersection is assumed to hold at least a single node
+	uint64_t cardinality = min_nnz * selectivity;
+	return MAX(cardinality, 1);
+}
+
+// estimate the number of entry points of an expression
+// when evaluated from either its source or destination
+static uint64_t _ExpressionCardinality
+(
+	AlgebraicExpression *exp,
+	const QueryGraph *qg
+) {
+	const char *src  = AlgebraicExpression_Src(exp);
+	const char *dest = AlgebraicExpression_Dest(exp);
+
+	uint64_t src_cardinality  = TraverseOrder_NodeCardinality(src, qg);
+	uint64_t dest_cardinality = TraverseOrder_NodeCardinality(dest, qg);
+
+	return MIN(src_cardinality, dest_cardinality);
+}
+
 //------------------------------------------------------------------------------
 // Scoring functions
 //------------------------------------------------------------------------------
@@ -256,6 +310,7 @@ void TraverseOrder_ScoreExpressions
 		score = TraverseOrder_LabelsScore(exp, qg);
 		scored_exp->exp = exp;
 		scored_exp->score = score;
+		scored_exp->cardinality = _ExpressionCardinality(exp, qg);
 
 		max = MAX(max, score);
 	}
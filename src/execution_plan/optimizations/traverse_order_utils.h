@@ -13,9 +13,19 @@
 // algebraic expression associated with a score
 typedef struct {
 	int score;                 // score given to expression
+	uint64_t cardinality;      // estimated number of entry points
 	AlgebraicExpression *exp;  // algebraic expression
 } ScoredExp;
 
+// estimate the number of nodes 'alias' can be resolved to
+// a labeled node is bound by the estimated intersection of its labels
+// an unlabeled node may be any node in the graph
+uint64_t TraverseOrder_NodeCardinality
+(
+	const char *alias,         // node alias
+	const QueryGraph *qg       // query graph
+);
+
  // collect independent entities
  // and the number of their independent occurrences from a filter tree
  // an indpendent entity is an entity that is the single entity in a predicate
@@ -9,6 +9,7 @@
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
 #include "../ops/op_filter.h"
+#include "../../ast/ast_hints.h"
 #include "../../ast/ast_shared.h"
 #include "../../datatypes/array.h"
 #include "../../datatypes/point.h"
@@ -104,6 +105,16 @@ static bool _applicable_predicate(const char* filtered_entity,
 
 	if(isDistanceFilter(filter)) return true;
 
+	// prefix filters must access an attribute of the filtered entity
+	if(isPrefixFilter(filter)) {
+		rax *aliases = raxNew();
+		AR_EXP_CollectEntities(filter->exp.exp->op.children[0], aliases);
+		res = raxFind(aliases, (unsigned char *)filtered_entity,
+				strlen(filtered_entity)) != raxNotFound;
+		raxFree(aliases);
+		return res;
+	}
+
 	switch(filter->t) {
 	case FT_N_PRED:
 		lhs_exp = filter->pred.lhs;
@@ -183,7 +194,8 @@ bool _applicableFilter
 	rax            *entities     =  NULL;
 	FT_FilterNode  *filter_tree  =  *filter;
 
-	// make sure the filter root is not a function, other then IN or distance
+	// make sure the filter root is not a function, other then IN, distance
+	// or a string prefix match
 	// make sure the "not equal, <>" operator isn't used
 	if(FilterTree_containsOp(filter_tree, OP_NEQUAL)) {
 		res = false;
@@ -280,6 +292,34 @@ static FT_FilterNode *_Concat_Filters(OpFilter **filter_ops) {
 	return root;
 }
 
+// returns true if one of 'filters' pins an attribute on which 'label_id'
+// declares a unique constraint to a single value, e.g. n.v = 1
+// in which case at most a single node passes the filters
+static bool _uniqueLookup
+(
+	int label_id,
+	OpFilter **filters
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
+	if(s == NULL || Schema_ConstraintCount(s) == 0) return false;
+
+	uint count = array_len(filters);
+	for(uint i = 0; i < count; i++) {
+		// filters are normalized, the attribute is on the left hand side
+		FT_FilterNode *f = filters[i]->filterTree;
+		if(f->t != FT_N_PRED || f->pred.op != OP_EQUAL) continue;
+
+		char *attr_name;
+		if(!AR_EXP_IsAttribute(f->pred.lhs, &attr_name)) continue;
+
+		Attribute_ID attr = GraphContext_GetAttributeID(gc, attr_name);
+		if(Schema_GetConstraint(s, CT_UNIQUE, attr) != NULL) return true;
+	}
+
+	return false;
+}
+
 // try to replace given Label Scan operation and a set of Filter operations with
 // a single Index Scan operation
 void reduce_scan_op
@@ -298,6 +338,7 @@ void reduce_scan_op
 	int         min_label_id;                 // tracks min label ID
 	uint64_t    min_nnz        = UINT64_MAX;  // tracks min entries
 	RSIndex     *rs_idx        = NULL;        // the index to be applied
+	NativeIndex *native_idx    = NULL;        // native index to be applied
 	OpFilter    **filters      = NULL;        // tracks indexed filters to apply
 	uint        filters_count  = 0;           // number of matching filters
 	const char  *min_label_str = NULL;        // tracks min label name
@@ -307,6 +348,19 @@ void reduce_scan_op
 	QGNode *qn = QueryGraph_GetNodeByAlias(qg, node_alias);
 	ASSERT(qn != NULL);
 
+	// honour planner hints
+	// USING SCAN keeps the label scan
+	// USING INDEX restricts the choice to the hinted label's index
+	PlanHint hint;
+	AST *ast = QueryCtx_GetAST();
+	if(AST_GetHint(ast, HINT_SCAN, node_alias, NULL)) return;
+	bool hinted = AST_GetHint(ast, HINT_INDEX, node_alias, &hint);
+	Attribute_ID hinted_attr = ATTRIBUTE_NOTFOUND;
+	if(hinted) {
+		hinted_attr = GraphContext_GetAttributeID(gc, hint.attribute);
+		if(hinted_attr == ATTRIBUTE_NOTFOUND) return;
+	}
+
 	uint label_count = QGNode_LabelCount(qn);
 	for(uint i = 0; i < label_count; i++) {
 		Index *idx;
@@ -319,8 +373,14 @@ void reduce_scan_op
 
 		idx = GraphContext_GetIndexByID(gc, label_id, NULL, IDX_EXACT_MATCH, SCHEMA_NODE);
 
-		// no index for current label
-		if(idx == NULL) continue;
+		// no index for current label, or index still under construction
+		if(idx == NULL || !Index_Enabled(idx)) continue;
+
+		// label or attribute differ from the hinted index
+		if(hinted && (strcmp(label, hint.label) != 0 ||
+					  !Index_ContainsAttribute(idx, hinted_attr))) {
+			continue;
+		}
 
 		// get all applicable filter for index
 		RSIndex *cur_idx = idx->idx;
@@ -340,6 +400,7 @@ void reduce_scan_op
 		nnz = Graph_LabeledNodeCount(g, label_id);
 		if(min_nnz > nnz) {
 			rs_idx         =  cur_idx;
+			native_idx     =  idx->native;
 			min_nnz        =  nnz;
 			min_label_str  =  label;
 			min_label_id   =  label_id;
@@ -388,7 +449,10 @@ void reduce_scan_op
 
 	FT_FilterNode *root = _Concat_Filters(filters);
 	OpBase *indexOp = NewIndexScanOp(scan->op.plan, scan->g, scan->n, rs_idx,
-			root);
+			native_idx, root);
+	if(_uniqueLookup(min_label_id, filters)) {
+		IndexScanOp_SetUnique((IndexScan *)indexOp);
+	}
 
 	// replace the redundant scan op with the newly-constructed Index Scan
 	ExecutionPlan_ReplaceOp(plan, (OpBase *)scan, indexOp);
@@ -421,7 +485,7 @@ void reduce_cond_op(ExecutionPlan *plan, OpCondTraverse *cond) {
 	const char *label = QGEdge_Relation(e, 0);
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	Index *idx = GraphContext_GetIndex(gc, label, NULL, IDX_EXACT_MATCH, SCHEMA_EDGE);
-	if(idx == NULL) return;
+	if(idx == NULL || !Index_Enabled(idx)) return;
 
 	// get all applicable filter for index
 	RSIndex *rs_idx = idx->idx;
@@ -0,0 +1,358 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "plan_stats.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../configuration/config.h"
+#include <pthread.h>
+#include <inttypes.h>
+
+// minimum number of records a checkpoint must observe before
+// its growth can trigger re-planning, small inputs are cheap regardless
+#define REPLAN_MIN_RECORDS 1000
+
+// statistics of a single operation, operations are kept in plan order
+typedef struct {
+	sds desc;            // operation string representation
+	OPType type;         // operation type
+	uint ident;          // operation depth within the plan, in spaces
+	double expected;     // records expected per execution, set by first sample
+	uint64_t records;    // records produced over all samples
+	double exec_time;    // execution time over all samples, in ms
+	int64_t allocated;   // bytes allocated over all samples
+	int64_t peak;        // peak bytes retained over all samples
+	uint64_t record_allocs;  // records allocated over all samples
+} PlanStatsOp;
+
+struct PlanStats {
+	uint refcount;          // number of execution contexts sharing stats
+	uint64_t executions;    // number of executions
+	uint64_t samples;       // number of sampled executions
+	PlanStatsOp *ops;       // per operation statistics, built on first sample
+	double correction;      // observed over estimated records, last sample
+	bool stale;             // a checkpoint outgrew its expectation
+	pthread_mutex_t lock;   // guards samples and ops
+};
+
+PlanStats *PlanStats_New(void) {
+	PlanStats *stats = rm_malloc(sizeof(PlanStats));
+
+	stats->ops        = NULL;
+	stats->stale      = false;
+	stats->samples    = 0;
+	stats->correction = 1;
+	stats->refcount   = 1;
+	stats->executions = 0;
+
+	int res = pthread_mutex_init(&stats->lock, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return stats;
+}
+
+PlanStats *PlanStats_Retain
+(
+	PlanStats *stats
+) {
+	ASSERT(stats != NULL);
+	__atomic_fetch_add(&stats->refcount, 1, __ATOMIC_RELAXED);
+	return stats;
+}
+
+bool PlanStats_ShouldSample
+(
+	PlanStats *stats
+) {
+	if(stats == NULL) return false;
+
+	uint64_t rate;
+	Config_Option_get(Config_PLAN_STATS_SAMPLE_RATE, &rate);
+
+	uint64_t n = __atomic_fetch_add(&stats->executions, 1, __ATOMIC_RELAXED);
+
+	// sampling is disabled
+	if(rate == 0) return false;
+
+	return (n % rate) == 0;
+}
+
+uint64_t PlanStats_Executions
+(
+	PlanStats *stats
+) {
+	ASSERT(stats != NULL);
+	return __atomic_load_n(&stats->executions, __ATOMIC_RELAXED);
+}
+
+static void _CollectOps
+(
+	const OpBase *op,
+	uint ident,
+	PlanStatsOp **ops
+) {
+	PlanStatsOp s = {.desc = sdsempty(), .type = op->type, .ident = ident};
+	if(op->toString) op->toString(op, &s.desc);
+	else s.desc = sdscat(s.desc, op->name);
+	array_append(*ops, s);
+
+	for(int i = 0; i < op->childCount; i++) {
+		_CollectOps(op->children[i], ident + 4, ops);
+	}
+}
+
+// checkpoints are operations whose output size drives the cost of the
+// remaining plan, scans feeding it and pipeline breakers materializing it
+static bool _Checkpoint
+(
+	OPType t
+) {
+	switch(t) {
+		case OPType_ALL_NODE_SCAN:
+		case OPType_NODE_BY_LABEL_SCAN:
+		case OPType_NODE_BY_INDEX_SCAN:
+		case OPType_EDGE_BY_INDEX_SCAN:
+		case OPType_SORT:
+		case OPType_AGGREGATE:
+		case OPType_VALUE_HASH_JOIN:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// sets the records expected of each operation from the first sample
+// the larger of the planner's estimate and the observed count
+// such that a misestimate the plan was already executed with
+// doesn't trigger re-planning on its own
+static void _SetExpectations
+(
+	const OpBase *op,
+	PlanStatsOp *ops,
+	uint *idx
+) {
+	PlanStatsOp *s = ops + (*idx)++;
+	double observed = op->stats->profileRecordCount;
+	double estimated = op->stats->profileEstimatedRecords;
+	s->expected = (estimated > observed) ? estimated : observed;
+
+	for(int i = 0; i < op->childCount; i++) {
+		_SetExpectations(op->children[i], ops, idx);
+	}
+}
+
+// checks if a checkpoint produced 'factor' times the records expected of it
+static bool _OutgrownExpectations
+(
+	const OpBase *op,
+	const PlanStatsOp *ops,
+	uint *idx,
+	uint64_t factor
+) {
+	const PlanStatsOp *s = ops + (*idx)++;
+	double observed = op->stats->profileRecordCount;
+	double expected = (s->expected > 1) ? s->expected : 1;
+	if(_Checkpoint(s->type) && observed >= REPLAN_MIN_RECORDS &&
+	   observed > expected * factor) {
+		return true;
+	}
+
+	for(int i = 0; i < op->childCount; i++) {
+		if(_OutgrownExpectations(op->children[i], ops, idx, factor)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// sums the observed and estimated records of all operations
+static void _SumRecords
+(
+	const OpBase *op,
+	double *observed,
+	double *estimated
+) {
+	*observed += op->stats->profileRecordCount;
+	if(op->stats->profileEstimatedRecords > 0) {
+		*estimated += op->stats->profileEstimatedRecords;
+	}
+
+	for(int i = 0; i < op->childCount; i++) {
+		_SumRecords(op->children[i], observed, estimated);
+	}
+}
+
+static void _RecordOps
+(
+	const OpBase *op,
+	PlanStatsOp *ops,
+	uint *idx
+) {
+	ASSERT(op->stats != NULL);
+
+	PlanStatsOp *s = ops + (*idx)++;
+	s->records       += op->stats->profileRecordCount;
+	s->exec_time     += op->stats->profileExecTime;
+	s->allocated     += op->stats->profileBytesAllocated;
+	s->record_allocs += op->stats->profileRecordAllocs;
+	if(op->stats->profilePeakMemory > s->peak) {
+		s->peak = op->stats->profilePeakMemory;
+	}
+
+	for(int i = 0; i < op->childCount; i++) {
+		_RecordOps(op->children[i], ops, idx);
+	}
+}
+
+static uint _CountOps
+(
+	const OpBase *op
+) {
+	uint n = 1;
+	for(int i = 0; i < op->childCount; i++) n += _CountOps(op->children[i]);
+	return n;
+}
+
+void PlanStats_Record
+(
+	PlanStats *stats,
+	const OpBase *root
+) {
+	ASSERT(stats != NULL);
+	ASSERT(root  != NULL);
+
+	pthread_mutex_lock(&stats->lock);
+
+	if(stats->ops == NULL) {
+		stats->ops = array_new(PlanStatsOp, 1);
+		_CollectOps(root, 0, &stats->ops);
+	}
+
+	// copies of a cached plan share its structure
+	if(_CountOps(root) == array_len(stats->ops)) {
+		uint idx = 0;
+		if(stats->samples == 0) _SetExpectations(root, stats->ops, &idx);
+
+		idx = 0;
+		_RecordOps(root, stats->ops, &idx);
+		stats->samples++;
+
+		// feed the observed records back into the plan's cost estimate
+		double observed = 0;
+		double estimated = 0;
+		_SumRecords(root, &observed, &estimated);
+		if(estimated > 0) stats->correction = observed / estimated;
+
+		// the data outgrew the statistics the plan was built with
+		uint64_t factor;
+		Config_Option_get(Config_REPLAN_FACTOR, &factor);
+		idx = 0;
+		if(factor != REPLAN_DISABLED &&
+		   _OutgrownExpectations(root, stats->ops, &idx, factor)) {
+			__atomic_store_n(&stats->stale, true, __ATOMIC_RELAXED);
+		}
+	}
+
+	pthread_mutex_unlock(&stats->lock);
+}
+
+bool PlanStats_ShouldReplan
+(
+	PlanStats *stats
+) {
+	if(stats == NULL) return false;
+
+	// copies of the plan still executing must not evict its replacement
+	return __atomic_exchange_n(&stats->stale, false, __ATOMIC_RELAXED);
+}
+
+bool PlanStats_ShouldCompile
+(
+	PlanStats *stats
+) {
+	if(stats == NULL) return false;
+
+	uint64_t threshold;
+	Config_Option_get(Config_COMPILE_THRESHOLD, &threshold);
+	if(threshold == COMPILE_DISABLED) return false;
+
+	return PlanStats_Executions(stats) >= threshold;
+}
+
+double PlanStats_CostCorrection
+(
+	PlanStats *stats
+) {
+	if(stats == NULL) return 1;
+
+	pthread_mutex_lock(&stats->lock);
+	double correction = stats->correction;
+	pthread_mutex_unlock(&stats->lock);
+
+	return correction;
+}
+
+void PlanStats_Reply
+(
+	PlanStats *stats,
+	RedisModuleCtx *ctx,
+	const char *query
+) {
+	ASSERT(ctx   != NULL);
+	ASSERT(stats != NULL);
+	ASSERT(query != NULL);
+
+	pthread_mutex_lock(&stats->lock);
+
+	uint64_t samples = stats->samples;
+	uint op_count = (stats->ops != NULL) ? array_len(stats->ops) : 0;
+	uint64_t executions = __atomic_load_n(&stats->executions, __ATOMIC_RELAXED);
+
+	RedisModule_ReplyWithArray(ctx, 4);
+	RedisModule_ReplyWithStringBuffer(ctx, query, strlen(query));
+	RedisModule_ReplyWithLongLong(ctx, executions);
+	RedisModule_ReplyWithLongLong(ctx, samples);
+
+	// operations, averaged over samples
+	sds buffer = sdsempty();
+	RedisModule_ReplyWithArray(ctx, (samples > 0) ? op_count : 0);
+	for(uint i = 0; samples > 0 && i < op_count; i++) {
+		PlanStatsOp *s = stats->ops + i;
+		sdsclear(buffer);
+		buffer = sdscatprintf(buffer,
+				"%*s%s | Records produced: %.2f, Execution time: %f ms"
+				", Memory allocated: %.2f bytes, Peak memory: %" PRId64 " bytes"
+				", Records allocated: %.2f",
+				s->ident, "", s->desc, (double)s->records / samples,
+				s->exec_time / samples, (double)s->allocated / samples,
+				s->peak, (double)s->record_allocs / samples);
+		RedisModule_ReplyWithStringBuffer(ctx, buffer, sdslen(buffer));
+	}
+	sdsfree(buffer);
+
+	pthread_mutex_unlock(&stats->lock);
+}
+
+void PlanStats_Release
+(
+	PlanStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	if(__atomic_sub_fetch(&stats->refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	if(stats->ops != NULL) {
+		uint n = array_len(stats->ops);
+		for(uint i = 0; i < n; i++) sdsfree(stats->ops[i].desc);
+		array_free(stats->ops);
+	}
+
+	pthread_mutex_destroy(&stats->lock);
+	rm_free(stats);
+}
@@ -0,0 +1,91 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "ops/op.h"
+#include "../redismodule.h"
+
+// per operation statistics aggregated over sampled executions of a plan
+// one in every PLAN_STATS_SAMPLE_RATE executions of a cached plan is profiled
+// while still replying to the client as usual
+//
+// sampled executions double as checkpoints, comparing the records produced
+// by scans and pipeline breakers to those expected when the plan was built
+//
+// statistics are shared by a cached plan and all of its copies
+// and are reference counted, such that copies handed out before an eviction
+// can still report their execution
+typedef struct PlanStats PlanStats;
+
+// create plan statistics
+PlanStats *PlanStats_New(void);
+
+// returns an additional reference to 'stats'
+PlanStats *PlanStats_Retain
+(
+	PlanStats *stats
+);
+
+// counts an execution of the plan
+// returns true if the execution should be sampled
+bool PlanStats_ShouldSample
+(
+	PlanStats *stats
+);
+
+// returns the number of executions of the plan
+uint64_t PlanStats_Executions
+(
+	PlanStats *stats
+);
+
+// accumulates the profiling statistics of the plan rooted at 'root'
+// 'root' must have been executed by ExecutionPlan_Profile
+void PlanStats_Record
+(
+	PlanStats *stats,
+	const OpBase *root
+);
+
+// returns true if a sampled execution observed a checkpoint operation
+// e.g. a scan or a sort, producing REPLAN_FACTOR times the records
+// expected of it when the plan was first executed
+// the plan no longer fits the data and should be rebuilt
+// a detection is reported once
+bool PlanStats_ShouldReplan
+(
+	PlanStats *stats
+);
+
+// returns true once the plan was executed COMPILE_THRESHOLD times
+// hot plans have their expressions compiled, see ExecutionPlan_Compile
+bool PlanStats_ShouldCompile
+(
+	PlanStats *stats
+);
+
+// returns the ratio of records observed by the last sampled execution
+// to the records estimated for it, 1 if the plan wasn't sampled yet
+// scaling the plan's estimated cost by it accounts for misestimates
+double PlanStats_CostCorrection
+(
+	PlanStats *stats
+);
+
+// replies with the statistics collected for 'query'
+void PlanStats_Reply
+(
+	PlanStats *stats,
+	RedisModuleCtx *ctx,
+	const char *query
+);
+
+// releases a reference to 'stats', freeing it once unreferenced
+void PlanStats_Release
+(
+	PlanStats *stats
+);
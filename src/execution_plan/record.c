@@ -6,6 +6,7 @@
 
 #include "RG.h"
 #include "./record.h"
+#include "../query_ctx.h"
 #include "../util/rmalloc.h"
 
 /* Migrate the entry at the given index in the source Record at the same index in the destination.
@@ -17,7 +18,9 @@ static void _RecordPropagateEntry(Record dest, Record src, uint idx) {
 	if(e.type == REC_TYPE_SCALAR) SIValue_MakeVolatile(&src->entries[idx].value.s);
 }
 
-// This function is currently unused.
+// Records produced by operations are borrowed from their execution plan's
+// record pool, see ExecutionPlan_BorrowRecord. Record_New is reserved for
+// records which live outside of the plan, e.g. list comprehension contexts.
 Record Record_New(rax *mapping) {
 	ASSERT(mapping);
 	// Determine record size.
@@ -201,6 +204,34 @@ void Record_PersistScalars(Record r) {
 	}
 }
 
+// invokes 'f' on every lazily materialised node of the batch
+static inline void _ForEachLazyNode
+(
+	Record *batch,
+	uint n,
+	Graph *g,
+	void (*f)(const Graph *, NodeID)
+) {
+	for(uint i = 0; i < n; i++) {
+		Record r = batch[i];
+		uint len = Record_length(r);
+		for(uint j = 0; j < len; j++) {
+			if(r->entries[j].type != REC_TYPE_NODE) continue;
+			Node *node = &r->entries[j].value.n;
+			if(node->entity == NULL && ENTITY_GET_ID(node) != INVALID_ENTITY_ID) {
+				f(g, ENTITY_GET_ID(node));
+			}
+		}
+	}
+}
+
+void Record_PrefetchNodes(Record *batch, uint n) {
+	Graph *g = QueryCtx_GetGraph();
+	_ForEachLazyNode(batch, n, g, Graph_PrefetchNode);
+	// the batch's first nodes have been loaded by now
+	_ForEachLazyNode(batch, n, g, Graph_PrefetchNodeProperties);
+}
+
 size_t Record_ToString(const Record r, char **buf, size_t *buf_cap) {
 	uint rLen = Record_length(r);
 	SIValue values[rLen];
@@ -242,7 +273,7 @@ void Record_FreeEntries(Record r) {
 	}
 }
 
-// This function is currently unused.
+// Counterpart of Record_New, pooled records are returned via OpBase_DeleteRecord.
 void Record_Free(Record r) {
 	Record_FreeEntries(r);
 	rm_free(r);
@@ -94,6 +94,11 @@ Edge *Record_AddEdge(Record r, uint idx, Edge edge);
 // Ensure that all scalar values in record are access-safe.
 void Record_PersistScalars(Record r);
 
+// hints the CPU to load the lazily materialised nodes of a batch of records
+// and their properties, such that accessing them doesn't stall on each node
+// nodes are loaded first and their properties once all nodes were requested
+void Record_PrefetchNodes(Record *batch, uint n);
+
 // String representation of record.
 size_t Record_ToString(const Record r, char **buf, size_t *buf_cap);
 
@@ -210,6 +210,29 @@ int _applyPredicateFilters(const FT_FilterNode *root, const Record r) {
 	return ret;
 }
 
+/* Evaluates a boolean expression against a single result. */
+int _applyExpressionFilter(AR_ExpNode *exp, const Record r) {
+	int retval = FILTER_PASS;
+	SIValue res = AR_EXP_Evaluate(exp, r);
+	if(SIValue_IsNull(res)) {
+		/* Expression evaluated to NULL should return false. */
+		retval = FILTER_FAIL;
+	} else if(SI_TYPE(res) & T_BOOL) {
+		/* Return false if this boolean value is false. */
+		if(res.longval == 0) retval = FILTER_FAIL;
+	} else if(SI_TYPE(res) & T_ARRAY) {
+		/* An empty array is falsey, all other arrays should return true. */
+		if(SIArray_Length(res) == 0) retval = FILTER_FAIL;
+	} else {
+		// If the expression node evaluated to an unexpected type (numeric, string, node, edge), emit an error.
+		Error_SITypeMismatch(res, T_BOOL);
+		retval = FILTER_FAIL;
+	}
+
+	SIValue_Free(res); // If res was a heap allocation, free it.
+	return retval;
+}
+
 int FilterTree_applyFilters(const FT_FilterNode *root, const Record r) {
 	switch(root->t) {
 		case FT_N_COND: {
@@ -244,25 +267,7 @@ int FilterTree_applyFilters(const FT_FilterNode *root, const Record r) {
 			return _applyPredicateFilters(root, r);
 		}
 		case FT_N_EXP: {
-			int retval = FILTER_PASS;
-			SIValue res = AR_EXP_Evaluate(root->exp.exp, r);
-			if(SIValue_IsNull(res)) {
-				/* Expression evaluated to NULL should return false. */
-				retval = FILTER_FAIL;
-			} else if(SI_TYPE(res) & T_BOOL) {
-				/* Return false if this boolean value is false. */
-				if(res.longval == 0) retval = FILTER_FAIL;
-			} else if(SI_TYPE(res) & T_ARRAY) {
-				/* An empty array is falsey, all other arrays should return true. */
-				if(SIArray_Length(res) == 0) retval = FILTER_FAIL;
-			} else {
-				// If the expression node evaluated to an unexpected type (numeric, string, node, edge), emit an error.
-				Error_SITypeMismatch(res, T_BOOL);
-				retval = FILTER_FAIL;
-			}
-
-			SIValue_Free(res); // If res was a heap allocation, free it.
-			return retval;
+			return _applyExpressionFilter(root->exp.exp, r);
 		}
 		default:
 			ASSERT(false);
@@ -418,6 +423,38 @@ bool FilterTree_ContainsFunc(const FT_FilterNode *root, const char *func, FT_Fil
 	return _FilterTree_ContainsFunc(root, func, node);
 }
 
+static bool _AR_EXP_Deterministic(const AR_ExpNode *exp) {
+	if(exp->type == AR_EXP_OPERAND) return true;
+
+	AR_FuncDesc *f = exp->op.f;
+	if(!f->deterministic || f->aggregate) return false;
+
+	for(int i = 0; i < exp->op.child_count; i++) {
+		if(!_AR_EXP_Deterministic(exp->op.children[i])) return false;
+	}
+
+	return true;
+}
+
+bool FilterTree_Deterministic(const FT_FilterNode *root) {
+	ASSERT(root != NULL);
+
+	switch(root->t) {
+		case FT_N_EXP:
+			return _AR_EXP_Deterministic(root->exp.exp);
+		case FT_N_PRED:
+			return _AR_EXP_Deterministic(root->pred.lhs) &&
+				   _AR_EXP_Deterministic(root->pred.rhs);
+		case FT_N_COND:
+			return FilterTree_Deterministic(root->cond.left) &&
+				   (root->cond.right == NULL ||
+					FilterTree_Deterministic(root->cond.right));
+		default:
+			ASSERT(false && "unknown filter tree node type");
+			return false;
+	}
+}
+
 void _FilterTree_ApplyNegate(FT_FilterNode **root, uint negate_count) {
 	switch((*root)->t) {
 		case FT_N_EXP:
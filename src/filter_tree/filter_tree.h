@@ -105,6 +105,10 @@ bool FilterTree_containsOp(const FT_FilterNode *root, AST_Operator op);
  * node - point to tree node in which func was located, null if func isn't located. */
 bool FilterTree_ContainsFunc(const FT_FilterNode *root, const char *func, FT_FilterNode **node);
 
+/* Checks to see if tree evaluates to the same result given the same record,
+ * i.e. it doesn't call non-deterministic or aggregation functions. */
+bool FilterTree_Deterministic(const FT_FilterNode *root);
+
 /* Prints tree. */
 void FilterTree_Print(const FT_FilterNode *root);
 
@@ -6,6 +6,8 @@
 
 #include "filter_tree_utils.h"
 #include "RG.h"
+#include "../util/rmalloc.h"
+#include "../arithmetic/string_funcs/string_funcs.h"
 
 bool isInFilter(const FT_FilterNode *filter) {
 	return (filter->t == FT_N_EXP &&
@@ -98,3 +100,48 @@ bool isDistanceFilter(FT_FilterNode *filter) {
 	return res;
 }
 
+
+bool extractPrefix(const FT_FilterNode *filter, char **attr, char **prefix,
+		bool *exact) {
+	ASSERT(filter != NULL);
+	ASSERT(prefix != NULL);
+
+	if(filter->t != FT_N_EXP) return false;
+
+	AR_ExpNode *exp = filter->exp.exp;
+	if(!AR_EXP_IsOperation(exp)) return false;
+
+	const char *func = AR_EXP_GetFuncName(exp);
+	bool starts_with = strcasecmp(func, "starts with") == 0;
+	if(!starts_with && strcmp(func, "=~") != 0) return false;
+
+	char *a = NULL;
+	if(!AR_EXP_IsAttribute(exp->op.children[0], &a)) return false;
+
+	// prefix or pattern must be a constant string
+	SIValue v = SI_NullVal();
+	if(!AR_EXP_ReduceToScalar(exp->op.children[1], true, &v)) return false;
+	if(SI_TYPE(v) != T_STRING) return false;
+
+	char *p = NULL;
+	if(starts_with) {
+		if(v.stringval[0] != '\0') p = rm_strdup(v.stringval);
+	} else {
+		p = StringRegex_LiteralPrefix(v.stringval);
+	}
+	if(p == NULL) return false;
+
+	if(attr) *attr = a;
+	if(exact) *exact = starts_with;
+	*prefix = p;
+	return true;
+}
+
+// return true if filter matches strings by a literal prefix
+// n.v STARTS WITH 'abc'
+bool isPrefixFilter(const FT_FilterNode *filter) {
+	char *prefix = NULL;
+	bool res = extractPrefix(filter, NULL, &prefix, NULL);
+	if(res) rm_free(prefix);
+	return res;
+}
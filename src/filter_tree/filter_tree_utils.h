@@ -15,3 +15,12 @@ bool extractOriginAndRadius(const FT_FilterNode *filter, SIValue *origin,
 
 bool isDistanceFilter(FT_FilterNode *filter);
 
+// extracts the attribute and literal prefix of a prefix filter
+// n.v STARTS WITH 'abc' or n.v =~ 'abc.*'
+// 'exact' is set when every string starting with the prefix passes the filter
+// the caller is responsible for freeing 'prefix'
+bool extractPrefix(const FT_FilterNode *filter, char **attr, char **prefix,
+		bool *exact);
+
+bool isPrefixFilter(const FT_FilterNode *filter);
+
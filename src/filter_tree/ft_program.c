@@ -0,0 +1,235 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "ft_program.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../arithmetic/arithmetic_expression_compile.h"
+
+// tree walker routines shared with filter_tree.c
+int _applyFilter(SIValue *aVal, SIValue *bVal, AST_Operator op);
+int _applyExpressionFilter(AR_ExpNode *exp, const Record r);
+
+typedef enum {
+	FT_INS_PRED,       // acc = lhs op rhs
+	FT_INS_EXP,        // acc = truthiness of expression
+	FT_INS_JMP_FALSE,  // jump to target if acc is FILTER_FAIL
+	FT_INS_JMP_TRUE,   // jump to target if acc is FILTER_PASS
+	FT_INS_STORE,      // regs[reg] = acc
+	FT_INS_XOR,        // acc = regs[reg] != acc
+	FT_INS_XNOR,       // acc = regs[reg] == acc
+	FT_INS_NOT,        // acc = !acc
+} FT_InstructionType;
+
+typedef struct {
+	FT_InstructionType t;
+	union {
+		struct {
+			AR_CompiledExp lhs;
+			AR_CompiledExp rhs;
+			AST_Operator op;
+		} pred;             // FT_INS_PRED
+		AR_ExpNode *exp;    // FT_INS_EXP
+		uint target;        // FT_INS_JMP_FALSE, FT_INS_JMP_TRUE
+		uint reg;           // FT_INS_STORE, FT_INS_XOR, FT_INS_XNOR
+	};
+} FT_Instruction;
+
+struct FT_Program {
+	FT_Instruction *code;  // instructions
+	int *regs;             // registers holding pending XOR/XNOR operands
+	uint reg_count;        // number of registers
+};
+
+// compiles 'node' such that once executed the accumulator holds its result
+static void _Compile
+(
+	FT_Program *program,
+	const FT_FilterNode *node,
+	uint depth  // number of registers in use
+) {
+	FT_Instruction ins;
+
+	switch(node->t) {
+		case FT_N_PRED:
+			ins.t = FT_INS_PRED;
+			ins.pred.op  = node->pred.op;
+			ins.pred.lhs = AR_EXP_Compile(node->pred.lhs);
+			ins.pred.rhs = AR_EXP_Compile(node->pred.rhs);
+			array_append(program->code, ins);
+			return;
+
+		case FT_N_EXP:
+			ins.t = FT_INS_EXP;
+			ins.exp = node->exp.exp;
+			array_append(program->code, ins);
+			return;
+
+		case FT_N_COND:
+			break;
+
+		default:
+			ASSERT(false);
+			return;
+	}
+
+	AST_Operator op = node->cond.op;
+	_Compile(program, node->cond.left, depth);
+
+	if(op == OP_NOT) {
+		ins.t = FT_INS_NOT;
+		array_append(program->code, ins);
+		return;
+	}
+
+	if(op == OP_AND || op == OP_OR) {
+		// jump over the right-hand side once the result is known
+		uint jmp = array_len(program->code);
+		ins.t = (op == OP_AND) ? FT_INS_JMP_FALSE : FT_INS_JMP_TRUE;
+		array_append(program->code, ins);
+
+		_Compile(program, node->cond.right, depth);
+		program->code[jmp].target = array_len(program->code);
+		return;
+	}
+
+	ASSERT(op == OP_XOR || op == OP_XNOR);
+
+	// stash left-hand side result while evaluating the right-hand side
+	ins.t = FT_INS_STORE;
+	ins.reg = depth;
+	array_append(program->code, ins);
+	if(depth + 1 > program->reg_count) program->reg_count = depth + 1;
+
+	_Compile(program, node->cond.right, depth + 1);
+
+	ins.t = (op == OP_XOR) ? FT_INS_XOR : FT_INS_XNOR;
+	ins.reg = depth;
+	array_append(program->code, ins);
+}
+
+FT_Program *FilterTree_Compile
+(
+	const FT_FilterNode *root
+) {
+	ASSERT(root != NULL);
+
+	FT_Program *program = rm_malloc(sizeof(FT_Program));
+	program->code      = array_new(FT_Instruction, 8);
+	program->regs      = NULL;
+	program->reg_count = 0;
+
+	_Compile(program, root, 0);
+
+	if(program->reg_count > 0) {
+		program->regs = rm_malloc(sizeof(int) * program->reg_count);
+	}
+
+	return program;
+}
+
+// compare two values, specialised for the common integer and
+// string equality cases, defers to the generic comparison otherwise
+static inline int _Compare
+(
+	SIValue *lhs,
+	SIValue *rhs,
+	AST_Operator op
+) {
+	SIType lt = SI_TYPE(*lhs);
+	SIType rt = SI_TYPE(*rhs);
+
+	if(lt == T_INT64 && rt == T_INT64) {
+		int64_t a = lhs->longval;
+		int64_t b = rhs->longval;
+		switch(op) {
+			case OP_EQUAL:  return a == b;
+			case OP_NEQUAL: return a != b;
+			case OP_GT:     return a >  b;
+			case OP_GE:     return a >= b;
+			case OP_LT:     return a <  b;
+			case OP_LE:     return a <= b;
+			default:        break;
+		}
+	} else if(lt == T_STRING && rt == T_STRING &&
+			  (op == OP_EQUAL || op == OP_NEQUAL)) {
+		const char *a = lhs->stringval;
+		const char *b = rhs->stringval;
+		// interned strings compare by address
+		bool eq = (a == b || (a[0] == b[0] && strcmp(a, b) == 0));
+		return (op == OP_EQUAL) ? eq : !eq;
+	}
+
+	return _applyFilter(lhs, rhs, op);
+}
+
+int FT_Program_Apply
+(
+	FT_Program *program,
+	const Record r
+) {
+	ASSERT(program != NULL);
+
+	int acc = FILTER_PASS;
+	int *regs = program->regs;
+	FT_Instruction *code = program->code;
+	uint len = array_len(code);
+
+	for(uint pc = 0; pc < len; pc++) {
+		FT_Instruction *ins = code + pc;
+		switch(ins->t) {
+			case FT_INS_PRED: {
+				SIValue lhs = AR_CompiledExp_Evaluate(&ins->pred.lhs, r);
+				SIValue rhs = AR_CompiledExp_Evaluate(&ins->pred.rhs, r);
+				acc = _Compare(&lhs, &rhs, ins->pred.op) ? FILTER_PASS
+					: FILTER_FAIL;
+				SIValue_Free(lhs);
+				SIValue_Free(rhs);
+				break;
+			}
+			case FT_INS_EXP:
+				acc = _applyExpressionFilter(ins->exp, r);
+				break;
+			case FT_INS_JMP_FALSE:
+				// target is the first instruction to execute, account for pc++
+				if(acc == FILTER_FAIL) pc = ins->target - 1;
+				break;
+			case FT_INS_JMP_TRUE:
+				if(acc == FILTER_PASS) pc = ins->target - 1;
+				break;
+			case FT_INS_STORE:
+				regs[ins->reg] = acc;
+				break;
+			case FT_INS_XOR:
+				acc = (regs[ins->reg] != acc) ? FILTER_PASS : FILTER_FAIL;
+				break;
+			case FT_INS_XNOR:
+				acc = (regs[ins->reg] == acc) ? FILTER_PASS : FILTER_FAIL;
+				break;
+			case FT_INS_NOT:
+				acc = (acc == FILTER_PASS) ? FILTER_FAIL : FILTER_PASS;
+				break;
+			default:
+				ASSERT(false);
+				break;
+		}
+	}
+
+	return acc;
+}
+
+void FT_Program_Free
+(
+	FT_Program *program
+) {
+	ASSERT(program != NULL);
+
+	array_free(program->code);
+	if(program->regs != NULL) rm_free(program->regs);
+	rm_free(program);
+}
+
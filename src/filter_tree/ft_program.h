@@ -0,0 +1,47 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "filter_tree.h"
+
+// FT_Program is a filter tree compiled into a flat sequence of instructions
+// evaluated by a simple loop instead of a recursive walk of the tree
+//
+// every instruction updates a single accumulator holding the result of the
+// last evaluated sub-filter, AND and OR short-circuit by jumping over the
+// instructions of their right-hand side, XOR and XNOR stash their
+// left-hand side result in a register
+//
+// predicate operands are specialised at compile time:
+// constants are read directly out of the expression tree, variables are
+// read directly out of the record and attribute accesses of the form 'n.v'
+// read the entity's attribute without evaluating an arithmetic expression
+//
+// the program references the expressions of the tree it was compiled from
+// and is only valid for as long as the tree is
+typedef struct FT_Program FT_Program;
+
+// compile filter tree into a program
+FT_Program *FilterTree_Compile
+(
+	const FT_FilterNode *root  // filter tree to compile
+);
+
+// applies program to a single record
+// returns FILTER_PASS if the record passes the filter, FILTER_FAIL otherwise
+int FT_Program_Apply
+(
+	FT_Program *program,  // program to apply
+	const Record r        // record to filter
+);
+
+// free program
+void FT_Program_Free
+(
+	FT_Program *program  // program to free
+);
+
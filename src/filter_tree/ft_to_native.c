@@ -0,0 +1,339 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "ft_to_native.h"
+#include "RG.h"
+#include "../query_ctx.h"
+#include "../graph/graphcontext.h"
+
+// maximum number of predicates considered
+// a range is bounded by two predicates, allow for some redundancy
+#define MAX_PREDICATES 16
+
+// range over a single attribute, built out of the filter's predicates
+typedef struct {
+	const char *field;           // attribute name
+	Attribute_ID attr;           // attribute ID
+	SIType t;                    // SI_NUMERIC or T_STRING
+	NumericRange *num_range;     // range over numeric values
+	StringRange *str_range;      // range over string values
+	const FT_FilterNode **preds; // predicates forming the range
+	uint pred_count;             // number of predicates
+} AttributeRange;
+
+// collects the predicates of a conjunction
+// returns false if 'tree' isn't a conjunction of predicates
+static bool _CollectPredicates
+(
+	const FT_FilterNode *tree,
+	const FT_FilterNode **preds,
+	uint *count,
+	uint cap
+) {
+	if(tree->t == FT_N_COND) {
+		if(tree->cond.op != OP_AND) return false;
+		return _CollectPredicates(tree->cond.left, preds, count, cap) &&
+			   _CollectPredicates(tree->cond.right, preds, count, cap);
+	}
+
+	if(tree->t != FT_N_PRED || *count == cap) return false;
+
+	preds[(*count)++] = tree;
+	return true;
+}
+
+// returns true if 'pred' is of form: 'n.v op constant'
+// where the native index supports both op and constant
+static bool _SupportedPredicate
+(
+	const FT_FilterNode *pred,
+	char **prop
+) {
+	if(!AR_EXP_IsAttribute(pred->pred.lhs, prop)) return false;
+	if(!AR_EXP_IsConstant(pred->pred.rhs)) return false;
+
+	AST_Operator op = pred->pred.op;
+	if(op != OP_LT && op != OP_LE && op != OP_GT && op != OP_GE &&
+	   op != OP_EQUAL) {
+		return false;
+	}
+
+	return NativeIndex_SupportedValue(pred->pred.rhs->operand.constant);
+}
+
+// tighten the ranges of 'r' by each of its predicates
+static void _BuildRange
+(
+	AttributeRange *r
+) {
+	if(r->t == SI_NUMERIC) {
+		r->num_range = NumericRange_New();
+		for(uint i = 0; i < r->pred_count; i++) {
+			SIValue c = r->preds[i]->pred.rhs->operand.constant;
+			NumericRange_TightenRange(r->num_range, r->preds[i]->pred.op,
+					SI_GET_NUMERIC(c));
+		}
+	} else {
+		r->str_range = StringRange_New();
+		for(uint i = 0; i < r->pred_count; i++) {
+			SIValue c = r->preds[i]->pred.rhs->operand.constant;
+			StringRange_TightenRange(r->str_range, r->preds[i]->pred.op,
+					c.stringval);
+		}
+	}
+}
+
+// returns true if range 'r' contains a single value, which is set to 'v'
+static bool _PointRange
+(
+	const AttributeRange *r,
+	SIValue *v
+) {
+	if(r->num_range != NULL) {
+		const NumericRange *range = r->num_range;
+		if(!NumericRange_IsValid(range) || range->min != range->max ||
+		   !range->include_min || !range->include_max) {
+			return false;
+		}
+		*v = SI_DoubleVal(range->min);
+		return true;
+	}
+
+	const StringRange *range = r->str_range;
+	if(!StringRange_IsValid(range) || range->min == NULL ||
+	   range->max == NULL || strcmp(range->min, range->max) != 0 ||
+	   !range->include_min || !range->include_max) {
+		return false;
+	}
+	*v = SI_ConstStringVal(range->min);
+	return true;
+}
+
+// single attribute lookup, e.g. n.v > 1 AND n.v <= 10
+static NativeIndexIterator *_SingleAttributeIterator
+(
+	NativeIndex *idx,
+	const AttributeRange *r
+) {
+	if(r->num_range != NULL) {
+		return NativeIndex_NumericRange(idx, r->attr, r->num_range);
+	}
+	return NativeIndex_StringRange(idx, r->attr, r->str_range);
+}
+
+// composite lookup, equality over a prefix of the indexed attributes
+// optionally followed by a range over the next indexed attribute
+// e.g. n.country = 'NL' AND n.city > 'A'
+// ranges which aren't part of the lookup are returned as filters
+static NativeIndexIterator *_CompositeIterator
+(
+	FT_FilterNode **none_converted_filters,
+	NativeIndex *idx,
+	AttributeRange *ranges,
+	uint range_count
+) {
+	uint attr_count = NativeIndex_AttributeCount(idx);
+	if(attr_count < 2) return NULL;
+
+	bool used[range_count];
+	memset(used, 0, sizeof(used));
+
+	uint prefix_len = 0;
+	SIValue prefix[attr_count];
+	const AttributeRange *trailing = NULL;
+
+	for(uint i = 0; i < attr_count && trailing == NULL; i++) {
+		// find range over the i-th indexed attribute
+		uint j = 0;
+		for(; j < range_count; j++) {
+			if(ranges[j].attr == idx->attrs[i]) break;
+		}
+		if(j == range_count) break;
+
+		used[j] = true;
+		if(!_PointRange(ranges + j, prefix + prefix_len)) trailing = ranges + j;
+		else prefix_len++;
+	}
+
+	// lookup must fix the first indexed attribute
+	if(prefix_len == 0 && trailing == NULL) return NULL;
+
+	// predicates of ranges outside of the lookup are applied per entity
+	FT_FilterNode **filters = array_new(FT_FilterNode *, 1);
+	for(uint i = 0; i < range_count; i++) {
+		if(used[i]) continue;
+		for(uint j = 0; j < ranges[i].pred_count; j++) {
+			array_append(filters, FilterTree_Clone(ranges[i].preds[j]));
+		}
+	}
+	*none_converted_filters = FilterTree_Combine(filters, array_len(filters));
+	array_free(filters);
+
+	return NativeIndex_CompositeRange(idx, prefix, prefix_len,
+			trailing ? trailing->num_range : NULL,
+			trailing ? trailing->str_range : NULL);
+}
+
+NativeIndexIterator *FilterTreeToNativeIterator
+(
+	FT_FilterNode **none_converted_filters,
+	const FT_FilterNode *tree,
+	NativeIndex *idx
+) {
+	ASSERT(idx                     != NULL);
+	ASSERT(tree                    != NULL);
+	ASSERT(none_converted_filters  != NULL);
+
+	*none_converted_filters = NULL;
+
+	uint count = 0;
+	const FT_FilterNode *preds[MAX_PREDICATES];
+	if(!_CollectPredicates(tree, preds, &count, MAX_PREDICATES)) return NULL;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	// group predicates by attribute
+	uint range_count = 0;
+	AttributeRange ranges[MAX_PREDICATES];
+	const FT_FilterNode *range_preds[MAX_PREDICATES][MAX_PREDICATES];
+	NativeIndexIterator *iter = NULL;
+
+	for(uint i = 0; i < count; i++) {
+		char *prop = NULL;
+		if(!_SupportedPredicate(preds[i], &prop)) goto cleanup;
+
+		SIValue c = preds[i]->pred.rhs->operand.constant;
+		SIType t = (SI_TYPE(c) & SI_NUMERIC) ? SI_NUMERIC : T_STRING;
+
+		uint j = 0;
+		for(; j < range_count; j++) {
+			if(strcmp(ranges[j].field, prop) == 0) break;
+		}
+
+		if(j == range_count) {
+			Attribute_ID attr = GraphContext_GetAttributeID(gc, prop);
+			if(attr == ATTRIBUTE_NOTFOUND) goto cleanup;
+
+			ranges[j] = (AttributeRange) {
+				.field = prop, .attr = attr, .t = t, .preds = range_preds[j]
+			};
+			range_count++;
+		}
+
+		// predicates over the same attribute must share a type
+		if(ranges[j].t != t) goto cleanup;
+		ranges[j].preds[ranges[j].pred_count++] = preds[i];
+	}
+
+	for(uint i = 0; i < range_count; i++) _BuildRange(ranges + i);
+
+	if(range_count == 1) {
+		iter = _SingleAttributeIterator(idx, ranges);
+	} else {
+		iter = _CompositeIterator(none_converted_filters, idx, ranges,
+				range_count);
+	}
+
+cleanup:
+	for(uint i = 0; i < range_count; i++) {
+		if(ranges[i].num_range) NumericRange_Free(ranges[i].num_range);
+		if(ranges[i].str_range) StringRange_Free(ranges[i].str_range);
+	}
+
+	return iter;
+}
+
+// collects the predicates of 'tree' bounding 'attr' into range 'r'
+// all of the tree's predicates are collected into 'preds'
+// returns false if 'tree' isn't a conjunction of predicates
+// or if none of its predicates bounds 'attr' by a supported value
+static bool _OrderingRange
+(
+	const FT_FilterNode *tree,
+	Attribute_ID attr,
+	AttributeRange *r,
+	const FT_FilterNode **preds,
+	uint *count
+) {
+	*count = 0;
+	if(!_CollectPredicates(tree, preds, count, MAX_PREDICATES)) return false;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	for(uint i = 0; i < *count; i++) {
+		char *prop = NULL;
+		if(!_SupportedPredicate(preds[i], &prop)) continue;
+		if(GraphContext_GetAttributeID(gc, prop) != attr) continue;
+
+		SIValue c = preds[i]->pred.rhs->operand.constant;
+		SIType t = (SI_TYPE(c) & SI_NUMERIC) ? SI_NUMERIC : T_STRING;
+
+		// predicates over the same attribute must share a type
+		if(r->pred_count > 0 && r->t != t) return false;
+
+		r->t = t;
+		r->field = prop;
+		r->preds[r->pred_count++] = preds[i];
+	}
+
+	return r->pred_count > 0;
+}
+
+bool FilterTree_NativeOrderable
+(
+	const FT_FilterNode *tree,
+	Attribute_ID attr
+) {
+	ASSERT(tree != NULL);
+
+	uint count = 0;
+	const FT_FilterNode *preds[MAX_PREDICATES];
+	const FT_FilterNode *range_preds[MAX_PREDICATES];
+	AttributeRange r = { .attr = attr, .preds = range_preds };
+
+	return _OrderingRange(tree, attr, &r, preds, &count);
+}
+
+NativeIndexIterator *FilterTreeToOrderedNativeIterator
+(
+	FT_FilterNode **none_converted_filters,
+	const FT_FilterNode *tree,
+	NativeIndex *idx,
+	Attribute_ID attr
+) {
+	ASSERT(idx                     != NULL);
+	ASSERT(tree                    != NULL);
+	ASSERT(none_converted_filters  != NULL);
+
+	*none_converted_filters = NULL;
+
+	uint count = 0;
+	const FT_FilterNode *preds[MAX_PREDICATES];
+	const FT_FilterNode *range_preds[MAX_PREDICATES];
+	AttributeRange r = { .attr = attr, .preds = range_preds };
+
+	if(!_OrderingRange(tree, attr, &r, preds, &count)) return NULL;
+
+	_BuildRange(&r);
+	NativeIndexIterator *iter = _SingleAttributeIterator(idx, &r);
+
+	// predicates outside of the range are applied per entity
+	FT_FilterNode **filters = array_new(FT_FilterNode *, 1);
+	for(uint i = 0; i < count; i++) {
+		bool used = false;
+		for(uint j = 0; j < r.pred_count && !used; j++) {
+			used = (r.preds[j] == preds[i]);
+		}
+		if(!used) array_append(filters, FilterTree_Clone(preds[i]));
+	}
+	*none_converted_filters = FilterTree_Combine(filters, array_len(filters));
+	array_free(filters);
+
+	if(r.num_range) NumericRange_Free(r.num_range);
+	if(r.str_range) StringRange_Free(r.str_range);
+
+	return iter;
+}
@@ -0,0 +1,44 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "filter_tree.h"
+#include "../index/index_native.h"
+
+// construct a native index iterator from filter tree
+// returns NULL if the native index can't resolve the filter
+// in which case the filter should be resolved by RediSearch
+// predicates on attributes beyond a matched composite prefix are returned
+// via 'none_converted_filters' and should be applied to the iterated entities
+NativeIndexIterator *FilterTreeToNativeIterator
+(
+	FT_FilterNode **none_converted_filters,  // [output] filters not resolved
+	const FT_FilterNode *tree,               // filter to convert
+	NativeIndex *idx                         // queried index
+);
+
+
+// returns true if 'tree' is a conjunction of predicates, at least one of
+// which bounds 'attr' such that FilterTreeToOrderedNativeIterator succeeds
+bool FilterTree_NativeOrderable
+(
+	const FT_FilterNode *tree,  // filter to inspect
+	Attribute_ID attr           // attribute to order by
+);
+
+// construct a native index iterator over the range of 'attr' bounded by
+// the filter's predicates, entities are iterated by ascending 'attr' value
+// entities missing 'attr' are skipped, as they fail the bounding predicates
+// predicates on other attributes are returned via 'none_converted_filters'
+// returns NULL if 'tree' isn't orderable, see FilterTree_NativeOrderable
+NativeIndexIterator *FilterTreeToOrderedNativeIterator
+(
+	FT_FilterNode **none_converted_filters,  // [output] filters not resolved
+	const FT_FilterNode *tree,               // filter to convert
+	NativeIndex *idx,                        // queried index
+	Attribute_ID attr                        // attribute to order by
+);
@@ -7,12 +7,19 @@
 #include "ft_to_rsq.h"
 #include "RG.h"
 #include "../util/arr.h"
+#include "../util/rmalloc.h"
 #include "filter_tree_utils.h"
 #include "../datatypes/point.h"
 #include "../datatypes/array.h"
 #include "../util/range/string_range.h"
 #include "../util/range/numeric_range.h"
 
+// the geo index measures distances over geohash cells using a different
+// earth radius than distance(), radius queries are widened by a margin
+// and their results are re-checked against the distance filter
+#define DISTANCE_RELATIVE_MARGIN 0.01  // 1% of the radius
+#define DISTANCE_ABSOLUTE_MARGIN 10.0  // 10 meters
+
 //------------------------------------------------------------------------------
 // forward declarations
 //------------------------------------------------------------------------------
@@ -82,8 +89,56 @@ static RSQNode *_FilterTreeToDistanceQueryNode
 
 	extractOriginAndRadius(filter, &origin, &radius, &field);
 
+	double r = SI_GET_NUMERIC(radius);
+	r += r * DISTANCE_RELATIVE_MARGIN + DISTANCE_ABSOLUTE_MARGIN;
+
 	return RediSearch_CreateGeoNode(idx, field, Point_lat(origin),
-									Point_lon(origin), SI_GET_NUMERIC(radius), RS_GEO_DISTANCE_M);
+									Point_lon(origin), r, RS_GEO_DISTANCE_M);
+}
+
+// creates a RediSearch query node out of given prefix filter
+// scanning the lexical range of strings starting with the prefix
+// returns true if the range resolves the filter
+static bool _FilterTreeToPrefixQueryNode
+(
+	RSQNode **root,         // [output] query node
+	FT_FilterNode *filter,  // filter to convert
+	RSIndex *idx            // queried index
+) {
+	char *field   =  NULL;  // field being filtered
+	char *prefix  =  NULL;  // common prefix of matching strings
+	bool exact    =  false; // prefix match resolves the filter
+
+	bool res = extractPrefix(filter, &field, &prefix, &exact);
+	ASSERT(res == true);
+	UNUSED(res);
+
+	// strings starting with an ASCII prefix are bounded by the prefix
+	// with its last character incremented, the index orders multi-byte
+	// characters differently, leave their range unbounded
+	bool ascii = true;
+	size_t len = strlen(prefix);
+	for(size_t i = 0; i < len && ascii; i++) {
+		ascii = (unsigned char)prefix[i] < 0x7F;
+	}
+
+	RSQNode *node;
+	if(ascii) {
+		char *upper = rm_strdup(prefix);
+		upper[len - 1]++;
+		node = RediSearch_CreateLexRangeNode(idx, field, prefix, upper, 1, 0);
+		rm_free(upper);
+	} else {
+		node = RediSearch_CreateLexRangeNode(idx, field, prefix,
+				RSLECRANGE_INF, 1, 0);
+	}
+	rm_free(prefix);
+
+	RSQNode *parent = RediSearch_CreateTagNode(idx, field);
+	RediSearch_QueryNodeAddChild(parent, node);
+	*root = parent;
+
+	return exact && ascii;
 }
 
 // creates a RediSearch query node out of given IN filter
@@ -517,9 +572,15 @@ static bool _FilterTreeToQueryNode
 		return true;
 	}
 
+	// the index narrows down candidates within a widened radius
+	// the filter itself remains to validate their exact distance
 	if(isDistanceFilter(tree)) {
 		*root = _FilterTreeToDistanceQueryNode(tree, idx);
-		return true;
+		return false;
+	}
+
+	if(isPrefixFilter(tree)) {
+		return _FilterTreeToPrefixQueryNode(root, tree, idx);
 	}
 
 	FT_FilterNodeType t = tree->t;
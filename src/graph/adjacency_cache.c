@@ -0,0 +1,186 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rax.h"
+#include "adjacency_cache.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/rax_extensions.h"
+#include <pthread.h>
+
+struct AdjacencyCache {
+	rax *entries;             // (node, relation, direction) to edge array
+	uint64_t epoch;           // write epoch entries were collected at
+	uint64_t edge_count;      // number of cached edges
+	pthread_rwlock_t rwlock;  // guards entries
+};
+
+// cache key, nodes are unique per (relation, direction)
+typedef struct {
+	NodeID id;
+	int32_t relation;
+	int32_t outgoing;
+} AdjacencyCacheKey;
+
+static inline AdjacencyCacheKey _Key
+(
+	NodeID id,
+	int relation,
+	bool outgoing
+) {
+	AdjacencyCacheKey key = {.id = id, .relation = relation,
+		.outgoing = outgoing};
+	return key;
+}
+
+static void _FreeEntry
+(
+	void *edges
+) {
+	array_free((Edge *)edges);
+}
+
+// discard all entries, caller must hold the write lock
+static void _Clear
+(
+	AdjacencyCache *cache
+) {
+	raxFreeWithCallback(cache->entries, _FreeEntry);
+	cache->entries = raxNew();
+	__atomic_store_n(&cache->edge_count, 0, __ATOMIC_RELAXED);
+}
+
+AdjacencyCache *AdjacencyCache_New(void) {
+	AdjacencyCache *cache = rm_malloc(sizeof(AdjacencyCache));
+
+	cache->epoch      = 0;
+	cache->entries    = raxNew();
+	cache->edge_count = 0;
+
+	int res = pthread_rwlock_init(&cache->rwlock, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return cache;
+}
+
+bool AdjacencyCache_Get
+(
+	AdjacencyCache *cache,
+	uint64_t epoch,
+	NodeID id,
+	int relation,
+	bool outgoing,
+	Edge **edges
+) {
+	ASSERT(cache != NULL);
+	ASSERT(edges != NULL);
+
+	// fast path, avoid locking when nothing is cached
+	if(AdjacencyCache_EdgeCount(cache) == 0) return false;
+
+	bool hit = false;
+	AdjacencyCacheKey key = _Key(id, relation, outgoing);
+
+	pthread_rwlock_rdlock(&cache->rwlock);
+
+	if(cache->epoch == epoch) {
+		Edge *cached = raxFind(cache->entries, (unsigned char *)&key,
+				sizeof(key));
+		if(cached != raxNotFound) {
+			uint n = array_len(cached);
+			array_ensure_append(*edges, cached, n, Edge);
+			hit = true;
+		}
+	}
+
+	pthread_rwlock_unlock(&cache->rwlock);
+
+	return hit;
+}
+
+void AdjacencyCache_Set
+(
+	AdjacencyCache *cache,
+	uint64_t epoch,
+	NodeID id,
+	int relation,
+	bool outgoing,
+	const Edge *edges,
+	uint count
+) {
+	ASSERT(cache != NULL);
+	ASSERT(edges != NULL);
+
+	if(count > ADJACENCY_CACHE_MAX_EDGES) return;
+
+	AdjacencyCacheKey key = _Key(id, relation, outgoing);
+
+	pthread_rwlock_wrlock(&cache->rwlock);
+
+	// entries collected at an earlier epoch are stale
+	// make room for the new entry once capacity is exhausted
+	if(cache->epoch != epoch ||
+	   cache->edge_count + count > ADJACENCY_CACHE_MAX_EDGES) {
+		_Clear(cache);
+		cache->epoch = epoch;
+	}
+
+	// concurrent readers may have collected the same node
+	if(raxFind(cache->entries, (unsigned char *)&key, sizeof(key)) ==
+	   raxNotFound) {
+		Edge *cached = array_new(Edge, count);
+		array_ensure_append(cached, edges, count, Edge);
+		raxInsert(cache->entries, (unsigned char *)&key, sizeof(key), cached,
+				NULL);
+		__atomic_store_n(&cache->edge_count, cache->edge_count + count,
+				__ATOMIC_RELAXED);
+	}
+
+	pthread_rwlock_unlock(&cache->rwlock);
+}
+
+uint64_t AdjacencyCache_EdgeCount
+(
+	const AdjacencyCache *cache
+) {
+	ASSERT(cache != NULL);
+	return __atomic_load_n(&cache->edge_count, __ATOMIC_RELAXED);
+}
+
+size_t AdjacencyCache_MemoryUsage
+(
+	AdjacencyCache *cache
+) {
+	ASSERT(cache != NULL);
+
+	pthread_rwlock_rdlock(&cache->rwlock);
+
+	size_t size = sizeof(AdjacencyCache) + raxMemoryUsage(cache->entries);
+
+	raxIterator it;
+	raxStart(&it, cache->entries);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) size += array_sizeof(array_hdr((Edge *)it.data));
+	raxStop(&it);
+
+	pthread_rwlock_unlock(&cache->rwlock);
+
+	return size;
+}
+
+void AdjacencyCache_Free
+(
+	AdjacencyCache *cache
+) {
+	ASSERT(cache != NULL);
+
+	raxFreeWithCallback(cache->entries, _FreeEntry);
+	pthread_rwlock_destroy(&cache->rwlock);
+	rm_free(cache);
+}
+
@@ -0,0 +1,71 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "entities/edge.h"
+
+// min number of edges a node must have in a direction for it to be cached
+#define ADJACENCY_CACHE_MIN_DEGREE 512
+// max number of edges held by the cache, the cache is cleared once exceeded
+#define ADJACENCY_CACHE_MAX_EDGES (1 << 18)
+
+// cache of decoded adjacency lists of high degree nodes
+// maps (node, relationship type, direction) to the node's edges
+//
+// entries are valid for a single graph write epoch,
+// the first insertion following a write discards all entries
+// the cache is shared by reader threads and is safe for concurrent use
+// it must not be consulted while the graph is being modified
+typedef struct AdjacencyCache AdjacencyCache;
+
+// create a new adjacency cache
+AdjacencyCache *AdjacencyCache_New(void);
+
+// appends the cached edges of 'id' to 'edges'
+// returns false if no entry exists for the current epoch
+bool AdjacencyCache_Get
+(
+	AdjacencyCache *cache,  // cache to query
+	uint64_t epoch,         // current graph write epoch
+	NodeID id,              // node whose edges are requested
+	int relation,           // relationship type, GRAPH_NO_RELATION for any
+	bool outgoing,          // outgoing or incoming edges
+	Edge **edges            // [output] array to append edges to
+);
+
+// caches 'count' edges of 'id'
+void AdjacencyCache_Set
+(
+	AdjacencyCache *cache,  // cache to populate
+	uint64_t epoch,         // graph write epoch 'edges' were collected at
+	NodeID id,              // node the edges belong to
+	int relation,           // relationship type, GRAPH_NO_RELATION for any
+	bool outgoing,          // outgoing or incoming edges
+	const Edge *edges,      // edges to cache
+	uint count              // number of edges
+);
+
+// number of edges held by the cache
+uint64_t AdjacencyCache_EdgeCount
+(
+	const AdjacencyCache *cache
+);
+
+// number of bytes used by the cache
+size_t AdjacencyCache_MemoryUsage
+(
+	AdjacencyCache *cache
+);
+
+// free cache
+void AdjacencyCache_Free
+(
+	AdjacencyCache *cache
+);
+
@@ -24,8 +24,7 @@
 	.src = NULL,                      \
 	.dest = NULL,                     \
 	.srcNodeID = INVALID_ENTITY_ID,   \
-	.destNodeID = INVALID_ENTITY_ID,  \
-	.mat = NULL                       \
+	.destNodeID = INVALID_ENTITY_ID   \
 }
 
 // instantiate a new edge with relation data
@@ -38,8 +37,7 @@
 	.src = NULL,                            \
 	.dest = NULL,                           \
 	.srcNodeID = INVALID_ENTITY_ID,         \
-	.destNodeID = INVALID_ENTITY_ID,        \
-	.mat = NULL                             \
+	.destNodeID = INVALID_ENTITY_ID         \
 }
 
 // resolves to the label ID of the given Node.
@@ -54,16 +52,17 @@ __extension__({
 
 /* TODO: note it is possible to get into an inconsistency
  * if we set src and srcNodeID to different nodes. */
+// edges are the largest Record entry, keep members ordered by size
+// such that the struct carries no padding between members
 struct Edge {
 	Entity *entity;             // MUST be the first member
 	EntityID id;                // Unique id, MUST be the second member
 	const char *relationship;   // Label attached to edge
-	int relationID;             // Relation ID
 	Node *src;                  // Pointer to source node
 	Node *dest;                 // Pointer to destination node
 	NodeID srcNodeID;           // Source node ID
 	NodeID destNodeID;          // Destination node ID
-	RG_Matrix mat;              // Adjacency matrix, associated with edge
+	int relationID;             // Relation ID
 };
 
 typedef struct Edge Edge;
@@ -86,9 +85,6 @@ Node *Edge_GetSrcNode(Edge *e); // opcreate
 // Retrieve edge destination node. // opcreate
 Node *Edge_GetDestNode(Edge *e);
 
-// Retrieves edge matrix.
-RG_Matrix Edge_GetMatrix(Edge *e); // AE
-
 // Sets edge source node.
 void Edge_SetSrcNode(Edge *e, Node *src); // QG
 
@@ -5,6 +5,7 @@
 */
 
 #include "graph_entity.h"
+#include <string.h>
 #include "node.h"
 #include "edge.h"
 #include "../../RG.h"
@@ -13,33 +14,125 @@
 #include "../graphcontext.h"
 #include "../../util/rmalloc.h"
 #include "../../datatypes/array.h"
+#include "../../util/string_pool.h"
+#include "../../configuration/config.h"
 
 SIValue *PROPERTY_NOTFOUND = &(SIValue) {
 	.longval = 0, .type = T_NULL
 };
 
+// stands in for lazily materialised nodes deleted before being accessed
+static Entity DELETED_ENTITY = { .properties = NULL };
+
+// size of a properties block holding 'n' attributes
+#define PROPERTIES_BLOCK_SIZE(n) \
+	(sizeof(uint64_t) + (n) * (sizeof(SIValue) + sizeof(Attribute_ID)))
+
+// properties block allocation, the property count precedes the values
+#define PROPERTIES_BLOCK(properties) (((uint64_t *)(properties)) - 1)
+
+// resizes entity's properties block to hold 'n' attributes
+// the IDs column is not relocated
+static void _Entity_ResizeProperties(Entity *e, int n) {
+	if(n == 0) {
+		if(e->properties != NULL) rm_free(PROPERTIES_BLOCK(e->properties));
+		e->properties = NULL;
+		return;
+	}
+
+	uint64_t *block = (e->properties == NULL) ?
+		rm_malloc(PROPERTIES_BLOCK_SIZE(n)) :
+		rm_realloc(PROPERTIES_BLOCK(e->properties), PROPERTIES_BLOCK_SIZE(n));
+
+	if(e->properties == NULL) block[0] = 0;
+	e->properties = (SIValue *)(block + 1);
+}
+
+// sets the number of properties held by entity
+static inline void _Entity_SetPropCount(Entity *e, int n) {
+	ASSERT(e->properties != NULL);
+	*PROPERTIES_BLOCK(e->properties) = n;
+}
+
+// returns a compressed copy of string 'v' if it's at least
+// COMPRESSION_THRESHOLD bytes long and compresses well, NULL value otherwise
+static SIValue _CompressedValue(SIValue v) {
+	uint64_t threshold;
+	Config_Option_get(Config_COMPRESSION_THRESHOLD, &threshold);
+	if(threshold == 0) return SI_NullVal();
+
+	size_t len = strlen(v.stringval);
+	if(len < threshold) return SI_NullVal();
+
+	char *cs = CompressedString_New(v.stringval, len);
+	if(cs == NULL) return SI_NullVal();
+
+	return (SIValue) {
+		.stringval = cs, .type = T_STRING, .allocation = M_COMPRESSED
+	};
+}
+
+// returns a copy of 'v' to be stored as a property value
+// interned strings are shared rather than duplicated
+// values in memory-mapped storage are referenced as is
+// large strings are stored compressed
+static inline SIValue _PropertyValue(SIValue v) {
+	if(v.allocation == M_INTERN) {
+		StringPool_Retain(v.stringval);
+		return v;
+	}
+	if(v.allocation == M_EXTERN) return v;
+	if(v.allocation == M_COMPRESSED) {
+		v.stringval = CompressedString_Clone(v.stringval);
+		return v;
+	}
+	if(SI_TYPE(v) == T_STRING) {
+		SIValue compressed = _CompressedValue(v);
+		if(!SIValue_IsNull(compressed)) return compressed;
+	}
+	return SI_CloneValue(v);
+}
+
+Entity *GraphEntity_GetEntity(const GraphEntity *e) {
+	ASSERT(e != NULL);
+
+	if(e->entity != NULL) return e->entity;
+	if(e->id == INVALID_ENTITY_ID) return NULL;
+
+	// only nodes are materialised lazily, resolve and cache the entity
+	Node n;
+	if(!Graph_GetNode(QueryCtx_GetGraph(), e->id, &n)) return &DELETED_ENTITY;
+	((GraphEntity *)e)->entity = n.entity;
+	return n.entity;
+}
+
 /* Removes entity's property. */
 static bool _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_id) {
 	// Quick return if attribute is missing.
 	if(attr_id == ATTRIBUTE_NOTFOUND) return false;
 
 	// Locate attribute position.
-	int prop_count = e->entity->prop_count;
+	Entity *en = GraphEntity_GetEntity(e);
+	int prop_count = Entity_PropCount(en);
+	SIValue *values = en->properties;
+	Attribute_ID *ids = Entity_AttributeIDs(en);
 	for(int i = 0; i < prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
-			SIValue_Free(e->entity->properties[i].value);
-			e->entity->prop_count--;
+		if(attr_id == ids[i]) {
+			SIValue_Free(values[i]);
 
-			if(e->entity->prop_count == 0) {
+			if(prop_count == 1) {
 				/* Only attribute removed, free properties bag. */
-				rm_free(e->entity->properties);
-				e->entity->properties = NULL;
+				_Entity_ResizeProperties(en, 0);
 			} else {
 				/* Overwrite deleted attribute with the last
 				 * attribute and shrink properties bag. */
-				e->entity->properties[i] = e->entity->properties[prop_count - 1];
-				e->entity->properties = rm_realloc(e->entity->properties,
-												   sizeof(EntityProperty) * e->entity->prop_count);
+				values[i] = values[prop_count - 1];
+				ids[i] = ids[prop_count - 1];
+				_Entity_SetPropCount(en, prop_count - 1);
+				// IDs column starts right after the last value
+				memmove(Entity_AttributeIDs(en), ids,
+						sizeof(Attribute_ID) * (prop_count - 1));
+				_Entity_ResizeProperties(en, prop_count - 1);
 			}
 
 			return true;
@@ -52,16 +145,15 @@ static bool _GraphEntity_RemoveProperty(const GraphEntity *e, Attribute_ID attr_
 int GraphEntity_ClearProperties(GraphEntity *e) {
 	ASSERT(e);
 
-	int prop_count = e->entity->prop_count;
+	Entity *en = GraphEntity_GetEntity(e);
+	int prop_count = Entity_PropCount(en);
 	for(int i = 0; i < prop_count; i++) {
 		// free all allocated properties
-		SIValue_Free(e->entity->properties[i].value);
+		SIValue_Free(en->properties[i]);
 	}
-	e->entity->prop_count = 0;
 
 	// free and NULL-set the properties bag.
-	rm_free(e->entity->properties);
-	e->entity->properties = NULL;
+	_Entity_ResizeProperties(en, 0);
 
 	return prop_count;
 }
@@ -71,42 +163,127 @@ bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value
 	ASSERT(e);
 	if(!(SI_TYPE(value) & SI_VALID_PROPERTY_VALUE)) return false;
 
-	if(e->entity->properties == NULL) {
-		e->entity->properties = rm_malloc(sizeof(EntityProperty));
-	} else {
-		e->entity->properties = rm_realloc(e->entity->properties,
-										   sizeof(EntityProperty) * (e->entity->prop_count + 1));
-	}
+	Entity *en = GraphEntity_GetEntity(e);
+	int prop_idx = Entity_PropCount(en);
+	_Entity_ResizeProperties(en, prop_idx + 1);
+	// shift IDs column to make room for the new value
+	memmove(en->properties + prop_idx + 1, en->properties + prop_idx,
+			sizeof(Attribute_ID) * prop_idx);
 
-	int prop_idx = e->entity->prop_count;
-	e->entity->properties[prop_idx].id = attr_id;
-	e->entity->properties[prop_idx].value = SI_CloneValue(value);
-	e->entity->prop_count++;
+	_Entity_SetPropCount(en, prop_idx + 1);
+	en->properties[prop_idx] = _PropertyValue(value);
+	Entity_AttributeIDs(en)[prop_idx] = attr_id;
 
 	return true;
 }
 
-SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
+int GraphEntity_AddProperties(GraphEntity *e, const Attribute_ID *attr_ids,
+		SIValue *values, int n) {
+	ASSERT(e);
+	ASSERT(n == 0 || (attr_ids != NULL && values != NULL));
+
+	// count valid values
+	int valid = 0;
+	for(int i = 0; i < n; i++) {
+		if(SI_TYPE(values[i]) & SI_VALID_PROPERTY_VALUE) valid++;
+	}
+	if(valid == 0) return 0;
+
+	// grow properties block once for all new attributes
+	Entity *en = GraphEntity_GetEntity(e);
+	int prop_count = Entity_PropCount(en);
+	_Entity_ResizeProperties(en, prop_count + valid);
+	// shift IDs column to make room for the new values
+	memmove(en->properties + prop_count + valid, en->properties + prop_count,
+			sizeof(Attribute_ID) * prop_count);
+
+	_Entity_SetPropCount(en, prop_count + valid);
+	SIValue *props = en->properties;
+	Attribute_ID *ids = Entity_AttributeIDs(en);
+	for(int i = 0; i < n; i++) {
+		if(!(SI_TYPE(values[i]) & SI_VALID_PROPERTY_VALUE)) continue;
+		props[prop_count] = _PropertyValue(values[i]);
+		ids[prop_count] = attr_ids[i];
+		prop_count++;
+	}
+
+	return valid;
+}
+
+// returns the stored value of entity's property, PROPERTY_NOTFOUND if missing
+static SIValue *_GraphEntity_StoredProperty(const GraphEntity *e,
+		Attribute_ID attr_id) {
 	if(attr_id == ATTRIBUTE_NOTFOUND) return PROPERTY_NOTFOUND;
-	if(e->entity == NULL) {
+	Entity *en = GraphEntity_GetEntity(e);
+	if(en == NULL) {
 		/* The internal entity pointer should only be NULL if the entity
 		 * is in an intermediate state, such as a node scheduled for creation.
 		 * Note that this exception may cause memory to be leaked in the caller. */
-		ASSERT(e->id == INVALID_ENTITY_ID);
 		ErrorCtx_SetError("Attempted to access undefined property");
 		return PROPERTY_NOTFOUND;
 	}
 
-	for(int i = 0; i < e->entity->prop_count; i++) {
-		if(attr_id == e->entity->properties[i].id) {
+	int prop_count = Entity_PropCount(en);
+	const Attribute_ID *ids = Entity_AttributeIDs(en);
+	for(int i = 0; i < prop_count; i++) {
+		if(attr_id == ids[i]) {
 			// Note, unsafe as entity properties can get reallocated.
-			return &(e->entity->properties[i].value);
+			return en->properties + i;
 		}
 	}
 
 	return PROPERTY_NOTFOUND;
 }
 
+SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id) {
+	return Entity_ReadValue(_GraphEntity_StoredProperty(e, attr_id));
+}
+
+SIValue GraphEntity_GetPropertyValue(const GraphEntity *e, Attribute_ID attr_id) {
+	return Entity_ConstValue(_GraphEntity_StoredProperty(e, attr_id));
+}
+
+void GraphEntity_GetProperties
+(
+	const GraphEntity *e,
+	const Attribute_ID *attr_ids,
+	int n,
+	SIValue *values
+) {
+	ASSERT(e        != NULL);
+	ASSERT(values   != NULL);
+	ASSERT(attr_ids != NULL);
+
+	for(int i = 0; i < n; i++) values[i] = SI_NullVal();
+
+	Entity *en = GraphEntity_GetEntity(e);
+	if(en == NULL) {
+		// see GraphEntity_GetProperty
+		ErrorCtx_SetError("Attempted to access undefined property");
+		return;
+	}
+
+	// single pass over the entity's attribute IDs
+	int prop_count = Entity_PropCount(en);
+	const Attribute_ID *ids = Entity_AttributeIDs(en);
+	for(int i = 0; i < prop_count; i++) {
+		for(int j = 0; j < n; j++) {
+			if(attr_ids[j] == ids[i]) {
+				values[j] = Entity_ConstValue(en->properties + i);
+			}
+		}
+	}
+}
+
+size_t Entity_PropertiesMemoryUsage(const Entity *e) {
+	int n = Entity_PropCount(e);
+	if(n == 0) return 0;
+
+	size_t size = PROPERTIES_BLOCK_SIZE(n);
+	for(int i = 0; i < n; i++) size += SIValue_MemoryUsage(e->properties[i]);
+	return size;
+}
+
 // Updates existing property value.
 bool GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue value) {
 	ASSERT(e);
@@ -114,23 +291,24 @@ bool GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue
 	// Setting an attribute value to NULL removes that attribute.
 	if(SIValue_IsNull(value)) return _GraphEntity_RemoveProperty(e, attr_id);
 
-	SIValue *current = GraphEntity_GetProperty(e, attr_id);
+	SIValue *current = _GraphEntity_StoredProperty(e, attr_id);
 	ASSERT(current != PROPERTY_NOTFOUND);
 
 	// compare current value to new value, only update if current != new
-	if(SIValue_Compare(*current, value, NULL) == 0) return false;
+	if(SIValue_Compare(*Entity_ReadValue(current), value, NULL) == 0) return false;
 
 	// value != current, update entity
 	SIValue_Free(*current);
-	*current = SI_CloneValue(value);
+	*current = _PropertyValue(value);
 	return true;
 }
 
 SIValue GraphEntity_Keys(const GraphEntity *e) {
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	SIValue keys = SIArray_New(ENTITY_PROP_COUNT(e));
-	for(int i = 0; i < e->entity->prop_count; i++) {
-		const char *key = GraphContext_GetAttributeString(gc, ENTITY_PROPS(e)[i].id);
+	const Attribute_ID *ids = ENTITY_PROP_IDS(e);
+	for(int i = 0; i < ENTITY_PROP_COUNT(e); i++) {
+		const char *key = GraphContext_GetAttributeString(gc, ids[i]);
 		SIArray_Append(&keys, SI_ConstStringVal(key));
 	}
 	return keys;
@@ -146,10 +324,11 @@ size_t GraphEntity_PropertiesToString(const GraphEntity *e, char **buffer, size_
 	*bytesWritten += snprintf(*buffer, *bufferLen, "{");
 	GraphContext *gc = QueryCtx_GetGraphCtx();
 	int propCount = ENTITY_PROP_COUNT(e);
-	EntityProperty *properties = ENTITY_PROPS(e);
+	SIValue *values = ENTITY_PROP_VALUES(e);
+	const Attribute_ID *ids = ENTITY_PROP_IDS(e);
 	for(int i = 0; i < propCount; i++) {
 		// print key
-		const char *key = GraphContext_GetAttributeString(gc, properties[i].id);
+		const char *key = GraphContext_GetAttributeString(gc, ids[i]);
 		// check for enough space
 		size_t keyLen = strlen(key);
 		if(*bufferLen - *bytesWritten < keyLen) {
@@ -159,7 +338,8 @@ size_t GraphEntity_PropertiesToString(const GraphEntity *e, char **buffer, size_
 		*bytesWritten += snprintf(*buffer + *bytesWritten, *bufferLen, "%s:", key);
 
 		// print value
-		SIValue_ToString(properties[i].value, buffer, bufferLen, bytesWritten);
+		SIValue_ToString(*Entity_ReadValue(values + i), buffer, bufferLen,
+				bytesWritten);
 
 		// if not the last element print ", "
 		if(i != propCount - 1) *bytesWritten = snprintf(*buffer + *bytesWritten, *bufferLen, ", ");
@@ -262,17 +442,18 @@ void GraphEntity_ToString
 	*bytesWritten += snprintf(*buffer + *bytesWritten, *bufferLen, "%s", closeSymbole);
 }
 
-inline bool GraphEntity_IsDeleted(const GraphEntity *e) {
-	return Graph_EntityIsDeleted(e->entity);
+bool GraphEntity_IsDeleted(const GraphEntity *e) {
+	Entity *en = GraphEntity_GetEntity(e);
+	if(en == &DELETED_ENTITY) return true;
+	return Graph_EntityIsDeleted(en);
 }
 
 void FreeEntity(Entity *e) {
 	ASSERT(e);
 	if(e->properties != NULL) {
-		for(int i = 0; i < e->prop_count; i++) SIValue_Free(e->properties[i].value);
-		rm_free(e->properties);
-		e->properties = NULL;
-		e->prop_count = 0;
+		int prop_count = Entity_PropCount(e);
+		for(int i = 0; i < prop_count; i++) SIValue_Free(e->properties[i]);
+		_Entity_ResizeProperties(e, 0);
 	}
 }
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../../value.h"
+#include "../../util/compressed_string.h"
 #include "../../../deps/GraphBLAS/Include/GraphBLAS.h"
 
 #define ATTRIBUTE_NOTFOUND USHRT_MAX
@@ -17,8 +18,12 @@
 #define INVALID_ENTITY_ID -1l
 
 #define ENTITY_GET_ID(graphEntity) (graphEntity)->id
-#define ENTITY_PROP_COUNT(graphEntity) ((graphEntity)->entity->prop_count)
-#define ENTITY_PROPS(graphEntity) ((graphEntity)->entity->properties)
+#define ENTITY_PROP_COUNT(graphEntity) \
+	Entity_PropCount(GraphEntity_GetEntity((const GraphEntity *)(graphEntity)))
+#define ENTITY_PROP_VALUES(graphEntity) \
+	(GraphEntity_GetEntity((const GraphEntity *)(graphEntity))->properties)
+#define ENTITY_PROP_IDS(graphEntity) \
+	Entity_AttributeIDs(GraphEntity_GetEntity((const GraphEntity *)(graphEntity)))
 
 // Defined in graph_entity.c
 extern SIValue *PROPERTY_NOTFOUND;
@@ -44,24 +49,61 @@ typedef enum GraphEntityType {
 	GETYPE_EDGE
 } GraphEntityType;
 
-typedef struct {
-	Attribute_ID id;
-	SIValue value;
-} EntityProperty;
-
 // Essence of a graph entity.
-// TODO: see if pragma pack 0 will cause memory access violation on ARM.
+// Properties are stored column-wise within a single allocation:
+// the number of properties followed by that many values
+// and their attribute IDs, such that attribute lookups scan a dense array
+// of IDs and no padding is wasted between an ID and its value.
+// | count | value_0 ... value_n-1 | id_0 ... id_n-1 |
+// 'properties' points at the first value, entities without properties
+// hold no allocation and only occupy a single pointer.
 typedef struct {
-	int prop_count;             // Number of properties.
-	EntityProperty *properties; // Key value pair of attributes.
+	SIValue *properties;        // Attribute values followed by attribute IDs.
 } Entity;
 
+// Returns the number of properties held by the entity.
+static inline int Entity_PropCount(const Entity *e) {
+	if(e->properties == NULL) return 0;
+	return (int)((const uint64_t *)e->properties)[-1];
+}
+
+// Returns the entity's attribute IDs, the i'th ID describes the i'th value.
+static inline Attribute_ID *Entity_AttributeIDs(const Entity *e) {
+	return (Attribute_ID *)(e->properties + Entity_PropCount(e));
+}
+
+// Hints the CPU to load the entity's properties block.
+static inline void Entity_PrefetchProperties(const Entity *e) {
+	if(e->properties != NULL) __builtin_prefetch((const uint64_t *)e->properties - 1);
+}
+
+// Returns stored property value 'v' as read by queries,
+// compressed strings are read through this thread's decompressed copy.
+static inline SIValue *Entity_ReadValue(SIValue *v) {
+	if(v->allocation == M_COMPRESSED) return CompressedString_Read(v->stringval);
+	return v;
+}
+
+// Returns stored property value 'v' as a constant held by queries,
+// compressed strings are decompressed into a copy owned by the result.
+static inline SIValue Entity_ConstValue(SIValue *v) {
+	if(v->allocation == M_COMPRESSED) return SI_CloneValue(*v);
+	return SI_ConstValue(v);
+}
+
 // Common denominator between nodes and edges.
+// Nodes produced by scans and traversals carry only their ID,
+// 'entity' is NULL until their properties are first accessed.
 typedef struct {
 	Entity *entity;
 	EntityID id;
 } GraphEntity;
 
+// returns the entity holding e's properties, looking up lazily
+// materialised nodes in the graph of the current query
+// returns NULL for entities scheduled for creation
+Entity *GraphEntity_GetEntity(const GraphEntity *e);
+
 /* Deletes all properties on the GraphEntity and returns
  * the number of deleted properties. */
 int GraphEntity_ClearProperties(GraphEntity *e);
@@ -70,11 +112,38 @@ int GraphEntity_ClearProperties(GraphEntity *e);
  * returns - reference to newly added property. */
 bool GraphEntity_AddProperty(GraphEntity *e, Attribute_ID attr_id, SIValue value);
 
+// adds multiple properties to entity using a single allocation
+// values which aren't valid property values are skipped
+// returns the number of added properties
+int GraphEntity_AddProperties(GraphEntity *e, const Attribute_ID *attr_ids,
+		SIValue *values, int n);
+
 /* Retrieves entity's property
  * NOTE: If the key does not exist, we return the special
  * constant value PROPERTY_NOTFOUND. */
 SIValue *GraphEntity_GetProperty(const GraphEntity *e, Attribute_ID attr_id);
 
+// retrieves entity's property as a value which can be held on to,
+// see Entity_ConstValue, the value is null if the entity doesn't hold it
+// and should be released by SIValue_Free
+SIValue GraphEntity_GetPropertyValue(const GraphEntity *e, Attribute_ID attr_id);
+
+// retrieves the properties 'attr_ids' of an entity in a single pass
+// over its attribute IDs, values[i] is set to a constant reference to the
+// value of attr_ids[i] or to null if the entity doesn't hold it
+// values should be released by SIValue_Free, see Entity_ConstValue
+void GraphEntity_GetProperties
+(
+	const GraphEntity *e,          // entity to retrieve properties from
+	const Attribute_ID *attr_ids,  // attributes to retrieve
+	int n,                         // number of attributes
+	SIValue *values                // [output] retrieved values
+);
+
+// returns the number of bytes used by the entity's properties block
+// and the heap allocations owned by its values
+size_t Entity_PropertiesMemoryUsage(const Entity *e);
+
 /* Updates existing attribute value, return true if property been updated. */
 bool GraphEntity_SetProperty(const GraphEntity *e, Attribute_ID attr_id, SIValue value);
 
@@ -24,6 +24,14 @@ typedef GrB_Index LabelID;
     .id = INVALID_ENTITY_ID,    \
 }
 
+// instantiate a node known only by its id
+// the node's entity is retrieved once its properties are accessed
+#define GE_LAZY_NODE(node_id)   \
+(Node) {                        \
+    .entity = NULL,             \
+    .id = (node_id),            \
+}
+
 // struct representing a node in the graph
 typedef struct {
 	Entity *entity;       // MUST be the first member of Node
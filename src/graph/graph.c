@@ -9,9 +9,11 @@
 #include "../util/arr.h"
 #include "../util/qsort.h"
 #include "../util/rmalloc.h"
+#include "../util/simple_timer.h"
 #include "../configuration/config.h"
 #include "../util/datablock/oo_datablock.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
+#include <math.h>
 
 //------------------------------------------------------------------------------
 // Forward declarations
@@ -56,13 +58,37 @@ static void _CreateRWLock
 
 // acquire a lock that does not restrict access from additional reader threads
 void Graph_AcquireReadLock(Graph *g) {
-	pthread_rwlock_rdlock(&g->_rwlock);
+	// only time acquisitions which have to wait
+	uint64_t wait_us = 0;
+	if(pthread_rwlock_tryrdlock(&g->_rwlock) != 0) {
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		pthread_rwlock_rdlock(&g->_rwlock);
+		wait_us = GraphLockStats_Elapsed(&start) + 1;
+	}
+	GraphLockStats_RecordAcquire(&g->lock_stats, GRAPH_LOCK_READ, wait_us);
 }
 
 // acquire a lock for exclusive access to this graph's data
 void Graph_AcquireWriteLock(Graph *g) {
-	pthread_rwlock_wrlock(&g->_rwlock);
+	// only time acquisitions which have to wait
+	uint64_t wait_us = 0;
+	if(pthread_rwlock_trywrlock(&g->_rwlock) != 0) {
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		pthread_rwlock_wrlock(&g->_rwlock);
+		wait_us = GraphLockStats_Elapsed(&start) + 1;
+	}
 	g->_writelocked = true;
+	GraphLockStats_RecordAcquire(&g->lock_stats, GRAPH_LOCK_WRITE, wait_us);
+}
+
+// try acquiring a lock for exclusive access to this graph's data
+bool Graph_TryAcquireWriteLock(Graph *g) {
+	if(pthread_rwlock_trywrlock(&g->_rwlock) != 0) return false;
+	g->_writelocked = true;
+	GraphLockStats_RecordAcquire(&g->lock_stats, GRAPH_LOCK_WRITE, 0);
+	return true;
 }
 
 // Release the held lock
@@ -77,10 +103,23 @@ void Graph_ReleaseLock
 	// for a reader thread to be considered as writer, performing illegal access to
 	// underline matrices, consider a context switch after unlocking `_rwlock` but
 	// before setting `_writelocked` to false
+	if(g->_writelocked) {
+		__atomic_store_n(&g->_write_epoch, g->_write_epoch + 1,
+				__ATOMIC_RELEASE);
+		GraphLockStats_RecordWriteRelease(&g->lock_stats);
+	}
 	g->_writelocked = false;
 	pthread_rwlock_unlock(&g->_rwlock);
 }
 
+uint64_t Graph_WriteEpoch
+(
+	const Graph *g
+) {
+	ASSERT(g != NULL);
+	return __atomic_load_n(&g->_write_epoch, __ATOMIC_ACQUIRE);
+}
+
 //------------------------------------------------------------------------------
 // Graph utility functions
 //------------------------------------------------------------------------------
@@ -117,11 +156,12 @@ static void _CollectEdgesFromEntry
 		array_append(*edges, e);
 	} else {
 		// multiple edges connecting src to dest,
-		// entry is a pointer to an array of edge IDs
-		EdgeID *edgeIds = (EdgeID *)(CLEAR_MSB(edgeId));
-		uint edgeCount = array_len(edgeIds);
+		// entry locates the edge IDs within the relation's multi-edge table
+		uint64_t edgeCount;
+		const EdgeID *edgeIds = RG_Matrix_multiEdgeIDs(g->relations[r],
+				edgeId, &edgeCount);
 
-		for(uint i = 0; i < edgeCount; i++) {
+		for(uint64_t i = 0; i < edgeCount; i++) {
 			edgeId = edgeIds[i];
 			e.entity = DataBlock_GetItem(g->edges, edgeId);
 			e.id = edgeId;
@@ -208,8 +248,10 @@ void _MatrixSynchronize
 	}
 
 	// flush pending changes if dirty
+	// merging them into the main matrix is deferred while pages are shared
 	if(RG_Matrix_isDirty(m)) {
-		info = RG_Matrix_wait(m, false);
+		info = g->_shared_pages ? RG_Matrix_waitDeltas(m) :
+			RG_Matrix_wait(m, false);
 		ASSERT(info == GrB_SUCCESS);
 	}
 
@@ -289,6 +331,16 @@ void Graph_SetMatrixPolicy
 	}
 }
 
+void Graph_SetSharedPages
+(
+	Graph *g,
+	bool shared
+) {
+	ASSERT(g != NULL);
+
+	g->_shared_pages = shared;
+}
+
 // synchronize and resize all matrices in graph
 void Graph_ApplyAllPending
 (
@@ -300,8 +352,11 @@ void Graph_ApplyAllPending
 	uint       n  =  0;
 	RG_Matrix  M  =  NULL;
 
-	M = Graph_GetAdjacencyMatrix(g, false);
-	RG_Matrix_wait(M, force_flush);
+	// a derived adjacency matrix holds no pending changes
+	if(!g->_derived_adjacency) {
+		M = Graph_GetAdjacencyMatrix(g, false);
+		RG_Matrix_wait(M, force_flush);
+	}
 
     M = Graph_GetNodeLabelMatrix(g);
     RG_Matrix_wait(M, force_flush);
@@ -368,6 +423,257 @@ bool Graph_Pending
 	return false;
 }
 
+static void _AccumulateMatrixStats
+(
+	const RG_Matrix M,
+	RG_MatrixStats *stats
+) {
+	RG_MatrixStats s = RG_Matrix_stats(M);
+	stats->flushes        += s.flushes;
+	stats->total_flush_us += s.total_flush_us;
+	stats->resizes        += s.resizes;
+	stats->last_flush_us  =  MAX(stats->last_flush_us, s.last_flush_us);
+}
+
+void Graph_MatrixStats
+(
+	const Graph *g,
+	RG_MatrixStats *stats
+) {
+	ASSERT(g     != NULL);
+	ASSERT(stats != NULL);
+
+	memset(stats, 0, sizeof(RG_MatrixStats));
+
+	_AccumulateMatrixStats(g->adjacency_matrix, stats);
+	_AccumulateMatrixStats(g->node_labels, stats);
+
+	uint n = array_len(g->labels);
+	for(uint i = 0; i < n; i++) _AccumulateMatrixStats(g->labels[i], stats);
+
+	n = array_len(g->relations);
+	for(uint i = 0; i < n; i++) _AccumulateMatrixStats(g->relations[i], stats);
+}
+
+// returns the i'th graph matrix, synchronized
+// NULL if 'i' is out of range
+static RG_Matrix _Graph_GetMatrix
+(
+	const Graph *g,
+	uint i
+) {
+	if(i == 0) return Graph_GetAdjacencyMatrix(g, false);
+	if(i == 1) return Graph_GetNodeLabelMatrix(g);
+	i -= 2;
+
+	uint n = array_len(g->labels);
+	if(i < n) return Graph_GetLabelMatrix(g, i);
+	i -= n;
+
+	n = array_len(g->relations);
+	if(i < n) return Graph_GetRelationMatrix(g, i, false);
+
+	return NULL;
+}
+
+uint Graph_CompactMatrices
+(
+	Graph *g,
+	uint64_t threshold
+) {
+	ASSERT(g != NULL);
+
+	uint compacted = 0;
+
+	Graph_AcquireReadLock(g);
+
+	// a graph which wasn't modified since the previous call is idle
+	// compact all of its pending changes
+	// '_compaction_epoch' is only accessed by the compacting thread
+	bool idle = (g->_write_epoch == g->_compaction_epoch);
+	g->_compaction_epoch = g->_write_epoch;
+	if(idle) threshold = 1;
+
+	// compact one matrix at a time, limiting memory overhead
+	for(uint i = 0;; i++) {
+		// only the default policy flushes matrices on access
+		if(Graph_GetMatrixPolicy(g) != SYNC_POLICY_FLUSH_RESIZE) break;
+
+		// merging into the main matrices is deferred while pages are shared
+		if(g->_shared_pages) break;
+
+		// retrieving the matrix flushes its pending GraphBLAS operations
+		RG_Matrix M = _Graph_GetMatrix(g, i);
+		if(M == NULL) break;
+
+		GrB_Index pending;
+		RG_Matrix_delta_nvals(&pending, M);
+		if(pending == 0 || pending < threshold) continue;
+
+		// compute the flushed matrix while readers are allowed in
+		GrB_Matrix A;
+		GrB_Matrix AT;
+		double tic[2];
+		uint64_t epoch = g->_write_epoch;
+		simple_tic(tic);
+		RG_Matrix_compact(&A, &AT, M);
+		uint64_t elapsed_us = simple_toc(tic) * 1000000;
+		Graph_ReleaseLock(g);
+
+		// swap in the flushed matrix unless a writer got in between
+		// or a reader built the matrix's transpose meanwhile
+		// the swap doesn't modify the graph's content
+		// as such the write epoch isn't advanced
+		pthread_rwlock_wrlock(&g->_rwlock);
+		bool transposed = RG_MATRIX_MAINTAIN_TRANSPOSE(M);
+		bool modified = (g->_write_epoch != epoch) ||
+			(transposed != (AT != NULL));
+		if(!modified) {
+			RG_Matrix_compact_apply(M, &A, &AT);
+			RG_Matrix_recordFlush(M, elapsed_us);
+			compacted++;
+		}
+		pthread_rwlock_unlock(&g->_rwlock);
+
+		GrB_Matrix_free(&A);
+		GrB_Matrix_free(&AT);
+
+		// graph is being modified, retry on the next call
+		if(modified) return compacted;
+
+		Graph_AcquireReadLock(g);
+	}
+
+	Graph_ReleaseLock(g);
+
+	return compacted;
+}
+
+uint Graph_DropIdleTransposes
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	if(!g->_adaptive_transpose) return 0;
+
+	bool idle = false;
+	uint dropped = 0;
+
+	// age usage counters, 'idle' is only accessed by the compacting thread
+	Graph_AcquireReadLock(g);
+	uint n = array_len(g->relations);
+	for(uint r = 0; r < n; r++) {
+		TransposeUsage *u = g->_transpose_usage + r;
+		uint64_t reads = __atomic_exchange_n(&u->reads, 0, __ATOMIC_RELAXED);
+		u->idle = (reads == 0) ? u->idle + 1 : 0;
+
+		RG_Matrix M = g->relations[r];
+		if(u->idle >= TRANSPOSE_IDLE_COMPACTIONS &&
+		   __atomic_load_n(&M->transposed, __ATOMIC_ACQUIRE) != NULL) {
+			idle = true;
+		}
+	}
+	Graph_ReleaseLock(g);
+
+	if(!idle) return 0;
+
+	// dropping a transpose doesn't modify the graph's content
+	// as such the write epoch isn't advanced
+	pthread_rwlock_wrlock(&g->_rwlock);
+	n = array_len(g->relations);
+	for(uint r = 0; r < n; r++) {
+		TransposeUsage *u = g->_transpose_usage + r;
+		RG_Matrix M = g->relations[r];
+
+		// skip relations traversed in reverse since usage was aged
+		if(u->idle < TRANSPOSE_IDLE_COMPACTIONS || u->reads > 0) continue;
+		if(!(RG_MATRIX_MAINTAIN_TRANSPOSE(M))) continue;
+
+		RG_Matrix_dropTranspose(M);
+		dropped++;
+	}
+	pthread_rwlock_unlock(&g->_rwlock);
+
+	return dropped;
+}
+
+// computes the degree summary of relation 'r'
+static void _Graph_SummarizeRelation
+(
+	Graph *g,
+	int r,
+	RelationSummary *summary
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Matrix A;
+	GrB_Vector v;
+	GrB_Index  nrows;
+
+	// export a flushed copy of the relation matrix
+	RG_Matrix M = Graph_GetRelationMatrix(g, r, false);
+	info = RG_Matrix_export(&A, M);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_nrows(&nrows, A);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_new(&v, GrB_BOOL, nrows);
+	ASSERT(info == GrB_SUCCESS);
+
+	// rows with at least a single entry are sources
+	info = GrB_Matrix_reduce_Monoid(v, NULL, NULL, GxB_ANY_BOOL_MONOID, A,
+			NULL);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_nvals(&summary->src_count, v);
+	ASSERT(info == GrB_SUCCESS);
+
+	// columns with at least a single entry are destinations
+	info = GrB_Matrix_reduce_Monoid(v, NULL, NULL, GxB_ANY_BOOL_MONOID, A,
+			GrB_DESC_RT0);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Vector_nvals(&summary->dest_count, v);
+	ASSERT(info == GrB_SUCCESS);
+
+	summary->edge_count = Graph_RelationEdgeCount(g, r);
+
+	GrB_Vector_free(&v);
+	GrB_Matrix_free(&A);
+}
+
+uint Graph_RefreshStatistics
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	uint refreshed = 0;
+
+	// summarize one relation at a time, writers get in between relations
+	for(uint r = 0;; r++) {
+		Graph_AcquireReadLock(g);
+
+		if(r >= array_len(g->relations)) {
+			Graph_ReleaseLock(g);
+			break;
+		}
+
+		// summaries are only written by the refreshing thread
+		// concurrent readers tolerate a partially updated summary
+		if(GraphStatistics_RelationSummaryStale(&g->stats, r)) {
+			RelationSummary summary;
+			_Graph_SummarizeRelation(g, r, &summary);
+			GraphStatistics_SetRelationSummary(&g->stats, r, &summary);
+			refreshed++;
+		}
+
+		Graph_ReleaseLock(g);
+	}
+
+	return refreshed;
+}
+
 //------------------------------------------------------------------------------
 // Graph API
 //------------------------------------------------------------------------------
@@ -378,7 +684,7 @@ Graph *Graph_New
 	size_t edge_cap
 ) {
 	node_cap = MAX(node_cap, GRAPH_DEFAULT_NODE_CAP);
-	edge_cap = MAX(node_cap, GRAPH_DEFAULT_EDGE_CAP);
+	edge_cap = MAX(edge_cap, GRAPH_DEFAULT_EDGE_CAP);
 
 	Graph *g = rm_calloc(1, sizeof(Graph));
 
@@ -392,15 +698,30 @@ Graph *Graph_New
 
 	GrB_Index n = Graph_RequiredMatrixDim(g);
 	RG_Matrix_new(&g->node_labels, GrB_BOOL, n, n);
+	RG_Matrix_setHypersparse(g->node_labels);
 	RG_Matrix_new(&g->adjacency_matrix, GrB_BOOL, n, n);
 	RG_Matrix_new(&g->adjacency_matrix->transposed, GrB_BOOL, n, n);
 	RG_Matrix_new(&g->_zero_matrix, GrB_BOOL, n, n);
 
+	// the adjacency matrix is either maintained on every edge update or
+	// derived from the relation matrices when an untyped traversal needs it
+	Config_Option_get(Config_DERIVED_ADJACENCY, &g->_derived_adjacency);
+	g->_adjacency_stale = false;
+
+	// relation matrices either maintain their transpose at all times or
+	// only while reverse traversals make use of it
+	Config_Option_get(Config_ADAPTIVE_TRANSPOSE, &g->_adaptive_transpose);
+	g->_transpose_usage = array_new(TransposeUsage,
+			GRAPH_DEFAULT_RELATION_TYPE_CAP);
+
 	// init graph statistics
 	GraphStatistics_init(&g->stats);
 
+	g->adjacency_cache = AdjacencyCache_New();
+
 	// initialize a read-write lock scoped to the individual graph
 	_CreateRWLock(g);
+	GraphLockStats_Init(&g->lock_stats);
 	g->_writelocked = false;
 
 	// force GraphBLAS updates and resize matrices to node count by default
@@ -411,8 +732,15 @@ Graph *Graph_New
 
 // All graph matrices are required to be squared NXN
 // where N = Graph_RequiredMatrixDim.
+// the node capacity grows by a datablock at a time, sizing matrices to it
+// would resize every matrix (and its transpose and deltas) each time
+// instead matrices are sized to the next power of two at least as large
+// such that growing the graph to N nodes resizes them O(log N) times
 inline size_t Graph_RequiredMatrixDim(const Graph *g) {
-	return _Graph_NodeCap(g);
+	size_t cap = _Graph_NodeCap(g);
+	size_t dim = DATABLOCK_MIN_BLOCK_CAP;
+	while(dim < cap) dim <<= 1;
+	return dim;
 }
 
 size_t Graph_NodeCount(const Graph *g) {
@@ -469,6 +797,25 @@ void Graph_AllocateEdges(Graph *g, size_t n) {
 	DataBlock_Accommodate(g->edges, n);
 }
 
+void Graph_PrefetchNode
+(
+	const Graph *g,
+	NodeID id
+) {
+	ASSERT(g);
+	DataBlock_Prefetch(g->nodes, id);
+}
+
+void Graph_PrefetchNodeProperties
+(
+	const Graph *g,
+	NodeID id
+) {
+	ASSERT(g);
+	const Entity *e = DataBlock_PeekItem(g->nodes, id);
+	if(e != NULL) Entity_PrefetchProperties(e);
+}
+
 int Graph_GetNode
 (
 	const Graph *g,
@@ -530,9 +877,10 @@ int Graph_GetEdgeRelation
 		} else {
 			// multiple edges exists between src and dest
 			// see if given edge is one of them
-			EdgeID *edges = (EdgeID *)(CLEAR_MSB(edgeId));
-			int edge_count = array_len(edges);
-			for(int j = 0; j < edge_count; j++) {
+			uint64_t edge_count;
+			const EdgeID *edges = RG_Matrix_multiEdgeIDs(M, edgeId,
+					&edge_count);
+			for(uint64_t j = 0; j < edge_count; j++) {
 				if(edges[j] == id) {
 					Edge_SetRelationID(e, i);
 					rel = i;
@@ -631,12 +979,89 @@ void Graph_CreateNode
 
 	n->id           =  id;
 	n->entity       =  en;
-	en->prop_count  =  0;
 	en->properties  =  NULL;
 
 	if(label_count > 0) _Graph_LabelNode(g, n->id, labels, label_count);
 }
 
+void Graph_CreateNodes
+(
+	Graph *g,
+	int *labels,
+	uint label_count,
+	Node *nodes,
+	uint n
+) {
+	ASSERT(g);
+	ASSERT(n == 0 || nodes != NULL);
+	ASSERT(label_count == 0 || (label_count > 0 && labels != NULL));
+
+	if(n == 0) return;
+
+	GrB_Info info;
+	UNUSED(info);
+	GrB_Index *ids = rm_malloc(sizeof(GrB_Index) * n);
+
+	for(uint i = 0; i < n; i++) {
+		NodeID id;
+		Node *node = nodes + i;
+		Entity *en = DataBlock_AllocateItem(g->nodes, &id);
+
+		node->id        =  id;
+		node->entity    =  en;
+		en->properties  =  NULL;
+		ids[i]          =  id;
+	}
+
+	if(label_count > 0) {
+		GrB_Index *cols = rm_malloc(sizeof(GrB_Index) * n);
+		RG_Matrix nl = Graph_GetNodeLabelMatrix(g);
+
+		for(uint i = 0; i < label_count; i++) {
+			int l = labels[i];
+			// set matrix at positions [id, id]
+			RG_Matrix m = Graph_GetLabelMatrix(g, l);
+			info = RG_Matrix_setElements_BOOL(m, ids, ids, n);
+			ASSERT(info == GrB_SUCCESS);
+
+			// map this label in each node's set of labels
+			for(uint j = 0; j < n; j++) cols[j] = l;
+			info = RG_Matrix_setElements_BOOL(nl, ids, cols, n);
+			ASSERT(info == GrB_SUCCESS);
+
+			GraphStatistics_IncNodeCount(&g->stats, l, n);
+		}
+
+		rm_free(cols);
+	}
+
+	rm_free(ids);
+}
+
+bool Graph_CreateNodeWithID
+(
+	Graph *g,
+	NodeID id,
+	Node *n,
+	int *labels,
+	uint label_count
+) {
+	ASSERT(g);
+	ASSERT(n);
+	ASSERT(label_count == 0 || (label_count > 0 && labels != NULL));
+
+	Entity *en = DataBlock_AllocateItemAt(g->nodes, id);
+	if(en == NULL) return false;
+
+	n->id           =  id;
+	n->entity       =  en;
+	en->properties  =  NULL;
+
+	if(label_count > 0) _Graph_LabelNode(g, n->id, labels, label_count);
+
+	return true;
+}
+
 void Graph_FormConnection
 (
 	Graph *g,
@@ -650,11 +1075,13 @@ void Graph_FormConnection
 	GrB_Info info;
 	UNUSED(info);
 	RG_Matrix  M    =  Graph_GetRelationMatrix(g, r, false);
-	RG_Matrix  adj  =  Graph_GetAdjacencyMatrix(g, false);
+	RG_Matrix  adj  =  Graph_GetAdjacencyMatrixForUpdate(g);
 
 	// rows represent source nodes, columns represent destination nodes
-	info = RG_Matrix_setElement_BOOL(adj, src, dest);
-	ASSERT(info == GrB_SUCCESS);
+	if(adj != NULL) {
+		info = RG_Matrix_setElement_BOOL(adj, src, dest);
+		ASSERT(info == GrB_SUCCESS);
+	}
 
 	info = RG_Matrix_setElement_UINT64(M, edge_id, src, dest);
 	ASSERT(info == GrB_SUCCESS);
@@ -689,41 +1116,113 @@ void Graph_CreateEdge
 	e->srcNodeID    =  src;
 	e->destNodeID   =  dest;
 	e->relationID   =  r;
-	en->prop_count  =  0;
 	en->properties  =  NULL;
 
 	Graph_FormConnection(g, src, dest, id, r);
 }
 
-// retrieves all either incoming or outgoing edges
-// to/from given node N, depending on given direction
-void Graph_GetNodeEdges
+bool Graph_CreateEdgeWithID
+(
+	Graph *g,
+	EdgeID id,
+	NodeID src,
+	NodeID dest,
+	int r,
+	Edge *e
+) {
+	ASSERT(g);
+	ASSERT(r < Graph_RelationTypeCount(g));
+
+	Entity *en = DataBlock_AllocateItemAt(g->edges, id);
+	if(en == NULL) return false;
+
+	e->id           =  id;
+	e->entity       =  en;
+	e->srcNodeID    =  src;
+	e->destNodeID   =  dest;
+	e->relationID   =  r;
+	en->properties  =  NULL;
+
+	Graph_FormConnection(g, src, dest, id, r);
+
+	return true;
+}
+
+void Graph_CreateEdges
+(
+	Graph *g,
+	int r,
+	NodeID *src,
+	NodeID *dest,
+	Edge **edges,
+	uint n
+) {
+	ASSERT(g);
+	ASSERT(r < Graph_RelationTypeCount(g));
+	ASSERT(n == 0 || (src != NULL && dest != NULL && edges != NULL));
+
+	if(n == 0) return;
+
+	GrB_Info info;
+	UNUSED(info);
+	EdgeID *ids = rm_malloc(sizeof(EdgeID) * n);
+
+	for(uint i = 0; i < n; i++) {
+		EdgeID id;
+		Edge *e = edges[i];
+		Entity *en = DataBlock_AllocateItem(g->edges, &id);
+
+		e->id           =  id;
+		e->entity       =  en;
+		e->srcNodeID    =  src[i];
+		e->destNodeID   =  dest[i];
+		e->relationID   =  r;
+		en->properties  =  NULL;
+		ids[i]          =  id;
+	}
+
+	RG_Matrix  M    =  Graph_GetRelationMatrix(g, r, false);
+	RG_Matrix  adj  =  Graph_GetAdjacencyMatrixForUpdate(g);
+
+	// rows represent source nodes, columns represent destination nodes
+	if(adj != NULL) {
+		info = RG_Matrix_setElements_BOOL(adj, src, dest, n);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	info = RG_Matrix_setElements_UINT64(M, ids, src, dest, n);
+	ASSERT(info == GrB_SUCCESS);
+
+	GraphStatistics_IncEdgeCount(&g->stats, r, n);
+
+	rm_free(ids);
+}
+
+// collects either the outgoing or the incoming edges of node 'srcID'
+static void _Graph_CollectNodeEdges
 (
 	const Graph *g,      // graph to collect edges from
-	const Node *n,       // either source or destination node
-	GRAPH_EDGE_DIR dir,  // edge direction ->, <-, <->
+	NodeID srcID,        // either source or destination node
+	bool outgoing,       // collect outgoing edges, incoming otherwise
 	int edgeType,        // relationship type
 	Edge **edges         // [output] array of edges
 ) {
-	ASSERT(g);
-	ASSERT(n);
-	ASSERT(edges);
-
 	RG_MatrixTupleIter   it;
 	RG_Matrix            M        =  NULL;
 	RG_Matrix            TM       =  NULL;
-	NodeID               srcID    =  ENTITY_GET_ID(n);
 	NodeID               destID   =  INVALID_ENTITY_ID;
 	EdgeID               edgeID   =  INVALID_ENTITY_ID;
 	bool                 depleted =  false;
 
-	if(edgeType == GRAPH_UNKNOWN_RELATION) return;
-
-	bool outgoing = (dir == GRAPH_EDGE_DIR_OUTGOING ||
-					 dir == GRAPH_EDGE_DIR_BOTH);
-
-	bool incoming = (dir == GRAPH_EDGE_DIR_INCOMING ||
-					 dir == GRAPH_EDGE_DIR_BOTH);
+	// a derived adjacency matrix is recomputed whenever edges change
+	// rather than recomputing it, collect from each relation matrix
+	if(edgeType == GRAPH_NO_RELATION && g->_derived_adjacency) {
+		int relation_count = Graph_RelationTypeCount(g);
+		for(int r = 0; r < relation_count; r++) {
+			_Graph_CollectNodeEdges(g, srcID, outgoing, r, edges);
+		}
+		return;
+	}
 
 	// if a relationship type is specified,
 	// retrieve the appropriate relation matrix
@@ -745,9 +1244,7 @@ void Graph_GetNodeEdges
 				Graph_GetEdgesConnectingNodes(g, srcID, destID, edgeType, edges);
 			}
 		}
-	}
-
-	if(incoming) {
+	} else {
 		// if a relationship type is specified, retrieve the appropriate
 		// transposed relation matrix,
 		// otherwise use the transposed adjacency matrix
@@ -771,6 +1268,67 @@ void Graph_GetNodeEdges
 	}
 }
 
+// collects either the outgoing or the incoming edges of node 'srcID'
+// consulting the adjacency cache first, high degree nodes are cached
+static void _Graph_GetNodeEdges
+(
+	const Graph *g,      // graph to collect edges from
+	NodeID srcID,        // either source or destination node
+	bool outgoing,       // collect outgoing edges, incoming otherwise
+	int edgeType,        // relationship type
+	Edge **edges         // [output] array of edges
+) {
+	// the cache reflects the graph as of the last released write lock
+	// bypass it while the graph is being modified
+	if(g->_writelocked) {
+		_Graph_CollectNodeEdges(g, srcID, outgoing, edgeType, edges);
+		return;
+	}
+
+	AdjacencyCache *cache = g->adjacency_cache;
+	uint64_t epoch = Graph_WriteEpoch(g);
+	if(AdjacencyCache_Get(cache, epoch, srcID, edgeType, outgoing, edges)) {
+		return;
+	}
+
+	uint offset = array_len(*edges);
+	_Graph_CollectNodeEdges(g, srcID, outgoing, edgeType, edges);
+
+	uint count = array_len(*edges) - offset;
+	if(count >= ADJACENCY_CACHE_MIN_DEGREE) {
+		AdjacencyCache_Set(cache, epoch, srcID, edgeType, outgoing,
+				*edges + offset, count);
+	}
+}
+
+// retrieves all either incoming or outgoing edges
+// to/from given node N, depending on given direction
+void Graph_GetNodeEdges
+(
+	const Graph *g,      // graph to collect edges from
+	const Node *n,       // either source or destination node
+	GRAPH_EDGE_DIR dir,  // edge direction ->, <-, <->
+	int edgeType,        // relationship type
+	Edge **edges         // [output] array of edges
+) {
+	ASSERT(g);
+	ASSERT(n);
+	ASSERT(edges);
+
+	NodeID srcID = ENTITY_GET_ID(n);
+
+	if(edgeType == GRAPH_UNKNOWN_RELATION) return;
+
+	bool outgoing = (dir == GRAPH_EDGE_DIR_OUTGOING ||
+					 dir == GRAPH_EDGE_DIR_BOTH);
+
+	bool incoming = (dir == GRAPH_EDGE_DIR_INCOMING ||
+					 dir == GRAPH_EDGE_DIR_BOTH);
+
+	if(outgoing) _Graph_GetNodeEdges(g, srcID, true, edgeType, edges);
+	if(incoming) _Graph_GetNodeEdges(g, srcID, false, edgeType, edges);
+}
+
 // populate array of node's label IDs, return number of labels on node
 uint Graph_GetNodeLabels
 (
@@ -842,7 +1400,8 @@ int Graph_DeleteEdge
 	info = RG_Matrix_removeEntry(R, src_id, dest_id, ENTITY_GET_ID(e));
 	ASSERT(info == GrB_SUCCESS);
 
-	if(SINGLE_EDGE(edge_id)) {
+	RG_Matrix adj = Graph_GetAdjacencyMatrixForUpdate(g);
+	if(SINGLE_EDGE(edge_id) && adj != NULL) {
 		// see if source is connected to destination with additional edges
 		bool connected = false;
 		int relationCount = Graph_RelationTypeCount(g);
@@ -859,8 +1418,7 @@ int Graph_DeleteEdge
 		// there are no additional edges connecting source to destination
 		// remove edge from THE adjacency matrix
 		if(!connected) {
-			M = Graph_GetAdjacencyMatrix(g, false);
-			info = RG_Matrix_removeElement_BOOL(M, src_id, dest_id);
+			info = RG_Matrix_removeElement_BOOL(adj, src_id, dest_id);
 			ASSERT(info == GrB_SUCCESS);
 		}
 	}
@@ -900,12 +1458,147 @@ void Graph_DeleteNode
 	DataBlock_DeleteItem(g->nodes, ENTITY_GET_ID(n));
 }
 
-static void _Graph_FreeRelationMatrices
+// returns true if sorted array 'ids' contains 'id'
+static bool _SortedContains
 (
-	const Graph *g
+	const GrB_Index *ids,
+	GrB_Index n,
+	GrB_Index id
+) {
+	GrB_Index lo = 0;
+	GrB_Index hi = n;
+	while(lo < hi) {
+		GrB_Index mid = lo + (hi - lo) / 2;
+		if(ids[mid] == id) return true;
+		if(ids[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return false;
+}
+
+// collect edges of relation 'r' stored within rows 'rows' of 'P'
+// 'P' is either the M or delta-plus matrix of 'R' or of its transpose
+// entries marked for deletion in 'DM' are skipped
+// when 'transposed' is set rows are destination nodes, in which case
+// edges whose source is also within 'rows' are skipped, as these
+// are collected as outgoing edges of their source
+static void _CollectRowEdges
+(
+	const Graph *g,
+	int r,
+	RG_Matrix R,
+	GrB_Matrix P,
+	GrB_Matrix DM,
+	bool transposed,
+	const GrB_Index *rows,
+	GrB_Index nrows,
+	Edge **edges
+) {
+	GrB_Info   info;
+	GrB_Matrix X;
+	GrB_Index  ncols;
+	GrB_Index  nvals;
+	GrB_Index  dm_nvals;
+	UNUSED(info);
+
+	info = GrB_Matrix_ncols(&ncols, P);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(&dm_nvals, DM);
+	ASSERT(info == GrB_SUCCESS);
+
+	// X = P(rows, :)
+	GrB_Type t = (transposed) ? GrB_BOOL : GrB_UINT64;
+	info = GrB_Matrix_new(&X, t, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_extract(X, NULL, NULL, P, rows, nrows, GrB_ALL, ncols,
+			NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_nvals(&nvals, X);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(nvals > 0) {
+		GrB_Index *I = rm_malloc(sizeof(GrB_Index) * nvals);
+		GrB_Index *J = rm_malloc(sizeof(GrB_Index) * nvals);
+		uint64_t  *V = (transposed) ? NULL : rm_malloc(sizeof(uint64_t) * nvals);
+
+		if(transposed) {
+			info = GrB_Matrix_extractTuples_BOOL(I, J, NULL, &nvals, X);
+		} else {
+			info = GrB_Matrix_extractTuples_UINT64(I, J, V, &nvals, X);
+		}
+		ASSERT(info == GrB_SUCCESS);
+
+		for(GrB_Index k = 0; k < nvals; k++) {
+			bool      deleted;
+			uint64_t  edge_id;
+			GrB_Index row = rows[I[k]];
+			GrB_Index col = J[k];
+
+			if(dm_nvals > 0 &&
+			   GrB_Matrix_extractElement_BOOL(&deleted, DM, row, col) == GrB_SUCCESS) {
+				continue;
+			}
+
+			NodeID src  = (transposed) ? col : row;
+			NodeID dest = (transposed) ? row : col;
+
+			if(transposed) {
+				if(_SortedContains(rows, nrows, src)) continue;
+				info = RG_Matrix_extractElement_UINT64(&edge_id, R, src, dest);
+				ASSERT(info == GrB_SUCCESS);
+			} else {
+				edge_id = V[k];
+			}
+
+			_CollectEdgesFromEntry(g, src, dest, r, edge_id, edges);
+		}
+
+		rm_free(I);
+		rm_free(J);
+		if(V != NULL) rm_free(V);
+	}
+
+	GrB_free(&X);
+}
+
+// collect all edges incident to 'nodes'
+// rather than traversing each node's rows, the rows of all nodes are
+// extracted at once from every relationship matrix and its transpose
+// 'nodes' must be sorted by ID and distinct
+static void _CollectIncidentEdges
+(
+	const Graph *g,
+	const Node *nodes,
+	uint node_count,
+	Edge **edges
 ) {
-	uint relationCount = Graph_RelationTypeCount(g);
-	for(uint i = 0; i < relationCount; i++) RG_Matrix_free(&g->relations[i]);
+	GrB_Index *rows = rm_malloc(sizeof(GrB_Index) * node_count);
+	for(uint i = 0; i < node_count; i++) rows[i] = ENTITY_GET_ID(nodes + i);
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) {
+		RG_Matrix R  = Graph_GetRelationMatrix(g, r, false);
+		RG_Matrix TR = Graph_GetRelationMatrix(g, r, true);
+
+		// delta-plus is read directly, build logged additions into it
+		RG_Matrix_flushDeltaLog(R);
+		RG_Matrix_flushDeltaLog(TR);
+
+		// outgoing edges
+		_CollectRowEdges(g, r, R, RG_MATRIX_M(R), RG_MATRIX_DELTA_MINUS(R),
+				false, rows, node_count, edges);
+		_CollectRowEdges(g, r, R, RG_MATRIX_DELTA_PLUS(R),
+				RG_MATRIX_DELTA_MINUS(R), false, rows, node_count, edges);
+
+		// incoming edges
+		_CollectRowEdges(g, r, R, RG_MATRIX_M(TR), RG_MATRIX_DELTA_MINUS(TR),
+				true, rows, node_count, edges);
+		_CollectRowEdges(g, r, R, RG_MATRIX_DELTA_PLUS(TR),
+				RG_MATRIX_DELTA_MINUS(TR), true, rows, node_count, edges);
+	}
+
+	rm_free(rows);
 }
 
 static void _BulkDeleteNodes
@@ -921,8 +1614,8 @@ static void _BulkDeleteNodes
 	ASSERT(g->_writelocked);
 	ASSERT(node_count > 0);
 
-	RG_Matrix adj; // adjacency matrix
-	adj = Graph_GetAdjacencyMatrix(g, false);
+	RG_Matrix adj; // adjacency matrix, NULL if derived
+	adj = Graph_GetAdjacencyMatrixForUpdate(g);
 
 	Node *distinct_nodes = array_new(Node, 1);
 	Edge *edges = array_new(Edge, 1);
@@ -943,14 +1636,17 @@ static void _BulkDeleteNodes
 	// collect edges to delete
 	//--------------------------------------------------------------------------
 
-	for(uint i = 0; i < node_count; i++) {
-		Node *n = distinct_nodes + i;
-		GrB_Index src;
-		GrB_Index dest;
-		NodeID ID = ENTITY_GET_ID(n);
+	if(node_count < NODE_BULK_DELETE_THRESHOLD) {
+		for(uint i = 0; i < node_count; i++) {
+			Node *n = distinct_nodes + i;
 
-		// collect edges
-		Graph_GetNodeEdges(g, n, GRAPH_EDGE_DIR_BOTH, GRAPH_NO_RELATION, &edges);
+			// collect edges
+			Graph_GetNodeEdges(g, n, GRAPH_EDGE_DIR_BOTH, GRAPH_NO_RELATION,
+					&edges);
+		}
+	} else {
+		// distinct nodes are sorted by ID
+		_CollectIncidentEdges(g, distinct_nodes, node_count, &edges);
 	}
 
 	//--------------------------------------------------------------------------
@@ -978,7 +1674,7 @@ static void _BulkDeleteNodes
 		EdgeID     edge_id  =  ENTITY_GET_ID(e);
 		RG_Matrix  R        =  Graph_GetRelationMatrix(g, e->relationID, false);
 
-		RG_Matrix_removeElement_BOOL(adj, src, dest);
+		if(adj != NULL) RG_Matrix_removeElement_BOOL(adj, src, dest);
 		RG_Matrix_removeElement_UINT64(R, src, dest);
 		DataBlock_DeleteItem(g->edges, edge_id);
 		edge_deletion_count[e->relationID]++;
@@ -1033,7 +1729,7 @@ static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 
 	int        relationCount  =  Graph_RelationTypeCount(g);
 	GrB_Index  n              =  Graph_RequiredMatrixDim(g);
-	RG_Matrix  adj            =  Graph_GetAdjacencyMatrix(g,  false);
+	RG_Matrix  adj            =  Graph_GetAdjacencyMatrixForUpdate(g);
 
 	for(int i = 0; i < edge_count; i++) {
 		Edge       *e       =  edges + i;
@@ -1051,6 +1747,9 @@ static void _BulkDeleteEdges(Graph *g, Edge *edges, size_t edge_count) {
 		// free and remove edges from datablock
 		DataBlock_DeleteItem(g->edges, edge_id);
 
+		// a derived adjacency matrix is recomputed on its next read
+		if(adj == NULL) continue;
+
 		int j = 0;
 		for(; j < relationCount; j++) {
 			GrB_Index e;
@@ -1121,6 +1820,16 @@ void Graph_BulkDelete(Graph *g, Node *nodes, uint node_count, Edge *edges, uint
 	if(edge_deleted != NULL) *edge_deleted = _edge_deleted;
 }
 
+void Graph_ReleaseDeletedBlocks
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	DataBlock_Trim(g->nodes);
+	DataBlock_Trim(g->edges);
+}
+
 DataBlockIterator *Graph_ScanNodes(const Graph *g) {
 	ASSERT(g);
 	return DataBlock_Scan(g->nodes);
@@ -1141,6 +1850,9 @@ int Graph_AddLabel
 	GrB_Info info;
 	size_t n = Graph_RequiredMatrixDim(g);
 	RG_Matrix_new(&m, GrB_BOOL, n, n);
+	// labels commonly cover a small subset of the graph's nodes
+	// let sparse labels be stored by their populated rows only
+	RG_Matrix_setHypersparse(m);
 
 	array_append(g->labels, m);
 
@@ -1162,8 +1874,14 @@ int Graph_AddRelationType
 
 	RG_Matrix_new(&m, GrB_UINT64, n, n);
 
+	// the transpose is built by the first reverse traversal
+	if(g->_adaptive_transpose) RG_Matrix_dropTranspose(m);
+
 	array_append(g->relations, m);
 
+	TransposeUsage usage = {0};
+	array_append(g->_transpose_usage, usage);
+
 	// adding a new relationship type, update the stats structures to support it
 	GraphStatistics_IntroduceRelationship(&g->stats);
 
@@ -1187,6 +1905,91 @@ RG_Matrix Graph_GetLabelMatrix
 	return m;
 }
 
+// recomputes a stale derived adjacency matrix
+// as the union of all relation matrices
+// concurrent readers race to recompute, the matrix lock admits a single one
+static void _Graph_DeriveAdjacencyMatrix
+(
+	const Graph *g
+) {
+	ASSERT(g->_derived_adjacency);
+
+	if(!__atomic_load_n(&g->_adjacency_stale, __ATOMIC_ACQUIRE)) return;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	RG_Matrix adj = g->adjacency_matrix;
+
+	// resize before locking, synchronization acquires the matrix lock
+	g->SynchronizeMatrix(g, adj);
+
+	RG_Matrix_Lock(adj);
+
+	if(__atomic_load_n(&g->_adjacency_stale, __ATOMIC_ACQUIRE)) {
+		GrB_Index  nrows;
+		GrB_Index  ncols;
+		GrB_Matrix A   =  RG_MATRIX_M(adj);
+		GrB_Matrix AT  =  RG_MATRIX_TM(adj);
+
+		info = GrB_Matrix_nrows(&nrows, A);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_ncols(&ncols, A);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = GrB_Matrix_clear(A);
+		ASSERT(info == GrB_SUCCESS);
+
+		int relation_count = Graph_RelationTypeCount(g);
+		for(int r = 0; r < relation_count; r++) {
+			// relation matrix including its pending changes
+			GrB_Matrix R;
+			info = RG_Matrix_export(&R, Graph_GetRelationMatrix(g, r, false));
+			ASSERT(info == GrB_SUCCESS);
+
+			// relation matrices aren't resized under the NOP sync policy
+			info = GrB_Matrix_resize(R, nrows, ncols);
+			ASSERT(info == GrB_SUCCESS);
+
+			info = GrB_eWiseAdd(A, NULL, NULL, GxB_ANY_PAIR_BOOL, A, R, NULL);
+			ASSERT(info == GrB_SUCCESS);
+
+			GrB_Matrix_free(&R);
+		}
+
+		info = GrB_transpose(AT, NULL, NULL, A, NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		__atomic_store_n(&((Graph *)g)->_adjacency_stale, false,
+				__ATOMIC_RELEASE);
+	}
+
+	RG_Matrix_Unlock(adj);
+}
+
+// records a reverse traversal of relation 'r'
+// building the relation's transpose if it isn't maintained
+static void _Graph_RequireTranspose
+(
+	const Graph *g,
+	int r
+) {
+	ASSERT(g->_adaptive_transpose);
+
+	RG_Matrix M = g->relations[r];
+	__atomic_fetch_add(&g->_transpose_usage[r].reads, 1, __ATOMIC_RELAXED);
+
+	if(__atomic_load_n(&M->transposed, __ATOMIC_ACQUIRE) != NULL) return;
+
+	// concurrent readers might require the transpose as well
+	// the first to acquire the matrix's lock builds it
+	RG_Matrix_Lock(M);
+	GrB_Info info = RG_Matrix_buildTranspose(M);
+	ASSERT(info == GrB_SUCCESS);
+	UNUSED(info);
+	RG_Matrix_Unlock(M);
+}
+
 RG_Matrix Graph_GetRelationMatrix
 (
 	const Graph *g,
@@ -1199,12 +2002,21 @@ RG_Matrix Graph_GetRelationMatrix
 
 	RG_Matrix m = GrB_NULL;
 
-	if(relation_idx == GRAPH_NO_RELATION) m = g->adjacency_matrix;
-	else m = g->relations[relation_idx];
+	if(relation_idx == GRAPH_NO_RELATION) {
+		m = g->adjacency_matrix;
+		if(g->_derived_adjacency) _Graph_DeriveAdjacencyMatrix(g);
+	} else {
+		m = g->relations[relation_idx];
+	}
 
 	g->SynchronizeMatrix(g, m);
 
-	if(transposed) m = RG_Matrix_getTranspose(m);
+	if(transposed) {
+		if(relation_idx != GRAPH_NO_RELATION && g->_adaptive_transpose) {
+			_Graph_RequireTranspose(g, relation_idx);
+		}
+		m = RG_Matrix_getTranspose(m);
+	}
 
 	return m;
 }
@@ -1217,6 +2029,20 @@ RG_Matrix Graph_GetAdjacencyMatrix
 	return Graph_GetRelationMatrix(g, GRAPH_NO_RELATION, transposed);
 }
 
+RG_Matrix Graph_GetAdjacencyMatrixForUpdate
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	if(g->_derived_adjacency) {
+		__atomic_store_n(&g->_adjacency_stale, true, __ATOMIC_RELEASE);
+		return NULL;
+	}
+
+	return Graph_GetAdjacencyMatrix(g, false);
+}
+
 // returns true if relationship matrix 'r' contains multi-edge entries,
 // false otherwise
 bool Graph_RelationshipContainsMultiEdge
@@ -1261,37 +2087,61 @@ RG_Matrix Graph_GetZeroMatrix
 	return z;
 }
 
-void Graph_Free(Graph *g) {
-	ASSERT(g);
-	// free matrices
-	Entity *en;
-	DataBlockIterator *it;
-	RG_Matrix_free(&g->_zero_matrix);
-	RG_Matrix_free(&g->adjacency_matrix);
+// frees a single matrix or datablock block of 'g'
+// returns false once there's nothing left to release
+static bool _Graph_FreeNext
+(
+	Graph *g
+) {
+	uint n = array_len(g->relations);
+	if(n > 0) {
+		RG_Matrix_free(&g->relations[n - 1]);
+		array_pop(g->relations);
+		return true;
+	}
 
-	_Graph_FreeRelationMatrices(g);
-	array_free(g->relations);
-	GraphStatistics_FreeInternals(&g->stats);
+	n = array_len(g->labels);
+	if(n > 0) {
+		RG_Matrix_free(&g->labels[n - 1]);
+		array_pop(g->labels);
+		return true;
+	}
 
-	uint32_t labelCount = array_len(g->labels);
-	for(int i = 0; i < labelCount; i++) RG_Matrix_free(&g->labels[i]);
-	array_free(g->labels);
-	RG_Matrix_free(&g->node_labels);
-
-	// TODO: disable datablock deleted items array
-	// there's no need to keep track after deleted items as the graph
-	// is being removed we won't be reusing items
-	it = Graph_ScanNodes(g);
-	while((en = (Entity *)DataBlockIterator_Next(it, NULL)) != NULL) {
-		FreeEntity(en);
+	RG_Matrix *matrices[3] = {&g->_zero_matrix, &g->adjacency_matrix,
+		&g->node_labels};
+	for(int i = 0; i < 3; i++) {
+		if(*matrices[i] != NULL) {
+			RG_Matrix_free(matrices[i]);
+			return true;
+		}
 	}
-	DataBlockIterator_Free(it);
 
-	it = Graph_ScanEdges(g);
-	while((en = DataBlockIterator_Next(it, NULL)) != NULL) FreeEntity(en);
-	DataBlockIterator_Free(it);
+	// entities release their attributes along with their block
+	if(DataBlock_ReleaseBlocks(g->edges, 1) > 0) return true;
+	if(DataBlock_ReleaseBlocks(g->nodes, 1) > 0) return true;
+
+	return false;
+}
+
+bool Graph_FreeSlice
+(
+	Graph *g,
+	double budget
+) {
+	ASSERT(g != NULL);
+
+	double tic[2];
+	simple_tic(tic);
+	while(_Graph_FreeNext(g)) {
+		if(simple_toc(tic) * 1000 >= budget) return false;
+	}
+
+	array_free(g->relations);
+	array_free(g->_transpose_usage);
+	array_free(g->labels);
+	GraphStatistics_FreeInternals(&g->stats);
+	AdjacencyCache_Free(g->adjacency_cache);
 
-	// free blocks
 	DataBlock_Free(g->nodes);
 	DataBlock_Free(g->edges);
 
@@ -1301,7 +2151,16 @@ void Graph_Free(Graph *g) {
 	if(g->_writelocked) Graph_ReleaseLock(g);
 	res = pthread_rwlock_destroy(&g->_rwlock);
 	ASSERT(res == 0);
+	GraphLockStats_FreeInternals(&g->lock_stats);
 
 	rm_free(g);
+	return true;
+}
+
+void Graph_Free(Graph *g) {
+	ASSERT(g);
+	bool freed = Graph_FreeSlice(g, INFINITY);
+	ASSERT(freed);
+	UNUSED(freed);
 }
 
@@ -12,14 +12,16 @@
 #include "entities/node.h"
 #include "entities/edge.h"
 #include "../redismodule.h"
+#include "adjacency_cache.h"
 #include "graph_statistics.h"
+#include "graph_lock_stats.h"
 #include "rg_matrix/rg_matrix.h"
 #include "../util/datablock/datablock.h"
 #include "../util/datablock/datablock_iterator.h"
 #include "../../deps/GraphBLAS/Include/GraphBLAS.h"
 
-#define GRAPH_DEFAULT_NODE_CAP 16384            // Default number of nodes a graph can hold before resizing.
-#define GRAPH_DEFAULT_EDGE_CAP 16384            // Default number of edges a graph can hold before resizing.
+#define GRAPH_DEFAULT_NODE_CAP 64               // Default number of nodes a graph can hold before resizing.
+#define GRAPH_DEFAULT_EDGE_CAP 64               // Default number of edges a graph can hold before resizing.
 #define GRAPH_DEFAULT_RELATION_TYPE_CAP 16      // Default number of different relationship types a graph can hold before resizing.
 #define GRAPH_DEFAULT_LABEL_CAP 16              // Default number of different labels a graph can hold before resizing.
 #define GRAPH_NO_LABEL -1                       // Labels are numbered [0-N], -1 represents no label.
@@ -27,6 +29,9 @@
 #define GRAPH_NO_RELATION -1                    // Relations are numbered [0-N], -1 represents no relation.
 #define GRAPH_UNKNOWN_RELATION -2               // Relations are numbered [0-N], -2 represents an unknown relation.
 #define EDGE_BULK_DELETE_THRESHOLD 4            // Max number of deletions to perform without choosing the bulk delete routine.
+#define EDGE_BULK_CREATE_THRESHOLD 64           // Min number of edges of a single type to create using the bulk create routine.
+#define NODE_BULK_DELETE_THRESHOLD 32           // Min number of deleted nodes for which incident edges are collected in bulk.
+#define TRANSPOSE_IDLE_COMPACTIONS 60           // Number of compactions without reverse traversals after which an adaptive transpose is dropped.
 
 typedef enum {
 	GRAPH_EDGE_DIR_INCOMING,
@@ -41,6 +46,13 @@ typedef enum {
 	SYNC_POLICY_NOP,
 } MATRIX_POLICY;
 
+// reverse traversal usage of a relation matrix
+// tracked by graphs maintaining transposed relation matrices adaptively
+typedef struct {
+	uint64_t reads;  // reverse traversals since the previous compaction
+	uint idle;       // consecutive compactions without reverse traversals
+} TransposeUsage;
+
 // forward declaration of Graph struct
 typedef struct Graph Graph;
 // typedef for synchronization function pointer
@@ -50,14 +62,23 @@ struct Graph {
 	DataBlock *nodes;                   // graph nodes stored in blocks
 	DataBlock *edges;                   // graph edges stored in blocks
 	RG_Matrix adjacency_matrix;         // adjacency matrix, holds all graph connections
+	bool _derived_adjacency;            // adjacency matrix is computed from the relation matrices on demand
+	bool _adjacency_stale;              // derived adjacency matrix no longer reflects the relation matrices
 	RG_Matrix *labels;                  // label matrices
 	RG_Matrix node_labels;              // mapping of all node IDs to all labels possessed by each node
 	RG_Matrix *relations;               // relation matrices
+	bool _adaptive_transpose;           // relation matrices maintain their transpose only while traversed in reverse
+	TransposeUsage *_transpose_usage;   // reverse traversal usage per relation matrix
 	RG_Matrix _zero_matrix;             // zero matrix
 	pthread_rwlock_t _rwlock;           // read-write lock scoped to this specific graph
 	bool _writelocked;                  // true if the read-write lock was acquired by a writer
+	uint64_t _write_epoch;              // number of released write locks
+	uint64_t _compaction_epoch;         // write epoch seen by the last compaction
 	SyncMatrixFunc SynchronizeMatrix;   // function pointer to matrix synchronization routine
+	bool _shared_pages;                 // a fork child shares the graph's memory pages
+	AdjacencyCache *adjacency_cache;    // edges of high degree nodes
 	GraphStatistics stats;              // graph related statistics
+	GraphLockStats lock_stats;          // read-write lock contention statistics
 };
 
 // graph synchronization functions
@@ -75,12 +96,26 @@ void Graph_AcquireWriteLock
 	Graph *g
 );
 
+// try acquiring a lock for exclusive access to this graph's data
+// returns false if the lock is held by others
+bool Graph_TryAcquireWriteLock
+(
+	Graph *g
+);
+
 // release the held lock
 void Graph_ReleaseLock
 (
 	Graph *g
 );
 
+// returns the number of write locks released so far
+// the graph was not modified as long as this number is unchanged
+uint64_t Graph_WriteEpoch
+(
+	const Graph *g
+);
+
 // choose the current matrix synchronization policy
 void Graph_SetMatrixPolicy
 (
@@ -95,6 +130,16 @@ void Graph_ApplyAllPending
 	bool force_flush    // force sync of delta matrices
 );
 
+// while a fork child shares the graph's memory pages, pending matrix
+// changes remain in the delta matrices rather than being merged into
+// the main matrices, such that the parent doesn't duplicate pages the child
+// reads, entity IDs are assigned regardless, keeping replicas consistent
+void Graph_SetSharedPages
+(
+	Graph *g,           // graph
+	bool shared         // a fork child is alive
+);
+
 // Retrieve graph matrix synchronization policy
 MATRIX_POLICY Graph_GetMatrixPolicy
 (
@@ -114,6 +159,43 @@ bool Graph_Pending
 	const Graph *g
 );
 
+// sums the flush and resize counters of all of the graph's matrices
+// 'last_flush_us' is set to the longest of the matrices' last flushes
+void Graph_MatrixStats
+(
+	const Graph *g,          // graph to query
+	RG_MatrixStats *stats    // [output] accumulated counters
+);
+
+// flush delta matrices without blocking readers
+// the flushed matrix is computed under a read lock and swapped in
+// under a brief write lock, a matrix is compacted once it accumulated
+// 'threshold' pending changes or if the graph was not modified
+// since the previous call, returns the number of compacted matrices
+uint Graph_CompactMatrices
+(
+	Graph *g,           // graph to compact
+	uint64_t threshold  // minimum number of pending changes to compact
+);
+
+// drops the transposes of relation matrices which were not traversed in reverse
+// for TRANSPOSE_IDLE_COMPACTIONS consecutive calls, a dropped transpose is
+// rebuilt by the next reverse traversal, no-op unless ADAPTIVE_TRANSPOSE is set
+// returns the number of dropped transposes
+uint Graph_DropIdleTransposes
+(
+	Graph *g  // graph to inspect
+);
+
+// recomputes the degree summaries of relationship types whose edges changed
+// by more than RELATION_SUMMARY_REFRESH_RATIO percent since last computed
+// each relation is scanned under its own read lock
+// returns the number of refreshed summaries
+uint Graph_RefreshStatistics
+(
+	Graph *g  // graph to refresh
+);
+
 // create a new graph
 Graph *Graph_New
 (
@@ -166,6 +248,18 @@ void Graph_CreateNode
 	uint label_count
 );
 
+// creates n nodes sharing the same labels
+// equivalent to calling Graph_CreateNode for each node
+// matrices are updated in bulk
+void Graph_CreateNodes
+(
+	Graph *g,           // graph on which to operate
+	int *labels,        // node labels
+	uint label_count,   // number of labels
+	Node *nodes,        // nodes to create
+	uint n              // number of nodes
+);
+
 // connects source node to destination node
 // returns 1 if connection is formed, 0 otherwise
 void Graph_CreateEdge
@@ -177,6 +271,42 @@ void Graph_CreateEdge
 	Edge *e
 );
 
+// create a node with a specific ID, mirroring a node created elsewhere
+// returns false if 'id' is in use
+bool Graph_CreateNodeWithID
+(
+	Graph *g,
+	NodeID id,
+	Node *n,
+	int *labels,
+	uint label_count
+);
+
+// create an edge with a specific ID, mirroring an edge created elsewhere
+// returns false if 'id' is in use
+bool Graph_CreateEdgeWithID
+(
+	Graph *g,           // graph on which to operate
+	EdgeID id,          // edge ID
+	NodeID src,         // source node ID
+	NodeID dest,        // destination node ID
+	int r,              // edge type
+	Edge *e
+);
+
+// connects each src[k] to dest[k] via a new edge of type 'r'
+// equivalent to calling Graph_CreateEdge for each edge
+// matrices are updated in bulk
+void Graph_CreateEdges
+(
+	Graph *g,           // graph on which to operate
+	int r,              // edge type
+	NodeID *src,        // source node IDs
+	NodeID *dest,       // destination node IDs
+	Edge **edges,       // edges to create
+	uint n              // number of edges
+);
+
 // removes node and all of its connections within the graph
 void Graph_DeleteNode
 (
@@ -209,8 +339,16 @@ void Graph_BulkDelete
 	uint *edge_deleted  // number of edges removed
 );
 
+// releases trailing storage blocks holding deleted entities only
+// entity IDs are left untouched, matrices shrink on their next sync
+void Graph_ReleaseDeletedBlocks
+(
+	Graph *g  // graph to release storage of
+);
+
 // all graph matrices are required to be squared NXN
 // where N is Graph_RequiredMatrixDim
+// N is at least the graph's node capacity and grows geometrically
 size_t Graph_RequiredMatrixDim
 (
 	const Graph *g
@@ -295,6 +433,23 @@ bool Graph_RelationshipContainsMultiEdge
 	bool transpose  // false for R, true for transpose R
 );
 
+// hints the CPU to load node 'id', such that a following
+// Graph_GetNode call doesn't stall on memory
+void Graph_PrefetchNode
+(
+	const Graph *g,
+	NodeID id
+);
+
+// hints the CPU to load the properties of node 'id'
+// reads the node itself, which should have been prefetched beforehand
+// by Graph_PrefetchNode such that this call doesn't stall on memory
+void Graph_PrefetchNodeProperties
+(
+	const Graph *g,
+	NodeID id
+);
+
 // retrieves node with given id from graph,
 // returns NULL if node wasn't found
 int Graph_GetNode
@@ -354,12 +509,21 @@ uint Graph_GetNodeLabels
 
 // retrieves the adjacency matrix
 // matrix is resized if its size doesn't match graph's node count
+// a derived adjacency matrix is recomputed if edges changed since its last read
 RG_Matrix Graph_GetAdjacencyMatrix
 (
 	const Graph *g,
 	bool transposed
 );
 
+// retrieves the adjacency matrix for an edge addition or removal
+// returns NULL if the adjacency matrix is derived from the relation matrices
+// in which case it is marked stale and recomputed on its next read
+RG_Matrix Graph_GetAdjacencyMatrixForUpdate
+(
+	Graph *g
+);
+
 // retrieves a label matrix
 // matrix is resized if its size doesn't match graph's node count
 RG_Matrix Graph_GetLabelMatrix
@@ -398,6 +562,16 @@ RG_Matrix Graph_GetLabelRGMatrix
 	int label_idx
 );
 
+// frees the next slice of the graph, one matrix or datablock block at a time
+// until 'budget' milliseconds elapsed, matrices are released first
+// returns true once the graph was entirely freed
+// the graph mustn't be accessed other than by subsequent calls
+bool Graph_FreeSlice
+(
+	Graph *g,      // graph to free
+	double budget  // time budget in milliseconds
+);
+
 // free graph
 void Graph_Free
 (
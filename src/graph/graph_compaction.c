@@ -0,0 +1,84 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "../RG.h"
+#include "graph_compaction.h"
+#include "graphcontext.h"
+#include "../util/arr.h"
+#include "../util/cron.h"
+#include "../redismodule.h"
+#include "../util/thpool/pools.h"
+#include "../configuration/config.h"
+#include "../serializers/decode_context.h"
+
+// number of miliseconds between compactions
+#define COMPACTION_INTERVAL 1000
+
+// true while a compaction job is queued or executing
+static bool _compaction_queued = false;
+
+// compacts all graphs in the keyspace
+// executed on the writer thread, the only thread making graph modifications
+// other than Redis main thread
+static void _GraphCompaction_Run
+(
+	void *arg
+) {
+	uint64_t ratio;
+	uint64_t max_pending_changes;
+	Config_Option_get(Config_DELTA_COMPACTION_RATIO, &ratio);
+	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES, &max_pending_changes);
+
+	uint64_t threshold = max_pending_changes * ratio / 100;
+	if(threshold == 0) threshold = 1;
+
+	// collect graphs, the keyspace is only accessed under Redis global lock
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+	GraphContext **graphs = GraphContext_RetainRegisteredGraphContexts();
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	uint n = array_len(graphs);
+	for(uint i = 0; i < n; i++) {
+		GraphContext *gc = graphs[i];
+
+		// skip graphs which are being decoded
+		if(!GraphDecodeContext_GetProcessedKeyCount(gc->decoding_context)) {
+			if(ratio > 0) {
+				Graph_CompactMatrices(gc->g, threshold);
+				Graph_DropIdleTransposes(gc->g);
+			}
+			Graph_RefreshStatistics(gc->g);
+		}
+
+		GraphContext_Release(gc);
+	}
+	array_free(graphs);
+
+	__atomic_store_n(&_compaction_queued, false, __ATOMIC_RELAXED);
+}
+
+// CRON task, queues a compaction job on the writer thread
+// and reschedules itself
+static void _GraphCompaction_Tick
+(
+	void *pdata
+) {
+	// avoid queuing a compaction job while a previous one is pending
+	// the job refreshes statistics even if compaction is disabled
+	if(!__atomic_exchange_n(&_compaction_queued, true, __ATOMIC_RELAXED)) {
+		if(ThreadPools_AddWorkWriter(_GraphCompaction_Run, NULL) != 0) {
+			__atomic_store_n(&_compaction_queued, false, __ATOMIC_RELAXED);
+		}
+	}
+
+	Cron_AddTask(COMPACTION_INTERVAL, _GraphCompaction_Tick, NULL);
+}
+
+void GraphCompaction_Start(void) {
+	Cron_AddTask(COMPACTION_INTERVAL, _GraphCompaction_Tick, NULL);
+}
@@ -0,0 +1,18 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+// background compaction of graph matrices
+// delta matrices are periodically flushed on the writer thread
+// sparing queries from performing the flush themselves
+// transposes of relation matrices no longer traversed in reverse are dropped
+// stale degree summaries of relationship types are recomputed
+// see Graph_CompactMatrices, Graph_DropIdleTransposes
+// and Graph_RefreshStatistics
+
+// start background compaction, should be called once
+void GraphCompaction_Start(void);
@@ -0,0 +1,259 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "graph_copy.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../index/index_builder.h"
+#include "../serializers/graph_extensions.h"
+
+// copies the properties of 'src' onto 'dst'
+// values are interned by the copy's string pool
+static void _CopyProperties
+(
+	GraphContext *gc,
+	const Entity *src,
+	GraphEntity *dst
+) {
+	int n = Entity_PropCount(src);
+	if(n == 0) return;
+
+	// small property sets are staged on the stack
+	SIValue _values[16];
+	SIValue *values = (n > 16) ? rm_malloc(sizeof(SIValue) * n) : _values;
+
+	for(int i = 0; i < n; i++) {
+		values[i] = SI_CloneValue(src->properties[i]);
+		GraphContext_PreparePropertyValue(gc, values + i);
+	}
+
+	GraphEntity_AddProperties(dst, Entity_AttributeIDs(src), values, n);
+	for(int i = 0; i < n; i++) SIValue_Free(values[i]);
+
+	if(values != _values) rm_free(values);
+}
+
+static void _CopySchemas
+(
+	GraphContext *dst,
+	const GraphContext *src,
+	SchemaType t
+) {
+	uint n = GraphContext_SchemaCount(src, t);
+	for(uint i = 0; i < n; i++) {
+		Schema *s = GraphContext_GetSchemaByID(src, i, t);
+		Schema *copy = GraphContext_AddSchema(dst, s->name, t);
+		ASSERT(copy->id == s->id);
+		UNUSED(copy);
+	}
+}
+
+// recreates the indices of 'src' over the copied entities
+static void _CopyIndices
+(
+	GraphContext *dst,
+	const GraphContext *src,
+	SchemaType t
+) {
+	uint n = GraphContext_SchemaCount(src, t);
+	for(uint i = 0; i < n; i++) {
+		Schema *s = GraphContext_GetSchemaByID(src, i, t);
+		Schema *copy = GraphContext_GetSchemaByID(dst, i, t);
+
+		Index *indices[3] = {s->index, s->fulltextIdx, s->vectorIdx};
+		for(int j = 0; j < 3; j++) {
+			Index *idx = indices[j];
+			if(idx == NULL) continue;
+
+			Index *copy_idx = NULL;
+			uint fields_count = Index_FieldsCount(idx);
+			for(uint k = 0; k < fields_count; k++) {
+				Schema_AddIndex(&copy_idx, copy, idx->fields[k], idx->type);
+			}
+			ASSERT(copy_idx != NULL);
+
+			if(idx->type == IDX_FULLTEXT) {
+				Index_SetLanguage(copy_idx, Index_GetLanguage(idx));
+
+				size_t stopwords_count;
+				char **stopwords = Index_GetStopwords(idx, &stopwords_count);
+				if(stopwords_count > 0) {
+					char **arr = array_new(char *, stopwords_count);
+					for(size_t k = 0; k < stopwords_count; k++) {
+						array_append(arr, stopwords[k]);
+					}
+					Index_SetStopwords(copy_idx, arr);
+					array_free(arr);
+				}
+				for(size_t k = 0; k < stopwords_count; k++) rm_free(stopwords[k]);
+				rm_free(stopwords);
+			}
+
+			if(idx->type == IDX_VECTOR) Index_SetDimension(copy_idx, idx->dimension);
+
+			IndexBuilder_Build(dst, copy_idx);
+		}
+	}
+}
+
+static void _CopyNodes
+(
+	GraphContext *dst,
+	const GraphContext *src
+) {
+	Entity *e;
+	NodeID id;
+	Graph *g = src->g;
+	uint label_count = Graph_LabelTypeCount(g);
+	LabelID *labels = rm_malloc(sizeof(LabelID) * (label_count + 1));
+
+	DataBlockIterator *it = Graph_ScanNodes(g);
+	while((e = (Entity *)DataBlockIterator_Next(it, &id)) != NULL) {
+		Node n = GE_NEW_NODE();
+		n.id = id;
+		n.entity = e;
+		uint count = Graph_GetNodeLabels(g, &n, labels, label_count);
+
+		Node copy;
+		Serializer_Graph_SetNode(dst->g, id, labels, count, &copy);
+		_CopyProperties(dst, e, (GraphEntity *)&copy);
+	}
+	DataBlockIterator_Free(it);
+	rm_free(labels);
+
+	Serializer_Graph_SetNodeLabels(dst->g);
+
+	uint64_t *deleted = Serializer_Graph_GetDeletedNodesList(g);
+	uint deleted_count = array_len(deleted);
+	for(uint i = 0; i < deleted_count; i++) {
+		Serializer_Graph_MarkNodeDeleted(dst->g, deleted[i]);
+	}
+}
+
+static void _CopyEdges
+(
+	GraphContext *dst,
+	const GraphContext *src
+) {
+	Entity *e;
+	EdgeID id;
+	Graph *g = src->g;
+
+	// edge connections are introduced by the relation matrices
+	DataBlockIterator *it = Graph_ScanEdges(g);
+	while((e = (Entity *)DataBlockIterator_Next(it, &id)) != NULL) {
+		Edge copy;
+		Serializer_Graph_AllocEdge(dst->g, id, INVALID_ENTITY_ID,
+				INVALID_ENTITY_ID, GRAPH_NO_RELATION, &copy);
+		_CopyProperties(dst, e, (GraphEntity *)&copy);
+	}
+	DataBlockIterator_Free(it);
+
+	uint64_t *deleted = Serializer_Graph_GetDeletedEdgesList(g);
+	uint deleted_count = array_len(deleted);
+	for(uint i = 0; i < deleted_count; i++) {
+		Serializer_Graph_MarkEdgeDeleted(dst->g, deleted[i]);
+	}
+}
+
+static void _CopyRelationMatrices
+(
+	GraphContext *dst,
+	const GraphContext *src
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	Graph *g = src->g;
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) {
+		GrB_Index  nvals;
+		GrB_Matrix A = NULL;
+
+		// export a flushed copy of the relation matrix
+		RG_Matrix M = Graph_GetRelationMatrix(g, r, false);
+		info = RG_Matrix_export(&A, M);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_nvals(&nvals, A);
+		ASSERT(info == GrB_SUCCESS);
+
+		if(nvals == 0) {
+			GrB_Matrix_free(&A);
+			continue;
+		}
+
+		// multi-edge entries remain valid within the copied
+		// relation matrix, which holds a copy of M's multi-edge table
+		if(Graph_RelationshipContainsMultiEdge(g, r, false)) {
+			RG_Matrix_copyMultiEdges(Graph_GetRelationMatrix(dst->g, r, false),
+					M);
+		}
+
+		Serializer_Graph_SetRelationMatrix(dst->g, r, &A,
+				Graph_RelationEdgeCount(g, r));
+	}
+}
+
+GraphContext *GraphContext_Copy
+(
+	GraphContext *gc,
+	const char *graph_name
+) {
+	ASSERT(gc != NULL);
+	ASSERT(graph_name != NULL);
+
+	Graph *g = gc->g;
+	GraphContext *copy = GraphContext_New(graph_name,
+			Graph_UncompactedNodeCount(g),
+			Graph_EdgeCount(g) + Graph_DeletedEdgeCount(g));
+
+	// attributes are introduced in order, preserving their IDs
+	uint attribute_count = GraphContext_AttributeCount(gc);
+	for(uint i = 0; i < attribute_count; i++) {
+		GraphContext_FindOrAddAttribute(copy,
+				GraphContext_GetAttributeString(gc, i));
+	}
+
+	_CopySchemas(copy, gc, SCHEMA_NODE);
+	_CopySchemas(copy, gc, SCHEMA_EDGE);
+
+	Graph_SetMatrixPolicy(copy->g, SYNC_POLICY_NOP);
+	_CopyNodes(copy, gc);
+	_CopyEdges(copy, gc);
+	_CopyRelationMatrices(copy, gc);
+
+	// revert to default synchronization behavior
+	Graph_SetMatrixPolicy(copy->g, SYNC_POLICY_FLUSH_RESIZE);
+	Graph_ApplyAllPending(copy->g, true);
+
+	// update the node statistics
+	uint label_count = Graph_LabelTypeCount(copy->g);
+	for(uint i = 0; i < label_count; i++) {
+		GrB_Index nvals;
+		RG_Matrix L = Graph_GetLabelMatrix(copy->g, i);
+		RG_Matrix_nvals(&nvals, L);
+		GraphStatistics_IncNodeCount(&copy->g->stats, i, nvals);
+	}
+
+	// relations' degree summaries describe the copied edges as well
+	uint relation_count = Graph_RelationTypeCount(copy->g);
+	for(uint i = 0; i < relation_count; i++) {
+		const RelationSummary *summary =
+			GraphStatistics_GetRelationSummary(&g->stats, i);
+		if(summary != NULL) {
+			GraphStatistics_SetRelationSummary(&copy->g->stats, i, summary);
+		}
+	}
+
+	// indices are populated out of the copied entities
+	QueryCtx_SetGraphCtx(copy);
+	_CopyIndices(copy, gc, SCHEMA_NODE);
+	_CopyIndices(copy, gc, SCHEMA_EDGE);
+
+	return copy;
+}
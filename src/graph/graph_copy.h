@@ -0,0 +1,23 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "graphcontext.h"
+
+// creates an independent copy of 'gc' named 'graph_name'
+// the copy is built the way an RDB load builds a graph, out of 'gc' rather
+// than out of an encoded stream: entity IDs, deleted IDs, schemas and
+// attribute IDs are preserved, relation matrices are copied as a whole
+// and indices are reconstructed over the copied entities
+//
+// the caller must hold 'gc''s read lock
+// the copy is neither registered with the module nor set in the keyspace
+GraphContext *GraphContext_Copy
+(
+	GraphContext *gc,       // graph to copy
+	const char *graph_name  // name of the copy
+);
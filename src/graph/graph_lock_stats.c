@@ -0,0 +1,171 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "graph_lock_stats.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include <string.h>
+
+static const char *_lock_type_names[GRAPH_LOCK_TYPE_COUNT] = {"read", "write"};
+
+// see _ReplyWithRoundedDouble in slow_log.c
+static inline void _ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
+	int len = snprintf(NULL, 0, "%.5g", d);
+	char str[len + 1];
+	sprintf(str, "%.5g", d);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+void GraphLockStats_Init
+(
+	GraphLockStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	memset(stats, 0, sizeof(GraphLockStats));
+	int res = pthread_mutex_init(&stats->holders_lock, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+}
+
+void GraphLockStats_RecordAcquire
+(
+	GraphLockStats *stats,
+	GRAPH_LOCK_TYPE type,
+	uint64_t wait_us
+) {
+	ASSERT(stats != NULL);
+	ASSERT(type < GRAPH_LOCK_TYPE_COUNT);
+
+	__atomic_fetch_add(stats->acquired + type, 1, __ATOMIC_RELAXED);
+	if(type == GRAPH_LOCK_WRITE) {
+		// write lock is held exclusively
+		clock_gettime(CLOCK_MONOTONIC, &stats->write_acquired_at);
+	}
+
+	if(wait_us == 0) return;
+
+	__atomic_fetch_add(stats->contended + type, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(stats->wait_us + type, wait_us, __ATOMIC_RELAXED);
+	uint64_t max = __atomic_load_n(stats->wait_max_us + type, __ATOMIC_RELAXED);
+	while(wait_us > max && !__atomic_compare_exchange_n(stats->wait_max_us + type,
+				&max, wait_us, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+void GraphLockStats_RecordWriteRelease
+(
+	GraphLockStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	uint64_t held_us = GraphLockStats_Elapsed(&stats->write_acquired_at);
+	if(held_us < GRAPH_LOCK_HOLD_THRESHOLD_US) return;
+
+	const char *query = QueryCtx_GetQuery();
+
+	pthread_mutex_lock(&stats->holders_lock);
+	{
+		// overwrite oldest holder
+		GraphLockHolder *holder = stats->holders + stats->holders_idx;
+		if(holder->query != NULL) rm_free(holder->query);
+		holder->time    = time(NULL);
+		holder->query   = (query != NULL) ? rm_strdup(query) : NULL;
+		holder->held_us = held_us;
+		stats->holders_idx = (stats->holders_idx + 1) % GRAPH_LOCK_HOLDERS_CAP;
+	}
+	pthread_mutex_unlock(&stats->holders_lock);
+}
+
+// GRAPH.SLOWLOG <graph> LOCKS reply:
+// 1) "read"  acquired, contended, total wait ms, max wait ms
+// 2) "write" acquired, contended, total wait ms, max wait ms
+// 3) long write lock holders, most recent first: time, query, held ms
+void GraphLockStats_Replay
+(
+	GraphLockStats *stats,
+	RedisModuleCtx *ctx
+) {
+	ASSERT(ctx   != NULL);
+	ASSERT(stats != NULL);
+
+	RedisModule_ReplyWithArray(ctx, GRAPH_LOCK_TYPE_COUNT + 1);
+	for(int t = 0; t < GRAPH_LOCK_TYPE_COUNT; t++) {
+		RedisModule_ReplyWithArray(ctx, 5);
+		RedisModule_ReplyWithSimpleString(ctx, _lock_type_names[t]);
+		RedisModule_ReplyWithLongLong(ctx,
+				__atomic_load_n(stats->acquired + t, __ATOMIC_RELAXED));
+		RedisModule_ReplyWithLongLong(ctx,
+				__atomic_load_n(stats->contended + t, __ATOMIC_RELAXED));
+		_ReplyWithRoundedDouble(ctx,
+				__atomic_load_n(stats->wait_us + t, __ATOMIC_RELAXED) / 1000.0);
+		_ReplyWithRoundedDouble(ctx,
+				__atomic_load_n(stats->wait_max_us + t, __ATOMIC_RELAXED) / 1000.0);
+	}
+
+	pthread_mutex_lock(&stats->holders_lock);
+	{
+		uint n = 0;
+		for(uint i = 0; i < GRAPH_LOCK_HOLDERS_CAP; i++) {
+			if(stats->holders[i].held_us > 0) n++;
+		}
+
+		RedisModule_ReplyWithArray(ctx, n);
+		for(uint i = 1; i <= n; i++) {
+			uint idx = (stats->holders_idx + GRAPH_LOCK_HOLDERS_CAP - i) %
+				GRAPH_LOCK_HOLDERS_CAP;
+			const GraphLockHolder *holder = stats->holders + idx;
+			RedisModule_ReplyWithArray(ctx, 3);
+			RedisModule_ReplyWithLongLong(ctx, holder->time);
+			if(holder->query != NULL) {
+				RedisModule_ReplyWithStringBuffer(ctx, holder->query,
+						strlen(holder->query));
+			} else {
+				RedisModule_ReplyWithNull(ctx);
+			}
+			_ReplyWithRoundedDouble(ctx, holder->held_us / 1000.0);
+		}
+	}
+	pthread_mutex_unlock(&stats->holders_lock);
+}
+
+void GraphLockStats_Reset
+(
+	GraphLockStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	for(int t = 0; t < GRAPH_LOCK_TYPE_COUNT; t++) {
+		__atomic_store_n(stats->acquired + t, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(stats->contended + t, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(stats->wait_us + t, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(stats->wait_max_us + t, 0, __ATOMIC_RELAXED);
+	}
+
+	pthread_mutex_lock(&stats->holders_lock);
+	{
+		for(uint i = 0; i < GRAPH_LOCK_HOLDERS_CAP; i++) {
+			GraphLockHolder *holder = stats->holders + i;
+			if(holder->query != NULL) rm_free(holder->query);
+			holder->query   = NULL;
+			holder->held_us = 0;
+		}
+		stats->holders_idx = 0;
+	}
+	pthread_mutex_unlock(&stats->holders_lock);
+}
+
+void GraphLockStats_FreeInternals
+(
+	GraphLockStats *stats
+) {
+	ASSERT(stats != NULL);
+
+	for(uint i = 0; i < GRAPH_LOCK_HOLDERS_CAP; i++) {
+		if(stats->holders[i].query != NULL) rm_free(stats->holders[i].query);
+	}
+	pthread_mutex_destroy(&stats->holders_lock);
+}
@@ -0,0 +1,97 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "../redismodule.h"
+
+// number of long write lock holders kept per graph
+#define GRAPH_LOCK_HOLDERS_CAP 16
+// write locks held at least this long are considered long holders
+#define GRAPH_LOCK_HOLD_THRESHOLD_US 1000
+
+typedef enum {
+	GRAPH_LOCK_READ,
+	GRAPH_LOCK_WRITE,
+	GRAPH_LOCK_TYPE_COUNT,
+} GRAPH_LOCK_TYPE;
+
+// write lock holder
+typedef struct {
+	time_t time;       // time lock was released
+	char *query;       // query holding the lock, NULL if not issued by a query
+	uint64_t held_us;  // time lock was held
+} GraphLockHolder;
+
+// graph read-write lock contention statistics
+// uncontended acquisitions only increment a counter
+// acquisitions which had to wait are timed
+typedef struct {
+	uint64_t acquired[GRAPH_LOCK_TYPE_COUNT];     // number of acquisitions
+	uint64_t contended[GRAPH_LOCK_TYPE_COUNT];    // acquisitions which waited
+	uint64_t wait_us[GRAPH_LOCK_TYPE_COUNT];      // total time waited
+	uint64_t wait_max_us[GRAPH_LOCK_TYPE_COUNT];  // longest wait
+	struct timespec write_acquired_at;            // current writer acquisition
+	pthread_mutex_t holders_lock;                 // guards holders
+	GraphLockHolder holders[GRAPH_LOCK_HOLDERS_CAP];  // ring of long holders
+	uint holders_idx;                             // next ring slot
+} GraphLockStats;
+
+// initialize lock statistics
+void GraphLockStats_Init
+(
+	GraphLockStats *stats
+);
+
+// count an acquisition of a 'type' lock
+// 'wait_us' is the time waited for the lock, 0 if uncontended
+void GraphLockStats_RecordAcquire
+(
+	GraphLockStats *stats,
+	GRAPH_LOCK_TYPE type,
+	uint64_t wait_us
+);
+
+// record the write lock is about to be released by its holder
+// must be called while holding the write lock
+void GraphLockStats_RecordWriteRelease
+(
+	GraphLockStats *stats
+);
+
+// replies with lock statistics
+void GraphLockStats_Replay
+(
+	GraphLockStats *stats,
+	RedisModuleCtx *ctx
+);
+
+// discard collected statistics
+void GraphLockStats_Reset
+(
+	GraphLockStats *stats
+);
+
+// free lock statistics internals
+void GraphLockStats_FreeInternals
+(
+	GraphLockStats *stats
+);
+
+// microseconds elapsed since 'start'
+static inline uint64_t GraphLockStats_Elapsed
+(
+	const struct timespec *start
+) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	int64_t us = (now.tv_sec - start->tv_sec) * 1000000 +
+		(now.tv_nsec - start->tv_nsec) / 1000;
+	return (us > 0) ? us : 0;
+}
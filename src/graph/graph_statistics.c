@@ -11,16 +11,23 @@ void GraphStatistics_init(GraphStatistics *stats) {
 	ASSERT(stats);
 	stats->node_count = array_new(uint64_t, 0);
 	stats->edge_count = array_new(uint64_t, 0);
+	stats->node_mods  = array_new(uint64_t, 0);
+	stats->edge_mods  = array_new(uint64_t, 0);
+	stats->relations  = array_new(RelationSummary, 0);
 }
 
 void GraphStatistics_IntroduceRelationship(GraphStatistics *stats) {
 	ASSERT(stats && stats->edge_count);
 	array_append(stats->edge_count, 0);
+	array_append(stats->edge_mods, 0);
+	RelationSummary summary = {0};
+	array_append(stats->relations, summary);
 }
 
 void GraphStatistics_IntroduceLabel(GraphStatistics *stats) {
 	ASSERT(stats && stats->node_count);
 	array_append(stats->node_count, 0);
+	array_append(stats->node_mods, 0);
 }
 
 uint64_t GraphStatistics_EdgeCount(const GraphStatistics *stats,
@@ -39,9 +46,99 @@ uint64_t GraphStatistics_NodeCount(const GraphStatistics *stats,
 	return stats->node_count[label_idx];
 }
 
+uint64_t GraphStatistics_NodeModifications(const GraphStatistics *stats,
+										   int label_idx) {
+	ASSERT(stats);
+	ASSERT(label_idx < (int)array_len(stats->node_mods));
+
+	if(label_idx < 0) return 0;
+	return stats->node_mods[label_idx];
+}
+
+uint64_t GraphStatistics_EdgeModifications(const GraphStatistics *stats,
+										   int relation_idx) {
+	ASSERT(stats);
+	ASSERT(relation_idx < (int)array_len(stats->edge_mods));
+
+	if(relation_idx < 0) return 0;
+	return stats->edge_mods[relation_idx];
+}
+
+void GraphStatistics_SetRelationSummary(GraphStatistics *stats,
+										int relation_idx,
+										const RelationSummary *summary) {
+	ASSERT(stats);
+	ASSERT(summary);
+	ASSERT(relation_idx < array_len(stats->relations));
+
+	RelationSummary *s = stats->relations + relation_idx;
+	s->src_count  = summary->src_count;
+	s->dest_count = summary->dest_count;
+	s->edge_count = summary->edge_count;
+	s->edge_mods  = stats->edge_mods[relation_idx];
+	s->computed   = true;
+}
+
+const RelationSummary *GraphStatistics_GetRelationSummary(
+		const GraphStatistics *stats, int relation_idx) {
+	ASSERT(stats);
+
+	if(relation_idx < 0 || relation_idx >= array_len(stats->relations)) {
+		return NULL;
+	}
+
+	const RelationSummary *s = stats->relations + relation_idx;
+	return s->computed ? s : NULL;
+}
+
+bool GraphStatistics_RelationSummaryStale(const GraphStatistics *stats,
+										  int relation_idx) {
+	ASSERT(stats);
+	ASSERT(relation_idx < array_len(stats->relations));
+
+	const RelationSummary *s = stats->relations + relation_idx;
+	if(!s->computed) return true;
+
+	// edges created or deleted since, the number of modifications
+	// accounts for changes which cancel each other out
+	uint64_t edges = stats->edge_count[relation_idx];
+	uint64_t delta = (edges > s->edge_count) ?
+		edges - s->edge_count : s->edge_count - edges;
+	uint64_t mods = stats->edge_mods[relation_idx] - s->edge_mods;
+	if(mods > delta) delta = mods;
+
+	return delta * 100 > s->edge_count * RELATION_SUMMARY_REFRESH_RATIO;
+}
+
+bool GraphStatistics_RelationEndpoints(const GraphStatistics *stats,
+									   int relation_idx, bool sources,
+									   double *count) {
+	ASSERT(stats);
+	ASSERT(count);
+
+	const RelationSummary *s =
+		GraphStatistics_GetRelationSummary(stats, relation_idx);
+	if(s == NULL || s->edge_count == 0) return false;
+
+	// assume the average degree is unchanged since the summary was computed
+	double edges = stats->edge_count[relation_idx];
+	double endpoints = sources ? s->src_count : s->dest_count;
+	endpoints *= edges / s->edge_count;
+
+	// each edge contributes at most a single endpoint
+	if(endpoints > edges) endpoints = edges;
+	if(endpoints < 1 && edges > 0) endpoints = 1;
+
+	*count = endpoints;
+	return true;
+}
+
 void GraphStatistics_FreeInternals(GraphStatistics *stats) {
 	ASSERT(stats);
 	if(stats->node_count) array_free(stats->node_count);
 	if(stats->edge_count) array_free(stats->edge_count);
+	if(stats->node_mods) array_free(stats->node_mods);
+	if(stats->edge_mods) array_free(stats->edge_mods);
+	if(stats->relations) array_free(stats->relations);
 }
 
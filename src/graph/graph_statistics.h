@@ -7,13 +7,35 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "../util/arr.h"
 
+// a degree summary is refreshed once the edges of its relationship type
+// changed by more than this percentage since it was computed
+#define RELATION_SUMMARY_REFRESH_RATIO 10
+
+// degree summaries are persisted with relation schemas
+// tagged as an index type older decoders reject
+#define RELATION_SUMMARY_ENCODING_TAG 65
+
 // Graph related statistics
 
+// Degree summary of a relationship type, computed by scanning its matrix
+// and persisted with the graph's schema, see Graph_RefreshStatistics
+typedef struct {
+	uint64_t src_count;   // Number of distinct source nodes
+	uint64_t dest_count;  // Number of distinct destination nodes
+	uint64_t edge_count;  // Number of edges when the summary was computed
+	uint64_t edge_mods;   // Modification count when the summary was computed
+	bool computed;        // False until the summary is first computed
+} RelationSummary;
+
 typedef struct {
-	uint64_t *node_count; // Array of node count per label matrix
-	uint64_t *edge_count; // Array of edge count per relationship matrix
+	uint64_t *node_count;        // Array of node count per label matrix
+	uint64_t *edge_count;        // Array of edge count per relationship matrix
+	uint64_t *node_mods;         // Array of modification count per label
+	uint64_t *edge_mods;         // Array of modification count per relationship
+	RelationSummary *relations;  // Array of degree summary per relationship
 } GraphStatistics;
 
 // Initialize the node_count and edge_count arrays
@@ -30,6 +52,7 @@ static inline void GraphStatistics_IncEdgeCount(GraphStatistics *stats,
 												int relation_idx, uint64_t amount) {
 	ASSERT(relation_idx < array_len(stats->edge_count));
 	stats->edge_count[relation_idx] += amount;
+	stats->edge_mods[relation_idx]++;
 }
 
 // Decrement the edge counter by amount
@@ -38,6 +61,7 @@ static inline void GraphStatistics_DecEdgeCount(GraphStatistics *stats,
 	ASSERT(relation_idx < array_len(stats->edge_count) &&
 		   stats->edge_count[relation_idx] >= amount);
 	stats->edge_count[relation_idx] -= amount;
+	stats->edge_mods[relation_idx]++;
 }
 
 // Increment the node counter by amount
@@ -45,6 +69,7 @@ static inline void GraphStatistics_IncNodeCount(GraphStatistics *stats,
 												int label_idx, uint64_t amount) {
 	ASSERT(label_idx < array_len(stats->node_count));
 	stats->node_count[label_idx] += amount;
+	stats->node_mods[label_idx]++;
 }
 
 // Decrement the node counter by amount
@@ -53,6 +78,21 @@ static inline void GraphStatistics_DecNodeCount(GraphStatistics *stats,
 	ASSERT(label_idx < array_len(stats->node_count) &&
 		   stats->node_count[label_idx] >= amount);
 	stats->node_count[label_idx] -= amount;
+	stats->node_mods[label_idx]++;
+}
+
+// Mark nodes with the given label as modified, e.g. their attributes updated
+static inline void GraphStatistics_NodesModified(GraphStatistics *stats,
+												 int label_idx) {
+	ASSERT(label_idx < array_len(stats->node_mods));
+	stats->node_mods[label_idx]++;
+}
+
+// Mark edges of the given relationship type as modified
+static inline void GraphStatistics_EdgesModified(GraphStatistics *stats,
+												 int relation_idx) {
+	ASSERT(relation_idx < array_len(stats->edge_mods));
+	stats->edge_mods[relation_idx]++;
 }
 
 // Retrieves edge count for given relationship type
@@ -63,6 +103,41 @@ uint64_t GraphStatistics_EdgeCount(const GraphStatistics *stats,
 uint64_t GraphStatistics_NodeCount(const GraphStatistics *stats,
 								   int label_idx);
 
+// Retrieves the number of times nodes with the given label were modified
+// the value itself is meaningless, it changes whenever such nodes are
+// created, deleted or updated
+uint64_t GraphStatistics_NodeModifications(const GraphStatistics *stats,
+										   int label_idx);
+
+// Retrieves the number of times edges of the given relationship type were
+// modified
+uint64_t GraphStatistics_EdgeModifications(const GraphStatistics *stats,
+										   int relation_idx);
+
+// Sets the degree summary of the given relationship type
+// the summary's modification count is taken from the current statistics
+void GraphStatistics_SetRelationSummary(GraphStatistics *stats,
+										int relation_idx,
+										const RelationSummary *summary);
+
+// Retrieves the degree summary of the given relationship type
+// returns NULL if it was never computed
+const RelationSummary *GraphStatistics_GetRelationSummary(
+		const GraphStatistics *stats, int relation_idx);
+
+// Returns true if the degree summary of the given relationship type
+// is missing or its edges changed considerably since it was computed
+bool GraphStatistics_RelationSummaryStale(const GraphStatistics *stats,
+										  int relation_idx);
+
+// Estimates the number of distinct source, or destination, nodes of the
+// given relationship type, the summary's counts are extrapolated by the
+// change in edge count since it was computed
+// returns false if no summary is available
+bool GraphStatistics_RelationEndpoints(const GraphStatistics *stats,
+									   int relation_idx, bool sources,
+									   double *count);
+
 // Free the internal structures.
 void GraphStatistics_FreeInternals(GraphStatistics *stats);
 
@@ -9,22 +9,35 @@
 #include "graphcontext.h"
 #include "../RG.h"
 #include "../util/arr.h"
+#include "../util/cron.h"
 #include "../util/uuid.h"
 #include "../query_ctx.h"
 #include "../redismodule.h"
 #include "../util/rmalloc.h"
+#include "../configuration/config.h"
 #include "../util/thpool/pools.h"
 #include "../serializers/graphcontext_type.h"
 #include "../commands/execution_ctx.h"
+#include "../resultset/resultset_cache.h"
 
 // Global array tracking all extant GraphContexts (defined in module.c)
 extern GraphContext **graphs_in_keyspace;
+// graphs held before a replica's full sync began (defined in module.c)
+extern GraphContext **graphs_in_load;
 extern uint aux_field_counter;
 // GraphContext type as it is registered at Redis.
 extern RedisModuleType *GraphContextRedisModuleType;
 
+// asynchronous deletes free the graph in time bounded slices on the writer
+// thread, pausing between slices such that queries aren't starved
+// of the writer thread nor of the allocator
+#define GRAPH_FREE_SLICE 5      // milliseconds spent per slice
+#define GRAPH_FREE_INTERVAL 10  // milliseconds between slices
+
 // Forward declarations.
 static void _GraphContext_Free(void *arg);
+static void _GraphContext_FreeTick(void *arg);
+static void _GraphContext_FreeSlice(void *arg);
 static void _GraphContext_UpdateVersion(GraphContext *gc, const char *str);
 
 static inline void _GraphContext_IncreaseRefCount(GraphContext *gc) {
@@ -39,7 +52,8 @@ static inline void _GraphContext_DecreaseRefCount(GraphContext *gc) {
 
 		if(async_delete) {
 			// Async delete
-			ThreadPools_AddWorkWriter(_GraphContext_Free, gc);
+			Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
+			_GraphContext_FreeTick(gc);
 		} else {
 			// Sync delete
 			_GraphContext_Free(gc);
@@ -57,29 +71,50 @@ GraphContext *GraphContext_New(const char *graph_name, size_t node_cap, size_t e
 
 	gc->version          = 0;  // initial graph version
 	gc->slowlog          = SlowLog_New();
+	gc->query_stats      = QueryStats_New();
+	gc->query_traces     = QueryTraceLog_New();
 	gc->ref_count        = 0;  // no refences
-	gc->attributes       = raxNew();
+	gc->attributes       = NameTable_New();
 	gc->index_count      = 0;  // no indicies
-	gc->string_mapping   = array_new(char *, 64);
+	gc->index_version    = 0;
+	gc->commit_seq       = 0;
 	gc->encoding_context = GraphEncodeContext_New();
 	gc->decoding_context = GraphDecodeContext_New();
 
 	// initialize the graph's matrices and datablock storage
 	gc->g = Graph_New(node_cap, edge_cap);
+	gc->string_pool = StringPool_New();
+	gc->cold_store  = MmapStore_New();
 	gc->graph_name = rm_strdup(graph_name);
 
 	// allocate the default space for schemas and indices
 	gc->node_schemas = array_new(Schema *, GRAPH_DEFAULT_LABEL_CAP);
 	gc->relation_schemas = array_new(Schema *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
-
-	// initialize the read-write lock to protect access to the attributes rax
-	assert(pthread_rwlock_init(&gc->_attribute_rwlock, NULL) == 0);
-
-	// build the execution plans cache
-	uint64_t cache_size;
-	Config_Option_get(Config_CACHE_SIZE, &cache_size);
-	gc->cache = Cache_New(cache_size, (CacheEntryFreeFunc)ExecutionCtx_Free,
-						  (CacheEntryCopyFunc)ExecutionCtx_Clone);
+	gc->_label_ids = NameTable_New();
+	gc->_reltype_ids = NameTable_New();
+
+	// name tables are read without locking, additions are serialized
+	assert(pthread_mutex_init(&gc->_names_lock, NULL) == 0);
+
+	// the execution plans cache is built by the first query to use it
+	// graphs which are only ever written to or not queried at all
+	// don't pay for its tables and per-thread statistics
+	gc->cache = NULL;
+	gc->auto_parameterize = false;  // opt-in
+	gc->prepared = PreparedStatements_New((CacheEntryFreeFunc)ExecutionCtx_Free,
+			(CacheEntryCopyFunc)ExecutionCtx_Clone);
+	gc->views = MaterializedViews_New((CacheEntryFreeFunc)CachedResultSet_Release,
+			(CacheEntryCopyFunc)CachedResultSet_Share);
+
+	// build the result-sets cache, disabled by default
+	uint64_t result_cache_size;
+	Config_Option_get(Config_RESULTSET_CACHE_SIZE, &result_cache_size);
+	gc->result_cache = NULL;
+	if(result_cache_size > 0) {
+		gc->result_cache = Cache_New(result_cache_size,
+				(CacheEntryFreeFunc)CachedResultSet_Release,
+				(CacheEntryCopyFunc)CachedResultSet_Share);
+	}
 
 	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 	QueryCtx_SetGraphCtx(gc);
@@ -107,6 +142,27 @@ static GraphContext *_GraphContext_Create(RedisModuleCtx *ctx, const char *graph
 	return gc;
 }
 
+// retrieve the version of a graph held before the current full sync began
+static GraphContext *_GraphContext_RetrieveInLoad
+(
+	RedisModuleCtx *ctx,
+	RedisModuleString *graphID
+) {
+	const char *graph_name = RedisModule_StringPtrLen(graphID, NULL);
+	uint graph_count = array_len(graphs_in_load);
+	for(uint i = 0; i < graph_count; i++) {
+		GraphContext *gc = graphs_in_load[i];
+		if(strcmp(gc->graph_name, graph_name) == 0) {
+			_GraphContext_IncreaseRefCount(gc);
+			return gc;
+		}
+	}
+
+	RedisModule_ReplyWithError(ctx,
+			"LOADING Redis is loading the dataset in memory");
+	return NULL;
+}
+
 GraphContext *GraphContext_Retrieve
 (
 	RedisModuleCtx *ctx,
@@ -114,6 +170,14 @@ GraphContext *GraphContext_Retrieve
 	bool readOnly,
 	bool shouldCreate
 ) {
+	// a loading server only admits read-only queries
+	// these are served by the graphs held before the full sync began
+	// until the loaded graphs replace them
+	if(readOnly &&
+	   (RedisModule_GetContextFlags(ctx) & REDISMODULE_CTX_FLAGS_LOADING)) {
+		return _GraphContext_RetrieveInLoad(ctx, graphID);
+	}
+
 	// check if we're still replicating, if so don't allow access to the graph
 	if(aux_field_counter > 0) {
 		// the whole module is currently replicating, emit an error
@@ -153,6 +217,11 @@ void GraphContext_Release(GraphContext *gc) {
 	_GraphContext_DecreaseRefCount(gc);
 }
 
+void GraphContext_Retain(GraphContext *gc) {
+	ASSERT(gc);
+	_GraphContext_IncreaseRefCount(gc);
+}
+
 void GraphContext_MarkWriter(RedisModuleCtx *ctx, GraphContext *gc) {
 	RedisModuleString *graphID = RedisModule_CreateString(ctx, gc->graph_name, strlen(gc->graph_name));
 
@@ -220,16 +289,38 @@ static void _GraphContext_UpdateVersion(GraphContext *gc, const char *str) {
 //------------------------------------------------------------------------------
 // Schema API
 //------------------------------------------------------------------------------
+// index the names of schemas missing from 'names'
+// schemas are added to the schema arrays directly by decoders
+// as such the name tables catch up on lookup
+static void _GraphContext_IndexSchemas
+(
+	GraphContext *gc,
+	Schema **schemas,
+	NameTable *names
+) {
+	pthread_mutex_lock(&gc->_names_lock);
+
+	uint n = array_len(schemas);
+	for(uint i = NameTable_Count(names); i < n; i++) {
+		NameTable_Add(names, schemas[i]->name);
+	}
+
+	pthread_mutex_unlock(&gc->_names_lock);
+}
+
 // Find the ID associated with a label for schema and matrix access
 int _GraphContext_GetLabelID(const GraphContext *gc, const char *label, SchemaType t) {
 	// Choose the appropriate schema array given the entity type
 	Schema **schemas = (t == SCHEMA_NODE) ? gc->node_schemas : gc->relation_schemas;
+	NameTable *names = (t == SCHEMA_NODE) ? gc->_label_ids : gc->_reltype_ids;
 
-	// TODO optimize lookup
-	for(uint32_t i = 0; i < array_len(schemas); i ++) {
-		if(!strcmp(label, schemas[i]->name)) return i;
+	if(NameTable_Count(names) < array_len(schemas)) {
+		_GraphContext_IndexSchemas((GraphContext *)gc, schemas, names);
 	}
-	return GRAPH_NO_LABEL; // equivalent to GRAPH_NO_RELATION
+
+	uint id = NameTable_Find(names, label);
+	if(id == NAME_TABLE_NOTFOUND) return GRAPH_NO_LABEL; // equivalent to GRAPH_NO_RELATION
+	return id;
 }
 
 unsigned short GraphContext_SchemaCount(const GraphContext *gc, SchemaType t) {
@@ -276,67 +367,71 @@ const char *GraphContext_GetEdgeRelationType(const GraphContext *gc, Edge *e) {
 }
 
 uint GraphContext_AttributeCount(GraphContext *gc) {
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	uint size = raxSize(gc->attributes);
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return size;
+	return NameTable_Count(gc->attributes);
 }
 
 Attribute_ID GraphContext_FindOrAddAttribute(GraphContext *gc, const char *attribute) {
-	// Acquire a read lock for looking up the attribute.
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-
-	// See if attribute already exists.
-	void *attribute_id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-
-	if(attribute_id == raxNotFound) {
-		// We are writing to the shared GraphContext; release the held lock and re-acquire as a writer.
-		pthread_rwlock_unlock(&gc->_attribute_rwlock);
-		pthread_rwlock_wrlock(&gc->_attribute_rwlock);
-
-		// Lookup the attribute again now that we are in a critical region.
-		attribute_id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-		// If it has been set by another thread, use the retrieved value.
-		if(attribute_id == raxNotFound) {
-			// Otherwise, it will be assigned an ID equal to the current mapping size.
-			attribute_id = (void *)raxSize(gc->attributes);
-			// Insert the new attribute key and ID.
-			raxInsert(gc->attributes,
-					  (unsigned char *)attribute,
-					  strlen(attribute),
-					  attribute_id,
-					  NULL);
-			array_append(gc->string_mapping, rm_strdup(attribute));
-
-			// new attribute been added, update graph version
-			_GraphContext_UpdateVersion(gc, attribute);
-		}
+	// See if attribute already exists, lookups don't lock.
+	uint id = NameTable_Find(gc->attributes, attribute);
+	if(id != NAME_TABLE_NOTFOUND) return id;
+
+	pthread_mutex_lock(&gc->_names_lock);
+
+	// Lookup the attribute again now that we are in a critical region.
+	id = NameTable_Find(gc->attributes, attribute);
+	// If it has been set by another thread, use the retrieved value.
+	if(id == NAME_TABLE_NOTFOUND) {
+		// Otherwise, it will be assigned an ID equal to the current mapping size.
+		id = NameTable_Add(gc->attributes, attribute);
+
+		// new attribute been added, update graph version
+		_GraphContext_UpdateVersion(gc, attribute);
 	}
 
-	// Release the lock.
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return (uintptr_t)attribute_id;
+	pthread_mutex_unlock(&gc->_names_lock);
+	return id;
 }
 
 const char *GraphContext_GetAttributeString(GraphContext *gc, Attribute_ID id) {
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	ASSERT(id < array_len(gc->string_mapping));
-	const char *name = gc->string_mapping[id];
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
-	return name;
+	return NameTable_Name(gc->attributes, id);
 }
 
 Attribute_ID GraphContext_GetAttributeID(GraphContext *gc, const char *attribute) {
-	// Acquire a read lock for looking up the attribute.
-	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
-	// Look up the attribute ID.
-	void *id = raxFind(gc->attributes, (unsigned char *)attribute, strlen(attribute));
-	// Release the lock.
-	pthread_rwlock_unlock(&gc->_attribute_rwlock);
+	uint id = NameTable_Find(gc->attributes, attribute);
+	if(id == NAME_TABLE_NOTFOUND) return ATTRIBUTE_NOTFOUND;
+
+	return id;
+}
 
-	if(id == raxNotFound) return ATTRIBUTE_NOTFOUND;
+void GraphContext_PreparePropertyValue(GraphContext *gc, SIValue *v) {
+	ASSERT(gc != NULL);
+	ASSERT(v  != NULL);
 
-	return (uintptr_t)id;
+	if(SI_TYPE(*v) != T_STRING) return;
+	if(v->allocation == M_INTERN || v->allocation == M_EXTERN ||
+	   v->allocation == M_COMPRESSED) {
+		return;
+	}
+
+	uint64_t threshold;
+	Config_Option_get(Config_COLD_STORAGE_THRESHOLD, &threshold);
+	if(threshold > 0 && gc->cold_store != NULL) {
+		size_t len = strlen(v->stringval);
+		if(len >= threshold) {
+			const char *s = MmapStore_AppendString(gc->cold_store, v->stringval,
+					len);
+			// keep value in RAM if it couldn't be stored
+			if(s != NULL) {
+				SIValue_Free(*v);
+				*v = (SIValue) {
+					.stringval = (char *)s, .type = T_STRING, .allocation = M_EXTERN
+				};
+				return;
+			}
+		}
+	}
+
+	StringPool_InternValue(gc->string_pool, v);
 }
 
 //------------------------------------------------------------------------------
@@ -426,6 +521,9 @@ int GraphContext_DeleteIndex
 	if(s != NULL) {
 		res = Schema_RemoveIndex(s, field, type);
 		if(res != INDEX_FAIL) {
+			// plans utilizing the removed index must not be reused
+			GraphContext_BumpIndexVersion(gc);
+
 			// update resultset statistics
 			ResultSet *result_set = QueryCtx_GetResultSet();
 			ResultSet_IndexDeleted(result_set, res);
@@ -435,6 +533,47 @@ int GraphContext_DeleteIndex
 	return res;
 }
 
+uint64_t GraphContext_IndexVersion
+(
+	const GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	return __atomic_load_n(&gc->index_version, __ATOMIC_ACQUIRE);
+}
+
+void GraphContext_BumpIndexVersion
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	__atomic_fetch_add(&gc->index_version, 1, __ATOMIC_RELEASE);
+}
+
+uint64_t GraphContext_CommitSeq
+(
+	const GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	return __atomic_load_n(&gc->commit_seq, __ATOMIC_ACQUIRE);
+}
+
+uint64_t GraphContext_AdvanceCommitSeq
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	return __atomic_add_fetch(&gc->commit_seq, 1, __ATOMIC_RELEASE);
+}
+
+void GraphContext_SetCommitSeq
+(
+	GraphContext *gc,
+	uint64_t seq
+) {
+	ASSERT(gc != NULL);
+	__atomic_store_n(&gc->commit_seq, seq, __ATOMIC_RELEASE);
+}
+
 // delete all references to a node from any indices built upon its properties
 void GraphContext_DeleteNodeFromIndices
 (
@@ -444,9 +583,9 @@ void GraphContext_DeleteNodeFromIndices
 	ASSERT(n  != NULL);
 	ASSERT(gc != NULL);
 
-	Schema    *s       =  NULL;
-	Graph     *g       =  gc->g;
-	EntityID  node_id  =  ENTITY_GET_ID(n);
+	Schema        *s        =  NULL;
+	Graph         *g        =  gc->g;
+	IndexChanges  *changes  =  QueryCtx_GetIndexChanges();
 
 	// retrieve node labels
 	uint label_count;
@@ -459,10 +598,13 @@ void GraphContext_DeleteNodeFromIndices
 
 		// Update any indices this entity is represented in
 		Index *idx = Schema_GetIndex(s, NULL, IDX_FULLTEXT);
-		if(idx) Index_RemoveNode(idx, n);
+		if(idx) IndexChanges_RemoveNode(changes, idx, n);
 
 		idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
-		if(idx) Index_RemoveNode(idx, n);
+		if(idx) IndexChanges_RemoveNode(changes, idx, n);
+
+		idx = Schema_GetIndex(s, NULL, IDX_VECTOR);
+		if(idx) IndexChanges_RemoveNode(changes, idx, n);
 	}
 }
 
@@ -475,11 +617,12 @@ void GraphContext_DeleteEdgeFromIndices(GraphContext *gc, Edge *e) {
 	s = GraphContext_GetSchemaByID(gc, relation_id, SCHEMA_EDGE);
 
 	// update any indices this entity is represented in
+	IndexChanges *changes = QueryCtx_GetIndexChanges();
 	Index *idx = Schema_GetIndex(s, NULL, IDX_FULLTEXT);
-	if(idx) Index_RemoveEdge(idx, e);
+	if(idx) IndexChanges_RemoveEdge(changes, idx, e);
 
 	idx = Schema_GetIndex(s, NULL, IDX_EXACT_MATCH);
-	if(idx) Index_RemoveEdge(idx, e);
+	if(idx) IndexChanges_RemoveEdge(changes, idx, e);
 }
 
 //------------------------------------------------------------------------------
@@ -519,6 +662,17 @@ void GraphContext_RemoveFromRegistry(GraphContext *gc) {
 	}
 }
 
+GraphContext **GraphContext_RetainRegisteredGraphContexts(void) {
+	uint graph_count = array_len(graphs_in_keyspace);
+	GraphContext **graphs = array_new(GraphContext *, graph_count);
+	for(uint i = 0; i < graph_count; i ++) {
+		GraphContext *gc = graphs_in_keyspace[i];
+		_GraphContext_IncreaseRefCount(gc);
+		array_append(graphs, gc);
+	}
+	return graphs;
+}
+
 //------------------------------------------------------------------------------
 // Slowlog API
 //------------------------------------------------------------------------------
@@ -529,6 +683,18 @@ SlowLog *GraphContext_GetSlowLog(const GraphContext *gc) {
 	return gc->slowlog;
 }
 
+// Return query shape statistics associated with graph context.
+QueryStats *GraphContext_GetQueryStats(const GraphContext *gc) {
+	ASSERT(gc);
+	return gc->query_stats;
+}
+
+// Return sampled query traces associated with graph context.
+QueryTraceLog *GraphContext_GetQueryTraces(const GraphContext *gc) {
+	ASSERT(gc);
+	return gc->query_traces;
+}
+
 //------------------------------------------------------------------------------
 // Cache API
 //------------------------------------------------------------------------------
@@ -536,7 +702,145 @@ SlowLog *GraphContext_GetSlowLog(const GraphContext *gc) {
 // Return cache associated with graph context and current thread id.
 Cache *GraphContext_GetCache(const GraphContext *gc) {
 	ASSERT(gc != NULL);
-	return gc->cache;
+
+	Cache *cache = __atomic_load_n(&gc->cache, __ATOMIC_ACQUIRE);
+	if(cache != NULL) return cache;
+
+	// build the execution plans cache on first use
+	// concurrent readers might race to build it, the first one wins
+	uint64_t cache_size;
+	Config_Option_get(Config_CACHE_SIZE, &cache_size);
+	Cache *new_cache = Cache_New(cache_size,
+			(CacheEntryFreeFunc)ExecutionCtx_Free,
+			(CacheEntryCopyFunc)ExecutionCtx_Clone);
+
+	if(!__atomic_compare_exchange_n((Cache **)&gc->cache, &cache, new_cache,
+				false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		// lost the race, 'cache' holds the winner's cache
+		Cache_Free(new_cache);
+		return cache;
+	}
+
+	return new_cache;
+}
+
+void GraphContext_SetAutoParameterize(GraphContext *gc, bool enable) {
+	ASSERT(gc != NULL);
+	__atomic_store_n(&gc->auto_parameterize, enable, __ATOMIC_RELAXED);
+}
+
+bool GraphContext_AutoParameterize(const GraphContext *gc) {
+	ASSERT(gc != NULL);
+	return __atomic_load_n(&gc->auto_parameterize, __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------------------
+// Memory API
+//------------------------------------------------------------------------------
+
+static void _MatrixMemoryUsage
+(
+	RG_Matrix A,
+	GraphMemoryUsage *usage
+) {
+	size_t m;
+	size_t dp;
+	size_t dm;
+
+	RG_Matrix_memoryUsage(&m, &dp, &dm, A);
+	usage->matrices    += m;
+	usage->delta_plus  += dp;
+	usage->delta_minus += dm;
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) {
+		RG_Matrix_memoryUsage(&m, &dp, &dm, A->transposed);
+		usage->transposes += m + dp + dm;
+	}
+}
+
+static size_t _PropertiesMemoryUsage
+(
+	DataBlockIterator *it
+) {
+	size_t size = 0;
+	Entity *e;
+	while((e = DataBlockIterator_Next(it, NULL)) != NULL) {
+		size += Entity_PropertiesMemoryUsage(e);
+	}
+	DataBlockIterator_Free(it);
+	return size;
+}
+
+static size_t _SchemasIndexMemoryUsage
+(
+	Schema **schemas
+) {
+	size_t size = 0;
+	uint n = array_len(schemas);
+	for(uint i = 0; i < n; i++) {
+		Schema *s = schemas[i];
+		if(s->index) size += Index_MemoryUsage(s->index);
+		if(s->fulltextIdx) size += Index_MemoryUsage(s->fulltextIdx);
+		if(s->vectorIdx) size += Index_MemoryUsage(s->vectorIdx);
+	}
+	return size;
+}
+
+static void _CachedResultSetMemoryUsage
+(
+	const char *key,
+	void *value,
+	void *privdata
+) {
+	size_t *size = privdata;
+	CachedResultSet *cached = value;
+
+	*size += sizeof(CachedResultSet) + sizeof(ResultSet);
+	if(cached->set->cells) *size += DataBlock_MemoryUsage(cached->set->cells);
+}
+
+void GraphContext_MemoryUsage
+(
+	const GraphContext *gc,
+	GraphMemoryUsage *usage
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(usage != NULL);
+
+	Graph *g = gc->g;
+	memset(usage, 0, sizeof(GraphMemoryUsage));
+
+	// matrices
+	_MatrixMemoryUsage(g->adjacency_matrix, usage);
+	_MatrixMemoryUsage(g->node_labels, usage);
+	_MatrixMemoryUsage(g->_zero_matrix, usage);
+	uint n = array_len(g->labels);
+	for(uint i = 0; i < n; i++) _MatrixMemoryUsage(g->labels[i], usage);
+	n = array_len(g->relations);
+	for(uint i = 0; i < n; i++) _MatrixMemoryUsage(g->relations[i], usage);
+
+	// entities
+	usage->node_blocks = DataBlock_MemoryUsage(g->nodes);
+	usage->edge_blocks = DataBlock_MemoryUsage(g->edges);
+	usage->properties  = _PropertiesMemoryUsage(Graph_ScanNodes(g)) +
+		_PropertiesMemoryUsage(Graph_ScanEdges(g));
+
+	if(gc->string_pool) {
+		usage->interned_strings = StringPool_MemoryUsage(gc->string_pool);
+	}
+	if(gc->cold_store) usage->cold_strings = MmapStore_Size(gc->cold_store);
+
+	usage->indexes = _SchemasIndexMemoryUsage(gc->node_schemas) +
+		_SchemasIndexMemoryUsage(gc->relation_schemas);
+
+	usage->adjacency_cache = AdjacencyCache_MemoryUsage(g->adjacency_cache);
+
+	if(gc->cache) usage->plan_cache = Cache_MemoryUsage(gc->cache);
+	if(gc->result_cache) {
+		usage->result_cache = Cache_MemoryUsage(gc->result_cache);
+		Cache_ForEach(gc->result_cache, _CachedResultSetMemoryUsage,
+				&usage->result_cache);
+	}
 }
 
 //------------------------------------------------------------------------------
@@ -544,13 +848,42 @@ Cache *GraphContext_GetCache(const GraphContext *gc) {
 //------------------------------------------------------------------------------
 
 // Free all data associated with graph
+// CRON task, queues the next slice of an asynchronous delete
+// on the writer thread
+static void _GraphContext_FreeTick(void *arg) {
+	if(ThreadPools_AddWorkWriter(_GraphContext_FreeSlice, arg) != 0) {
+		// queue is full, retry later
+		Cron_AddTask(GRAPH_FREE_INTERVAL, _GraphContext_FreeTick, arg);
+	}
+}
+
+// frees a slice of a deleted graph, rescheduling itself until
+// the graph is entirely freed, at which point the context is freed
+static void _GraphContext_FreeSlice(void *arg) {
+	GraphContext *gc = (GraphContext *)arg;
+
+	if(!Graph_FreeSlice(gc->g, GRAPH_FREE_SLICE)) {
+		Cron_AddTask(GRAPH_FREE_INTERVAL, _GraphContext_FreeTick, gc);
+		return;
+	}
+
+	gc->g = NULL;
+	_GraphContext_Free(gc);
+}
+
 static void _GraphContext_Free(void *arg) {
 	GraphContext *gc = (GraphContext *)arg;
 	uint len;
 
-	// Disable matrix synchronization for graph deletion.
-	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
-	Graph_Free(gc->g);
+	if(gc->g != NULL) {
+		// Disable matrix synchronization for graph deletion.
+		Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
+		Graph_Free(gc->g);
+	}
+
+	// entities released their interned strings
+	StringPool_Free(gc->string_pool);
+	MmapStore_Free(gc->cold_store);
 
 	//--------------------------------------------------------------------------
 	// Free node schemas
@@ -580,26 +913,25 @@ static void _GraphContext_Free(void *arg) {
 	// Free attribute mappings
 	//--------------------------------------------------------------------------
 
-	if(gc->attributes) raxFree(gc->attributes);
-
-	if(gc->string_mapping) {
-		len = array_len(gc->string_mapping);
-		for(uint32_t i = 0; i < len; i ++) {
-			rm_free(gc->string_mapping[i]);
-		}
-		array_free(gc->string_mapping);
-	}
+	if(gc->attributes) NameTable_Free(gc->attributes);
+	if(gc->_label_ids) NameTable_Free(gc->_label_ids);
+	if(gc->_reltype_ids) NameTable_Free(gc->_reltype_ids);
 
-	int res = pthread_rwlock_destroy(&gc->_attribute_rwlock);
+	int res = pthread_mutex_destroy(&gc->_names_lock);
 	ASSERT(res == 0);
 
 	if(gc->slowlog) SlowLog_Free(gc->slowlog);
+	if(gc->query_stats) QueryStats_Free(gc->query_stats);
+	if(gc->query_traces) QueryTraceLog_Free(gc->query_traces);
 
 	//--------------------------------------------------------------------------
 	// Clear cache
 	//--------------------------------------------------------------------------
 
 	if(gc->cache) Cache_Free(gc->cache);
+	if(gc->result_cache) Cache_Free(gc->result_cache);
+	if(gc->prepared) PreparedStatements_Free(gc->prepared);
+	if(gc->views) MaterializedViews_Free(gc->views);
 
 	GraphEncodeContext_Free(gc->encoding_context);
 	GraphDecodeContext_Free(gc->decoding_context);
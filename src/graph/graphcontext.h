@@ -10,10 +10,17 @@
 #include "../index/index.h"
 #include "../schema/schema.h"
 #include "../slow_log/slow_log.h"
+#include "../slow_log/query_stats.h"
+#include "../slow_log/query_trace.h"
 #include "graph.h"
 #include "../serializers/encode_context.h"
 #include "../serializers/decode_context.h"
 #include "../util/cache/cache.h"
+#include "../util/mmap_store.h"
+#include "../util/string_pool.h"
+#include "../util/name_table.h"
+#include "prepared_statements.h"
+#include "materialized_views.h"
 
 // GraphContext holds refrences to various elements of a graph object
 // It is the value sitting behind a Redis graph key
@@ -27,21 +34,49 @@
 
 typedef struct {
 	Graph *g;                               // container for all matrices and entity properties
+	StringPool *string_pool;                // interned string property values
+	MmapStore *cold_store;                  // memory-mapped large string property values
 	int ref_count;                          // number of active references
-	rax *attributes;                        // from strings to attribute IDs
-	pthread_rwlock_t _attribute_rwlock;     // read-write lock to protect access to the attribute maps
+	NameTable *attributes;                  // attribute IDs by name and names by ID
+	pthread_mutex_t _names_lock;            // serializes additions to the graph's name tables
 	char *graph_name;                       // string associated with graph
-	char **string_mapping;                  // from attribute IDs to strings
 	Schema **node_schemas;                  // array of schemas for each node label
 	Schema **relation_schemas;              // array of schemas for each relation type
+	NameTable *_label_ids;                  // node schema IDs by label
+	NameTable *_reltype_ids;                // relation schema IDs by relationship type
 	unsigned short index_count;             // number of indicies
 	SlowLog *slowlog;                       // slowlog associated with graph
+	QueryStats *query_stats;                // latency statistics by query shape
+	QueryTraceLog *query_traces;            // sampled query phase traces
 	GraphEncodeContext *encoding_context;   // encode context of the graph
 	GraphDecodeContext *decoding_context;   // decode context of the graph
 	Cache *cache;                           // global cache of execution plans
+	Cache *result_cache;                    // cache of read-only query results
+	PreparedStatements *prepared;           // statements prepared via GRAPH.PREPARE
+	MaterializedViews *views;               // views registered via GRAPH.VIEW
+	bool auto_parameterize;                 // lift query literals into parameters
+	uint64_t index_version;                 // changes whenever the set of usable indices changes
+	uint64_t commit_seq;                    // number of committed modifications
 	XXH32_hash_t version;                   // graph version
 } GraphContext;
 
+// number of bytes used by each of the graph's components
+typedef struct {
+	size_t matrices;          // M of all matrices
+	size_t delta_plus;        // pending additions of all matrices
+	size_t delta_minus;       // pending deletions of all matrices
+	size_t transposes;        // transposed matrices, including their deltas
+	size_t node_blocks;       // node storage
+	size_t edge_blocks;       // edge storage
+	size_t properties;        // entity property blocks and owned values
+	size_t interned_strings;  // string pool
+	size_t cold_strings;      // memory-mapped string property values
+	size_t indexes;           // exact-match and full-text indexes
+	size_t adjacency_cache;   // cached adjacency lists
+	size_t plan_cache;        // execution plan cache, excluding plans
+	size_t result_cache;      // cached result-sets
+} GraphMemoryUsage;
+
 //------------------------------------------------------------------------------
 // GraphContext API
 //------------------------------------------------------------------------------
@@ -70,6 +105,13 @@ void GraphContext_Release
 	GraphContext *gc
 );
 
+// retains an additional reference to 'gc'
+// should be released via GraphContext_Release
+void GraphContext_Retain
+(
+	GraphContext *gc
+);
+
 // mark graph key as "dirty" for Redis to pick up on
 void GraphContext_MarkWriter
 (
@@ -180,6 +222,16 @@ Attribute_ID GraphContext_GetAttributeID
 	const char *str
 );
 
+// prepares 'v' to be stored as a property value, freeing its previous form
+// strings at least COLD_STORAGE_THRESHOLD bytes long are moved into
+// memory-mapped storage, short strings are interned
+// must only be called by the thread holding the graph's write access
+void GraphContext_PreparePropertyValue
+(
+	GraphContext *gc,
+	SIValue *v
+);
+
 //------------------------------------------------------------------------------
 // Index API
 //------------------------------------------------------------------------------
@@ -230,6 +282,42 @@ int GraphContext_DeleteIndex
 	IndexType type
 );
 
+// returns the graph's index version, execution plans built under
+// a different version may not utilize the graph's current indices
+uint64_t GraphContext_IndexVersion
+(
+	const GraphContext *gc
+);
+
+// advance the graph's index version, called once an index
+// becomes usable or unusable by queries
+void GraphContext_BumpIndexVersion
+(
+	GraphContext *gc
+);
+
+// returns the graph's commit sequence, the number of modifications
+// committed to the graph, a replica which applied the master's commits
+// reports the same sequence as the master
+uint64_t GraphContext_CommitSeq
+(
+	const GraphContext *gc
+);
+
+// advance the graph's commit sequence, called once per committed modification
+// returns the new sequence
+uint64_t GraphContext_AdvanceCommitSeq
+(
+	GraphContext *gc
+);
+
+// set the graph's commit sequence, used when loading a graph
+void GraphContext_SetCommitSeq
+(
+	GraphContext *gc,
+	uint64_t seq
+);
+
 // remove a single node from all indices that refer to it
 void GraphContext_DeleteNodeFromIndices
 (
@@ -263,6 +351,11 @@ void GraphContext_RemoveFromRegistry
 	GraphContext *gc
 );
 
+// retrieve all GraphContexts from the global array
+// each retrieved graph context is retained and should be released
+// via GraphContext_Release, caller must hold Redis global lock
+GraphContext **GraphContext_RetainRegisteredGraphContexts(void);
+
 //------------------------------------------------------------------------------
 // Slowlog API
 //------------------------------------------------------------------------------
@@ -272,6 +365,18 @@ SlowLog *GraphContext_GetSlowLog
 	const GraphContext *gc
 );
 
+// return query shape statistics associated with graph context
+QueryStats *GraphContext_GetQueryStats
+(
+	const GraphContext *gc
+);
+
+// return sampled query traces associated with graph context
+QueryTraceLog *GraphContext_GetQueryTraces
+(
+	const GraphContext *gc
+);
+
 //------------------------------------------------------------------------------
 // Cache API
 //------------------------------------------------------------------------------
@@ -282,3 +387,28 @@ Cache *GraphContext_GetCache
 	const GraphContext *gc
 );
 
+//------------------------------------------------------------------------------
+// Memory API
+//------------------------------------------------------------------------------
+
+// compute the number of bytes used by each of the graph's components
+// caller must hold the graph's read lock
+void GraphContext_MemoryUsage
+(
+	const GraphContext *gc,
+	GraphMemoryUsage *usage
+);
+
+// enable or disable auto-parameterization of queries issued against the graph
+void GraphContext_SetAutoParameterize
+(
+	GraphContext *gc,
+	bool enable
+);
+
+// returns true if queries issued against the graph are auto-parameterized
+bool GraphContext_AutoParameterize
+(
+	const GraphContext *gc
+);
+
@@ -0,0 +1,253 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "materialized_views.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "rax.h"
+#include <string.h>
+#include <pthread.h>
+
+struct MaterializedView {
+	char *name;                       // view name
+	char *query;                      // query text
+	char **labels;                    // labels the view depends on
+	char **relations;                 // relationship types the view depends on
+	bool global;                      // depends on every graph modification
+	void *result;                     // last result, NULL until first read
+	uint64_t version;                 // dependencies version 'result' reflects
+	int format;                       // reply format of 'result'
+	int ref_count;                    // number of references to the view
+	pthread_mutex_t lock;             // guards the result
+	CacheEntryFreeFunc free_result;   // frees results
+	CacheEntryCopyFunc copy_result;   // copies results
+};
+
+struct MaterializedViews {
+	rax *views;                       // view name to view
+	CacheEntryFreeFunc free_result;   // frees results
+	CacheEntryCopyFunc copy_result;   // copies results
+	pthread_mutex_t lock;             // guards registration and lookups
+};
+
+static char **_CopyNames
+(
+	const char **names
+) {
+	uint n = (names != NULL) ? array_len(names) : 0;
+	char **copy = array_new(char *, n);
+	for(uint i = 0; i < n; i++) array_append(copy, rm_strdup(names[i]));
+	return copy;
+}
+
+MaterializedViews *MaterializedViews_New
+(
+	CacheEntryFreeFunc free_result,
+	CacheEntryCopyFunc copy_result
+) {
+	ASSERT(free_result != NULL);
+	ASSERT(copy_result != NULL);
+
+	MaterializedViews *views = rm_malloc(sizeof(MaterializedViews));
+
+	views->views       = raxNew();
+	views->free_result = free_result;
+	views->copy_result = copy_result;
+
+	int res = pthread_mutex_init(&views->lock, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return views;
+}
+
+bool MaterializedViews_Add
+(
+	MaterializedViews *views,
+	const char *name,
+	const char *query,
+	const char **labels,
+	const char **relations,
+	bool global
+) {
+	ASSERT(name  != NULL);
+	ASSERT(views != NULL);
+	ASSERT(query != NULL);
+
+	bool added = false;
+	size_t len = strlen(name);
+
+	pthread_mutex_lock(&views->lock);
+
+	if(raxSize(views->views) >= MATERIALIZED_VIEWS_MAX) goto cleanup;
+	if(raxFind(views->views, (unsigned char *)name, len) != raxNotFound) {
+		goto cleanup;
+	}
+
+	MaterializedView *view = rm_malloc(sizeof(MaterializedView));
+	view->name        = rm_strdup(name);
+	view->query       = rm_strdup(query);
+	view->labels      = _CopyNames(labels);
+	view->relations   = _CopyNames(relations);
+	view->global      = global;
+	view->result      = NULL;
+	view->version     = 0;
+	view->format      = 0;
+	view->ref_count   = 1;  // owned by the registry
+	view->free_result = views->free_result;
+	view->copy_result = views->copy_result;
+	pthread_mutex_init(&view->lock, NULL);
+
+	raxInsert(views->views, (unsigned char *)name, len, view, NULL);
+	added = true;
+
+cleanup:
+	pthread_mutex_unlock(&views->lock);
+	return added;
+}
+
+MaterializedView *MaterializedViews_Get
+(
+	MaterializedViews *views,
+	const char *name
+) {
+	ASSERT(name  != NULL);
+	ASSERT(views != NULL);
+
+	MaterializedView *view = NULL;
+
+	pthread_mutex_lock(&views->lock);
+	void *v = raxFind(views->views, (unsigned char *)name, strlen(name));
+	if(v != raxNotFound) {
+		view = v;
+		__atomic_fetch_add(&view->ref_count, 1, __ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&views->lock);
+
+	return view;
+}
+
+bool MaterializedViews_Remove
+(
+	MaterializedViews *views,
+	const char *name
+) {
+	ASSERT(name  != NULL);
+	ASSERT(views != NULL);
+
+	MaterializedView *view = NULL;
+
+	pthread_mutex_lock(&views->lock);
+	raxRemove(views->views, (unsigned char *)name, strlen(name),
+			(void **)&view);
+	pthread_mutex_unlock(&views->lock);
+
+	// readers holding a reference keep the view alive
+	if(view != NULL) MaterializedView_Release(view);
+	return view != NULL;
+}
+
+void MaterializedViews_Free
+(
+	MaterializedViews *views
+) {
+	ASSERT(views != NULL);
+
+	raxFreeWithCallback(views->views, (void (*)(void *))MaterializedView_Release);
+	pthread_mutex_destroy(&views->lock);
+	rm_free(views);
+}
+
+const char *MaterializedView_Query
+(
+	const MaterializedView *view
+) {
+	ASSERT(view != NULL);
+	return view->query;
+}
+
+const char **MaterializedView_Labels
+(
+	const MaterializedView *view
+) {
+	ASSERT(view != NULL);
+	return (const char **)view->labels;
+}
+
+const char **MaterializedView_Relations
+(
+	const MaterializedView *view
+) {
+	ASSERT(view != NULL);
+	return (const char **)view->relations;
+}
+
+bool MaterializedView_Global
+(
+	const MaterializedView *view
+) {
+	ASSERT(view != NULL);
+	return view->global;
+}
+
+void *MaterializedView_GetResult
+(
+	MaterializedView *view,
+	uint64_t version,
+	int format
+) {
+	ASSERT(view != NULL);
+
+	void *result = NULL;
+
+	pthread_mutex_lock(&view->lock);
+	if(view->result != NULL && view->version == version &&
+	   view->format == format) {
+		result = view->copy_result(view->result);
+	}
+	pthread_mutex_unlock(&view->lock);
+
+	return result;
+}
+
+void MaterializedView_SetResult
+(
+	MaterializedView *view,
+	uint64_t version,
+	int format,
+	void *result
+) {
+	ASSERT(view   != NULL);
+	ASSERT(result != NULL);
+
+	pthread_mutex_lock(&view->lock);
+	void *prev = view->result;
+	view->result  = result;
+	view->version = version;
+	view->format  = format;
+	pthread_mutex_unlock(&view->lock);
+
+	// copies handed out remain valid once their origin is released
+	if(prev != NULL) view->free_result(prev);
+}
+
+void MaterializedView_Release
+(
+	MaterializedView *view
+) {
+	ASSERT(view != NULL);
+
+	if(__atomic_sub_fetch(&view->ref_count, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	if(view->result != NULL) view->free_result(view->result);
+	array_free_cb(view->labels, rm_free);
+	array_free_cb(view->relations, rm_free);
+	pthread_mutex_destroy(&view->lock);
+	rm_free(view->query);
+	rm_free(view->name);
+	rm_free(view);
+}
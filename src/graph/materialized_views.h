@@ -0,0 +1,120 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../util/cache/cache_array.h"
+
+// maximum number of views registered against a single graph
+#define MATERIALIZED_VIEWS_MAX 1024
+
+// registry of the views registered against a graph via GRAPH.VIEW
+// a view is a named read-only query whose last result is kept
+// reading a view replays its result as long as the labels and relationship
+// types it depends on weren't modified, otherwise the query is re-executed
+// and its new result kept
+//
+// a global view depends on every modification of the graph, e.g. views
+// matching unlabeled nodes or calling procedures
+//
+// views are reference counted, such that a view can be dropped
+// while being read
+typedef struct MaterializedViews MaterializedViews;
+typedef struct MaterializedView MaterializedView;
+
+// create a new registry
+// 'free_result' and 'copy_result' free and copy view results
+MaterializedViews *MaterializedViews_New
+(
+	CacheEntryFreeFunc free_result,
+	CacheEntryCopyFunc copy_result
+);
+
+// registers view 'name' over 'query'
+// the view takes a copy of its dependencies
+// returns false if a view named 'name' exists or the registry is full
+bool MaterializedViews_Add
+(
+	MaterializedViews *views,  // registry
+	const char *name,          // view name
+	const char *query,         // query text
+	const char **labels,       // labels the view depends on
+	const char **relations,    // relationship types the view depends on
+	bool global                // view depends on every graph modification
+);
+
+// returns a reference to view 'name', NULL if no such view
+// the reference is released via MaterializedView_Release
+MaterializedView *MaterializedViews_Get
+(
+	MaterializedViews *views,  // registry
+	const char *name           // view name
+);
+
+// removes view 'name', returns false if no such view
+bool MaterializedViews_Remove
+(
+	MaterializedViews *views,  // registry
+	const char *name           // view name
+);
+
+// free registry and release all of its views
+void MaterializedViews_Free
+(
+	MaterializedViews *views
+);
+
+// query text of 'view'
+const char *MaterializedView_Query
+(
+	const MaterializedView *view
+);
+
+// labels 'view' depends on
+const char **MaterializedView_Labels
+(
+	const MaterializedView *view
+);
+
+// relationship types 'view' depends on
+const char **MaterializedView_Relations
+(
+	const MaterializedView *view
+);
+
+// returns true if 'view' depends on every modification of the graph
+bool MaterializedView_Global
+(
+	const MaterializedView *view
+);
+
+// returns a copy of the view's result if it was computed at 'version'
+// in the given reply format, NULL otherwise
+void *MaterializedView_GetResult
+(
+	MaterializedView *view,  // view
+	uint64_t version,        // current version of the view's dependencies
+	int format               // reply format
+);
+
+// sets the view's result, computed at 'version' in the given reply format
+// the view takes ownership over 'result'
+void MaterializedView_SetResult
+(
+	MaterializedView *view,  // view
+	uint64_t version,        // version of the view's dependencies
+	int format,              // reply format
+	void *result             // view result
+);
+
+// releases a reference to 'view'
+// the view is freed once its last reference is released
+void MaterializedView_Release
+(
+	MaterializedView *view
+);
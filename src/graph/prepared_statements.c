@@ -0,0 +1,181 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "prepared_statements.h"
+#include "RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "rax.h"
+#include <string.h>
+#include <pthread.h>
+
+struct PreparedStatement {
+	char *query;           // query text
+	char *plan_key;        // key under which 'plan' is pinned
+	void *plan;            // pinned plan, NULL until first executed
+	pthread_mutex_t lock;  // guards the pinned plan
+	PreparedStatements *statements;  // owning registry
+};
+
+struct PreparedStatements {
+	rax *handles;                     // query text to statement handle
+	PreparedStatement **statements;   // statements, indexed by handle
+	CacheEntryFreeFunc free_plan;     // frees pinned plans
+	CacheEntryCopyFunc copy_plan;     // copies pinned plans
+	pthread_mutex_t lock;             // guards registration and lookups
+};
+
+PreparedStatements *PreparedStatements_New
+(
+	CacheEntryFreeFunc free_plan,
+	CacheEntryCopyFunc copy_plan
+) {
+	ASSERT(free_plan != NULL);
+	ASSERT(copy_plan != NULL);
+
+	PreparedStatements *statements = rm_malloc(sizeof(PreparedStatements));
+
+	statements->handles    = raxNew();
+	statements->statements = array_new(PreparedStatement *, 0);
+	statements->free_plan  = free_plan;
+	statements->copy_plan  = copy_plan;
+
+	int res = pthread_mutex_init(&statements->lock, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return statements;
+}
+
+int64_t PreparedStatements_Add
+(
+	PreparedStatements *statements,
+	const char *query
+) {
+	ASSERT(query != NULL);
+	ASSERT(statements != NULL);
+
+	size_t len = strlen(query);
+	int64_t handle = -1;
+
+	pthread_mutex_lock(&statements->lock);
+
+	// query already prepared
+	void *existing = raxFind(statements->handles, (unsigned char *)query, len);
+	if(existing != raxNotFound) {
+		handle = (int64_t)(intptr_t)existing;
+		goto cleanup;
+	}
+
+	if(array_len(statements->statements) >= PREPARED_STATEMENTS_MAX) {
+		goto cleanup;
+	}
+
+	PreparedStatement *statement = rm_malloc(sizeof(PreparedStatement));
+	statement->plan       = NULL;
+	statement->query      = rm_strdup(query);
+	statement->plan_key   = NULL;
+	statement->statements = statements;
+	pthread_mutex_init(&statement->lock, NULL);
+
+	handle = array_len(statements->statements);
+	array_append(statements->statements, statement);
+	raxInsert(statements->handles, (unsigned char *)query, len,
+			(void *)(intptr_t)handle, NULL);
+
+cleanup:
+	pthread_mutex_unlock(&statements->lock);
+	return handle;
+}
+
+PreparedStatement *PreparedStatements_Get
+(
+	PreparedStatements *statements,
+	int64_t handle
+) {
+	ASSERT(statements != NULL);
+
+	PreparedStatement *statement = NULL;
+
+	pthread_mutex_lock(&statements->lock);
+	if(handle >= 0 && handle < array_len(statements->statements)) {
+		statement = statements->statements[handle];
+	}
+	pthread_mutex_unlock(&statements->lock);
+
+	return statement;
+}
+
+void PreparedStatements_Free
+(
+	PreparedStatements *statements
+) {
+	ASSERT(statements != NULL);
+
+	uint count = array_len(statements->statements);
+	for(uint i = 0; i < count; i++) {
+		PreparedStatement *statement = statements->statements[i];
+		if(statement->plan != NULL) statements->free_plan(statement->plan);
+		if(statement->plan_key != NULL) rm_free(statement->plan_key);
+		pthread_mutex_destroy(&statement->lock);
+		rm_free(statement->query);
+		rm_free(statement);
+	}
+
+	array_free(statements->statements);
+	raxFree(statements->handles);
+	pthread_mutex_destroy(&statements->lock);
+	rm_free(statements);
+}
+
+const char *PreparedStatement_Query
+(
+	const PreparedStatement *statement
+) {
+	ASSERT(statement != NULL);
+	return statement->query;
+}
+
+void *PreparedStatement_GetPlan
+(
+	PreparedStatement *statement,
+	const char *key
+) {
+	ASSERT(key != NULL);
+	ASSERT(statement != NULL);
+
+	void *plan = NULL;
+
+	pthread_mutex_lock(&statement->lock);
+	if(statement->plan != NULL && strcmp(statement->plan_key, key) == 0) {
+		plan = statement->statements->copy_plan(statement->plan);
+	}
+	pthread_mutex_unlock(&statement->lock);
+
+	return plan;
+}
+
+void PreparedStatement_PinPlan
+(
+	PreparedStatement *statement,
+	char *key,
+	void *plan
+) {
+	ASSERT(key != NULL);
+	ASSERT(plan != NULL);
+	ASSERT(statement != NULL);
+
+	pthread_mutex_lock(&statement->lock);
+	void *prev_plan = statement->plan;
+	char *prev_key = statement->plan_key;
+	statement->plan = plan;
+	statement->plan_key = key;
+	pthread_mutex_unlock(&statement->lock);
+
+	// copies handed out remain valid once their origin is released
+	if(prev_plan != NULL) statement->statements->free_plan(prev_plan);
+	if(prev_key != NULL) rm_free(prev_key);
+}
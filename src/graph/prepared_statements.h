@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "../util/cache/cache_array.h"
+
+// maximum number of statements prepared against a single graph
+#define PREPARED_STATEMENTS_MAX 4096
+
+// registry of the queries prepared against a graph via GRAPH.PREPARE
+// each statement is identified by a handle, preparing the same query
+// twice yields the same handle
+//
+// a statement pins the execution plan it was last executed with
+// such that executions skip both query parsing and plan cache lookups
+// statements are registered and executed concurrently by reader threads
+typedef struct PreparedStatements PreparedStatements;
+typedef struct PreparedStatement PreparedStatement;
+
+// create a new registry
+// 'free_plan' and 'copy_plan' free and copy pinned plans
+PreparedStatements *PreparedStatements_New
+(
+	CacheEntryFreeFunc free_plan,
+	CacheEntryCopyFunc copy_plan
+);
+
+// registers 'query' and returns its handle
+// returns -1 if the registry is full
+int64_t PreparedStatements_Add
+(
+	PreparedStatements *statements,  // registry
+	const char *query                // query text
+);
+
+// returns the statement identified by 'handle', NULL if no such statement
+// statements remain valid for the lifetime of the registry
+PreparedStatement *PreparedStatements_Get
+(
+	PreparedStatements *statements,  // registry
+	int64_t handle                   // statement handle
+);
+
+// free registry and all of its statements
+void PreparedStatements_Free
+(
+	PreparedStatements *statements
+);
+
+// query text of 'statement'
+const char *PreparedStatement_Query
+(
+	const PreparedStatement *statement
+);
+
+// returns a copy of the plan pinned under 'key', NULL if none
+void *PreparedStatement_GetPlan
+(
+	PreparedStatement *statement,  // statement
+	const char *key                // plan key
+);
+
+// pins 'plan' under 'key', replacing the previously pinned plan
+// the statement takes ownership over both 'plan' and 'key'
+void PreparedStatement_PinPlan
+(
+	PreparedStatement *statement,  // statement
+	char *key,                     // plan key
+	void *plan                     // plan to pin
+);
@@ -232,6 +232,7 @@ QueryGraph *QueryGraph_New
 	qg->nodes = array_new(QGNode *, node_cap);
 	qg->edges = array_new(QGEdge *, edge_cap);
 	qg->unknown_reltype_ids = false;
+	qg->refcount = 1;
 
 	return qg;
 }
@@ -512,6 +513,16 @@ QueryGraph *QueryGraph_Clone
 	return clone;
 }
 
+QueryGraph *QueryGraph_Share
+(
+	QueryGraph *qg
+) {
+	ASSERT(qg != NULL);
+
+	__atomic_fetch_add(&qg->refcount, 1, __ATOMIC_RELAXED);
+	return qg;
+}
+
 QGNode *QueryGraph_RemoveNode
 (
 	QueryGraph *qg,
@@ -675,6 +686,53 @@ uint QueryGraph_EdgeCount
 	return array_len(qg->edges);
 }
 
+// returns the position of 'n' within the query graph nodes array
+static uint _QueryGraph_NodeIdx
+(
+	const QueryGraph *qg,
+	const QGNode *n
+) {
+	uint node_count = array_len(qg->nodes);
+	for(uint i = 0; i < node_count; i++) {
+		if(qg->nodes[i] == n) return i;
+	}
+
+	ASSERT(false);
+	return 0;
+}
+
+// an edge connecting two nodes which are already connected closes a cycle
+// track connected nodes using a union-find over node positions
+bool QueryGraph_ContainsCycle
+(
+	const QueryGraph *qg
+) {
+	ASSERT(qg != NULL);
+
+	uint node_count = array_len(qg->nodes);
+	uint edge_count = array_len(qg->edges);
+	if(edge_count == 0) return false;
+
+	uint set[node_count];
+	for(uint i = 0; i < node_count; i++) set[i] = i;
+
+	bool cycle = false;
+	for(uint i = 0; i < edge_count && !cycle; i++) {
+		const QGEdge *e = qg->edges[i];
+		uint a = _QueryGraph_NodeIdx(qg, e->src);
+		uint b = _QueryGraph_NodeIdx(qg, e->dest);
+
+		// find set representatives
+		while(set[a] != a) a = set[a];
+		while(set[b] != b) b = set[b];
+
+		if(a == b) cycle = true;
+		else set[a] = b;
+	}
+
+	return cycle;
+}
+
 GrB_Matrix QueryGraph_MatrixRepresentation
 (
 	const QueryGraph *qg
@@ -750,6 +808,9 @@ void QueryGraph_Free
 ) {
 	if(qg == NULL) return;
 
+	// query graph is still in use by another owner
+	if(__atomic_sub_fetch(&qg->refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
+
 	// free QueryGraph nodes
 	uint nodeCount = QueryGraph_NodeCount(qg);
 	for(uint i = 0; i < nodeCount; i++) {
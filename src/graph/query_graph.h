@@ -19,6 +19,7 @@ typedef struct {
 	QGNode **nodes;             // Nodes contained in QueryGraph
 	QGEdge **edges;             // Edges contained in QueryGraph
 	bool unknown_reltype_ids;   // Indicates if the query graph contains unknown relationship ids.
+	uint refcount;              // Number of owners sharing the query graph.
 } QueryGraph;
 
 typedef enum {
@@ -75,6 +76,10 @@ void QueryGraph_ResolveUnknownRelIDs(QueryGraph *g);
 /* Performs deep copy of input query graph. */
 QueryGraph *QueryGraph_Clone(const QueryGraph *g);
 
+/* Adds an owner to the query graph, which must no longer be modified.
+ * Each owner releases the query graph by calling QueryGraph_Free. */
+QueryGraph *QueryGraph_Share(QueryGraph *g);
+
 /* Remove given node from query graph. */
 QGNode *QueryGraph_RemoveNode(QueryGraph *g, QGNode *n);
 
@@ -91,6 +96,10 @@ uint QueryGraph_NodeCount(const QueryGraph *qg);
 /* Retrieve the number of edges in a QueryGraph. */
 uint QueryGraph_EdgeCount(const QueryGraph *qg);
 
+/* Returns true if the query graph contains a cycle,
+ * self-loops and parallel edges included. */
+bool QueryGraph_ContainsCycle(const QueryGraph *qg);
+
 /* Build a matrix representation of query graph. */
 GrB_Matrix QueryGraph_MatrixRepresentation(const QueryGraph *qg);
 
@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 
 GrB_Info RG_eWiseAdd                // C = A + B
@@ -37,6 +38,9 @@ GrB_Info RG_eWiseAdd                // C = A + B
 
 	// TODO: check A, B and C are compatible
 
+	RG_Matrix_flushDeltaLog(A);
+	RG_Matrix_flushDeltaLog(B);
+
 	GrB_Matrix_nvals(&DM_nvals, ADM);
 	GrB_Matrix_nvals(&DP_nvals, ADP);
 	if(DM_nvals > 0 || DP_nvals > 0) {
@@ -59,7 +63,8 @@ GrB_Info RG_eWiseAdd                // C = A + B
 	// C = A + B
 	//--------------------------------------------------------------------------
 
-	info = GrB_Matrix_eWiseAdd_Semiring(_C, NULL, NULL, semiring, _A, _B, NULL);
+	info = GrB_Matrix_eWiseAdd_Semiring(_C, NULL, NULL, semiring, _A, _B,
+			RG_Matrix_descriptor(NULL));
 	ASSERT(info == GrB_SUCCESS);
 
 	if(_A != AM) GrB_free(&_A);
@@ -0,0 +1,122 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rg_matrix.h"
+
+// computes the flushed content of 'C' into a new matrix
+// formatted as C's main matrix, see RG_Matrix_new
+static GrB_Info _RG_Matrix_compact
+(
+	GrB_Matrix *A,
+	RG_Matrix C
+) {
+	GrB_Info info = RG_Matrix_export(A, C);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(C->hypersparse) {
+		info = GxB_set(*A, GxB_SPARSITY_CONTROL, GxB_SPARSE | GxB_HYPERSPARSE);
+		ASSERT(info == GrB_SUCCESS);
+		info = GxB_set(*A, GxB_HYPER_SWITCH, GxB_HYPER_DEFAULT);
+		ASSERT(info == GrB_SUCCESS);
+	} else {
+		info = GxB_set(*A, GxB_SPARSITY_CONTROL, GxB_SPARSE);
+		ASSERT(info == GrB_SUCCESS);
+		info = GxB_set(*A, GxB_HYPER_SWITCH, GxB_NEVER_HYPER);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	info = GrB_wait(*A, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	return info;
+}
+
+// replaces C's main matrix with 'A' and clears C's delta matrices
+static GrB_Info _RG_Matrix_compact_apply
+(
+	RG_Matrix C,
+	GrB_Matrix *A
+) {
+	GrB_Info info = GrB_Matrix_free(&RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	RG_MATRIX_M(C) = *A;
+	*A = NULL;
+
+	info = GrB_Matrix_clear(RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_clear(RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	return info;
+}
+
+GrB_Info RG_Matrix_delta_nvals
+(
+	GrB_Index *nvals,
+	const RG_Matrix C
+) {
+	ASSERT(C     != NULL);
+	ASSERT(nvals != NULL);
+
+	GrB_Index m_nvals;
+	GrB_Index dp_nvals;
+	GrB_Index dm_nvals;
+
+	GrB_Info info = RG_Matrix_component_nvals(&m_nvals, &dp_nvals, &dm_nvals,
+			C);
+	ASSERT(info == GrB_SUCCESS);
+
+	*nvals = dp_nvals + dm_nvals;
+
+	return info;
+}
+
+GrB_Info RG_Matrix_compact
+(
+	GrB_Matrix *A,
+	GrB_Matrix *AT,
+	RG_Matrix C
+) {
+	ASSERT(A  != NULL);
+	ASSERT(AT != NULL);
+	ASSERT(C  != NULL);
+	ASSERT(!C->dirty);
+
+	GrB_Info info = _RG_Matrix_compact(A, C);
+	ASSERT(info == GrB_SUCCESS);
+
+	*AT = NULL;
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = _RG_Matrix_compact(AT, C->transposed);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	return info;
+}
+
+GrB_Info RG_Matrix_compact_apply
+(
+	RG_Matrix C,
+	GrB_Matrix *A,
+	GrB_Matrix *AT
+) {
+	ASSERT(C  != NULL);
+	ASSERT(A  != NULL && *A != NULL);
+	ASSERT(AT != NULL);
+	ASSERT((*AT != NULL) == (RG_MATRIX_MAINTAIN_TRANSPOSE(C)));
+
+	GrB_Info info = _RG_Matrix_compact_apply(C, A);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = _RG_Matrix_compact_apply(C->transposed, AT);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	return info;
+}
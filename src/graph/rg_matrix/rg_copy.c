@@ -47,6 +47,9 @@ GrB_Info RG_Matrix_copy
 	GrB_Matrix  out_delta_plus   =  RG_MATRIX_DELTA_PLUS(C);
 	GrB_Matrix  out_delta_minus  =  RG_MATRIX_DELTA_MINUS(C);
 
+	RG_Matrix_flushDeltaLog(A);
+	RG_Matrix_freeDeltaLog(C);
+
 	_copyMatrix(in_m, out_m);
 	_copyMatrix(in_delta_plus, out_delta_plus);
 	_copyMatrix(in_delta_minus, out_delta_minus);
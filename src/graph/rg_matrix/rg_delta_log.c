@@ -0,0 +1,204 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rg_utils.h"
+#include "rg_matrix.h"
+#include "../../util/rmalloc.h"
+#include <string.h>
+
+// initial number of additions a log can hold
+#define DELTA_LOG_INIT_CAP 64
+
+static inline uint64_t _Hash
+(
+	GrB_Index i,
+	GrB_Index j
+) {
+	uint64_t h = i * 0x9E3779B97F4A7C15ULL ^ j;
+	h ^= h >> 33;
+	h *= 0xFF51AFD7ED558CCDULL;
+	h ^= h >> 33;
+	return h;
+}
+
+// indexes log position 'pos', the log must hold fewer additions than slots
+static void _Index
+(
+	DeltaLog *log,
+	uint64_t pos
+) {
+	uint64_t mask = log->slot_count - 1;
+	uint64_t s = _Hash(log->I[pos], log->J[pos]) & mask;
+	while(log->slots[s] != 0) s = (s + 1) & mask;
+	log->slots[s] = pos + 1;
+}
+
+// grows the log to hold 'cap' additions, indexed by twice as many slots
+static void _Grow
+(
+	RG_Matrix C,
+	uint64_t cap
+) {
+	DeltaLog *log = &C->delta_log;
+
+	if(log->cap == 0 && RG_MATRIX_MULTI_EDGE(C)) {
+		log->X = rm_malloc(sizeof(uint64_t) * cap);
+	} else if(log->X != NULL) {
+		log->X = rm_realloc(log->X, sizeof(uint64_t) * cap);
+	}
+	log->I = rm_realloc(log->I, sizeof(GrB_Index) * cap);
+	log->J = rm_realloc(log->J, sizeof(GrB_Index) * cap);
+	log->cap = cap;
+
+	// rebuild index
+	rm_free(log->slots);
+	log->slot_count = cap * 2;
+	log->slots = rm_calloc(log->slot_count, sizeof(uint64_t));
+	for(uint64_t pos = 0; pos < log->len; pos++) _Index(log, pos);
+}
+
+uint64_t *RG_Matrix_deltaLogFind
+(
+	const RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j
+) {
+	ASSERT(C != NULL);
+
+	DeltaLog *log = &C->delta_log;
+	if(log->len == 0) return NULL;
+
+	uint64_t mask = log->slot_count - 1;
+	uint64_t s = _Hash(i, j) & mask;
+	for(; log->slots[s] != 0; s = (s + 1) & mask) {
+		uint64_t pos = log->slots[s] - 1;
+		if(log->I[pos] == i && log->J[pos] == j) {
+			// boolean matrices only track the entry's existence
+			return (log->X != NULL) ? log->X + pos : log->slots + s;
+		}
+	}
+
+	return NULL;
+}
+
+void RG_Matrix_deltaLogAppend
+(
+	RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j,
+	uint64_t x
+) {
+	ASSERT(C != NULL);
+	ASSERT(RG_Matrix_deltaLogFind(C, i, j) == NULL);
+
+	DeltaLog *log = &C->delta_log;
+	if(log->len == log->cap) {
+		_Grow(C, (log->cap == 0) ? DELTA_LOG_INIT_CAP : log->cap * 2);
+	}
+
+	uint64_t pos = log->len++;
+	log->I[pos] = i;
+	log->J[pos] = j;
+	if(log->X != NULL) log->X[pos] = x;
+
+	_Index(log, pos);
+}
+
+uint64_t RG_Matrix_deltaLogLen
+(
+	const RG_Matrix C
+) {
+	ASSERT(C != NULL);
+	return C->delta_log.len;
+}
+
+GrB_Info RG_Matrix_flushDeltaLog
+(
+	RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	DeltaLog *log = &C->delta_log;
+	if(log->len == 0) return GrB_SUCCESS;
+
+	GrB_Type    t;
+	GrB_Matrix  T;
+	GrB_Index   nrows;
+	GrB_Index   ncols;
+	GrB_Info    info;
+	GrB_Matrix  dp = RG_MATRIX_DELTA_PLUS(C);
+
+	info = GxB_Matrix_type(&t, dp);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nrows(&nrows, dp);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, dp);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_new(&T, t, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+
+	// logged positions are distinct and missing from dp
+	if(log->X != NULL) {
+		info = GrB_Matrix_build_UINT64(T, log->I, log->J, log->X, log->len,
+				GrB_FIRST_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+	} else {
+		GrB_Scalar s;
+		info = GrB_Scalar_new(&s, GrB_BOOL);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Scalar_setElement_BOOL(s, true);
+		ASSERT(info == GrB_SUCCESS);
+		info = GxB_Matrix_build_Scalar(T, log->I, log->J, s, log->len);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_free(&s);
+	}
+
+	// dp = dp + T
+	GrB_BinaryOp op = (log->X != NULL) ? GrB_FIRST_UINT64 : GrB_LOR;
+	info = GrB_Matrix_eWiseAdd_BinaryOp(dp, NULL, NULL, op, dp, T, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_free(&T);
+
+	// the log's buffers are released, most flushes are followed by
+	// reads rather than by additional writes
+	RG_Matrix_freeDeltaLog(C);
+
+	return info;
+}
+
+void RG_Matrix_freeDeltaLog
+(
+	RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	DeltaLog *log = &C->delta_log;
+
+	if(log->I != NULL) rm_free(log->I);
+	if(log->J != NULL) rm_free(log->J);
+	if(log->X != NULL) rm_free(log->X);
+	if(log->slots != NULL) rm_free(log->slots);
+
+	memset(log, 0, sizeof(DeltaLog));
+}
+
+size_t RG_Matrix_deltaLogMemoryUsage
+(
+	const RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	const DeltaLog *log = &C->delta_log;
+	size_t n = sizeof(GrB_Index) * 2 * log->cap;
+
+	if(log->X != NULL) n += sizeof(uint64_t) * log->cap;
+	n += sizeof(uint64_t) * log->slot_count;
+
+	return n;
+}
@@ -0,0 +1,94 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rg_matrix.h"
+
+// predefined descriptors used by RG_Matrix functions
+typedef enum {
+	DESC_DEFAULT,  // NULL
+	DESC_S,        // GrB_DESC_S
+	DESC_RS,       // GrB_DESC_RS
+	DESC_RSC,      // GrB_DESC_RSC
+	DESC_COUNT
+} DescType;
+
+// per thread copies of the predefined descriptors
+// built-in descriptors are shared and can't carry a per thread budget
+static __thread GrB_Descriptor _descs[DESC_COUNT] = {NULL};
+static __thread int _nthreads = 0;  // calling thread's budget, 0 for global
+
+static GrB_Descriptor _create_descriptor
+(
+	DescType t
+) {
+	GrB_Info info;
+	GrB_Descriptor desc;
+	UNUSED(info);
+
+	info = GrB_Descriptor_new(&desc);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(t == DESC_RS || t == DESC_RSC) {
+		info = GrB_Descriptor_set(desc, GrB_OUTP, GrB_REPLACE);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	if(t != DESC_DEFAULT) {
+		info = GrB_Descriptor_set(desc, GrB_MASK, GrB_STRUCTURE);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	if(t == DESC_RSC) {
+		// combined with the structural setting
+		info = GrB_Descriptor_set(desc, GrB_MASK, GrB_COMP);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	return desc;
+}
+
+void RG_Matrix_setThreadBudget
+(
+	int nthreads
+) {
+	ASSERT(nthreads >= 0);
+	if(nthreads == _nthreads) return;
+
+	_nthreads = nthreads;
+	for(int i = 0; i < DESC_COUNT; i++) {
+		if(_descs[i] == NULL) continue;
+		GrB_Info info = GxB_Desc_set(_descs[i], GxB_DESCRIPTOR_NTHREADS,
+				nthreads);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+	}
+}
+
+GrB_Descriptor RG_Matrix_descriptor
+(
+	GrB_Descriptor desc
+) {
+	// no budget, the predefined descriptors follow the global setting
+	if(_nthreads == 0) return desc;
+
+	DescType t;
+	if(desc == NULL)              t = DESC_DEFAULT;
+	else if(desc == GrB_DESC_S)   t = DESC_S;
+	else if(desc == GrB_DESC_RS)  t = DESC_RS;
+	else if(desc == GrB_DESC_RSC) t = DESC_RSC;
+	else return desc;
+
+	if(_descs[t] == NULL) {
+		_descs[t] = _create_descriptor(t);
+		GrB_Info info = GxB_Desc_set(_descs[t], GxB_DESCRIPTOR_NTHREADS,
+				_nthreads);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+	}
+
+	return _descs[t];
+}
@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 #include "../../util/rmalloc.h"
 
@@ -39,6 +40,9 @@ GrB_Info RG_Matrix_export
 	info = GrB_Matrix_new(&a, t, nrows, ncols);
 	ASSERT(info == GrB_SUCCESS);
 
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
 	info = GrB_wait(dp, GrB_MATERIALIZE);
 	ASSERT(info == GrB_SUCCESS);
 
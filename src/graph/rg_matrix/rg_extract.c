@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 
 GrB_Info RG_Matrix_extractElement_BOOL     // x = A(i,j)
@@ -22,6 +23,13 @@ GrB_Info RG_Matrix_extractElement_BOOL     // x = A(i,j)
 	GrB_Matrix  dp     =  RG_MATRIX_DELTA_PLUS(A);
 	GrB_Matrix  dm     =  RG_MATRIX_DELTA_MINUS(A);
 
+	// logged additions are missing from 'delta-plus'
+	uint64_t *pending = RG_Matrix_deltaLogFind(A, i, j);
+	if(pending != NULL) {
+		*x = true;
+		return GrB_SUCCESS;
+	}
+
 	// if 'delta-plus' exists return dp[i,j]
 	info = GrB_Matrix_extractElement(x, dp, i, j);
 	if(info == GrB_SUCCESS) {
@@ -55,6 +63,13 @@ GrB_Info RG_Matrix_extractElement_UINT64   // x = A(i,j)
 	GrB_Matrix  dp     =  RG_MATRIX_DELTA_PLUS(A);
 	GrB_Matrix  dm     =  RG_MATRIX_DELTA_MINUS(A);
 
+	// logged additions are missing from 'delta-plus'
+	uint64_t *pending = RG_Matrix_deltaLogFind(A, i, j);
+	if(pending != NULL) {
+		*x = *pending;
+		return GrB_SUCCESS;
+	}
+
 	// if 'delta-plus' exists return dp[i,j]
 	info = GrB_Matrix_extractElement(x, dp, i, j);
 	if(info == GrB_SUCCESS) {
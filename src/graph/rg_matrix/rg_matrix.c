@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 #include "../../util/rmalloc.h"
 
@@ -17,6 +18,29 @@ void RG_Matrix_setDirty
 	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) C->transposed->dirty = true;
 }
 
+GrB_Info RG_Matrix_setHypersparse
+(
+	RG_Matrix C
+) {
+	ASSERT(C);
+
+	GrB_Info info;
+	GrB_Matrix m = RG_MATRIX_M(C);
+
+	C->hypersparse = true;
+
+	info = GxB_set(m, GxB_SPARSITY_CONTROL, GxB_SPARSE | GxB_HYPERSPARSE);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_set(m, GxB_HYPER_SWITCH, GxB_HYPER_DEFAULT);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = RG_Matrix_setHypersparse(C->transposed);
+	}
+
+	return info;
+}
+
 RG_Matrix RG_Matrix_getTranspose
 (
 	const RG_Matrix C
@@ -105,10 +129,86 @@ GrB_Info RG_Matrix_nvals    // get the number of entries in a matrix
 	info = GrB_Matrix_nvals(&dm_nvals, dm);
 	ASSERT(info == GrB_SUCCESS);
 
+	// logged additions are missing from DP
+	dp_nvals += RG_Matrix_deltaLogLen(A);
+
 	*nvals = m_nvals + dp_nvals - dm_nvals;
 	return info;
 }
 
+GrB_Info RG_Matrix_component_nvals
+(
+	GrB_Index *m_nvals,
+	GrB_Index *dp_nvals,
+	GrB_Index *dm_nvals,
+	const RG_Matrix C
+) {
+	ASSERT(C        != NULL);
+	ASSERT(m_nvals  != NULL);
+	ASSERT(dp_nvals != NULL);
+	ASSERT(dm_nvals != NULL);
+
+	GrB_Info info;
+
+	info = GrB_Matrix_nvals(m_nvals, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(dp_nvals, RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(dm_nvals, RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	// logged additions are missing from DP
+	*dp_nvals += RG_Matrix_deltaLogLen(C);
+
+	return info;
+}
+
+RG_MatrixStats RG_Matrix_stats
+(
+	const RG_Matrix C
+) {
+	ASSERT(C != NULL);
+	return C->stats;
+}
+
+void RG_Matrix_recordFlush
+(
+	RG_Matrix C,
+	uint64_t elapsed_us
+) {
+	ASSERT(C != NULL);
+
+	C->stats.flushes++;
+	C->stats.last_flush_us = elapsed_us;
+	C->stats.total_flush_us += elapsed_us;
+}
+
+GrB_Info RG_Matrix_memoryUsage
+(
+	size_t *m,
+	size_t *dp,
+	size_t *dm,
+	const RG_Matrix A
+) {
+	ASSERT(A  != NULL);
+	ASSERT(m  != NULL);
+	ASSERT(dp != NULL);
+	ASSERT(dm != NULL);
+
+	GrB_Info info;
+
+	info = GxB_Matrix_memoryUsage(m, RG_MATRIX_M(A));
+	ASSERT(info == GrB_SUCCESS);
+	*m += RG_Matrix_multiEdgesMemoryUsage(A);
+	info = GxB_Matrix_memoryUsage(dp, RG_MATRIX_DELTA_PLUS(A));
+	ASSERT(info == GrB_SUCCESS);
+	*dp += RG_Matrix_deltaLogMemoryUsage(A);
+	info = GxB_Matrix_memoryUsage(dm, RG_MATRIX_DELTA_MINUS(A));
+	ASSERT(info == GrB_SUCCESS);
+
+	return info;
+}
+
 GrB_Info RG_Matrix_clear
 (
     RG_Matrix A
@@ -121,12 +221,15 @@ GrB_Info RG_Matrix_clear
 	info = GrB_Matrix_clear(m);
 	ASSERT(info == GrB_SUCCESS);
 
-	info = GrB_Matrix_clear(m);
+	info = GrB_Matrix_clear(delta_plus);
 	ASSERT(info == GrB_SUCCESS);
 
-	info = GrB_Matrix_clear(m);
+	info = GrB_Matrix_clear(delta_minus);
 	ASSERT(info == GrB_SUCCESS);
 
+	RG_Matrix_freeMultiEdges(A);
+	RG_Matrix_freeDeltaLog(A);
+
 	A->dirty = false;
 	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) A->transposed->dirty = false;
 
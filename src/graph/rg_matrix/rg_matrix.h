@@ -24,6 +24,51 @@ typedef _RG_Matrix *RG_Matrix;
 // Checks if X represents edge ID.
 #define SINGLE_EDGE(x) !((x) & MSB_MASK)
 
+// entries connecting the same pair of nodes through multiple edges
+// hold SET_MSB(slot), the slot locates the entry's edge IDs within the
+// matrix's multi-edge table, see RG_Matrix_multiEdgeIDs
+typedef struct {
+	uint64_t offset;  // position of the slot's first edge ID within 'ids'
+	uint32_t count;   // number of edge IDs held by the slot
+	uint32_t cap;     // number of edge IDs the slot can hold in place
+} MultiEdgeSlot;
+
+// edge IDs of all multi-edge entries, stored contiguously
+// slots outgrowing their capacity move to the end of 'ids'
+// the space they leave behind is reclaimed once the matrix is flushed
+typedef struct {
+	uint64_t *ids;           // edge IDs
+	uint64_t len;            // number of elements in 'ids', including garbage
+	uint64_t cap;            // number of elements 'ids' can hold
+	uint64_t garbage;        // number of elements no slot refers to
+	MultiEdgeSlot *slots;    // multi-edge entries
+	uint64_t *free_slots;    // released slots, reused by new entries
+} MultiEdgeTable;
+
+// additions of entries missing from M, DP and DM are appended to the log
+// rather than inserted into DP one at a time, each insertion into DP
+// followed by a lookup would have GraphBLAS assemble its pending tuples
+// the log is built into DP at once before DP is read, see
+// RG_Matrix_flushDeltaLog, such that logged entries are never within DP
+typedef struct {
+	GrB_Index *I;            // row indices
+	GrB_Index *J;            // column indices
+	uint64_t *X;             // values, NULL for boolean matrices
+	uint64_t len;            // number of logged additions
+	uint64_t cap;            // number of additions the log can hold
+	uint64_t *slots;         // open addressing index, log position + 1
+	uint64_t slot_count;     // number of slots, a power of 2
+} DeltaLog;
+
+// flush and resize counters, see RG_Matrix_recordFlush and RG_Matrix_resize
+// read without synchronization, as such approximate
+typedef struct {
+	uint64_t flushes;         // number of times deltas were merged into M
+	uint64_t last_flush_us;   // duration of the last merge
+	uint64_t total_flush_us;  // accumulated duration of all merges
+	uint64_t resizes;         // number of times the matrix was resized
+} RG_MatrixStats;
+
 #define RG_MATRIX_M(C) (C)->matrix
 #define RG_MATRIX_DELTA_PLUS(C) (C)->delta_plus
 #define RG_MATRIX_DELTA_MINUS(C) (C)->delta_minus
@@ -126,10 +171,14 @@ typedef _RG_Matrix *RG_Matrix;
 
 struct _RG_Matrix {
 	bool dirty;                         // Indicates if matrix requires sync
+	bool hypersparse;                   // M may be stored hypersparse
 	GrB_Matrix matrix;                  // Underlying GrB_Matrix
 	GrB_Matrix delta_plus;              // Pending additions
 	GrB_Matrix delta_minus;             // Pending deletions
 	RG_Matrix transposed;               // Transposed matrix
+	MultiEdgeTable multi_edges;         // edge IDs of multi-edge entries
+	DeltaLog delta_log;                 // additions yet to be built into DP
+	RG_MatrixStats stats;               // flush and resize counters
 	pthread_mutex_t mutex;              // Lock
 };
 
@@ -141,12 +190,52 @@ GrB_Info RG_Matrix_new
 	GrB_Index ncols
 );
 
+// scratch matrices, e.g. a traversal's filter and result matrices
+// are borrowed from a per thread pool of cleared matrices rather than
+// allocated for each execution, pooled matrices are keyed by type and
+// by their number of rows, rounded up to a power of two
+
+// borrows a cleared nrows-by-ncols matrix, allocating one if none is pooled
+GrB_Info RG_Matrix_newScratch
+(
+	RG_Matrix *A,            // handle of matrix to borrow
+	GrB_Type type,           // type of matrix, must be GrB_BOOL
+	GrB_Index nrows,         // matrix dimension is nrows-by-ncols
+	GrB_Index ncols
+);
+
+// returns a borrowed matrix to the calling thread's pool
+// the matrix is freed instead if the pool is full
+// or if the thread exceeded its memory capacity, in which case
+// the pool is trimmed as well
+void RG_Matrix_freeScratch
+(
+	RG_Matrix *A             // matrix to return
+);
+
+// frees the matrices pooled by the calling thread
+void RG_Matrix_trimScratch(void);
+
 // returns transposed matrix of C
 RG_Matrix RG_Matrix_getTranspose
 (
 	const RG_Matrix C
 );
 
+// computes C's transpose from its current content and maintains it
+// from here on, no-op if C already maintains its transpose
+GrB_Info RG_Matrix_buildTranspose
+(
+	RG_Matrix C
+);
+
+// stops maintaining C's transpose and frees it
+// later modifications to C no longer pay for updating the transpose
+void RG_Matrix_dropTranspose
+(
+	RG_Matrix C
+);
+
 // mark matrix as dirty
 void RG_Matrix_setDirty
 (
@@ -158,6 +247,14 @@ bool RG_Matrix_isDirty
 	const RG_Matrix C
 );
 
+// allow C's main matrix to switch to a hypersparse representation
+// once only a small fraction of its rows hold entries
+// e.g. label matrices, where storage drops from O(nrows) to O(nvals)
+GrB_Info RG_Matrix_setHypersparse
+(
+	RG_Matrix C
+);
+
 // locks the matrix
 void RG_Matrix_Lock
 (
@@ -188,6 +285,14 @@ GrB_Info RG_Matrix_nvals    // get the number of entries in a matrix
 	const RG_Matrix A       // matrix to query
 );
 
+GrB_Info RG_Matrix_memoryUsage  // get the number of bytes used by a matrix
+(
+	size_t *m,              // bytes used by M
+	size_t *dp,             // bytes used by delta plus
+	size_t *dm,             // bytes used by delta minus
+	const RG_Matrix A       // matrix to query, excluding its transpose
+);
+
 GrB_Info RG_Matrix_resize      // change the size of a matrix
 (
 	RG_Matrix C,                // matrix to modify
@@ -210,6 +315,29 @@ GrB_Info RG_Matrix_setElement_UINT64      // C (i,j) = x
 	GrB_Index j                         // column index
 );
 
+// sets multiple entries at once, equivalent to calling
+// RG_Matrix_setElement_BOOL for each entry
+// entries missing from M are assembled into delta-plus in bulk
+GrB_Info RG_Matrix_setElements_BOOL     // C (I[k],J[k]) = true
+(
+	RG_Matrix C,                        // matrix to modify
+	const GrB_Index *I,                 // row indices
+	const GrB_Index *J,                 // column indices
+	GrB_Index n                         // number of entries
+);
+
+// sets multiple entries at once, equivalent to calling
+// RG_Matrix_setElement_UINT64 for each entry
+// entries missing from M are assembled into delta-plus in bulk
+GrB_Info RG_Matrix_setElements_UINT64   // C (I[k],J[k]) = X[k]
+(
+	RG_Matrix C,                        // matrix to modify
+	const uint64_t *X,                  // scalars to assign
+	const GrB_Index *I,                 // row indices
+	const GrB_Index *J,                 // column indices
+	GrB_Index n                         // number of entries
+);
+
 GrB_Info RG_Matrix_extractElement_BOOL     // x = A(i,j)
 (
 	bool *x,                               // extracted scalar
@@ -258,6 +386,17 @@ GrB_Info RG_mxm                     // C = A * B
 	const RG_Matrix B               // second input: matrix B
 );
 
+// C<Mask> = A * B where Mask is used as a structural mask
+// a NULL Mask computes every entry of C, same as RG_mxm
+GrB_Info RG_mxm_masked              // C<Mask> = A * B
+(
+    RG_Matrix C,                    // input/output matrix for results
+    const GrB_Matrix Mask,          // optional structural mask for C
+    const GrB_Semiring semiring,    // defines '+' and '*' for A*B
+    const RG_Matrix A,              // first input:  matrix A
+    const RG_Matrix B               // second input: matrix B
+);
+
 GrB_Info RG_eWiseAdd                // C = A + B
 (
     RG_Matrix C,                    // input/output matrix for results
@@ -284,6 +423,81 @@ GrB_Info RG_Matrix_export
 	RG_Matrix C
 );
 
+// returns the edge IDs of multi-edge entry 'x'
+// the IDs remain valid until C's multi-edge entries are modified
+const uint64_t *RG_Matrix_multiEdgeIDs
+(
+	const RG_Matrix C,              // matrix holding the entry
+	uint64_t x,                     // multi-edge entry value
+	uint64_t *n                     // [output] number of edge IDs
+);
+
+// creates a multi-edge entry holding 'ids'
+// returns the value to assign to the entry
+uint64_t RG_Matrix_newMultiEdge
+(
+	RG_Matrix C,                    // matrix to hold the entry
+	const uint64_t *ids,            // edge IDs
+	uint64_t n                      // number of edge IDs, at least 2
+);
+
+// copies A's multi-edge entries to C, C must hold no multi-edge entries
+// entries of A's values remain valid within C
+void RG_Matrix_copyMultiEdges
+(
+	RG_Matrix C,                    // matrix to copy to
+	const RG_Matrix A               // matrix to copy from
+);
+
+// get the number of entries held by each of C's internal matrices
+GrB_Info RG_Matrix_component_nvals
+(
+	GrB_Index *m_nvals,             // number of entries in M
+	GrB_Index *dp_nvals,            // number of pending additions
+	GrB_Index *dm_nvals,            // number of pending deletions
+	const RG_Matrix C               // matrix to query
+);
+
+// returns C's flush and resize counters, excluding its transpose's
+// flush durations include the time spent flushing the transpose
+RG_MatrixStats RG_Matrix_stats
+(
+	const RG_Matrix C               // matrix to query
+);
+
+// accounts for a merge of C's deltas into its main matrix
+void RG_Matrix_recordFlush
+(
+	RG_Matrix C,                    // flushed matrix
+	uint64_t elapsed_us             // duration of the flush
+);
+
+// get the number of entries held by C's delta matrices
+GrB_Info RG_Matrix_delta_nvals
+(
+	GrB_Index *nvals,               // number of pending additions and deletions
+	const RG_Matrix C               // matrix to query
+);
+
+// computes the flushed content of 'C' and its transpose into new matrices
+// without modifying 'C', allowing readers to access 'C' meanwhile
+// 'C' must not be dirty
+GrB_Info RG_Matrix_compact
+(
+	GrB_Matrix *A,                  // [output] flushed 'C'
+	GrB_Matrix *AT,                 // [output] flushed transpose of 'C'
+	RG_Matrix C                     // matrix to compact
+);
+
+// replaces C's content with matrices computed by RG_Matrix_compact
+// clearing C's delta matrices, 'C' must not be modified in between
+GrB_Info RG_Matrix_compact_apply
+(
+	RG_Matrix C,                    // matrix to update
+	GrB_Matrix *A,                  // matrix to replace C's main matrix
+	GrB_Matrix *AT                  // matrix to replace C's transposed matrix
+);
+
 // checks to see if matrix has pending operations
 GrB_Info RG_Matrix_pending
 (
@@ -297,8 +511,38 @@ GrB_Info RG_Matrix_wait
 	bool force_sync
 );
 
+// materialize pending changes without merging them into the main matrix
+// changes are kept in the delta matrices until the next RG_Matrix_wait
+GrB_Info RG_Matrix_waitDeltas
+(
+	RG_Matrix C
+);
+
+// builds C's logged additions into delta-plus and clears the log
+// must be called before accessing delta-plus directly
+GrB_Info RG_Matrix_flushDeltaLog
+(
+	RG_Matrix C
+);
+
 void RG_Matrix_free
 (
 	RG_Matrix *C
 );
 
+
+// sets the maximum number of OpenMP threads used by GraphBLAS operations
+// invoked by the calling thread through RG_Matrix functions
+// 0 restores the global GxB_NTHREADS setting
+void RG_Matrix_setThreadBudget
+(
+	int nthreads                    // thread budget, 0 for global
+);
+
+// returns a descriptor equivalent to 'desc' honoring the calling thread's
+// budget, 'desc' is either NULL or one of the predefined descriptors
+// the returned descriptor is owned by the calling thread
+GrB_Descriptor RG_Matrix_descriptor
+(
+	GrB_Descriptor desc             // descriptor to honor the budget with
+);
@@ -4,10 +4,23 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
+#include <string.h>
 #include "RG.h"
+#include "rg_utils.h"
 #include "./rg_matrix_iter.h"
 #include "../../util/rmalloc.h"
 
+// discard lookahead entries, called whenever the scanned range changes
+static inline void _reset_peek
+(
+	RG_MatrixTupleIter *iter
+) {
+	iter->m.pending   = false;
+	iter->m.depleted  = false;
+	iter->dp.pending  = false;
+	iter->dp.depleted = false;
+}
+
 // create a new iterator
 GrB_Info RG_MatrixTupleIter_new
 (
@@ -21,6 +34,9 @@ GrB_Info RG_MatrixTupleIter_new
 	GrB_Matrix M  = RG_MATRIX_M(A) ;
 	GrB_Matrix DP = RG_MATRIX_DELTA_PLUS(A) ;
 
+	info = RG_Matrix_flushDeltaLog(A) ;
+	ASSERT(info == GrB_SUCCESS) ;
+
 	RG_MatrixTupleIter *it = rm_calloc(1, sizeof(RG_MatrixTupleIter)) ;
 	it->A = A ;
 
@@ -30,6 +46,8 @@ GrB_Info RG_MatrixTupleIter_new
 	info = GxB_MatrixTupleIter_reuse(&(it->dp_it), DP) ;
 	ASSERT(info == GrB_SUCCESS) ;
 
+	_reset_peek(it) ;
+
 	*iter = it ;
 	return info ;
 }
@@ -49,6 +67,8 @@ GrB_Info RG_MatrixTupleIter_iterate_row
 	info = GxB_MatrixTupleIter_iterate_row(&(iter->dp_it), rowIdx) ;
 	ASSERT(info == GrB_SUCCESS) ;
 
+	_reset_peek(iter) ;
+
 	return info ;
 }
 
@@ -67,6 +87,8 @@ GrB_Info RG_MatrixTupleIter_jump_to_row
 	info = GxB_MatrixTupleIter_jump_to_row(&(iter->dp_it), rowIdx) ;
 	ASSERT(info == GrB_SUCCESS) ;
 
+	_reset_peek(iter) ;
+
 	return info ;
 }
 
@@ -88,6 +110,8 @@ GrB_Info RG_MatrixTupleIter_iterate_range
 			endRowIdx) ;
 	ASSERT(info == GrB_SUCCESS) ;
 
+	_reset_peek(iter) ;
+
 	return info ;
 }
 
@@ -127,7 +151,32 @@ static GrB_Info _next_m_iter
 	return info ;
 }
 
+// make sure 'p' holds the next entry of its matrix, unless depleted
+static inline void _peek
+(
+	RG_MatrixTupleIterPeek *p,  // lookahead to fill
+	GxB_MatrixTupleIter *it,    // iterator feeding 'p'
+	const GrB_Matrix DM         // delta-minus, NULL if 'it' scans delta-plus
+) {
+	if(p->pending || p->depleted) return ;
+
+	GrB_Info info ;
+	UNUSED(info) ;
+	if(DM != NULL) {
+		info = _next_m_iter(it, DM, &p->row, &p->col, &p->val, &p->depleted) ;
+	} else {
+		info = GxB_MatrixTupleIter_next(it, &p->row, &p->col, &p->val,
+				&p->depleted) ;
+	}
+	ASSERT(info == GrB_SUCCESS) ;
+
+	p->pending = !p->depleted ;
+}
+
 // advance iterator
+// entries of M and delta-plus are merged in (row, column) order
+// the two never share an entry as additions to M are recorded
+// in delta-plus only when missing from M
 GrB_Info RG_MatrixTupleIter_next
 (
 	RG_MatrixTupleIter *iter,       // iterator to consume
@@ -141,15 +190,33 @@ GrB_Info RG_MatrixTupleIter_next
 	ASSERT(iter        != NULL) ;
 	ASSERT(depleted    != NULL) ;
 
-	GrB_Matrix           DM       =  RG_MATRIX_DELTA_MINUS(iter->A) ;
-	GxB_MatrixTupleIter  *m_it    =  &(iter->m_it)                  ;
-	GxB_MatrixTupleIter  *dp_it   =  &(iter->dp_it)                 ;
+	GrB_Matrix              DM  =  RG_MATRIX_DELTA_MINUS(iter->A) ;
+	RG_MatrixTupleIterPeek  *m  =  &(iter->m)                     ;
+	RG_MatrixTupleIterPeek  *dp =  &(iter->dp)                    ;
+
+	_peek(dp, &(iter->dp_it), NULL) ;
+	_peek(m, &(iter->m_it), DM) ;
+
+	RG_MatrixTupleIterPeek *next ;
+	if(!m->pending) {
+		next = dp ;
+	} else if(!dp->pending) {
+		next = m ;
+	} else {
+		bool m_first = (m->row < dp->row) ||
+			(m->row == dp->row && m->col < dp->col) ;
+		next = m_first ? m : dp ;
+	}
 
-	GrB_Info info = _next_m_iter(m_it, DM, row, col, val, depleted) ;
-	if(!(*depleted)) return info ;
+	*depleted = !next->pending ;
+	if(*depleted) return GrB_SUCCESS ;
 
-	// M iterator depleted, try delta-plus iterator
-	return GxB_MatrixTupleIter_next(dp_it, row, col, val, depleted) ;
+	if(row) *row = next->row ;
+	if(col) *col = next->col ;
+	if(val) memcpy(val, &next->val, iter->m_it.size) ;
+	next->pending = false ;
+
+	return GrB_SUCCESS ;
 }
 
 // reset iterator, assumes the iterator is valid
@@ -167,6 +234,8 @@ GrB_Info RG_MatrixTupleIter_reset
 	info = GxB_MatrixTupleIter_reset(&(iter->dp_it)) ;
 	ASSERT(info == GrB_SUCCESS) ;
 
+	_reset_peek(iter) ;
+
 	return info ;
 }
 
@@ -183,6 +252,9 @@ GrB_Info RG_MatrixTupleIter_reuse
 	GrB_Matrix M  = RG_MATRIX_M(A) ;
 	GrB_Matrix DP = RG_MATRIX_DELTA_PLUS(A) ;
 
+	info = RG_Matrix_flushDeltaLog(A) ;
+	ASSERT(info == GrB_SUCCESS) ;
+
 	iter->A = A ;
 
 	info = GxB_MatrixTupleIter_reuse(&(iter->m_it), M) ;
@@ -191,6 +263,8 @@ GrB_Info RG_MatrixTupleIter_reuse
 	info = GxB_MatrixTupleIter_reuse(&(iter->dp_it), DP) ;
 	ASSERT(info == GrB_SUCCESS) ;
 
+	_reset_peek(iter) ;
+
 	return info;
 }
 
@@ -10,13 +10,29 @@
 #include "./rg_matrix.h"
 #include "../../deps/GraphBLAS/Include/GraphBLAS.h"
 
+// lookahead over one of the iterator's internal matrices
+typedef struct
+{
+    GrB_Index row;                 // row of the pending entry
+    GrB_Index col;                 // column of the pending entry
+    uint64_t val;                  // value of the pending entry
+    bool pending;                  // an entry was read and not yet consumed
+    bool depleted;                 // matrix depleted
+} RG_MatrixTupleIterPeek ;
+
 // TuplesIter maintains information required
 // to iterate over a RG_Matrix
+//
+// entries are produced in (row, column) order by merging the entries of M
+// which aren't deleted by delta-minus with the entries of delta-plus
+// such that a dirty matrix can be scanned without flushing it
 typedef struct
 {
     RG_Matrix A;                   // matrix iterated
     GxB_MatrixTupleIter m_it;      // internal m iterator
     GxB_MatrixTupleIter dp_it;     // internal delta plus iterator
+    RG_MatrixTupleIterPeek m;      // next entry of M
+    RG_MatrixTupleIterPeek dp;     // next entry of delta plus
 } RG_MatrixTupleIter ;
 
 // create a new iterator
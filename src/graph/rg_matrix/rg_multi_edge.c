@@ -0,0 +1,282 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rg_utils.h"
+#include "rg_matrix.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+#include <string.h>
+
+// slot located by multi-edge entry 'x'
+#define SLOT(x) (CLEAR_MSB(x))
+
+// reserves 'n' elements at the end of the table's edge IDs
+// returns the position of the first reserved element
+static uint64_t _Reserve
+(
+	MultiEdgeTable *t,
+	uint64_t n
+) {
+	if(t->len + n > t->cap) {
+		t->cap = (t->cap * 2 > t->len + n) ? t->cap * 2 : t->len + n;
+		t->ids = rm_realloc(t->ids, sizeof(uint64_t) * t->cap);
+	}
+
+	uint64_t offset = t->len;
+	t->len += n;
+	return offset;
+}
+
+// allocates a slot able to hold 'cap' edge IDs
+static uint64_t _NewSlot
+(
+	MultiEdgeTable *t,
+	uint32_t cap
+) {
+	uint64_t s;
+
+	if(t->free_slots != NULL && array_len(t->free_slots) > 0) {
+		s = array_pop(t->free_slots);
+	} else {
+		if(t->slots == NULL) t->slots = array_new(MultiEdgeSlot, 16);
+		MultiEdgeSlot slot = {0};
+		array_append(t->slots, slot);
+		s = array_len(t->slots) - 1;
+	}
+
+	t->slots[s].offset = _Reserve(t, cap);
+	t->slots[s].count  = 0;
+	t->slots[s].cap    = cap;
+
+	return s;
+}
+
+static void _ReleaseSlot
+(
+	MultiEdgeTable *t,
+	uint64_t s
+) {
+	t->garbage += t->slots[s].cap;
+	t->slots[s].count = 0;
+	t->slots[s].cap   = 0;
+
+	if(t->free_slots == NULL) t->free_slots = array_new(uint64_t, 16);
+	array_append(t->free_slots, s);
+}
+
+const uint64_t *RG_Matrix_multiEdgeIDs
+(
+	const RG_Matrix C,
+	uint64_t x,
+	uint64_t *n
+) {
+	ASSERT(C != NULL);
+	ASSERT(n != NULL);
+	ASSERT(!(SINGLE_EDGE(x)));
+
+	const MultiEdgeTable *t = &C->multi_edges;
+	const MultiEdgeSlot *slot = t->slots + SLOT(x);
+	ASSERT(slot->count > 1);
+
+	*n = slot->count;
+	return t->ids + slot->offset;
+}
+
+uint64_t RG_Matrix_newMultiEdge
+(
+	RG_Matrix C,
+	const uint64_t *ids,
+	uint64_t n
+) {
+	ASSERT(C != NULL);
+	ASSERT(ids != NULL);
+	ASSERT(n > 1 && n <= UINT32_MAX);
+
+	MultiEdgeTable *t = &C->multi_edges;
+	uint64_t s = _NewSlot(t, n);
+	MultiEdgeSlot *slot = t->slots + s;
+
+	memcpy(t->ids + slot->offset, ids, sizeof(uint64_t) * n);
+	slot->count = n;
+
+	return SET_MSB(s);
+}
+
+uint64_t RG_Matrix_addMultiEdge
+(
+	RG_Matrix C,
+	uint64_t x,
+	uint64_t id
+) {
+	ASSERT(C != NULL);
+
+	// switching from a single edge ID to multiple IDs
+	if(SINGLE_EDGE(x)) {
+		uint64_t ids[2] = {x, id};
+		return RG_Matrix_newMultiEdge(C, ids, 2);
+	}
+
+	MultiEdgeTable *t = &C->multi_edges;
+	MultiEdgeSlot *slot = t->slots + SLOT(x);
+	ASSERT(slot->cap < UINT32_MAX / 2);
+
+	if(slot->count == slot->cap) {
+		if(slot->offset + slot->cap == t->len) {
+			// slot is last, grow it in place
+			_Reserve(t, slot->cap);
+		} else {
+			// move slot to the end of the table
+			uint64_t offset = _Reserve(t, slot->cap * 2);
+			memcpy(t->ids + offset, t->ids + slot->offset,
+					sizeof(uint64_t) * slot->count);
+			t->garbage += slot->cap;
+			slot->offset = offset;
+		}
+		slot->cap *= 2;
+	}
+
+	t->ids[slot->offset + slot->count] = id;
+	slot->count++;
+
+	return x;
+}
+
+uint64_t RG_Matrix_removeMultiEdge
+(
+	RG_Matrix C,
+	uint64_t x,
+	uint64_t id
+) {
+	ASSERT(C != NULL);
+	ASSERT(!(SINGLE_EDGE(x)));
+
+	MultiEdgeTable *t = &C->multi_edges;
+	MultiEdgeSlot *slot = t->slots + SLOT(x);
+	uint64_t *ids = t->ids + slot->offset;
+
+	// search for edge
+	uint32_t i = 0;
+	for(; i < slot->count; i++) {
+		if(ids[i] == id) break;
+	}
+	ASSERT(i < slot->count);
+
+	// migrate last element into the removed edge's position
+	slot->count--;
+	ids[i] = ids[slot->count];
+
+	// in case we're left with a single edge revert back to scalar
+	if(slot->count == 1) {
+		uint64_t remaining = ids[0];
+		_ReleaseSlot(t, SLOT(x));
+		return remaining;
+	}
+
+	return x;
+}
+
+void RG_Matrix_freeMultiEdge
+(
+	RG_Matrix C,
+	uint64_t x
+) {
+	ASSERT(C != NULL);
+	ASSERT(!(SINGLE_EDGE(x)));
+
+	_ReleaseSlot(&C->multi_edges, SLOT(x));
+}
+
+void RG_Matrix_compactMultiEdges
+(
+	RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	MultiEdgeTable *t = &C->multi_edges;
+	if(t->garbage == 0 || t->garbage < t->len / 2) return;
+
+	// copy each slot's edge IDs into a new array, back to back
+	// slots keep their position, such that entries remain valid
+	uint64_t *ids = NULL;
+	uint64_t live = t->len - t->garbage;
+	if(live > 0) ids = rm_malloc(sizeof(uint64_t) * live);
+
+	uint64_t offset = 0;
+	uint32_t n = (t->slots != NULL) ? array_len(t->slots) : 0;
+	for(uint32_t s = 0; s < n; s++) {
+		MultiEdgeSlot *slot = t->slots + s;
+		if(slot->cap == 0) continue;
+
+		memcpy(ids + offset, t->ids + slot->offset,
+				sizeof(uint64_t) * slot->count);
+		slot->offset = offset;
+		slot->cap    = slot->count;
+		offset += slot->count;
+	}
+
+	rm_free(t->ids);
+	t->ids     = ids;
+	t->len     = offset;
+	t->cap     = live;
+	t->garbage = 0;
+}
+
+void RG_Matrix_copyMultiEdges
+(
+	RG_Matrix C,
+	const RG_Matrix A
+) {
+	ASSERT(C != NULL);
+	ASSERT(A != NULL);
+	ASSERT(C->multi_edges.slots == NULL);
+
+	MultiEdgeTable *dst = &C->multi_edges;
+	const MultiEdgeTable *src = &A->multi_edges;
+
+	*dst = *src;
+
+	if(src->cap > 0) {
+		dst->ids = rm_malloc(sizeof(uint64_t) * src->cap);
+		memcpy(dst->ids, src->ids, sizeof(uint64_t) * src->len);
+	}
+	if(src->slots != NULL) array_clone(dst->slots, src->slots);
+	if(src->free_slots != NULL) array_clone(dst->free_slots, src->free_slots);
+}
+
+void RG_Matrix_freeMultiEdges
+(
+	RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	MultiEdgeTable *t = &C->multi_edges;
+
+	if(t->ids != NULL) rm_free(t->ids);
+	if(t->slots != NULL) array_free(t->slots);
+	if(t->free_slots != NULL) array_free(t->free_slots);
+
+	memset(t, 0, sizeof(MultiEdgeTable));
+}
+
+size_t RG_Matrix_multiEdgesMemoryUsage
+(
+	const RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	const MultiEdgeTable *t = &C->multi_edges;
+	size_t n = sizeof(uint64_t) * t->cap;
+
+	if(t->slots != NULL) {
+		n += sizeof(MultiEdgeSlot) * array_len(t->slots);
+	}
+	if(t->free_slots != NULL) {
+		n += sizeof(uint64_t) * array_len(t->free_slots);
+	}
+
+	return n;
+}
@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 
 GrB_Info RG_mxm                     // C = A * B
@@ -13,6 +14,17 @@ GrB_Info RG_mxm                     // C = A * B
     const GrB_Semiring semiring,    // defines '+' and '*' for A*B
     const RG_Matrix A,              // first input:  matrix A
     const RG_Matrix B               // second input: matrix B
+) {
+	return RG_mxm_masked(C, NULL, semiring, A, B);
+}
+
+GrB_Info RG_mxm_masked              // C<Mask> = A * B
+(
+    RG_Matrix C,                    // input/output matrix for results
+    const GrB_Matrix Mask,          // optional structural mask for C
+    const GrB_Semiring semiring,    // defines '+' and '*' for A*B
+    const RG_Matrix A,              // first input:  matrix A
+    const RG_Matrix B               // second input: matrix B
 ) {
 	ASSERT(C != NULL);
 	ASSERT(A != NULL);
@@ -25,6 +37,8 @@ GrB_Info RG_mxm                     // C = A * B
 	// it is possible for either 'delta-plus' or 'delta-minus' to be empty
 	// this operation performs: A * B by computing:
 	// (A * (M + 'delta-plus'))<!'delta-minus'>
+	//
+	// entries outside of 'Mask' aren't computed
 
 	// validate A is fully synced
 	ASSERT(!RG_Matrix_isDirty(A));
@@ -46,6 +60,8 @@ GrB_Info RG_mxm                     // C = A * B
 	GrB_Matrix  mask   =  NULL;  // entities removed
 	GrB_Matrix  accum  =  NULL;  // entities added
 
+	RG_Matrix_flushDeltaLog(B);
+
 	RG_Matrix_nrows(&nrows, C);
 	RG_Matrix_ncols(&ncols, C);
 	GrB_Matrix_nvals(&dp_nvals, dp);
@@ -56,7 +72,8 @@ GrB_Info RG_mxm                     // C = A * B
 		info = GrB_Matrix_new(&mask, GrB_BOOL, nrows, ncols);
 		ASSERT(info == GrB_SUCCESS);
 
-		info = GrB_mxm(mask, NULL, NULL, GxB_ANY_PAIR_BOOL, _A, dm, NULL);
+		info = GrB_mxm(mask, NULL, NULL, GxB_ANY_PAIR_BOOL, _A, dm,
+				RG_Matrix_descriptor(NULL));
 		ASSERT(info == GrB_SUCCESS);
 
 		// update 'dm_nvals'
@@ -69,7 +86,8 @@ GrB_Info RG_mxm                     // C = A * B
 		info = GrB_Matrix_new(&accum, GrB_BOOL, nrows, ncols);
 		ASSERT(info == GrB_SUCCESS);
 
-		info = GrB_mxm(accum, NULL, NULL, semiring, _A, dp, NULL);
+		info = GrB_mxm(accum, Mask, NULL, semiring, _A, dp,
+				RG_Matrix_descriptor(Mask ? GrB_DESC_S : NULL));
 		ASSERT(info == GrB_SUCCESS);
 
 		// update 'dp_nvals'
@@ -83,22 +101,39 @@ GrB_Info RG_mxm                     // C = A * B
 
 	if (deletions) {
 		desc = GrB_DESC_RSC;
+		if(Mask != NULL) {
+			// combine masks, keep Mask entries not deleted
+			GrB_Matrix m;
+			info = GrB_Matrix_new(&m, GrB_BOOL, nrows, ncols);
+			ASSERT(info == GrB_SUCCESS);
+
+			info = GrB_Matrix_apply(m, mask, NULL, GrB_IDENTITY_BOOL, Mask,
+					RG_Matrix_descriptor(GrB_DESC_RSC));
+			ASSERT(info == GrB_SUCCESS);
+
+			GrB_free(&mask);
+			mask = m;
+			desc = GrB_DESC_RS;
+		}
 	} else {
 		GrB_free(&mask);
-		mask = NULL;
+		mask = (GrB_Matrix)Mask;
+		desc = (Mask != NULL) ? GrB_DESC_RS : NULL;
 	}
 
-	// compute (A * B)<!mask>
-	info = GrB_mxm(_C, mask, NULL, semiring, _A, _B, desc);
+	// compute (A * B)<mask>
+	info = GrB_mxm(_C, mask, NULL, semiring, _A, _B,
+			RG_Matrix_descriptor(desc));
 	ASSERT(info == GrB_SUCCESS);
 
 	if(additions) {
-		info = GrB_eWiseAdd(_C, NULL, NULL, GxB_ANY_PAIR_BOOL, _C, accum, NULL);
+		info = GrB_eWiseAdd(_C, NULL, NULL, GxB_ANY_PAIR_BOOL, _C, accum,
+				RG_Matrix_descriptor(NULL));
 		ASSERT(info == GrB_SUCCESS);
 	}
 
 	// clean up
-	if(mask)  GrB_free(&mask);
+	if(mask && mask != Mask) GrB_free(&mask);
 	if(accum) GrB_free(&accum);
 
 	return info;
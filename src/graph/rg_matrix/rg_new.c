@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 #include "../../util/rmalloc.h"
 
@@ -93,3 +94,50 @@ GrB_Info RG_Matrix_new
 	return info;
 }
 
+
+GrB_Info RG_Matrix_buildTranspose
+(
+	RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) return GrB_SUCCESS;
+
+	GrB_Info  info;
+	GrB_Index nrows;
+	GrB_Index ncols;
+
+	info = GrB_Matrix_nrows(&nrows, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
+	RG_Matrix T = rm_calloc(1, sizeof(_RG_Matrix));
+	info = _RG_Matrix_init(T, GrB_BOOL, ncols, nrows);
+	ASSERT(info == GrB_SUCCESS);
+
+	// transpose M and each of its deltas
+	// such that T's pending changes mirror C's
+	info = GrB_Matrix_apply(T->matrix, NULL, NULL, GxB_ONE_BOOL,
+			RG_MATRIX_M(C), GrB_DESC_T0);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_apply(T->delta_plus, NULL, NULL, GxB_ONE_BOOL,
+			RG_MATRIX_DELTA_PLUS(C), GrB_DESC_T0);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_apply(T->delta_minus, NULL, NULL, GxB_ONE_BOOL,
+			RG_MATRIX_DELTA_MINUS(C), GrB_DESC_T0);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(C->hypersparse) RG_Matrix_setHypersparse(T);
+	T->dirty = C->dirty;
+
+	// publish the transpose once it is complete
+	__atomic_store_n(&C->transposed, T, __ATOMIC_RELEASE);
+
+	return info;
+}
@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 
 GrB_Info RG_Matrix_pending
@@ -46,6 +47,9 @@ GrB_Info RG_Matrix_pending
 	ASSERT(info == GrB_SUCCESS);
 	res |= p;
 
+	// check if additions were logged
+	res |= (RG_Matrix_deltaLogLen(C) > 0);
+
 	// set output
 	*pending = res;
 
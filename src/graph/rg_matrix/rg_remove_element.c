@@ -7,7 +7,6 @@
 #include "RG.h"
 #include "rg_matrix.h"
 #include "rg_utils.h"
-#include "../../util/arr.h"
 #include "../../util/rmalloc.h"
 
 GrB_Info RG_Matrix_removeElement_BOOL
@@ -42,6 +41,10 @@ GrB_Info RG_Matrix_removeElement_BOOL
 		}
 	}
 
+	// logged additions are removed from dp
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
 	info = GrB_Matrix_extractElement(&m_x, m, i, j);
 	in_m = (info == GrB_SUCCESS);
 
@@ -120,6 +123,10 @@ GrB_Info RG_Matrix_removeElement_UINT64
 		}
 	}
 
+	// logged additions are removed from dp
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
 	info = GrB_Matrix_extractElement(&m_x, m, i, j);
 	in_m = (info == GrB_SUCCESS);
 
@@ -146,10 +153,7 @@ GrB_Info RG_Matrix_removeElement_UINT64
 
 	if(in_m) {
 		// free multi-edge entry, leave M[i,j] dirty
-		if((SINGLE_EDGE(m_x)) == false) {
-			m_x = CLEAR_MSB(m_x);
-			array_free((uint64_t *)m_x);
-		}
+		if((SINGLE_EDGE(m_x)) == false) RG_Matrix_freeMultiEdge(C, m_x);
 
 		// mark deletion in delta minus
 		info = GrB_Matrix_setElement(dm, true, i, j);
@@ -162,10 +166,7 @@ GrB_Info RG_Matrix_removeElement_UINT64
 
 	if(in_dp) {
 		// free multi-edge entry
-		if((SINGLE_EDGE(dp_x)) == false) {
-			dp_x = CLEAR_MSB(dp_x);
-			array_free((uint64_t *)dp_x);
-		}
+		if((SINGLE_EDGE(dp_x)) == false) RG_Matrix_freeMultiEdge(C, dp_x);
 
 		// remove entry from 'dp'
 		info = GrB_Matrix_removeElement(dp, i, j);
@@ -7,45 +7,11 @@
 #include "RG.h"
 #include "rg_utils.h"
 #include "rg_matrix.h"
-#include "../../util/arr.h"
 #include "../../util/rmalloc.h"
 
-static bool _removeEntryFromMultiValArr
-(
-	uint64_t **entries,  // multi-value array
-	uint64_t entry       // element to remove output new value
-) {
-	ASSERT(*entries != NULL);
-
-	uint  i  =  0;
-	uint  n  =  array_len(*entries);
-
-	// search for entry
-	for(; i < n; i++) {
-		if((*entries)[i] == entry) {
-			break;
-		}
-	}
-
-	ASSERT(i < n);
-
-	// remove located entry
-	// migrate last element and reduce array size
-	array_del_fast(*entries, i);
-
-	// incase we're left with a single entry revert back to scalar
-	if(array_len(*entries) == 1) {
-		entry = (*entries)[0];
-		array_free(*entries);
-		*entries = (uint64_t *)entry;
-		return true;
-	}
-
-	return false;
-}
-
 static GrB_Info _removeElementMultiVal
 (
+    RG_Matrix C,                    // matrix owning A's multi-edges
     GrB_Matrix A,                   // matrix to remove entry from
     GrB_Index i,                    // row index
     GrB_Index j,                    // column index
@@ -62,12 +28,11 @@ static GrB_Info _removeElementMultiVal
 	ASSERT((SINGLE_EDGE(x)) == false);
 
 	// remove entry from multi-value
-	x  = CLEAR_MSB(x);
-	uint64_t *entries  = (uint64_t *)x;
-	if(_removeEntryFromMultiValArr(&entries, v)) {
+	// incase we're left with a single entry revert back to scalar
+	tx = RG_Matrix_removeMultiEdge(C, x, v);
+	if(tx != x) {
 		// update entry
-		x = (uint64_t)entries;
-		info = GrB_Matrix_setElement(A, x, i, j);
+		info = GrB_Matrix_setElement(A, tx, i, j);
 	}
 
 	return info;
@@ -103,6 +68,10 @@ GrB_Info RG_Matrix_removeEntry
 
 	// entry should exists in either delta-plus or main
 	// locate entry
+	// logged additions are removed from dp
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
 	info = GrB_Matrix_extractElement(&m_x, m, i, j);
 	in_m = (info == GrB_SUCCESS);
 
@@ -132,11 +101,13 @@ GrB_Info RG_Matrix_removeEntry
 			// mark deletion in delta minus
 			info = GrB_Matrix_setElement(dm, true, i, j);
 			ASSERT(info == GrB_SUCCESS);
-			info = RG_Matrix_removeElement_BOOL(C->transposed, j, i);
-			ASSERT(info == GrB_SUCCESS)
+			if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+				info = RG_Matrix_removeElement_BOOL(C->transposed, j, i);
+				ASSERT(info == GrB_SUCCESS)
+			}
 			RG_Matrix_setDirty(C);
 		} else {
-			info = _removeElementMultiVal(m, i, j, v);
+			info = _removeElementMultiVal(C, m, i, j, v);
 			ASSERT(info == GrB_SUCCESS);
 		}
 	}
@@ -149,11 +120,13 @@ GrB_Info RG_Matrix_removeEntry
 		if(SINGLE_EDGE(dp_x)) {
 			info = GrB_Matrix_removeElement(dp, i, j);
 			ASSERT(info == GrB_SUCCESS);
-			info = RG_Matrix_removeElement_BOOL(C->transposed, j, i);
-			ASSERT(info == GrB_SUCCESS)
+			if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+				info = RG_Matrix_removeElement_BOOL(C->transposed, j, i);
+				ASSERT(info == GrB_SUCCESS)
+			}
 			RG_Matrix_setDirty(C);
 		} else {
-			info = _removeElementMultiVal(dp, i, j, v);
+			info = _removeElementMultiVal(C, dp, i, j, v);
 			ASSERT(info == GrB_SUCCESS);
 		}
 	}
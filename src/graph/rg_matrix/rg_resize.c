@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 
 GrB_Info RG_Matrix_resize       // change the size of a matrix
@@ -25,6 +26,12 @@ GrB_Info RG_Matrix_resize       // change the size of a matrix
 	GrB_Matrix  delta_plus   =  RG_MATRIX_DELTA_PLUS(C);
 	GrB_Matrix  delta_minus  =  RG_MATRIX_DELTA_MINUS(C);
 
+	// logged additions might fall outside of the new dimensions
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
+	C->stats.resizes++;
+
 	info = GrB_Matrix_resize(m, nrows_new, ncols_new);
 	ASSERT(info == GrB_SUCCESS);
 
@@ -0,0 +1,111 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "rg_matrix.h"
+#include "../../util/rmalloc.h"
+
+// maximum number of idle scratch matrices kept by each thread
+#define SCRATCH_CACHE_CAP 8
+
+// an idle scratch matrix
+typedef struct {
+	RG_Matrix A;     // cleared matrix
+	GrB_Type type;   // matrix type
+	uint class;      // dimension class of A
+} ScratchMatrix;
+
+// matrices released by a thread's operations are kept cleared
+// such that the next query executed by the thread skips allocating them
+static __thread ScratchMatrix _scratch[SCRATCH_CACHE_CAP];
+static __thread uint _scratch_count = 0;
+
+// matrices whose number of rows is within the same power of two
+// are interchangeable, a reused matrix is resized to the requested dimensions
+static inline uint _DimClass
+(
+	GrB_Index nrows
+) {
+	return (nrows == 0) ? 0 : 64 - __builtin_clzll(nrows);
+}
+
+GrB_Info RG_Matrix_newScratch
+(
+	RG_Matrix *A,
+	GrB_Type type,
+	GrB_Index nrows,
+	GrB_Index ncols
+) {
+	ASSERT(A != NULL);
+	// scratch matrices don't maintain a transpose
+	ASSERT(type == GrB_BOOL);
+
+	uint class = _DimClass(nrows);
+	for(uint i = 0; i < _scratch_count; i++) {
+		ScratchMatrix *s = _scratch + i;
+		if(s->type != type || s->class != class) continue;
+
+		*A = s->A;
+		*s = _scratch[--_scratch_count];
+
+		GrB_Index cur_nrows;
+		GrB_Index cur_ncols;
+		RG_Matrix_nrows(&cur_nrows, *A);
+		RG_Matrix_ncols(&cur_ncols, *A);
+		if(cur_nrows != nrows || cur_ncols != ncols) {
+			return RG_Matrix_resize(*A, nrows, ncols);
+		}
+		return GrB_SUCCESS;
+	}
+
+	return RG_Matrix_new(A, type, nrows, ncols);
+}
+
+void RG_Matrix_freeScratch
+(
+	RG_Matrix *A
+) {
+	ASSERT(A != NULL);
+
+	RG_Matrix M = *A;
+	if(M == NULL) return;
+	*A = NULL;
+
+	// under memory pressure release rather than keep matrices
+	if(rm_mem_capacity_exceeded()) {
+		RG_Matrix_trimScratch();
+		RG_Matrix_free(&M);
+		return;
+	}
+
+	GrB_Type  type;
+	GrB_Index nrows;
+	GrB_Info  info;
+	UNUSED(info);
+
+	info = GxB_Matrix_type(&type, RG_MATRIX_M(M));
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_nrows(&nrows, M);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_clear(M);
+	ASSERT(info == GrB_SUCCESS);
+
+	// evict the oldest idle matrix
+	if(_scratch_count == SCRATCH_CACHE_CAP) {
+		RG_Matrix_free(&_scratch[0].A);
+		_scratch[0] = _scratch[--_scratch_count];
+	}
+
+	_scratch[_scratch_count++] = (ScratchMatrix) {
+		.A = M, .type = type, .class = _DimClass(nrows)
+	};
+}
+
+void RG_Matrix_trimScratch(void) {
+	for(uint i = 0; i < _scratch_count; i++) RG_Matrix_free(&_scratch[i].A);
+	_scratch_count = 0;
+}
@@ -7,6 +7,7 @@
 #include "RG.h"
 #include "rg_utils.h"
 #include "rg_matrix.h"
+#include "../../util/rmalloc.h"
 
 GrB_Info RG_Matrix_setElement_BOOL      // C (i,j) = x
 (
@@ -44,11 +45,12 @@ GrB_Info RG_Matrix_setElement_BOOL      // C (i,j) = x
 		info = GrB_Matrix_extractElement(&v, m, i, j);
 		already_allocated = (info == GrB_SUCCESS);
 
-		if(!already_allocated) {
-			// update entry to dp[i, j]
-			info = GrB_Matrix_setElement_BOOL(dp, true, i, j);
-			ASSERT(info == GrB_SUCCESS);
+		if(!already_allocated && RG_Matrix_deltaLogFind(C, i, j) == NULL &&
+		   GrB_Matrix_extractElement(&v, dp, i, j) != GrB_SUCCESS) {
+			// log addition, built into dp once dp is read
+			RG_Matrix_deltaLogAppend(C, i, j, true);
 		}
+		info = GrB_SUCCESS;
 	}
 
 	RG_Matrix_setDirty(C);
@@ -56,3 +58,101 @@ GrB_Info RG_Matrix_setElement_BOOL      // C (i,j) = x
 	return info;
 }
 
+
+GrB_Info RG_Matrix_setElements_BOOL     // C (I[k],J[k]) = true
+(
+    RG_Matrix C,                        // matrix to modify
+    const GrB_Index *I,                 // row indices
+    const GrB_Index *J,                 // column indices
+    GrB_Index n                         // number of entries
+) {
+	ASSERT(C != NULL);
+	ASSERT(!RG_MATRIX_MULTI_EDGE(C));
+	ASSERT(n == 0 || (I != NULL && J != NULL));
+
+	if(n == 0) return GrB_SUCCESS;
+
+	bool v;
+	GrB_Info info;
+	UNUSED(info);
+
+	// entries are assembled into dp, which mustn't miss logged additions
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = RG_Matrix_setElements_BOOL(C->transposed, J, I, n);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	GrB_Index  nrows;
+	GrB_Index  ncols;
+	GrB_Index  dm_nvals;
+	GrB_Matrix m   = RG_MATRIX_M(C);
+	GrB_Matrix dp  = RG_MATRIX_DELTA_PLUS(C);
+	GrB_Matrix dm  = RG_MATRIX_DELTA_MINUS(C);
+
+	info = GrB_Matrix_nvals(&dm_nvals, dm);
+	ASSERT(info == GrB_SUCCESS);
+
+	// collect entries missing from 'm', these are assembled into delta-plus
+	GrB_Index dp_n = 0;
+	GrB_Index *dp_I = rm_malloc(sizeof(GrB_Index) * n);
+	GrB_Index *dp_J = rm_malloc(sizeof(GrB_Index) * n);
+
+	for(GrB_Index k = 0; k < n; k++) {
+		GrB_Index i = I[k];
+		GrB_Index j = J[k];
+		RG_Matrix_checkBounds(C, i, j);
+
+		if(dm_nvals > 0 && GrB_Matrix_extractElement(&v, dm, i, j) == GrB_SUCCESS) {
+			// unset delta-minus m already assign to true
+			info = GrB_Matrix_removeElement(dm, i, j);
+			ASSERT(info == GrB_SUCCESS);
+			dm_nvals--;
+			continue;
+		}
+
+		if(GrB_Matrix_extractElement(&v, m, i, j) == GrB_SUCCESS) continue;
+
+		dp_I[dp_n] = i;
+		dp_J[dp_n] = j;
+		dp_n++;
+	}
+
+	if(dp_n > 0) {
+		GrB_Matrix T;
+		GrB_Scalar s;
+
+		info = GrB_Matrix_nrows(&nrows, dp);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_ncols(&ncols, dp);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = GrB_Scalar_new(&s, GrB_BOOL);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Scalar_setElement_BOOL(s, true);
+		ASSERT(info == GrB_SUCCESS);
+
+		// duplicate entries collapse into a single entry
+		info = GrB_Matrix_new(&T, GrB_BOOL, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+		info = GxB_Matrix_build_Scalar(T, dp_I, dp_J, s, dp_n);
+		ASSERT(info == GrB_SUCCESS);
+
+		// dp = dp + T
+		info = GrB_Matrix_eWiseAdd_BinaryOp(dp, NULL, NULL, GrB_LOR, dp, T,
+				NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_free(&T);
+		GrB_free(&s);
+	}
+
+	rm_free(dp_I);
+	rm_free(dp_J);
+
+	RG_Matrix_setDirty(C);
+
+	return GrB_SUCCESS;
+}
@@ -7,53 +7,36 @@
 #include "RG.h"
 #include "rg_utils.h"
 #include "rg_matrix.h"
-#include "../../util/arr.h"
-
-static GrB_BinaryOp _graph_edge_accum = NULL;
-
-void _edge_accum(void *_z, const void *_x, const void *_y) {
-	uint64_t *ids;
-	uint64_t       *z  =  (uint64_t *)        _z;
-	const uint64_t *x  =  (const uint64_t *)  _x;
-	const uint64_t *y  =  (const uint64_t *)  _y;
-
-	// single edge ID,
-	// switching from single edge ID to multiple IDs
-	if(SINGLE_EDGE(*x)) {
-		ids = array_new(uint64_t, 2);
-		array_append(ids, *x);
-		array_append(ids, *y);
-	} else {
-		// multiple edges, adding another edge
-		ids = (uint64_t *)(CLEAR_MSB(*x));
-		array_append(ids, *y);
-	}
-
-	*z = (uint64_t)SET_MSB(ids);
-}
+#include "../../util/rmalloc.h"
 
 // dealing with multi-value entries
+// adds edge 'x' to A(i,j), an existing entry turns into a multi-edge entry
 static GrB_Info setMultiEdgeEntry
 (
+    RG_Matrix C,                        // matrix owning A's multi-edges
     GrB_Matrix A,                       // matrix to modify
     uint64_t x,                         // scalar to assign to A(i,j)
     GrB_Index i,                        // row index
     GrB_Index j                         // column index
 ) {
-	GrB_Info info;
+	uint64_t v;
+	GrB_Info info = GrB_Matrix_extractElement_UINT64(&v, A, i, j);
 
-	// create edge accumulator binary function
-	// TODO: remove if condition, initialize binary operation at module load
-	if(!_graph_edge_accum) {
-		info = GrB_BinaryOp_new(&_graph_edge_accum, _edge_accum, GrB_UINT64, 
-								GrB_UINT64, GrB_UINT64);
+	if(info == GrB_NO_VALUE) {
+		info = GrB_Matrix_setElement_UINT64(A, x, i, j);
 		ASSERT(info == GrB_SUCCESS);
+		return info;
 	}
 
-	info = GxB_Matrix_subassign_UINT64(A, NULL, _graph_edge_accum, 
-									   x, &i, 1, &j, 1, NULL);
 	ASSERT(info == GrB_SUCCESS);
 
+	// entry is only updated when switching from a single edge ID
+	uint64_t z = RG_Matrix_addMultiEdge(C, v, x);
+	if(z != v) {
+		info = GrB_Matrix_setElement_UINT64(A, z, i, j);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
 	return info;
 }
 
@@ -119,10 +102,22 @@ GrB_Info RG_Matrix_setElement_UINT64    // C (i,j) = x
 
 		if(entry_exists) {
 			// update entry at m[i,j]
-			info = setMultiEdgeEntry(m, x, i, j);
+			info = setMultiEdgeEntry(C, m, x, i, j);
 		} else {
-			// update entry at dp[i,j]
-			info = setMultiEdgeEntry(dp, x, i, j);
+			uint64_t *pending = RG_Matrix_deltaLogFind(C, i, j);
+			if(pending != NULL) {
+				// addition already logged
+				*pending = RG_Matrix_addMultiEdge(C, *pending, x);
+				info = GrB_SUCCESS;
+			} else if(GrB_Matrix_extractElement_UINT64(&v, dp, i, j) ==
+					GrB_SUCCESS) {
+				// update entry at dp[i,j]
+				info = setMultiEdgeEntry(C, dp, x, i, j);
+			} else {
+				// log addition, built into dp once dp is read
+				RG_Matrix_deltaLogAppend(C, i, j, x);
+				info = GrB_SUCCESS;
+			}
 		}
 	}
 
@@ -131,3 +126,161 @@ GrB_Info RG_Matrix_setElement_UINT64    // C (i,j) = x
 	return info;
 }
 
+
+// entry assembled into delta-plus
+typedef struct {
+	GrB_Index i;  // row index
+	GrB_Index j;  // column index
+	uint64_t x;   // edge ID
+} PendingEntry;
+
+static int _PendingEntryCmp(const void *a, const void *b) {
+	const PendingEntry *ea = a;
+	const PendingEntry *eb = b;
+	if(ea->i != eb->i) return (ea->i < eb->i) ? -1 : 1;
+	if(ea->j != eb->j) return (ea->j < eb->j) ? -1 : 1;
+	return 0;
+}
+
+GrB_Info RG_Matrix_setElements_UINT64   // C (I[k],J[k]) = X[k]
+(
+    RG_Matrix C,                        // matrix to modify
+    const uint64_t *X,                  // scalars to assign
+    const GrB_Index *I,                 // row indices
+    const GrB_Index *J,                 // column indices
+    GrB_Index n                         // number of entries
+) {
+	ASSERT(C != NULL);
+	ASSERT(n == 0 || (X != NULL && I != NULL && J != NULL));
+
+	if(n == 0) return GrB_SUCCESS;
+
+	uint64_t  v;
+	GrB_Info  info;
+
+	// entries are assembled into dp, which mustn't miss logged additions
+	info = RG_Matrix_flushDeltaLog(C);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		info = RG_Matrix_setElements_BOOL(C->transposed, J, I, n);
+		if(info != GrB_SUCCESS) {
+			return info;
+		}
+	}
+
+	GrB_Index  nrows;
+	GrB_Index  ncols;
+	GrB_Index  dm_nvals;
+	GrB_Matrix m   = RG_MATRIX_M(C);
+	GrB_Matrix dp  = RG_MATRIX_DELTA_PLUS(C);
+	GrB_Matrix dm  = RG_MATRIX_DELTA_MINUS(C);
+
+	info = GrB_Matrix_nvals(&dm_nvals, dm);
+	ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// set entries already present in 'm' one by one
+	//--------------------------------------------------------------------------
+
+	GrB_Index dp_n = 0;
+	PendingEntry *entries = rm_malloc(sizeof(PendingEntry) * n);
+
+	for(GrB_Index k = 0; k < n; k++) {
+		GrB_Index i = I[k];
+		GrB_Index j = J[k];
+		RG_Matrix_checkBounds(C, i, j);
+
+		if(dm_nvals > 0 && GrB_Matrix_extractElement(&v, dm, i, j) == GrB_SUCCESS) {
+			// m contains single edge, simple replace
+			info = GrB_Matrix_removeElement(dm, i, j);
+			ASSERT(info == GrB_SUCCESS);
+			info = GrB_Matrix_setElement(m, X[k], i, j);
+			ASSERT(info == GrB_SUCCESS);
+			dm_nvals--;
+			continue;
+		}
+
+		if(GrB_Matrix_extractElement_UINT64(&v, m, i, j) == GrB_SUCCESS) {
+			info = setMultiEdgeEntry(C, m, X[k], i, j);
+			ASSERT(info == GrB_SUCCESS);
+			continue;
+		}
+
+		entries[dp_n].i = i;
+		entries[dp_n].j = j;
+		entries[dp_n].x = X[k];
+		dp_n++;
+	}
+
+	//--------------------------------------------------------------------------
+	// assemble remaining entries into delta-plus
+	//--------------------------------------------------------------------------
+
+	if(dp_n > 0) {
+		// sort entries by position, the first edge of each position is
+		// assembled, additional edges connecting the same nodes are
+		// accumulated afterwards
+		qsort(entries, dp_n, sizeof(PendingEntry), _PendingEntryCmp);
+
+		GrB_Index  T_n   = 0;
+		GrB_Index  *T_I  = rm_malloc(sizeof(GrB_Index) * dp_n);
+		GrB_Index  *T_J  = rm_malloc(sizeof(GrB_Index) * dp_n);
+		uint64_t   *T_X  = rm_malloc(sizeof(uint64_t) * dp_n);
+
+		for(GrB_Index k = 0; k < dp_n; k++) {
+			if(k > 0 && _PendingEntryCmp(entries + k - 1, entries + k) == 0) {
+				continue;
+			}
+
+			// position already pending, becomes a multi-edge entry
+			if(GrB_Matrix_extractElement_UINT64(&v, dp, entries[k].i,
+						entries[k].j) == GrB_SUCCESS) {
+				info = setMultiEdgeEntry(C, dp, entries[k].x, entries[k].i,
+						entries[k].j);
+				ASSERT(info == GrB_SUCCESS);
+				continue;
+			}
+
+			T_I[T_n] = entries[k].i;
+			T_J[T_n] = entries[k].j;
+			T_X[T_n] = entries[k].x;
+			T_n++;
+		}
+
+		info = GrB_Matrix_nrows(&nrows, dp);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_ncols(&ncols, dp);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_Matrix T;
+		info = GrB_Matrix_new(&T, GrB_UINT64, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_build_UINT64(T, T_I, T_J, T_X, T_n, GrB_FIRST_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+
+		// dp = dp + T, T's positions are missing from dp
+		info = GrB_Matrix_eWiseAdd_BinaryOp(dp, NULL, NULL, GrB_FIRST_UINT64,
+				dp, T, NULL);
+		ASSERT(info == GrB_SUCCESS);
+		GrB_free(&T);
+
+		// accumulate additional edges connecting the same nodes
+		for(GrB_Index k = 1; k < dp_n; k++) {
+			if(_PendingEntryCmp(entries + k - 1, entries + k) != 0) continue;
+			info = setMultiEdgeEntry(C, dp, entries[k].x, entries[k].i,
+					entries[k].j);
+			ASSERT(info == GrB_SUCCESS);
+		}
+
+		rm_free(T_I);
+		rm_free(T_J);
+		rm_free(T_X);
+	}
+
+	rm_free(entries);
+
+	RG_Matrix_setDirty(C);
+
+	return GrB_SUCCESS;
+}
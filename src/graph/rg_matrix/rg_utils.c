@@ -5,6 +5,7 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 
 // check if i and j are within matrix boundries
@@ -87,7 +88,8 @@ void RG_Matrix_validateState
 	UNUSED(pending_deletion);
 
 	existing_entry    =  info_m  == GrB_SUCCESS;
-	pending_addition  =  info_dp == GrB_SUCCESS;
+	pending_addition  =  info_dp == GrB_SUCCESS ||
+		RG_Matrix_deltaLogFind(C, i, j) != NULL;
 	pending_deletion  =  info_dm == GrB_SUCCESS;
 
 	//--------------------------------------------------------------------------
@@ -29,3 +29,85 @@ void RG_Matrix_validateState
 	GrB_Index j
 );
 
+// adds edge 'id' to the entry valued 'x'
+// turning a single edge entry into a multi-edge entry
+// returns the entry's new value
+uint64_t RG_Matrix_addMultiEdge
+(
+	RG_Matrix C,
+	uint64_t x,
+	uint64_t id
+);
+
+// removes edge 'id' from multi-edge entry 'x'
+// returns the entry's new value, the remaining edge ID
+// once only a single edge is left
+uint64_t RG_Matrix_removeMultiEdge
+(
+	RG_Matrix C,
+	uint64_t x,
+	uint64_t id
+);
+
+// releases multi-edge entry 'x'
+void RG_Matrix_freeMultiEdge
+(
+	RG_Matrix C,
+	uint64_t x
+);
+
+// reclaims the space left behind by relocated and released entries
+// once it amounts to half of C's multi-edge table
+void RG_Matrix_compactMultiEdges
+(
+	RG_Matrix C
+);
+
+// frees C's multi-edge table
+void RG_Matrix_freeMultiEdges
+(
+	RG_Matrix C
+);
+
+// returns the number of bytes used by C's multi-edge table
+size_t RG_Matrix_multiEdgesMemoryUsage
+(
+	const RG_Matrix C
+);
+
+// returns the value of C's logged addition at position [i,j]
+// NULL if no addition was logged for [i,j]
+uint64_t *RG_Matrix_deltaLogFind
+(
+	const RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j
+);
+
+// logs the addition of entry [i,j], which must be missing from
+// C's main and delta matrices, 'x' is ignored by boolean matrices
+void RG_Matrix_deltaLogAppend
+(
+	RG_Matrix C,
+	GrB_Index i,
+	GrB_Index j,
+	uint64_t x
+);
+
+// returns the number of additions logged by C
+uint64_t RG_Matrix_deltaLogLen
+(
+	const RG_Matrix C
+);
+
+// frees C's log
+void RG_Matrix_freeDeltaLog
+(
+	RG_Matrix C
+);
+
+// returns the number of bytes used by C's log
+size_t RG_Matrix_deltaLogMemoryUsage
+(
+	const RG_Matrix C
+);
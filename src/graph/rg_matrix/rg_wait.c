@@ -5,8 +5,10 @@
 */
 
 #include "RG.h"
+#include "rg_utils.h"
 #include "rg_matrix.h"
 #include "../../util/rmalloc.h"
+#include "../../util/simple_timer.h"
 #include "configuration/config.h"
 
 static inline void _SetUndirty
@@ -89,24 +91,36 @@ static GrB_Info RG_Matrix_sync
 	info = GrB_wait(m, GrB_MATERIALIZE);
 	ASSERT(info == GrB_SUCCESS);
 
+	// reclaim space left behind by deleted and relocated multi-edge entries
+	RG_Matrix_compactMultiEdges(C);
+
 	return info;
 }
 
-GrB_Info RG_Matrix_wait
+// materialize pending changes
+// delta matrices are merged into M once they hold 'max_pending' changes
+static GrB_Info _RG_Matrix_wait
 (
 	RG_Matrix A,
-	bool force_sync
+	bool force_sync,
+	uint64_t max_pending
 ) {
 	ASSERT(A != NULL);
+
+	double tic[2];
+	simple_tic(tic);
+
 	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) {
-		RG_Matrix_wait(A->transposed, force_sync);
+		_RG_Matrix_wait(A->transposed, force_sync, max_pending);
 	}
-	
+
 	GrB_Info    info         =  GrB_SUCCESS;
-	GrB_Matrix  m            =  RG_MATRIX_M(A);
 	GrB_Matrix  delta_plus   =  RG_MATRIX_DELTA_PLUS(A);
 	GrB_Matrix  delta_minus  =  RG_MATRIX_DELTA_MINUS(A);
 
+	info = RG_Matrix_flushDeltaLog(A);
+	ASSERT(info == GrB_SUCCESS);
+
 	info = GrB_wait(delta_plus, GrB_MATERIALIZE);
 	ASSERT(info == GrB_SUCCESS);
 
@@ -120,11 +134,12 @@ GrB_Info RG_Matrix_wait
 	GrB_Matrix_nvals(&delta_plus_nvals, delta_plus);
 	GrB_Matrix_nvals(&delta_minus_nvals, delta_minus);
 
-	uint64_t delta_max_pending_changes;
-	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES, &delta_max_pending_changes);
 	if(force_sync ||
-	   delta_plus_nvals + delta_minus_nvals >= delta_max_pending_changes) {
+	   delta_plus_nvals + delta_minus_nvals >= max_pending) {
 		info = RG_Matrix_sync(A);
+
+		// the flush's duration includes flushing the transpose
+		RG_Matrix_recordFlush(A, simple_toc(tic) * 1000000);
 	}
 
 	_SetUndirty(A);
@@ -132,3 +147,19 @@ GrB_Info RG_Matrix_wait
 	return info;
 }
 
+GrB_Info RG_Matrix_wait
+(
+	RG_Matrix A,
+	bool force_sync
+) {
+	uint64_t delta_max_pending_changes;
+	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES, &delta_max_pending_changes);
+	return _RG_Matrix_wait(A, force_sync, delta_max_pending_changes);
+}
+
+GrB_Info RG_Matrix_waitDeltas
+(
+	RG_Matrix A
+) {
+	return _RG_Matrix_wait(A, false, UINT64_MAX);
+}
@@ -6,50 +6,135 @@
 
 #include <stddef.h>
 #include "group_cache.h"
+#include "../RG.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
 
+// initial number of hash table slots
+#define GROUP_CACHE_INITIAL_CAP 16
+
+// table grows once it is more than 3/4 full
+#define GROUP_CACHE_FULL(groups) \
+	(array_len((groups)->groups) * 4 >= (groups)->cap * 3)
+
+// returns true if group 'g' is keyed by 'keys'
+static bool _KeysMatch(const Group *g, const SIValue *keys) {
+	for(uint i = 0; i < g->key_count; i++) {
+		SIValue a = g->keys[i];
+		SIValue b = keys[i];
+		// NULL keys form a single group
+		if(SI_TYPE(a) == T_NULL || SI_TYPE(b) == T_NULL) {
+			if(SI_TYPE(a) != SI_TYPE(b)) return false;
+			continue;
+		}
+		if(SIValue_Compare(a, b, NULL) != 0) return false;
+	}
+	return true;
+}
+
+// place entry in the first empty slot of its probe sequence
+static void _Insert(CacheGroupEntry *entries, uint64_t cap,
+		CacheGroupEntry entry) {
+	uint64_t mask = cap - 1;
+	uint64_t pos = entry.hash & mask;
+	while(entries[pos].group != NULL) pos = (pos + 1) & mask;
+	entries[pos] = entry;
+}
+
+// double the number of slots, rehashing all entries
+static void _Grow(CacheGroup *groups) {
+	uint64_t cap = groups->cap * 2;
+	CacheGroupEntry *entries = rm_calloc(cap, sizeof(CacheGroupEntry));
+
+	for(uint64_t i = 0; i < groups->cap; i++) {
+		if(groups->entries[i].group != NULL) {
+			_Insert(entries, cap, groups->entries[i]);
+		}
+	}
+
+	rm_free(groups->entries);
+	groups->entries = entries;
+	groups->cap = cap;
+}
+
 CacheGroup *CacheGroupNew() {
-	return raxNew();
+	CacheGroup *groups = rm_malloc(sizeof(CacheGroup));
+	groups->cap = GROUP_CACHE_INITIAL_CAP;
+	groups->entries = rm_calloc(groups->cap, sizeof(CacheGroupEntry));
+	groups->groups = array_new(Group *, 0);
+	return groups;
 }
 
-void CacheGroupAdd(CacheGroup *groups, XXH64_hash_t key, Group *group) {
-	raxInsert(groups, (unsigned char *)&key, sizeof(key), group, NULL);
+void CacheGroupAdd(CacheGroup *groups, XXH64_hash_t hash, Group *group) {
+	ASSERT(groups != NULL);
+	ASSERT(group != NULL);
+
+	if(GROUP_CACHE_FULL(groups)) _Grow(groups);
+
+	CacheGroupEntry entry = {.hash = hash, .group = group};
+	_Insert(groups->entries, groups->cap, entry);
+	array_append(groups->groups, group);
+}
+
+// retrives the group matching 'keys', NULL if keys are missing
+Group *CacheGroupGet(CacheGroup *groups, XXH64_hash_t hash,
+		const SIValue *keys) {
+	ASSERT(groups != NULL);
+
+	uint64_t mask = groups->cap - 1;
+	uint64_t pos = hash & mask;
+	const CacheGroupEntry *entries = groups->entries;
+
+	// the table is never full, probing ends at an empty slot
+	while(entries[pos].group != NULL) {
+		if(entries[pos].hash == hash && _KeysMatch(entries[pos].group, keys)) {
+			return entries[pos].group;
+		}
+		pos = (pos + 1) & mask;
+	}
+
+	return NULL;
 }
 
-// retrives a group, sets group to NULL if key is missing
-Group *CacheGroupGet(CacheGroup *groups, XXH64_hash_t key) {
-	Group *g = raxFind(groups, (unsigned char *)&key, sizeof(key));
-	if(g == raxNotFound) return NULL;
-	return g;
+uint64_t CacheGroupCount(const CacheGroup *groups) {
+	ASSERT(groups != NULL);
+	return array_len(groups->groups);
 }
 
 void FreeGroupCache(CacheGroup *groups) {
-	raxFreeWithCallback(groups, (void (*)(void *))FreeGroup);
+	if(groups == NULL) return;
+
+	uint64_t count = array_len(groups->groups);
+	for(uint64_t i = 0; i < count; i++) FreeGroup(groups->groups[i]);
+
+	array_free(groups->groups);
+	rm_free(groups->entries);
+	rm_free(groups);
 }
 
 // Populates an iterator to scan entire group cache
 CacheGroupIterator *CacheGroupIter(CacheGroup *groups) {
 	CacheGroupIterator *iter = rm_malloc(sizeof(CacheGroupIterator));
 
-	raxStart(iter, groups);
-	raxSeek(iter, "^", NULL, 0);
+	iter->groups = groups;
+	iter->pos = 0;
 
 	return iter;
 }
 
 // advance iterator and returns value in current position
 int CacheGroupIterNext(CacheGroupIterator *iter, Group **group) {
-	int res = raxNext(iter);
-	if(res == 0) {
+	if(iter->pos == array_len(iter->groups->groups)) {
 		*group = NULL;
-	} else {
-		*group = iter->data; // TODO revisit this to fix up
+		return 0;
 	}
-	return res;
+
+	*group = iter->groups->groups[iter->pos++];
+	return 1;
 }
 
 void CacheGroupIterator_Free(CacheGroupIterator *iter) {
 	if(iter == NULL) return;
-	raxStop(iter);
 	rm_free(iter);
 }
+
@@ -6,19 +6,43 @@
 
 #pragma once
 
-#include "rax.h"
 #include "group.h"
 #include "../../deps/xxHash/xxhash.h"
 
-typedef rax CacheGroup;
-typedef raxIterator CacheGroupIterator;
+// slot within the group cache hash table
+// four slots share a cache line, such that probing seldom
+// touches more than a single line before finding its group
+typedef struct {
+	XXH64_hash_t hash;  // hash of the group's keys
+	Group *group;       // group, NULL if slot is empty
+} CacheGroupEntry;
+
+// open addressing (linear probing) hash table mapping group keys to groups
+// groups are verified against the looked up keys, such that keys
+// sharing a hash are kept in separate groups
+typedef struct {
+	CacheGroupEntry *entries;  // hash table slots
+	uint64_t cap;              // number of slots, a power of two
+	Group **groups;            // groups in insertion order
+} CacheGroup;
+
+// iterator over groups in insertion order
+typedef struct {
+	const CacheGroup *groups;  // iterated cache
+	uint64_t pos;              // position of next group
+} CacheGroupIterator;
 
 CacheGroup *CacheGroupNew(void);
 
-void CacheGroupAdd(CacheGroup *groups, XXH64_hash_t key, Group *group);
+// adds group to cache, group's keys must not already be cached
+void CacheGroupAdd(CacheGroup *groups, XXH64_hash_t hash, Group *group);
 
-// retrives a group, sets group to NULL if key is missing
-Group *CacheGroupGet(CacheGroup *groups, XXH64_hash_t key);
+// retrives the group matching 'keys', NULL if keys are missing
+// 'keys' holds a value for each group key
+Group *CacheGroupGet(CacheGroup *groups, XXH64_hash_t hash, const SIValue *keys);
+
+// number of cached groups
+uint64_t CacheGroupCount(const CacheGroup *groups);
 
 void FreeGroupCache(CacheGroup *groups);
 
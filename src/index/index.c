@@ -11,12 +11,14 @@
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
 #include "../datatypes/point.h"
+#include "../configuration/config.h"
 #include "../graph/graphcontext.h"
 #include "../graph/entities/node.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
 
-extern void populateEdgeIndex(Index *idx); 
-extern void populateNodeIndex(Index *idx);
+extern bool populateEdgeIndex(Index *idx, EntityID start, EntityID end);
+extern bool populateNodeIndex(Index *idx, EntityID start, EntityID end);
+extern void populateNativeIndex(Index *idx);
 
 // TODO: Remove this comment when https://github.com/RediSearch/RediSearch/issues/1100 is closed
 // static int _getNodeAttribute(void *ctx, const char *fieldName, const void *id, char **strVal,
@@ -163,6 +165,9 @@ Index *Index_New
 	Index *idx = rm_malloc(sizeof(Index));
 
 	idx->idx           =  NULL;
+	idx->native        =  NULL;
+	idx->vectors       =  NULL;
+	idx->dimension     =  0;
 	idx->type          =  type;
 	idx->label         =  rm_strdup(label);
 	idx->fields        =  array_new(char *, 0);
@@ -171,6 +176,8 @@ Index *Index_New
 	idx->language      =  NULL;
 	idx->stopwords     =  NULL;
 	idx->entity_type   =  entity_type;
+	idx->building      =  false;
+	idx->generation    =  0;
 
 	return idx;
 }
@@ -208,20 +215,56 @@ void Index_RemoveField
 	for(uint i = 0; i < fields_count; i++) {
 		if(idx->fields_ids[i] == attribute_id) {
 			rm_free(idx->fields[i]);
-			array_del_fast(idx->fields, i);
-			array_del_fast(idx->fields_ids, i);
+			// keep fields order, native composite keys follow it
+			array_del(idx->fields, i);
+			array_del(idx->fields_ids, i);
+			if(idx->vectors) {
+				VectorIndex_Free(idx->vectors[i]);
+				array_del(idx->vectors, i);
+			}
 			break;
 		}
 	}
+
+	// native composite keys are built out of the indexed fields
+	if(idx->native && array_len(idx->fields_ids) > 0) populateNativeIndex(idx);
 }
 
-// constructs index
-void Index_Construct
+// source of index generations, unique across all indices
+static uint64_t _generation = 0;
+
+static void _FreeVectorIndices
+(
+	Index *idx
+) {
+	uint n = array_len(idx->vectors);
+	for(uint i = 0; i < n; i++) VectorIndex_Free(idx->vectors[i]);
+	array_free(idx->vectors);
+	idx->vectors = NULL;
+}
+
+// drops all indexed entities leaving an empty index over the indexed fields
+void Index_Reset
 (
 	Index *idx
 ) {
 	ASSERT(idx != NULL);
 
+	idx->generation = __atomic_add_fetch(&_generation, 1, __ATOMIC_RELAXED);
+
+	// vector indices are maintained natively, one flat index per field
+	if(idx->type == IDX_VECTOR) {
+		ASSERT(idx->dimension > 0);
+		if(idx->vectors) _FreeVectorIndices(idx);
+
+		uint fields_count = array_len(idx->fields);
+		idx->vectors = array_new(VectorIndex *, fields_count);
+		for(uint i = 0; i < fields_count; i++) {
+			array_append(idx->vectors, VectorIndex_New(idx->dimension));
+		}
+		return;
+	}
+
 	// RediSearch index already exists, re-construct
 	if(idx->idx) {
 		RediSearch_DropIndex(idx->idx);
@@ -275,8 +318,56 @@ void Index_Construct
 	}
 
 	idx->idx = rsIdx;
-	if(idx->entity_type == GETYPE_NODE) populateNodeIndex(idx);
-	else populateEdgeIndex(idx);
+
+	// node exact-match indices maintain a native ordered index
+	// answering simple lookups without going through RediSearch
+	if(idx->native) {
+		NativeIndex_Free(idx->native);
+		idx->native = NULL;
+	}
+
+	bool native_index;
+	Config_Option_get(Config_NATIVE_INDEX, &native_index);
+	if(native_index && idx->type == IDX_EXACT_MATCH &&
+	   idx->entity_type == GETYPE_NODE) {
+		idx->native = NativeIndex_New(idx->fields_ids,
+				array_len(idx->fields_ids));
+	}
+}
+
+// indexes entities stored within rows [start, end] of the indexed matrix
+bool Index_Populate
+(
+	Index *idx,
+	EntityID start,
+	EntityID end
+) {
+	ASSERT(idx != NULL);
+	ASSERT(start <= end);
+
+	if(idx->entity_type == GETYPE_NODE) return populateNodeIndex(idx, start, end);
+	else return populateEdgeIndex(idx, start, end);
+}
+
+// constructs index
+void Index_Construct
+(
+	Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	Index_Reset(idx);
+	Index_Populate(idx, 0, UINT64_MAX);
+}
+
+// returns true if queries may utilize the index
+bool Index_Enabled
+(
+	const Index *idx
+) {
+	ASSERT(idx != NULL);
+
+	return !__atomic_load_n(&idx->building, __ATOMIC_ACQUIRE);
 }
 
 // query index
@@ -288,6 +379,7 @@ RSResultsIterator *Index_Query
 ) {
 	ASSERT(idx   != NULL);
 	ASSERT(query != NULL);
+	ASSERT(idx->type != IDX_VECTOR);
 
 	return RediSearch_IterateQuery(idx->idx, query, strlen(query), err);
 }
@@ -342,6 +434,8 @@ const char *Index_GetLanguage
 (
 	const Index *idx
 ) {
+	if(idx->type == IDX_VECTOR) return NULL;
+
 	return RediSearch_IndexGetLanguage(idx->idx);
 }
 
@@ -356,6 +450,37 @@ char **Index_GetStopwords
 	return NULL;
 }
 
+VectorIndex *Index_GetVectorIndex
+(
+	const Index *idx,
+	Attribute_ID attribute_id
+) {
+	ASSERT(idx != NULL);
+
+	if(idx->type != IDX_VECTOR || idx->vectors == NULL) return NULL;
+
+	uint fields_count = array_len(idx->fields);
+	for(uint i = 0; i < fields_count; i++) {
+		if(idx->fields_ids[i] == attribute_id) return idx->vectors[i];
+	}
+
+	return NULL;
+}
+
+// set the dimension of vectors indexed by a vector index
+void Index_SetDimension
+(
+	Index *idx,
+	uint32_t dimension
+) {
+	ASSERT(idx != NULL);
+	ASSERT(dimension > 0);
+	ASSERT(idx->type == IDX_VECTOR);
+	ASSERT(idx->dimension == 0);
+
+	idx->dimension = dimension;
+}
+
 // set indexed language
 void Index_SetLanguage
 (
@@ -382,11 +507,28 @@ void Index_SetStopwords
 	array_clone_with_cb(idx->stopwords, stopwords, rm_strdup);
 }
 
+size_t Index_MemoryUsage(const Index *idx) {
+	ASSERT(idx != NULL);
+
+	size_t size = 0;
+	if(idx->idx) size += RediSearch_MemUsage(idx->idx);
+	if(idx->native) size += NativeIndex_MemoryUsage(idx->native);
+
+	uint vectors_count = array_len(idx->vectors);
+	for(uint i = 0; i < vectors_count; i++) {
+		size += VectorIndex_MemoryUsage(idx->vectors[i]);
+	}
+
+	return size;
+}
+
 // free index
 void Index_Free(Index *idx) {
 	ASSERT(idx != NULL);
 
 	if(idx->idx) RediSearch_DropIndex(idx->idx);
+	if(idx->native) NativeIndex_Free(idx->native);
+	if(idx->vectors) _FreeVectorIndices(idx);
 
 	if(idx->language) rm_free(idx->language);
 
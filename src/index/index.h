@@ -9,6 +9,8 @@
 #include "../graph/entities/node.h"
 #include "../graph/entities/edge.h"
 #include "../graph/entities/graph_entity.h"
+#include "index_native.h"
+#include "index_vector.h"
 #include "redisearch_api.h"
 
 #define INDEX_OK 1
@@ -20,6 +22,7 @@ typedef enum {
 	IDX_ANY = 0,
 	IDX_EXACT_MATCH = 1,
 	IDX_FULLTEXT = 2,
+	IDX_VECTOR = 3,
 } IndexType;
 
 typedef struct {
@@ -36,8 +39,13 @@ typedef struct {
 	char *language;               // language
 	char **stopwords;             // stopwords
 	GraphEntityType entity_type;  // entity type (node/edge) indexed
-	IndexType type;               // index type exact-match / fulltext
-	RSIndex *idx;                 // rediSearch index
+	IndexType type;               // index type exact-match / fulltext / vector
+	RSIndex *idx;                 // rediSearch index, NULL for vector indices
+	NativeIndex *native;          // [optional] native ordered index
+	uint32_t dimension;           // [vector] dimension of indexed vectors
+	VectorIndex **vectors;        // [vector] vector index per field
+	bool building;                // index is being populated, hidden from queries
+	uint64_t generation;          // identifies the index's current construction
 } Index;
 
 // create a new index
@@ -55,6 +63,28 @@ void Index_Construct
 	Index *idx
 );
 
+// drops all indexed entities leaving an empty index over the indexed fields
+// assigns the index a new generation
+void Index_Reset
+(
+	Index *idx
+);
+
+// indexes entities stored within rows [start, end] of the indexed matrix
+// returns false if 'start' is beyond the matrix's last row
+bool Index_Populate
+(
+	Index *idx,
+	EntityID start,  // first row to index
+	EntityID end     // last row to index
+);
+
+// returns true if queries may utilize the index
+bool Index_Enabled
+(
+	const Index *idx
+);
+
 // adds field to index
 void Index_AddField
 (
@@ -128,7 +158,7 @@ int Index_GetLabelID
 	const Index *idx
 );
 
-// returns indexed language
+// returns indexed language, NULL for vector indices
 const char *Index_GetLanguage
 (
 	const Index *idx
@@ -141,6 +171,21 @@ char **Index_GetStopwords
 	size_t *size
 );
 
+// returns the vector index of 'attribute_id'
+// NULL if the attribute isn't indexed by the vector index 'idx'
+VectorIndex *Index_GetVectorIndex
+(
+	const Index *idx,
+	Attribute_ID attribute_id  // indexed attribute
+);
+
+// set the dimension of vectors indexed by a vector index
+void Index_SetDimension
+(
+	Index *idx,
+	uint32_t dimension
+);
+
 // set indexed language
 void Index_SetLanguage
 (
@@ -155,6 +200,12 @@ void Index_SetStopwords
 	char **stopwords
 );
 
+// number of bytes used by the index
+size_t Index_MemoryUsage
+(
+	const Index *idx
+);
+
 // free fulltext index
 void Index_Free
 (
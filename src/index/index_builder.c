@@ -0,0 +1,158 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_builder.h"
+#include "../query_ctx.h"
+#include "../redismodule.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+#include "../configuration/config.h"
+
+// number of matrix rows indexed by a single batch
+#define INDEX_BUILD_BATCH_SIZE 10000
+
+// background index construction
+// refers to the index by its schema rather than by pointer
+// as the index might be dropped or reconstructed between batches
+typedef struct {
+	GraphContext *gc;      // graph context, retained by the build
+	SchemaType t;          // indexed schema type
+	int label_id;          // indexed label / relationship-type ID
+	IndexType type;        // constructed index type
+	uint64_t generation;   // constructed index generation
+	EntityID cursor;       // next row to index
+} IndexBuild;
+
+static uint64_t _EntityCount
+(
+	const GraphContext *gc,
+	const Index *idx
+) {
+	if(idx->entity_type == GETYPE_NODE) {
+		return Graph_LabeledNodeCount(gc->g, idx->label_id);
+	}
+	return Graph_RelationEdgeCount(gc->g, idx->label_id);
+}
+
+// retrieves the index under construction
+// returns NULL if it had been dropped or reconstructed
+static Index *_BuiltIndex
+(
+	const IndexBuild *build
+) {
+	Schema *s = GraphContext_GetSchemaByID(build->gc, build->label_id,
+			build->t);
+	if(s == NULL) return NULL;
+
+	Index *idx = Schema_GetIndex(s, NULL, build->type);
+	if(idx == NULL || idx->generation != build->generation) return NULL;
+
+	return idx;
+}
+
+// indexes a single batch of rows
+// returns true once the build is done or abandoned
+static bool _IndexBuild_Step
+(
+	IndexBuild *build
+) {
+	GraphContext *gc = build->gc;
+	bool done = true;
+
+	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+	RedisModule_ThreadSafeContextLock(ctx);
+	Graph_AcquireWriteLock(gc->g);
+
+	QueryCtx_SetGraphCtx(gc);
+
+	// stop if the graph had been deleted
+	// or the index dropped or reconstructed since the build started
+	Index *idx = NULL;
+	if(GraphContext_GetRegisteredGraphContext(gc->graph_name) == gc) {
+		idx = _BuiltIndex(build);
+	}
+
+	if(idx != NULL) {
+		EntityID start = build->cursor;
+		EntityID end = start + INDEX_BUILD_BATCH_SIZE - 1;
+		done = !Index_Populate(idx, start, end);
+		build->cursor = end + 1;
+
+		if(done) {
+			// index is fully populated, plans may utilize it from now on
+			__atomic_store_n(&idx->building, false, __ATOMIC_RELEASE);
+			GraphContext_BumpIndexVersion(gc);
+		}
+	}
+
+	QueryCtx_Free();
+
+	Graph_ReleaseLock(gc->g);
+	RedisModule_ThreadSafeContextUnlock(ctx);
+	RedisModule_FreeThreadSafeContext(ctx);
+
+	return done;
+}
+
+// executed on the writer thread, requeues itself after each batch
+// allowing queued write queries to execute in between batches
+static void _IndexBuild_Run
+(
+	void *arg
+) {
+	IndexBuild *build = (IndexBuild *)arg;
+
+	while(!_IndexBuild_Step(build)) {
+		// failing to requeue, keep on indexing
+		if(ThreadPools_AddWorkWriter(_IndexBuild_Run, build) == 0) return;
+	}
+
+	GraphContext_Release(build->gc);
+	rm_free(build);
+}
+
+void IndexBuilder_Build
+(
+	GraphContext *gc,
+	Index *idx
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(idx != NULL);
+
+	// plans utilizing the index's previous content must not be reused
+	GraphContext_BumpIndexVersion(gc);
+
+	uint64_t threshold;
+	Config_Option_get(Config_ASYNC_INDEX_THRESHOLD, &threshold);
+
+	if(threshold == 0 || _EntityCount(gc, idx) < threshold) {
+		Index_Construct(idx);
+		__atomic_store_n(&idx->building, false, __ATOMIC_RELEASE);
+		return;
+	}
+
+	Index_Reset(idx);
+	__atomic_store_n(&idx->building, true, __ATOMIC_RELEASE);
+
+	IndexBuild *build = rm_malloc(sizeof(IndexBuild));
+	build->gc          =  gc;
+	build->t           =  (idx->entity_type == GETYPE_NODE) ?
+		SCHEMA_NODE : SCHEMA_EDGE;
+	build->label_id    =  idx->label_id;
+	build->type        =  idx->type;
+	build->generation  =  idx->generation;
+	build->cursor      =  0;
+
+	GraphContext_Retain(gc);
+	if(ThreadPools_AddWorkWriter(_IndexBuild_Run, build) != 0) {
+		// failed to queue the build, populate inline
+		Index_Populate(idx, 0, UINT64_MAX);
+		__atomic_store_n(&idx->building, false, __ATOMIC_RELEASE);
+		GraphContext_Release(gc);
+		rm_free(build);
+	}
+}
@@ -0,0 +1,28 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "index.h"
+#include "../graph/graphcontext.h"
+
+// constructs 'idx' from scratch
+//
+// indices over labels holding at least ASYNC_INDEX_THRESHOLD entities
+// are populated in the background by the writer thread, in batches of rows
+// each batch holding the graph's write lock only while indexing its rows
+// such that queries are not blocked for the whole construction
+//
+// while being populated the index is maintained by write queries
+// but isn't utilized by queries, the graph's index version is advanced
+// once the index is fully populated
+//
+// expects the graph to be locked for commit
+void IndexBuilder_Build
+(
+	GraphContext *gc,  // graph context
+	Index *idx         // index to construct
+);
@@ -0,0 +1,200 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_changes.h"
+#include "../util/rmalloc.h"
+
+// a single pending change
+typedef struct {
+	Index *idx;        // index to update
+	EntityID id;       // modified entity
+	EntityID src_id;   // edge source node
+	EntityID dest_id;  // edge destination node
+	bool remove;       // remove entity from index, otherwise (re)index it
+} IndexChange;
+
+// change key: index | entity ID, edges are additionally keyed by their
+// endpoints, as a deleted edge ID might be reused by a different edge
+// IDs are big endian such that changes are applied in entity ID order
+typedef struct {
+	unsigned char key[sizeof(Index *) + 3 * sizeof(EntityID)];
+	size_t len;
+} ChangeKey;
+
+static void _KeyAppendID
+(
+	ChangeKey *k,
+	EntityID id
+) {
+	for(int i = sizeof(EntityID) - 1; i >= 0; i--) {
+		k->key[k->len++] = (unsigned char)(id >> (i * 8));
+	}
+}
+
+// record change, overriding any previous change to the same entity
+static void _AddChange
+(
+	IndexChanges *changes,
+	Index *idx,
+	EntityID id,
+	EntityID src_id,
+	EntityID dest_id,
+	bool remove
+) {
+	ASSERT(idx     != NULL);
+	ASSERT(changes != NULL);
+
+	ChangeKey k = {.len = sizeof(Index *)};
+	memcpy(k.key, &idx, sizeof(Index *));
+	if(idx->entity_type == GETYPE_EDGE) {
+		_KeyAppendID(&k, id);
+		_KeyAppendID(&k, src_id);
+		_KeyAppendID(&k, dest_id);
+	} else {
+		_KeyAppendID(&k, id);
+	}
+
+	IndexChange *c = raxFind(changes->changes, k.key, k.len);
+	if(c == raxNotFound) {
+		c = rm_malloc(sizeof(IndexChange));
+		raxInsert(changes->changes, k.key, k.len, c, NULL);
+	}
+
+	c->idx      =  idx;
+	c->id       =  id;
+	c->src_id   =  src_id;
+	c->dest_id  =  dest_id;
+	c->remove   =  remove;
+}
+
+static void _ApplyNodeChange
+(
+	const IndexChange *c,
+	const Graph *g
+) {
+	Node n = GE_NEW_NODE();
+
+	// entity might have been deleted after its change was recorded
+	if(c->remove || !Graph_GetNode(g, c->id, &n)) {
+		n.id = c->id;
+		Index_RemoveNode(c->idx, &n);
+	} else {
+		Index_IndexNode(c->idx, &n);
+	}
+}
+
+static void _ApplyEdgeChange
+(
+	const IndexChange *c,
+	const Graph *g
+) {
+	Edge e = GE_NEW_EDGE();
+	e.srcNodeID   =  c->src_id;
+	e.destNodeID  =  c->dest_id;
+	e.relationID  =  c->idx->label_id;
+
+	// entity might have been deleted after its change was recorded
+	if(c->remove || !Graph_GetEdge(g, c->id, &e)) {
+		e.id = c->id;
+		Index_RemoveEdge(c->idx, &e);
+	} else {
+		Index_IndexEdge(c->idx, &e);
+	}
+}
+
+IndexChanges *IndexChanges_New(void) {
+	IndexChanges *changes = rm_malloc(sizeof(IndexChanges));
+	changes->changes = raxNew();
+	return changes;
+}
+
+bool IndexChanges_Empty
+(
+	const IndexChanges *changes
+) {
+	ASSERT(changes != NULL);
+	return raxSize(changes->changes) == 0;
+}
+
+void IndexChanges_IndexNode
+(
+	IndexChanges *changes,
+	Index *idx,
+	const Node *n
+) {
+	ASSERT(n != NULL);
+	_AddChange(changes, idx, ENTITY_GET_ID(n), 0, 0, false);
+}
+
+void IndexChanges_RemoveNode
+(
+	IndexChanges *changes,
+	Index *idx,
+	const Node *n
+) {
+	ASSERT(n != NULL);
+	_AddChange(changes, idx, ENTITY_GET_ID(n), 0, 0, true);
+}
+
+void IndexChanges_IndexEdge
+(
+	IndexChanges *changes,
+	Index *idx,
+	const Edge *e
+) {
+	ASSERT(e != NULL);
+	_AddChange(changes, idx, ENTITY_GET_ID(e), Edge_GetSrcNodeID(e),
+			Edge_GetDestNodeID(e), false);
+}
+
+void IndexChanges_RemoveEdge
+(
+	IndexChanges *changes,
+	Index *idx,
+	const Edge *e
+) {
+	ASSERT(e != NULL);
+	_AddChange(changes, idx, ENTITY_GET_ID(e), Edge_GetSrcNodeID(e),
+			Edge_GetDestNodeID(e), true);
+}
+
+void IndexChanges_Apply
+(
+	IndexChanges *changes,
+	const Graph *g
+) {
+	ASSERT(g       != NULL);
+	ASSERT(changes != NULL);
+
+	if(IndexChanges_Empty(changes)) return;
+
+	raxIterator it;
+	raxStart(&it, changes->changes);
+	raxSeek(&it, "^", NULL, 0);
+
+	while(raxNext(&it)) {
+		IndexChange *c = it.data;
+		if(c->idx->entity_type == GETYPE_NODE) _ApplyNodeChange(c, g);
+		else _ApplyEdgeChange(c, g);
+		rm_free(c);
+	}
+
+	raxStop(&it);
+
+	raxFree(changes->changes);
+	changes->changes = raxNew();
+}
+
+void IndexChanges_Free
+(
+	IndexChanges *changes
+) {
+	ASSERT(changes != NULL);
+
+	raxFreeWithCallback(changes->changes, rm_free);
+	rm_free(changes);
+}
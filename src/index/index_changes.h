@@ -0,0 +1,77 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "index.h"
+#include "rax.h"
+#include "../graph/graph.h"
+
+// pending index modifications made by a single query
+//
+// rather than updating indices as each entity is created, updated or
+// deleted, modifications are buffered and applied in one pass, e.g. once
+// the query commits, an entity modified multiple times by the query
+// is (re)indexed only once, according to its final state
+typedef struct {
+	rax *changes;  // (index, entity) -> pending change
+} IndexChanges;
+
+// create an empty change buffer
+IndexChanges *IndexChanges_New(void);
+
+// returns true if there are no pending changes
+bool IndexChanges_Empty
+(
+	const IndexChanges *changes
+);
+
+// (re)index node once changes are applied
+void IndexChanges_IndexNode
+(
+	IndexChanges *changes,  // change buffer
+	Index *idx,             // index to update
+	const Node *n           // node to index
+);
+
+// remove node from index once changes are applied
+void IndexChanges_RemoveNode
+(
+	IndexChanges *changes,  // change buffer
+	Index *idx,             // index to update
+	const Node *n           // node to remove
+);
+
+// (re)index edge once changes are applied
+void IndexChanges_IndexEdge
+(
+	IndexChanges *changes,  // change buffer
+	Index *idx,             // index to update
+	const Edge *e           // edge to index
+);
+
+// remove edge from index once changes are applied
+void IndexChanges_RemoveEdge
+(
+	IndexChanges *changes,  // change buffer
+	Index *idx,             // index to update
+	const Edge *e           // edge to remove
+);
+
+// apply and clear all pending changes
+// entities are indexed according to their current state in 'g'
+// expects the graph to be locked for commit
+void IndexChanges_Apply
+(
+	IndexChanges *changes,  // change buffer
+	const Graph *g          // graph holding the modified entities
+);
+
+// free change buffer, discarding pending changes
+void IndexChanges_Free
+(
+	IndexChanges *changes
+);
@@ -52,9 +52,11 @@ void Index_IndexEdge
 	}
 }
 
-void populateEdgeIndex
+bool populateEdgeIndex
 (
-	Index *idx
+	Index *idx,
+	EntityID start,
+	EntityID end
 ) {
 	ASSERT(idx != NULL);
 
@@ -64,8 +66,14 @@ void populateEdgeIndex
 	const RG_Matrix m = Graph_GetRelationMatrix(g, idx->label_id, false);
 	ASSERT(m != NULL);
 
+	// rows are indexed by the edges source node ID
+	GrB_Index nrows;
+	RG_Matrix_nrows(&nrows, m);
+	if(start >= nrows) return false;
+
 	RG_MatrixTupleIter it;
 	RG_MatrixTupleIter_reuse(&it, m);
+	RG_MatrixTupleIter_iterate_range(&it, start, end);
 
 	// iterate over each graph entity
 	while(true) {
@@ -85,6 +93,8 @@ void populateEdgeIndex
 		Graph_GetEdge(g, edge_id, &e);
 		Index_IndexEdge(idx, &e);
 	}
+
+	return true;
 }
 
 void Index_RemoveEdge
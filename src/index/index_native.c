@@ -0,0 +1,845 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_native.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/rax_extensions.h"
+#include <math.h>
+
+#define ATTR_LEN        2       // encoded attribute ID length
+#define TAG_NUMERIC     0x01    // numeric values tag
+#define TAG_STRING      0x02    // string values tag
+#define KEY_END         0x00    // separates encoded values from their types
+#define KEY_LAST        0xFF    // byte following every encoded tag or value
+#define COMPOSITE_ATTR  0xFFFF  // composite keys marker, never a valid attribute
+
+// original type of an encoded value, stored at the end of indexed keys
+// allowing values to be decoded back out of the index
+#define TYPE_DOUBLE     0x01    // double
+#define TYPE_INT        0x02    // integer, exactly represented as a double
+#define TYPE_INEXACT    0x03    // integer beyond double precision
+#define TYPE_STRING     0x04    // string
+
+// doubles represent integers exactly up to 2^53
+#define MAX_EXACT_INT   (1LL << 53)
+
+// encoded key an entity is indexed under
+typedef struct NativeKey {
+	size_t len;           // key length
+	unsigned char key[];  // key
+} NativeKey;
+
+//------------------------------------------------------------------------------
+// key encoding
+//------------------------------------------------------------------------------
+
+// create a key holding only the encoded attribute ID
+static NativeKey *_KeyNew
+(
+	uint16_t attr
+) {
+	NativeKey *k = rm_malloc(sizeof(NativeKey) + ATTR_LEN);
+	k->len = ATTR_LEN;
+	k->key[0] = (unsigned char)(attr >> 8);
+	k->key[1] = (unsigned char)(attr & 0xFF);
+	return k;
+}
+
+static NativeKey *_KeyClone
+(
+	const NativeKey *k
+) {
+	NativeKey *clone = rm_malloc(sizeof(NativeKey) + k->len);
+	memcpy(clone, k, sizeof(NativeKey) + k->len);
+	return clone;
+}
+
+static void _KeyAppend
+(
+	NativeKey **k,
+	const unsigned char *buf,
+	size_t len
+) {
+	NativeKey *key = rm_realloc(*k, sizeof(NativeKey) + (*k)->len + len);
+	memcpy(key->key + key->len, buf, len);
+	key->len += len;
+	*k = key;
+}
+
+static void _KeyAppendByte
+(
+	NativeKey **k,
+	unsigned char b
+) {
+	_KeyAppend(k, &b, 1);
+}
+
+// encode 'd' such that the byte order of encoded values matches their order
+static void _KeyAppendNumeric
+(
+	NativeKey **k,
+	double d
+) {
+	if(d == 0) d = 0;  // -0.0 and 0.0 are equal
+
+	uint64_t u;
+	memcpy(&u, &d, sizeof(uint64_t));
+	// negative values are ordered in reverse
+	// positive values are ordered after negative ones
+	u = (u & (1ULL << 63)) ? ~u : (u | (1ULL << 63));
+
+	unsigned char buf[9];
+	buf[0] = TAG_NUMERIC;
+	for(int i = 0; i < 8; i++) buf[i + 1] = (unsigned char)(u >> (56 - 8 * i));
+	_KeyAppend(k, buf, sizeof(buf));
+}
+
+// inverse of _KeyAppendNumeric, 'buf' points past the numeric tag
+static double _DecodeNumeric
+(
+	const unsigned char *buf
+) {
+	uint64_t u = 0;
+	for(int i = 0; i < 8; i++) u = (u << 8) | buf[i];
+	u = (u & (1ULL << 63)) ? (u & ~(1ULL << 63)) : ~u;
+
+	double d;
+	memcpy(&d, &u, sizeof(double));
+	return d;
+}
+
+static void _KeyAppendString
+(
+	NativeKey **k,
+	const char *s
+) {
+	// keep the NULL terminator, ordering "a" before "ab"
+	_KeyAppendByte(k, TAG_STRING);
+	_KeyAppend(k, (const unsigned char *)s, strlen(s) + 1);
+}
+
+// returns false if 'v' isn't indexed natively
+// sets 'type' to the original type of 'v'
+static bool _KeyAppendValue
+(
+	NativeKey **k,
+	SIValue v,
+	unsigned char *type
+) {
+	switch(SI_TYPE(v)) {
+		case T_INT64:
+			_KeyAppendNumeric(k, (double)v.longval);
+			*type = (v.longval <= MAX_EXACT_INT && v.longval >= -MAX_EXACT_INT) ?
+				TYPE_INT : TYPE_INEXACT;
+			return true;
+		case T_DOUBLE:
+			if(isnan(v.doubleval)) return false;
+			_KeyAppendNumeric(k, v.doubleval);
+			// -0.0 is encoded as 0.0
+			*type = (v.doubleval == 0 && signbit(v.doubleval)) ? TYPE_INEXACT :
+				TYPE_DOUBLE;
+			return true;
+		case T_STRING:
+			_KeyAppendString(k, v.stringval);
+			*type = TYPE_STRING;
+			return true;
+		default:
+			return false;
+	}
+}
+
+// terminate an indexed key with the types of its values
+static void _KeyAppendTypes
+(
+	NativeKey **k,
+	const unsigned char *types,
+	uint n
+) {
+	_KeyAppendByte(k, KEY_END);
+	_KeyAppend(k, types, n);
+}
+
+// returns NULL if 'v' isn't indexed natively
+static NativeKey *_ValueKey
+(
+	Attribute_ID attr,
+	SIValue v
+) {
+	unsigned char type;
+	NativeKey *k = _KeyNew(attr);
+	if(!_KeyAppendValue(&k, v, &type)) {
+		rm_free(k);
+		return NULL;
+	}
+	_KeyAppendTypes(&k, &type, 1);
+	return k;
+}
+
+// returns NULL if 'e' doesn't have a value for the first indexed attribute
+static NativeKey *_CompositeKey
+(
+	const NativeIndex *idx,
+	const GraphEntity *e
+) {
+	NativeKey *k = _KeyNew(COMPOSITE_ATTR);
+	uint attr_count = array_len(idx->attrs);
+	unsigned char types[attr_count];
+
+	uint i = 0;
+	for(; i < attr_count; i++) {
+		SIValue *v = GraphEntity_GetProperty(e, idx->attrs[i]);
+		if(v == PROPERTY_NOTFOUND || !_KeyAppendValue(&k, *v, types + i)) break;
+	}
+
+	if(i == 0) {
+		rm_free(k);
+		return NULL;
+	}
+	_KeyAppendTypes(&k, types, i);
+	return k;
+}
+
+static int _KeyCompare
+(
+	const unsigned char *a,
+	size_t a_len,
+	const unsigned char *b,
+	size_t b_len
+) {
+	int cmp = memcmp(a, b, MIN(a_len, b_len));
+	if(cmp != 0) return cmp;
+	return (a_len > b_len) - (a_len < b_len);
+}
+
+//------------------------------------------------------------------------------
+// entity IDs buckets
+//------------------------------------------------------------------------------
+
+// returns the position of the first ID in 'ids' which is >= 'id'
+static uint _BucketSearch
+(
+	const EntityID *ids,
+	uint n,
+	EntityID id
+) {
+	uint lo = 0;
+	uint hi = n;
+	while(lo < hi) {
+		uint mid = lo + (hi - lo) / 2;
+		if(ids[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+static void _BucketAdd
+(
+	rax *tree,
+	const NativeKey *k,
+	EntityID id
+) {
+	EntityID *ids = raxFind(tree, (unsigned char *)k->key, k->len);
+	if(ids == raxNotFound) {
+		ids = array_new(EntityID, 1);
+		array_append(ids, id);
+		raxInsert(tree, (unsigned char *)k->key, k->len, ids, NULL);
+		return;
+	}
+
+	uint n = array_len(ids);
+	uint pos = _BucketSearch(ids, n, id);
+	if(pos < n && ids[pos] == id) return;
+
+	// entities are mostly introduced in increasing ID order
+	// in which case the ID is appended
+	EntityID *prev = ids;
+	array_append(ids, id);
+	memmove(ids + pos + 1, ids + pos, sizeof(EntityID) * (n - pos));
+	ids[pos] = id;
+
+	// bucket was reallocated
+	if(ids != prev) raxInsert(tree, (unsigned char *)k->key, k->len, ids, NULL);
+}
+
+static void _BucketRemove
+(
+	rax *tree,
+	const NativeKey *k,
+	EntityID id
+) {
+	EntityID *ids = raxFind(tree, (unsigned char *)k->key, k->len);
+	ASSERT(ids != raxNotFound);
+
+	uint n = array_len(ids);
+	uint pos = _BucketSearch(ids, n, id);
+	ASSERT(pos < n && ids[pos] == id);
+
+	array_del(ids, pos);
+	if(array_len(ids) == 0) {
+		raxRemove(tree, (unsigned char *)k->key, k->len, NULL);
+		array_free(ids);
+	}
+}
+
+static void _FreeBucket
+(
+	void *ids
+) {
+	array_free(ids);
+}
+
+static void _FreeEntityKeys
+(
+	void *keys
+) {
+	NativeKey **arr = keys;
+	uint n = array_len(arr);
+	for(uint i = 0; i < n; i++) rm_free(arr[i]);
+	array_free(arr);
+}
+
+//------------------------------------------------------------------------------
+// NativeIndex API
+//------------------------------------------------------------------------------
+
+NativeIndex *NativeIndex_New
+(
+	const Attribute_ID *attrs,
+	uint attr_count
+) {
+	ASSERT(attrs != NULL);
+	ASSERT(attr_count > 0);
+
+	NativeIndex *idx = rm_malloc(sizeof(NativeIndex));
+
+	idx->tree      =  raxNew();
+	idx->entities  =  raxNew();
+	idx->attrs     =  array_new(Attribute_ID, attr_count);
+
+	for(uint i = 0; i < attr_count; i++) array_append(idx->attrs, attrs[i]);
+
+	return idx;
+}
+
+uint NativeIndex_AttributeCount
+(
+	const NativeIndex *idx
+) {
+	ASSERT(idx != NULL);
+	return array_len(idx->attrs);
+}
+
+// returns true if 'keys' holds a key equal to 'k'
+static bool _ContainsKey
+(
+	NativeKey **keys,
+	const NativeKey *k
+) {
+	uint n = array_len(keys);
+	for(uint i = 0; i < n; i++) {
+		if(_KeyCompare(keys[i]->key, keys[i]->len, k->key, k->len) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void NativeIndex_IndexEntity
+(
+	NativeIndex *idx,
+	const GraphEntity *e
+) {
+	ASSERT(e   != NULL);
+	ASSERT(idx != NULL);
+
+	EntityID id = ENTITY_GET_ID(e);
+	uint attr_count = array_len(idx->attrs);
+
+	NativeKey **keys = array_new(NativeKey *, attr_count + 1);
+	for(uint i = 0; i < attr_count; i++) {
+		SIValue *v = GraphEntity_GetProperty(e, idx->attrs[i]);
+		if(v == PROPERTY_NOTFOUND) continue;
+
+		NativeKey *k = _ValueKey(idx->attrs[i], *v);
+		if(k != NULL) array_append(keys, k);
+	}
+
+	// a composite key exists only if the entity is indexed
+	// under the first attribute
+	if(attr_count > 1 && array_len(keys) > 0) {
+		NativeKey *k = _CompositeKey(idx, e);
+		if(k != NULL) array_append(keys, k);
+	}
+
+	// entity values might have changed, move the entity only between
+	// the buckets of keys which changed, unmodified keys are left in place
+	NativeKey **prev = raxFind(idx->entities, (unsigned char *)&id,
+			sizeof(EntityID));
+	if(prev == raxNotFound) prev = NULL;
+
+	if(prev != NULL) {
+		uint n = array_len(prev);
+		for(uint i = 0; i < n; i++) {
+			if(!_ContainsKey(keys, prev[i])) {
+				_BucketRemove(idx->tree, prev[i], id);
+			}
+		}
+	}
+
+	uint n = array_len(keys);
+	for(uint i = 0; i < n; i++) {
+		if(prev == NULL || !_ContainsKey(prev, keys[i])) {
+			_BucketAdd(idx->tree, keys[i], id);
+		}
+	}
+
+	if(prev != NULL) _FreeEntityKeys(prev);
+
+	if(n > 0) {
+		raxInsert(idx->entities, (unsigned char *)&id, sizeof(EntityID), keys,
+				NULL);
+	} else {
+		if(prev != NULL) {
+			raxRemove(idx->entities, (unsigned char *)&id, sizeof(EntityID),
+					NULL);
+		}
+		array_free(keys);
+	}
+}
+
+void NativeIndex_RemoveEntity
+(
+	NativeIndex *idx,
+	EntityID id
+) {
+	ASSERT(idx != NULL);
+
+	NativeKey **keys = NULL;
+	if(raxRemove(idx->entities, (unsigned char *)&id, sizeof(EntityID),
+				(void **)&keys) == 0) {
+		return;  // entity isn't indexed
+	}
+
+	uint n = array_len(keys);
+	for(uint i = 0; i < n; i++) _BucketRemove(idx->tree, keys[i], id);
+	_FreeEntityKeys(keys);
+}
+
+bool NativeIndex_SupportedValue
+(
+	SIValue v
+) {
+	switch(SI_TYPE(v)) {
+		case T_INT64:
+			return (v.longval <= MAX_EXACT_INT && v.longval >= -MAX_EXACT_INT);
+		case T_DOUBLE:
+			return !isnan(v.doubleval);
+		case T_STRING:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static NativeIndexIterator *_NativeIndexIterator_New
+(
+	NativeIndex *idx,
+	NativeKey *min,
+	bool include_min,
+	NativeKey *max,
+	bool include_max,
+	bool empty
+) {
+	NativeIndexIterator *iter = rm_malloc(sizeof(NativeIndexIterator));
+
+	iter->idx          =  idx;
+	iter->min          =  min;
+	iter->include_min  =  include_min;
+	iter->max          =  max;
+	iter->include_max  =  include_max;
+	iter->empty        =  empty;
+	iter->reverse      =  false;
+
+	raxStart(&iter->it, idx->tree);
+	NativeIndexIterator_Reset(iter);
+
+	return iter;
+}
+
+// set iterator bounds to a numeric range following 'prefix'
+static void _NumericBounds
+(
+	const NativeKey *prefix,
+	const NumericRange *range,
+	NativeKey **min,
+	bool *include_min,
+	NativeKey **max,
+	bool *include_max
+) {
+	*min = _KeyClone(prefix);
+	*max = _KeyClone(prefix);
+	*include_min = true;
+	*include_max = false;
+
+	if(range->min == -INFINITY) {
+		// first key of numeric values
+		_KeyAppendByte(min, TAG_NUMERIC);
+	} else {
+		_KeyAppendNumeric(min, range->min);
+		// skip over keys extending the excluded minimum
+		if(!range->include_min) _KeyAppendByte(min, KEY_LAST);
+	}
+
+	if(range->max == INFINITY) {
+		// first key past numeric values
+		_KeyAppendByte(max, TAG_NUMERIC + 1);
+	} else {
+		_KeyAppendNumeric(max, range->max);
+		// include keys extending the included maximum
+		if(range->include_max) _KeyAppendByte(max, KEY_LAST);
+	}
+}
+
+// set iterator bounds to a string range following 'prefix'
+static void _StringBounds
+(
+	const NativeKey *prefix,
+	const StringRange *range,
+	NativeKey **min,
+	bool *include_min,
+	NativeKey **max,
+	bool *include_max
+) {
+	*min = _KeyClone(prefix);
+	*max = _KeyClone(prefix);
+	*include_min = true;
+	*include_max = false;
+
+	if(range->min == NULL) {
+		// first key of string values
+		_KeyAppendByte(min, TAG_STRING);
+	} else {
+		_KeyAppendString(min, range->min);
+		// skip over keys extending the excluded minimum
+		if(!range->include_min) _KeyAppendByte(min, KEY_LAST);
+	}
+
+	if(range->max == NULL) {
+		// first key past string values
+		_KeyAppendByte(max, TAG_STRING + 1);
+	} else {
+		_KeyAppendString(max, range->max);
+		// include keys extending the included maximum
+		if(range->include_max) _KeyAppendByte(max, KEY_LAST);
+	}
+}
+
+NativeIndexIterator *NativeIndex_NumericRange
+(
+	NativeIndex *idx,
+	Attribute_ID attr,
+	const NumericRange *range
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(range != NULL);
+
+	NativeKey *min;
+	NativeKey *max;
+	bool include_min;
+	bool include_max;
+	NativeKey *prefix = _KeyNew(attr);
+
+	_NumericBounds(prefix, range, &min, &include_min, &max, &include_max);
+	rm_free(prefix);
+
+	return _NativeIndexIterator_New(idx, min, include_min, max, include_max,
+			!NumericRange_IsValid(range));
+}
+
+NativeIndexIterator *NativeIndex_StringRange
+(
+	NativeIndex *idx,
+	Attribute_ID attr,
+	const StringRange *range
+) {
+	ASSERT(idx   != NULL);
+	ASSERT(range != NULL);
+
+	NativeKey *min;
+	NativeKey *max;
+	bool include_min;
+	bool include_max;
+	NativeKey *prefix = _KeyNew(attr);
+
+	_StringBounds(prefix, range, &min, &include_min, &max, &include_max);
+	rm_free(prefix);
+
+	return _NativeIndexIterator_New(idx, min, include_min, max, include_max,
+			!StringRange_IsValid(range));
+}
+
+NativeIndexIterator *NativeIndex_CompositeRange
+(
+	NativeIndex *idx,
+	const SIValue *prefix,
+	uint prefix_len,
+	const NumericRange *num_range,
+	const StringRange *str_range
+) {
+	ASSERT(idx != NULL);
+	ASSERT(num_range == NULL || str_range == NULL);
+	ASSERT(array_len(idx->attrs) > 1);
+	ASSERT(prefix_len + (num_range != NULL || str_range != NULL) <=
+			array_len(idx->attrs));
+
+	NativeKey *p = _KeyNew(COMPOSITE_ATTR);
+	for(uint i = 0; i < prefix_len; i++) {
+		unsigned char type;
+		bool supported = _KeyAppendValue(&p, prefix[i], &type);
+		ASSERT(supported);
+		UNUSED(supported);
+	}
+
+	NativeKey *min;
+	NativeKey *max;
+	bool include_min;
+	bool include_max;
+	bool empty = false;
+
+	if(num_range != NULL) {
+		_NumericBounds(p, num_range, &min, &include_min, &max, &include_max);
+		empty = !NumericRange_IsValid(num_range);
+	} else if(str_range != NULL) {
+		_StringBounds(p, str_range, &min, &include_min, &max, &include_max);
+		empty = !StringRange_IsValid(str_range);
+	} else {
+		// every key extending the prefix
+		min = _KeyClone(p);
+		max = _KeyClone(p);
+		_KeyAppendByte(&max, KEY_LAST);
+		include_min = true;
+		include_max = false;
+	}
+	rm_free(p);
+
+	return _NativeIndexIterator_New(idx, min, include_min, max, include_max,
+			empty);
+}
+
+// advance the iterator to its next key
+// returns false once the range is depleted
+static bool _NextKey
+(
+	NativeIndexIterator *iter
+) {
+	if(iter->depleted) return false;
+
+	if(!(iter->reverse ? raxPrev(&iter->it) : raxNext(&iter->it))) {
+		iter->depleted = true;
+		return false;
+	}
+
+	// stop once the bound we're heading towards is passed
+	if(iter->reverse) {
+		NativeKey *min = iter->min;
+		int cmp = _KeyCompare(iter->it.key, iter->it.key_len, min->key,
+				min->len);
+		if(cmp < 0 || (cmp == 0 && !iter->include_min)) {
+			iter->depleted = true;
+			return false;
+		}
+	} else {
+		NativeKey *max = iter->max;
+		int cmp = _KeyCompare(iter->it.key, iter->it.key_len, max->key,
+				max->len);
+		if(cmp > 0 || (cmp == 0 && !iter->include_max)) {
+			iter->depleted = true;
+			return false;
+		}
+	}
+
+	iter->ids        =  iter->it.data;
+	iter->ids_count  =  array_len(iter->it.data);
+	iter->pos        =  0;
+
+	return true;
+}
+
+const EntityID *NativeIndexIterator_Next
+(
+	NativeIndexIterator *iter
+) {
+	ASSERT(iter != NULL);
+
+	while(iter->pos == iter->ids_count) {
+		if(!_NextKey(iter)) return NULL;
+	}
+
+	return iter->ids + iter->pos++;
+}
+
+uint64_t NativeIndexIterator_Count
+(
+	NativeIndexIterator *iter
+) {
+	ASSERT(iter != NULL);
+
+	// remaining IDs of the current key
+	uint64_t count = iter->ids_count - iter->pos;
+	iter->pos = iter->ids_count;
+
+	// sum the sizes of the remaining keys' buckets
+	while(_NextKey(iter)) {
+		count += iter->ids_count;
+		iter->pos = iter->ids_count;
+	}
+
+	return count;
+}
+
+bool NativeIndexIterator_Value
+(
+	const NativeIndexIterator *iter,
+	Attribute_ID attr,
+	SIValue *v
+) {
+	ASSERT(v    != NULL);
+	ASSERT(iter != NULL);
+	ASSERT(iter->ids != NULL);
+
+	const unsigned char *key = iter->it.key;
+	size_t len = iter->it.key_len;
+	uint16_t key_attr = ((uint16_t)key[0] << 8) | key[1];
+
+	// position of 'attr' among the key's values
+	uint pos = 0;
+	if(key_attr == COMPOSITE_ATTR) {
+		const Attribute_ID *attrs = iter->idx->attrs;
+		uint attr_count = NativeIndex_AttributeCount(iter->idx);
+		while(pos < attr_count && attrs[pos] != attr) pos++;
+		if(pos == attr_count) return false;
+	} else if(key_attr != attr) {
+		return false;
+	}
+
+	// skip over encoded values, types follow
+	uint n = 0;
+	size_t off = ATTR_LEN;
+	const unsigned char *value = NULL;
+	while(off < len && key[off] != KEY_END) {
+		if(n++ == pos) value = key + off;
+		if(key[off] == TAG_NUMERIC) off += 9;
+		else off += strlen((const char *)key + off + 1) + 2;
+	}
+
+	// composite key ended before reaching 'attr'
+	if(value == NULL) return false;
+
+	ASSERT(off + 1 + pos < len);
+	switch(key[off + 1 + pos]) {
+		case TYPE_INT:
+			*v = SI_LongVal((int64_t)_DecodeNumeric(value + 1));
+			return true;
+		case TYPE_DOUBLE:
+			*v = SI_DoubleVal(_DecodeNumeric(value + 1));
+			return true;
+		case TYPE_STRING:
+			*v = SI_ConstStringVal((const char *)value + 1);
+			return true;
+		default:
+			// value isn't represented exactly
+			return false;
+	}
+}
+
+void NativeIndexIterator_Reset
+(
+	NativeIndexIterator *iter
+) {
+	ASSERT(iter != NULL);
+
+	iter->ids        =  NULL;
+	iter->ids_count  =  0;
+	iter->pos        =  0;
+	iter->depleted   =  iter->empty;
+
+	if(iter->empty) return;
+
+	// the tree might have been modified, seek from scratch
+	if(iter->reverse) {
+		NativeKey *max = iter->max;
+		raxSeek(&iter->it, iter->include_max ? "<=" : "<", max->key, max->len);
+	} else {
+		NativeKey *min = iter->min;
+		raxSeek(&iter->it, iter->include_min ? ">=" : ">", min->key, min->len);
+	}
+}
+
+void NativeIndexIterator_Reverse
+(
+	NativeIndexIterator *iter
+) {
+	ASSERT(iter != NULL);
+
+	iter->reverse = true;
+	NativeIndexIterator_Reset(iter);
+}
+
+void NativeIndexIterator_Free
+(
+	NativeIndexIterator *iter
+) {
+	ASSERT(iter != NULL);
+
+	raxStop(&iter->it);
+	rm_free(iter->min);
+	rm_free(iter->max);
+	rm_free(iter);
+}
+
+size_t NativeIndex_MemoryUsage
+(
+	const NativeIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	size_t size = sizeof(NativeIndex) + array_sizeof(array_hdr(idx->attrs)) +
+		raxMemoryUsage(idx->tree) + raxMemoryUsage(idx->entities);
+
+	raxIterator it;
+	raxStart(&it, idx->tree);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) size += array_sizeof(array_hdr((EntityID *)it.data));
+	raxStop(&it);
+
+	raxStart(&it, idx->entities);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		NativeKey **keys = it.data;
+		uint n = array_len(keys);
+		size += array_sizeof(array_hdr(keys));
+		for(uint i = 0; i < n; i++) size += sizeof(NativeKey) + keys[i]->len;
+	}
+	raxStop(&it);
+
+	return size;
+}
+
+void NativeIndex_Free
+(
+	NativeIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	raxFreeWithCallback(idx->tree, _FreeBucket);
+	raxFreeWithCallback(idx->entities, _FreeEntityKeys);
+	array_free(idx->attrs);
+	rm_free(idx);
+}
+
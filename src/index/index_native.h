@@ -0,0 +1,179 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../graph/entities/graph_entity.h"
+#include "../util/range/string_range.h"
+#include "../util/range/numeric_range.h"
+
+// native ordered index, maps attribute values to entity IDs
+// maintained alongside the RediSearch exact-match index when enabled
+//
+// keys are encoded such that their byte order matches the order of the
+// values they represent, allowing range lookups to be answered by a
+// single ordered scan of the tree:
+// attribute ID (big endian) | type tag | value
+//
+// numeric values are stored as order-preserving doubles
+// string values are stored as is followed by a NULL terminator
+//
+// when multiple attributes are indexed each entity is additionally indexed
+// under a composite key, made of its values in the order attributes were
+// added to the index, a composite key ends at the first missing value:
+// composite marker | type tag | value | type tag | value ...
+//
+// indexed keys end with the original types of their values, such that
+// values can be read back from the index without accessing the entity
+//
+// composite keys answer lookups which fix a prefix of the indexed
+// attributes, optionally followed by a range over the next attribute
+typedef struct {
+	rax *tree;            // encoded value -> sorted array of entity IDs
+	rax *entities;        // entity ID -> encoded values the entity is indexed under
+	Attribute_ID *attrs;  // indexed attributes, composite keys order
+} NativeIndex;
+
+// iterator over the entity IDs within a range of a NativeIndex
+typedef struct {
+	const NativeIndex *idx; // iterated index
+	raxIterator it;         // iterator over the index tree
+	struct NativeKey *min;  // lower bound key
+	bool include_min;       // lower bound inclusive
+	struct NativeKey *max;  // upper bound key
+	bool include_max;       // upper bound inclusive
+	const EntityID *ids;    // entity IDs of the current key
+	uint ids_count;         // number of entity IDs of the current key
+	uint pos;               // position within 'ids'
+	bool empty;             // range is known to be empty
+	bool depleted;          // iterator reached the upper bound
+	bool reverse;           // iterate from the upper bound downwards
+} NativeIndexIterator;
+
+// create a new native index over 'attrs'
+NativeIndex *NativeIndex_New
+(
+	const Attribute_ID *attrs,  // indexed attributes
+	uint attr_count             // number of indexed attributes
+);
+
+// number of indexed attributes
+uint NativeIndex_AttributeCount
+(
+	const NativeIndex *idx
+);
+
+// index entity under its indexable attributes
+// replaces any previously indexed values of the entity
+// keys whose values didn't change are left untouched
+void NativeIndex_IndexEntity
+(
+	NativeIndex *idx,     // index to update
+	const GraphEntity *e  // entity to index
+);
+
+// remove entity from index
+void NativeIndex_RemoveEntity
+(
+	NativeIndex *idx,  // index to update
+	EntityID id        // entity to remove
+);
+
+// returns true if 'v' can be looked up in a native index
+// e.g. integers beyond double precision can not
+bool NativeIndex_SupportedValue
+(
+	SIValue v  // value to look up
+);
+
+// create an iterator over entities whose 'attr' is within a numeric range
+NativeIndexIterator *NativeIndex_NumericRange
+(
+	NativeIndex *idx,          // index to query
+	Attribute_ID attr,         // queried attribute
+	const NumericRange *range  // range to query
+);
+
+// create an iterator over entities whose 'attr' is within a string range
+NativeIndexIterator *NativeIndex_StringRange
+(
+	NativeIndex *idx,         // index to query
+	Attribute_ID attr,        // queried attribute
+	const StringRange *range  // range to query
+);
+
+// create an iterator over entities whose first 'prefix_len' indexed
+// attributes equal 'prefix' and whose next attribute is within either
+// 'num_range' or 'str_range', if neither is specified only the prefix is matched
+// requires at least two indexed attributes
+NativeIndexIterator *NativeIndex_CompositeRange
+(
+	NativeIndex *idx,                // index to query
+	const SIValue *prefix,           // values of the leading attributes
+	uint prefix_len,                 // number of values in 'prefix'
+	const NumericRange *num_range,   // [optional] range over the next attribute
+	const StringRange *str_range     // [optional] range over the next attribute
+);
+
+// returns the next entity ID, NULL once depleted
+// the returned ID points into the index and is valid
+// only as long as the index isn't modified
+const EntityID *NativeIndexIterator_Next
+(
+	NativeIndexIterator *iter
+);
+
+// returns the number of entity IDs the iterator has yet to return
+// summing the sizes of the remaining keys' buckets, depletes the iterator
+uint64_t NativeIndexIterator_Count
+(
+	NativeIndexIterator *iter
+);
+
+// retrieves the value of 'attr' of the entity last returned by the iterator
+// out of the index key it is stored under
+// returns false if the key doesn't hold that value, strings point into
+// the iterator and are valid only until the iterator advances
+bool NativeIndexIterator_Value
+(
+	const NativeIndexIterator *iter,  // iterator
+	Attribute_ID attr,                // attribute to retrieve
+	SIValue *v                        // [output] attribute value
+);
+
+// rewind iterator to the beginning of its range
+void NativeIndexIterator_Reset
+(
+	NativeIndexIterator *iter
+);
+
+// iterate keys in descending order, from the upper bound of the range
+// entity IDs sharing a key are still returned in ascending order
+// rewinds the iterator
+void NativeIndexIterator_Reverse
+(
+	NativeIndexIterator *iter
+);
+
+// free iterator
+void NativeIndexIterator_Free
+(
+	NativeIndexIterator *iter
+);
+
+// number of bytes used by the index
+size_t NativeIndex_MemoryUsage
+(
+	const NativeIndex *idx
+);
+
+// free native index
+void NativeIndex_Free
+(
+	NativeIndex *idx
+);
+
@@ -7,6 +7,7 @@
 #include "RG.h"
 #include "index.h"
 #include "../value.h"
+#include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../graph/graphcontext.h"
 #include "../graph/rg_matrix/rg_matrix_iter.h"
@@ -22,6 +23,19 @@ void Index_IndexNode
 	ASSERT(idx  !=  NULL);
 	ASSERT(n    !=  NULL);
 
+	// index each field's vector under its own vector index
+	if(idx->type == IDX_VECTOR) {
+		EntityID id = ENTITY_GET_ID(n);
+		uint fields_count = array_len(idx->fields_ids);
+		for(uint i = 0; i < fields_count; i++) {
+			SIValue *v = GraphEntity_GetProperty((const GraphEntity *)n,
+					idx->fields_ids[i]);
+			SIValue vec = (v == PROPERTY_NOTFOUND) ? SI_NullVal() : *v;
+			VectorIndex_IndexEntity(idx->vectors[i], id, vec);
+		}
+		return;
+	}
+
 	RSIndex   *rsIdx           =  idx->idx;
 	EntityID  key              =  ENTITY_GET_ID(n);
 	size_t    key_len          =  sizeof(EntityID);
@@ -33,6 +47,9 @@ void Index_IndexNode
 
 	if(doc_field_count > 0) {
 		RediSearch_SpecAddDocument(rsIdx, doc);
+		if(idx->native) {
+			NativeIndex_IndexEntity(idx->native, (const GraphEntity *)n);
+		}
 	} else {
 		// entity doesn't poses any attributes which are indexed
 		// remove entity from index and delete document
@@ -41,9 +58,11 @@ void Index_IndexNode
 	}
 }
 
-void populateNodeIndex
+bool populateNodeIndex
 (
-	Index *idx
+	Index *idx,
+	EntityID start,
+	EntityID end
 ) {
 	ASSERT(idx != NULL);
 
@@ -53,8 +72,13 @@ void populateNodeIndex
 	const RG_Matrix m = Graph_GetLabelMatrix(g, idx->label_id);
 	ASSERT(m != NULL);
 
+	GrB_Index nrows;
+	RG_Matrix_nrows(&nrows, m);
+	if(start >= nrows) return false;
+
 	RG_MatrixTupleIter it;
 	RG_MatrixTupleIter_reuse(&it, m);
+	RG_MatrixTupleIter_iterate_range(&it, start, end);
 
 	// iterate over each graph entity
 	while(true) {
@@ -68,6 +92,42 @@ void populateNodeIndex
 		Graph_GetNode(g, id, &n);
 		Index_IndexNode(idx, &n);
 	}
+
+	return true;
+}
+
+// rebuild the native index of 'idx' from scratch
+void populateNativeIndex
+(
+	Index *idx
+) {
+	ASSERT(idx         != NULL);
+	ASSERT(idx->native != NULL);
+
+	NativeIndex_Free(idx->native);
+	idx->native = NativeIndex_New(idx->fields_ids, array_len(idx->fields_ids));
+
+	GraphContext  *gc  =  QueryCtx_GetGraphCtx();
+	Graph         *g   =  gc->g;
+
+	const RG_Matrix m = Graph_GetLabelMatrix(g, idx->label_id);
+	ASSERT(m != NULL);
+
+	RG_MatrixTupleIter it;
+	RG_MatrixTupleIter_reuse(&it, m);
+
+	// iterate over each graph entity
+	while(true) {
+		EntityID id;
+		bool depleted = false;
+
+		RG_MatrixTupleIter_next(&it, NULL, &id, NULL, &depleted);
+		if(depleted) break;
+
+		Node n;
+		Graph_GetNode(g, id, &n);
+		NativeIndex_IndexEntity(idx->native, (const GraphEntity *)&n);
+	}
 }
 
 void Index_RemoveNode
@@ -79,6 +139,16 @@ void Index_RemoveNode
 	ASSERT(idx != NULL);
 
 	EntityID id = ENTITY_GET_ID(n);
+
+	if(idx->type == IDX_VECTOR) {
+		uint vectors_count = array_len(idx->vectors);
+		for(uint i = 0; i < vectors_count; i++) {
+			VectorIndex_RemoveEntity(idx->vectors[i], id);
+		}
+		return;
+	}
+
 	RediSearch_DeleteDocument(idx->idx, &id, sizeof(EntityID));
+	if(idx->native) NativeIndex_RemoveEntity(idx->native, id);
 }
 
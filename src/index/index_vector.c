@@ -0,0 +1,282 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "index_vector.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/array.h"
+
+#include <math.h>
+
+// vector positions are stored as rax values offset by 1
+// as a NULL value can't be told apart from a missing key
+#define SLOT_ITEM(pos) ((void *)(uintptr_t)((pos) + 1))
+#define ITEM_SLOT(item) ((uint64_t)(uintptr_t)(item) - 1)
+
+VectorIndex *VectorIndex_New
+(
+	uint32_t dim
+) {
+	ASSERT(dim > 0);
+
+	VectorIndex *idx = rm_malloc(sizeof(VectorIndex));
+
+	idx->dim      =  dim;
+	idx->cap      =  0;
+	idx->count    =  0;
+	idx->ids      =  NULL;
+	idx->slots    =  raxNew();
+	idx->vectors  =  NULL;
+
+	return idx;
+}
+
+// dot product of two vectors
+// independent partial sums allow the compiler to vectorize the loop
+static inline float _Dot
+(
+	const float *a,
+	const float *b,
+	uint32_t dim
+) {
+	float acc[8] = {0};
+
+	uint32_t i = 0;
+	for(; i + 8 <= dim; i += 8) {
+		for(int j = 0; j < 8; j++) acc[j] += a[i + j] * b[i + j];
+	}
+
+	float sum = 0;
+	for(; i < dim; i++) sum += a[i] * b[i];
+	for(int j = 0; j < 8; j++) sum += acc[j];
+
+	return sum;
+}
+
+bool VectorIndex_ReadVector
+(
+	SIValue v,
+	uint32_t dim,
+	float *out
+) {
+	ASSERT(out != NULL);
+
+	if(SI_TYPE(v) != T_ARRAY) return false;
+	if(SIArray_Length(v) != dim) return false;
+
+	double norm = 0;
+	for(uint32_t i = 0; i < dim; i++) {
+		SIValue elem = SIArray_Get(v, i);
+		if(!(SI_TYPE(elem) & SI_NUMERIC)) return false;
+
+		double d = SI_GET_NUMERIC(elem);
+		norm += d * d;
+		out[i] = (float)d;
+	}
+
+	// cosine similarity is undefined for the zero vector
+	if(norm == 0 || !isfinite(norm)) return false;
+
+	float inv = (float)(1 / sqrt(norm));
+	for(uint32_t i = 0; i < dim; i++) out[i] *= inv;
+
+	return true;
+}
+
+void VectorIndex_IndexEntity
+(
+	VectorIndex *idx,
+	EntityID id,
+	SIValue v
+) {
+	ASSERT(idx != NULL);
+
+	uint64_t pos;
+	void *item = raxFind(idx->slots, (unsigned char *)&id, sizeof(EntityID));
+
+	if(item == raxNotFound) {
+		// grow storage
+		if(idx->count == idx->cap) {
+			idx->cap = (idx->cap == 0) ? 64 : idx->cap * 2;
+			idx->ids = rm_realloc(idx->ids, sizeof(EntityID) * idx->cap);
+			idx->vectors = rm_realloc(idx->vectors,
+					sizeof(float) * idx->dim * idx->cap);
+		}
+		pos = idx->count;
+	} else {
+		pos = ITEM_SLOT(item);
+	}
+
+	float *vec = idx->vectors + pos * idx->dim;
+	if(!VectorIndex_ReadVector(v, idx->dim, vec)) {
+		// not a vector, drop any previously indexed vector
+		if(item != raxNotFound) VectorIndex_RemoveEntity(idx, id);
+		return;
+	}
+
+	if(item == raxNotFound) {
+		idx->ids[pos] = id;
+		idx->count++;
+		raxInsert(idx->slots, (unsigned char *)&id, sizeof(EntityID),
+				SLOT_ITEM(pos), NULL);
+	}
+}
+
+void VectorIndex_RemoveEntity
+(
+	VectorIndex *idx,
+	EntityID id
+) {
+	ASSERT(idx != NULL);
+
+	void *item = raxFind(idx->slots, (unsigned char *)&id, sizeof(EntityID));
+	if(item == raxNotFound) return;
+
+	raxRemove(idx->slots, (unsigned char *)&id, sizeof(EntityID), NULL);
+
+	// move the last vector into the vacated position
+	uint64_t pos = ITEM_SLOT(item);
+	uint64_t last = --idx->count;
+	if(pos == last) return;
+
+	EntityID moved = idx->ids[last];
+	idx->ids[pos] = moved;
+	memcpy(idx->vectors + pos * idx->dim, idx->vectors + last * idx->dim,
+			sizeof(float) * idx->dim);
+	raxInsert(idx->slots, (unsigned char *)&moved, sizeof(EntityID),
+			SLOT_ITEM(pos), NULL);
+}
+
+uint64_t VectorIndex_Count
+(
+	const VectorIndex *idx
+) {
+	ASSERT(idx != NULL);
+	return idx->count;
+}
+
+// restores the min-heap property of the retained results from 'i' down
+// the least similar retained result is at the top
+static void _SiftDown
+(
+	EntityID *ids,
+	float *scores,
+	uint64_t n,
+	uint64_t i
+) {
+	while(true) {
+		uint64_t min = i;
+		uint64_t l = 2 * i + 1;
+		uint64_t r = l + 1;
+		if(l < n && scores[l] < scores[min]) min = l;
+		if(r < n && scores[r] < scores[min]) min = r;
+		if(min == i) return;
+
+		float s = scores[i];
+		scores[i] = scores[min];
+		scores[min] = s;
+
+		EntityID id = ids[i];
+		ids[i] = ids[min];
+		ids[min] = id;
+
+		i = min;
+	}
+}
+
+static void _SiftUp
+(
+	EntityID *ids,
+	float *scores,
+	uint64_t i
+) {
+	while(i > 0) {
+		uint64_t parent = (i - 1) / 2;
+		if(scores[parent] <= scores[i]) return;
+
+		float s = scores[i];
+		scores[i] = scores[parent];
+		scores[parent] = s;
+
+		EntityID id = ids[i];
+		ids[i] = ids[parent];
+		ids[parent] = id;
+
+		i = parent;
+	}
+}
+
+uint64_t VectorIndex_Query
+(
+	const VectorIndex *idx,
+	const float *query,
+	uint64_t k,
+	EntityID *ids,
+	float *scores
+) {
+	ASSERT(idx    != NULL);
+	ASSERT(query  != NULL);
+	ASSERT(k == 0 || (ids != NULL && scores != NULL));
+
+	if(k == 0) return 0;
+
+	uint64_t n = 0;
+	uint32_t dim = idx->dim;
+	const float *vec = idx->vectors;
+
+	for(uint64_t i = 0; i < idx->count; i++, vec += dim) {
+		float score = _Dot(query, vec, dim);
+
+		if(n < k) {
+			ids[n] = idx->ids[i];
+			scores[n] = score;
+			_SiftUp(ids, scores, n);
+			n++;
+		} else if(score > scores[0]) {
+			// replace the least similar retained result
+			ids[0] = idx->ids[i];
+			scores[0] = score;
+			_SiftDown(ids, scores, n, 0);
+		}
+	}
+
+	// heap sort, least similar results are moved to the end
+	for(uint64_t i = n; i > 1; i--) {
+		float s = scores[0];
+		scores[0] = scores[i - 1];
+		scores[i - 1] = s;
+
+		EntityID id = ids[0];
+		ids[0] = ids[i - 1];
+		ids[i - 1] = id;
+
+		_SiftDown(ids, scores, i - 1, 0);
+	}
+
+	return n;
+}
+
+size_t VectorIndex_MemoryUsage
+(
+	const VectorIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	return sizeof(VectorIndex) + raxMemoryUsage(idx->slots) +
+		idx->cap * (sizeof(EntityID) + sizeof(float) * idx->dim);
+}
+
+void VectorIndex_Free
+(
+	VectorIndex *idx
+) {
+	ASSERT(idx != NULL);
+
+	raxFree(idx->slots);
+	if(idx->ids) rm_free(idx->ids);
+	if(idx->vectors) rm_free(idx->vectors);
+	rm_free(idx);
+}
@@ -0,0 +1,89 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+#include "../graph/entities/graph_entity.h"
+
+// flat vector index, maps entities to vectors of a fixed dimension
+// indexed attribute values are arrays of 'dimension' numbers
+//
+// vectors are stored normalized and contiguously as floats, such that
+// the cosine similarity of two vectors is their dot product, queries scan
+// all vectors and retain the k most similar ones
+typedef struct {
+	uint32_t dim;       // vector dimension
+	float *vectors;     // normalized vectors, 'dim' floats each
+	EntityID *ids;      // entity ID of each vector
+	uint64_t count;     // number of indexed vectors
+	uint64_t cap;       // number of vectors allocated
+	rax *slots;         // entity ID -> vector position
+} VectorIndex;
+
+// create a new vector index over vectors of dimension 'dim'
+VectorIndex *VectorIndex_New
+(
+	uint32_t dim  // vector dimension
+);
+
+// converts 'v' into a normalized vector of dimension 'dim'
+// returns false if 'v' isn't an array of 'dim' numbers or its norm is 0
+bool VectorIndex_ReadVector
+(
+	SIValue v,     // value to convert
+	uint32_t dim,  // expected dimension
+	float *out     // [output] 'dim' floats
+);
+
+// index entity 'id' under vector 'v'
+// replaces any previously indexed vector of the entity
+// the entity is removed from the index if 'v' isn't a valid vector
+void VectorIndex_IndexEntity
+(
+	VectorIndex *idx,  // index to update
+	EntityID id,       // indexed entity
+	SIValue v          // entity's vector
+);
+
+// remove entity from index
+void VectorIndex_RemoveEntity
+(
+	VectorIndex *idx,  // index to update
+	EntityID id        // entity to remove
+);
+
+// number of indexed vectors
+uint64_t VectorIndex_Count
+(
+	const VectorIndex *idx
+);
+
+// retrieves the 'k' indexed vectors most similar to 'query'
+// 'query' is a normalized vector, see VectorIndex_ReadVector
+// results are ordered by descending cosine similarity
+// returns the number of results, at most 'k'
+uint64_t VectorIndex_Query
+(
+	const VectorIndex *idx,  // index to query
+	const float *query,      // normalized query vector
+	uint64_t k,              // number of results
+	EntityID *ids,           // [output] 'k' entity IDs
+	float *scores            // [output] 'k' similarities
+);
+
+// number of bytes used by the index
+size_t VectorIndex_MemoryUsage
+(
+	const VectorIndex *idx
+);
+
+// free vector index
+void VectorIndex_Free
+(
+	VectorIndex *idx
+);
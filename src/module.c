@@ -11,6 +11,7 @@
 #include "errors.h"
 #include "version.h"
 #include "util/arr.h"
+#include "util/tsc.h"
 #include "util/cron.h"
 #include "query_ctx.h"
 #include "redisearch_api.h"
@@ -18,6 +19,7 @@
 #include "commands/commands.h"
 #include "util/thpool/pools.h"
 #include "graph/graphcontext.h"
+#include "graph/graph_compaction.h"
 #include "util/redis_version.h"
 #include "configuration/config.h"
 #include "ast/cypher_whitelist.h"
@@ -39,6 +41,7 @@
 // Module-level global variables
 //------------------------------------------------------------------------------
 GraphContext **graphs_in_keyspace;  // Global array tracking all extant GraphContexts.
+GraphContext **graphs_in_load;      // Graphs served while a replica loads its master's dataset.
 bool process_is_child;              // Flag indicating whether the running process is a child.
 
 extern CommandCtx **command_ctxs;
@@ -58,13 +61,55 @@ static int _RegisterDataTypes(RedisModuleCtx *ctx) {
 
 static void _PrepareModuleGlobals(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 	graphs_in_keyspace = array_new(GraphContext *, 1);
+	graphs_in_load = NULL;
 	process_is_child = false;
 }
 
+// Redis allocator functions handed to GraphBLAS
+static void *(*GrB_Alloc)(size_t bytes);
+static void *(*GrB_Calloc)(size_t nmemb, size_t size);
+static void *(*GrB_Realloc)(void *ptr, size_t bytes);
+static void (*GrB_Free)(void *ptr);
+
+// matrix arrays (Ap, Ai, Ax) are GraphBLAS's large long-lived allocations
+// advise them to use huge pages when enabled
+// allocations count toward the executing query's memory capacity
+static void *_GrB_Alloc(size_t bytes) {
+	void *p = GrB_Alloc(bytes);
+	rm_advise_huge_pages(p, bytes);
+	rm_count_matrix_alloc(p);
+	return p;
+}
+
+static void *_GrB_Calloc(size_t nmemb, size_t size) {
+	void *p = GrB_Calloc(nmemb, size);
+	rm_advise_huge_pages(p, nmemb * size);
+	rm_count_matrix_alloc(p);
+	return p;
+}
+
+static void *_GrB_Realloc(void *ptr, size_t bytes) {
+	rm_count_matrix_free(ptr);
+	void *p = GrB_Realloc(ptr, bytes);
+	// on failure the original allocation is retained
+	rm_count_matrix_alloc(p != NULL ? p : ptr);
+	rm_advise_huge_pages(p, bytes);
+	return p;
+}
+
+static void _GrB_Free(void *ptr) {
+	rm_count_matrix_free(ptr);
+	GrB_Free(ptr);
+}
+
 static int GraphBLAS_Init(RedisModuleCtx *ctx) {
 	// GraphBLAS should use Redis allocator
-	GrB_Info res = GxB_init(GrB_NONBLOCKING, RedisModule_Alloc,
-			RedisModule_Calloc, RedisModule_Realloc, RedisModule_Free);
+	GrB_Alloc   = RedisModule_Alloc;
+	GrB_Calloc  = RedisModule_Calloc;
+	GrB_Realloc = RedisModule_Realloc;
+	GrB_Free    = RedisModule_Free;
+	GrB_Info res = GxB_init(GrB_NONBLOCKING, _GrB_Alloc, _GrB_Calloc,
+			_GrB_Realloc, _GrB_Free);
 	if(res != GrB_SUCCESS) {
 		RedisModule_Log(ctx, "warning", "Encountered error initializing GraphBLAS");
 		return REDISMODULE_ERR;
@@ -104,6 +149,7 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 	Proc_Register();         // Register procedures.
 	AR_RegisterFuncs();      // Register arithmetic functions.
 	Cron_Start();            // Start CRON
+	TSC_Init();              // Calibrate profiling timer.
 	// Set up global lock and variables scoped to the entire module.
 	_PrepareModuleGlobals(ctx, argv, argc);
 
@@ -124,6 +170,9 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 	RedisModule_Log(ctx, "notice", "Thread pool created, using %d threads.",
 			ThreadPools_ReadersCount());
 
+	// flush delta matrices in the background
+	GraphCompaction_Start();
+
 	int ompThreadCount;
 	Config_Option_get(Config_OPENMP_NTHREAD, &ompThreadCount);
 
@@ -143,7 +192,27 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
-	if(RedisModule_CreateCommand(ctx, "graph.RO_QUERY", CommandDispatch, "readonly", 1, 1,
+	if(RedisModule_CreateCommand(ctx, "graph.RO_QUERY", CommandDispatch, "readonly allow-loading", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.MULTI_RO_QUERY", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.PREPARE", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.EXECUTE", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.VIEW", CommandDispatch, "readonly", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
 	}
@@ -153,6 +222,11 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.COPY", Graph_Copy, "write deny-oom", 1, 2,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.EXPLAIN", CommandDispatch, "write deny-oom", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
@@ -168,11 +242,41 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.IMPORT", Graph_Import, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.EXPORT", Graph_Export, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.EFFECT", Graph_Effect, "write deny-oom", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.SLOWLOG", CommandDispatch, "readonly", 1, 1,
 								 1) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.PLANSTATS", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.MEMORY", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.MATRICES", CommandDispatch, "readonly", 1, 1,
+								 1) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.CONFIG", Graph_Config, "readonly", 0, 0,
 								 0) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
@@ -183,6 +287,16 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 		return REDISMODULE_ERR;
 	}
 
+	if(RedisModule_CreateCommand(ctx, "graph.LIST_QUERIES", Graph_ListQueries,
+								 "readonly", 0, 0, 0) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
+	if(RedisModule_CreateCommand(ctx, "graph.KILL", Graph_Kill, "readonly", 0, 0,
+								 0) == REDISMODULE_ERR) {
+		return REDISMODULE_ERR;
+	}
+
 	if(RedisModule_CreateCommand(ctx, "graph.DEBUG", Graph_Debug, "readonly", 0, 0,
 								 0) == REDISMODULE_ERR) {
 		return REDISMODULE_ERR;
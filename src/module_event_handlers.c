@@ -14,6 +14,7 @@
 #include "graph/graphcontext.h"
 #include "configuration/config.h"
 #include "serializers/graphmeta_type.h"
+#include "commands/plan_warmup.h"
 #include "serializers/graphcontext_type.h"
 
 // indicates the possibility of half-baked graphs in the keyspace
@@ -21,6 +22,8 @@
 
 // global array tracking all extant GraphContexts
 extern GraphContext **graphs_in_keyspace;
+// graphs served while a replica loads its master's dataset
+extern GraphContext **graphs_in_load;
 // flag indicating whether the running process is a child
 extern bool process_is_child;
 // graphContext type as it is registered at Redis
@@ -179,11 +182,33 @@ static void _ClearKeySpaceMetaKeys(RedisModuleCtx *ctx, bool decode) {
 	}
 }
 
+// release the graphs held before a full sync
+// once the loaded graphs replace them
+static void _ReleaseGraphsInLoad(void) {
+	if(graphs_in_load == NULL) return;
+
+	uint count = array_len(graphs_in_load);
+	for(uint i = 0; i < count; i++) {
+		GraphContext_Release(graphs_in_load[i]);
+	}
+	array_free(graphs_in_load);
+	graphs_in_load = NULL;
+}
+
 static void _FlushDBHandler(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent,
 							void *data) {
 	// reset `aux_field_counter` upon handeling FLUSH-ALL
 	if(eid.id == REDISMODULE_EVENT_FLUSHDB &&
 	   subevent == REDISMODULE_SUBEVENT_FLUSHDB_START) {
+		// a replica is about to load its master's dataset
+		// keep serving read-only queries from its current graphs
+		// the decoder builds the new graphs aside, as they're unregistered
+		_ReleaseGraphsInLoad();
+		if(!INTERMEDIATE_GRAPHS && (RedisModule_GetContextFlags(ctx) &
+		   REDISMODULE_CTX_FLAGS_REPLICA_IS_TRANSFERRING)) {
+			graphs_in_load = GraphContext_RetainRegisteredGraphContexts();
+		}
+
 		aux_field_counter = 0;
 		uint count = array_len(graphs_in_keyspace);
 		for (size_t i = 0; i < count; i++) {
@@ -237,6 +262,40 @@ static void _PersistenceEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid,
 	}
 }
 
+// the loaded graphs are in place, or loading failed
+// either way the graphs held before the full sync are no longer served
+static void _LoadingEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid,
+		uint64_t subevent, void *data) {
+	if(subevent == REDISMODULE_SUBEVENT_LOADING_ENDED ||
+	   subevent == REDISMODULE_SUBEVENT_LOADING_FAILED) {
+		_ReleaseGraphsInLoad();
+	}
+
+	// re-plan the loaded graphs' most executed queries
+	if(subevent == REDISMODULE_SUBEVENT_LOADING_ENDED) PlanWarmup_Start();
+	else if(subevent == REDISMODULE_SUBEVENT_LOADING_FAILED) PlanWarmup_Discard();
+}
+
+// a fork child shares the parent's memory pages until it exits
+// direct writes to fresh pages for as long as the child is alive
+// once the child exits, merge the changes deferred meanwhile
+static void _ForkChildEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid,
+		uint64_t subevent, void *data) {
+	bool born = (subevent == REDISMODULE_SUBEVENT_FORK_CHILD_BORN);
+
+	uint graph_count = array_len(graphs_in_keyspace);
+	for(uint i = 0; i < graph_count; i++) {
+		// acquire read lock, guarantee graph isn't modified
+		Graph *g = graphs_in_keyspace[i]->g;
+		Graph_AcquireReadLock(g);
+
+		Graph_SetSharedPages(g, born);
+		if(!born && !INTERMEDIATE_GRAPHS) Graph_ApplyAllPending(g, false);
+
+		Graph_ReleaseLock(g);
+	}
+}
+
 // Perform clean-up upon server shutdown.
 static void _ShutdownEventHandler(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent,
 		void *data) {
@@ -258,6 +317,12 @@ static void _RegisterServerEvents(RedisModuleCtx *ctx) {
 
 	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Persistence,
 			_PersistenceEventHandler);
+
+	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Loading,
+			_LoadingEventHandler);
+
+	RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_ForkChild,
+			_ForkChildEventHandler);
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,204 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_algo_utils.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+bool AlgoArgs_ReadFilters
+(
+	GraphContext *gc,
+	SIValue label_arg,
+	SIValue relation_arg,
+	int *label,
+	int *relation,
+	bool *missing
+) {
+	ASSERT(gc       != NULL);
+	ASSERT(label    != NULL);
+	ASSERT(missing  != NULL);
+	ASSERT(relation != NULL);
+
+	if(!(SI_TYPE(label_arg) & (T_STRING | T_NULL)))    return false;
+	if(!(SI_TYPE(relation_arg) & (T_STRING | T_NULL))) return false;
+
+	*missing  = false;
+	*label    = GRAPH_NO_LABEL;
+	*relation = GRAPH_NO_RELATION;
+
+	if(SI_TYPE(label_arg) == T_STRING) {
+		Schema *s = GraphContext_GetSchema(gc, label_arg.stringval,
+				SCHEMA_NODE);
+		if(s == NULL) *missing = true;
+		else *label = s->id;
+	}
+
+	if(SI_TYPE(relation_arg) == T_STRING) {
+		Schema *s = GraphContext_GetSchema(gc, relation_arg.stringval,
+				SCHEMA_EDGE);
+		if(s == NULL) *missing = true;
+		else *relation = s->id;
+	}
+
+	return true;
+}
+
+// heap items are entry indices offset by 1, as NULL marks an empty heap
+#define ENTRY_ITEM(idx) ((void *)(uintptr_t)((idx) + 1))
+#define ITEM_ENTRY(item) ((uintptr_t)(item) - 1)
+
+// compare values in retained order, < 0 if 'a' precedes 'b'
+static inline int _AlgoNodeValues_Compare
+(
+	const AlgoNodeValues *res,
+	SIValue a,
+	SIValue b
+) {
+	return SIValue_Compare(a, b, NULL) * res->direction;
+}
+
+// the worst retained entry is on top of the heap
+static int _AlgoNodeValues_HeapCmp
+(
+	const void *a,
+	const void *b,
+	const void *udata
+) {
+	const AlgoNodeValues *res = udata;
+	return _AlgoNodeValues_Compare(res, res->entries[ITEM_ENTRY(a)].v,
+			res->entries[ITEM_ENTRY(b)].v);
+}
+
+AlgoNodeValues *AlgoNodeValues_New
+(
+	Graph *g,
+	const ProcedureCtx *proc,
+	const char *value_name,
+	const char **yield
+) {
+	ASSERT(g          != NULL);
+	ASSERT(proc       != NULL);
+	ASSERT(value_name != NULL);
+
+	AlgoNodeValues *res = rm_calloc(1, sizeof(AlgoNodeValues));
+	res->g       = g;
+	res->node    = GE_NEW_NODE();
+	res->output  = array_new(SIValue, 2);
+	res->entries = array_new(AlgoNodeValue, 0);
+
+	// retain only the entries the consumer keeps
+	const ProcedureOrderHint *hint = &proc->hint;
+	if(hint->output != NULL && strcasecmp(hint->output, value_name) == 0) {
+		res->limit     = hint->limit;
+		res->direction = hint->direction;
+		res->top       = Heap_new(_AlgoNodeValues_HeapCmp, res);
+	}
+
+	int idx = 0;
+	for(uint i = 0; i < array_len(yield); i++) {
+		if(strcasecmp("node", yield[i]) == 0) {
+			res->yield_node = res->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp(value_name, yield[i]) == 0) {
+			res->yield_value = res->output + idx;
+			idx++;
+			continue;
+		}
+	}
+
+	return res;
+}
+
+void AlgoNodeValues_Add
+(
+	AlgoNodeValues *res,
+	NodeID id,
+	SIValue v
+) {
+	ASSERT(res != NULL);
+
+	AlgoNodeValue entry = {.id = id, .v = v};
+
+	if(res->top == NULL) {
+		array_append(res->entries, entry);
+		return;
+	}
+
+	if(res->limit == 0) return;
+
+	uint64_t count = array_len(res->entries);
+	if(count < res->limit) {
+		array_append(res->entries, entry);
+		Heap_offer(&res->top, ENTRY_ITEM(count));
+		return;
+	}
+
+	// replace the worst retained entry if 'v' precedes it
+	uintptr_t worst = ITEM_ENTRY(Heap_peek(res->top));
+	if(_AlgoNodeValues_Compare(res, v, res->entries[worst].v) < 0) {
+		Heap_poll(res->top);
+		res->entries[worst] = entry;
+		Heap_offer(&res->top, ENTRY_ITEM(worst));
+	}
+}
+
+// order retained entries, best first
+static void _AlgoNodeValues_Order
+(
+	AlgoNodeValues *res
+) {
+	uint64_t count = array_len(res->entries);
+	AlgoNodeValue *ordered = array_newlen(AlgoNodeValue, count);
+
+	// the heap yields the worst entry first
+	for(uint64_t i = count; i > 0; i--) {
+		ordered[i - 1] = res->entries[ITEM_ENTRY(Heap_poll(res->top))];
+	}
+
+	array_free(res->entries);
+	res->entries = ordered;
+
+	Heap_free(res->top);
+	res->top = NULL;
+}
+
+SIValue *AlgoNodeValues_Step
+(
+	AlgoNodeValues *res
+) {
+	ASSERT(res != NULL);
+
+	if(res->top != NULL) _AlgoNodeValues_Order(res);
+
+	// depleted/no results
+	if(res->i >= array_len(res->entries)) return NULL;
+
+	AlgoNodeValue *entry = res->entries + res->i++;
+
+	if(res->yield_node) {
+		Graph_GetNode(res->g, entry->id, &res->node);
+		*res->yield_node = SI_Node(&res->node);
+	}
+	if(res->yield_value) *res->yield_value = entry->v;
+
+	return res->output;
+}
+
+void AlgoNodeValues_Free
+(
+	AlgoNodeValues *res
+) {
+	if(res == NULL) return;
+
+	if(res->top)     Heap_free(res->top);
+	if(res->output)  array_free(res->output);
+	if(res->entries) array_free(res->entries);
+	rm_free(res);
+}
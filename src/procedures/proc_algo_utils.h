@@ -0,0 +1,90 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "proc_ctx.h"
+#include "../value.h"
+#include "../util/heap.h"
+#include "../graph/graphcontext.h"
+#include "../../deps/GraphBLAS/Include/GraphBLAS.h"
+
+// utilities shared by the algo.* procedures operating on the sub-graph
+// induced by a node label and a relationship type, see AlgoMatrix_Build
+
+// resolves the label and relationship-type arguments
+// each is either a string or NULL, standing for any
+// returns false if an argument is of a different type
+// sets 'missing' if a named label or relationship type doesn't exist
+bool AlgoArgs_ReadFilters
+(
+	GraphContext *gc,       // graph context
+	SIValue label_arg,      // label argument
+	SIValue relation_arg,   // relationship-type argument
+	int *label,             // [output] label ID
+	int *relation,          // [output] relationship-type ID
+	bool *missing           // [output] unknown label or relationship type
+);
+
+// a node and its algorithm result
+typedef struct {
+	NodeID id;     // node ID
+	SIValue v;     // node value
+} AlgoNodeValue;
+
+// per node algorithm results, yielded as (node, value) records
+// when the consumer retains only the top records ordered by value
+// only those are kept, see ProcedureOrderHint
+typedef struct {
+	Graph *g;                 // graph
+	GrB_Index i;              // next result to yield
+	AlgoNodeValue *entries;   // results, array
+	heap_t *top;              // retained entries, worst on top, NULL if all
+	uint64_t limit;           // number of retained entries
+	int direction;            // retained order, DIR_ASC or DIR_DESC
+	Node node;                // yielded node
+	SIValue *output;          // yielded record
+	SIValue *yield_node;      // yielded node slot
+	SIValue *yield_value;     // yielded value slot
+} AlgoNodeValues;
+
+// create an empty result set yielding 'node' and 'value_name'
+// retaining entries according to the procedure's order hint
+AlgoNodeValues *AlgoNodeValues_New
+(
+	Graph *g,                   // graph
+	const ProcedureCtx *proc,   // procedure producing results
+	const char *value_name,     // name of the value output
+	const char **yield          // outputs to yield
+);
+
+// add the result of node 'id'
+void AlgoNodeValues_Add
+(
+	AlgoNodeValues *res,     // results
+	NodeID id,               // node ID
+	SIValue v                // node value
+);
+
+// returns the next record or NULL once depleted
+SIValue *AlgoNodeValues_Step
+(
+	AlgoNodeValues *res
+);
+
+void AlgoNodeValues_Free
+(
+	AlgoNodeValues *res
+);
+
+// node ID of row 'i'
+static inline NodeID AlgoNodeValues_NodeID
+(
+	const GrB_Index *mapping,
+	GrB_Index i
+) {
+	return (mapping) ? mapping[i] : i;
+}
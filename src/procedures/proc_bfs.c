@@ -13,6 +13,7 @@
 #include "../datatypes/array.h"
 #include "../graph/graphcontext.h"
 #include "../configuration/config.h"
+#include "../algorithms/bidirectional_bfs.h"
 #include "../algorithms/LAGraph_bfs_pushpull.h"
 
 // The BFS procedure performs a single source BFS scan
@@ -20,12 +21,20 @@
 // 1. source node to traverse from
 // 2. depth, how deep should the procedure traverse (0 no limit)
 // 3. relationship type to traverse, (NULL for edge type agnostic)
+// 4. optional destination node, when specified a bidirectional search
+//    looks for a shortest path from source to destination
 //
 // output:
 // 1. nodes - an array of reachable nodes
 // 2. edges- an array of edges traversed
 //
 // MATCH (a:User {id: 1}) CALL algo.bfs(a, 0, 'MANAGES') YIELD nodes, edges
+//
+// when a destination is specified nodes and edges form a shortest path
+// excluding the source node
+//
+// MATCH (a:User {id: 1}), (b:User {id: 5})
+// CALL algo.bfs(a, 0, 'MANAGES', b) YIELD nodes, edges
 
 typedef struct {
 	Graph *g;                       // Graph scanned.
@@ -37,6 +46,7 @@ typedef struct {
 	SIValue *yield_edges;           // yield edges traversed
 	GrB_Vector nodes;               // Vector of reachable nodes.
 	GrB_Vector parents;             // Vector associating each node in the BFS tree with its parent.
+	NodeID *path;                   // Shortest path to destination node, if specified.
 } BFSCtx;
 
 static void _process_yield
@@ -73,11 +83,13 @@ static ProcedureResult Proc_BFS_Invoke
 	ASSERT(ctx   !=  NULL);
 	ASSERT(args  !=  NULL);
 
-	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	uint argc = array_len((SIValue *)args);
+	if(argc != 3 && argc != 4) return PROCEDURE_ERR;
 
 	if(SI_TYPE(args[0]) != T_NODE                 ||   // source node
 	   SI_TYPE(args[1]) != T_INT64                ||   // max level to iterate to, unlimited if 0
-	   !(SI_TYPE(args[2]) & (T_NULL | T_STRING)))      // relationship type to traverse if not NULL
+	   !(SI_TYPE(args[2]) & (T_NULL | T_STRING))  ||   // relationship type to traverse if not NULL
+	   (argc == 4 && SI_TYPE(args[3]) != T_NODE))      // destination node
 		return PROCEDURE_ERR;
 
 	BFSCtx *bfs_ctx = ctx->privateData;
@@ -90,31 +102,43 @@ static ProcedureResult Proc_BFS_Invoke
 	Node *source_node = args[0].ptrval;
 	int64_t max_level = args[1].longval;
 	const char *reltype = SIValue_IsNull(args[2]) ? NULL : args[2].stringval;
+	Node *dest_node = (argc == 4) ? args[3].ptrval : NULL;
 
-	// the BFS algorithm uses a level of 1 to indicate the source node
-	// if this value is not zero (unlimited), increment it by 1
-	// to make level 1 indicate the source's direct neighbors
-	if(max_level > 0) max_level++;
 	GrB_Index src_id = ENTITY_GET_ID(source_node);
+	GraphContext *gc = QueryCtx_GetGraphCtx();
 
-	// Get edge matrix and transpose matrix, if available.
-	GrB_Matrix    R    =  NULL;
-	GrB_Matrix    TR   =  NULL;
-	GraphContext  *gc  =  QueryCtx_GetGraphCtx();
-
-	if(reltype == NULL) {
-		RG_Matrix_export(&R, Graph_GetAdjacencyMatrix(gc->g, false));
-		RG_Matrix_export(&TR, Graph_GetAdjacencyMatrix(gc->g, true));
-	} else {
+	if(reltype != NULL) {
 		Schema *s = GraphContext_GetSchema(gc, reltype, SCHEMA_EDGE);
 		// failed to find schema, first step will return NULL
 		if(!s) return PROCEDURE_OK;
 
 		bfs_ctx->reltype_id = s->id;
-		RG_Matrix_export(&R, Graph_GetRelationMatrix(gc->g, s->id, false));
-		RG_Matrix_export(&TR, Graph_GetRelationMatrix(gc->g, s->id, true));
 	}
 
+	RG_Matrix M  = Graph_GetRelationMatrix(gc->g, bfs_ctx->reltype_id, false);
+	RG_Matrix MT = Graph_GetRelationMatrix(gc->g, bfs_ctx->reltype_id, true);
+
+	if(dest_node != NULL) {
+		// search for a shortest path, expanding from both ends
+		uint max_len = (max_level > 0) ? max_level : UINT_MAX;
+		bfs_ctx->path = BidirectionalBFS(&M, &MT, 1, src_id,
+				ENTITY_GET_ID(dest_node), max_len);
+		// the source node isn't reported
+		if(bfs_ctx->path != NULL) bfs_ctx->n = array_len(bfs_ctx->path) - 1;
+		return PROCEDURE_OK;
+	}
+
+	// the BFS algorithm uses a level of 1 to indicate the source node
+	// if this value is not zero (unlimited), increment it by 1
+	// to make level 1 indicate the source's direct neighbors
+	if(max_level > 0) max_level++;
+
+	// export edge matrix and its transpose
+	GrB_Matrix R  = NULL;
+	GrB_Matrix TR = NULL;
+	RG_Matrix_export(&R, M);
+	RG_Matrix_export(&TR, MT);
+
 	// if we're not collecting edges, pass a NULL parent pointer
 	// so that the algorithm will not perform unnecessary work
 	GrB_Vector V = GrB_NULL;  // vector of results
@@ -173,6 +197,28 @@ static SIValue *Proc_BFS_Step
 	if(yield_edges) edges = SI_Array(n);
 	Edge *edge = array_new(Edge, 1);
 
+	if(bfs_ctx->path != NULL) {
+		// emit the nodes and edges along the path to the destination
+		for(uint i = 1; i <= n; i++) {
+			NodeID id = bfs_ctx->path[i];
+			if(yield_nodes) {
+				Node node = GE_NEW_NODE();
+				Graph_GetNode(bfs_ctx->g, id, &node);
+				SIArray_Append(&nodes, SI_Node(&node));
+			}
+
+			if(yield_edges) {
+				array_clear(edge);
+				Graph_GetEdgesConnectingNodes(bfs_ctx->g, bfs_ctx->path[i - 1],
+						id, bfs_ctx->reltype_id, &edge);
+				SIArray_Append(&edges, SI_Edge(edge));
+			}
+		}
+
+		bfs_ctx->depleted = true;
+		goto populate;
+	}
+
 	// setup result iterator
 	NodeID               id;
 	GrB_Info             res;
@@ -213,6 +259,7 @@ static SIValue *Proc_BFS_Step
 
 	bfs_ctx->depleted = depleted; // mark that this node has been mapped
 
+populate:
 	// populate output
 	if(yield_nodes) *bfs_ctx->yield_nodes = nodes;
 	if(yield_edges) *bfs_ctx->yield_edges = edges;
@@ -235,6 +282,7 @@ static ProcedureResult Proc_BFS_Free
 	if(pdata->output   !=  NULL)  array_free(pdata->output);
 	if(pdata->nodes    !=  NULL)  GrB_Vector_free(&pdata->nodes);
 	if(pdata->parents  !=  NULL)  GrB_Vector_free(&pdata->parents);
+	if(pdata->path     !=  NULL)  array_free(pdata->path);
 
 	rm_free(ctx->privateData);
 
@@ -249,6 +297,7 @@ static BFSCtx *_Build_Private_Data() {
 	pdata->g            =  QueryCtx_GetGraph();
 	pdata->nodes        =  GrB_NULL;
 	pdata->output       =  array_new(SIValue, 2);
+	pdata->path         =  NULL;
 	pdata->parents      =  GrB_NULL;
 	pdata->depleted     =  false;
 	pdata->reltype_id   =  GRAPH_NO_RELATION;
@@ -270,7 +319,7 @@ ProcedureCtx *Proc_BFS_Ctx() {
 	array_append(outputs, out_edges);
 
 	ProcedureCtx *ctx = ProcCtxNew("algo.BFS",
-								   3,
+								   PROCEDURE_VARIABLE_ARG_COUNT,
 								   outputs,
 								   Proc_BFS_Step,
 								   Proc_BFS_Invoke,
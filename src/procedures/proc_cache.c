@@ -0,0 +1,164 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_cache.h"
+#include "RG.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// db.cache.stats
+//------------------------------------------------------------------------------
+
+// CALL db.cache.stats() YIELD hits, misses, autoParameterize
+// reports execution plan cache statistics of the current graph
+// note, the lookup issued by the call itself is accounted for
+
+typedef struct {
+	bool depleted;   // single row emitted
+	SIValue *out;    // output row
+} CacheStatsContext;
+
+ProcedureResult Proc_CacheStatsInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	if(array_len((SIValue *)args) != 0) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	uint64_t hits;
+	uint64_t misses;
+	Cache_GetStats(GraphContext_GetCache(gc), &hits, &misses);
+	bool auto_parameterize = GraphContext_AutoParameterize(gc);
+
+	CacheStatsContext *pdata = rm_malloc(sizeof(CacheStatsContext));
+	pdata->depleted = false;
+	pdata->out      = array_new(SIValue, 3);
+
+	// populate outputs in yield order
+	for(uint i = 0; i < array_len(yield); i++) {
+		SIValue v = SI_NullVal();
+		if(strcasecmp("hits", yield[i]) == 0) {
+			v = SI_LongVal(hits);
+		} else if(strcasecmp("misses", yield[i]) == 0) {
+			v = SI_LongVal(misses);
+		} else if(strcasecmp("autoParameterize", yield[i]) == 0) {
+			v = SI_BoolVal(auto_parameterize);
+		}
+		array_append(pdata->out, v);
+	}
+
+	ctx->privateData = pdata;
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_CacheStatsStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData != NULL);
+
+	CacheStatsContext *pdata = (CacheStatsContext *)ctx->privateData;
+	if(pdata->depleted) return NULL;
+
+	pdata->depleted = true;
+	return pdata->out;
+}
+
+ProcedureResult Proc_CacheStatsFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	if(ctx->privateData) {
+		CacheStatsContext *pdata = ctx->privateData;
+		array_free(pdata->out);
+		rm_free(ctx->privateData);
+	}
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_CacheStatsCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 3);
+	ProcedureOutput out_hits = {.name = "hits", .type = T_INT64};
+	ProcedureOutput out_misses = {.name = "misses", .type = T_INT64};
+	ProcedureOutput out_auto = {.name = "autoParameterize", .type = T_BOOL};
+	array_append(outputs, out_hits);
+	array_append(outputs, out_misses);
+	array_append(outputs, out_auto);
+
+	ProcedureCtx *ctx = ProcCtxNew("db.cache.stats",
+								   0,
+								   outputs,
+								   Proc_CacheStatsStep,
+								   Proc_CacheStatsInvoke,
+								   Proc_CacheStatsFree,
+								   privateData,
+								   true);
+	return ctx;
+}
+
+//------------------------------------------------------------------------------
+// db.cache.autoParameterize
+//------------------------------------------------------------------------------
+
+// CALL db.cache.autoParameterize(true)
+// opt the current graph in (or out) of auto-parameterization, when enabled
+// literals within MATCH and WHERE clauses are lifted into parameters
+// such that queries which differ only by their literals share a cached plan
+// the procedure is marked as a write, to have it replicated
+
+ProcedureResult Proc_CacheAutoParameterizeInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	if(array_len((SIValue *)args) != 1) return PROCEDURE_ERR;
+	if(SI_TYPE(args[0]) != T_BOOL) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	GraphContext_SetAutoParameterize(gc, args[0].longval);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_CacheAutoParameterizeStep
+(
+	ProcedureCtx *ctx
+) {
+	return NULL;
+}
+
+ProcedureResult Proc_CacheAutoParameterizeFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_CacheAutoParameterizeCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.cache.autoParameterize",
+								   1,
+								   outputs,
+								   Proc_CacheAutoParameterizeStep,
+								   Proc_CacheAutoParameterizeInvoke,
+								   Proc_CacheAutoParameterizeFree,
+								   privateData,
+								   false);
+	return ctx;
+}
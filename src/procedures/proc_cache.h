@@ -0,0 +1,15 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "proc_ctx.h"
+
+// CALL db.cache.stats()
+ProcedureCtx *Proc_CacheStatsCtx();
+
+// CALL db.cache.autoParameterize(enable)
+ProcedureCtx *Proc_CacheAutoParameterizeCtx();
@@ -31,6 +31,17 @@ typedef struct {
 	SIType type;    // Type of output.
 } ProcedureOutput;
 
+// order and number of records a procedure's consumer retains
+// e.g. CALL algo.pageRank(NULL, NULL) YIELD node, score
+//      RETURN node ORDER BY score DESC LIMIT 10
+// retains the 10 records with the highest score, a procedure ordering
+// its records by 'score' may produce those alone
+typedef struct {
+	const char *output;  // output records are ordered by, NULL if no hint
+	int direction;       // DIR_ASC or DIR_DESC
+	uint64_t limit;      // number of records retained
+} ProcedureOrderHint;
+
 struct ProcedureCtx;
 
 // Procedure instance generator.
@@ -53,6 +64,8 @@ struct ProcedureCtx {
 	ProcInvoke Invoke;          //
 	ProcFree Free;              //
 	bool readOnly;              // Indicates if the procedure is able to mutate the graph.
+	const char *orderable;      // Output the procedure can order its records by, NULL if none.
+	ProcedureOrderHint hint;    // Records retained by the consumer, set before invocation.
 };
 typedef struct ProcedureCtx ProcedureCtx;
 
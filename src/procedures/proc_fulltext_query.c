@@ -12,6 +12,7 @@
 #include "../query_ctx.h"
 #include "../index/index.h"
 #include "../util/rmalloc.h"
+#include "proc_algo_utils.h"
 #include "../graph/graphcontext.h"
 
 //------------------------------------------------------------------------------
@@ -26,6 +27,7 @@ typedef struct {
 	SIValue *output;
 	Index *idx;
 	RSResultsIterator *iter;
+	AlgoNodeValues *top;     // top scored results, NULL if results stream
 	SIValue *yield_node;     // yield node
 	SIValue *yield_score;    // yield score
 } QueryNodeContext;
@@ -84,11 +86,13 @@ ProcedureResult Proc_FulltextQueryNodeInvoke
 	pdata->g       =  gc->g;
 	pdata->n       =  GE_NEW_NODE();
 	pdata->idx     =  idx;
+	pdata->top     =  NULL;
 	pdata->output  =  array_new(SIValue,  2);
 
 	_process_yield(pdata, yield);
 
-	// execute query
+	// execute query, the index must reflect the query's own modifications
+	QueryCtx_ApplyIndexChanges();
 	pdata->iter = Index_Query(pdata->idx, query, &err);
 
 	// raise runtime exception if err != NULL
@@ -105,6 +109,23 @@ ProcedureResult Proc_FulltextQueryNodeInvoke
 
 	ASSERT(pdata->iter != NULL);
 
+	// the consumer retains only the top scored results
+	// collect those out of the index, nodes are fetched for them alone
+	if(ctx->hint.output != NULL) {
+		pdata->top = AlgoNodeValues_New(pdata->g, ctx, "score", yield);
+
+		size_t len = 0;
+		NodeID *id;
+		while((id = (NodeID *)RediSearch_ResultsIteratorNext(pdata->iter,
+						pdata->idx->idx, &len)) != NULL) {
+			double score = RediSearch_ResultsIteratorGetScore(pdata->iter);
+			AlgoNodeValues_Add(pdata->top, *id, SI_DoubleVal(score));
+		}
+
+		RediSearch_ResultsIteratorFree(pdata->iter);
+		pdata->iter = NULL;
+	}
+
 	return PROCEDURE_OK;
 }
 
@@ -115,7 +136,8 @@ SIValue *Proc_FulltextQueryNodeStep
 	if(!ctx->privateData) return NULL; // no index was attached to this procedure
 
 	QueryNodeContext *pdata = (QueryNodeContext *)ctx->privateData;
-	if(!pdata || !pdata->iter) return NULL;
+	if(pdata->top) return AlgoNodeValues_Step(pdata->top);
+	if(!pdata->iter) return NULL;
 
 	// try to get a result out of the iterator
 	// NULL is returned if iterator id depleted
@@ -125,14 +147,17 @@ SIValue *Proc_FulltextQueryNodeStep
 	// depleted
 	if(!id) return NULL;
 
-	double score = RediSearch_ResultsIteratorGetScore(pdata->iter);
-
-	// get node
-	Node *n = &pdata->n;
-	Graph_GetNode(pdata->g, *id, n);
+	// get node, only if yielded
+	if(pdata->yield_node) {
+		Node *n = &pdata->n;
+		Graph_GetNode(pdata->g, *id, n);
+		*pdata->yield_node = SI_Node(n);
+	}
 
-	if(pdata->yield_node)  *pdata->yield_node  = SI_Node(n);
-	if(pdata->yield_score) *pdata->yield_score = SI_DoubleVal(score);
+	if(pdata->yield_score) {
+		double score = RediSearch_ResultsIteratorGetScore(pdata->iter);
+		*pdata->yield_score = SI_DoubleVal(score);
+	}
 
 	return pdata->output;
 }
@@ -147,6 +172,7 @@ ProcedureResult Proc_FulltextQueryNodeFree
 	QueryNodeContext *pdata = ctx->privateData;
 	array_free(pdata->output);
 	if(pdata->iter) RediSearch_ResultsIteratorFree(pdata->iter);
+	AlgoNodeValues_Free(pdata->top);
 	rm_free(pdata);
 
 	return PROCEDURE_OK;
@@ -168,6 +194,7 @@ ProcedureCtx *Proc_FulltextQueryNodeGen() {
 								   Proc_FulltextQueryNodeFree,
 								   privateData,
 								   true);
+	ctx->orderable = "score";
 	return ctx;
 }
 
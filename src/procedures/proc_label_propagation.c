@@ -0,0 +1,122 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_label_propagation.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "proc_algo_utils.h"
+#include "../algorithms/algo_matrix.h"
+#include "../algorithms/label_propagation.h"
+
+// community detection by label propagation, edge direction is ignored
+// each node is yielded along with its community ID, the ID of the node
+// whose label the community adopted
+// the third argument caps the number of iterations, NULL for the default
+//
+// CALL algo.labelPropagation(NULL, NULL, NULL)      YIELD node, communityId
+// CALL algo.labelPropagation('User', 'FOLLOWS', 20) YIELD node, communityId
+
+#define LABEL_PROPAGATION_DEFAULT_ITERATIONS 10
+
+ProcedureResult Proc_LabelPropagationInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	// expecting 3 arguments
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+
+	int label;
+	int relation;
+	bool missing;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(!AlgoArgs_ReadFilters(gc, args[0], args[1], &label, &relation,
+				&missing)) {
+		return PROCEDURE_ERR;
+	}
+
+	// max iterations, a positive integer or NULL
+	int itermax = LABEL_PROPAGATION_DEFAULT_ITERATIONS;
+	if(SI_TYPE(args[2]) == T_INT64) {
+		if(args[2].longval <= 0) return PROCEDURE_ERR;
+		itermax = args[2].longval;
+	} else if(SI_TYPE(args[2]) != T_NULL) {
+		return PROCEDURE_ERR;
+	}
+
+	AlgoNodeValues *res = AlgoNodeValues_New(gc->g, ctx, "communityId", yield);
+	ctx->privateData = res;
+
+	// unknown label or relationship type, quickly return
+	if(missing) return PROCEDURE_OK;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	int iters;
+	GrB_Index n;
+	GrB_Matrix A;
+	GrB_Index *mapping;
+	GrB_Index *labels;
+
+	info = AlgoMatrix_Build(&A, &mapping, &n, gc->g, label, relation,
+			ATTRIBUTE_NOTFOUND, true);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = LabelPropagation(&labels, A, itermax, &iters);
+	ASSERT(info == GrB_SUCCESS);
+	GrB_free(&A);
+
+	for(GrB_Index i = 0; i < n; i++) {
+		NodeID community = AlgoNodeValues_NodeID(mapping, labels[i]);
+		AlgoNodeValues_Add(res, AlgoNodeValues_NodeID(mapping, i),
+				SI_LongVal(community));
+	}
+	if(labels) rm_free(labels);
+	if(mapping) rm_free(mapping);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_LabelPropagationStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData);
+	return AlgoNodeValues_Step((AlgoNodeValues *)ctx->privateData);
+}
+
+ProcedureResult Proc_LabelPropagationFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	AlgoNodeValues_Free((AlgoNodeValues *)ctx->privateData);
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_LabelPropagationCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 2);
+	ProcedureOutput output_node = {.name = "node", .type = T_NODE};
+	ProcedureOutput output_community = {.name = "communityId", .type = T_INT64};
+	array_append(outputs, output_node);
+	array_append(outputs, output_community);
+
+	ProcedureCtx *ctx = ProcCtxNew("algo.labelPropagation",
+								   3,
+								   outputs,
+								   Proc_LabelPropagationStep,
+								   Proc_LabelPropagationInvoke,
+								   Proc_LabelPropagationFree,
+								   privateData,
+								   true);
+	ctx->orderable = "communityId";
+	return ctx;
+}
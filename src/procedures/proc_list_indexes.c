@@ -132,8 +132,10 @@ static bool _EmitIndex
 	if(ctx->yield_type != NULL) {
 		if(type == IDX_EXACT_MATCH) {
 			*ctx->yield_type = SI_ConstStringVal("exact-match");
-		} else {
+		} else if(type == IDX_FULLTEXT) {
 			*ctx->yield_type = SI_ConstStringVal("full-text");
+		} else {
+			*ctx->yield_type = SI_ConstStringVal("vector");
 		}
 	}
 
@@ -153,8 +155,9 @@ static bool _EmitIndex
 	}
 
 	if(ctx->yield_language) {
-		*ctx->yield_language =
-			SI_ConstStringVal((char *)Index_GetLanguage(idx));
+		const char *language = Index_GetLanguage(idx);
+		*ctx->yield_language = (language != NULL) ?
+			SI_ConstStringVal((char *)language) : SI_NullVal();
 	}
 
 	if(ctx->yield_stopwords) {
@@ -196,10 +199,13 @@ static SIValue *Schema_Step
 		// populate index data if one is found
 		bool found = _EmitIndex(pdata, s, pdata->type);
 
-		if(pdata->type == IDX_FULLTEXT) {
+		if(pdata->type == IDX_VECTOR) {
 			// all indexes retrieved; update schema_id, reset schema type
 			(*schema_id)--;
 			pdata->type = IDX_EXACT_MATCH;
+		} else if(pdata->type == IDX_FULLTEXT) {
+			// next iteration will check the same schema for a vector index
+			pdata->type = IDX_VECTOR;
 		} else {
 			// next iteration will check the same schema for a full-text index
 			pdata->type = IDX_FULLTEXT;
@@ -245,7 +251,7 @@ ProcedureCtx *Proc_IndexesCtx() {
 	ProcedureOutput output;
 	ProcedureOutput *outputs = array_new(ProcedureOutput, 6);
 
-	// index type (exact-match / fulltext)
+	// index type (exact-match / fulltext / vector)
 	output = (ProcedureOutput) {
 		.name = "type", .type = T_STRING
 	};
@@ -10,8 +10,13 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../util/qsort.h"
+#include "proc_algo_utils.h"
+#include "../datatypes/array.h"
 #include "../graph/graphcontext.h"
 #include "../algorithms/pagerank.h"
+#include "../algorithms/algo_matrix.h"
+#include "../algorithms/weighted_pagerank.h"
 
 // CALL algo.pageRank(NULL, NULL)      YIELD node, score
 // CALL algo.pageRank('Page', NULL)    YIELD node, score
@@ -238,3 +243,262 @@ ProcedureCtx *Proc_PagerankCtx() {
 	return ctx;
 }
 
+
+//------------------------------------------------------------------------------
+// weighted and personalized pagerank
+//------------------------------------------------------------------------------
+
+// CALL algo.weightedPageRank('Page', 'LINKS', 'weight') YIELD node, score
+//
+// MATCH (s:Page {url: 'a'})
+// CALL algo.personalizedPageRank('Page', 'LINKS', [s], NULL) YIELD node, score
+//
+// edges distribute rank proportionally to their weight attribute,
+// edges lacking a positive numeric weight are ignored
+// personalized pagerank jumps to the specified source nodes only
+
+#define PAGERANK_DAMPING 0.85
+#define PAGERANK_ITERMAX 100
+#define PAGERANK_TOL 1e-6
+
+typedef struct {
+	double score;   // node rank
+	GrB_Index row;  // node row
+} RankedRow;
+
+#define RANK_ISLT(a,b) ((a)->score > (b)->score || \
+		((a)->score == (b)->score && (a)->row < (b)->row))
+
+// returns the row of node 'id' or n if the node isn't part of the sub-graph
+static GrB_Index _NodeRow
+(
+	const GrB_Index *mapping,
+	GrB_Index n,
+	NodeID id
+) {
+	if(mapping == NULL) return (id < n) ? id : n;
+
+	// mapping is sorted in ascending order
+	GrB_Index lo = 0;
+	GrB_Index hi = n;
+	while(lo < hi) {
+		GrB_Index mid = lo + (hi - lo) / 2;
+		if(mapping[mid] < id) lo = mid + 1;
+		else hi = mid;
+	}
+
+	return (lo < n && mapping[lo] == id) ? lo : n;
+}
+
+// builds the jump distribution vector out of 'sources'
+// a node or a list of nodes, returns NULL if none is part of the sub-graph
+static GrB_Vector _JumpVector
+(
+	SIValue sources,
+	const GrB_Index *mapping,
+	GrB_Index n
+) {
+	GrB_Vector p;
+	GrB_Vector_new(&p, GrB_FP64, n);
+
+	uint count = (SI_TYPE(sources) == T_ARRAY) ? SIArray_Length(sources) : 1;
+	for(uint i = 0; i < count; i++) {
+		SIValue v = (SI_TYPE(sources) == T_ARRAY) ?
+			SIArray_Get(sources, i) : sources;
+		GrB_Index row = _NodeRow(mapping, n, ENTITY_GET_ID((Node *)v.ptrval));
+		if(row < n) GrB_Vector_setElement_FP64(p, 1.0, row);
+	}
+
+	GrB_Index nvals;
+	GrB_Vector_nvals(&nvals, p);
+	if(nvals == 0) GrB_free(&p);
+
+	return p;
+}
+
+static bool _ValidSources
+(
+	SIValue sources
+) {
+	if(SI_TYPE(sources) == T_NODE) return true;
+	if(SI_TYPE(sources) != T_ARRAY) return false;
+
+	uint count = SIArray_Length(sources);
+	for(uint i = 0; i < count; i++) {
+		if(SI_TYPE(SIArray_Get(sources, i)) != T_NODE) return false;
+	}
+
+	return true;
+}
+
+static ProcedureResult _RankInvoke
+(
+	ProcedureCtx *ctx,
+	SIValue label_arg,     // label filter
+	SIValue relation_arg,  // relationship-type filter
+	SIValue weight_arg,    // weight attribute name or NULL
+	SIValue sources,       // source nodes, NULL for uniform jumps
+	const char **yield
+) {
+	int label;
+	int relation;
+	bool missing;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(!AlgoArgs_ReadFilters(gc, label_arg, relation_arg, &label, &relation,
+				&missing)) {
+		return PROCEDURE_ERR;
+	}
+
+	if(!(SI_TYPE(weight_arg) & (T_STRING | T_NULL))) return PROCEDURE_ERR;
+	if(SI_TYPE(sources) != T_NULL && !_ValidSources(sources)) {
+		return PROCEDURE_ERR;
+	}
+
+	AlgoNodeValues *res = AlgoNodeValues_New(gc->g, ctx, "score", yield);
+	ctx->privateData = res;
+
+	Attribute_ID weight = ATTRIBUTE_NOTFOUND;
+	if(SI_TYPE(weight_arg) == T_STRING) {
+		weight = GraphContext_GetAttributeID(gc, weight_arg.stringval);
+		// no edge is weighted
+		if(weight == ATTRIBUTE_NOTFOUND) missing = true;
+	}
+
+	// unknown label, relationship type or attribute, quickly return
+	if(missing) return PROCEDURE_OK;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	int iters;
+	GrB_Index n;
+	GrB_Matrix A;
+	GrB_Vector p = NULL;
+	double *ranks = NULL;
+	GrB_Index *mapping = NULL;
+
+	info = AlgoMatrix_Build(&A, &mapping, &n, gc->g, label, relation, weight,
+			false);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(SI_TYPE(sources) != T_NULL) {
+		p = _JumpVector(sources, mapping, n);
+		// no source within the sub-graph, nothing to rank
+		if(p == NULL) n = 0;
+	}
+
+	if(n > 0) {
+		info = WeightedPagerank(&ranks, A, p, PAGERANK_DAMPING,
+				PAGERANK_ITERMAX, PAGERANK_TOL, &iters);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	GrB_free(&A);
+	if(p != NULL) GrB_free(&p);
+
+	// yield nodes by descending rank
+	// unless only the top ranked nodes are retained, ordered by res
+	RankedRow *rows = NULL;
+	if(res->top == NULL) {
+		rows = rm_malloc(sizeof(RankedRow) * n);
+		for(GrB_Index i = 0; i < n; i++) {
+			rows[i].row = i;
+			rows[i].score = ranks[i];
+		}
+		QSORT(RankedRow, rows, n, RANK_ISLT);
+	}
+
+	for(GrB_Index i = 0; i < n; i++) {
+		GrB_Index row = (rows != NULL) ? rows[i].row : i;
+		AlgoNodeValues_Add(res, AlgoNodeValues_NodeID(mapping, row),
+				SI_DoubleVal(ranks[row]));
+	}
+
+	if(rows) rm_free(rows);
+	if(ranks) rm_free(ranks);
+	if(mapping) rm_free(mapping);
+
+	return PROCEDURE_OK;
+}
+
+ProcedureResult Proc_WeightedPagerankInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	// expecting 3 arguments
+	if(array_len((SIValue *)args) != 3) return PROCEDURE_ERR;
+	// weight attribute is mandatory
+	if(SI_TYPE(args[2]) != T_STRING) return PROCEDURE_ERR;
+
+	return _RankInvoke(ctx, args[0], args[1], args[2], SI_NullVal(), yield);
+}
+
+ProcedureResult Proc_PersonalizedPagerankInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	// expecting 4 arguments
+	if(array_len((SIValue *)args) != 4) return PROCEDURE_ERR;
+	// source nodes are mandatory
+	if(SI_TYPE(args[2]) == T_NULL) return PROCEDURE_ERR;
+
+	return _RankInvoke(ctx, args[0], args[1], args[3], args[2], yield);
+}
+
+SIValue *Proc_RankStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData);
+	return AlgoNodeValues_Step((AlgoNodeValues *)ctx->privateData);
+}
+
+ProcedureResult Proc_RankFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	AlgoNodeValues_Free((AlgoNodeValues *)ctx->privateData);
+	return PROCEDURE_OK;
+}
+
+static ProcedureOutput *_RankOutputs(void) {
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 2);
+	ProcedureOutput output_node = {.name = "node", .type = T_NODE};
+	ProcedureOutput output_score = {.name = "score", .type = T_DOUBLE};
+	array_append(outputs, output_node);
+	array_append(outputs, output_score);
+	return outputs;
+}
+
+ProcedureCtx *Proc_WeightedPagerankCtx() {
+	void *privateData = NULL;
+	ProcedureCtx *ctx = ProcCtxNew("algo.weightedPageRank",
+								   3,
+								   _RankOutputs(),
+								   Proc_RankStep,
+								   Proc_WeightedPagerankInvoke,
+								   Proc_RankFree,
+								   privateData,
+								   true);
+	ctx->orderable = "score";
+	return ctx;
+}
+
+ProcedureCtx *Proc_PersonalizedPagerankCtx() {
+	void *privateData = NULL;
+	ProcedureCtx *ctx = ProcCtxNew("algo.personalizedPageRank",
+								   4,
+								   _RankOutputs(),
+								   Proc_RankStep,
+								   Proc_PersonalizedPagerankInvoke,
+								   Proc_RankFree,
+								   privateData,
+								   true);
+	ctx->orderable = "score";
+	return ctx;
+}
@@ -9,3 +9,5 @@
 #include "proc_ctx.h"
 
 ProcedureCtx *Proc_PagerankCtx();
+ProcedureCtx *Proc_WeightedPagerankCtx();
+ProcedureCtx *Proc_PersonalizedPagerankCtx();
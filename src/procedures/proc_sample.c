@@ -0,0 +1,551 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_sample.h"
+#include "../RG.h"
+#include "rax.h"
+#include "../value.h"
+#include "../errors.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/map.h"
+#include "../graph/graphcontext.h"
+#include <math.h>
+
+// samples nodes without scanning the graph, streaming sampled nodes
+// the procedure accepts a single configuration map:
+//
+// label              - sample nodes of this label only, default any
+// method             - 'uniform' (default), 'bernoulli' or 'randomWalk'
+// size               - number of distinct nodes to sample,
+//                      mandatory for 'uniform' and 'randomWalk'
+// rate               - probability of sampling a node, mandatory for
+//                      'bernoulli', in the range (0, 1]
+// relType            - 'randomWalk' only, relationship type to walk,
+//                      default any
+// restartProbability - 'randomWalk' only, probability of jumping to a
+//                      random node at each step, default 0.15
+// seed               - random seed, default random
+//
+// uniform    - 'size' distinct nodes drawn uniformly by probing random node
+//              IDs, once probing is expected to cost more than a scan
+//              a reservoir is filled by scanning the label instead
+// bernoulli  - every node is sampled independently with probability 'rate'
+//              node IDs are visited by geometrically distributed skips
+//              such that only sampled IDs are inspected
+// randomWalk - nodes visited by a random walk with restarts
+//              following outgoing edges, biased toward well connected nodes
+//
+// CALL algo.sampleNodes({label: 'User', size: 1000}) YIELD node
+// RETURN avg(node.age)
+
+typedef enum {
+	SAMPLE_UNIFORM,
+	SAMPLE_BERNOULLI,
+	SAMPLE_RANDOM_WALK,
+} SampleMethod;
+
+// consecutive failed random walk steps before giving up
+#define WALK_MAX_STALLS 1024
+
+typedef struct {
+	Graph *g;                  // graph sampled
+	SampleMethod method;       // sampling method
+	int label;                 // sampled label ID
+	RG_Matrix L;               // label matrix, NULL if any label
+	RG_Matrix R;               // walked relation matrix
+	RG_MatrixTupleIter *it;    // walked relation iterator
+	uint64_t n;                // node ID range
+	uint64_t size;             // number of nodes to sample
+	uint64_t sampled;          // number of nodes sampled so far
+	double rate;               // bernoulli sampling probability
+	double restart;            // random walk restart probability
+	uint64_t cursor;           // bernoulli next node ID
+	uint64_t attempts;         // random walk probes per restart
+	uint64_t state;            // random generator state
+	rax *seen;                 // sampled node IDs
+	NodeID *reservoir;         // nodes sampled by scan, NULL if probing
+	NodeID position;           // random walk position
+	Node node;                 // yielded node
+	SIValue *output;           // yield values
+	SIValue *yield_node;       // yield node
+} SampleCtx;
+
+// xorshift64* random generator
+static inline uint64_t _Random
+(
+	SampleCtx *ctx
+) {
+	ctx->state ^= ctx->state >> 12;
+	ctx->state ^= ctx->state << 25;
+	ctx->state ^= ctx->state >> 27;
+	return ctx->state * 0x2545F4914F6CDD1DULL;
+}
+
+// uniform random number in [0, 1)
+static inline double _RandomUnit
+(
+	SampleCtx *ctx
+) {
+	return (_Random(ctx) >> 11) * 0x1.0p-53;
+}
+
+// uniform random number in [0, n)
+static inline uint64_t _RandomRange
+(
+	SampleCtx *ctx,
+	uint64_t n
+) {
+	return _Random(ctx) % n;
+}
+
+// returns true if 'id' is an existing node of the sampled label
+static bool _Candidate
+(
+	SampleCtx *ctx,
+	NodeID id
+) {
+	if(ctx->L != NULL) {
+		bool x;
+		return RG_Matrix_extractElement_BOOL(&x, ctx->L, id, id) == GrB_SUCCESS;
+	}
+	return Graph_GetNode(ctx->g, id, &ctx->node);
+}
+
+// marks 'id' as sampled, returns false if it was sampled already
+static inline bool _Sample
+(
+	SampleCtx *ctx,
+	NodeID id
+) {
+	return raxTryInsert(ctx->seen, (unsigned char *)&id, sizeof(id), NULL,
+			NULL);
+}
+
+// probes random node IDs until a candidate is found
+// gives up after 'attempts' probes
+static bool _ProbeCandidate
+(
+	SampleCtx *ctx,
+	uint64_t attempts,
+	NodeID *id
+) {
+	for(uint64_t i = 0; i < attempts; i++) {
+		*id = _RandomRange(ctx, ctx->n);
+		if(_Candidate(ctx, *id)) return true;
+	}
+	return false;
+}
+
+// fill a reservoir of 'size' nodes by scanning the candidates
+static void _FillReservoir
+(
+	SampleCtx *ctx
+) {
+	ctx->reservoir = array_new(NodeID, ctx->size);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	NodeID id;
+	uint64_t seen = 0;
+	bool depleted = false;
+	RG_MatrixTupleIter *it = NULL;
+	DataBlockIterator *nodes = NULL;
+
+	if(ctx->L != NULL) {
+		info = RG_MatrixTupleIter_new(&it, ctx->L);
+		ASSERT(info == GrB_SUCCESS);
+	} else {
+		nodes = Graph_ScanNodes(ctx->g);
+	}
+
+	while(true) {
+		if(it != NULL) {
+			info = RG_MatrixTupleIter_next(it, &id, NULL, NULL, &depleted);
+			ASSERT(info == GrB_SUCCESS);
+			if(depleted) break;
+		} else if(DataBlockIterator_Next(nodes, &id) == NULL) {
+			break;
+		}
+
+		// the i'th candidate replaces a retained one with probability size/i
+		seen++;
+		if(array_len(ctx->reservoir) < ctx->size) {
+			array_append(ctx->reservoir, id);
+		} else {
+			uint64_t j = _RandomRange(ctx, seen);
+			if(j < ctx->size) ctx->reservoir[j] = id;
+		}
+	}
+
+	if(it != NULL) RG_MatrixTupleIter_free(&it);
+	if(nodes != NULL) DataBlockIterator_Free(nodes);
+}
+
+static bool _NextUniform
+(
+	SampleCtx *ctx,
+	NodeID *id
+) {
+	if(ctx->reservoir != NULL) {
+		if(ctx->sampled >= array_len(ctx->reservoir)) return false;
+		*id = ctx->reservoir[ctx->sampled];
+		return true;
+	}
+
+	if(ctx->sampled >= ctx->size) return false;
+
+	// a candidate exists, retry until a new one is found
+	while(true) {
+		*id = _RandomRange(ctx, ctx->n);
+		if(_Candidate(ctx, *id) && _Sample(ctx, *id)) return true;
+	}
+}
+
+static bool _NextBernoulli
+(
+	SampleCtx *ctx,
+	NodeID *id
+) {
+	// number of IDs skipped before the next sampled one is geometric
+	double log_q = log1p(-ctx->rate);
+	while(ctx->cursor < ctx->n) {
+		uint64_t skip = 0;
+		if(ctx->rate < 1) {
+			double s = floor(log1p(-_RandomUnit(ctx)) / log_q);
+			if(s >= ctx->n - ctx->cursor) {
+				ctx->cursor = ctx->n;
+				return false;
+			}
+			skip = s;
+		}
+
+		*id = ctx->cursor + skip;
+		ctx->cursor = *id + 1;
+		if(_Candidate(ctx, *id)) return true;
+	}
+	return false;
+}
+
+// moves to a random out neighbour of the current position
+// returns false if the current position has no candidate neighbours
+static bool _Walk
+(
+	SampleCtx *ctx
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	info = RG_MatrixTupleIter_iterate_row(ctx->it, ctx->position);
+	ASSERT(info == GrB_SUCCESS);
+
+	// pick a neighbour uniformly in a single pass
+	GrB_Index dest;
+	GrB_Index next = INVALID_ENTITY_ID;
+	uint64_t degree = 0;
+	bool depleted = false;
+	while(true) {
+		info = RG_MatrixTupleIter_next(ctx->it, NULL, &dest, NULL, &depleted);
+		ASSERT(info == GrB_SUCCESS);
+		if(depleted) break;
+		if(ctx->L != NULL && !_Candidate(ctx, dest)) continue;
+
+		degree++;
+		if(_RandomRange(ctx, degree) == 0) next = dest;
+	}
+
+	if(degree == 0) return false;
+	ctx->position = next;
+	return true;
+}
+
+static bool _NextRandomWalk
+(
+	SampleCtx *ctx,
+	NodeID *id
+) {
+	if(ctx->sampled >= ctx->size) return false;
+
+	uint stalls = 0;
+	while(stalls < WALK_MAX_STALLS) {
+		bool moved = false;
+		if(ctx->position != INVALID_ENTITY_ID &&
+		   _RandomUnit(ctx) >= ctx->restart) {
+			moved = _Walk(ctx);
+		}
+
+		// restart from a random node
+		if(!moved) {
+			if(!_ProbeCandidate(ctx, ctx->attempts, &ctx->position)) {
+				return false;
+			}
+		}
+
+		if(_Sample(ctx, ctx->position)) {
+			*id = ctx->position;
+			return true;
+		}
+		stalls++;
+	}
+
+	// walk keeps revisiting sampled nodes, the reachable nodes are exhausted
+	return false;
+}
+
+// reads a configuration value expected to be a string
+static bool _ReadString
+(
+	SIValue config,
+	const char *key,
+	const char **s
+) {
+	SIValue v;
+	if(!Map_Get(config, SI_ConstStringVal((char *)key), &v)) return true;
+	if(SI_TYPE(v) != T_STRING) {
+		ErrorCtx_SetError("%s must be a string", key);
+		return false;
+	}
+	*s = v.stringval;
+	return true;
+}
+
+// populates 'ctx' from the configuration map
+// returns false and sets an error on invalid configuration
+// sets 'missing' if a specified label or relationship type doesn't exist
+static bool _ReadConfig
+(
+	SampleCtx *ctx,
+	SIValue config,
+	bool *missing
+) {
+	SIValue v;
+	const char *label = NULL;
+	const char *method = NULL;
+	const char *relation = NULL;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	*missing = false;
+
+	if(SI_TYPE(config) != T_MAP) {
+		ErrorCtx_SetError("Expecting a configuration map");
+		return false;
+	}
+
+	if(!_ReadString(config, "label", &label))     return false;
+	if(!_ReadString(config, "method", &method))   return false;
+	if(!_ReadString(config, "relType", &relation)) return false;
+
+	ctx->method = SAMPLE_UNIFORM;
+	if(method != NULL) {
+		if(strcasecmp(method, "uniform") == 0) {
+			ctx->method = SAMPLE_UNIFORM;
+		} else if(strcasecmp(method, "bernoulli") == 0) {
+			ctx->method = SAMPLE_BERNOULLI;
+		} else if(strcasecmp(method, "randomWalk") == 0) {
+			ctx->method = SAMPLE_RANDOM_WALK;
+		} else {
+			ErrorCtx_SetError("Unknown sampling method '%s'", method);
+			return false;
+		}
+	}
+
+	if(ctx->method == SAMPLE_BERNOULLI) {
+		if(!MAP_GET(config, "rate", v) || !(SI_TYPE(v) & SI_NUMERIC) ||
+		   !(SI_GET_NUMERIC(v) > 0 && SI_GET_NUMERIC(v) <= 1)) {
+			ErrorCtx_SetError("rate must be a number in the range (0, 1]");
+			return false;
+		}
+		ctx->rate = SI_GET_NUMERIC(v);
+	} else {
+		if(!MAP_GET(config, "size", v) || SI_TYPE(v) != T_INT64 ||
+		   v.longval < 0) {
+			ErrorCtx_SetError("size must be a non-negative integer");
+			return false;
+		}
+		ctx->size = v.longval;
+	}
+
+	if(MAP_GET(config, "restartProbability", v)) {
+		if(!(SI_TYPE(v) & SI_NUMERIC) ||
+		   !(SI_GET_NUMERIC(v) >= 0 && SI_GET_NUMERIC(v) <= 1)) {
+			ErrorCtx_SetError("restartProbability must be a number in the range [0, 1]");
+			return false;
+		}
+		ctx->restart = SI_GET_NUMERIC(v);
+	}
+
+	if(MAP_GET(config, "seed", v)) {
+		if(SI_TYPE(v) != T_INT64) {
+			ErrorCtx_SetError("seed must be an integer");
+			return false;
+		}
+		ctx->state = v.longval;
+	}
+	// xorshift state must not be zero
+	if(ctx->state == 0) ctx->state = 0x9E3779B97F4A7C15ULL;
+
+	if(label != NULL) {
+		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+		if(s == NULL) *missing = true;
+		else {
+			ctx->label = s->id;
+			ctx->L = Graph_GetLabelMatrix(ctx->g, s->id);
+		}
+	}
+
+	if(ctx->method == SAMPLE_RANDOM_WALK) {
+		if(relation == NULL) {
+			ctx->R = Graph_GetAdjacencyMatrix(ctx->g, false);
+		} else {
+			Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+			if(s == NULL) *missing = true;
+			else ctx->R = Graph_GetRelationMatrix(ctx->g, s->id, false);
+		}
+	}
+
+	return true;
+}
+
+// decides between probing random IDs and scanning for a uniform sample
+static void _PlanUniform
+(
+	SampleCtx *ctx,
+	uint64_t population
+) {
+	// drawing k distinct out of p candidates takes ~p * ln(p / (p - k))
+	// draws, each costing n / p probes, scanning costs p
+	double p = population;
+	double k = ctx->size;
+	if(k >= p || ctx->n * log(p / (p - k)) > p) _FillReservoir(ctx);
+}
+
+static ProcedureResult Proc_SampleInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	if(array_len((SIValue *)args) != 1) return PROCEDURE_ERR;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	SampleCtx *sample = rm_calloc(1, sizeof(SampleCtx));
+	sample->g        = gc->g;
+	sample->n        = Graph_UncompactedNodeCount(gc->g);
+	sample->node     = GE_NEW_NODE();
+	sample->seen     = raxNew();
+	sample->label    = GRAPH_NO_LABEL;
+	sample->state    = (uint64_t)rand() << 32 | rand();
+	sample->output   = array_new(SIValue, 1);
+	sample->restart  = 0.15;
+	sample->position = INVALID_ENTITY_ID;
+	ctx->privateData = sample;
+
+	for(uint i = 0; i < array_len(yield); i++) {
+		if(strcasecmp("node", yield[i]) == 0) {
+			array_append(sample->output, SI_NullVal());
+			sample->yield_node = sample->output;
+		}
+	}
+
+	bool missing;
+	if(!_ReadConfig(sample, args[0], &missing)) return PROCEDURE_ERR;
+
+	// unknown label or relationship type, first step will return NULL
+	uint64_t population = 0;
+	if(!missing) {
+		population = (sample->L != NULL)
+			? Graph_LabeledNodeCount(gc->g, sample->label)
+			: Graph_NodeCount(gc->g);
+	}
+
+	if(population == 0) {
+		sample->size = 0;
+		sample->cursor = sample->n;
+		return PROCEDURE_OK;
+	}
+
+	// random jumps land on a candidate once every n / population probes
+	sample->attempts = 64 * (sample->n / population + 1);
+
+	if(sample->method == SAMPLE_UNIFORM) _PlanUniform(sample, population);
+
+	if(sample->method == SAMPLE_RANDOM_WALK) {
+		GrB_Info info = RG_MatrixTupleIter_new(&sample->it, sample->R);
+		ASSERT(info == GrB_SUCCESS);
+		UNUSED(info);
+	}
+
+	return PROCEDURE_OK;
+}
+
+static SIValue *Proc_SampleStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData != NULL);
+
+	SampleCtx *sample = ctx->privateData;
+
+	NodeID id;
+	bool found = false;
+	switch(sample->method) {
+		case SAMPLE_UNIFORM:
+			found = _NextUniform(sample, &id);
+			break;
+		case SAMPLE_BERNOULLI:
+			found = _NextBernoulli(sample, &id);
+			break;
+		case SAMPLE_RANDOM_WALK:
+			found = _NextRandomWalk(sample, &id);
+			break;
+		default:
+			ASSERT(false);
+	}
+
+	if(!found) return NULL;
+
+	sample->sampled++;
+	Graph_GetNode(sample->g, id, &sample->node);
+	if(sample->yield_node) *sample->yield_node = SI_Node(&sample->node);
+
+	return sample->output;
+}
+
+static ProcedureResult Proc_SampleFree
+(
+	ProcedureCtx *ctx
+) {
+	SampleCtx *sample = ctx->privateData;
+	if(sample == NULL) return PROCEDURE_OK;
+
+	if(sample->it)        RG_MatrixTupleIter_free(&sample->it);
+	if(sample->seen)      raxFree(sample->seen);
+	if(sample->output)    array_free(sample->output);
+	if(sample->reservoir) array_free(sample->reservoir);
+	rm_free(sample);
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_SampleNodesCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 1);
+	ProcedureOutput output_node = {.name = "node", .type = T_NODE};
+	array_append(outputs, output_node);
+
+	ProcedureCtx *ctx = ProcCtxNew("algo.sampleNodes",
+								   1,
+								   outputs,
+								   Proc_SampleStep,
+								   Proc_SampleInvoke,
+								   Proc_SampleFree,
+								   privateData,
+								   true);
+	return ctx;
+}
@@ -0,0 +1,330 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_sp_paths.h"
+#include "../RG.h"
+#include "../value.h"
+#include "../errors.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/map.h"
+#include "../datatypes/array.h"
+#include "../datatypes/path/sipath.h"
+#include "../graph/graphcontext.h"
+#include "../algorithms/weighted_paths.h"
+
+// weighted shortest paths, a path weight is the sum of its edges weight
+// both procedures accept a single configuration map:
+//
+// sourceNode   - node to traverse from, mandatory
+// targetNode   - node to reach, mandatory for algo.SPpaths
+// relTypes     - relationship types to traverse, default any
+// relDirection - 'outgoing' (default), 'incoming' or 'both'
+// weightProp   - edge weight attribute, edges without a non-negative
+//                numeric weight are not traversed, default 1 per edge
+// maxLen       - max number of edges per path, default unbounded
+// maxCost      - max path weight, default unbounded
+// pathCount    - number of lightest paths to report, algo.SPpaths only,
+//                default 1
+//
+// algo.SSpaths yields the lightest path to every reachable node
+// algo.SPpaths yields up to pathCount lightest loopless paths to targetNode
+//
+// MATCH (a:City {name: 'A'}), (b:City {name: 'B'})
+// CALL algo.SPpaths({sourceNode: a, targetNode: b, relTypes: ['ROAD'],
+//                    weightProp: 'cost', pathCount: 3})
+// YIELD path, pathWeight
+
+typedef struct {
+	Graph *g;               // graph traversed
+	WeightedPath *paths;    // computed paths
+	uint idx;               // next path to yield
+	SIValue *output;        // yield values
+	SIValue *yield_path;    // yield path
+	SIValue *yield_weight;  // yield path weight
+} SPPathsCtx;
+
+static void _process_yield
+(
+	SPPathsCtx *ctx,
+	const char **yield
+) {
+	int idx = 0;
+	for(uint i = 0; i < array_len(yield); i++) {
+		if(strcasecmp("path", yield[i]) == 0) {
+			ctx->yield_path = ctx->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("pathWeight", yield[i]) == 0) {
+			ctx->yield_weight = ctx->output + idx;
+			idx++;
+			continue;
+		}
+	}
+}
+
+// reads a non-negative numeric configuration value
+static bool _ReadBound
+(
+	SIValue config,
+	const char *key,
+	SIValue *v
+) {
+	if(!Map_Get(config, SI_ConstStringVal((char *)key), v)) return true;
+	if(!(SI_TYPE(*v) & SI_NUMERIC) || SI_GET_NUMERIC(*v) < 0) {
+		ErrorCtx_SetError("%s must be a non-negative number", key);
+		return false;
+	}
+	return true;
+}
+
+// populates 'wctx' from the configuration map
+// returns false and sets an error on invalid configuration
+// sets 'missing' if a specified relationship type doesn't exist
+static bool _ReadConfig
+(
+	SIValue config,
+	bool target,
+	WeightedPathCtx *wctx,
+	Node **src,
+	Node **dest,
+	uint *path_count,
+	bool *missing
+) {
+	SIValue v;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	*missing = false;
+	wctx->g          = gc->g;
+	wctx->relations  = NULL;
+	wctx->dir        = GRAPH_EDGE_DIR_OUTGOING;
+	wctx->weight     = ATTRIBUTE_NOTFOUND;
+	wctx->max_len    = UINT_MAX;
+	wctx->max_weight = INFINITY;
+
+	if(SI_TYPE(config) != T_MAP) {
+		ErrorCtx_SetError("Expecting a configuration map");
+		return false;
+	}
+
+	if(!MAP_GET(config, "sourceNode", v) || SI_TYPE(v) != T_NODE) {
+		ErrorCtx_SetError("sourceNode is missing or not a node");
+		return false;
+	}
+	*src = v.ptrval;
+
+	if(target) {
+		if(!MAP_GET(config, "targetNode", v) || SI_TYPE(v) != T_NODE) {
+			ErrorCtx_SetError("targetNode is missing or not a node");
+			return false;
+		}
+		*dest = v.ptrval;
+	}
+
+	if(MAP_GET(config, "relDirection", v)) {
+		if(SI_TYPE(v) != T_STRING) {
+			ErrorCtx_SetError("relDirection must be a string");
+			return false;
+		}
+		if(strcasecmp(v.stringval, "outgoing") == 0) {
+			wctx->dir = GRAPH_EDGE_DIR_OUTGOING;
+		} else if(strcasecmp(v.stringval, "incoming") == 0) {
+			wctx->dir = GRAPH_EDGE_DIR_INCOMING;
+		} else if(strcasecmp(v.stringval, "both") == 0) {
+			wctx->dir = GRAPH_EDGE_DIR_BOTH;
+		} else {
+			ErrorCtx_SetError("relDirection values must be 'incoming', 'outgoing' or 'both'");
+			return false;
+		}
+	}
+
+	if(MAP_GET(config, "weightProp", v)) {
+		if(SI_TYPE(v) != T_STRING) {
+			ErrorCtx_SetError("weightProp must be a string");
+			return false;
+		}
+		wctx->weight = GraphContext_GetAttributeID(gc, v.stringval);
+		// unknown attribute, no edge is traversable
+		if(wctx->weight == ATTRIBUTE_NOTFOUND) *missing = true;
+	}
+
+	if(!_ReadBound(config, "maxLen", &v)) return false;
+	if(SI_TYPE(v) & SI_NUMERIC) wctx->max_len = SI_GET_NUMERIC(v);
+
+	if(!_ReadBound(config, "maxCost", &v)) return false;
+	if(SI_TYPE(v) & SI_NUMERIC) wctx->max_weight = SI_GET_NUMERIC(v);
+
+	if(target) {
+		*path_count = 1;
+		if(MAP_GET(config, "pathCount", v)) {
+			if(SI_TYPE(v) != T_INT64 || v.longval < 0) {
+				ErrorCtx_SetError("pathCount must be a non-negative integer");
+				return false;
+			}
+			*path_count = v.longval;
+		}
+	}
+
+	if(MAP_GET(config, "relTypes", v)) {
+		if(SI_TYPE(v) != T_ARRAY) {
+			ErrorCtx_SetError("relTypes must be an array of strings");
+			return false;
+		}
+
+		uint count = SIArray_Length(v);
+		wctx->relations = array_new(int, count);
+		for(uint i = 0; i < count; i++) {
+			SIValue rel = SIArray_Get(v, i);
+			if(SI_TYPE(rel) != T_STRING) {
+				ErrorCtx_SetError("relTypes must be an array of strings");
+				return false;
+			}
+			Schema *s = GraphContext_GetSchema(gc, rel.stringval, SCHEMA_EDGE);
+			if(s != NULL) array_append(wctx->relations, s->id);
+		}
+
+		// none of the specified types exist
+		if(array_len(wctx->relations) == 0) *missing = true;
+	}
+
+	return true;
+}
+
+static ProcedureResult _Invoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield,
+	bool target
+) {
+	if(array_len((SIValue *)args) != 1) {
+		ErrorCtx_SetError("Expecting a single configuration map argument");
+		return PROCEDURE_ERR;
+	}
+
+	SPPathsCtx *pdata = ctx->privateData;
+	_process_yield(pdata, yield);
+
+	Node *src  = NULL;
+	Node *dest = NULL;
+	bool missing;
+	uint path_count = 0;
+	WeightedPathCtx wctx;
+
+	bool valid = _ReadConfig(args[0], target, &wctx, &src, &dest, &path_count,
+			&missing);
+
+	if(valid && !missing) {
+		pdata->paths = target ?
+			WeightedPaths_KShortest(&wctx, ENTITY_GET_ID(src),
+					ENTITY_GET_ID(dest), path_count) :
+			WeightedPaths_SingleSource(&wctx, ENTITY_GET_ID(src));
+	}
+
+	if(wctx.relations != NULL) array_free(wctx.relations);
+
+	return valid ? PROCEDURE_OK : PROCEDURE_ERR;
+}
+
+static ProcedureResult Proc_SSpathsInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	return _Invoke(ctx, args, yield, false);
+}
+
+static ProcedureResult Proc_SPpathsInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	return _Invoke(ctx, args, yield, true);
+}
+
+static SIValue *Proc_SPpathsStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData != NULL);
+
+	SPPathsCtx *pdata = ctx->privateData;
+	if(pdata->paths == NULL || pdata->idx >= array_len(pdata->paths)) {
+		return NULL;
+	}
+
+	WeightedPath *wp = pdata->paths + pdata->idx++;
+
+	if(pdata->yield_path) {
+		uint edge_count = array_len(wp->edges);
+		Path *p = Path_New(edge_count + 1);
+		for(uint i = 0; i <= edge_count; i++) {
+			Node n = GE_NEW_NODE();
+			Graph_GetNode(pdata->g, wp->nodes[i], &n);
+			Path_AppendNode(p, n);
+			if(i < edge_count) Path_AppendEdge(p, wp->edges[i]);
+		}
+		*pdata->yield_path = SIPath_New(p);
+		Path_Free(p);
+	}
+
+	if(pdata->yield_weight) *pdata->yield_weight = SI_DoubleVal(wp->weight);
+
+	return pdata->output;
+}
+
+static ProcedureResult Proc_SPpathsFree
+(
+	ProcedureCtx *ctx
+) {
+	SPPathsCtx *pdata = ctx->privateData;
+	if(pdata == NULL) return PROCEDURE_OK;
+
+	WeightedPaths_Free(pdata->paths);
+	array_free(pdata->output);
+	rm_free(pdata);
+
+	return PROCEDURE_OK;
+}
+
+static ProcedureCtx *_Ctx
+(
+	const char *name,
+	ProcInvoke invoke
+) {
+	SPPathsCtx *pdata = rm_calloc(1, sizeof(SPPathsCtx));
+	pdata->g      = QueryCtx_GetGraph();
+	pdata->output = array_new(SIValue, 2);
+
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 2);
+	ProcedureOutput output_path = {.name = "path", .type = T_PATH};
+	ProcedureOutput output_weight = {.name = "pathWeight", .type = T_DOUBLE};
+	array_append(outputs, output_path);
+	array_append(outputs, output_weight);
+
+	ProcedureCtx *ctx = ProcCtxNew(name,
+								   1,
+								   outputs,
+								   Proc_SPpathsStep,
+								   invoke,
+								   Proc_SPpathsFree,
+								   pdata,
+								   true);
+	return ctx;
+}
+
+ProcedureCtx *Proc_SSpathsCtx() {
+	return _Ctx("algo.SSpaths", Proc_SSpathsInvoke);
+}
+
+ProcedureCtx *Proc_SPpathsCtx() {
+	return _Ctx("algo.SPpaths", Proc_SPpathsInvoke);
+}
@@ -0,0 +1,107 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_triangle_count.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "proc_algo_utils.h"
+#include "../algorithms/algo_matrix.h"
+#include "../algorithms/triangle_count.h"
+
+// counts the triangles each node participates in
+// edge direction and self loops are ignored
+//
+// CALL algo.triangleCount(NULL, NULL)        YIELD node, triangles
+// CALL algo.triangleCount('User', 'FOLLOWS') YIELD node, triangles
+
+ProcedureResult Proc_TriangleCountInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	// expecting 2 arguments
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+
+	int label;
+	int relation;
+	bool missing;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(!AlgoArgs_ReadFilters(gc, args[0], args[1], &label, &relation,
+				&missing)) {
+		return PROCEDURE_ERR;
+	}
+
+	AlgoNodeValues *res = AlgoNodeValues_New(gc->g, ctx, "triangles", yield);
+	ctx->privateData = res;
+
+	// unknown label or relationship type, quickly return
+	if(missing) return PROCEDURE_OK;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index n;
+	GrB_Matrix A;
+	GrB_Index *mapping;
+	uint64_t *triangles;
+
+	info = AlgoMatrix_Build(&A, &mapping, &n, gc->g, label, relation,
+			ATTRIBUTE_NOTFOUND, true);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = TriangleCount(&triangles, A);
+	ASSERT(info == GrB_SUCCESS);
+	GrB_free(&A);
+
+	for(GrB_Index i = 0; i < n; i++) {
+		AlgoNodeValues_Add(res, AlgoNodeValues_NodeID(mapping, i),
+				SI_LongVal(triangles[i]));
+	}
+	if(triangles) rm_free(triangles);
+	if(mapping) rm_free(mapping);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_TriangleCountStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData);
+	return AlgoNodeValues_Step((AlgoNodeValues *)ctx->privateData);
+}
+
+ProcedureResult Proc_TriangleCountFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	AlgoNodeValues_Free((AlgoNodeValues *)ctx->privateData);
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_TriangleCountCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 2);
+	ProcedureOutput output_node = {.name = "node", .type = T_NODE};
+	ProcedureOutput output_triangles = {.name = "triangles", .type = T_INT64};
+	array_append(outputs, output_node);
+	array_append(outputs, output_triangles);
+
+	ProcedureCtx *ctx = ProcCtxNew("algo.triangleCount",
+								   2,
+								   outputs,
+								   Proc_TriangleCountStep,
+								   Proc_TriangleCountInvoke,
+								   Proc_TriangleCountFree,
+								   privateData,
+								   true);
+	ctx->orderable = "triangles";
+	return ctx;
+}
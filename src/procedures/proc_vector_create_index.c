@@ -0,0 +1,92 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_vector_create_index.h"
+#include "../value.h"
+#include "../errors.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../index/index.h"
+#include "../graph/graphcontext.h"
+
+// largest supported vector dimension
+#define VECTOR_MAX_DIMENSION 32768
+
+//------------------------------------------------------------------------------
+// vector createNodeIndex
+//------------------------------------------------------------------------------
+
+// CALL db.idx.vector.createNodeIndex(label, attribute, dimension)
+// CALL db.idx.vector.createNodeIndex('Movie', 'embedding', 128)
+// all attributes of a label's vector index share the same dimension
+ProcedureResult Proc_VectorCreateNodeIdxInvoke(ProcedureCtx *ctx,
+		const SIValue *args, const char **yield) {
+	if(array_len((SIValue *)args) != 3) {
+		ErrorCtx_SetError("Expecting label, attribute and dimension arguments");
+		return PROCEDURE_ERR;
+	}
+
+	if(!(SI_TYPE(args[0]) & SI_TYPE(args[1]) & T_STRING)) {
+		ErrorCtx_SetError("Label and attribute arguments must be strings");
+		return PROCEDURE_ERR;
+	}
+
+	if(SI_TYPE(args[2]) != T_INT64 || args[2].longval <= 0 ||
+	   args[2].longval > VECTOR_MAX_DIMENSION) {
+		ErrorCtx_SetError("Dimension must be an integer between 1 and %d",
+				VECTOR_MAX_DIMENSION);
+		return PROCEDURE_ERR;
+	}
+
+	Index *idx            = NULL;
+	GraphContext *gc      = QueryCtx_GetGraphCtx();
+	const char *label     = args[0].stringval;
+	const char *attribute = args[1].stringval;
+	uint32_t dimension    = args[2].longval;
+
+	Index *existing = GraphContext_GetIndex(gc, label, NULL, IDX_VECTOR,
+			SCHEMA_NODE);
+	if(existing != NULL && existing->dimension != dimension) {
+		ErrorCtx_SetError("Index already exists with dimension %u",
+				existing->dimension);
+		return PROCEDURE_ERR;
+	}
+
+	int res = GraphContext_AddIndex(&idx, gc, SCHEMA_NODE, label, attribute,
+			IDX_VECTOR);
+
+	// build index
+	if(res == INDEX_OK) {
+		if(existing == NULL) Index_SetDimension(idx, dimension);
+		Index_Construct(idx);
+	}
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_VectorCreateNodeIdxStep(ProcedureCtx *ctx) {
+	return NULL;
+}
+
+ProcedureResult Proc_VectorCreateNodeIdxFree(ProcedureCtx *ctx) {
+	// Clean up.
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_VectorCreateNodeIdxGen() {
+	void *privateData = NULL;
+	ProcedureOutput *output = array_new(ProcedureOutput, 0);
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.vector.createNodeIndex",
+								   3,
+								   output,
+								   Proc_VectorCreateNodeIdxStep,
+								   Proc_VectorCreateNodeIdxInvoke,
+								   Proc_VectorCreateNodeIdxFree,
+								   privateData,
+								   false);
+
+	return ctx;
+}
@@ -0,0 +1,192 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_vector_query.h"
+#include "RG.h"
+#include "../value.h"
+#include "../errors.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../index/index.h"
+#include "../util/rmalloc.h"
+#include "../graph/graphcontext.h"
+
+//------------------------------------------------------------------------------
+// vector queryNodes
+//------------------------------------------------------------------------------
+
+// CALL db.idx.vector.queryNodes(label, attribute, k, vector)
+// CALL db.idx.vector.queryNodes('Movie', 'embedding', 10, $vec)
+// YIELD node, score
+// yields the k nodes whose vectors are most similar to 'vector'
+// ordered by descending cosine similarity
+
+typedef struct {
+	Node n;
+	Graph *g;
+	SIValue *output;
+	EntityID *ids;           // nearest neighbours
+	float *scores;           // neighbours similarity
+	uint64_t count;          // number of neighbours
+	uint64_t i;              // next neighbour to yield
+	SIValue *yield_node;     // yield node
+	SIValue *yield_score;    // yield score
+} QueryVectorContext;
+
+static void _process_yield
+(
+	QueryVectorContext *ctx,
+	const char **yield
+) {
+	ctx->yield_node   =    NULL;
+	ctx->yield_score  =    NULL;
+
+	int idx = 0;
+	for(uint i = 0; i < array_len(yield); i++) {
+		if(strcasecmp("node", yield[i]) == 0) {
+			ctx->yield_node = ctx->output + idx;
+			idx++;
+			continue;
+		}
+
+		if(strcasecmp("score", yield[i]) == 0) {
+			ctx->yield_score = ctx->output + idx;
+			idx++;
+			continue;
+		}
+	}
+}
+
+ProcedureResult Proc_VectorQueryNodeInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	ctx->privateData = NULL;
+
+	if(array_len((SIValue *)args) != 4) return PROCEDURE_ERR;
+	if(!(SI_TYPE(args[0]) & SI_TYPE(args[1]) & T_STRING)) {
+		ErrorCtx_SetError("Label and attribute arguments must be strings");
+		return PROCEDURE_ERR;
+	}
+	if(SI_TYPE(args[2]) != T_INT64 || args[2].longval < 0) {
+		ErrorCtx_SetError("k must be a non-negative integer");
+		return PROCEDURE_ERR;
+	}
+
+	GraphContext *gc      = QueryCtx_GetGraphCtx();
+	const char *label     = args[0].stringval;
+	const char *attribute = args[1].stringval;
+
+	// unknown label, no results
+	Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+	if(s == NULL) return PROCEDURE_OK;
+
+	Attribute_ID attr_id = GraphContext_GetAttributeID(gc, attribute);
+	Index *idx = Schema_GetIndex(s, &attr_id, IDX_VECTOR);
+	if(idx == NULL) {
+		ErrorCtx_SetError("No vector index on :%s(%s)", label, attribute);
+		return PROCEDURE_ERR;
+	}
+
+	// the index must reflect the query's own modifications
+	QueryCtx_ApplyIndexChanges();
+
+	VectorIndex *vidx = Index_GetVectorIndex(idx, attr_id);
+	ASSERT(vidx != NULL);
+
+	float *query = rm_malloc(sizeof(float) * idx->dimension);
+	if(!VectorIndex_ReadVector(args[3], idx->dimension, query)) {
+		rm_free(query);
+		ErrorCtx_SetError("Query vector must be a non-zero array of %u numbers",
+				idx->dimension);
+		return PROCEDURE_ERR;
+	}
+
+	uint64_t k = args[2].longval;
+	uint64_t n = VectorIndex_Count(vidx);
+	if(k > n) k = n;
+
+	QueryVectorContext *pdata = rm_malloc(sizeof(QueryVectorContext));
+	ctx->privateData = pdata;
+
+	pdata->g       =  gc->g;
+	pdata->n       =  GE_NEW_NODE();
+	pdata->i       =  0;
+	pdata->ids     =  rm_malloc(sizeof(EntityID) * k);
+	pdata->scores  =  rm_malloc(sizeof(float) * k);
+	pdata->output  =  array_new(SIValue, 2);
+
+	_process_yield(pdata, yield);
+
+	pdata->count = VectorIndex_Query(vidx, query, k, pdata->ids,
+			pdata->scores);
+	rm_free(query);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_VectorQueryNodeStep
+(
+	ProcedureCtx *ctx
+) {
+	QueryVectorContext *pdata = (QueryVectorContext *)ctx->privateData;
+	if(pdata == NULL) return NULL;  // unknown label
+
+	// depleted
+	if(pdata->i >= pdata->count) return NULL;
+
+	uint64_t i = pdata->i++;
+
+	// get node, only if yielded
+	if(pdata->yield_node) {
+		Node *n = &pdata->n;
+		Graph_GetNode(pdata->g, pdata->ids[i], n);
+		*pdata->yield_node = SI_Node(n);
+	}
+
+	if(pdata->yield_score) {
+		*pdata->yield_score = SI_DoubleVal(pdata->scores[i]);
+	}
+
+	return pdata->output;
+}
+
+ProcedureResult Proc_VectorQueryNodeFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	if(!ctx->privateData) return PROCEDURE_OK;
+
+	QueryVectorContext *pdata = ctx->privateData;
+	array_free(pdata->output);
+	rm_free(pdata->ids);
+	rm_free(pdata->scores);
+	rm_free(pdata);
+
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_VectorQueryNodeGen() {
+	void *privateData = NULL;
+	ProcedureOutput *output   = array_new(ProcedureOutput, 2);
+	ProcedureOutput out_node  = {.name = "node", .type = T_NODE};
+	ProcedureOutput out_score = {.name = "score", .type = T_DOUBLE};
+	array_append(output, out_node);
+	array_append(output, out_score);
+
+	ProcedureCtx *ctx = ProcCtxNew("db.idx.vector.queryNodes",
+								   4,
+								   output,
+								   Proc_VectorQueryNodeStep,
+								   Proc_VectorQueryNodeInvoke,
+								   Proc_VectorQueryNodeFree,
+								   privateData,
+								   true);
+	return ctx;
+}
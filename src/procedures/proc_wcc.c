@@ -0,0 +1,109 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "proc_wcc.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "proc_algo_utils.h"
+#include "../algorithms/fastsv.h"
+#include "../algorithms/algo_matrix.h"
+
+// weakly connected components, edge direction is ignored
+// each node is yielded along with its component ID,
+// the smallest node ID within its component
+//
+// CALL algo.WCC(NULL, NULL)        YIELD node, componentId
+// CALL algo.WCC('User', 'FOLLOWS') YIELD node, componentId
+
+ProcedureResult Proc_WCCInvoke
+(
+	ProcedureCtx *ctx,
+	const SIValue *args,
+	const char **yield
+) {
+	// expecting 2 arguments
+	if(array_len((SIValue *)args) != 2) return PROCEDURE_ERR;
+
+	int label;
+	int relation;
+	bool missing;
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	if(!AlgoArgs_ReadFilters(gc, args[0], args[1], &label, &relation,
+				&missing)) {
+		return PROCEDURE_ERR;
+	}
+
+	AlgoNodeValues *res = AlgoNodeValues_New(gc->g, ctx, "componentId", yield);
+	ctx->privateData = res;
+
+	// unknown label or relationship type, quickly return
+	if(missing) return PROCEDURE_OK;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index n;
+	GrB_Matrix A;
+	GrB_Index *mapping;
+	GrB_Index *components;
+
+	info = AlgoMatrix_Build(&A, &mapping, &n, gc->g, label, relation,
+			ATTRIBUTE_NOTFOUND, true);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = FastSV(&components, A);
+	ASSERT(info == GrB_SUCCESS);
+	GrB_free(&A);
+
+	for(GrB_Index i = 0; i < n; i++) {
+		NodeID component = AlgoNodeValues_NodeID(mapping, components[i]);
+		AlgoNodeValues_Add(res, AlgoNodeValues_NodeID(mapping, i),
+				SI_LongVal(component));
+	}
+	if(components) rm_free(components);
+	if(mapping) rm_free(mapping);
+
+	return PROCEDURE_OK;
+}
+
+SIValue *Proc_WCCStep
+(
+	ProcedureCtx *ctx
+) {
+	ASSERT(ctx->privateData);
+	return AlgoNodeValues_Step((AlgoNodeValues *)ctx->privateData);
+}
+
+ProcedureResult Proc_WCCFree
+(
+	ProcedureCtx *ctx
+) {
+	// clean up
+	AlgoNodeValues_Free((AlgoNodeValues *)ctx->privateData);
+	return PROCEDURE_OK;
+}
+
+ProcedureCtx *Proc_WCCCtx() {
+	void *privateData = NULL;
+	ProcedureOutput *outputs = array_new(ProcedureOutput, 2);
+	ProcedureOutput output_node = {.name = "node", .type = T_NODE};
+	ProcedureOutput output_component = {.name = "componentId", .type = T_INT64};
+	array_append(outputs, output_node);
+	array_append(outputs, output_component);
+
+	ProcedureCtx *ctx = ProcCtxNew("algo.WCC",
+								   2,
+								   outputs,
+								   Proc_WCCStep,
+								   Proc_WCCInvoke,
+								   Proc_WCCFree,
+								   privateData,
+								   true);
+	ctx->orderable = "componentId";
+	return ctx;
+}
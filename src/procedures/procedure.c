@@ -32,14 +32,31 @@ void Proc_Register() {
 	_procRegister("dbms.procedures", Proc_ProceduresCtx);
 	_procRegister("db.relationshipTypes", Proc_RelationsCtx);
 
+	// Register execution plan cache procedures.
+	_procRegister("db.cache.stats", Proc_CacheStatsCtx);
+	_procRegister("db.cache.autoParameterize", Proc_CacheAutoParameterizeCtx);
+
 	// Register graph algorithms.
 	_procRegister("algo.BFS", Proc_BFS_Ctx);
 	_procRegister("algo.pageRank", Proc_PagerankCtx);
+	_procRegister("algo.weightedPageRank", Proc_WeightedPagerankCtx);
+	_procRegister("algo.personalizedPageRank", Proc_PersonalizedPagerankCtx);
+	_procRegister("algo.WCC", Proc_WCCCtx);
+	_procRegister("algo.triangleCount", Proc_TriangleCountCtx);
+	_procRegister("algo.labelPropagation", Proc_LabelPropagationCtx);
+	_procRegister("algo.SSpaths", Proc_SSpathsCtx);
+	_procRegister("algo.SPpaths", Proc_SPpathsCtx);
+	_procRegister("algo.sampleNodes", Proc_SampleNodesCtx);
 
 	// Register FullText Search generator.
 	_procRegister("db.idx.fulltext.drop", Proc_FulltextDropIdxGen);
 	_procRegister("db.idx.fulltext.queryNodes", Proc_FulltextQueryNodeGen);
 	_procRegister("db.idx.fulltext.createNodeIndex", Proc_FulltextCreateNodeIdxGen);
+
+	// Register vector similarity search generator.
+	_procRegister("db.idx.vector.drop", Proc_VectorDropIdxGen);
+	_procRegister("db.idx.vector.queryNodes", Proc_VectorQueryNodeGen);
+	_procRegister("db.idx.vector.createNodeIndex", Proc_VectorCreateNodeIdxGen);
 }
 
 ProcedureCtx *ProcCtxNew(const char *name,
@@ -60,6 +77,8 @@ ProcedureCtx *ProcCtxNew(const char *name,
 	ctx->Invoke = fInvoke;
 	ctx->privateData = privateData;
 	ctx->readOnly = readOnly;
+	ctx->orderable = NULL;
+	ctx->hint.output = NULL;
 	return ctx;
 }
 
@@ -140,6 +159,18 @@ const char *Procedure_GetName(const ProcedureCtx *proc) {
 	return proc->name;
 }
 
+const char *Procedure_OrderableOutput(const ProcedureCtx *proc) {
+	ASSERT(proc != NULL);
+	return proc->orderable;
+}
+
+void Procedure_SetOrderHint(ProcedureCtx *proc, ProcedureOrderHint hint) {
+	ASSERT(proc != NULL);
+	ASSERT(proc->state == PROCEDURE_NOT_INIT);
+	ASSERT(hint.output == NULL || Procedure_OrderableOutput(proc) != NULL);
+	proc->hint = hint;
+}
+
 bool Procedure_IsReadOnly(const ProcedureCtx *proc) {
 	ASSERT(proc != NULL);
 	return proc->readOnly;
@@ -41,6 +41,14 @@ const char *Procedure_GetOutput(const ProcedureCtx *proc, uint output_idx);
 /* Returns true if given output can be yield by procedure */
 bool Procedure_ContainsOutput(const ProcedureCtx *proc, const char *output);
 
+// Returns the output the procedure can order its records by, NULL if none.
+// Such a procedure accepts an order hint limiting its records
+// to those its consumer retains.
+const char *Procedure_OrderableOutput(const ProcedureCtx *proc);
+
+// Sets the procedure's order hint, must be called prior to invocation.
+void Procedure_SetOrderHint(ProcedureCtx *proc, ProcedureOrderHint hint);
+
 // Free procedure context.
 void Proc_Free(ProcedureCtx *proc);
 
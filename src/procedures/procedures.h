@@ -7,13 +7,22 @@
 #pragma once
 
 #include "proc_bfs.h"
+#include "proc_wcc.h"
+#include "proc_sample.h"
+#include "proc_sp_paths.h"
+#include "proc_cache.h"
 #include "proc_labels.h"
 #include "proc_pagerank.h"
 #include "proc_relations.h"
+#include "proc_triangle_count.h"
+#include "proc_label_propagation.h"
 #include "proc_procedures.h"
 #include "proc_list_indexes.h"
 #include "proc_property_keys.h"
 #include "proc_fulltext_query.h"
 #include "proc_fulltext_drop_index.h"
 #include "proc_fulltext_create_index.h"
+#include "proc_vector_query.h"
+#include "proc_vector_drop_index.h"
+#include "proc_vector_create_index.h"
 
@@ -7,15 +7,35 @@
 #include "query_ctx.h"
 #include "RG.h"
 #include "errors.h"
+#include "query_registry.h"
 #include "util/simple_timer.h"
+#include "configuration/config.h"
+#include "effects/change_stream.h"
+#include "util/compressed_string.h"
+#include "datatypes/temporal_value.h"
 #include "arithmetic/arithmetic_expression.h"
 #include "serializers/graphcontext_type.h"
+#include <time.h>
 
 // GraphContext type as it is registered at Redis.
 extern RedisModuleType *GraphContextRedisModuleType;
 
 pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
 
+// commit context shared by a group of write queries
+typedef struct {
+	GraphContext *gc;           // graph written to, NULL if no group is active
+	RedisModuleCtx *redis_ctx;  // context locking the GIL for the group's commits
+	RedisModuleKey *key;        // graph key opened for write by the current commit
+	bool locked;                // commit locks held by the current commit
+} GroupCommit;
+
+static __thread GroupCommit _group_commit = {0};
+
+// time spent by all queries in each stage, in microseconds
+static uint64_t _stage_totals[QUERY_STAGE_COUNT] = {0};
+static uint64_t _stage_queries = 0;
+
 // retrieve or instantiate new QueryCtx
 static inline QueryCtx *_QueryCtx_GetCreateCtx(void) {
 	QueryCtx *ctx = pthread_getspecific(_tlsQueryCtxKey);
@@ -38,6 +58,19 @@ static void _ParameterFreeCallback(void *param_val) {
 	AR_EXP_Free(param_val);
 }
 
+// list and map parameters are made shared
+// such that records reference rather than copy them
+static void _ShareParams(rax *params) {
+	raxIterator it;
+	raxStart(&it, params);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		AR_ExpNode *exp = it.data;
+		if(AR_EXP_IsConstant(exp)) SIValue_MakeShared(&exp->operand.constant);
+	}
+	raxStop(&it);
+}
+
 bool QueryCtx_Init(void) {
 	return (pthread_key_create(&_tlsQueryCtxKey, NULL) == 0);
 }
@@ -57,12 +90,15 @@ inline void QueryCtx_RemoveFromTLS() {
 void QueryCtx_BeginTimer(void) {
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx(); // Attempt to retrieve the QueryCtx.
 	simple_tic(ctx->internal_exec_ctx.timer); // Start the execution timer.
+	ctx->internal_exec_ctx.timestamp = TemporalValue_NewTimestamp();
 }
 
 void QueryCtx_SetGlobalExecutionCtx(CommandCtx *cmd_ctx) {
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
 	ctx->gc = CommandCtx_GetGraphContext(cmd_ctx);
 	ctx->query_data.query = CommandCtx_GetQuery(cmd_ctx);
+	ctx->query_data.binary_params = cmd_ctx->binary_params;
+	ctx->query_data.binary_params_len = cmd_ctx->binary_params_len;
 	ctx->global_exec_ctx.bc = CommandCtx_GetBlockingClient(cmd_ctx);
 	ctx->global_exec_ctx.redis_ctx = CommandCtx_GetRedisCtx(cmd_ctx);
 	ctx->global_exec_ctx.command_name = CommandCtx_GetCommandName(cmd_ctx);
@@ -85,8 +121,26 @@ void QueryCtx_SetResultSet(ResultSet *result_set) {
 
 void QueryCtx_SetParams(rax *params) {
 	ASSERT(params != NULL);
+	_ShareParams(params);
+
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
-	ctx->query_data.params = params;
+	rax *current = ctx->query_data.params;
+	if(current == NULL) {
+		ctx->query_data.params = params;
+		return;
+	}
+
+	// binary parameters are set ahead of parsing the query's CYPHER header
+	raxIterator it;
+	raxStart(&it, params);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		void *prev = NULL;
+		raxInsert(current, it.key, it.key_len, it.data, &prev);
+		if(prev != NULL) _ParameterFreeCallback(prev);
+	}
+	raxStop(&it);
+	raxFree(params);
 }
 
 void QueryCtx_SetLastWriter(OpBase *last_writer) {
@@ -106,6 +160,15 @@ rax *QueryCtx_GetParams(void) {
 	return ctx->query_data.params;
 }
 
+int64_t QueryCtx_GetTimestamp(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	// outside of a timed query, e.g. a thread without a query context
+	if(ctx == NULL || ctx->internal_exec_ctx.timestamp == 0) {
+		return TemporalValue_NewTimestamp();
+	}
+	return ctx->internal_exec_ctx.timestamp;
+}
+
 GraphContext *QueryCtx_GetGraphCtx(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	ASSERT(ctx && ctx->gc);
@@ -136,73 +199,255 @@ ResultSetStatistics *QueryCtx_GetResultSetStatistics(void) {
 	return stats;
 }
 
-void QueryCtx_PrintQuery(void) {
+IndexChanges *QueryCtx_GetIndexChanges(void) {
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
-	printf("%s\n", ctx->query_data.query);
+	if(ctx->internal_exec_ctx.index_changes == NULL) {
+		ctx->internal_exec_ctx.index_changes = IndexChanges_New();
+	}
+	return ctx->internal_exec_ctx.index_changes;
 }
 
-static void _QueryCtx_ThreadSafeContextLock(QueryCtx *ctx) {
-	if(ctx->global_exec_ctx.bc) RedisModule_ThreadSafeContextLock(ctx->global_exec_ctx.redis_ctx);
+EffectsBuffer *QueryCtx_GetEffectsBuffer(void) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	if(ctx->internal_exec_ctx.effects == NULL) {
+		ctx->internal_exec_ctx.effects = EffectsBuffer_New();
+	}
+	return ctx->internal_exec_ctx.effects;
+}
+
+void QueryCtx_SetNonDeterministic(void) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	ctx->internal_exec_ctx.non_deterministic = true;
+}
+
+void QueryCtx_ApplyIndexChanges(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!ctx || !ctx->internal_exec_ctx.index_changes) return;
+
+	IndexChanges_Apply(ctx->internal_exec_ctx.index_changes, ctx->gc->g);
+}
+
+const char *QueryCtx_GetQuery(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return (ctx != NULL) ? ctx->query_data.query : NULL;
+}
+
+void QueryCtx_PrintQuery(void) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	printf("%s\n", ctx->query_data.query);
 }
 
 static void _QueryCtx_ThreadSafeContextUnlock(QueryCtx *ctx) {
 	if(ctx->global_exec_ctx.bc) RedisModule_ThreadSafeContextUnlock(ctx->global_exec_ctx.redis_ctx);
 }
 
-bool QueryCtx_LockForCommit(void) {
-	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
-	if(ctx->internal_exec_ctx.locked_for_commit) return true;
-	// Lock GIL.
-	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
-	GraphContext *gc = ctx->gc;
+// number of times commit locks are acquired without holding the GIL
+// while waiting for readers, before falling back to GIL -> graph lock order
+#define COMMIT_LOCK_ATTEMPTS 4
+
+// acquire both the GIL and the graph's write lock
+// waiting for the graph's readers to drain while holding the GIL would stall
+// Redis for as long as the longest running reader
+// instead, each lock is awaited while holding no lock, and the other lock
+// is only tried, backing off if it is unavailable
+// Redis main thread acquires graph locks while holding the GIL,
+// so blocking on the GIL while holding the graph lock could deadlock
+//
+// under steady load either try may keep failing, after COMMIT_LOCK_ATTEMPTS
+// the GIL is awaited first and the graph lock blocked on while holding it
+// the graph lock prefers writers, new readers wait behind the writer
+// such that only readers already holding the lock are waited for
+static void _QueryCtx_AcquireCommitLocks(RedisModuleCtx *redis_ctx, Graph *g) {
+	// fallback to GIL -> graph lock order if try-lock isn't supported
+	if(RedisModule_ThreadSafeContextTryLock != NULL) {
+		for(int i = 0; i < COMMIT_LOCK_ATTEMPTS; i++) {
+			Graph_AcquireWriteLock(g);
+			if(RedisModule_ThreadSafeContextTryLock(redis_ctx) == REDISMODULE_OK) {
+				return;
+			}
+			Graph_ReleaseLock(g);
+
+			RedisModule_ThreadSafeContextLock(redis_ctx);
+			if(Graph_TryAcquireWriteLock(g)) return;
+			RedisModule_ThreadSafeContextUnlock(redis_ctx);
+		}
+	}
+
+	RedisModule_ThreadSafeContextLock(redis_ctx);
+	Graph_AcquireWriteLock(g);
+}
+
+// open graph key for write and verify it still holds 'gc'
+// returns NULL and sets an error otherwise
+static RedisModuleKey *_QueryCtx_OpenGraphKey(RedisModuleCtx *redis_ctx,
+		GraphContext *gc) {
 	RedisModuleString *graphID = RedisModule_CreateString(redis_ctx, gc->graph_name,
 														  strlen(gc->graph_name));
-	_QueryCtx_ThreadSafeContextLock(ctx);
-	// Open key and verify.
 	RedisModuleKey *key = RedisModule_OpenKey(redis_ctx, graphID, REDISMODULE_WRITE);
 	RedisModule_FreeString(redis_ctx, graphID);
 	if(RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY) {
-		ErrorCtx_SetError("Encountered an empty key when opened key %s", ctx->gc->graph_name);
+		ErrorCtx_SetError("Encountered an empty key when opened key %s", gc->graph_name);
 		goto clean_up;
 	}
 	if(RedisModule_ModuleTypeGetType(key) != GraphContextRedisModuleType) {
-		ErrorCtx_SetError("Encountered a non-graph value type when opened key %s", ctx->gc->graph_name);
+		ErrorCtx_SetError("Encountered a non-graph value type when opened key %s", gc->graph_name);
 		goto clean_up;
-
 	}
 	if(gc != RedisModule_ModuleTypeGetValue(key)) {
-		ErrorCtx_SetError("Encountered different graph value when opened key %s", ctx->gc->graph_name);
+		ErrorCtx_SetError("Encountered different graph value when opened key %s", gc->graph_name);
 		goto clean_up;
 	}
+	return key;
+
+clean_up:
+	RedisModule_CloseKey(key);
+	return NULL;
+}
+
+// acquire commit locks on behalf of the active group commit
+// locks are held for the duration of the query's commit only
+static bool _QueryCtx_LockGroupCommit(QueryCtx *ctx) {
+	GroupCommit *group = &_group_commit;
+	ASSERT(!group->locked);
+
+	// the group's commits share a thread safe context
+	if(group->redis_ctx == NULL) {
+		group->redis_ctx = RedisModule_GetThreadSafeContext(NULL);
+	}
+
+	double tic[2];
+	simple_tic(tic);
+	_QueryCtx_AcquireCommitLocks(group->redis_ctx, group->gc->g);
+	QueryCtx_AddStageTime(QUERY_STAGE_LOCK, simple_toc(tic) * 1000);
+
+	group->key = _QueryCtx_OpenGraphKey(group->redis_ctx, group->gc);
+	if(group->key == NULL) {
+		Graph_ReleaseLock(group->gc->g);
+		RedisModule_ThreadSafeContextUnlock(group->redis_ctx);
+		// If there is a break point for runtime exception, raise it, otherwise return false.
+		ErrorCtx_RaiseRuntimeException(NULL);
+		return false;
+	}
+	group->locked = true;
+
+	ctx->internal_exec_ctx.key = group->key;
+	ctx->internal_exec_ctx.locked_for_commit = true;
+
+	// see QueryCtx_LockForCommit
+	Graph_ReleaseDeletedBlocks(group->gc->g);
+
+	return true;
+}
+
+bool QueryCtx_LockForCommit(void) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	if(ctx->internal_exec_ctx.locked_for_commit) return true;
+	if(_group_commit.gc != NULL && _group_commit.gc == ctx->gc) {
+		return _QueryCtx_LockGroupCommit(ctx);
+	}
+	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
+	GraphContext *gc = ctx->gc;
+	// Lock GIL and acquire graph write lock.
+	double tic[2];
+	simple_tic(tic);
+	if(ctx->global_exec_ctx.bc) {
+		_QueryCtx_AcquireCommitLocks(redis_ctx, gc->g);
+	} else {
+		// running on Redis main thread, GIL is held
+		Graph_AcquireWriteLock(gc->g);
+	}
+	QueryCtx_AddStageTime(QUERY_STAGE_LOCK, simple_toc(tic) * 1000);
+	// Open key and verify.
+	RedisModuleKey *key = _QueryCtx_OpenGraphKey(redis_ctx, gc);
+	if(key == NULL) goto clean_up;
 	ctx->internal_exec_ctx.key = key;
-	// Acquire graph write lock.
-	Graph_AcquireWriteLock(gc->g);
 	ctx->internal_exec_ctx.locked_for_commit = true;
 
+	// release storage left holding deleted entities only
+	// writers are serialized, entities deleted by previous queries
+	// are no longer referenced once the write lock is acquired
+	Graph_ReleaseDeletedBlocks(gc->g);
+
 	return true;
 
 clean_up:
-	// Free key handle.
-	RedisModule_CloseKey(key);
+	// Release graph write lock.
+	Graph_ReleaseLock(gc->g);
 	// Unlock GIL.
 	_QueryCtx_ThreadSafeContextUnlock(ctx);
 	// If there is a break point for runtime exception, raise it, otherwise return false.
 	ErrorCtx_RaiseRuntimeException(NULL);
 	return false;
+}
 
+// replicate the query's modifications, either as effects or as the query itself
+// effects spare replicas from re-executing expensive or non-deterministic
+// queries, cheap queries are usually shorter than their effects
+static void _QueryCtx_Replicate(QueryCtx *ctx, RedisModuleCtx *redis_ctx) {
+	GraphContext *gc = ctx->gc;
+	EffectsBuffer *effects = ctx->internal_exec_ctx.effects;
+
+	bool use_effects = (effects != NULL && EffectsBuffer_Valid(effects) &&
+						!EffectsBuffer_Empty(effects));
+	if(use_effects && !ctx->internal_exec_ctx.non_deterministic) {
+		uint64_t threshold;
+		Config_Option_get(Config_EFFECTS_THRESHOLD, &threshold);
+		use_effects = (QueryCtx_GetExecutionTime() * 1000 >= threshold);
+	}
+
+	if(use_effects) {
+		RedisModule_Replicate(redis_ctx, "GRAPH.EFFECT", "cb!", gc->graph_name,
+							  EffectsBuffer_Buffer(effects),
+							  EffectsBuffer_Length(effects));
+	} else if(ctx->query_data.binary_params != NULL) {
+		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name,
+							  "cccb!", gc->graph_name, ctx->query_data.query,
+							  "params", ctx->query_data.binary_params,
+							  ctx->query_data.binary_params_len);
+	} else {
+		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name,
+							  "cc!", gc->graph_name, ctx->query_data.query);
+	}
+
+	if(effects != NULL) EffectsBuffer_Reset(effects);
 }
 
 static void _QueryCtx_UnlockCommit(QueryCtx *ctx) {
 	GraphContext *gc = ctx->gc;
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 
-	if(ResultSetStat_IndicateModification(ctx->internal_exec_ctx.result_set->stats)) {
+	// index modifications are applied while the graph is still locked
+	QueryCtx_ApplyIndexChanges();
+
+	// locks are held through the group commit's context
+	bool grouped = (_group_commit.locked && _group_commit.gc == gc);
+	if(grouped) redis_ctx = _group_commit.redis_ctx;
+
+	ResultSetStatistics *stats = &ctx->internal_exec_ctx.result_set->stats;
+	if(ResultSetStat_IndicateModification(*stats)) {
+		// replicas advance their sequence as they apply the replicated command
+		stats->commit_seq = GraphContext_AdvanceCommitSeq(gc);
+		// publish before replication resets the query's effects
+		ChangeStream_Publish(redis_ctx, gc, stats,
+				ctx->internal_exec_ctx.effects, ctx->query_data.query);
 		// Replicate only in case of changes.
-		RedisModule_Replicate(redis_ctx, ctx->global_exec_ctx.command_name, "cc!", gc->graph_name,
-							  ctx->query_data.query);
+		_QueryCtx_Replicate(ctx, redis_ctx);
 	}
 
 	ctx->internal_exec_ctx.locked_for_commit = false;
+	if(grouped) {
+		// release the commit's locks, letting Redis and readers in
+		// before the group's next query executes
+		GroupCommit *group = &_group_commit;
+		Graph_ReleaseLock(gc->g);
+		RedisModule_CloseKey(group->key);
+		RedisModule_ThreadSafeContextUnlock(group->redis_ctx);
+		group->key = NULL;
+		group->locked = false;
+		ctx->internal_exec_ctx.key = NULL;
+		return;
+	}
+
 	// Release graph R/W lock.
 	Graph_ReleaseLock(gc->g);
 
@@ -241,21 +486,178 @@ void QueryCtx_ForceUnlockCommit() {
 	_QueryCtx_UnlockCommit(ctx);
 }
 
+void QueryCtx_BeginGroupCommit(GraphContext *gc) {
+	ASSERT(gc != NULL);
+	ASSERT(_group_commit.gc == NULL);
+
+	_group_commit.gc = gc;
+	_group_commit.locked = false;
+}
+
+void QueryCtx_EndGroupCommit(void) {
+	GroupCommit *group = &_group_commit;
+	ASSERT(group->gc != NULL);
+
+	// each commit releases its own locks
+	ASSERT(!group->locked);
+
+	if(group->redis_ctx != NULL) {
+		RedisModule_FreeThreadSafeContext(group->redis_ctx);
+	}
+
+	group->gc = NULL;
+	group->redis_ctx = NULL;
+	group->key = NULL;
+	group->locked = false;
+}
+
 double QueryCtx_GetExecutionTime(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	ASSERT(ctx != NULL);
 	return simple_toc(ctx->internal_exec_ctx.timer) * 1000;
 }
 
+void QueryCtx_AddStageTime(QueryStage stage, double ms) {
+	ASSERT(stage < QUERY_STAGE_COUNT);
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	if(ms > 0) ctx->internal_exec_ctx.stage_time[stage] += ms;
+}
+
+double QueryCtx_GetStageTime(QueryStage stage) {
+	ASSERT(stage < QUERY_STAGE_COUNT);
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	return ctx->internal_exec_ctx.stage_time[stage];
+}
+
+void QueryCtx_RecordStageTimes(void) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	for(int i = 0; i < QUERY_STAGE_COUNT; i++) {
+		uint64_t us = ctx->internal_exec_ctx.stage_time[i] * 1000;
+		__atomic_fetch_add(_stage_totals + i, us, __ATOMIC_RELAXED);
+	}
+	__atomic_fetch_add(&_stage_queries, 1, __ATOMIC_RELAXED);
+}
+
+void QueryCtx_GetStageTotals(uint64_t totals[QUERY_STAGE_COUNT], uint64_t *queries) {
+	ASSERT(totals != NULL);
+	ASSERT(queries != NULL);
+	for(int i = 0; i < QUERY_STAGE_COUNT; i++) {
+		totals[i] = __atomic_load_n(_stage_totals + i, __ATOMIC_RELAXED);
+	}
+	*queries = __atomic_load_n(&_stage_queries, __ATOMIC_RELAXED);
+}
+
+void QueryCtx_Trace(QueryTraceEvent event) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	QueryTrace_Record(&ctx->internal_exec_ctx.trace, event, QueryTrace_Now());
+}
+
+QueryTrace *QueryCtx_GetTrace(void) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	return &ctx->internal_exec_ctx.trace;
+}
+
+void QueryCtx_Cancel(QueryCtx *ctx, QueryCancelReason reason) {
+	ASSERT(ctx != NULL);
+	ASSERT(reason != QUERY_CANCEL_NONE);
+
+	// the first reason set sticks
+	int expected = QUERY_CANCEL_NONE;
+	__atomic_compare_exchange_n(&ctx->internal_exec_ctx.cancel_reason,
+			&expected, reason, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+QueryCancelReason QueryCtx_CancelReason(const QueryCtx *ctx) {
+	ASSERT(ctx != NULL);
+	return __atomic_load_n(&ctx->internal_exec_ctx.cancel_reason,
+			__ATOMIC_RELAXED);
+}
+
+// coarse monotonic clock in milliseconds
+// cheap enough to be read at every cancellation checkpoint
+static inline uint64_t _QueryCtx_NowMs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void QueryCtx_SetDeadline(uint timeout) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	ASSERT(timeout > 0);
+	ctx->internal_exec_ctx.deadline = _QueryCtx_NowMs() + timeout;
+}
+
+bool QueryCtx_Cancelled(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	return ctx != NULL && QueryCtx_CancelReason(ctx) != QUERY_CANCEL_NONE;
+}
+
+void QueryCtx_CheckCancelled(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(ctx == NULL) return;
+
+	// a query past its deadline cancels itself
+	uint64_t deadline = ctx->internal_exec_ctx.deadline;
+	if(deadline != 0 && _QueryCtx_NowMs() >= deadline) {
+		QueryCtx_Cancel(ctx, QUERY_CANCEL_TIMEOUT);
+	}
+
+	QueryCancelReason reason = QueryCtx_CancelReason(ctx);
+	bool exceeded = rm_mem_capacity_exceeded();
+	if(reason == QUERY_CANCEL_NONE && !exceeded) return;
+
+	// interrupting a commit would leave the graph inconsistent
+	if(ctx->internal_exec_ctx.locked_for_commit) return;
+
+	// the query exceeded its memory capacity, the error is already set
+	// GraphBLAS kernels can't be interrupted, the breach is acted upon here
+	if(exceeded) {
+		ErrorCtx_RaiseRuntimeException(NULL);
+		return;
+	}
+
+	// If there is a break point for runtime exception, raise it, otherwise return.
+	if(reason == QUERY_CANCEL_TIMEOUT) {
+		ErrorCtx_RaiseRuntimeException("Query timed out");
+	} else {
+		ErrorCtx_RaiseRuntimeException("Query was killed");
+	}
+}
+
+void QueryCtx_Register(const char *graph, const char *command, const char *query) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	ASSERT(ctx->internal_exec_ctx.query_id == 0);
+	ctx->internal_exec_ctx.query_id = QueryRegistry_Add(ctx, graph, command,
+			query);
+}
+
 void QueryCtx_Free(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
 	ASSERT(ctx != NULL);
 
+	// no longer cancellable once unlisted
+	if(ctx->internal_exec_ctx.query_id != 0) {
+		QueryRegistry_Remove(ctx->internal_exec_ctx.query_id);
+	}
+
 	if(ctx->query_data.params) {
 		raxFreeWithCallback(ctx->query_data.params, _ParameterFreeCallback);
 		ctx->query_data.params = NULL;
 	}
 
+	if(ctx->internal_exec_ctx.index_changes) {
+		// changes are applied at commit, nothing should be left pending
+		ASSERT(IndexChanges_Empty(ctx->internal_exec_ctx.index_changes));
+		IndexChanges_Free(ctx->internal_exec_ctx.index_changes);
+	}
+
+	if(ctx->internal_exec_ctx.effects) {
+		EffectsBuffer_Free(ctx->internal_exec_ctx.effects);
+	}
+
+	// values read by the query are no longer referenced
+	CompressedString_ReleaseReads();
+
 	rm_free(ctx);
 	// NULL-set the context for reuse the next time this thread receives a query
 	QueryCtx_RemoveFromTLS();
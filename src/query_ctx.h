@@ -10,8 +10,11 @@
 #include "redismodule.h"
 #include "util/rmalloc.h"
 #include "graph/graphcontext.h"
+#include "index/index_changes.h"
 #include "commands/cmd_context.h"
 #include "resultset/resultset.h"
+#include "slow_log/query_trace.h"
+#include "effects/effects.h"
 #include "execution_plan/ops/op.h"
 #include <pthread.h>
 
@@ -21,14 +24,45 @@ typedef struct {
 	AST *ast;       // The scoped AST associated with this query.
 	rax *params;    // Query parameters.
 	const char *query;    // Query string.
+	const char *binary_params;  // MessagePack encoded parameters, NULL if none.
+	size_t binary_params_len;   // Length of binary_params.
 } QueryCtx_QueryData;
 
+// stages a query's time is split into
+typedef enum {
+	QUERY_STAGE_WAIT,     // pending in a thread pool queue
+	QUERY_STAGE_LOCK,     // acquiring the graph lock
+	QUERY_STAGE_PLAN,     // parsing and building an execution plan
+	QUERY_STAGE_EXECUTE,  // executing and replying
+	QUERY_STAGE_COUNT
+} QueryStage;
+
+// reasons for cancelling a running query
+typedef enum {
+	QUERY_CANCEL_NONE = 0,  // query is running
+	QUERY_CANCEL_TIMEOUT,   // query exceeded its timeout
+	QUERY_CANCEL_KILLED     // query was killed by GRAPH.KILL
+} QueryCancelReason;
+
+// long loops check for cancellation once every QUERY_CANCEL_CHECK_MASK + 1
+// iterations, e.g. if((++i & QUERY_CANCEL_CHECK_MASK) == 0)
+#define QUERY_CANCEL_CHECK_MASK 0x3FF
+
 typedef struct {
 	double timer[2];            // Query execution time tracking.
+	double stage_time[QUERY_STAGE_COUNT];  // Time spent in each stage, in milliseconds.
+	QueryTrace trace;           // Lifecycle phase timestamps.
 	RedisModuleKey *key;        // Saves an open key value, for later extraction and closing.
 	ResultSet *result_set;      // Save the execution result set.
 	bool locked_for_commit;     // Indicates if a call for QueryCtx_LockForCommit issued before.
 	OpBase *last_writer;        // The last writer operation which indicates the need for commit.
+	IndexChanges *index_changes;  // Pending index modifications, applied at commit.
+	EffectsBuffer *effects;     // Modifications introduced by the query, replicated at commit.
+	bool non_deterministic;     // The query calls non-deterministic functions.
+	int64_t timestamp;          // Query start time, milliseconds since epoch.
+	int cancel_reason;          // QueryCancelReason, set by other threads.
+	uint64_t deadline;          // Monotonic time in ms at which the query times out, 0 if none.
+	uint64_t query_id;          // ID in the query registry, 0 if not listed.
 } QueryCtx_InternalExecCtx;
 
 typedef struct {
@@ -68,7 +102,8 @@ void QueryCtx_SetAST(AST *ast);
 void QueryCtx_SetGraphCtx(GraphContext *gc);
 /* Set the resultset. */
 void QueryCtx_SetResultSet(ResultSet *result_set);
-/* Set the parameters map. */
+/* Set the parameters map, merged into previously set parameters,
+ * overriding parameters of the same name. */
 void QueryCtx_SetParams(rax *params);
 /* Set the last writer which needs to commit */
 void QueryCtx_SetLastWriter(OpBase *op);
@@ -78,6 +113,9 @@ void QueryCtx_SetLastWriter(OpBase *op);
 AST *QueryCtx_GetAST(void);
 /* Retrieve the query parameters values map. */
 rax *QueryCtx_GetParams(void);
+/* Retrieve the query start time in milliseconds since epoch,
+ * the same value is returned throughout a query. */
+int64_t QueryCtx_GetTimestamp(void);
 /* Retrieve the Graph object. */
 Graph *QueryCtx_GetGraph(void);
 /* Retrieve the GraphCtx. */
@@ -89,6 +127,23 @@ ResultSet *QueryCtx_GetResultSet(void);
 /* Retrive the resultset statistics. */
 ResultSetStatistics *QueryCtx_GetResultSetStatistics(void);
 
+/* Retrive the query's pending index modifications, created on demand. */
+IndexChanges *QueryCtx_GetIndexChanges(void);
+
+/* Retrieve the query's effects buffer, created on demand. */
+EffectsBuffer *QueryCtx_GetEffectsBuffer(void);
+
+/* Mark the query as calling non-deterministic functions,
+ * such queries are always replicated via effects. */
+void QueryCtx_SetNonDeterministic(void);
+
+/* Apply the query's pending index modifications.
+ * Called before the query reads an index and once the query commits. */
+void QueryCtx_ApplyIndexChanges(void);
+
+/* Retrieve the current query string, NULL if the thread isn't executing a query. */
+const char *QueryCtx_GetQuery(void);
+
 /* Print the current query. */
 void QueryCtx_PrintQuery(void);
 
@@ -122,9 +177,64 @@ void QueryCtx_UnlockCommit(OpBase *writer_op);
  * some reason the last writer op has not invoked QueryCtx_UnlockCommit and Redis is locked.*/
 void QueryCtx_ForceUnlockCommit(void);
 
+/* Group commit.
+ * Write queries against 'gc' executed by the calling thread between
+ * QueryCtx_BeginGroupCommit and QueryCtx_EndGroupCommit commit through a
+ * shared thread safe context, each query holds the GIL and the graph's
+ * write lock only while it commits and replicates. */
+void QueryCtx_BeginGroupCommit(GraphContext *gc);
+
+/* Ends group commit, releasing its context. */
+void QueryCtx_EndGroupCommit(void);
+
 /* Compute and return elapsed query execution time. */
 double QueryCtx_GetExecutionTime(void);
 
+/* Add 'ms' milliseconds to the time spent by the query in 'stage'. */
+void QueryCtx_AddStageTime(QueryStage stage, double ms);
+
+/* Retrieve the time spent by the query in 'stage', in milliseconds. */
+double QueryCtx_GetStageTime(QueryStage stage);
+
+/* Accumulate the query stage times into the process-wide totals. */
+void QueryCtx_RecordStageTimes(void);
+
+/* Retrieve the process-wide stage totals, in microseconds,
+ * and the number of queries they were accumulated over. */
+void QueryCtx_GetStageTotals(uint64_t totals[QUERY_STAGE_COUNT], uint64_t *queries);
+
+/* Record that the query reached 'event' now. */
+void QueryCtx_Trace(QueryTraceEvent event);
+
+/* Retrieve the query's lifecycle phase trace. */
+QueryTrace *QueryCtx_GetTrace(void);
+
+/* Cancellation.
+ * Running queries are cancelled cooperatively: QueryCtx_Cancel may be called
+ * from any thread and only sets a flag, the query notices it at its next
+ * checkpoint (QueryCtx_CheckCancelled) and aborts with a runtime error.
+ * A query holding its commit locks is never interrupted. */
+void QueryCtx_Cancel(QueryCtx *ctx, QueryCancelReason reason);
+
+/* Retrieve the reason 'ctx' was cancelled for, the first reason set sticks. */
+QueryCancelReason QueryCtx_CancelReason(const QueryCtx *ctx);
+
+/* Set the current query to time out 'timeout' milliseconds from now.
+ * The deadline is checked at cancellation checkpoints, no timer is armed. */
+void QueryCtx_SetDeadline(uint timeout);
+
+/* Returns true if the current query was cancelled. */
+bool QueryCtx_Cancelled(void);
+
+/* Cancellation checkpoint, raises a runtime exception if the current query
+ * was cancelled, passed its deadline or exceeded its memory capacity,
+ * and doesn't hold its commit locks. */
+void QueryCtx_CheckCancelled(void);
+
+/* List the current query in the query registry, making it visible to
+ * GRAPH.LIST_QUERIES and cancellable by GRAPH.KILL. */
+void QueryCtx_Register(const char *graph, const char *command, const char *query);
+
 /* Free the allocations within the QueryCtx and reset it for the next query. */
 void QueryCtx_Free(void);
 
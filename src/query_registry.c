@@ -0,0 +1,128 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "query_registry.h"
+#include "util/arr.h"
+#include "util/rmalloc.h"
+#include "util/simple_timer.h"
+#include <pthread.h>
+
+// in-flight query
+typedef struct {
+	uint64_t id;          // query ID
+	QueryCtx *query_ctx;  // query context, cancelled by GRAPH.KILL
+	char *graph;          // graph name
+	char *command;        // command name
+	char *query;          // query string
+	double timer[2];      // time since the query was listed
+} QueryRegistryEntry;
+
+static uint64_t _next_id = 1;               // next query ID
+static QueryRegistryEntry *_entries = NULL;  // in-flight queries
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+uint64_t QueryRegistry_Add
+(
+	QueryCtx *query_ctx,
+	const char *graph,
+	const char *command,
+	const char *query
+) {
+	ASSERT(query_ctx != NULL);
+
+	QueryRegistryEntry e;
+	e.query_ctx = query_ctx;
+	e.graph     = rm_strdup(graph   ? graph   : "");
+	e.command   = rm_strdup(command ? command : "");
+	e.query     = rm_strdup(query   ? query   : "");
+	simple_tic(e.timer);
+
+	pthread_mutex_lock(&_lock);
+	{
+		if(_entries == NULL) _entries = array_new(QueryRegistryEntry, 16);
+		e.id = _next_id++;
+		array_append(_entries, e);
+	}
+	pthread_mutex_unlock(&_lock);
+
+	return e.id;
+}
+
+void QueryRegistry_Remove
+(
+	uint64_t id
+) {
+	QueryRegistryEntry e = {0};
+
+	pthread_mutex_lock(&_lock);
+	{
+		uint n = array_len(_entries);
+		for(uint i = 0; i < n; i++) {
+			if(_entries[i].id != id) continue;
+			e = _entries[i];
+			array_del_fast(_entries, i);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+
+	if(e.id == 0) return;
+
+	rm_free(e.graph);
+	rm_free(e.command);
+	rm_free(e.query);
+}
+
+bool QueryRegistry_Kill
+(
+	uint64_t id
+) {
+	bool found = false;
+
+	pthread_mutex_lock(&_lock);
+	{
+		uint n = array_len(_entries);
+		for(uint i = 0; i < n; i++) {
+			if(_entries[i].id != id) continue;
+			QueryCtx_Cancel(_entries[i].query_ctx, QUERY_CANCEL_KILLED);
+			found = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+
+	return found;
+}
+
+void QueryRegistry_Reply
+(
+	RedisModuleCtx *ctx
+) {
+	ASSERT(ctx != NULL);
+
+	pthread_mutex_lock(&_lock);
+	{
+		uint n = array_len(_entries);
+		RedisModule_ReplyWithArray(ctx, n);
+		for(uint i = 0; i < n; i++) {
+			QueryRegistryEntry *e = _entries + i;
+			bool cancelled = QueryCtx_CancelReason(e->query_ctx) !=
+				QUERY_CANCEL_NONE;
+
+			RedisModule_ReplyWithArray(ctx, 6);
+			RedisModule_ReplyWithLongLong(ctx, e->id);
+			RedisModule_ReplyWithStringBuffer(ctx, e->graph, strlen(e->graph));
+			RedisModule_ReplyWithStringBuffer(ctx, e->command,
+					strlen(e->command));
+			RedisModule_ReplyWithStringBuffer(ctx, e->query, strlen(e->query));
+			RedisModule_ReplyWithDouble(ctx, simple_toc(e->timer) * 1000);
+			RedisModule_ReplyWithSimpleString(ctx,
+					cancelled ? "cancelled" : "running");
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+}
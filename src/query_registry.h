@@ -0,0 +1,45 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "query_ctx.h"
+#include "redismodule.h"
+
+// registry of in-flight queries
+// queries are listed by GRAPH.LIST_QUERIES and cancelled by GRAPH.KILL
+//
+// an entry refers to its QueryCtx until the QueryCtx is freed, which removes
+// the entry, the registry lock guards against cancelling a freed QueryCtx
+
+// lists 'query_ctx' as an in-flight query, assigning it a unique ID
+// 'graph', 'command' and 'query' are copied
+uint64_t QueryRegistry_Add
+(
+	QueryCtx *query_ctx,  // query to list
+	const char *graph,    // graph name
+	const char *command,  // command name
+	const char *query     // query string
+);
+
+// removes the entry of query 'id'
+void QueryRegistry_Remove
+(
+	uint64_t id  // query ID
+);
+
+// cancels query 'id', the query stops at its next cancellation checkpoint
+// returns false if there's no such in-flight query
+bool QueryRegistry_Kill
+(
+	uint64_t id  // query ID
+);
+
+// replies with the in-flight queries
+void QueryRegistry_Reply
+(
+	RedisModuleCtx *ctx  // redis module context
+);
@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include <math.h>
 #include "../../redismodule.h"
 #include "../../graph/graphcontext.h"
 #include "../../graph/query_graph.h"
+#include "../../util/string_pool.h"
 
 typedef enum {
 	COLUMN_UNKNOWN = 0,
@@ -39,22 +41,60 @@ typedef void (*EmitHeaderFunc)(RedisModuleCtx *ctx, const char **columns,
 // Typedef for row formatters.
 typedef void (*EmitRowFunc)(RedisModuleCtx *ctx, GraphContext *gc,
 		SIValue **row, uint numcols);
-							   
+
+// Typedef for columnar formatters, encoding a batch of rows as a single
+// reply element, 'cells' holds the batch rows one after the other.
+typedef void (*EmitBatchFunc)(RedisModuleCtx *ctx, GraphContext *gc,
+		const char **columns, uint numcols, DataBlock *cells);
+
 typedef struct {
 	EmitRowFunc    EmitRow;
+	EmitBatchFunc  EmitBatch;   // [optional] replaces EmitRow when set
 	EmitHeaderFunc EmitHeader;
 } ResultSetFormatter;
 
+// length of string value 'v', interned strings record their length
+// such that only non interned strings are scanned
+static inline size_t _ResultSet_StringLength(SIValue v) {
+	if(v.allocation == M_INTERN) return StringPool_Length(v.stringval);
+	return strlen(v.stringval);
+}
+
+// buffer size sufficient for any double printed with %.15g
+#define ROUNDED_DOUBLE_BUFSIZE 32
+
 /* Redis prints doubles with up to 17 digits of precision, which captures
  * the inaccuracy of many floating-point numbers (such as 0.1).
  * By using the %g format and a precision of 15 significant digits, we avoid many
  * awkward representations like RETURN 0.1 emitting "0.10000000000000001",
- * though we're still subject to many of the typical issues with floating-point error. */
+ * though we're still subject to many of the typical issues with floating-point error.
+ * Integral values below 1e15 print under %.15g as plain integers,
+ * these are formatted directly, sparing the printf machinery. */
+static inline int _ResultSet_FormatRoundedDouble(double d, char *buf) {
+	if(d > -1e15 && d < 1e15 && d == (double)(int64_t)d &&
+	   !(d == 0 && signbit(d))) {
+		int64_t n = (int64_t)d;
+		uint64_t u = (n < 0) ? -(uint64_t)n : (uint64_t)n;
+		char digits[16];
+		int ndigits = 0;
+		do {
+			digits[ndigits++] = '0' + (u % 10);
+			u /= 10;
+		} while(u > 0);
+
+		int len = 0;
+		if(n < 0) buf[len++] = '-';
+		while(ndigits > 0) buf[len++] = digits[--ndigits];
+		buf[len] = '\0';
+		return len;
+	}
+
+	return snprintf(buf, ROUNDED_DOUBLE_BUFSIZE, "%.15g", d);
+}
+
 static inline void _ResultSet_ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
-	// Get length required to print number
-	int len = snprintf(NULL, 0, "%.15g", d);
-	char str[len + 1]; // TODO a reusable buffer would be far preferable
-	sprintf(str, "%.15g", d);
+	char str[ROUNDED_DOUBLE_BUFSIZE];
+	int len = _ResultSet_FormatRoundedDouble(d, str);
 	// Output string-formatted number
 	RedisModule_ReplyWithStringBuffer(ctx, str, len);
 }
@@ -18,6 +18,12 @@ ResultSetFormatter *ResultSetFormatter_GetFormatter(ResultSetFormatterType t) {
 	case FORMATTER_COMPACT:
 		formatter = &ResultSetFormatterCompact;
 		break;
+	case FORMATTER_ARROW:
+		formatter = &ResultSetFormatterArrow;
+		break;
+	case FORMATTER_JSON:
+		formatter = &ResultSetFormatterJSON;
+		break;
 	default:
 		RedisModule_Assert(false && "Unknown formatter");
 	}
@@ -10,11 +10,15 @@
 #include "resultset_replynop.h"
 #include "resultset_replycompact.h"
 #include "resultset_replyverbose.h"
+#include "resultset_replyarrow.h"
+#include "resultset_replyjson.h"
 
 typedef enum {
 	FORMATTER_NOP = 0,
 	FORMATTER_VERBOSE = 1,
 	FORMATTER_COMPACT = 2,
+	FORMATTER_ARROW = 3,
+	FORMATTER_JSON = 4,
 } ResultSetFormatterType;
 
 /* Retrieves result-set formatter.
@@ -40,3 +44,16 @@ static ResultSetFormatter ResultSetFormatterVerbose __attribute__((used)) = {
 	.EmitHeader = ResultSet_ReplyWithVerboseHeader
 };
 
+/* Columnar reply formatter, rows are encoded in batches as Arrow IPC streams.
+ * The header is identical to the verbose header. */
+static ResultSetFormatter ResultSetFormatterArrow __attribute__((used)) = {
+	.EmitBatch = ResultSet_EmitArrowBatch,
+	.EmitHeader = ResultSet_ReplyWithVerboseHeader
+};
+
+/* JSON reply formatter, rows are encoded in batches as JSON arrays of objects.
+ * The header is identical to the verbose header. */
+static ResultSetFormatter ResultSetFormatterJSON __attribute__((used)) = {
+	.EmitBatch = ResultSet_EmitJSONBatch,
+	.EmitHeader = ResultSet_ReplyWithVerboseHeader
+};
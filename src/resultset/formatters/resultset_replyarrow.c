@@ -0,0 +1,429 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "resultset_formatters.h"
+#include "RG.h"
+#include "../../util/arr.h"
+#include "../../util/rmalloc.h"
+
+// Arrow IPC streaming format
+// https://arrow.apache.org/docs/format/Columnar.html#serialization-and-interprocess-communication-ipc
+//
+// each message is encapsulated as:
+// continuation marker, metadata length, flatbuffers metadata, body
+//
+// column types are inferred from the batch values:
+// integers -> Int64, floats or a mix of integers and floats -> Float64,
+// booleans -> Bool, anything else (strings, graph entities, collections
+// and mixed types) -> Utf8 holding the value's string representation
+// nulls are tracked by validity bitmaps
+
+#define ARROW_METADATA_V5      4           // MetadataVersion.V5
+#define ARROW_HEADER_SCHEMA    1           // MessageHeader.Schema
+#define ARROW_HEADER_BATCH     3           // MessageHeader.RecordBatch
+#define ARROW_TYPE_INT         2           // Type.Int
+#define ARROW_TYPE_FLOAT       3           // Type.FloatingPoint
+#define ARROW_TYPE_UTF8        5           // Type.Utf8
+#define ARROW_TYPE_BOOL        6           // Type.Bool
+#define ARROW_PRECISION_DOUBLE 2           // Precision.DOUBLE
+#define ARROW_CONTINUATION     0xFFFFFFFF  // message continuation marker
+#define ARROW_ALIGNMENT        8           // messages and buffers alignment
+
+// growable byte buffer
+typedef struct {
+	char *data;  // buffer content
+	size_t len;  // number of bytes used
+	size_t cap;  // number of bytes allocated
+} ArrowBuffer;
+
+static ArrowBuffer _Buffer_New(size_t cap) {
+	ArrowBuffer b = {.data = rm_malloc(cap), .len = 0, .cap = cap};
+	return b;
+}
+
+// reserves 'n' zeroed bytes aligned to 'align', returns their position
+// padding introduced by the alignment is zeroed as well
+static size_t _Buffer_Reserve(ArrowBuffer *b, size_t n, size_t align) {
+	size_t pos = (b->len + align - 1) & ~(align - 1);
+	size_t end = pos + n;
+	if(end > b->cap) {
+		b->cap = (end > b->cap * 2) ? end : b->cap * 2;
+		b->data = rm_realloc(b->data, b->cap);
+	}
+	memset(b->data + b->len, 0, end - b->len);
+	b->len = end;
+	return pos;
+}
+
+static inline void _Buffer_Write(ArrowBuffer *b, size_t pos, const void *v,
+		size_t n) {
+	memcpy(b->data + pos, v, n);
+}
+
+//------------------------------------------------------------------------------
+// flatbuffers
+//------------------------------------------------------------------------------
+
+// metadata is written front to back, a table is followed by the objects it
+// refers to, such that offsets are always positive as flatbuffers require
+
+// writes a table preceded by its vtable, fields are sized by 'sizes'
+// absent fields have size 0, the position of each field is set in 'pos'
+static size_t _FB_Table(ArrowBuffer *b, uint nfields, const uint8_t *sizes,
+		size_t *pos) {
+	uint16_t vtable[2 + nfields];
+	size_t vtable_len = sizeof(vtable);
+	size_t vtable_pos = _Buffer_Reserve(b, vtable_len, sizeof(uint16_t));
+
+	// a table starts with the signed offset to its vtable
+	// fields are aligned to their size
+	size_t table = _Buffer_Reserve(b, sizeof(int32_t), ARROW_ALIGNMENT);
+	vtable[0] = vtable_len;
+	for(uint i = 0; i < nfields; i++) {
+		vtable[2 + i] = 0;
+		if(sizes[i] == 0) continue;
+		pos[i] = _Buffer_Reserve(b, sizes[i], sizes[i]);
+		vtable[2 + i] = pos[i] - table;
+	}
+	vtable[1] = b->len - table;
+
+	int32_t soffset = table - vtable_pos;
+	_Buffer_Write(b, vtable_pos, vtable, vtable_len);
+	_Buffer_Write(b, table, &soffset, sizeof(soffset));
+	return table;
+}
+
+// sets the offset at 'pos' to refer to 'target'
+static void _FB_Patch(ArrowBuffer *b, size_t pos, size_t target) {
+	ASSERT(target > pos);
+	uint32_t offset = target - pos;
+	_Buffer_Write(b, pos, &offset, sizeof(offset));
+}
+
+static size_t _FB_String(ArrowBuffer *b, const char *s) {
+	uint32_t len = strlen(s);
+	// length prefix, content and a null terminator
+	size_t pos = _Buffer_Reserve(b, sizeof(len) + len + 1, sizeof(len));
+	_Buffer_Write(b, pos, &len, sizeof(len));
+	_Buffer_Write(b, pos + sizeof(len), s, len);
+	return pos;
+}
+
+// writes a vector of 'n' zeroed elements of 'size' bytes, elements follow
+// the length prefix and are aligned to 'align'
+static size_t _FB_Vector(ArrowBuffer *b, uint32_t n, size_t size,
+		size_t align) {
+	_Buffer_Reserve(b, 0, sizeof(n));
+	while((b->len + sizeof(n)) % align != 0) {
+		_Buffer_Reserve(b, sizeof(n), sizeof(n));
+	}
+
+	size_t pos = _Buffer_Reserve(b, sizeof(n) + n * size, sizeof(n));
+	_Buffer_Write(b, pos, &n, sizeof(n));
+	return pos;
+}
+
+// writes a Type union member table
+static size_t _FB_Type(ArrowBuffer *b, uint8_t type) {
+	size_t pos[2];
+	size_t table;
+
+	switch(type) {
+		case ARROW_TYPE_INT: {
+			// Int: bitWidth, is_signed
+			static const uint8_t fields[] = {4, 1};
+			table = _FB_Table(b, 2, fields, pos);
+			int32_t bit_width = 64;
+			uint8_t is_signed = 1;
+			_Buffer_Write(b, pos[0], &bit_width, sizeof(bit_width));
+			_Buffer_Write(b, pos[1], &is_signed, sizeof(is_signed));
+			return table;
+		}
+		case ARROW_TYPE_FLOAT: {
+			// FloatingPoint: precision
+			static const uint8_t fields[] = {2};
+			table = _FB_Table(b, 1, fields, pos);
+			int16_t precision = ARROW_PRECISION_DOUBLE;
+			_Buffer_Write(b, pos[0], &precision, sizeof(precision));
+			return table;
+		}
+		default:
+			// Utf8 and Bool have no fields
+			return _FB_Table(b, 0, NULL, NULL);
+	}
+}
+
+// writes a Message table, returns the position of its header offset
+static size_t _FB_Message(ArrowBuffer *b, uint8_t header_type,
+		int64_t body_len) {
+	// the buffer starts with the offset to the root table
+	size_t root = _Buffer_Reserve(b, sizeof(uint32_t), sizeof(uint32_t));
+
+	// Message: version, header_type, header, bodyLength
+	static const uint8_t fields[] = {2, 1, 4, 8};
+	size_t pos[4];
+	size_t message = _FB_Table(b, 4, fields, pos);
+	_FB_Patch(b, root, message);
+
+	int16_t version = ARROW_METADATA_V5;
+	_Buffer_Write(b, pos[0], &version, sizeof(version));
+	_Buffer_Write(b, pos[1], &header_type, sizeof(header_type));
+	_Buffer_Write(b, pos[3], &body_len, sizeof(body_len));
+
+	return pos[2];
+}
+
+//------------------------------------------------------------------------------
+// IPC messages
+//------------------------------------------------------------------------------
+
+// appends an encapsulated message to 'out'
+static void _IPC_Message(ArrowBuffer *out, const ArrowBuffer *metadata,
+		const ArrowBuffer *body) {
+	// metadata is padded such that the body is aligned
+	uint32_t marker = ARROW_CONTINUATION;
+	uint32_t metadata_len = (metadata->len + ARROW_ALIGNMENT - 1) &
+		~(ARROW_ALIGNMENT - 1);
+
+	size_t pos = _Buffer_Reserve(out, sizeof(marker) + sizeof(metadata_len) +
+			metadata_len, ARROW_ALIGNMENT);
+	_Buffer_Write(out, pos, &marker, sizeof(marker));
+	pos += sizeof(marker);
+	_Buffer_Write(out, pos, &metadata_len, sizeof(metadata_len));
+	pos += sizeof(metadata_len);
+	_Buffer_Write(out, pos, metadata->data, metadata->len);
+
+	if(body != NULL && body->len > 0) {
+		pos = _Buffer_Reserve(out, body->len, ARROW_ALIGNMENT);
+		_Buffer_Write(out, pos, body->data, body->len);
+	}
+}
+
+static void _IPC_Schema(ArrowBuffer *out, const char **columns, uint numcols,
+		const uint8_t *types) {
+	ArrowBuffer b = _Buffer_New(256);
+	size_t header = _FB_Message(&b, ARROW_HEADER_SCHEMA, 0);
+
+	// Schema: endianness (little endian is the default), fields
+	static const uint8_t schema_fields[] = {0, 4};
+	size_t schema_pos[2];
+	size_t schema = _FB_Table(&b, 2, schema_fields, schema_pos);
+	_FB_Patch(&b, header, schema);
+
+	size_t fields = _FB_Vector(&b, numcols, sizeof(uint32_t), sizeof(uint32_t));
+	_FB_Patch(&b, schema_pos[1], fields);
+
+	for(uint i = 0; i < numcols; i++) {
+		// Field: name, nullable, type_type, type, dictionary, children
+		static const uint8_t field_fields[] = {4, 1, 1, 4, 0, 4};
+		size_t pos[6];
+		size_t field = _FB_Table(&b, 6, field_fields, pos);
+		_FB_Patch(&b, fields + sizeof(uint32_t) * (i + 1), field);
+
+		uint8_t nullable = 1;
+		_FB_Patch(&b, pos[0], _FB_String(&b, columns[i]));
+		_Buffer_Write(&b, pos[1], &nullable, sizeof(nullable));
+		_Buffer_Write(&b, pos[2], types + i, sizeof(uint8_t));
+		_FB_Patch(&b, pos[3], _FB_Type(&b, types[i]));
+		// readers expect a children vector, even an empty one
+		_FB_Patch(&b, pos[5], _FB_Vector(&b, 0, sizeof(uint32_t),
+					sizeof(uint32_t)));
+	}
+
+	_IPC_Message(out, &b, NULL);
+	rm_free(b.data);
+}
+
+// 'nodes' holds a (length, null count) pair per column
+// 'buffers' holds an (offset, length) pair per body buffer
+static void _IPC_RecordBatch(ArrowBuffer *out, int64_t nrows,
+		const int64_t *nodes, uint numcols, int64_t *buffers,
+		const ArrowBuffer *body) {
+	ArrowBuffer b = _Buffer_New(256);
+	size_t header = _FB_Message(&b, ARROW_HEADER_BATCH, body->len);
+
+	// RecordBatch: length, nodes, buffers
+	static const uint8_t batch_fields[] = {8, 4, 4};
+	size_t pos[3];
+	size_t batch = _FB_Table(&b, 3, batch_fields, pos);
+	_FB_Patch(&b, header, batch);
+	_Buffer_Write(&b, pos[0], &nrows, sizeof(nrows));
+
+	// FieldNode and Buffer are structs of two longs
+	size_t pair = 2 * sizeof(int64_t);
+	size_t nodes_pos = _FB_Vector(&b, numcols, pair, sizeof(int64_t));
+	_FB_Patch(&b, pos[1], nodes_pos);
+	_Buffer_Write(&b, nodes_pos + sizeof(uint32_t), nodes, numcols * pair);
+
+	uint32_t buffer_count = array_len(buffers) / 2;
+	size_t buffers_pos = _FB_Vector(&b, buffer_count, pair, sizeof(int64_t));
+	_FB_Patch(&b, pos[2], buffers_pos);
+	_Buffer_Write(&b, buffers_pos + sizeof(uint32_t), buffers,
+			buffer_count * pair);
+
+	_IPC_Message(out, &b, body);
+	rm_free(b.data);
+}
+
+//------------------------------------------------------------------------------
+// columns
+//------------------------------------------------------------------------------
+
+static inline SIValue *_Cell(DataBlock *cells, uint numcols, uint64_t row,
+		uint col) {
+	return DataBlock_GetItem(cells, row * numcols + col);
+}
+
+static uint8_t _ColumnType(DataBlock *cells, uint numcols, uint64_t nrows,
+		uint col) {
+	SIType types = 0;
+	for(uint64_t i = 0; i < nrows; i++) {
+		types |= SI_TYPE(*_Cell(cells, numcols, i, col));
+	}
+	types &= ~T_NULL;
+
+	if(types == T_INT64) return ARROW_TYPE_INT;
+	if(types == T_DOUBLE || types == (T_INT64 | T_DOUBLE)) return ARROW_TYPE_FLOAT;
+	if(types == T_BOOL) return ARROW_TYPE_BOOL;
+	return ARROW_TYPE_UTF8;
+}
+
+// reserves an aligned body buffer of 'len' bytes
+// records its location in 'buffers', returns its position
+static size_t _Body_Buffer(ArrowBuffer *body, int64_t **buffers, size_t len) {
+	size_t pos = _Buffer_Reserve(body, len, ARROW_ALIGNMENT);
+	array_append(*buffers, pos);
+	array_append(*buffers, len);
+	return pos;
+}
+
+static inline void _SetBit(char *bitmap, uint64_t i) {
+	bitmap[i / 8] |= (1 << (i % 8));
+}
+
+// encodes a column into the body buffers, returns its null count
+static int64_t _EncodeColumn(ArrowBuffer *body, int64_t **buffers,
+		DataBlock *cells, uint numcols, uint64_t nrows, uint col,
+		uint8_t type) {
+	int64_t null_count = 0;
+	for(uint64_t i = 0; i < nrows; i++) {
+		if(SIValue_IsNull(*_Cell(cells, numcols, i, col))) null_count++;
+	}
+
+	// validity bitmap, omitted when there are no nulls
+	size_t bitmap_len = (null_count > 0) ? (nrows + 7) / 8 : 0;
+	size_t pos = _Body_Buffer(body, buffers, bitmap_len);
+	if(null_count > 0) {
+		char *validity = body->data + pos;
+		for(uint64_t i = 0; i < nrows; i++) {
+			if(!SIValue_IsNull(*_Cell(cells, numcols, i, col))) {
+				_SetBit(validity, i);
+			}
+		}
+	}
+
+	switch(type) {
+		case ARROW_TYPE_INT: {
+			pos = _Body_Buffer(body, buffers, nrows * sizeof(int64_t));
+			int64_t *values = (int64_t *)(body->data + pos);
+			for(uint64_t i = 0; i < nrows; i++) {
+				SIValue *v = _Cell(cells, numcols, i, col);
+				if(SI_TYPE(*v) == T_INT64) values[i] = v->longval;
+			}
+			break;
+		}
+		case ARROW_TYPE_FLOAT: {
+			pos = _Body_Buffer(body, buffers, nrows * sizeof(double));
+			double *values = (double *)(body->data + pos);
+			for(uint64_t i = 0; i < nrows; i++) {
+				SIValue *v = _Cell(cells, numcols, i, col);
+				if(SI_TYPE(*v) == T_INT64) values[i] = v->longval;
+				else if(SI_TYPE(*v) == T_DOUBLE) values[i] = v->doubleval;
+			}
+			break;
+		}
+		case ARROW_TYPE_BOOL: {
+			pos = _Body_Buffer(body, buffers, (nrows + 7) / 8);
+			char *values = body->data + pos;
+			for(uint64_t i = 0; i < nrows; i++) {
+				SIValue *v = _Cell(cells, numcols, i, col);
+				if(SI_TYPE(*v) == T_BOOL && v->longval) _SetBit(values, i);
+			}
+			break;
+		}
+		case ARROW_TYPE_UTF8: {
+			// offsets into the concatenated strings
+			pos = _Body_Buffer(body, buffers, (nrows + 1) * sizeof(int32_t));
+			size_t cap = 64;
+			size_t len = 0;
+			char *str = rm_malloc(cap);
+			for(uint64_t i = 0; i < nrows; i++) {
+				SIValue *v = _Cell(cells, numcols, i, col);
+				if(!SIValue_IsNull(*v)) {
+					if(SI_TYPE(*v) == T_STRING) {
+						size_t n = _ResultSet_StringLength(*v);
+						if(len + n > cap) {
+							cap = (len + n > cap * 2) ? len + n : cap * 2;
+							str = rm_realloc(str, cap);
+						}
+						memcpy(str + len, v->stringval, n);
+						len += n;
+					} else {
+						SIValue_ToString(*v, &str, &cap, &len);
+					}
+				}
+				ASSERT(len <= INT32_MAX);
+				int32_t offset = len;
+				memcpy(body->data + pos + (i + 1) * sizeof(int32_t), &offset,
+						sizeof(offset));
+			}
+			pos = _Body_Buffer(body, buffers, len);
+			memcpy(body->data + pos, str, len);
+			rm_free(str);
+			break;
+		}
+		default:
+			ASSERT(false && "unknown arrow type");
+	}
+
+	return null_count;
+}
+
+void ResultSet_EmitArrowBatch(RedisModuleCtx *ctx, GraphContext *gc,
+		const char **columns, uint numcols, DataBlock *cells) {
+	UNUSED(gc);
+	ASSERT(numcols > 0);
+
+	uint64_t nrows = DataBlock_ItemCount(cells) / numcols;
+	uint8_t types[numcols];
+	int64_t nodes[numcols * 2];
+	int64_t *buffers = array_new(int64_t, numcols * 6);
+	ArrowBuffer body = _Buffer_New(nrows * numcols * sizeof(int64_t) + 64);
+
+	for(uint i = 0; i < numcols; i++) {
+		types[i] = _ColumnType(cells, numcols, nrows, i);
+		nodes[i * 2] = nrows;
+		nodes[i * 2 + 1] = _EncodeColumn(&body, &buffers, cells, numcols,
+				nrows, i, types[i]);
+	}
+	// pad the last buffer
+	_Buffer_Reserve(&body, 0, ARROW_ALIGNMENT);
+
+	ArrowBuffer out = _Buffer_New(body.len + 1024);
+	_IPC_Schema(&out, columns, numcols, types);
+	_IPC_RecordBatch(&out, nrows, nodes, numcols, buffers, &body);
+
+	// end of stream, a continuation marker followed by a zero length
+	uint32_t marker = ARROW_CONTINUATION;
+	size_t pos = _Buffer_Reserve(&out, 2 * sizeof(uint32_t), ARROW_ALIGNMENT);
+	_Buffer_Write(&out, pos, &marker, sizeof(marker));
+
+	RedisModule_ReplyWithStringBuffer(ctx, out.data, out.len);
+
+	rm_free(out.data);
+	rm_free(body.data);
+	array_free(buffers);
+}
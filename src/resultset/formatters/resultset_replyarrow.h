@@ -0,0 +1,13 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+// Formatter for columnar replies, encoded in the Arrow IPC streaming format
+// each batch of rows is replied as a single bulk string holding a self
+// contained IPC stream: a schema, a single record batch and an end-of-stream
+void ResultSet_EmitArrowBatch(RedisModuleCtx *ctx, GraphContext *gc,
+		const char **columns, uint numcols, DataBlock *cells);
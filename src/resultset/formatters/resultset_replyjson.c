@@ -0,0 +1,57 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "resultset_formatters.h"
+#include "RG.h"
+#include "../../util/rmalloc.h"
+#include "../../util/json_encoder.h"
+
+// rows are encoded as JSON objects, values follow the toJSON() encoding
+// [{"a": 1, "b": "x"}, {"a": 2, "b": "y"}]
+
+// estimated encoded size of a single value, sizes the initial buffer
+#define JSON_VALUE_SIZE_ESTIMATE 16
+
+void ResultSet_EmitJSONBatch(RedisModuleCtx *ctx, GraphContext *gc,
+		const char **columns, uint numcols, DataBlock *cells) {
+	ASSERT(numcols > 0);
+
+	uint64_t nrows = DataBlock_ItemCount(cells) / numcols;
+
+	// encode column names once, each key is followed by ": "
+	// key i spans [offsets[i], offsets[i + 1]) of keys.buf
+	JsonWriter keys;
+	size_t offsets[numcols + 1];
+	JsonWriter_Init(&keys, gc, numcols * JSON_VALUE_SIZE_ESTIMATE);
+	for(uint i = 0; i < numcols; i++) {
+		offsets[i] = keys.len;
+		JsonWriter_String(&keys, columns[i], strlen(columns[i]));
+		JsonWriter_Raw(&keys, ": ", 2);
+	}
+	offsets[numcols] = keys.len;
+
+	JsonWriter w;
+	JsonWriter_Init(&w, gc,
+			nrows * (keys.len + numcols * JSON_VALUE_SIZE_ESTIMATE) + 2);
+
+	JsonWriter_Raw(&w, "[", 1);
+	for(uint64_t r = 0; r < nrows; r++) {
+		JsonWriter_Raw(&w, (r == 0) ? "{" : ", {", (r == 0) ? 1 : 3);
+		for(uint i = 0; i < numcols; i++) {
+			if(i > 0) JsonWriter_Raw(&w, ", ", 2);
+			JsonWriter_Raw(&w, keys.buf + offsets[i], offsets[i + 1] - offsets[i]);
+			SIValue *v = DataBlock_GetItem(cells, r * numcols + i);
+			JsonWriter_SIValue(&w, *v);
+		}
+		JsonWriter_Raw(&w, "}", 1);
+	}
+	JsonWriter_Raw(&w, "]", 1);
+
+	RedisModule_ReplyWithStringBuffer(ctx, w.buf, w.len);
+
+	JsonWriter_Free(&w);
+	JsonWriter_Free(&keys);
+}
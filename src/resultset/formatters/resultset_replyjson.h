@@ -0,0 +1,12 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+// Formatter for JSON replies, each batch of rows is replied as a single
+// bulk string holding a JSON array with an object per row, keyed by column
+void ResultSet_EmitJSONBatch(RedisModuleCtx *ctx, GraphContext *gc,
+		const char **columns, uint numcols, DataBlock *cells);
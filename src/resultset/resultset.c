@@ -11,11 +11,14 @@
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
+#include "../datatypes/map.h"
+#include "../datatypes/array.h"
 #include "../grouping/group_cache.h"
+#include "../configuration/config.h"
 
-static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
+static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, const ResultSet *set) {
 	char buff[512] = {0};
-	size_t resultset_size = 2; // execution time, cached
+	size_t resultset_size = 3; // execution time, cached, commit sequence
 	int buflen;
 
 	if(set->stats.labels_added > 0) resultset_size++;
@@ -26,6 +29,8 @@ static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
 	if(set->stats.relationships_deleted > 0) resultset_size++;
 	if(set->stats.indices_created != STAT_NOT_SET) resultset_size++;
 	if(set->stats.indices_deleted != STAT_NOT_SET) resultset_size++;
+	if(set->stats.constraints_created != STAT_NOT_SET) resultset_size++;
+	if(set->stats.constraints_deleted != STAT_NOT_SET) resultset_size++;
 
 	RedisModule_ReplyWithArray(ctx, resultset_size);
 
@@ -69,9 +74,26 @@ static void _ResultSet_ReplayStats(RedisModuleCtx *ctx, ResultSet *set) {
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
 	}
 
+	if(set->stats.constraints_created != STAT_NOT_SET) {
+		buflen = sprintf(buff, "Constraints created: %d", set->stats.constraints_created);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+	}
+
+	if(set->stats.constraints_deleted != STAT_NOT_SET) {
+		buflen = sprintf(buff, "Constraints deleted: %d", set->stats.constraints_deleted);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+	}
+
 	buflen = sprintf(buff, "Cached execution: %d", set->stats.cached ? 1 : 0);
 	RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
 
+	// queries which didn't modify the graph report the sequence
+	// the graph reached, which covers every write they observed
+	uint64_t seq = ResultSetStat_IndicateModification(set->stats) ?
+		set->stats.commit_seq : GraphContext_CommitSeq(set->gc);
+	buflen = sprintf(buff, "Commit sequence: %llu", (unsigned long long)seq);
+	RedisModule_ReplyWithStringBuffer(ctx, (const char *)buff, buflen);
+
 	// Emit query execution time.
 	ResultSet_ReportQueryRuntime(ctx);
 }
@@ -90,15 +112,16 @@ void ResultSet_MapProjection(ResultSet *set, const Record r) {
 	}
 }
 
-static void _ResultSet_ReplyWithPreamble(ResultSet *set) {
+static void _ResultSet_ReplyWithPreamble(RedisModuleCtx *ctx,
+		const ResultSet *set) {
 	if(set->column_count > 0) {
 		// prepare a response containing a header, records, and statistics
-		RedisModule_ReplyWithArray(set->ctx, 3);
+		RedisModule_ReplyWithArray(ctx, 3);
 		// emit the table header using the appropriate formatter
-		set->formatter->EmitHeader(set->ctx, set->columns, set->columns_record_map);
+		set->formatter->EmitHeader(ctx, set->columns, set->columns_record_map);
 	} else {
 		// prepare a response containing only statistics
-		RedisModule_ReplyWithArray(set->ctx, 1);
+		RedisModule_ReplyWithArray(ctx, 1);
 	}
 }
 
@@ -132,6 +155,11 @@ ResultSet *NewResultSet(RedisModuleCtx *ctx, ResultSetFormatterType format) {
 	set->column_count = 0;
 	set->columns_record_map = NULL;
 	set->cells = DataBlock_New(32, sizeof(SIValue), NULL);
+	set->rows_emitted = 0;
+	set->elements_emitted = 0;
+	set->streaming = false;
+	set->retain_rows = false;
+	Config_Option_get(Config_RESULTSET_CHUNK_SIZE, &set->chunk_size);
 
 	set->stats.labels_added = 0;
 	set->stats.nodes_created = 0;
@@ -141,7 +169,10 @@ ResultSet *NewResultSet(RedisModuleCtx *ctx, ResultSetFormatterType format) {
 	set->stats.relationships_deleted = 0;
 	set->stats.indices_created = STAT_NOT_SET;
 	set->stats.indices_deleted = STAT_NOT_SET;
+	set->stats.constraints_created = STAT_NOT_SET;
+	set->stats.constraints_deleted = STAT_NOT_SET;
 	set->stats.cached = false;
+	set->stats.commit_seq = 0;
 
 	_ResultSet_SetColumns(set);
 
@@ -151,9 +182,74 @@ ResultSet *NewResultSet(RedisModuleCtx *ctx, ResultSetFormatterType format) {
 uint64_t ResultSet_RowCount(const ResultSet *set) {
 	ASSERT(set != NULL);
 	if(set->column_count == 0) return 0;
+	return set->rows_emitted +
+		DataBlock_ItemCount(set->cells) / set->column_count;
+}
+
+// number of records array elements replying the buffered rows
+// columnar formatters encode all buffered rows as a single element
+static uint64_t _ResultSet_ElementCount(const ResultSet *set) {
+	if(set->formatter->EmitBatch != NULL) return 1;
 	return DataBlock_ItemCount(set->cells) / set->column_count;
 }
 
+// emit every buffered row to 'ctx'
+// returns the number of records array elements emitted
+static uint64_t _ResultSet_EmitRows(RedisModuleCtx *ctx, const ResultSet *set) {
+	if(set->formatter->EmitBatch != NULL) {
+		set->formatter->EmitBatch(ctx, set->gc, set->columns,
+				set->column_count, set->cells);
+		return 1;
+	}
+
+	SIValue *row[set->column_count];
+	uint64_t cells = DataBlock_ItemCount(set->cells);
+	for(uint64_t i = 0; i < cells; i += set->column_count) {
+		for(uint j = 0; j < set->column_count; j++) {
+			row[j] = DataBlock_GetItem(set->cells, i + j);
+		}
+
+		set->formatter->EmitRow(ctx, set->gc, row, set->column_count);
+	}
+
+	return cells / set->column_count;
+}
+
+static void _ResultSet_FreeCells(ResultSet *set) {
+	uint64_t cells = DataBlock_ItemCount(set->cells);
+	for(uint64_t i = 0; i < cells; i++) {
+		SIValue_Free(*(SIValue *)DataBlock_GetItem(set->cells, i));
+	}
+}
+
+// emit and free every buffered row
+// retained rows are kept until the result-set is freed
+static uint64_t _ResultSet_EmitCells(ResultSet *set) {
+	uint64_t elements = _ResultSet_EmitRows(set->ctx, set);
+	if(!set->retain_rows) _ResultSet_FreeCells(set);
+	return elements;
+}
+
+// encode buffered rows into the client's reply and clear the buffer
+// the first flush opens a postponed-length reply holding the header
+// followed by a postponed-length records array, both closed by ResultSet_Reply
+static void _ResultSet_FlushChunk(ResultSet *set) {
+	if(!set->streaming) {
+		RedisModule_ReplyWithArray(set->ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+		set->formatter->EmitHeader(set->ctx, set->columns,
+				set->columns_record_map);
+		RedisModule_ReplyWithArray(set->ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+		set->streaming = true;
+	}
+
+	set->elements_emitted += _ResultSet_EmitCells(set);
+	set->rows_emitted += DataBlock_ItemCount(set->cells) / set->column_count;
+
+	// reuse a fresh buffer for the next chunk
+	DataBlock_Free(set->cells);
+	set->cells = DataBlock_New(32, sizeof(SIValue), NULL);
+}
+
 void _ResultSet_ConsumeRecord(ResultSet *set, Record r) {
 	for(int i = 0; i < set->column_count; i++) {
 		int idx = set->columns_record_map[i];
@@ -176,10 +272,17 @@ int ResultSet_AddRecord(ResultSet *set, Record r) {
 	if(set->format == FORMATTER_NOP) return RESULTSET_OK;
 
 	// if this is the first Record encountered, map columns to record indices
-	if(DataBlock_ItemCount(set->cells) == 0) ResultSet_MapProjection(set, r);
+	if(set->columns_record_map == NULL) ResultSet_MapProjection(set, r);
 
 	_ResultSet_ConsumeRecord(set, r);
 
+	// stream rows to the client once a full chunk has been accumulated
+	if(set->chunk_size != RESULTSET_CHUNK_SIZE_DISABLED &&
+	   set->column_count > 0 &&
+	   DataBlock_ItemCount(set->cells) >= set->chunk_size * set->column_count) {
+		_ResultSet_FlushChunk(set);
+	}
+
 	return RESULTSET_OK;
 }
 
@@ -207,12 +310,59 @@ void ResultSet_IndexDeleted(ResultSet *set, int status_code) {
 	}
 }
 
+void ResultSet_ConstraintCreated(ResultSet *set, bool created) {
+	if(set->stats.constraints_created == STAT_NOT_SET) {
+		set->stats.constraints_created = 0;
+	}
+	if(created) set->stats.constraints_created += 1;
+}
+
+void ResultSet_ConstraintDeleted(ResultSet *set, bool deleted) {
+	if(set->stats.constraints_deleted == STAT_NOT_SET) {
+		set->stats.constraints_deleted = 0;
+	}
+	if(deleted) set->stats.constraints_deleted += 1;
+}
+
 void ResultSet_CachedExecution(ResultSet *set) {
 	set->stats.cached = true;
 }
 
+// close a streamed reply, emitting the remaining rows
+// the reply always holds the header, records and statistics
+// a run-time error is appended as a fourth and last element
+static void _ResultSet_ReplyStreamed(ResultSet *set) {
+	ASSERT(set->streaming);
+
+	bool error = ErrorCtx_EncounteredError();
+
+	// rows accumulated after an error are discarded
+	if(error) {
+		if(!set->retain_rows) _ResultSet_FreeCells(set);
+	} else {
+		set->elements_emitted += _ResultSet_EmitCells(set);
+		set->rows_emitted += DataBlock_ItemCount(set->cells) / set->column_count;
+	}
+	RedisModule_ReplySetArrayLength(set->ctx, set->elements_emitted);
+
+	_ResultSet_ReplayStats(set->ctx, set);
+
+	// the header and part of the records were already emitted
+	// report a run-time error after the statistics
+	long len = 3;
+	if(error) {
+		ErrorCtx_EmitException();
+		len++;
+	}
+	RedisModule_ReplySetArrayLength(set->ctx, len);
+}
+
 void ResultSet_Reply(ResultSet *set) {
-	uint64_t row_count = ResultSet_RowCount(set);
+	if(set->streaming) {
+		_ResultSet_ReplyStreamed(set);
+		return;
+	}
+
 	/* Check to see if we've encountered a run-time error.
 	 * If so, emit it as the only response. */
 	if(ErrorCtx_EncounteredError()) {
@@ -221,25 +371,81 @@ void ResultSet_Reply(ResultSet *set) {
 	}
 
 	// Set up the results array and emit the header if the query requires one.
-	_ResultSet_ReplyWithPreamble(set);
+	_ResultSet_ReplyWithPreamble(set->ctx, set);
 
 	// Emit the records cached in the result set.
 	if(set->column_count > 0) {
-		RedisModule_ReplyWithArray(set->ctx, row_count);
-		SIValue *row[set->column_count];
-		uint64_t cells = DataBlock_ItemCount(set->cells);
-		for(uint64_t i = 0; i < cells; i += set->column_count) {
-			for(uint j = 0; j < set->column_count; j++) {
-				row[j] = DataBlock_GetItem(set->cells, i + j);
-			}
+		RedisModule_ReplyWithArray(set->ctx, _ResultSet_ElementCount(set));
+		_ResultSet_EmitCells(set);
+	}
 
-			set->formatter->EmitRow(set->ctx, set->gc, row, set->column_count);
+	_ResultSet_ReplayStats(set->ctx, set); // The last response is query statistics.
+}
 
-			for(uint j = 0; j < set->column_count; j++) SIValue_Free(*row[j]);
+// returns true if 'v' references a graph entity
+// entities are resolved against the graph while being replied
+static bool _ResultSet_ReferencesGraph(SIValue v) {
+	switch(SI_TYPE(v)) {
+	case T_NODE:
+	case T_EDGE:
+	case T_PATH:
+		return true;
+	case T_ARRAY: {
+		uint32_t n = SIArray_Length(v);
+		for(uint32_t i = 0; i < n; i++) {
+			if(_ResultSet_ReferencesGraph(SIArray_Get(v, i))) return true;
 		}
+		return false;
 	}
+	case T_MAP: {
+		uint n = Map_KeyCount(v);
+		for(uint i = 0; i < n; i++) {
+			SIValue key;
+			SIValue val;
+			Map_GetIdx(v, i, &key, &val);
+			if(_ResultSet_ReferencesGraph(val)) return true;
+		}
+		return false;
+	}
+	default:
+		return false;
+	}
+}
 
-	_ResultSet_ReplayStats(set->ctx, set); // The last response is query statistics.
+bool ResultSet_Detach(ResultSet *set) {
+	ASSERT(set != NULL);
+
+	uint64_t cells = DataBlock_ItemCount(set->cells);
+	for(uint64_t i = 0; i < cells; i++) {
+		SIValue *cell = DataBlock_GetItem(set->cells, i);
+		if(_ResultSet_ReferencesGraph(*cell)) return false;
+
+		// strings in memory-mapped storage are owned by the graph
+		if(cell->allocation == M_EXTERN) *cell = SI_CloneValue(*cell);
+	}
+
+	return true;
+}
+
+void ResultSet_RetainRows(ResultSet *set) {
+	ASSERT(set != NULL);
+	// streamed rows are released as soon as they are sent
+	ASSERT(!set->streaming);
+	set->retain_rows = true;
+}
+
+void ResultSet_ReplyCached(const ResultSet *set, RedisModuleCtx *ctx) {
+	ASSERT(set != NULL);
+	ASSERT(set->retain_rows);
+
+	_ResultSet_ReplyWithPreamble(ctx, set);
+
+	if(set->column_count > 0) {
+		RedisModule_ReplyWithArray(ctx, _ResultSet_ElementCount(set));
+		_ResultSet_EmitRows(ctx, set);
+	}
+
+	_ResultSet_ReplayStats(ctx, set);
 }
 
 /* Report execution timing. */
@@ -256,7 +462,10 @@ void ResultSet_Free(ResultSet *set) {
 
 	if(set->columns) array_free(set->columns);
 	if(set->columns_record_map) rm_free(set->columns_record_map);
-	if(set->cells) DataBlock_Free(set->cells);
+	if(set->cells) {
+		if(set->retain_rows) _ResultSet_FreeCells(set);
+		DataBlock_Free(set->cells);
+	}
 
 	rm_free(set);
 }
@@ -22,9 +22,14 @@ typedef struct {
 	const char **columns;           /* Field names for each column of results. */
 	uint *columns_record_map;       /* Mapping between column name and record index.*/
 	DataBlock *cells;               /* Accumulated cells */
+	uint64_t chunk_size;            /* Rows buffered before streaming, 0 buffers all. */
+	uint64_t rows_emitted;          /* Number of rows already streamed to the client. */
+	uint64_t elements_emitted;      /* Number of records array elements streamed. */
+	bool streaming;                 /* True once the reply preamble was emitted. */
+	bool retain_rows;               /* Keep rows after reply, see ResultSet_RetainRows. */
 	double timer[2];                /* Query runtime tracker. */
 	ResultSetStatistics stats;      /* ResultSet statistics. */
-	ResultSetFormatterType format;  /* Result-set format; compact/verbose/nop. */
+	ResultSetFormatterType format;  /* Result-set format; compact/verbose/arrow/json/nop. */
 	ResultSetFormatter *formatter;  /* ResultSet data formatter. */
 } ResultSet;
 
@@ -41,10 +46,26 @@ void ResultSet_IndexCreated(ResultSet *set, int status_code);
 
 void ResultSet_IndexDeleted(ResultSet *set, int status_code);
 
+void ResultSet_ConstraintCreated(ResultSet *set, bool created);
+
+void ResultSet_ConstraintDeleted(ResultSet *set, bool deleted);
+
 void ResultSet_CachedExecution(ResultSet *set);
 
 void ResultSet_Reply(ResultSet *set);
 
+// materialize buffered rows such that they can be replied without holding
+// the graph lock, returns false if rows reference graph entities
+// e.g. nodes, edges and paths, which are resolved while replying
+bool ResultSet_Detach(ResultSet *set);
+
+// keep buffered rows once replied, allowing the result-set
+// to be replayed by ResultSet_ReplyCached, must not be streaming
+void ResultSet_RetainRows(ResultSet *set);
+
+// replay a replied result-set which retained its rows to 'ctx'
+void ResultSet_ReplyCached(const ResultSet *set, RedisModuleCtx *ctx);
+
 void ResultSet_ReportQueryRuntime(RedisModuleCtx *ctx);
 
 void ResultSet_Free(ResultSet *set);
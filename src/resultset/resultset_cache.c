@@ -0,0 +1,35 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "resultset_cache.h"
+#include "RG.h"
+#include "../util/rmalloc.h"
+
+CachedResultSet *CachedResultSet_New(ResultSet *set) {
+	ASSERT(set != NULL);
+	ASSERT(set->retain_rows);
+
+	CachedResultSet *cached = rm_malloc(sizeof(CachedResultSet));
+	cached->set = set;
+	cached->ref_count = 1;
+
+	return cached;
+}
+
+CachedResultSet *CachedResultSet_Share(CachedResultSet *cached) {
+	ASSERT(cached != NULL);
+	__atomic_fetch_add(&cached->ref_count, 1, __ATOMIC_RELAXED);
+	return cached;
+}
+
+void CachedResultSet_Release(CachedResultSet *cached) {
+	ASSERT(cached != NULL);
+	if(__atomic_sub_fetch(&cached->ref_count, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	ResultSet_Free(cached->set);
+	rm_free(cached);
+}
+
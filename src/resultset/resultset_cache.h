@@ -0,0 +1,28 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "resultset.h"
+
+// a replied result-set shared between the result cache
+// and the queries replaying it
+typedef struct {
+	ResultSet *set;  // result-set retaining its rows
+	int ref_count;   // number of references to this cached result-set
+} CachedResultSet;
+
+// wraps 'set' taking ownership over it, the returned reference is owned
+// by the caller, 'set' must retain its rows, see ResultSet_RetainRows
+CachedResultSet *CachedResultSet_New(ResultSet *set);
+
+// returns a new reference to 'cached'
+CachedResultSet *CachedResultSet_Share(CachedResultSet *cached);
+
+// releases a reference to 'cached'
+// the result-set is freed once the last reference is released
+void CachedResultSet_Release(CachedResultSet *cached);
+
@@ -14,6 +14,8 @@ bool ResultSetStat_IndicateModification(ResultSetStatistics stats) {
 			|| stats.nodes_deleted > 0
 			|| stats.relationships_deleted > 0
 			|| stats.indices_created > 0
-			|| stats.indices_deleted > 0);
+			|| stats.indices_deleted > 0
+			|| stats.constraints_created > 0
+			|| stats.constraints_deleted > 0);
 }
 
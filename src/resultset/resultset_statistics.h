@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <stdbool.h>
 #define STAT_NOT_SET -1
 
@@ -18,7 +19,10 @@ typedef struct {
 	int relationships_deleted;  // number of edges removed as part of a delete query
 	int indices_created;        // number of indices created
 	int indices_deleted;        // number of indices deleted
+	int constraints_created;    // number of constraints created
+	int constraints_deleted;    // number of constraints deleted
 	bool cached;                // indication for a cached query execution
+	uint64_t commit_seq;        // graph commit sequence once modifications committed
 } ResultSetStatistics;
 
 // Checks to see if resultset-statistics indicate that a modification was made
@@ -0,0 +1,302 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "schema.h"
+#include "constraint.h"
+#include "../errors.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
+#include "../ast/ast_shared.h"
+#include "../graph/graphcontext.h"
+
+// orders checks by label, constraint and value
+static inline int _CompareValues
+(
+	const ConstraintCheck *a,
+	const ConstraintCheck *b
+) {
+	if(a->label_id != b->label_id) return a->label_id - b->label_id;
+	if(a->c != b->c) return (a->c < b->c) ? -1 : 1;
+	return SIValue_Compare(a->v, b->v, NULL);
+}
+
+// orders checks by label, constraint and node ID
+static inline int _CompareNodes
+(
+	const ConstraintCheck *a,
+	const ConstraintCheck *b
+) {
+	if(a->label_id != b->label_id) return a->label_id - b->label_id;
+	if(a->c != b->c) return (a->c < b->c) ? -1 : 1;
+	if(a->id == b->id) return 0;
+	return (a->id < b->id) ? -1 : 1;
+}
+
+#define VALUE_ISLT(a, b) (_CompareValues((a), (b)) < 0)
+#define NODE_ISLT(a, b) (_CompareNodes((a), (b)) < 0)
+
+static void _MissingValueError
+(
+	const ConstraintCheck *check
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchemaByID(gc, check->label_id, SCHEMA_NODE);
+	ErrorCtx_SetError("Node with label '%s' must have property '%s'",
+			Schema_GetName(s), check->c->attr_name);
+}
+
+static void _DuplicateValueError
+(
+	const ConstraintCheck *check
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	Schema *s = GraphContext_GetSchemaByID(gc, check->label_id, SCHEMA_NODE);
+
+	size_t len = 64;
+	size_t written = 0;
+	char *buf = rm_malloc(len);
+	SIValue_ToString(check->v, &buf, &len, &written);
+	ErrorCtx_SetError("Node with label '%s' and property '%s' = %s already exists",
+			Schema_GetName(s), check->c->attr_name, buf);
+	rm_free(buf);
+}
+
+// returns true if 'n' holds 'v' under the checked attribute
+static inline bool _HoldsValue
+(
+	Graph *g,
+	EntityID id,
+	const ConstraintCheck *check
+) {
+	Node n = GE_NEW_NODE();
+	if(!Graph_GetNode(g, id, &n)) return false;
+
+	SIValue *v = GraphEntity_GetProperty((GraphEntity *)&n, check->c->attr);
+	return v != PROPERTY_NOTFOUND && SIValue_Compare(*v, check->v, NULL) == 0;
+}
+
+// collects the IDs of nodes which may hold the checked value
+// out of the label's exact-match index, or all of the label's nodes
+// if the index can't look the value up
+static EntityID *_Candidates
+(
+	Graph *g,
+	Schema *s,
+	const ConstraintCheck *check
+) {
+	SIValue v = check->v;
+	Attribute_ID attr = check->c->attr;
+	EntityID *ids = array_new(EntityID, 1);
+
+	Index *idx = Schema_GetIndex(s, &attr, IDX_EXACT_MATCH);
+	if(idx != NULL && !Index_Enabled(idx)) idx = NULL;
+
+	// the index must reflect the query's own modifications
+	if(idx != NULL) QueryCtx_ApplyIndexChanges();
+
+	const EntityID *id;
+	if(idx != NULL && idx->native != NULL && NativeIndex_SupportedValue(v)) {
+		NativeIndexIterator *it;
+		if(SI_TYPE(v) & SI_NUMERIC) {
+			NumericRange *range = NumericRange_New();
+			NumericRange_TightenRange(range, OP_EQUAL, SI_GET_NUMERIC(v));
+			it = NativeIndex_NumericRange(idx->native, attr, range);
+			NumericRange_Free(range);
+		} else {
+			StringRange *range = StringRange_New();
+			StringRange_TightenRange(range, OP_EQUAL, v.stringval);
+			it = NativeIndex_StringRange(idx->native, attr, range);
+			StringRange_Free(range);
+		}
+
+		while((id = NativeIndexIterator_Next(it)) != NULL) {
+			array_append(ids, *id);
+		}
+		NativeIndexIterator_Free(it);
+	} else if(idx != NULL && (SI_TYPE(v) & (SI_NUMERIC | T_STRING | T_BOOL))) {
+		RSQNode *node;
+		const char *field = check->c->attr_name;
+		if(SI_TYPE(v) == T_STRING) {
+			node = RediSearch_CreateTagNode(idx->idx, field);
+			RediSearch_QueryNodeAddChild(node,
+					RediSearch_CreateTokenNode(idx->idx, field, v.stringval));
+		} else {
+			double d = SI_GET_NUMERIC(v);
+			node = RediSearch_CreateNumericNode(idx->idx, field, d, d, true,
+					true);
+		}
+
+		RSResultsIterator *it = RediSearch_GetResultsIterator(node, idx->idx);
+		while((id = RediSearch_ResultsIteratorNext(it, idx->idx, NULL)) != NULL) {
+			array_append(ids, *id);
+		}
+		RediSearch_ResultsIteratorFree(it);
+	} else {
+		RG_Matrix L = Graph_GetLabelMatrix(g, check->label_id);
+		RG_MatrixTupleIter it;
+		RG_MatrixTupleIter_reuse(&it, L);
+		RG_MatrixTupleIter_iterate_range(&it, 0, UINT64_MAX);
+
+		EntityID node_id;
+		bool depleted = false;
+		while(true) {
+			RG_MatrixTupleIter_next(&it, NULL, &node_id, NULL, &depleted);
+			if(depleted) break;
+			array_append(ids, node_id);
+		}
+	}
+
+	return ids;
+}
+
+// returns true if 'check' is part of 'nodes', sorted by NODE_ISLT
+static bool _Checked
+(
+	const ConstraintCheck *nodes,
+	uint n,
+	const ConstraintCheck *check
+) {
+	int lo = 0;
+	int hi = (int)n - 1;
+	while(lo <= hi) {
+		int mid = lo + (hi - lo) / 2;
+		int cmp = _CompareNodes(nodes + mid, check);
+		if(cmp == 0) return true;
+		if(cmp < 0) lo = mid + 1;
+		else hi = mid - 1;
+	}
+	return false;
+}
+
+// validates checks against their constraints and against each other
+// nodes outside of 'checks' are consulted only if 'probe' is set
+static bool _ValidateChecks
+(
+	ConstraintCheck *checks,
+	uint n,
+	bool probe
+) {
+	bool valid = true;
+	ConstraintCheck *unique = array_new(ConstraintCheck, 0);
+
+	for(uint i = 0; i < n; i++) {
+		ConstraintCheck *check = checks + i;
+		if(SIValue_IsNull(check->v)) {
+			if(check->c->t == CT_EXISTS) {
+				_MissingValueError(check);
+				valid = false;
+				goto cleanup;
+			}
+			continue;
+		}
+		if(check->c->t == CT_UNIQUE) array_append(unique, *check);
+	}
+
+	// checks sharing a value are adjacent once sorted
+	uint unique_count = array_len(unique);
+	QSORT(ConstraintCheck, unique, unique_count, VALUE_ISLT);
+	for(uint i = 1; i < unique_count; i++) {
+		if(_CompareValues(unique + i - 1, unique + i) == 0) {
+			_DuplicateValueError(unique + i);
+			valid = false;
+			goto cleanup;
+		}
+	}
+
+	if(!probe || unique_count == 0) goto cleanup;
+
+	// a node holding a checked value conflicts with the check
+	// unless the node is checked itself, in which case its value is replaced
+	ConstraintCheck *nodes = array_new(ConstraintCheck, unique_count);
+	for(uint i = 0; i < unique_count; i++) {
+		if(unique[i].id != INVALID_ENTITY_ID) array_append(nodes, unique[i]);
+	}
+	uint node_count = array_len(nodes);
+	QSORT(ConstraintCheck, nodes, node_count, NODE_ISLT);
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	for(uint i = 0; i < unique_count && valid; i++) {
+		ConstraintCheck *check = unique + i;
+		Schema *s = GraphContext_GetSchemaByID(gc, check->label_id,
+				SCHEMA_NODE);
+		ASSERT(s != NULL);
+
+		EntityID *ids = _Candidates(gc->g, s, check);
+		uint id_count = array_len(ids);
+		for(uint j = 0; j < id_count; j++) {
+			ConstraintCheck holder = *check;
+			holder.id = ids[j];
+			if(holder.id == check->id) continue;
+			if(_Checked(nodes, node_count, &holder)) continue;
+			if(!_HoldsValue(gc->g, holder.id, check)) continue;
+
+			_DuplicateValueError(check);
+			valid = false;
+			break;
+		}
+		array_free(ids);
+	}
+
+	array_free(nodes);
+
+cleanup:
+	array_free(unique);
+	return valid;
+}
+
+bool Constraint_Validate
+(
+	ConstraintCheck *checks,
+	uint n
+) {
+	ASSERT(checks != NULL || n == 0);
+
+	return _ValidateChecks(checks, n, true);
+}
+
+bool Constraint_Holds
+(
+	int label_id,
+	const Constraint *c
+) {
+	ASSERT(c != NULL);
+
+	Graph *g = QueryCtx_GetGraph();
+	RG_Matrix L = Graph_GetLabelMatrix(g, label_id);
+	RG_MatrixTupleIter it;
+	RG_MatrixTupleIter_reuse(&it, L);
+	RG_MatrixTupleIter_iterate_range(&it, 0, UINT64_MAX);
+
+	ConstraintCheck *checks = array_new(ConstraintCheck, 0);
+	while(true) {
+		EntityID id;
+		bool depleted = false;
+		RG_MatrixTupleIter_next(&it, NULL, &id, NULL, &depleted);
+		if(depleted) break;
+
+		Node n = GE_NEW_NODE();
+		Graph_GetNode(g, id, &n);
+		// values are held until all of them are checked
+		ConstraintCheck check = {
+			.label_id  =  label_id,
+			.c         =  c,
+			.id        =  id,
+			.v         =  GraphEntity_GetPropertyValue((GraphEntity *)&n, c->attr),
+		};
+		array_append(checks, check);
+	}
+
+	// all of the label's nodes are checked, no need to probe the index
+	uint check_count = array_len(checks);
+	bool holds = _ValidateChecks(checks, check_count, false);
+	for(uint i = 0; i < check_count; i++) SIValue_Free(checks[i].v);
+	array_free(checks);
+
+	return holds;
+}
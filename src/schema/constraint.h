@@ -0,0 +1,55 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../value.h"
+#include "../graph/entities/graph_entity.h"
+
+// constraints are persisted amid a schema's indices
+// under a tag no IndexType takes
+#define CONSTRAINT_ENCODING_TAG 64
+
+typedef enum {
+	CT_UNIQUE,  // no two nodes share a value, nodes may miss the attribute
+	CT_EXISTS,  // every node holds the attribute
+} ConstraintType;
+
+// constraint over a single attribute of a node label
+// unique constraints are enforced through the label's exact-match index
+typedef struct {
+	ConstraintType t;   // constraint type
+	Attribute_ID attr;  // constrained attribute
+	char *attr_name;    // constrained attribute name
+} Constraint;
+
+// prospective value of a constrained attribute of a node
+// which is about to be created or updated
+typedef struct {
+	int label_id;         // constrained label
+	const Constraint *c;  // checked constraint
+	EntityID id;          // node ID, INVALID_ENTITY_ID for nodes yet to be created
+	SIValue v;            // prospective value, NULL if the attribute is missing
+} ConstraintCheck;
+
+// validates prospective values against their constraints
+// against each other and against the values held by nodes
+// which aren't part of 'checks'
+// a node contributes at most one check per label and constraint
+// returns false and sets an error if a constraint is violated
+bool Constraint_Validate
+(
+	ConstraintCheck *checks,  // checks to validate
+	uint n                    // number of checks
+);
+
+// returns true if the nodes of 'label_id' satisfy 'c'
+// sets an error otherwise
+bool Constraint_Holds
+(
+	int label_id,        // constrained label
+	const Constraint *c  // constraint to verify
+);
@@ -24,6 +24,8 @@ Schema *Schema_New
 	s->type         =  type;
 	s->index        =  NULL;
 	s->fulltextIdx  =  NULL;
+	s->vectorIdx    =  NULL;
+	s->constraints  =  array_new(Constraint, 0);
 	s->name         =  rm_strdup(name);
 
 	return s;
@@ -53,7 +55,7 @@ int Schema_GetID(const Schema *s) {
 
 bool Schema_HasIndices(const Schema *s) {
 	ASSERT(s);
-	return (s->fulltextIdx || s->index);
+	return (s->fulltextIdx || s->index || s->vectorIdx);
 }
 
 unsigned short Schema_IndexCount
@@ -65,6 +67,7 @@ unsigned short Schema_IndexCount
 
 	if(s->index) n += 1;
 	if(s->fulltextIdx) n += 1;
+	if(s->vectorIdx) n += 1;
 
 	return n;
 }
@@ -93,6 +96,12 @@ Index *Schema_GetIndex
 			return NULL;
 		}
 		return s->fulltextIdx;
+	} else if(type == IDX_VECTOR) {
+		if(s->vectorIdx == NULL ||
+		   (attribute_id && !Index_ContainsAttribute(s->vectorIdx, *attribute_id))) {
+			return NULL;
+		}
+		return s->vectorIdx;
 	} else if(type == IDX_ANY && attribute_id) {
 		// if an attribute was specified
 		// return the first index that contains it
@@ -102,10 +111,14 @@ Index *Schema_GetIndex
 		if(s->fulltextIdx && Index_ContainsAttribute(s->fulltextIdx, *attribute_id)) {
 			return s->fulltextIdx;
 		}
+		if(s->vectorIdx && Index_ContainsAttribute(s->vectorIdx, *attribute_id)) {
+			return s->vectorIdx;
+		}
 	} else if(type == IDX_ANY && attribute_id == NULL) {
 		// if no attribute was specified, return the first extant index
 		if(s->index) return s->index;
 		if(s->fulltextIdx) return s->fulltextIdx;
+		if(s->vectorIdx) return s->vectorIdx;
 	}
 
 	return NULL;
@@ -136,6 +149,7 @@ int Schema_AddIndex
 
 		_idx = Index_New(s->name, s->id, type, entity_type);
 		if(type == IDX_FULLTEXT) s->fulltextIdx = _idx;
+		else if(type == IDX_VECTOR) s->vectorIdx = _idx;
 		else s->index = _idx;
 
 		// introduce edge src and dest node ids
@@ -194,6 +208,21 @@ static int _Schema_RemoveFullTextIndex
 	return INDEX_OK;
 }
 
+static int _Schema_RemoveVectorIndex
+(
+	Schema *s
+) {
+	ASSERT(s != NULL);
+
+	Index *idx = Schema_GetIndex(s, NULL, IDX_VECTOR);
+	if(idx == NULL) return INDEX_FAIL;
+
+	Index_Free(idx);
+	s->vectorIdx = NULL;
+
+	return INDEX_OK;
+}
+
 int Schema_RemoveIndex
 (
 	Schema *s,
@@ -207,12 +236,15 @@ int Schema_RemoveIndex
 			return _Schema_RemoveFullTextIndex(s);
 		case IDX_EXACT_MATCH:
 			return _Schema_RemoveExactMatchIndex(s, field);
+		case IDX_VECTOR:
+			return _Schema_RemoveVectorIndex(s);
 		default:
 			return INDEX_FAIL;
 	}
 }
 
 // index node under all schema indices
+// the node is indexed once the query's index changes are applied
 void Schema_AddNodeToIndices
 (
 	const Schema *s,
@@ -222,15 +254,20 @@ void Schema_AddNodeToIndices
 	ASSERT(n != NULL);
 
 	Index *idx = NULL;
+	IndexChanges *changes = QueryCtx_GetIndexChanges();
 
 	idx = s->fulltextIdx;
-	if(idx) Index_IndexNode(idx, n);
+	if(idx) IndexChanges_IndexNode(changes, idx, n);
 
 	idx = s->index;
-	if(idx) Index_IndexNode(idx, n);
+	if(idx) IndexChanges_IndexNode(changes, idx, n);
+
+	idx = s->vectorIdx;
+	if(idx) IndexChanges_IndexNode(changes, idx, n);
 }
 
 // index edge under all schema indices
+// the edge is indexed once the query's index changes are applied
 void Schema_AddEdgeToIndices
 (
 	const Schema *s,
@@ -240,12 +277,78 @@ void Schema_AddEdgeToIndices
 	ASSERT(e != NULL);
 
 	Index *idx = NULL;
+	IndexChanges *changes = QueryCtx_GetIndexChanges();
 
 	idx = s->fulltextIdx;
-	if(idx) Index_IndexEdge(idx, e);
+	if(idx) IndexChanges_IndexEdge(changes, idx, e);
 
 	idx = s->index;
-	if(idx) Index_IndexEdge(idx, e);
+	if(idx) IndexChanges_IndexEdge(changes, idx, e);
+}
+
+bool Schema_AddConstraint
+(
+	Schema *s,
+	ConstraintType t,
+	Attribute_ID attr,
+	const char *attr_name
+) {
+	ASSERT(s         != NULL);
+	ASSERT(attr_name != NULL);
+	ASSERT(attr      != ATTRIBUTE_NOTFOUND);
+
+	if(Schema_GetConstraint(s, t, attr) != NULL) return false;
+
+	Constraint c = {.t = t, .attr = attr, .attr_name = rm_strdup(attr_name)};
+	array_append(s->constraints, c);
+
+	return true;
+}
+
+bool Schema_RemoveConstraint
+(
+	Schema *s,
+	ConstraintType t,
+	Attribute_ID attr
+) {
+	ASSERT(s != NULL);
+
+	uint count = array_len(s->constraints);
+	for(uint i = 0; i < count; i++) {
+		Constraint *c = s->constraints + i;
+		if(c->t != t || c->attr != attr) continue;
+
+		rm_free(c->attr_name);
+		array_del(s->constraints, i);
+		return true;
+	}
+
+	return false;
+}
+
+const Constraint *Schema_GetConstraint
+(
+	const Schema *s,
+	ConstraintType t,
+	Attribute_ID attr
+) {
+	ASSERT(s != NULL);
+
+	uint count = array_len(s->constraints);
+	for(uint i = 0; i < count; i++) {
+		const Constraint *c = s->constraints + i;
+		if(c->t == t && c->attr == attr) return c;
+	}
+
+	return NULL;
+}
+
+uint Schema_ConstraintCount
+(
+	const Schema *s
+) {
+	ASSERT(s != NULL);
+	return array_len(s->constraints);
 }
 
 void Schema_Free
@@ -259,6 +362,14 @@ void Schema_Free
 	// Free indicies.
 	if(s->index) Index_Free(s->index);
 	if(s->fulltextIdx) Index_Free(s->fulltextIdx);
+	if(s->vectorIdx) Index_Free(s->vectorIdx);
+
+	// free constraints
+	uint constraint_count = array_len(s->constraints);
+	for(uint i = 0; i < constraint_count; i++) {
+		rm_free(s->constraints[i].attr_name);
+	}
+	array_free(s->constraints);
 
 	rm_free(s);
 }
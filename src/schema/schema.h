@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../redismodule.h"
+#include "constraint.h"
 #include "../index/index.h"
 #include "rax.h"
 #include "redisearch_api.h"
@@ -26,6 +27,8 @@ typedef struct {
 	SchemaType type;      // schema type (node/edge)
 	Index *index;         // exact match index
 	Index *fulltextIdx;   // full-text index
+	Index *vectorIdx;     // vector index
+	Constraint *constraints;  // constraints over the schema's attributes
 } Schema;
 
 // creates a new schema
@@ -47,7 +50,7 @@ const char *Schema_GetName
 	const Schema *s
 );
 
-// returns true if schema has either a full-text or exact-match index
+// returns true if schema has either a full-text, exact-match or vector index
 bool Schema_HasIndices
 (
 	const Schema *s
@@ -100,6 +103,40 @@ void Schema_AddEdgeToIndices
 	const Edge *e
 );
 
+// adds constraint 't' over 'attr'
+// returns false if the constraint already exists
+bool Schema_AddConstraint
+(
+	Schema *s,
+	ConstraintType t,
+	Attribute_ID attr,
+	const char *attr_name
+);
+
+// removes constraint 't' over 'attr'
+// returns false if there's no such constraint
+bool Schema_RemoveConstraint
+(
+	Schema *s,
+	ConstraintType t,
+	Attribute_ID attr
+);
+
+// retrieves constraint 't' over 'attr'
+// returns NULL if there's no such constraint
+const Constraint *Schema_GetConstraint
+(
+	const Schema *s,
+	ConstraintType t,
+	Attribute_ID attr
+);
+
+// returns number of constraints in schema
+uint Schema_ConstraintCount
+(
+	const Schema *s
+);
+
 // Free schema
 void Schema_Free
 (
@@ -0,0 +1,231 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "aof_rewrite.h"
+#include "../effects/effects.h"
+
+// an edge and its endpoints as stored by a relation matrix
+typedef struct {
+	EdgeID id;    // edge ID
+	NodeID src;   // source node ID
+	NodeID dest;  // destination node ID
+	int r;        // relationship type ID
+} EdgeConnection;
+
+#define EDGE_ISLT(a,b) ((a)->id < (b)->id)
+
+// rewrite state, accumulates effects into chunks
+typedef struct {
+	RedisModuleIO *aof;          // AOF to emit commands to
+	RedisModuleString *key;      // graph key
+	EffectsBuffer *buff;         // pending effects
+	uint64_t chunk_size;         // max number of entities per command
+	uint64_t entity_count;       // number of entities in pending effects
+	bool emitted;                // at least one command was emitted
+} AofRewriteCtx;
+
+// emit pending effects as a single GRAPH.EFFECT command
+static void _EmitEffects
+(
+	AofRewriteCtx *ctx
+) {
+	EffectsBuffer *buff = ctx->buff;
+
+	if(EffectsBuffer_Valid(buff)) {
+		RedisModule_EmitAOF(ctx->aof, "GRAPH.EFFECT", "sb", ctx->key,
+				EffectsBuffer_Buffer(buff), EffectsBuffer_Length(buff));
+	} else {
+		// values which can't be encoded aren't persisted by RDB either
+		RedisModule_LogIOError(ctx->aof, "warning",
+				"graph entities containing unsupported values were not rewritten");
+	}
+
+	EffectsBuffer_Reset(buff);
+	ctx->entity_count = 0;
+	ctx->emitted      = true;
+}
+
+// account for an added entity, emit pending effects once chunk is full
+static inline void _EntityAdded
+(
+	AofRewriteCtx *ctx
+) {
+	ctx->entity_count++;
+	if(ctx->entity_count >= ctx->chunk_size) _EmitEffects(ctx);
+}
+
+// attributes and schemas are introduced in ID order
+// such that the loaded graph assigns them the same IDs
+static void _RewriteSchemas
+(
+	AofRewriteCtx *ctx,
+	GraphContext *gc
+) {
+	uint attr_count = GraphContext_AttributeCount(gc);
+	for(uint i = 0; i < attr_count; i++) {
+		EffectsBuffer_AddAttributeEffect(ctx->buff,
+				GraphContext_GetAttributeString(gc, i));
+	}
+
+	uint label_count = array_len(gc->node_schemas);
+	for(uint i = 0; i < label_count; i++) {
+		EffectsBuffer_AddSchemaEffect(ctx->buff, gc->node_schemas[i]);
+	}
+
+	uint relation_count = array_len(gc->relation_schemas);
+	for(uint i = 0; i < relation_count; i++) {
+		EffectsBuffer_AddSchemaEffect(ctx->buff, gc->relation_schemas[i]);
+	}
+}
+
+static void _RewriteNodes
+(
+	AofRewriteCtx *ctx,
+	GraphContext *gc
+) {
+	Graph *g = gc->g;
+	uint label_type_count = Graph_LabelTypeCount(g);
+	LabelID node_labels[label_type_count];
+	int labels[label_type_count];
+
+	Node n;
+	DataBlockIterator *iter = Graph_ScanNodes(g);
+	while((n.entity = (Entity *)DataBlockIterator_Next(iter, &n.id)) != NULL) {
+		uint label_count = Graph_GetNodeLabels(g, &n, node_labels,
+				label_type_count);
+		for(uint i = 0; i < label_count; i++) labels[i] = node_labels[i];
+
+		EffectsBuffer_AddCreateNodeEffect(ctx->buff, gc, &n, labels,
+				label_count);
+		_EntityAdded(ctx);
+	}
+	DataBlockIterator_Free(iter);
+}
+
+// collect edges from relation matrix 'r'
+static void _CollectEdges
+(
+	Graph *g,
+	int r,
+	EdgeConnection **edges
+) {
+	EdgeID     id;
+	GrB_Index  src;
+	GrB_Index  dest;
+	bool       depleted = false;
+
+	RG_Matrix M = Graph_GetRelationMatrix(g, r, false);
+	RG_MatrixTupleIter *it = NULL;
+	RG_MatrixTupleIter_new(&it, M);
+
+	while(true) {
+		RG_MatrixTupleIter_next(it, &src, &dest, &id, &depleted);
+		if(depleted) break;
+
+		EdgeConnection conn = {.src = src, .dest = dest, .r = r};
+		if(SINGLE_EDGE(id)) {
+			conn.id = id;
+			array_append(*edges, conn);
+		} else {
+			// multiple edges connecting src to dest
+			uint64_t edge_count;
+			const EdgeID *ids = RG_Matrix_multiEdgeIDs(M, id, &edge_count);
+			for(uint64_t i = 0; i < edge_count; i++) {
+				conn.id = ids[i];
+				array_append(*edges, conn);
+			}
+		}
+	}
+
+	RG_MatrixTupleIter_free(&it);
+}
+
+// edges are introduced in ID order such that loading them
+// reuses deleted IDs without searching the edges free list
+static void _RewriteEdges
+(
+	AofRewriteCtx *ctx,
+	GraphContext *gc
+) {
+	Graph *g = gc->g;
+	EdgeConnection *edges = array_new(EdgeConnection, Graph_EdgeCount(g));
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(int r = 0; r < relation_count; r++) _CollectEdges(g, r, &edges);
+
+	uint edge_count = array_len(edges);
+	QSORT(EdgeConnection, edges, edge_count, EDGE_ISLT);
+
+	for(uint i = 0; i < edge_count; i++) {
+		EdgeConnection *conn = edges + i;
+		Edge e;
+		int res = Graph_GetEdge(g, conn->id, &e);
+		ASSERT(res != 0);
+		UNUSED(res);
+
+		EffectsBuffer_AddCreateEdgeEffect(ctx->buff, gc, &e, conn->src,
+				conn->dest, conn->r);
+		_EntityAdded(ctx);
+	}
+
+	array_free(edges);
+}
+
+// indices are introduced last, each is populated once when loaded
+static void _RewriteIndices
+(
+	AofRewriteCtx *ctx,
+	GraphContext *gc
+) {
+	Schema **schemas[2] = {gc->node_schemas, gc->relation_schemas};
+	for(uint i = 0; i < 2; i++) {
+		uint schema_count = array_len(schemas[i]);
+		for(uint j = 0; j < schema_count; j++) {
+			Schema *s = schemas[i][j];
+			if(s->index != NULL) {
+				EffectsBuffer_AddIndexEffect(ctx->buff, s, s->index);
+			}
+			if(s->fulltextIdx != NULL) {
+				EffectsBuffer_AddIndexEffect(ctx->buff, s, s->fulltextIdx);
+			}
+			if(s->vectorIdx != NULL) {
+				EffectsBuffer_AddIndexEffect(ctx->buff, s, s->vectorIdx);
+			}
+		}
+	}
+}
+
+void AofRewriteGraph
+(
+	RedisModuleIO *aof,
+	RedisModuleString *key,
+	GraphContext *gc
+) {
+	ASSERT(gc  != NULL);
+	ASSERT(aof != NULL);
+	ASSERT(key != NULL);
+
+	AofRewriteCtx ctx = {
+		.aof          = aof,
+		.key          = key,
+		.buff         = EffectsBuffer_New(),
+		.entity_count = 0,
+		.emitted      = false,
+	};
+	Config_Option_get(Config_VKEY_MAX_ENTITY_COUNT, &ctx.chunk_size);
+	if(ctx.chunk_size == 0) ctx.chunk_size = UINT64_MAX;
+
+	_RewriteSchemas(&ctx, gc);
+	_RewriteNodes(&ctx, gc);
+	_RewriteEdges(&ctx, gc);
+	_RewriteIndices(&ctx, gc);
+
+	// an empty graph still requires a command to create its key
+	if(!ctx.emitted || !EffectsBuffer_Empty(ctx.buff)) _EmitEffects(&ctx);
+
+	EffectsBuffer_Free(ctx.buff);
+}
@@ -0,0 +1,18 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "serializers_include.h"
+
+// rewrite graph as a sequence of GRAPH.EFFECT commands
+// each command introduces up to VKEY_MAX_ENTITY_COUNT entities
+void AofRewriteGraph
+(
+	RedisModuleIO *aof,      // AOF to emit commands to
+	RedisModuleString *key,  // graph key
+	GraphContext *gc         // graph to rewrite
+);
@@ -16,9 +16,21 @@ GraphDecodeContext *GraphDecodeContext_New() {
 	ctx->graph_keys_count = 1;
 	ctx->meta_keys = raxNew();
 	ctx->multi_edge = NULL;
+	ctx->pending_edges = NULL;
 	return ctx;
 }
 
+static void _GraphDecodeContext_FreePendingEdges(GraphDecodeContext *ctx) {
+	if(ctx->pending_edges == NULL) return;
+
+	uint relation_count = array_len(ctx->pending_edges);
+	for(uint i = 0; i < relation_count; i++) {
+		array_free(ctx->pending_edges[i]);
+	}
+	array_free(ctx->pending_edges);
+	ctx->pending_edges = NULL;
+}
+
 void GraphDecodeContext_Reset(GraphDecodeContext *ctx) {
 	ASSERT(ctx);
 
@@ -29,6 +41,8 @@ void GraphDecodeContext_Reset(GraphDecodeContext *ctx) {
 		array_free(ctx->multi_edge);
 		ctx->multi_edge = NULL;
 	}
+
+	_GraphDecodeContext_FreePendingEdges(ctx);
 }
 
 void GraphDecodeContext_SetKeyCount(GraphDecodeContext *ctx, uint64_t key_count) {
@@ -75,6 +89,7 @@ bool GraphDecodeContext_GetProcessedKeyCount(const GraphDecodeContext *ctx) {
 
 void GraphDecodeContext_Free(GraphDecodeContext *ctx) {
 	if(ctx) {
+		_GraphDecodeContext_FreePendingEdges(ctx);
 		raxFree(ctx->meta_keys);
 		rm_free(ctx);
 	}
@@ -11,12 +11,22 @@
 #include "stdint.h"
 #include "rax.h"
 
+// A decoded edge connection.
+// Connections are collected per relationship type and introduced
+// to the relation matrices once all graph keys are decoded.
+typedef struct {
+	uint64_t src;   // Source node ID.
+	uint64_t dest;  // Destination node ID.
+	uint64_t id;    // Edge ID.
+} PendingEdge;
+
 // A struct that maintains the state of a graph decoding from RDB.
 typedef struct {
-	uint64_t keys_processed;    // Count the number of procssed graph keys.
-	uint64_t graph_keys_count;  // The number of keys representing the graph.
-	rax *meta_keys;             // The meta keys encountered so far in the decode process.
-	uint64_t *multi_edge;       // Is relation contains multi edge values.
+	uint64_t keys_processed;      // Count the number of procssed graph keys.
+	uint64_t graph_keys_count;    // The number of keys representing the graph.
+	rax *meta_keys;               // The meta keys encountered so far in the decode process.
+	uint64_t *multi_edge;         // Is relation contains multi edge values.
+	PendingEdge **pending_edges;  // Decoded connections per relation, pending matrix construction.
 } GraphDecodeContext;
 
 // Creates a new graph decoding context.
@@ -0,0 +1,229 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "decode_v12.h"
+
+// forward declarations
+static SIValue _RdbLoadPoint(RedisModuleIO *rdb);
+static SIValue _RdbLoadSIArray(RedisModuleIO *rdb);
+static SIValue _RdbLoadCompressedString(RedisModuleIO *rdb);
+
+static SIValue _RdbLoadSIValue
+(
+	RedisModuleIO *rdb
+) {
+	// Format:
+	// SIType
+	// Value
+	uint64_t tag = RedisModule_LoadUnsigned(rdb);
+	if(tag == COMPRESSED_STRING_ENCODING_TAG) {
+		return _RdbLoadCompressedString(rdb);
+	}
+
+	SIType t = tag;
+	switch(t) {
+	case T_INT64:
+		return SI_LongVal(RedisModule_LoadSigned(rdb));
+	case T_DOUBLE:
+		return SI_DoubleVal(RedisModule_LoadDouble(rdb));
+	case T_STRING:
+		// transfer ownership of the heap-allocated string to the
+		// newly-created SIValue
+		return SI_TransferStringVal(RedisModule_LoadStringBuffer(rdb, NULL));
+	case T_BOOL:
+		return SI_BoolVal(RedisModule_LoadSigned(rdb));
+	case T_ARRAY:
+		return _RdbLoadSIArray(rdb);
+	case T_POINT:
+		return _RdbLoadPoint(rdb);
+	case T_NULL:
+	default: // currently impossible
+		return SI_NullVal();
+	}
+}
+
+static SIValue _RdbLoadCompressedString
+(
+	RedisModuleIO *rdb
+) {
+	// Format:
+	// decompressed length
+	// compressed bytes
+	// loaded as is, without being recompressed
+	size_t len = RedisModule_LoadUnsigned(rdb);
+	size_t size;
+	char *data = RedisModule_LoadStringBuffer(rdb, &size);
+	char *cs = CompressedString_FromCompressed(data, size, len);
+	RedisModule_Free(data);
+
+	ASSERT(cs != NULL);
+	return (SIValue) {
+		.stringval = cs, .type = T_STRING, .allocation = M_COMPRESSED
+	};
+}
+
+static SIValue _RdbLoadPoint
+(
+	RedisModuleIO *rdb
+) {
+	double lat = RedisModule_LoadDouble(rdb);
+	double lon = RedisModule_LoadDouble(rdb);
+	return SI_Point(lat, lon);
+}
+
+static SIValue _RdbLoadSIArray
+(
+	RedisModuleIO *rdb
+) {
+	/* loads array as
+	   unsinged : array legnth
+	   array[0]
+	   .
+	   .
+	   .
+	   array[array length -1]
+	 */
+	uint arrayLen = RedisModule_LoadUnsigned(rdb);
+	SIValue list = SI_Array(arrayLen);
+	for(uint i = 0; i < arrayLen; i++) {
+		SIValue elem = _RdbLoadSIValue(rdb);
+		SIArray_Append(&list, elem);
+		SIValue_Free(elem);
+	}
+	return list;
+}
+
+static void _RdbLoadEntity
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	GraphEntity *e
+) {
+	// Format:
+	// #properties N
+	// (name, value type, value) X N
+
+	uint64_t propCount = RedisModule_LoadUnsigned(rdb);
+	if(propCount == 0) return;
+
+	// load all properties, then add them using a single allocation
+	// small property sets are staged on the stack
+	Attribute_ID _ids[16];
+	SIValue _values[16];
+	Attribute_ID *ids = _ids;
+	SIValue *values = _values;
+	if(propCount > 16) {
+		ids = rm_malloc(sizeof(Attribute_ID) * propCount);
+		values = rm_malloc(sizeof(SIValue) * propCount);
+	}
+	for(int i = 0; i < propCount; i++) {
+		ids[i] = RedisModule_LoadUnsigned(rdb);
+		values[i] = _RdbLoadSIValue(rdb);
+		GraphContext_PreparePropertyValue(gc, values + i);
+	}
+
+	GraphEntity_AddProperties(e, ids, values, propCount);
+	for(int i = 0; i < propCount; i++) SIValue_Free(values[i]);
+
+	if(ids != _ids) {
+		rm_free(ids);
+		rm_free(values);
+	}
+}
+
+void RdbLoadNodes_v12
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t node_count
+) {
+	// Node Format:
+	//      ID
+	//      #labels M
+	//      (labels) X M
+	//      #properties N
+	//      (name, value type, value) X N
+
+	for(uint64_t i = 0; i < node_count; i++) {
+		Node n;
+		NodeID id = RedisModule_LoadUnsigned(rdb);
+
+		// #labels M
+		uint64_t nodeLabelCount = RedisModule_LoadUnsigned(rdb);
+
+		// * (labels) x M
+		uint64_t labels[nodeLabelCount];
+		for(uint64_t i = 0; i < nodeLabelCount; i ++){
+			labels[i] = RedisModule_LoadUnsigned(rdb);
+		}
+
+		Serializer_Graph_SetNode(gc->g, id, labels, nodeLabelCount, &n);
+
+		_RdbLoadEntity(rdb, gc, (GraphEntity *)&n);
+
+		// introduce n to each relevant index
+		for (int i = 0; i < nodeLabelCount; i++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+			ASSERT(s != NULL);
+			if(s->index) Index_IndexNode(s->index, &n);
+			if(s->fulltextIdx) Index_IndexNode(s->fulltextIdx, &n);
+			if(s->vectorIdx) Index_IndexNode(s->vectorIdx, &n);
+		}
+	}
+
+	Serializer_Graph_SetNodeLabels(gc->g);
+}
+
+void RdbLoadDeletedNodes_v12
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_node_count
+) {
+	// Format:
+	// node id X N
+	for(uint64_t i = 0; i < deleted_node_count; i++) {
+		NodeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkNodeDeleted(gc->g, id);
+	}
+}
+
+void RdbLoadEdges_v12
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t edge_count
+) {
+	// Format:
+	// {
+	//  edge ID
+	//  edge properties
+	// } X N
+	//
+	// edge connections are introduced by the relation matrices
+
+	for(uint64_t i = 0; i < edge_count; i++) {
+		Edge e;
+		EdgeID edgeId = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_AllocEdge(gc->g, edgeId, INVALID_ENTITY_ID,
+				INVALID_ENTITY_ID, GRAPH_NO_RELATION, &e);
+		_RdbLoadEntity(rdb, gc, (GraphEntity *)&e);
+	}
+}
+
+void RdbLoadDeletedEdges_v12
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t deleted_edge_count
+) {
+	// Format:
+	// edge id X N
+	for(uint64_t i = 0; i < deleted_edge_count; i++) {
+		EdgeID id = RedisModule_LoadUnsigned(rdb);
+		Serializer_Graph_MarkEdgeDeleted(gc->g, id);
+	}
+}
@@ -0,0 +1,124 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "decode_v12.h"
+
+// restores the multiple edges referenced by 'Ax'
+// into the multi-edge table of relation matrix 'M'
+// returns the number of edges beyond a single edge per entry
+static uint64_t _RestoreMultipleEdges
+(
+	RG_Matrix M,              // relation matrix
+	uint64_t *Ax,             // matrix values
+	const uint64_t *entries,  // (position, #edges, edge IDs) entries
+	size_t n                  // number of uint64 elements in 'entries'
+) {
+	uint64_t additional_edges = 0;
+
+	size_t i = 0;
+	while(i < n) {
+		uint64_t pos        = entries[i++];
+		uint64_t edge_count = entries[i++];
+		ASSERT(i + edge_count <= n);
+
+		Ax[pos] = RG_Matrix_newMultiEdge(M, entries + i, edge_count);
+		i += edge_count;
+
+		additional_edges += edge_count - 1;
+	}
+
+	return additional_edges;
+}
+
+static void _RdbLoadRelationMatrix
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc
+) {
+	// Format:
+	//  relation type
+	//  #rows
+	//  #columns
+	//  #entries N
+	//  if N > 0:
+	//   is hypersparse
+	//   is iso
+	//   is jumbled
+	//   #vectors V (hypersparse only)
+	//   row indices (hypersparse only)
+	//   row pointers
+	//   column indices
+	//   values
+	//   multiple edges: (position, #edges M, edge ID X M) X K
+
+	GrB_Info info;
+	UNUSED(info);
+
+	int        r      =  RedisModule_LoadUnsigned(rdb);
+	GrB_Index  nrows  =  RedisModule_LoadUnsigned(rdb);
+	GrB_Index  ncols  =  RedisModule_LoadUnsigned(rdb);
+	GrB_Index  nvals  =  RedisModule_LoadUnsigned(rdb);
+
+	// empty relation, nothing to introduce
+	if(nvals == 0) return;
+
+	bool hyper   = RedisModule_LoadUnsigned(rdb);
+	bool iso     = RedisModule_LoadUnsigned(rdb);
+	bool jumbled = RedisModule_LoadUnsigned(rdb);
+
+	size_t     Ah_size  =  0;
+	size_t     Ap_size;
+	size_t     Aj_size;
+	size_t     Ax_size;
+	size_t     multiple_edges_size;
+	GrB_Index  nvec     =  nrows;
+	GrB_Index  *Ah      =  NULL;
+	GrB_Matrix A        =  NULL;
+
+	if(hyper) {
+		nvec = RedisModule_LoadUnsigned(rdb);
+		Ah = (GrB_Index *)RedisModule_LoadStringBuffer(rdb, &Ah_size);
+	}
+
+	// loaded buffers are allocated by the same allocator as GraphBLAS
+	// allowing them to be imported as is
+	GrB_Index *Ap = (GrB_Index *)RedisModule_LoadStringBuffer(rdb, &Ap_size);
+	GrB_Index *Aj = (GrB_Index *)RedisModule_LoadStringBuffer(rdb, &Aj_size);
+	uint64_t  *Ax = (uint64_t *)RedisModule_LoadStringBuffer(rdb, &Ax_size);
+	uint64_t  *multiple_edges = (uint64_t *)RedisModule_LoadStringBuffer(rdb,
+			&multiple_edges_size);
+
+	RG_Matrix M = Graph_GetRelationMatrix(gc->g, r, false);
+	uint64_t edge_count = nvals + _RestoreMultipleEdges(M, Ax, multiple_edges,
+			multiple_edges_size / sizeof(uint64_t));
+	RedisModule_Free(multiple_edges);
+
+	if(hyper) {
+		info = GxB_Matrix_import_HyperCSR(&A, GrB_UINT64, nrows, ncols, &Ap,
+				&Ah, &Aj, (void **)&Ax, Ap_size, Ah_size, Aj_size, Ax_size, iso,
+				nvec, jumbled, NULL);
+	} else {
+		info = GxB_Matrix_import_CSR(&A, GrB_UINT64, nrows, ncols, &Ap, &Aj,
+				(void **)&Ax, Ap_size, Aj_size, Ax_size, iso, jumbled, NULL);
+	}
+	ASSERT(info == GrB_SUCCESS);
+
+	Serializer_Graph_SetRelationMatrix(gc->g, r, &A, edge_count);
+}
+
+void RdbLoadRelationMatrices_v12
+(
+	RedisModuleIO *rdb,
+	GraphContext *gc,
+	uint64_t matrix_count
+) {
+	// Format:
+	// relation matrix X matrix_count
+
+	for(uint64_t i = 0; i < matrix_count; i++) {
+		_RdbLoadRelationMatrix(rdb, gc);
+	}
+}
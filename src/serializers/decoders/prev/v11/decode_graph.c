@@ -87,11 +87,15 @@ static GraphContext *_DecodeHeader
 		_InitGraphDataStructure(gc->g, node_count, edge_count, label_count, relation_count);
 
 		gc->decoding_context->multi_edge = array_new(uint64_t, relation_count);
+		gc->decoding_context->pending_edges = array_new(PendingEdge *,
+				relation_count);
 		for(uint i = 0; i < relation_count; i++) {
 			// enable/Disable support for multi-edge
 			// we will enable support for multi-edge on all relationship
 			// matrices once we finish loading the graph
 			array_append(gc->decoding_context->multi_edge,  multi_edge[i]);
+			array_append(gc->decoding_context->pending_edges,
+					array_new(PendingEdge, 0));
 		}
 
 		GraphDecodeContext_SetKeyCount(gc->decoding_context, key_number);
@@ -196,6 +200,19 @@ GraphContext *RdbLoadGraphContext_v11
 	if(GraphDecodeContext_Finished(gc->decoding_context)) {
 		Graph *g = gc->g;
 
+		// construct each relation matrix out of its decoded edges
+		// a single build is considerably cheaper than setting each entry
+		GraphDecodeContext *decoding_context = gc->decoding_context;
+		uint relation_count = Graph_RelationTypeCount(g);
+		for(uint i = 0; i < relation_count; i++) {
+			PendingEdge *edges = decoding_context->pending_edges[i];
+			Serializer_Graph_SetRelationEdges(g, decoding_context->multi_edge[i],
+					i, edges, array_len(edges));
+			// release edges as soon as possible
+			array_free(edges);
+			decoding_context->pending_edges[i] = NULL;
+		}
+
 		// revert to default synchronization behavior
 		Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
 		Graph_ApplyAllPending(g, true);
@@ -85,6 +85,7 @@ static void _RdbLoadEntity
 	for(int i = 0; i < propCount; i++) {
 		Attribute_ID attr_id = RedisModule_LoadUnsigned(rdb);
 		SIValue attr_value = _RdbLoadSIValue(rdb);
+		GraphContext_PreparePropertyValue(gc, &attr_value);
 		GraphEntity_AddProperty(e, attr_id, attr_value);
 		SIValue_Free(attr_value);
 	}
@@ -161,16 +162,18 @@ void RdbLoadEdges_v11
 	// } X N
 	// edge properties X N
 
-	// construct connections
+	// connections are introduced to the relation matrices
+	// once all graph keys are decoded
+	PendingEdge **pending_edges = gc->decoding_context->pending_edges;
 	for(uint64_t i = 0; i < edge_count; i++) {
 		Edge e;
 		EdgeID    edgeId    =  RedisModule_LoadUnsigned(rdb);
 		NodeID    srcId     =  RedisModule_LoadUnsigned(rdb);
 		NodeID    destId    =  RedisModule_LoadUnsigned(rdb);
 		uint64_t  relation  =  RedisModule_LoadUnsigned(rdb);
-		Serializer_Graph_SetEdge(gc->g,
-				gc->decoding_context->multi_edge[relation], edgeId, srcId,
-				destId, relation, &e);
+		Serializer_Graph_AllocEdge(gc->g, edgeId, srcId, destId, relation, &e);
+		PendingEdge pending = {.src = srcId, .dest = destId, .id = edgeId};
+		array_append(pending_edges[relation], pending);
 		_RdbLoadEntity(rdb, gc, (GraphEntity *)&e);
 
 		// index edge
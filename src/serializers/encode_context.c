@@ -48,6 +48,7 @@ void GraphEncodeContext_Reset(GraphEncodeContext *ctx) {
 	ctx->multiple_edges_array = NULL;
 	ctx->current_relation_matrix_id = 0;
 	ctx->multiple_edges_current_index = 0;
+	ctx->parallel_encoder = NULL;
 
 	Config_Option_get(Config_VKEY_MAX_ENTITY_COUNT, &ctx->vkey_entity_count);
 
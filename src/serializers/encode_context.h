@@ -17,13 +17,14 @@
 
 // Encoding states
 typedef enum {
-	ENCODE_STATE_INIT,          // encoding initial state
-	ENCODE_STATE_NODES,         // encoding nodes
-	ENCODE_STATE_DELETED_NODES, // encoding deleted nodes
-	ENCODE_STATE_EDGES,         // encoding edges
-	ENCODE_STATE_DELETED_EDGES, // encoding deleted edges
-	ENCODE_STATE_GRAPH_SCHEMA,  // encoding graph schemas
-	ENCODE_STATE_FINAL          // encoding final state
+	ENCODE_STATE_INIT,              // encoding initial state
+	ENCODE_STATE_NODES,             // encoding nodes
+	ENCODE_STATE_DELETED_NODES,     // encoding deleted nodes
+	ENCODE_STATE_EDGES,             // encoding edges
+	ENCODE_STATE_DELETED_EDGES,     // encoding deleted edges
+	ENCODE_STATE_GRAPH_SCHEMA,      // encoding graph schemas
+	ENCODE_STATE_RELATION_MATRICES, // encoding relation matrices
+	ENCODE_STATE_FINAL              // encoding final state
 } EncodeState;
 
 // Header information encoded for every payload
@@ -52,6 +53,7 @@ typedef struct {
 	uint multiple_edges_current_index;          // The current index of the encoded edges array.
 	DataBlockIterator *datablock_iterator;      // Datablock iterator to be saved in the context.
 	RG_MatrixTupleIter *matrix_tuple_iterator; // Matrix tuple iterator to be saved in the context.
+	struct ParallelEncoder *parallel_encoder;  // Concurrent encoder, NULL when encoding sequentially.
 } GraphEncodeContext;
 
 // Creates a new graph encoding context.
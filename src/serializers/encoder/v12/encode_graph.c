@@ -4,7 +4,8 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
-#include "encode_v11.h"
+#include "encode_v12.h"
+#include "encode_parallel.h"
 
 extern bool process_is_child; // Global variable declared in module.c
 
@@ -16,7 +17,7 @@ static inline bool _shouldAcquireLocks(void) {
 
 static void _RdbSaveHeader
 (
-	RedisModuleIO *rdb,
+	SerializerIO *io,
 	GraphContext *gc
 ) {
 	// Header format:
@@ -34,31 +35,31 @@ static void _RdbSaveHeader
 	GraphEncodeHeader *header = &(gc->encoding_context->header);
 
 	// graph name
-	RedisModule_SaveStringBuffer(rdb, header->graph_name, strlen(header->graph_name) + 1);
+	SerializerIO_WriteBuffer(io, header->graph_name, strlen(header->graph_name) + 1);
 
 	// node count
-	RedisModule_SaveUnsigned(rdb, header->node_count);
+	SerializerIO_WriteUnsigned(io, header->node_count);
 
 	// edge count
-	RedisModule_SaveUnsigned(rdb, header->edge_count);
+	SerializerIO_WriteUnsigned(io, header->edge_count);
 
 	// label matrix count
-	RedisModule_SaveUnsigned(rdb, header->label_matrix_count);
+	SerializerIO_WriteUnsigned(io, header->label_matrix_count);
 
 	// relation matrix count
-	RedisModule_SaveUnsigned(rdb, header->relationship_matrix_count);
+	SerializerIO_WriteUnsigned(io, header->relationship_matrix_count);
 
 	// does relationship Ri holds mutiple edges under a single entry X N
 	for(int i = 0; i < header->relationship_matrix_count; i++) {
 		// true if R[i] contain a multi edge entry
-		RedisModule_SaveUnsigned(rdb, header->multi_edge[i]);
+		SerializerIO_WriteUnsigned(io, header->multi_edge[i]);
 	}
 
 	// number of keys
-	RedisModule_SaveUnsigned(rdb, header->key_count);
+	SerializerIO_WriteUnsigned(io, header->key_count);
 
 	// save graph schemas
-	RdbSaveGraphSchema_v11(rdb, gc);
+	RdbSaveGraphSchema_v12(io, gc);
 }
 
 // returns a state information regarding the number of entities required
@@ -87,6 +88,9 @@ static PayloadInfo _StatePayloadInfo
 	case ENCODE_STATE_GRAPH_SCHEMA:
 		required_entities_count = 1;
 		break;
+	case ENCODE_STATE_RELATION_MATRICES:
+		required_entities_count = Graph_RelationTypeCount(gc->g);
+		break;
 	default:
 		ASSERT(false && "Unknown encoding state in _CurrentStatePayloadInfo");
 		break;
@@ -101,23 +105,15 @@ static PayloadInfo _StatePayloadInfo
 	return payload_info;
 }
 
-// this function saves the key content schema
-// and returns it so the encoder can know how to encode the key
-static PayloadInfo *_RdbSaveKeySchema
+PayloadInfo *RdbKeySchema_v12
 (
-	RedisModuleIO *rdb,
-	GraphContext *gc
+	GraphContext *gc,
+	const GraphEncodeContext *ctx
 ) {
-	//  Format:
-	//  #Number of payloads info - N
-	//  N * Payload info:
-	//      Encode state
-	//      Number of entities encoded in this state
-
 	PayloadInfo *payloads = array_new(PayloadInfo, 1);
 
 	// get current encoding state
-	EncodeState current_state = GraphEncodeContext_GetEncodeState(gc->encoding_context);
+	EncodeState current_state = GraphEncodeContext_GetEncodeState(ctx);
 
 	// if this is the start of the encodeing, set the state to be NODES
 	if(current_state == ENCODE_STATE_INIT) current_state = ENCODE_STATE_NODES;
@@ -126,12 +122,12 @@ static PayloadInfo *_RdbSaveKeySchema
 	Config_Option_get(Config_VKEY_MAX_ENTITY_COUNT, &remaining_entities);
 
 	// check if this is the last key
-	bool last_key = GraphEncodeContext_GetProcessedKeyCount(gc->encoding_context) ==
-					(GraphEncodeContext_GetKeyCount(gc->encoding_context) - 1);
+	bool last_key = GraphEncodeContext_GetProcessedKeyCount(ctx) ==
+					(GraphEncodeContext_GetKeyCount(ctx) - 1);
 	if(last_key) remaining_entities = VKEY_ENTITY_COUNT_UNLIMITED;
 
 	// get the current state encoded entities count
-	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(ctx);
 
 	// while there are still remaining entities to encode in this key
 	// and the state is valid
@@ -147,21 +143,102 @@ static PayloadInfo *_RdbSaveKeySchema
 		}
 	}
 
+	return payloads;
+}
+
+// this function saves the key content schema
+// and returns it so the encoder can know how to encode the key
+static PayloadInfo *_RdbSaveKeySchema
+(
+	SerializerIO *io,
+	GraphContext *gc
+) {
+	//  Format:
+	//  #Number of payloads info - N
+	//  N * Payload info:
+	//      Encode state
+	//      Number of entities encoded in this state
+
+	PayloadInfo *payloads = RdbKeySchema_v12(gc, gc->encoding_context);
+
 	// save the number of payloads
 	uint payloads_count = array_len(payloads);
-	RedisModule_SaveUnsigned(rdb, payloads_count);
+	SerializerIO_WriteUnsigned(io, payloads_count);
 	for(uint i = 0; i < payloads_count; i++) {
 		// for each payload
 		// save its type and the number of entities it contains
 		PayloadInfo payload_info = payloads[i];
-		RedisModule_SaveUnsigned(rdb, payload_info.state);
-		RedisModule_SaveUnsigned(rdb, payload_info.entities_count);
+		SerializerIO_WriteUnsigned(io, payload_info.state);
+		SerializerIO_WriteUnsigned(io, payload_info.entities_count);
 	}
 
 	return payloads;
 }
 
-void RdbSaveGraph_v11
+void RdbSavePayloads_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	PayloadInfo *key_schema
+) {
+	uint payloads_count = array_len(key_schema);
+	for(uint i = 0; i < payloads_count; i++) {
+		// if the current key encoding more than one payload type,
+		// payloads count >1 and we are in a new state, zero the entities count
+		if(i > 0) GraphEncodeContext_SetProcessedEntitiesOffset(ctx, 0);
+		PayloadInfo payload = key_schema[i];
+		switch(payload.state) {
+		case ENCODE_STATE_NODES:
+			RdbSaveNodes_v12(io, gc, ctx, payload.entities_count);
+			break;
+		case ENCODE_STATE_DELETED_NODES:
+			RdbSaveDeletedNodes_v12(io, gc, ctx, payload.entities_count);
+			break;
+		case ENCODE_STATE_EDGES:
+			RdbSaveEdges_v12(io, gc, ctx, payload.entities_count);
+			break;
+		case ENCODE_STATE_DELETED_EDGES:
+			RdbSaveDeletedEdges_v12(io, gc, ctx, payload.entities_count);
+			break;
+		case ENCODE_STATE_GRAPH_SCHEMA:
+			// skip, handled in _RdbSaveHeader
+			break;
+		case ENCODE_STATE_RELATION_MATRICES:
+			RdbSaveRelationMatrices_v12(io, gc, ctx, payload.entities_count);
+			break;
+		default:
+			ASSERT(false && "Unknown encoding phase");
+			break;
+		}
+
+		// save the current state and the number of encoded entities
+		GraphEncodeContext_SetEncodeState(ctx, payload.state);
+		uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(ctx);
+		GraphEncodeContext_SetProcessedEntitiesOffset(ctx,
+													  payload.entities_count + offset);
+	}
+}
+
+// encode virtual keys concurrently when running within a forked child
+// and the graph spans multiple keys
+static bool _shouldEncodeInParallel
+(
+	const GraphEncodeContext *ctx,
+	int *thread_count
+) {
+	if(!process_is_child) return false;
+	if(GraphEncodeContext_GetKeyCount(ctx) < 2) return false;
+
+	// the forked child has no thread pools, use as many threads as readers
+	bool config_read = Config_Option_get(Config_THREAD_POOL_SIZE, thread_count);
+	ASSERT(config_read == true);
+	UNUSED(config_read);
+
+	return *thread_count > 1;
+}
+
+void RdbSaveGraph_v12
 (
 	RedisModuleIO *rdb,
 	void *value
@@ -170,7 +247,7 @@ void RdbSaveGraph_v11
 	//  Header
 	//  Payload(s) count: N
 	//  Key content X N:
-	//      Payload type (Nodes / Edges / Deleted nodes/ Deleted edges/ Graph schema)
+	//      Payload type (Nodes / Edges / Deleted nodes/ Deleted edges/ Graph schema / Relation matrices)
 	//      Entities in payload
 	//  Payload(s) X N
 	//
@@ -180,77 +257,64 @@ void RdbSaveGraph_v11
 	// 3. Edges
 	// 4. Deleted edges
 	// 5. Graph schema
+	// 6. Relation matrices
 	//
 	// Each payload type can spread over one or more keys. For example:
 	// A graph with 200,000 nodes, and the number of entities per payload
 	// is 100,000 then there will be two nodes payloads,
 	// each containing 100,000 nodes, encoded into two different RDB meta keys
+	//
+	// Within a forked child, the payloads of all keys are encoded concurrently
+	// by a ParallelEncoder, see encode_parallel.h
 
 	GraphContext *gc = value;
+	GraphEncodeContext *ctx = gc->encoding_context;
+	SerializerIO io = SerializerIO_FromRdb(rdb);
 
 	// TODO: remove, no need, as GIL is taken
 
 	// acquire a read lock if we're not in a thread-safe context
 	if(_shouldAcquireLocks()) Graph_AcquireReadLock(gc->g);
 
-	EncodeState current_state = GraphEncodeContext_GetEncodeState(gc->encoding_context);
+	EncodeState current_state = GraphEncodeContext_GetEncodeState(ctx);
 
-	if(current_state == ENCODE_STATE_INIT) {
+	if(current_state == ENCODE_STATE_INIT && ctx->parallel_encoder == NULL) {
 		// inital state, populate encoding context header
-		GraphEncodeContext_InitHeader(gc->encoding_context, gc->graph_name, gc->g);
-	}
-
-	// save header
-	_RdbSaveHeader(rdb, gc);
+		GraphEncodeContext_InitHeader(ctx, gc->graph_name, gc->g);
 
-	// save payloads info for this key and retrive the key schema
-	PayloadInfo *key_schema = _RdbSaveKeySchema(rdb, gc);
-
-	uint payloads_count = array_len(key_schema);
-	for(uint i = 0; i < payloads_count; i++) {
-		// if the current key encoding more than one payload type,
-		// payloads count >1 and we are in a new state, zero the entities count
-		if(i > 0) GraphEncodeContext_SetProcessedEntitiesOffset(gc->encoding_context, 0);
-		PayloadInfo payload = key_schema[i];
-		switch(payload.state) {
-		case ENCODE_STATE_NODES:
-			RdbSaveNodes_v11(rdb, gc, payload.entities_count);
-			break;
-		case ENCODE_STATE_DELETED_NODES:
-			RdbSaveDeletedNodes_v11(rdb, gc, payload.entities_count);
-			break;
-		case ENCODE_STATE_EDGES:
-			RdbSaveEdges_v11(rdb, gc, payload.entities_count);
-			break;
-		case ENCODE_STATE_DELETED_EDGES:
-			RdbSaveDeletedEdges_v11(rdb, gc, payload.entities_count);
-			break;
-		case ENCODE_STATE_GRAPH_SCHEMA:
-			// skip, handled in _RdbSaveHeader
-			break;
-		default:
-			ASSERT(false && "Unknown encoding phase");
-			break;
+		int thread_count;
+		if(_shouldEncodeInParallel(ctx, &thread_count)) {
+			ctx->parallel_encoder = ParallelEncoder_New(gc, ctx, thread_count);
 		}
+	}
 
-		// save the current state and the number of encoded entities
-		GraphEncodeContext_SetEncodeState(gc->encoding_context, payload.state);
-		uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(gc->encoding_context);
-		GraphEncodeContext_SetProcessedEntitiesOffset(gc->encoding_context,
-													  payload.entities_count + offset);
+	// save header
+	_RdbSaveHeader(&io, gc);
+
+	if(ctx->parallel_encoder != NULL) {
+		// save key schema and concurrently encoded payloads
+		ParallelEncoder_SaveKey(ctx->parallel_encoder, rdb,
+				GraphEncodeContext_GetProcessedKeyCount(ctx));
+	} else {
+		// save payloads info for this key and retrive the key schema
+		PayloadInfo *key_schema = _RdbSaveKeySchema(&io, gc);
+		RdbSavePayloads_v12(&io, gc, ctx, key_schema);
+		array_free(key_schema);
 	}
-	array_free(key_schema);
 
 	// increase processed key count
 	// if finished encoding, reset context
-	GraphEncodeContext_IncreaseProcessedKeyCount(gc->encoding_context);
-	if(GraphEncodeContext_Finished(gc->encoding_context)) {
-		GraphEncodeContext_Reset(gc->encoding_context);
-		RedisModuleCtx *ctx = RedisModule_GetContextFromIO(rdb);
-		RedisModule_Log(ctx, "notice", "Done encoding graph %s", gc->graph_name);
+	GraphEncodeContext_IncreaseProcessedKeyCount(ctx);
+	if(GraphEncodeContext_Finished(ctx)) {
+		if(ctx->parallel_encoder != NULL) {
+			ParallelEncoder_Free(ctx->parallel_encoder);
+			ctx->parallel_encoder = NULL;
+		}
+		GraphEncodeContext_Reset(ctx);
+		RedisModuleCtx *rm_ctx = RedisModule_GetContextFromIO(rdb);
+		RedisModule_Log(rm_ctx, "notice", "Done encoding graph %s", gc->graph_name);
 	}
 
 	// if a lock was acquired, release it
 	if(_shouldAcquireLocks()) Graph_ReleaseLock(gc->g);
 }
-
@@ -0,0 +1,287 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "encode_v12.h"
+#include "../../../datatypes/datatypes.h"
+
+// forword decleration
+static void _RdbSaveSIValue
+(
+	SerializerIO *io,
+	const SIValue *v
+);
+
+static void _RdbSaveSIArray
+(
+	SerializerIO *io,
+	const SIValue list
+) {
+	/* saves array as
+	   unsigned : array legnth
+	   array[0]
+	   .
+	   .
+	   .
+	   array[array length -1]
+	 */
+	uint arrayLen = SIArray_Length(list);
+	SerializerIO_WriteUnsigned(io, arrayLen);
+	for(uint i = 0; i < arrayLen; i ++) {
+		SIValue value = SIArray_Get(list, i);
+		_RdbSaveSIValue(io, &value);
+	}
+}
+
+static void _RdbSaveSIValue
+(
+	SerializerIO *io,
+	const SIValue *v
+) {
+	// Format:
+	// SIType
+	// Value
+
+	// compressed strings are saved compressed
+	// Format:
+	// compressed string tag
+	// decompressed length
+	// compressed bytes
+	if(v->allocation == M_COMPRESSED) {
+		size_t size;
+		const char *data = CompressedString_Data(v->stringval, &size);
+		SerializerIO_WriteUnsigned(io, COMPRESSED_STRING_ENCODING_TAG);
+		SerializerIO_WriteUnsigned(io, CompressedString_Length(v->stringval));
+		SerializerIO_WriteBuffer(io, data, size);
+		return;
+	}
+
+	SerializerIO_WriteUnsigned(io, v->type);
+	switch(v->type) {
+		case T_BOOL:
+		case T_INT64:
+			SerializerIO_WriteSigned(io, v->longval);
+			return;
+		case T_DOUBLE:
+			SerializerIO_WriteDouble(io, v->doubleval);
+			return;
+		case T_STRING:
+			SerializerIO_WriteBuffer(io, v->stringval, strlen(v->stringval) + 1);
+			return;
+		case T_ARRAY:
+			_RdbSaveSIArray(io, *v);
+			return;
+		case T_POINT:
+			SerializerIO_WriteDouble(io, Point_lat(*v));
+			SerializerIO_WriteDouble(io, Point_lon(*v));
+		case T_NULL:
+			return; // No data beyond the type needs to be encoded for a NULL value.
+		default:
+			ASSERT(0 && "Attempted to serialize value of invalid type.");
+	}
+}
+
+static void _RdbSaveEntity
+(
+	SerializerIO *io,
+	const Entity *e
+) {
+	// Format:
+	// #attributes N
+	// (name, value type, value) X N 
+
+	int prop_count = Entity_PropCount(e);
+	SerializerIO_WriteUnsigned(io, prop_count);
+
+	const Attribute_ID *ids = Entity_AttributeIDs(e);
+	for(int i = 0; i < prop_count; i++) {
+		SerializerIO_WriteUnsigned(io, ids[i]);
+		_RdbSaveSIValue(io, e->properties + i);
+	}
+}
+
+static void _RdbSaveEdge
+(
+	SerializerIO *io,
+	GraphEntity *e
+) {
+
+	// Format:
+	//  edge ID
+	//  edge properties
+	//
+	// edge connections are encoded by the relation matrices
+
+	SerializerIO_WriteUnsigned(io, ENTITY_GET_ID(e));
+
+	// edge properties
+	_RdbSaveEntity(io, e->entity);
+}
+
+static void _RdbSaveNode_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEntity *n
+) {
+	// Format:
+	//     ID
+	//     #labels M
+	//     (labels) X M
+	//     #properties N
+	//     (name, value type, value) X N */
+
+	// save ID
+	EntityID id = ENTITY_GET_ID(n);
+	SerializerIO_WriteUnsigned(io, id);
+
+	// retrieve node labels
+	uint l_count;
+	NODE_GET_LABELS(gc->g, (Node *)n, l_count);
+	SerializerIO_WriteUnsigned(io, l_count);
+
+	// save labels
+	for(uint i = 0; i < l_count; i++) SerializerIO_WriteUnsigned(io, labels[i]);
+
+	// properties N
+	// (name, value type, value) X N
+	_RdbSaveEntity(io, n->entity);
+}
+
+static void _RdbSaveDeletedEntities_v12
+(
+	SerializerIO *io,
+	GraphEncodeContext *ctx,
+	uint64_t deleted_entities_to_encode,
+	uint64_t *deleted_id_list
+) {
+	// Get the number of deleted entities already encoded.
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(ctx);
+
+	// Iterated over the required range in the datablock deleted items.
+	for(uint64_t i = offset; i < offset + deleted_entities_to_encode; i++) {
+		SerializerIO_WriteUnsigned(io, deleted_id_list[i]);
+	}
+}
+
+void RdbSaveDeletedNodes_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t deleted_nodes_to_encode
+) {
+	// Format:
+	// node id X N
+
+	// skipping deleted entities only requires an offset update
+	if(io == NULL || deleted_nodes_to_encode == 0) return;
+	// get deleted nodes list
+	uint64_t *deleted_nodes_list = Serializer_Graph_GetDeletedNodesList(gc->g);
+	_RdbSaveDeletedEntities_v12(io, ctx, deleted_nodes_to_encode, deleted_nodes_list);
+}
+
+void RdbSaveDeletedEdges_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t deleted_edges_to_encode
+) {
+	// Format:
+	// edge id X N
+
+	// skipping deleted entities only requires an offset update
+	if(io == NULL || deleted_edges_to_encode == 0) return;
+
+	// get deleted edges list
+	uint64_t *deleted_edges_list = Serializer_Graph_GetDeletedEdgesList(gc->g);
+	_RdbSaveDeletedEntities_v12(io, ctx, deleted_edges_to_encode, deleted_edges_list);
+}
+
+void RdbSaveNodes_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t nodes_to_encode
+) {
+	// Format:
+	// Node Format * nodes_to_encode:
+	//  ID
+	//  #labels M
+	//  (labels) X M
+	//  #properties N
+	//  (name, value type, value) X N
+
+	if(nodes_to_encode == 0) return;
+	// get graph's node count
+	uint64_t graph_nodes = Graph_NodeCount(gc->g);
+	// get the number of nodes already encoded
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(ctx);
+
+	// get datablock iterator from context,
+	// already set to offset by a previous encodeing of nodes, or create new one
+	DataBlockIterator *iter = GraphEncodeContext_GetDatablockIterator(ctx);
+	if(!iter) {
+		iter = Graph_ScanNodes(gc->g);
+		GraphEncodeContext_SetDatablockIterator(ctx, iter);
+	}
+
+	for(uint64_t i = 0; i < nodes_to_encode; i++) {
+		GraphEntity e;
+		e.entity = (Entity *)DataBlockIterator_Next(iter, &e.id);
+		if(io != NULL) _RdbSaveNode_v12(io, gc, &e);
+	}
+
+	// check if done encodeing nodes
+	if(offset + nodes_to_encode == graph_nodes) {
+		DataBlockIterator_Free(iter);
+		iter = NULL;
+		GraphEncodeContext_SetDatablockIterator(ctx, iter);
+	}
+}
+
+void RdbSaveEdges_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t edges_to_encode
+) {
+	// Format:
+	// Edge format * edges_to_encode:
+	//  edge ID
+	//  edge properties
+
+	if(edges_to_encode == 0) return;
+
+	// get graph's edge count
+	uint64_t graph_edges = Graph_EdgeCount(gc->g);
+
+	// get the number of edges already encoded
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(ctx);
+
+	// get datablock iterator from context,
+	// already set to offset by a previous encodeing of edges, or create new one
+	DataBlockIterator *iter = GraphEncodeContext_GetDatablockIterator(ctx);
+	if(!iter) {
+		iter = Graph_ScanEdges(gc->g);
+		GraphEncodeContext_SetDatablockIterator(ctx, iter);
+	}
+
+	for(uint64_t i = 0; i < edges_to_encode; i++) {
+		GraphEntity e;
+		e.entity = (Entity *)DataBlockIterator_Next(iter, &e.id);
+		if(io != NULL) _RdbSaveEdge(io, &e);
+	}
+
+	// check if done encoding edges
+	if(offset + edges_to_encode == graph_edges) {
+		DataBlockIterator_Free(iter);
+		iter = NULL;
+		GraphEncodeContext_SetDatablockIterator(ctx, iter);
+	}
+}
@@ -0,0 +1,220 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "encode_parallel.h"
+#include <pthread.h>
+
+// a single key encoding task
+typedef struct {
+	bool done;                // payloads encoded
+	SerializerIO io;          // recorded payloads
+	PayloadInfo *schema;      // key schema
+	GraphEncodeContext ctx;   // encoding cursor at the beginning of the key
+} EncodeTask;
+
+struct ParallelEncoder {
+	GraphContext *gc;         // encoded graph
+	EncodeTask *tasks;        // task per graph key
+	uint64_t task_count;      // number of tasks
+	uint64_t next_task;       // next task to be picked by a worker
+	uint64_t saved;           // number of keys saved to RDB
+	uint64_t window;          // max number of encoded keys pending to be saved
+	pthread_t *threads;       // worker threads
+	uint thread_count;        // number of worker threads
+	pthread_mutex_t lock;     // guards task picking and completion
+	pthread_cond_t cond;      // signaled on task completion and key save
+};
+
+// copy encoding cursor, iterators are duplicated
+static void _EncodeCursor_Snapshot
+(
+	const GraphEncodeContext *src,
+	GraphEncodeContext *dest
+) {
+	*dest = *src;
+	dest->parallel_encoder = NULL;
+
+	if(src->datablock_iterator != NULL) {
+		dest->datablock_iterator =
+			DataBlockIterator_Clone(src->datablock_iterator);
+	}
+
+	// matrix tuple iterators are plain structs, a copy retains position
+	if(src->matrix_tuple_iterator != NULL) {
+		dest->matrix_tuple_iterator = rm_malloc(sizeof(RG_MatrixTupleIter));
+		*dest->matrix_tuple_iterator = *src->matrix_tuple_iterator;
+	}
+}
+
+// free encoding cursor iterators
+static void _EncodeCursor_Free
+(
+	GraphEncodeContext *ctx
+) {
+	if(ctx->datablock_iterator != NULL) {
+		DataBlockIterator_Free(ctx->datablock_iterator);
+		ctx->datablock_iterator = NULL;
+	}
+
+	if(ctx->matrix_tuple_iterator != NULL) {
+		RG_MatrixTupleIter_free(&ctx->matrix_tuple_iterator);
+	}
+}
+
+static void *_ParallelEncoder_Worker
+(
+	void *arg
+) {
+	ParallelEncoder *pe = arg;
+
+	while(true) {
+		pthread_mutex_lock(&pe->lock);
+
+		// bound the number of recorded keys waiting to be saved
+		while(pe->next_task < pe->task_count &&
+			  pe->next_task >= pe->saved + pe->window) {
+			pthread_cond_wait(&pe->cond, &pe->lock);
+		}
+
+		if(pe->next_task == pe->task_count) {
+			pthread_mutex_unlock(&pe->lock);
+			break;
+		}
+
+		EncodeTask *task = pe->tasks + pe->next_task++;
+		pthread_mutex_unlock(&pe->lock);
+
+		task->io = SerializerIO_Recorder();
+		RdbSavePayloads_v12(&task->io, pe->gc, &task->ctx, task->schema);
+		_EncodeCursor_Free(&task->ctx);
+
+		pthread_mutex_lock(&pe->lock);
+		task->done = true;
+		pthread_cond_broadcast(&pe->cond);
+		pthread_mutex_unlock(&pe->lock);
+	}
+
+	return NULL;
+}
+
+ParallelEncoder *ParallelEncoder_New
+(
+	GraphContext *gc,
+	const GraphEncodeContext *ctx,
+	uint thread_count
+) {
+	ASSERT(gc           != NULL);
+	ASSERT(ctx          != NULL);
+	ASSERT(thread_count > 0);
+	ASSERT(GraphEncodeContext_GetProcessedKeyCount(ctx) == 0);
+
+	uint64_t key_count = GraphEncodeContext_GetKeyCount(ctx);
+
+	ParallelEncoder *pe = rm_calloc(1, sizeof(ParallelEncoder));
+	pe->gc           = gc;
+	pe->task_count   = key_count;
+	pe->thread_count = MIN(thread_count, key_count);
+	pe->window       = 2 * pe->thread_count;
+	pe->tasks        = rm_calloc(key_count, sizeof(EncodeTask));
+	pe->threads      = rm_malloc(sizeof(pthread_t) * pe->thread_count);
+
+	pthread_mutex_init(&pe->lock, NULL);
+	pthread_cond_init(&pe->cond, NULL);
+
+	// workers access matrices concurrently, flush all pending changes
+	Graph_ApplyAllPending(gc->g, true);
+
+	// determine each key's schema and starting cursor
+	// by skipping over the entities of its preceding keys
+	GraphEncodeContext scratch;
+	_EncodeCursor_Snapshot(ctx, &scratch);
+	for(uint64_t i = 0; i < key_count; i++) {
+		EncodeTask *task = pe->tasks + i;
+		task->schema = RdbKeySchema_v12(gc, &scratch);
+		_EncodeCursor_Snapshot(&scratch, &task->ctx);
+
+		RdbSavePayloads_v12(NULL, gc, &scratch, task->schema);
+		scratch.keys_processed++;
+	}
+	_EncodeCursor_Free(&scratch);
+
+	for(uint i = 0; i < pe->thread_count; i++) {
+		int res = pthread_create(pe->threads + i, NULL,
+				_ParallelEncoder_Worker, pe);
+		ASSERT(res == 0);
+		UNUSED(res);
+	}
+
+	return pe;
+}
+
+void ParallelEncoder_SaveKey
+(
+	ParallelEncoder *pe,
+	RedisModuleIO *rdb,
+	uint64_t key
+) {
+	ASSERT(pe  != NULL);
+	ASSERT(rdb != NULL);
+	ASSERT(key == pe->saved);
+
+	EncodeTask *task = pe->tasks + key;
+
+	// save key schema, see _RdbSaveKeySchema
+	SerializerIO io = SerializerIO_FromRdb(rdb);
+	uint payloads_count = array_len(task->schema);
+	SerializerIO_WriteUnsigned(&io, payloads_count);
+	for(uint i = 0; i < payloads_count; i++) {
+		SerializerIO_WriteUnsigned(&io, task->schema[i].state);
+		SerializerIO_WriteUnsigned(&io, task->schema[i].entities_count);
+	}
+
+	// wait for the key payloads to be encoded
+	pthread_mutex_lock(&pe->lock);
+	while(!task->done) pthread_cond_wait(&pe->cond, &pe->lock);
+	pthread_mutex_unlock(&pe->lock);
+
+	SerializerIO_Replay(&task->io, rdb);
+	SerializerIO_Free(&task->io);
+	array_free(task->schema);
+	task->schema = NULL;
+
+	// allow workers to proceed
+	pthread_mutex_lock(&pe->lock);
+	pe->saved++;
+	pthread_cond_broadcast(&pe->cond);
+	pthread_mutex_unlock(&pe->lock);
+}
+
+void ParallelEncoder_Free
+(
+	ParallelEncoder *pe
+) {
+	ASSERT(pe != NULL);
+
+	// stop workers from picking up further tasks
+	pthread_mutex_lock(&pe->lock);
+	pe->next_task = pe->task_count;
+	pthread_cond_broadcast(&pe->cond);
+	pthread_mutex_unlock(&pe->lock);
+
+	for(uint i = 0; i < pe->thread_count; i++) {
+		pthread_join(pe->threads[i], NULL);
+	}
+
+	for(uint64_t i = 0; i < pe->task_count; i++) {
+		EncodeTask *task = pe->tasks + i;
+		_EncodeCursor_Free(&task->ctx);
+		SerializerIO_Free(&task->io);
+		if(task->schema != NULL) array_free(task->schema);
+	}
+
+	pthread_cond_destroy(&pe->cond);
+	pthread_mutex_destroy(&pe->lock);
+	rm_free(pe->threads);
+	rm_free(pe->tasks);
+	rm_free(pe);
+}
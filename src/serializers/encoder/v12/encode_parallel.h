@@ -0,0 +1,46 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "encode_v12.h"
+
+// ParallelEncoder encodes a graph's virtual keys concurrently
+//
+// Redis saves keys to the RDB stream one after the other, as such
+// each key's payloads are encoded by a worker thread into an in-memory
+// recording, which is replayed onto the stream once Redis asks for the key
+// the produced byte stream is identical to the one produced by the
+// sequential encoder
+//
+// every key's starting position (its encoding context cursor) is determined
+// upfront by a pass which skips over entities without encoding them
+typedef struct ParallelEncoder ParallelEncoder;
+
+// creates a parallel encoder for 'gc'
+// 'ctx' must have its header initialized and not have processed any key
+// spawns 'thread_count' worker threads
+ParallelEncoder *ParallelEncoder_New
+(
+	GraphContext *gc,
+	const GraphEncodeContext *ctx,
+	uint thread_count
+);
+
+// saves the key schema and payloads of the 'key'th graph key to 'rdb'
+// blocks until the key's payloads are encoded
+void ParallelEncoder_SaveKey
+(
+	ParallelEncoder *pe,
+	RedisModuleIO *rdb,
+	uint64_t key
+);
+
+// joins worker threads and frees the encoder
+void ParallelEncoder_Free
+(
+	ParallelEncoder *pe
+);
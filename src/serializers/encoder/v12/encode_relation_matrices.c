@@ -0,0 +1,184 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "encode_v12.h"
+
+// encodes the multiple edges referenced by 'Ax'
+// into a buffer of (position, #edges, edge IDs) entries
+// returns the buffer length in bytes, the buffer is owned by the caller
+static size_t _CollectMultipleEdges
+(
+	const RG_Matrix M,   // relation matrix holding the multiple edges
+	const uint64_t *Ax,  // matrix values
+	GrB_Index n,         // number of values
+	uint64_t **buf       // [output] multiple edges buffer
+) {
+	// compute buffer length
+	size_t len = 0;
+	for(GrB_Index i = 0; i < n; i++) {
+		if(SINGLE_EDGE(Ax[i])) continue;
+		uint64_t edge_count;
+		RG_Matrix_multiEdgeIDs(M, Ax[i], &edge_count);
+		len += 2 + edge_count;
+	}
+
+	*buf = NULL;
+	if(len == 0) return 0;
+
+	uint64_t *entries = rm_malloc(sizeof(uint64_t) * len);
+	uint64_t *entry = entries;
+	for(GrB_Index i = 0; i < n; i++) {
+		if(SINGLE_EDGE(Ax[i])) continue;
+
+		uint64_t edge_count;
+		const EdgeID *ids = RG_Matrix_multiEdgeIDs(M, Ax[i], &edge_count);
+
+		*entry++ = i;
+		*entry++ = edge_count;
+		memcpy(entry, ids, sizeof(EdgeID) * edge_count);
+		entry += edge_count;
+	}
+
+	*buf = entries;
+	return sizeof(uint64_t) * len;
+}
+
+static void _RdbSaveRelationMatrix
+(
+	SerializerIO *io,
+	Graph *g,
+	int r
+) {
+	// Format:
+	//  relation type
+	//  #rows
+	//  #columns
+	//  #entries N
+	//  if N > 0:
+	//   is hypersparse
+	//   is iso
+	//   is jumbled
+	//   #vectors V (hypersparse only)
+	//   row indices (hypersparse only)
+	//   row pointers
+	//   column indices
+	//   values
+	//   multiple edges: (position, #edges M, edge ID X M) X K
+	//
+	// arrays are written in their native memory layout
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Type   t;
+	GrB_Index  nrows;
+	GrB_Index  ncols;
+	GrB_Index  nvals;
+	GrB_Index  nvec;
+	GrB_Index  *Ap       =  NULL;
+	GrB_Index  *Ah       =  NULL;
+	GrB_Index  *Aj       =  NULL;
+	uint64_t   *Ax       =  NULL;
+	GrB_Index  Ap_size   =  0;
+	GrB_Index  Ah_size   =  0;
+	GrB_Index  Aj_size   =  0;
+	GrB_Index  Ax_size   =  0;
+	bool       iso       =  false;
+	bool       jumbled   =  false;
+	int        sparsity  =  GxB_SPARSE;
+	GrB_Matrix A         =  NULL;
+
+	// export a flushed copy of the relation matrix
+	RG_Matrix M = Graph_GetRelationMatrix(g, r, false);
+	info = RG_Matrix_export(&A, M);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_nrows(&nrows, A);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, A);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(&nvals, A);
+	ASSERT(info == GrB_SUCCESS);
+
+	SerializerIO_WriteUnsigned(io, r);
+	SerializerIO_WriteUnsigned(io, nrows);
+	SerializerIO_WriteUnsigned(io, ncols);
+	SerializerIO_WriteUnsigned(io, nvals);
+
+	if(nvals == 0) {
+		GrB_Matrix_free(&A);
+		return;
+	}
+
+	// avoid bitmap and full formats
+	info = GxB_Matrix_Option_set(A, GxB_SPARSITY_CONTROL,
+			GxB_SPARSE | GxB_HYPERSPARSE);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_wait(A, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Matrix_Option_get(A, GxB_SPARSITY_STATUS, &sparsity);
+	ASSERT(info == GrB_SUCCESS);
+
+	bool hyper = (sparsity == GxB_HYPERSPARSE);
+
+	// export frees A and hands over its arrays
+	if(hyper) {
+		info = GxB_Matrix_export_HyperCSR(&A, &t, &nrows, &ncols, &Ap, &Ah,
+				&Aj, (void **)&Ax, &Ap_size, &Ah_size, &Aj_size, &Ax_size, &iso,
+				&nvec, &jumbled, NULL);
+	} else {
+		info = GxB_Matrix_export_CSR(&A, &t, &nrows, &ncols, &Ap, &Aj,
+				(void **)&Ax, &Ap_size, &Aj_size, &Ax_size, &iso, &jumbled,
+				NULL);
+		nvec = nrows;
+	}
+	ASSERT(info == GrB_SUCCESS);
+	ASSERT(t == GrB_UINT64);
+
+	GrB_Index values_count = iso ? 1 : nvals;
+	uint64_t *multiple_edges;
+	size_t multiple_edges_len = _CollectMultipleEdges(M, Ax, values_count,
+			&multiple_edges);
+
+	SerializerIO_WriteUnsigned(io, hyper);
+	SerializerIO_WriteUnsigned(io, iso);
+	SerializerIO_WriteUnsigned(io, jumbled);
+	if(hyper) {
+		SerializerIO_WriteUnsigned(io, nvec);
+		SerializerIO_TransferBuffer(io, (char *)Ah, sizeof(GrB_Index) * nvec);
+	}
+	SerializerIO_TransferBuffer(io, (char *)Ap,
+			sizeof(GrB_Index) * (nvec + 1));
+	SerializerIO_TransferBuffer(io, (char *)Aj, sizeof(GrB_Index) * nvals);
+	SerializerIO_TransferBuffer(io, (char *)Ax,
+			sizeof(uint64_t) * values_count);
+	if(multiple_edges != NULL) {
+		SerializerIO_TransferBuffer(io, (char *)multiple_edges,
+				multiple_edges_len);
+	} else {
+		SerializerIO_WriteBuffer(io, "", 0);
+	}
+}
+
+void RdbSaveRelationMatrices_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t matrices_to_encode
+) {
+	// Format:
+	// relation matrix X matrices_to_encode
+
+	// relation matrices are encoded one after the other
+	// skipping them only requires an offset update
+	if(io == NULL) return;
+
+	uint64_t offset = GraphEncodeContext_GetProcessedEntitiesOffset(ctx);
+	for(uint64_t i = 0; i < matrices_to_encode; i++) {
+		_RdbSaveRelationMatrix(io, gc->g, offset + i);
+	}
+}
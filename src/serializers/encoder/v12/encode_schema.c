@@ -0,0 +1,158 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "encode_v12.h"
+
+static void _RdbSaveAttributeKeys(SerializerIO *io, GraphContext *gc) {
+	/* Format:
+	 * #attribute keys
+	 * attribute keys
+	*/
+
+	uint count = GraphContext_AttributeCount(gc);
+	SerializerIO_WriteUnsigned(io, count);
+	for(uint i = 0; i < count; i ++) {
+		const char *key = GraphContext_GetAttributeString(gc, i);
+		SerializerIO_WriteBuffer(io, key, strlen(key) + 1);
+	}
+}
+
+static inline void _RdbSaveIndexData(SerializerIO *io, Index *idx) {
+	if(!idx) return;
+
+	// Index type
+	SerializerIO_WriteUnsigned(io, idx->type);
+
+	if(idx->type == IDX_FULLTEXT) {
+		// Index language
+		const char *language = Index_GetLanguage(idx);
+		SerializerIO_WriteBuffer(io, language, strlen(language) + 1);
+
+		size_t stopwords_count;
+		char **stopwords = Index_GetStopwords(idx, &stopwords_count);
+		// Index stopwords count
+		SerializerIO_WriteUnsigned(io, stopwords_count);
+		for (size_t i = 0; i < stopwords_count; i++) {
+			char *stopword = stopwords[i];
+			// Index stopword
+			SerializerIO_WriteBuffer(io, stopword, strlen(stopword) + 1);
+			rm_free(stopword);
+		}
+		rm_free(stopwords);
+	} else if(idx->type == IDX_VECTOR) {
+		// Indexed vectors dimension
+		SerializerIO_WriteUnsigned(io, idx->dimension);
+	}
+
+	uint fields_count = Index_FieldsCount(idx);
+	// Indexed fields count
+	SerializerIO_WriteUnsigned(io, fields_count);
+	for(uint i = 0; i < fields_count; i++) {
+		// Indexed property
+		SerializerIO_WriteBuffer(io, idx->fields[i], strlen(idx->fields[i]) + 1);
+	}
+}
+
+static inline void _RdbSaveConstraint(SerializerIO *io, const Constraint *c) {
+	// Constraints are tagged as an index type older decoders reject.
+	SerializerIO_WriteUnsigned(io, CONSTRAINT_ENCODING_TAG);
+
+	// Constraint type
+	SerializerIO_WriteUnsigned(io, c->t);
+
+	// Constrained property
+	SerializerIO_WriteBuffer(io, c->attr_name, strlen(c->attr_name) + 1);
+}
+
+static inline void _RdbSaveRelationSummary(SerializerIO *io,
+		const RelationSummary *summary) {
+	// Degree summaries are tagged as an index type older decoders reject.
+	SerializerIO_WriteUnsigned(io, RELATION_SUMMARY_ENCODING_TAG);
+
+	// Distinct source and destination nodes.
+	SerializerIO_WriteUnsigned(io, summary->src_count);
+	SerializerIO_WriteUnsigned(io, summary->dest_count);
+
+	// Edge count the summary was computed at.
+	SerializerIO_WriteUnsigned(io, summary->edge_count);
+}
+
+static void _RdbSaveSchema(SerializerIO *io, GraphContext *gc, Schema *s) {
+	/* Format:
+	 * id
+	 * name
+	 * #indices, constraints and summaries
+	 * (index type, indexed property) X M
+	 * (constraint tag, constraint type, constrained property) X C
+	 * (summary tag, #sources, #destinations, #edges) X S, relations only */
+
+	// Schema ID.
+	SerializerIO_WriteUnsigned(io, s->id);
+
+	// Schema name.
+	SerializerIO_WriteBuffer(io, s->name, strlen(s->name) + 1);
+
+	// Relation's degree summary, if computed.
+	const RelationSummary *summary = NULL;
+	if(s->type == SCHEMA_EDGE) {
+		summary = GraphStatistics_GetRelationSummary(&gc->g->stats, s->id);
+	}
+
+	// Number of indices, constraints and summaries.
+	uint constraint_count = Schema_ConstraintCount(s);
+	SerializerIO_WriteUnsigned(io, Schema_IndexCount(s) + constraint_count +
+			(summary != NULL));
+
+	// Exact match indices.
+	_RdbSaveIndexData(io, s->index);
+
+	// Fulltext indices.
+	_RdbSaveIndexData(io, s->fulltextIdx);
+
+	// Vector indices.
+	_RdbSaveIndexData(io, s->vectorIdx);
+
+	// Constraints.
+	for(uint i = 0; i < constraint_count; i++) {
+		_RdbSaveConstraint(io, s->constraints + i);
+	}
+
+	// Degree summary.
+	if(summary != NULL) _RdbSaveRelationSummary(io, summary);
+}
+
+void RdbSaveGraphSchema_v12(SerializerIO *io, GraphContext *gc) {
+	/* Format:
+	 * attribute keys (unified schema)
+	 * #node schemas
+	 * node schema X #node schemas
+	 * #relation schemas
+	 * relation schema X #relation schemas
+	*/
+
+	// Serialize all attribute keys
+	_RdbSaveAttributeKeys(io, gc);
+
+	// #Node schemas.
+	unsigned short schema_count = GraphContext_SchemaCount(gc, SCHEMA_NODE);
+	SerializerIO_WriteUnsigned(io, schema_count);
+
+	// Name of label X #node schemas.
+	for(int i = 0; i < schema_count; i++) {
+		Schema *s = gc->node_schemas[i];
+		_RdbSaveSchema(io, gc, s);
+	}
+
+	// #Relation schemas.
+	unsigned short relation_count = GraphContext_SchemaCount(gc, SCHEMA_EDGE);
+	SerializerIO_WriteUnsigned(io, relation_count);
+
+	// Name of label X #relation schemas.
+	for(unsigned short i = 0; i < relation_count; i++) {
+		Schema *s = gc->relation_schemas[i];
+		_RdbSaveSchema(io, gc, s);
+	}
+}
@@ -0,0 +1,80 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include "../../serializers_include.h"
+#include "../../serializer_io.h"
+
+void RdbSaveGraph_v12
+(
+	RedisModuleIO *rdb,
+	void *value
+);
+
+// computes the payloads of the next key to be encoded by 'ctx'
+// the returned array is owned by the caller
+PayloadInfo *RdbKeySchema_v12
+(
+	GraphContext *gc,
+	const GraphEncodeContext *ctx
+);
+
+// encodes the payloads described by 'key_schema', advancing 'ctx'
+// when 'io' is NULL entities are skipped rather than encoded
+void RdbSavePayloads_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	PayloadInfo *key_schema
+);
+
+void RdbSaveNodes_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t nodes_to_encode
+);
+
+void RdbSaveDeletedNodes_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t deleted_nodes_to_encode
+);
+
+void RdbSaveEdges_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t edges_to_encode
+);
+
+void RdbSaveDeletedEdges_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t deleted_edges_to_encode
+);
+
+void RdbSaveRelationMatrices_v12
+(
+	SerializerIO *io,
+	GraphContext *gc,
+	GraphEncodeContext *ctx,
+	uint64_t matrices_to_encode
+);
+
+void RdbSaveGraphSchema_v12
+(
+	SerializerIO *io,
+	GraphContext *gc
+);
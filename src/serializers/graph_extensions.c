@@ -6,6 +6,9 @@
 
 #include "graph_extensions.h"
 #include "../RG.h"
+#include "../util/arr.h"
+#include "../util/qsort.h"
+#include "../util/rmalloc.h"
 #include "../util/datablock/oo_datablock.h"
 
 // functions declerations - implemented in graph.c
@@ -38,7 +41,6 @@ void Serializer_Graph_SetNode
 	ASSERT(g);
 
 	Entity *en = DataBlock_AllocateItemOutOfOrder(g->nodes, id);
-	en->prop_count  =  0;
 	en->properties  =  NULL;
 	n->id           =  id;
 	n->entity       =  en;
@@ -100,11 +102,9 @@ static void _OptimizedSingleEdgeFormConnection
 ) {
 	GrB_Info info;
 	RG_Matrix  M      =  Graph_GetRelationMatrix(g, r, false);
-	RG_Matrix  adj    =  Graph_GetAdjacencyMatrix(g, false);
+	RG_Matrix  adj    =  Graph_GetAdjacencyMatrixForUpdate(g);
 	GrB_Matrix m      =  RG_MATRIX_M(M);
-	GrB_Matrix tm     =  RG_MATRIX_TM(M);
-	GrB_Matrix adj_m  =  RG_MATRIX_M(adj);
-	GrB_Matrix adj_tm =  RG_MATRIX_TM(adj);
+	GrB_Matrix tm     =  RG_MATRIX_MAINTAIN_TRANSPOSE(M) ? RG_MATRIX_TM(M) : NULL;
 
 	UNUSED(info);
 
@@ -114,10 +114,12 @@ static void _OptimizedSingleEdgeFormConnection
 	// update adjacency matrix
 	//--------------------------------------------------------------------------
 
-	info = GrB_Matrix_setElement_BOOL(adj_m, true, src, dest);
-	ASSERT(info == GrB_SUCCESS);
-	info = GrB_Matrix_setElement_BOOL(adj_tm, true, dest, src);
-	ASSERT(info == GrB_SUCCESS);
+	if(adj != NULL) {
+		info = GrB_Matrix_setElement_BOOL(RG_MATRIX_M(adj), true, src, dest);
+		ASSERT(info == GrB_SUCCESS);
+		info = GrB_Matrix_setElement_BOOL(RG_MATRIX_TM(adj), true, dest, src);
+		ASSERT(info == GrB_SUCCESS);
+	}
 
 	//--------------------------------------------------------------------------
 	// update relationship matrix
@@ -125,8 +127,10 @@ static void _OptimizedSingleEdgeFormConnection
 
 	info = GrB_Matrix_setElement_UINT64(m, edge_id, src, dest);
 	ASSERT(info == GrB_SUCCESS);
-	info = GrB_Matrix_setElement_UINT64(tm, edge_id, dest, src);
-	ASSERT(info == GrB_SUCCESS);
+	if(tm != NULL) {
+		info = GrB_Matrix_setElement_UINT64(tm, edge_id, dest, src);
+		ASSERT(info == GrB_SUCCESS);
+	}
 
 	// an edge of type r has just been created, update statistics
 	// TODO: stats->edge_count[relation_idx] += nvals;
@@ -147,7 +151,6 @@ void Serializer_Graph_SetEdge
 	GrB_Info info;
 
 	Entity *en = DataBlock_AllocateItemOutOfOrder(g->edges, edge_id);
-	en->prop_count = 0;
 	en->properties = NULL;
 	e->id = edge_id;
 	e->entity = en;
@@ -162,6 +165,200 @@ void Serializer_Graph_SetEdge
 	}
 }
 
+void Serializer_Graph_AllocEdge
+(
+	Graph *g,
+	EdgeID edge_id,
+	NodeID src,
+	NodeID dest,
+	int r,
+	Edge *e
+) {
+	ASSERT(g);
+
+	Entity *en = DataBlock_AllocateItemOutOfOrder(g->edges, edge_id);
+	en->properties = NULL;
+	e->id = edge_id;
+	e->entity = en;
+	e->relationID = r;
+	e->srcNodeID = src;
+	e->destNodeID = dest;
+}
+
+// adjacency matrix is the union of all relationship matrices
+// sets adjacency matrix entries wherever 'm' and 'tm' hold an entry
+static void _UpdateAdjacencyMatrix
+(
+	Graph *g,
+	GrB_Matrix m,   // relation matrix
+	GrB_Matrix tm   // transposed relation matrix, NULL if not maintained
+) {
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index  nrows;
+	GrB_Index  ncols;
+	RG_Matrix  adj    =  Graph_GetAdjacencyMatrixForUpdate(g);
+
+	// a derived adjacency matrix is recomputed on its next read
+	if(adj == NULL) return;
+
+	GrB_Matrix adj_m  =  RG_MATRIX_M(adj);
+	GrB_Matrix adj_tm =  RG_MATRIX_TM(adj);
+
+	info = GrB_Matrix_nrows(&nrows, adj_m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, adj_m);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_Matrix_assign_BOOL(adj_m, m, NULL, true, GrB_ALL, nrows,
+			GrB_ALL, ncols, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+	if(tm != NULL) {
+		info = GrB_Matrix_assign_BOOL(adj_tm, tm, NULL, true, GrB_ALL, ncols,
+				GrB_ALL, nrows, GrB_DESC_S);
+	} else {
+		info = GrB_Matrix_eWiseAdd_Semiring(adj_tm, NULL, NULL,
+				GxB_ANY_PAIR_BOOL, adj_tm, m, GrB_DESC_T1);
+	}
+	ASSERT(info == GrB_SUCCESS);
+}
+
+// order edges by source, destination and ID
+#define PENDING_EDGE_LT(a, b) ((a)->src != (b)->src ? (a)->src < (b)->src : \
+		(a)->dest != (b)->dest ? (a)->dest < (b)->dest : (a)->id < (b)->id)
+
+void Serializer_Graph_SetRelationEdges
+(
+	Graph *g,
+	bool multi_edge,
+	int r,
+	PendingEdge *edges,
+	uint64_t edge_count
+) {
+	ASSERT(g);
+	ASSERT(edges != NULL || edge_count == 0);
+
+	if(edge_count == 0) return;
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index  nvals  =  0;
+	RG_Matrix  M      =  Graph_GetRelationMatrix(g, r, false);
+	GrB_Matrix m      =  RG_MATRIX_M(M);
+	GrB_Matrix tm     =  RG_MATRIX_MAINTAIN_TRANSPOSE(M) ? RG_MATRIX_TM(M) : NULL;
+
+	info = GrB_Matrix_nvals(&nvals, m);
+	ASSERT(info == GrB_SUCCESS && nvals == 0);
+
+	// bring multiple edges connecting the same pair of nodes together
+	if(multi_edge) QSORT(PendingEdge, edges, edge_count, PENDING_EDGE_LT);
+
+	GrB_Index *rows = rm_malloc(sizeof(GrB_Index) * edge_count);
+	GrB_Index *cols = rm_malloc(sizeof(GrB_Index) * edge_count);
+	uint64_t  *vals = rm_malloc(sizeof(uint64_t)  * edge_count);
+	bool      *pattern = rm_malloc(sizeof(bool)   * edge_count);
+	EdgeID    *ids     = multi_edge ? rm_malloc(sizeof(EdgeID) * edge_count)
+		: NULL;
+
+	// a single entry per connected pair of nodes
+	// holding either an edge ID or an array of edge IDs
+	for(uint64_t i = 0; i < edge_count;) {
+		uint64_t j = i + 1;
+		while(j < edge_count && edges[j].src == edges[i].src &&
+			  edges[j].dest == edges[i].dest) j++;
+
+		rows[nvals]    = edges[i].src;
+		cols[nvals]    = edges[i].dest;
+		pattern[nvals] = true;
+
+		if(j - i == 1) {
+			vals[nvals] = edges[i].id;
+		} else {
+			for(uint64_t k = i; k < j; k++) ids[k - i] = edges[k].id;
+			vals[nvals] = RG_Matrix_newMultiEdge(M, ids, j - i);
+		}
+
+		nvals++;
+		i = j;
+	}
+
+	//--------------------------------------------------------------------------
+	// build relationship matrix and its transpose
+	//--------------------------------------------------------------------------
+
+	info = GrB_Matrix_build_UINT64(m, rows, cols, vals, nvals,
+			GrB_FIRST_UINT64);
+	ASSERT(info == GrB_SUCCESS);
+	if(tm != NULL) {
+		info = GrB_Matrix_build_BOOL(tm, cols, rows, pattern, nvals, GrB_LOR);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	_UpdateAdjacencyMatrix(g, m, tm);
+
+	rm_free(rows);
+	rm_free(cols);
+	rm_free(vals);
+	rm_free(pattern);
+	if(ids != NULL) rm_free(ids);
+
+	GraphStatistics_IncEdgeCount(&g->stats, r, edge_count);
+}
+
+void Serializer_Graph_SetRelationMatrix
+(
+	Graph *g,
+	int r,
+	GrB_Matrix *A,
+	uint64_t edge_count
+) {
+	ASSERT(g);
+	ASSERT(A != NULL && *A != NULL);
+
+	GrB_Info info;
+	UNUSED(info);
+
+	GrB_Index  nvals;
+	GrB_Index  dim  =  Graph_RequiredMatrixDim(g);
+	RG_Matrix  M    =  Graph_GetRelationMatrix(g, r, false);
+	RG_Matrix  adj  =  Graph_GetAdjacencyMatrixForUpdate(g);
+
+	info = RG_Matrix_nvals(&nvals, M);
+	ASSERT(info == GrB_SUCCESS && nvals == 0);
+
+	// replace relation matrix, 'A' might have been encoded with different
+	// dimensions, all of its entries are within the graph's node range
+	info = GrB_Matrix_free(&RG_MATRIX_M(M));
+	ASSERT(info == GrB_SUCCESS);
+	RG_MATRIX_M(M) = *A;
+	*A = NULL;
+
+	info = RG_Matrix_resize(M, dim, dim);
+	ASSERT(info == GrB_SUCCESS);
+	if(adj != NULL) {
+		info = RG_Matrix_resize(adj, dim, dim);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	//--------------------------------------------------------------------------
+	// compute transposed relation matrix
+	//--------------------------------------------------------------------------
+
+	GrB_Matrix m  = RG_MATRIX_M(M);
+	GrB_Matrix tm = NULL;
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(M)) {
+		tm = RG_MATRIX_TM(M);
+		info = GrB_Matrix_apply(tm, NULL, NULL, GxB_ONE_BOOL, m, GrB_DESC_T0);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	_UpdateAdjacencyMatrix(g, m, tm);
+
+	GraphStatistics_IncEdgeCount(&g->stats, r, edge_count);
+}
+
 // returns the graph deleted nodes list
 uint64_t *Serializer_Graph_GetDeletedNodesList
 (
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "decode_context.h"
 #include "../graph/graph.h"
 
 // sets a node in the graph
@@ -36,6 +37,40 @@ void Serializer_Graph_SetEdge
 	Edge *e                 // pointer to edge
 );
 
+// allocates an edge without connecting it
+// the edge connection is introduced by Serializer_Graph_SetRelationEdges
+void Serializer_Graph_AllocEdge
+(
+	Graph *g,               // graph to add edge to
+	EdgeID edge_id,         // edge ID
+	NodeID src,             // edge source
+	NodeID dest,            // edge destination
+	int r,                  // edge relationship-type
+	Edge *e                 // pointer to edge
+);
+
+// constructs relationship matrix 'r' out of 'edges' in a single build
+// the relation matrix 'r' must be empty
+// 'edges' is reordered
+void Serializer_Graph_SetRelationEdges
+(
+	Graph *g,               // graph to add edges to
+	bool multi_edge,        // true if edges may share source and destination
+	int r,                  // edges relationship-type
+	PendingEdge *edges,     // edge connections
+	uint64_t edge_count     // number of edges
+);
+
+// sets 'A' as relationship matrix 'r', taking ownership of 'A'
+// the relation matrix 'r' must be empty
+void Serializer_Graph_SetRelationMatrix
+(
+	Graph *g,               // graph to add edges to
+	int r,                  // edges relationship-type
+	GrB_Matrix *A,          // relation matrix, set to NULL
+	uint64_t edge_count     // number of edges in 'A'
+);
+
 // marks a node ID as deleted
 void Serializer_Graph_MarkNodeDeleted
 (
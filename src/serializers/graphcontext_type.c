@@ -6,11 +6,14 @@
 
 #include "graphcontext_type.h"
 #include "../version.h"
+#include "aof_rewrite.h"
 #include "encoding_version.h"
 #include "encoder/encode_graph.h"
 #include "decoders/decode_graph.h"
 #include "decoders/decode_previous.h"
+#include "../util/arr.h"
 #include "../util/redis_version.h"
+#include "../commands/plan_warmup.h"
 
 // forward declerations of the module event handler functions
 void ModuleEventHandler_AUXBeforeKeyspaceEvent(void);
@@ -49,15 +52,64 @@ static void _GraphContextType_RdbSave(RedisModuleIO *rdb, void *value) {
 	RdbSaveGraph(rdb, value);
 }
 
-// save an unsigned placeholder before and after the keyspace encoding
+// rewrite graph as a compact sequence of GRAPH.EFFECT commands
+static void _GraphContextType_AofRewrite(RedisModuleIO *aof,
+		RedisModuleString *key, void *value) {
+	AofRewriteGraph(aof, key, value);
+}
+
+extern GraphContext **graphs_in_keyspace;
+
+// version of the values saved after the keyspace
+// 0 - each graph's name and commit sequence
+// 1 - followed by the graph's most executed queries
+#define AUX_VERSION 1
+
+// version saved before the keyspace of the snapshot being loaded
+static uint64_t loaded_aux_version = 0;
+
+// save the aux version before the keyspace encoding
+// after the keyspace, save the number of graphs followed by each graph's
+// name and commit sequence, such that replicas loading the snapshot
+// continue from the master's sequence, and its most executed queries
+// which are re-planned once loading ends
 static void _GraphContextType_AuxSave(RedisModuleIO *rdb, int when) {
-	RedisModule_SaveUnsigned(rdb, 0);
+	if(when == REDISMODULE_AUX_BEFORE_RDB) {
+		RedisModule_SaveUnsigned(rdb, AUX_VERSION);
+		return;
+	}
+
+	uint n = array_len(graphs_in_keyspace);
+	RedisModule_SaveUnsigned(rdb, n);
+	for(uint i = 0; i < n; i++) {
+		GraphContext *gc = graphs_in_keyspace[i];
+		RedisModule_SaveStringBuffer(rdb, gc->graph_name,
+				strlen(gc->graph_name) + 1);
+		RedisModule_SaveUnsigned(rdb, GraphContext_CommitSeq(gc));
+		PlanWarmup_Save(rdb, gc);
+	}
 }
 
-// decode the unsigned placeholders saved before and after the keyspace values
+// decode the values saved before and after the keyspace values
 // and call the module event handler
+// snapshots prior to commit sequences save a 0 placeholder after the keyspace
+// snapshots prior to the aux version save a 0 placeholder before the keyspace
 static int _GraphContextType_AuxLoad(RedisModuleIO *rdb, int encver, int when) {
-	RedisModule_LoadUnsigned(rdb);
+	uint64_t n = RedisModule_LoadUnsigned(rdb);
+
+	if(when == REDISMODULE_AUX_BEFORE_RDB) loaded_aux_version = n;
+
+	if(when == REDISMODULE_AUX_AFTER_RDB) {
+		for(uint64_t i = 0; i < n; i++) {
+			char *name = RedisModule_LoadStringBuffer(rdb, NULL);
+			uint64_t seq = RedisModule_LoadUnsigned(rdb);
+			GraphContext *gc = GraphContext_GetRegisteredGraphContext(name);
+			if(gc != NULL) GraphContext_SetCommitSeq(gc, seq);
+			if(loaded_aux_version >= 1) PlanWarmup_Load(rdb, name);
+			RedisModule_Free(name);
+		}
+	}
+
 	if(when == REDISMODULE_AUX_BEFORE_RDB) ModuleEventHandler_AUXBeforeKeyspaceEvent();
 	else ModuleEventHandler_AUXAfterKeyspaceEvent();
 	return REDISMODULE_OK;
@@ -74,6 +126,7 @@ int GraphContextType_Register(RedisModuleCtx *ctx) {
 	tm.version            =  REDISMODULE_TYPE_METHOD_VERSION;
 	tm.rdb_load           =  _GraphContextType_RdbLoad;
 	tm.rdb_save           =  _GraphContextType_RdbSave;
+	tm.aof_rewrite        =  _GraphContextType_AofRewrite;
 	tm.aux_save           =  _GraphContextType_AuxSave;
 	tm.aux_load           =  _GraphContextType_AuxLoad;
 	tm.aux_save_triggers  =  REDISMODULE_AUX_BEFORE_RDB | REDISMODULE_AUX_AFTER_RDB;
@@ -0,0 +1,159 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "serializer_io.h"
+#include "../RG.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+// recorded value types
+enum {
+	SERIALIZER_UNSIGNED,
+	SERIALIZER_SIGNED,
+	SERIALIZER_DOUBLE,
+	SERIALIZER_BUFFER,
+	SERIALIZER_OWNED_BUFFER
+};
+
+SerializerIO SerializerIO_FromRdb
+(
+	RedisModuleIO *rdb
+) {
+	ASSERT(rdb != NULL);
+	return (SerializerIO) {.rdb = rdb, .records = NULL};
+}
+
+SerializerIO SerializerIO_Recorder(void) {
+	return (SerializerIO) {.rdb = NULL,
+		.records = array_new(SerializerRecord, 1024)};
+}
+
+void SerializerIO_WriteUnsigned
+(
+	SerializerIO *io,
+	uint64_t value
+) {
+	if(io->rdb) {
+		RedisModule_SaveUnsigned(io->rdb, value);
+	} else {
+		SerializerRecord r = {.type = SERIALIZER_UNSIGNED, .u = value};
+		array_append(io->records, r);
+	}
+}
+
+void SerializerIO_WriteSigned
+(
+	SerializerIO *io,
+	int64_t value
+) {
+	if(io->rdb) {
+		RedisModule_SaveSigned(io->rdb, value);
+	} else {
+		SerializerRecord r = {.type = SERIALIZER_SIGNED, .i = value};
+		array_append(io->records, r);
+	}
+}
+
+void SerializerIO_WriteDouble
+(
+	SerializerIO *io,
+	double value
+) {
+	if(io->rdb) {
+		RedisModule_SaveDouble(io->rdb, value);
+	} else {
+		SerializerRecord r = {.type = SERIALIZER_DOUBLE, .d = value};
+		array_append(io->records, r);
+	}
+}
+
+void SerializerIO_WriteBuffer
+(
+	SerializerIO *io,
+	const char *buf,
+	size_t len
+) {
+	if(io->rdb) {
+		RedisModule_SaveStringBuffer(io->rdb, buf, len);
+	} else {
+		SerializerRecord r = {.type = SERIALIZER_BUFFER, .str = {buf, len}};
+		array_append(io->records, r);
+	}
+}
+
+void SerializerIO_TransferBuffer
+(
+	SerializerIO *io,
+	char *buf,
+	size_t len
+) {
+	if(io->rdb) {
+		RedisModule_SaveStringBuffer(io->rdb, buf, len);
+		rm_free(buf);
+	} else {
+		SerializerRecord r = {.type = SERIALIZER_OWNED_BUFFER,
+			.str = {buf, len}};
+		array_append(io->records, r);
+	}
+}
+
+// free buffers owned by the recording
+static void _SerializerIO_FreeOwnedBuffers
+(
+	SerializerIO *recorder
+) {
+	uint n = array_len(recorder->records);
+	for(uint i = 0; i < n; i++) {
+		SerializerRecord *r = recorder->records + i;
+		if(r->type == SERIALIZER_OWNED_BUFFER) rm_free((char *)r->str.s);
+	}
+}
+
+void SerializerIO_Replay
+(
+	SerializerIO *recorder,
+	RedisModuleIO *rdb
+) {
+	ASSERT(rdb != NULL);
+	ASSERT(recorder->rdb == NULL);
+
+	uint n = array_len(recorder->records);
+	for(uint i = 0; i < n; i++) {
+		const SerializerRecord *r = recorder->records + i;
+		switch(r->type) {
+			case SERIALIZER_UNSIGNED:
+				RedisModule_SaveUnsigned(rdb, r->u);
+				break;
+			case SERIALIZER_SIGNED:
+				RedisModule_SaveSigned(rdb, r->i);
+				break;
+			case SERIALIZER_DOUBLE:
+				RedisModule_SaveDouble(rdb, r->d);
+				break;
+			case SERIALIZER_BUFFER:
+			case SERIALIZER_OWNED_BUFFER:
+				RedisModule_SaveStringBuffer(rdb, r->str.s, r->str.len);
+				break;
+			default:
+				ASSERT(false && "unknown serializer record type");
+				break;
+		}
+	}
+
+	_SerializerIO_FreeOwnedBuffers(recorder);
+	array_clear(recorder->records);
+}
+
+void SerializerIO_Free
+(
+	SerializerIO *io
+) {
+	if(io->records != NULL) {
+		_SerializerIO_FreeOwnedBuffers(io);
+		array_free(io->records);
+		io->records = NULL;
+	}
+}
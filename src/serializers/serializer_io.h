@@ -0,0 +1,99 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../redismodule.h"
+
+// SerializerIO is the sink encoders write to
+// it either writes directly to an RDB stream
+// or records the written values into memory, to be replayed onto an RDB
+// stream at a later point, allowing entities to be encoded concurrently
+// while the RDB stream itself is written to sequentially
+//
+// recorded string buffers are not copied, the caller must keep them alive
+// until the recording is replayed
+
+// a single recorded value
+typedef struct {
+	uint8_t type;           // value type
+	union {
+		uint64_t u;         // unsigned value
+		int64_t i;          // signed value
+		double d;           // double value
+		struct {
+			const char *s;  // borrowed string buffer
+			size_t len;     // buffer length
+		} str;
+	};
+} SerializerRecord;
+
+typedef struct {
+	RedisModuleIO *rdb;         // RDB stream, NULL when recording
+	SerializerRecord *records;  // recorded values
+} SerializerIO;
+
+// create a serializer writing directly to 'rdb'
+SerializerIO SerializerIO_FromRdb
+(
+	RedisModuleIO *rdb
+);
+
+// create a serializer recording values into memory
+SerializerIO SerializerIO_Recorder(void);
+
+// write an unsigned value
+void SerializerIO_WriteUnsigned
+(
+	SerializerIO *io,
+	uint64_t value
+);
+
+// write a signed value
+void SerializerIO_WriteSigned
+(
+	SerializerIO *io,
+	int64_t value
+);
+
+// write a double value
+void SerializerIO_WriteDouble
+(
+	SerializerIO *io,
+	double value
+);
+
+// write a string buffer
+void SerializerIO_WriteBuffer
+(
+	SerializerIO *io,
+	const char *buf,
+	size_t len
+);
+
+// write a string buffer and take ownership of it
+// 'buf' is freed once written, or once the recording is replayed or freed
+void SerializerIO_TransferBuffer
+(
+	SerializerIO *io,
+	char *buf,
+	size_t len
+);
+
+// write all values recorded by 'recorder' to 'rdb' and clear the recording
+void SerializerIO_Replay
+(
+	SerializerIO *recorder,
+	RedisModuleIO *rdb
+);
+
+// free serializer, 'rdb' is not closed
+void SerializerIO_Free
+(
+	SerializerIO *io
+);
@@ -0,0 +1,117 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "query_capture.h"
+#include "../redismodule.h"
+#include "../configuration/config.h"
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#define QUERY_CAPTURE_MAGIC "RGCAPTUR"
+
+static FILE *_file = NULL;       // capture file, opened on first capture
+static uint64_t _queries = 0;    // number of queries counted for sampling
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;  // guards _file
+
+static inline void _WriteString
+(
+	const char *s
+) {
+	uint32_t len = strlen(s);
+	fwrite(&len, sizeof(len), 1, _file);
+	fwrite(s, 1, len, _file);
+}
+
+// opens the capture file for append, writing its header if new
+// must be called with _lock held
+static bool _Open(void) {
+	_file = fopen(QUERY_CAPTURE_FILE, "ab");
+	if(_file == NULL) {
+		RedisModule_Log(NULL, "warning", "Failed to open query capture file %s",
+				QUERY_CAPTURE_FILE);
+		return false;
+	}
+
+	if(ftell(_file) == 0) {
+		uint32_t version = QUERY_CAPTURE_VERSION;
+		fwrite(QUERY_CAPTURE_MAGIC, 1, strlen(QUERY_CAPTURE_MAGIC), _file);
+		fwrite(&version, sizeof(version), 1, _file);
+	}
+
+	return true;
+}
+
+// rotates the capture file once it grew past its maximum size
+// must be called with _lock held
+static bool _Rotate(void) {
+	if(ftell(_file) < QUERY_CAPTURE_MAX_FILE_SIZE) return true;
+
+	fclose(_file);
+	_file = NULL;
+	rename(QUERY_CAPTURE_FILE, QUERY_CAPTURE_FILE ".1");
+
+	return _Open();
+}
+
+void QueryCapture_Add
+(
+	const char *graph,
+	const char *command,
+	const char *query,
+	double latency,
+	uint64_t rows,
+	uint8_t flags
+) {
+	ASSERT(graph   != NULL);
+	ASSERT(query   != NULL);
+	ASSERT(command != NULL);
+
+	uint64_t rate;
+	Config_Option_get(Config_CAPTURE_SAMPLE_RATE, &rate);
+	if(rate == 0) return;
+
+	uint64_t n = __atomic_fetch_add(&_queries, 1, __ATOMIC_RELAXED);
+	if((n % rate) != 0) return;
+
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	uint64_t time = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+	uint32_t len = sizeof(time) + sizeof(latency) + sizeof(rows) +
+		sizeof(flags) + 3 * sizeof(uint32_t) + strlen(graph) +
+		strlen(command) + strlen(query);
+
+	pthread_mutex_lock(&_lock);
+
+	if((_file != NULL || _Open()) && _Rotate()) {
+		fwrite(&len,     sizeof(len),     1, _file);
+		fwrite(&time,    sizeof(time),    1, _file);
+		fwrite(&latency, sizeof(latency), 1, _file);
+		fwrite(&rows,    sizeof(rows),    1, _file);
+		fwrite(&flags,   sizeof(flags),   1, _file);
+		_WriteString(graph);
+		_WriteString(command);
+		_WriteString(query);
+		// keep the capture readable while the server is running
+		fflush(_file);
+	}
+
+	pthread_mutex_unlock(&_lock);
+}
+
+void QueryCapture_Close(void) {
+	pthread_mutex_lock(&_lock);
+
+	if(_file != NULL) {
+		fclose(_file);
+		_file = NULL;
+	}
+
+	pthread_mutex_unlock(&_lock);
+}
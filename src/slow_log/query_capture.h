@@ -0,0 +1,55 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// query capture logs a sample of the executed queries to a binary file
+// which can be replayed against a build by tests/benchmarks/replay.py
+// one in every CAPTURE_SAMPLE_RATE queries is captured, 0 disables capture
+//
+// the file is created within the Redis working directory
+// once it exceeds QUERY_CAPTURE_MAX_FILE_SIZE bytes it is rotated
+// replacing the previously rotated file
+//
+// file layout, integers are little endian:
+//   header: magic "RGCAPTUR" followed by a uint32 format version
+//   record: uint32 record length, excluding the length field itself
+//           uint64 capture time, microseconds since epoch
+//           double latency, milliseconds
+//           uint64 number of rows returned
+//           uint8  flags, QUERY_CAPTURE_READONLY | QUERY_CAPTURE_COMPACT |
+//                  QUERY_CAPTURE_ARROW | QUERY_CAPTURE_JSON
+//           graph name, command name and query
+//           each as a uint32 length followed by its bytes
+//           the query includes its parameters, e.g. "CYPHER a=1 RETURN $a"
+
+#define QUERY_CAPTURE_FILE          "redisgraph_capture.bin"
+#define QUERY_CAPTURE_MAX_FILE_SIZE (64 * 1024 * 1024)
+#define QUERY_CAPTURE_VERSION       1
+
+// capture record flags
+#define QUERY_CAPTURE_READONLY 0x1  // query was executed as read only
+#define QUERY_CAPTURE_COMPACT  0x2  // query was issued with --compact
+#define QUERY_CAPTURE_ARROW    0x4  // query was issued with --arrow
+#define QUERY_CAPTURE_JSON     0x8  // query was issued with --json
+
+// counts an executed query, capturing it if sampled
+// safe to call concurrently
+void QueryCapture_Add
+(
+	const char *graph,    // graph name
+	const char *command,  // command name, e.g. GRAPH.QUERY
+	const char *query,    // query string, including parameters
+	double latency,       // execution time in milliseconds
+	uint64_t rows,        // number of rows returned
+	uint8_t flags         // capture record flags
+);
+
+// closes the capture file, a later capture reopens it
+void QueryCapture_Close(void);
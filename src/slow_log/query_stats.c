@@ -0,0 +1,202 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "../../deps/rax/rax.h"
+#include "query_stats.h"
+#include "../util/rmalloc.h"
+#include "../util/histogram.h"
+#include <ctype.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+
+// statistics of a single query shape
+typedef struct {
+	uint64_t rows;        // total number of rows returned
+	Histogram latency;    // latency histogram, in microseconds
+} QueryShapeStats;
+
+struct QueryStats {
+	rax *shapes;              // query shape to QueryShapeStats
+	pthread_rwlock_t rwlock;  // guards shapes, not their content
+};
+
+// see _ReplyWithRoundedDouble in slow_log.c
+static inline void _ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
+	int len = snprintf(NULL, 0, "%.5g", d);
+	char str[len + 1];
+	sprintf(str, "%.5g", d);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+static inline bool _IdentifierChar(char c) {
+	return isalnum((unsigned char)c) || c == '_';
+}
+
+QueryStats *QueryStats_New(void) {
+	QueryStats *stats = rm_malloc(sizeof(QueryStats));
+	stats->shapes = raxNew();
+
+	int res = pthread_rwlock_init(&stats->rwlock, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return stats;
+}
+
+sds QueryStats_Shape(const char *query) {
+	ASSERT(query != NULL);
+
+	sds shape = sdsempty();
+	const char *c = query;
+	char prev = ' ';  // last char appended to shape
+
+	while(*c != '\0') {
+		const char *start = c;
+
+		if(isspace((unsigned char)*c)) {
+			// collapse whitespace
+			while(isspace((unsigned char)*c)) c++;
+			if(prev != ' ') {
+				shape = sdscatlen(shape, " ", 1);
+				prev = ' ';
+			}
+			continue;
+		}
+
+		if(*c == '\'' || *c == '"') {
+			// string literal
+			char quote = *c++;
+			while(*c != '\0' && *c != quote) {
+				if(*c == '\\' && c[1] != '\0') c++;
+				c++;
+			}
+			if(*c != '\0') c++;
+			shape = sdscatlen(shape, "?", 1);
+			prev = '?';
+			continue;
+		}
+
+		if(isdigit((unsigned char)*c) && !_IdentifierChar(prev)) {
+			// numeric literal, avoid swallowing range dots, e.g. [*1..3]
+			while(_IdentifierChar(*c) || (*c == '.' && c[1] != '.')) c++;
+			shape = sdscatlen(shape, "?", 1);
+			prev = '?';
+			continue;
+		}
+
+		if(*c == '`') {
+			// escaped identifier, keep as is
+			c = strchr(c + 1, '`');
+			c = (c == NULL) ? start + strlen(start) : c + 1;
+			shape = sdscatlen(shape, start, c - start);
+			prev = c[-1];
+			continue;
+		}
+
+		shape = sdscatlen(shape, c++, 1);
+		prev = *start;
+	}
+
+	// trim trailing whitespace
+	if(prev == ' ' && sdslen(shape) > 0) sdsrange(shape, 0, -2);
+
+	return shape;
+}
+
+void QueryStats_Add
+(
+	QueryStats *stats,
+	const char *query,
+	double latency,
+	uint64_t rows
+) {
+	ASSERT(stats != NULL);
+	ASSERT(query != NULL);
+
+	sds shape = QueryStats_Shape(query);
+	size_t len = sdslen(shape);
+	uint64_t us = (latency > 0) ? (uint64_t)(latency * 1000) : 0;
+
+	// common case, shape is already tracked
+	pthread_rwlock_rdlock(&stats->rwlock);
+	QueryShapeStats *s = raxFind(stats->shapes, (unsigned char *)shape, len);
+	if(s != raxNotFound) {
+		Histogram_Record(&s->latency, us);
+		__atomic_fetch_add(&s->rows, rows, __ATOMIC_RELAXED);
+	}
+	pthread_rwlock_unlock(&stats->rwlock);
+
+	if(s == raxNotFound) {
+		pthread_rwlock_wrlock(&stats->rwlock);
+		// shape might have been introduced concurrently
+		s = raxFind(stats->shapes, (unsigned char *)shape, len);
+		if(s == raxNotFound &&
+		   raxSize(stats->shapes) < QUERY_STATS_MAX_SHAPES) {
+			s = rm_malloc(sizeof(QueryShapeStats));
+			s->rows = 0;
+			Histogram_Reset(&s->latency);
+			raxInsert(stats->shapes, (unsigned char *)shape, len, s, NULL);
+		}
+		if(s != raxNotFound) {
+			Histogram_Record(&s->latency, us);
+			s->rows += rows;
+		}
+		pthread_rwlock_unlock(&stats->rwlock);
+	}
+
+	sdsfree(shape);
+}
+
+void QueryStats_Replay(QueryStats *stats, RedisModuleCtx *ctx) {
+	ASSERT(stats != NULL);
+	ASSERT(ctx   != NULL);
+
+	pthread_rwlock_rdlock(&stats->rwlock);
+
+	RedisModule_ReplyWithArray(ctx, raxSize(stats->shapes));
+
+	raxIterator it;
+	raxStart(&it, stats->shapes);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		QueryShapeStats *s = it.data;
+		const Histogram *h = &s->latency;
+
+		RedisModule_ReplyWithArray(ctx, 8);
+		RedisModule_ReplyWithStringBuffer(ctx, (const char *)it.key,
+				it.key_len);
+		RedisModule_ReplyWithLongLong(ctx, Histogram_Count(h));
+		_ReplyWithRoundedDouble(ctx, Histogram_Sum(h) / 1000.0);
+		RedisModule_ReplyWithLongLong(ctx,
+				__atomic_load_n(&s->rows, __ATOMIC_RELAXED));
+		_ReplyWithRoundedDouble(ctx, Histogram_Percentile(h, 50) / 1000.0);
+		_ReplyWithRoundedDouble(ctx, Histogram_Percentile(h, 95) / 1000.0);
+		_ReplyWithRoundedDouble(ctx, Histogram_Percentile(h, 99) / 1000.0);
+		_ReplyWithRoundedDouble(ctx, Histogram_Max(h) / 1000.0);
+	}
+	raxStop(&it);
+
+	pthread_rwlock_unlock(&stats->rwlock);
+}
+
+void QueryStats_Reset(QueryStats *stats) {
+	ASSERT(stats != NULL);
+
+	pthread_rwlock_wrlock(&stats->rwlock);
+	raxFreeWithCallback(stats->shapes, rm_free);
+	stats->shapes = raxNew();
+	pthread_rwlock_unlock(&stats->rwlock);
+}
+
+void QueryStats_Free(QueryStats *stats) {
+	ASSERT(stats != NULL);
+
+	raxFreeWithCallback(stats->shapes, rm_free);
+	pthread_rwlock_destroy(&stats->rwlock);
+	rm_free(stats);
+}
@@ -0,0 +1,58 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "../redismodule.h"
+#include "../util/sds/sds.h"
+
+// max number of distinct query shapes tracked per graph
+#define QUERY_STATS_MAX_SHAPES 1024
+
+// QueryStats aggregates query latencies by query shape
+// a query's shape is the query with all of its literals replaced by '?'
+// such that queries which differ only by their literals are grouped together
+typedef struct QueryStats QueryStats;
+
+// create a new query statistics container
+QueryStats *QueryStats_New(void);
+
+// normalize query into its shape
+// the returned string is owned by the caller
+sds QueryStats_Shape
+(
+	const char *query
+);
+
+// record a single execution of query
+// safe to call concurrently
+void QueryStats_Add
+(
+	QueryStats *stats,  // statistics container
+	const char *query,  // executed query
+	double latency,     // execution time in milliseconds
+	uint64_t rows       // number of rows returned
+);
+
+// replies with the per shape statistics
+void QueryStats_Replay
+(
+	QueryStats *stats,
+	RedisModuleCtx *ctx
+);
+
+// discard all collected statistics
+void QueryStats_Reset
+(
+	QueryStats *stats
+);
+
+// free query statistics container
+void QueryStats_Free
+(
+	QueryStats *stats
+);
@@ -0,0 +1,208 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "query_trace.h"
+#include "../util/rmalloc.h"
+#include "../configuration/config.h"
+#include <time.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+// a kept trace
+typedef struct {
+	char *cmd;           // command name
+	char *query;         // query string
+	double latency;      // execution time in milliseconds
+	QueryTrace trace;    // phase timestamps
+} QueryTraceItem;
+
+struct QueryTraceLog {
+	QueryTraceItem items[QUERY_TRACE_LOG_SIZE];  // ring buffer
+	uint count;                                  // number of kept traces
+	uint next;                                   // next slot to write
+	uint64_t queries;                            // queries counted for sampling
+	pthread_mutex_t lock;                        // guards items
+};
+
+// phase names, indexed by the event ending the phase
+static const char *_phase_names[QUERY_TRACE_EVENT_COUNT] = {
+	[QUERY_TRACE_RECEIVED]        = NULL,
+	[QUERY_TRACE_DEQUEUED]        = "queue",
+	[QUERY_TRACE_PARAMS_PARSED]   = "params",
+	[QUERY_TRACE_PLANNED]         = "plan",
+	[QUERY_TRACE_WRITER_DEQUEUED] = "writer_queue",
+	[QUERY_TRACE_LOCKED]          = "lock",
+	[QUERY_TRACE_PREPARED]        = "prepare",
+	[QUERY_TRACE_EXECUTED]        = "execute",
+	[QUERY_TRACE_REPLIED]         = "reply",
+	[QUERY_TRACE_LOGGED]          = "log",
+};
+
+// see _ReplyWithRoundedDouble in slow_log.c
+static inline void _ReplyWithRoundedDouble(RedisModuleCtx *ctx, double d) {
+	int len = snprintf(NULL, 0, "%.5g", d);
+	char str[len + 1];
+	sprintf(str, "%.5g", d);
+	RedisModule_ReplyWithStringBuffer(ctx, str, len);
+}
+
+static void _QueryTraceItem_Clear(QueryTraceItem *item) {
+	rm_free(item->cmd);
+	rm_free(item->query);
+	item->cmd   = NULL;
+	item->query = NULL;
+}
+
+uint64_t QueryTrace_Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void QueryTrace_Record(QueryTrace *trace, QueryTraceEvent event, uint64_t ns) {
+	ASSERT(trace != NULL);
+	ASSERT(event < QUERY_TRACE_EVENT_COUNT);
+
+	trace->events[event] = ns;
+
+	if(event == QUERY_TRACE_RECEIVED) {
+		// anchor the trace to wall clock time
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		uint64_t now = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+		uint64_t elapsed = (QueryTrace_Now() - ns) / 1000;
+		trace->start = now - elapsed;
+	}
+}
+
+const char *QueryTrace_PhaseName(QueryTraceEvent event) {
+	ASSERT(event > QUERY_TRACE_RECEIVED && event < QUERY_TRACE_EVENT_COUNT);
+	return _phase_names[event];
+}
+
+double QueryTrace_PhaseTime(const QueryTrace *trace, QueryTraceEvent event) {
+	ASSERT(trace != NULL);
+	ASSERT(event > QUERY_TRACE_RECEIVED && event < QUERY_TRACE_EVENT_COUNT);
+
+	uint64_t end = trace->events[event];
+	if(end == 0) return 0;
+
+	// the phase starts at the closest preceding recorded event
+	for(int i = event - 1; i >= 0; i--) {
+		uint64_t start = trace->events[i];
+		if(start == 0) continue;
+		return (end > start) ? (end - start) / 1000000.0 : 0;
+	}
+
+	return 0;
+}
+
+void QueryTrace_Reply(const QueryTrace *trace, RedisModuleCtx *ctx) {
+	ASSERT(ctx   != NULL);
+	ASSERT(trace != NULL);
+
+	RedisModule_ReplyWithArray(ctx, (QUERY_TRACE_EVENT_COUNT - 1) * 2);
+	for(int i = QUERY_TRACE_RECEIVED + 1; i < QUERY_TRACE_EVENT_COUNT; i++) {
+		RedisModule_ReplyWithSimpleString(ctx, QueryTrace_PhaseName(i));
+		_ReplyWithRoundedDouble(ctx, QueryTrace_PhaseTime(trace, i));
+	}
+}
+
+QueryTraceLog *QueryTraceLog_New(void) {
+	QueryTraceLog *log = rm_calloc(1, sizeof(QueryTraceLog));
+
+	int res = pthread_mutex_init(&log->lock, NULL);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	return log;
+}
+
+void QueryTraceLog_Add(QueryTraceLog *log, const char *cmd, const char *query,
+		double latency, const QueryTrace *trace) {
+	ASSERT(log   != NULL);
+	ASSERT(cmd   != NULL);
+	ASSERT(query != NULL);
+	ASSERT(trace != NULL);
+
+	uint64_t rate;
+	Config_Option_get(Config_TRACE_SAMPLE_RATE, &rate);
+	if(rate == 0) return;
+
+	uint64_t n = __atomic_fetch_add(&log->queries, 1, __ATOMIC_RELAXED);
+	if((n % rate) != 0) return;
+
+	char *cmd_copy   = rm_strdup(cmd);
+	char *query_copy = rm_strdup(query);
+
+	pthread_mutex_lock(&log->lock);
+
+	// overwrite the oldest trace once the log is full
+	QueryTraceItem *item = log->items + log->next;
+	_QueryTraceItem_Clear(item);
+	item->cmd     = cmd_copy;
+	item->query   = query_copy;
+	item->latency = latency;
+	item->trace   = *trace;
+
+	log->next = (log->next + 1) % QUERY_TRACE_LOG_SIZE;
+	if(log->count < QUERY_TRACE_LOG_SIZE) log->count++;
+
+	pthread_mutex_unlock(&log->lock);
+}
+
+void QueryTraceLog_Replay(QueryTraceLog *log, RedisModuleCtx *ctx) {
+	ASSERT(log != NULL);
+	ASSERT(ctx != NULL);
+
+	pthread_mutex_lock(&log->lock);
+
+	RedisModule_ReplyWithArray(ctx, log->count);
+	for(uint i = 1; i <= log->count; i++) {
+		uint slot = (log->next + QUERY_TRACE_LOG_SIZE - i) % QUERY_TRACE_LOG_SIZE;
+		const QueryTraceItem *item = log->items + slot;
+
+		RedisModule_ReplyWithArray(ctx, 5);
+		RedisModule_ReplyWithLongLong(ctx, item->trace.start);
+		RedisModule_ReplyWithStringBuffer(ctx, item->cmd, strlen(item->cmd));
+		RedisModule_ReplyWithStringBuffer(ctx, item->query,
+				strlen(item->query));
+		_ReplyWithRoundedDouble(ctx, item->latency);
+		QueryTrace_Reply(&item->trace, ctx);
+	}
+
+	pthread_mutex_unlock(&log->lock);
+}
+
+void QueryTraceLog_Reset(QueryTraceLog *log) {
+	ASSERT(log != NULL);
+
+	pthread_mutex_lock(&log->lock);
+
+	for(uint i = 0; i < QUERY_TRACE_LOG_SIZE; i++) {
+		_QueryTraceItem_Clear(log->items + i);
+	}
+	log->count = 0;
+	log->next  = 0;
+
+	pthread_mutex_unlock(&log->lock);
+}
+
+void QueryTraceLog_Free(QueryTraceLog *log) {
+	ASSERT(log != NULL);
+
+	for(uint i = 0; i < QUERY_TRACE_LOG_SIZE; i++) {
+		_QueryTraceItem_Clear(log->items + i);
+	}
+
+	int res = pthread_mutex_destroy(&log->lock);
+	ASSERT(res == 0);
+	UNUSED(res);
+
+	rm_free(log);
+}
@@ -0,0 +1,106 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../redismodule.h"
+
+// max number of traces kept per graph
+#define QUERY_TRACE_LOG_SIZE 128
+
+// events marking the boundaries of a query's lifecycle phases
+// in the order they occur, events a query skips, e.g. queueing on the writer
+// thread for read queries, are never recorded
+typedef enum {
+	QUERY_TRACE_RECEIVED,         // command dispatched
+	QUERY_TRACE_DEQUEUED,         // picked up by an executing thread
+	QUERY_TRACE_PARAMS_PARSED,    // query parameters parsed
+	QUERY_TRACE_PLANNED,          // execution plan retrieved from cache or built
+	QUERY_TRACE_WRITER_DEQUEUED,  // picked up by the writer thread
+	QUERY_TRACE_LOCKED,           // graph lock acquired
+	QUERY_TRACE_PREPARED,         // execution plan prepared
+	QUERY_TRACE_EXECUTED,         // execution plan executed
+	QUERY_TRACE_REPLIED,          // result-set replied
+	QUERY_TRACE_LOGGED,           // slowlog and statistics updated
+	QUERY_TRACE_EVENT_COUNT
+} QueryTraceEvent;
+
+// a query's lifecycle phase timestamps
+typedef struct {
+	uint64_t start;                            // receive time, microseconds since epoch
+	uint64_t events[QUERY_TRACE_EVENT_COUNT];  // monotonic nanoseconds, 0 if not recorded
+} QueryTrace;
+
+// QueryTraceLog keeps the most recent sampled traces of a graph
+typedef struct QueryTraceLog QueryTraceLog;
+
+// current monotonic time in nanoseconds
+uint64_t QueryTrace_Now(void);
+
+// record 'event' as occurring at 'ns', see QueryTrace_Now
+void QueryTrace_Record
+(
+	QueryTrace *trace,
+	QueryTraceEvent event,
+	uint64_t ns
+);
+
+// name of the phase ending at 'event', e.g. "plan" for QUERY_TRACE_PLANNED
+const char *QueryTrace_PhaseName
+(
+	QueryTraceEvent event  // any event but QUERY_TRACE_RECEIVED
+);
+
+// time spent in the phase ending at 'event', in milliseconds
+// phases whose end event wasn't recorded take 0
+double QueryTrace_PhaseTime
+(
+	const QueryTrace *trace,
+	QueryTraceEvent event  // any event but QUERY_TRACE_RECEIVED
+);
+
+// replies with the trace's phases as a flat array of name, time pairs
+void QueryTrace_Reply
+(
+	const QueryTrace *trace,
+	RedisModuleCtx *ctx
+);
+
+// create a new trace log
+QueryTraceLog *QueryTraceLog_New(void);
+
+// counts an executed query, keeping its trace if sampled
+// one in every TRACE_SAMPLE_RATE queries is kept, 0 disables sampling
+// safe to call concurrently
+void QueryTraceLog_Add
+(
+	QueryTraceLog *log,       // trace log
+	const char *cmd,          // command name, e.g. GRAPH.QUERY
+	const char *query,        // query string
+	double latency,           // execution time in milliseconds
+	const QueryTrace *trace   // query trace
+);
+
+// replies with the kept traces, most recent first
+void QueryTraceLog_Replay
+(
+	QueryTraceLog *log,
+	RedisModuleCtx *ctx
+);
+
+// discard all kept traces
+void QueryTraceLog_Reset
+(
+	QueryTraceLog *log
+);
+
+// free trace log
+void QueryTraceLog_Free
+(
+	QueryTraceLog *log
+);
@@ -32,10 +32,12 @@ static SlowLogItem *_SlowLogItem_New
 	const char *cmd,
 	const char *query,
 	double latency,
-	time_t t
+	time_t t,
+	const QueryTrace *trace
 ) {
-	SlowLogItem *item = rm_malloc(sizeof(SlowLogItem));
+	SlowLogItem *item = rm_calloc(1, sizeof(SlowLogItem));
 	item->time = t;
+	if(trace) item->trace = *trace;
 	item->latency = latency;
 	item->cmd = rm_strdup(cmd);
 	item->query = rm_strdup(query);
@@ -86,17 +88,17 @@ static bool _SlowLog_Contains(const SlowLog *slowlog, int t_id, const char *cmd,
 SlowLog *SlowLog_New() {
 	SlowLog *slowlog = rm_malloc(sizeof(SlowLog));
 
-	// Redis main thread + writer threads + reader threads.
+	// Redis main thread + writer, reader and heavy threads.
 	int thread_count = ThreadPools_ThreadCount() + 1;
 
 	slowlog->count = thread_count;
-	slowlog->lookup = rm_malloc(sizeof(rax *) * thread_count);
-	slowlog->min_heap = rm_malloc(sizeof(heap_t *) * thread_count);
+	slowlog->lookup = rm_calloc(thread_count, sizeof(rax *));
+	slowlog->min_heap = rm_calloc(thread_count, sizeof(heap_t *));
 	slowlog->locks = rm_malloc(sizeof(pthread_mutex_t) * thread_count);
 
+	// a thread's lookup and heap are created once it logs its first item
+	// most graphs only ever see a few threads log into them, if any
 	for(int i = 0; i < thread_count; i++) {
-		slowlog->lookup[i] = raxNew();
-		slowlog->min_heap[i] = Heap_new(_slowlog_elem_compare, NULL);
 		int res = pthread_mutex_init(slowlog->locks + i, NULL);
 		ASSERT(res == 0);
 	}
@@ -105,7 +107,7 @@ SlowLog *SlowLog_New() {
 }
 
 void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
-				 double latency, time_t *t) {
+				 double latency, time_t *t, const QueryTrace *trace) {
 	ASSERT(slowlog && cmd && query && latency >= 0);
 
 	int res;
@@ -114,8 +116,6 @@ void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
 	time_t _time;
 	SlowLogItem *existing_item;
 	int t_id = ThreadPools_GetThreadID();
-	rax *lookup = slowlog->lookup[t_id];
-	heap_t *heap = slowlog->min_heap[t_id];
 	pthread_mutex_t *lock = slowlog->locks + t_id;
 
 	// initialise time
@@ -128,6 +128,13 @@ void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
 
 	{
 		// In critical section..
+		if(slowlog->lookup[t_id] == NULL) {
+			slowlog->lookup[t_id] = raxNew();
+			slowlog->min_heap[t_id] = Heap_new(_slowlog_elem_compare, NULL);
+		}
+		rax *lookup = slowlog->lookup[t_id];
+		heap_t *heap = slowlog->min_heap[t_id];
+
 		bool exists = _SlowLog_Contains(slowlog, t_id, cmd, query, &key, &existing_item);
 		size_t key_len = strlen(key);
 
@@ -136,6 +143,7 @@ void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
 			if(existing_item->latency < latency) {
 				existing_item->time = _time;
 				existing_item->latency = latency;
+				if(trace) existing_item->trace = *trace;
 			}
 			goto cleanup;
 		}
@@ -157,7 +165,8 @@ void SlowLog_Add(SlowLog *slowlog, const char *cmd, const char *query,
 		}
 
 		if(introduce_item) {
-			SlowLogItem *item = _SlowLogItem_New(cmd, query, latency, _time);
+			SlowLogItem *item = _SlowLogItem_New(cmd, query, latency, _time,
+					trace);
 			Heap_offer(slowlog->min_heap + t_id, item);
 			raxInsert(lookup, (unsigned char *)key, key_len, item, NULL);
 		}
@@ -169,7 +178,8 @@ cleanup:
 	free(key);
 }
 
-void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx) {
+void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx,
+		bool traces) {
 	SlowLog *aggregated_slowlog = SlowLog_New();
 	int my_t_id = ThreadPools_GetThreadID();
 
@@ -179,40 +189,68 @@ void SlowLog_Replay(const SlowLog *slowlog, RedisModuleCtx *ctx) {
 		{
 			// Critical section.
 			rax *lookup = slowlog->lookup[t_id];
-			raxIterator iter;
-			raxStart(&iter, lookup);
-			raxSeek(&iter, "^", NULL, 0);
-			while(raxNext(&iter)) {
-				SlowLogItem *item = iter.data;
-				SlowLog_Add(aggregated_slowlog, item->cmd, item->query,
-							item->latency, &item->time);
+			if(lookup != NULL) {
+				raxIterator iter;
+				raxStart(&iter, lookup);
+				raxSeek(&iter, "^", NULL, 0);
+				while(raxNext(&iter)) {
+					SlowLogItem *item = iter.data;
+					SlowLog_Add(aggregated_slowlog, item->cmd, item->query,
+								item->latency, &item->time, &item->trace);
+				}
+				raxStop(&iter);
 			}
-			raxStop(&iter);
 			// End of critical section.
 		}
 		if(my_t_id != t_id) pthread_mutex_unlock(slowlog->locks + t_id);
 	}
 
 	heap_t *heap = aggregated_slowlog->min_heap[my_t_id];
-	RedisModule_ReplyWithArray(ctx, Heap_count(heap));
+	RedisModule_ReplyWithArray(ctx, (heap != NULL) ? Heap_count(heap) : 0);
 
-	while(Heap_count(heap)) {
+	while(heap != NULL && Heap_count(heap)) {
 		SlowLogItem *item = Heap_poll(heap);
-		RedisModule_ReplyWithArray(ctx, 4);
+		RedisModule_ReplyWithArray(ctx, traces ? 5 : 4);
 		RedisModule_ReplyWithDouble(ctx, item->time);
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->cmd, strlen(item->cmd));
 		RedisModule_ReplyWithStringBuffer(ctx, (const char *)item->query, strlen(item->query));
 		_ReplyWithRoundedDouble(ctx, item->latency);
+		if(traces) QueryTrace_Reply(&item->trace, ctx);
 	}
 
 	SlowLog_Free(aggregated_slowlog);
 }
 
+void SlowLog_Reset(SlowLog *slowlog) {
+	ASSERT(slowlog);
+
+	for(int t_id = 0; t_id < slowlog->count; t_id++) {
+		pthread_mutex_lock(slowlog->locks + t_id);
+		{
+			// Critical section.
+			heap_t *heap = slowlog->min_heap[t_id];
+			if(heap != NULL) {
+				while(Heap_count(heap)) _SlowLog_Item_Free(Heap_poll(heap));
+				Heap_free(heap);
+				raxFree(slowlog->lookup[t_id]);
+				slowlog->min_heap[t_id] = NULL;
+				slowlog->lookup[t_id] = NULL;
+			}
+			// End of critical section.
+		}
+		pthread_mutex_unlock(slowlog->locks + t_id);
+	}
+}
+
 void SlowLog_Free(SlowLog *slowlog) {
 	for(int i = 0; i < slowlog->count; i++) {
 		rax *lookup = slowlog->lookup[i];
 		heap_t *heap = slowlog->min_heap[i];
 
+		int res = pthread_mutex_destroy(slowlog->locks + i);
+		ASSERT(res == 0);
+		if(lookup == NULL) continue;
+
 		raxIterator iter;
 		raxStart(&iter, lookup);
 		raxSeek(&iter, "^", NULL, 0);
@@ -224,8 +262,6 @@ void SlowLog_Free(SlowLog *slowlog) {
 
 		raxFree(lookup);
 		Heap_free(heap);
-		int res = pthread_mutex_destroy(slowlog->locks + i);
-		ASSERT(res == 0);
 	}
 
 	rm_free(slowlog->locks);
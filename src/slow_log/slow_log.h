@@ -10,6 +10,7 @@
 
 #include <pthread.h>
 
+#include "query_trace.h"
 #include "../util/heap.h"
 #include "../redismodule.h"
 #include "../../deps/rax/rax.h"
@@ -20,6 +21,7 @@ typedef struct {
     time_t time;        // Item creation time.
 	char *query;        // Query.
 	double latency;     // How much time query was processed.
+	QueryTrace trace;   // Phase timestamps of the logged execution.
 } SlowLogItem;
 
 // Slowlog, maintains N slowest queries.
@@ -40,14 +42,23 @@ void SlowLog_Add
 	const char *cmd,			// command being logged
 	const char *query,			// query being logged
 	double latency,				// command latency
-	time_t *time				// optional time command was issued
+	time_t *time,				// optional time command was issued
+	const QueryTrace *trace		// optional phase trace of the command
 );
 
 // Replies with slow log content.
+// each item is followed by its phase times if 'traces' is set.
 void SlowLog_Replay
 (
 	const SlowLog *slowlog,
-	RedisModuleCtx *ctx
+	RedisModuleCtx *ctx,
+	bool traces
+);
+
+// Clear slow log.
+void SlowLog_Reset
+(
+	SlowLog *slowlog
 );
 
 // Free slowlog.
@@ -10,13 +10,17 @@
 
 Block *Block_New(uint itemSize, uint capacity) {
 	ASSERT(itemSize > 0);
-	Block *block = rm_calloc(1, sizeof(Block) + (capacity * itemSize));
+	size_t size = sizeof(Block) + ((size_t)capacity * itemSize);
+	Block *block = rm_calloc(1, size);
+	rm_advise_huge_pages(block, size);
 	block->itemSize = itemSize;
+	block->capacity = capacity;
 	return block;
 }
 
 void Block_Free(Block *block) {
 	ASSERT(block != NULL);
+	if(block->deleted != NULL) rm_free(block->deleted);
 	rm_free(block);
 }
 
@@ -7,13 +7,17 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 /* The Block is a type-agnostic block of continuous memory used to hold items of the same type.
  * Each block has a next pointer to another block, or NULL if this is the last block. */
 typedef struct Block {
 	size_t itemSize;        // Size of a single item in bytes.
+	uint capacity;          // Number of items in block.
 	struct Block *next;     // Pointer to next block.
+	uint64_t *deleted;      // Deletion bitmap, bit i is set if item i is deleted, NULL while none is.
+	uint deleted_count;     // Number of deleted items, the bitmap's popcount.
 	unsigned char data[];   // Item array. MUST BE LAST MEMBER OF THE STRUCT!
 } Block;
 
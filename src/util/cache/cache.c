@@ -6,69 +6,186 @@
 
 #include "cache.h"
 #include "RG.h"
+#include "xxhash.h"
 #include "../rmalloc.h"
 #include "cache_array.h"
+#include <string.h>
 #include <pthread.h>
 
-static CacheEntry *_CacheEvictLRU(Cache *cache) {
-	CacheEntry *entry = CacheArray_FindMinLRU(cache->arr, cache->cap);
-	// Remove evicted element from the rax.
-	raxRemove(cache->lookup, (unsigned  char *)entry->key,
-	  strlen(entry->key), NULL);
-	CacheArray_CleanEntry(entry, cache->free_item);
+// marks a deleted lookup slot, probing continues past it
+#define TOMBSTONE ((CacheEntry *)1)
 
-	return entry;
+// statistics slot used by threads without an epoch slot
+#define SHARED_STATS CACHE_EPOCH_MAX_THREADS
+
+static inline uint64_t _Cache_Hash(const char *key, size_t key_len) {
+	return XXH64(key, key_len, 0);
+}
+
+//------------------------------------------------------------------------------
+// lookup table
+//------------------------------------------------------------------------------
+
+static CacheTable *_CacheTable_New(uint cap) {
+	CacheTable *t = rm_calloc(1, sizeof(CacheTable) + sizeof(CacheEntry *) * cap);
+	t->cap = cap;
+	return t;
+}
+
+// reader side probe, safe to call concurrently with a writer
+static CacheEntry *_CacheTable_Find(const CacheTable *t, const char *key,
+		uint64_t hash) {
+	uint mask = t->cap - 1;
+	for(uint i = 0; i < t->cap; i++) {
+		CacheEntry *entry = __atomic_load_n(t->slots + ((hash + i) & mask),
+				__ATOMIC_ACQUIRE);
+		if(entry == NULL) break;          // end of probe sequence
+		if(entry == TOMBSTONE) continue;  // deleted entry
+		if(entry->hash == hash && strcmp(entry->key, key) == 0) return entry;
+	}
+	return NULL;
+}
+
+// publish entry, returns true if a tombstone was reused
+static bool _CacheTable_Insert(CacheTable *t, CacheEntry *entry) {
+	uint mask = t->cap - 1;
+	for(uint i = 0; i < t->cap; i++) {
+		CacheEntry **slot = t->slots + ((entry->hash + i) & mask);
+		if(*slot == NULL || *slot == TOMBSTONE) {
+			bool tombstone = (*slot == TOMBSTONE);
+			// entry is fully initialized by the time readers observe it
+			__atomic_store_n(slot, entry, __ATOMIC_RELEASE);
+			return tombstone;
+		}
+	}
+
+	ASSERT(false && "cache lookup table is full");
+	return false;
+}
+
+static void _CacheTable_Remove(CacheTable *t, const CacheEntry *entry) {
+	uint mask = t->cap - 1;
+	for(uint i = 0; i < t->cap; i++) {
+		CacheEntry **slot = t->slots + ((entry->hash + i) & mask);
+		if(*slot == entry) {
+			__atomic_store_n(slot, TOMBSTONE, __ATOMIC_RELEASE);
+			return;
+		}
+	}
+
+	ASSERT(false && "cache entry is missing from lookup table");
+}
+
+// rebuild the lookup table without tombstones, returns the replaced table
+static CacheTable *_Cache_Rehash(Cache *cache) {
+	CacheTable *replaced = cache->lookup;
+	CacheTable *t = _CacheTable_New(replaced->cap);
+
+	for(uint i = 0; i < cache->size; i++) _CacheTable_Insert(t, cache->arr[i]);
+
+	__atomic_store_n(&cache->lookup, t, __ATOMIC_RELEASE);
+	cache->tombstones = 0;
+
+	return replaced;
 }
 
+//------------------------------------------------------------------------------
+// read-side critical section
+//------------------------------------------------------------------------------
+
+// threads without an epoch slot fall back to excluding writers
+static inline void _Cache_ReadBegin(Cache *cache, int slot) {
+	if(slot >= 0) CacheEpoch_Enter(slot);
+	else pthread_mutex_lock(&cache->_cache_mutex);
+}
+
+static inline void _Cache_ReadEnd(Cache *cache, int slot) {
+	if(slot >= 0) CacheEpoch_Exit(slot);
+	else pthread_mutex_unlock(&cache->_cache_mutex);
+}
+
+static CacheEntry *_Cache_Find(Cache *cache, const char *key) {
+	CacheTable *t = __atomic_load_n(&cache->lookup, __ATOMIC_ACQUIRE);
+	return _CacheTable_Find(t, key, _Cache_Hash(key, strlen(key)));
+}
+
+//------------------------------------------------------------------------------
+// writer
+//------------------------------------------------------------------------------
+
+// expects the writer mutex to be held
 static bool _Cache_SetValue(Cache *cache, const char *key, void *value,
   		size_t key_len) {
 	ASSERT(key != NULL);
 	ASSERT(cache != NULL);
 
+	uint64_t hash = _Cache_Hash(key, key_len);
+
 	/* in case that another working thread had already inserted the item to the
 	 * cache, no need to re-insert it */
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
-	if(entry != raxNotFound) {
-		return false;
-	}
+	if(_CacheTable_Find(cache->lookup, key, hash) != NULL) return false;
+
+	uint pos;
+	CacheEntry *evicted  = NULL;
+	CacheTable *replaced = NULL;
 
 	// key is not in cache! test to see if cache is full?
 	if(cache->size == cache->cap) {
-		/* the cache is full, evict the least-recently-used element
-		 * and reuse its space for the new element */
-		entry = _CacheEvictLRU(cache);
+		/* the cache is full, evict an entry which was not used recently
+		 * and reuse its position for the new element */
+		pos = CacheArray_ClockEvict(cache->arr, cache->cap, &cache->hand);
+		evicted = cache->arr[pos];
+		_CacheTable_Remove(cache->lookup, evicted);
+		cache->tombstones++;
 	} else {
-		// the array has space left in it, use the next available entry
-		entry = cache->arr + cache->size++;
+		// the array has space left in it, use the next available position
+		pos = cache->size++;
 	}
 
-	// populate the entry
-	char *k = rm_strdup(key);
-	cache->counter++;
-	CacheArray_PopulateEntry(cache->counter, entry, k, value);
+	// populate and publish the entry
+	CacheEntry *entry = CacheEntry_New(rm_strdup(key), hash, value);
+	cache->arr[pos] = entry;
+	if(_CacheTable_Insert(cache->lookup, entry)) cache->tombstones--;
 
+	// probe sequences grow with tombstones, rebuild the table
+	if(cache->tombstones > cache->lookup->cap / 4) {
+		replaced = _Cache_Rehash(cache);
+	}
 
-	// Add the new entry to the rax.
-	raxInsert(cache->lookup, (unsigned char *)key, key_len, entry, NULL);
+	// release unlinked memory once no reader can observe it
+	if(evicted != NULL || replaced != NULL) {
+		CacheEpoch_Synchronize();
+		if(evicted != NULL) CacheEntry_Free(evicted, cache->free_item);
+		if(replaced != NULL) rm_free(replaced);
+	}
 
 	return true;
 }
 
+//------------------------------------------------------------------------------
+// cache API
+//------------------------------------------------------------------------------
+
 Cache *Cache_New(uint cap, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyFunc) {
 	ASSERT(cap > 0);
 	ASSERT(copyFunc != NULL);
 
-	Cache *cache     = rm_malloc(sizeof(Cache));
-	cache->cap       = cap;
-	cache->size      = 0;
-	cache->lookup    = raxNew();       // Instantiate key entry mapping.
-	cache->counter   = 0;             // Initialize counter to zero.
-	cache->copy_item = copyFunc;
-	cache->free_item = freeFunc;
-	cache->arr = rm_calloc(cap, sizeof(CacheEntry)); // Array of cached values.
-
-	// Initialize the read-write lock to protect access to the cache.
-	int res = pthread_rwlock_init(&cache->_cache_rwlock, NULL);
+	// lookup table is kept at most half full
+	uint table_cap = 1;
+	while(table_cap < cap * 2) table_cap <<= 1;
+
+	Cache *cache      = rm_malloc(sizeof(Cache));
+	cache->cap        = cap;
+	cache->size       = 0;
+	cache->hand       = 0;
+	cache->tombstones = 0;
+	cache->lookup     = _CacheTable_New(table_cap);
+	cache->copy_item  = copyFunc;
+	cache->free_item  = freeFunc;
+	cache->arr        = rm_calloc(cap, sizeof(CacheEntry *));
+	cache->stats      = rm_calloc(CACHE_EPOCH_MAX_THREADS + 1, sizeof(CacheStats));
+
+	int res = pthread_mutex_init(&cache->_cache_mutex, NULL);
 	UNUSED(res);
 	ASSERT(res == 0);
 
@@ -80,26 +197,29 @@ void *Cache_GetValue(Cache *cache, const char *key) {
 
 	ASSERT(cache != NULL);
 
-	int res = pthread_rwlock_rdlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	int slot = CacheEpoch_ThreadSlot();
+	_Cache_ReadBegin(cache, slot);
 
-	size_t key_len = strlen(key);
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
+	CacheEntry *entry = _Cache_Find(cache, key);
+	if(entry != NULL) {
+		/* element is now recently used, avoid dirtying the cache line
+		 * when the bit is already set */
+		if(!__atomic_load_n(&entry->referenced, __ATOMIC_RELAXED)) {
+			__atomic_store_n(&entry->referenced, true, __ATOMIC_RELAXED);
+		}
 
-	if(entry == raxNotFound) goto cleanup;
+		// return a copy of element, prefer a spare one
+		item = CacheEntry_PopCopy(entry);
+		if(item == NULL) item = cache->copy_item(entry->value);
+	}
 
-	/* element is now the most recently used; update its LRU
-	 * note that multiple threads can be here simultaneously */
-	cache->counter++;
-	entry->LRU = cache->counter;
+	_Cache_ReadEnd(cache, slot);
 
-	// return a copy of element
-	item = cache->copy_item(entry->value);
+	// statistics are kept per thread
+	CacheStats *stats = cache->stats + ((slot >= 0) ? slot : SHARED_STATS);
+	if(entry != NULL) __atomic_fetch_add(&stats->hits, 1, __ATOMIC_RELAXED);
+	else __atomic_fetch_add(&stats->misses, 1, __ATOMIC_RELAXED);
 
-cleanup:
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
 	return item;
 }
 
@@ -109,16 +229,12 @@ void Cache_SetValue(Cache *cache, const char *key, void *value) {
 
 	size_t key_len = strlen(key);
 
-	// Acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	pthread_mutex_lock(&cache->_cache_mutex);
 
 	// Insert the value to the cache.
 	_Cache_SetValue(cache, key, value, key_len);
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
+	pthread_mutex_unlock(&cache->_cache_mutex);
 }
 
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
@@ -128,10 +244,7 @@ void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 	size_t key_len = strlen(key);
 	void *value_to_return = value;
 
-	// acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	pthread_mutex_lock(&cache->_cache_mutex);
 
 	// return true if value was added, false if value already in cache
 	if(_Cache_SetValue(cache, key, value, key_len)) {
@@ -139,26 +252,148 @@ void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 		value_to_return = cache->copy_item(value);
 	}
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
+	pthread_mutex_unlock(&cache->_cache_mutex);
 
 	return value_to_return;
 }
 
+bool Cache_Remove(Cache *cache, const char *key) {
+	ASSERT(key != NULL);
+	ASSERT(cache != NULL);
+
+	CacheTable *replaced = NULL;
+
+	pthread_mutex_lock(&cache->_cache_mutex);
+
+	CacheEntry *entry = _CacheTable_Find(cache->lookup, key,
+			_Cache_Hash(key, strlen(key)));
+	if(entry == NULL) {
+		pthread_mutex_unlock(&cache->_cache_mutex);
+		return false;
+	}
+
+	_CacheTable_Remove(cache->lookup, entry);
+	cache->tombstones++;
+
+	// fill the gap with the last entry
+	for(uint i = 0; i < cache->size; i++) {
+		if(cache->arr[i] != entry) continue;
+		cache->arr[i] = cache->arr[--cache->size];
+		cache->arr[cache->size] = NULL;
+		break;
+	}
+	if(cache->hand >= cache->size) cache->hand = 0;
+
+	if(cache->tombstones > cache->lookup->cap / 4) {
+		replaced = _Cache_Rehash(cache);
+	}
+
+	// release unlinked memory once no reader can observe it
+	CacheEpoch_Synchronize();
+	CacheEntry_Free(entry, cache->free_item);
+	if(replaced != NULL) rm_free(replaced);
+
+	pthread_mutex_unlock(&cache->_cache_mutex);
+
+	return true;
+}
+
+void Cache_Replenish(Cache *cache, const char *key) {
+	ASSERT(key != NULL);
+	ASSERT(cache != NULL);
+
+	int slot = CacheEpoch_ThreadSlot();
+	_Cache_ReadBegin(cache, slot);
+
+	// entry might have been evicted in the meantime
+	CacheEntry *entry = _Cache_Find(cache, key);
+	if(entry != NULL && CacheEntry_PoolHasRoom(entry)) {
+		void *copy = cache->copy_item(entry->value);
+		// lost the race against a concurrent replenish
+		if(!CacheEntry_PushCopy(entry, copy)) cache->free_item(copy);
+	}
+
+	_Cache_ReadEnd(cache, slot);
+}
+
+void Cache_GetStats(Cache *cache, uint64_t *hits, uint64_t *misses) {
+	ASSERT(cache != NULL);
+	ASSERT(hits != NULL);
+	ASSERT(misses != NULL);
+
+	*hits   = 0;
+	*misses = 0;
+
+	for(uint i = 0; i <= CACHE_EPOCH_MAX_THREADS; i++) {
+		*hits   += __atomic_load_n(&cache->stats[i].hits, __ATOMIC_RELAXED);
+		*misses += __atomic_load_n(&cache->stats[i].misses, __ATOMIC_RELAXED);
+	}
+}
+
+void Cache_ForEach(Cache *cache, void (*cb)(const char *, void *, void *),
+		void *privdata) {
+	ASSERT(cb != NULL);
+	ASSERT(cache != NULL);
+
+	// entries are only evicted by writers
+	pthread_mutex_lock(&cache->_cache_mutex);
+
+	for(uint i = 0; i < cache->size; i++) {
+		CacheEntry *entry = cache->arr[i];
+		cb(entry->key, entry->value, privdata);
+	}
+
+	pthread_mutex_unlock(&cache->_cache_mutex);
+}
+
+bool Cache_TryForEach(Cache *cache, void (*cb)(const char *, void *, void *),
+		void *privdata) {
+	ASSERT(cb != NULL);
+	ASSERT(cache != NULL);
+
+	if(pthread_mutex_trylock(&cache->_cache_mutex) != 0) return false;
+
+	for(uint i = 0; i < cache->size; i++) {
+		CacheEntry *entry = cache->arr[i];
+		cb(entry->key, entry->value, privdata);
+	}
+
+	pthread_mutex_unlock(&cache->_cache_mutex);
+	return true;
+}
+
+size_t Cache_MemoryUsage(Cache *cache) {
+	ASSERT(cache != NULL);
+
+	pthread_mutex_lock(&cache->_cache_mutex);
+
+	size_t size = sizeof(Cache) +
+		sizeof(CacheTable) + sizeof(CacheEntry *) * cache->lookup->cap +
+		sizeof(CacheEntry *) * cache->cap +
+		sizeof(CacheStats) * (CACHE_EPOCH_MAX_THREADS + 1);
+
+	for(uint i = 0; i < cache->size; i++) {
+		size += sizeof(CacheEntry) + strlen(cache->arr[i]->key) + 1;
+	}
+
+	pthread_mutex_unlock(&cache->_cache_mutex);
+
+	return size;
+}
+
 void Cache_Free(Cache *cache) {
 	ASSERT(cache != NULL);
 
 	// free cache entries
 	for(size_t i = 0; i < cache->size; i++) {
-		CacheEntry *entry = cache->arr + i;
-		rm_free(entry->key);
-		cache->free_item(entry->value);
+		CacheEntry_Free(cache->arr[i], cache->free_item);
 	}
 
 	rm_free(cache->arr);
-	raxFree(cache->lookup);
+	rm_free(cache->stats);
+	rm_free(cache->lookup);
 
-	int res = pthread_rwlock_destroy(&cache->_cache_rwlock);
+	int res = pthread_mutex_destroy(&cache->_cache_mutex);
 	UNUSED(res);
 	ASSERT(res == 0);
 
@@ -7,21 +7,45 @@
 #pragma once
 
 #include "cache_array.h"
-#include "rax.h"
+#include "cache_epoch.h"
+#include <pthread.h>
 
 /**
- * @brief Key-value cache, uses LRU policy for eviction.
+ * @brief  Open addressing mapping between keys and entries.
+ * @note   Slots are published atomically, readers probe the table
+ *         without locking while a single writer mutates it.
+ */
+typedef struct {
+	uint cap;                          // Number of slots, a power of two.
+	CacheEntry *slots[];               // Entries, NULL or tombstone for vacant slots.
+} CacheTable;
+
+/**
+ * @brief  Per thread lookup statistics, padded to avoid false sharing.
+ */
+typedef struct {
+	uint64_t hits;                     // Number of lookups served by the cache.
+	uint64_t misses;                   // Number of lookups which missed the cache.
+	char _pad[48];
+} CacheStats;
+
+/**
+ * @brief  Key-value cache, uses an approximated LRU (clock) policy for eviction.
+ * Lookups are lock free, writers are serialized and defer releasing evicted
+ * entries until no reader can observe them.
  * Assumes owership over stored objects.
  */
 typedef struct Cache {
 	uint cap;                          // Cache capacity.
 	uint size;                         // Cache current size.
-	long long counter;                 // Atomic counter for number of reads.
-	rax *lookup;                       // Mapping between keys to entries, for fast lookups.
-	CacheEntry *arr;                   // Array of cache elements.
+	uint hand;                         // Clock hand, next eviction candidate.
+	uint tombstones;                   // Number of deleted lookup slots.
+	CacheTable *lookup;                // Mapping between keys to entries, for fast lookups.
+	CacheEntry **arr;                  // Array of cache elements.
+	CacheStats *stats;                 // Per thread lookup statistics.
 	CacheEntryFreeFunc free_item;      // Callback function that free cached value.
 	CacheEntryCopyFunc copy_item;      // Callback function that copies cached value.
-	pthread_rwlock_t _cache_rwlock;    // Read-write lock to protect access to the cache.
+	pthread_mutex_t _cache_mutex;      // Serializes writers.
 } Cache;
 
 /**
@@ -35,6 +59,7 @@ Cache *Cache_New(uint size, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copy
 
 /**
  * @brief  Returns a copy of value if it is cached, NULL otherwise.
+ * @note   Copies are taken from the entry's pool of spares when available.
  * @param  *cache: cache pointer.
  * @param  *key: Key to look for.
  * @retval  pointer with the cached answer, NULL if the key isn't cached.
@@ -60,6 +85,64 @@ void Cache_SetValue(Cache *cache, const char *key, void *item);
  */
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value);
 
+/**
+ * @brief  Removes key and its value from the cache.
+ * @note   Copies handed out earlier remain valid, removing a missing key
+ *         is a no-op.
+ * @param  *cache: cache pointer.
+ * @param  *key: Key to remove.
+ * @retval true if key was cached.
+ */
+bool Cache_Remove(Cache *cache, const char *key);
+
+/**
+ * @brief  Tops up the pool of spare copies kept for key.
+ * @note   Meant to be called off the critical path, e.g. once a reply was sent,
+ *         such that a following hit pops a copy rather than performing one.
+ * @param  *cache: cache pointer.
+ * @param  *key: Key whose entry's pool should be replenished.
+ */
+void Cache_Replenish(Cache *cache, const char *key);
+
+/**
+ * @brief  Reports the number of cache hits and misses since creation.
+ * @param  *cache: cache pointer.
+ * @param  *hits: number of lookups which found their key.
+ * @param  *misses: number of lookups which did not find their key.
+ */
+void Cache_GetStats(Cache *cache, uint64_t *hits, uint64_t *misses);
+
+/**
+ * @brief  Invokes callback on each cached key and value.
+ * @note   Writers are excluded for the duration of the scan,
+ *         callbacks must not modify the cache.
+ * @param  *cache: cache pointer.
+ * @param  *cb: callback invoked with each key, value and privdata.
+ * @param  *privdata: passed as is to callback.
+ */
+void Cache_ForEach(Cache *cache, void (*cb)(const char *, void *, void *),
+		void *privdata);
+
+/**
+ * @brief  Invokes callback on each cached key and value, unless a writer
+ *         is currently modifying the cache.
+ * @note   Safe to call from a forked child, where a writer thread holding
+ *         the cache at fork time never releases it.
+ * @param  *cache: cache pointer.
+ * @param  *cb: callback invoked with each key, value and privdata.
+ * @param  *privdata: passed as is to callback.
+ * @retval true if the cache was scanned, false if a writer holds it.
+ */
+bool Cache_TryForEach(Cache *cache, void (*cb)(const char *, void *, void *),
+		void *privdata);
+
+/**
+ * @brief  Returns the number of bytes used by the cache and its keys,
+ *         excluding stored values.
+ * @param  *cache: cache pointer.
+ */
+size_t Cache_MemoryUsage(Cache *cache);
+
 /**
  * @brief  Destroys the cache and free all stored items.
  * @param  *cache: cache pointer
@@ -8,45 +8,82 @@
 #include "../rmalloc.h"
 #include "../../RG.h"
 
-CacheEntry *CacheArray_FindMinLRU(CacheEntry *cache_arr, uint cap) {
-	ASSERT(cache_arr != NULL);
+CacheEntry *CacheEntry_New(char *key, uint64_t hash, void *value) {
+	CacheEntry *entry = rm_calloc(1, sizeof(CacheEntry));
 
-	CacheEntry *min_LRU_entry = cache_arr;
+	entry->key        = key;
+	entry->hash       = hash;
+	entry->value      = value;
+	entry->referenced = true;  // insertion counts as a use
 
-	for(size_t i = 1; i < cap; i++) {
-		CacheEntry *current_entry = cache_arr + i;
-		if(current_entry->LRU < min_LRU_entry->LRU) {
-			min_LRU_entry = current_entry;
-		}
+	return entry;
+}
+
+void *CacheEntry_PopCopy(CacheEntry *entry) {
+	ASSERT(entry != NULL);
+
+	for(uint i = 0; i < CACHE_POOL_CAP; i++) {
+		// skip empty slots without dirtying the cache line
+		if(__atomic_load_n(entry->pool + i, __ATOMIC_RELAXED) == NULL) continue;
+		void *copy = __atomic_exchange_n(entry->pool + i, NULL, __ATOMIC_ACQUIRE);
+		if(copy != NULL) return copy;
 	}
 
-	return min_LRU_entry;
+	return NULL;
 }
 
-CacheEntry *CacheArray_PopulateEntry(long long counter, CacheEntry *entry, char *key,
-  									void *value) {
+bool CacheEntry_PoolHasRoom(const CacheEntry *entry) {
+	ASSERT(entry != NULL);
 
-	entry->key   = key;
-	entry->value = value;
-	entry->LRU   = counter;
+	for(uint i = 0; i < CACHE_POOL_CAP; i++) {
+		if(__atomic_load_n(entry->pool + i, __ATOMIC_RELAXED) == NULL) return true;
+	}
 
-	return entry;
+	return false;
 }
 
-void CacheArray_CleanEntry(CacheEntry *entry, CacheEntryFreeFunc free_entry) {
+bool CacheEntry_PushCopy(CacheEntry *entry, void *copy) {
+	ASSERT(copy  != NULL);
 	ASSERT(entry != NULL);
-	ASSERT(free_entry != NULL);
 
-	if(entry->key != NULL) {
-		rm_free(entry->key);
-		entry->key = NULL;
+	for(uint i = 0; i < CACHE_POOL_CAP; i++) {
+		void *expected = NULL;
+		if(__atomic_compare_exchange_n(entry->pool + i, &expected, copy, false,
+					__ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+			return true;
+		}
 	}
 
-	if(entry->value != NULL) {
-		free_entry(entry->value);
-		entry->value = NULL;
+	return false;
+}
+
+void CacheEntry_Free(CacheEntry *entry, CacheEntryFreeFunc free_entry) {
+	ASSERT(entry != NULL);
+	ASSERT(free_entry != NULL);
+
+	rm_free(entry->key);
+	free_entry(entry->value);
+
+	for(uint i = 0; i < CACHE_POOL_CAP; i++) {
+		if(entry->pool[i] != NULL) free_entry(entry->pool[i]);
 	}
 
-	entry->LRU = 0;
+	rm_free(entry);
+}
+
+uint CacheArray_ClockEvict(CacheEntry **cache_arr, uint cap, uint *hand) {
+	ASSERT(cap > 0);
+	ASSERT(hand != NULL);
+	ASSERT(cache_arr != NULL);
+
+	// terminates within two sweeps, as each visit clears a reference bit
+	while(true) {
+		uint i = *hand;
+		*hand = (i + 1) % cap;
+
+		CacheEntry *entry = cache_arr[i];
+		if(!__atomic_load_n(&entry->referenced, __ATOMIC_RELAXED)) return i;
+		__atomic_store_n(&entry->referenced, false, __ATOMIC_RELAXED);
+	}
 }
 
@@ -11,6 +11,9 @@
 #include <stdbool.h>
 #include <sys/types.h>
 
+// number of spare copies kept by each cache entry
+#define CACHE_POOL_CAP 2
+
 //------------------------------------------------------------------------------
 // function pointers
 //------------------------------------------------------------------------------
@@ -23,21 +26,34 @@ typedef void *(*CacheEntryCopyFunc)(void *);
 
 /**
  * @brief  A struct for an entry in cache array with a key and value.
+ * @note   Once published an entry is only mutated atomically,
+ *         it is freed after all readers which might observe it are done.
  */
 typedef struct CacheEntry_t {
-	char *key;      // Entry key.
-	void *value;    // Entry stored value.
-	long long LRU;  // Indicates the time when the entry was last recently used.
+	char *key;                    // Entry key.
+	uint64_t hash;                // Key hash.
+	void *value;                  // Entry stored value.
+	void *pool[CACHE_POOL_CAP];   // Spare copies of value, handed out on hits.
+	bool referenced;              // Set when the entry is used, cleared by the clock hand.
 } CacheEntry;
 
+// Creates a new cache entry, assumes ownership over key and value.
+CacheEntry *CacheEntry_New(char *key, uint64_t hash, void *value);
+
+// Pops a spare copy of the entry value, returns NULL if the pool is empty.
+void *CacheEntry_PopCopy(CacheEntry *entry);
+
+// Returns true if the entry's pool has room for an additional copy.
+bool CacheEntry_PoolHasRoom(const CacheEntry *entry);
 
-// Returns a pointer to the entry in the cache array with the minimum LRU.
-CacheEntry *CacheArray_FindMinLRU(CacheEntry *cache_arr, uint cap);
+// Pushes a spare copy of the entry value, returns false if the pool is full.
+bool CacheEntry_PushCopy(CacheEntry *entry, void *copy);
 
-// Assign new values to the fields of a cache entry.
-CacheEntry *CacheArray_PopulateEntry(long long counter, CacheEntry *entry, char *key,
-  			void *value);
+// Frees the entry, its value and all spare copies.
+void CacheEntry_Free(CacheEntry *entry, CacheEntryFreeFunc free_entry);
 
-// Free the fields of a cache entry to prepare it for reuse.
-void CacheArray_CleanEntry(CacheEntry *entry, CacheEntryFreeFunc free_entry);
+// Picks an eviction victim using the clock algorithm, an approximation of LRU
+// entries referenced since the last sweep are spared and their bit is cleared.
+// Returns the victim's position in the cache array.
+uint CacheArray_ClockEvict(CacheEntry **cache_arr, uint cap, uint *hand);
 
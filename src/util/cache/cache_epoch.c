@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "cache_epoch.h"
+#include "../../RG.h"
+#include <sched.h>
+#include <sys/types.h>
+
+#define CACHE_LINE_SIZE 64
+
+// per thread announced epoch, padded to avoid false sharing
+typedef struct {
+	uint64_t epoch;  // epoch entered at, 0 when outside of a critical section
+	char _pad[CACHE_LINE_SIZE - sizeof(uint64_t)];
+} EpochSlot;
+
+static EpochSlot _slots[CACHE_EPOCH_MAX_THREADS]
+	__attribute__((aligned(CACHE_LINE_SIZE)));
+
+static uint64_t _global_epoch  =  1;   // current epoch
+static uint _slots_count       =  0;   // number of assigned slots
+static __thread int _slot      = -2;   // thread's slot, -2 when unassigned
+
+int CacheEpoch_ThreadSlot(void) {
+	if(_slot == -2) {
+		// threads are long lived, slots are never reclaimed
+		uint slot = __atomic_fetch_add(&_slots_count, 1, __ATOMIC_RELAXED);
+		_slot = (slot < CACHE_EPOCH_MAX_THREADS) ? (int)slot : -1;
+	}
+	return _slot;
+}
+
+void CacheEpoch_Enter(int slot) {
+	ASSERT(slot >= 0 && slot < CACHE_EPOCH_MAX_THREADS);
+	ASSERT(_slots[slot].epoch == 0);
+
+	uint64_t epoch = __atomic_load_n(&_global_epoch, __ATOMIC_RELAXED);
+	__atomic_store_n(&_slots[slot].epoch, epoch, __ATOMIC_RELAXED);
+
+	// order the announcement before any subsequent read of shared pointers
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void CacheEpoch_Exit(int slot) {
+	ASSERT(slot >= 0 && slot < CACHE_EPOCH_MAX_THREADS);
+	__atomic_store_n(&_slots[slot].epoch, 0, __ATOMIC_RELEASE);
+}
+
+void CacheEpoch_Synchronize(void) {
+	// order prior unlinks before scanning reader slots
+	uint64_t target = __atomic_add_fetch(&_global_epoch, 1, __ATOMIC_SEQ_CST);
+
+	uint n = __atomic_load_n(&_slots_count, __ATOMIC_RELAXED);
+	if(n > CACHE_EPOCH_MAX_THREADS) n = CACHE_EPOCH_MAX_THREADS;
+
+	for(uint i = 0; i < n; i++) {
+		while(true) {
+			uint64_t epoch = __atomic_load_n(&_slots[i].epoch, __ATOMIC_ACQUIRE);
+			// reader is either quiescent or entered after the unlink
+			if(epoch == 0 || epoch >= target) break;
+			sched_yield();
+		}
+	}
+}
+
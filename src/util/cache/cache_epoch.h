@@ -0,0 +1,45 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// maximum number of threads reading concurrently from caches
+#define CACHE_EPOCH_MAX_THREADS 128
+
+/**
+ * Epoch based reclamation, allows cache lookups to proceed without locking.
+ * A reader announces the global epoch once it enters a read-side critical
+ * section and clears it once it exits, a writer which unlinked an object
+ * advances the global epoch and waits for every reader which entered at a
+ * prior epoch to exit, at which point the object can be safely freed.
+ */
+
+/**
+ * @brief  Returns the calling thread's epoch slot.
+ * @retval slot index, -1 if all slots are taken.
+ */
+int CacheEpoch_ThreadSlot(void);
+
+/**
+ * @brief  Enters a read-side critical section.
+ * @param  slot: calling thread's epoch slot.
+ */
+void CacheEpoch_Enter(int slot);
+
+/**
+ * @brief  Exits a read-side critical section.
+ * @param  slot: calling thread's epoch slot.
+ */
+void CacheEpoch_Exit(int slot);
+
+/**
+ * @brief  Waits for all readers which entered before this call to exit.
+ * @note   Must not be called from within a read-side critical section.
+ */
+void CacheEpoch_Synchronize(void);
+
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "compressed_string.h"
+#include "RG.h"
+#include "rmalloc.h"
+#include <limits.h>
+#include <string.h>
+
+// LZ4 is bundled with GraphBLAS, which prefixes its symbols
+// to avoid clashing with other copies of the library
+int GB_LZ4_compressBound(int inputSize);
+int GB_LZ4_compress_default(const char *src, char *dst, int srcSize,
+		int dstCapacity);
+int GB_LZ4_decompress_safe(const char *src, char *dst, int compressedSize,
+		int dstCapacity);
+
+typedef struct {
+	uint64_t id;    // process-wide unique, keys decompressed copies
+	uint32_t len;   // decompressed length, excluding the terminating null
+	uint32_t size;  // number of compressed bytes
+	char data[];    // compressed bytes
+} CompressedString;
+
+#define CS(cs) ((CompressedString *)(cs))
+
+// a decompressed copy, reused by later reads
+typedef struct {
+	uint64_t id;  // ID of the copied compressed string, READ_SLOT_EMPTY if none
+	size_t cap;   // number of bytes allocated for 'v.stringval'
+	SIValue v;    // decompressed copy
+} ReadSlot;
+
+#define READ_SLOT_EMPTY UINT64_MAX
+
+static uint64_t _next_id = 0;              // ID of the next compressed string
+static __thread ReadSlot *_reads = NULL;   // thread's decompressed copies
+static __thread uint _next_read = 0;       // next slot to reuse
+
+static char *_New
+(
+	const char *data,
+	uint32_t size,
+	uint32_t len
+) {
+	CompressedString *cs = rm_malloc(sizeof(CompressedString) + size);
+	cs->id   = __atomic_fetch_add(&_next_id, 1, __ATOMIC_RELAXED);
+	cs->len  = len;
+	cs->size = size;
+	memcpy(cs->data, data, size);
+	return (char *)cs;
+}
+
+char *CompressedString_New
+(
+	const char *s,
+	size_t len
+) {
+	ASSERT(s != NULL);
+
+	if(len == 0 || len > INT_MAX / 2) return NULL;
+
+	int bound = GB_LZ4_compressBound(len);
+	char *buf = rm_malloc(bound);
+	int size = GB_LZ4_compress_default(s, buf, len, bound);
+
+	char *cs = NULL;
+	if(size > 0 && sizeof(CompressedString) + size <= len - len / 8) {
+		cs = _New(buf, size, len);
+	}
+
+	rm_free(buf);
+	return cs;
+}
+
+char *CompressedString_FromCompressed
+(
+	const char *data,
+	size_t size,
+	size_t len
+) {
+	ASSERT(data != NULL);
+
+	if(size == 0 || size > INT_MAX || len > INT_MAX / 2) return NULL;
+
+	// make sure the data isn't corrupt before it's stored
+	char *s = rm_malloc(len + 1);
+	int n = GB_LZ4_decompress_safe(data, s, size, len);
+	rm_free(s);
+	if(n < 0 || (size_t)n != len) return NULL;
+
+	return _New(data, size, len);
+}
+
+char *CompressedString_Clone
+(
+	const char *cs
+) {
+	ASSERT(cs != NULL);
+	return _New(CS(cs)->data, CS(cs)->size, CS(cs)->len);
+}
+
+const char *CompressedString_Data
+(
+	const char *cs,
+	size_t *size
+) {
+	ASSERT(cs   != NULL);
+	ASSERT(size != NULL);
+
+	*size = CS(cs)->size;
+	return CS(cs)->data;
+}
+
+size_t CompressedString_Length
+(
+	const char *cs
+) {
+	ASSERT(cs != NULL);
+	return CS(cs)->len;
+}
+
+size_t CompressedString_MemoryUsage
+(
+	const char *cs
+) {
+	ASSERT(cs != NULL);
+	return sizeof(CompressedString) + CS(cs)->size;
+}
+
+char *CompressedString_Decompress
+(
+	const char *cs
+) {
+	ASSERT(cs != NULL);
+
+	const CompressedString *c = CS(cs);
+	char *s = rm_malloc(c->len + 1);
+	int n = GB_LZ4_decompress_safe(c->data, s, c->size, c->len);
+	ASSERT(n >= 0 && (uint32_t)n == c->len);
+	s[c->len] = '\0';
+
+	return s;
+}
+
+SIValue *CompressedString_Read
+(
+	const char *cs
+) {
+	ASSERT(cs != NULL);
+
+	if(_reads == NULL) {
+		_reads = rm_calloc(COMPRESSED_STRING_READ_SLOTS, sizeof(ReadSlot));
+		for(uint i = 0; i < COMPRESSED_STRING_READ_SLOTS; i++) {
+			_reads[i].id = READ_SLOT_EMPTY;
+		}
+	}
+
+	// value read recently, reuse its copy
+	const CompressedString *c = CS(cs);
+	for(uint i = 0; i < COMPRESSED_STRING_READ_SLOTS; i++) {
+		if(_reads[i].id == c->id) return &_reads[i].v;
+	}
+
+	// decompress into the least recently filled slot
+	ReadSlot *slot = _reads + _next_read;
+	_next_read = (_next_read + 1) % COMPRESSED_STRING_READ_SLOTS;
+
+	if(slot->cap < (size_t)c->len + 1) {
+		slot->cap = c->len + 1;
+		slot->v.stringval = rm_realloc(slot->v.stringval, slot->cap);
+	}
+
+	int n = GB_LZ4_decompress_safe(c->data, slot->v.stringval, c->size,
+			c->len);
+	ASSERT(n >= 0 && (uint32_t)n == c->len);
+	UNUSED(n);
+	slot->v.stringval[c->len] = '\0';
+
+	slot->id           = c->id;
+	slot->v.type       = T_STRING;
+	slot->v.allocation = M_VOLATILE;
+
+	return &slot->v;
+}
+
+void CompressedString_ReleaseReads(void) {
+	if(_reads == NULL) return;
+
+	for(uint i = 0; i < COMPRESSED_STRING_READ_SLOTS; i++) {
+		rm_free(_reads[i].v.stringval);
+	}
+	rm_free(_reads);
+
+	_reads     = NULL;
+	_next_read = 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../value.h"
+
+// compressed strings hold large string property values LZ4 compressed
+// graph entities store them in SIValues with the M_COMPRESSED allocation type
+// values are read through a decompressed copy held by the reading thread
+// each thread holds a fixed number of copies, reused by later reads
+// such that repeated reads of a value decompress it once
+//
+// decompressed copies are M_VOLATILE and short lived, values held beyond
+// the immediate read, e.g. record entries, are cloned into their own copy
+
+// RDB tag of compressed string values, no SIType takes it
+#define COMPRESSED_STRING_ENCODING_TAG (1 << 24)
+
+// number of decompressed copies held by a thread
+// a copy is valid until the thread performs this many further reads
+#define COMPRESSED_STRING_READ_SLOTS 16
+
+// compresses the first 'len' bytes of 's'
+// returns NULL if compression doesn't save at least an eighth of 'len'
+char *CompressedString_New
+(
+	const char *s,  // string to compress
+	size_t len      // length of 's'
+);
+
+// creates a compressed string out of already compressed bytes
+// e.g. as persisted in RDB, returns NULL if 'data' doesn't decompress
+// into exactly 'len' bytes
+char *CompressedString_FromCompressed
+(
+	const char *data,  // LZ4 compressed bytes
+	size_t size,       // number of compressed bytes
+	size_t len         // decompressed length
+);
+
+// duplicates compressed string 'cs'
+char *CompressedString_Clone
+(
+	const char *cs  // compressed string
+);
+
+// returns the compressed bytes of 'cs' and sets 'size' to their number
+const char *CompressedString_Data
+(
+	const char *cs,  // compressed string
+	size_t *size     // [output] number of compressed bytes
+);
+
+// length of 'cs' once decompressed
+size_t CompressedString_Length
+(
+	const char *cs  // compressed string
+);
+
+// number of bytes allocated by 'cs'
+size_t CompressedString_MemoryUsage
+(
+	const char *cs  // compressed string
+);
+
+// returns a heap allocated, decompressed copy of 'cs'
+// owned by the caller
+char *CompressedString_Decompress
+(
+	const char *cs  // compressed string
+);
+
+// returns this thread's decompressed copy of 'cs', decompressing it
+// into the least recently filled copy unless it was read recently
+// the copy is valid for the next COMPRESSED_STRING_READ_SLOTS reads
+SIValue *CompressedString_Read
+(
+	const char *cs  // compressed string
+);
+
+// frees this thread's decompressed copies
+void CompressedString_ReleaseReads(void);
@@ -9,25 +9,8 @@
 #include "datablock_iterator.h"
 #include "../arr.h"
 #include "../rmalloc.h"
-#include <math.h>
 #include <stdbool.h>
 
-// Computes the number of blocks required to accommodate n items.
-#define ITEM_COUNT_TO_BLOCK_COUNT(n) \
-    ceil((double)n / DATABLOCK_BLOCK_CAP)
-
-// Computes block index from item index.
-#define ITEM_INDEX_TO_BLOCK_INDEX(idx) \
-    (idx / DATABLOCK_BLOCK_CAP)
-
-// Computes item position within a block.
-#define ITEM_POSITION_WITHIN_BLOCK(idx) \
-    (idx % DATABLOCK_BLOCK_CAP)
-
-// Retrieves block in which item with index resides.
-#define GET_ITEM_BLOCK(dataBlock, idx) \
-    dataBlock->blocks[ITEM_INDEX_TO_BLOCK_INDEX(idx)]
-
 static void _DataBlock_AddBlocks(DataBlock *dataBlock, uint blockCount) {
 	ASSERT(dataBlock && blockCount > 0);
 
@@ -40,12 +23,12 @@ static void _DataBlock_AddBlocks(DataBlock *dataBlock, uint blockCount) {
 
 	uint i;
 	for(i = prevBlockCount; i < dataBlock->blockCount; i++) {
-		dataBlock->blocks[i] = Block_New(dataBlock->itemSize, DATABLOCK_BLOCK_CAP);
+		dataBlock->blocks[i] = Block_New(dataBlock->itemSize, DataBlock_BlockCap(i));
 		if(i > 0) dataBlock->blocks[i - 1]->next = dataBlock->blocks[i];
 	}
 	dataBlock->blocks[i - 1]->next = NULL;
 
-	dataBlock->itemCap = dataBlock->blockCount * DATABLOCK_BLOCK_CAP;
+	dataBlock->itemCap = DataBlock_BlockStart(dataBlock->blockCount);
 }
 
 // Checks to see if idx is within global array bounds
@@ -58,27 +41,61 @@ static inline bool _DataBlock_IndexOutOfBounds(const DataBlock *dataBlock, uint6
 
 static inline DataBlockItemHeader *DataBlock_GetItemHeader(const DataBlock *dataBlock,
 														   uint64_t idx) {
-	Block *block = GET_ITEM_BLOCK(dataBlock, idx);
-	idx = ITEM_POSITION_WITHIN_BLOCK(idx);
-	return (DataBlockItemHeader *)block->data + (idx * block->itemSize);
+	uint64_t pos;
+	Block *block = dataBlock->blocks[DataBlock_BlockIndex(idx, &pos)];
+	return (DataBlockItemHeader *)block->data + (pos * block->itemSize);
 }
 
 //------------------------------------------------------------------------------
 // DataBlock API implementation
 //------------------------------------------------------------------------------
 
+void DataBlock_MarkItemDeleted(DataBlock *dataBlock, uint64_t idx) {
+	uint64_t pos;
+	Block *block = dataBlock->blocks[DataBlock_BlockIndex(idx, &pos)];
+	MARK_HEADER_AS_DELETED((DataBlockItemHeader *)block->data +
+			(pos * block->itemSize));
+
+	// bitmap is allocated once the block's first item is deleted
+	if(block->deleted == NULL) {
+		block->deleted = rm_calloc(BLOCK_BITMAP_WORDS(block->capacity),
+				sizeof(uint64_t));
+	}
+
+	uint64_t bit = 1ULL << (pos & 63);
+	if(block->deleted[pos >> 6] & bit) return;
+	block->deleted[pos >> 6] |= bit;
+	block->deleted_count++;
+}
+
+void DataBlock_MarkItemUsed(DataBlock *dataBlock, uint64_t idx) {
+	uint64_t pos;
+	Block *block = dataBlock->blocks[DataBlock_BlockIndex(idx, &pos)];
+	MARK_HEADER_AS_NOT_DELETED((DataBlockItemHeader *)block->data +
+			(pos * block->itemSize));
+
+	if(block->deleted == NULL) return;
+
+	uint64_t bit = 1ULL << (pos & 63);
+	if(!(block->deleted[pos >> 6] & bit)) return;
+	block->deleted[pos >> 6] &= ~bit;
+	block->deleted_count--;
+}
+
 DataBlock *DataBlock_New(uint64_t itemCap, uint itemSize, fpDestructor fp) {
 	DataBlock *dataBlock = rm_malloc(sizeof(DataBlock));
 	dataBlock->itemCount = 0;
 	dataBlock->itemSize = itemSize + ITEM_HEADER_SIZE;
 	dataBlock->blockCount = 0;
 	dataBlock->blocks = NULL;
-	dataBlock->deletedIdx = array_new(uint64_t, 128);
+	dataBlock->deletedIdx = array_new(uint64_t, 0);
 	dataBlock->destructor = fp;
 	int res = pthread_mutex_init(&dataBlock->mutex, NULL);
 	UNUSED(res);
 	ASSERT(res == 0);
-	_DataBlock_AddBlocks(dataBlock, ITEM_COUNT_TO_BLOCK_COUNT(itemCap));
+	// always hold at least a single block
+	uint blockCount = DataBlock_BlockCount(itemCap);
+	_DataBlock_AddBlocks(dataBlock, (blockCount > 0) ? blockCount : 1);
 	return dataBlock;
 }
 
@@ -103,8 +120,7 @@ void DataBlock_Accommodate(DataBlock *dataBlock, int64_t k) {
 	int64_t additionalItems = k - freeSlotsCount;
 
 	if(additionalItems > 0) {
-		int64_t additionalBlocks = ITEM_COUNT_TO_BLOCK_COUNT(additionalItems);
-		_DataBlock_AddBlocks(dataBlock, additionalBlocks);
+		DataBlock_Ensure(dataBlock, dataBlock->itemCap + additionalItems - 1);
 	}
 }
 
@@ -115,8 +131,7 @@ void DataBlock_Ensure(DataBlock *dataBlock, uint64_t idx) {
 	if(dataBlock->itemCap > idx) return;
 
 	// make sure datablock cap > 'idx'
-	int64_t additionalItems = (1 + idx) - dataBlock->itemCap;
-	int64_t additionalBlocks = ITEM_COUNT_TO_BLOCK_COUNT(additionalItems);
+	uint additionalBlocks = DataBlock_BlockCount(idx + 1) - dataBlock->blockCount;
 	_DataBlock_AddBlocks(dataBlock, additionalBlocks);
 
 	ASSERT(dataBlock->itemCap > idx);
@@ -135,6 +150,20 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
 	return ITEM_DATA(item_header);
 }
 
+void DataBlock_Prefetch(const DataBlock *dataBlock, uint64_t idx) {
+	ASSERT(dataBlock != NULL);
+
+	if(_DataBlock_IndexOutOfBounds(dataBlock, idx)) return;
+	__builtin_prefetch(DataBlock_GetItemHeader(dataBlock, idx));
+}
+
+void *DataBlock_PeekItem(const DataBlock *dataBlock, uint64_t idx) {
+	ASSERT(dataBlock != NULL);
+
+	if(_DataBlock_IndexOutOfBounds(dataBlock, idx)) return NULL;
+	return DataBlock_GetItem(dataBlock, idx);
+}
+
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 	// make sure we've got room for items
 	if(dataBlock->itemCount >= dataBlock->itemCap) {
@@ -145,7 +174,7 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 
 	// get index into which to store item,
 	// prefer reusing free indicies
-	uint pos = dataBlock->itemCount;
+	uint64_t pos = dataBlock->itemCount;
 	if(array_len(dataBlock->deletedIdx) > 0) {
 		pos = array_pop(dataBlock->deletedIdx);
 	}
@@ -153,10 +182,35 @@ void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx) {
 
 	if(idx) *idx = pos;
 
-	DataBlockItemHeader *item_header = DataBlock_GetItemHeader(dataBlock, pos);
-	MARK_HEADER_AS_NOT_DELETED(item_header);
+	DataBlock_MarkItemUsed(dataBlock, pos);
+	return ITEM_DATA(DataBlock_GetItemHeader(dataBlock, pos));
+}
 
-	return ITEM_DATA(item_header);
+void *DataBlock_AllocateItemAt(DataBlock *dataBlock, uint64_t idx) {
+	ASSERT(dataBlock != NULL);
+
+	uint64_t deletedCount = array_len(dataBlock->deletedIdx);
+	uint64_t end = dataBlock->itemCount + deletedCount;
+
+	if(idx < end) {
+		// reuse a free index, search from the end of the free list
+		// as that's where DataBlock_AllocateItem would have picked it from
+		uint64_t i = deletedCount;
+		while(i > 0 && dataBlock->deletedIdx[i - 1] != idx) i--;
+		if(i == 0) return NULL;  // item in use
+		array_del(dataBlock->deletedIdx, i - 1);
+	} else {
+		// extend the datablock, marking skipped items as deleted
+		DataBlock_Ensure(dataBlock, idx);
+		for(uint64_t i = end; i < idx; i++) {
+			DataBlock_MarkItemDeleted(dataBlock, i);
+			array_append(dataBlock->deletedIdx, i);
+		}
+	}
+	dataBlock->itemCount++;
+
+	DataBlock_MarkItemUsed(dataBlock, idx);
+	return ITEM_DATA(DataBlock_GetItemHeader(dataBlock, idx));
 }
 
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
@@ -173,22 +227,80 @@ void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx) {
 		dataBlock->destructor(item);
 	}
 
-	MARK_HEADER_AS_DELETED(item_header);
-
 	/* DataBlock_DeleteItem should be thread-safe as it's being called
 	 * from GraphBLAS concurent operations, e.g. GxB_SelectOp.
 	 * As such updateing the datablock deleted indices array must be guarded
 	 * if there's enough space to accommodate the deleted idx the operation should
 	 * return quickly otherwise, memory reallocation will occur, which we want to perform
-	 * in a thread safe matter. */
+	 * in a thread safe matter.
+	 * neighbouring items share a word of their block's deletion bitmap
+	 * which is updated under the same lock. */
 	pthread_mutex_lock(&dataBlock->mutex);
 	{
+		DataBlock_MarkItemDeleted(dataBlock, idx);
 		array_append(dataBlock->deletedIdx, idx);
 		dataBlock->itemCount--;
 	}
 	pthread_mutex_unlock(&dataBlock->mutex);
 }
 
+uint64_t DataBlock_Trim(DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+
+	// walk down from the last used index while items are deleted
+	// skipping entirely deleted bitmap words
+	uint64_t deletedCount = array_len(dataBlock->deletedIdx);
+	uint64_t end = dataBlock->itemCount + deletedCount;
+	uint64_t newEnd = end;
+	while(newEnd > 0) {
+		uint64_t pos;
+		Block *block = dataBlock->blocks[DataBlock_BlockIndex(newEnd - 1, &pos)];
+		if(block->deleted_count == 0) break;
+
+		// positions up to and including pos within pos' word
+		uint64_t mask = ~0ULL >> (63 - (pos & 63));
+		uint64_t word = block->deleted[pos >> 6] & mask;
+		if(word == mask) {
+			newEnd -= (pos & 63) + 1;
+			continue;
+		}
+
+		// last item in use within the word
+		newEnd -= (pos & 63) - (63 - __builtin_clzll(~word & mask));
+		break;
+	}
+
+	// always keep at least a single block
+	uint blockCount = DataBlock_BlockCount(newEnd);
+	if(blockCount == 0) blockCount = 1;
+
+	// trimming is only worthwhile once a block can be released
+	if(blockCount >= dataBlock->blockCount) return 0;
+
+	// discard trailing indices from the free list
+	uint64_t j = 0;
+	for(uint64_t i = 0; i < deletedCount; i++) {
+		uint64_t idx = dataBlock->deletedIdx[i];
+		if(idx < newEnd) dataBlock->deletedIdx[j++] = idx;
+	}
+	dataBlock->deletedIdx = array_trimm_len(dataBlock->deletedIdx, j);
+	ASSERT(dataBlock->itemCount + j == newEnd);
+
+	// release blocks
+	for(uint i = blockCount; i < dataBlock->blockCount; i++) {
+		Block_Free(dataBlock->blocks[i]);
+	}
+	dataBlock->blocks[blockCount - 1]->next = NULL;
+
+	uint released = dataBlock->blockCount - blockCount;
+	dataBlock->blockCount = blockCount;
+	dataBlock->blocks = rm_realloc(dataBlock->blocks,
+			sizeof(Block *) * dataBlock->blockCount);
+	dataBlock->itemCap = DataBlock_BlockStart(dataBlock->blockCount);
+
+	return released;
+}
+
 uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock) {
 	return array_len(dataBlock->deletedIdx);
 }
@@ -198,6 +310,50 @@ inline bool DataBlock_ItemIsDeleted(void *item) {
 	return IS_ITEM_DELETED(header);
 }
 
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock) {
+	ASSERT(dataBlock != NULL);
+
+	// blocks vary in size, together they hold itemCap items
+	size_t bitmaps = 0;
+	for(uint i = 0; i < dataBlock->blockCount; i++) {
+		Block *block = dataBlock->blocks[i];
+		if(block->deleted == NULL) continue;
+		bitmaps += BLOCK_BITMAP_WORDS(block->capacity) * sizeof(uint64_t);
+	}
+
+	return sizeof(DataBlock) +
+		dataBlock->blockCount * (sizeof(Block *) + sizeof(Block)) +
+		dataBlock->itemCap * dataBlock->itemSize +
+		array_sizeof(array_hdr(dataBlock->deletedIdx)) + bitmaps;
+}
+
+uint DataBlock_ReleaseBlocks(DataBlock *dataBlock, uint n) {
+	ASSERT(dataBlock != NULL);
+
+	// items beyond the last used index are uninitialized
+	uint64_t end = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+	if(end > dataBlock->itemCap) end = dataBlock->itemCap;
+
+	for(; n > 0 && dataBlock->blockCount > 0; n--) {
+		uint b = dataBlock->blockCount - 1;
+		uint64_t first = DataBlock_BlockStart(b);
+
+		if(dataBlock->destructor) {
+			for(uint64_t idx = first; idx < end; idx++) {
+				DataBlockItemHeader *header = DataBlock_GetItemHeader(dataBlock, idx);
+				if(!IS_ITEM_DELETED(header)) dataBlock->destructor(ITEM_DATA(header));
+			}
+		}
+		if(end > first) end = first;
+
+		Block_Free(dataBlock->blocks[b]);
+		dataBlock->blockCount--;
+		dataBlock->itemCap = first;
+	}
+
+	return dataBlock->blockCount;
+}
+
 void DataBlock_Free(DataBlock *dataBlock) {
 	for(uint i = 0; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
 
@@ -208,4 +364,3 @@ void DataBlock_Free(DataBlock *dataBlock) {
 	ASSERT(res == 0);
 	rm_free(dataBlock);
 }
-
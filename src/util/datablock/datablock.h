@@ -15,7 +15,18 @@
 typedef void (*fpDestructor)(void *);
 
 // Number of items in a block. Should always be a power of 2.
-#define DATABLOCK_BLOCK_CAP 16384
+#define DATABLOCK_BLOCK_SHIFT 14
+#define DATABLOCK_BLOCK_CAP (1 << DATABLOCK_BLOCK_SHIFT)
+
+// Number of items in the first block, the blocks following it double in size
+// until reaching DATABLOCK_BLOCK_CAP, such that small datablocks don't reserve
+// memory for thousands of items they'll never hold.
+#define DATABLOCK_MIN_BLOCK_SHIFT 6
+#define DATABLOCK_MIN_BLOCK_CAP (1 << DATABLOCK_MIN_BLOCK_SHIFT)
+
+// Number of blocks holding the first DATABLOCK_BLOCK_CAP items.
+#define DATABLOCK_SMALL_BLOCK_COUNT \
+	(DATABLOCK_BLOCK_SHIFT - DATABLOCK_MIN_BLOCK_SHIFT + 1)
 
 // Returns the item header size.
 #define ITEM_HEADER_SIZE 1
@@ -35,6 +46,9 @@ typedef void (*fpDestructor)(void *);
 // Checks if the deleted bit in the header is 1 or not.
 #define IS_ITEM_DELETED(header) ((header)->deleted & 1)
 
+// Number of 64 bit words in the deletion bitmap of a block holding cap items.
+#define BLOCK_BITMAP_WORDS(cap) (((cap) + 63) / 64)
+
 
 /* The DataBlock is a container structure for holding arbitrary items of a uniform type
  * in order to reduce the number of alloc/free calls and improve locality of reference.
@@ -57,6 +71,44 @@ typedef struct {
 	unsigned char deleted: 1;  // A bit indicate if the current item is deleted or not.
 } DataBlockItemHeader;
 
+// Returns the number of items block 'b' holds.
+static inline uint64_t DataBlock_BlockCap(uint b) {
+	if(b == 0) return DATABLOCK_MIN_BLOCK_CAP;
+	if(b < DATABLOCK_SMALL_BLOCK_COUNT) return (uint64_t)DATABLOCK_MIN_BLOCK_CAP << (b - 1);
+	return DATABLOCK_BLOCK_CAP;
+}
+
+// Returns the index of the first item in block 'b'
+// which is also the number of items held by the blocks preceding it.
+static inline uint64_t DataBlock_BlockStart(uint b) {
+	if(b == 0) return 0;
+	if(b < DATABLOCK_SMALL_BLOCK_COUNT) return (uint64_t)DATABLOCK_MIN_BLOCK_CAP << (b - 1);
+	return (uint64_t)(b - DATABLOCK_SMALL_BLOCK_COUNT + 1) << DATABLOCK_BLOCK_SHIFT;
+}
+
+// Returns the index of the block holding item 'idx'
+// sets 'pos' to the item's position within that block.
+static inline uint DataBlock_BlockIndex(uint64_t idx, uint64_t *pos) {
+	if(idx >= DATABLOCK_BLOCK_CAP) {
+		*pos = idx & (DATABLOCK_BLOCK_CAP - 1);
+		return (idx >> DATABLOCK_BLOCK_SHIFT) + DATABLOCK_SMALL_BLOCK_COUNT - 1;
+	}
+	if(idx < DATABLOCK_MIN_BLOCK_CAP) {
+		*pos = idx;
+		return 0;
+	}
+	// small blocks start at powers of 2
+	uint msb = 63 - __builtin_clzll(idx);
+	*pos = idx - ((uint64_t)1 << msb);
+	return msb - DATABLOCK_MIN_BLOCK_SHIFT + 1;
+}
+
+// Returns the number of blocks required to accommodate 'n' items.
+static inline uint DataBlock_BlockCount(uint64_t n) {
+	uint64_t pos;
+	return (n == 0) ? 0 : DataBlock_BlockIndex(n - 1, &pos) + 1;
+}
+
 // Create a new DataBlock
 // itemCap - number of items datablock can hold before resizing.
 // itemSize - item size in bytes.
@@ -78,20 +130,50 @@ DataBlockIterator *DataBlock_Scan(const DataBlock *dataBlock);
 // Get item at position idx
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 
+// Hint the CPU to load item at position idx, out of bounds positions are ignored.
+void DataBlock_Prefetch(const DataBlock *dataBlock, uint64_t idx);
+
+// Marks item at position idx as deleted, in its header and its block's bitmap.
+void DataBlock_MarkItemDeleted(DataBlock *dataBlock, uint64_t idx);
+
+// Marks item at position idx as in use, in its header and its block's bitmap.
+void DataBlock_MarkItemUsed(DataBlock *dataBlock, uint64_t idx);
+
+// Get item at position idx, NULL if idx is out of bounds or the item is deleted.
+void *DataBlock_PeekItem(const DataBlock *dataBlock, uint64_t idx);
+
 // Allocate a new item within given dataBlock,
 // if idx is not NULL, idx will contain item position
 // return a pointer to the newly allocated item.
 void *DataBlock_AllocateItem(DataBlock *dataBlock, uint64_t *idx);
 
+// Allocate item at position idx, which must either be free or beyond the
+// last used position, skipped positions are marked as deleted
+// returns NULL if idx is in use.
+void *DataBlock_AllocateItemAt(DataBlock *dataBlock, uint64_t idx);
+
 // Removes item at position idx.
 void DataBlock_DeleteItem(DataBlock *dataBlock, uint64_t idx);
 
+// Releases trailing blocks holding only deleted items.
+// Indices of live items are left untouched, returns the number of released blocks.
+uint64_t DataBlock_Trim(DataBlock *dataBlock);
+
 // Returns the number of deleted items.
 uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
 
 // Returns true if the given item has been deleted.
 bool DataBlock_ItemIsDeleted(void *item);
 
+// Returns the number of bytes used by the datablock, excluding memory
+// referenced by its items.
+size_t DataBlock_MemoryUsage(const DataBlock *dataBlock);
+
+// Releases up to n trailing blocks, calling the item destructor on their
+// live items, returns the number of remaining blocks.
+// Used to free a datablock incrementally, which may only be freed afterwards.
+uint DataBlock_ReleaseBlocks(DataBlock *dataBlock, uint n);
+
 // Free block.
 void DataBlock_Free(DataBlock *block);
 
@@ -17,7 +17,9 @@ DataBlockIterator *DataBlockIterator_New(Block *block, uint64_t start_pos, uint6
 	DataBlockIterator *iter = rm_malloc(sizeof(DataBlockIterator));
 	iter->_start_block = block;
 	iter->_current_block = block;
-	iter->_block_pos = start_pos % DATABLOCK_BLOCK_CAP;
+	uint64_t block_pos;
+	DataBlock_BlockIndex(start_pos, &block_pos);
+	iter->_block_pos = block_pos;
 	iter->_start_pos = start_pos;
 	iter->_current_pos = iter->_start_pos;
 	iter->_end_pos = end_pos;
@@ -29,9 +31,64 @@ DataBlockIterator *DataBlockIterator_Clone(const DataBlockIterator *it) {
 	return DataBlockIterator_New(it->_start_block, it->_start_pos, it->_end_pos, it->_step);
 }
 
+// returns the position of the first item within 'block' at or after 'pos'
+// which isn't deleted, or the block's capacity if there's none
+// deleted items are skipped a bitmap word at a time
+static inline uint _NextUsedPosition(const Block *block, uint pos) {
+	if(block->deleted_count == 0) return pos;
+	if(block->deleted_count == block->capacity) return block->capacity;
+
+	uint w = pos >> 6;
+	uint words = BLOCK_BITMAP_WORDS(block->capacity);
+	uint64_t used = ~block->deleted[w] & (~0ULL << (pos & 63));
+	while(used == 0) {
+		if(++w == words) return block->capacity;
+		used = ~block->deleted[w];
+	}
+
+	return (w << 6) + __builtin_ctzll(used);
+}
+
+// scans consecutive positions, locating items via the blocks' bitmaps
+static void *_NextDense(DataBlockIterator *iter, uint64_t *id) {
+	while(iter->_current_pos < iter->_end_pos && iter->_current_block != NULL) {
+		Block *block = iter->_current_block;
+		uint pos = _NextUsedPosition(block, iter->_block_pos);
+		iter->_current_pos += pos - iter->_block_pos;
+		iter->_block_pos = pos;
+
+		// rest of the block is deleted
+		if(pos >= block->capacity) {
+			iter->_block_pos = 0;
+			iter->_current_block = block->next;
+			continue;
+		}
+
+		if(iter->_current_pos >= iter->_end_pos) break;
+
+		DataBlockItemHeader *item_header =
+			(DataBlockItemHeader *)block->data + (pos * block->itemSize);
+		ASSERT(!IS_ITEM_DELETED(item_header));
+		if(id) *id = iter->_current_pos;
+
+		// advance to next position
+		iter->_current_pos++;
+		if(++iter->_block_pos == block->capacity) {
+			iter->_block_pos = 0;
+			iter->_current_block = block->next;
+		}
+
+		return ITEM_DATA(item_header);
+	}
+
+	return NULL;
+}
+
 void *DataBlockIterator_Next(DataBlockIterator *iter, uint64_t *id) {
 	ASSERT(iter != NULL);
 
+	if(iter->_step == 1) return _NextDense(iter, id);
+
 	// Set default.
 	void *item = NULL;
 	DataBlockItemHeader *item_header = NULL;
@@ -47,8 +104,10 @@ void *DataBlockIterator_Next(DataBlockIterator *iter, uint64_t *id) {
 		iter->_current_pos += iter->_step;
 
 		// Advance to next block if current block consumed.
-		if(iter->_block_pos >= DATABLOCK_BLOCK_CAP) {
-			iter->_block_pos -= DATABLOCK_BLOCK_CAP;
+		// blocks vary in size, a step might skip over small blocks.
+		while(iter->_current_block != NULL &&
+			  iter->_block_pos >= iter->_current_block->capacity) {
+			iter->_block_pos -= iter->_current_block->capacity;
 			iter->_current_block = iter->_current_block->next;
 		}
 
@@ -62,9 +121,35 @@ void *DataBlockIterator_Next(DataBlockIterator *iter, uint64_t *id) {
 	return item;
 }
 
+uint64_t DataBlockIterator_Advance(DataBlockIterator *iter, uint64_t n) {
+	ASSERT(iter != NULL);
+
+	if(iter->_current_pos >= iter->_end_pos) return 0;
+
+	// Don't advance past the end position.
+	uint64_t remaining = (iter->_end_pos - iter->_current_pos + iter->_step - 1) /
+		iter->_step;
+	if(n > remaining) n = remaining;
+
+	uint64_t offset = n * iter->_step;
+	uint64_t block_pos = iter->_block_pos + offset;
+	while(iter->_current_block != NULL &&
+		  block_pos >= iter->_current_block->capacity) {
+		block_pos -= iter->_current_block->capacity;
+		iter->_current_block = iter->_current_block->next;
+	}
+
+	iter->_block_pos = block_pos;
+	iter->_current_pos += offset;
+
+	return n;
+}
+
 void DataBlockIterator_Reset(DataBlockIterator *iter) {
 	ASSERT(iter != NULL);
-	iter->_block_pos = iter->_start_pos % DATABLOCK_BLOCK_CAP;
+	uint64_t block_pos;
+	DataBlock_BlockIndex(iter->_start_pos, &block_pos);
+	iter->_block_pos = block_pos;
 	iter->_current_block = iter->_start_block;
 	iter->_current_pos = iter->_start_pos;
 }
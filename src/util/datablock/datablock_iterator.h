@@ -42,6 +42,11 @@ DataBlockIterator *DataBlockIterator_Clone(
 // `id` will be set to the returned item index
 void *DataBlockIterator_Next(DataBlockIterator *iter, uint64_t *id);
 
+// Advance iterator by 'n' positions, whether or not they hold items.
+// Returns the number of positions advanced, fewer than 'n' once the end
+// position is reached.
+uint64_t DataBlockIterator_Advance(DataBlockIterator *iter, uint64_t n);
+
 // Reset iterator to original position.
 void DataBlockIterator_Reset(DataBlockIterator *iter);
 
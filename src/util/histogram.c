@@ -0,0 +1,122 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "histogram.h"
+#include <string.h>
+
+// maps a value to its bucket
+static inline uint _Histogram_BucketIdx
+(
+	uint64_t v
+) {
+	// values smaller than HISTOGRAM_SUB_BUCKETS have a bucket of their own
+	if(v < HISTOGRAM_SUB_BUCKETS) return v;
+
+	uint exponent = 63 - __builtin_clzll(v);
+	if(exponent > HISTOGRAM_MAX_EXPONENT) {
+		return HISTOGRAM_BUCKET_COUNT - 1;
+	}
+
+	uint shift = exponent - HISTOGRAM_SUB_BUCKET_BITS;
+	uint sub   = (v >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+	return (shift + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+// largest value mapped to bucket
+static inline uint64_t _Histogram_BucketValue
+(
+	uint idx
+) {
+	if(idx < HISTOGRAM_SUB_BUCKETS) return idx;
+
+	uint shift = idx / HISTOGRAM_SUB_BUCKETS - 1;
+	uint64_t sub = idx % HISTOGRAM_SUB_BUCKETS;
+	uint64_t lower = (HISTOGRAM_SUB_BUCKETS + sub) << shift;
+	return lower + (((uint64_t)1 << shift) - 1);
+}
+
+void Histogram_Reset
+(
+	Histogram *h
+) {
+	ASSERT(h != NULL);
+	memset(h, 0, sizeof(Histogram));
+}
+
+void Histogram_Record
+(
+	Histogram *h,
+	uint64_t v
+) {
+	ASSERT(h != NULL);
+
+	__atomic_fetch_add(h->buckets + _Histogram_BucketIdx(v), 1,
+			__ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->sum, v, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&h->count, 1, __ATOMIC_RELAXED);
+
+	uint64_t max = __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+	while(v > max && !__atomic_compare_exchange_n(&h->max, &max, v, true,
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+uint64_t Histogram_Count
+(
+	const Histogram *h
+) {
+	ASSERT(h != NULL);
+	return __atomic_load_n(&h->count, __ATOMIC_RELAXED);
+}
+
+uint64_t Histogram_Sum
+(
+	const Histogram *h
+) {
+	ASSERT(h != NULL);
+	return __atomic_load_n(&h->sum, __ATOMIC_RELAXED);
+}
+
+uint64_t Histogram_Max
+(
+	const Histogram *h
+) {
+	ASSERT(h != NULL);
+	return __atomic_load_n(&h->max, __ATOMIC_RELAXED);
+}
+
+uint64_t Histogram_Percentile
+(
+	const Histogram *h,
+	double percentile
+) {
+	ASSERT(h != NULL);
+	ASSERT(percentile >= 0 && percentile <= 100);
+
+	// buckets might be updated concurrently, sum them up rather than
+	// relying on count
+	uint64_t total = 0;
+	for(uint i = 0; i < HISTOGRAM_BUCKET_COUNT; i++) {
+		total += __atomic_load_n(h->buckets + i, __ATOMIC_RELAXED);
+	}
+	if(total == 0) return 0;
+
+	uint64_t rank = (uint64_t)((percentile / 100.0) * total + 0.5);
+	if(rank == 0) rank = 1;
+
+	uint64_t seen = 0;
+	uint64_t max = Histogram_Max(h);
+	for(uint i = 0; i < HISTOGRAM_BUCKET_COUNT; i++) {
+		seen += __atomic_load_n(h->buckets + i, __ATOMIC_RELAXED);
+		if(seen >= rank) {
+			uint64_t v = _Histogram_BucketValue(i);
+			// never report beyond the largest recorded value
+			return (v < max) ? v : max;
+		}
+	}
+
+	return max;
+}
@@ -0,0 +1,69 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// log-linear histogram of non-negative integer values
+// every power of two range is split into HISTOGRAM_SUB_BUCKETS linear buckets
+// such that reported values are within 1/HISTOGRAM_SUB_BUCKETS of the
+// recorded value, values beyond 2^HISTOGRAM_MAX_EXPONENT are clamped
+//
+// recording is lock-free and safe to call concurrently
+// readers observe a consistent enough view for percentile estimation
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_MAX_EXPONENT 40
+#define HISTOGRAM_BUCKET_COUNT \
+	((HISTOGRAM_MAX_EXPONENT - HISTOGRAM_SUB_BUCKET_BITS + 2) * \
+	 HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+	uint64_t count;                            // number of recorded values
+	uint64_t sum;                              // sum of recorded values
+	uint64_t max;                              // largest recorded value
+	uint64_t buckets[HISTOGRAM_BUCKET_COUNT];  // value counts
+} Histogram;
+
+// clear histogram
+void Histogram_Reset
+(
+	Histogram *h
+);
+
+// record a single value
+void Histogram_Record
+(
+	Histogram *h,
+	uint64_t v
+);
+
+// number of recorded values
+uint64_t Histogram_Count
+(
+	const Histogram *h
+);
+
+// sum of recorded values
+uint64_t Histogram_Sum
+(
+	const Histogram *h
+);
+
+// largest recorded value
+uint64_t Histogram_Max
+(
+	const Histogram *h
+);
+
+// returns the value below which 'percentile' percent of the values fall
+// 0 is returned for an empty histogram
+uint64_t Histogram_Percentile
+(
+	const Histogram *h,
+	double percentile  // [0-100]
+);
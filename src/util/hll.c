@@ -0,0 +1,78 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "hll.h"
+#include <math.h>
+#include <string.h>
+
+void HLL_Reset
+(
+	HLL *hll
+) {
+	ASSERT(hll != NULL);
+	memset(hll->registers, 0, sizeof(hll->registers));
+}
+
+void HLL_Add
+(
+	HLL *hll,
+	uint64_t hash
+) {
+	ASSERT(hll != NULL);
+
+	uint idx = hash >> (64 - HLL_PRECISION);
+
+	// position of the first set bit within the remaining bits
+	// a sentinel bit bounds the run for hashes whose remaining bits are zero
+	uint64_t rest = (hash << HLL_PRECISION) | ((uint64_t)1 << (HLL_PRECISION - 1));
+	uint8_t rank = __builtin_clzll(rest) + 1;
+
+	if(rank > hll->registers[idx]) hll->registers[idx] = rank;
+}
+
+void HLL_Merge
+(
+	HLL *dest,
+	const HLL *src
+) {
+	ASSERT(dest != NULL);
+	ASSERT(src  != NULL);
+
+	for(uint i = 0; i < HLL_REGISTERS; i++) {
+		if(src->registers[i] > dest->registers[i]) {
+			dest->registers[i] = src->registers[i];
+		}
+	}
+}
+
+uint64_t HLL_Count
+(
+	const HLL *hll
+) {
+	ASSERT(hll != NULL);
+
+	const double m = HLL_REGISTERS;
+	const double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+	// harmonic mean of the registers
+	double sum = 0;
+	uint zeros = 0;
+	for(uint i = 0; i < HLL_REGISTERS; i++) {
+		sum += ldexp(1.0, -hll->registers[i]);
+		zeros += (hll->registers[i] == 0);
+	}
+
+	double estimate = alpha * m * m / sum;
+
+	// small cardinalities are better estimated by linear counting
+	// 64 bit hashes make a large range correction unnecessary
+	if(estimate <= 2.5 * m && zeros > 0) {
+		estimate = m * log(m / zeros);
+	}
+
+	return (uint64_t)(estimate + 0.5);
+}
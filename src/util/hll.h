@@ -0,0 +1,51 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// HyperLogLog distinct count estimator
+// values are added by their 64 bit hash, the first HLL_PRECISION bits
+// select a register which retains the longest run of leading zeros observed
+// in the remaining bits
+//
+// memory is fixed at HLL_REGISTERS bytes, the standard error is
+// 1.04 / sqrt(HLL_REGISTERS), ~1.6%
+// sketches are merged by taking the maximum of each register
+#define HLL_PRECISION 12
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+typedef struct {
+	uint8_t registers[HLL_REGISTERS];  // longest zero run + 1 per register
+} HLL;
+
+// clear sketch
+void HLL_Reset
+(
+	HLL *hll
+);
+
+// add a value by its hash
+void HLL_Add
+(
+	HLL *hll,
+	uint64_t hash
+);
+
+// merge 'src' into 'dest'
+// 'dest' estimates the distinct count of the union of both sketches
+void HLL_Merge
+(
+	HLL *dest,
+	const HLL *src
+);
+
+// estimate number of distinct values added
+uint64_t HLL_Count
+(
+	const HLL *hll
+);
@@ -5,199 +5,384 @@
 */
 
 #include "json_encoder.h"
-#include "sds/sds.h"
+#include "RG.h"
 #include "rmalloc.h"
-#include "strutil.h"
-#include "../value.h"
+#include "string_pool.h"
 #include "../errors.h"
 #include "../query_ctx.h"
-#include "../graph/graphcontext.h"
 #include "../graph/entities/node.h"
 #include "../graph/entities/edge.h"
 #include "../datatypes/datatypes.h"
 
-// Forward declaration
-sds _JsonEncoder_SIValue(SIValue v, sds s);
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-static inline sds _JsonEncoder_String(SIValue v, sds s) {
-	return sdscatfmt(s, "\"%s\"", v.stringval);
+// appends a string literal
+#define JSON_LITERAL(w, s) JsonWriter_Raw((w), (s), sizeof(s) - 1)
+
+// buffer size sufficient for any double printed with %.15g followed by ".0"
+#define JSON_DOUBLE_BUFSIZE 40
+
+// "00" "01" ... "99", integers are printed two digits at a time
+static const char _digit_pairs[201] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+// characters requiring escaping within a JSON string:
+// control characters, quotation mark and reverse solidus
+static inline bool _Json_MustEscape(unsigned char c) {
+	return c < 0x20 || c == '"' || c == '\\';
+}
+
+// ensures room for 'n' additional bytes
+static inline void _JsonWriter_Reserve(JsonWriter *w, size_t n) {
+	if(w->len + n <= w->cap) return;
+	size_t cap = w->cap * 2;
+	if(cap < w->len + n) cap = w->len + n;
+	w->buf = rm_realloc(w->buf, cap);
+	w->cap = cap;
+}
+
+static inline void _JsonWriter_Char(JsonWriter *w, char c) {
+	_JsonWriter_Reserve(w, 1);
+	w->buf[w->len++] = c;
+}
+
+// returns the offset of the first character of 's' requiring escaping
+// or 'len' if there is none, most strings don't require any escaping
+// and are scanned 16 bytes at a time where SSE2 is available
+static size_t _Json_ScanEscape(const char *s, size_t len) {
+	size_t i = 0;
+#ifdef __SSE2__
+	const __m128i quote  = _mm_set1_epi8('"');
+	const __m128i bslash = _mm_set1_epi8('\\');
+	const __m128i ctrl   = _mm_set1_epi8(0x1F);
+	for(; i + 16 <= len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+		// unsigned v <= 0x1F iff max(v, 0x1F) == 0x1F
+		__m128i m = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash)),
+				_mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl));
+		int mask = _mm_movemask_epi8(m);
+		if(mask != 0) return i + __builtin_ctz(mask);
+	}
+#endif
+	for(; i < len; i++) {
+		if(_Json_MustEscape(s[i])) return i;
+	}
+	return len;
+}
+
+void JsonWriter_Init
+(
+	JsonWriter *w,
+	GraphContext *gc,
+	size_t cap
+) {
+	ASSERT(w != NULL);
+
+	if(cap == 0) cap = 1;
+	w->buf = rm_malloc(cap);
+	w->len = 0;
+	w->cap = cap;
+	w->gc  = gc;
 }
 
-static sds _JsonEncoder_Properties(const GraphEntity *ge, sds s) {
-	s = sdscat(s, "\"properties\": {");
+void JsonWriter_Raw
+(
+	JsonWriter *w,
+	const char *s,
+	size_t len
+) {
+	_JsonWriter_Reserve(w, len);
+	memcpy(w->buf + w->len, s, len);
+	w->len += len;
+}
+
+void JsonWriter_String
+(
+	JsonWriter *w,
+	const char *s,
+	size_t len
+) {
+	// room for the unescaped string and its quotes
+	_JsonWriter_Reserve(w, len + 2);
+	w->buf[w->len++] = '"';
+
+	while(len > 0) {
+		// copy the run preceding the next escaped character at once
+		size_t run = _Json_ScanEscape(s, len);
+		JsonWriter_Raw(w, s, run);
+		if(run == len) break;
+
+		unsigned char c = s[run];
+		char esc[6] = {'\\', 0};
+		size_t n = 2;
+		switch(c) {
+		case '"':  esc[1] = '"';  break;
+		case '\\': esc[1] = '\\'; break;
+		case '\b': esc[1] = 'b';  break;
+		case '\f': esc[1] = 'f';  break;
+		case '\n': esc[1] = 'n';  break;
+		case '\r': esc[1] = 'r';  break;
+		case '\t': esc[1] = 't';  break;
+		default:
+			// \u00XX
+			esc[1] = 'u';
+			esc[2] = '0';
+			esc[3] = '0';
+			esc[4] = "0123456789abcdef"[c >> 4];
+			esc[5] = "0123456789abcdef"[c & 0xF];
+			n = 6;
+			break;
+		}
+		JsonWriter_Raw(w, esc, n);
+
+		s   += run + 1;
+		len -= run + 1;
+	}
+
+	_JsonWriter_Char(w, '"');
+}
+
+static void _JsonWriter_Int(JsonWriter *w, int64_t n) {
+	char digits[20];
+	char *p = digits + sizeof(digits);
+	uint64_t u = (n < 0) ? -(uint64_t)n : (uint64_t)n;
+
+	while(u >= 100) {
+		uint idx = (u % 100) * 2;
+		u /= 100;
+		*--p = _digit_pairs[idx + 1];
+		*--p = _digit_pairs[idx];
+	}
+	if(u >= 10) {
+		uint idx = u * 2;
+		*--p = _digit_pairs[idx + 1];
+		*--p = _digit_pairs[idx];
+	} else {
+		*--p = '0' + u;
+	}
+
+	size_t len = digits + sizeof(digits) - p;
+	_JsonWriter_Reserve(w, len + 1);
+	if(n < 0) w->buf[w->len++] = '-';
+	memcpy(w->buf + w->len, p, len);
+	w->len += len;
+}
+
+// doubles are printed with 15 significant digits as in result-sets
+// and always carry a fraction or an exponent, such that they are read back
+// as floats, JSON can't represent NaN or infinity, these are encoded as null
+static void _JsonWriter_Double(JsonWriter *w, double d) {
+	if(!isfinite(d)) {
+		JSON_LITERAL(w, "null");
+		return;
+	}
+
+	// integral values are printed without the printf machinery
+	if(d > -1e15 && d < 1e15 && d == (double)(int64_t)d &&
+	   !(d == 0 && signbit(d))) {
+		_JsonWriter_Int(w, (int64_t)d);
+		JSON_LITERAL(w, ".0");
+		return;
+	}
+
+	char buf[JSON_DOUBLE_BUFSIZE];
+	int len = snprintf(buf, sizeof(buf), "%.15g", d);
+	if(strpbrk(buf, ".e") == NULL) {
+		buf[len++] = '.';
+		buf[len++] = '0';
+	}
+	JsonWriter_Raw(w, buf, len);
+}
+
+static inline void _JsonWriter_CString(JsonWriter *w, const char *s) {
+	JsonWriter_String(w, s, strlen(s));
+}
+
+static void _JsonWriter_Properties(JsonWriter *w, const GraphEntity *ge) {
+	JSON_LITERAL(w, "\"properties\": {");
 	uint prop_count = ENTITY_PROP_COUNT(ge);
-	EntityProperty *properties = ENTITY_PROPS(ge);
-	GraphContext *gc = QueryCtx_GetGraphCtx();
+	SIValue *values = ENTITY_PROP_VALUES(ge);
+	const Attribute_ID *ids = ENTITY_PROP_IDS(ge);
 	for(uint i = 0; i < prop_count; i ++) {
-		const char *key = GraphContext_GetAttributeString(gc, properties[i].id);
-		s = sdscatfmt(s, "\"%s\": ", key);
-		s = _JsonEncoder_SIValue(properties[i].value, s);
-		if(i < prop_count - 1) s = sdscat(s, ", ");
+		if(i > 0) JSON_LITERAL(w, ", ");
+		const char *key = GraphContext_GetAttributeString(w->gc, ids[i]);
+		_JsonWriter_CString(w, key);
+		JSON_LITERAL(w, ": ");
+		JsonWriter_SIValue(w, *Entity_ReadValue(values + i));
 	}
-	s = sdscat(s, "}");
-	return s;
+	_JsonWriter_Char(w, '}');
 }
 
-static sds _JsonEncoder_Node(const Node *n, sds s) {
-	s = sdscatfmt(s, "\"id\": %U", ENTITY_GET_ID(n));
-	s = sdscat(s, ", \"labels\": [");
-	// Retrieve node labels
+static void _JsonWriter_Node(JsonWriter *w, const Node *n) {
+	JSON_LITERAL(w, "\"id\": ");
+	_JsonWriter_Int(w, ENTITY_GET_ID(n));
+	JSON_LITERAL(w, ", \"labels\": [");
+	// retrieve node labels
 	uint label_count;
-	GraphContext *gc = QueryCtx_GetGraphCtx();
-	NODE_GET_LABELS(gc->g, n, label_count);
+	NODE_GET_LABELS(w->gc->g, n, label_count);
 	for(uint i = 0; i < label_count; i ++) {
-		Schema *schema = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		if(i > 0) JSON_LITERAL(w, ", ");
+		Schema *schema = GraphContext_GetSchemaByID(w->gc, labels[i], SCHEMA_NODE);
 		ASSERT(schema);
 		const char *label = Schema_GetName(schema);
 		ASSERT(label);
-		s = sdscatfmt(s, "\"%s\"", label);
+		_JsonWriter_CString(w, label);
 	}
-	s = sdscat(s, "], ");
-	s = _JsonEncoder_Properties((const GraphEntity *)n, s);
-	return s;
+	JSON_LITERAL(w, "], ");
+	_JsonWriter_Properties(w, (const GraphEntity *)n);
 }
 
-static sds _JsonEncoder_Edge(Edge *e, sds s) {
-	s = sdscatfmt(s, "\"id\": %U", ENTITY_GET_ID(e));
-	GraphContext *gc = QueryCtx_GetGraphCtx();
-	// Retrieve reltype data.
-	int id = Graph_GetEdgeRelation(gc->g, e);
-	Schema *schema = GraphContext_GetSchemaByID(gc, id, SCHEMA_EDGE);
+static void _JsonWriter_Edge(JsonWriter *w, Edge *e) {
+	Graph *g = w->gc->g;
+	JSON_LITERAL(w, "\"id\": ");
+	_JsonWriter_Int(w, ENTITY_GET_ID(e));
+	// retrieve reltype data
+	int id = Graph_GetEdgeRelation(g, e);
+	Schema *schema = GraphContext_GetSchemaByID(w->gc, id, SCHEMA_EDGE);
 	ASSERT(schema);
 	const char *relationship = Schema_GetName(schema);
 	ASSERT(relationship);
-	s = sdscatfmt(s, ", \"relationship\": \"%s\", ", relationship);
+	JSON_LITERAL(w, ", \"relationship\": ");
+	_JsonWriter_CString(w, relationship);
+	JSON_LITERAL(w, ", ");
 
-	s = _JsonEncoder_Properties((const GraphEntity *)e, s);
+	_JsonWriter_Properties(w, (const GraphEntity *)e);
 
-	s = sdscat(s, ", \"start\": {");
-	// Retrieve source node data.
+	JSON_LITERAL(w, ", \"start\": {");
+	// retrieve source node data
 	Node src;
-	Graph_GetNode(gc->g, e->srcNodeID, &src);
-	s = _JsonEncoder_Node(&src, s);
+	Graph_GetNode(g, e->srcNodeID, &src);
+	_JsonWriter_Node(w, &src);
 
-	s = sdscat(s, "}, \"end\": {");
-	// Retrieve dest node data.
+	JSON_LITERAL(w, "}, \"end\": {");
+	// retrieve dest node data
 	Node dest;
-	Graph_GetNode(gc->g, e->destNodeID, &dest);
-	s = _JsonEncoder_Node(&dest, s);
+	Graph_GetNode(g, e->destNodeID, &dest);
+	_JsonWriter_Node(w, &dest);
 
-	s = sdscat(s, "}");
-	return s;
+	_JsonWriter_Char(w, '}');
 }
 
-static sds _JsonEncoder_GraphEntity(GraphEntity *ge, sds s, GraphEntityType type) {
+static void _JsonWriter_GraphEntity(JsonWriter *w, GraphEntity *ge,
+		GraphEntityType type) {
 	switch(type) {
 	case GETYPE_NODE:
-		s = sdscat(s, "{\"type\": \"node\", ");
-		s = _JsonEncoder_Node((const Node *)ge, s);
+		JSON_LITERAL(w, "{\"type\": \"node\", ");
+		_JsonWriter_Node(w, (const Node *)ge);
 		break;
 	case GETYPE_EDGE:
-		s = sdscat(s, "{\"type\": \"relationship\", ");
-		s = _JsonEncoder_Edge((Edge *)ge, s);
+		JSON_LITERAL(w, "{\"type\": \"relationship\", ");
+		_JsonWriter_Edge(w, (Edge *)ge);
 		break;
 	default:
 		ASSERT(false);
 	}
-	s = sdscat(s, "}");
-	return s;
+	_JsonWriter_Char(w, '}');
 }
 
-static sds _JsonEncoder_Path(SIValue p, sds s) {
-	// open path with "["
-	s = sdscat(s, "[");
+static void _JsonWriter_Path(JsonWriter *w, SIValue p) {
+	_JsonWriter_Char(w, '[');
 
 	size_t nodeCount = SIPath_NodeCount(p);
-	for(size_t i = 0; i < nodeCount - 1; i ++) {
-		// write the next value
+	for(size_t i = 0; i < nodeCount; i ++) {
+		if(i > 0) {
+			// a relationship precedes every node but the first
+			JSON_LITERAL(w, ", ");
+			SIValue edge = SIPath_GetRelationship(p, i - 1);
+			_JsonWriter_GraphEntity(w, (GraphEntity *)edge.ptrval, GETYPE_EDGE);
+			JSON_LITERAL(w, ", ");
+		}
 		SIValue node = SIPath_GetNode(p, i);
-		s = _JsonEncoder_GraphEntity((GraphEntity *)node.ptrval, s, GETYPE_NODE);
-		s = sdscat(s, ", ");
-		SIValue edge = SIPath_GetRelationship(p, i);
-		s = _JsonEncoder_GraphEntity((GraphEntity *)edge.ptrval, s, GETYPE_EDGE);
-		s = sdscat(s, ", ");
-	}
-	// Handle last node.
-	if(nodeCount > 0) {
-		SIValue node = SIPath_GetNode(p, nodeCount - 1);
-		s = _JsonEncoder_GraphEntity((GraphEntity *)node.ptrval, s, GETYPE_NODE);
+		_JsonWriter_GraphEntity(w, (GraphEntity *)node.ptrval, GETYPE_NODE);
 	}
 
-	// close array with "]"
-	s = sdscat(s, "]");
-	return s;
+	_JsonWriter_Char(w, ']');
 }
 
-static sds _JsonEncoder_Array(SIValue list, sds s) {
-	// open array with "["
-	s = sdscat(s, "[");
+static void _JsonWriter_Array(JsonWriter *w, SIValue list) {
+	_JsonWriter_Char(w, '[');
 	uint arrayLen = SIArray_Length(list);
 	for(uint i = 0; i < arrayLen; i ++) {
-		// write the next value
-		s = _JsonEncoder_SIValue(SIArray_Get(list, i), s);
-		// if it is not the last element, add ", "
-		if(i != arrayLen - 1) s = sdscat(s, ", ");
+		if(i > 0) JSON_LITERAL(w, ", ");
+		JsonWriter_SIValue(w, SIArray_Get(list, i));
 	}
-
-	// close array with "]"
-	s = sdscat(s, "]");
-	return s;
+	_JsonWriter_Char(w, ']');
 }
 
-static sds _JsonEncoder_Map(SIValue map, sds s) {
+static void _JsonWriter_Map(JsonWriter *w, SIValue map) {
 	ASSERT(SI_TYPE(map) & T_MAP);
 
-	// "{" marks the beginning of a map
-	s = sdscat(s, "{");
-
+	_JsonWriter_Char(w, '{');
 	uint key_count = Map_KeyCount(map);
 	for(uint i = 0; i < key_count; i ++) {
+		if(i > 0) JSON_LITERAL(w, ", ");
 		Pair p = map.map[i];
-		// write the next key/value pair
-		s = _JsonEncoder_String(p.key, s);
-		s = sdscat(s, ": ");
-		s = _JsonEncoder_SIValue(p.val, s);
-		// if this is not the last element, add ", "
-		if(i != key_count - 1) s = sdscat(s, ", ");
+		JsonWriter_SIValue(w, p.key);
+		JSON_LITERAL(w, ": ");
+		JsonWriter_SIValue(w, p.val);
 	}
+	_JsonWriter_Char(w, '}');
+}
 
-	// "}" marks the end of a map
-	s = sdscat(s, "}");
-	return s;
+static void _JsonWriter_Point(JsonWriter *w, SIValue point) {
+	JSON_LITERAL(w, "{\"latitude\": ");
+	_JsonWriter_Double(w, Point_lat(point));
+	JSON_LITERAL(w, ", \"longitude\": ");
+	_JsonWriter_Double(w, Point_lon(point));
+	_JsonWriter_Char(w, '}');
 }
 
-sds _JsonEncoder_SIValue(SIValue v, sds s) {
-	switch(v.type) {
-	case T_STRING:
-		s = _JsonEncoder_String(v, s);
+void JsonWriter_SIValue
+(
+	JsonWriter *w,
+	SIValue v
+) {
+	switch(SI_TYPE(v)) {
+	case T_STRING: {
+		size_t len = (v.allocation == M_INTERN)
+			? StringPool_Length(v.stringval)
+			: strlen(v.stringval);
+		JsonWriter_String(w, v.stringval, len);
 		break;
+	}
 	case T_INT64:
-		s = sdscatfmt(s, "%I", v.longval);
+		_JsonWriter_Int(w, v.longval);
 		break;
 	case T_BOOL:
-		if(v.longval) s = sdscat(s, "true");
-		else s = sdscat(s, "false");
+		if(v.longval) JSON_LITERAL(w, "true");
+		else JSON_LITERAL(w, "false");
 		break;
 	case T_DOUBLE:
-		s = sdscatprintf(s, "%f", v.doubleval);
+		_JsonWriter_Double(w, v.doubleval);
 		break;
 	case T_NODE:
-		s = _JsonEncoder_GraphEntity(v.ptrval, s, GETYPE_NODE);
+		_JsonWriter_GraphEntity(w, v.ptrval, GETYPE_NODE);
 		break;
 	case T_EDGE:
-		s = _JsonEncoder_GraphEntity(v.ptrval, s, GETYPE_EDGE);
+		_JsonWriter_GraphEntity(w, v.ptrval, GETYPE_EDGE);
 		break;
 	case T_ARRAY:
-		s = _JsonEncoder_Array(v, s);
+		_JsonWriter_Array(w, v);
 		break;
 	case T_MAP:
-		s = _JsonEncoder_Map(v, s);
+		_JsonWriter_Map(w, v);
 		break;
 	case T_PATH:
-		s = _JsonEncoder_Path(v, s);
+		_JsonWriter_Path(w, v);
+		break;
+	case T_POINT:
+		_JsonWriter_Point(w, v);
 		break;
 	case T_NULL:
-		s = sdscat(s, "null");
+		JSON_LITERAL(w, "null");
 		break;
 	default:
 		// unrecognized type
@@ -205,18 +390,34 @@ sds _JsonEncoder_SIValue(SIValue v, sds s) {
 		ASSERT(false);
 		break;
 	}
+}
+
+char *JsonWriter_Detach
+(
+	JsonWriter *w
+) {
+	_JsonWriter_Char(w, '\0');
+	char *s = w->buf;
+	w->buf = NULL;
+	w->len = 0;
+	w->cap = 0;
 	return s;
 }
 
+void JsonWriter_Free
+(
+	JsonWriter *w
+) {
+	rm_free(w->buf);
+	w->buf = NULL;
+	w->len = 0;
+	w->cap = 0;
+}
+
 char *JsonEncoder_SIValue(SIValue v) {
-	// Create an empty sds string.
-	sds s = sdsempty();
-	// Populate the sds string with encoded data.
-	s = _JsonEncoder_SIValue(v, s);
-	// Duplicate the sds string into a standard C string.
-	char *retval = rm_strdup(s);
-	// Free the sds string.
-	sdsfree(s);
-	return retval;
+	JsonWriter w;
+	JsonWriter_Init(&w, QueryCtx_GetGraphCtx(), 64);
+	JsonWriter_SIValue(&w, v);
+	return JsonWriter_Detach(&w);
 }
 
@@ -7,6 +7,61 @@
 #pragma once
 
 #include "../value.h"
+#include "../graph/graphcontext.h"
+
+// JSON writer, values are encoded in a single pass into a growable buffer
+// the buffer is grown geometrically, such that a writer reused across
+// values, e.g. the rows of a result-set, seldom reallocates
+typedef struct {
+	char *buf;         // encoded output, not NULL terminated
+	size_t len;        // number of bytes written
+	size_t cap;        // number of bytes allocated
+	GraphContext *gc;  // resolves labels, relationship types and attributes
+} JsonWriter;
+
+// initialize writer 'w' with an initial capacity of 'cap' bytes
+void JsonWriter_Init
+(
+	JsonWriter *w,     // writer to initialize
+	GraphContext *gc,  // graph encoded entities belong to
+	size_t cap         // initial buffer capacity
+);
+
+// appends 'len' bytes of 's' as is
+void JsonWriter_Raw
+(
+	JsonWriter *w,
+	const char *s,
+	size_t len
+);
+
+// appends 's' as a quoted JSON string, escaping it as required
+void JsonWriter_String
+(
+	JsonWriter *w,
+	const char *s,
+	size_t len
+);
+
+// appends the JSON encoding of 'v'
+void JsonWriter_SIValue
+(
+	JsonWriter *w,
+	SIValue v
+);
+
+// returns the NULL terminated output, owned by the caller
+// the writer is left empty and can't be reused
+char *JsonWriter_Detach
+(
+	JsonWriter *w
+);
+
+// free writer's buffer
+void JsonWriter_Free
+(
+	JsonWriter *w
+);
 
 // Prints the input value to buffer encoded as a JSON string.
 char *JsonEncoder_SIValue(SIValue v);
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "mmap_store.h"
+#include "RG.h"
+#include "arr.h"
+#include "rmalloc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+struct MmapStore {
+	int fd;            // backing file descriptor, -1 if not created
+	char **segments;   // mapped segments
+	size_t offset;     // write offset within last segment
+	uint64_t size;     // number of bytes appended
+	bool failed;       // backing file couldn't be created or extended
+};
+
+MmapStore *MmapStore_New(void) {
+	MmapStore *store = rm_malloc(sizeof(MmapStore));
+
+	store->fd       = -1;
+	store->size     = 0;
+	store->offset   = 0;
+	store->failed   = false;
+	store->segments = array_new(char *, 1);
+
+	return store;
+}
+
+// creates the backing file in the server's working directory
+// the file is unlinked right away such that it never outlives the process
+static bool _MmapStore_CreateFile
+(
+	MmapStore *store
+) {
+	char path[] = "redisgraph-mmap-XXXXXX";
+	store->fd = mkstemp(path);
+	if(store->fd == -1) return false;
+	unlink(path);
+	return true;
+}
+
+// maps an additional segment at the end of the backing file
+static bool _MmapStore_AddSegment
+(
+	MmapStore *store
+) {
+	if(store->fd == -1 && !_MmapStore_CreateFile(store)) return false;
+
+	off_t file_size = (off_t)array_len(store->segments) * MMAP_STORE_SEGMENT_SIZE;
+	if(ftruncate(store->fd, file_size + MMAP_STORE_SEGMENT_SIZE) != 0) {
+		return false;
+	}
+
+	char *segment = mmap(NULL, MMAP_STORE_SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+			MAP_SHARED, store->fd, file_size);
+	if(segment == MAP_FAILED) return false;
+
+	array_append(store->segments, segment);
+	store->offset = 0;
+
+	return true;
+}
+
+const char *MmapStore_AppendString
+(
+	MmapStore *store,
+	const char *s,
+	size_t len
+) {
+	ASSERT(store != NULL);
+	ASSERT(s     != NULL);
+
+	size_t n = len + 1;
+	if(store->failed || n > MMAP_STORE_SEGMENT_SIZE) return NULL;
+
+	if(array_len(store->segments) == 0 ||
+	   store->offset + n > MMAP_STORE_SEGMENT_SIZE) {
+		if(!_MmapStore_AddSegment(store)) {
+			// keep data in RAM from here on
+			store->failed = true;
+			return NULL;
+		}
+	}
+
+	char *dest = store->segments[array_len(store->segments) - 1] + store->offset;
+	memcpy(dest, s, len);
+	dest[len] = '\0';
+
+	store->offset += n;
+	store->size   += n;
+
+	return dest;
+}
+
+uint64_t MmapStore_Size
+(
+	const MmapStore *store
+) {
+	ASSERT(store != NULL);
+	return store->size;
+}
+
+void MmapStore_Free
+(
+	MmapStore *store
+) {
+	ASSERT(store != NULL);
+
+	uint n = array_len(store->segments);
+	for(uint i = 0; i < n; i++) {
+		munmap(store->segments[i], MMAP_STORE_SEGMENT_SIZE);
+	}
+	array_free(store->segments);
+
+	if(store->fd != -1) close(store->fd);
+	rm_free(store);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// size of a single memory-mapped segment
+#define MMAP_STORE_SEGMENT_SIZE (64 * 1024 * 1024)
+
+// append-only memory-mapped storage for rarely accessed data
+// data is written into fixed size segments of a file mapped into memory
+// the kernel faults pages in on access and is free to evict them
+// such that stored data does not have to remain resident
+//
+// the backing file is unlinked once created, it is reclaimed once the
+// store is freed, stored data is not persisted across restarts
+//
+// appended data remains at a fixed address for the lifetime of the store
+// the store must only be appended to by the thread holding the graph's
+// write access, stored data may be read concurrently
+typedef struct MmapStore MmapStore;
+
+// create a new store, the backing file is created on first append
+MmapStore *MmapStore_New(void);
+
+// copies 'len' bytes of 's' followed by a NULL terminator into the store
+// returns the stored copy or NULL if the data couldn't be stored
+const char *MmapStore_AppendString
+(
+	MmapStore *store,  // store to append to
+	const char *s,     // string to store
+	size_t len         // length of 's'
+);
+
+// number of bytes appended to the store
+uint64_t MmapStore_Size
+(
+	const MmapStore *store
+);
+
+// unmaps all segments and closes the backing file
+void MmapStore_Free
+(
+	MmapStore *store
+);
+
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "msgpack.h"
+#include "RG.h"
+#include "rmalloc.h"
+#include "../datatypes/map.h"
+#include "../datatypes/array.h"
+#include <string.h>
+
+MsgPackReader MsgPack_Reader
+(
+	const char *buf,
+	size_t len
+) {
+	ASSERT(buf != NULL || len == 0);
+	return (MsgPackReader) {
+		.buf = (const unsigned char *)buf, .len = len, .pos = 0
+	};
+}
+
+bool MsgPack_Done
+(
+	const MsgPackReader *reader
+) {
+	ASSERT(reader != NULL);
+	return reader->pos == reader->len;
+}
+
+// reads an 'n' bytes big-endian unsigned integer
+static bool _ReadUInt(MsgPackReader *reader, uint n, uint64_t *v) {
+	if(reader->len - reader->pos < n) return false;
+
+	uint64_t x = 0;
+	for(uint i = 0; i < n; i++) x = (x << 8) | reader->buf[reader->pos + i];
+	reader->pos += n;
+
+	*v = x;
+	return true;
+}
+
+// reads an 'n' bytes big-endian signed integer
+static bool _ReadInt(MsgPackReader *reader, uint n, int64_t *v) {
+	uint64_t x;
+	if(!_ReadUInt(reader, n, &x)) return false;
+
+	// sign extend
+	uint shift = 64 - n * 8;
+	*v = (int64_t)(x << shift) >> shift;
+	return true;
+}
+
+// reads the length of a string, array or map
+// whose type byte 'b' was already consumed
+static bool _ReadLength(MsgPackReader *reader, unsigned char b,
+		unsigned char fix_mask, unsigned char fix, unsigned char first,
+		uint first_size, uint32_t *len) {
+	if((b & ~fix_mask) == fix) {
+		*len = b & fix_mask;
+		return true;
+	}
+
+	// sized variants are consecutive, e.g. str8, str16, str32
+	for(uint i = 0; i < 3; i++) {
+		uint size = first_size << i;
+		if(b != first + i || size > 4) continue;
+		uint64_t l;
+		if(!_ReadUInt(reader, size, &l)) return false;
+		*len = l;
+		return true;
+	}
+
+	return false;
+}
+
+bool MsgPack_ReadMapHeader
+(
+	MsgPackReader *reader,
+	uint32_t *n
+) {
+	ASSERT(n != NULL);
+	ASSERT(reader != NULL);
+
+	if(reader->pos >= reader->len) return false;
+	unsigned char b = reader->buf[reader->pos++];
+	// fixmap, map16, map32
+	return _ReadLength(reader, b, 0x0f, 0x80, 0xde, 2, n);
+}
+
+bool MsgPack_ReadString
+(
+	MsgPackReader *reader,
+	const char **s,
+	uint32_t *len
+) {
+	ASSERT(s != NULL);
+	ASSERT(len != NULL);
+	ASSERT(reader != NULL);
+
+	if(reader->pos >= reader->len) return false;
+	unsigned char b = reader->buf[reader->pos++];
+	// fixstr, str8, str16, str32
+	if(!_ReadLength(reader, b, 0x1f, 0xa0, 0xd9, 1, len)) return false;
+	if(reader->len - reader->pos < *len) return false;
+
+	*s = (const char *)reader->buf + reader->pos;
+	reader->pos += *len;
+	return true;
+}
+
+// reads a string into a NULL terminated copy
+static bool _ReadOwnedString(MsgPackReader *reader, SIValue *v) {
+	const char *s;
+	uint32_t len;
+	if(!MsgPack_ReadString(reader, &s, &len)) return false;
+
+	char *str = rm_malloc(len + 1);
+	memcpy(str, s, len);
+	str[len] = '\0';
+	*v = SI_TransferStringVal(str);
+	return true;
+}
+
+static bool _ReadValue(MsgPackReader *reader, SIValue *v, uint depth);
+
+static bool _ReadArray(MsgPackReader *reader, uint32_t n, SIValue *v,
+		uint depth) {
+	// each element takes at least a byte, don't trust 'n' any further
+	if(reader->len - reader->pos < n) return false;
+
+	SIValue arr = SIArray_New(n);
+	for(uint32_t i = 0; i < n; i++) {
+		SIValue elem;
+		if(!_ReadValue(reader, &elem, depth + 1)) {
+			SIValue_Free(arr);
+			return false;
+		}
+		SIArray_Append(&arr, elem);
+		SIValue_Free(elem);
+	}
+
+	*v = arr;
+	return true;
+}
+
+static bool _ReadMap(MsgPackReader *reader, uint32_t n, SIValue *v,
+		uint depth) {
+	// each pair takes at least two bytes, don't trust 'n' any further
+	if((reader->len - reader->pos) / 2 < n) return false;
+
+	SIValue map = Map_New(n);
+	for(uint32_t i = 0; i < n; i++) {
+		SIValue key;
+		SIValue val;
+		if(!_ReadOwnedString(reader, &key)) {
+			SIValue_Free(map);
+			return false;
+		}
+		if(!_ReadValue(reader, &val, depth + 1)) {
+			SIValue_Free(key);
+			SIValue_Free(map);
+			return false;
+		}
+		Map_Add(&map, key, val);
+		SIValue_Free(key);
+		SIValue_Free(val);
+	}
+
+	*v = map;
+	return true;
+}
+
+static bool _ReadValue(MsgPackReader *reader, SIValue *v, uint depth) {
+	if(depth > MSGPACK_MAX_DEPTH) return false;
+	if(reader->pos >= reader->len) return false;
+
+	unsigned char b = reader->buf[reader->pos];
+
+	// positive fixint
+	if(b <= 0x7f) {
+		reader->pos++;
+		*v = SI_LongVal(b);
+		return true;
+	}
+
+	// negative fixint
+	if(b >= 0xe0) {
+		reader->pos++;
+		*v = SI_LongVal((int8_t)b);
+		return true;
+	}
+
+	// fixstr, str8, str16, str32
+	if((b & 0xe0) == 0xa0 || (b >= 0xd9 && b <= 0xdb)) {
+		return _ReadOwnedString(reader, v);
+	}
+
+	uint32_t n;
+	uint64_t u;
+	int64_t i;
+	reader->pos++;
+
+	// fixarray, array16, array32
+	if((b & 0xf0) == 0x90 || b == 0xdc || b == 0xdd) {
+		if(!_ReadLength(reader, b, 0x0f, 0x90, 0xdc, 2, &n)) return false;
+		return _ReadArray(reader, n, v, depth);
+	}
+
+	// fixmap, map16, map32
+	if((b & 0xf0) == 0x80 || b == 0xde || b == 0xdf) {
+		if(!_ReadLength(reader, b, 0x0f, 0x80, 0xde, 2, &n)) return false;
+		return _ReadMap(reader, n, v, depth);
+	}
+
+	switch(b) {
+		case 0xc0:  // nil
+			*v = SI_NullVal();
+			return true;
+		case 0xc2:  // false
+			*v = SI_BoolVal(false);
+			return true;
+		case 0xc3:  // true
+			*v = SI_BoolVal(true);
+			return true;
+		case 0xca: {  // float32
+			if(!_ReadUInt(reader, 4, &u)) return false;
+			uint32_t bits = u;
+			float f;
+			memcpy(&f, &bits, sizeof(f));
+			*v = SI_DoubleVal(f);
+			return true;
+		}
+		case 0xcb: {  // float64
+			if(!_ReadUInt(reader, 8, &u)) return false;
+			double d;
+			memcpy(&d, &u, sizeof(d));
+			*v = SI_DoubleVal(d);
+			return true;
+		}
+		case 0xcc:  // uint8
+		case 0xcd:  // uint16
+		case 0xce:  // uint32
+		case 0xcf:  // uint64
+			if(!_ReadUInt(reader, 1 << (b - 0xcc), &u)) return false;
+			if(u > INT64_MAX) return false;
+			*v = SI_LongVal(u);
+			return true;
+		case 0xd0:  // int8
+		case 0xd1:  // int16
+		case 0xd2:  // int32
+		case 0xd3:  // int64
+			if(!_ReadInt(reader, 1 << (b - 0xd0), &i)) return false;
+			*v = SI_LongVal(i);
+			return true;
+		default:
+			// binary, extension and reserved types
+			return false;
+	}
+}
+
+bool MsgPack_ReadValue
+(
+	MsgPackReader *reader,
+	SIValue *v
+) {
+	ASSERT(v != NULL);
+	ASSERT(reader != NULL);
+	return _ReadValue(reader, v, 0);
+}
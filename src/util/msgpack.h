@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../value.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// maximum nesting depth of decoded arrays and maps
+#define MSGPACK_MAX_DEPTH 64
+
+// reader decoding MessagePack encoded values out of a buffer
+// supported types: nil, bool, integers, floats, strings, arrays and maps
+// with string keys, binary and extension types are rejected
+// multi-byte values are big-endian, as mandated by the format
+typedef struct {
+	const unsigned char *buf;  // encoded data
+	size_t len;                // length of 'buf'
+	size_t pos;                // read position
+} MsgPackReader;
+
+// create a reader over 'buf'
+MsgPackReader MsgPack_Reader
+(
+	const char *buf,  // encoded data
+	size_t len        // length of 'buf'
+);
+
+// true if the entire buffer was consumed
+bool MsgPack_Done
+(
+	const MsgPackReader *reader
+);
+
+// reads a map header
+// returns false if the next value isn't a map
+bool MsgPack_ReadMapHeader
+(
+	MsgPackReader *reader,  // reader
+	uint32_t *n             // [output] number of key/value pairs
+);
+
+// reads a string, 's' points into the reader's buffer
+// and isn't NULL terminated
+// returns false if the next value isn't a string
+bool MsgPack_ReadString
+(
+	MsgPackReader *reader,  // reader
+	const char **s,         // [output] string
+	uint32_t *len           // [output] string length
+);
+
+// reads a value, the caller owns the returned value
+// returns false if the data is malformed or of an unsupported type
+bool MsgPack_ReadValue
+(
+	MsgPackReader *reader,  // reader
+	SIValue *v              // [output] decoded value
+);
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "name_table.h"
+#include "RG.h"
+#include "arr.h"
+#include "rmalloc.h"
+#include <string.h>
+
+// initial number of names a table can hold
+#define NAME_TABLE_INITIAL_CAP 64
+
+// open addressing hash index from names to IDs
+// kept at most half full, such that probing always reaches a vacant bucket
+typedef struct {
+	uint64_t cap;        // number of buckets, a power of two
+	const char **keys;   // name held by each bucket, NULL if vacant
+	uint *ids;           // ID of each bucket's name
+} NameIndex;
+
+struct NameTable {
+	uint count;          // number of names, published after each addition
+	uint cap;            // number of names 'names' can hold
+	char **names;        // names by ID
+	NameIndex *index;    // IDs by name
+	void **retired;      // replaced buffers, readers might still access them
+};
+
+// FNV-1a
+static uint64_t _Hash
+(
+	const char *name
+) {
+	uint64_t h = 14695981039346656037UL;
+	for(const unsigned char *c = (const unsigned char *)name; *c; c++) {
+		h ^= *c;
+		h *= 1099511628211UL;
+	}
+	return h;
+}
+
+// index and its buckets are allocated at once
+static NameIndex *_NameIndex_New
+(
+	uint64_t cap
+) {
+	ASSERT((cap & (cap - 1)) == 0);
+
+	NameIndex *idx = rm_calloc(1, sizeof(NameIndex) +
+			cap * (sizeof(const char *) + sizeof(uint)));
+
+	idx->cap  = cap;
+	idx->keys = (const char **)(idx + 1);
+	idx->ids  = (uint *)(idx->keys + cap);
+
+	return idx;
+}
+
+// places 'name' in a vacant bucket
+// the bucket's ID is set before its key is published to readers
+static void _NameIndex_Insert
+(
+	NameIndex *idx,
+	const char *name,
+	uint id
+) {
+	uint64_t mask = idx->cap - 1;
+	uint64_t i = _Hash(name) & mask;
+	while(idx->keys[i] != NULL) i = (i + 1) & mask;
+
+	idx->ids[i] = id;
+	__atomic_store_n(&idx->keys[i], name, __ATOMIC_RELEASE);
+}
+
+NameTable *NameTable_New(void) {
+	NameTable *t = rm_malloc(sizeof(NameTable));
+
+	t->count   = 0;
+	t->cap     = NAME_TABLE_INITIAL_CAP;
+	t->names   = rm_malloc(sizeof(char *) * t->cap);
+	t->index   = _NameIndex_New(NAME_TABLE_INITIAL_CAP * 2);
+	t->retired = array_new(void *, 0);
+
+	return t;
+}
+
+uint NameTable_Count
+(
+	const NameTable *t
+) {
+	ASSERT(t != NULL);
+	return __atomic_load_n(&t->count, __ATOMIC_ACQUIRE);
+}
+
+uint NameTable_Find
+(
+	const NameTable *t,
+	const char *name
+) {
+	ASSERT(t    != NULL);
+	ASSERT(name != NULL);
+
+	NameIndex *idx = __atomic_load_n(&t->index, __ATOMIC_ACQUIRE);
+	uint64_t mask = idx->cap - 1;
+
+	for(uint64_t i = _Hash(name) & mask;; i = (i + 1) & mask) {
+		const char *key = __atomic_load_n(&idx->keys[i], __ATOMIC_ACQUIRE);
+		if(key == NULL) return NAME_TABLE_NOTFOUND;
+		if(strcmp(key, name) == 0) return idx->ids[i];
+	}
+}
+
+const char *NameTable_Name
+(
+	const NameTable *t,
+	uint id
+) {
+	ASSERT(t != NULL);
+	ASSERT(id < NameTable_Count(t));
+
+	char **names = __atomic_load_n(&t->names, __ATOMIC_ACQUIRE);
+	return names[id];
+}
+
+uint NameTable_Add
+(
+	NameTable *t,
+	const char *name
+) {
+	ASSERT(t    != NULL);
+	ASSERT(name != NULL);
+	ASSERT(NameTable_Find(t, name) == NAME_TABLE_NOTFOUND);
+
+	uint id = t->count;
+
+	// grow names, the replaced buffer is published as a whole
+	if(id == t->cap) {
+		char **names = rm_malloc(sizeof(char *) * t->cap * 2);
+		memcpy(names, t->names, sizeof(char *) * t->count);
+		array_append(t->retired, t->names);
+		__atomic_store_n(&t->names, names, __ATOMIC_RELEASE);
+		t->cap *= 2;
+	}
+
+	// the slot past 'count' isn't visible to readers yet
+	char *s = rm_strdup(name);
+	t->names[id] = s;
+
+	// rehash into a larger index once half full
+	if((uint64_t)(id + 1) * 2 > t->index->cap) {
+		NameIndex *idx = _NameIndex_New(t->index->cap * 2);
+		for(uint i = 0; i < id; i++) _NameIndex_Insert(idx, t->names[i], i);
+		array_append(t->retired, t->index);
+		__atomic_store_n(&t->index, idx, __ATOMIC_RELEASE);
+	}
+
+	_NameIndex_Insert(t->index, s, id);
+	__atomic_store_n(&t->count, id + 1, __ATOMIC_RELEASE);
+
+	return id;
+}
+
+void NameTable_Free
+(
+	NameTable *t
+) {
+	ASSERT(t != NULL);
+
+	for(uint i = 0; i < t->count; i++) rm_free(t->names[i]);
+
+	uint n = array_len(t->retired);
+	for(uint i = 0; i < n; i++) rm_free(t->retired[i]);
+	array_free(t->retired);
+
+	rm_free(t->names);
+	rm_free(t->index);
+	rm_free(t);
+}
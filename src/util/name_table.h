@@ -0,0 +1,61 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// returned by NameTable_Find for names missing from the table
+#define NAME_TABLE_NOTFOUND UINT32_MAX
+
+// append-only table assigning consecutive IDs to distinct names
+// e.g. attribute names and schema labels
+//
+// lookups in either direction are wait-free and may run concurrently
+// with an addition, additions must be serialized by the caller
+// buffers replaced by a growing table are retired rather than freed
+// as readers may still access them, they're released with the table
+typedef struct NameTable NameTable;
+
+// create a new name table
+NameTable *NameTable_New(void);
+
+// number of names in table
+uint NameTable_Count
+(
+	const NameTable *t
+);
+
+// returns the ID of 'name', NAME_TABLE_NOTFOUND if missing
+uint NameTable_Find
+(
+	const NameTable *t,  // table to search
+	const char *name     // name to look up
+);
+
+// returns the name assigned to 'id'
+// the name remains valid until the table is freed
+const char *NameTable_Name
+(
+	const NameTable *t,  // table to search
+	uint id              // name ID, smaller than the table's count
+);
+
+// adds 'name' to the table, 'name' must not be in the table
+// returns the ID assigned to 'name'
+uint NameTable_Add
+(
+	NameTable *t,     // table to add to
+	const char *name  // name to add
+);
+
+// free table
+void NameTable_Free
+(
+	NameTable *t
+);
+
@@ -41,6 +41,47 @@ typedef uint64_t ObjectID;
 // Given an item header, retrieve the item data.
 #define ITEM_FROM_HEADER(header) ((header) + sizeof(ObjectID))
 
+// Maximum number of released blocks kept for reuse by each thread.
+#define BLOCK_CACHE_CAP 8
+
+// Maximum size in bytes of a block kept for reuse.
+#define BLOCK_CACHE_MAX_BLOCK_SIZE (1 << 18)
+
+/* Blocks of freed pools are kept in a thread-local cache, allowing subsequent pools
+ * to skip allocation. As the execution plans of a recurring query produce records
+ * of the same size, cached blocks commonly match the item size of new pools. */
+static __thread Block *_block_cache[BLOCK_CACHE_CAP];
+static __thread uint _block_cache_count = 0;
+
+// Retrieve a zeroed block from the thread's cache, allocate a new one on a miss.
+static Block *_ObjectPool_NewBlock(uint itemSize) {
+	for(uint i = 0; i < _block_cache_count; i++) {
+		Block *block = _block_cache[i];
+		if(block->itemSize != itemSize) continue;
+
+		_block_cache[i] = _block_cache[--_block_cache_count];
+		memset(block->data, 0, itemSize * POOL_BLOCK_CAP);
+		block->next = NULL;
+		return block;
+	}
+
+	return Block_New(itemSize, POOL_BLOCK_CAP);
+}
+
+// Keep block in the thread's cache, evicting a cached block if the cache is full.
+static void _ObjectPool_ReleaseBlock(Block *block) {
+	if(block->itemSize * POOL_BLOCK_CAP > BLOCK_CACHE_MAX_BLOCK_SIZE) {
+		Block_Free(block);
+		return;
+	}
+
+	if(_block_cache_count == BLOCK_CACHE_CAP) {
+		Block_Free(_block_cache[0]);
+		_block_cache[0] = _block_cache[--_block_cache_count];
+	}
+	_block_cache[_block_cache_count++] = block;
+}
+
 static void _ObjectPool_AddBlocks(ObjectPool *pool, uint blockCount) {
 	ASSERT(pool && blockCount > 0);
 
@@ -51,7 +92,7 @@ static void _ObjectPool_AddBlocks(ObjectPool *pool, uint blockCount) {
 
 	uint i;
 	for(i = prevBlockCount; i < pool->blockCount; i++) {
-		pool->blocks[i] = Block_New(pool->itemSize, POOL_BLOCK_CAP);
+		pool->blocks[i] = _ObjectPool_NewBlock(pool->itemSize);
 		if(i > 0) pool->blocks[i - 1]->next = pool->blocks[i];
 	}
 	pool->blocks[i - 1]->next = NULL;
@@ -130,10 +171,14 @@ void ObjectPool_DeleteItem(ObjectPool *pool, void *item) {
 }
 
 void ObjectPool_Free(ObjectPool *pool) {
-	for(uint i = 0; i < pool->blockCount; i++) Block_Free(pool->blocks[i]);
+	for(uint i = 0; i < pool->blockCount; i++) _ObjectPool_ReleaseBlock(pool->blocks[i]);
 
 	rm_free(pool->blocks);
 	array_free(pool->deletedIdx);
 	rm_free(pool);
 }
 
+void ObjectPool_FreeThreadCache(void) {
+	for(uint i = 0; i < _block_cache_count; i++) Block_Free(_block_cache[i]);
+	_block_cache_count = 0;
+}
@@ -40,6 +40,9 @@ void *ObjectPool_NewItem(ObjectPool *pool);
 // Removes item from pool.
 void ObjectPool_DeleteItem(ObjectPool *pool, void *item);
 
-// Free pool.
+// Free pool, its blocks are kept for reuse by pools created on the same thread.
 void ObjectPool_Free(ObjectPool *pool);
 
+// Free the blocks kept for reuse by the calling thread.
+void ObjectPool_FreeThreadCache(void);
+
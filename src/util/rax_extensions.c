@@ -86,3 +86,10 @@ unsigned char **raxKeys(rax *rax) {
 	return keys;
 }
 
+size_t raxMemoryUsage(const rax *rax) {
+	// every node holds a header, at least a single character and a child
+	// pointer, key nodes additionally hold a value pointer
+	return sizeof(*rax) +
+		rax->numnodes * (sizeof(raxNode) + sizeof(raxNode *) + sizeof(void *)) +
+		rax->numele * sizeof(void *);
+}
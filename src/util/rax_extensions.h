@@ -26,3 +26,5 @@ void **raxValues(rax *rax);
 // Collect all keys in a rax into an array.
 unsigned char **raxKeys(rax *rax);
 
+// Estimates the number of bytes used by a rax, excluding its values.
+size_t raxMemoryUsage(const rax *rax);
@@ -4,8 +4,12 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
+#include "../RG.h"
 #include "rmalloc.h"
 #include "../errors.h"
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/mman.h>
 
 #ifdef REDIS_MODULE_TARGET /* Set this when compiling your code as a module */
 
@@ -19,7 +23,13 @@
 // bytes requested < bytes allocated
 static __thread int64_t n_alloced; 
 static int64_t mem_capacity;  // maximum memory consumption for thread
- 
+static __thread rm_alloc_counters counters;  // thread allocation counters
+static __thread bool counting;       // thread allocations count toward capacity
+static __thread bool exceeded;       // thread exceeded its memory capacity
+static int trackers;          // number of active allocation tracking requests
+static bool patched;          // allocator functions are patched
+static pthread_mutex_t patch_lock = PTHREAD_MUTEX_INITIALIZER;
+
 // function pointers which hold the original address of RedisModule_Alloc*
 static void (*RedisModule_Free_Orig)(void *ptr);
 static void * (*RedisModule_Alloc_Orig)(size_t bytes);
@@ -29,22 +39,32 @@ static void * (*RedisModule_Calloc_Orig)(size_t nmemb, size_t size);
 
 void rm_reset_n_alloced() {
 	n_alloced = 0;
+	exceeded = false;
+	// the thread executes queries, GraphBLAS allocations made by it are counted
+	counting = true;
+}
+
+bool rm_mem_capacity_exceeded(void) {
+	return exceeded;
 }
 
 // removes n_bytes from thread memory consumption
 static inline void _nmalloc_decrement(int64_t n_bytes) {
 	n_alloced -= n_bytes;
+	counters.freed += n_bytes;
 }
 
 // adds nbytes to thread memory consumption
 static inline void _nmalloc_increment(int64_t n_bytes) {
 	n_alloced += n_bytes;
-	// check if capacity exceeded
-	if(n_alloced > mem_capacity) {
+	counters.allocated += n_bytes;
+	// check if capacity exceeded, allocations might be tracked uncapped
+	if(mem_capacity > 0 && n_alloced > mem_capacity) {
 		// set n_alloced to MIN to avoid further out of memory exceptions
 		// TODO: consider switching to double -inf
 		n_alloced = INT64_MIN;
-		
+		exceeded = true;
+
 		// throw exception cause memory limit exceeded
 		ErrorCtx_SetError("Query's mem consumption exceeded capacity");
 	}
@@ -58,7 +78,7 @@ void *rm_alloc_with_capacity(size_t n_bytes) {
 
 void *rm_realloc_with_capacity(void *ptr, size_t n_bytes) {
 	// remove bytes of original allocation
-	_nmalloc_decrement(RedisModule_MallocSize(ptr));
+	if(ptr != NULL) _nmalloc_decrement(RedisModule_MallocSize(ptr));
 	// track new allocation size
 	_nmalloc_increment(n_bytes);
 	return RedisModule_Realloc_Orig(ptr, n_bytes);
@@ -79,20 +99,45 @@ char *rm_strdup_with_capacity(const char *str) {
 }
 
 void rm_free_with_capacity(void *ptr) {
+	if(ptr == NULL) return;
 	_nmalloc_decrement(RedisModule_MallocSize(ptr));
 	RedisModule_Free_Orig(ptr);
 }
 
-void rm_set_mem_capacity(int64_t cap) {
-	bool is_capped = (mem_capacity > 0); // current allocator applies memory cap
-	bool should_cap = (cap > 0); // should we use a memory capped allocator
-	
-	// The local enforced capacity should be set
-	// before resetting function pointers
-	// for instance if we're switching to capped allocator
-	// we want the memory cap to be set
-	mem_capacity = cap; 
-	if(should_cap && !is_capped) {
+// GraphBLAS allocations don't go through the patched allocator functions
+// they're counted on query threads while allocations are counted
+// allocations made by GraphBLAS' OpenMP workers aren't attributed to a query
+void rm_count_matrix_alloc(void *ptr) {
+	if(ptr == NULL || !patched || !counting) return;
+
+	int64_t n_bytes = RedisModule_MallocSize(ptr);
+	counters.grb_retained += n_bytes;
+	if(counters.grb_retained > counters.grb_peak) {
+		counters.grb_peak = counters.grb_retained;
+	}
+	_nmalloc_increment(n_bytes);
+}
+
+void rm_count_matrix_free(void *ptr) {
+	if(ptr == NULL || !patched || !counting) return;
+
+	int64_t n_bytes = RedisModule_MallocSize(ptr);
+	counters.grb_retained -= n_bytes;
+	_nmalloc_decrement(n_bytes);
+}
+
+void rm_set_matrix_peak(int64_t peak) {
+	counters.grb_peak = peak;
+}
+
+// patch or restore the allocator functions
+// allocations are routed through the counting allocator
+// while a memory cap is set or allocations are tracked
+// must be called with 'patch_lock' held
+static void _rm_update_allocator(void) {
+	bool should_patch = (mem_capacity > 0 || trackers > 0);
+
+	if(should_patch && !patched) {
 		// store the function pointer original values and change them
 		// to the capped version
 		RedisModule_Free_Orig     =  RedisModule_Free;
@@ -105,7 +150,7 @@ void rm_set_mem_capacity(int64_t cap) {
 		RedisModule_Calloc        =  rm_calloc_with_capacity;
 		RedisModule_Strdup        =  rm_strdup_with_capacity;
 		RedisModule_Realloc       =  rm_realloc_with_capacity;
-	} else if(!should_cap && is_capped) {
+	} else if(!should_patch && patched) {
 		// restore all function pointers to their original values
 		RedisModule_Free     =  RedisModule_Free_Orig;
 		RedisModule_Alloc    =  RedisModule_Alloc_Orig;
@@ -113,9 +158,87 @@ void rm_set_mem_capacity(int64_t cap) {
 		RedisModule_Strdup   =  RedisModule_Strdup_Orig;
 		RedisModule_Realloc  =  RedisModule_Realloc_Orig;
 	}
+
+	patched = should_patch;
 }
 
+void rm_set_mem_capacity(int64_t cap) {
+	pthread_mutex_lock(&patch_lock);
+
+	// The local enforced capacity should be set
+	// before resetting function pointers
+	// for instance if we're switching to capped allocator
+	// we want the memory cap to be set
+	mem_capacity = cap;
+	_rm_update_allocator();
+
+	pthread_mutex_unlock(&patch_lock);
+}
+
+void rm_track_allocations(bool enable) {
+	pthread_mutex_lock(&patch_lock);
+
+	trackers += enable ? 1 : -1;
+	ASSERT(trackers >= 0);
+	_rm_update_allocator();
+
+	pthread_mutex_unlock(&patch_lock);
+}
+
+void rm_get_alloc_counters(rm_alloc_counters *c) {
+	*c = counters;
+}
+
+#else
+
+// allocations are not counted outside of Redis
+void rm_track_allocations(bool enable) {
+}
+
+void rm_get_alloc_counters(rm_alloc_counters *c) {
+	c->allocated = 0;
+	c->freed = 0;
+	c->grb_retained = 0;
+	c->grb_peak = 0;
+}
+
+void rm_count_matrix_alloc(void *ptr) {
+}
+
+void rm_count_matrix_free(void *ptr) {
+}
+
+void rm_set_matrix_peak(int64_t peak) {
+}
+
+bool rm_mem_capacity_exceeded(void) {
+	return false;
+}
+
+#endif
+
+// transparent huge page size on x86-64 and aarch64 with 4KB base pages
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+static bool huge_pages = false;  // back large allocations with huge pages
+
+void rm_set_huge_pages(bool enabled) {
+	huge_pages = enabled;
+}
+
+void rm_advise_huge_pages(void *p, size_t n) {
+#ifdef MADV_HUGEPAGE
+	if(!huge_pages || p == NULL || n < HUGE_PAGE_SIZE) return;
+
+	// madvise requires page alignment, advise the huge page aligned interior
+	uintptr_t start = ((uintptr_t)p + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+	uintptr_t end = ((uintptr_t)p + n) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+	if(end <= start) return;
+
+	// best effort, THP might be disabled system wide
+	madvise((void *)start, end - start, MADV_HUGEPAGE);
 #endif
+}
 
 /* Redefine the allocator functions to use the malloc family.
  * Only to be used when running module code from a non-Redis
@@ -2,7 +2,9 @@
 #define __REDISGRAPH_ALLOC__
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <stdbool.h>
 #include "../redismodule.h"
 
 #ifdef REDIS_MODULE_TARGET /* Set this when compiling your code as a module */
@@ -18,6 +20,41 @@ void rm_set_mem_capacity(int64_t cap);
 // reset thread memory consumption counter to 0 (no memory consumed)
 void rm_reset_n_alloced();
 
+#endif
+
+// per thread allocation counters, maintained while allocation tracking is on
+typedef struct {
+	int64_t allocated;     // bytes allocated
+	int64_t freed;         // bytes freed
+	int64_t grb_retained;  // bytes currently held by GraphBLAS, included above
+	int64_t grb_peak;      // maximum of grb_retained since last reset
+} rm_alloc_counters;
+
+// enable or disable allocation tracking
+// calls are reference counted, tracking is on while any caller enabled it
+// e.g. a profiled query attributing allocations to its operations
+void rm_track_allocations(bool enable);
+
+// snapshot the calling thread allocation counters
+void rm_get_alloc_counters(rm_alloc_counters *counters);
+
+// count a GraphBLAS allocation, e.g. a matrix intermediate, toward the
+// calling thread memory consumption and capacity
+// called by the allocator functions handed to GraphBLAS
+void rm_count_matrix_alloc(void *ptr);
+
+// count the release of a GraphBLAS allocation
+void rm_count_matrix_free(void *ptr);
+
+// reset the calling thread GraphBLAS peak, e.g. to measure a single operation
+void rm_set_matrix_peak(int64_t peak);
+
+// returns true if the calling thread exceeded its memory capacity
+// since its consumption was last reset
+bool rm_mem_capacity_exceeded(void);
+
+#ifdef REDIS_MODULE_TARGET
+
 static inline void *rm_malloc(size_t n) {
 	return RedisModule_Alloc(n);
 }
@@ -57,6 +94,15 @@ static inline char *rm_strndup(const char *s, size_t n) {
 
 #define rm_new(x) rm_malloc(sizeof(x))
 
+// enable or disable backing large allocations with transparent huge pages
+void rm_set_huge_pages(bool enabled);
+
+// advise the kernel to back the huge page aligned portion of 'p'
+// with transparent huge pages, no-op unless huge pages are enabled
+// and 'n' spans at least one huge page
+// memory remains owned and accounted for by the allocator which returned 'p'
+void rm_advise_huge_pages(void *p, size_t n);
+
 /* Revert the allocator patches so that
  * the stdlib malloc functions will be used
  * for use when executing code from non-Redis
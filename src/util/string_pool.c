@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#include "string_pool.h"
+#include "RG.h"
+#include "rmalloc.h"
+#include "rax_extensions.h"
+#include <stddef.h>
+
+struct StringPool {
+	rax *strings;  // string to interned entry
+};
+
+// interned string, 'str' is the pointer handed out to SIValues
+typedef struct {
+	StringPool *pool;   // owning pool
+	uint32_t refcount;  // number of references
+	uint32_t len;       // string length
+	char str[];         // NULL terminated string
+} InternedString;
+
+#define INTERNED_STRING(s) \
+	((InternedString *)((char *)(s) - offsetof(InternedString, str)))
+
+StringPool *StringPool_New(void) {
+	StringPool *pool = rm_malloc(sizeof(StringPool));
+	pool->strings = raxNew();
+	return pool;
+}
+
+SIValue StringPool_Intern
+(
+	StringPool *pool,
+	const char *s
+) {
+	ASSERT(pool != NULL);
+	ASSERT(s    != NULL);
+
+	size_t len = strlen(s);
+	if(len > STRING_POOL_MAX_LEN) return SI_DuplicateStringVal(s);
+
+	InternedString *entry = raxFind(pool->strings, (unsigned char *)s, len);
+	if(entry == raxNotFound) {
+		entry = rm_malloc(sizeof(InternedString) + len + 1);
+		entry->pool     = pool;
+		entry->refcount = 0;
+		entry->len      = len;
+		memcpy(entry->str, s, len + 1);
+		raxInsert(pool->strings, (unsigned char *)s, len, entry, NULL);
+	}
+
+	entry->refcount++;
+
+	return (SIValue) {
+		.stringval = entry->str, .type = T_STRING, .allocation = M_INTERN
+	};
+}
+
+void StringPool_InternValue
+(
+	StringPool *pool,
+	SIValue *v
+) {
+	ASSERT(v != NULL);
+
+	if(pool == NULL) return;
+	if(SI_TYPE(*v) != T_STRING || v->allocation == M_INTERN) return;
+
+	SIValue interned = StringPool_Intern(pool, v->stringval);
+	SIValue_Free(*v);
+	*v = interned;
+}
+
+void StringPool_Retain
+(
+	const char *s
+) {
+	ASSERT(s != NULL);
+	INTERNED_STRING(s)->refcount++;
+}
+
+void StringPool_Release
+(
+	const char *s
+) {
+	ASSERT(s != NULL);
+
+	InternedString *entry = INTERNED_STRING(s);
+	ASSERT(entry->refcount > 0);
+	if(--entry->refcount > 0) return;
+
+	// last reference, evict from pool
+	raxRemove(entry->pool->strings, (unsigned char *)entry->str, entry->len,
+			NULL);
+	rm_free(entry);
+}
+
+size_t StringPool_Length
+(
+	const char *s
+) {
+	ASSERT(s != NULL);
+	return INTERNED_STRING(s)->len;
+}
+
+uint64_t StringPool_Size
+(
+	const StringPool *pool
+) {
+	ASSERT(pool != NULL);
+	return raxSize(pool->strings);
+}
+
+size_t StringPool_MemoryUsage
+(
+	const StringPool *pool
+) {
+	ASSERT(pool != NULL);
+
+	size_t size = sizeof(StringPool) + raxMemoryUsage(pool->strings);
+
+	raxIterator it;
+	raxStart(&it, pool->strings);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		const InternedString *entry = it.data;
+		size += sizeof(InternedString) + entry->len + 1;
+	}
+	raxStop(&it);
+
+	return size;
+}
+
+void StringPool_Free
+(
+	StringPool *pool
+) {
+	ASSERT(pool != NULL);
+
+	// entities are expected to release their strings before the pool is freed
+	// free whatever is left regardless
+	raxFreeWithCallback(pool->strings, rm_free);
+	rm_free(pool);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2018-2022 Redis Labs Ltd. and Contributors
+ *
+ * This file is available under the Redis Labs Source Available License Agreement
+ */
+
+#pragma once
+
+#include "../value.h"
+
+// strings longer than this are never interned
+#define STRING_POOL_MAX_LEN 64
+
+// string pool deduplicating string property values
+// each distinct string is stored once and shared by all graph entities
+// holding it as a property value, interned strings are reference counted
+// and removed from the pool once their last reference is released
+//
+// interned strings are placed in SIValues with the M_INTERN allocation type
+// the pool is owned by a single graph and must only be modified
+// by the thread holding the graph's write access
+typedef struct StringPool StringPool;
+
+// create a new string pool
+StringPool *StringPool_New(void);
+
+// returns an SIValue holding a reference to the interned copy of 's'
+// strings longer than STRING_POOL_MAX_LEN are duplicated rather than interned
+SIValue StringPool_Intern
+(
+	StringPool *pool,  // pool to intern into
+	const char *s      // string to intern
+);
+
+// replaces string value 'v' with its interned counterpart
+// freeing 'v', non string values are left untouched
+// a NULL 'pool' disables interning
+void StringPool_InternValue
+(
+	StringPool *pool,  // pool to intern into
+	SIValue *v         // value to intern
+);
+
+// acquires an additional reference to interned string 's'
+void StringPool_Retain
+(
+	const char *s  // interned string
+);
+
+// releases a reference to interned string 's'
+// removing it from its pool once no references remain
+void StringPool_Release
+(
+	const char *s  // interned string
+);
+
+// length of interned string 's', read from its header rather than scanned
+size_t StringPool_Length
+(
+	const char *s  // interned string
+);
+
+// number of distinct strings in pool
+uint64_t StringPool_Size
+(
+	const StringPool *pool
+);
+
+// number of bytes used by the pool and its interned strings
+size_t StringPool_MemoryUsage
+(
+	const StringPool *pool
+);
+
+// free pool, all interned strings must have been released
+void StringPool_Free
+(
+	StringPool *pool
+);
+
@@ -0,0 +1,191 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "RG.h"
+#include "tdigest.h"
+#include "qsort.h"
+#include <math.h>
+
+#define CENTROID_LT(a, b) ((a)->mean < (b)->mean)
+
+// scale function, maps quantile to k
+static inline double _TDigest_K
+(
+	double q
+) {
+	return TDIGEST_COMPRESSION / (2 * M_PI) * asin(2 * q - 1);
+}
+
+// inverse scale function, maps k to quantile
+static inline double _TDigest_Q
+(
+	double k
+) {
+	return (sin(k * 2 * M_PI / TDIGEST_COMPRESSION) + 1) / 2;
+}
+
+static void _TDigest_Sort
+(
+	TDigest *td
+) {
+	if(td->sorted) return;
+	QSORT(Centroid, td->centroids, td->count, CENTROID_LT);
+	td->sorted = true;
+}
+
+// sort centroids and merge neighbours while they span less than one k unit
+static void _TDigest_Compress
+(
+	TDigest *td
+) {
+	_TDigest_Sort(td);
+
+	Centroid *c = td->centroids;
+
+	uint n = 0;                    // merged centroids
+	double prefix = 0;             // weight preceding the current centroid
+	double limit = td->weight * _TDigest_Q(_TDigest_K(0) + 1);
+
+	for(uint i = 1; i < td->count; i++) {
+		double w = c[n].weight + c[i].weight;
+		if(prefix + w <= limit) {
+			// absorb centroid i into centroid n
+			c[n].mean += (c[i].mean - c[n].mean) * c[i].weight / w;
+			c[n].weight = w;
+		} else {
+			// close centroid n, the next centroid may span one more k unit
+			prefix += c[n].weight;
+			limit = td->weight * _TDigest_Q(_TDigest_K(prefix / td->weight) + 1);
+			c[++n] = c[i];
+		}
+	}
+
+	td->count = n + 1;
+}
+
+static void _TDigest_AddCentroid
+(
+	TDigest *td,
+	double mean,
+	double weight
+) {
+	if(td->count == TDIGEST_CAPACITY) _TDigest_Compress(td);
+	ASSERT(td->count < TDIGEST_CAPACITY);
+
+	if(td->weight == 0 || mean < td->min) td->min = mean;
+	if(td->weight == 0 || mean > td->max) td->max = mean;
+
+	td->centroids[td->count].mean   = mean;
+	td->centroids[td->count].weight = weight;
+	td->count++;
+	td->weight += weight;
+	td->sorted = false;
+}
+
+void TDigest_Reset
+(
+	TDigest *td
+) {
+	ASSERT(td != NULL);
+
+	td->count  = 0;
+	td->sorted = true;
+	td->weight = 0;
+	td->min    = 0;
+	td->max    = 0;
+}
+
+void TDigest_Add
+(
+	TDigest *td,
+	double v
+) {
+	ASSERT(td != NULL);
+	_TDigest_AddCentroid(td, v, 1);
+}
+
+void TDigest_Merge
+(
+	TDigest *dest,
+	const TDigest *src
+) {
+	ASSERT(dest != NULL);
+	ASSERT(src  != NULL);
+
+	if(src->weight == 0) return;
+
+	double min = src->min;
+	double max = src->max;
+	if(dest->weight > 0) {
+		min = fmin(min, dest->min);
+		max = fmax(max, dest->max);
+	}
+
+	for(uint i = 0; i < src->count; i++) {
+		_TDigest_AddCentroid(dest, src->centroids[i].mean,
+				src->centroids[i].weight);
+	}
+
+	// centroid means lie within the summarized range, restore its bounds
+	dest->min = min;
+	dest->max = max;
+}
+
+double TDigest_Weight
+(
+	const TDigest *td
+) {
+	ASSERT(td != NULL);
+	return td->weight;
+}
+
+double TDigest_Quantile
+(
+	TDigest *td,
+	double q
+) {
+	ASSERT(td != NULL);
+	ASSERT(q >= 0 && q <= 1);
+
+	if(td->weight == 0) return NAN;
+
+	_TDigest_Sort(td);
+
+	const Centroid *c = td->centroids;
+	uint n = td->count;
+	if(n == 1) return c[0].mean;
+
+	if(td->weight == n) {
+		// no centroids were merged, interpolate between the two closest values
+		double int_val;
+		double fraction = modf(q * (n - 1), &int_val);
+		uint idx = int_val;
+		if(fraction == 0) return c[idx].mean;
+		return c[idx].mean + (c[idx + 1].mean - c[idx].mean) * fraction;
+	}
+
+	// each centroid is centered at its mean, interpolate between centers
+	// the extreme values bound the tails
+	double target = q * td->weight;
+
+	double center = c[0].weight / 2;
+	if(target < center) {
+		return td->min + (c[0].mean - td->min) * target / center;
+	}
+
+	for(uint i = 1; i < n; i++) {
+		double next = center + (c[i - 1].weight + c[i].weight) / 2;
+		if(target < next) {
+			double t = (target - center) / (next - center);
+			return c[i - 1].mean + (c[i].mean - c[i - 1].mean) * t;
+		}
+		center = next;
+	}
+
+	double tail = td->weight - center;
+	if(tail <= 0) return td->max;
+	return c[n - 1].mean + (td->max - c[n - 1].mean) * (target - center) / tail;
+}
@@ -0,0 +1,75 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+// merging t-digest quantile estimator
+// values are summarized by weighted centroids, centroids near the tails
+// are kept small such that extreme quantiles are estimated accurately
+//
+// added values are appended as unit centroids, once the centroid array fills
+// up it is sorted and adjacent centroids are merged as long as they span
+// less than one unit of the scale function
+// k(q) = TDIGEST_COMPRESSION / (2 * pi) * asin(2q - 1)
+// which bounds the number of merged centroids by TDIGEST_COMPRESSION
+//
+// while no centroids were merged quantiles are computed exactly
+// memory is fixed at TDIGEST_CAPACITY centroids
+// digests are merged by adding one digest's centroids to the other
+#define TDIGEST_COMPRESSION 100
+#define TDIGEST_CAPACITY (TDIGEST_COMPRESSION * 6)
+
+typedef struct {
+	double mean;    // mean of summarized values
+	double weight;  // number of summarized values
+} Centroid;
+
+typedef struct {
+	uint count;                             // number of centroids
+	bool sorted;                            // centroids are sorted by mean
+	double weight;                          // number of summarized values
+	double min;                             // smallest value
+	double max;                             // largest value
+	Centroid centroids[TDIGEST_CAPACITY];  // centroids
+} TDigest;
+
+// clear digest
+void TDigest_Reset
+(
+	TDigest *td
+);
+
+// add a value
+void TDigest_Add
+(
+	TDigest *td,
+	double v
+);
+
+// merge 'src' into 'dest'
+void TDigest_Merge
+(
+	TDigest *dest,
+	const TDigest *src
+);
+
+// number of summarized values
+double TDigest_Weight
+(
+	const TDigest *td
+);
+
+// estimate the value below which 'q' of the values fall
+// NAN is returned for an empty digest
+double TDigest_Quantile
+(
+	TDigest *td,
+	double q  // [0-1]
+);
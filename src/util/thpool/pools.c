@@ -4,6 +4,8 @@
 * This file is available under the Redis Labs Source Available License Agreement
 */
 
+#include <sched.h>
+#include <unistd.h>
 #include <pthread.h>
 #include "RG.h"
 #include "pools.h"
@@ -15,6 +17,66 @@
 
 static threadpool _readers_thpool = NULL;  // readers
 static threadpool _writers_thpool = NULL;  // writers
+static threadpool _heavy_thpool   = NULL;  // expensive read-only queries
+
+//------------------------------------------------------------------------------
+// CPU affinity
+//------------------------------------------------------------------------------
+
+static uint64_t _reader_affinity = CPU_AFFINITY_DISABLED;  // readers and heavy
+static uint64_t _writer_affinity = CPU_AFFINITY_DISABLED;  // writers
+static uint64_t _omp_affinity    = CPU_AFFINITY_DISABLED;  // OpenMP workers
+static int _omp_thread_count     = 1;  // OpenMP workers spawned by each thread
+
+// pins calling thread to the CPUs set in 'mask'
+static void _SetAffinity
+(
+	uint64_t mask
+) {
+#if defined(__linux__)
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	for(int cpu = 0; cpu < 64; cpu++) {
+		if(mask & ((uint64_t)1 << cpu)) CPU_SET(cpu, &cpus);
+	}
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+#else
+	UNUSED(mask);
+#endif
+}
+
+// invoked by each pool thread as it starts
+// OpenMP workers inherit the affinity of the thread spawning them and are
+// reused by its subsequent parallel regions, as such the thread spawns its
+// workers while pinned to the OpenMP CPUs and only then pins itself
+static void _PinThread
+(
+	uint64_t mask
+) {
+#if defined(__linux__)
+	cpu_set_t original;
+	pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &original);
+
+	if(_omp_affinity != CPU_AFFINITY_DISABLED) {
+		_SetAffinity(_omp_affinity);
+		#pragma omp parallel num_threads(_omp_thread_count)
+		{ }
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &original);
+	}
+
+	if(mask != CPU_AFFINITY_DISABLED) _SetAffinity(mask);
+#else
+	UNUSED(mask);
+#endif
+}
+
+static void _ReaderStart(void) {
+	_PinThread(_reader_affinity);
+}
+
+static void _WriterStart(void) {
+	_PinThread(_writer_affinity);
+}
 
 int ThreadPools_Init
 (
@@ -33,42 +95,75 @@ int ThreadPools_Init
 	config_read = Config_Option_get(Config_MAX_QUEUED_QUERIES, &max_queue_size);
 	ASSERT(config_read == true);
 
-	return ThreadPools_CreatePools(reader_count, writer_count, max_queue_size);
+	config_read = Config_Option_get(Config_READER_AFFINITY, &_reader_affinity);
+	ASSERT(config_read == true);
+
+	config_read = Config_Option_get(Config_WRITER_AFFINITY, &_writer_affinity);
+	ASSERT(config_read == true);
+
+	config_read = Config_Option_get(Config_OMP_AFFINITY, &_omp_affinity);
+	ASSERT(config_read == true);
+
+	config_read = Config_Option_get(Config_OPENMP_NTHREAD, &_omp_thread_count);
+	ASSERT(config_read == true);
+
+	// readers may grow up to the number of cores at runtime
+	int cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+	int max_reader_count = (cpu_count > reader_count) ? cpu_count : reader_count;
+
+	// expensive queries are confined to a quarter of the readers
+	int heavy_count = reader_count / 4;
+	if(heavy_count < 1) heavy_count = 1;
+
+	return ThreadPools_CreatePools(reader_count, max_reader_count,
+			writer_count, heavy_count, max_queue_size);
 }
 
-// set up thread pools  (readers and writers)
+// set up thread pools  (readers, writers and heavy)
 // returns 1 if thread pools initialized, 0 otherwise
 int ThreadPools_CreatePools
 (
 	uint reader_count,
+	uint max_reader_count,
 	uint writer_count,
+	uint heavy_count,
 	uint64_t max_pending_work
 ) {
 	ASSERT(_readers_thpool == NULL);
 	ASSERT(_writers_thpool == NULL);
+	ASSERT(_heavy_thpool   == NULL);
 
-	_readers_thpool = thpool_init(reader_count, "reader");
+	_readers_thpool = thpool_init(reader_count, max_reader_count, "reader",
+			_ReaderStart);
 	if(_readers_thpool == NULL) return 0;
 
-	_writers_thpool = thpool_init(writer_count, "writer");
+	_writers_thpool = thpool_init(writer_count, writer_count, "writer",
+			_WriterStart);
 	if(_writers_thpool == NULL) return 0;
 
+	_heavy_thpool = thpool_init(heavy_count, heavy_count, "heavy",
+			_ReaderStart);
+	if(_heavy_thpool == NULL) return 0;
+
 	ThreadPools_SetMaxPendingWork(max_pending_work);
 
 	return 1;
 }
 
-// return number of threads in both the readers and writers pools
+// return number of thread ids across all pools
+// readers are accounted for at their max capacity
 uint ThreadPools_ThreadCount
 (
 	void
 ) {
 	ASSERT(_readers_thpool != NULL);
 	ASSERT(_writers_thpool != NULL);
+	ASSERT(_heavy_thpool   != NULL);
 
 	uint count = 0;
-	count += thpool_num_threads(_readers_thpool);
-	count += thpool_num_threads(_writers_thpool);
+	count += thpool_max_threads(_readers_thpool);
+	count += thpool_max_threads(_writers_thpool);
+	count += thpool_max_threads(_heavy_thpool);
 
 	return count;
 }
@@ -81,22 +176,62 @@ uint ThreadPools_ReadersCount
 	return thpool_num_threads(_readers_thpool);
 }
 
+uint ThreadPools_ReadersCapacity
+(
+	void
+) {
+	if(_readers_thpool == NULL) return 0;
+	return thpool_max_threads(_readers_thpool);
+}
+
+bool ThreadPools_SetReadersCount
+(
+	uint count
+) {
+	// pools are yet to be created, Config_Init
+	if(_readers_thpool == NULL) return true;
+
+	return thpool_resize(_readers_thpool, count) == 0;
+}
+
+uint ThreadPools_BusyCount
+(
+	void
+) {
+	ASSERT(_readers_thpool != NULL);
+	ASSERT(_writers_thpool != NULL);
+	ASSERT(_heavy_thpool   != NULL);
+
+	return thpool_num_threads_working(_readers_thpool) +
+		   thpool_num_threads_working(_writers_thpool) +
+		   thpool_num_threads_working(_heavy_thpool);
+}
+
 // retrieve current thread id
-// 0         redis-main
-// 1..N + 1  readers
-// N + 2..   writers
+// ids are stable as the readers pool is resized, N is its capacity
+// 0             redis-main
+// 1..N + 1      readers
+// N + 2..N + M  writers
+// N + M + 1..   heavy
 int ThreadPools_GetThreadID
 (
 	void
 ) {
 	ASSERT(_readers_thpool != NULL);
 	ASSERT(_writers_thpool != NULL);
+	ASSERT(_heavy_thpool   != NULL);
 
 	// thpool_get_thread_id returns -1 if pthread_self isn't in the thread pool
 	// most likely Redis main thread
 	int thread_id;
 	pthread_t pthread = pthread_self();
-	int readers_count = thpool_num_threads(_readers_thpool);
+	int readers_count = thpool_max_threads(_readers_thpool);
+	int writers_count = thpool_max_threads(_writers_thpool);
+
+	// search in heavy
+	thread_id = thpool_get_thread_id(_heavy_thpool, pthread);
+	// compensate for Redis main thread
+	if(thread_id != -1) return readers_count + writers_count + thread_id + 1;
 
 	// search in writers
 	thread_id = thpool_get_thread_id(_writers_thpool, pthread);
@@ -118,9 +253,11 @@ void ThreadPools_Pause
 ) {
 	ASSERT(_readers_thpool != NULL);
 	ASSERT(_writers_thpool != NULL);
+	ASSERT(_heavy_thpool   != NULL);
 
 	thpool_pause(_readers_thpool);
 	thpool_pause(_writers_thpool);
+	thpool_pause(_heavy_thpool);
 }
 
 void ThreadPools_Resume
@@ -130,23 +267,27 @@ void ThreadPools_Resume
 
 	ASSERT(_readers_thpool != NULL);
 	ASSERT(_writers_thpool != NULL);
+	ASSERT(_heavy_thpool   != NULL);
 
 	thpool_resume(_readers_thpool);
 	thpool_resume(_writers_thpool);
+	thpool_resume(_heavy_thpool);
 }
 
 // add task for reader thread
 int ThreadPools_AddWorkReader
 (
 	void (*function_p)(void *),
-	void *arg_p
+	void *arg_p,
+	const void *group
 ) {
 	ASSERT(_readers_thpool != NULL);
 
 	// make sure there's enough room in thread pool queue
 	if(thpool_queue_full(_readers_thpool)) return THPOOL_QUEUE_FULL;
 
-	return thpool_add_work(_readers_thpool, function_p, arg_p);
+	// all groups get an equal share of the readers
+	return thpool_add_group_work(_readers_thpool, group, 1, function_p, arg_p);
 }
 
 // add task for writer thread
@@ -163,9 +304,39 @@ int ThreadPools_AddWorkWriter
 	return thpool_add_work(_writers_thpool, function_p, arg_p);
 }
 
+// add task for heavy thread
+int ThreadPools_AddWorkHeavy
+(
+	void (*function_p)(void *),
+	void *arg_p
+) {
+	ASSERT(_heavy_thpool != NULL);
+
+	// make sure there's enough room in thread pool queue
+	if(thpool_queue_full(_heavy_thpool)) return THPOOL_QUEUE_FULL;
+
+	return thpool_add_work(_heavy_thpool, function_p, arg_p);
+}
+
 void ThreadPools_SetMaxPendingWork(uint64_t val) {
 	if(_readers_thpool != NULL) thpool_set_jobqueue_cap(_readers_thpool, val);
 	if(_writers_thpool != NULL) thpool_set_jobqueue_cap(_writers_thpool, val);
+	if(_heavy_thpool   != NULL) thpool_set_jobqueue_cap(_heavy_thpool, val);
+}
+
+void ThreadPools_GetStats
+(
+	thpool_stats *readers,
+	thpool_stats *writers,
+	thpool_stats *heavy
+) {
+	ASSERT(_readers_thpool != NULL);
+	ASSERT(_writers_thpool != NULL);
+	ASSERT(_heavy_thpool   != NULL);
+
+	if(readers != NULL) thpool_get_stats(_readers_thpool, readers);
+	if(writers != NULL) thpool_get_stats(_writers_thpool, writers);
+	if(heavy   != NULL) thpool_get_stats(_heavy_thpool, heavy);
 }
 
 void ThreadPools_Destroy
@@ -174,7 +345,9 @@ void ThreadPools_Destroy
 ) {
 	ASSERT(_readers_thpool != NULL);
 	ASSERT(_writers_thpool != NULL);
+	ASSERT(_heavy_thpool   != NULL);
 
 	thpool_destroy(_readers_thpool);
 	thpool_destroy(_writers_thpool);
+	thpool_destroy(_heavy_thpool);
 }
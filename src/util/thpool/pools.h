@@ -16,15 +16,19 @@ int ThreadPools_Init
 	void
 );
 
-// create both readers and writers thread pools
+// create readers, writers and heavy thread pools
+// the readers pool may be resized up to 'max_reader_count' threads
 int ThreadPools_CreatePools
 (
 	uint reader_count,
+	uint max_reader_count,
 	uint writer_count,
+	uint heavy_count,
 	uint64_t max_pending_work
 );
 
-// return number of threads in both the readers and writers pools
+// return number of thread ids across all pools
+// thread ids are smaller than this number plus one, for Redis main thread
 uint ThreadPools_ThreadCount
 (
 	void
@@ -36,10 +40,34 @@ uint ThreadPools_ReadersCount
 	void
 );
 
+// return the number of threads READERS thread-pool may grow to
+// 0 if pools are yet to be created
+uint ThreadPools_ReadersCapacity
+(
+	void
+);
+
+// resize READERS thread-pool to 'count' threads
+// surplus threads exit once they complete their current task
+// returns false if 'count' exceeds the pool's capacity
+bool ThreadPools_SetReadersCount
+(
+	uint count
+);
+
+// return number of threads currently executing a task, across all pools
+// the figure is approximate as it is read without synchronization
+uint ThreadPools_BusyCount
+(
+	void
+);
+
 // retrieve current thread id
-// 0         redis-main
-// 1..N + 1  readers
-// N + 2..   writers
+// N is the capacity of the readers pool
+// 0             redis-main
+// 1..N + 1      readers
+// N + 2..N + M  writers
+// N + M + 1..   heavy
 int ThreadPools_GetThreadID
 (
 	void
@@ -57,11 +85,14 @@ void ThreadPools_Resume
 	void
 );
 
-// adds a read task
+// adds a read task on behalf of 'group'
+// groups, e.g. graphs, are served in round-robin order
+// such that a single busy group can't starve the others
 int ThreadPools_AddWorkReader
 (
 	void (*function_p)(void *),
-	void *arg_p
+	void *arg_p,
+	const void *group
 );
 
 // add a write task
@@ -71,12 +102,28 @@ int ThreadPools_AddWorkWriter
 	void *arg_p
 );
 
+// add a task to the bounded pool serving expensive read-only queries
+// such that they can't occupy all of the readers
+int ThreadPools_AddWorkHeavy
+(
+	void (*function_p)(void *),
+	void *arg_p
+);
+
 // sets the limit on max queued queries in each thread pool
 void ThreadPools_SetMaxPendingWork
 (
 	uint64_t val
 );
 
+// retrieve readers, writers and heavy queue statistics
+void ThreadPools_GetStats
+(
+	thpool_stats *readers,
+	thpool_stats *writers,
+	thpool_stats *heavy
+);
+
 // destroies all threadpools, allows threads to exit gracefully
 void ThreadPools_Destroy
 (
@@ -23,6 +23,7 @@
 #endif
 
 #include "thpool.h"
+#include "../histogram.h"
 
 #ifdef THPOOL_DEBUG
 #define THPOOL_DEBUG 1
@@ -41,71 +42,88 @@ static volatile int threads_on_hold;
 
 /* ========================== STRUCTURES ============================ */
 
-/* Binary semaphore */
-typedef struct bsem {
-	pthread_mutex_t mutex;
-	pthread_cond_t cond;
-	int v;
-} bsem;
-
 /* Job */
 typedef struct job {
 	struct job *prev;            /* pointer to previous job   */
 	void (*function)(void *arg); /* function pointer          */
 	void *arg;                   /* function's argument       */
+	struct timespec queued_at;   /* time job was added        */
 } job;
 
-/* Job queue */
+/* Group of jobs issued on behalf of the same tenant */
+typedef struct jobgroup {
+	struct jobgroup *next;       /* next group in round-robin */
+	const void *key;             /* group identifier          */
+	job *front;                  /* pointer to front of group */
+	job *rear;                   /* pointer to rear  of group */
+	uint weight;                 /* jobs served per round     */
+	uint served;                 /* jobs served this round    */
+} jobgroup;
+
+/* Job queue, owned by a single thread
+ *
+ * active groups form a ring served in weighted round-robin,
+ * 'current' is the group being served and 'last' precedes it */
 typedef struct jobqueue {
 	pthread_mutex_t rwmutex; 		/* used for queue r/w access */
-	job *front;              		/* pointer to front of queue */
-	job *rear;               		/* pointer to rear  of queue */
-	bsem *has_jobs;          		/* flag as binary semaphore  */
-	int len;                 		/* number of jobs in queue   */
-	uint64_t cap;                   /* capacity of the queue     */
+	jobgroup *current;       		/* group currently served    */
+	jobgroup *last;          		/* group preceding current   */
+	jobgroup *spare;         		/* recycled groups           */
+	volatile int len;        		/* number of jobs in queue   */
 } jobqueue;
 
 /* Thread */
 typedef struct thread {
 	int id;                   /* friendly id               */
 	pthread_t pthread;        /* pointer to actual thread  */
+	volatile int active;      /* slot is served by thread  */
 	struct thpool_ *thpool_p; /* access to thpool          */
 } thread;
 
 /* Threadpool */
 typedef struct thpool_ {
-	thread **threads;                 /* pointer to threads        */
+	thread **threads;                 /* thread slots, max_threads */
 	const char *name;                 /* name associated with pool */
+	void (*on_start)(void);           /* run by each new thread    */
+	int max_threads;                  /* number of thread slots    */
+	volatile int num_threads_target;  /* threads the pool resizes to */
 	volatile int num_threads_alive;   /* threads currently alive   */
 	volatile int num_threads_working; /* threads currently working */
+	volatile int num_threads_idle;    /* threads waiting for jobs  */
 	pthread_mutex_t thcount_lock;     /* used for thread count etc */
 	pthread_cond_t threads_all_idle;  /* signal to thpool_wait     */
-	jobqueue jobqueue;                /* job queue                 */
+	pthread_mutex_t idle_lock;        /* guards has_jobs           */
+	pthread_cond_t has_jobs;          /* signal to idle threads    */
+	jobqueue *jobqueues;              /* job queue per thread      */
+	int num_queues;                   /* number of job queues      */
+	volatile uint64_t len;            /* number of jobs pending    */
+	uint64_t cap;                     /* capacity of the queues    */
+	thpool_stats stats;               /* queue statistics          */
+	Histogram wait_time;              /* time jobs spent pending   */
 } thpool_;
 
 /* ========================== PROTOTYPES ============================ */
 
-static int thread_init(thpool_* thpool_p, struct thread **thread_p, int id);
+static int thread_init(thpool_* thpool_p, int id);
 static void *thread_do(struct thread *thread_p);
 static void thread_hold(int sig_id);
 static void thread_destroy(struct thread *thread_p);
 
-static int jobqueue_init(jobqueue *jobqueue_p);
+static void jobqueue_init(jobqueue *jobqueue_p);
 static void jobqueue_clear(jobqueue *jobqueue_p);
-static void jobqueue_push(jobqueue *jobqueue_p, struct job *newjob_p);
+static void jobqueue_push(jobqueue *jobqueue_p, const void *key, uint weight, struct job *newjob_p);
 static struct job *jobqueue_pull(jobqueue *jobqueue_p);
 static void jobqueue_destroy(jobqueue *jobqueue_p);
 
-static void bsem_init(struct bsem *bsem_p, int value);
-static void bsem_reset(struct bsem *bsem_p);
-static void bsem_post(struct bsem *bsem_p);
-static void bsem_post_all(struct bsem *bsem_p);
-static void bsem_wait(struct bsem *bsem_p);
+static jobqueue *thpool_group_queue(thpool_* thpool_p, const void *key);
+static struct job *thpool_pull(thpool_* thpool_p, int id);
+static void thpool_wait_for_jobs(thpool_* thpool_p, int id);
 
 /* ========================== THREADPOOL ============================ */
 
 /* Initialise thread pool */
-struct thpool_ *thpool_init(int num_threads, const char *name) {
+struct thpool_ *thpool_init(int num_threads, int max_threads, const char *name,
+		void (*on_start)(void)) {
 
 	threads_on_hold = 0;
 	threads_keepalive = 1;
@@ -113,46 +131,66 @@ struct thpool_ *thpool_init(int num_threads, const char *name) {
 	if(num_threads < 0) {
 		num_threads = 0;
 	}
+	if(max_threads < num_threads) {
+		max_threads = num_threads;
+	}
 
 	/* Make new thread pool */
 	thpool_* thpool_p;
-	thpool_p = (struct thpool_ *)malloc(sizeof(struct thpool_));
+	thpool_p = (struct thpool_ *)calloc(1, sizeof(struct thpool_));
 	if(thpool_p == NULL) {
 		err("thpool_init(): Could not allocate memory for thread pool\n");
 		return NULL;
 	}
 	if(name == NULL) {
 		err("thpool_init(): missing thread pool name\n");
+		free(thpool_p);
 		return NULL;
 	}
 
 	thpool_p->name = name;
+	thpool_p->on_start = on_start;
+	thpool_p->max_threads = max_threads;
+	thpool_p->num_threads_target = num_threads;
 	thpool_p->num_threads_alive = 0;
 	thpool_p->num_threads_working = 0;
-
-	/* Initialise the job queue */
-	if(jobqueue_init(&thpool_p->jobqueue) == -1) {
+	thpool_p->num_threads_idle = 0;
+	thpool_p->len = 0;
+	thpool_p->cap = UINT64_MAX; // unlimited queue size
+
+	/* Initialise the job queues, one per thread slot */
+	thpool_p->num_queues = (max_threads > 0) ? max_threads : 1;
+	thpool_p->jobqueues = (jobqueue *)malloc(thpool_p->num_queues * sizeof(jobqueue));
+	if(thpool_p->jobqueues == NULL) {
 		err("thpool_init(): Could not allocate memory for job queue\n");
 		free(thpool_p);
 		return NULL;
 	}
+	for(int n = 0; n < thpool_p->num_queues; n++) {
+		jobqueue_init(&thpool_p->jobqueues[n]);
+	}
 
 	/* Make threads in pool */
-	thpool_p->threads = (struct thread **)malloc(num_threads * sizeof(struct thread *));
+	thpool_p->threads = (struct thread **)calloc(thpool_p->num_queues, sizeof(struct thread *));
 	if(thpool_p->threads == NULL) {
 		err("thpool_init(): Could not allocate memory for threads\n");
-		jobqueue_destroy(&thpool_p->jobqueue);
+		for(int n = 0; n < thpool_p->num_queues; n++) {
+			jobqueue_destroy(&thpool_p->jobqueues[n]);
+		}
+		free(thpool_p->jobqueues);
 		free(thpool_p);
 		return NULL;
 	}
 
 	pthread_mutex_init(&(thpool_p->thcount_lock), NULL);
 	pthread_cond_init(&thpool_p->threads_all_idle, NULL);
+	pthread_mutex_init(&(thpool_p->idle_lock), NULL);
+	pthread_cond_init(&thpool_p->has_jobs, NULL);
 
 	/* Thread init */
 	int n;
 	for(n = 0; n < num_threads; n++) {
-		thread_init(thpool_p, &thpool_p->threads[n], n);
+		thread_init(thpool_p, n);
 #if THPOOL_DEBUG
 		printf("THPOOL_DEBUG: Created thread %d in pool \n", n);
 #endif
@@ -167,6 +205,12 @@ struct thpool_ *thpool_init(int num_threads, const char *name) {
 
 /* Add work to the thread pool */
 int thpool_add_work(thpool_* thpool_p, void (*function_p)(void *), void *arg_p) {
+	return thpool_add_group_work(thpool_p, NULL, 1, function_p, arg_p);
+}
+
+/* Add work on behalf of a group to the thread pool */
+int thpool_add_group_work(thpool_* thpool_p, const void *group, uint weight,
+		void (*function_p)(void *), void *arg_p) {
 	job *newjob;
 
 	newjob = (struct job *)malloc(sizeof(struct job));
@@ -178,9 +222,48 @@ int thpool_add_work(thpool_* thpool_p, void (*function_p)(void *), void *arg_p)
 	/* add function and argument */
 	newjob->function = function_p;
 	newjob->arg = arg_p;
+	clock_gettime(CLOCK_MONOTONIC, &newjob->queued_at);
+
+	/* add job to the queue group is pinned to */
+	jobqueue *jobqueue_p = thpool_group_queue(thpool_p, group);
+	jobqueue_push(jobqueue_p, group, (weight > 0) ? weight : 1, newjob);
+
+	__atomic_fetch_add(&thpool_p->stats.enqueued, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&thpool_p->len, 1, __ATOMIC_SEQ_CST);
+
+	/* wake an idle thread, if there's one */
+	if(__atomic_load_n(&thpool_p->num_threads_idle, __ATOMIC_SEQ_CST) > 0) {
+		pthread_mutex_lock(&thpool_p->idle_lock);
+		pthread_cond_signal(&thpool_p->has_jobs);
+		pthread_mutex_unlock(&thpool_p->idle_lock);
+	}
 
-	/* add job to queue */
-	jobqueue_push(&thpool_p->jobqueue, newjob);
+	return 0;
+}
+
+/* Resize the pool to 'num_threads' threads
+ *
+ * missing threads are spawned right away, surplus threads exit once
+ * they complete the job they're executing */
+int thpool_resize(thpool_* thpool_p, int num_threads) {
+	if(num_threads < 1 || num_threads > thpool_p->max_threads) return -1;
+
+	pthread_mutex_lock(&thpool_p->thcount_lock);
+
+	__atomic_store_n(&thpool_p->num_threads_target, num_threads, __ATOMIC_SEQ_CST);
+
+	/* a retiring thread which hasn't exited yet keeps its slot */
+	for(int n = 0; n < num_threads; n++) {
+		thread *thread_p = thpool_p->threads[n];
+		if(thread_p == NULL || !thread_p->active) thread_init(thpool_p, n);
+	}
+
+	pthread_mutex_unlock(&thpool_p->thcount_lock);
+
+	/* wake idle threads, surplus ones exit */
+	pthread_mutex_lock(&thpool_p->idle_lock);
+	pthread_cond_broadcast(&thpool_p->has_jobs);
+	pthread_mutex_unlock(&thpool_p->idle_lock);
 
 	return 0;
 }
@@ -188,7 +271,8 @@ int thpool_add_work(thpool_* thpool_p, void (*function_p)(void *), void *arg_p)
 /* Wait until all jobs have finished */
 void thpool_wait(thpool_* thpool_p) {
 	pthread_mutex_lock(&thpool_p->thcount_lock);
-	while(thpool_p->jobqueue.len || thpool_p->num_threads_working) {
+	while(__atomic_load_n(&thpool_p->len, __ATOMIC_SEQ_CST) ||
+		  __atomic_load_n(&thpool_p->num_threads_working, __ATOMIC_SEQ_CST)) {
 		pthread_cond_wait(&thpool_p->threads_all_idle, &thpool_p->thcount_lock);
 	}
 	pthread_mutex_unlock(&thpool_p->thcount_lock);
@@ -199,8 +283,6 @@ void thpool_destroy(thpool_* thpool_p) {
 	/* No need to destory if it's NULL */
 	if(thpool_p == NULL) return;
 
-	volatile int threads_total = thpool_p->num_threads_alive;
-
 	/* End each thread 's infinite loop */
 	threads_keepalive = 0;
 
@@ -210,7 +292,9 @@ void thpool_destroy(thpool_* thpool_p) {
 	double tpassed = 0.0;
 	time(&start);
 	while(tpassed < TIMEOUT && thpool_p->num_threads_alive) {
-		bsem_post_all(thpool_p->jobqueue.has_jobs);
+		pthread_mutex_lock(&thpool_p->idle_lock);
+		pthread_cond_broadcast(&thpool_p->has_jobs);
+		pthread_mutex_unlock(&thpool_p->idle_lock);
 		time(&end);
 		tpassed = difftime(end, start);
 	}
@@ -218,16 +302,19 @@ void thpool_destroy(thpool_* thpool_p) {
 	/* Poll remaining threads */
 	// do not wait forever for threads to complete their work
 	//while(thpool_p->num_threads_alive) {
-	//	bsem_post_all(thpool_p->jobqueue.has_jobs);
+	//	pthread_cond_broadcast(&thpool_p->has_jobs);
 	//	sleep(1);
 	//}
 
 	/* Job queue cleanup */
-	jobqueue_destroy(&thpool_p->jobqueue);
+	for(int n = 0; n < thpool_p->num_queues; n++) {
+		jobqueue_destroy(&thpool_p->jobqueues[n]);
+	}
+	free(thpool_p->jobqueues);
 	/* Deallocs */
 	int n;
-	for(n = 0; n < threads_total; n++) {
-		thread_destroy(thpool_p->threads[n]);
+	for(n = 0; n < thpool_p->max_threads; n++) {
+		if(thpool_p->threads[n] != NULL) thread_destroy(thpool_p->threads[n]);
 	}
 	free(thpool_p->threads);
 	free(thpool_p);
@@ -238,10 +325,12 @@ void thpool_pause(thpool_* thpool_p) {
 	int n;
 	pthread_t caller = pthread_self();
 
-	for(n = 0; n < thpool_p->num_threads_alive; n++) {
+	for(n = 0; n < thpool_p->max_threads; n++) {
+		thread *thread_p = thpool_p->threads[n];
+		if(thread_p == NULL || !thread_p->active) continue;
 		// do not pause caller
-		if(thpool_p->threads[n]->pthread != caller) {
-			pthread_kill(thpool_p->threads[n]->pthread, SIGUSR2);
+		if(thread_p->pthread != caller) {
+			pthread_kill(thread_p->pthread, SIGUSR2);
 		}
 	}
 }
@@ -264,9 +353,14 @@ int thpool_num_threads(thpool_* thpool_p) {
 	return thpool_p->num_threads_alive;
 }
 
+int thpool_max_threads(thpool_* thpool_p) {
+	return thpool_p->max_threads;
+}
+
 int thpool_get_thread_id(thpool_* thpool_p, pthread_t pthread) {
-	for(int i = 0; i < thpool_p->num_threads_alive; i++) {
+	for(int i = 0; i < thpool_p->max_threads; i++) {
 		thread *thread = thpool_p->threads[i];
+		if(thread == NULL || !thread->active) continue;
 		if(thread->pthread == pthread) return thread->id;
 	}
 
@@ -279,38 +373,154 @@ bool thpool_queue_full(thpool_* thpool_p) {
 	ASSERT(thpool_p != NULL);
 
 	// test if there's enough room in thread pool queue
-	return (thpool_p->jobqueue.len >= thpool_p->jobqueue.cap);
+	return (__atomic_load_n(&thpool_p->len, __ATOMIC_RELAXED) >= thpool_p->cap);
 }
 
 void thpool_set_jobqueue_cap(thpool_* thpool_p, uint64_t val) {
 	ASSERT(thpool_p);
-	thpool_p->jobqueue.cap = val;
+	thpool_p->cap = val;
+}
+
+void thpool_get_stats(thpool_* thpool_p, thpool_stats *stats) {
+	ASSERT(thpool_p != NULL);
+	ASSERT(stats != NULL);
+
+	stats->queued             = __atomic_load_n(&thpool_p->len, __ATOMIC_RELAXED);
+	stats->enqueued           = __atomic_load_n(&thpool_p->stats.enqueued, __ATOMIC_RELAXED);
+	stats->dequeued           = __atomic_load_n(&thpool_p->stats.dequeued, __ATOMIC_RELAXED);
+	stats->stolen             = __atomic_load_n(&thpool_p->stats.stolen, __ATOMIC_RELAXED);
+	stats->wait_time_total_us = __atomic_load_n(&thpool_p->stats.wait_time_total_us, __ATOMIC_RELAXED);
+	stats->wait_time_max_us   = __atomic_load_n(&thpool_p->stats.wait_time_max_us, __ATOMIC_RELAXED);
+	stats->wait_time_p50_us   = Histogram_Percentile(&thpool_p->wait_time, 50);
+	stats->wait_time_p99_us   = Histogram_Percentile(&thpool_p->wait_time, 99);
+	stats->working            = __atomic_load_n(&thpool_p->num_threads_working, __ATOMIC_RELAXED);
+}
+
+/* Maps group to the queue it is pinned to */
+static jobqueue *thpool_group_queue(thpool_* thpool_p, const void *key) {
+	// mix pointer bits, allocations are aligned
+	uint64_t h = (uint64_t)(uintptr_t)key;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return &thpool_p->jobqueues[h % thpool_p->num_queues];
+}
+
+/* Record time job spent pending */
+static void thpool_record_wait(thpool_* thpool_p, const job *job_p) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	int64_t waited = (now.tv_sec - job_p->queued_at.tv_sec) * 1000000 +
+		(now.tv_nsec - job_p->queued_at.tv_nsec) / 1000;
+	uint64_t us = (waited > 0) ? waited : 0;
+
+	__atomic_fetch_add(&thpool_p->stats.wait_time_total_us, us, __ATOMIC_RELAXED);
+	Histogram_Record(&thpool_p->wait_time, us);
+	uint64_t max = __atomic_load_n(&thpool_p->stats.wait_time_max_us, __ATOMIC_RELAXED);
+	while(us > max && !__atomic_compare_exchange_n(&thpool_p->stats.wait_time_max_us,
+				&max, us, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+	}
+}
+
+/* Get next job, first from the thread's own queue then steal from others
+ *
+ * @param id            friendly id of the pulling thread
+ * @return job or NULL if all queues are empty
+ */
+static struct job *thpool_pull(thpool_* thpool_p, int id) {
+	int n = thpool_p->num_queues;
+	for(int i = 0; i < n; i++) {
+		jobqueue *jobqueue_p = &thpool_p->jobqueues[(id + i) % n];
+		// skip empty queues without contending on their lock
+		if(__atomic_load_n(&jobqueue_p->len, __ATOMIC_SEQ_CST) == 0) continue;
+
+		job *job_p = jobqueue_pull(jobqueue_p);
+		if(job_p == NULL) continue;
+
+		__atomic_fetch_sub(&thpool_p->len, 1, __ATOMIC_SEQ_CST);
+		__atomic_fetch_add(&thpool_p->stats.dequeued, 1, __ATOMIC_RELAXED);
+		if(i > 0) __atomic_fetch_add(&thpool_p->stats.stolen, 1, __ATOMIC_RELAXED);
+		thpool_record_wait(thpool_p, job_p);
+		return job_p;
+	}
+
+	return NULL;
+}
+
+/* Returns true if thread 'id' is beyond the pool's target size */
+static inline bool thpool_surplus(thpool_* thpool_p, int id) {
+	return id >= __atomic_load_n(&thpool_p->num_threads_target, __ATOMIC_SEQ_CST);
+}
+
+/* Blocks calling thread until there are pending jobs
+ * or the pool shrinks below the thread's id */
+static void thpool_wait_for_jobs(thpool_* thpool_p, int id) {
+	if(__atomic_load_n(&thpool_p->len, __ATOMIC_SEQ_CST) > 0) return;
+
+	pthread_mutex_lock(&thpool_p->idle_lock);
+	// announce idleness before checking for jobs, see thpool_add_group_work
+	__atomic_fetch_add(&thpool_p->num_threads_idle, 1, __ATOMIC_SEQ_CST);
+	while(threads_keepalive && !thpool_surplus(thpool_p, id) &&
+		  __atomic_load_n(&thpool_p->len, __ATOMIC_SEQ_CST) == 0) {
+		pthread_cond_wait(&thpool_p->has_jobs, &thpool_p->idle_lock);
+	}
+	__atomic_fetch_sub(&thpool_p->num_threads_idle, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&thpool_p->idle_lock);
 }
 
 /* ============================ THREAD ============================== */
 
 /* Initialize a thread in the thread pool
  *
- * @param thread        address to the pointer of the thread to be created
- * @param id            id to be given to the thread
+ * slots are allocated once and reused by the threads spawned
+ * as the pool grows back
+ *
+ * @param id            id to be given to the thread, its slot
  * @return 0 on success, -1 otherwise.
  */
-static int thread_init(thpool_* thpool_p, struct thread **thread_p, int id) {
+static int thread_init(thpool_* thpool_p, int id) {
 
-	*thread_p = (struct thread *)malloc(sizeof(struct thread));
+	thread *thread_p = thpool_p->threads[id];
 	if(thread_p == NULL) {
-		err("thread_init(): Could not allocate memory for thread\n");
-		return -1;
+		thread_p = (struct thread *)malloc(sizeof(struct thread));
+		if(thread_p == NULL) {
+			err("thread_init(): Could not allocate memory for thread\n");
+			return -1;
+		}
+		thpool_p->threads[id] = thread_p;
 	}
 
-	(*thread_p)->thpool_p = thpool_p;
-	(*thread_p)->id = id;
+	thread_p->thpool_p = thpool_p;
+	thread_p->id = id;
+	thread_p->active = 1;
 
-	pthread_create(&(*thread_p)->pthread, NULL, (void *)thread_do, (*thread_p));
-	pthread_detach((*thread_p)->pthread);
+	pthread_t pthread;
+	pthread_create(&pthread, NULL, (void *)thread_do, thread_p);
+	pthread_detach(pthread);
 	return 0;
 }
 
+/* Releases the thread's slot if the pool shrank below its id
+ *
+ * @return true if the thread should exit
+ */
+static bool thread_retire(thread *thread_p) {
+	thpool_* thpool_p = thread_p->thpool_p;
+	bool retire = false;
+
+	/* decided under lock, such that thpool_resize either
+	 * keeps this thread or spawns a replacement */
+	pthread_mutex_lock(&thpool_p->thcount_lock);
+	if(thpool_surplus(thpool_p, thread_p->id)) {
+		retire = true;
+		thread_p->active = 0;
+		thpool_p->num_threads_alive--;
+	}
+	pthread_mutex_unlock(&thpool_p->thcount_lock);
+
+	return retire;
+}
+
 /* Sets the calling thread on hold */
 static void thread_hold(int sig_id) {
 	(void)sig_id;
@@ -345,6 +555,10 @@ static void *thread_do(struct thread *thread_p) {
 
 	/* Assure all threads have been created before starting serving */
 	thpool_* thpool_p = thread_p->thpool_p;
+	thread_p->pthread = pthread_self();
+
+	/* e.g. pin thread to CPUs */
+	if(thpool_p->on_start != NULL) thpool_p->on_start();
 
 	/* Register signal handler */
 	struct sigaction act;
@@ -362,18 +576,21 @@ static void *thread_do(struct thread *thread_p) {
 
 	while(threads_keepalive) {
 
-		bsem_wait(thpool_p->jobqueue.has_jobs);
+		/* thread's slot is beyond the pool's size */
+		if(thpool_surplus(thpool_p, thread_p->id) && thread_retire(thread_p)) {
+			return NULL;
+		}
+
+		thpool_wait_for_jobs(thpool_p, thread_p->id);
 
 		if(threads_keepalive) {
 
-			pthread_mutex_lock(&thpool_p->thcount_lock);
-			thpool_p->num_threads_working++;
-			pthread_mutex_unlock(&thpool_p->thcount_lock);
+			__atomic_fetch_add(&thpool_p->num_threads_working, 1, __ATOMIC_SEQ_CST);
 
 			/* Read job from queue and execute it */
 			void (*func_buff)(void *);
 			void *arg_buff;
-			job *job_p = jobqueue_pull(&thpool_p->jobqueue);
+			job *job_p = thpool_pull(thpool_p, thread_p->id);
 			if(job_p) {
 				func_buff = job_p->function;
 				arg_buff = job_p->arg;
@@ -381,12 +598,11 @@ static void *thread_do(struct thread *thread_p) {
 				free(job_p);
 			}
 
-			pthread_mutex_lock(&thpool_p->thcount_lock);
-			thpool_p->num_threads_working--;
-			if(!thpool_p->num_threads_working) {
+			if(__atomic_sub_fetch(&thpool_p->num_threads_working, 1, __ATOMIC_SEQ_CST) == 0) {
+				pthread_mutex_lock(&thpool_p->thcount_lock);
 				pthread_cond_signal(&thpool_p->threads_all_idle);
+				pthread_mutex_unlock(&thpool_p->thcount_lock);
 			}
-			pthread_mutex_unlock(&thpool_p->thcount_lock);
 		}
 	}
 	pthread_mutex_lock(&thpool_p->thcount_lock);
@@ -404,22 +620,13 @@ static void thread_destroy(thread *thread_p) {
 /* ============================ JOB QUEUE =========================== */
 
 /* Initialize queue */
-static int jobqueue_init(jobqueue *jobqueue_p) {
+static void jobqueue_init(jobqueue *jobqueue_p) {
 	jobqueue_p->len         =  0;
-	jobqueue_p->front       =  NULL;
-	jobqueue_p->rear        =  NULL;
-
-	jobqueue_p->has_jobs = (struct bsem *)malloc(sizeof(struct bsem));
-	if(jobqueue_p->has_jobs == NULL) {
-		return -1;
-	}
+	jobqueue_p->current     =  NULL;
+	jobqueue_p->last        =  NULL;
+	jobqueue_p->spare       =  NULL;
 
 	pthread_mutex_init(&(jobqueue_p->rwmutex), NULL);
-	bsem_init(jobqueue_p->has_jobs, 0);
-
-	jobqueue_p->cap = UINT64_MAX; // unlimited queue size
-
-	return 0;
 }
 
 /* Clear the queue */
@@ -429,61 +636,109 @@ static void jobqueue_clear(jobqueue *jobqueue_p) {
 		free(jobqueue_pull(jobqueue_p));
 	}
 
-	jobqueue_p->front = NULL;
-	jobqueue_p->rear = NULL;
-	bsem_reset(jobqueue_p->has_jobs);
+	jobqueue_p->current = NULL;
+	jobqueue_p->last = NULL;
 	jobqueue_p->len = 0;
 }
 
+/* Locate active group, NULL if group has no pending jobs
+ *
+ * Notice: Caller MUST hold a mutex
+ */
+static jobgroup *jobqueue_get_group(jobqueue *jobqueue_p, const void *key) {
+	jobgroup *group_p = jobqueue_p->current;
+	if(group_p == NULL) return NULL;
+
+	do {
+		if(group_p->key == key) return group_p;
+		group_p = group_p->next;
+	} while(group_p != jobqueue_p->current);
+
+	return NULL;
+}
+
 /* Add (allocated) job to queue */
-static void jobqueue_push(jobqueue *jobqueue_p, struct job *newjob) {
+static void jobqueue_push(jobqueue *jobqueue_p, const void *key, uint weight, struct job *newjob) {
 	newjob->prev = NULL;
 
 	pthread_mutex_lock(&jobqueue_p->rwmutex);
 
-	switch(jobqueue_p->len) {
-		case 0: /* no jobs in queue */
-			jobqueue_p->front = newjob;
-			jobqueue_p->rear = newjob;
-			break;
-		default: /* jobs in queue */
-			jobqueue_p->rear->prev = newjob;
-			jobqueue_p->rear = newjob;
+	jobgroup *group_p = jobqueue_get_group(jobqueue_p, key);
+	if(group_p == NULL) {
+		/* new active group, reuse a spare one if possible */
+		group_p = jobqueue_p->spare;
+		if(group_p != NULL) {
+			jobqueue_p->spare = group_p->next;
+		} else {
+			group_p = (jobgroup *)malloc(sizeof(jobgroup));
+		}
+		group_p->key = key;
+		group_p->front = NULL;
+		group_p->rear = NULL;
+		group_p->served = 0;
+
+		/* join ring at the end of the current round */
+		if(jobqueue_p->current == NULL) {
+			group_p->next = group_p;
+			jobqueue_p->current = group_p;
+		} else {
+			group_p->next = jobqueue_p->current;
+			jobqueue_p->last->next = group_p;
+		}
+		jobqueue_p->last = group_p;
 	}
+	group_p->weight = weight;
 
-	jobqueue_p->len++;
-	bsem_post(jobqueue_p->has_jobs);
+	if(group_p->rear == NULL) { /* no jobs in group */
+		group_p->front = newjob;
+	} else {                    /* jobs in group */
+		group_p->rear->prev = newjob;
+	}
+	group_p->rear = newjob;
+
+	__atomic_fetch_add(&jobqueue_p->len, 1, __ATOMIC_SEQ_CST);
 
 	pthread_mutex_unlock(&jobqueue_p->rwmutex);
 }
 
-/* Get first job from queue(removes it from queue)
- *
- * Notice: Caller MUST hold a mutex
+/* Get next job from queue(removes it from queue)
+ * groups are visited in round-robin order, each group serving
+ * up to its weight of consecutive jobs
  */
 static struct job *jobqueue_pull(jobqueue *jobqueue_p) {
 
 	pthread_mutex_lock(&jobqueue_p->rwmutex);
-	job *job_p = jobqueue_p->front;
-
-	switch(jobqueue_p->len) {
-
-	case 0: /* if no jobs in queue */
-		break;
 
-	case 1: /* if one job in queue */
-		jobqueue_p->front = NULL;
-		jobqueue_p->rear = NULL;
-		jobqueue_p->len = 0;
-		break;
+	jobgroup *group_p = jobqueue_p->current;
+	if(group_p == NULL) { /* if no jobs in queue */
+		pthread_mutex_unlock(&jobqueue_p->rwmutex);
+		return NULL;
+	}
 
-	default: /* if >1 jobs in queue */
-		jobqueue_p->front = job_p->prev;
-		jobqueue_p->len--;
-		/* more than one job in queue -> post it */
-		bsem_post(jobqueue_p->has_jobs);
+	job *job_p = group_p->front;
+	group_p->front = job_p->prev;
+	group_p->served++;
+
+	if(group_p->front == NULL) {
+		/* group depleted, leave ring */
+		if(group_p->next == group_p) {
+			jobqueue_p->current = NULL;
+			jobqueue_p->last = NULL;
+		} else {
+			jobqueue_p->current = group_p->next;
+			jobqueue_p->last->next = group_p->next;
+		}
+		group_p->next = jobqueue_p->spare;
+		jobqueue_p->spare = group_p;
+	} else if(group_p->served >= group_p->weight) {
+		/* group consumed its share, advance round */
+		group_p->served = 0;
+		jobqueue_p->last = group_p;
+		jobqueue_p->current = group_p->next;
 	}
 
+	__atomic_fetch_sub(&jobqueue_p->len, 1, __ATOMIC_SEQ_CST);
+
 	pthread_mutex_unlock(&jobqueue_p->rwmutex);
 	return job_p;
 }
@@ -491,49 +746,12 @@ static struct job *jobqueue_pull(jobqueue *jobqueue_p) {
 /* Free all queue resources back to the system */
 static void jobqueue_destroy(jobqueue *jobqueue_p) {
 	jobqueue_clear(jobqueue_p);
-	free(jobqueue_p->has_jobs);
-}
-
-/* ======================== SYNCHRONISATION ========================= */
-
-/* Init semaphore to 1 or 0 */
-static void bsem_init(bsem *bsem_p, int value) {
-	if(value < 0 || value > 1) {
-		err("bsem_init(): Binary semaphore can take only values 1 or 0");
-		exit(1);
-	}
-	pthread_mutex_init(&(bsem_p->mutex), NULL);
-	pthread_cond_init(&(bsem_p->cond), NULL);
-	bsem_p->v = value;
-}
-
-/* Reset semaphore to 0 */
-static void bsem_reset(bsem *bsem_p) {
-	bsem_init(bsem_p, 0);
-}
-
-/* Post to at least one thread */
-static void bsem_post(bsem *bsem_p) {
-	pthread_mutex_lock(&bsem_p->mutex);
-	bsem_p->v = 1;
-	pthread_cond_signal(&bsem_p->cond);
-	pthread_mutex_unlock(&bsem_p->mutex);
-}
-
-/* Post to all threads */
-static void bsem_post_all(bsem *bsem_p) {
-	pthread_mutex_lock(&bsem_p->mutex);
-	bsem_p->v = 1;
-	pthread_cond_broadcast(&bsem_p->cond);
-	pthread_mutex_unlock(&bsem_p->mutex);
-}
 
-/* Wait on semaphore until semaphore has value 0 */
-static void bsem_wait(bsem *bsem_p) {
-	pthread_mutex_lock(&bsem_p->mutex);
-	while(bsem_p->v != 1) {
-		pthread_cond_wait(&bsem_p->cond, &bsem_p->mutex);
+	jobgroup *group_p = jobqueue_p->spare;
+	while(group_p != NULL) {
+		jobgroup *next = group_p->next;
+		free(group_p);
+		group_p = next;
 	}
-	bsem_p->v = 0;
-	pthread_mutex_unlock(&bsem_p->mutex);
+	jobqueue_p->spare = NULL;
 }
@@ -12,6 +12,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 /* =================================== API ======================================= */
@@ -19,6 +20,19 @@ extern "C" {
 
 typedef struct thpool_* threadpool;
 
+/* Thread pool statistics */
+typedef struct thpool_stats {
+	uint64_t queued;              /* jobs currently pending             */
+	uint64_t enqueued;            /* total jobs added                   */
+	uint64_t dequeued;            /* total jobs picked by a thread      */
+	uint64_t stolen;              /* jobs picked from another's queue   */
+	uint64_t wait_time_total_us;  /* total time jobs spent pending      */
+	uint64_t wait_time_max_us;    /* longest time a job spent pending   */
+	uint64_t wait_time_p50_us;    /* median time jobs spent pending     */
+	uint64_t wait_time_p99_us;    /* 99th percentile of pending time    */
+	uint64_t working;             /* threads currently executing a job  */
+} thpool_stats;
+
 
 /**
  * @brief  Initialize threadpool
@@ -30,15 +44,18 @@ typedef struct thpool_* threadpool;
  *
  *    ..
  *    threadpool thpool;                     //First we declare a threadpool
- *    thpool = thpool_init(4);               //then we initialize it to 4 threads
+ *    thpool = thpool_init(4, 8, "pool", NULL); //then we initialize it to 4 threads
  *    ..
  *
  * @param  num_threads   number of threads to be created in the threadpool
+ * @param  max_threads   number of threads the threadpool may grow to
  * @param  name          name associated with pool
+ * @param  on_start      invoked by each thread as it starts, may be NULL
  * @return threadpool    created threadpool on success,
  *                       NULL on error
  */
-threadpool thpool_init(int num_threads, const char *name);
+threadpool thpool_init(int num_threads, int max_threads, const char *name,
+		void (*on_start)(void));
 
 
 /**
@@ -71,6 +88,39 @@ threadpool thpool_init(int num_threads, const char *name);
 int thpool_add_work(threadpool, void (*function_p)(void*), void* arg_p);
 
 
+/**
+ * @brief Add work on behalf of a group to the job queue
+ *
+ * Jobs are kept in per group sub-queues, each group is pinned to the
+ * queue of one thread while idle threads steal from other queues.
+ * Groups sharing a queue are served in weighted round-robin order,
+ * a group is served up to 'weight' consecutive jobs per round, so a
+ * group flooding the pool can't starve the others.
+ *
+ * @param  threadpool    threadpool to which the work will be added
+ * @param  group         key identifying the group, NULL for the default group
+ * @param  weight        number of jobs served per round for the group
+ * @param  function_p    pointer to function to add as work
+ * @param  arg_p         pointer to an argument
+ * @return 0 on successs -1 otherwise
+ */
+int thpool_add_group_work(threadpool, const void *group, uint weight,
+		void (*function_p)(void*), void* arg_p);
+
+
+/**
+ * @brief Resizes the threadpool
+ *
+ * Missing threads are created right away, surplus threads exit
+ * once they're done with the job they are executing.
+ *
+ * @param threadpool     the threadpool to resize
+ * @param num_threads    number of threads, between 1 and max_threads
+ * @return 0 on successs -1 otherwise
+ */
+int thpool_resize(threadpool, int num_threads);
+
+
 /**
  * @brief Wait for all queued jobs to finish
  *
@@ -195,6 +245,17 @@ int thpool_num_threads_working(threadpool);
 int thpool_num_threads(threadpool);
 
 
+/**
+ * @brief Returns number of threads the pool may grow to.
+ *
+ * Friendly thread ids are smaller than this number.
+ *
+ * @param threadpool     the threadpool of interest
+ * @return integer       max number of threads
+ */
+int thpool_max_threads(threadpool);
+
+
 /**
  * @brief Returns friendly id associated with thread.
  *
@@ -220,6 +281,14 @@ bool thpool_queue_full(threadpool);
  */
 void thpool_set_jobqueue_cap(threadpool, uint64_t);
 
+/**
+ * @brief Retrieves thread pool queue statistics.
+ *
+ * @param threadpool    the threadpool of interest
+ * @param thpool_stats  [output] statistics
+ */
+void thpool_get_stats(threadpool, thpool_stats *);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,48 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "tsc.h"
+#include <pthread.h>
+
+// calibration period
+#define TSC_CALIBRATION_NS 5000000
+
+static double _ticks_per_ms = 1000000;  // a tick per nanosecond
+static pthread_once_t _calibrated = PTHREAD_ONCE_INIT;
+
+static inline uint64_t _MonotonicNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// measure ticks elapsed over a short busy wait
+static void _Calibrate(void) {
+	uint64_t ns_start  = _MonotonicNs();
+	uint64_t tsc_start = TSC_Now();
+
+	uint64_t ns_end;
+	do {
+		ns_end = _MonotonicNs();
+	} while(ns_end - ns_start < TSC_CALIBRATION_NS);
+
+	uint64_t tsc_end = TSC_Now();
+
+	_ticks_per_ms = (double)(tsc_end - tsc_start) * 1000000 /
+		(double)(ns_end - ns_start);
+}
+
+void TSC_Init(void) {
+	pthread_once(&_calibrated, _Calibrate);
+}
+
+double TSC_ToMs
+(
+	uint64_t ticks
+) {
+	TSC_Init();
+	return (double)ticks / _ticks_per_ms;
+}
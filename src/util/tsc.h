@@ -0,0 +1,42 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// low overhead timer reading the CPU's time stamp counter
+// ticks are converted to wall clock time using a frequency
+// calibrated once against the monotonic clock
+// platforms without an accessible counter fall back to the monotonic clock
+// in which case a tick is a nanosecond
+
+static inline uint64_t TSC_Now(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	uint64_t ticks;
+	__asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+	return ticks;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// calibrate tick frequency, invoked lazily by TSC_ToMs
+void TSC_Init(void);
+
+// converts a number of ticks to milliseconds
+double TSC_ToMs
+(
+	uint64_t ticks
+);
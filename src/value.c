@@ -9,11 +9,14 @@
 #include "graph/entities/graph_entity.h"
 #include "graph/entities/node.h"
 #include "graph/entities/edge.h"
+#include "util/string_pool.h"
+#include "util/compressed_string.h"
 #include <errno.h>
 #include <limits.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <sys/param.h>
+#include "util/arr.h"
 #include "util/rmalloc.h"
 #include "datatypes/map.h"
 #include "datatypes/array.h"
@@ -117,13 +120,89 @@ SIValue SI_Point(float latitude, float longitude) {
 	};
 }
 
+//------------------------------------------------------------------------------
+// shared arrays and maps
+//------------------------------------------------------------------------------
+
+// shared arrays and maps are arr.h arrays prefixed by a reference count
+// [refcount][array header][elements]
+// such that element access is identical to that of self-owned values
+#define SHARED_REFCOUNT(v) \
+	((uint32_t *)((char *)array_hdr((v).array) - sizeof(uint32_t)))
+
+static inline bool _SIValue_IsShared(const SIValue *v) {
+	return v->allocation == M_SHARED || v->allocation == M_SHARED_VOLATILE;
+}
+
+// acquire an additional reference to a shared value
+static inline void _SIValue_Retain(SIValue v) {
+	__atomic_add_fetch(SHARED_REFCOUNT(v), 1, __ATOMIC_RELAXED);
+}
+
+// release a reference to a shared value
+// the last reference frees the elements and the block
+static void _SIValue_Release(SIValue v) {
+	uint32_t *refcount = SHARED_REFCOUNT(v);
+	if(__atomic_sub_fetch(refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+	uint32_t n = array_len(v.array);
+	if(v.type == T_ARRAY) {
+		for(uint32_t i = 0; i < n; i++) SIValue_Free(v.array[i]);
+	} else {
+		for(uint32_t i = 0; i < n; i++) {
+			SIValue_Free(v.map[i].key);
+			SIValue_Free(v.map[i].val);
+		}
+	}
+	rm_free(refcount);
+}
+
+// move an arr.h array into a reference counted block
+static void *_SharedBlock_New(void *arr) {
+	array_hdr_t *hdr = array_hdr(arr);
+	size_t size = sizeof(array_hdr_t) + (size_t)hdr->len * hdr->elem_sz;
+
+	uint32_t *refcount = rm_malloc(sizeof(uint32_t) + size);
+	*refcount = 1;
+
+	array_hdr_t *shared = (array_hdr_t *)(refcount + 1);
+	memcpy(shared, hdr, size);
+	shared->cap = hdr->len;
+
+	array_free(arr);
+	return shared->buf;
+}
+
+void SIValue_MakeShared(SIValue *v) {
+	ASSERT(v != NULL);
+
+	if(v->allocation != M_SELF) return;
+	if(v->type != T_ARRAY && v->type != T_MAP) return;
+
+	// share nested values first, elements are moved rather than copied
+	uint32_t n = array_len(v->array);
+	if(v->type == T_ARRAY) {
+		for(uint32_t i = 0; i < n; i++) SIValue_MakeShared(v->array + i);
+		v->array = _SharedBlock_New(v->array);
+	} else {
+		for(uint32_t i = 0; i < n; i++) SIValue_MakeShared(&v->map[i].val);
+		v->map = _SharedBlock_New(v->map);
+	}
+
+	v->allocation = M_SHARED;
+}
+
 /* Make an SIValue that reuses the original's allocations, if any.
  * The returned value is not responsible for freeing any allocations,
  * and is not guaranteed that these allocations will remain in scope. */
 SIValue SI_ShareValue(const SIValue v) {
 	SIValue dup = v;
 	// If the original value owns an allocation, mark that the duplicate shares it.
-	if(v.allocation == M_SELF) dup.allocation = M_VOLATILE;
+	if(v.allocation == M_SELF || v.allocation == M_INTERN) {
+		dup.allocation = M_VOLATILE;
+	} else if(v.allocation == M_SHARED) {
+		dup.allocation = M_SHARED_VOLATILE;
+	}
 	return dup;
 }
 
@@ -133,6 +212,10 @@ SIValue SI_ShareValue(const SIValue v) {
 SIValue SI_CloneValue(const SIValue v) {
 	if(v.allocation == M_NONE) return v; // Stack value; no allocation necessary.
 
+	if(v.allocation == M_COMPRESSED) {
+		return SI_TransferStringVal(CompressedString_Decompress(v.stringval));
+	}
+
 	if(v.type == T_STRING) {
 		// Allocate a new copy of the input's string value.
 		return SI_DuplicateStringVal(v.stringval);
@@ -172,6 +255,12 @@ SIValue SI_CloneValue(const SIValue v) {
 
 SIValue SI_ShallowCloneValue(const SIValue v) {
 	if(v.allocation == M_CONST || v.allocation == M_NONE) return v;
+	if(_SIValue_IsShared(&v)) {
+		SIValue dup = v;
+		_SIValue_Retain(dup);
+		dup.allocation = M_SHARED;
+		return dup;
+	}
 	return SI_CloneValue(v);
 }
 
@@ -179,14 +268,21 @@ SIValue SI_ShallowCloneValue(const SIValue v) {
  *  to remain in scope. This is most frequently the case for GraphEntity properties. */
 SIValue SI_ConstValue(const SIValue *v) {
 	SIValue dup = *v;
-	if(v->allocation != M_NONE) dup.allocation = M_CONST;
+	// volatile values, e.g. decompressed properties, remain volatile
+	if(v->allocation != M_NONE && v->allocation != M_VOLATILE) {
+		dup.allocation = M_CONST;
+	}
 	return dup;
 }
 
 // Clone 'v' and set v's allocation to volatile if 'v' owned the memory
 SIValue SI_TransferOwnership(SIValue *v) {
 	SIValue dup = *v;
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(v->allocation == M_SELF || v->allocation == M_INTERN) {
+		v->allocation = M_VOLATILE;
+	} else if(v->allocation == M_SHARED) {
+		v->allocation = M_SHARED_VOLATILE;
+	}
 	return dup;
 }
 
@@ -194,7 +290,11 @@ SIValue SI_TransferOwnership(SIValue *v) {
  * with no responsibility for freeing or guarantee regarding scope.
  * This is used in cases like performing shallow copies of scalars in Record entries. */
 void SIValue_MakeVolatile(SIValue *v) {
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(v->allocation == M_SELF || v->allocation == M_INTERN) {
+		v->allocation = M_VOLATILE;
+	} else if(v->allocation == M_SHARED) {
+		v->allocation = M_SHARED_VOLATILE;
+	}
 }
 
 /* Ensure that any allocation held by the given SIValue is guaranteed to not go out
@@ -205,6 +305,11 @@ void SIValue_Persist(SIValue *v) {
 	// do nothing for non-volatile values
 	// for volatile values, persisting uses the same logic as cloning
 	if(v->allocation == M_VOLATILE) *v = SI_CloneValue(*v);
+	// borrowed shared values only acquire a reference
+	else if(v->allocation == M_SHARED_VOLATILE) {
+		_SIValue_Retain(*v);
+		v->allocation = M_SHARED;
+	}
 }
 
 /* Update an SIValue's allocation type to the provided value. */
@@ -515,6 +620,8 @@ int SIValue_Compare(const SIValue a, const SIValue b, int *disjointOrNull) {
 		case T_DOUBLE:
 			return SAFE_COMPARISON_RESULT(a.doubleval - b.doubleval);
 		case T_STRING:
+			// identical pointers, e.g. two references to an interned string
+			if(a.stringval == b.stringval) return 0;
 			return strcmp(a.stringval, b.stringval);
 		case T_NODE:
 		case T_EDGE:
@@ -669,7 +776,44 @@ XXH64_hash_t SIValue_HashCode(SIValue v) {
 	return XXH64_digest(&state);
 }
 
+size_t SIValue_MemoryUsage(SIValue v) {
+	if(v.allocation == M_COMPRESSED) {
+		return CompressedString_MemoryUsage(v.stringval);
+	}
+	if(v.allocation != M_SELF) return 0;
+
+	switch(v.type) {
+	case T_STRING:
+		return strlen(v.stringval) + 1;
+	case T_ARRAY: {
+		uint32_t n = array_len(v.array);
+		size_t size = array_sizeof(array_hdr(v.array));
+		for(uint32_t i = 0; i < n; i++) size += SIValue_MemoryUsage(v.array[i]);
+		return size;
+	}
+	default:
+		return 0;
+	}
+}
+
 void SIValue_Free(SIValue v) {
+	// interned strings are shared, release this value's reference
+	if(v.allocation == M_INTERN) {
+		StringPool_Release(v.stringval);
+		return;
+	}
+
+	// shared arrays and maps, release this value's reference
+	if(v.allocation == M_SHARED) {
+		_SIValue_Release(v);
+		return;
+	}
+
+	if(v.allocation == M_COMPRESSED) {
+		rm_free(v.stringval);
+		return;
+	}
+
 	// The free routine only performs work if it owns a heap allocation.
 	if(v.allocation != M_SELF) return;
 
@@ -44,7 +44,12 @@ typedef enum {
 	M_NONE = 0,       // SIValue is not heap-allocated
 	M_SELF = 0x1,     // SIValue is responsible for freeing its reference
 	M_VOLATILE = 0x2, // SIValue does not own its reference and may go out of scope
-	M_CONST = 0x4     // SIValue does not own its allocation, but its access is safe
+	M_CONST = 0x4,    // SIValue does not own its allocation, but its access is safe
+	M_INTERN = 0x8,   // SIValue holds a reference to a string pool interned string
+	M_EXTERN = 0x10,  // SIValue references graph owned memory-mapped storage
+	M_SHARED = 0x20,  // SIValue holds a counted reference to an immutable array or map
+	M_SHARED_VOLATILE = 0x40, // SIValue borrows a shared array or map without counting
+	M_COMPRESSED = 0x80       // SIValue holds a graph entity's compressed string property
 } SIAllocation;
 
 #define SI_TYPE(value) (value).type
@@ -143,6 +148,12 @@ void SIValue_MakeVolatile(SIValue *v);
 // SIValue_Persist updates an SIValue to duplicate any allocations that may go out of scope in the lifetime of this query.
 void SIValue_Persist(SIValue *v);
 
+// SIValue_MakeShared converts a self-owned array or map, and nested arrays
+// and maps within it, into reference counted immutable values
+// sharing and persisting the result only bump its reference count
+// the value must not be modified in place afterwards
+void SIValue_MakeShared(SIValue *v);
+
 // SIValue_SetAllocationType changes the SIValue's allocation to the explicitly provided value.
 void SIValue_SetAllocationType(SIValue *v, SIAllocation allocation);
 
@@ -197,6 +208,10 @@ void SIValue_HashUpdate(SIValue v, XXH64_state_t *state);
 /* Returns a hash code for a given SIValue. */
 XXH64_hash_t SIValue_HashCode(SIValue v);
 
+/* Returns the number of heap bytes owned by an SIValue, excluding the SIValue
+ * itself. Interned strings are owned by their pool and aren't accounted. */
+size_t SIValue_MemoryUsage(SIValue v);
+
 /* Free an SIValue's internal property if that property is a heap allocation owned
  * by this object. */
 void SIValue_Free(SIValue v);
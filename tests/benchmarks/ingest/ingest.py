@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+"""Compare the throughput of RedisGraph's ingest paths.
+
+The same synthetic social graph, people connected by KNOWS relationships,
+is loaded by each strategy into a freshly started server:
+
+    create              a CREATE query per node and per relationship
+    unwind_create       UNWIND $rows CREATE, 'batch' rows per query
+    unwind_merge        UNWIND $rows MERGE, nodes matched by a label scan
+    unwind_merge_index  UNWIND $rows MERGE, nodes matched through an index
+    bulk                GRAPH.BULK binary blobs, 'batch' entities per blob
+
+The create strategies address relationship endpoints by node ID, the merge
+strategies by the indexed or scanned 'id' property.
+
+Each strategy reports entities created per second, the server's peak RSS,
+time spent merging pending matrix changes (INFO graph graph_matrices)
+and, unless --no-replica is given, how long a replica took to catch up
+once loading ended.
+
+Examples:
+    python3 ingest.py --module ../../../src/redisgraph.so
+    python3 ingest.py --module redisgraph.so --nodes 100000 --batch 5000 \\
+        --strategies unwind_create,bulk --json report.json
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+import redis
+
+GRAPH = "ingest"
+STRATEGIES = ["create", "unwind_create", "unwind_merge", "unwind_merge_index", "bulk"]
+
+
+def dataset(args):
+    """Returns the nodes and relationships to load, nodes are numbered
+    in creation order such that node i is assigned ID i."""
+    rng = random.Random(args.seed)
+    nodes = [{"id": i, "name": "person_%d" % i, "age": 18 + rng.randrange(60)}
+             for i in range(args.nodes)]
+    # distinct destinations, such that MERGE creates every relationship
+    edges = [{"src": i, "dst": d, "since": 1990 + rng.randrange(30)}
+             for i in range(args.nodes) for d in rng.sample(range(args.nodes), args.degree)]
+    return nodes, edges
+
+
+def literal(v):
+    if isinstance(v, str):
+        return "'%s'" % v
+    if isinstance(v, dict):
+        return "{%s}" % ", ".join("%s: %s" % (k, literal(x)) for k, x in v.items())
+    if isinstance(v, list):
+        return "[%s]" % ", ".join(literal(x) for x in v)
+    return str(v)
+
+
+def batches(rows, n):
+    for i in range(0, len(rows), n):
+        yield rows[i:i + n]
+
+
+class Server:
+    """A redis-server loading the module, replicating 'primary' if given."""
+
+    def __init__(self, args, port, primary=None):
+        self.dir = tempfile.mkdtemp(prefix="rg-ingest-")
+        cmd = [args.redis_server, "--port", str(port), "--dir", self.dir,
+               "--save", "", "--appendonly", "no",
+               "--loadmodule", os.path.abspath(args.module)]
+        if primary is not None:
+            cmd += ["--replicaof", "localhost", str(primary)]
+        self.proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL)
+        self.conn = redis.Redis(port=port, decode_responses=True)
+        deadline = time.time() + 10
+        while True:
+            try:
+                self.conn.ping()
+                break
+            except redis.ConnectionError:
+                if time.time() > deadline:
+                    raise
+                time.sleep(0.1)
+
+    def peak_rss(self):
+        """Peak resident set size in bytes, Linux only, else Redis's peak."""
+        try:
+            with open("/proc/%d/status" % self.proc.pid) as f:
+                for line in f:
+                    if line.startswith("VmHWM:"):
+                        return int(line.split()[1]) * 1024
+        except OSError:
+            pass
+        return self.conn.info("memory")["used_memory_peak"]
+
+    def flush_us(self):
+        """Accumulated duration of the graph's matrix merges."""
+        for k, v in self.conn.info("graph").items():
+            if k in (GRAPH, "graph_" + GRAPH) and isinstance(v, dict):
+                return v["total_flush_us"]
+        return 0
+
+    def offset(self):
+        return self.conn.info("replication")["master_repl_offset"]
+
+    def stop(self):
+        try:
+            self.conn.shutdown(nosave=True)
+        except redis.ConnectionError:
+            pass
+        self.proc.wait()
+        shutil.rmtree(self.dir, ignore_errors=True)
+
+
+def query(conn, q, rows=None):
+    if rows is not None:
+        q = "CYPHER rows=%s %s" % (literal(rows), q)
+    conn.execute_command("GRAPH.QUERY", GRAPH, q)
+
+
+def load_create(conn, nodes, edges, args):
+    for n in nodes:
+        query(conn, "CREATE (:Person %s)" % literal(n))
+    for e in edges:
+        query(conn, "MATCH (a), (b) WHERE id(a) = %d AND id(b) = %d "
+                    "CREATE (a)-[:KNOWS {since: %d}]->(b)" % (e["src"], e["dst"], e["since"]))
+
+
+def load_unwind_create(conn, nodes, edges, args):
+    for b in batches(nodes, args.batch):
+        query(conn, "UNWIND $rows AS r CREATE (:Person {id: r.id, name: r.name, age: r.age})", b)
+    for b in batches(edges, args.batch):
+        query(conn, "UNWIND $rows AS r MATCH (a), (b) WHERE id(a) = r.src AND id(b) = r.dst "
+                    "CREATE (a)-[:KNOWS {since: r.since}]->(b)", b)
+
+
+def load_unwind_merge(conn, nodes, edges, args):
+    for b in batches(nodes, args.batch):
+        query(conn, "UNWIND $rows AS r MERGE (p:Person {id: r.id}) "
+                    "SET p.name = r.name, p.age = r.age", b)
+    for b in batches(edges, args.batch):
+        query(conn, "UNWIND $rows AS r MATCH (a:Person {id: r.src}), (b:Person {id: r.dst}) "
+                    "MERGE (a)-[:KNOWS {since: r.since}]->(b)", b)
+
+
+def load_unwind_merge_index(conn, nodes, edges, args):
+    query(conn, "CREATE INDEX FOR (p:Person) ON (p.id)")
+    load_unwind_merge(conn, nodes, edges, args)
+
+
+# GRAPH.BULK binary blobs, see docs/bulk_spec.md
+def bulk_header(label, props):
+    h = label.encode() + b"\x00" + struct.pack("<I", len(props))
+    return h + b"".join(p.encode() + b"\x00" for p in props)
+
+
+def bulk_value(v):
+    if isinstance(v, str):
+        return b"\x03" + v.encode() + b"\x00"
+    return b"\x04" + struct.pack("<q", v)
+
+
+def load_bulk(conn, nodes, edges, args):
+    begin = ["BEGIN"]
+    for b in batches(nodes, args.batch):
+        blob = bulk_header("Person", ["id", "name", "age"]) + b"".join(
+            bulk_value(n["id"]) + bulk_value(n["name"]) + bulk_value(n["age"]) for n in b)
+        conn.execute_command("GRAPH.BULK", GRAPH, *begin, len(b), 0, 1, 0, blob)
+        begin = []
+    for b in batches(edges, args.batch):
+        blob = bulk_header("KNOWS", ["since"]) + b"".join(
+            struct.pack("<QQ", e["src"], e["dst"]) + bulk_value(e["since"]) for e in b)
+        conn.execute_command("GRAPH.BULK", GRAPH, *begin, 0, len(b), 0, 1, blob)
+
+
+def run(args, strategy, nodes, edges):
+    primary = Server(args, args.port)
+    replica = None if args.no_replica else Server(args, args.port + 1, args.port)
+    try:
+        if replica is not None:
+            # wait for the initial sync
+            while replica.conn.info("replication")["master_link_status"] != "up":
+                time.sleep(0.1)
+
+        loader = globals()["load_" + strategy]
+        start = time.perf_counter()
+        loader(primary.conn, nodes, edges, args)
+        elapsed = time.perf_counter() - start
+
+        lag = None
+        if replica is not None:
+            # time for the replica to apply the replication stream
+            offset = primary.offset()
+            lag_start = time.perf_counter()
+            while replica.offset() < offset:
+                time.sleep(0.001)
+            lag = time.perf_counter() - lag_start
+
+        counts = primary.conn.execute_command("GRAPH.QUERY", GRAPH,
+            "MATCH (n) OPTIONAL MATCH (n)-[e]->() RETURN count(DISTINCT n), count(e)")[1][0]
+        return {
+            "strategy": strategy,
+            "nodes": counts[0],
+            "edges": counts[1],
+            "seconds": elapsed,
+            "entities_per_sec": (counts[0] + counts[1]) / max(elapsed, 1e-9),
+            "peak_rss_bytes": primary.peak_rss(),
+            "matrix_flush_ms": primary.flush_us() / 1000.0,
+            "replica_lag_ms": lag * 1000.0 if lag is not None else None,
+        }
+    finally:
+        if replica is not None:
+            replica.stop()
+        primary.stop()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--module", required=True, help="path to redisgraph.so")
+    parser.add_argument("--redis-server", default="redis-server")
+    parser.add_argument("--port", type=int, default=6379,
+                        help="primary port, the replica listens on the next one")
+    parser.add_argument("--nodes", type=int, default=20000)
+    parser.add_argument("--degree", type=int, default=5, help="relationships per node")
+    parser.add_argument("--batch", type=int, default=1000,
+                        help="rows per UNWIND query, entities per GRAPH.BULK call")
+    parser.add_argument("--seed", type=int, default=12345)
+    parser.add_argument("--strategies", default=",".join(STRATEGIES))
+    parser.add_argument("--no-replica", action="store_true")
+    parser.add_argument("--json", help="write the report to a JSON file")
+    args = parser.parse_args()
+
+    strategies = args.strategies.split(",")
+    for s in strategies:
+        if s not in STRATEGIES:
+            parser.error("unknown strategy %s" % s)
+
+    nodes, edges = dataset(args)
+    expected = (len(nodes), len(edges))
+
+    print("%-20s %10s %12s %12s %12s %12s" % ("strategy", "seconds", "entities/s",
+          "peak rss MB", "flush ms", "lag ms"))
+    report = []
+    failed = False
+    for s in strategies:
+        r = run(args, s, nodes, edges)
+        report.append(r)
+        lag = "%12.1f" % r["replica_lag_ms"] if r["replica_lag_ms"] is not None else "%12s" % "-"
+        print("%-20s %10.2f %12.0f %12.1f %12.1f %s" % (s, r["seconds"],
+              r["entities_per_sec"], r["peak_rss_bytes"] / 2 ** 20,
+              r["matrix_flush_ms"], lag))
+        if (r["nodes"], r["edges"]) != expected:
+            print("%s created %d nodes and %d edges, expected %d and %d" %
+                  ((s, r["nodes"], r["edges"]) + expected))
+            failed = True
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"nodes": len(nodes), "edges": len(edges), "runs": report}, f, indent=2)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,330 @@
+#!/usr/bin/env python3
+"""Load an LDBC Social Network Benchmark dataset into RedisGraph.
+
+Reads the CSV output of the LDBC SNB datagen (CsvBasic serializer, '|'
+delimited, static/ and dynamic/ directories) and loads it with GRAPH.BULK,
+then creates the indices used by the interactive workload and optionally saves
+an RDB to be used as a benchmark dataset.
+
+Besides the LDBC schema the loader adds:
+  - a `seq` attribute to Person, Forum and Message nodes, a pseudo random
+    permutation of [0, count) such that benchmarks can pick random entities
+    using redisgraph-benchmark-go's __rand_int__
+  - `birthdayMonth` and `birthdayDay` attributes to Person nodes
+  - the Message label to both Post and Comment nodes
+  - the City, Country, Continent, University and Company labels to Place and
+    Organisation nodes according to their type
+
+Dates are stored as milliseconds since epoch.
+
+Example:
+    python3 ldbc_loader.py --graph ldbc-snb-sf1 --save datasets/ldbc-snb-sf1.rdb social_network/
+"""
+
+import argparse
+import datetime
+import math
+import os
+import re
+import shutil
+import struct
+import sys
+
+import redis
+
+# GRAPH.BULK property types, see src/bulk_insert/bulk_insert.c
+BI_NULL = 0
+BI_BOOL = 1
+BI_DOUBLE = 2
+BI_STRING = 3
+BI_LONG = 4
+BI_ARRAY = 5
+
+# max size of a single GRAPH.BULK call
+MAX_BATCH_BYTES = 64 * 1024 * 1024
+
+# node files, in load order: (file prefix, labels, label column)
+# a label column maps a column's value to an additional label
+NODE_FILES = [
+    ("static/place", "Place", ("type", {"city": "City", "country": "Country", "continent": "Continent"})),
+    ("static/organisation", "Organisation", ("type", {"university": "University", "company": "Company"})),
+    ("static/tagclass", "TagClass", None),
+    ("static/tag", "Tag", None),
+    ("dynamic/person", "Person", None),
+    ("dynamic/forum", "Forum", None),
+    ("dynamic/post", "Post:Message", None),
+    ("dynamic/comment", "Comment:Message", None),
+]
+
+# edge files: (file prefix, relationship type, source group, destination group)
+EDGE_FILES = [
+    ("static/organisation_isLocatedIn_place", "IS_LOCATED_IN", "Organisation", "Place"),
+    ("static/place_isPartOf_place", "IS_PART_OF", "Place", "Place"),
+    ("static/tag_hasType_tagclass", "HAS_TYPE", "Tag", "TagClass"),
+    ("static/tagclass_isSubclassOf_tagclass", "IS_SUBCLASS_OF", "TagClass", "TagClass"),
+    ("dynamic/person_isLocatedIn_place", "IS_LOCATED_IN", "Person", "Place"),
+    ("dynamic/person_hasInterest_tag", "HAS_INTEREST", "Person", "Tag"),
+    ("dynamic/person_knows_person", "KNOWS", "Person", "Person"),
+    ("dynamic/person_likes_post", "LIKES", "Person", "Message"),
+    ("dynamic/person_likes_comment", "LIKES", "Person", "Message"),
+    ("dynamic/person_studyAt_organisation", "STUDY_AT", "Person", "Organisation"),
+    ("dynamic/person_workAt_organisation", "WORK_AT", "Person", "Organisation"),
+    ("dynamic/forum_containerOf_post", "CONTAINER_OF", "Forum", "Message"),
+    ("dynamic/forum_hasMember_person", "HAS_MEMBER", "Forum", "Person"),
+    ("dynamic/forum_hasModerator_person", "HAS_MODERATOR", "Forum", "Person"),
+    ("dynamic/forum_hasTag_tag", "HAS_TAG", "Forum", "Tag"),
+    ("dynamic/post_hasCreator_person", "HAS_CREATOR", "Message", "Person"),
+    ("dynamic/post_hasTag_tag", "HAS_TAG", "Message", "Tag"),
+    ("dynamic/post_isLocatedIn_place", "IS_LOCATED_IN", "Message", "Place"),
+    ("dynamic/comment_hasCreator_person", "HAS_CREATOR", "Message", "Person"),
+    ("dynamic/comment_hasTag_tag", "HAS_TAG", "Message", "Tag"),
+    ("dynamic/comment_isLocatedIn_place", "IS_LOCATED_IN", "Message", "Place"),
+    ("dynamic/comment_replyOf_post", "REPLY_OF", "Message", "Message"),
+    ("dynamic/comment_replyOf_comment", "REPLY_OF", "Message", "Message"),
+]
+
+# multi-valued person attributes: (file prefix, attribute)
+PERSON_LISTS = [
+    ("dynamic/person_email_emailaddress", "email"),
+    ("dynamic/person_speaks_language", "speaks"),
+]
+
+# labels with a `seq` attribute, Post and Comment share the Message sequence
+SEQ_GROUPS = {"Person": "Person", "Forum": "Forum", "Post": "Message", "Comment": "Message"}
+
+INDICES = [
+    ("Person", "id"), ("Person", "seq"), ("Person", "firstName"),
+    ("Message", "id"), ("Message", "seq"),
+    ("Forum", "id"), ("Forum", "seq"),
+    ("Tag", "name"), ("TagClass", "name"),
+    ("Place", "id"), ("Country", "name"),
+    ("Organisation", "id"),
+]
+
+INT_COLUMNS = {"id", "length", "classYear", "workFrom"}
+DATE_COLUMNS = {"creationDate", "joinDate", "birthday"}
+
+
+def part_files(root, prefix):
+    """Returns all part files of 'prefix', e.g. person_0_0.csv, person_1_0.csv."""
+    directory, name = os.path.split(os.path.join(root, prefix))
+    pattern = re.compile(r"^%s_\d+_\d+\.csv$" % re.escape(name))
+    if not os.path.isdir(directory):
+        return []
+    return sorted(os.path.join(directory, f) for f in os.listdir(directory) if pattern.match(f))
+
+
+def rows(root, prefix):
+    """Yields (header, row) of every part file of 'prefix'."""
+    for path in part_files(root, prefix):
+        with open(path, encoding="utf-8") as f:
+            header = f.readline().rstrip("\n").split("|")
+            for line in f:
+                yield header, line.rstrip("\n").split("|")
+
+
+def to_millis(value):
+    if value.isdigit():
+        return int(value)
+    if len(value) == 10:
+        d = datetime.datetime.strptime(value, "%Y-%m-%d").replace(tzinfo=datetime.timezone.utc)
+    else:
+        d = datetime.datetime.strptime(value, "%Y-%m-%dT%H:%M:%S.%f%z")
+    return int(d.timestamp() * 1000)
+
+
+def encode(value):
+    if value is None:
+        return struct.pack("<B", BI_NULL)
+    if isinstance(value, bool):
+        return struct.pack("<B?", BI_BOOL, value)
+    if isinstance(value, int):
+        return struct.pack("<Bq", BI_LONG, value)
+    if isinstance(value, float):
+        return struct.pack("<Bd", BI_DOUBLE, value)
+    if isinstance(value, list):
+        return struct.pack("<Bq", BI_ARRAY, len(value)) + b"".join(encode(v) for v in value)
+    return struct.pack("<B", BI_STRING) + value.encode("utf-8") + b"\0"
+
+
+def convert(column, value):
+    if value == "":
+        return None
+    if column in INT_COLUMNS:
+        return int(value)
+    if column in DATE_COLUMNS:
+        return to_millis(value)
+    return value
+
+
+def token_header(labels, props):
+    return (labels.encode("utf-8") + b"\0" + struct.pack("<I", len(props)) +
+            b"".join(p.encode("utf-8") + b"\0" for p in props))
+
+
+def permutation(n):
+    """Returns a multiplier 'a' such that i -> (a * i) % n permutes [0, n)."""
+    a = max(int(n * 0.6180339887) | 1, 1)
+    while math.gcd(a, n) != 1:
+        a += 2
+    return a
+
+
+class BulkLoader:
+    def __init__(self, conn, graph):
+        self.conn = conn
+        self.graph = graph
+        self.begin = True
+        self.node_count = 0     # nodes created so far, the next node's ID
+        self.edge_count = 0
+        self.tokens = {}        # header -> bytearray, pending tokens
+        self.pending = 0        # pending bytes
+        self.pending_nodes = 0
+        self.pending_edges = 0
+        self.edges = False      # pending tokens are edge tokens
+
+    def add(self, header, payload, edge):
+        token = self.tokens.get(header)
+        if token is None:
+            token = self.tokens[header] = bytearray(header)
+        token += payload
+        self.pending += len(payload)
+        if edge:
+            self.pending_edges += 1
+        else:
+            self.pending_nodes += 1
+        self.edges = edge
+        if self.pending >= MAX_BATCH_BYTES:
+            self.flush()
+
+    def add_node(self, header, values):
+        node_id = self.node_count + self.pending_nodes
+        self.add(header, b"".join(encode(v) for v in values), False)
+        return node_id
+
+    def add_edge(self, header, src, dest, values):
+        payload = struct.pack("<QQ", src, dest) + b"".join(encode(v) for v in values)
+        self.add(header, payload, True)
+
+    def flush(self):
+        if not self.tokens:
+            return
+        tokens = [bytes(t) for t in self.tokens.values()]
+        args = ["GRAPH.BULK", self.graph]
+        if self.begin:
+            args.append("BEGIN")
+        args += [self.pending_nodes, self.pending_edges]
+        args += [0, len(tokens)] if self.edges else [len(tokens), 0]
+        self.conn.execute_command(*(args + tokens))
+
+        self.begin = False
+        self.node_count += self.pending_nodes
+        self.edge_count += self.pending_edges
+        self.tokens = {}
+        self.pending = self.pending_nodes = self.pending_edges = 0
+
+
+def load_nodes(root, loader, ids):
+    lists = {}
+    for prefix, attr in PERSON_LISTS:
+        for _, row in rows(root, prefix):
+            lists.setdefault(int(row[0]), {}).setdefault(attr, []).append(row[1])
+
+    # count sequenced entities to permute their seq values
+    seq_counts = {}
+    for prefix, labels, _ in NODE_FILES:
+        group = SEQ_GROUPS.get(labels.split(":")[0])
+        if group:
+            seq_counts[group] = seq_counts.get(group, 0) + sum(1 for _ in rows(root, prefix))
+    seq_next = {group: 0 for group in seq_counts}
+    seq_mult = {group: permutation(n) for group, n in seq_counts.items() if n > 0}
+
+    for prefix, labels, label_column in NODE_FILES:
+        label = labels.split(":")[0]
+        group = SEQ_GROUPS.get(label)
+        group_ids = ids.setdefault(group or label, {})
+        headers = {}
+        for header, row in rows(root, prefix):
+            props = [c for c in header]
+            values = [convert(c, v) for c, v in zip(header, row)]
+            node_labels = labels
+            if label_column:
+                column, mapping = label_column
+                node_labels += ":" + mapping[row[header.index(column)].lower()]
+            if group:
+                n = seq_next[group]
+                seq_next[group] += 1
+                props.append("seq")
+                values.append((seq_mult[group] * n) % seq_counts[group])
+            if label == "Person":
+                extra = lists.get(values[0], {})
+                for attr, _ in PERSON_LISTS:
+                    props.append(attr)
+                    values.append(extra.get(attr, []))
+                birthday = datetime.datetime.utcfromtimestamp(values[header.index("birthday")] / 1000)
+                props += ["birthdayMonth", "birthdayDay"]
+                values += [birthday.month, birthday.day]
+
+            key = (node_labels, tuple(props))
+            h = headers.get(key)
+            if h is None:
+                h = headers[key] = token_header(node_labels, props)
+            group_ids[values[0]] = loader.add_node(h, values)
+
+    loader.flush()
+    if seq_counts.get("Person"):
+        print("Person seq range: [0, %d)" % seq_counts["Person"])
+
+
+def load_edges(root, loader, ids):
+    for prefix, reltype, src_group, dest_group in EDGE_FILES:
+        h = None
+        for header, row in rows(root, prefix):
+            props = header[2:]
+            if h is None:
+                h = token_header(reltype, props)
+            src = ids[src_group][int(row[0])]
+            dest = ids[dest_group][int(row[1])]
+            loader.add_edge(h, src, dest, [convert(c, v) for c, v in zip(props, row[2:])])
+        # each relationship file is loaded as its own token
+        loader.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dataset", help="datagen output directory, holding static/ and dynamic/")
+    parser.add_argument("--graph", default="ldbc-snb", help="graph key")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=6379)
+    parser.add_argument("--password", default=None)
+    parser.add_argument("--save", help="save an RDB and copy it to this path, "
+                                       "the server must be local")
+    args = parser.parse_args()
+
+    conn = redis.Redis(host=args.host, port=args.port, password=args.password)
+    if conn.exists(args.graph):
+        print("key %s already exists" % args.graph)
+        return 1
+
+    loader = BulkLoader(conn, args.graph)
+    ids = {}
+    load_nodes(args.dataset, loader, ids)
+    load_edges(args.dataset, loader, ids)
+    print("loaded %d nodes and %d edges" % (loader.node_count, loader.edge_count))
+
+    for label, attr in INDICES:
+        conn.execute_command("GRAPH.QUERY", args.graph, "CREATE INDEX ON :%s(%s)" % (label, attr))
+
+    if args.save:
+        conn.save()
+        config = conn.config_get("dir")
+        dbfilename = conn.config_get("dbfilename")["dbfilename"]
+        shutil.copyfile(os.path.join(config["dir"], dbfilename), args.save)
+        print("saved %s" % args.save)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+"""Replay a RedisGraph query capture against a server.
+
+Captures are produced by the module once CAPTURE_SAMPLE_RATE is set, see
+docs/configuration.md. Queries are re-issued either at their recorded pace,
+optionally sped up, or by a fixed number of concurrent clients.
+The report compares the replay's server side latencies and throughput
+against the captured ones.
+
+Examples:
+    python3 replay.py redisgraph_capture.bin.1 redisgraph_capture.bin
+    python3 replay.py --speed 2 redisgraph_capture.bin
+    python3 replay.py --concurrency 32 --skip-writes redisgraph_capture.bin
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import redis
+
+MAGIC = b"RGCAPTUR"
+VERSION = 1
+READONLY = 0x1
+COMPACT = 0x2
+ARROW = 0x4
+JSON = 0x8
+
+RECORD_HEADER = struct.Struct("<QdQB")
+EXEC_TIME = re.compile(r"Query internal execution time: ([0-9.]+) milliseconds")
+
+
+class Query:
+    __slots__ = ("time", "latency", "rows", "flags", "graph", "command", "query")
+
+    def __init__(self, time, latency, rows, flags, graph, command, query):
+        self.time = time          # capture time, seconds since epoch
+        self.latency = latency    # captured latency, milliseconds
+        self.rows = rows
+        self.flags = flags
+        self.graph = graph
+        self.command = command
+        self.query = query
+
+
+def read_capture(path):
+    """Yields the queries recorded in a capture file."""
+    with open(path, "rb") as f:
+        header = f.read(len(MAGIC) + 4)
+        if len(header) < len(MAGIC) + 4 or header[:len(MAGIC)] != MAGIC:
+            raise ValueError("%s is not a query capture" % path)
+        version, = struct.unpack("<I", header[len(MAGIC):])
+        if version != VERSION:
+            raise ValueError("%s: unsupported capture version %d" % (path, version))
+
+        while True:
+            prefix = f.read(4)
+            if len(prefix) < 4:
+                return
+            length, = struct.unpack("<I", prefix)
+            record = f.read(length)
+            if len(record) < length:
+                return  # truncated tail, capture is still being written
+
+            t, latency, rows, flags = RECORD_HEADER.unpack_from(record)
+            offset = RECORD_HEADER.size
+            strings = []
+            for _ in range(3):
+                n, = struct.unpack_from("<I", record, offset)
+                offset += 4
+                strings.append(record[offset:offset + n].decode("utf-8"))
+                offset += n
+
+            graph, command, query = strings
+            yield Query(t / 1e6, latency, rows, flags, graph, command, query)
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    k = min(len(values) - 1, int(round(p / 100.0 * (len(values) - 1))))
+    return values[k]
+
+
+def server_latency(reply):
+    """Extracts the server side execution time out of a query reply."""
+    if not reply:
+        return None
+    stats = reply[-1]
+    for stat in stats if isinstance(stats, list) else []:
+        if isinstance(stat, bytes):
+            stat = stat.decode("utf-8")
+        m = EXEC_TIME.match(stat) if isinstance(stat, str) else None
+        if m:
+            return float(m.group(1))
+    return None
+
+
+class Replayer:
+    def __init__(self, args):
+        self.args = args
+        self.local = threading.local()
+        self.lock = threading.Lock()
+        self.latencies = []   # server side latency of each replayed query, ms
+        self.errors = 0
+        self.row_mismatches = 0
+
+    def connection(self):
+        conn = getattr(self.local, "conn", None)
+        if conn is None:
+            conn = redis.Redis(host=self.args.host, port=self.args.port,
+                               password=self.args.password)
+            self.local.conn = conn
+        return conn
+
+    def execute(self, q):
+        cmd = [q.command, q.graph, q.query]
+        if q.flags & COMPACT:
+            cmd.append("--compact")
+        if q.flags & ARROW:
+            cmd.append("--arrow")
+        if q.flags & JSON:
+            cmd.append("--json")
+
+        start = time.perf_counter()
+        try:
+            reply = self.connection().execute_command(*cmd)
+        except redis.ResponseError:
+            with self.lock:
+                self.errors += 1
+            return
+        elapsed = (time.perf_counter() - start) * 1000
+
+        latency = server_latency(reply)
+        rows = len(reply[1]) if len(reply) == 3 else 0
+        with self.lock:
+            self.latencies.append(latency if latency is not None else elapsed)
+            # arrow replies hold record batches rather than rows
+            if q.command.upper() == "GRAPH.QUERY" and not q.flags & ARROW and rows != q.rows:
+                self.row_mismatches += 1
+
+    def run(self, queries):
+        if self.args.concurrency:
+            # scaled concurrency, each client issues queries back to back
+            with ThreadPoolExecutor(self.args.concurrency) as pool:
+                start = time.perf_counter()
+                list(pool.map(self.execute, queries))
+            return time.perf_counter() - start
+
+        # recorded concurrency, issue each query at its captured offset
+        origin = queries[0].time
+        with ThreadPoolExecutor(self.args.max_clients) as pool:
+            start = time.perf_counter()
+            for q in queries:
+                delay = (q.time - origin) / self.args.speed - (time.perf_counter() - start)
+                if delay > 0:
+                    time.sleep(delay)
+                pool.submit(self.execute, q)
+        return time.perf_counter() - start
+
+
+def delta(baseline, value):
+    if baseline == 0:
+        return 0.0
+    return (value - baseline) / baseline * 100.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("captures", nargs="+", help="capture files, oldest first")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=6379)
+    parser.add_argument("--password", default=None)
+    parser.add_argument("--speed", type=float, default=1.0,
+                        help="recorded pace multiplier, 2 replays twice as fast")
+    parser.add_argument("--concurrency", type=int, default=0,
+                        help="replay with N clients issuing queries back to back "
+                             "instead of at the recorded pace")
+    parser.add_argument("--max-clients", type=int, default=64,
+                        help="max concurrent clients when replaying at the recorded pace")
+    parser.add_argument("--skip-writes", action="store_true",
+                        help="replay read only queries only")
+    parser.add_argument("--json", help="write the report to a JSON file")
+    args = parser.parse_args()
+
+    queries = [q for path in args.captures for q in read_capture(path)]
+    if args.skip_writes:
+        queries = [q for q in queries if q.flags & READONLY]
+    if not queries:
+        print("no queries to replay")
+        return 1
+    queries.sort(key=lambda q: q.time)
+
+    replayer = Replayer(args)
+    duration = replayer.run(queries)
+
+    captured = [q.latency for q in queries]
+    captured_duration = max(queries[-1].time - queries[0].time, 1e-9)
+    replayed = replayer.latencies
+
+    report = {
+        "queries": len(queries),
+        "errors": replayer.errors,
+        "row_mismatches": replayer.row_mismatches,
+        "throughput": {
+            "captured": len(queries) / captured_duration,
+            "replayed": len(queries) / max(duration, 1e-9),
+        },
+        "latency_ms": {},
+    }
+    for p in (50, 90, 99):
+        c = percentile(captured, p)
+        r = percentile(replayed, p)
+        report["latency_ms"]["p%d" % p] = {"captured": c, "replayed": r, "delta_pct": delta(c, r)}
+
+    t = report["throughput"]
+    t["delta_pct"] = delta(t["captured"], t["replayed"])
+
+    print("queries: %d, errors: %d, row mismatches: %d" %
+          (report["queries"], report["errors"], report["row_mismatches"]))
+    print("%-10s %14s %14s %10s" % ("", "captured", "replayed", "delta"))
+    print("%-10s %14.1f %14.1f %9.1f%%" % ("qps", t["captured"], t["replayed"], t["delta_pct"]))
+    for name, l in report["latency_ms"].items():
+        print("%-10s %12.3fms %12.3fms %9.1f%%" %
+              (name, l["captured"], l["replayed"], l["delta_pct"]))
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
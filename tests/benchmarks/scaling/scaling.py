@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""Measure how RedisGraph throughput scales with concurrency.
+
+A scaling spec lists the values to sweep of the THREAD_COUNT and
+OMP_THREAD_COUNT module arguments, the number of concurrent clients and the
+ratio of write queries. A server is started for each module configuration,
+loading a fresh copy of the dataset, against which redisgraph-benchmark-go
+runs every combination of clients and write ratio.
+
+Alongside throughput and client latencies, each run reports the time queries
+spent queued for a thread (INFO graph query_stages wait_total_us) and waiting
+for the graph's lock (lock_total_us) per query, and the readers / writers
+thread pools' wait percentiles since the server started.
+
+Scaling efficiency is the speedup obtained by adding reader threads, or
+clients, divided by the factor by which they were added, 1.0 being perfect
+scaling. The spec's KPIs bound it from below; the script exits non-zero
+if any run errs or a KPI is missed.
+
+Examples:
+    python3 scaling.py --module ../../../src/redisgraph.so \\
+        graph500-scale18-ef16_1hop_scaling.yml
+    python3 scaling.py --module redisgraph.so --json report.json \\
+        --threads 1,4 --clients 16 graph500-scale18-ef16_1hop_scaling.yml
+"""
+
+import argparse
+import itertools
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+import urllib.request
+
+import redis
+import yaml
+
+DATASETS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "datasets")
+
+
+def fetch_dataset(spec):
+    """Returns a local path to the spec's dataset, downloading it once."""
+    dataset = spec["dataset"]
+    if not dataset.startswith("http"):
+        return dataset
+    os.makedirs(DATASETS, exist_ok=True)
+    path = os.path.join(DATASETS, os.path.basename(dataset))
+    if not os.path.exists(path):
+        print("downloading %s" % dataset)
+        urllib.request.urlretrieve(dataset, path + ".part")
+        os.rename(path + ".part", path)
+    return path
+
+
+class Server:
+    """A redis-server loading the dataset with the given module arguments."""
+
+    def __init__(self, args, dataset, module_args, timeout):
+        self.dir = tempfile.mkdtemp(prefix="rg-scaling-")
+        shutil.copy(dataset, os.path.join(self.dir, "dump.rdb"))
+        cmd = [args.redis_server, "--port", str(args.port), "--dir", self.dir,
+               "--dbfilename", "dump.rdb", "--save", "", "--appendonly", "no",
+               "--loadmodule", os.path.abspath(args.module)]
+        for k, v in module_args.items():
+            cmd += [k, str(v)]
+        self.proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL)
+        self.conn = redis.Redis(port=args.port, decode_responses=True)
+
+        deadline = time.time() + timeout
+        while True:
+            try:
+                if self.conn.info("persistence")["loading"] == 0:
+                    break
+            except (redis.ConnectionError, redis.BusyLoadingError):
+                pass
+            if time.time() > deadline or self.proc.poll() is not None:
+                self.stop()
+                raise RuntimeError("server failed to load the dataset")
+            time.sleep(0.5)
+
+    def stats(self):
+        """Returns the module's INFO fields, without the module prefix."""
+        info = self.conn.info("graph")
+        return {k[len("graph_"):] if k.startswith("graph_") else k: v
+                for k, v in info.items()}
+
+    def stop(self):
+        try:
+            self.conn.shutdown(nosave=True)
+        except redis.ConnectionError:
+            pass
+        self.proc.wait()
+        shutil.rmtree(self.dir, ignore_errors=True)
+
+
+def run_benchmark(args, spec, clients, write_ratio, out):
+    params = spec["parameters"]
+    cmd = [args.benchmark_tool, "-p", str(args.port), "-graph-key", params["graph"],
+           "-c", str(clients), "-n", str(params["requests"]),
+           "-random-int-max", str(params["random-int-max"]),
+           "-random-seed", str(params["random-seed"]), "-json-out-file", out]
+    queries = spec["queries"]
+    if write_ratio < 1:
+        cmd += ["-query", queries["read"], "-query-ratio", str(1 - write_ratio)]
+    if write_ratio > 0:
+        cmd += ["-query", queries["write"], "-query-ratio", str(write_ratio)]
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    with open(out) as f:
+        return json.load(f)
+
+
+def measure(server, args, spec, clients, write_ratio, out):
+    before = server.stats()
+    result = run_benchmark(args, spec, clients, write_ratio, out)
+    after = server.stats()
+
+    queries = max(after["queries"] - before["queries"], 1)
+    latencies = result["OverallClientLatencies"]["Total"]
+    return {
+        "qps": result["OverallQueryRates"]["Total"],
+        "errors": result["Totals"]["Total"]["Errors"],
+        "latency_ms": {p: latencies[p] for p in ("avg", "q50", "q95", "q99")},
+        "queue_wait_avg_us": (after["wait_total_us"] - before["wait_total_us"]) / queries,
+        "lock_wait_avg_us": (after["lock_total_us"] - before["lock_total_us"]) / queries,
+        "readers_wait_p99_us": after["readers_wait_p99_us"],
+        "writers_wait_p99_us": after["writers_wait_p99_us"],
+    }
+
+
+def efficiency(runs, name, axis, fixed, cap=None):
+    """Sets 'name' to the scaling efficiency of each run relative to the run
+    with the lowest 'axis' value among those sharing the 'fixed' keys.
+    With 'cap' the added factor is bounded by that key, e.g. clients beyond
+    the number of threads add no work."""
+    groups = {}
+    for r in runs:
+        groups.setdefault(tuple(r[k] for k in fixed), []).append(r)
+
+    for group in groups.values():
+        group.sort(key=lambda r: r[axis])
+        base = group[0]
+        for r in group[1:]:
+            scale = r[axis] / base[axis]
+            if cap is not None:
+                scale = min(r[axis], r[cap]) / min(base[axis], base[cap])
+            if scale > 1 and base["qps"] > 0:
+                r[name] = (r["qps"] / base["qps"]) / scale
+
+
+def check_kpis(spec, runs):
+    kpis = spec.get("kpis", {})
+    failures = []
+    for r in runs:
+        if r["errors"] > kpis.get("errors", 0):
+            failures.append((r, "errors", r["errors"]))
+        for name in ("thread_scaling_efficiency", "client_scaling_efficiency"):
+            kpi = kpis.get(name)
+            if kpi is None or name not in r:
+                continue
+            if r["write_ratio"] > kpi.get("max_write_ratio", 1):
+                continue
+            if r[name] < kpi["min"]:
+                failures.append((r, name, r[name]))
+    return failures
+
+
+def values(override, default, cast):
+    return [cast(v) for v in override.split(",")] if override else default
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("spec", help="scaling spec yaml")
+    parser.add_argument("--module", required=True, help="path to redisgraph.so")
+    parser.add_argument("--redis-server", default="redis-server")
+    parser.add_argument("--benchmark-tool", default="redisgraph-benchmark-go")
+    parser.add_argument("--port", type=int, default=6379)
+    parser.add_argument("--threads", help="override the swept THREAD_COUNT values, e.g. 1,4")
+    parser.add_argument("--omp-threads", help="override the swept OMP_THREAD_COUNT values")
+    parser.add_argument("--clients", help="override the swept client counts")
+    parser.add_argument("--write-ratios", help="override the swept write ratios")
+    parser.add_argument("--json", help="write the report to a JSON file")
+    args = parser.parse_args()
+
+    with open(args.spec) as f:
+        spec = yaml.safe_load(f)
+    sweep = spec["sweep"]
+    threads = values(args.threads, sweep["THREAD_COUNT"], int)
+    omp_threads = values(args.omp_threads, sweep["OMP_THREAD_COUNT"], int)
+    clients = values(args.clients, sweep["clients"], int)
+    write_ratios = values(args.write_ratios, sweep["write_ratio"], float)
+
+    dataset = fetch_dataset(spec)
+    out = os.path.join(tempfile.gettempdir(), "rg-scaling-run.json")
+    runs = []
+
+    print("%7s %4s %7s %6s %10s %9s %9s %11s %10s" % ("threads", "omp", "clients",
+          "writes", "qps", "p50 ms", "p99 ms", "queue us", "lock us"))
+    for t, omp in itertools.product(threads, omp_threads):
+        # each server starts over from the dataset, writes of earlier
+        # configurations don't carry over
+        server = Server(args, dataset, {"THREAD_COUNT": t, "OMP_THREAD_COUNT": omp},
+                        spec.get("dataset_load_timeout_secs", 180))
+        try:
+            for c, w in itertools.product(clients, write_ratios):
+                r = measure(server, args, spec, c, w, out)
+                r.update({"THREAD_COUNT": t, "OMP_THREAD_COUNT": omp,
+                          "clients": c, "write_ratio": w})
+                runs.append(r)
+                print("%7d %4d %7d %6.2f %10.1f %9.3f %9.3f %11.1f %10.1f" %
+                      (t, omp, c, w, r["qps"], r["latency_ms"]["q50"],
+                       r["latency_ms"]["q99"], r["queue_wait_avg_us"],
+                       r["lock_wait_avg_us"]))
+        finally:
+            server.stop()
+
+    # adding threads is measured at the highest client count
+    # adding clients is measured per thread count, up to that count
+    top = max(clients)
+    efficiency([r for r in runs if r["clients"] == top], "thread_scaling_efficiency",
+               "THREAD_COUNT", ("OMP_THREAD_COUNT", "write_ratio"))
+    efficiency(runs, "client_scaling_efficiency", "clients",
+               ("THREAD_COUNT", "OMP_THREAD_COUNT", "write_ratio"),
+               cap="THREAD_COUNT")
+
+    failures = check_kpis(spec, runs)
+    for r, name, value in failures:
+        print("KPI missed: %s = %.3f (threads %d, omp %d, clients %d, writes %.2f)" %
+              (name, value, r["THREAD_COUNT"], r["OMP_THREAD_COUNT"],
+               r["clients"], r["write_ratio"]))
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"name": spec["name"], "runs": runs}, f, indent=2)
+
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,68 @@
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "adaptive_transpose"
+redis_con = None
+redis_graph = None
+
+class testAdaptiveTranspose(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='ADAPTIVE_TRANSPOSE yes')
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # a chain of 10 nodes connected by R edges
+        # with an additional S edge parallel to every other R edge
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE b.v = a.v + 1 CREATE (a)-[:R]->(b)")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE b.v = a.v + 1 AND a.v % 2 = 0 CREATE (a)-[:S]->(b)")
+
+    def transposed_memory(self):
+        res = redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID)
+        return dict(zip(res[::2], res[1::2]))["matrices_transposed"]
+
+    def incoming(self, v):
+        query = "MATCH (b:N {v: %d})<-[:R]-(a) RETURN a.v" % v
+        return redis_graph.query(query).result_set
+
+    def test01_forward_traversal(self):
+        # forward traversals don't require the transpose
+        before = self.transposed_memory()
+        query = "MATCH (a:N {v: 0})-[:R*]->(b) RETURN count(b)"
+        self.env.assertEquals(redis_graph.query(query).result_set[0][0], 9)
+        self.env.assertEquals(self.transposed_memory(), before)
+
+    def test02_reverse_traversal(self):
+        # the first reverse traversal builds the transpose
+        before = self.transposed_memory()
+        self.env.assertEquals(self.incoming(5), [[4]])
+        self.env.assertGreater(self.transposed_memory(), before)
+
+        query = "MATCH (a:N {v: 9})<-[:R*]-(b) RETURN count(b)"
+        self.env.assertEquals(redis_graph.query(query).result_set[0][0], 9)
+
+    def test03_edge_updates(self):
+        # once built, the transpose is maintained by edge updates
+        redis_graph.query("MATCH (a:N {v: 9}), (b:N {v: 5}) CREATE (a)-[:R]->(b)")
+        self.env.assertEquals(sorted(self.incoming(5)), [[4], [9]])
+
+        redis_graph.query("MATCH (:N {v: 4})-[e:R]->(:N {v: 5}) DELETE e")
+        self.env.assertEquals(self.incoming(5), [[9]])
+
+        # relationship type S was never traversed in reverse
+        query = "MATCH (a:N)<-[:S]-(b:N) RETURN count(b)"
+        self.env.assertEquals(redis_graph.query(query).result_set[0][0], 5)
+
+    def test04_persistence(self):
+        # decoded relation matrices are built without their transpose
+        self.env.dumpAndReload()
+        self.env.assertEquals(self.incoming(5), [[9]])
+
+        query = "MATCH (a:N)<-[:S]-(b:N) RETURN count(b)"
+        self.env.assertEquals(redis_graph.query(query).result_set[0][0], 5)
@@ -0,0 +1,76 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "async_index"
+NODE_COUNT = 50000
+redis_graph = None
+
+class testAsyncIndex(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='ASYNC_INDEX_THRESHOLD 1000')
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    # wait for the index utilized by 'query' to be populated
+    def wait_for_index(self, query, op='Index Scan'):
+        for _ in range(1000):
+            if op in redis_graph.execution_plan(query):
+                return
+            time.sleep(0.01)
+        self.env.assertTrue(False)
+
+    def test01_node_index(self):
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:L {v: x})" % (NODE_COUNT - 1))
+
+        result = redis_graph.query("CREATE INDEX ON :L(v)")
+        self.env.assertEquals(result.indices_created, 1)
+
+        # modify the graph while the index is being populated
+        redis_graph.query("MATCH (n:L) WHERE n.v = 10 SET n.v = -10")
+        redis_graph.query("CREATE (:L {v: %d})" % NODE_COUNT)
+        redis_graph.query("MATCH (n:L) WHERE n.v = 20 DELETE n")
+
+        query = "MATCH (n:L) WHERE n.v IN [-10, 10, 20, 30, %d] RETURN n.v ORDER BY n.v" % NODE_COUNT
+        # results are correct regardless of the index being populated
+        self.env.assertEquals(redis_graph.query(query).result_set,
+                              [[-10], [30], [NODE_COUNT]])
+
+        self.wait_for_index(query)
+        self.env.assertEquals(redis_graph.query(query).result_set,
+                              [[-10], [30], [NODE_COUNT]])
+
+        query = "MATCH (n:L) WHERE n.v >= 0 RETURN count(n)"
+        self.wait_for_index(query)
+        self.env.assertEquals(redis_graph.query(query).result_set, [[NODE_COUNT - 1]])
+
+    def test02_drop_while_populating(self):
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:D {v: x})" % (NODE_COUNT - 1))
+        redis_graph.query("CREATE INDEX ON :D(v)")
+        result = redis_graph.query("DROP INDEX ON :D(v)")
+        self.env.assertEquals(result.indices_deleted, 1)
+
+        # recreate the index, earlier population must not interfere
+        redis_graph.query("CREATE INDEX ON :D(v)")
+        query = "MATCH (n:D) WHERE n.v < 100 RETURN count(n)"
+        self.wait_for_index(query)
+        self.env.assertEquals(redis_graph.query(query).result_set, [[100]])
+
+    def test03_edge_index(self):
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:S)-[:R {v: x}]->(:T)" % (NODE_COUNT - 1))
+        redis_graph.query("CREATE INDEX FOR ()-[r:R]-() ON (r.v)")
+
+        query = "MATCH ()-[r:R]->() WHERE r.v < 100 RETURN count(r)"
+        self.wait_for_index(query, 'Edge By Index Scan')
+        self.env.assertEquals(redis_graph.query(query).result_set, [[100]])
+
+    def test04_small_label_populated_inline(self):
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:Small {v: x})")
+        redis_graph.query("CREATE INDEX ON :Small(v)")
+
+        query = "MATCH (n:Small) WHERE n.v > 4 RETURN count(n)"
+        self.env.assertIn('Index Scan', redis_graph.execution_plan(query))
+        self.env.assertEquals(redis_graph.query(query).result_set, [[5]])
@@ -181,3 +181,30 @@ class testBFS(FlowTestsBase):
         actual_result = graph.query(query)
         expected_result = [[['b'], ['e']]]
         self.env.assertEquals(actual_result.result_set, expected_result)
+
+    # Test BFS searching for a path to a given destination
+    def test08_bfs_destination(self):
+        query = """MATCH (a {v: 'a'}), (e {v: 'e'}) CALL algo.BFS(a, 0, NULL, e) YIELD nodes, edges RETURN [n IN nodes | n.v], [e IN edges | e.v]"""
+        actual_result = graph.query(query)
+        expected_result = [[['b', 'd', 'e'], ['b', 'd', 'e']]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        query = """MATCH (a {v: 'a'}), (c {v: 'c'}) CALL algo.BFS(a, 0, 'E1', c) YIELD nodes RETURN [n IN nodes | n.v]"""
+        actual_result = graph.query(query)
+        expected_result = [[['b', 'c']]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # destination is only reachable via E2 edges
+        query = """MATCH (a {v: 'a'}), (e {v: 'e'}) CALL algo.BFS(a, 0, 'E1', e) YIELD nodes"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [])
+
+        # destination is beyond max level
+        query = """MATCH (a {v: 'a'}), (e {v: 'e'}) CALL algo.BFS(a, 2, NULL, e) YIELD nodes"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [])
+
+        # edges are not traversed backwards
+        query = """MATCH (a {v: 'a'}), (e {v: 'e'}) CALL algo.BFS(e, 0, NULL, a) YIELD nodes"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [])
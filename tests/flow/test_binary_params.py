@@ -0,0 +1,98 @@
+import os
+import sys
+import struct
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "binary_params"
+redis_con = None
+graph = None
+
+# minimal MessagePack encoder covering the types accepted as parameters
+def pack(v):
+    if v is None:
+        return b'\xc0'
+    if isinstance(v, bool):
+        return b'\xc3' if v else b'\xc2'
+    if isinstance(v, int):
+        return b'\xd3' + struct.pack('>q', v)
+    if isinstance(v, float):
+        return b'\xcb' + struct.pack('>d', v)
+    if isinstance(v, str):
+        b = v.encode('utf-8')
+        return b'\xdb' + struct.pack('>I', len(b)) + b
+    if isinstance(v, list):
+        return b'\xdd' + struct.pack('>I', len(v)) + b''.join(pack(x) for x in v)
+    if isinstance(v, dict):
+        return b'\xdf' + struct.pack('>I', len(v)) + \
+            b''.join(pack(k) + pack(x) for k, x in v.items())
+    raise TypeError(type(v))
+
+class testBinaryParams(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global graph
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        graph.query("UNWIND range(1, 10) AS i CREATE (:N {v: i, name: 'n' + tostring(i)})")
+
+    def test01_scalars(self):
+        params = {'min': 7, 'name': 'n2', 'd': 2.5, 'b': True, 'nil': None}
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID,
+                "RETURN $min, $name, $d, $b, $nil", "params", pack(params))
+        self.env.assertEquals(res[1], [[7, 'n2', '2.5', 'true', None]])
+
+    def test02_matches_cypher_header(self):
+        q = "MATCH (n:N) WHERE n.v > $min OR n.name IN $names RETURN n.v ORDER BY n.v"
+        params = {'min': 8, 'names': ['n1', 'n3']}
+        expected = graph.query(q, params).result_set
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, q,
+                "params", pack(params), "--compact")
+        self.env.assertEquals([row[0][1] for row in res[1]], [r[0] for r in expected])
+
+    def test03_nested(self):
+        params = {'m': {'a': [1, 2], 'b': 'x'}}
+        res = redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID,
+                "RETURN $m.a[1], $m.b", "params", pack(params))
+        self.env.assertEquals(res[1], [[2, 'x']])
+
+    def test04_header_precedence(self):
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID,
+                "CYPHER x=1 RETURN $x, $y", "params", pack({'x': 2, 'y': 3}))
+        self.env.assertEquals(res[1], [[1, 3]])
+
+    def test05_write(self):
+        res = redis_con.execute_command("GRAPH.QUERY", GRAPH_ID,
+                "CREATE (:M {v: $v}) RETURN 1", "params", pack({'v': 42}))
+        res = graph.query("MATCH (m:M) RETURN m.v")
+        self.env.assertEquals(res.result_set, [[42]])
+
+    def test06_errors(self):
+        # missing value
+        try:
+            redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "RETURN $x", "params")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("parameters", str(e))
+
+        # not a map
+        try:
+            redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "RETURN $x",
+                    "params", pack([1]))
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("invalid binary parameters", str(e))
+
+        # trailing bytes
+        try:
+            redis_con.execute_command("GRAPH.QUERY", GRAPH_ID, "RETURN $x",
+                    "params", pack({'x': 1}) + b'\x01')
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("invalid binary parameters", str(e))
@@ -2,6 +2,7 @@
 import os
 import sys
 import csv
+import struct
 import time
 import redis
 import threading
@@ -18,6 +19,22 @@ redis_con = None
 port = None
 redis_graph = None
 
+# binary stream encoding, see docs/bulk_spec.md
+def header(label, props):
+    h = label.encode() + b'\x00' + struct.pack('<I', len(props))
+    for p in props:
+        h += p.encode() + b'\x00'
+    return h
+
+def long_prop(v):
+    return b'\x04' + struct.pack('<q', v)
+
+def str_prop(v):
+    return b'\x03' + v.encode() + b'\x00'
+
+def array_prop(vs):
+    return b'\x05' + struct.pack('<q', len(vs)) + b''.join(long_prop(v) for v in vs)
+
 def run_bulk_loader(graphname, filename):
     runner = CliRunner()
     runner.invoke(bulk_insert, ['--port', port,
@@ -719,3 +736,153 @@ class testGraphBulkInsertFlow(FlowTestsBase):
             query_result = graph.query(q)
             self.env.assertEquals(query_result.result_set, expected_result)
 
+
+    # Verify that a single GRAPH.BULK call carrying multiple node and
+    # relation tokens, each spanning several decoding morsels,
+    # assigns IDs in stream order
+    def test12_multiple_tokens(self):
+        graphname = "tmpgraph9"
+
+        nodes_per_token = 5000
+        node_tokens = []
+        for t in range(2):
+            token = header('N%d' % t, ['v', 's'])
+            for i in range(nodes_per_token):
+                v = t * nodes_per_token + i
+                token += long_prop(v) + str_prop('str%d' % (v % 7))
+            node_tokens.append(token)
+
+        node_count = 2 * nodes_per_token
+        edge_token = header('R', ['w'])
+        for i in range(node_count):
+            edge_token += struct.pack('<QQ', i, (i + 1) % node_count)
+            edge_token += array_prop([i, i])
+        # multiple edges connecting the same pair of nodes
+        edge_token += struct.pack('<QQ', 0, 1) + array_prop([-1])
+        edge_count = node_count + 1
+
+        res = redis_con.execute_command("GRAPH.BULK", graphname, "BEGIN",
+                node_count, edge_count, 2, 1, *node_tokens, edge_token)
+        self.env.assertEquals(res, "%d nodes created, %d edges created" %
+                (node_count, edge_count))
+
+        graph = Graph(graphname, redis_con)
+
+        q = "MATCH (n) WHERE id(n) <> n.v OR n.s <> 'str' + toString(n.v % 7) RETURN count(n)"
+        self.env.assertEquals(graph.query(q).result_set, [[0]])
+
+        q = "MATCH (n:N1) RETURN min(id(n)), max(id(n))"
+        self.env.assertEquals(graph.query(q).result_set,
+                [[nodes_per_token, node_count - 1]])
+
+        q = "MATCH (a)-[e:R]->(b) WHERE id(e) < $n AND (e.w <> [id(a), id(a)] OR id(e) <> id(a) OR id(b) <> (id(a) + 1) % $n) RETURN count(e)"
+        self.env.assertEquals(graph.query(q, {'n': node_count}).result_set, [[0]])
+
+        q = "MATCH ({v: 0})-[e:R]->({v: 1}) RETURN e.w ORDER BY id(e)"
+        self.env.assertEquals(graph.query(q).result_set, [[[0, 0]], [[-1]]])
+
+    # Verify that GRAPH.IMPORT reads node and relation files
+    # and fails without creating the graph on invalid input
+    def test13_import_files(self):
+        graphname = "tmpgraph10"
+        node_path = "/tmp/import_nodes.bin"
+        edge_path = "/tmp/import_edges.bin"
+
+        node_count = 1000
+        with open(node_path, 'wb') as f:
+            f.write(header('Person', ['v', 's']))
+            for i in range(node_count):
+                f.write(long_prop(i) + str_prop('p%d' % i))
+
+        with open(edge_path, 'wb') as f:
+            f.write(header('KNOWS', ['w']))
+            for i in range(node_count):
+                f.write(struct.pack('<QQ', i, (i + 1) % node_count))
+                f.write(array_prop([i]))
+
+        # no import in progress
+        self.env.assertEquals(redis_con.execute_command("GRAPH.IMPORT",
+            graphname, "STATUS"), None)
+
+        res = redis_con.execute_command("GRAPH.IMPORT", graphname,
+                "NODES", node_path, "RELATIONS", edge_path)
+        self.env.assertEquals(res, "%d nodes created, %d edges created" %
+                (node_count, node_count))
+
+        graph = Graph(graphname, redis_con)
+        q = "MATCH (a:Person)-[e:KNOWS]->(b:Person) WHERE id(a) <> a.v OR a.s <> 'p' + toString(a.v) OR e.w <> [a.v] OR b.v <> (a.v + 1) % $n RETURN count(e)"
+        self.env.assertEquals(graph.query(q, {'n': node_count}).result_set, [[0]])
+        q = "MATCH (a:Person)-[e:KNOWS]->() RETURN count(a), count(e)"
+        self.env.assertEquals(graph.query(q).result_set, [[node_count, node_count]])
+
+        # graph key already exists
+        try:
+            redis_con.execute_command("GRAPH.IMPORT", graphname, "NODES", node_path)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("already exists", str(e))
+
+        # missing file
+        try:
+            redis_con.execute_command("GRAPH.IMPORT", "import_missing",
+                    "NODES", "/tmp/no_such_import_file.bin")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Failed to open", str(e))
+        self.env.assertEquals(redis_con.exists("import_missing"), 0)
+
+        # truncated entity
+        with open(node_path, 'wb') as f:
+            f.write(header('Person', ['v']))
+            f.write(long_prop(0) + long_prop(1)[:5])
+        try:
+            redis_con.execute_command("GRAPH.IMPORT", "import_truncated",
+                    "NODES", node_path)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Truncated entity", str(e))
+        self.env.assertEquals(redis_con.exists("import_truncated"), 0)
+
+        os.remove(node_path)
+        os.remove(edge_path)
+
+    # Verify that GRAPH.EXPORT writes files which GRAPH.IMPORT
+    # reconstructs the graph from
+    def test14_export_files(self):
+        export_dir = "/tmp/graph_export"
+        os.makedirs(export_dir, exist_ok=True)
+
+        src = Graph("export_src", redis_con)
+        src.query("""UNWIND range(0, 99) AS i
+                     CREATE (:A {v: i, s: 'a' + toString(i)}), (:A:B {v: 100 + i, l: [i, 'x']}), ({v: 200 + i})""")
+        src.query("""MATCH (a:A), (b {v: a.v + 200}) WHERE NOT a:B
+                     CREATE (a)-[:R {w: a.v}]->(b), (a)-[:R]->(b), (b)-[:S {d: 0.5}]->(a)""")
+
+        res = redis_con.execute_command("GRAPH.EXPORT", "export_src", export_dir)
+        self.env.assertEquals(res[0::2], ["NODES", "NODES", "NODES", "RELATIONS", "RELATIONS"])
+        with open(os.path.join(export_dir, "manifest")) as f:
+            self.env.assertEquals([l.split() for l in f.read().splitlines()],
+                    [list(p) for p in zip(res[0::2], res[1::2])])
+
+        res = redis_con.execute_command("GRAPH.IMPORT", "export_dst", *res)
+        self.env.assertEquals(res, "300 nodes created, 300 edges created")
+
+        # node IDs are reassigned, compare entities by their properties
+        dst = Graph("export_dst", redis_con)
+        queries = ["MATCH (n) RETURN labels(n), properties(n)",
+                   "MATCH (a)-[e]->(b) RETURN a.v, type(e), properties(e), b.v"]
+        for q in queries:
+            expected = sorted(src.query(q).result_set, key=str)
+            actual = sorted(dst.query(q).result_set, key=str)
+            self.env.assertEquals(actual, expected)
+
+        # missing directory
+        try:
+            redis_con.execute_command("GRAPH.EXPORT", "export_src", "/tmp/no_such_export_dir")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("isn't writable", str(e))
+
+        for f in os.listdir(export_dir):
+            os.remove(os.path.join(export_dir, f))
+        os.rmdir(export_dir)
@@ -245,3 +245,88 @@ class testCache(FlowTestsBase):
         cached_result = graph.query(query, params)
         self.env.assertEqual(expected_result, cached_result.result_set)
         self.env.assertTrue(cached_result.cached_execution)
+
+    def test13_auto_parameterize(self):
+        # Queries which differ only by their literals should share
+        # a cached execution plan once auto-parameterization is enabled.
+        graph = Graph('Cache_Auto_Parameterize', redis_con)
+        graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x, s: toString(x)})")
+
+        # Disabled by default, each literal yields a new cache entry.
+        result = graph.query("CALL db.cache.stats() YIELD autoParameterize")
+        self.env.assertFalse(result.result_set[0][0])
+        graph.query("MATCH (n:N) WHERE n.v = 1 RETURN n.v")
+        result = graph.query("MATCH (n:N) WHERE n.v = 2 RETURN n.v")
+        self.env.assertFalse(result.cached_execution)
+
+        graph.query("CALL db.cache.autoParameterize(true)")
+
+        query = "MATCH (n:N {s: '%d'}) WHERE n.v >= %d RETURN n.v, 10 ORDER BY n.v LIMIT 1"
+        result = graph.query(query % (3, 3))
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.header[1][1], '10')
+        self.env.assertEqual(result.result_set, [[3, 10]])
+
+        # Same shape, different literals, served from cache.
+        result = graph.query(query % (7, 4))
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[7, 10]])
+
+        # Literals mixed with user provided parameters.
+        query = "MATCH (n:N) WHERE n.v > $min AND n.v < %d RETURN count(n)"
+        result = graph.query(query % 5, {'min': 1})
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[3]])
+        result = graph.query(query % 9, {'min': 6})
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[2]])
+
+        # ID lookups are resolved at plan construction, never lifted.
+        graph.query("MATCH (n) WHERE id(n) = 1 RETURN n")
+        result = graph.query("MATCH (n) WHERE id(n) = 2 RETURN n.v")
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[2]])
+
+        # Counters are exposed, the stats call itself is a cache lookup.
+        before = graph.query("CALL db.cache.stats() YIELD hits, misses").result_set[0]
+        graph.query("MATCH (n:N) WHERE n.v = 8 RETURN n.v")
+        graph.query("MATCH (n:N) WHERE n.v = 9 RETURN n.v")
+        after = graph.query("CALL db.cache.stats() YIELD hits, misses").result_set[0]
+        self.env.assertEqual(after[0] - before[0], 2)
+        self.env.assertEqual(after[1] - before[1], 1)
+
+        graph.query("CALL db.cache.autoParameterize(false)")
+        result = graph.query("MATCH (n:N) WHERE n.v = 5 RETURN n.v")
+        self.env.assertFalse(result.cached_execution)
+
+        graph.delete()
+
+    def test14_param_type_signature(self):
+        # Plans are cached per parameter type signature,
+        # a plan built for one type is never reused for another.
+        graph = Graph('Cache_Param_Types', redis_con)
+        graph.query("CREATE INDEX ON :N(val)")
+        graph.query("UNWIND range(0, 4) AS x CREATE (:N {val: x})")
+
+        query = "MATCH (n:N) WHERE n.val = $v RETURN n.val"
+        result = graph.query(query, {'v': 1})
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[1]])
+
+        result = graph.query(query, {'v': 2})
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[2]])
+
+        # list values can't be resolved by the index
+        result = graph.query(query, {'v': [3]})
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [])
+
+        result = graph.query(query, {'v': 'a'})
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [])
+
+        result = graph.query(query, {'v': 3})
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[3]])
+        graph.delete()
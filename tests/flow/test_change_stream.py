@@ -0,0 +1,51 @@
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "change_stream"
+STREAM_KEY = GRAPH_ID + ":changes"
+redis_con = None
+redis_graph = None
+
+class testChangeStream(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='CHANGE_STREAM_LENGTH 1000')
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def entries(self):
+        return [fields for _, fields in redis_con.xrange(STREAM_KEY)]
+
+    def test01_commits_are_streamed(self):
+        redis_graph.query("UNWIND range(1, 3) AS x CREATE (:N {v: x})")
+        redis_graph.query("MATCH (n:N {v: 1}) SET n.v = 10")
+        redis_graph.query("MATCH (n:N {v: 2}) DELETE n")
+
+        entries = self.entries()
+        self.env.assertEquals(len(entries), 3)
+
+        # a single entry per commit, in commit order
+        seqs = [int(e['seq']) for e in entries]
+        self.env.assertEquals(seqs, sorted(seqs))
+
+        self.env.assertEquals(entries[0]['nodes_created'], '3')
+        self.env.assertEquals(entries[0]['labels_added'], '1')
+        self.env.assertEquals(entries[1]['properties_set'], '1')
+        self.env.assertEquals(entries[2]['nodes_deleted'], '1')
+
+    def test02_reads_are_not_streamed(self):
+        redis_graph.query("MATCH (n) RETURN n")
+        redis_graph.query("MATCH (n:N {v: 100}) SET n.v = 1")
+        self.env.assertEquals(len(self.entries()), 3)
+
+    def test03_disable_stream(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "CHANGE_STREAM_LENGTH", 0)
+        redis_graph.query("CREATE (:N {v: 4})")
+        self.env.assertEquals(len(self.entries()), 3)
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "CHANGE_STREAM_LENGTH", 1000)
+        redis_graph.query("CREATE (:N {v: 5})")
+        self.env.assertEquals(len(self.entries()), 4)
@@ -0,0 +1,46 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "compile"
+redis_con = None
+redis_graph = None
+
+class testCompile(FlowTestsBase):
+    def __init__(self):
+        # compile plans from their second execution onwards
+        self.env = Env(decodeResponses=True, moduleArgs='COMPILE_THRESHOLD 2')
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 20) AS x CREATE (:N {v: x, g: x % 3, name: 'n' + toString(x)})")
+
+    def compare(self, query):
+        # first execution is interpreted, later executions are compiled
+        expected = redis_graph.query(query).result_set
+        for i in range(3):
+            res = redis_graph.query(query)
+            self.env.assertTrue(res.cached_execution)
+            self.env.assertEquals(res.result_set, expected)
+        return expected
+
+    def test01_project(self):
+        res = self.compare("MATCH (n:N) WHERE n.v < 4 RETURN n.v, n.name, n.missing, 1, n ORDER BY n.v")
+        self.env.assertEquals(len(res), 3)
+        self.env.assertEquals(res[0][:4], [1, 'n1', None, 1])
+
+        self.compare("MATCH (n:N) WITH n.v AS v, n.v * 2 AS w WHERE v > 18 RETURN v, w ORDER BY v")
+
+    def test02_aggregate(self):
+        res = self.compare("MATCH (n:N) RETURN n.g, sum(n.v), count(n), avg(n.v) ORDER BY n.g")
+        self.env.assertEquals(res[0][:3], [0, 63, 6])
+
+        self.compare("MATCH (n:N) RETURN n.g AS g, collect(n.name) AS names ORDER BY g")
+        self.compare("MATCH (n:N) RETURN sum(n.v) + max(n.v), min(n.missing)")
+
+    def test03_disabled(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "COMPILE_THRESHOLD", 0)
+        res = self.compare("MATCH (n:N) RETURN n.g, sum(n.v) ORDER BY n.g")
+        self.env.assertEquals(res[0], [0, 63])
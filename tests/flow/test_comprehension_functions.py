@@ -368,3 +368,39 @@ class testComprehensionFunctions(FlowTestsBase):
                            ['v2', ['v3']],
                            ['v3', []]]
         self.env.assertEquals(actual_result.result_set, expected_result)
+
+    def test19_predicates_over_local_and_outer_values(self):
+        # predicates referencing only the local variable
+        query = """WITH ['a', 'spam', 'b'] AS tags
+                   RETURN all(x IN tags WHERE x <> 'spam'),
+                          any(x IN tags WHERE x = 'spam'),
+                          single(x IN tags WHERE x = 'spam'),
+                          none(x IN tags WHERE x = 'c'),
+                          [x IN tags WHERE x <> 'spam' | x + '!']"""
+        actual_result = redis_graph.query(query)
+        expected_result = [[False, True, True, True, ['a!', 'b!']]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # predicates referencing outer values, which change between records
+        query = """UNWIND [1, 2, 3] AS y
+                   WITH y, [1, 2, 3, 4] AS arr
+                   RETURN y,
+                          all(x IN arr WHERE x >= y),
+                          single(x IN arr WHERE x = y),
+                          [x IN arr WHERE x > y | x * y]
+                   ORDER BY y"""
+        actual_result = redis_graph.query(query)
+        expected_result = [[1, True, True, [2, 3, 4]],
+                           [2, False, True, [6, 8]],
+                           [3, False, True, [12]]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # nested comprehension referencing an outer value
+        query = """UNWIND [1, 2] AS y
+                   WITH y, [[1, 2], [2, 3]] AS arr
+                   RETURN y, [l IN arr WHERE any(x IN l WHERE x = y)]
+                   ORDER BY y"""
+        actual_result = redis_graph.query(query)
+        expected_result = [[1, [[1, 2]]],
+                           [2, [[1, 2], [2, 3]]]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
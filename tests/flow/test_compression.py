@@ -0,0 +1,87 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "compression"
+redis_con = None
+redis_graph = None
+
+TEXT = "the quick brown fox jumps over the lazy dog " * 20
+
+class testCompression(FlowTestsBase):
+    def __init__(self):
+        # strings of 256 bytes or more are stored compressed
+        self.env = Env(decodeResponses=True, moduleArgs='COMPRESSION_THRESHOLD 256')
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 100) AS x CREATE (:Review {id: x, text: $text + toString(x), short: 'r' + toString(x)})",
+                          {'text': TEXT})
+
+    def properties_size(self):
+        res = redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID)
+        return dict(zip(res[::2], res[1::2]))["properties"]
+
+    def test01_read(self):
+        res = redis_graph.query("MATCH (r:Review {id: 7}) RETURN r.text, r.short, size(r.text)").result_set
+        self.env.assertEquals(res[0], [TEXT + '7', 'r7', len(TEXT) + 1])
+
+        res = redis_graph.query("MATCH (r:Review) WHERE r.text ENDS WITH '42' RETURN r.id").result_set
+        self.env.assertEquals(res, [[42]])
+
+        # values read through the whole entity
+        res = redis_graph.query("MATCH (r:Review {id: 3}) RETURN r, properties(r)").result_set
+        self.env.assertEquals(res[0][0].properties['text'], TEXT + '3')
+        self.env.assertEquals(res[0][1]['text'], TEXT + '3')
+
+    def test02_memory(self):
+        # text is stored in far fewer bytes than its length
+        self.env.assertLess(self.properties_size(), 100 * len(TEXT) / 2)
+
+    def test03_update(self):
+        redis_graph.query("MATCH (r:Review {id: 1}) SET r.text = $text + 'updated'", {'text': TEXT})
+        res = redis_graph.query("MATCH (r:Review {id: 1}) RETURN r.text").result_set
+        self.env.assertEquals(res[0][0], TEXT + 'updated')
+
+        # copying a compressed value between entities
+        redis_graph.query("MATCH (a:Review {id: 2}), (b:Review {id: 3}) SET b.text = a.text")
+        res = redis_graph.query("MATCH (r:Review {id: 3}) RETURN r.text").result_set
+        self.env.assertEquals(res[0][0], TEXT + '2')
+        redis_graph.query("MATCH (r:Review {id: 3}) SET r.text = $text + '3'", {'text': TEXT})
+
+    def test04_index(self):
+        redis_graph.query("CREATE INDEX FOR (r:Review) ON (r.text)")
+        res = redis_graph.query("MATCH (r:Review) WHERE r.text = $text RETURN r.id", {'text': TEXT + '50'}).result_set
+        self.env.assertEquals(res, [[50]])
+
+    def test05_reload(self):
+        expected = redis_graph.query("MATCH (r:Review) RETURN r.id, r.text ORDER BY r.id").result_set
+        size = self.properties_size()
+
+        # values are persisted compressed
+        self.env.dumpAndReload()
+        res = redis_graph.query("MATCH (r:Review) RETURN r.id, r.text ORDER BY r.id").result_set
+        self.env.assertEquals(res, expected)
+        self.env.assertEquals(self.properties_size(), size)
+
+    def test06_disabled(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "COMPRESSION_THRESHOLD", 0)
+        size = self.properties_size()
+        redis_graph.query("CREATE (:Review {id: 1000, text: $text})", {'text': TEXT})
+        self.env.assertGreater(self.properties_size(), size + len(TEXT))
+
+        res = redis_graph.query("MATCH (r:Review {id: 1000}) RETURN r.text").result_set
+        self.env.assertEquals(res[0][0], TEXT)
+
+    def test07_held_values(self):
+        # values held by records outlive the thread's decompressed copies
+        res = redis_graph.query("MATCH (r:Review) WHERE r.id > 1 AND r.id <= 100 RETURN r.id, r.text ORDER BY r.text DESC").result_set
+        self.env.assertEquals(len(res), 99)
+        for row in res:
+            self.env.assertEquals(row[1], TEXT + str(row[0]))
+
+        res = redis_graph.query("MATCH (r:Review) WHERE r.id > 1 AND r.id <= 100 RETURN collect(r {.id, .text}) AS c").result_set
+        for m in res[0][0]:
+            self.env.assertEquals(m['text'], TEXT + str(m['id']))
@@ -1,3 +1,4 @@
+import time
 from RLTest import Env
 from base import FlowTestsBase
 from redis import ResponseError
@@ -333,3 +334,77 @@ class testConcurrentQueryFlow(FlowTestsBase):
         # delete the key
         self.conn.delete(GRAPH_ID)
 
+
+    def test_11_concurrent_batched_writes(self):
+        # concurrent writes share commits
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "WRITE_BATCH_SIZE", 8)
+
+        queries = ["CREATE (:B {v: %d})" % i for i in range(CLIENT_COUNT)]
+        results = run_concurrent(queries, thread_run_query)
+
+        # each client receives its own reply
+        for result in results:
+            self.env.assertEquals(result["nodes_created"], 1)
+            self.env.assertEquals(result["properties_set"], 1)
+
+        result = self.graph.query("MATCH (n:B) RETURN count(n), sum(n.v)")
+        expected = [[CLIENT_COUNT, sum(range(CLIENT_COUNT))]]
+        self.env.assertEquals(result.result_set, expected)
+
+        # restore default
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "WRITE_BATCH_SIZE", 1)
+        self.conn.delete(GRAPH_ID)
+
+    def test_12_concurrent_reads_background_compaction(self):
+        # compact matrices in the background as soon as possible
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_COMPACTION_RATIO", 1)
+
+        self.graph.query("UNWIND range(0, 999) AS x CREATE (:C {v: x})-[:R]->(:C)")
+        self.graph.query("MATCH (a:C)-[e:R]->() WHERE a.v % 2 = 0 DELETE e")
+
+        # read while pending changes are being compacted
+        queries = ["MATCH (:C)-[e:R]->(:C) RETURN count(e)"] * CLIENT_COUNT * 4
+        results = run_concurrent(queries, thread_run_query)
+        for result in results:
+            self.env.assertEquals(result["result_set"], [[500]])
+
+        # allow for the graph to go idle and be compacted
+        time.sleep(2.5)
+
+        result = self.graph.query("MATCH (:C)-[e:R]->(:C) RETURN count(e)")
+        self.env.assertEquals(result.result_set, [[500]])
+        result = self.graph.query("MATCH (a:C)-[:R]->() RETURN sum(a.v % 2)")
+        self.env.assertEquals(result.result_set, [[500]])
+
+        # restore default
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_COMPACTION_RATIO", 50)
+        self.conn.delete(GRAPH_ID)
+
+    def test_13_commit_under_steady_reads(self):
+        # a writer acquiring the GIL and the graph's write lock
+        # must not be starved by a steady stream of readers
+        self.graph = Graph(GRAPH_ID, self.conn)
+        self.graph.query("UNWIND range(0, 999) AS x CREATE (:D {v: x})")
+
+        readers_pool = Pool(nodes=CLIENT_COUNT)
+        Rq = "MATCH (a:D), (b:D) WHERE a.v < 100 RETURN count(b)"
+        queries = [Rq] * CLIENT_COUNT * 20
+        nulls = [None] * CLIENT_COUNT * 20
+        readers = readers_pool.amap(thread_run_query, queries, nulls)
+
+        # issue a write while reads are in flight
+        time.sleep(0.5)
+        writer_pool = Pool(nodes=1)
+        Wq = "CREATE (:D {v: 1000})"
+        writer = writer_pool.apipe(thread_run_query, Wq, None)
+
+        # the write completes while readers keep arriving
+        result = writer.get(timeout=30)
+        self.env.assertEquals(result["nodes_created"], 1)
+
+        # readers observe the graph either before or after the write
+        for result in readers.get():
+            self.env.assertIn(result["result_set"][0][0], [100 * 1000, 100 * 1001])
+
+        # delete the key
+        self.conn.delete(GRAPH_ID)
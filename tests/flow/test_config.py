@@ -90,9 +90,9 @@ class testConfig(FlowTestsBase):
         prev_conf = redis_con.execute_command("GRAPH.CONFIG GET *")
 
         try:
-            # Set multiple configuration values, THREAD_COUNT is NOT
+            # Set multiple configuration values, CACHE_SIZE is NOT
             # a runtime configuration, expecting this command to fail
-            response = redis_con.execute_command("GRAPH.CONFIG SET QUERY_MEM_CAPACITY 150 THREAD_COUNT 40")
+            response = redis_con.execute_command("GRAPH.CONFIG SET QUERY_MEM_CAPACITY 150 CACHE_SIZE 40")
             assert(False)
         except redis.exceptions.ResponseError as e:
             # Expecting an error.
@@ -246,4 +246,88 @@ class testConfig(FlowTestsBase):
         # Make sure config been updated.
         response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
         expected_response = [config_name, config_value]
-        self.env.assertEqual(response, expected_response)
\ No newline at end of file
+        self.env.assertEqual(response, expected_response)
+
+    def test10_set_get_huge_pages(self):
+        config_name = "HUGE_PAGES"
+
+        # huge pages are disabled by default
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        self.env.assertEqual(response, [config_name, 0])
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s yes" % config_name)
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        self.env.assertEqual(response, [config_name, 1])
+
+        # large allocations are advised to use huge pages
+        g = Graph("huge_pages", redis_con)
+        g.query("UNWIND range(0, 200000) AS x CREATE (:N {v: x})")
+        result = g.query("MATCH (n:N) RETURN count(n)")
+        self.env.assertEqual(result.result_set[0][0], 200001)
+        g.delete()
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s no" % config_name)
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET " + config_name)
+        self.env.assertEqual(response, [config_name, 0])
+
+    def test11_cold_storage_threshold(self):
+        config_name = "COLD_STORAGE_THRESHOLD"
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s 32" % config_name)
+        self.env.assertEqual(response, "OK")
+
+        # strings of at least 32 bytes are kept in memory-mapped storage
+        g = Graph("cold_storage", redis_con)
+        desc = "x" * 100
+        g.query("UNWIND range(0, 9) AS x CREATE (:N {v: x, desc: '%s' + toString(x), short: 'abc'})" % desc)
+        result = g.query("MATCH (n:N) WHERE n.v = 3 RETURN n.desc, n.short")
+        self.env.assertEqual(result.result_set, [[desc + "3", "abc"]])
+
+        # update and remove stored values
+        g.query("MATCH (n:N) WHERE n.v = 3 SET n.desc = 'updated %s'" % desc)
+        g.query("MATCH (n:N) WHERE n.v = 4 SET n.desc = NULL")
+        result = g.query("MATCH (n:N) WHERE n.v IN [3, 4] RETURN n.v, n.desc ORDER BY n.v")
+        self.env.assertEqual(result.result_set, [[3, "updated " + desc], [4, None]])
+
+        # stored values are compared by content
+        result = g.query("MATCH (n:N) WHERE n.desc = '%s5' RETURN n.v" % desc)
+        self.env.assertEqual(result.result_set, [[5]])
+
+        # stored values survive a reload
+        redis_con.execute_command("DEBUG", "RELOAD")
+        result = g.query("MATCH (n:N) WHERE n.v IN [3, 5] RETURN n.v, n.desc ORDER BY n.v")
+        self.env.assertEqual(result.result_set, [[3, "updated " + desc], [5, desc + "5"]])
+        g.delete()
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s 0" % config_name)
+        self.env.assertEqual(response, "OK")
+
+    def test12_thread_count(self):
+        config_name = "THREAD_COUNT"
+        response = redis_con.execute_command("GRAPH.CONFIG GET %s" % config_name)
+        thread_count = response[1]
+
+        # shrink the readers pool, queries keep being served
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s 1" % config_name)
+        self.env.assertEqual(response, "OK")
+        response = redis_con.execute_command("GRAPH.CONFIG GET %s" % config_name)
+        self.env.assertEqual(response, [config_name, 1])
+
+        g = Graph("thread_count", redis_con)
+        result = g.query("UNWIND range(1, 10) AS x RETURN count(x)")
+        self.env.assertEqual(result.result_set, [[10]])
+
+        # the pool can't outgrow its capacity
+        try:
+            redis_con.execute_command("GRAPH.CONFIG SET %s 100000" % config_name)
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            assert("Failed to set config value" in str(e))
+
+        # grow back
+        response = redis_con.execute_command("GRAPH.CONFIG SET %s %d" % (config_name, thread_count))
+        self.env.assertEqual(response, "OK")
+        result = g.query("UNWIND range(1, 10) AS x RETURN count(x)")
+        self.env.assertEqual(result.result_set, [[10]])
@@ -0,0 +1,129 @@
+import os
+import sys
+from RLTest import Env
+from redisgraph import Graph
+from redis import ResponseError
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "constraints"
+redis_con = None
+graph = None
+
+class testConstraints(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global graph
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        graph.query("UNWIND range(0, 9) AS i CREATE (:User {id: i, name: 'u' + toString(i)})")
+
+    def expect_error(self, q, msg):
+        try:
+            graph.query(q)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn(msg, str(e))
+
+    def user_count(self):
+        return graph.query("MATCH (u:User) RETURN count(u)").result_set[0][0]
+
+    def test01_create_constraint(self):
+        graph.query("CREATE CONSTRAINT ON (u:User) ASSERT u.id IS UNIQUE")
+        graph.query("CREATE CONSTRAINT ON (u:User) ASSERT exists(u.name)")
+
+        # the unique constraint is backed by an index
+        plan = graph.execution_plan("MATCH (u:User {id: 3}) RETURN u")
+        self.env.assertIn("Node By Index Scan", plan)
+        self.env.assertIn("Unique", plan)
+
+        # the backing index can't be dropped
+        self.expect_error("DROP INDEX ON :User(id)", "enforces a unique constraint")
+
+    def test02_violating_data(self):
+        graph.query("CREATE (:Tmp {v: 1}), (:Tmp {v: 1}), (:Tmp)")
+
+        # existing nodes must satisfy the constraint
+        self.expect_error("CREATE CONSTRAINT ON (t:Tmp) ASSERT t.v IS UNIQUE",
+                          "already exists")
+        self.expect_error("CREATE CONSTRAINT ON (t:Tmp) ASSERT exists(t.v)",
+                          "must have property")
+
+        graph.query("MATCH (t:Tmp) DELETE t")
+
+    def test03_create_violations(self):
+        count = self.user_count()
+
+        # value held by an existing node
+        self.expect_error("CREATE (:User {id: 1, name: 'x'})", "already exists")
+
+        # values clashing within the query
+        self.expect_error("UNWIND [100, 100] AS i CREATE (:User {id: i, name: 'x'})",
+                          "already exists")
+
+        # missing property
+        self.expect_error("CREATE (:User {id: 100})", "must have property")
+
+        # none of the query's nodes are created
+        self.env.assertEquals(self.user_count(), count)
+
+        # nodes missing a unique property don't clash
+        graph.query("CREATE (:User {name: 'a'}), (:User {name: 'b'})")
+        self.env.assertEquals(self.user_count(), count + 2)
+        graph.query("MATCH (u:User) WHERE u.id IS NULL DELETE u")
+
+    def test04_update_violations(self):
+        self.expect_error("MATCH (u:User {id: 1}) SET u.id = 2", "already exists")
+        self.expect_error("MATCH (u:User {id: 1}) SET u.name = NULL", "must have property")
+        self.expect_error("MATCH (u:User {id: 1}) SET u = {id: 1}", "must have property")
+        self.expect_error("MATCH (u:User) WHERE u.id < 2 SET u.id = 50", "already exists")
+
+        # swapping values is allowed
+        graph.query("MATCH (a:User {id: 1}), (b:User {id: 2}) SET a.id = 2, b.id = 1")
+        result = graph.query("MATCH (u:User {id: 1}) RETURN u.name").result_set
+        self.env.assertEquals(result[0][0], 'u2')
+        graph.query("MATCH (a:User {id: 1}), (b:User {id: 2}) SET a.id = 2, b.id = 1")
+
+        # a node keeps its own value
+        graph.query("MATCH (u:User {id: 1}) SET u.id = 1")
+
+    def test05_merge(self):
+        count = self.user_count()
+        result = graph.query("UNWIND [1, 2, 1, 20] AS i MERGE (u:User {id: i}) ON CREATE SET u.name = 'new' RETURN u.name")
+        self.env.assertEquals([row[0] for row in result.result_set],
+                              ['u1', 'u2', 'u1', 'new'])
+        self.env.assertEquals(self.user_count(), count + 1)
+        graph.query("MATCH (u:User {id: 20}) DELETE u")
+
+    def test06_reduce_distinct(self):
+        # unique and present on every node, no need to distinct
+        plan = graph.execution_plan("MATCH (u:User) RETURN DISTINCT u.id, u.name")
+        self.env.assertNotIn("Distinct", plan)
+
+        # name isn't unique
+        plan = graph.execution_plan("MATCH (u:User) RETURN DISTINCT u.name")
+        self.env.assertIn("Distinct", plan)
+
+        result = graph.query("MATCH (u:User) RETURN DISTINCT u.id ORDER BY u.id")
+        self.env.assertEquals([row[0] for row in result.result_set], list(range(10)))
+
+    def test07_drop_constraint(self):
+        graph.query("DROP CONSTRAINT ON (u:User) ASSERT exists(u.name)")
+        graph.query("CREATE (:User {id: 100})")
+
+        graph.query("DROP CONSTRAINT ON (u:User) ASSERT u.id IS UNIQUE")
+        graph.query("CREATE (:User {id: 100})")
+        result = graph.query("MATCH (u:User {id: 100}) RETURN count(u)").result_set
+        self.env.assertEquals(result[0][0], 2)
+
+        self.expect_error("DROP CONSTRAINT ON (u:User) ASSERT u.id IS UNIQUE",
+                          "no such constraint")
+
+        # the backing index outlives the constraint
+        graph.query("DROP INDEX ON :User(id)")
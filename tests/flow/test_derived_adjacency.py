@@ -0,0 +1,59 @@
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "derived_adjacency"
+redis_graph = None
+
+class testDerivedAdjacency(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='DERIVED_ADJACENCY yes')
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # a chain of 10 nodes alternating between relationship types R and S
+        # with an additional R edge parallel to every S edge
+        redis_graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE b.v = a.v + 1 AND a.v % 2 = 0 CREATE (a)-[:R]->(b)")
+        redis_graph.query("MATCH (a:N), (b:N) WHERE b.v = a.v + 1 AND a.v % 2 = 1 CREATE (a)-[:S]->(b), (a)-[:R]->(b)")
+
+    def untyped_count(self):
+        query = "MATCH (a)-[]->(b) RETURN count(DISTINCT [a.v, b.v])"
+        return redis_graph.query(query).result_set[0][0]
+
+    def test01_untyped_traversal(self):
+        # untyped traversals see the union of all relationship types
+        self.env.assertEquals(self.untyped_count(), 9)
+
+        query = "MATCH (a:N {v: 0})-[*]->(b) RETURN count(DISTINCT b)"
+        self.env.assertEquals(redis_graph.query(query).result_set[0][0], 9)
+
+        query = "MATCH (a:N {v: 9})<-[*]-(b) RETURN count(DISTINCT b)"
+        self.env.assertEquals(redis_graph.query(query).result_set[0][0], 9)
+
+    def test02_edge_updates(self):
+        # the adjacency matrix is recomputed once edges change
+        redis_graph.query("MATCH (a:N {v: 9}), (b:N {v: 0}) CREATE (a)-[:T]->(b)")
+        self.env.assertEquals(self.untyped_count(), 10)
+
+        # deleting one of two parallel edges keeps the nodes connected
+        redis_graph.query("MATCH (:N {v: 1})-[e:S]->(:N {v: 2}) DELETE e")
+        self.env.assertEquals(self.untyped_count(), 10)
+
+        redis_graph.query("MATCH (:N {v: 1})-[e:R]->(:N {v: 2}) DELETE e")
+        self.env.assertEquals(self.untyped_count(), 9)
+
+    def test03_node_deletion(self):
+        # deleting a node removes its edges of every type
+        result = redis_graph.query("MATCH (n:N {v: 9}) DETACH DELETE n")
+        self.env.assertEquals(result.relationships_deleted, 2)
+        self.env.assertEquals(self.untyped_count(), 7)
+
+    def test04_persistence(self):
+        # the adjacency matrix is derived from the decoded relation matrices
+        self.env.dumpAndReload()
+        self.env.assertEquals(self.untyped_count(), 7)
@@ -237,3 +237,21 @@ class testDistinct(FlowTestsBase):
         expected_result = [[2, 1]]
         self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+    def test_distinct_many_values(self):
+        # enough distinct tuples to grow the set several times
+        query = "UNWIND range(0, 19999) AS x RETURN DISTINCT x % 5000 AS k, toString(x % 2) AS s ORDER BY k, s"
+        actual_result = graph3.query(query)
+        expected_result = [[k, str(k % 2)] for k in range(5000)]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # sorted input, consecutive duplicates
+        query = "UNWIND range(0, 9999) AS x WITH x / 10 AS k ORDER BY k RETURN DISTINCT k"
+        actual_result = graph3.query(query)
+        expected_result = [[k] for k in range(1000)]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # values of different types are distinct, 1 and 1.0 are not
+        query = "UNWIND [1, '1', 1.0, true, [1], NULL, '1', NULL] AS x WITH DISTINCT x RETURN count(*)"
+        actual_result = graph3.query(query)
+        self.env.assertEquals(actual_result.result_set, [[5]])
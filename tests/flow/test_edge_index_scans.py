@@ -507,3 +507,29 @@ class testEdgeByIndexScanFlow(FlowTestsBase):
         result = redis_graph.query("MATCH ()-[u:R2]->() WHERE u.id1 = 990000000262240069 AND u.id2 = 990000000262240067 RETURN u.id1, u.id2")
         expected_result = [[990000000262240069, 990000000262240067]]
         self.env.assertEquals(result.result_set, expected_result)
+
+    def test21_index_scan_bound_endpoints(self):
+        redis_graph = Graph('bound_edge_index', self.env.getConnection())
+
+        # ring of 40 nodes, each node connected to the next by two parallel
+        # edges and to the one after it by a single edge
+        redis_graph.query("CREATE INDEX FOR ()-[r:R]-() ON (r.w)")
+        redis_graph.query("UNWIND range(0, 39) AS v CREATE (:N {v: v})")
+        redis_graph.query("""MATCH (a:N), (b:N), (c:N)
+                             WHERE b.v = (a.v + 1) % 40 AND c.v = (a.v + 2) % 40
+                             CREATE (a)-[:R {w: a.v}]->(b), (a)-[:R {w: a.v + 100}]->(b),
+                                    (a)-[:R {w: a.v + 200}]->(c)""")
+
+        # many input records, each looking up edges of a bound endpoint
+        query = "MATCH (a:N) MATCH (a)-[r:R]->(b) WHERE r.w >= 100 RETURN count(r), sum(r.w - a.v)"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[80, 12000]])
+
+        query = "MATCH (b:N) MATCH (a)-[r:R]->(b) WHERE r.w >= 200 RETURN count(r), sum(r.w - b.v)"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[40, 8000]])
+
+        query = "MATCH (a:N) MATCH (a)-[r:R]->(b) WHERE r.w < 100 RETURN count(r), sum(b.v - a.v)"
+        result = redis_graph.query(query)
+        # each edge leads to the next node, the last wraps around
+        self.env.assertEquals(result.result_set, [[40, 0]])
@@ -4,6 +4,7 @@ import sys
 from RLTest import Env
 from redisgraph import Graph, Node, Edge
 import re
+import time
 
 redis_con = None
 
@@ -217,3 +218,60 @@ class test_v7_encode_decode(FlowTestsBase):
         matches = re.findall("Deleted (.) virtual keys for graph vkey_max_entity_count", log)
 
         self.env.assertEqual(matches, ['3', '6'])
+
+    # keys saved by a forked child are encoded concurrently
+    def test10_bgsave_multiple_keys(self):
+        redis_con.flushall()
+
+        response = redis_con.execute_command("GRAPH.CONFIG SET VKEY_MAX_ENTITY_COUNT 10")
+        self.env.assertEqual(response, "OK")
+
+        graph_name = "bgsave_multiple_keys"
+        redis_graph = Graph(graph_name, redis_con)
+
+        # nodes, multi-edges and deleted entities spread over multiple keys
+        redis_graph.query("UNWIND range(0, 100) as v CREATE (:L {v: v, s: toString(v)})")
+        redis_graph.query("MATCH (a:L), (b:L) WHERE b.v = a.v + 1 CREATE (a)-[:R {v: a.v}]->(b), (a)-[:R {v: -a.v}]->(b)")
+        redis_graph.query("MATCH (a:L), (b:L) WHERE b.v = a.v + 2 CREATE (a)-[:S {v: a.v}]->(b)")
+        redis_graph.query("MATCH (n:L) WHERE n.v % 7 = 0 DELETE n")
+
+        nodes_query = "MATCH (n:L) RETURN n ORDER BY ID(n)"
+        edges_query = "MATCH (a:L)-[e]->(b:L) RETURN ID(a), ID(b), type(e), e.v ORDER BY ID(e)"
+        expected_nodes = redis_graph.query(nodes_query)
+        expected_edges = redis_graph.query(edges_query)
+
+        # save RDB from a forked child & load it
+        redis_con.execute_command("BGSAVE")
+        while redis_con.execute_command("INFO", "persistence")['rdb_bgsave_in_progress'] == 1:
+            time.sleep(0.1)
+        self.env.assertEqual(redis_con.execute_command("INFO", "persistence")['rdb_last_bgsave_status'], "ok")
+        redis_con.execute_command("DEBUG", "RELOAD", "NOSAVE")
+
+        actual_nodes = redis_graph.query(nodes_query)
+        actual_edges = redis_graph.query(edges_query)
+        self.env.assertEquals(expected_nodes.result_set, actual_nodes.result_set)
+        self.env.assertEquals(expected_edges.result_set, actual_edges.result_set)
+
+    # edge connections are restored from the relation matrices,
+    # edge indices are populated once the whole graph is loaded
+    def test11_edge_index_after_encode_decode(self):
+        redis_con.flushall()
+
+        graph_name = "edge_index_after_encode_decode"
+        redis_graph = Graph(graph_name, redis_con)
+
+        redis_graph.query("UNWIND range(0, 30) as v CREATE (:L {v: v})")
+        redis_graph.query("MATCH (a:L), (b:L) WHERE b.v = a.v + 1 CREATE (a)-[:R {v: a.v}]->(b), (a)-[:R {v: -a.v}]->(b)")
+        redis_graph.query("CREATE INDEX FOR ()-[r:R]-() ON (r.v)")
+
+        query = "MATCH (a:L)-[e:R]->(b:L) WHERE e.v = -3 RETURN a.v, b.v, e.v"
+        expected = redis_graph.query(query)
+        self.env.assertEquals(expected.result_set, [[3, 4, -3]])
+
+        # Save RDB & Load from RDB
+        redis_con.execute_command("DEBUG", "RELOAD")
+
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Edge By Index Scan", plan)
+        actual = redis_graph.query(query)
+        self.env.assertEquals(expected.result_set, actual.result_set)
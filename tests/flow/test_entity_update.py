@@ -237,3 +237,25 @@ class testEntityUpdate(FlowTestsBase):
                 self.env.assertTrue(False)
             except ResponseError as e:
                 self.env.assertContains("Property values can only be of primitive types or arrays of primitive types", str(e))
+
+    # updates spanning multiple commit chunks
+    def test18_chunked_updates(self):
+        g = Graph('chunked_update', self.env.getConnection())
+        g.query("UNWIND range(1, 3000) AS x CREATE (:C {v: x})")
+
+        # each node is updated exactly once
+        result = g.query("MATCH (n:C) WHERE n.v > 0 SET n.v = n.v + 1")
+        self.env.assertEqual(result.properties_set, 3000)
+        result = g.query("MATCH (n:C) RETURN min(n.v), max(n.v), count(n)")
+        self.env.assertEqual(result.result_set, [[2, 3001, 3000]])
+
+        # updated values are returned
+        result = g.query("MATCH (n:C) SET n.v = 0 RETURN count(n), sum(n.v)")
+        self.env.assertEqual(result.result_set, [[3000, 0]])
+
+        # every record of a later clause observes all updates
+        result = g.query("""MATCH (n:C) SET n.v = 1
+                            WITH n MATCH (m:C) WHERE id(m) = 0
+                            RETURN DISTINCT m.v""")
+        self.env.assertEqual(result.result_set, [[1]])
+        g.delete()
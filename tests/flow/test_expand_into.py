@@ -108,3 +108,72 @@ class testExpandInto():
         self.env.assertIn("Expand Into", plan)
         self.env.assertEquals(4, result.result_set[0][0])
 
+
+    # batches of source records grow as the child keeps on producing records
+    # results must not depend on the maximum batch size
+    def test05_adaptive_batch_size(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("adaptive_batch", redis_con)
+
+        # create 2000 chains (:A)-[:R]->(:B)-[:R]->(:C)
+        graph.query("UNWIND range(1, 2000) AS x CREATE (:A {v: x})-[:R]->(:B {v: x})-[:R]->(:C {v: x})")
+
+        queries = ["MATCH (a:A)-[:R]->(b)-[:R]->(c) RETURN count(c), sum(c.v)",
+                   "MATCH (a:A), (c:C) WHERE a.v = c.v WITH a, c MATCH (a)-[:R]->()-[:R]->(c) RETURN count(c)",
+                   "MATCH (a:A)-[:R]->(b) RETURN b.v ORDER BY b.v LIMIT 3"]
+        expected = [[[2000, 2001000]], [[2000]], [[1], [2], [3]]]
+
+        for max_batch_size in [16, 17, 1024, 100000]:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "MAX_TRAVERSE_BATCH_SIZE", max_batch_size)
+            for q, e in zip(queries, expected):
+                self.env.assertEqual(graph.query(q).result_set, e)
+
+        # restore default
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "MAX_TRAVERSE_BATCH_SIZE", 1024)
+
+    # records sharing a source node are traversed once
+    # and emitted in the order they were received
+    def test06_shared_sources(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("shared_sources", redis_con)
+
+        # a hub reached by each of 100 spokes, and connected to 3 leaves
+        graph.query("CREATE (h:H)-[:R]->(:L {v: 1}), (h)-[:R]->(:L {v: 2}), (h)-[:R]->(:L {v: 3})")
+        graph.query("MATCH (h:H) UNWIND range(1, 100) AS x CREATE (:S {v: x})-[:R]->(h)")
+
+        query = "MATCH (s:S)-[:R]->(h)-[:R]->(l) RETURN s.v, l.v"
+        result = graph.query(query).result_set
+        self.env.assertEquals(len(result), 300)
+        self.env.assertEquals(sorted(result), [[s, l] for s in range(1, 101) for l in range(1, 4)])
+
+        # destinations follow their record
+        spokes = [row[0] for row in result]
+        self.env.assertEquals(spokes, [s for s in spokes[::3] for _ in range(3)])
+
+        query = "MATCH (s:S)-[:R]->(h)-[:R]->(l) RETURN s.v, count(l) ORDER BY s.v"
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[s, 3] for s in range(1, 101)])
+
+    # bound endpoint pairs are probed against the relation matrix
+    # pairs sharing a source are intersected with the source's row
+    def test07_probe_bound_pairs(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("probe_pairs", redis_con)
+
+        # a hub connected to every even numbered node, half of which are :E
+        graph.query("CREATE (:H)")
+        graph.query("UNWIND range(1, 100) AS x CREATE (:N {v: x})")
+        graph.query("MATCH (h:H), (n:N) WHERE n.v % 2 = 0 CREATE (h)-[:R]->(n)")
+        graph.query("MATCH (n:N) WHERE n.v % 4 = 0 SET n:E")
+
+        queries = ["MATCH (h:H), (n:N) WITH h, n MATCH (h)-[:R]->(n) RETURN count(n)",
+                   "MATCH (h:H), (n:N) WITH h, n MATCH (h)-[:R]->(n:E) RETURN count(n)",
+                   "MATCH (h:H), (n:N) WITH h, n MATCH (n)<-[:R]-(h) RETURN count(n)",
+                   "MATCH (h:H), (n:N) WITH h, n MATCH (h)-[e:R]->(n) RETURN count(e)",
+                   "MATCH (h:H), (n:N) WITH h, n MATCH (h)-[:R]->(n) RETURN n.v LIMIT 3"]
+        expected = [[[50]], [[25]], [[50]], [[50]], [[2], [4], [6]]]
+
+        for q, e in zip(queries, expected):
+            plan = graph.execution_plan(q)
+            self.env.assertIn("Expand Into", plan)
+            self.env.assertEquals(graph.query(q).result_set, e)
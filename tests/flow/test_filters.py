@@ -1,5 +1,6 @@
 from RLTest import Env
 from redisgraph import Graph
+from redis import ResponseError
 
 class testFilters():
     def __init__(self):
@@ -38,3 +39,77 @@ class testFilters():
         expected = [[i, j] for i in range(1, 6) for j in range(1, 6) if not (i % 2 != j % 2)]
         result = g.query("MATCH (n:N), (m:N) WHERE NOT (n.b XOR m.b) RETURN n.v, m.v ORDER BY n.v, m.v")
         self.env.assertEqual(result.result_set,  expected)
+
+    def test02_parallel_filter_over_scan(self):
+        redis_con = self.env.getConnection()
+        g = Graph("parallel", redis_con)
+        g.query("UNWIND range(0, 9999) AS x CREATE (:P {v: x, s: toString(x)})")
+
+        queries = [("MATCH (n:P) WHERE n.v > 3000 RETURN count(n)", [[6999]]),
+                   ("MATCH (n:P) WHERE n.v % 7 = 0 AND n.s STARTS WITH '1' RETURN count(n), sum(n.v)", None),
+                   ("MATCH (n) WHERE n.v < 5 RETURN n.v ORDER BY n.v", [[0], [1], [2], [3], [4]]),
+                   ("MATCH (n:P) WHERE n.v >= 9990 RETURN n.v", [[i] for i in range(9990, 10000)])]
+
+        # compute expected results using a single thread
+        expected = []
+        for q, e in queries:
+            expected.append(g.query(q).result_set if e is None else e)
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_PARALLELISM", 4)
+        try:
+            for (q, _), e in zip(queries, expected):
+                # records are emitted in scan order
+                self.env.assertEqual(g.query(q).result_set, e)
+
+            # a run-time error raised by a worker thread is reported
+            try:
+                g.query("MATCH (n:P) WHERE n.v / (n.v - 5000) > 1 RETURN count(n)")
+                self.env.assertTrue(False)
+            except ResponseError as e:
+                self.env.assertIn("Division by zero", str(e))
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_PARALLELISM", 1)
+
+    def test03_typed_comparisons(self):
+        g = Graph("typed", self.env.getConnection())
+        g.query("UNWIND range(0, 9) AS x CREATE (:T {i: x, f: x + 0.5, s: toString(x)})")
+        g.query("CREATE (:T {s: 'a'}), (:T {i: 'a'})")
+
+        # integer, string and mixed type comparisons
+        # combined with short-circuiting and nested exclusive or
+        queries = [("MATCH (n:T) WHERE n.i >= 7 RETURN n.i ORDER BY n.i", [[7], [8], [9]]),
+                   ("MATCH (n:T) WHERE n.i < 2.5 RETURN n.i ORDER BY n.i", [[0], [1], [2]]),
+                   ("MATCH (n:T) WHERE n.s = '3' OR n.s = 'a' RETURN n.s ORDER BY n.s", [['3'], ['a']]),
+                   ("MATCH (n:T) WHERE n.i <> 'a' AND n.i > 8 RETURN n.i", [[9]]),
+                   ("MATCH (n:T) WHERE n.f > 8 OR n.s = '0' RETURN n.i ORDER BY n.i", [[0], [8], [9]]),
+                   ("MATCH (n:T) WHERE (n.i < 3 XOR n.i > 1) XOR n.i = 0 RETURN n.i ORDER BY n.i", [[1], [3], [4], [5], [6], [7], [8], [9]]),
+                   ("MATCH (n:T) WHERE n.f > 0 AND NOT (n.i < 8 OR n.missing = 1) RETURN n.i ORDER BY n.i", [[8], [9]])]
+
+        for q, e in queries:
+            self.env.assertEqual(g.query(q).result_set, e)
+
+    def test04_regex(self):
+        g = Graph("regex", self.env.getConnection())
+        g.query("UNWIND ['apple', 'apricot', 'banana', 'Avocado', 'grape'] AS s CREATE (:F {s: s})")
+
+        # the pattern must match the entire string
+        queries = [("MATCH (n:F) WHERE n.s =~ 'ap.*' RETURN n.s ORDER BY n.s", [['apple'], ['apricot']]),
+                   ("MATCH (n:F) WHERE n.s =~ 'ap' RETURN n.s", []),
+                   ("MATCH (n:F) WHERE n.s =~ '.*an.*' RETURN n.s", [['banana']]),
+                   ("MATCH (n:F) WHERE n.s =~ '(?i)a.*' RETURN n.s ORDER BY n.s", [['Avocado'], ['apple'], ['apricot']]),
+                   ("MATCH (n:F) WHERE n.s =~ 'g[a-z]+|b[a-z]+' RETURN n.s ORDER BY n.s", [['banana'], ['grape']]),
+                   ("MATCH (n:F) WHERE NOT n.s =~ '[a-z]+' RETURN n.s", [['Avocado']]),
+                   ("RETURN 'abc' =~ 'a.c', null =~ 'a', 'a' =~ null", [[True, None, None]])]
+
+        for q, e in queries:
+            self.env.assertEqual(g.query(q).result_set, e)
+
+        # the pattern may vary per row
+        q = "UNWIND ['a.*', 'b.*', 'a.*'] AS p MATCH (n:F) WHERE n.s =~ p RETURN count(n)"
+        self.env.assertEqual(g.query(q).result_set, [[5]])
+
+        try:
+            g.query("MATCH (n:F) WHERE n.s =~ '(' RETURN n")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Invalid regular expression", str(e))
@@ -57,4 +57,24 @@ class testFulltextIndexQuery(FlowTestsBase):
 
         # fulltext query L2 for world 
         result = graph.query("CALL db.idx.fulltext.queryNodes('L2', 'world')")
-        self.env.assertEquals(result.result_set, [])
\ No newline at end of file
+        self.env.assertEquals(result.result_set, [])
+    # top scored results
+    def test02_ordered_limited_output(self):
+        graph.query("CALL db.idx.fulltext.createNodeIndex('L3', 'v')")
+        graph.query("UNWIND range(1, 10) AS i CREATE (:L3 {i: i, v: 'a' + reduce(s = '', x IN range(1, i) | s + ' term')})")
+
+        q = """CALL db.idx.fulltext.queryNodes('L3', 'term') YIELD node, score
+               RETURN node.i, score ORDER BY score DESC"""
+        ranked = graph.query(q).result_set
+        self.env.assertEquals(len(ranked), 10)
+
+        # only the top scored nodes are produced by the procedure
+        q = """CALL db.idx.fulltext.queryNodes('L3', 'term') YIELD node, score
+               RETURN node.i, score ORDER BY score DESC LIMIT 3"""
+        res = graph.query(q).result_set
+        self.env.assertEquals(res, ranked[:3])
+
+        q = """CALL db.idx.fulltext.queryNodes('L3', 'term') YIELD score
+               RETURN score ORDER BY score SKIP 2 LIMIT 2"""
+        res = graph.query(q).result_set
+        self.env.assertEquals([r[0] for r in res], [r[1] for r in ranked[::-1][2:4]])
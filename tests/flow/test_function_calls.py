@@ -323,7 +323,9 @@ class testFunctionCallsFlow(FlowTestsBase):
                      "sum",
                      "percentileDisc",
                      "percentileCont",
-                     "stDev"]
+                     "stDev",
+                     "approxCountDistinct",
+                     "approxPercentile"]
         # Test all functions for invalid argument counts.
         for function in functions:
             query = """UNWIND range(0, 10) AS val RETURN %s(val, val, val)""" % (function)
@@ -341,6 +343,9 @@ class testFunctionCallsFlow(FlowTestsBase):
         query = """UNWIND range(0, 10) AS val RETURN percentileDisc(val, -1)"""
         self.expect_error(query, "must be a number in the range 0.0 to 1.0")
 
+        query = """UNWIND range(0, 10) AS val RETURN approxPercentile(val, 2)"""
+        self.expect_error(query, "must be a number in the range 0.0 to 1.0")
+
     # startNode and endNode calls should return the appropriate nodes.
     def test16_edge_endpoints(self):
         query = """MATCH (a)-[e]->(b) RETURN a.name, startNode(e).name, b.name, endNode(e).name"""
@@ -474,3 +479,108 @@ class testFunctionCallsFlow(FlowTestsBase):
         # Test trying to retrieve keys of an invalid type
         query = """WITH 10 AS map RETURN keys(map)"""
         self.expect_type_error(query)
+
+    def test21_numeric_aggregations(self):
+        values = range(1, 5001)
+
+        query = """UNWIND range(1, 5000) AS x RETURN sum(x), avg(x), min(x), max(x)"""
+        actual_result = graph.query(query)
+        expected_result = [[sum(values), 2500.5, 1, 5000]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # integers, floats and NULLs mixed
+        mixed = [x + 0.5 if x % 3 == 0 else (None if x % 7 == 0 else x) for x in values]
+        non_null = [v for v in mixed if v is not None]
+        query = """UNWIND range(1, 5000) AS x
+                   WITH CASE WHEN x % 3 = 0 THEN x + 0.5 WHEN x % 7 = 0 THEN NULL ELSE x END AS v
+                   RETURN sum(v), min(v), max(v), count(v)"""
+        actual_result = graph.query(query)
+        expected_result = [[sum(non_null), min(non_null), max(non_null), len(non_null)]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # grouped aggregations
+        query = """UNWIND range(1, 5000) AS x RETURN x % 3 AS k, sum(x), max(x) ORDER BY k"""
+        actual_result = graph.query(query)
+        expected_result = [[k, sum(x for x in values if x % 3 == k), max(x for x in values if x % 3 == k)] for k in range(3)]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        query = """UNWIND range(1, 5000) AS x RETURN percentileCont(x, 0.5), percentileDisc(x, 0.25)"""
+        actual_result = graph.query(query)
+        expected_result = [[2500.5, 1250]]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        query = """UNWIND range(1, 5000) AS x RETURN stDevP(x)"""
+        actual_result = graph.query(query)
+        mean = sum(values) / len(values)
+        expected = (sum((x - mean) ** 2 for x in values) / len(values)) ** 0.5
+        self.env.assertAlmostEqual(actual_result.result_set[0][0], expected, 0.0001)
+
+        # a value of an unexpected type is reported
+        query = """UNWIND range(1, 5000) AS x
+                   WITH CASE WHEN x = 4000 THEN 'a' ELSE x END AS v
+                   RETURN sum(v)"""
+        self.expect_type_error(query)
+
+    def test22_many_groups(self):
+        # enough groups to grow the group cache several times
+        query = """UNWIND range(0, 19999) AS x RETURN x % 5000 AS k, count(x), sum(x) ORDER BY k"""
+        actual_result = graph.query(query)
+        expected_result = [[k, 4, 4 * k + 5000 * 6] for k in range(5000)]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # keys of different types and NULL keys form distinct groups
+        query = """UNWIND [1, '1', NULL, 1, NULL, [1], '1'] AS x RETURN x, count(1) ORDER BY count(1), toString(x)"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(len(actual_result.result_set), 4)
+        self.env.assertEquals(sorted(row[1] for row in actual_result.result_set), [1, 2, 2, 2])
+
+    def test23_approximate_aggregations(self):
+        # small inputs are counted exactly
+        query = """UNWIND [1, 2, 2, 'a', 'a', NULL, 1.5, [1]] AS x RETURN approxCountDistinct(x)"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [[5]])
+
+        # no centroids are merged for small inputs, matching percentileCont
+        query = """UNWIND [10, 2, 8, 4, 6, NULL] AS x
+                   RETURN approxPercentile(x, 0.25), percentileCont(x, 0.25),
+                   approxPercentile(x, 0.5), percentileCont(x, 0.5)"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [[4.0, 4.0, 6.0, 6.0]])
+
+        # large inputs are estimated
+        query = """UNWIND range(1, 200000) AS x
+                   RETURN approxCountDistinct(x % 50000), approxPercentile(x, 0.5),
+                   approxPercentile(x, 0), approxPercentile(x, 1)"""
+        actual_result = graph.query(query)
+        distinct, median, minimum, maximum = actual_result.result_set[0]
+        self.env.assertLess(abs(distinct - 50000), 50000 * 0.05)
+        self.env.assertLess(abs(median - 100000), 100000 * 0.01)
+        self.env.assertEquals(minimum, 1)
+        self.env.assertEquals(maximum, 200000)
+
+        # grouped estimations
+        query = """UNWIND range(1, 30000) AS x
+                   RETURN x % 3 AS k, approxCountDistinct(x) ORDER BY k"""
+        actual_result = graph.query(query)
+        for row in actual_result.result_set:
+            self.env.assertLess(abs(row[1] - 10000), 10000 * 0.05)
+
+    def test24_timestamp(self):
+        # timestamp() returns the same value throughout a query
+        query = """UNWIND range(1, 100000) AS x
+                   WITH x, timestamp() AS t
+                   RETURN count(DISTINCT t), min(t) = max(t)"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1, True]])
+
+        # time window filters
+        graph.query("CREATE (:ts_event {ts: timestamp() - 1000}), (:ts_event {ts: timestamp() - 100000000})")
+        query = """MATCH (e:ts_event) WHERE e.ts > timestamp() - 86400000 RETURN count(e)"""
+        actual_result = graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1]])
+
+        # successive executions of a cached query observe the current time
+        query = """RETURN timestamp()"""
+        t1 = graph.query(query).result_set[0][0]
+        t2 = graph.query(query).result_set[0][0]
+        self.env.assertGreaterEqual(t2, t1)
@@ -0,0 +1,257 @@
+import os
+import sys
+from RLTest import Env
+from redis import ResponseError
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "G"
+redis_graph = None
+
+class testGraphAlgorithmsFlow(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def create(self, q):
+        self.env.cmd('flushall')
+        redis_graph.query(q)
+
+    def test01_wcc(self):
+        self.create("""CREATE (a:N {v:0}), (b:N {v:1}), (c:N {v:2}), (d:N {v:3}),
+                       (e:N {v:4}), (f:N {v:5}),
+                       (a)-[:R]->(b), (c)-[:R]->(b), (e)-[:R]->(f)""")
+
+        q = """CALL algo.WCC(NULL, NULL) YIELD node, componentId
+               RETURN node.v, componentId ORDER BY node.v"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res, [[0, 0], [1, 0], [2, 0], [3, 3], [4, 4], [5, 4]])
+
+        # unknown relationship type
+        q = "CALL algo.WCC(NULL, 'X') YIELD node RETURN count(node)"
+        self.env.assertEquals(redis_graph.query(q).result_set, [[0]])
+
+        # deleted nodes are skipped
+        redis_graph.query("MATCH (n {v:0}) DELETE n")
+        q = """CALL algo.WCC('N', 'R') YIELD node, componentId
+               RETURN node.v, componentId ORDER BY node.v"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res, [[1, 1], [2, 1], [3, 3], [4, 4], [5, 4]])
+
+    def test02_triangle_count(self):
+        self.create("""CREATE (a {v:0}), (b {v:1}), (c {v:2}), (d {v:3}),
+                       (a)-[:R]->(b), (b)-[:R]->(c), (c)-[:R]->(a),
+                       (c)-[:R]->(d), (d)-[:R]->(d)""")
+
+        q = """CALL algo.triangleCount(NULL, NULL) YIELD node, triangles
+               RETURN node.v, triangles ORDER BY node.v"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res, [[0, 1], [1, 1], [2, 1], [3, 0]])
+
+    def test03_label_propagation(self):
+        # two triangles connected by a single edge
+        self.create("""CREATE (a {v:0}), (b {v:1}), (c {v:2}),
+                       (d {v:3}), (e {v:4}), (f {v:5}),
+                       (a)-[:R]->(b), (b)-[:R]->(c), (c)-[:R]->(a),
+                       (d)-[:R]->(e), (e)-[:R]->(f), (f)-[:R]->(d),
+                       (c)-[:R]->(d)""")
+
+        q = """CALL algo.labelPropagation(NULL, NULL, NULL) YIELD node, communityId
+               RETURN node.v, communityId ORDER BY node.v"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res, [[0, 0], [1, 0], [2, 0], [3, 3], [4, 3], [5, 3]])
+
+        # invalid number of iterations
+        try:
+            redis_graph.query("CALL algo.labelPropagation(NULL, NULL, 0) YIELD node RETURN node")
+            self.env.assertTrue(False)
+        except Exception:
+            pass
+
+    def test04_weighted_pagerank(self):
+        self.create("""CREATE (a {v:0}), (b {v:1}), (c {v:2}),
+                       (a)-[:R {w: 3}]->(b), (a)-[:R {w: 1}]->(c)""")
+
+        q = """CALL algo.weightedPageRank(NULL, 'R', 'w') YIELD node, score
+               RETURN node.v, score"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals([r[0] for r in res], [1, 2, 0])
+        self.env.assertAlmostEqual(sum(r[1] for r in res), 1, 0.0001)
+
+        # unknown weight attribute
+        q = "CALL algo.weightedPageRank(NULL, 'R', 'x') YIELD node RETURN count(node)"
+        self.env.assertEquals(redis_graph.query(q).result_set, [[0]])
+
+    def test05_personalized_pagerank(self):
+        self.create("""CREATE (a {v:0})-[:R]->(b {v:1})-[:R]->(c {v:2}),
+                       (d {v:3})""")
+
+        q = """MATCH (s {v:0})
+               CALL algo.personalizedPageRank(NULL, NULL, [s], NULL) YIELD node, score
+               RETURN node.v, score"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(len(res), 4)
+        self.env.assertEquals(res[0][0], 0)
+        # unreachable from the source
+        self.env.assertEquals(res[3], [3, 0])
+        self.env.assertAlmostEqual(sum(r[1] for r in res), 1, 0.0001)
+
+    def test06_single_source_paths(self):
+        self.create("""CREATE (a {v:0}), (b {v:1}), (c {v:2}), (d {v:3}),
+                       (a)-[:R {w:1}]->(b), (b)-[:R {w:1}]->(c),
+                       (a)-[:R {w:5}]->(c), (c)-[:R {w:1}]->(d)""")
+
+        q = """MATCH (s {v:0})
+               CALL algo.SSpaths({sourceNode: s, weightProp: 'w'}) YIELD path, pathWeight
+               RETURN [n IN nodes(path) | n.v], pathWeight"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res, [[[0, 1], 1], [[0, 1, 2], 2], [[0, 1, 2, 3], 3]])
+
+        # the lightest path within 1 edge
+        q = """MATCH (s {v:0})
+               CALL algo.SSpaths({sourceNode: s, weightProp: 'w', maxLen: 1}) YIELD path, pathWeight
+               RETURN [n IN nodes(path) | n.v], pathWeight"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res, [[[0, 1], 1], [[0, 2], 5]])
+
+        # cost bound
+        q = """MATCH (s {v:0})
+               CALL algo.SSpaths({sourceNode: s, weightProp: 'w', maxCost: 2}) YIELD path
+               RETURN count(path)"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[2]])
+
+        # incoming direction
+        q = """MATCH (s {v:3})
+               CALL algo.SSpaths({sourceNode: s, relDirection: 'incoming'}) YIELD path, pathWeight
+               RETURN [n IN nodes(path) | n.v], pathWeight"""
+        res = sorted(redis_graph.query(q).result_set, key=lambda r: (r[1], r[0]))
+        self.env.assertEquals(res, [[[3, 2], 1], [[3, 2, 0], 2], [[3, 2, 1], 2]])
+
+        # invalid configuration
+        try:
+            redis_graph.query("CALL algo.SSpaths({relTypes: ['R']}) YIELD path RETURN path")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("sourceNode", str(e))
+
+    def test07_k_shortest_paths(self):
+        self.create("""CREATE (a {v:0}), (b {v:1}), (c {v:2}), (d {v:3}),
+                       (a)-[:R {w:1}]->(b), (b)-[:R {w:1}]->(d),
+                       (a)-[:R {w:1}]->(c), (c)-[:R {w:2}]->(d),
+                       (a)-[:R {w:4}]->(d), (b)-[:R {w:1}]->(c)""")
+
+        q = """MATCH (s {v:0}), (t {v:3})
+               CALL algo.SPpaths({sourceNode: s, targetNode: t, weightProp: 'w', pathCount: 5})
+               YIELD path, pathWeight
+               RETURN [n IN nodes(path) | n.v], pathWeight"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res[0], [[0, 1, 3], 2])
+        self.env.assertEquals(res[1], [[0, 2, 3], 3])
+        self.env.assertEquals(len(res), 4)
+        self.env.assertEquals([r[1] for r in res], [2, 3, 4, 4])
+
+        # default to a single path
+        q = """MATCH (s {v:0}), (t {v:3})
+               CALL algo.SPpaths({sourceNode: s, targetNode: t, weightProp: 'w'})
+               YIELD pathWeight RETURN pathWeight"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[2]])
+
+        # unknown relationship type
+        q = """MATCH (s {v:0}), (t {v:3})
+               CALL algo.SPpaths({sourceNode: s, targetNode: t, relTypes: ['X']})
+               YIELD path RETURN count(path)"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[0]])
+
+    def test08_ordered_limited_output(self):
+        # star around node 0, plus a triangle 1-2-3
+        self.create("""CREATE (c {v:0}), (a {v:1}), (b {v:2}), (d {v:3}), (e {v:4}),
+                       (a)-[:R {w:1}]->(c), (b)-[:R {w:1}]->(c), (d)-[:R {w:1}]->(c),
+                       (e)-[:R {w:1}]->(c), (a)-[:R {w:1}]->(b), (b)-[:R {w:1}]->(d),
+                       (d)-[:R {w:1}]->(a)""")
+
+        q = """CALL algo.weightedPageRank(NULL, 'R', 'w') YIELD node, score
+               RETURN node.v, score ORDER BY score DESC"""
+        ranked = redis_graph.query(q).result_set
+
+        # only the top ranked nodes are produced by the procedure
+        q = """CALL algo.weightedPageRank(NULL, 'R', 'w') YIELD node, score
+               RETURN node.v, score ORDER BY score DESC LIMIT 2"""
+        res = redis_graph.query(q).result_set
+        # nodes 1, 2 and 3 are ranked equally
+        self.env.assertEquals(res[0], ranked[0])
+        self.env.assertAlmostEqual(res[1][1], ranked[1][1], 0.0001)
+
+        q = """CALL algo.weightedPageRank(NULL, 'R', 'w') YIELD node, score AS s
+               RETURN node.v, s ORDER BY s DESC SKIP 1 LIMIT 2"""
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(len(res), 2)
+        self.env.assertAlmostEqual(res[0][1], ranked[1][1], 0.0001)
+        self.env.assertAlmostEqual(res[1][1], ranked[2][1], 0.0001)
+
+        q = """CALL algo.triangleCount(NULL, NULL) YIELD node, triangles
+               WITH node, triangles ORDER BY triangles LIMIT 1
+               RETURN node.v, triangles"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[4, 0]])
+
+        # ordering by a different output, all records are produced
+        q = """CALL algo.triangleCount(NULL, NULL) YIELD node, triangles
+               RETURN node.v, triangles ORDER BY node.v DESC LIMIT 1"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[4, 0]])
+
+    def test09_sample_nodes(self):
+        # 1000 labeled nodes forming a ring, 1000 unlabeled nodes
+        self.create("""UNWIND range(0, 999) AS x CREATE (:L {v: x}), ({v: -1})""")
+        redis_graph.query("""MATCH (a:L), (b:L) WHERE b.v = (a.v + 1) % 1000
+                             CREATE (a)-[:R]->(b)""")
+
+        # distinct labeled nodes are sampled
+        for method in ["uniform", "randomWalk"]:
+            q = """CALL algo.sampleNodes({label: 'L', size: 100, method: '%s', relType: 'R'})
+                   YIELD node RETURN count(node), count(DISTINCT node), min(node.v)""" % method
+            self.env.assertEquals(redis_graph.query(q).result_set[0][:2], [100, 100])
+            self.env.assertGreaterEqual(redis_graph.query(q).result_set[0][2], 0)
+
+        # a sample larger than the label holds every labeled node
+        q = """CALL algo.sampleNodes({label: 'L', size: 5000})
+               YIELD node RETURN count(DISTINCT node), sum(node.v)"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[1000, 499500]])
+
+        # bernoulli sampling of unlabeled nodes yields roughly rate * count
+        q = """CALL algo.sampleNodes({method: 'bernoulli', rate: 0.25, seed: 7})
+               YIELD node RETURN count(node), count(DISTINCT node)"""
+        count, distinct = redis_graph.query(q).result_set[0]
+        self.env.assertEquals(count, distinct)
+        self.env.assertGreater(count, 400)
+        self.env.assertLess(count, 600)
+
+        q = """CALL algo.sampleNodes({method: 'bernoulli', rate: 1, label: 'L'})
+               YIELD node RETURN count(node)"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[1000]])
+
+        # samples are reproducible given a seed
+        q = """CALL algo.sampleNodes({label: 'L', size: 10, seed: 42})
+               YIELD node RETURN collect(node.v)"""
+        self.env.assertEquals(redis_graph.query(q).result_set,
+                              redis_graph.query(q).result_set)
+
+        # the estimate of the average converges to the true average
+        q = """CALL algo.sampleNodes({label: 'L', size: 500})
+               YIELD node RETURN avg(node.v)"""
+        self.env.assertLess(abs(redis_graph.query(q).result_set[0][0] - 499.5), 100)
+
+        # unknown label
+        q = """CALL algo.sampleNodes({label: 'X', size: 10}) YIELD node
+               RETURN count(node)"""
+        self.env.assertEquals(redis_graph.query(q).result_set, [[0]])
+
+        # invalid configuration
+        try:
+            redis_graph.query("CALL algo.sampleNodes({method: 'bernoulli', rate: 2})")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("rate must be a number", str(e))
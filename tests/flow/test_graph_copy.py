@@ -0,0 +1,81 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+SRC_ID = "copy_src"
+DST_ID = "copy_dst"
+redis_con = None
+src = None
+dst = None
+
+class testGraphCopy(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global src
+        global dst
+        redis_con = self.env.getConnection()
+        src = Graph(SRC_ID, redis_con)
+        dst = Graph(DST_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        src.query("UNWIND range(0, 9) AS i CREATE (:A:B {v: i, name: 'n' + tostring(i)})")
+        src.query("MATCH (a:A), (b:A) WHERE a.v + 1 = b.v CREATE (a)-[:R {w: a.v}]->(b)")
+        # multi-edges
+        src.query("MATCH (a:A {v: 0}), (b:A {v: 1}) CREATE (a)-[:R {w: 100}]->(b), (a)-[:R {w: 101}]->(b)")
+        # leave deleted IDs behind
+        src.query("MATCH (a:A {v: 9}) DELETE a")
+        src.query("CREATE INDEX ON :A(v)")
+
+    def test01_copy(self):
+        res = redis_con.execute_command("GRAPH.COPY", SRC_ID, DST_ID)
+        self.env.assertContains("Graph copied", res)
+
+        queries = ["MATCH (n) RETURN ID(n), labels(n), n ORDER BY ID(n)",
+                   "MATCH (a)-[e]->(b) RETURN ID(a), ID(e), e.w, ID(b) ORDER BY ID(e)",
+                   "MATCH (a:A {v: 0})-[e:R]->(b:A {v: 1}) RETURN count(e)"]
+        for q in queries:
+            self.env.assertEquals(src.query(q).result_set, dst.query(q).result_set)
+
+    def test02_index(self):
+        plan = dst.execution_plan("MATCH (a:A) WHERE a.v = 3 RETURN a")
+        self.env.assertIn("Node By Index Scan", plan)
+        res = dst.query("MATCH (a:A) WHERE a.v = 3 RETURN a.name")
+        self.env.assertEquals(res.result_set, [['n3']])
+
+    def test03_independent(self):
+        dst.query("MATCH (a:A {v: 0}) SET a.v = -1")
+        dst.query("CREATE (:C)")
+
+        res = src.query("MATCH (a:A {v: 0}) RETURN count(a)")
+        self.env.assertEquals(res.result_set, [[1]])
+        res = src.query("MATCH (c:C) RETURN count(c)")
+        self.env.assertEquals(res.result_set, [[0]])
+
+        # reused IDs on the source don't show up on the copy
+        src.query("CREATE (:D)")
+        res = dst.query("MATCH (d:D) RETURN count(d)")
+        self.env.assertEquals(res.result_set, [[0]])
+
+    def test04_errors(self):
+        # destination exists
+        try:
+            redis_con.execute_command("GRAPH.COPY", SRC_ID, DST_ID)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("already exists", str(e))
+
+        # missing source
+        try:
+            redis_con.execute_command("GRAPH.COPY", "no_such_graph", "x")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+        self.env.assertEquals(redis_con.exists("x"), 0)
@@ -131,3 +131,31 @@ class testGraphCreationFlow(FlowTestsBase):
         expected_result = [['B']]
         self.env.assertEquals(result.result_set, expected_result)
 
+
+    # edges of a single type created in large batches are
+    # committed in bulk, including multiple edges connecting the same nodes
+    def test09_create_edges_in_bulk(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("bulk_edges", redis_con)
+        graph.query("UNWIND range(0, 99) AS x CREATE (:B {v: x})")
+
+        # existing edge, new edges connect the same nodes
+        graph.query("MATCH (a:B {v: 0}), (b:B {v: 1}) CREATE (a)-[:R {i: -1}]->(b)")
+
+        query = """UNWIND range(0, 299) AS x
+                   MATCH (a:B {v: x % 100}), (b:B {v: (x + 1) % 100})
+                   CREATE (a)-[:R {i: x}]->(b)"""
+        result = graph.query(query)
+        self.env.assertEquals(result.relationships_created, 300)
+
+        query = """MATCH (a:B {v: 0})-[e:R]->(b:B) RETURN b.v, e.i ORDER BY e.i"""
+        result = graph.query(query)
+        self.env.assertEquals(result.result_set, [[1, -1], [1, 0], [1, 100], [1, 200]])
+
+        query = """MATCH (a:B)<-[e:R]-(b:B) WHERE a.v = 50 RETURN b.v, count(e)"""
+        result = graph.query(query)
+        self.env.assertEquals(result.result_set, [[49, 3]])
+
+        query = """MATCH ()-[e:R]->() RETURN count(e)"""
+        result = graph.query(query)
+        self.env.assertEquals(result.result_set, [[301]])
@@ -311,3 +311,38 @@ class testGraphDeletionFlow(FlowTestsBase):
         actual_result = redis_graph.query(query)
         expected_result = []
         self.env.assertEquals(actual_result.result_set, expected_result)
+
+    def test16_bulk_delete_nodes(self):
+        # deleting many nodes collects their incident edges in bulk
+        redis_con = self.env.getConnection()
+        graph = Graph("bulk_delete", redis_con)
+
+        n = 200
+        edges = [('R', x, (x + 1) % n) for x in range(n)]    # ring
+        edges += [('R', x, x + 1) for x in range(50)]         # multi-edges
+        edges += [('S', x, x) for x in range(0, n, 10)]       # self loops
+        edges += [('S', x, n - 1 - x) for x in range(n)]      # crossing edges
+
+        graph.query("UNWIND range(0, %d) AS x CREATE (:N {v: x})" % (n - 1))
+        for t in ['R', 'S']:
+            pairs = ",".join("[%d,%d]" % (s, d) for (r, s, d) in edges if r == t)
+            graph.query("""UNWIND [%s] AS p
+                           MATCH (a:N {v: p[0]}), (b:N {v: p[1]})
+                           CREATE (a)-[:%s]->(b)""" % (pairs, t))
+
+        deleted = lambda x: x < 100
+        expected_deleted = len([e for e in edges if deleted(e[1]) or deleted(e[2])])
+
+        result = graph.query("MATCH (a:N) WHERE a.v < 100 DELETE a")
+        self.env.assertEquals(result.nodes_deleted, 100)
+        self.env.assertEquals(result.relationships_deleted, expected_deleted)
+
+        remaining = sorted([[r, s, d] for (r, s, d) in edges
+                            if not deleted(s) and not deleted(d)])
+        result = graph.query("""MATCH (a)-[e]->(b)
+                                RETURN type(e), a.v, b.v
+                                ORDER BY type(e), a.v, b.v""")
+        self.env.assertEquals(result.result_set, remaining)
+
+        result = graph.query("MATCH (a)<-[e]-(b) RETURN count(e)")
+        self.env.assertEquals(result.result_set, [[len(remaining)]])
@@ -0,0 +1,49 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "graph_matrices_test"
+redis_con = None
+redis_graph = None
+
+class testGraphMatrices(FlowTestsBase):
+    def __init__(self):
+        # merge deltas into the main matrix once they hold 10 changes
+        # rather than in the background
+        self.env = Env(decodeResponses=True,
+                       moduleArgs='DELTA_MAX_PENDING_CHANGES 10 DELTA_COMPACTION_RATIO 0')
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def matrices(self):
+        res = redis_con.execute_command("GRAPH.MATRICES", GRAPH_ID)
+        return {entry[1]: dict(zip(entry[2::2], entry[3::2])) for entry in res}
+
+    def test01_pending_changes(self):
+        redis_graph.query("UNWIND range(1, 5) AS x CREATE (:N)-[:R]->(:N)")
+
+        # changes below the threshold are kept pending
+        R = self.matrices()["R"]
+        self.env.assertEquals(R["nvals"], 0)
+        self.env.assertEquals(R["pending_additions"], 5)
+        self.env.assertEquals(R["pending_deletions"], 0)
+        self.env.assertEquals(R["flushes"], 0)
+
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:N)-[:R]->(:N)")
+
+        # exceeding the threshold merges pending changes
+        R = self.matrices()["R"]
+        self.env.assertEquals(R["nvals"], 15)
+        self.env.assertEquals(R["pending_additions"], 0)
+        self.env.assertEquals(R["flushes"], 1)
+        self.env.assertGreaterEqual(R["total_flush_us"], R["last_flush_us"])
+
+    def test02_info(self):
+        info = redis_con.info("modules")
+        stats = info[GRAPH_ID]
+        self.env.assertGreaterEqual(stats["flushes"], 1)
+        for field in ["last_flush_us", "total_flush_us", "resizes"]:
+            self.env.assertIn(field, stats)
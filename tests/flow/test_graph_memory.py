@@ -0,0 +1,68 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+from redis import ResponseError
+
+GRAPH_ID = "graph_memory_test"
+redis_con = None
+redis_graph = None
+
+class testGraphMemory(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def memory(self):
+        res = redis_con.execute_command("GRAPH.MEMORY", GRAPH_ID)
+        return dict(zip(res[::2], res[1::2]))
+
+    def test01_missing_graph(self):
+        try:
+            redis_con.execute_command("GRAPH.MEMORY", "NONE_EXISTING_GRAPH")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Invalid graph operation on empty key", str(e))
+
+    def test02_components(self):
+        redis_graph.query("CREATE ()")
+        before = self.memory()
+
+        components = ["matrices", "matrices_delta_plus", "matrices_delta_minus",
+                      "matrices_transposed", "node_blocks", "edge_blocks",
+                      "properties", "interned_strings", "cold_strings",
+                      "indexes", "adjacency_cache", "plan_cache",
+                      "result_cache"]
+        self.env.assertEquals(len(before), len(components) + 1)
+        self.env.assertEquals(before["total"],
+                              sum(before[c] for c in components))
+
+        # properties and indexes grow with the data they hold
+        redis_graph.query("""UNWIND range(0, 9999) AS x
+                             CREATE (:P {name: 'person_' + toString(x), v: x})
+                                    -[:R {w: x}]->(:P)""")
+        redis_graph.query("CREATE INDEX ON :P(v)")
+        after = self.memory()
+
+        self.env.assertGreater(after["total"], before["total"])
+        self.env.assertGreater(after["properties"], before["properties"])
+        self.env.assertGreater(after["indexes"], before["indexes"])
+        self.env.assertGreater(after["matrices"] + after["matrices_delta_plus"],
+                               before["matrices"] + before["matrices_delta_plus"])
+
+    def test03_small_graph(self):
+        # a graph holding a handful of entities doesn't reserve storage
+        # for thousands of nodes and edges
+        small_graph = Graph("small_graph_memory_test", redis_con)
+        small_graph.query("CREATE (:A {v: 1})-[:R]->(:B {v: 2})")
+        res = redis_con.execute_command("GRAPH.MEMORY", "small_graph_memory_test")
+        small = dict(zip(res[::2], res[1::2]))
+
+        self.env.assertLess(small["node_blocks"], 8192)
+        self.env.assertLess(small["edge_blocks"], 8192)
+
+        # storage grows with the graph
+        self.env.assertGreater(self.memory()["node_blocks"], small["node_blocks"])
@@ -575,3 +575,43 @@ class testGraphMergeFlow(FlowTestsBase):
         except redis.exceptions.ResponseError as e:
             # Expecting an error.
             self.env.assertIn("undefined property", str(e))
+
+    def test28_merge_indexed_upserts(self):
+        redis_con = self.env.getConnection()
+        graph = Graph("upserts", redis_con)
+        graph.query("CREATE INDEX ON :User(id)")
+        graph.query("UNWIND range(0, 9) AS x CREATE (:User {id: x, v: 0})")
+
+        # bound keys are looked up in the index directly
+        query = """UNWIND $rows AS r MERGE (n:User {id: r.id}) SET n.v = r.v"""
+        plan = graph.execution_plan(query, params={'rows': []})
+        self.env.assertIn("Node By Index Scan", plan)
+
+        # half the keys exist, keys repeat within the batch
+        # and some can't be looked up by the index
+        rows = [{'id': x % 20, 'v': x} for x in range(40)]
+        rows += [{'id': 'a', 'v': 1}, {'id': 'a', 'v': 2}, {'id': [1], 'v': 3}]
+        result = graph.query(query, params={'rows': rows})
+        self.env.assertEquals(result.nodes_created, 12)
+
+        query = """MATCH (n:User) RETURN count(n), count(DISTINCT n.id)"""
+        result = graph.query(query)
+        self.env.assertEquals(result.result_set, [[22, 22]])
+
+        # re-running the batch matches every key
+        query = """UNWIND $rows AS r MERGE (n:User {id: r.id})
+                   ON MATCH SET n.matched = true
+                   RETURN count(n)"""
+        result = graph.query(query, params={'rows': rows})
+        self.env.assertEquals(result.nodes_created, 0)
+        self.env.assertEquals(result.result_set, [[len(rows)]])
+
+        query = """MATCH (n:User) WHERE n.matched RETURN count(n)"""
+        result = graph.query(query)
+        self.env.assertEquals(result.result_set, [[22]])
+
+        # integral doubles match integer keys
+        query = """UNWIND [1.0, 2.0] AS k MERGE (n:User {id: k}) RETURN n.id ORDER BY n.id"""
+        result = graph.query(query)
+        self.env.assertEquals(result.nodes_created, 0)
+        self.env.assertEquals(result.result_set, [[1], [2]])
@@ -36,3 +36,20 @@ class testHashJoin(FlowTestsBase):
 
         self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+    def test_hashjoin_duplicates_and_types(self):
+        graph = Graph("hashjoin_types", self.env.getConnection())
+        graph.query("UNWIND range(0, 999) AS x CREATE (:A {v: x % 100}), (:B {v: toFloat(x % 50)})")
+        graph.query("CREATE (:A {s: 'x'}), (:B {s: 'x'})")
+
+        # every A value below 50 matches 10 Bs, integers join with equal floats
+        q = "MATCH (a:A), (b:B) WHERE a.v = b.v RETURN count(*)"
+        self.env.assertIn("Value Hash Join", graph.execution_plan(q))
+        self.env.assertEquals(graph.query(q).result_set, [[500 * 20]])
+
+        # NULL join values never match
+        q = "MATCH (a:A), (b:B) WHERE a.s = b.v RETURN count(*)"
+        self.env.assertEquals(graph.query(q).result_set, [[0]])
+
+        q = "MATCH (a:A), (b:B) WHERE a.s = b.s RETURN a.s, b.s"
+        self.env.assertEquals(graph.query(q).result_set, [['x', 'x']])
@@ -570,3 +570,88 @@ class testIndexScanFlow():
         expected_result = [[990000000262240069, 990000000262240067]]
         self.env.assertEquals(result.result_set, expected_result)
 
+
+    def test20_point_index_scan_accuracy(self):
+        # indexed and unindexed copies of points spread around a 1000m radius
+        redis_graph.query("CREATE INDEX ON :geo_indexed(location)")
+        q = """UNWIND range(0, 199) AS i
+        WITH point({latitude: 32.0 + i * 0.00005, longitude: 34.8}) AS p
+        CREATE (:geo_indexed {location: p}), (:geo_plain {location: p})"""
+        redis_graph.query(q)
+
+        params = {'origin': {'latitude': 32.0, 'longitude': 34.8}}
+        for radius in [100, 500, 1000]:
+            for op in ['<', '<=']:
+                filter = "distance(n.location, point($origin)) %s %d" % (op, radius)
+                ret = "RETURN distance(n.location, point($origin)) AS d ORDER BY d"
+                indexed = "MATCH (n:geo_indexed) WHERE %s %s" % (filter, ret)
+                plain = "MATCH (n:geo_plain) WHERE %s %s" % (filter, ret)
+
+                plan = redis_graph.execution_plan(indexed, params)
+                self.env.assertIn("Node By Index Scan", plan)
+
+                # index results are re-checked against the exact distance
+                expected = redis_graph.query(plain, params).result_set
+                actual = redis_graph.query(indexed, params).result_set
+                self.env.assertEquals(actual, expected)
+
+    def test21_index_scan_in_parameter_list(self):
+        # indexed and unindexed copies of the same values
+        redis_graph.query("CREATE INDEX ON :in_indexed(v)")
+        redis_graph.query("UNWIND range(0, 999) AS i CREATE (:in_indexed {v: i}), (:in_plain {v: i})")
+
+        # long lists are probed through a hash index
+        # numeric equality holds across integers and floats
+        ids = list(range(0, 2000, 7)) + [14.0, 21.5, 'a']
+        params = {'ids': ids}
+        indexed = "MATCH (n:in_indexed) WHERE n.v IN $ids RETURN n.v ORDER BY n.v"
+        plain = "MATCH (n:in_plain) WHERE n.v IN $ids RETURN n.v ORDER BY n.v"
+
+        plan = redis_graph.execution_plan(indexed, params)
+        self.env.assertIn("Node By Index Scan", plan)
+
+        expected = [[i] for i in range(0, 1000, 7)]
+        self.env.assertEquals(redis_graph.query(indexed, params).result_set, expected)
+        self.env.assertEquals(redis_graph.query(plain, params).result_set, expected)
+
+        # a null element turns a miss into null
+        params = {'ids': ids + [None]}
+        q = "MATCH (n:in_plain) WHERE n.v < 3 RETURN n.v, n.v IN $ids ORDER BY n.v"
+        res = redis_graph.query(q, params).result_set
+        self.env.assertEquals(res, [[0, True], [1, None], [2, None]])
+
+        # constant lists behave the same
+        q = "MATCH (n:in_plain) WHERE n.v < 3 RETURN n.v, n.v IN [%s] ORDER BY n.v" % \
+                ", ".join(str(i) for i in range(1, 40))
+        res = redis_graph.query(q).result_set
+        self.env.assertEquals(res, [[0, False], [1, True], [2, True]])
+
+    def test22_index_scan_string_prefix(self):
+        # indexed and unindexed copies of the same strings
+        redis_graph.query("CREATE INDEX ON :prefix_indexed(s)")
+        q = """UNWIND ['apple', 'apricot', 'ap', 'banana', 'Apple', 'a', 'aq', 'épée', 'éclair']
+        AS s CREATE (:prefix_indexed {s: s}), (:prefix_plain {s: s})"""
+        redis_graph.query(q)
+
+        filters = ["n.s STARTS WITH 'ap'",
+                   "n.s STARTS WITH $p",
+                   "n.s STARTS WITH 'é'",
+                   "n.s =~ 'ap.*t'",
+                   "n.s =~ 'apx?.*'",
+                   "n.s STARTS WITH 'ap' OR n.s = 'banana'"]
+        params = {'p': 'ap'}
+        for f in filters:
+            indexed = "MATCH (n:prefix_indexed) WHERE %s RETURN n.s ORDER BY n.s" % f
+            plain = "MATCH (n:prefix_plain) WHERE %s RETURN n.s ORDER BY n.s" % f
+
+            plan = redis_graph.execution_plan(indexed, params)
+            self.env.assertIn("Node By Index Scan", plan)
+
+            expected = redis_graph.query(plain, params).result_set
+            actual = redis_graph.query(indexed, params).result_set
+            self.env.assertEquals(actual, expected)
+
+        # patterns without a literal prefix can't utilize the index
+        q = "MATCH (n:prefix_indexed) WHERE n.s =~ '.*a' RETURN n.s"
+        plan = redis_graph.execution_plan(q)
+        self.env.assertNotIn("Node By Index Scan", plan)
@@ -200,3 +200,32 @@ class testIndexUpdatesFlow(FlowTestsBase):
         # Validate that the previous value has been removed
         result = redis_graph.query("CALL db.idx.fulltext.queryNodes('label_a', 'Group C')")
         self.env.assertEquals(len(result.result_set), 0)
+
+    # index modifications are applied once per entity when a query commits
+    # the query itself observes its own modifications through the index
+    def test08_multiple_updates_within_query(self):
+        redis_graph.query("CREATE INDEX ON :label_c(v)")
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:label_c {v: x})")
+
+        # update every node twice
+        result = redis_graph.query("MATCH (n:label_c) SET n.v = n.v + 100 WITH n SET n.v = n.v + 100")
+        self.env.assertEquals(result.properties_set, 20)
+
+        query = "MATCH (n:label_c) WHERE n.v > 200 RETURN count(n)"
+        self.env.assertIn("Index Scan", redis_graph.execution_plan(query))
+        self.env.assertEquals(redis_graph.query(query).result_set, [[10]])
+
+        query = "MATCH (n:label_c) WHERE n.v <= 200 RETURN count(n)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0]])
+
+        # read modified nodes back through the index within the same query
+        query = """MATCH (n:label_c) WHERE n.v = 201 SET n.v = 1
+                   WITH n
+                   MATCH (m:label_c) WHERE m.v = 1
+                   RETURN count(m)"""
+        self.env.assertEquals(redis_graph.query(query).result_set, [[1]])
+
+        # create and delete a node within the same query
+        redis_graph.query("CREATE (n:label_c {v: 500}) WITH n DELETE n")
+        query = "MATCH (n:label_c) WHERE n.v = 500 RETURN count(n)"
+        self.env.assertEquals(redis_graph.query(query).result_set, [[0]])
@@ -0,0 +1,40 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "info_test"
+redis_con = None
+redis_graph = None
+
+class testInfo(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def test_query_stages(self):
+        info = redis_con.info("modules")
+        queries = info["queries"]
+
+        redis_graph.query("""CREATE ()""")
+        redis_graph.query("""MATCH (n) RETURN n""")
+
+        info = redis_con.info("modules")
+        self.env.assertEquals(info["queries"], queries + 2)
+        for stage in ["wait", "lock", "plan", "execute"]:
+            self.env.assertGreaterEqual(info[stage + "_total_us"], 0)
+
+    def test_thread_pools(self):
+        redis_graph.query("""MATCH (n) RETURN n""")
+
+        info = redis_con.info("modules")
+        for pool in ["readers", "writers", "heavy"]:
+            for field in ["busy", "queued", "enqueued", "wait_p50_us",
+                          "wait_p99_us", "wait_max_us"]:
+                self.env.assertIn(pool + "_" + field, info)
+            self.env.assertLessEqual(info[pool + "_wait_p50_us"],
+                                     info[pool + "_wait_p99_us"])
+        self.env.assertGreater(info["readers_enqueued"], 0)
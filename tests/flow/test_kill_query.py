@@ -0,0 +1,73 @@
+import os
+import time
+import threading
+from RLTest import Env
+from base import FlowTestsBase
+from redis import ResponseError
+
+GRAPH_ID = "kill_query"
+SLOW_QUERY = "UNWIND range(0, 100000000) AS x WITH x WHERE x = -1 RETURN x"
+
+class testKillQuery(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        # skip test if we're running under Valgrind
+        if self.env.envRunner.debugger is not None or os.getenv('COV') == '1':
+            self.env.skip() # queries will be much slower under Valgrind
+
+        self.conn = self.env.getConnection()
+        self.conn.execute_command("GRAPH.QUERY", GRAPH_ID, "CREATE ()")
+
+    def _run_slow_query(self, errors):
+        conn = self.env.getConnection()
+        try:
+            conn.execute_command("GRAPH.RO_QUERY", GRAPH_ID, SLOW_QUERY)
+        except ResponseError as e:
+            errors.append(str(e))
+
+    def _wait_for_query(self):
+        # poll until the slow query is listed
+        for _ in range(500):
+            for q in self.conn.execute_command("GRAPH.LIST_QUERIES"):
+                if q[3] == SLOW_QUERY:
+                    return q
+            time.sleep(0.01)
+        return None
+
+    def test01_list_queries(self):
+        # no query is in-flight
+        self.env.assertEquals(self.conn.execute_command("GRAPH.LIST_QUERIES"), [])
+
+    def test02_kill_query(self):
+        errors = []
+        t = threading.Thread(target=self._run_slow_query, args=(errors,))
+        t.start()
+
+        q = self._wait_for_query()
+        self.env.assertIsNotNone(q)
+        self.env.assertEquals(q[1], GRAPH_ID)
+        self.env.assertEquals(q[2], "GRAPH.RO_QUERY")
+        self.env.assertEquals(q[5], "running")
+
+        self.env.assertEquals(self.conn.execute_command("GRAPH.KILL", q[0]), "OK")
+        t.join()
+
+        # the query aborted with an error
+        self.env.assertEquals(len(errors), 1)
+        self.env.assertContains("Query was killed", errors[0])
+
+        # the query is no longer listed
+        self.env.assertEquals(self.conn.execute_command("GRAPH.LIST_QUERIES"), [])
+
+    def test03_kill_unknown_query(self):
+        try:
+            self.conn.execute_command("GRAPH.KILL", 123456789)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Unknown query ID", str(e))
+
+        try:
+            self.conn.execute_command("GRAPH.KILL", "abc")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("Invalid query ID", str(e))
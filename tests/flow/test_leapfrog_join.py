@@ -0,0 +1,105 @@
+import random
+from RLTest import Env
+from redisgraph import Graph
+
+from base import FlowTestsBase
+
+GRAPH_ID = "leapfrog_join"
+NODE_COUNT = 40
+redis_graph = None
+edges = None
+
+# the leapfrog join resolves a node closing a cycle by intersecting
+# the adjacency rows of the nodes it is connected to, e.g.
+# MATCH (a)-[:F]->(b)-[:F]->(c)-[:F]->(a)
+# 'c' is resolved by intersecting the outgoing row of 'b'
+# with the incoming row of 'a'
+
+class testLeapfrogJoin(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        global edges
+        random.seed(7)
+        edges = set()
+        while len(edges) < 300:
+            a = random.randrange(NODE_COUNT)
+            b = random.randrange(NODE_COUNT)
+            if a != b:
+                edges.add((a, b))
+
+        # every even node is labeled P
+        redis_graph.query("UNWIND range(0, %d) AS x CREATE (:N {v: x})" % (NODE_COUNT - 1))
+        redis_graph.query("MATCH (n:N) WHERE n.v % 2 = 0 SET n:P")
+        pairs = ",".join("[%d,%d]" % e for e in sorted(edges))
+        redis_graph.query("""UNWIND [%s] AS p
+                             MATCH (a:N {v: p[0]}), (b:N {v: p[1]})
+                             CREATE (a)-[:F]->(b)""" % pairs)
+
+    def test01_triangles(self):
+        query = """MATCH (a)-[:F]->(b)-[:F]->(c)-[:F]->(a)
+                   RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Leapfrog Join", plan)
+        self.env.assertNotIn("Expand Into", plan)
+
+        expected = sorted([[a, b, c] for (a, b) in edges for (x, c) in edges
+                           if x == b and (c, a) in edges])
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+    def test02_transitive_triangles(self):
+        # edges closing the cycle run in both directions
+        query = """MATCH (a)-[:F]->(b)-[:F]->(c), (a)-[:F]->(c)
+                   RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Leapfrog Join", plan)
+
+        expected = sorted([[a, b, c] for (a, b) in edges for (x, c) in edges
+                           if x == b and (a, c) in edges])
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+    def test03_labeled_triangles(self):
+        query = """MATCH (a)-[:F]->(b)-[:F]->(c:P)-[:F]->(a)
+                   RETURN a.v, b.v, c.v ORDER BY a.v, b.v, c.v"""
+        expected = sorted([[a, b, c] for (a, b) in edges for (x, c) in edges
+                           if x == b and (c, a) in edges and c % 2 == 0])
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+    def test04_cliques(self):
+        # the last node is intersected across three rows
+        query = """MATCH (a)-[:F]->(b)-[:F]->(c), (a)-[:F]->(c),
+                         (a)-[:F]->(d), (b)-[:F]->(d), (c)-[:F]->(d)
+                   RETURN a.v, b.v, c.v, d.v ORDER BY a.v, b.v, c.v, d.v"""
+        expected = []
+        for (a, b) in edges:
+            for (x, c) in edges:
+                if x != b or (a, c) not in edges:
+                    continue
+                for d in range(NODE_COUNT):
+                    if (a, d) in edges and (b, d) in edges and (c, d) in edges:
+                        expected.append([a, b, c, d])
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, sorted(expected))
+
+    def test05_referenced_edges(self):
+        # edges are collected, cycles are closed by expand into
+        query = """MATCH (a)-[:F]->(b)-[:F]->(c)-[e:F]->(a)
+                   RETURN a.v, b.v, c.v, type(e) ORDER BY a.v, b.v, c.v"""
+        expected = sorted([[a, b, c, 'F'] for (a, b) in edges for (x, c) in edges
+                           if x == b and (c, a) in edges])
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+    def test06_missing_relationship(self):
+        query = """MATCH (a)-[:F]->(b)-[:F]->(c)-[:MISSING]->(a)
+                   RETURN a.v, b.v, c.v"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [])
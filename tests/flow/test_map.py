@@ -146,3 +146,41 @@ class testMap(FlowTestsBase):
         except redis.exceptions.ResponseError as e:
             self.env.assertIn("Encountered unhandled type", str(e))
 
+
+    # Validate map projections over multiple, missing and repeated keys.
+    def test08_map_projection_selectors(self):
+        redis_graph.query("CREATE (:P {a: 1, b: 'x', c: [1, 2]})")
+
+        query = """MATCH (p:P) RETURN p {.c, .a, .missing, .b}"""
+        query_result = redis_graph.query(query)
+        expected_result = [[{'c': [1, 2], 'a': 1, 'missing': None, 'b': 'x'}]]
+        self.env.assertEquals(query_result.result_set, expected_result)
+
+        # later selectors override earlier ones sharing their key
+        query = """MATCH (p:P) RETURN p {.a, a: 5, .b}"""
+        query_result = redis_graph.query(query)
+        expected_result = [[{'a': 5, 'b': 'x'}]]
+        self.env.assertEquals(query_result.result_set, expected_result)
+
+        # projecting maps and nulls
+        query = """WITH {a: 1} AS m RETURN m {.a, .b}"""
+        query_result = redis_graph.query(query)
+        expected_result = [[{'a': 1, 'b': None}]]
+        self.env.assertEquals(query_result.result_set, expected_result)
+
+        query = """OPTIONAL MATCH (n:Missing) RETURN n {.a}"""
+        query_result = redis_graph.query(query)
+        expected_result = [[{'a': None}]]
+        self.env.assertEquals(query_result.result_set, expected_result)
+
+    # Validate the properties function.
+    def test09_properties(self):
+        query = """MATCH (p:P) RETURN properties(p)"""
+        query_result = redis_graph.query(query)
+        expected_result = [[{'a': 1, 'b': 'x', 'c': [1, 2]}]]
+        self.env.assertEquals(query_result.result_set, expected_result)
+
+        query = """MATCH (a:L {val: 1})-[e:E]->() RETURN properties(e), properties({v: 1}), properties(null)"""
+        query_result = redis_graph.query(query)
+        expected_result = [[{}, {'v': 1}, None]]
+        self.env.assertEquals(query_result.result_set, expected_result)
@@ -0,0 +1,91 @@
+from RLTest import Env
+from redisgraph import Graph
+from redis import ResponseError
+
+from base import FlowTestsBase
+
+GRAPH_ID = "materialized_views"
+VIEW_QUERY = "MATCH (p:Product)<-[:BOUGHT]-() RETURN p.category, count(*) ORDER BY p.category"
+redis_con = None
+redis_graph = None
+
+class testMaterializedViews(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("""CREATE (a:Product {category: 'a'}), (b:Product {category: 'b'}),
+                             (c:Customer), (c)-[:BOUGHT]->(a), (c)-[:BOUGHT]->(b), (c)-[:BOUGHT]->(a)""")
+
+    def read_view(self):
+        res = redis_con.execute_command("GRAPH.VIEW", GRAPH_ID, "READ", "purchases")
+        cached = any("Cached execution: 1" in stat for stat in res[2])
+        return res[1], cached
+
+    def test01_create_view(self):
+        res = redis_con.execute_command("GRAPH.VIEW", GRAPH_ID, "CREATE", "purchases", VIEW_QUERY)
+        self.env.assertEquals(res, "OK")
+
+        # view names are unique
+        try:
+            redis_con.execute_command("GRAPH.VIEW", GRAPH_ID, "CREATE", "purchases", VIEW_QUERY)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("already exists", str(e))
+
+        # views are defined by read-only queries
+        try:
+            redis_con.execute_command("GRAPH.VIEW", GRAPH_ID, "CREATE", "w", "CREATE ()")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("read-only", str(e))
+
+    def test02_read_view(self):
+        # first read executes the view's query
+        rows, cached = self.read_view()
+        self.env.assertEquals(rows, [['a', 2], ['b', 1]])
+        self.env.assertFalse(cached)
+
+        # following reads replay the result
+        rows, cached = self.read_view()
+        self.env.assertEquals(rows, [['a', 2], ['b', 1]])
+        self.env.assertTrue(cached)
+
+    def test03_unrelated_modifications(self):
+        # modifications of labels the view doesn't depend on keep its result
+        redis_graph.query("CREATE (:Other {v: 1})")
+        redis_graph.query("MATCH (c:Customer) SET c.name = 'x'")
+        rows, cached = self.read_view()
+        self.env.assertEquals(rows, [['a', 2], ['b', 1]])
+        self.env.assertTrue(cached)
+
+    def test04_dependent_modifications(self):
+        # new purchase
+        redis_graph.query("MATCH (c:Customer), (p:Product {category: 'b'}) CREATE (c)-[:BOUGHT]->(p)")
+        rows, cached = self.read_view()
+        self.env.assertEquals(rows, [['a', 2], ['b', 2]])
+        self.env.assertFalse(cached)
+
+        # product update
+        redis_graph.query("MATCH (p:Product {category: 'b'}) SET p.category = 'c'")
+        rows, cached = self.read_view()
+        self.env.assertEquals(rows, [['a', 2], ['c', 2]])
+        self.env.assertFalse(cached)
+
+        # purchase deletion
+        redis_graph.query("MATCH (:Product {category: 'a'})<-[e:BOUGHT]-() WITH e LIMIT 1 DELETE e")
+        rows, cached = self.read_view()
+        self.env.assertEquals(rows, [['a', 1], ['c', 2]])
+        self.env.assertFalse(cached)
+
+    def test05_drop_view(self):
+        res = redis_con.execute_command("GRAPH.VIEW", GRAPH_ID, "DROP", "purchases")
+        self.env.assertEquals(res, "OK")
+
+        try:
+            self.read_view()
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("unknown view", str(e))
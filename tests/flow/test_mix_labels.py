@@ -88,3 +88,21 @@ class testGraphMixLabelsFlow(FlowTestsBase):
         query = """MATCH (f)-[:knows]->(t) RETURN f,t ORDER BY f.name"""
         actual_result = redis_graph.query(query)
         self.env.assertEquals(len(actual_result.result_set), (len(male+female) * (len(male+female)-1)))
+
+    def test_selective_destination_label(self):
+        # few destinations carry the label, the label is applied as a mask
+        g = Graph("selective_label", self.env.getConnection())
+        g.query("UNWIND range(0, 99) AS x CREATE (:S {v: x})-[:R]->(:T {v: x})")
+        g.query("MATCH (t:T) WHERE t.v % 10 = 0 SET t:Rare")
+
+        query = """MATCH (s:S)-[:R]->(t:Rare) RETURN t.v ORDER BY t.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[v] for v in range(0, 100, 10)])
+
+        # pending additions and deletions are accounted for
+        g.query("MATCH (s:S {v: 0})-[e:R]->() DELETE e")
+        g.query("MATCH (s:S {v: 1}), (t:Rare {v: 10}) CREATE (s)-[:R]->(t)")
+        query = """MATCH (s:S)-[:R]->(t:Rare) RETURN s.v, t.v ORDER BY s.v, t.v"""
+        actual_result = g.query(query)
+        expected = [[1, 10]] + [[v, v] for v in range(10, 100, 10)]
+        self.env.assertEquals(actual_result.result_set, expected)
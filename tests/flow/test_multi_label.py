@@ -231,3 +231,57 @@ class testMultiLabel():
         self.env.assertEquals(query_result.nodes_created, 2)
         self.env.assertEquals(query_result.relationships_created, 2)
 
+
+    def test10_label_intersection_scan(self):
+        graph = Graph('intersect', self.redis_con)
+
+        # 10 A nodes, 5 of which are also B, 2 of which are also C
+        graph.query("UNWIND range(0, 9) AS x CREATE (:A {v: x})")
+        graph.query("MATCH (n:A) WHERE n.v < 5 SET n:B")
+        graph.query("MATCH (n:A) WHERE n.v < 2 SET n:C")
+        graph.query("MATCH (n:A {v: 0}) CREATE (n)-[:R]->(:D)")
+
+        # labels are intersected by the scan, no traversal checks them
+        query = "MATCH (n:A:B) RETURN n.v ORDER BY n.v"
+        plan = graph.execution_plan(query)
+        self.env.assertContains("Node By Label Scan | (n:B) | intersect :A", plan)
+        self.env.assertNotIn("Conditional Traverse", plan)
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[0], [1], [2], [3], [4]])
+
+        # label negation is applied as a complemented mask
+        query = "MATCH (n:B) WHERE NOT n:C RETURN n.v ORDER BY n.v"
+        plan = graph.execution_plan(query)
+        self.env.assertContains("Node By Label Scan | (n:B) | exclude :C", plan)
+        self.env.assertNotIn("Filter", plan)
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[2], [3], [4]])
+
+        # label filters are absorbed as well
+        query = "MATCH (n:A) WHERE n:C RETURN n.v ORDER BY n.v"
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[0], [1]])
+
+        # counting a multi-label scan isn't reduced to a label count
+        query = "MATCH (n:A:B:C) RETURN count(n)"
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[2]])
+
+        # intersected scan followed by a traversal
+        query = "MATCH (n:C:A)-[:R]->(m:D) RETURN n.v"
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[0]])
+
+        # missing labels
+        query = "MATCH (n:A:X) RETURN count(n)"
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[0]])
+
+        query = "MATCH (n:A) WHERE NOT n:X RETURN count(n)"
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[10]])
+
+        # ID range over an intersected scan
+        query = "MATCH (n:A:B) WHERE id(n) > 2 RETURN n.v ORDER BY n.v"
+        result = graph.query(query).result_set
+        self.env.assertEquals(result, [[3], [4]])
@@ -0,0 +1,68 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "multi_ro_query"
+redis_con = None
+graph = None
+
+class testMultiReadOnlyQuery(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global graph
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        graph.query("UNWIND range(1, 10) AS i CREATE (:N {v: i})")
+
+    def test01_batch_results(self):
+        # each query replies with its own result-set, in order
+        res = redis_con.execute_command("GRAPH.MULTI_RO_QUERY", GRAPH_ID,
+                "MATCH (n:N) RETURN count(n)",
+                "CYPHER v=3 MATCH (n:N {v: $v}) RETURN n.v",
+                "MATCH (n:N) WHERE n.v > 8 RETURN n.v ORDER BY n.v",
+                "--compact")
+
+        self.env.assertEquals(len(res), 3)
+        expected = [[[10]], [[3]], [[9], [10]]]
+        for i in range(3):
+            rows = [[cell[1] for cell in row] for row in res[i][1]]
+            self.env.assertEquals(rows, expected[i])
+
+    def test02_batch_matches_single_query(self):
+        q = "MATCH (n:N) WHERE n.v < 3 RETURN n.v ORDER BY n.v"
+        single = redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, q)
+        batch = redis_con.execute_command("GRAPH.MULTI_RO_QUERY", GRAPH_ID, q)
+        self.env.assertEquals(len(batch), 1)
+        self.env.assertEquals(batch[0][0], single[0])
+        self.env.assertEquals(batch[0][1], single[1])
+
+    def test03_write_query_rejected(self):
+        # a failing query is replied with an error in its position
+        # while the rest of the batch executes
+        res = redis_con.execute_command("GRAPH.MULTI_RO_QUERY", GRAPH_ID,
+                "CREATE ()", "MATCH (n:N) RETURN count(n)", "RETURN a")
+
+        self.env.assertEquals(len(res), 3)
+        self.env.assertTrue(isinstance(res[0], redis.exceptions.ResponseError))
+        self.env.assertContains("read-only", str(res[0]))
+        self.env.assertEquals(res[1][1], [[10]])
+        self.env.assertTrue(isinstance(res[2], redis.exceptions.ResponseError))
+
+        # graph wasn't modified
+        res = graph.query("MATCH (n) RETURN count(n)")
+        self.env.assertEquals(res.result_set[0][0], 10)
+
+    def test04_missing_queries(self):
+        try:
+            redis_con.execute_command("GRAPH.MULTI_RO_QUERY", GRAPH_ID,
+                    "--compact")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("no queries", str(e))
@@ -99,3 +99,38 @@ class testGraphMultipleEdgeFlow(FlowTestsBase):
         actual_result = redis_graph.query(query)
         edge_count = actual_result.result_set[0][0]
         self.env.assertEquals(edge_count, 1)
+
+    # Edges of a batch of traversals are resolved together.
+    def test_batched_edges(self):
+        g = Graph("multi_edge_batch", self.env.getConnection())
+
+        # Ring of 50 nodes, each connected to the next by two R edges
+        # and a single S edge.
+        query = """UNWIND range(0, 49) AS i CREATE (:N {v:i})"""
+        g.query(query)
+        query = """MATCH (a:N), (b:N) WHERE b.v = (a.v + 1) % 50
+                   CREATE (a)-[:R {w:a.v}]->(b), (a)-[:R {w:a.v}]->(b), (a)-[:S]->(b)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.relationships_created, 150)
+
+        # Each edge is attached to its own endpoints.
+        queries = ["""MATCH (a:N)-[e:R]->(b:N) RETURN count(e), sum(e.w)""",
+                   """MATCH (b:N)<-[e:R]-(a:N) RETURN count(e), sum(e.w)""",
+                   """MATCH (a:N)-[:S]->(b:N) MATCH (a)-[e:R]->(b) RETURN count(e), sum(e.w)"""]
+        for query in queries:
+            actual_result = g.query(query)
+            self.env.assertEquals(actual_result.result_set, [[100, 2450]])
+
+        query = """MATCH (a:N)-[e:R]->(b:N) WHERE e.w <> a.v OR b.v <> (a.v + 1) % 50 RETURN count(e)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[0]])
+
+        # Multiple relationship types.
+        query = """MATCH (a:N)-[e:R|S]->(b:N) RETURN count(e)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[150]])
+
+        # Bidirectional traversals match each edge from both of its endpoints.
+        query = """MATCH (a:N)-[e]-(b:N) RETURN count(e)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[300]])
@@ -0,0 +1,220 @@
+from RLTest import Env
+from redisgraph import Graph, Node, Edge
+
+from base import FlowTestsBase
+
+GRAPH_ID = "native_index"
+redis_graph = None
+
+class testNativeIndex(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='NATIVE_INDEX yes')
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # indexed label L and an identical unindexed label U
+        redis_graph.query("UNWIND range(-10, 10) AS x CREATE (:L {v: x, s: 's' + toString(x + 10)}), (:U {v: x, s: 's' + toString(x + 10)})")
+        redis_graph.query("UNWIND range(-10, 10) AS x CREATE (:L {v: x / 4.0}), (:U {v: x / 4.0})")
+        redis_graph.query("CREATE (:L {v: true}), (:U {v: true}), (:L {v: [1]}), (:U {v: [1]})")
+        redis_graph.query("CREATE INDEX ON :L(v)")
+        redis_graph.query("CREATE INDEX ON :L(s)")
+
+    # compare indexed results against the same query over the unindexed label
+    def compare(self, predicate):
+        query = "MATCH (n:L) WHERE %s RETURN n.v, n.s ORDER BY n.v, n.s" % predicate
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn('Node By Index Scan', plan)
+        indexed = redis_graph.query(query).result_set
+
+        query = "MATCH (n:U) WHERE %s RETURN n.v, n.s ORDER BY n.v, n.s" % predicate
+        unindexed = redis_graph.query(query).result_set
+
+        self.env.assertEquals(indexed, unindexed)
+        return indexed
+
+    def test01_equality(self):
+        self.env.assertEquals(len(self.compare("n.v = 1")), 2)
+        self.env.assertEquals(len(self.compare("n.v = 0.25")), 1)
+        self.env.assertEquals(len(self.compare("n.v = 100")), 0)
+        self.env.assertEquals(len(self.compare("n.s = 's03'")), 0)
+        self.env.assertEquals(len(self.compare("n.s = 's3'")), 1)
+
+    def test02_ranges(self):
+        self.compare("n.v > 1")
+        self.compare("n.v >= -2 AND n.v < 2")
+        self.compare("n.v > 2 AND n.v < 1")
+        self.compare("n.v <= -1.5")
+        self.compare("n.s >= 's1' AND n.s < 's2'")
+        self.compare("n.s > 's9'")
+
+    def test03_runtime_values(self):
+        query = "UNWIND [-1, 0, 2] AS x MATCH (n:L) WHERE n.v = x RETURN x, n.v ORDER BY x, n.v"
+        indexed = redis_graph.query(query).result_set
+        query = "UNWIND [-1, 0, 2] AS x MATCH (n:U) WHERE n.v = x RETURN x, n.v ORDER BY x, n.v"
+        unindexed = redis_graph.query(query).result_set
+        self.env.assertEquals(indexed, unindexed)
+
+    def test04_updates(self):
+        redis_graph.query("MATCH (n:L {v: 5}) SET n.v = 50")
+        redis_graph.query("MATCH (n:U {v: 5}) SET n.v = 50")
+        self.env.assertEquals(len(self.compare("n.v = 5")), 0)
+        self.env.assertEquals(len(self.compare("n.v = 50")), 1)
+
+        redis_graph.query("MATCH (n:L {v: 50}) SET n.v = 'fifty'")
+        redis_graph.query("MATCH (n:U {v: 50}) SET n.v = 'fifty'")
+        self.env.assertEquals(len(self.compare("n.v = 50")), 0)
+        self.env.assertEquals(len(self.compare("n.v = 'fifty'")), 1)
+
+        redis_graph.query("MATCH (n:L {v: 'fifty'}) DELETE n")
+        redis_graph.query("MATCH (n:U {v: 'fifty'}) DELETE n")
+        self.env.assertEquals(len(self.compare("n.v = 'fifty'")), 0)
+        self.compare("n.v > 0")
+
+        redis_graph.query("CREATE (:L {v: 7}), (:U {v: 7})")
+        self.env.assertEquals(len(self.compare("n.v = 7")), 2)
+
+    # compare composite lookups over label C against unindexed label D
+    def compare_composite(self, predicate):
+        query = "MATCH (n:C) WHERE %s RETURN n.country, n.city, n.pop ORDER BY n.country, n.city, n.pop" % predicate
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn('Node By Index Scan', plan)
+        indexed = redis_graph.query(query).result_set
+
+        query = "MATCH (n:D) WHERE %s RETURN n.country, n.city, n.pop ORDER BY n.country, n.city, n.pop" % predicate
+        unindexed = redis_graph.query(query).result_set
+
+        self.env.assertEquals(indexed, unindexed)
+        return indexed
+
+    def test05_composite(self):
+        redis_graph.query("UNWIND range(0, 59) AS x CREATE (:C {country: ['NL', 'FR', 'DE'][x % 3], city: 'c' + toString(x % 10), pop: x}), (:D {country: ['NL', 'FR', 'DE'][x % 3], city: 'c' + toString(x % 10), pop: x})")
+        redis_graph.query("CREATE (:C {city: 'c1', pop: 100}), (:D {city: 'c1', pop: 100})")
+        redis_graph.query("CREATE INDEX ON :C(country, city, pop)")
+
+        # equality prefix
+        self.env.assertEquals(len(self.compare_composite("n.country = 'NL'")), 20)
+        self.env.assertEquals(len(self.compare_composite("n.country = 'NL' AND n.city = 'c3'")), 2)
+        self.env.assertEquals(len(self.compare_composite("n.country = 'NL' AND n.city = 'c3' AND n.pop = 3")), 1)
+
+        # equality prefix followed by a range
+        self.compare_composite("n.country = 'FR' AND n.city >= 'c2' AND n.city < 'c5'")
+        self.compare_composite("n.country = 'DE' AND n.city = 'c5' AND n.pop > 10")
+
+        # predicates beyond the matched prefix
+        self.compare_composite("n.country = 'NL' AND n.pop < 30")
+        self.compare_composite("n.country > 'E' AND n.city = 'c1'")
+
+        # lookups not fixing the first indexed property
+        self.env.assertEquals(len(self.compare_composite("n.city = 'c1'")), 7)
+        self.compare_composite("n.city = 'c1' AND n.pop > 50")
+
+        # updates
+        redis_graph.query("MATCH (n:C {pop: 3}) SET n.country = 'FR'")
+        redis_graph.query("MATCH (n:D {pop: 3}) SET n.country = 'FR'")
+        self.env.assertEquals(len(self.compare_composite("n.country = 'NL' AND n.city = 'c3'")), 1)
+        self.env.assertEquals(len(self.compare_composite("n.country = 'FR' AND n.city = 'c3'")), 3)
+
+        # dropping the leading property re-orders the composite index
+        redis_graph.query("DROP INDEX ON :C(country)")
+        self.env.assertEquals(len(self.compare_composite("n.city = 'c1' AND n.pop > 50")), 2)
+        self.compare_composite("n.city = 'c3'")
+
+    def test06_index_only_scan(self):
+        # projections of indexed properties are read from the index
+        queries = ["MATCH (n:{label}) WHERE n.v > 1 RETURN n.v ORDER BY n.v",
+                   "MATCH (n:{label}) WHERE n.v >= -2 AND n.v < 2 RETURN n.v, n.s ORDER BY n.v, n.s",
+                   "MATCH (n:{label}) WHERE n.s > 's1' RETURN toUpper(n.s) AS s, n.v * 2 AS v ORDER BY s, v",
+                   "MATCH (n:{label}) WHERE n.v < 0 RETURN n.s, count(n), max(n.v) ORDER BY n.s",
+                   "MATCH (n:{label}) WHERE n.v > 0 RETURN DISTINCT n.s ORDER BY n.s"]
+
+        for q in queries:
+            plan = redis_graph.execution_plan(q.format(label='L'))
+            self.env.assertIn('Index Only', plan)
+            indexed = redis_graph.query(q.format(label='L')).result_set
+            unindexed = redis_graph.query(q.format(label='U')).result_set
+            self.env.assertEquals(indexed, unindexed)
+
+        # integers and floats are returned as stored
+        result = redis_graph.query("MATCH (n:L) WHERE n.v = 1 RETURN n.v").result_set
+        self.env.assertEquals(sorted(type(row[0]).__name__ for row in result), ['float', 'int'])
+
+        # composite lookups project the properties held by their key
+        q = "MATCH (n:{label}) WHERE n.city = 'c1' AND n.pop > 20 RETURN n.city, n.pop ORDER BY n.pop"
+        plan = redis_graph.execution_plan(q.format(label='C'))
+        self.env.assertIn('Index Only', plan)
+        indexed = redis_graph.query(q.format(label='C')).result_set
+        unindexed = redis_graph.query(q.format(label='D')).result_set
+        self.env.assertEquals(indexed, unindexed)
+
+        # accessing the node itself or unindexed properties requires the node
+        for q in ["MATCH (n:L) WHERE n.v > 1 RETURN n",
+                  "MATCH (n:L) WHERE n.v > 1 RETURN n.v, id(n)",
+                  "MATCH (n:L) WHERE n.v > 1 RETURN n.w"]:
+            plan = redis_graph.execution_plan(q)
+            self.env.assertNotIn('Index Only', plan)
+
+    def test07_index_order(self):
+        # sorting by an indexed property bounded by the filter is
+        # satisfied by the index, in either direction
+        queries = ["MATCH (n:{label}) WHERE n.v > -2 RETURN n.v ORDER BY n.v LIMIT 5",
+                   "MATCH (n:{label}) WHERE n.v <= 2 RETURN n.v ORDER BY n.v DESC LIMIT 5",
+                   "MATCH (n:{label}) WHERE n.s >= 's12' RETURN n.s, n.v ORDER BY n.s DESC",
+                   "MATCH (n:{label}) WHERE n.v > 0 AND n.s < 's15' RETURN n.s ORDER BY n.v SKIP 1 LIMIT 2"]
+
+        for q in queries:
+            plan = redis_graph.execution_plan(q.format(label='L'))
+            self.env.assertIn('Ordered', plan)
+            self.env.assertNotIn('Sort', plan)
+            indexed = redis_graph.query(q.format(label='L')).result_set
+            unindexed = redis_graph.query(q.format(label='U')).result_set
+            self.env.assertEquals(indexed, unindexed)
+
+        # nodes missing the property would be skipped by the index
+        # sorting by a property the filter doesn't bound requires a sort
+        for q in ["MATCH (n:L) WHERE n.v > 0 RETURN n ORDER BY n.s",
+                  "MATCH (n:L) WHERE n.v > 0 OR n.v < -5 RETURN n ORDER BY n.v",
+                  "MATCH (n:L) WHERE n.v > 0 RETURN n ORDER BY n.v, n.s"]:
+            plan = redis_graph.execution_plan(q)
+            self.env.assertIn('Sort', plan)
+
+        # label scans produce nodes by ascending ID
+        q = "MATCH (n:{label}) RETURN id(n) ORDER BY id(n) LIMIT 3"
+        plan = redis_graph.execution_plan(q.format(label='U'))
+        self.env.assertNotIn('Sort', plan)
+        result = redis_graph.query(q.format(label='U')).result_set
+        ids = [row[0] for row in result]
+        self.env.assertEquals(ids, sorted(ids))
+
+        plan = redis_graph.execution_plan("MATCH (n:U) RETURN n ORDER BY id(n) DESC LIMIT 3")
+        self.env.assertIn('Sort', plan)
+
+    def test08_index_aggregate(self):
+        # counts and extremes over a scan are answered by the scan itself
+        queries = [("MATCH (n:{label}) WHERE n.v > 0 RETURN count(n)", 'Count'),
+                   ("MATCH (n:{label}) WHERE n.v >= -2 AND n.v < 2 RETURN count(n) AS c", 'Count'),
+                   ("MATCH (n:{label}) WHERE n.v > 100 RETURN count(n)", 'Count'),
+                   ("MATCH (n:{label}) WHERE n.v > 0 AND n.s < 's15' RETURN count(n)", 'Count'),
+                   ("MATCH (n:{label}) WHERE n.v > 0 RETURN max(n.v)", 'Max'),
+                   ("MATCH (n:{label}) WHERE n.v < 0 RETURN min(n.v)", 'Min'),
+                   ("MATCH (n:{label}) WHERE n.s > 's1' RETURN max(n.s)", 'Max'),
+                   ("MATCH (n:{label}) WHERE n.v > 100 RETURN min(n.v)", 'Min'),
+                   ("MATCH (n:{label}) WHERE n.v > 0 AND n.s < 's15' RETURN max(n.v)", 'Max')]
+
+        for q, op in queries:
+            plan = redis_graph.execution_plan(q.format(label='L'))
+            self.env.assertIn(op, plan)
+            self.env.assertNotIn('Aggregate', plan)
+            indexed = redis_graph.query(q.format(label='L'))
+            unindexed = redis_graph.query(q.format(label='U'))
+            self.env.assertEquals(indexed.header, unindexed.header)
+            self.env.assertEquals(indexed.result_set, unindexed.result_set)
+
+        # extremes of attributes the filter doesn't bound require aggregation
+        for q in ["MATCH (n:L) WHERE n.s > 's1' RETURN max(n.v)",
+                  "MATCH (n:L) WHERE n.v > 0 RETURN count(DISTINCT n)",
+                  "MATCH (n:L) WHERE n.v > 0 RETURN n.s, count(n)"]:
+            plan = redis_graph.execution_plan(q)
+            self.env.assertIn('Aggregate', plan)
@@ -239,3 +239,32 @@ class testNodeByIDFlow(FlowTestsBase):
             resultset = redis_graph.query(query).result_set        
             self.env.assertEquals(len(resultset), 0)    # Expecting no results.
             self.env.assertIn("Node By Label and ID Scan", redis_graph.execution_plan(query))
+
+    # Fetch entities by a list of IDs.
+    def test_get_nodes_by_id_list(self):
+        # duplicates, negative and out of range IDs are ignored
+        query = """MATCH (n) WHERE ID(n) IN [7, 2, 2, -1, 999, 5] RETURN n.id ORDER BY n.id"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("NodeByIdSeek", plan)
+        self.env.assertNotIn("Filter", plan)
+        resultset = redis_graph.query(query).result_set
+        self.env.assertEquals(resultset, [[2], [5], [7]])
+
+        # labeled node, label is verified by a filter
+        query = """MATCH (n:person) WHERE ID(n) IN [1, 3] RETURN n.id ORDER BY n.id"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("NodeByIdSeek", plan)
+        resultset = redis_graph.query(query).result_set
+        self.env.assertEquals(resultset, [[1], [3]])
+
+        query = """MATCH (n:none) WHERE ID(n) IN [1, 3] RETURN n.id"""
+        resultset = redis_graph.query(query).result_set
+        self.env.assertEquals(resultset, [])
+
+        # the ID list is read on every execution of a cached plan
+        query = """MATCH (n) WHERE ID(n) IN $ids RETURN n.id ORDER BY n.id"""
+        self.env.assertIn("NodeByIdSeek", redis_graph.execution_plan(query, {'ids': [4]}))
+        for ids in [[4], [9, 0], [], [100]]:
+            resultset = redis_graph.query(query, {'ids': ids}).result_set
+            expected = [[i] for i in sorted(ids) if i < 10]
+            self.env.assertEquals(resultset, expected)
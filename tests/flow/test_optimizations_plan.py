@@ -1,6 +1,7 @@
 from base import FlowTestsBase
 import os
 import sys
+import redis
 from RLTest import Env
 from redisgraph import Graph, Node, Edge
 
@@ -431,3 +432,210 @@ class testOptimizationsPlan(FlowTestsBase):
                     [0, 3],
                     [0, 3]]
         self.env.assertEqual(resultset, expected)
+
+    # Traversals should start from the label with fewer nodes
+    # when expressions are otherwise scored equally.
+    def test28_entry_point_by_label_cardinality(self):
+        g = Graph("cardinality", redis_con)
+        g.query("UNWIND range(1, 100) AS x CREATE (:Big {v: x})")
+        g.query("UNWIND range(1, 5) AS x CREATE (:Small {v: x})")
+        g.query("MATCH (b:Big), (s:Small) WHERE b.v = s.v CREATE (b)-[:R]->(s)")
+
+        for q in ["MATCH (b:Big)-[:R]->(s:Small) RETURN count(b)",
+                  "MATCH (s:Small)<-[:R]-(b:Big) RETURN count(b)"]:
+            plan = g.execution_plan(q)
+            self.env.assertIn("Node By Label Scan | (s:Small)", plan)
+            self.env.assertEqual(g.query(q).result_set, [[5]])
+
+    # Filters on renamed WITH projections should be applied
+    # within the projected scope, unless a LIMIT is in the way.
+    def test29_push_down_filters_across_with(self):
+        query = """MATCH (n:person) WITH n AS u WHERE u.val = 1 RETURN u.name"""
+        plan = graph.execution_plan(query).split('\n')
+        ops = [op.strip() for op in plan]
+        filter_idx = next(i for i, op in enumerate(ops) if op.startswith("Filter"))
+        project_idx = max(i for i, op in enumerate(ops) if op.startswith("Project"))
+        self.env.assertGreater(filter_idx, project_idx)
+        self.env.assertEqual(graph.query(query).result_set, [["Alon"]])
+
+        query = """MATCH (n:person) WITH n AS u ORDER BY u.val LIMIT 2 WHERE u.val = 1 RETURN u.name"""
+        plan = graph.execution_plan(query).split('\n')
+        ops = [op.strip() for op in plan]
+        filter_idx = next(i for i, op in enumerate(ops) if op.startswith("Filter"))
+        limit_idx = next(i for i, op in enumerate(ops) if op.startswith("Limit"))
+        self.env.assertLess(filter_idx, limit_idx)
+        self.env.assertEqual(graph.query(query).result_set, [["Alon"]])
+
+        # filters on the bound branch of an OPTIONAL MATCH
+        query = """MATCH (a:person) OPTIONAL MATCH (a)-[:know]->(b {name: 'Roi'}) WITH a, b WHERE a.val > 1 RETURN DISTINCT a.name, b.name ORDER BY a.name"""
+        expected = [["Ailon", "Roi"], ["Boaz", "Roi"]]
+        self.env.assertEqual(graph.query(query).result_set, expected)
+
+    # Counting traversal destinations grouped by source should
+    # reduce the traversal's result rows rather than emit each destination.
+    def test30_reduce_destination_count(self):
+        expected = [["Ailon", 3], ["Alon", 3], ["Boaz", 3], ["Roi", 3]]
+        for query in ["MATCH (a:person)-[:know]->(b) RETURN a.name, count(b) ORDER BY a.name",
+                      "MATCH (a:person)-[:know]->(b:person) RETURN a.name, count(*) ORDER BY a.name"]:
+            plan = graph.execution_plan(query)
+            self.env.assertIn("Conditional Traverse Count", plan)
+            self.env.assertEqual(graph.query(query).result_set, expected)
+
+        # populated edges are counted off the relation matrix,
+        # multiple edges connecting the same pair of nodes are each counted
+        query = """MATCH (a:person)-[e:know]->(b) RETURN a.name, count(b) ORDER BY a.name"""
+        plan = graph.execution_plan(query)
+        self.env.assertIn("Conditional Traverse Count", plan)
+        self.env.assertEqual(graph.query(query).result_set,
+                             [[name, 6] for name, _ in expected])
+
+        # destinations filtered by a predicate can't be counted off the matrix
+        query = """MATCH (a:person)-[:know]->(b) WHERE b.val > 0 RETURN a.name, count(b) ORDER BY a.name"""
+        plan = graph.execution_plan(query)
+        self.env.assertNotIn("Conditional Traverse Count", plan)
+        # Roi's val is 0, excluded as a destination of everyone else
+        self.env.assertEqual(graph.query(query).result_set,
+                             [["Ailon", 2], ["Alon", 2], ["Boaz", 2], ["Roi", 3]])
+
+    # Per node relationship counts should be read off the relation matrix,
+    # multiple edges connecting the same pair of nodes are counted once populated.
+    def test31_reduce_node_degree_count(self):
+        query = """MATCH (n)-[:know]->() WHERE ID(n) = 0 RETURN count(*)"""
+        plan = graph.execution_plan(query)
+        self.env.assertIn("Conditional Traverse Count", plan)
+        self.env.assertEqual(graph.query(query).result_set, [[3]])
+
+        query = """MATCH (n)-[e:know]->() WHERE ID(n) = 0 RETURN count(e)"""
+        plan = graph.execution_plan(query)
+        self.env.assertIn("Conditional Traverse Count", plan)
+        self.env.assertEqual(graph.query(query).result_set, [[6]])
+
+        # node without outgoing edges of the given type
+        query = """MATCH (n)-[e:works_with]->() WHERE ID(n) = 100 RETURN count(e)"""
+        self.env.assertEqual(graph.query(query).result_set, [[0]])
+
+    # Traversals under a small limit extract destinations row by row,
+    # producing the same records as a full traversal.
+    def test32_lazy_traversal_under_limit(self):
+        for query in ["MATCH (a:person)-[:know]->(b:person) RETURN a.name, b.name",
+                      "MATCH (a:person)<-[:know]-(b) RETURN a.name, b.name",
+                      "MATCH (a:person)-[e:know]->(b) RETURN a.name, b.name"]:
+            expected = graph.query(query).result_set
+            for limit in [1, 5, 7]:
+                actual = graph.query(query + " LIMIT %d" % limit).result_set
+                self.env.assertEqual(actual, expected[:limit])
+
+    # Branches of a Cartesian Product are combined in order of
+    # estimated cardinality, filters are applied as soon as resolved.
+    def test33_join_order(self):
+        g = Graph("join_order", redis_con)
+        g.query("UNWIND range(1, 50) AS x CREATE (:A {v: x}), (:B {v: x})")
+        g.query("UNWIND range(1, 3) AS x CREATE (:C {v: x})")
+
+        query = """MATCH (a:A), (b:B), (c:C) WHERE a.v = c.v AND b.v = c.v RETURN count(*)"""
+        plan = g.execution_plan(query)
+        self.env.assertEqual(2, plan.count("Value Hash Join"))
+        self.env.assertNotIn("Cartesian Product", plan)
+        self.env.assertEqual(g.query(query).result_set, [[3]])
+
+        query = """MATCH (a:A), (b:B), (c:C) WHERE a.v < c.v AND b.v <> a.v RETURN count(*)"""
+        plan = g.execution_plan(query)
+        self.env.assertEqual(2, plan.count("Cartesian Product"))
+        self.env.assertEqual(g.query(query).result_set, [[147]])
+        g.delete()
+
+    # Filters which can't be reduced to joins are applied by the
+    # Cartesian Product, whose inner branches are executed once.
+    def test34_filtered_cartesian_product(self):
+        g = Graph("filtered_product", redis_con)
+        g.query("UNWIND range(1, 20) AS x CREATE (:A {v: x}), (:B {v: x})")
+
+        query = """MATCH (a:A), (b:B) WHERE a.v < b.v RETURN a.v, b.v ORDER BY a.v, b.v"""
+        plan = g.execution_plan(query)
+        self.env.assertIn("Filtered Cartesian Product", plan)
+        self.env.assertNotIn("Filter\n", plan)
+        expected = [[a, b] for a in range(1, 21) for b in range(1, 21) if a < b]
+        self.env.assertEqual(g.query(query).result_set, expected)
+
+        query = """MATCH (a:A), (b:B), (c:A) RETURN count(*)"""
+        self.env.assertEqual(g.query(query).result_set, [[8000]])
+
+        # products are re-executed once their bound variables change
+        query = """UNWIND [5, 10, 15] AS x MATCH (a:A), (b:B) WHERE a.v + b.v = x AND a.v < b.v RETURN x, count(*) ORDER BY x"""
+        self.env.assertEqual(g.query(query).result_set, [[5, 2], [10, 4], [15, 7]])
+        g.delete()
+
+    # Skips fed by scans through projections alone are performed by the
+    # scans, producing the same records as skipping produced records.
+    def test35_skip_pushdown(self):
+        g = Graph("skip_pushdown", redis_con)
+        g.query("UNWIND range(0, 99) AS x CREATE (:A {v: x}), (:B {v: x})")
+
+        queries = ["MATCH (n:A) RETURN n.v",
+                   "MATCH (n) RETURN n.v",
+                   "MATCH (n:A) WHERE id(n) >= 10 AND id(n) < 150 RETURN n.v",
+                   "MATCH (n:A) WITH n AS m RETURN m.v * 2"]
+
+        def check():
+            for query in queries:
+                expected = g.query(query).result_set
+                for skip in [0, 1, 37, 99, 250]:
+                    actual = g.query(query + " SKIP $s LIMIT 10", {'s': skip}).result_set
+                    self.env.assertEqual(actual, expected[skip:skip + 10])
+
+        check()
+
+        # skipping must step over deleted nodes
+        g.query("MATCH (n) WHERE n.v % 3 = 0 DELETE n")
+        check()
+
+        # keyset pagination resumes from the last seen ID without sorting
+        query = "MATCH (n:A) WHERE id(n) > $last RETURN id(n) ORDER BY id(n) LIMIT 5"
+        plan = g.execution_plan(query, {'last': 50})
+        self.env.assertNotIn("Sort", plan)
+        ids = [row[0] for row in g.query(query, {'last': 50}).result_set]
+        self.env.assertEqual(ids, sorted(ids))
+        self.env.assertTrue(all(i > 50 for i in ids))
+        g.delete()
+
+    def test36_planner_hints(self):
+        g = Graph("planner_hints", redis_con)
+        g.query("CREATE INDEX FOR (a:A) ON (a.v)")
+        g.query("CREATE INDEX FOR (b:B) ON (b.v)")
+        g.query("UNWIND range(0, 99) AS x CREATE (:A:C {v: x})-[:R]->(:B {v: x})")
+
+        query = "MATCH (a:A)-[:R]->(b:B) %s WHERE a.v = 1 AND b.v = 1 RETURN a.v, b.v"
+
+        # index hints pick the traversal's start point
+        for alias, label in [("a", "A"), ("b", "B")]:
+            q = query % ("USING INDEX %s:%s(v)" % (alias, label))
+            plan = g.execution_plan(q)
+            self.env.assertContains("Node By Index Scan | (%s:%s)" % (alias, label), plan)
+            self.env.assertEqual(g.query(q).result_set, [[1, 1]])
+
+        # scan hints keep the label scan
+        q = query % "USING SCAN b:B"
+        plan = g.execution_plan(q)
+        self.env.assertContains("Node By Label Scan | (b:B)", plan)
+        self.env.assertNotIn("Index Scan", plan)
+        self.env.assertEqual(g.query(q).result_set, [[1, 1]])
+
+        # scan hints pick the scanned label
+        plan = g.execution_plan("MATCH (a:A:C) USING SCAN a:C RETURN count(a)")
+        self.env.assertContains("Node By Label Scan | (a:C) | intersect :A", plan)
+
+        # join hints pick the cached stream
+        q = "MATCH (a:A), (b:B) USING JOIN ON %s WHERE a.v = b.v RETURN count(a)"
+        plan = g.execution_plan(q % "a")
+        self.env.assertContains("Value Hash Join | a.v = b.v", plan)
+        plan = g.execution_plan(q % "b")
+        self.env.assertContains("Value Hash Join | b.v = a.v", plan)
+        self.env.assertEqual(g.query(q % "b").result_set, [[100]])
+
+        # hints must refer to entities defined by the pattern
+        try:
+            g.query("MATCH (a:A) USING SCAN z:A RETURN a")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("not defined by the MATCH pattern", str(e))
+        g.delete()
@@ -275,3 +275,21 @@ class testOptionalFlow(FlowTestsBase):
         actual_result = redis_graph.query(query)
         expected_result = [['v1', 'v2']]
         self.env.assertEquals(actual_result.result_set, expected_result)
+
+    # Optional traversals are resolved over batches of bound records.
+    def test22_optional_traverse_batch(self):
+        global redis_graph
+        # output follows the order of the bound records
+        vs = ['v1', 'v4', 'v2', 'v3'] * 50
+        expected = {'v1': 'v2', 'v2': 'v3', 'v3': None, 'v4': None}
+        query = """UNWIND $vs AS v MATCH (a:L {v: v}) OPTIONAL MATCH (a)-[]->(b) RETURN a.v, b.v"""
+        actual_result = redis_graph.query(query, {'vs': vs})
+        expected_result = [[v, expected[v]] for v in vs]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # bound records lacking the source node are emitted unmodified
+        vs = ['v1', 'none', 'v3', 'none', 'v2'] * 40
+        query = """UNWIND $vs AS v OPTIONAL MATCH (a:L {v: v}) OPTIONAL MATCH (a)-[]->(b) RETURN v, a.v, b.v"""
+        actual_result = redis_graph.query(query, {'vs': vs})
+        expected_result = [[v, v, expected[v]] if v != 'none' else [v, None, None] for v in vs]
+        self.env.assertEquals(actual_result.result_set, expected_result)
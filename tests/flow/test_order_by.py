@@ -35,3 +35,38 @@ class testOrderBy(FlowTestsBase):
         q = """MATCH (n:Person) RETURN n.id, n.name ORDER BY n.id DESC, n.name ASC LIMIT 10"""
         actual_result = redis_graph.query(q)
         self.env.assertEquals(actual_result.result_set, expected)
+
+    def test_order_by_mixed_values(self):
+        # values of different types, strings sharing a long prefix
+        q = """UNWIND [NULL, 2, 'b', true, 1.5, 'abcdefgh2', 'abcdefgh1', -3, false] AS x RETURN x ORDER BY x"""
+        expected = [['abcdefgh1'], ['abcdefgh2'], ['b'], [False], [True], [-3], [1.5], [2], [None]]
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+        q = """UNWIND [NULL, 2, 'b', true, 1.5, 'abcdefgh2', 'abcdefgh1', -3, false] AS x RETURN x ORDER BY x DESC"""
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, expected[::-1])
+
+        # equal first keys are ordered by the second key
+        q = """UNWIND [[0, 'd'], [-0.0, 'c'], [1, 'a'], [1.0, 'b']] AS p RETURN p[1] ORDER BY p[0], p[1]"""
+        expected = [['c'], ['d'], ['a'], ['b']]
+        actual_result = redis_graph.query(q)
+        self.env.assertEquals(actual_result.result_set, expected)
+
+    def test_parallel_order_by(self):
+        redis_con = self.env.getConnection()
+        n = 100000
+        # enough records to be sorted in parallel
+        queries = ["UNWIND range(0, %d) AS x RETURN (x * 7919) %% %d AS v ORDER BY v" % (n - 1, n),
+                   "UNWIND range(0, %d) AS x RETURN x %% 100 AS a, toString(x) AS b ORDER BY a DESC, b" % (n - 1)]
+
+        # compute expected results using a single thread
+        expected = [redis_graph.query(q).result_set for q in queries]
+        self.env.assertEquals(expected[0], [[v] for v in range(n)])
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_PARALLELISM", 3)
+        try:
+            for q, e in zip(queries, expected):
+                self.env.assertEquals(redis_graph.query(q).result_set, e)
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_PARALLELISM", 1)
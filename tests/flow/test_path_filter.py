@@ -306,3 +306,51 @@ class testPathFilter(FlowTestsBase):
         # The plan should be identical to the one constructed previously.
         self.env.assertEqual(plan_1, plan_2)
 
+
+    def test15_path_filter_repeating_arguments(self):
+        # Many records share the same path filter argument.
+        redis_graph.query("""UNWIND range(0, 9) AS i CREATE (u:User {id: i})
+                             WITH u WHERE u.id % 3 = 0
+                             CREATE (u)-[:BLOCKED]->(:Target)""")
+        redis_graph.query("""MATCH (u:User) UNWIND range(1, 50) AS j
+                             CREATE (:Post {j: j})-[:BY]->(u)""")
+
+        # Outcomes must hold for repeated and new arguments alike.
+        query = """MATCH (p:Post)-[:BY]->(u:User) WHERE (u)-[:BLOCKED]->(:Target)
+                   RETURN u.id, count(p) ORDER BY u.id"""
+        result_set = redis_graph.query(query)
+        expected_result = [[0, 50], [3, 50], [6, 50], [9, 50]]
+        self.env.assertEquals(result_set.result_set, expected_result)
+
+        query = """MATCH (p:Post)-[:BY]->(u:User) WHERE NOT (u)-[:BLOCKED]->(:Target)
+                   RETURN count(DISTINCT u), count(p)"""
+        result_set = redis_graph.query(query)
+        expected_result = [[6, 300]]
+        self.env.assertEquals(result_set.result_set, expected_result)
+
+    def test16_path_filter_semi_join(self):
+        # Enough records for the pattern to be resolved for all sources at once.
+        redis_graph.query("CREATE (:Topic {name: 'x'}), (:Topic {name: 'y'}), (:Other {name: 'x'})")
+        redis_graph.query("""UNWIND range(0, 299) AS i CREATE (p:Post {i: i})
+                             WITH p, i
+                             MATCH (t:Topic {name: CASE WHEN i % 3 = 0 THEN 'x' ELSE 'y' END})
+                             CREATE (p)-[:TAGGED]->(t)""")
+        redis_graph.query("""MATCH (p:Post), (o:Other) WHERE p.i % 5 = 0
+                             CREATE (p)-[:TAGGED]->(o)""")
+
+        query = """MATCH (p:Post) WHERE (p)-[:TAGGED]->(:Topic {name: 'x'}) RETURN count(p)"""
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[100]])
+
+        query = """MATCH (p:Post) WHERE NOT (p)-[:TAGGED]->(:Topic {name: 'x'}) RETURN count(p)"""
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[200]])
+
+        # unlabeled destination
+        query = """MATCH (p:Post) WHERE (p)-[:TAGGED]->({name: 'x'}) RETURN count(p)"""
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[140]])
+
+        query = """MATCH (p:Post) WHERE (p)-[:TAGGED]->(:Other) RETURN count(p)"""
+        result_set = redis_graph.query(query)
+        self.env.assertEquals(result_set.result_set, [[60]])
@@ -412,3 +412,38 @@ class testGraphPersistency():
         for q in queries:
             actual_result = g.query(q)
             self.env.assertEquals(actual_result.result_set[0], [1])
+
+    # Verify entity IDs, including reuse of deleted IDs, and indices
+    # are preserved across a reload
+    # under AOF the graph is rewritten as GRAPH.EFFECT commands
+    def test08_preserve_entity_ids(self):
+        graph_id = "preserve_ids"
+        g = Graph(graph_id, redis_con)
+
+        g.query("CREATE INDEX ON :L(v)")
+        g.query("UNWIND range(0, 9) AS v CREATE (:L {v: v})-[:R {v: v}]->(:M {v: [v, 'a']})")
+        g.query("MATCH (n:L) WHERE n.v % 3 = 0 DETACH DELETE n")
+        g.query("MATCH (a:M {v: [1, 'a']}), (b:M {v: [2, 'a']}) CREATE (a)-[:R]->(b), (a)-[:R]->(b)")
+
+        nodes_q = "MATCH (n) RETURN id(n), labels(n), n.v ORDER BY id(n)"
+        edges_q = "MATCH (a)-[e]->(b) RETURN id(e), type(e), id(a), id(b), e.v ORDER BY id(e)"
+        index_q = "MATCH (n:L) WHERE n.v = 4 RETURN id(n)"
+
+        expected_nodes = g.query(nodes_q).result_set
+        expected_edges = g.query(edges_q).result_set
+        expected_index = g.query(index_q).result_set
+
+        self.env.dumpAndReload()
+
+        self.env.assertEquals(g.query(nodes_q).result_set, expected_nodes)
+        self.env.assertEquals(g.query(edges_q).result_set, expected_edges)
+        self.env.assertEquals(g.query(index_q).result_set, expected_index)
+
+        plan = g.execution_plan(index_q)
+        self.env.assertIn("Index Scan", plan)
+
+        # new entities reuse deleted IDs
+        result = g.query("CREATE (n:L {v: 100}) RETURN id(n)").result_set
+        existing_ids = [row[0] for row in expected_nodes]
+        self.env.assertNotIn(result[0][0], existing_ids)
+        self.env.assertTrue(result[0][0] < 20)
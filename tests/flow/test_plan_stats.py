@@ -0,0 +1,68 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+from redis import ResponseError
+
+GRAPH_ID = "plan_stats_test"
+redis_con = None
+redis_graph = None
+
+class testPlanStats(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x})")
+
+    def _plan_stats(self, query):
+        for entry in redis_con.execute_command("GRAPH.PLANSTATS", GRAPH_ID):
+            if entry[0] == query:
+                return entry
+        return None
+
+    def test01_missing_graph(self):
+        try:
+            redis_con.execute_command("GRAPH.PLANSTATS", "NONE_EXISTING_GRAPH")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Invalid graph operation on empty key", str(e))
+
+    def test02_sampled_executions(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "PLAN_STATS_SAMPLE_RATE", 2)
+
+        query = "MATCH (n:N) RETURN n.v ORDER BY n.v"
+        for i in range(4):
+            # sampled executions reply as usual
+            result = redis_graph.query(query)
+            self.env.assertEquals(result.result_set, [[x] for x in range(1, 11)])
+
+        entry = self._plan_stats(query)
+        self.env.assertIsNotNone(entry)
+        executions = entry[1]
+        samples = entry[2]
+        ops = entry[3]
+        self.env.assertEquals(executions, 4)
+        self.env.assertEquals(samples, 2)
+
+        # operations are reported in plan order, averaged over samples
+        self.env.assertIn("Results", ops[0])
+        self.env.assertIn("Node By Label Scan", ops[-1])
+        self.env.assertIn("Records produced: 10.00", ops[-1])
+
+    def test03_disable_sampling(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "PLAN_STATS_SAMPLE_RATE", 0)
+
+        query = "MATCH (n:N) WHERE n.v > 5 RETURN n.v ORDER BY n.v"
+        for i in range(3):
+            redis_graph.query(query)
+
+        entry = self._plan_stats(query)
+        self.env.assertIsNotNone(entry)
+        self.env.assertEquals(entry[1], 3)
+        self.env.assertEquals(entry[2], 0)
+        self.env.assertEquals(entry[3], [])
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "PLAN_STATS_SAMPLE_RATE", 100)
@@ -0,0 +1,58 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "plan_warmup"
+redis_con = None
+redis_graph = None
+
+class testPlanWarmup(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='WARM_PLAN_COUNT 2')
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x})")
+
+    def cached_queries(self):
+        res = redis_con.execute_command("GRAPH.PLANSTATS", GRAPH_ID)
+        return sorted(entry[0] for entry in res)
+
+    def test01_warm_after_reload(self):
+        frequent = ["MATCH (n:N) RETURN count(n)",
+                    "MATCH (n:N) WHERE n.v > 5 RETURN n.v ORDER BY n.v"]
+        rare = "MATCH (n:N) WHERE n.v < 5 RETURN n.v ORDER BY n.v"
+
+        for q in frequent:
+            for i in range(5):
+                redis_graph.query(q)
+        redis_graph.query(rare)
+
+        self.env.dumpAndReload()
+
+        # the most executed queries are planned in the background
+        cached = []
+        for _ in range(100):
+            cached = self.cached_queries()
+            if len(cached) == len(frequent):
+                break
+            time.sleep(0.05)
+        self.env.assertEquals(cached, sorted(frequent))
+
+        # and hit the cache on their first execution
+        for q in frequent:
+            self.env.assertTrue(redis_graph.query(q).cached_execution)
+        self.env.assertFalse(redis_graph.query(rare).cached_execution)
+
+    def test02_disabled(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "WARM_PLAN_COUNT", 0)
+        redis_graph.query("MATCH (n:N) RETURN count(n)")
+
+        self.env.dumpAndReload()
+
+        # no query is saved, the cache starts out empty
+        time.sleep(0.2)
+        self.env.assertEquals(self.cached_queries(), [])
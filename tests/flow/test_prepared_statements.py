@@ -0,0 +1,111 @@
+import os
+import sys
+import redis
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "prepared_statements"
+redis_con = None
+graph = None
+
+class testPreparedStatements(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global graph
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        graph.query("UNWIND range(1, 10) AS i CREATE (:N {v: i, name: 'n' + tostring(i), even: i % 2 = 0})")
+
+    def test01_prepare(self):
+        q = "MATCH (n:N) WHERE n.v > $min RETURN count(n)"
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, q)
+
+        # preparing the same query yields the same handle
+        self.env.assertEquals(redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, q), handle)
+
+        other = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "RETURN 1")
+        self.env.assertNotEqual(other, handle)
+
+    def test02_execute(self):
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID,
+                "MATCH (n:N) WHERE n.v > $min RETURN count(n)")
+
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "min", "INT", 7)
+        self.env.assertEquals(res[1], [[3]])
+
+        # re-execute with different values, reusing the pinned plan
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "min", "INT", 2)
+        self.env.assertEquals(res[1], [[8]])
+
+        # different parameter type
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "min", "DOUBLE", 8.5)
+        self.env.assertEquals(res[1], [[2]])
+
+    def test03_parameter_types(self):
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID,
+                "MATCH (n:N) WHERE n.name = $name AND n.even = $even RETURN n.v")
+
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle,
+                "name", "STRING", "n4", "even", "BOOL", "true", "--compact")
+        self.env.assertEquals(res[1], [[[3, 4]]])
+
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle,
+                "name", "STRING", "n4", "even", "BOOL", "false")
+        self.env.assertEquals(res[1], [])
+
+    def test04_matches_query(self):
+        q = "MATCH (n:N) WHERE n.v <= $max RETURN n.v ORDER BY n.v"
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, q)
+        expected = graph.query(q, {'max': 4}).result_set
+        res = redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "max", "INT", 4)
+        self.env.assertEquals(res[1], expected)
+
+    def test05_errors(self):
+        # write queries can't be prepared
+        try:
+            redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "CREATE ()")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("read-only", str(e))
+
+        # parameters are bound on execution
+        try:
+            redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "CYPHER x=1 RETURN $x")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("on execution", str(e))
+
+        # unknown handle
+        try:
+            redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, 4096)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("unknown prepared statement", str(e))
+
+        handle = redis_con.execute_command("GRAPH.PREPARE", GRAPH_ID, "RETURN $x")
+
+        # invalid parameter value
+        try:
+            redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "x", "INT", "abc")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("invalid INT parameter", str(e))
+
+        # incomplete parameter
+        try:
+            redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle, "x", "INT")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("name, type and value", str(e))
+
+        # missing parameter
+        try:
+            redis_con.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("Missing parameters", str(e))
@@ -368,10 +368,23 @@ class testProcedures(FlowTestsBase):
         actual_resultset = redis_graph.query("CALL dbms.procedures() YIELD mode, name RETURN mode, name ORDER BY name").result_set
 
         expected_result = [["READ", "algo.BFS"],
+                           ["READ", "algo.SPpaths"],
+                           ["READ", "algo.SSpaths"],
+                           ["READ", "algo.WCC"],
+                           ["READ", "algo.labelPropagation"],
                            ["READ", "algo.pageRank"],
+                           ["READ", "algo.personalizedPageRank"],
+                           ["READ", "algo.sampleNodes"],
+                           ["READ", "algo.triangleCount"],
+                           ["READ", "algo.weightedPageRank"],
+                           ["WRITE", "db.cache.autoParameterize"],
+                           ["READ", "db.cache.stats"],
                            ["WRITE", "db.idx.fulltext.createNodeIndex"],
                            ["WRITE", "db.idx.fulltext.drop"],
                            ["READ", "db.idx.fulltext.queryNodes"],
+                           ["WRITE", "db.idx.vector.createNodeIndex"],
+                           ["WRITE", "db.idx.vector.drop"],
+                           ["READ", "db.idx.vector.queryNodes"],
                            ["READ", "db.indexes"],
                            ["READ", "db.labels"],
                            ["READ", "db.propertyKeys"],
@@ -1,5 +1,7 @@
 import os
+import re
 import sys
+import time
 from RLTest import Env
 from redisgraph import Graph, Node, Edge, Path
 sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
@@ -35,3 +37,82 @@ class testProfile(FlowTestsBase):
         self.env.assertIn("Project | Records produced: 2", profile)
         self.env.assertIn("Filter | Records produced: 2", profile)
         self.env.assertIn("Node By Label Scan | (p:Person) | Records produced: 3", profile)
+
+    def test_profile_memory(self):
+        q = "UNWIND range(1, 10000) AS x RETURN x ORDER BY x DESC"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+
+        def stat(op, name):
+            line = next(x for x in profile if x.strip().startswith(op))
+            return int(re.search(name + r": (-?\d+)", line).group(1))
+
+        # sort buffers its input, growing its retained memory
+        self.env.assertGreater(stat("Sort", "Memory allocated"), 0)
+        self.env.assertGreater(stat("Sort", "Peak memory"), 0)
+
+        # each unwound value is emitted in a newly allocated record
+        self.env.assertGreaterEqual(stat("Unwind", "Records allocated"), 10000)
+
+    def test_profile_graphblas_memory(self):
+        redis_graph.query("UNWIND range(1, 1000) AS x CREATE (:N {v: x})-[:R]->(:M)")
+        q = "MATCH (n:N)-[:R]->(m:M) RETURN count(m)"
+        profile = redis_con.execute_command("GRAPH.PROFILE", GRAPH_ID, q)
+
+        def stat(op, name):
+            line = next(x for x in profile if x.strip().startswith(op))
+            return int(re.search(name + r": (-?\d+)", line).group(1))
+
+        # traversal intermediates are allocated by GraphBLAS
+        self.env.assertGreater(stat("Conditional Traverse", "GraphBLAS peak memory"), 0)
+        # scans don't multiply matrices
+        self.env.assertEquals(stat("Node By Label Scan", "GraphBLAS peak memory"), 0)
+
+    def test_estimates(self):
+        g = Graph("estimates", redis_con)
+        g.query("UNWIND range(1, 10) AS x CREATE (:E {v: x})")
+        q = "MATCH (e:E) RETURN e.v"
+
+        def stat(plan, op, name):
+            line = next(x for x in plan if x.strip().startswith(op))
+            return float(re.search(name + r": (-?\d+(\.\d+)?)", line).group(1))
+
+        # explain annotates each operation with its estimates
+        plan = redis_con.execute_command("GRAPH.EXPLAIN", "estimates", q)
+        self.env.assertEquals(stat(plan, "Node By Label Scan", "Estimated records"), 10)
+        self.env.assertEquals(stat(plan, "Node By Label Scan", "Estimated input"), 0)
+        self.env.assertEquals(stat(plan, "Project", "Estimated input"), 10)
+
+        # the operations' shares of the plan's cost add up
+        total = sum(float(re.search(r"Cost: (\d+\.\d+)%", x).group(1)) for x in plan)
+        self.env.assertAlmostEqual(total, 100, 1)
+
+        # profile reports estimates along with the records produced
+        profile = redis_con.execute_command("GRAPH.PROFILE", "estimates", q)
+        self.env.assertEquals(stat(profile, "Node By Label Scan", "Records produced"), 10)
+        self.env.assertEquals(stat(profile, "Node By Label Scan", "Estimated records"), 10)
+        g.delete()
+
+    def test_traverse_estimates(self):
+        # all relationships leave the 10 :A nodes, 100 per node
+        g = Graph("traverse_estimates", redis_con)
+        g.query("UNWIND range(1, 1000) AS x CREATE (:B {v: x})")
+        g.query("""UNWIND range(0, 9) AS i CREATE (a:A {v: i}) WITH a, i
+                   MATCH (b:B) WHERE b.v % 10 = i CREATE (a)-[:R]->(b)""")
+        q = "MATCH (a:A)-[:R]->(b) RETURN b"
+
+        def estimate():
+            plan = redis_con.execute_command("GRAPH.EXPLAIN", "traverse_estimates", q)
+            line = next(x for x in plan if x.strip().startswith("Conditional Traverse"))
+            return float(re.search(r"Estimated records: (\d+(\.\d+)?)", line).group(1))
+
+        # the relation's degree summary is computed in the background
+        # after which a traversal from :A is estimated to reach every edge
+        deadline = time.time() + 10
+        while estimate() != 1000 and time.time() < deadline:
+            time.sleep(0.1)
+        self.env.assertEquals(estimate(), 1000)
+
+        # the summary is persisted, plans are estimated alike once reloaded
+        self.env.dumpAndReload()
+        self.env.assertEquals(estimate(), 1000)
+        g.delete()
@@ -0,0 +1,53 @@
+import os
+import sys
+from RLTest import Env
+from redisgraph import Graph
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+sys.path.append(os.path.join(os.path.dirname(__file__), '..', 'benchmarks'))
+
+from base import FlowTestsBase
+from replay import read_capture, READONLY, COMPACT
+
+GRAPH_ID = "capture"
+
+redis_con = None
+redis_graph = None
+
+class testQueryCapture(FlowTestsBase):
+    def __init__(self):
+        global redis_con
+        global redis_graph
+        self.env = Env(decodeResponses=True)
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+
+    def capture_path(self):
+        return os.path.join(redis_con.config_get("dir")["dir"], "redisgraph_capture.bin")
+
+    def test01_capture(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "CAPTURE_SAMPLE_RATE", 1)
+        redis_graph.query("UNWIND range(1, 3) AS x CREATE (:N {v: x})")
+        redis_graph.query("MATCH (n:N) WHERE n.v > $v RETURN n.v", {'v': 1})
+        redis_con.execute_command("GRAPH.RO_QUERY", GRAPH_ID, "MATCH (n) RETURN count(n)", "--compact")
+
+        # disabling capture closes the capture file
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "CAPTURE_SAMPLE_RATE", 0)
+        redis_graph.query("MATCH (n) RETURN n")
+
+        queries = list(read_capture(self.capture_path()))
+        self.env.assertEquals(len(queries), 3)
+
+        create, match, count = queries
+        self.env.assertEquals(create.graph, GRAPH_ID)
+        self.env.assertEquals(create.command, "GRAPH.QUERY")
+        self.env.assertFalse(create.flags & READONLY)
+
+        # parameters are captured along with the query
+        self.env.assertIn("CYPHER v=1", match.query)
+        self.env.assertEquals(match.rows, 2)
+        self.env.assertTrue(match.flags & READONLY)
+        self.env.assertGreater(match.latency, 0)
+
+        self.env.assertEquals(count.command, "GRAPH.RO_QUERY")
+        self.env.assertTrue(count.flags & COMPACT)
+        self.env.assertLessEqual(create.time, count.time)
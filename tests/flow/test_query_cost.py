@@ -0,0 +1,78 @@
+from RLTest import Env
+from base import FlowTestsBase
+from redis import ResponseError
+from redisgraph import Graph
+
+GRAPH_ID = "query_cost"
+redis_con = None
+redis_graph = None
+
+class testQueryCost(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 100) AS x CREATE (:A {v: x}), (:B {v: x})")
+
+    def tearDown(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_COST_LIMIT", 0)
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "HEAVY_QUERY_COST", 0)
+
+    def test01_default_config(self):
+        for name in ["QUERY_COST_LIMIT", "HEAVY_QUERY_COST"]:
+            response = redis_con.execute_command("GRAPH.CONFIG", "GET", name)
+            self.env.assertEquals(response, [name, 0])
+
+    def test02_cost_limit(self):
+        # a Cartesian product of both labels is estimated at 100 * 100 records
+        cartesian = "MATCH (a:A), (b:B) RETURN count(*)"
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_COST_LIMIT", 5000)
+
+        try:
+            redis_graph.query(cartesian)
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("exceeds the limit of 5000", str(e))
+
+        # queries within the limit are admitted
+        result = redis_graph.query("MATCH (a:A) RETURN count(a)")
+        self.env.assertEquals(result.result_set, [[100]])
+
+        # a limit bounds the estimated cost of a streaming plan
+        result = redis_graph.query("MATCH (a:A), (b:B) RETURN a.v, b.v LIMIT 3")
+        self.env.assertEquals(len(result.result_set), 3)
+
+        # write queries are subject to the limit as well
+        try:
+            redis_graph.query("MATCH (a:A), (b:B) CREATE (a)-[:R]->(b)")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("exceeds the limit", str(e))
+
+        # lifting the limit admits the query
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_COST_LIMIT", 0)
+        result = redis_graph.query(cartesian)
+        self.env.assertEquals(result.result_set, [[10000]])
+
+    def test03_heavy_pool(self):
+        info = redis_con.info("modules")
+        heavy = info["heavy_enqueued"]
+
+        # cheap queries are served by the readers
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "HEAVY_QUERY_COST", 5000)
+        redis_graph.query("MATCH (a:A) RETURN count(a)")
+        info = redis_con.info("modules")
+        self.env.assertEquals(info["heavy_enqueued"], heavy)
+
+        # expensive read-only queries are handed over to the heavy pool
+        result = redis_graph.query("MATCH (a:A), (b:B) RETURN count(*)")
+        self.env.assertEquals(result.result_set, [[10000]])
+        info = redis_con.info("modules")
+        self.env.assertEquals(info["heavy_enqueued"], heavy + 1)
+
+        # write queries are executed by the writer
+        redis_graph.query("MATCH (a:A), (b:B) WHERE a.v = 1 AND b.v = 1 CREATE (a)-[:R]->(b)")
+        info = redis_con.info("modules")
+        self.env.assertEquals(info["heavy_enqueued"], heavy + 1)
@@ -0,0 +1,53 @@
+from RLTest import Env
+from redisgraph import Graph
+from base import FlowTestsBase
+
+GRAPH_ID = "replan"
+redis_con = None
+redis_graph = None
+
+class testReplan(FlowTestsBase):
+    def __init__(self):
+        # sample every execution of a cached plan
+        self.env = Env(decodeResponses=True,
+                       moduleArgs='PLAN_STATS_SAMPLE_RATE 1 REPLAN_FACTOR 10')
+        global redis_con
+        global redis_graph
+
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:A {v: x}), (:B {v: x})")
+
+    def test01_replan_on_growth(self):
+        query = "MATCH (a:A) WHERE a.v > 0 RETURN count(a)"
+
+        # first execution sets the plan's expectations
+        self.env.assertEquals(redis_graph.query(query).result_set, [[10]])
+        self.env.assertTrue(redis_graph.query(query).cached_execution)
+
+        # label A outgrows the statistics the plan was built with
+        redis_graph.query("UNWIND range(1, 2000) AS x CREATE (:A {v: x})")
+
+        # the sampled execution observes the growth and drops the plan
+        res = redis_graph.query(query)
+        self.env.assertTrue(res.cached_execution)
+        self.env.assertEquals(res.result_set, [[2010]])
+
+        # next execution builds a new plan
+        res = redis_graph.query(query)
+        self.env.assertFalse(res.cached_execution)
+        self.env.assertEquals(res.result_set, [[2010]])
+
+        # the new plan expects the current number of nodes
+        self.env.assertTrue(redis_graph.query(query).cached_execution)
+
+    def test02_disabled(self):
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "REPLAN_FACTOR", 0)
+        query = "MATCH (b:B) WHERE b.v > 0 RETURN count(b)"
+
+        redis_graph.query(query)
+        redis_graph.query("UNWIND range(1, 2000) AS x CREATE (:B {v: x})")
+
+        # growth is ignored, the cached plan is kept
+        for i in range(3):
+            self.env.assertTrue(redis_graph.query(query).cached_execution)
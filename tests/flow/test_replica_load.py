@@ -0,0 +1,60 @@
+import time
+from RLTest import Env
+from redisgraph import Graph
+
+GRAPH_ID = "replica_load"
+
+# a replica performing a full sync keeps serving read-only queries
+# from the graphs it held before the sync began
+class testReplicaLoad():
+    def __init__(self):
+        self.env = Env(useSlaves=True, decodeResponses=True, env='oss',
+                       moduleArgs='VKEY_MAX_ENTITY_COUNT 10')
+        # skip test if we're running under Valgrind
+        if self.env.envRunner.debugger is not None:
+            self.env.skip() # valgrind is not working correctly with replication
+
+        self.master = self.env.getConnection()
+        self.slave = self.env.getSlaveConnection()
+        info = self.slave.info("Replication")
+        self.master_host = info["master_host"]
+        self.master_port = info["master_port"]
+
+    def test01_serve_previous_graph(self):
+        q = "MATCH (n:N) RETURN count(n)"
+        graph = Graph(GRAPH_ID, self.master)
+        graph.query("UNWIND range(1, 100) AS i CREATE (:N {v: i})")
+        self.master.execute_command("WAIT", "1", "0")
+        res = self.slave.execute_command("GRAPH.RO_QUERY", GRAPH_ID, q)
+        self.env.assertEquals(res[1], [[100]])
+
+        # update the graph while the replica is detached
+        self.slave.slaveof()
+        graph.query("UNWIND range(1, 100) AS i CREATE (:N {v: i})")
+
+        # slow down loading, each virtual key takes a while to load
+        self.slave.config_set("key-load-delay", 100000)
+        self.slave.slaveof(self.master_host, self.master_port)
+
+        # wait for the replica to start loading
+        while self.slave.info("Persistence")["loading"] == 0:
+            time.sleep(0.01)
+
+        # queries are served from the previous graph
+        res = self.slave.execute_command("GRAPH.RO_QUERY", GRAPH_ID, q)
+        self.env.assertEquals(res[1], [[100]])
+
+        # write queries are rejected while loading
+        try:
+            self.slave.execute_command("GRAPH.QUERY", GRAPH_ID, "RETURN 1")
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertContains("LOADING", str(e))
+
+        # once loaded, queries are served from the new graph
+        self.slave.config_set("key-load-delay", 0)
+        while self.slave.info("Persistence")["loading"] == 1:
+            time.sleep(0.01)
+        self.master.execute_command("WAIT", "1", "0")
+        res = self.slave.execute_command("GRAPH.RO_QUERY", GRAPH_ID, q)
+        self.env.assertEquals(res[1], [[200]])
@@ -115,3 +115,144 @@ class testReplication(FlowTestsBase):
         replica_result = replica.query(q).result_set
         self.env.assertEquals(replica_result, result)
 
+
+    def test_effects_replication(self):
+        env = self.env
+        source_con = env.getConnection()
+        replica_con = env.getSlaveConnection()
+        replica_con.config_set("slave-read-only", "no")
+
+        graph = Graph("effects", source_con)
+        replica = Graph("effects", replica_con)
+
+        # replicate every write query as its effects
+        source_con.execute_command("GRAPH.CONFIG", "SET", "EFFECTS_THRESHOLD", 0)
+
+        try:
+            queries = [
+                # node and edge creation
+                "UNWIND range(0, 9) AS x CREATE (:A {v: x, arr: [x, 'a', [1.5]], p: point({latitude: 1, longitude: 2})})",
+                "MATCH (a:A), (b:A) WHERE b.v = a.v + 1 CREATE (a)-[:R {w: a.v}]->(b)",
+                # non-deterministic values
+                "MATCH (a:A) SET a.r = rand()",
+                # attribute update, removal and clearing
+                "MATCH (a:A) WHERE a.v < 3 SET a.v = a.v * 10, a.arr = NULL",
+                "MATCH (a:A {v: 4}) SET a = {}",
+                "MATCH ()-[e:R]->() WHERE e.w > 5 SET e.w = -1",
+                # deletion, freeing IDs
+                "MATCH (a:A {v: 5}) DELETE a",
+                "MATCH ()-[e:R {w: 1}]->() DELETE e",
+                # creation reusing deleted IDs
+                "CREATE (:B {v: 'x'})-[:S]->(:B {v: 'y'})",
+            ]
+            for q in queries:
+                graph.query(q)
+
+            # a query replicated as is, which must reuse the same IDs on both
+            source_con.execute_command("GRAPH.CONFIG", "SET", "EFFECTS_THRESHOLD", 1000000)
+            graph.query("MATCH (a:A {v: 6}) DELETE a")
+            graph.query("CREATE (:C)-[:T]->(:C)")
+        finally:
+            source_con.execute_command("GRAPH.CONFIG", "SET", "EFFECTS_THRESHOLD", 300)
+
+        # give replica some time to catch up
+        source_con.execute_command("WAIT", 1, 0)
+
+        q = "MATCH (n) RETURN id(n), n ORDER BY id(n)"
+        result = graph.query(q).result_set
+        replica_result = replica.query(q).result_set
+        self.env.assertEquals(replica_result, result)
+
+        q = "MATCH (a)-[e]->(b) RETURN id(e), id(a), id(b), e ORDER BY id(e)"
+        result = graph.query(q).result_set
+        replica_result = replica.query(q).result_set
+        self.env.assertEquals(replica_result, result)
+
+    def _commit_seq(self, con, graph_id, q, *args):
+        res = con.execute_command("GRAPH.QUERY", graph_id, q, *args)
+        stats = res[-1]
+        for s in stats:
+            if s.startswith("Commit sequence: "):
+                return int(s.split(": ")[1])
+        self.env.assertTrue(False)
+
+    def test_commit_sequence_replication(self):
+        env = self.env
+        source_con = env.getConnection()
+        replica_con = env.getSlaveConnection()
+        replica_con.config_set("slave-read-only", "no")
+
+        graph_id = "commit_seq"
+
+        # a write query advances the sequence, a read query doesn't
+        seq = self._commit_seq(source_con, graph_id, "CREATE (:A {v: 1})")
+        self.env.assertEquals(seq, 1)
+        seq = self._commit_seq(source_con, graph_id, "MATCH (a) RETURN a")
+        self.env.assertEquals(seq, 1)
+
+        # writes replicated either as effects or as queries
+        source_con.execute_command("GRAPH.CONFIG", "SET", "EFFECTS_THRESHOLD", 0)
+        try:
+            self._commit_seq(source_con, graph_id, "CREATE (:A {v: 2})")
+        finally:
+            source_con.execute_command("GRAPH.CONFIG", "SET", "EFFECTS_THRESHOLD", 300)
+        seq = self._commit_seq(source_con, graph_id, "MATCH (a:A {v: 2}) SET a.v = 3")
+        self.env.assertEquals(seq, 3)
+
+        # replica reaches the master's sequence
+        res = replica_con.execute_command("GRAPH.RO_QUERY", graph_id,
+                "MATCH (a:A) RETURN max(a.v)", "min_version", seq, "timeout", 5000)
+        self.env.assertEquals(res[1], [[3]])
+        replica_seq = self._commit_seq(replica_con, graph_id, "MATCH (a) RETURN count(a)")
+        self.env.assertEquals(replica_seq, seq)
+
+        # a sequence which isn't reached in time fails the query
+        try:
+            replica_con.execute_command("GRAPH.RO_QUERY", graph_id,
+                    "MATCH (a) RETURN a", "min_version", seq + 100, "timeout", 10)
+            self.env.assertTrue(False)
+        except Exception as e:
+            self.env.assertIn("has not reached version", str(e))
+
+        # the sequence survives a reload
+        source_con.execute_command("DEBUG", "RELOAD")
+        seq = self._commit_seq(source_con, graph_id, "MATCH (a) RETURN a")
+        self.env.assertEquals(seq, 3)
+
+    def test_ids_assigned_during_bgsave(self):
+        env = self.env
+        source_con = env.getConnection()
+        replica_con = env.getSlaveConnection()
+        replica_con.config_set("slave-read-only", "no")
+
+        graph = Graph("bgsave_ids", source_con)
+        replica = Graph("bgsave_ids", replica_con)
+
+        # free IDs to be reused by later creations
+        graph.query("UNWIND range(0, 9) AS x CREATE (:A {v: x})")
+        graph.query("MATCH (a:A) WHERE a.v % 2 = 0 DELETE a")
+
+        # keep the fork child alive while creating, queries are fast enough
+        # to be replicated as is and re-executed by the replica
+        source_con.config_set("rdb-key-save-delay", 1000000)
+        try:
+            source_con.execute_command("BGSAVE")
+            graph.query("CREATE (:B {v: 1})")
+            graph.query("UNWIND range(2, 4) AS x CREATE (:B {v: x})")
+        finally:
+            source_con.config_set("rdb-key-save-delay", 0)
+
+        # give replica some time to catch up
+        source_con.execute_command("WAIT", 1, 0)
+
+        q = "MATCH (n) RETURN id(n), labels(n), n.v ORDER BY id(n)"
+        result = graph.query(q).result_set
+        replica_result = replica.query(q).result_set
+        self.env.assertEquals(replica_result, result)
+
+        # deleted IDs are reused while the fork child is alive
+        self.env.assertTrue(all(row[0] < 10 for row in result))
+
+        # wait for the fork child to exit
+        while source_con.execute_command("INFO", "persistence")['rdb_bgsave_in_progress'] == 1:
+            time.sleep(0.1)
@@ -0,0 +1,67 @@
+from RLTest import Env
+from redisgraph import Graph, Node, Edge
+
+from base import FlowTestsBase
+
+GRAPH_ID = "result_cache"
+redis_con = None
+redis_graph = None
+
+class testResultCache(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='RESULTSET_CACHE_SIZE 16')
+        global redis_con
+        global redis_graph
+        redis_con = self.env.getConnection()
+        redis_graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        redis_graph.query("UNWIND range(1, 10) AS x CREATE (:N {v: x})")
+
+    def test01_repeated_query(self):
+        query = "MATCH (n:N) RETURN n.v ORDER BY n.v"
+        expected = [[i] for i in range(1, 11)]
+
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, expected)
+
+        # replayed from the result cache
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, expected)
+        self.env.assertTrue(result.cached_execution)
+
+        # entities are replayed as well
+        result = redis_graph.query("MATCH (n:N {v: 1}) RETURN n")
+        result = redis_graph.query("MATCH (n:N {v: 1}) RETURN n")
+        self.env.assertEquals(result.result_set[0][0].properties, {'v': 1})
+
+    def test02_parameters(self):
+        query = "MATCH (n:N) WHERE n.v = $v RETURN n.v"
+        for i in range(2):
+            result = redis_graph.query(query, {'v': 1})
+            self.env.assertEquals(result.result_set, [[1]])
+            result = redis_graph.query(query, {'v': 2})
+            self.env.assertEquals(result.result_set, [[2]])
+
+    def test03_invalidate_on_write(self):
+        query = "MATCH (n:N) RETURN count(n)"
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10]])
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10]])
+
+        redis_graph.query("CREATE (:N {v: 11})")
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[11]])
+
+        redis_graph.query("MATCH (n:N {v: 11}) DELETE n")
+        result = redis_graph.query(query)
+        self.env.assertEquals(result.result_set, [[10]])
+
+    def test04_non_deterministic_query(self):
+        # results of rand() must not be replayed
+        query = "UNWIND range(1, 10) AS x RETURN collect(rand())"
+        first = redis_graph.query(query).result_set
+        second = redis_graph.query(query).result_set
+        self.env.assertNotEqual(first, second)
@@ -1,5 +1,8 @@
 import os
+import json
 import sys
+import redis
+import struct
 from RLTest import Env
 from redisgraph import Graph, Node, Edge
 
@@ -12,6 +15,75 @@ redis_con = None
 
 people = ["Roi", "Alon", "Ailon", "Boaz"]
 
+# minimal Arrow IPC stream decoder, supporting the types emitted by --arrow
+def _fb_field(buf, table, slot):
+    # position of a flatbuffers table field, None if absent
+    vtable = table - struct.unpack_from('<i', buf, table)[0]
+    vtable_len = struct.unpack_from('<H', buf, vtable)[0]
+    if 4 + 2 * slot >= vtable_len:
+        return None
+    offset = struct.unpack_from('<H', buf, vtable + 4 + 2 * slot)[0]
+    return table + offset if offset else None
+
+def _fb_deref(buf, pos):
+    return pos + struct.unpack_from('<I', buf, pos)[0]
+
+def _fb_vector(buf, pos):
+    vec = _fb_deref(buf, pos)
+    return vec + 4, struct.unpack_from('<I', buf, vec)[0]
+
+def _arrow_decode(stream):
+    types = []
+    columns = None
+    pos = 0
+    while True:
+        marker, length = struct.unpack_from('<Ii', stream, pos)
+        assert marker == 0xFFFFFFFF
+        pos += 8
+        if length == 0:
+            break
+        meta = stream[pos:pos + length]
+        msg = _fb_deref(meta, 0)
+        header_type = meta[_fb_field(meta, msg, 1)]
+        header = _fb_deref(meta, _fb_field(meta, msg, 2))
+        body_len = struct.unpack_from('<q', meta, _fb_field(meta, msg, 3))[0]
+        body = stream[pos + length:pos + length + body_len]
+        pos += length + body_len
+
+        if header_type == 1:
+            # schema, collect column types
+            fields, count = _fb_vector(meta, _fb_field(meta, header, 1))
+            for i in range(count):
+                field = _fb_deref(meta, fields + 4 * i)
+                types.append(meta[_fb_field(meta, field, 2)])
+            continue
+
+        # record batch
+        assert header_type == 3
+        rows = struct.unpack_from('<q', meta, _fb_field(meta, header, 0))[0]
+        vec, count = _fb_vector(meta, _fb_field(meta, header, 2))
+        buffers = [struct.unpack_from('<qq', meta, vec + 16 * i) for i in range(count)]
+        buffers = [body[offset:offset + size] for offset, size in buffers]
+        columns = []
+        for t in types:
+            validity = buffers.pop(0)
+            valid = [not validity or bool(validity[i // 8] & (1 << (i % 8))) for i in range(rows)]
+            if t == 2:
+                values = list(struct.unpack_from('<%dq' % rows, buffers.pop(0)))
+            elif t == 3:
+                values = list(struct.unpack_from('<%dd' % rows, buffers.pop(0)))
+            elif t == 6:
+                bits = buffers.pop(0)
+                values = [bool(bits[i // 8] & (1 << (i % 8))) for i in range(rows)]
+            else:
+                offsets = struct.unpack_from('<%di' % (rows + 1), buffers.pop(0))
+                data = buffers.pop(0)
+                values = [data[offsets[i]:offsets[i + 1]].decode() for i in range(rows)]
+            columns.append([v if ok else None for v, ok in zip(values, valid)])
+
+    assert pos == len(stream)
+    return types, columns
+
 
 class testResultSetFlow(FlowTestsBase):
     def __init__(self):
@@ -200,3 +272,147 @@ class testResultSetFlow(FlowTestsBase):
         query = """RETURN 'Foo\r\nBar'"""
         result = graph.query(query)
         self.env.assertEqual(result.result_set[0][0], 'Foo\r\nBar')
+
+    # Test result-set streaming in fixed-size chunks
+    def test11_streamed_resultset(self):
+        query = "UNWIND range(1, 10) AS x RETURN x"
+        expected_result = [[i] for i in range(1, 11)]
+
+        # emit rows in chunks of 3, last chunk is partial
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 3)
+
+        result = graph.query(query)
+        self.env.assertEqual(result.result_set, expected_result)
+
+        # query statistics are still reported after the streamed rows
+        self.env.assertIsNotNone(result.run_time_ms)
+
+        # row count is a multiple of the chunk size
+        result = graph.query("UNWIND range(1, 9) AS x RETURN x")
+        self.env.assertEqual(len(result.result_set), 9)
+
+        # run-time error is reported, see test15_streamed_error_reply_shape
+        try:
+            graph.query("UNWIND [1, 2, 3, 4, 'a'] AS x RETURN x * 2")
+            assert(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertContains("Type mismatch", str(e))
+
+        # restore default, buffer the entire result-set
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 0)
+
+        result = graph.query(query)
+        self.env.assertEqual(result.result_set, expected_result)
+
+    # Records flowing through scan, filter, project and aggregate
+    # are produced in batches, validate results span multiple batches
+    def test12_batched_execution(self):
+        g = Graph("batched", redis_con)
+        g.query("UNWIND range(0, 999) AS x CREATE (:N {v: x})")
+
+        result = g.query("MATCH (n:N) WHERE n.v % 2 = 0 RETURN n.v ORDER BY n.v")
+        self.env.assertEqual(result.result_set, [[i] for i in range(0, 1000, 2)])
+
+        result = g.query("MATCH (n) WHERE n.v >= 100 RETURN count(n), sum(n.v)")
+        self.env.assertEqual(result.result_set, [[900, sum(range(100, 1000))]])
+
+        result = g.query("MATCH (n:N) RETURN n.v % 10 AS k, count(n) ORDER BY k")
+        self.env.assertEqual(result.result_set, [[i, 100] for i in range(10)])
+
+        # result-set size limit is respected mid-batch
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", 70)
+        result = g.query("MATCH (n:N) RETURN n.v")
+        self.env.assertEqual(len(result.result_set), 70)
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_SIZE", -1)
+
+        g.delete()
+
+    def test13_arrow_resultset(self):
+        # binary replies can't be decoded as text
+        conn = redis.Redis(**{**redis_con.connection_pool.connection_kwargs,
+                              'decode_responses': False})
+        query = """UNWIND range(1, 5) AS x
+                   RETURN x, x / 2.0 AS half, 'v' + toString(x) AS s,
+                   x > 2 AS b, CASE WHEN x > 2 THEN x END AS n"""
+        header, batches, stats = conn.execute_command("GRAPH.QUERY", "G", query, "--arrow")
+        self.env.assertEqual(header, [b'x', b'half', b's', b'b', b'n'])
+        self.env.assertEqual(len(batches), 1)
+
+        types, columns = _arrow_decode(batches[0])
+        # Int, FloatingPoint, Utf8, Bool, Int
+        self.env.assertEqual(types, [2, 3, 5, 6, 2])
+        self.env.assertEqual(columns[0], [1, 2, 3, 4, 5])
+        self.env.assertEqual(columns[1], [0.5, 1.0, 1.5, 2.0, 2.5])
+        self.env.assertEqual(columns[2], ['v1', 'v2', 'v3', 'v4', 'v5'])
+        self.env.assertEqual(columns[3], [False, False, True, True, True])
+        self.env.assertEqual(columns[4], [None, None, 3, 4, 5])
+
+        # graph entities are encoded by their string representation
+        header, batches, stats = conn.execute_command("GRAPH.QUERY", "G",
+                "MATCH (n:person) RETURN n.name, n LIMIT 1", "--arrow")
+        types, columns = _arrow_decode(batches[0])
+        self.env.assertEqual(types, [5, 5])
+        self.env.assertIn(columns[0][0], people)
+
+        # streamed chunks are replied as separate batches
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 3)
+        header, batches, stats = conn.execute_command("GRAPH.QUERY", "G",
+                "UNWIND range(1, 10) AS x RETURN x", "--arrow")
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 0)
+        values = []
+        for batch in batches:
+            values += _arrow_decode(batch)[1][0]
+        self.env.assertEqual(values, list(range(1, 11)))
+
+    def test14_json_resultset(self):
+        query = """UNWIND range(1, 3) AS x
+                   RETURN x, x / 2.0 AS half, 'v"' + toString(x) AS s,
+                   x > 2 AS b, CASE WHEN x > 2 THEN [x, {k: x}] END AS c"""
+        header, batches, stats = redis_con.execute_command("GRAPH.QUERY", "G", query, "--json")
+        self.env.assertEqual(header, ['x', 'half', 's', 'b', 'c'])
+        self.env.assertEqual(len(batches), 1)
+
+        rows = json.loads(batches[0])
+        self.env.assertEqual(rows, [
+            {'x': 1, 'half': 0.5, 's': 'v"1', 'b': False, 'c': None},
+            {'x': 2, 'half': 1.0, 's': 'v"2', 'b': False, 'c': None},
+            {'x': 3, 'half': 1.5, 's': 'v"3', 'b': True, 'c': [3, {'k': 3}]}])
+        # floats remain floats
+        self.env.assertTrue(isinstance(rows[1]['half'], float))
+
+        # graph entities follow the toJSON encoding
+        header, batches, stats = redis_con.execute_command("GRAPH.QUERY", "G",
+                "MATCH (n:person) RETURN n LIMIT 1", "--json")
+        node = json.loads(batches[0])[0]['n']
+        self.env.assertEqual(node['type'], 'node')
+        self.env.assertEqual(node['labels'], ['person'])
+        self.env.assertIn(node['properties']['name'], people)
+
+        # streamed chunks are replied as separate batches
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 3)
+        header, batches, stats = redis_con.execute_command("GRAPH.QUERY", "G",
+                "UNWIND range(1, 10) AS x RETURN x", "--json")
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 0)
+        values = [row['x'] for batch in batches for row in json.loads(batch)]
+        self.env.assertEqual(values, list(range(1, 11)))
+
+    # A run-time error raised after rows were streamed
+    # follows a complete header, records and statistics reply
+    def test15_streamed_error_reply_shape(self):
+        # records are produced in batches, fail well past the first batch
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 10)
+        reply = redis_con.execute_command("GRAPH.QUERY", "G",
+                "UNWIND range(1, 200) + ['a'] AS x RETURN x * 2")
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "RESULTSET_CHUNK_SIZE", 0)
+
+        self.env.assertEqual(len(reply), 4)
+        header, records, stats, error = reply
+
+        self.env.assertEqual(header, ['x * 2'])
+        # only complete chunks preceding the error are replied
+        self.env.assertGreater(len(records), 0)
+        self.env.assertEqual(len(records) % 10, 0)
+        self.env.assertEqual(records, [[2 * i] for i in range(1, len(records) + 1)])
+        self.env.assertTrue(any("Query internal execution time" in s for s in stats))
+        self.env.assertTrue(isinstance(error, redis.exceptions.ResponseError))
+        self.env.assertContains("Type mismatch", str(error))
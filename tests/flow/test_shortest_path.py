@@ -140,3 +140,44 @@ class testShortestPath(FlowTestsBase):
         # The longer traversal will be found
         expected_result = [[1], [2], [3], [4]]
         self.env.assertEqual(actual_result.result_set, expected_result)
+
+    def test07_all_shortest_paths(self):
+        # (s)->(a1|a2|a3)->(m)->(b1|b2)->(t), 6 shortest paths of 4 hops
+        # and a longer one, (s)-[:F]->(x)-[:F]->(y)-[:F]->(z)-[:F]->(w)-[:F]->(t)
+        g = Graph("all_shortest_paths", redis_graph.redis_con)
+        g.query("""CREATE (s:N {v: 's'}), (m:N {v: 'm'}), (t:N {v: 't'})
+                   WITH s, m, t
+                   UNWIND ['a1', 'a2', 'a3'] AS a
+                   CREATE (s)-[:E]->(:N {v: a})-[:E]->(m)""")
+        g.query("""MATCH (m:N {v: 'm'}), (t:N {v: 't'})
+                   UNWIND ['b1', 'b2'] AS b
+                   CREATE (m)-[:E2]->(:N {v: b})-[:E]->(t)""")
+        g.query("""MATCH (s:N {v: 's'}), (t:N {v: 't'})
+                   CREATE (s)-[:F]->(:N)-[:F]->(:N)-[:F]->(:N)-[:F]->(:N)-[:F]->(t)""")
+
+        query = """MATCH (s {v: 's'}), (t {v: 't'})
+                   UNWIND allShortestPaths((s)-[*]->(t)) AS p
+                   RETURN [n IN nodes(p) | n.v] AS vs ORDER BY vs"""
+        actual_result = g.query(query)
+        expected_result = [[['s', a, 'm', b, 't']] for a in ['a1', 'a2', 'a3'] for b in ['b1', 'b2']]
+        self.env.assertEqual(actual_result.result_set, expected_result)
+
+        # counted without enumerating the paths
+        query = """MATCH (s {v: 's'}), (t {v: 't'}) RETURN size(allShortestPaths((s)-[*]->(t)))"""
+        self.env.assertEqual(g.query(query).result_set, [[6]])
+
+        # paths longer than the maximum number of hops are ignored
+        query = """MATCH (s {v: 's'}), (t {v: 't'}) RETURN size(allShortestPaths((s)-[*..3]->(t))), allShortestPaths((s)-[*..3]->(t))"""
+        self.env.assertEqual(g.query(query).result_set, [[0, []]])
+
+        # without E2 only the longer path remains
+        query = """MATCH (s {v: 's'}), (t {v: 't'}) RETURN size(allShortestPaths((s)-[:E|:F*]->(t)))"""
+        self.env.assertEqual(g.query(query).result_set, [[1]])
+
+        query = """MATCH (s {v: 's'}), (t {v: 't'})
+                   RETURN [p IN allShortestPaths((s)-[:E|:E2*]->(t)) | length(p)]"""
+        self.env.assertEqual(g.query(query).result_set, [[[4] * 6]])
+
+        # a node's path to itself has no edges
+        query = """MATCH (s {v: 's'}) RETURN size(allShortestPaths((s)-[*0..]->(s))), size(allShortestPaths((s)-[*]->(s)))"""
+        self.env.assertEqual(g.query(query).result_set, [[1, 0]])
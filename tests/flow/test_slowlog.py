@@ -47,3 +47,115 @@ class testSlowLog(FlowTestsBase):
         B = redis_con.execute_command("GRAPH.SLOWLOG " + GRAPH_ID)
 
         self.env.assertNotEqual(A, B)
+
+    def test_slowlog_shapes(self):
+        redis_graph.query("""UNWIND range(0, 9) AS x CREATE (:S {w: x})""")
+        redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "RESET")
+        self.env.assertEquals(redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID), [])
+        self.env.assertEquals(redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "SHAPES"), [])
+
+        # queries which differ only by their literals share a shape
+        for i in range(10):
+            redis_graph.query("""MATCH (n:S) WHERE n.w = %d RETURN n.w""" % i)
+        redis_graph.query("""MATCH (n:S) WHERE n.w > 'a' RETURN n.w LIMIT 1""")
+
+        shapes = redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "SHAPES")
+        shapes = {s[0]: s for s in shapes}
+        self.env.assertEquals(len(shapes), 2)
+
+        shape = shapes["MATCH (n:S) WHERE n.w = ? RETURN n.w"]
+        # shape, count, total time, rows, p50, p95, p99, max
+        self.env.assertEquals(len(shape), 8)
+        self.env.assertEquals(shape[1], 10)
+        self.env.assertEquals(shape[3], 10)
+        p50, p95, p99, max_latency = [float(x) for x in shape[4:]]
+        self.env.assertLessEqual(p50, p95)
+        self.env.assertLessEqual(p95, p99)
+        self.env.assertLessEqual(p99, max_latency)
+
+        shape = shapes["MATCH (n:S) WHERE n.w > ? RETURN n.w LIMIT ?"]
+        self.env.assertEquals(shape[1], 1)
+        self.env.assertEquals(shape[3], 0)
+
+        # unknown subcommand
+        try:
+            redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "NONE")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Unknown subcommand", str(e))
+
+        redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "RESET")
+        self.env.assertEquals(redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "SHAPES"), [])
+
+    def test_slowlog_locks(self):
+        redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "RESET")
+
+        redis_graph.query("""UNWIND range(0, 50000) AS x CREATE (:L {v: x})""")
+        redis_graph.query("""MATCH (n:L) RETURN count(n)""")
+
+        read, write, holders = redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "LOCKS")
+        # lock type, acquired, contended, total wait, max wait
+        self.env.assertEquals(read[0], "read")
+        self.env.assertGreaterEqual(read[1], 1)
+        self.env.assertEquals(write[0], "write")
+        self.env.assertGreaterEqual(write[1], 1)
+        self.env.assertLessEqual(write[2], write[1])
+
+        # the bulk creation held the write lock for a while
+        queries = [h[1] for h in holders]
+        self.env.assertIn("UNWIND range(0, 50000) AS x CREATE (:L {v: x})", queries)
+
+        redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "RESET")
+        read, write, holders = redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "LOCKS")
+        self.env.assertEquals(read[1], 0)
+        self.env.assertEquals(write[1], 0)
+        self.env.assertEquals(holders, [])
+
+    def test_slowlog_traces(self):
+        redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "RESET")
+        phases = ["queue", "params", "plan", "writer_queue", "lock", "prepare",
+                  "execute", "reply", "log"]
+
+        # slowlog entries carry the phase times of their execution
+        redis_graph.query("""UNWIND range(0, 1000) AS x CREATE (:T {v: x})""")
+        slowlog = redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "SPANS")
+        self.env.assertEquals(len(slowlog), 1)
+        entry = slowlog[0]
+        self.env.assertEquals(len(entry), 5)
+        spans = entry[4]
+        self.env.assertEquals(spans[0::2], phases)
+        # phases preceding the reply add up to at most the query's latency
+        # queueing isn't accounted by the latency
+        total = sum(float(t) for t in spans[3:16:2])
+        self.env.assertLessEqual(total, float(entry[3]) + 1)
+        # execution took some time
+        self.env.assertGreater(float(spans[13]), 0)
+
+        # traces aren't kept by default
+        self.env.assertEquals(redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "TRACES"), [])
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "TRACE_SAMPLE_RATE", 1)
+        try:
+            redis_graph.query("""MATCH (n:T) RETURN count(n)""")
+            redis_graph.query("""CREATE (:T {v: -1})""")
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "TRACE_SAMPLE_RATE", 0)
+
+        # most recent first
+        traces = redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "TRACES")
+        self.env.assertEquals(len(traces), 2)
+        write, read = traces
+        self.env.assertEquals(write[1], "GRAPH.QUERY")
+        self.env.assertEquals(write[2], "CREATE (:T {v: -1})")
+        self.env.assertEquals(read[2], "MATCH (n:T) RETURN count(n)")
+        self.env.assertGreaterEqual(write[0], read[0])
+        for trace in traces:
+            self.env.assertEquals(trace[4][0::2], phases)
+            for t in trace[4][1::2]:
+                self.env.assertGreaterEqual(float(t), 0)
+
+        # read queries aren't queued on the writer thread
+        self.env.assertEquals(float(read[4][7]), 0)
+
+        redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "RESET")
+        self.env.assertEquals(redis_con.execute_command("GRAPH.SLOWLOG", GRAPH_ID, "TRACES"), [])
@@ -144,3 +144,40 @@ class testUnion(FlowTestsBase):
                    UNWIND range(1, 3) AS b RETURN b"""
         result = redis_graph.query(query)
         self.env.assertEquals(result.result_set, expected_result)
+
+    def test08_parallel_union(self):
+        redis_con = self.env.getConnection()
+        g = Graph("parallel_union", redis_con)
+        g.query("UNWIND range(0, 9999) AS x CREATE (:P {v: x})")
+
+        queries = ["""MATCH (n:P) WHERE n.v % 2 = 0 RETURN n.v AS v
+                      UNION ALL
+                      MATCH (n:P) WHERE n.v % 3 = 0 RETURN n.v AS v""",
+                   """MATCH (n:P) WHERE n.v % 2 = 0 RETURN n.v AS v
+                      UNION
+                      MATCH (n:P) WHERE n.v % 3 = 0 RETURN n.v AS v
+                      UNION
+                      MATCH (n:P) WHERE n.v < 10 RETURN n.v AS v""",
+                   """MATCH (n:P) RETURN count(n) AS v
+                      UNION ALL
+                      MATCH (n:P) WHERE n.v > 5000 RETURN count(n) AS v"""]
+
+        # compute expected results using a single thread
+        expected = [sorted(g.query(q).result_set) for q in queries]
+
+        redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_PARALLELISM", 4)
+        try:
+            for q, e in zip(queries, expected):
+                # records of different branches may interleave
+                self.env.assertEqual(sorted(g.query(q).result_set), e)
+
+            # a run-time error raised by a branch is reported
+            try:
+                g.query("""MATCH (n:P) RETURN n.v / (n.v - 5000) AS v
+                           UNION ALL
+                           MATCH (n:P) RETURN n.v AS v""")
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Division by zero", str(e))
+        finally:
+            redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_PARALLELISM", 1)
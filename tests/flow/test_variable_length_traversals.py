@@ -183,3 +183,129 @@ class testVariableLengthTraversals(FlowTestsBase):
         actual_result = redis_graph.query(query)
         expected_result = [['A', 'B']]
         self.env.assertEquals(actual_result.result_set, expected_result)
+
+    # Test variable-length traversals where both endpoints are bound
+    def test11_expand_into(self):
+        query = """MATCH (a), (b) WITH a, b MATCH (a)-[*]->(b) RETURN a.name, b.name ORDER BY a.name, b.name"""
+        plan = redis_graph.execution_plan(query)
+        self.env.assertIn("Expand Into", plan)
+        actual_result = redis_graph.query(query)
+        expected_result = [['A', 'B'],
+                           ['A', 'C'],
+                           ['A', 'D'],
+                           ['B', 'C'],
+                           ['B', 'D'],
+                           ['C', 'D']]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # destinations beyond the maximum number of hops are pruned
+        query = """MATCH (a), (b) WITH a, b MATCH (a)-[*..2]->(b) RETURN a.name, b.name ORDER BY a.name, b.name"""
+        actual_result = redis_graph.query(query)
+        expected_result = [['A', 'B'],
+                           ['A', 'C'],
+                           ['B', 'C'],
+                           ['B', 'D'],
+                           ['C', 'D']]
+        self.env.assertEquals(actual_result.result_set, expected_result)
+
+        # incoming and undirected traversals
+        query = """MATCH (a {name: 'D'}), (b {name: 'A'}) WITH a, b MATCH (a)<-[*]-(b) RETURN a.name, b.name"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [['D', 'A']])
+
+        query = """MATCH (a {name: 'D'}), (b {name: 'A'}) WITH a, b MATCH (a)-[*]-(b) RETURN a.name, b.name"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [['D', 'A']])
+
+        query = """MATCH (a {name: 'D'}), (b {name: 'A'}) WITH a, b MATCH (a)-[*]->(b) RETURN a.name, b.name"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEquals(actual_result.result_set, [])
+
+    def test12_distinct_destinations(self):
+        g = Graph("diamonds", redis_con)
+        # chain of 12 diamonds, 2^12 paths lead from the first node to the last
+        g.query("""UNWIND range(0, 11) AS i
+                   MERGE (s:D {v: i}) MERGE (t:D {v: i + 1})
+                   CREATE (s)-[:R]->(:M)-[:R]->(t), (s)-[:R]->(:M)-[:R]->(t)""")
+
+        query = """MATCH (a:D {v: 0})-[:R*]->(b:D) RETURN DISTINCT b.v ORDER BY b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[v] for v in range(1, 13)])
+
+        # reachable nodes within range of hops
+        query = """MATCH (a:D {v: 0})-[:R*..4]->(b) RETURN DISTINCT b.v ORDER BY b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1], [2], [None]])
+
+        query = """MATCH (a:D {v: 0})-[:R*0..2]->(b:D) RETURN DISTINCT b.v ORDER BY b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[0], [1]])
+
+        # without DISTINCT every path is produced
+        query = """MATCH (a:D {v: 0})-[:R*..4]->(b:D) RETURN count(b)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[2 + 4]])
+
+        # minimum of 2 hops, nodes reachable only through longer paths
+        query = """MATCH (a:D {v: 0})-[:R*3..4]->(b:D) RETURN DISTINCT b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[2]])
+
+        # source is reachable from itself through a cycle
+        g.query("MATCH (a:D {v: 12}), (b:D {v: 0}) CREATE (a)-[:R]->(b)")
+        query = """MATCH (a:D {v: 0})-[:R*]->(b:D) RETURN DISTINCT b.v ORDER BY b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[v] for v in range(0, 13)])
+
+    def test13_filtered_distinct_destinations(self):
+        g = Graph("flagged_chain", redis_con)
+        # chain 0->1->...->6, with a parallel flagged edge along every hop
+        # traversal through unflagged edges is interrupted after node 3
+        g.query("""UNWIND range(0, 5) AS i
+                   MERGE (s:N {v: i}) MERGE (t:N {v: i + 1})
+                   CREATE (s)-[:R {flagged: i = 3}]->(t), (s)-[:R {flagged: true}]->(t)""")
+
+        query = """MATCH (a:N {v: 0})-[:R*1..5 {flagged: false}]->(b:N) RETURN DISTINCT b.v ORDER BY b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1], [2], [3]])
+
+        query = """MATCH (a:N {v: 0})-[:R*1..5 {flagged: true}]->(b:N) RETURN DISTINCT b.v ORDER BY b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[v] for v in range(1, 6)])
+
+        # without DISTINCT every path is produced
+        query = """MATCH (a:N {v: 0})-[:R*1..5 {flagged: false}]->(b:N) RETURN count(b)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[3]])
+
+        # the edge itself is projected, paths are enumerated
+        query = """MATCH (a:N {v: 0})-[e:R*1..2 {flagged: true}]->(b:N) RETURN DISTINCT b.v, size(e) ORDER BY b.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[1, 1], [2, 2]])
+
+    def test14_distinct_aggregated_destinations(self):
+        g = Graph("dense", redis_con)
+        # every node links to the 8 nodes following it, modulo 64
+        # frontiers quickly cover most of the graph, making pull steps viable
+        g.query("""UNWIND range(0, 63) AS i CREATE (:N {v: i})""")
+        g.query("""MATCH (a:N), (b:N)
+                   WHERE b.v <> a.v AND (b.v - a.v + 64) % 64 <= 8
+                   CREATE (a)-[:R]->(b)""")
+
+        query = """MATCH (a:N {v: 0})-[:R*]->(b:N) RETURN count(DISTINCT b)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[64]])
+
+        query = """MATCH (a:N {v: 0})<-[:R*1..2]-(b:N) RETURN collect(DISTINCT b.v)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(sorted(actual_result.result_set[0][0]), list(range(48, 64)))
+
+        query = """MATCH (a:N)-[:R*..3]->(b:N) WHERE a.v < 2
+                   RETURN a.v, count(DISTINCT b) ORDER BY a.v"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[0, 24], [1, 24]])
+
+        # a non-distinct aggregation counts every path
+        query = """MATCH (a:N {v: 0})-[:R*..2]->(b:N) RETURN count(DISTINCT b), count(b)"""
+        actual_result = g.query(query)
+        self.env.assertEquals(actual_result.result_set, [[16, 8 + 64]])
@@ -0,0 +1,137 @@
+import os
+import sys
+from RLTest import Env
+from redisgraph import Graph
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+from base import FlowTestsBase
+
+GRAPH_ID = "vector_index"
+redis_con = None
+graph = None
+
+class testVectorIndex(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        global redis_con
+        global graph
+        redis_con = self.env.getConnection()
+        graph = Graph(GRAPH_ID, redis_con)
+        self.populate_graph()
+
+    def populate_graph(self):
+        graph.query("""UNWIND range(0, 9) AS i
+                       CREATE (:Doc {id: i, vec: [10 - i, i, 0]})""")
+        # values which aren't vectors aren't indexed
+        graph.query("CREATE (:Doc {id: 100, vec: 'not a vector'})")
+        graph.query("CREATE (:Doc {id: 101, vec: [1, 2]})")
+        graph.query("CREATE (:Doc {id: 102, vec: [0, 0, 0]})")
+        graph.query("CALL db.idx.vector.createNodeIndex('Doc', 'vec', 3)")
+
+    def query_ids(self, k, vec):
+        q = """CALL db.idx.vector.queryNodes('Doc', 'vec', $k, $vec)
+               YIELD node RETURN node.id"""
+        result = graph.query(q, {'k': k, 'vec': vec})
+        return [row[0] for row in result.result_set]
+
+    def test01_query_order(self):
+        # nearest to the x axis first
+        self.env.assertEquals(self.query_ids(3, [1, 0, 0]), [0, 1, 2])
+
+        # nearest to the y axis first
+        self.env.assertEquals(self.query_ids(3, [0, 1, 0]), [9, 8, 7])
+
+        # vector magnitude doesn't affect similarity
+        self.env.assertEquals(self.query_ids(3, [0, 100, 0]), [9, 8, 7])
+
+        # k exceeding the number of indexed vectors
+        self.env.assertEquals(len(self.query_ids(100, [1, 1, 0])), 10)
+
+        self.env.assertEquals(self.query_ids(0, [1, 1, 0]), [])
+
+    def test02_scores(self):
+        q = """CALL db.idx.vector.queryNodes('Doc', 'vec', 10, [1, 0, 0])
+               YIELD node, score RETURN node.id, score"""
+        result = graph.query(q).result_set
+        self.env.assertAlmostEqual(result[0][1], 1.0, 0.0001)
+
+        # scores are ordered descendingly
+        scores = [row[1] for row in result]
+        self.env.assertEquals(scores, sorted(scores, reverse=True))
+
+        # orthogonal vectors
+        q = """CALL db.idx.vector.queryNodes('Doc', 'vec', 1, [0, 0, 1])
+               YIELD score RETURN score"""
+        result = graph.query(q).result_set
+        self.env.assertAlmostEqual(result[0][0], 0.0, 0.0001)
+
+    def test03_updates(self):
+        # move node 5 onto the z axis
+        graph.query("MATCH (n:Doc {id: 5}) SET n.vec = [0, 0, 1]")
+        self.env.assertEquals(self.query_ids(1, [0, 0, 1]), [5])
+
+        # remove node 5 from the index
+        graph.query("MATCH (n:Doc {id: 5}) SET n.vec = NULL")
+        self.env.assertNotEqual(self.query_ids(1, [0, 0, 1]), [5])
+        self.env.assertEquals(len(self.query_ids(100, [1, 1, 0])), 9)
+
+        # index a new node
+        graph.query("CREATE (:Doc {id: 5, vec: [0, 0, 1]})")
+        self.env.assertEquals(self.query_ids(1, [0, 0, 1]), [5])
+
+        # delete node
+        graph.query("MATCH (n:Doc {id: 5}) DELETE n")
+        self.env.assertEquals(len(self.query_ids(100, [1, 1, 0])), 9)
+
+        # the index reflects modifications made by the same query
+        q = """CREATE (:Doc {id: 200, vec: [0, 0, 1]})
+               WITH 1 AS x
+               CALL db.idx.vector.queryNodes('Doc', 'vec', 1, [0, 0, 1])
+               YIELD node RETURN node.id"""
+        result = graph.query(q).result_set
+        self.env.assertEquals(result, [[200]])
+
+    def test04_list_indexes(self):
+        result = graph.query("CALL db.indexes() YIELD type, label, properties").result_set
+        self.env.assertIn(['vector', 'Doc', ['vec']], result)
+
+    def test05_errors(self):
+        queries = [
+            # no index
+            "CALL db.idx.vector.queryNodes('Doc', 'id', 1, [1, 0, 0])",
+            # dimension mismatch
+            "CALL db.idx.vector.queryNodes('Doc', 'vec', 1, [1, 0])",
+            # zero vector
+            "CALL db.idx.vector.queryNodes('Doc', 'vec', 1, [0, 0, 0])",
+            # negative k
+            "CALL db.idx.vector.queryNodes('Doc', 'vec', -1, [1, 0, 0])",
+            # invalid dimension
+            "CALL db.idx.vector.createNodeIndex('Doc', 'x', 0)",
+            # dimension differs from existing index
+            "CALL db.idx.vector.createNodeIndex('Doc', 'x', 4)",
+        ]
+        for q in queries:
+            try:
+                graph.query(q)
+                self.env.assertTrue(False)
+            except Exception:
+                pass
+
+        # unknown label, no results
+        result = graph.query("CALL db.idx.vector.queryNodes('None', 'vec', 1, [1, 0, 0])")
+        self.env.assertEquals(result.result_set, [])
+
+    def test06_persistence(self):
+        expected = self.query_ids(10, [1, 2, 3])
+        redis_con.execute_command("DEBUG", "RELOAD")
+        self.env.assertEquals(self.query_ids(10, [1, 2, 3]), expected)
+
+    def test07_drop(self):
+        graph.query("CALL db.idx.vector.drop('Doc')")
+        try:
+            graph.query("CALL db.idx.vector.queryNodes('Doc', 'vec', 1, [1, 0, 0])")
+            self.env.assertTrue(False)
+        except Exception:
+            pass
+
@@ -262,3 +262,23 @@ class testWithClause(FlowTestsBase):
             except redis.exceptions.ResponseError as e:
                 # Expecting an error.
                 self.env.assertIn("not defined", str(e))
+
+    # Projected variables are moved across scopes, and projected in place
+    # within a scope, values must survive both.
+    def test12_projected_variables(self):
+        query = """UNWIND ['a', 'b'] AS x WITH x, x + 'c' AS y WITH y AS x, x AS y WITH x, y, [x, y] AS l RETURN x, y, l"""
+        actual_result = redis_graph.query(query)
+        expected_result = [['ac', 'a', ['ac', 'a']],
+                           ['bc', 'b', ['bc', 'b']]]
+        self.env.assertEqual(actual_result.result_set, expected_result)
+
+        # a variable projected twice
+        query = """UNWIND ['a'] AS x WITH x, x AS y, toUpper(x) AS z RETURN x, y, z"""
+        actual_result = redis_graph.query(query)
+        self.env.assertEqual(actual_result.result_set, [['a', 'a', 'A']])
+
+        # entities and their properties projected over several scopes
+        query = """MATCH (a:label_a)-[e]->(b) WITH a, e, b WITH b AS a, a AS b, e RETURN a.b_idx, b.a_idx, e.edgeval ORDER BY e.edgeval"""
+        actual_result = redis_graph.query(query)
+        expected_result = [[i, i, i] for i in range(len(values))]
+        self.env.assertEqual(actual_result.result_set, expected_result)
@@ -0,0 +1,629 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+// microbenchmarks for matrix, entity and per record evaluation kernels
+// every benchmark runs over a synthetic graph generated from a fixed seed
+// such that consecutive runs measure the exact same work
+// results are written to stdout as a single JSON document
+//
+// usage: microbench.run [label] [scale]
+// label - free form string recorded in the output, e.g. a commit hash
+// scale - log2 of the number of nodes in the synthetic graph
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include "xxhash.h"
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/arithmetic/funcs.h"
+#include "../../src/execution_plan/record.h"
+#include "../../src/filter_tree/filter_tree.h"
+#include "../../src/arithmetic/arithmetic_expression.h"
+#include "../../src/configuration/config.h"
+#include "../../src/util/datablock/datablock.h"
+#include "../../src/graph/rg_matrix/rg_matrix.h"
+#include "../../src/graph/rg_matrix/rg_matrix_iter.h"
+#include "../../src/graph/entities/graph_entity.h"
+#include "../../src/ast/ast.h"
+#include "../../src/query_ctx.h"
+#include "../../src/ast/cypher_whitelist.h"
+#include "../../src/procedures/procedure.h"
+#include "../../src/graph/graphcontext.h"
+#include "../../src/execution_plan/execution_plan.h"
+
+#define SEED          42   // synthetic graph seed
+#define DEFAULT_SCALE 16   // log2 of the default number of nodes
+#define EDGE_FACTOR   8    // average out degree
+#define REPETITIONS   5    // the best of which is reported
+#define PLAN_BUILDS   1000 // query plans built per repetition
+
+static uint64_t _rng;      // generator state
+static bool _first = true; // first result emitted
+
+static inline uint64_t _Rand(void) {
+	// xorshift64*
+	_rng ^= _rng >> 12;
+	_rng ^= _rng << 25;
+	_rng ^= _rng >> 27;
+	return _rng * 2685821657736338717ULL;
+}
+
+static inline uint64_t _Now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// emit a single benchmark result
+// 'ns' is the best running time out of all repetitions
+static void _Report(const char *name, const char *param, uint64_t param_val,
+		uint64_t ops, uint64_t ns) {
+	printf("%s\n    {\"name\": \"%s\", \"%s\": %" PRIu64 ", \"ops\": %" PRIu64
+			", \"ns\": %" PRIu64 ", \"ns_per_op\": %.3f}",
+			_first ? "" : ",", name, param, param_val, ops, ns,
+			(double)ns / ops);
+	_first = false;
+}
+
+// synthetic edges, (src[i], dest[i])
+typedef struct {
+	GrB_Index n;      // number of nodes
+	GrB_Index m;      // number of edges
+	GrB_Index *src;   // edges source
+	GrB_Index *dest;  // edges destination
+} Edges;
+
+static Edges _Edges_New(GrB_Index n, GrB_Index m) {
+	Edges e = {.n = n, .m = m};
+	e.src  = rm_malloc(sizeof(GrB_Index) * m);
+	e.dest = rm_malloc(sizeof(GrB_Index) * m);
+
+	_rng = SEED;
+	for(GrB_Index i = 0; i < m; i++) {
+		e.src[i]  = _Rand() % n;
+		e.dest[i] = _Rand() % n;
+	}
+
+	return e;
+}
+
+static void _Edges_Free(Edges *e) {
+	rm_free(e->src);
+	rm_free(e->dest);
+}
+
+// build a fully synced matrix out of 'e'
+static RG_Matrix _Matrix_New(const Edges *e, GrB_Type type) {
+	RG_Matrix A;
+	RG_Matrix_new(&A, type, e->n, e->n);
+	for(GrB_Index i = 0; i < e->m; i++) {
+		if(type == GrB_BOOL) {
+			RG_Matrix_setElement_BOOL(A, e->src[i], e->dest[i]);
+		} else {
+			RG_Matrix_setElement_UINT64(A, i, e->src[i], e->dest[i]);
+		}
+	}
+	RG_Matrix_wait(A, true);
+	return A;
+}
+
+//------------------------------------------------------------------------------
+// RG_Matrix_setElement_*
+//------------------------------------------------------------------------------
+
+static void _Bench_SetElement(const Edges *e, GrB_Type type) {
+	uint64_t best = UINT64_MAX;
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		RG_Matrix A;
+		RG_Matrix_new(&A, type, e->n, e->n);
+
+		uint64_t start = _Now();
+		for(GrB_Index i = 0; i < e->m; i++) {
+			if(type == GrB_BOOL) {
+				RG_Matrix_setElement_BOOL(A, e->src[i], e->dest[i]);
+			} else {
+				RG_Matrix_setElement_UINT64(A, i, e->src[i], e->dest[i]);
+			}
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+
+		RG_Matrix_free(&A);
+	}
+
+	_Report(type == GrB_BOOL ? "rg_matrix_set_element_bool" :
+			"rg_matrix_set_element_uint64", "nodes", e->n, e->m, best);
+}
+
+//------------------------------------------------------------------------------
+// RG_Matrix_wait
+//------------------------------------------------------------------------------
+
+// flush 'pending' delta entries into a matrix holding all of 'e'
+static void _Bench_Wait(const Edges *e, GrB_Index pending) {
+	uint64_t best = UINT64_MAX;
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		RG_Matrix A = _Matrix_New(e, GrB_BOOL);
+
+		_rng = SEED + r + 1;
+		for(GrB_Index i = 0; i < pending; i++) {
+			RG_Matrix_setElement_BOOL(A, _Rand() % e->n, _Rand() % e->n);
+		}
+
+		uint64_t start = _Now();
+		RG_Matrix_wait(A, true);
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+
+		RG_Matrix_free(&A);
+	}
+
+	_Report("rg_matrix_wait", "pending", pending, pending, best);
+}
+
+//------------------------------------------------------------------------------
+// RG_MatrixTupleIter
+//------------------------------------------------------------------------------
+
+static void _Bench_Iter(const Edges *e, bool by_row) {
+	RG_Matrix A = _Matrix_New(e, GrB_BOOL);
+	GrB_Index nvals;
+	RG_Matrix_nvals(&nvals, A);
+
+	uint64_t best = UINT64_MAX;
+	GrB_Index sum = 0;  // keeps the loop from being optimized away
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		bool depleted;
+		GrB_Index col;
+		RG_MatrixTupleIter it;
+
+		uint64_t start = _Now();
+		RG_MatrixTupleIter_reuse(&it, A);
+		if(by_row) {
+			for(GrB_Index i = 0; i < e->n; i++) {
+				RG_MatrixTupleIter_iterate_row(&it, i);
+				while(true) {
+					RG_MatrixTupleIter_next(&it, NULL, &col, NULL, &depleted);
+					if(depleted) break;
+					sum += col;
+				}
+			}
+		} else {
+			while(true) {
+				RG_MatrixTupleIter_next(&it, NULL, &col, NULL, &depleted);
+				if(depleted) break;
+				sum += col;
+			}
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+	}
+
+	if(sum == 0) fprintf(stderr, "empty matrix\n");
+	_Report(by_row ? "rg_matrix_iter_rows" : "rg_matrix_iter_scan", "nodes",
+			e->n, nvals, best);
+
+	RG_Matrix_free(&A);
+}
+
+//------------------------------------------------------------------------------
+// RG_mxm
+//------------------------------------------------------------------------------
+
+// multiply batches of 'batch' frontier nodes by the adjacency matrix
+// mimicking the traversal ops, reports time per traversed source node
+static void _Bench_Mxm(const Edges *e, GrB_Index batch) {
+	RG_Matrix A = _Matrix_New(e, GrB_BOOL);
+	RG_Matrix F;
+	RG_Matrix C;
+	RG_Matrix_new(&F, GrB_BOOL, batch, e->n);
+	RG_Matrix_new(&C, GrB_BOOL, batch, e->n);
+
+	// traverse from the first 'sources' nodes
+	GrB_Index sources = (e->n < 4096) ? e->n : 4096;
+	sources -= sources % batch;
+	if(sources == 0) sources = batch;
+
+	uint64_t best = UINT64_MAX;
+	for(int r = 0; r < REPETITIONS; r++) {
+		uint64_t elapsed = 0;
+		for(GrB_Index offset = 0; offset < sources; offset += batch) {
+			RG_Matrix_clear(F);
+			for(GrB_Index i = 0; i < batch; i++) {
+				RG_Matrix_setElement_BOOL(F, i, (offset + i) % e->n);
+			}
+			RG_Matrix_wait(F, true);
+			RG_Matrix_clear(C);
+
+			uint64_t start = _Now();
+			RG_mxm(C, GxB_ANY_PAIR_BOOL, F, A);
+			elapsed += _Now() - start;
+		}
+		if(elapsed < best) best = elapsed;
+	}
+
+	_Report("rg_mxm", "batch", batch, sources, best);
+
+	RG_Matrix_free(&A);
+	RG_Matrix_free(&F);
+	RG_Matrix_free(&C);
+}
+
+//------------------------------------------------------------------------------
+// DataBlock
+//------------------------------------------------------------------------------
+
+static void _Bench_DataBlock(GrB_Index n) {
+	uint64_t best = UINT64_MAX;
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		DataBlock *db = DataBlock_New(16384, sizeof(Entity), NULL);
+
+		uint64_t start = _Now();
+		for(GrB_Index i = 0; i < n; i++) {
+			uint64_t idx;
+			Entity *en = DataBlock_AllocateItem(db, &idx);
+			en->properties = NULL;
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+
+		DataBlock_Free(db);
+	}
+
+	_Report("datablock_allocate_item", "items", n, n, best);
+}
+
+//------------------------------------------------------------------------------
+// GraphEntity_GetProperty
+//------------------------------------------------------------------------------
+
+static void _Bench_GetProperty(Attribute_ID prop_count) {
+	Entity en = {0};
+	GraphEntity ge = {.entity = &en, .id = 0};
+	for(Attribute_ID i = 0; i < prop_count; i++) {
+		GraphEntity_AddProperty(&ge, i, SI_LongVal(i));
+	}
+
+	// look up present attributes in a pseudo random order
+	const uint64_t lookups = 1 << 20;
+	Attribute_ID *ids = rm_malloc(sizeof(Attribute_ID) * lookups);
+	_rng = SEED;
+	for(uint64_t i = 0; i < lookups; i++) ids[i] = _Rand() % prop_count;
+
+	uint64_t best = UINT64_MAX;
+	int64_t sum = 0;  // keeps the loop from being optimized away
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		uint64_t start = _Now();
+		for(uint64_t i = 0; i < lookups; i++) {
+			sum += GraphEntity_GetProperty(&ge, ids[i])->longval;
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+	}
+
+	if(sum < 0) fprintf(stderr, "unexpected property value\n");
+	_Report("graph_entity_get_property", "properties", prop_count, lookups,
+			best);
+
+	rm_free(ids);
+	FreeEntity(&en);
+}
+
+//------------------------------------------------------------------------------
+// per record evaluation
+//------------------------------------------------------------------------------
+
+// synthetic records, each holding three scalars:
+// a - integer, b - double in [0, 1), s - string
+typedef struct {
+	uint64_t n;         // number of records
+	Record *records;    // records
+	rax *mapping;       // alias to record index
+	char (*strs)[16];   // backing storage of the string entries
+} Records;
+
+static Records _Records_New(uint64_t n) {
+	Records rs = {.n = n};
+	rs.records = rm_malloc(sizeof(Record) * n);
+	rs.strs = rm_malloc(sizeof(*rs.strs) * n);
+
+	rs.mapping = raxNew();
+	raxInsert(rs.mapping, (unsigned char *)"a", 1, (void *)0, NULL);
+	raxInsert(rs.mapping, (unsigned char *)"b", 1, (void *)1, NULL);
+	raxInsert(rs.mapping, (unsigned char *)"s", 1, (void *)2, NULL);
+
+	_rng = SEED;
+	for(uint64_t i = 0; i < n; i++) {
+		uint64_t v = _Rand();
+		snprintf(rs.strs[i], sizeof(rs.strs[i]), "user_%" PRIu64, v % 100000);
+
+		Record r = Record_New(rs.mapping);
+		Record_AddScalar(r, 0, SI_LongVal(v % 1000));
+		Record_AddScalar(r, 1, SI_DoubleVal((double)(v >> 11) / (1ULL << 53)));
+		Record_AddScalar(r, 2, SI_ConstStringVal(rs.strs[i]));
+		rs.records[i] = r;
+	}
+
+	return rs;
+}
+
+static void _Records_Free(Records *rs) {
+	for(uint64_t i = 0; i < rs->n; i++) Record_Free(rs->records[i]);
+	rm_free(rs->records);
+	rm_free(rs->strs);
+	raxFree(rs->mapping);
+}
+
+// build op node 'func'(lhs, rhs)
+static AR_ExpNode *_Exp_Op(const char *func, AR_ExpNode *lhs, AR_ExpNode *rhs) {
+	AR_ExpNode *op = AR_EXP_NewOpNode(func, 2);
+	op->op.children[0] = lhs;
+	op->op.children[1] = rhs;
+	return op;
+}
+
+static void _Bench_Evaluate(const Records *rs, const char *name,
+		AR_ExpNode *exp) {
+	uint64_t best = UINT64_MAX;
+	uint64_t types = 0;  // keeps the loop from being optimized away
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		uint64_t start = _Now();
+		for(uint64_t i = 0; i < rs->n; i++) {
+			SIValue v = AR_EXP_Evaluate(exp, rs->records[i]);
+			types |= SI_TYPE(v);
+			SIValue_Free(v);
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+	}
+
+	if(types == 0) fprintf(stderr, "unexpected evaluation result\n");
+	_Report(name, "records", rs->n, rs->n, best);
+
+	AR_EXP_Free(exp);
+}
+
+static void _Bench_Filter(const Records *rs, const char *name,
+		FT_FilterNode *filter) {
+	uint64_t best = UINT64_MAX;
+	uint64_t passed = 0;  // keeps the loop from being optimized away
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		uint64_t start = _Now();
+		for(uint64_t i = 0; i < rs->n; i++) {
+			passed += (FilterTree_applyFilters(filter, rs->records[i]) == FILTER_PASS);
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+	}
+
+	if(passed == 0) fprintf(stderr, "no record passed filter %s\n", name);
+	_Report(name, "records", rs->n, rs->n, best);
+
+	FilterTree_Free(filter);
+}
+
+// compares entry 'idx' of each record to the next record's
+static void _Bench_Compare(const Records *rs, uint idx, const char *name) {
+	uint64_t best = UINT64_MAX;
+	int64_t sum = 0;  // keeps the loop from being optimized away
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		uint64_t start = _Now();
+		for(uint64_t i = 1; i < rs->n; i++) {
+			sum += SIValue_Compare(Record_Get(rs->records[i - 1], idx),
+					Record_Get(rs->records[i], idx), NULL);
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+	}
+
+	if(sum == INT64_MAX) fprintf(stderr, "unexpected comparison\n");
+	_Report(name, "records", rs->n, rs->n - 1, best);
+}
+
+// hashes all entries of each record, as distinct and aggregate do
+static void _Bench_Hash(const Records *rs) {
+	uint64_t best = UINT64_MAX;
+	XXH64_hash_t sum = 0;  // keeps the loop from being optimized away
+	XXH64_state_t state;
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		uint64_t start = _Now();
+		for(uint64_t i = 0; i < rs->n; i++) {
+			XXH64_reset(&state, 0);
+			for(uint j = 0; j < 3; j++) {
+				SIValue_HashUpdate(Record_Get(rs->records[i], j), &state);
+			}
+			sum += XXH64_digest(&state);
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+	}
+
+	if(sum == 0) fprintf(stderr, "unexpected hash\n");
+	_Report("sivalue_hash_update", "records", rs->n, rs->n, best);
+}
+
+static void _Bench_Records(uint64_t n) {
+	Records rs = _Records_New(n);
+
+	// a + b * 2
+	_Bench_Evaluate(&rs, "ar_exp_evaluate_arithmetic",
+			_Exp_Op("add", AR_EXP_NewVariableOperandNode("a"),
+				_Exp_Op("mul", AR_EXP_NewVariableOperandNode("b"),
+					AR_EXP_NewConstOperandNode(SI_LongVal(2)))));
+
+	// s STARTS WITH 'user_1'
+	_Bench_Evaluate(&rs, "ar_exp_evaluate_string",
+			_Exp_Op("starts with", AR_EXP_NewVariableOperandNode("s"),
+				AR_EXP_NewConstOperandNode(SI_ConstStringVal("user_1"))));
+
+	// a > 100
+	_Bench_Filter(&rs, "filter_tree_predicate",
+			FilterTree_CreatePredicateFilter(OP_GT,
+				AR_EXP_NewVariableOperandNode("a"),
+				AR_EXP_NewConstOperandNode(SI_LongVal(100))));
+
+	// a > 100 AND b < 0.5 AND s CONTAINS '7'
+	FT_FilterNode *inner = FilterTree_CreateConditionFilter(OP_AND);
+	FilterTree_AppendLeftChild(inner, FilterTree_CreatePredicateFilter(OP_GT,
+				AR_EXP_NewVariableOperandNode("a"),
+				AR_EXP_NewConstOperandNode(SI_LongVal(100))));
+	FilterTree_AppendRightChild(inner, FilterTree_CreatePredicateFilter(OP_LT,
+				AR_EXP_NewVariableOperandNode("b"),
+				AR_EXP_NewConstOperandNode(SI_DoubleVal(0.5))));
+	FT_FilterNode *outer = FilterTree_CreateConditionFilter(OP_AND);
+	FilterTree_AppendLeftChild(outer, inner);
+	FilterTree_AppendRightChild(outer, FilterTree_CreateExpressionFilter(
+				_Exp_Op("contains", AR_EXP_NewVariableOperandNode("s"),
+					AR_EXP_NewConstOperandNode(SI_ConstStringVal("7")))));
+	_Bench_Filter(&rs, "filter_tree_conjunction", outer);
+
+	_Bench_Compare(&rs, 0, "sivalue_compare_integer");
+	_Bench_Compare(&rs, 1, "sivalue_compare_double");
+	_Bench_Compare(&rs, 2, "sivalue_compare_string");
+
+	_Bench_Hash(&rs);
+
+	_Records_Free(&rs);
+}
+
+//------------------------------------------------------------------------------
+// query parsing and planning
+//------------------------------------------------------------------------------
+
+// queries planned on cache misses, from simple lookups to multi clause queries
+static const char *_queries[] = {
+	"MATCH (n:Person) RETURN n",
+	"MATCH (n:Person {name: 'a'}) RETURN n.age",
+	"MATCH (a:Person)-[:KNOWS]->(b:Person) WHERE a.age > 30 RETURN b.name",
+	"MATCH (a)-[:KNOWS*1..3]->(b) RETURN a, count(b) ORDER BY a LIMIT 10",
+	"MATCH (a:Person) WITH a, a.age AS age WHERE age > 10 "
+		"MATCH (a)-[:WORKS_AT]->(c:Company) RETURN c.name, collect(a.name)",
+	"UNWIND range(0, 100) AS x CREATE (:Person {id: x, name: toString(x)})",
+	"MATCH (a:Person {id: 1}), (b:Person {id: 2}) MERGE (a)-[:KNOWS]->(b)",
+	"MATCH (n:Person) WHERE n.id IN [1, 2, 3] SET n.v = n.v + 1 RETURN n",
+	"MATCH (a:Person) OPTIONAL MATCH (a)-[:KNOWS]->(b) "
+		"RETURN a.name, {friend: b.name, age: b.age} AS friend",
+	"MATCH (a:Person) RETURN a.name AS name UNION "
+		"MATCH (c:Company) RETURN c.name AS name",
+};
+
+// parse and validate a query
+// if 'plan' is set, also build its AST and execution plan
+static void _Bench_Plan(uint query_idx, bool plan) {
+	const char *query = _queries[query_idx];
+	uint64_t best = UINT64_MAX;
+
+	for(int r = 0; r < REPETITIONS; r++) {
+		uint64_t start = _Now();
+		for(int i = 0; i < PLAN_BUILDS; i++) {
+			cypher_parse_result_t *parse_result = parse_query(query);
+			if(parse_result == NULL) {
+				fprintf(stderr, "failed to parse: %s\n", query);
+				exit(1);
+			}
+			if(!plan) {
+				parse_result_free(parse_result);
+				continue;
+			}
+			AST *ast = AST_Build(parse_result);
+			ExecutionPlan *ep = NewExecutionPlan();
+			ExecutionPlan_Free(ep);
+			AST_Free(ast);
+		}
+		uint64_t elapsed = _Now() - start;
+		if(elapsed < best) best = elapsed;
+	}
+
+	_Report(plan ? "query_parse_plan" : "query_parse_validate", "query",
+			query_idx, PLAN_BUILDS, best);
+}
+
+static void _Bench_Queries(void) {
+	QueryCtx_Init();
+	Proc_Register();
+	CypherWhitelist_Build();
+	// an empty graph, set as the planned queries' graph
+	// kept alive until the process exits
+	GraphContext_New("microbench", 16, 16);
+
+	uint query_count = sizeof(_queries) / sizeof(_queries[0]);
+	for(uint i = 0; i < query_count; i++) {
+		_Bench_Plan(i, false);
+		_Bench_Plan(i, true);
+	}
+}
+
+int main(int argc, char **argv) {
+	const char *label = (argc > 1) ? argv[1] : "";
+	int scale = (argc > 2) ? atoi(argv[2]) : DEFAULT_SCALE;
+	if(scale < 4 || scale > 30) {
+		fprintf(stderr, "scale must be within [4, 30]\n");
+		return 1;
+	}
+
+	// use the malloc family for allocations
+	Alloc_Reset();
+	AR_RegisterFuncs();
+
+	GrB_init(GrB_NONBLOCKING);
+	// all matrices in CSR format
+	GxB_Global_Option_set(GxB_FORMAT, GxB_BY_ROW);
+	// flush deltas only when explicitly asked to
+	Config_Option_set(Config_DELTA_MAX_PENDING_CHANGES, "100000000");
+
+	GrB_Index n = 1ULL << scale;
+	Edges e = _Edges_New(n, n * EDGE_FACTOR);
+
+	printf("{\n  \"label\": \"%s\",\n  \"scale\": %d,\n  \"edge_factor\": %d,"
+			"\n  \"seed\": %d,\n  \"benchmarks\": [", label, scale, EDGE_FACTOR,
+			SEED);
+
+	_Bench_SetElement(&e, GrB_BOOL);
+	_Bench_SetElement(&e, GrB_UINT64);
+
+	_Bench_Wait(&e, 1024);
+	_Bench_Wait(&e, e.m / 8);
+	_Bench_Wait(&e, e.m);
+
+	_Bench_Iter(&e, false);
+	_Bench_Iter(&e, true);
+
+	GrB_Index batches[] = {1, 16, 64, 256, 1024};
+	for(int i = 0; i < sizeof(batches) / sizeof(batches[0]); i++) {
+		_Bench_Mxm(&e, batches[i]);
+	}
+
+	_Bench_DataBlock(n);
+
+	Attribute_ID prop_counts[] = {4, 16, 64};
+	for(int i = 0; i < sizeof(prop_counts) / sizeof(prop_counts[0]); i++) {
+		_Bench_GetProperty(prop_counts[i]);
+	}
+
+	_Bench_Records(n);
+
+	_Bench_Queries();
+
+	printf("\n  ]\n}\n");
+
+	_Edges_Free(&e);
+	GrB_finalize();
+
+	return 0;
+}
@@ -0,0 +1,104 @@
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/arr.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/adjacency_cache.h"
+#ifdef __cplusplus
+}
+#endif
+
+class AdjacencyCacheTest:
+	public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+static Edge *_BuildEdges(NodeID src, uint count) {
+	Edge *edges = array_new(Edge, count);
+	for(uint i = 0; i < count; i++) {
+		Edge e = {0};
+		e.id         = i;
+		e.srcNodeID  = src;
+		e.destNodeID = i + 100;
+		e.relationID = 0;
+		array_append(edges, e);
+	}
+	return edges;
+}
+
+TEST_F(AdjacencyCacheTest, GetSet) {
+	AdjacencyCache *cache = AdjacencyCache_New();
+	Edge *edges = _BuildEdges(1, 3);
+	Edge *out = array_new(Edge, 0);
+
+	// empty cache
+	ASSERT_FALSE(AdjacencyCache_Get(cache, 1, 1, 0, true, &out));
+
+	AdjacencyCache_Set(cache, 1, 1, 0, true, edges, 3);
+	ASSERT_EQ(AdjacencyCache_EdgeCount(cache), 3);
+
+	// entries are keyed by node, relation and direction
+	ASSERT_FALSE(AdjacencyCache_Get(cache, 1, 2, 0, true, &out));
+	ASSERT_FALSE(AdjacencyCache_Get(cache, 1, 1, 1, true, &out));
+	ASSERT_FALSE(AdjacencyCache_Get(cache, 1, 1, 0, false, &out));
+	ASSERT_EQ(array_len(out), 0);
+
+	// cached edges are appended to the output
+	Edge e = {0};
+	array_append(out, e);
+	ASSERT_TRUE(AdjacencyCache_Get(cache, 1, 1, 0, true, &out));
+	ASSERT_EQ(array_len(out), 4);
+	for(uint i = 0; i < 3; i++) {
+		ASSERT_EQ(out[i + 1].id, edges[i].id);
+		ASSERT_EQ(out[i + 1].destNodeID, edges[i].destNodeID);
+	}
+
+	array_free(out);
+	array_free(edges);
+	AdjacencyCache_Free(cache);
+}
+
+TEST_F(AdjacencyCacheTest, EpochInvalidation) {
+	AdjacencyCache *cache = AdjacencyCache_New();
+	Edge *edges = _BuildEdges(1, 3);
+	Edge *out = array_new(Edge, 0);
+
+	AdjacencyCache_Set(cache, 1, 1, 0, true, edges, 3);
+
+	// a write advanced the epoch, entries are stale
+	ASSERT_FALSE(AdjacencyCache_Get(cache, 2, 1, 0, true, &out));
+
+	// populating the new epoch discards stale entries
+	AdjacencyCache_Set(cache, 2, 2, 0, true, edges, 2);
+	ASSERT_EQ(AdjacencyCache_EdgeCount(cache), 2);
+	ASSERT_FALSE(AdjacencyCache_Get(cache, 2, 1, 0, true, &out));
+	ASSERT_TRUE(AdjacencyCache_Get(cache, 2, 2, 0, true, &out));
+	ASSERT_EQ(array_len(out), 2);
+
+	array_free(out);
+	array_free(edges);
+	AdjacencyCache_Free(cache);
+}
+
+TEST_F(AdjacencyCacheTest, Capacity) {
+	AdjacencyCache *cache = AdjacencyCache_New();
+	uint count = ADJACENCY_CACHE_MAX_EDGES / 2 + 1;
+	Edge *edges = _BuildEdges(1, count);
+	Edge *out = array_new(Edge, 0);
+
+	// exceeding capacity clears the cache
+	AdjacencyCache_Set(cache, 1, 1, 0, true, edges, count);
+	AdjacencyCache_Set(cache, 1, 2, 0, true, edges, count);
+	ASSERT_EQ(AdjacencyCache_EdgeCount(cache), count);
+	ASSERT_FALSE(AdjacencyCache_Get(cache, 1, 1, 0, true, &out));
+	ASSERT_TRUE(AdjacencyCache_Get(cache, 1, 2, 0, true, &out));
+
+	array_free(out);
+	array_free(edges);
+	AdjacencyCache_Free(cache);
+}
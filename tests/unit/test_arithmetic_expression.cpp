@@ -1758,3 +1758,43 @@ TEST_F(ArithmeticTest, ReplaceTest) {
 	ASSERT_EQ(AR_EXP_CONSTANT, arExp->operand.type);
 	ASSERT_EQ(0, SIValue_Compare(SI_ConstStringVal("0a0b0c0a0b0c0"), arExp->operand.constant, NULL));
 }
+
+TEST_F(ArithmeticTest, ShareSubexpressionsTest) {
+	const char *query;
+	AR_ExpNode *arExp;
+
+	// x * 2 is shared by both of its occurrences
+	query = "WITH 1 AS x RETURN x * 2 + x * 2 * 3";
+	arExp = _exp_from_query(query);
+	ASSERT_EQ(AR_EXP_OP, arExp->type);
+
+	AR_ExpNode *lhs = arExp->op.children[0];
+	AR_ExpNode *rhs = arExp->op.children[1]->op.children[0];
+	ASSERT_EQ(AR_EXP_OP, lhs->type);
+	ASSERT_EQ(AR_EXP_OP, rhs->type);
+	ASSERT_TRUE(lhs->op.memo != NULL);
+	ASSERT_EQ(lhs->op.memo, rhs->op.memo);
+	ASSERT_TRUE(arExp->op.memo == NULL);
+
+	// clones share subexpressions among themselves
+	AR_ExpNode *clone = AR_EXP_Clone(arExp);
+	AR_ExpNode *clone_lhs = clone->op.children[0];
+	AR_ExpNode *clone_rhs = clone->op.children[1]->op.children[0];
+	ASSERT_TRUE(clone_lhs->op.memo != NULL);
+	ASSERT_NE(lhs->op.memo, clone_lhs->op.memo);
+	ASSERT_EQ(clone_lhs->op.memo, clone_rhs->op.memo);
+
+	AR_EXP_Free(clone);
+	AR_EXP_Free(arExp);
+
+	// non-deterministic functions are never shared
+	query = "WITH 1 AS x RETURN x + rand() + x + rand()";
+	arExp = _exp_from_query(query);
+	AR_ExpNode *rand_a = arExp->op.children[1];
+	AR_ExpNode *rand_b = arExp->op.children[0]->op.children[0]->op.children[1];
+	ASSERT_EQ(0, strcasecmp("rand", AR_EXP_GetFuncName(rand_a)));
+	ASSERT_EQ(0, strcasecmp("rand", AR_EXP_GetFuncName(rand_b)));
+	ASSERT_TRUE(rand_a->op.memo == NULL);
+	ASSERT_TRUE(rand_b->op.memo == NULL);
+	AR_EXP_Free(arExp);
+}
@@ -0,0 +1,72 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/util/rmalloc.h"
+#include "../../src/ast/ast_parameterize.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class AutoParameterizeTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+
+	// validate query rewrite, 'expected' is NULL if no literal should be lifted
+	void validate(const char *query, const char *body, const char *expected) {
+		sds rewritten = AST_AutoParameterize(query, body);
+		if(expected == NULL) {
+			ASSERT_TRUE(rewritten == NULL);
+		} else {
+			ASSERT_TRUE(rewritten != NULL);
+			ASSERT_STREQ(rewritten, expected);
+			sdsfree(rewritten);
+		}
+	}
+};
+
+TEST_F(AutoParameterizeTest, LiftLiterals) {
+	const char *q = "MATCH (n {v: 1}) WHERE n.x > 'a' RETURN n";
+	validate(q, q, "CYPHER __ap0=1 __ap1='a' MATCH (n {v: $__ap0}) WHERE n.x > $__ap1 RETURN n");
+
+	q = "MATCH (n) WHERE n.v = 'a\\'b' OR n.v < 2.5e-3 RETURN n";
+	validate(q, q, "CYPHER __ap0='a\\'b' __ap1=2.5e-3 MATCH (n) WHERE n.v = $__ap0 OR n.v < $__ap1 RETURN n");
+
+	q = "MATCH (n)-[*1..3]->(m) WHERE n.name STARTS WITH \"x\" RETURN m LIMIT 3";
+	validate(q, q, "CYPHER __ap0=\"x\" MATCH (n)-[*1..3]->(m) WHERE n.name STARTS WITH $__ap0 RETURN m LIMIT 3");
+}
+
+TEST_F(AutoParameterizeTest, ExtendParamsHeader) {
+	const char *q = "CYPHER a=1 MATCH (n) WHERE n.x = $a AND n.y <> 2 RETURN n";
+	const char *body = q + strlen("CYPHER a=1 ");
+	validate(q, body, "CYPHER a=1  __ap0=2 MATCH (n) WHERE n.x = $a AND n.y <> $__ap0 RETURN n");
+}
+
+TEST_F(AutoParameterizeTest, KeepLiterals) {
+	// projections and write clauses are left as is
+	const char *q = "MATCH (n) RETURN n.v + 1, [(n)-->(m) WHERE m.v = 1 | m] AS x";
+	validate(q, q, NULL);
+
+	q = "CREATE (n {v: 1}) SET n.x = 2";
+	validate(q, q, NULL);
+
+	// ID lookups are resolved at plan construction
+	q = "MATCH (n) WHERE id(n) = 1 AND n.v = 2 RETURN n";
+	validate(q, q, NULL);
+
+	// avoid clashing with user parameters
+	q = "CYPHER __ap0=1 MATCH (n) WHERE n.v = 2 AND n.x = $__ap0 RETURN n";
+	validate(q, q + strlen("CYPHER __ap0=1 "), NULL);
+}
@@ -19,6 +19,7 @@ class CacheTest:
 };
 
 static int free_count = 0;  // count how many cache objects been freed
+static int copy_count = 0;  // count how many cache objects been copied
 
 typedef struct {
 	const char *str;
@@ -31,6 +32,7 @@ CacheObj *CacheObj_New(const char *str) {
 }
 
 CacheObj *CacheObj_Dup(const CacheObj *obj) {
+	copy_count++;
 	CacheObj *dup = (CacheObj *)rm_malloc(sizeof(CacheObj));
 	memcpy(dup, obj, sizeof(CacheObj));
 	return dup;
@@ -96,9 +98,119 @@ TEST_F(CacheTest, ExecutionPlanCache) {
 	// Verify that oldest entry do not exists - queue is [ 4 | 3 | 2 ].
 	ASSERT_TRUE(Cache_GetValue(cache, key1) == NULL);
 
+	//--------------------------------------------------------------------------
+	// Validate hit / miss counters
+	//--------------------------------------------------------------------------
+
+	uint64_t hits;
+	uint64_t misses;
+	Cache_GetStats(cache, &hits, &misses);
+	ASSERT_EQ(hits, 2);
+	ASSERT_EQ(misses, 2);
+
 	Cache_Free(cache);
 
 	// Expecting CacheObjFree to be called 9 times.
 	ASSERT_EQ(free_count, 9);
 }
 
+
+TEST_F(CacheTest, ClockEviction) {
+	Cache *cache = Cache_New(2, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key_a = "MATCH (a) RETURN a";
+	const char *key_b = "MATCH (b) RETURN b";
+	const char *key_c = "MATCH (c) RETURN c";
+	const char *key_d = "MATCH (d) RETURN d";
+
+	Cache_SetValue(cache, key_a, CacheObj_New("a"));
+	Cache_SetValue(cache, key_b, CacheObj_New("b"));
+
+	// all entries were recently used, the clock sweeps and evicts 'a'
+	Cache_SetValue(cache, key_c, CacheObj_New("c"));
+
+	// 'b' wasn't used since the sweep, 'c' was just inserted
+	Cache_SetValue(cache, key_d, CacheObj_New("d"));
+
+	ASSERT_TRUE(Cache_GetValue(cache, key_a) == NULL);
+	ASSERT_TRUE(Cache_GetValue(cache, key_b) == NULL);
+
+	CacheObj *from_cache = (CacheObj *)Cache_GetValue(cache, key_c);
+	ASSERT_STREQ(from_cache->str, "c");
+	CacheObj_Free(from_cache);
+
+	from_cache = (CacheObj *)Cache_GetValue(cache, key_d);
+	ASSERT_STREQ(from_cache->str, "d");
+	CacheObj_Free(from_cache);
+
+	Cache_Free(cache);
+}
+
+TEST_F(CacheTest, SparePool) {
+	free_count = 0;
+	copy_count = 0;
+
+	Cache *cache = Cache_New(2, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key = "MATCH (a) RETURN a";
+	Cache_SetValue(cache, key, CacheObj_New("1"));
+
+	// fill the pool of spares, replenishing a full pool is a no-op
+	for(int i = 0; i < CACHE_POOL_CAP + 1; i++) Cache_Replenish(cache, key);
+	ASSERT_EQ(copy_count, CACHE_POOL_CAP);
+
+	// replenishing a missing key is a no-op
+	Cache_Replenish(cache, "None existing");
+	ASSERT_EQ(copy_count, CACHE_POOL_CAP);
+
+	// hits pop spares before resorting to copying
+	for(int i = 0; i < CACHE_POOL_CAP; i++) {
+		CacheObj *from_cache = (CacheObj *)Cache_GetValue(cache, key);
+		ASSERT_STREQ(from_cache->str, "1");
+		ASSERT_EQ(copy_count, CACHE_POOL_CAP);
+		CacheObj_Free(from_cache);
+	}
+
+	CacheObj *from_cache = (CacheObj *)Cache_GetValue(cache, key);
+	ASSERT_EQ(copy_count, CACHE_POOL_CAP + 1);
+	CacheObj_Free(from_cache);
+
+	// spares are released along with the cache
+	Cache_Replenish(cache, key);
+	Cache_Free(cache);
+	ASSERT_EQ(free_count, copy_count + 1);
+}
+
+TEST_F(CacheTest, Remove) {
+	free_count = 0;
+
+	Cache *cache = Cache_New(3, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	Cache_SetValue(cache, "1", CacheObj_New("1"));
+	Cache_SetValue(cache, "2", CacheObj_New("2"));
+	Cache_SetValue(cache, "3", CacheObj_New("3"));
+
+	// removed entries are freed and no longer found
+	ASSERT_TRUE(Cache_Remove(cache, "1"));
+	ASSERT_EQ(free_count, 1);
+	ASSERT_TRUE(Cache_GetValue(cache, "1") == NULL);
+	ASSERT_FALSE(Cache_Remove(cache, "1"));
+
+	// remaining entries are unaffected
+	CacheObj *from_cache = (CacheObj *)Cache_GetValue(cache, "3");
+	ASSERT_STREQ(from_cache->str, "3");
+	CacheObj_Free(from_cache);
+
+	// the freed position is reused without evicting
+	free_count = 0;
+	Cache_SetValue(cache, "4", CacheObj_New("4"));
+	ASSERT_EQ(free_count, 0);
+	from_cache = (CacheObj *)Cache_GetValue(cache, "2");
+	ASSERT_STREQ(from_cache->str, "2");
+	CacheObj_Free(from_cache);
+
+	Cache_Free(cache);
+}
@@ -39,11 +39,12 @@ TEST_F(DataBlockTest, New) {
 	ASSERT_EQ(dataBlock->itemCount, 0);     // No items were added.
 	ASSERT_GE(dataBlock->itemCap, 1024);
 	ASSERT_EQ(dataBlock->itemSize, itemSize + ITEM_HEADER_SIZE);
-	ASSERT_GE(dataBlock->blockCount, 1024 / DATABLOCK_BLOCK_CAP);
+	ASSERT_EQ(dataBlock->blockCount, DataBlock_BlockCount(1024));
 
 	for(int i = 0; i < dataBlock->blockCount; i++) {
 		Block *block = dataBlock->blocks[i];
 		ASSERT_EQ(block->itemSize, dataBlock->itemSize);
+		ASSERT_EQ(block->capacity, DataBlock_BlockCap(i));
 		ASSERT_TRUE(block->data != NULL);
 		if(i > 0) {
 			ASSERT_TRUE(dataBlock->blocks[i - 1]->next == dataBlock->blocks[i]);
@@ -239,3 +240,191 @@ TEST_F(DataBlockTest, OutOfOrderBuilding) {
 	DataBlock_Free(dataBlock);
 }
 
+
+TEST_F(DataBlockTest, Trim) {
+	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, sizeof(int), NULL);
+	uint itemCount = DATABLOCK_BLOCK_CAP * 3;
+
+	for(uint i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+	ASSERT_EQ(dataBlock->blockCount, DATABLOCK_SMALL_BLOCK_COUNT + 2);
+
+	// the last block still holds a live item, nothing to release
+	for(uint i = DATABLOCK_BLOCK_CAP; i < itemCount - 1; i++) {
+		DataBlock_DeleteItem(dataBlock, i);
+	}
+	ASSERT_EQ(DataBlock_Trim(dataBlock), 0);
+	ASSERT_EQ(dataBlock->blockCount, DATABLOCK_SMALL_BLOCK_COUNT + 2);
+
+	// release both trailing blocks
+	DataBlock_DeleteItem(dataBlock, itemCount - 1);
+	ASSERT_EQ(DataBlock_Trim(dataBlock), 2);
+	ASSERT_EQ(dataBlock->blockCount, DATABLOCK_SMALL_BLOCK_COUNT);
+	ASSERT_EQ(dataBlock->itemCap, DATABLOCK_BLOCK_CAP);
+	ASSERT_EQ(dataBlock->itemCount, DATABLOCK_BLOCK_CAP);
+	ASSERT_EQ(DataBlock_DeletedItemsCount(dataBlock), 0);
+	ASSERT_TRUE(dataBlock->blocks[DATABLOCK_SMALL_BLOCK_COUNT - 1]->next == NULL);
+
+	// live items are left untouched
+	for(uint i = 0; i < DATABLOCK_BLOCK_CAP; i++) {
+		int *item = (int *)DataBlock_GetItem(dataBlock, i);
+		ASSERT_EQ(*item, i);
+	}
+
+	// deleted items within the kept block remain reusable
+	DataBlock_DeleteItem(dataBlock, 7);
+	ASSERT_EQ(DataBlock_Trim(dataBlock), 0);
+	uint64_t idx;
+	DataBlock_AllocateItem(dataBlock, &idx);
+	ASSERT_EQ(idx, 7);
+
+	// new items are appended after the last live item
+	DataBlock_AllocateItem(dataBlock, &idx);
+	ASSERT_EQ(idx, DATABLOCK_BLOCK_CAP);
+	ASSERT_EQ(dataBlock->blockCount, DATABLOCK_SMALL_BLOCK_COUNT + 1);
+
+	DataBlock_Free(dataBlock);
+}
+
+static int _destructed = 0;
+static void _CountDestructor(void *item) {
+	_destructed++;
+}
+
+TEST_F(DataBlockTest, ReleaseBlocks) {
+	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, sizeof(int),
+			_CountDestructor);
+
+	// two full blocks and a partially used third block
+	uint itemCount = DATABLOCK_BLOCK_CAP * 2 + 10;
+	for(uint i = 0; i < itemCount; i++) DataBlock_AllocateItem(dataBlock, NULL);
+	ASSERT_EQ(dataBlock->blockCount, DATABLOCK_SMALL_BLOCK_COUNT + 2);
+
+	// deleted items are destructed once
+	DataBlock_DeleteItem(dataBlock, 3);
+	ASSERT_EQ(_destructed, 1);
+
+	// only used items of the last block are destructed
+	ASSERT_EQ(DataBlock_ReleaseBlocks(dataBlock, 1),
+			DATABLOCK_SMALL_BLOCK_COUNT + 1);
+	ASSERT_EQ(_destructed, 11);
+
+	ASSERT_EQ(DataBlock_ReleaseBlocks(dataBlock, DATABLOCK_SMALL_BLOCK_COUNT + 1), 0);
+	ASSERT_EQ(_destructed, itemCount);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, GrowingBlocks) {
+	// a small datablock holds a single small block
+	DataBlock *dataBlock = DataBlock_New(1, sizeof(int), NULL);
+	ASSERT_EQ(dataBlock->blockCount, 1);
+	ASSERT_EQ(dataBlock->itemCap, DATABLOCK_MIN_BLOCK_CAP);
+
+	// blocks double in size up to DATABLOCK_BLOCK_CAP
+	uint itemCount = DATABLOCK_BLOCK_CAP + DATABLOCK_MIN_BLOCK_CAP;
+	for(uint i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+	ASSERT_EQ(dataBlock->blockCount, DATABLOCK_SMALL_BLOCK_COUNT + 1);
+	ASSERT_EQ(dataBlock->itemCap, 2 * DATABLOCK_BLOCK_CAP);
+	ASSERT_EQ(dataBlock->blocks[1]->capacity, DATABLOCK_MIN_BLOCK_CAP);
+	ASSERT_EQ(dataBlock->blocks[2]->capacity, 2 * DATABLOCK_MIN_BLOCK_CAP);
+
+	// items are located across block boundaries
+	for(uint i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_GetItem(dataBlock, i);
+		ASSERT_EQ(*item, i);
+	}
+
+	// and scanned in order
+	uint64_t id;
+	uint i = 0;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	for(int *item; (item = (int *)DataBlockIterator_Next(it, &id)); i++) {
+		ASSERT_EQ(*item, i);
+		ASSERT_EQ(id, i);
+	}
+	ASSERT_EQ(i, itemCount);
+
+	// advancing crosses blocks of different sizes
+	DataBlockIterator_Reset(it);
+	ASSERT_EQ(DataBlockIterator_Advance(it, 1000), 1000);
+	int *item = (int *)DataBlockIterator_Next(it, &id);
+	ASSERT_EQ(*item, 1000);
+
+	DataBlockIterator_Free(it);
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, PeekItem) {
+	DataBlock *dataBlock = DataBlock_New(16, sizeof(int), NULL);
+	for(int i = 0; i < 4; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+	DataBlock_DeleteItem(dataBlock, 1);
+
+	ASSERT_EQ(*(int *)DataBlock_PeekItem(dataBlock, 2), 2);
+
+	// deleted and out of bounds items aren't accessible
+	ASSERT_TRUE(DataBlock_PeekItem(dataBlock, 1) == NULL);
+	ASSERT_TRUE(DataBlock_PeekItem(dataBlock, 4) == NULL);
+	ASSERT_TRUE(DataBlock_PeekItem(dataBlock, 1000) == NULL);
+
+	DataBlock_Free(dataBlock);
+}
+
+TEST_F(DataBlockTest, DeletionBitmap) {
+	DataBlock *dataBlock = DataBlock_New(DATABLOCK_BLOCK_CAP, sizeof(int), NULL);
+	uint itemCount = DATABLOCK_BLOCK_CAP * 2;
+	for(uint i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// keep every 1000th item, deleting entire words in between
+	for(uint i = 0; i < itemCount; i++) {
+		if(i % 1000 != 0) DataBlock_DeleteItem(dataBlock, i);
+	}
+
+	// the last block keeps items 17000 to 32000
+	Block *last = dataBlock->blocks[dataBlock->blockCount - 1];
+	ASSERT_EQ(last->deleted_count, DATABLOCK_BLOCK_CAP - 16);
+
+	uint64_t id;
+	uint count = 0;
+	DataBlockIterator *it = DataBlock_Scan(dataBlock);
+	for(int *item; (item = (int *)DataBlockIterator_Next(it, &id)); count++) {
+		ASSERT_EQ(id, count * 1000);
+		ASSERT_EQ(*item, count * 1000);
+	}
+	ASSERT_EQ(count, 33);
+
+	// reused items are cleared from the bitmap
+	DataBlock_AllocateItem(dataBlock, &id);
+	ASSERT_EQ(id, itemCount - 1);
+	ASSERT_EQ(last->deleted_count, DATABLOCK_BLOCK_CAP - 17);
+
+	// entirely deleted blocks are skipped
+	DataBlock_DeleteItem(dataBlock, itemCount - 1);
+	for(uint i = 17000; i < itemCount; i += 1000) DataBlock_DeleteItem(dataBlock, i);
+	ASSERT_EQ(last->deleted_count, DATABLOCK_BLOCK_CAP);
+
+	count = 0;
+	DataBlockIterator_Reset(it);
+	while(DataBlockIterator_Next(it, &id)) count++;
+	ASSERT_EQ(count, 17);
+	ASSERT_EQ(id, 16000);
+	DataBlockIterator_Free(it);
+
+	// trimming stops past the last item in use
+	ASSERT_EQ(DataBlock_Trim(dataBlock), 1);
+	ASSERT_EQ(DataBlock_ItemCount(dataBlock), 17);
+	ASSERT_EQ(DataBlock_DeletedItemsCount(dataBlock), 16001 - 17);
+
+	DataBlock_Free(dataBlock);
+}
@@ -53,11 +53,12 @@ class ExecutionPlanCloneTest: public ::testing::Test {
 		gc->g = Graph_New(16, 16);
 		gc->index_count = 0;
 		gc->graph_name = strdup("G");
-		gc->attributes = raxNew();
-		pthread_rwlock_init(&gc->_attribute_rwlock, NULL);
-		gc->string_mapping = (char **)array_new(char *, 64);
+		gc->attributes = NameTable_New();
+		pthread_mutex_init(&gc->_names_lock, NULL);
 		gc->node_schemas = (Schema **)array_new(Schema *, GRAPH_DEFAULT_LABEL_CAP);
 		gc->relation_schemas = (Schema **)array_new(Schema *, GRAPH_DEFAULT_RELATION_TYPE_CAP);
+		gc->_label_ids = NameTable_New();
+		gc->_reltype_ids = NameTable_New();
 		QueryCtx_SetGraphCtx(gc);
 	}
 
@@ -44,8 +44,10 @@ class FilterTreeTest: public ::testing::Test {
 		 * accessible via thread local storage, as such we're creating a
 		 * fake graph context and placing it within thread local storage. */
 		GraphContext *gc = (GraphContext *)calloc(1, sizeof(GraphContext));
-		gc->attributes = raxNew();
-		pthread_rwlock_init(&gc->_attribute_rwlock, NULL);
+		gc->attributes = NameTable_New();
+		pthread_mutex_init(&gc->_names_lock, NULL);
+		gc->_label_ids = NameTable_New();
+		gc->_reltype_ids = NameTable_New();
 
 		// No indicies.
 		gc->index_count = 0;
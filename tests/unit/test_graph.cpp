@@ -343,6 +343,44 @@ TEST_F(GraphTest, GraphConstruction) {
 	Graph_Free(g);
 }
 
+// Matrix dimensions grow geometrically as nodes are introduced.
+TEST_F(GraphTest, MatrixDimGrowth) {
+	Node n;
+	GrB_Index nrows;
+	Graph *g = Graph_New(GRAPH_DEFAULT_NODE_CAP, GRAPH_DEFAULT_EDGE_CAP);
+	Graph_AcquireWriteLock(g);
+
+	// dimension is a power of two at least as large as the node capacity
+	size_t dim = Graph_RequiredMatrixDim(g);
+	ASSERT_GE(dim, g->nodes->itemCap);
+	ASSERT_EQ(dim & (dim - 1), 0);
+
+	// fill the first dimension, no resize is required
+	for(size_t i = 0; i < dim; i++) Graph_CreateNode(g, &n, NULL, 0);
+	ASSERT_EQ(Graph_RequiredMatrixDim(g), dim);
+
+	// an additional node doubles the dimension
+	Graph_CreateNode(g, &n, NULL, 0);
+	ASSERT_EQ(Graph_RequiredMatrixDim(g), dim * 2);
+
+	// once blocks reach their full size the node capacity grows linearly
+	// a capacity increase may then fit within the current dimension
+	while(g->nodes->itemCap <= 2 * DATABLOCK_BLOCK_CAP) {
+		Graph_CreateNode(g, &n, NULL, 0);
+	}
+	dim = Graph_RequiredMatrixDim(g);
+	size_t cap = g->nodes->itemCap;
+	while(g->nodes->itemCap == cap) Graph_CreateNode(g, &n, NULL, 0);
+	ASSERT_EQ(Graph_RequiredMatrixDim(g), dim);
+
+	RG_Matrix adj = Graph_GetAdjacencyMatrix(g, false);
+	ASSERT_EQ(RG_Matrix_nrows(&nrows, adj), GrB_SUCCESS);
+	ASSERT_EQ(nrows, dim);
+
+	Graph_ReleaseLock(g);
+	Graph_Free(g);
+}
+
 TEST_F(GraphTest, RemoveNodes) {
 	// Construct graph.
 	RG_Matrix M;
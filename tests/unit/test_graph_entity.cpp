@@ -0,0 +1,141 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/graph/entities/graph_entity.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class GraphEntityTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() {
+		// Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(GraphEntityTest, AddGetProperties) {
+	Entity en = {0};
+	GraphEntity ge = {.entity = &en, .id = 0};
+
+	for(Attribute_ID i = 0; i < 10; i++) {
+		ASSERT_TRUE(GraphEntity_AddProperty(&ge, i * 2, SI_LongVal(i)));
+	}
+	ASSERT_TRUE(GraphEntity_AddProperty(&ge, 100, SI_ConstStringVal((char *)"str")));
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 11);
+
+	// IDs and values are kept in insertion order
+	const Attribute_ID *ids = ENTITY_PROP_IDS(&ge);
+	for(Attribute_ID i = 0; i < 10; i++) {
+		ASSERT_EQ(ids[i], i * 2);
+		SIValue *v = GraphEntity_GetProperty(&ge, i * 2);
+		ASSERT_EQ(v, ENTITY_PROP_VALUES(&ge) + i);
+		ASSERT_EQ(v->longval, i);
+	}
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 100)->stringval, "str");
+
+	// missing attributes
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 1), PROPERTY_NOTFOUND);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, ATTRIBUTE_NOTFOUND), PROPERTY_NOTFOUND);
+
+	FreeEntity(&en);
+	ASSERT_EQ(Entity_PropCount(&en), 0);
+	ASSERT_TRUE(en.properties == NULL);
+}
+
+TEST_F(GraphEntityTest, UpdateRemoveProperties) {
+	Entity en = {0};
+	GraphEntity ge = {.entity = &en, .id = 0};
+
+	for(Attribute_ID i = 0; i < 5; i++) {
+		GraphEntity_AddProperty(&ge, i, SI_LongVal(i));
+	}
+
+	// update existing attribute
+	ASSERT_TRUE(GraphEntity_SetProperty(&ge, 3, SI_DoubleVal(3.5)));
+	ASSERT_FALSE(GraphEntity_SetProperty(&ge, 3, SI_DoubleVal(3.5)));
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 3)->doubleval, 3.5);
+
+	// setting NULL removes the attribute
+	ASSERT_TRUE(GraphEntity_SetProperty(&ge, 1, SI_NullVal()));
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 4);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 1), PROPERTY_NOTFOUND);
+
+	// remaining attributes are intact
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 0)->longval, 0);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 2)->longval, 2);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 3)->doubleval, 3.5);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 4)->longval, 4);
+
+	// add after removal
+	GraphEntity_AddProperty(&ge, 7, SI_LongVal(7));
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 7)->longval, 7);
+
+	// remove all
+	ASSERT_EQ(GraphEntity_ClearProperties(&ge), 5);
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 0);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 0), PROPERTY_NOTFOUND);
+}
+
+TEST_F(GraphEntityTest, AddMultipleProperties) {
+	Entity en = {0};
+	GraphEntity ge = {.entity = &en, .id = 0};
+
+	ASSERT_TRUE(GraphEntity_AddProperty(&ge, 7, SI_LongVal(7)));
+
+	// invalid property values are skipped
+	Attribute_ID ids[4] = {1, 2, 3, 4};
+	SIValue values[4] = {SI_LongVal(1), SI_NullVal(),
+		SI_ConstStringVal((char *)"three"), SI_DoubleVal(4.5)};
+	ASSERT_EQ(GraphEntity_AddProperties(&ge, ids, values, 4), 3);
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 4);
+
+	// existing attributes precede the added ones
+	const Attribute_ID *prop_ids = ENTITY_PROP_IDS(&ge);
+	Attribute_ID expected[4] = {7, 1, 3, 4};
+	for(int i = 0; i < 4; i++) ASSERT_EQ(prop_ids[i], expected[i]);
+
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 7)->longval, 7);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 1)->longval, 1);
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 2), PROPERTY_NOTFOUND);
+	ASSERT_STREQ(GraphEntity_GetProperty(&ge, 3)->stringval, "three");
+	ASSERT_EQ(GraphEntity_GetProperty(&ge, 4)->doubleval, 4.5);
+
+	// adding no valid values leaves entity untouched
+	SIValue nulls[1] = {SI_NullVal()};
+	ASSERT_EQ(GraphEntity_AddProperties(&ge, ids, nulls, 1), 0);
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 4);
+
+	FreeEntity(&en);
+}
+
+TEST_F(GraphEntityTest, PropertylessEntity) {
+	// entities without properties hold no allocation
+	ASSERT_EQ(sizeof(Entity), sizeof(void *));
+
+	Entity en = {0};
+	GraphEntity ge = {.entity = &en, .id = 0};
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 0);
+
+	ASSERT_TRUE(GraphEntity_AddProperty(&ge, 0, SI_LongVal(1)));
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 1);
+
+	// removing the last property releases the properties block
+	ASSERT_TRUE(GraphEntity_SetProperty(&ge, 0, SI_NullVal()));
+	ASSERT_EQ(ENTITY_PROP_COUNT(&ge), 0);
+	ASSERT_TRUE(en.properties == NULL);
+
+	FreeEntity(&en);
+}
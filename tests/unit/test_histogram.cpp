@@ -0,0 +1,71 @@
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/histogram.h"
+#ifdef __cplusplus
+}
+#endif
+
+class HistogramTest:
+	public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(HistogramTest, Empty) {
+	Histogram h;
+	Histogram_Reset(&h);
+
+	ASSERT_EQ(Histogram_Count(&h), 0);
+	ASSERT_EQ(Histogram_Sum(&h), 0);
+	ASSERT_EQ(Histogram_Max(&h), 0);
+	ASSERT_EQ(Histogram_Percentile(&h, 50), 0);
+	ASSERT_EQ(Histogram_Percentile(&h, 100), 0);
+}
+
+TEST_F(HistogramTest, SmallValues) {
+	Histogram h;
+	Histogram_Reset(&h);
+
+	// small values are recorded exactly
+	for(uint64_t i = 0; i < 10; i++) Histogram_Record(&h, i);
+
+	ASSERT_EQ(Histogram_Count(&h), 10);
+	ASSERT_EQ(Histogram_Sum(&h), 45);
+	ASSERT_EQ(Histogram_Max(&h), 9);
+	ASSERT_EQ(Histogram_Percentile(&h, 0), 0);
+	ASSERT_EQ(Histogram_Percentile(&h, 50), 4);
+	ASSERT_EQ(Histogram_Percentile(&h, 100), 9);
+}
+
+TEST_F(HistogramTest, Precision) {
+	Histogram h;
+	Histogram_Reset(&h);
+
+	for(uint64_t i = 1; i <= 1000; i++) Histogram_Record(&h, i * 1000);
+
+	// reported values are within 1/HISTOGRAM_SUB_BUCKETS of actual values
+	double p50 = Histogram_Percentile(&h, 50);
+	double p95 = Histogram_Percentile(&h, 95);
+	ASSERT_NEAR(p50, 500000, 500000.0 / HISTOGRAM_SUB_BUCKETS);
+	ASSERT_NEAR(p95, 950000, 950000.0 / HISTOGRAM_SUB_BUCKETS);
+	ASSERT_EQ(Histogram_Percentile(&h, 100), 1000000);
+	ASSERT_EQ(Histogram_Max(&h), 1000000);
+}
+
+TEST_F(HistogramTest, Clamp) {
+	Histogram h;
+	Histogram_Reset(&h);
+
+	// values beyond the histogram range fall into its last bucket
+	Histogram_Record(&h, UINT64_MAX);
+	ASSERT_EQ(Histogram_Count(&h), 1);
+	ASSERT_EQ(Histogram_Max(&h), UINT64_MAX);
+	ASSERT_GT(Histogram_Percentile(&h, 100),
+			(uint64_t)1 << HISTOGRAM_MAX_EXPONENT);
+}
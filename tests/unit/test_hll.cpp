@@ -0,0 +1,72 @@
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/hll.h"
+#ifdef __cplusplus
+}
+#endif
+
+#include <cmath>
+
+class HLLTest:
+	public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+// spread consecutive integers over the hash space
+static uint64_t _hash(uint64_t x) {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+// estimate is within 5% of 'expected'
+static void _assertClose(uint64_t estimate, uint64_t expected) {
+	ASSERT_LE(std::fabs((double)estimate - expected), expected * 0.05);
+}
+
+TEST_F(HLLTest, Empty) {
+	HLL hll;
+	HLL_Reset(&hll);
+	ASSERT_EQ(HLL_Count(&hll), 0);
+}
+
+TEST_F(HLLTest, Duplicates) {
+	HLL hll;
+	HLL_Reset(&hll);
+
+	// small cardinalities are counted exactly
+	for(int i = 0; i < 1000; i++) HLL_Add(&hll, _hash(i % 10));
+	ASSERT_EQ(HLL_Count(&hll), 10);
+}
+
+TEST_F(HLLTest, LargeCardinality) {
+	HLL hll;
+	HLL_Reset(&hll);
+
+	for(uint64_t i = 0; i < 1000000; i++) HLL_Add(&hll, _hash(i));
+	_assertClose(HLL_Count(&hll), 1000000);
+}
+
+TEST_F(HLLTest, Merge) {
+	HLL a;
+	HLL b;
+	HLL_Reset(&a);
+	HLL_Reset(&b);
+
+	// overlapping ranges [0, 60000) and [40000, 100000)
+	for(uint64_t i = 0; i < 60000; i++) HLL_Add(&a, _hash(i));
+	for(uint64_t i = 40000; i < 100000; i++) HLL_Add(&b, _hash(i));
+
+	HLL_Merge(&a, &b);
+	_assertClose(HLL_Count(&a), 100000);
+}
@@ -0,0 +1,63 @@
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/mmap_store.h"
+#ifdef __cplusplus
+}
+#endif
+
+class MmapStoreTest:
+	public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(MmapStoreTest, AppendString) {
+	MmapStore *store = MmapStore_New();
+	ASSERT_EQ(MmapStore_Size(store), 0);
+
+	const char *a = MmapStore_AppendString(store, "description", 11);
+	const char *b = MmapStore_AppendString(store, "{\"k\": 1}", 8);
+	ASSERT_TRUE(a != NULL);
+	ASSERT_TRUE(b != NULL);
+
+	ASSERT_STREQ(a, "description");
+	ASSERT_STREQ(b, "{\"k\": 1}");
+	ASSERT_EQ(MmapStore_Size(store), 21);
+
+	MmapStore_Free(store);
+}
+
+TEST_F(MmapStoreTest, AppendAcrossSegments) {
+	MmapStore *store = MmapStore_New();
+
+	// strings which do not fit the current segment start a new one
+	size_t len = MMAP_STORE_SEGMENT_SIZE / 2;
+	char *s = (char *)malloc(len + 1);
+	memset(s, 'x', len);
+	s[len] = '\0';
+
+	const char *stored[3];
+	for(int i = 0; i < 3; i++) {
+		s[0] = 'a' + i;
+		stored[i] = MmapStore_AppendString(store, s, len);
+		ASSERT_TRUE(stored[i] != NULL);
+	}
+
+	// previously stored strings remain in place
+	for(int i = 0; i < 3; i++) {
+		ASSERT_EQ(stored[i][0], 'a' + i);
+		ASSERT_EQ(strlen(stored[i]), len);
+	}
+
+	// strings larger than a segment can not be stored
+	ASSERT_TRUE(MmapStore_AppendString(store, s, MMAP_STORE_SEGMENT_SIZE) == NULL);
+
+	free(s);
+	MmapStore_Free(store);
+}
@@ -0,0 +1,157 @@
+/*
+* Copyright 2018-2022 Redis Labs Ltd. and Contributors
+*
+* This file is available under the Redis Labs Source Available License Agreement
+*/
+
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../src/value.h"
+#include "../../src/util/msgpack.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/datatypes/map.h"
+#include "../../src/datatypes/array.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+class MsgPackTest: public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(MsgPackTest, scalars) {
+	const unsigned char buf[] = {
+		0x07,                                            // 7
+		0xff,                                            // -1
+		0xd1, 0xfe, 0x0c,                                // int16 -500
+		0xce, 0x00, 0x01, 0x00, 0x00,                    // uint32 65536
+		0xcb, 0x40, 0x09, 0x21, 0xfb, 0x54, 0x44, 0x2d, 0x18,  // 3.141592653589793
+		0xc3,                                            // true
+		0xc0,                                            // nil
+		0xa3, 'a', 'b', 'c'                              // "abc"
+	};
+
+	SIValue v;
+	MsgPackReader reader = MsgPack_Reader((const char *)buf, sizeof(buf));
+
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.longval, 7);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.longval, -1);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.longval, -500);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.longval, 65536);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.type, T_DOUBLE);
+	ASSERT_EQ(v.doubleval, 3.141592653589793);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.type, T_BOOL);
+	ASSERT_TRUE(v.longval);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.type, T_NULL);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_EQ(v.type, T_STRING);
+	ASSERT_STREQ(v.stringval, "abc");
+	SIValue_Free(v);
+
+	ASSERT_TRUE(MsgPack_Done(&reader));
+	ASSERT_FALSE(MsgPack_ReadValue(&reader, &v));
+}
+
+TEST_F(MsgPackTest, nested) {
+	// {"a": [1, "x"], "b": {"c": false}}
+	const unsigned char buf[] = {
+		0x82,
+		0xa1, 'a', 0x92, 0x01, 0xa1, 'x',
+		0xa1, 'b', 0x81, 0xa1, 'c', 0xc2
+	};
+
+	SIValue v;
+	SIValue elem;
+	MsgPackReader reader = MsgPack_Reader((const char *)buf, sizeof(buf));
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_TRUE(MsgPack_Done(&reader));
+	ASSERT_EQ(v.type, T_MAP);
+	ASSERT_EQ(Map_KeyCount(v), 2);
+
+	ASSERT_TRUE(MAP_GET(v, "a", elem));
+	ASSERT_EQ(SIArray_Length(elem), 2);
+	ASSERT_EQ(SIArray_Get(elem, 0).longval, 1);
+	ASSERT_STREQ(SIArray_Get(elem, 1).stringval, "x");
+
+	ASSERT_TRUE(MAP_GET(v, "b", elem));
+	SIValue c;
+	ASSERT_TRUE(MAP_GET(elem, "c", c));
+	ASSERT_EQ(c.type, T_BOOL);
+	ASSERT_FALSE(c.longval);
+
+	SIValue_Free(v);
+}
+
+TEST_F(MsgPackTest, map_header) {
+	// {"name": "Ann"}
+	const unsigned char buf[] = {
+		0x81, 0xa4, 'n', 'a', 'm', 'e', 0xa3, 'A', 'n', 'n'
+	};
+
+	uint32_t n;
+	uint32_t len;
+	const char *s;
+	SIValue v;
+	MsgPackReader reader = MsgPack_Reader((const char *)buf, sizeof(buf));
+
+	ASSERT_TRUE(MsgPack_ReadMapHeader(&reader, &n));
+	ASSERT_EQ(n, 1);
+	ASSERT_TRUE(MsgPack_ReadString(&reader, &s, &len));
+	ASSERT_EQ(len, 4);
+	ASSERT_EQ(strncmp(s, "name", len), 0);
+	ASSERT_TRUE(MsgPack_ReadValue(&reader, &v));
+	ASSERT_STREQ(v.stringval, "Ann");
+	ASSERT_TRUE(MsgPack_Done(&reader));
+	SIValue_Free(v);
+
+	// not a map
+	reader = MsgPack_Reader((const char *)buf + 1, sizeof(buf) - 1);
+	ASSERT_FALSE(MsgPack_ReadMapHeader(&reader, &n));
+}
+
+TEST_F(MsgPackTest, malformed) {
+	SIValue v;
+	MsgPackReader reader;
+
+	// truncated string
+	const unsigned char str[] = {0xa5, 'a', 'b'};
+	reader = MsgPack_Reader((const char *)str, sizeof(str));
+	ASSERT_FALSE(MsgPack_ReadValue(&reader, &v));
+
+	// array claiming more elements than available
+	const unsigned char arr[] = {0xdd, 0xff, 0xff, 0xff, 0xff, 0x01};
+	reader = MsgPack_Reader((const char *)arr, sizeof(arr));
+	ASSERT_FALSE(MsgPack_ReadValue(&reader, &v));
+
+	// uint64 exceeding the int64 range
+	const unsigned char big[] = {0xcf, 0xff, 0, 0, 0, 0, 0, 0, 0};
+	reader = MsgPack_Reader((const char *)big, sizeof(big));
+	ASSERT_FALSE(MsgPack_ReadValue(&reader, &v));
+
+	// binary type
+	const unsigned char bin[] = {0xc4, 0x01, 0x00};
+	reader = MsgPack_Reader((const char *)bin, sizeof(bin));
+	ASSERT_FALSE(MsgPack_ReadValue(&reader, &v));
+
+	// nesting too deep
+	unsigned char deep[MSGPACK_MAX_DEPTH + 2];
+	memset(deep, 0x91, sizeof(deep) - 1);
+	deep[sizeof(deep) - 1] = 0x01;
+	reader = MsgPack_Reader((const char *)deep, sizeof(deep));
+	ASSERT_FALSE(MsgPack_ReadValue(&reader, &v));
+}
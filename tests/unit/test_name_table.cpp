@@ -0,0 +1,62 @@
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/name_table.h"
+#include <stdio.h>
+#ifdef __cplusplus
+}
+#endif
+
+class NameTableTest:
+	public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(NameTableTest, AddFind) {
+	NameTable *t = NameTable_New();
+
+	ASSERT_EQ(NameTable_Count(t), 0);
+	ASSERT_EQ(NameTable_Find(t, "name"), NAME_TABLE_NOTFOUND);
+
+	// names are assigned consecutive IDs
+	ASSERT_EQ(NameTable_Add(t, "name"), 0);
+	ASSERT_EQ(NameTable_Add(t, "age"), 1);
+	ASSERT_EQ(NameTable_Count(t), 2);
+
+	ASSERT_EQ(NameTable_Find(t, "name"), 0);
+	ASSERT_EQ(NameTable_Find(t, "age"), 1);
+	ASSERT_EQ(NameTable_Find(t, "Age"), NAME_TABLE_NOTFOUND);
+
+	ASSERT_STREQ(NameTable_Name(t, 0), "name");
+	ASSERT_STREQ(NameTable_Name(t, 1), "age");
+
+	NameTable_Free(t);
+}
+
+TEST_F(NameTableTest, Grow) {
+	NameTable *t = NameTable_New();
+
+	// grow well past the table's initial capacity
+	char name[32];
+	uint n = 1000;
+	for(uint i = 0; i < n; i++) {
+		sprintf(name, "attr_%u", i);
+		ASSERT_EQ(NameTable_Add(t, name), i);
+	}
+	ASSERT_EQ(NameTable_Count(t), n);
+
+	// names added before the table grew remain reachable in both directions
+	for(uint i = 0; i < n; i++) {
+		sprintf(name, "attr_%u", i);
+		ASSERT_EQ(NameTable_Find(t, name), i);
+		ASSERT_STREQ(NameTable_Name(t, i), name);
+	}
+
+	NameTable_Free(t);
+}
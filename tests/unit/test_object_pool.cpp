@@ -119,3 +119,32 @@ TEST_F(ObjectPoolTest, RemoveItem) {
 	ObjectPool_Free(object_pool);
 }
 
+
+TEST_F(ObjectPoolTest, ReuseBlocks) {
+	// Discard blocks released by previous tests.
+	ObjectPool_FreeThreadCache();
+
+	ObjectPool *object_pool = ObjectPool_New(256, sizeof(uint), NULL);
+	Block *block = object_pool->blocks[0];
+
+	uint *item = (uint *)ObjectPool_NewItem(object_pool);
+	*item = 7;
+	ObjectPool_Free(object_pool);
+
+	// A pool of the same item size reuses the freed block.
+	object_pool = ObjectPool_New(256, sizeof(uint), NULL);
+	ASSERT_EQ(object_pool->blocks[0], block);
+	ASSERT_TRUE(block->next == NULL);
+
+	// Verify that the reused block is zeroed.
+	item = (uint *)ObjectPool_NewItem(object_pool);
+	ASSERT_EQ(*item, 0);
+	ObjectPool_Free(object_pool);
+
+	// A pool of a different item size doesn't.
+	object_pool = ObjectPool_New(256, sizeof(uint64_t), NULL);
+	ASSERT_NE(object_pool->blocks[0], block);
+	ObjectPool_Free(object_pool);
+
+	ObjectPool_FreeThreadCache();
+}
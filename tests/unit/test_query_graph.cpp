@@ -349,6 +349,26 @@ TEST_F(QueryGraphTest, QueryGraphConnectedComponents) {
 	array_free(connected_components);
 }
 
+TEST_F(QueryGraphTest, QueryGraphContainsCycle) {
+	QueryGraph *g;
+
+	g = SingleNodeGraph();
+	ASSERT_FALSE(QueryGraph_ContainsCycle(g));
+	QueryGraph_Free(g);
+
+	g = TriangleGraph();
+	ASSERT_TRUE(QueryGraph_ContainsCycle(g));
+	QueryGraph_Free(g);
+
+	g = DisjointGraph();
+	ASSERT_FALSE(QueryGraph_ContainsCycle(g));
+	QueryGraph_Free(g);
+
+	g = SingleNodeCycleGraph();
+	ASSERT_TRUE(QueryGraph_ContainsCycle(g));
+	QueryGraph_Free(g);
+}
+
 TEST_F(QueryGraphTest, QueryGraphExtractSubGraph) {
 	//--------------------------------------------------------------------------
 	// Construct graph
@@ -59,3 +59,11 @@ TEST_F(RecordTest, RecordToString) {
 	Record_Free(r);
 }
 
+
+TEST_F(RecordTest, EntryLayout) {
+	// scalars are a 16 byte union, type and allocation packed in one word
+	ASSERT_EQ(sizeof(SIValue), 16);
+	// edges are the largest entry and carry no padding between members
+	ASSERT_EQ(sizeof(Edge), 64);
+	ASSERT_EQ(sizeof(Entry), 72);
+}
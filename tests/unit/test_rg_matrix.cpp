@@ -10,9 +10,12 @@
 extern "C" {
 #endif
 
+#include "../../src/util/arr.h"
 #include "../../src/util/rmalloc.h"
 #include "../../src/configuration/config.h"
 #include "../../src/graph/rg_matrix/rg_matrix.h"
+#include "../../src/graph/rg_matrix/rg_utils.h"
+#include "../../src/graph/rg_matrix/rg_matrix_iter.h"
 #include <time.h>
 
 #ifdef __cplusplus
@@ -264,6 +267,9 @@ TEST_F(RGMatrixTest, RGMatrix_simple_set) {
 	// matrix should be mark as dirty
 	ASSERT_TRUE(RG_Matrix_isDirty(A));
 
+	// build logged additions into delta-plus
+	RG_Matrix_flushDeltaLog(A);
+
 	// get internal matrices
 	M   =  RG_MATRIX_M(A);
 	DP  =  RG_MATRIX_DELTA_PLUS(A);
@@ -900,6 +906,9 @@ TEST_F(RGMatrixTest, RGMatrix_managed_transposed) {
 	// matrix should be mark as dirty
 	ASSERT_TRUE(RG_Matrix_isDirty(T));
 
+	// build logged additions into delta-plus
+	RG_Matrix_flushDeltaLog(T);
+
 	//--------------------------------------------------------------------------
 	// validations
 	//--------------------------------------------------------------------------
@@ -1539,6 +1548,320 @@ TEST_F(RGMatrixTest, RGMatrix_resize) {
 	ASSERT_EQ(T_ncols, nrows);
 }
 
+// setting entries in bulk is equivalent to setting them one by one
+TEST_F(RGMatrixTest, RGMatrix_setElements) {
+	RG_Matrix  A      =  NULL;
+	RG_Matrix  B      =  NULL;
+	GrB_Info   info   =  GrB_SUCCESS;
+	GrB_Index  nrows  =  16;
+	GrB_Index  ncols  =  16;
+
+	info = RG_Matrix_new(&A, GrB_UINT64, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	info = RG_Matrix_new(&B, GrB_UINT64, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// entry already present in M
+	info = RG_Matrix_setElement_UINT64(A, 0, 1, 2);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	info = RG_Matrix_setElement_UINT64(B, 0, 1, 2);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	RG_Matrix_wait(A, true);
+	RG_Matrix_wait(B, true);
+
+	// multiple edges connecting the same nodes
+	// both within M and within delta-plus
+	GrB_Index  I[6]  =  {1, 2, 3, 3, 1, 5};
+	GrB_Index  J[6]  =  {2, 3, 4, 4, 2, 6};
+	uint64_t   X[6]  =  {1, 2, 3, 4, 5, 6};
+
+	info = RG_Matrix_setElements_UINT64(A, X, I, J, 6);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	for(int k = 0; k < 6; k++) {
+		info = RG_Matrix_setElement_UINT64(B, X[k], I[k], J[k]);
+		ASSERT_EQ(info, GrB_SUCCESS);
+	}
+
+	// B's additions were logged
+	RG_Matrix_flushDeltaLog(B);
+	RG_Matrix_flushDeltaLog(RG_Matrix_getTranspose(B));
+
+	GrB_Index A_nvals;
+	GrB_Index B_nvals;
+	GrB_Matrix_nvals(&A_nvals, RG_MATRIX_DELTA_PLUS(A));
+	GrB_Matrix_nvals(&B_nvals, RG_MATRIX_DELTA_PLUS(B));
+	ASSERT_EQ(A_nvals, 3);
+	ASSERT_EQ(A_nvals, B_nvals);
+
+	GrB_Matrix_nvals(&A_nvals, RG_MATRIX_DELTA_PLUS(RG_Matrix_getTranspose(A)));
+	GrB_Matrix_nvals(&B_nvals, RG_MATRIX_DELTA_PLUS(RG_Matrix_getTranspose(B)));
+	ASSERT_EQ(A_nvals, 3);
+	ASSERT_EQ(A_nvals, B_nvals);
+
+	// compare entries
+	uint64_t  a;
+	uint64_t  b;
+	GrB_Index rows[4] = {1, 2, 3, 5};
+	GrB_Index cols[4] = {2, 3, 4, 6};
+	uint      edges[4] = {3, 1, 2, 1};
+	for(int k = 0; k < 4; k++) {
+		info = RG_Matrix_extractElement_UINT64(&a, A, rows[k], cols[k]);
+		ASSERT_EQ(info, GrB_SUCCESS);
+		info = RG_Matrix_extractElement_UINT64(&b, B, rows[k], cols[k]);
+		ASSERT_EQ(info, GrB_SUCCESS);
+
+		ASSERT_EQ(SINGLE_EDGE(a), SINGLE_EDGE(b));
+		if(SINGLE_EDGE(a)) {
+			ASSERT_EQ(edges[k], 1);
+			ASSERT_EQ(a, b);
+		} else {
+			uint64_t a_n;
+			uint64_t b_n;
+			RG_Matrix_multiEdgeIDs(A, a, &a_n);
+			RG_Matrix_multiEdgeIDs(B, b, &b_n);
+			ASSERT_EQ(a_n, edges[k]);
+			ASSERT_EQ(a_n, b_n);
+		}
+	}
+
+	RG_Matrix_free(&A);
+	RG_Matrix_free(&B);
+}
+
+// additions missing from the matrix are logged
+// and built into delta-plus once delta-plus is read
+TEST_F(RGMatrixTest, RGMatrix_deltaLog) {
+	RG_Matrix  A      =  NULL;
+	GrB_Info   info   =  GrB_SUCCESS;
+	GrB_Index  nrows  =  1024;
+	GrB_Index  ncols  =  1024;
+	GrB_Index  n      =  500;
+	GrB_Index  nvals  =  0;
+	uint64_t   x      =  0;
+
+	info = RG_Matrix_new(&A, GrB_UINT64, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// enough entries for the log to grow, the last connects (0,1) again
+	for(GrB_Index k = 0; k < n; k++) {
+		info = RG_Matrix_setElement_UINT64(A, k, k, k + 1);
+		ASSERT_EQ(info, GrB_SUCCESS);
+	}
+	info = RG_Matrix_setElement_UINT64(A, n, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// additions are yet to reach delta-plus
+	GrB_Matrix_nvals(&nvals, RG_MATRIX_DELTA_PLUS(A));
+	ASSERT_EQ(nvals, 0);
+	ASSERT_EQ(RG_Matrix_deltaLogLen(A), n);
+
+	// yet are visible through the matrix
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, n);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 7, 8);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(x, 7);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 0, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_FALSE(SINGLE_EDGE(x));
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 8, 7);
+	ASSERT_EQ(info, GrB_NO_VALUE);
+
+	// the transpose logs its own additions
+	bool b;
+	info = RG_Matrix_extractElement_BOOL(&b, RG_Matrix_getTranspose(A), 8, 7);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// iterating builds the log into delta-plus
+	RG_MatrixTupleIter it;
+	info = RG_MatrixTupleIter_reuse(&it, A);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_deltaLogLen(A), 0);
+
+	GrB_Matrix_nvals(&nvals, RG_MATRIX_DELTA_PLUS(A));
+	ASSERT_EQ(nvals, n);
+
+	// entries already within delta-plus are updated in place
+	info = RG_Matrix_setElement_UINT64(A, n + 1, 7, 8);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_deltaLogLen(A), 0);
+
+	uint64_t edge_count;
+	info = RG_Matrix_extractElement_UINT64(&x, A, 7, 8);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	RG_Matrix_multiEdgeIDs(A, x, &edge_count);
+	ASSERT_EQ(edge_count, 2);
+
+	// flush
+	info = RG_Matrix_wait(A, true);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(RG_Matrix_deltaLogLen(RG_Matrix_getTranspose(A)), 0);
+
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, n);
+
+	RG_Matrix_free(&A);
+}
+
+// multi-edge entries are kept in the matrix's multi-edge table
+// which is compacted once the matrix is flushed
+TEST_F(RGMatrixTest, RGMatrix_multiEdgeTable) {
+	RG_Matrix  A      =  NULL;
+	GrB_Info   info   =  GrB_SUCCESS;
+	GrB_Index  nrows  =  16;
+	GrB_Index  ncols  =  16;
+	uint64_t   x;
+	uint64_t   n;
+
+	info = RG_Matrix_new(&A, GrB_UINT64, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// connect (1, 2) and (3, 4) by interleaved edges
+	// forcing the slot of (1, 2) to relocate as it grows
+	for(uint64_t id = 0; id < 8; id++) {
+		info = RG_Matrix_setElement_UINT64(A, id, 1, 2);
+		ASSERT_EQ(info, GrB_SUCCESS);
+		info = RG_Matrix_setElement_UINT64(A, 100 + id, 3, 4);
+		ASSERT_EQ(info, GrB_SUCCESS);
+	}
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 1, 2);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_FALSE(SINGLE_EDGE(x));
+
+	const uint64_t *ids = RG_Matrix_multiEdgeIDs(A, x, &n);
+	ASSERT_EQ(n, 8);
+	for(uint64_t i = 0; i < n; i++) ASSERT_EQ(ids[i], i);
+
+	// remove all but a single edge, reverting the entry to a scalar
+	for(uint64_t id = 1; id < 8; id++) {
+		info = RG_Matrix_removeEntry(A, 1, 2, id);
+		ASSERT_EQ(info, GrB_SUCCESS);
+	}
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 1, 2);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_TRUE(SINGLE_EDGE(x));
+	ASSERT_EQ(x, 0);
+
+	// flushing reclaims the released space
+	size_t before = RG_Matrix_multiEdgesMemoryUsage(A);
+	info = RG_Matrix_wait(A, true);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_LT(RG_Matrix_multiEdgesMemoryUsage(A), before);
+
+	// remaining multi-edge entry is intact
+	info = RG_Matrix_extractElement_UINT64(&x, A, 3, 4);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ids = RG_Matrix_multiEdgeIDs(A, x, &n);
+	ASSERT_EQ(n, 8);
+	for(uint64_t i = 0; i < n; i++) ASSERT_EQ(ids[i], 100 + i);
+
+	RG_Matrix_free(&A);
+}
+
+// a sparsely populated hypersparse matrix stores only its populated rows
+TEST_F(RGMatrixTest, RGMatrix_hypersparse) {
+	RG_Matrix   A       =  NULL;
+	RG_Matrix   B       =  NULL;
+	GrB_Matrix  M       =  NULL;
+	GrB_Matrix  AT      =  NULL;
+	GrB_Info    info    =  GrB_SUCCESS;
+	GrB_Index   nrows   =  1024;
+	GrB_Index   ncols   =  1024;
+	int         status  =  0;
+	bool        x;
+
+	info = RG_Matrix_new(&A, GrB_BOOL, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	info = RG_Matrix_new(&B, GrB_BOOL, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	info = RG_Matrix_setHypersparse(A);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	GrB_Index ids[3] = {3, 500, 1000};
+	for(int k = 0; k < 3; k++) {
+		RG_Matrix_setElement_BOOL(A, ids[k], ids[k]);
+		RG_Matrix_setElement_BOOL(B, ids[k], ids[k]);
+	}
+
+	RG_Matrix_wait(A, true);
+	RG_Matrix_wait(B, true);
+
+	GxB_Matrix_Option_get(RG_MATRIX_M(A), GxB_SPARSITY_STATUS, &status);
+	ASSERT_EQ(status, GxB_HYPERSPARSE);
+	GxB_Matrix_Option_get(RG_MATRIX_M(B), GxB_SPARSITY_STATUS, &status);
+	ASSERT_EQ(status, GxB_SPARSE);
+
+	for(int k = 0; k < 3; k++) {
+		info = RG_Matrix_extractElement_BOOL(&x, A, ids[k], ids[k]);
+		ASSERT_EQ(info, GrB_SUCCESS);
+	}
+	info = RG_Matrix_extractElement_BOOL(&x, A, 4, 4);
+	ASSERT_EQ(info, GrB_NO_VALUE);
+
+	// compaction preserves the representation
+	info = RG_Matrix_compact(&M, &AT, A);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	info = RG_Matrix_compact_apply(A, &M, &AT);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	GxB_Matrix_Option_get(RG_MATRIX_M(A), GxB_SPARSITY_STATUS, &status);
+	ASSERT_EQ(status, GxB_HYPERSPARSE);
+
+	RG_Matrix_free(&A);
+	RG_Matrix_free(&B);
+}
+
+TEST_F(RGMatrixTest, RGMatrix_scratch) {
+	RG_Matrix   A       =  NULL;
+	RG_Matrix   B       =  NULL;
+	RG_Matrix   C       =  NULL;
+	GrB_Info    info    =  GrB_SUCCESS;
+	GrB_Index   nvals   =  0;
+	GrB_Index   nrows   =  0;
+	GrB_Index   ncols   =  0;
+
+	info = RG_Matrix_newScratch(&A, GrB_BOOL, 16, 100);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	RG_Matrix_setElement_BOOL(A, 1, 1);
+	RG_Matrix_setElement_BOOL(A, 2, 3);
+
+	// a returned matrix is reused cleared
+	RG_Matrix prev = A;
+	RG_Matrix_freeScratch(&A);
+	ASSERT_TRUE(A == NULL);
+
+	info = RG_Matrix_newScratch(&A, GrB_BOOL, 16, 100);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(A, prev);
+	RG_Matrix_nvals(&nvals, A);
+	ASSERT_EQ(nvals, 0);
+
+	// same dimension class, resized to the requested dimensions
+	RG_Matrix_freeScratch(&A);
+	info = RG_Matrix_newScratch(&B, GrB_BOOL, 12, 200);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_EQ(B, prev);
+	RG_Matrix_nrows(&nrows, B);
+	RG_Matrix_ncols(&ncols, B);
+	ASSERT_EQ(nrows, 12);
+	ASSERT_EQ(ncols, 200);
+
+	// different dimension class, a new matrix
+	RG_Matrix_freeScratch(&B);
+	info = RG_Matrix_newScratch(&C, GrB_BOOL, 1024, 200);
+	ASSERT_EQ(info, GrB_SUCCESS);
+	ASSERT_NE(C, prev);
+
+	RG_Matrix_freeScratch(&C);
+	RG_Matrix_trimScratch();
+}
+
 //#ifndef RG_DEBUG
 //// test RGMatrix_pending
 //// if RG_DEBUG is defined, each call to setElement will flush all 3 matrices
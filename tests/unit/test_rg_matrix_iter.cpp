@@ -399,3 +399,81 @@ TEST_F(RGMatrixTupleIterTest, RGMatrixTupleiIter_iterate_range) {
 	RG_MatrixTupleIter_free(&iter);
 	ASSERT_TRUE(iter == NULL);
 }
+
+// test RGMatrixTupleIter merges pending changes in order
+TEST_F(RGMatrixTupleIterTest, RGMatrixTupleiIter_ordered_merge) {
+	RG_Matrix          A                   =  NULL;
+	GrB_Type           t                   =  GrB_UINT64;
+	GrB_Info           info                =  GrB_SUCCESS;
+	RG_MatrixTupleIter *iter               =  NULL;
+	GrB_Index          row                 =  0;
+	GrB_Index          col                 =  0;
+	GrB_Index          nrows               =  100;
+	GrB_Index          ncols               =  100;
+	uint64_t           val                 =  0;
+	bool               depleted            =  false;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// flushed entries at even columns of rows 1 and 3
+	for(GrB_Index j = 0; j < 10; j += 2) {
+		RG_Matrix_setElement_UINT64(A, j, 1, j);
+		RG_Matrix_setElement_UINT64(A, j, 3, j);
+	}
+	RG_Matrix_wait(A, true);
+
+	// pending additions at odd columns of rows 1 and 2
+	for(GrB_Index j = 1; j < 10; j += 2) {
+		RG_Matrix_setElement_UINT64(A, j, 1, j);
+		RG_Matrix_setElement_UINT64(A, j, 2, j);
+	}
+
+	// pending deletion of row 3 column 4
+	info = RG_Matrix_removeElement_UINT64(A, 3, 4);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	// expected entries in (row, column) order
+	GrB_Index expected[3][10] = {
+		{0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+		{1, 3, 5, 7, 9},
+		{0, 2, 6, 8}
+	};
+	GrB_Index expected_count[3] = {10, 5, 4};
+
+	info = RG_MatrixTupleIter_new(&iter, A);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	for(int r = 0; r < 3; r++) {
+		for(GrB_Index k = 0; k < expected_count[r]; k++) {
+			info = RG_MatrixTupleIter_next(iter, &row, &col, &val, &depleted);
+			ASSERT_EQ(info, GrB_SUCCESS);
+			ASSERT_FALSE(depleted);
+			ASSERT_EQ(row, (GrB_Index)(r + 1));
+			ASSERT_EQ(col, expected[r][k]);
+			ASSERT_EQ(val, expected[r][k]);
+		}
+	}
+
+	info = RG_MatrixTupleIter_next(iter, &row, &col, &val, &depleted);
+	ASSERT_TRUE(depleted);
+
+	// scanning a single row restarts the merge
+	info = RG_MatrixTupleIter_iterate_row(iter, 1);
+	ASSERT_EQ(info, GrB_SUCCESS);
+
+	for(GrB_Index k = 0; k < 10; k++) {
+		info = RG_MatrixTupleIter_next(iter, &row, &col, NULL, &depleted);
+		ASSERT_FALSE(depleted);
+		ASSERT_EQ(row, 1);
+		ASSERT_EQ(col, k);
+	}
+
+	info = RG_MatrixTupleIter_next(iter, &row, &col, NULL, &depleted);
+	ASSERT_TRUE(depleted);
+
+	RG_Matrix_free(&A);
+	ASSERT_TRUE(A == NULL);
+	RG_MatrixTupleIter_free(&iter);
+	ASSERT_TRUE(iter == NULL);
+}
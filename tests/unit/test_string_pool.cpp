@@ -0,0 +1,88 @@
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/value.h"
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/string_pool.h"
+#ifdef __cplusplus
+}
+#endif
+
+class StringPoolTest:
+	public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(StringPoolTest, InternShares) {
+	StringPool *pool = StringPool_New();
+
+	SIValue a = StringPool_Intern(pool, "US");
+	SIValue b = StringPool_Intern(pool, "US");
+	SIValue c = StringPool_Intern(pool, "UK");
+
+	ASSERT_EQ(a.allocation, M_INTERN);
+	ASSERT_EQ(a.stringval, b.stringval);
+	ASSERT_NE(a.stringval, c.stringval);
+	ASSERT_STREQ(a.stringval, "US");
+	ASSERT_EQ(StringPool_Size(pool), 2);
+	ASSERT_EQ(SIValue_Compare(a, b, NULL), 0);
+	ASSERT_EQ(StringPool_Length(a.stringval), 2);
+
+	// strings are evicted once their last reference is released
+	SIValue_Free(a);
+	ASSERT_EQ(StringPool_Size(pool), 2);
+	SIValue_Free(b);
+	ASSERT_EQ(StringPool_Size(pool), 1);
+	SIValue_Free(c);
+	ASSERT_EQ(StringPool_Size(pool), 0);
+
+	StringPool_Free(pool);
+}
+
+TEST_F(StringPoolTest, InternValue) {
+	StringPool *pool = StringPool_New();
+
+	// owned strings are replaced by their interned counterpart
+	SIValue v = SI_DuplicateStringVal("active");
+	StringPool_InternValue(pool, &v);
+	ASSERT_EQ(v.allocation, M_INTERN);
+	ASSERT_STREQ(v.stringval, "active");
+
+	// interned values are left as is
+	char *interned = v.stringval;
+	StringPool_InternValue(pool, &v);
+	ASSERT_EQ(v.stringval, interned);
+	ASSERT_EQ(StringPool_Size(pool), 1);
+
+	// non string values are left as is
+	SIValue l = SI_LongVal(3);
+	StringPool_InternValue(pool, &l);
+	ASSERT_EQ(l.longval, 3);
+
+	// long strings are not interned
+	char long_str[STRING_POOL_MAX_LEN + 2];
+	memset(long_str, 'x', sizeof(long_str) - 1);
+	long_str[sizeof(long_str) - 1] = '\0';
+	SIValue s = SI_ConstStringVal(long_str);
+	StringPool_InternValue(pool, &s);
+	ASSERT_EQ(s.allocation, M_SELF);
+	ASSERT_NE(s.stringval, long_str);
+	ASSERT_EQ(StringPool_Size(pool), 1);
+
+	// shared copies do not hold a reference
+	SIValue shared = SI_ShareValue(v);
+	ASSERT_EQ(shared.allocation, M_VOLATILE);
+	SIValue_Free(shared);
+	ASSERT_EQ(StringPool_Size(pool), 1);
+
+	SIValue_Free(s);
+	SIValue_Free(v);
+	ASSERT_EQ(StringPool_Size(pool), 0);
+
+	StringPool_Free(pool);
+}
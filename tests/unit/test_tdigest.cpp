@@ -0,0 +1,86 @@
+#include "gtest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../../src/util/rmalloc.h"
+#include "../../src/util/tdigest.h"
+#ifdef __cplusplus
+}
+#endif
+
+#include <cmath>
+
+class TDigestTest:
+	public ::testing::Test {
+  protected:
+	static void SetUpTestCase() { // Use the malloc family for allocations
+		Alloc_Reset();
+	}
+};
+
+TEST_F(TDigestTest, Empty) {
+	TDigest td;
+	TDigest_Reset(&td);
+
+	ASSERT_EQ(TDigest_Weight(&td), 0);
+	ASSERT_TRUE(std::isnan(TDigest_Quantile(&td, 0.5)));
+}
+
+TEST_F(TDigestTest, SmallSet) {
+	TDigest td;
+	TDigest_Reset(&td);
+
+	// values are added out of order
+	double values[5] = {6, 2, 10, 4, 8};
+	for(int i = 0; i < 5; i++) TDigest_Add(&td, values[i]);
+
+	// no centroids were merged, quantiles are exact
+	ASSERT_EQ(TDigest_Weight(&td), 5);
+	ASSERT_EQ(TDigest_Quantile(&td, 0), 2);
+	ASSERT_EQ(TDigest_Quantile(&td, 0.25), 4);
+	ASSERT_EQ(TDigest_Quantile(&td, 0.5), 6);
+	ASSERT_DOUBLE_EQ(TDigest_Quantile(&td, 0.6), 6.8);
+	ASSERT_EQ(TDigest_Quantile(&td, 1), 10);
+}
+
+TEST_F(TDigestTest, LargeSet) {
+	TDigest *td = (TDigest *)malloc(sizeof(TDigest));
+	TDigest_Reset(td);
+
+	const int n = 1000000;
+	for(int i = 1; i <= n; i++) TDigest_Add(td, i);
+
+	ASSERT_EQ(TDigest_Weight(td), n);
+	ASSERT_EQ(TDigest_Quantile(td, 0), 1);
+	ASSERT_EQ(TDigest_Quantile(td, 1), n);
+
+	// tails are estimated more accurately than the median
+	ASSERT_LE(std::fabs(TDigest_Quantile(td, 0.5) - n * 0.5), n * 0.005);
+	ASSERT_LE(std::fabs(TDigest_Quantile(td, 0.99) - n * 0.99), n * 0.002);
+	ASSERT_LE(std::fabs(TDigest_Quantile(td, 0.001) - n * 0.001), n * 0.0005);
+
+	free(td);
+}
+
+TEST_F(TDigestTest, Merge) {
+	TDigest *a = (TDigest *)malloc(sizeof(TDigest));
+	TDigest *b = (TDigest *)malloc(sizeof(TDigest));
+	TDigest_Reset(a);
+	TDigest_Reset(b);
+
+	// interleaved halves of [1, 100000]
+	const int n = 100000;
+	for(int i = 1; i <= n; i++) TDigest_Add((i % 2) ? a : b, i);
+
+	TDigest_Merge(a, b);
+
+	ASSERT_EQ(TDigest_Weight(a), n);
+	ASSERT_EQ(TDigest_Quantile(a, 0), 1);
+	ASSERT_EQ(TDigest_Quantile(a, 1), n);
+	ASSERT_LE(std::fabs(TDigest_Quantile(a, 0.25) - n * 0.25), n * 0.005);
+	ASSERT_LE(std::fabs(TDigest_Quantile(a, 0.9) - n * 0.9), n * 0.005);
+
+	free(a);
+	free(b);
+}
@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "assert.h"
+#include <unistd.h>
 #include "../../src/util/rmalloc.h"
 #include "../../src/util/thpool/pools.h"
 #include "../../src/configuration/config.h"
@@ -21,13 +22,15 @@ extern "C" {
 
 #define READER_COUNT 4
 #define WRITER_COUNT 1
+#define HEAVY_COUNT 1
 
 class ThreadPoolsTest: public ::testing::Test {
 	protected:
 	// Use the malloc family for allocations
 	static void SetUpTestCase() {
 		Alloc_Reset();
-		ThreadPools_CreatePools(READER_COUNT, WRITER_COUNT, UINT64_MAX);
+		ThreadPools_CreatePools(READER_COUNT, READER_COUNT, WRITER_COUNT,
+				HEAVY_COUNT, UINT64_MAX);
 	}
 
 	static void get_thread_friendly_id(void *arg) {
@@ -37,10 +40,12 @@ class ThreadPoolsTest: public ::testing::Test {
 };
 
 TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
-	// verify thread count equals to the number of reader and writer threads
-	ASSERT_EQ (READER_COUNT + WRITER_COUNT, ThreadPools_ThreadCount());
+	// verify thread count equals to the number of reader, writer and heavy threads
+	ASSERT_EQ (READER_COUNT + WRITER_COUNT + HEAVY_COUNT,
+			ThreadPools_ThreadCount());
 
-	int thread_ids[READER_COUNT + WRITER_COUNT + 1] = {-1, -1, -1, -1, -1, -1};
+	int thread_ids[READER_COUNT + WRITER_COUNT + HEAVY_COUNT + 1] =
+		{-1, -1, -1, -1, -1, -1, -1};
 
 	// get main thread friendly id
 	thread_ids[0] = ThreadPools_GetThreadID();
@@ -50,7 +55,7 @@ TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 		int offset = i + 1;
 		ASSERT_EQ(0,
 				ThreadPools_AddWorkReader(get_thread_friendly_id,
-					thread_ids + offset));
+					thread_ids + offset, NULL));
 	}
 
 	// get writer threads friendly ids
@@ -61,8 +66,16 @@ TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 					thread_ids + offset));
 	}
 
+	// get heavy threads friendly ids
+	for(int i = 0; i < HEAVY_COUNT; i++) {
+		int offset = i + READER_COUNT + WRITER_COUNT + 1;
+		ASSERT_EQ(0,
+				ThreadPools_AddWorkHeavy(get_thread_friendly_id,
+					thread_ids + offset));
+	}
+
 	// wait for all threads
-	for(int i = 0; i < READER_COUNT + WRITER_COUNT + 1; i++) {
+	for(int i = 0; i < READER_COUNT + WRITER_COUNT + HEAVY_COUNT + 1; i++) {
 		while(thread_ids[i] == -1) { i = i; }
 	}
 
@@ -81,5 +94,60 @@ TEST_F(ThreadPoolsTest, ThreadPools_ThreadID) {
 		int offset = i + READER_COUNT + 1;
 		ASSERT_GT(thread_ids[offset], thread_ids[1]);
 	}
+
+	// heavy thread ids should be > writer thread ids
+	for(int i = 0; i < HEAVY_COUNT; i++) {
+		int offset = i + READER_COUNT + WRITER_COUNT + 1;
+		ASSERT_GT(thread_ids[offset], thread_ids[READER_COUNT + WRITER_COUNT]);
+	}
 }
 
+
+TEST_F(ThreadPoolsTest, ThreadPools_Stats) {
+	thpool_stats before;
+	ThreadPools_GetStats(&before, NULL, NULL);
+
+	// issue reads on behalf of two groups
+	int a = 0;
+	int b = 0;
+	int thread_ids[READER_COUNT * 2];
+	for(int i = 0; i < READER_COUNT * 2; i++) {
+		thread_ids[i] = -1;
+		const void *group = (i % 2 == 0) ? (void *)&a : (void *)&b;
+		ASSERT_EQ(0, ThreadPools_AddWorkReader(get_thread_friendly_id,
+					thread_ids + i, group));
+	}
+
+	// wait for all jobs
+	for(int i = 0; i < READER_COUNT * 2; i++) {
+		while(thread_ids[i] == -1) { i = i; }
+	}
+
+	thpool_stats after;
+	ThreadPools_GetStats(&after, NULL, NULL);
+	ASSERT_EQ(before.enqueued + READER_COUNT * 2, after.enqueued);
+	ASSERT_GE(after.wait_time_total_us, before.wait_time_total_us);
+	ASSERT_GE(after.wait_time_max_us, before.wait_time_max_us);
+}
+
+TEST_F(ThreadPoolsTest, ThreadPools_Resize) {
+	// readers can't outgrow their capacity
+	ASSERT_FALSE(ThreadPools_SetReadersCount(READER_COUNT + 1));
+
+	// shrink, surplus readers exit
+	ASSERT_TRUE(ThreadPools_SetReadersCount(1));
+	while(ThreadPools_ReadersCount() != 1) { usleep(1000); }
+
+	// remaining reader keeps serving
+	int thread_id = -1;
+	ASSERT_EQ(0, ThreadPools_AddWorkReader(get_thread_friendly_id, &thread_id,
+				NULL));
+	while(thread_id == -1) { usleep(1000); }
+	ASSERT_EQ(1, thread_id);
+
+	// grow back, thread ids are unaffected
+	ASSERT_TRUE(ThreadPools_SetReadersCount(READER_COUNT));
+	while(ThreadPools_ReadersCount() != READER_COUNT) { usleep(1000); }
+	ASSERT_EQ(READER_COUNT + WRITER_COUNT + HEAVY_COUNT,
+			ThreadPools_ThreadCount());
+}
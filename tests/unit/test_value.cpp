@@ -216,6 +216,53 @@ TEST_F(ValueTest, TestArray) {
 	ASSERT_TRUE(contains);
 }
 
+TEST_F(ValueTest, TestSharedArray) {
+	SIValue nested = SI_EmptyArray();
+	SIArray_Append(&nested, SI_LongVal(2));
+	SIArray_Append(&nested, SI_ConstStringVal("str"));
+
+	SIValue arr = SI_EmptyArray();
+	SIArray_Append(&arr, SI_LongVal(1));
+	SIArray_Append(&arr, nested);
+	SIValue_Free(nested);
+
+	uint64_t hash = SIValue_HashCode(arr);
+	SIValue_MakeShared(&arr);
+	ASSERT_EQ(arr.allocation, M_SHARED);
+	ASSERT_EQ(SIArray_Length(arr), 2);
+	ASSERT_EQ(SIValue_HashCode(arr), hash);
+
+	// nested arrays are shared as well
+	SIValue elem = SIArray_Get(arr, 1);
+	ASSERT_EQ(elem.allocation, M_SHARED_VOLATILE);
+
+	// sharing and persisting reference the original elements
+	SIValue dup = SI_ShareValue(arr);
+	ASSERT_EQ(dup.allocation, M_SHARED_VOLATILE);
+	SIValue_Persist(&dup);
+	ASSERT_EQ(dup.allocation, M_SHARED);
+	ASSERT_EQ(dup.array, arr.array);
+
+	// appending a shared value references it
+	SIValue outer = SI_EmptyArray();
+	SIArray_Append(&outer, elem);
+	ASSERT_EQ(SIArray_Get(outer, 0).array, elem.array);
+
+	// cloning creates a private top-level copy
+	SIValue clone = SI_CloneValue(arr);
+	ASSERT_EQ(clone.allocation, M_SELF);
+	ASSERT_NE(clone.array, arr.array);
+	ASSERT_EQ(SIValue_HashCode(clone), hash);
+
+	// elements outlive the values they were shared from
+	SIValue_Free(arr);
+	SIValue_Free(clone);
+	ASSERT_EQ(SIValue_HashCode(dup), hash);
+	SIValue_Free(dup);
+	ASSERT_STREQ(SIArray_Get(SIArray_Get(outer, 0), 1).stringval, "str");
+	SIValue_Free(outer);
+}
+
 /* Test for difference in hash code for the same binary representation
  * for different types. The value boolean "true" and the integer value "1"
  * have the same binary representation. Given that, their types are different,